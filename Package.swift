@@ -437,6 +437,7 @@ let package = Package(
         "connections/listeners_test.cc",
         "connections/strategy_test.cc",
         "connections/implementation/offline_frames_test.cc",
+        "connections/implementation/offline_frames_benchmark.cc",
         "connections/implementation/offline_service_controller_test.cc",
         "connections/implementation/encryption_runner_test.cc",
         "connections/implementation/p2p_cluster_pcp_handler_test.cc",
@@ -445,7 +446,29 @@ let package = Package(
         "connections/implementation/injected_bluetooth_device_store_test.cc",
         "connections/implementation/internal_payload_factory_test.cc",
         "connections/implementation/client_proxy_test.cc",
+        "connections/implementation/client_callback_queue_test.cc",
+        "connections/implementation/incoming_bytes_budget_test.cc",
+        "connections/implementation/medium_throughput_history_test.cc",
+        "connections/implementation/bwu_medium_scorer_test.cc",
+        "connections/implementation/peer_medium_cache_test.cc",
         "connections/implementation/payload_manager_test.cc",
+        "connections/implementation/load_harness_test.cc",
+        "connections/implementation/payload_manager_benchmark.cc",
+        "connections/implementation/connection_pool_test.cc",
+        "connections/implementation/discovery_event_coalescer_test.cc",
+        "connections/implementation/chunk_size_controller_test.cc",
+        "connections/implementation/keep_alive_task_test.cc",
+        "connections/implementation/aead_record_layer_test.cc",
+        "connections/implementation/session_resumption_test.cc",
+        "connections/implementation/reconnect_strategy_test.cc",
+        "connections/implementation/frame_read_ahead_test.cc",
+        "connections/implementation/write_behind_sink_test.cc",
+        "connections/implementation/chunk_compression_test.cc",
+        "connections/implementation/outgoing_payload_scheduler_test.cc",
+        "connections/implementation/write_priority_gate_test.cc",
+        "connections/implementation/payload_progress_coalescer_test.cc",
+        "connections/implementation/payload_send_window_test.cc",
+        "connections/implementation/payload_batcher_test.cc",
         "connections/implementation/offline_frames_validator_test.cc",
         "connections/implementation/service_controller_router_test.cc",
         "connections/implementation/bluetooth_bwu_test.cc",
@@ -453,17 +476,21 @@ let package = Package(
         "connections/implementation/wifi_hotspot_bwu_test.cc",
         "connections/implementation/analytics/analytics_recorder_test.cc",
         "connections/implementation/analytics/throughput_recorder_test.cc",
+        "connections/implementation/analytics/link_throughput_recorder_test.cc",
         "connections/implementation/mediums/ble_v2_test.cc",
         "connections/implementation/mediums/ble_v2/bloom_filter_test.cc",
+        "connections/implementation/mediums/ble_v2/bloom_filter_benchmark.cc",
         "connections/implementation/mediums/ble_v2/ble_packet_test.cc",
         "connections/implementation/mediums/ble_v2/ble_advertisement_test.cc",
         "connections/implementation/mediums/ble_v2/advertisement_read_result_test.cc",
+        "connections/implementation/mediums/ble_v2/advertisement_cache_test.cc",
         "connections/implementation/mediums/ble_v2/ble_advertisement_header_test.cc",
         "connections/implementation/mediums/ble_v2/ble_utils_test.cc",
         "connections/implementation/mediums/ble_v2/discovered_peripheral_tracker_test.cc",
         "connections/implementation/mediums/ble_v2/instant_on_lost_advertisement_test.cc",
         "connections/implementation/mediums/ble_v2/instant_on_lost_manager_test.cc",
         "connections/implementation/mediums/multiplex/multiplex_frames_test.cc",
+        "connections/implementation/mediums/multiplex/multiplex_benchmark.cc",
         "connections/implementation/mediums/multiplex/multiplex_socket_test.cc",
         "connections/implementation/mediums/multiplex/multiplex_output_stream_test.cc",
         "connections/implementation/mediums/webrtc_peer_id_test.cc",
@@ -472,6 +499,8 @@ let package = Package(
         "connections/implementation/mediums/ble_test.cc",
         "connections/implementation/mediums/webrtc_test.cc",
         "connections/implementation/mediums/lost_entity_tracker_test.cc",
+        "connections/implementation/mediums/lost_entity_tracker_benchmark.cc",
+        "connections/implementation/mediums/nsd_service_cache_test.cc",
         "connections/implementation/mediums/bluetooth_radio_test.cc",
         "connections/implementation/mediums/wifi_direct_test.cc",
         "connections/implementation/mediums/wifi_hotspot_test.cc",
@@ -485,6 +514,7 @@ let package = Package(
         "connections/implementation/pcp_manager_test.cc",
         "connections/implementation/ble_advertisement_test.cc",
         "connections/implementation/base_endpoint_channel_test.cc",
+        "connections/implementation/base_endpoint_channel_benchmark.cc",
         "connections/implementation/reconnect_manager_test.cc",
         "connections/v3/connections_device_test.cc",
         "connections/v3/connections_device_provider_test.cc",
@@ -495,6 +525,7 @@ let package = Package(
         "internal/base/bluetooth_address_test.cc",
         "internal/base/files_test.cc",
         "internal/crypto/ed25519_unittest.cc",
+        "internal/crypto/keyed_hkdf_unittest.cc",
         "internal/crypto_cros/aead_unittest.cc",
         "internal/crypto_cros/ec_private_key_unittest.cc",
         "internal/crypto_cros/ec_signature_creator_unittest.cc",
@@ -507,6 +538,7 @@ let package = Package(
         "internal/crypto_cros/symmetric_key_unittest.cc",
         "internal/data/leveldb_data_set_test.cc",
         "internal/data/memory_data_set_test.cc",
+        "internal/data/async_data_set_test.cc",
         "internal/flags/nearby_flags_test.cc",
         "internal/proto/analytics/connections_log_test.cc",
         "internal/platform/feature_flags_test.cc",
@@ -514,13 +546,18 @@ let package = Package(
         "internal/platform/crypto_test.cc",
         "internal/platform/byte_array_test.cc",
         "internal/platform/bluetooth_utils_test.cc",
+        "internal/platform/base64_utils_test.cc",
+        "internal/platform/base64_utils_benchmark.cc",
         "internal/platform/credential_storage_impl_test.cc",
         "internal/platform/input_stream_test.cc",
+        "internal/platform/buffered_frame_reader_test.cc",
         "internal/platform/single_thread_executor_test.cc",
         "internal/platform/scheduled_executor_test.cc",
         "internal/platform/count_down_latch_test.cc",
         "internal/platform/pipe_test.cc",
         "internal/platform/timer_impl_test.cc",
+        "internal/platform/timer_wheel_test.cc",
+        "internal/platform/trace_event_test.cc",
         "internal/platform/task_runner_impl_test.cc",
         "internal/platform/uuid_test.cc",
         "internal/platform/wifi_lan_connection_info_test.cc",
@@ -534,10 +571,14 @@ let package = Package(
         "internal/platform/bluetooth_classic_test.cc",
         "internal/platform/bluetooth_connection_info_test.cc",
         "internal/platform/mutex_test.cc",
+        "internal/platform/lock_profiler_test.cc",
         "internal/platform/atomic_reference_test.cc",
         "internal/platform/multi_thread_executor_test.cc",
+        "internal/platform/executor_stats_test.cc",
         "internal/platform/ble_connection_info_test.cc",
         "internal/platform/ble_test.cc",
+        "internal/platform/ble_scan_arbiter_test.cc",
+        "internal/platform/ble_advertising_scheduler_test.cc",
         "internal/platform/ble_v2_test.cc",
         "internal/platform/prng_test.cc",
         "internal/platform/implementation/apple/count_down_latch_test.cc",
@@ -546,6 +587,9 @@ let package = Package(
         "internal/platform/implementation/apple/atomic_boolean_test.cc",
         "internal/platform/implementation/apple/atomic_uint32_test.cc",
         "internal/platform/implementation/shared/file_test.cc",
+        "internal/platform/implementation/shared/work_stealing_executor_test.cc",
+        "internal/platform/implementation/shared/timer_service_test.cc",
+        "internal/platform/implementation/shared/work_stealing_executor_benchmark.cc",
         "internal/platform/implementation/wifi_utils_test.cc",
         "internal/platform/atomic_boolean_test.cc",
         "internal/platform/exception_test.cc",
@@ -559,12 +603,16 @@ let package = Package(
         "internal/platform/borrowable_test.cc",
         "internal/platform/implementation/windows/http_loader_test.cc",
         "internal/platform/blocking_queue_stream_test.cc",
+        "internal/platform/array_blocking_queue_test.cc",
+        "internal/platform/async_log_sink_test.cc",
+        "internal/platform/pending_job_registry_test.cc",
         "internal/network/utils_test.cc",
         "internal/network/url_test.cc",
         "internal/network/http_response_test.cc",
         "internal/network/http_request_test.cc",
         "internal/network/http_client_impl_test.cc",
         "internal/network/http_status_code_test.cc",
+        "internal/network/http_response_cache_test.cc",
         "internal/test/google3_only/fake_authentication_manager_test.cc",
         "internal/test/fake_clock_test.cc",
         "internal/test/fake_webrtc.cc",
@@ -579,6 +627,7 @@ let package = Package(
         "internal/weave/packet_test.cc",
         "internal/weave/packet_sequence_number_generator_test.cc",
         "internal/weave/packetizer_test.cc",
+        "internal/weave/packetizer_benchmark.cc",
         "internal/weave/sockets/client_socket_test.cc",
         "internal/weave/sockets/server_socket_test.cc",
         // simulation
@@ -84,12 +84,17 @@ constexpr ConnectionResponseFrame::ConnectionResponseFrame(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : handshake_data_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
   , os_info_(nullptr)
+  , location_hint_(nullptr)
   , status_(0)
   , response_(0)
 
   , multiplex_socket_bitmask_(0)
   , nearby_connections_version_(0)
-  , safe_to_disconnect_version_(0){}
+  , safe_to_disconnect_version_(0)
+  , keep_alive_timeout_millis_(0)
+  , aead_record_layer_version_(0)
+  , payload_compression_version_(0)
+  , payload_batching_version_(0){}
 struct ConnectionResponseFrameDefaultTypeInternal {
   constexpr ConnectionResponseFrameDefaultTypeInternal()
     : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
@@ -120,6 +125,7 @@ PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PayloadTransferFrame_PayloadHea
 constexpr PayloadTransferFrame_PayloadChunk::PayloadTransferFrame_PayloadChunk(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : body_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , sha256_digest_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
   , offset_(int64_t{0})
   , flags_(0)
   , index_(0){}
@@ -132,6 +138,19 @@ struct PayloadTransferFrame_PayloadChunkDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PayloadTransferFrame_PayloadChunkDefaultTypeInternal _PayloadTransferFrame_PayloadChunk_default_instance_;
+constexpr PayloadTransferFrame_BatchedPayload::PayloadTransferFrame_BatchedPayload(
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : body_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , payload_header_(nullptr){}
+struct PayloadTransferFrame_BatchedPayloadDefaultTypeInternal {
+  constexpr PayloadTransferFrame_BatchedPayloadDefaultTypeInternal()
+    : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
+  ~PayloadTransferFrame_BatchedPayloadDefaultTypeInternal() {}
+  union {
+    PayloadTransferFrame_BatchedPayload _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PayloadTransferFrame_BatchedPayloadDefaultTypeInternal _PayloadTransferFrame_BatchedPayload_default_instance_;
 constexpr PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : offset_(int64_t{0})
@@ -148,7 +167,8 @@ struct PayloadTransferFrame_ControlMessageDefaultTypeInternal {
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT PayloadTransferFrame_ControlMessageDefaultTypeInternal _PayloadTransferFrame_ControlMessage_default_instance_;
 constexpr PayloadTransferFrame::PayloadTransferFrame(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
-  : payload_header_(nullptr)
+  : batched_payloads_()
+  , payload_header_(nullptr)
   , payload_chunk_(nullptr)
   , control_message_(nullptr)
   , packet_type_(0)
@@ -351,7 +371,8 @@ PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT KeepAliveFrameDefaultTypeIntern
 constexpr DisconnectionFrame::DisconnectionFrame(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : request_safe_to_disconnect_(false)
-  , ack_safe_to_disconnect_(false){}
+  , ack_safe_to_disconnect_(false)
+  , park_connection_(false){}
 struct DisconnectionFrameDefaultTypeInternal {
   constexpr DisconnectionFrameDefaultTypeInternal()
     : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
@@ -412,9 +433,24 @@ struct AutoResumeFrameDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT AutoResumeFrameDefaultTypeInternal _AutoResumeFrame_default_instance_;
+constexpr AutoReconnectFrame_SessionResumption::AutoReconnectFrame_SessionResumption(
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : ticket_id_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , nonce_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , mac_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string){}
+struct AutoReconnectFrame_SessionResumptionDefaultTypeInternal {
+  constexpr AutoReconnectFrame_SessionResumptionDefaultTypeInternal()
+    : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
+  ~AutoReconnectFrame_SessionResumptionDefaultTypeInternal() {}
+  union {
+    AutoReconnectFrame_SessionResumption _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT AutoReconnectFrame_SessionResumptionDefaultTypeInternal _AutoReconnectFrame_SessionResumption_default_instance_;
 constexpr AutoReconnectFrame::AutoReconnectFrame(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : endpoint_id_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , session_resumption_(nullptr)
   , event_type_(0)
 {}
 struct AutoReconnectFrameDefaultTypeInternal {
@@ -1075,23 +1111,27 @@ constexpr int PayloadTransferFrame_PayloadHeader::PayloadType_ARRAYSIZE;
 bool PayloadTransferFrame_PayloadChunk_Flags_IsValid(int value) {
   switch (value) {
     case 1:
+    case 2:
       return true;
     default:
       return false;
   }
 }
 
-static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_PayloadChunk_Flags_strings[1] = {};
+static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_PayloadChunk_Flags_strings[2] = {};
 
 static const char PayloadTransferFrame_PayloadChunk_Flags_names[] =
+  "COMPRESSED"
   "LAST_CHUNK";
 
 static const ::PROTOBUF_NAMESPACE_ID::internal::EnumEntry PayloadTransferFrame_PayloadChunk_Flags_entries[] = {
-  { {PayloadTransferFrame_PayloadChunk_Flags_names + 0, 10}, 1 },
+  { {PayloadTransferFrame_PayloadChunk_Flags_names + 0, 10}, 2 },
+  { {PayloadTransferFrame_PayloadChunk_Flags_names + 10, 10}, 1 },
 };
 
 static const int PayloadTransferFrame_PayloadChunk_Flags_entries_by_number[] = {
-  0, // 1 -> LAST_CHUNK
+  1, // 1 -> LAST_CHUNK
+  0, // 2 -> COMPRESSED
 };
 
 const std::string& PayloadTransferFrame_PayloadChunk_Flags_Name(
@@ -1100,12 +1140,12 @@ const std::string& PayloadTransferFrame_PayloadChunk_Flags_Name(
       ::PROTOBUF_NAMESPACE_ID::internal::InitializeEnumStrings(
           PayloadTransferFrame_PayloadChunk_Flags_entries,
           PayloadTransferFrame_PayloadChunk_Flags_entries_by_number,
-          1, PayloadTransferFrame_PayloadChunk_Flags_strings);
+          2, PayloadTransferFrame_PayloadChunk_Flags_strings);
   (void) dummy;
   int idx = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumName(
       PayloadTransferFrame_PayloadChunk_Flags_entries,
       PayloadTransferFrame_PayloadChunk_Flags_entries_by_number,
-      1, value);
+      2, value);
   return idx == -1 ? ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString() :
                      PayloadTransferFrame_PayloadChunk_Flags_strings[idx].get();
 }
@@ -1113,7 +1153,7 @@ bool PayloadTransferFrame_PayloadChunk_Flags_Parse(
     ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, PayloadTransferFrame_PayloadChunk_Flags* value) {
   int int_value;
   bool success = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumValue(
-      PayloadTransferFrame_PayloadChunk_Flags_entries, 1, name, &int_value);
+      PayloadTransferFrame_PayloadChunk_Flags_entries, 2, name, &int_value);
   if (success) {
     *value = static_cast<PayloadTransferFrame_PayloadChunk_Flags>(int_value);
   }
@@ -1121,6 +1161,7 @@ bool PayloadTransferFrame_PayloadChunk_Flags_Parse(
 }
 #if (__cplusplus < 201703) && (!defined(_MSC_VER) || (_MSC_VER >= 1900 && _MSC_VER < 1912))
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::LAST_CHUNK;
+constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::COMPRESSED;
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::Flags_MIN;
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk::Flags_MAX;
 constexpr int PayloadTransferFrame_PayloadChunk::Flags_ARRAYSIZE;
@@ -1199,32 +1240,36 @@ bool PayloadTransferFrame_PacketType_IsValid(int value) {
     case 1:
     case 2:
     case 3:
+    case 4:
       return true;
     default:
       return false;
   }
 }
 
-static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_PacketType_strings[4] = {};
+static ::PROTOBUF_NAMESPACE_ID::internal::ExplicitlyConstructed<std::string> PayloadTransferFrame_PacketType_strings[5] = {};
 
 static const char PayloadTransferFrame_PacketType_names[] =
+  "BATCHED_DATA"
   "CONTROL"
   "DATA"
   "PAYLOAD_ACK"
   "UNKNOWN_PACKET_TYPE";
 
 static const ::PROTOBUF_NAMESPACE_ID::internal::EnumEntry PayloadTransferFrame_PacketType_entries[] = {
-  { {PayloadTransferFrame_PacketType_names + 0, 7}, 2 },
-  { {PayloadTransferFrame_PacketType_names + 7, 4}, 1 },
-  { {PayloadTransferFrame_PacketType_names + 11, 11}, 3 },
-  { {PayloadTransferFrame_PacketType_names + 22, 19}, 0 },
+  { {PayloadTransferFrame_PacketType_names + 0, 12}, 4 },
+  { {PayloadTransferFrame_PacketType_names + 12, 7}, 2 },
+  { {PayloadTransferFrame_PacketType_names + 19, 4}, 1 },
+  { {PayloadTransferFrame_PacketType_names + 23, 11}, 3 },
+  { {PayloadTransferFrame_PacketType_names + 34, 19}, 0 },
 };
 
 static const int PayloadTransferFrame_PacketType_entries_by_number[] = {
-  3, // 0 -> UNKNOWN_PACKET_TYPE
-  1, // 1 -> DATA
-  0, // 2 -> CONTROL
-  2, // 3 -> PAYLOAD_ACK
+  4, // 0 -> UNKNOWN_PACKET_TYPE
+  2, // 1 -> DATA
+  1, // 2 -> CONTROL
+  3, // 3 -> PAYLOAD_ACK
+  0, // 4 -> BATCHED_DATA
 };
 
 const std::string& PayloadTransferFrame_PacketType_Name(
@@ -1233,12 +1278,12 @@ const std::string& PayloadTransferFrame_PacketType_Name(
       ::PROTOBUF_NAMESPACE_ID::internal::InitializeEnumStrings(
           PayloadTransferFrame_PacketType_entries,
           PayloadTransferFrame_PacketType_entries_by_number,
-          4, PayloadTransferFrame_PacketType_strings);
+          5, PayloadTransferFrame_PacketType_strings);
   (void) dummy;
   int idx = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumName(
       PayloadTransferFrame_PacketType_entries,
       PayloadTransferFrame_PacketType_entries_by_number,
-      4, value);
+      5, value);
   return idx == -1 ? ::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString() :
                      PayloadTransferFrame_PacketType_strings[idx].get();
 }
@@ -1246,7 +1291,7 @@ bool PayloadTransferFrame_PacketType_Parse(
     ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, PayloadTransferFrame_PacketType* value) {
   int int_value;
   bool success = ::PROTOBUF_NAMESPACE_ID::internal::LookUpEnumValue(
-      PayloadTransferFrame_PacketType_entries, 4, name, &int_value);
+      PayloadTransferFrame_PacketType_entries, 5, name, &int_value);
   if (success) {
     *value = static_cast<PayloadTransferFrame_PacketType>(int_value);
   }
@@ -1257,6 +1302,7 @@ constexpr PayloadTransferFrame_PacketType PayloadTransferFrame::UNKNOWN_PACKET_T
 constexpr PayloadTransferFrame_PacketType PayloadTransferFrame::DATA;
 constexpr PayloadTransferFrame_PacketType PayloadTransferFrame::CONTROL;
 constexpr PayloadTransferFrame_PacketType PayloadTransferFrame::PAYLOAD_ACK;
+constexpr PayloadTransferFrame_PacketType PayloadTransferFrame::BATCHED_DATA;
 constexpr PayloadTransferFrame_PacketType PayloadTransferFrame::PacketType_MIN;
 constexpr PayloadTransferFrame_PacketType PayloadTransferFrame::PacketType_MAX;
 constexpr int PayloadTransferFrame::PacketType_ARRAYSIZE;
@@ -3781,26 +3827,42 @@ class ConnectionResponseFrame::_Internal {
  public:
   using HasBits = decltype(std::declval<ConnectionResponseFrame>()._has_bits_);
   static void set_has_status(HasBits* has_bits) {
-    (*has_bits)[0] |= 4u;
+    (*has_bits)[0] |= 8u;
   }
   static void set_has_handshake_data(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
   static void set_has_response(HasBits* has_bits) {
-    (*has_bits)[0] |= 8u;
+    (*has_bits)[0] |= 16u;
   }
   static const ::location::nearby::connections::OsInfo& os_info(const ConnectionResponseFrame* msg);
   static void set_has_os_info(HasBits* has_bits) {
     (*has_bits)[0] |= 2u;
   }
   static void set_has_multiplex_socket_bitmask(HasBits* has_bits) {
-    (*has_bits)[0] |= 16u;
+    (*has_bits)[0] |= 32u;
   }
   static void set_has_nearby_connections_version(HasBits* has_bits) {
-    (*has_bits)[0] |= 32u;
+    (*has_bits)[0] |= 64u;
   }
   static void set_has_safe_to_disconnect_version(HasBits* has_bits) {
-    (*has_bits)[0] |= 64u;
+    (*has_bits)[0] |= 128u;
+  }
+  static const ::location::nearby::connections::LocationHint& location_hint(const ConnectionResponseFrame* msg);
+  static void set_has_location_hint(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
+  static void set_has_keep_alive_timeout_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 256u;
+  }
+  static void set_has_aead_record_layer_version(HasBits* has_bits) {
+    (*has_bits)[0] |= 512u;
+  }
+  static void set_has_payload_compression_version(HasBits* has_bits) {
+    (*has_bits)[0] |= 1024u;
+  }
+  static void set_has_payload_batching_version(HasBits* has_bits) {
+    (*has_bits)[0] |= 2048u;
   }
 };
 
@@ -3808,6 +3870,10 @@ const ::location::nearby::connections::OsInfo&
 ConnectionResponseFrame::_Internal::os_info(const ConnectionResponseFrame* msg) {
   return *msg->os_info_;
 }
+const ::location::nearby::connections::LocationHint&
+ConnectionResponseFrame::_Internal::location_hint(const ConnectionResponseFrame* msg) {
+  return *msg->location_hint_;
+}
 ConnectionResponseFrame::ConnectionResponseFrame(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
@@ -3834,9 +3900,14 @@ ConnectionResponseFrame::ConnectionResponseFrame(const ConnectionResponseFrame&
   } else {
     os_info_ = nullptr;
   }
+  if (from._internal_has_location_hint()) {
+    location_hint_ = new ::location::nearby::connections::LocationHint(*from.location_hint_);
+  } else {
+    location_hint_ = nullptr;
+  }
   ::memcpy(&status_, &from.status_,
-    static_cast<size_t>(reinterpret_cast<char*>(&safe_to_disconnect_version_) -
-    reinterpret_cast<char*>(&status_)) + sizeof(safe_to_disconnect_version_));
+    static_cast<size_t>(reinterpret_cast<char*>(&payload_batching_version_) -
+    reinterpret_cast<char*>(&status_)) + sizeof(payload_batching_version_));
   // @@protoc_insertion_point(copy_constructor:location.nearby.connections.ConnectionResponseFrame)
 }
 
@@ -3847,8 +3918,8 @@ handshake_data_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStr
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
     reinterpret_cast<char*>(&os_info_) - reinterpret_cast<char*>(this)),
-    0, static_cast<size_t>(reinterpret_cast<char*>(&safe_to_disconnect_version_) -
-    reinterpret_cast<char*>(&os_info_)) + sizeof(safe_to_disconnect_version_));
+    0, static_cast<size_t>(reinterpret_cast<char*>(&payload_batching_version_) -
+    reinterpret_cast<char*>(&os_info_)) + sizeof(payload_batching_version_));
 }
 
 ConnectionResponseFrame::~ConnectionResponseFrame() {
@@ -3862,6 +3933,7 @@ inline void ConnectionResponseFrame::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   handshake_data_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
   if (this != internal_default_instance()) delete os_info_;
+  if (this != internal_default_instance()) delete location_hint_;
 }
 
 void ConnectionResponseFrame::ArenaDtor(void* object) {
@@ -3881,7 +3953,7 @@ void ConnectionResponseFrame::Clear() {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
       handshake_data_.ClearNonDefaultToEmpty();
     }
@@ -3889,12 +3961,21 @@ void ConnectionResponseFrame::Clear() {
       GOOGLE_DCHECK(os_info_ != nullptr);
       os_info_->Clear();
     }
+    if (cached_has_bits & 0x00000004u) {
+      GOOGLE_DCHECK(location_hint_ != nullptr);
+      location_hint_->Clear();
+    }
   }
-  if (cached_has_bits & 0x0000007cu) {
+  if (cached_has_bits & 0x000000f8u) {
     ::memset(&status_, 0, static_cast<size_t>(
         reinterpret_cast<char*>(&safe_to_disconnect_version_) -
         reinterpret_cast<char*>(&status_)) + sizeof(safe_to_disconnect_version_));
   }
+  if (cached_has_bits & 0x00000f00u) {
+    ::memset(&keep_alive_timeout_millis_, 0, static_cast<size_t>(
+        reinterpret_cast<char*>(&payload_batching_version_) -
+        reinterpret_cast<char*>(&keep_alive_timeout_millis_)) + sizeof(payload_batching_version_));
+  }
   _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
 }
@@ -3972,6 +4053,50 @@ const char* ConnectionResponseFrame::_InternalParse(const char* ptr, ::PROTOBUF_
         } else
           goto handle_unusual;
         continue;
+      // optional .location.nearby.connections.LocationHint location_hint = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 66)) {
+          ptr = ctx->ParseMessage(_internal_mutable_location_hint(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int32 keep_alive_timeout_millis = 9;
+      case 9:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 72)) {
+          _Internal::set_has_keep_alive_timeout_millis(&has_bits);
+          keep_alive_timeout_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int32 aead_record_layer_version = 10;
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 80)) {
+          _Internal::set_has_aead_record_layer_version(&has_bits);
+          aead_record_layer_version_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int32 payload_compression_version = 11;
+      case 11:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 88)) {
+          _Internal::set_has_payload_compression_version(&has_bits);
+          payload_compression_version_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int32 payload_batching_version = 12;
+      case 12:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 96)) {
+          _Internal::set_has_payload_batching_version(&has_bits);
+          payload_batching_version_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -4004,7 +4129,7 @@ uint8_t* ConnectionResponseFrame::_InternalSerialize(
 
   cached_has_bits = _has_bits_[0];
   // optional int32 status = 1 [deprecated = true];
-  if (cached_has_bits & 0x00000004u) {
+  if (cached_has_bits & 0x00000008u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(1, this->_internal_status(), target);
   }
@@ -4016,7 +4141,7 @@ uint8_t* ConnectionResponseFrame::_InternalSerialize(
   }
 
   // optional .location.nearby.connections.ConnectionResponseFrame.ResponseStatus response = 3;
-  if (cached_has_bits & 0x00000008u) {
+  if (cached_has_bits & 0x00000010u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       3, this->_internal_response(), target);
@@ -4031,23 +4156,55 @@ uint8_t* ConnectionResponseFrame::_InternalSerialize(
   }
 
   // optional int32 multiplex_socket_bitmask = 5;
-  if (cached_has_bits & 0x00000010u) {
+  if (cached_has_bits & 0x00000020u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(5, this->_internal_multiplex_socket_bitmask(), target);
   }
 
   // optional int32 nearby_connections_version = 6 [deprecated = true];
-  if (cached_has_bits & 0x00000020u) {
+  if (cached_has_bits & 0x00000040u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(6, this->_internal_nearby_connections_version(), target);
   }
 
   // optional int32 safe_to_disconnect_version = 7;
-  if (cached_has_bits & 0x00000040u) {
+  if (cached_has_bits & 0x00000080u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(7, this->_internal_safe_to_disconnect_version(), target);
   }
 
+  // optional .location.nearby.connections.LocationHint location_hint = 8;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        8, _Internal::location_hint(this), target, stream);
+  }
+
+  // optional int32 keep_alive_timeout_millis = 9;
+  if (cached_has_bits & 0x00000100u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(9, this->_internal_keep_alive_timeout_millis(), target);
+  }
+
+  // optional int32 aead_record_layer_version = 10;
+  if (cached_has_bits & 0x00000200u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(10, this->_internal_aead_record_layer_version(), target);
+  }
+
+  // optional int32 payload_compression_version = 11;
+  if (cached_has_bits & 0x00000400u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(11, this->_internal_payload_compression_version(), target);
+  }
+
+  // optional int32 payload_batching_version = 12;
+  if (cached_has_bits & 0x00000800u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(12, this->_internal_payload_batching_version(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -4065,7 +4222,7 @@ size_t ConnectionResponseFrame::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x0000007fu) {
+  if (cached_has_bits & 0x000000ffu) {
     // optional bytes handshake_data = 2;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -4080,32 +4237,61 @@ size_t ConnectionResponseFrame::ByteSizeLong() const {
           *os_info_);
     }
 
-    // optional int32 status = 1 [deprecated = true];
+    // optional .location.nearby.connections.LocationHint location_hint = 8;
     if (cached_has_bits & 0x00000004u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *location_hint_);
+    }
+
+    // optional int32 status = 1 [deprecated = true];
+    if (cached_has_bits & 0x00000008u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_status());
     }
 
     // optional .location.nearby.connections.ConnectionResponseFrame.ResponseStatus response = 3;
-    if (cached_has_bits & 0x00000008u) {
+    if (cached_has_bits & 0x00000010u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_response());
     }
 
     // optional int32 multiplex_socket_bitmask = 5;
-    if (cached_has_bits & 0x00000010u) {
+    if (cached_has_bits & 0x00000020u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_multiplex_socket_bitmask());
     }
 
     // optional int32 nearby_connections_version = 6 [deprecated = true];
-    if (cached_has_bits & 0x00000020u) {
+    if (cached_has_bits & 0x00000040u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_nearby_connections_version());
     }
 
     // optional int32 safe_to_disconnect_version = 7;
-    if (cached_has_bits & 0x00000040u) {
+    if (cached_has_bits & 0x00000080u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_safe_to_disconnect_version());
     }
 
+  }
+  if (cached_has_bits & 0x00000f00u) {
+    // optional int32 keep_alive_timeout_millis = 9;
+    if (cached_has_bits & 0x00000100u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_keep_alive_timeout_millis());
+    }
+
+    // optional int32 aead_record_layer_version = 10;
+    if (cached_has_bits & 0x00000200u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_aead_record_layer_version());
+    }
+
+    // optional int32 payload_compression_version = 11;
+    if (cached_has_bits & 0x00000400u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_payload_compression_version());
+    }
+
+    // optional int32 payload_batching_version = 12;
+    if (cached_has_bits & 0x00000800u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_payload_batching_version());
+    }
+
   }
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
@@ -4128,7 +4314,7 @@ void ConnectionResponseFrame::MergeFrom(const ConnectionResponseFrame& from) {
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x0000007fu) {
+  if (cached_has_bits & 0x000000ffu) {
     if (cached_has_bits & 0x00000001u) {
       _internal_set_handshake_data(from._internal_handshake_data());
     }
@@ -4136,22 +4322,40 @@ void ConnectionResponseFrame::MergeFrom(const ConnectionResponseFrame& from) {
       _internal_mutable_os_info()->::location::nearby::connections::OsInfo::MergeFrom(from._internal_os_info());
     }
     if (cached_has_bits & 0x00000004u) {
-      status_ = from.status_;
+      _internal_mutable_location_hint()->::location::nearby::connections::LocationHint::MergeFrom(from._internal_location_hint());
     }
     if (cached_has_bits & 0x00000008u) {
-      response_ = from.response_;
+      status_ = from.status_;
     }
     if (cached_has_bits & 0x00000010u) {
-      multiplex_socket_bitmask_ = from.multiplex_socket_bitmask_;
+      response_ = from.response_;
     }
     if (cached_has_bits & 0x00000020u) {
-      nearby_connections_version_ = from.nearby_connections_version_;
+      multiplex_socket_bitmask_ = from.multiplex_socket_bitmask_;
     }
     if (cached_has_bits & 0x00000040u) {
+      nearby_connections_version_ = from.nearby_connections_version_;
+    }
+    if (cached_has_bits & 0x00000080u) {
       safe_to_disconnect_version_ = from.safe_to_disconnect_version_;
     }
     _has_bits_[0] |= cached_has_bits;
   }
+  if (cached_has_bits & 0x00000f00u) {
+    if (cached_has_bits & 0x00000100u) {
+      keep_alive_timeout_millis_ = from.keep_alive_timeout_millis_;
+    }
+    if (cached_has_bits & 0x00000200u) {
+      aead_record_layer_version_ = from.aead_record_layer_version_;
+    }
+    if (cached_has_bits & 0x00000400u) {
+      payload_compression_version_ = from.payload_compression_version_;
+    }
+    if (cached_has_bits & 0x00000800u) {
+      payload_batching_version_ = from.payload_batching_version_;
+    }
+    _has_bits_[0] |= cached_has_bits;
+  }
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
 }
 
@@ -4178,8 +4382,8 @@ void ConnectionResponseFrame::InternalSwap(ConnectionResponseFrame* other) {
       &other->handshake_data_, rhs_arena
   );
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(ConnectionResponseFrame, safe_to_disconnect_version_)
-      + sizeof(ConnectionResponseFrame::safe_to_disconnect_version_)
+      PROTOBUF_FIELD_OFFSET(ConnectionResponseFrame, payload_batching_version_)
+      + sizeof(ConnectionResponseFrame::payload_batching_version_)
       - PROTOBUF_FIELD_OFFSET(ConnectionResponseFrame, os_info_)>(
           reinterpret_cast<char*>(&os_info_),
           reinterpret_cast<char*>(&other->os_info_));
@@ -4590,16 +4794,19 @@ class PayloadTransferFrame_PayloadChunk::_Internal {
  public:
   using HasBits = decltype(std::declval<PayloadTransferFrame_PayloadChunk>()._has_bits_);
   static void set_has_flags(HasBits* has_bits) {
-    (*has_bits)[0] |= 4u;
+    (*has_bits)[0] |= 8u;
   }
   static void set_has_offset(HasBits* has_bits) {
-    (*has_bits)[0] |= 2u;
+    (*has_bits)[0] |= 4u;
   }
   static void set_has_body(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
   static void set_has_index(HasBits* has_bits) {
-    (*has_bits)[0] |= 8u;
+    (*has_bits)[0] |= 16u;
+  }
+  static void set_has_sha256_digest(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
   }
 };
 
@@ -4624,6 +4831,14 @@ PayloadTransferFrame_PayloadChunk::PayloadTransferFrame_PayloadChunk(const Paylo
     body_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_body(), 
       GetArenaForAllocation());
   }
+  sha256_digest_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    sha256_digest_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_sha256_digest()) {
+    sha256_digest_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_sha256_digest(), 
+      GetArenaForAllocation());
+  }
   ::memcpy(&offset_, &from.offset_,
     static_cast<size_t>(reinterpret_cast<char*>(&index_) -
     reinterpret_cast<char*>(&offset_)) + sizeof(index_));
@@ -4635,6 +4850,10 @@ body_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlready
 #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
   body_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+sha256_digest_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  sha256_digest_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
     reinterpret_cast<char*>(&offset_) - reinterpret_cast<char*>(this)),
     0, static_cast<size_t>(reinterpret_cast<char*>(&index_) -
@@ -4651,6 +4870,7 @@ PayloadTransferFrame_PayloadChunk::~PayloadTransferFrame_PayloadChunk() {
 inline void PayloadTransferFrame_PayloadChunk::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   body_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  sha256_digest_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
 }
 
 void PayloadTransferFrame_PayloadChunk::ArenaDtor(void* object) {
@@ -4670,10 +4890,15 @@ void PayloadTransferFrame_PayloadChunk::Clear() {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000001u) {
-    body_.ClearNonDefaultToEmpty();
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      body_.ClearNonDefaultToEmpty();
+    }
+    if (cached_has_bits & 0x00000002u) {
+      sha256_digest_.ClearNonDefaultToEmpty();
+    }
   }
-  if (cached_has_bits & 0x0000000eu) {
+  if (cached_has_bits & 0x0000001cu) {
     ::memset(&offset_, 0, static_cast<size_t>(
         reinterpret_cast<char*>(&index_) -
         reinterpret_cast<char*>(&offset_)) + sizeof(index_));
@@ -4725,6 +4950,15 @@ const char* PayloadTransferFrame_PayloadChunk::_InternalParse(const char* ptr, :
         } else
           goto handle_unusual;
         continue;
+      // optional bytes sha256_digest = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          auto str = _internal_mutable_sha256_digest();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -4757,13 +4991,13 @@ uint8_t* PayloadTransferFrame_PayloadChunk::_InternalSerialize(
 
   cached_has_bits = _has_bits_[0];
   // optional int32 flags = 1;
-  if (cached_has_bits & 0x00000004u) {
+  if (cached_has_bits & 0x00000008u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(1, this->_internal_flags(), target);
   }
 
   // optional int64 offset = 2;
-  if (cached_has_bits & 0x00000002u) {
+  if (cached_has_bits & 0x00000004u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(2, this->_internal_offset(), target);
   }
@@ -4775,11 +5009,17 @@ uint8_t* PayloadTransferFrame_PayloadChunk::_InternalSerialize(
   }
 
   // optional int32 index = 4;
-  if (cached_has_bits & 0x00000008u) {
+  if (cached_has_bits & 0x00000010u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(4, this->_internal_index(), target);
   }
 
+  // optional bytes sha256_digest = 5;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->WriteBytesMaybeAliased(
+        5, this->_internal_sha256_digest(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -4797,7 +5037,7 @@ size_t PayloadTransferFrame_PayloadChunk::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x0000000fu) {
+  if (cached_has_bits & 0x0000001fu) {
     // optional bytes body = 3;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -4805,18 +5045,25 @@ size_t PayloadTransferFrame_PayloadChunk::ByteSizeLong() const {
           this->_internal_body());
     }
 
-    // optional int64 offset = 2;
+    // optional bytes sha256_digest = 5;
     if (cached_has_bits & 0x00000002u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_sha256_digest());
+    }
+
+    // optional int64 offset = 2;
+    if (cached_has_bits & 0x00000004u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_offset());
     }
 
     // optional int32 flags = 1;
-    if (cached_has_bits & 0x00000004u) {
+    if (cached_has_bits & 0x00000008u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_flags());
     }
 
     // optional int32 index = 4;
-    if (cached_has_bits & 0x00000008u) {
+    if (cached_has_bits & 0x00000010u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_index());
     }
 
@@ -4842,17 +5089,20 @@ void PayloadTransferFrame_PayloadChunk::MergeFrom(const PayloadTransferFrame_Pay
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x0000000fu) {
+  if (cached_has_bits & 0x0000001fu) {
     if (cached_has_bits & 0x00000001u) {
       _internal_set_body(from._internal_body());
     }
     if (cached_has_bits & 0x00000002u) {
-      offset_ = from.offset_;
+      _internal_set_sha256_digest(from._internal_sha256_digest());
     }
     if (cached_has_bits & 0x00000004u) {
-      flags_ = from.flags_;
+      offset_ = from.offset_;
     }
     if (cached_has_bits & 0x00000008u) {
+      flags_ = from.flags_;
+    }
+    if (cached_has_bits & 0x00000010u) {
       index_ = from.index_;
     }
     _has_bits_[0] |= cached_has_bits;
@@ -4882,6 +5132,11 @@ void PayloadTransferFrame_PayloadChunk::InternalSwap(PayloadTransferFrame_Payloa
       &body_, lhs_arena,
       &other->body_, rhs_arena
   );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      &sha256_digest_, lhs_arena,
+      &other->sha256_digest_, rhs_arena
+  );
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
       PROTOBUF_FIELD_OFFSET(PayloadTransferFrame_PayloadChunk, index_)
       + sizeof(PayloadTransferFrame_PayloadChunk::index_)
@@ -4897,32 +5152,294 @@ std::string PayloadTransferFrame_PayloadChunk::GetTypeName() const {
 
 // ===================================================================
 
-class PayloadTransferFrame_ControlMessage::_Internal {
+class PayloadTransferFrame_BatchedPayload::_Internal {
  public:
-  using HasBits = decltype(std::declval<PayloadTransferFrame_ControlMessage>()._has_bits_);
-  static void set_has_event(HasBits* has_bits) {
+  using HasBits = decltype(std::declval<PayloadTransferFrame_BatchedPayload>()._has_bits_);
+  static const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader& payload_header(const PayloadTransferFrame_BatchedPayload* msg);
+  static void set_has_payload_header(HasBits* has_bits) {
     (*has_bits)[0] |= 2u;
   }
-  static void set_has_offset(HasBits* has_bits) {
+  static void set_has_body(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
 };
 
-PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader&
+PayloadTransferFrame_BatchedPayload::_Internal::payload_header(const PayloadTransferFrame_BatchedPayload* msg) {
+  return *msg->payload_header_;
+}
+PayloadTransferFrame_BatchedPayload::PayloadTransferFrame_BatchedPayload(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
   SharedCtor();
   if (!is_message_owned) {
     RegisterArenaDtor(arena);
   }
-  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.PayloadTransferFrame.ControlMessage)
+  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
 }
-PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(const PayloadTransferFrame_ControlMessage& from)
+PayloadTransferFrame_BatchedPayload::PayloadTransferFrame_BatchedPayload(const PayloadTransferFrame_BatchedPayload& from)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
       _has_bits_(from._has_bits_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
-  ::memcpy(&offset_, &from.offset_,
-    static_cast<size_t>(reinterpret_cast<char*>(&event_) -
+  body_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    body_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_body()) {
+    body_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_body(), 
+      GetArenaForAllocation());
+  }
+  if (from._internal_has_payload_header()) {
+    payload_header_ = new ::location::nearby::connections::PayloadTransferFrame_PayloadHeader(*from.payload_header_);
+  } else {
+    payload_header_ = nullptr;
+  }
+  // @@protoc_insertion_point(copy_constructor:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+}
+
+inline void PayloadTransferFrame_BatchedPayload::SharedCtor() {
+body_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  body_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+payload_header_ = nullptr;
+}
+
+PayloadTransferFrame_BatchedPayload::~PayloadTransferFrame_BatchedPayload() {
+  // @@protoc_insertion_point(destructor:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+  if (GetArenaForAllocation() != nullptr) return;
+  SharedDtor();
+  _internal_metadata_.Delete<std::string>();
+}
+
+inline void PayloadTransferFrame_BatchedPayload::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  body_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (this != internal_default_instance()) delete payload_header_;
+}
+
+void PayloadTransferFrame_BatchedPayload::ArenaDtor(void* object) {
+  PayloadTransferFrame_BatchedPayload* _this = reinterpret_cast< PayloadTransferFrame_BatchedPayload* >(object);
+  (void)_this;
+}
+void PayloadTransferFrame_BatchedPayload::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+}
+void PayloadTransferFrame_BatchedPayload::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+
+void PayloadTransferFrame_BatchedPayload::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      body_.ClearNonDefaultToEmpty();
+    }
+    if (cached_has_bits & 0x00000002u) {
+      GOOGLE_DCHECK(payload_header_ != nullptr);
+      payload_header_->Clear();
+    }
+  }
+  _has_bits_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* PayloadTransferFrame_BatchedPayload::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader payload_header = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          ptr = ctx->ParseMessage(_internal_mutable_payload_header(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bytes body = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_body();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* PayloadTransferFrame_BatchedPayload::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader payload_header = 1;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        1, _Internal::payload_header(this), target, stream);
+  }
+
+  // optional bytes body = 2;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->WriteBytesMaybeAliased(
+        2, this->_internal_body(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+  return target;
+}
+
+size_t PayloadTransferFrame_BatchedPayload::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    // optional bytes body = 2;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_body());
+    }
+
+    // optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader payload_header = 1;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *payload_header_);
+    }
+
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void PayloadTransferFrame_BatchedPayload::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::PROTOBUF_NAMESPACE_ID::internal::DownCast<const PayloadTransferFrame_BatchedPayload*>(
+      &from));
+}
+
+void PayloadTransferFrame_BatchedPayload::MergeFrom(const PayloadTransferFrame_BatchedPayload& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+  GOOGLE_DCHECK_NE(&from, this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      _internal_set_body(from._internal_body());
+    }
+    if (cached_has_bits & 0x00000002u) {
+      _internal_mutable_payload_header()->::location::nearby::connections::PayloadTransferFrame_PayloadHeader::MergeFrom(from._internal_payload_header());
+    }
+  }
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void PayloadTransferFrame_BatchedPayload::CopyFrom(const PayloadTransferFrame_BatchedPayload& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool PayloadTransferFrame_BatchedPayload::IsInitialized() const {
+  return true;
+}
+
+void PayloadTransferFrame_BatchedPayload::InternalSwap(PayloadTransferFrame_BatchedPayload* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      &body_, lhs_arena,
+      &other->body_, rhs_arena
+  );
+  swap(payload_header_, other->payload_header_);
+}
+
+std::string PayloadTransferFrame_BatchedPayload::GetTypeName() const {
+  return "location.nearby.connections.PayloadTransferFrame.BatchedPayload";
+}
+
+
+// ===================================================================
+
+class PayloadTransferFrame_ControlMessage::_Internal {
+ public:
+  using HasBits = decltype(std::declval<PayloadTransferFrame_ControlMessage>()._has_bits_);
+  static void set_has_event(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static void set_has_offset(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+};
+
+PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor();
+  if (!is_message_owned) {
+    RegisterArenaDtor(arena);
+  }
+  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.PayloadTransferFrame.ControlMessage)
+}
+PayloadTransferFrame_ControlMessage::PayloadTransferFrame_ControlMessage(const PayloadTransferFrame_ControlMessage& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  ::memcpy(&offset_, &from.offset_,
+    static_cast<size_t>(reinterpret_cast<char*>(&event_) -
     reinterpret_cast<char*>(&offset_)) + sizeof(event_));
   // @@protoc_insertion_point(copy_constructor:location.nearby.connections.PayloadTransferFrame.ControlMessage)
 }
@@ -5171,7 +5688,8 @@ PayloadTransferFrame::_Internal::control_message(const PayloadTransferFrame* msg
 }
 PayloadTransferFrame::PayloadTransferFrame(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
-  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned),
+  batched_payloads_(arena) {
   SharedCtor();
   if (!is_message_owned) {
     RegisterArenaDtor(arena);
@@ -5180,7 +5698,8 @@ PayloadTransferFrame::PayloadTransferFrame(::PROTOBUF_NAMESPACE_ID::Arena* arena
 }
 PayloadTransferFrame::PayloadTransferFrame(const PayloadTransferFrame& from)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
-      _has_bits_(from._has_bits_) {
+      _has_bits_(from._has_bits_),
+      batched_payloads_(from.batched_payloads_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
   if (from._internal_has_payload_header()) {
     payload_header_ = new ::location::nearby::connections::PayloadTransferFrame_PayloadHeader(*from.payload_header_);
@@ -5238,6 +5757,7 @@ void PayloadTransferFrame::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  batched_payloads_.Clear();
   cached_has_bits = _has_bits_[0];
   if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
@@ -5302,6 +5822,19 @@ const char* PayloadTransferFrame::_InternalParse(const char* ptr, ::PROTOBUF_NAM
         } else
           goto handle_unusual;
         continue;
+      // repeated .location.nearby.connections.PayloadTransferFrame.BatchedPayload batched_payloads = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 42)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_batched_payloads(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<42>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -5364,6 +5897,14 @@ uint8_t* PayloadTransferFrame::_InternalSerialize(
         4, _Internal::control_message(this), target, stream);
   }
 
+  // repeated .location.nearby.connections.PayloadTransferFrame.BatchedPayload batched_payloads = 5;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->_internal_batched_payloads_size()); i < n; i++) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(5, this->_internal_batched_payloads(i), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -5380,6 +5921,13 @@ size_t PayloadTransferFrame::ByteSizeLong() const {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  // repeated .location.nearby.connections.PayloadTransferFrame.BatchedPayload batched_payloads = 5;
+  total_size += 1UL * this->_internal_batched_payloads_size();
+  for (const auto& msg : this->batched_payloads_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
   cached_has_bits = _has_bits_[0];
   if (cached_has_bits & 0x0000000fu) {
     // optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader payload_header = 2;
@@ -5430,6 +5978,7 @@ void PayloadTransferFrame::MergeFrom(const PayloadTransferFrame& from) {
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
+  batched_payloads_.MergeFrom(from.batched_payloads_);
   cached_has_bits = from._has_bits_[0];
   if (cached_has_bits & 0x0000000fu) {
     if (cached_has_bits & 0x00000001u) {
@@ -5464,6 +6013,7 @@ void PayloadTransferFrame::InternalSwap(PayloadTransferFrame* other) {
   using std::swap;
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   swap(_has_bits_[0], other->_has_bits_[0]);
+  batched_payloads_.InternalSwap(&other->batched_payloads_);
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
       PROTOBUF_FIELD_OFFSET(PayloadTransferFrame, packet_type_)
       + sizeof(PayloadTransferFrame::packet_type_)
@@ -9335,6 +9885,9 @@ class DisconnectionFrame::_Internal {
   static void set_has_ack_safe_to_disconnect(HasBits* has_bits) {
     (*has_bits)[0] |= 2u;
   }
+  static void set_has_park_connection(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
 };
 
 DisconnectionFrame::DisconnectionFrame(::PROTOBUF_NAMESPACE_ID::Arena* arena,
@@ -9351,16 +9904,16 @@ DisconnectionFrame::DisconnectionFrame(const DisconnectionFrame& from)
       _has_bits_(from._has_bits_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
   ::memcpy(&request_safe_to_disconnect_, &from.request_safe_to_disconnect_,
-    static_cast<size_t>(reinterpret_cast<char*>(&ack_safe_to_disconnect_) -
-    reinterpret_cast<char*>(&request_safe_to_disconnect_)) + sizeof(ack_safe_to_disconnect_));
+    static_cast<size_t>(reinterpret_cast<char*>(&park_connection_) -
+    reinterpret_cast<char*>(&request_safe_to_disconnect_)) + sizeof(park_connection_));
   // @@protoc_insertion_point(copy_constructor:location.nearby.connections.DisconnectionFrame)
 }
 
 inline void DisconnectionFrame::SharedCtor() {
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
     reinterpret_cast<char*>(&request_safe_to_disconnect_) - reinterpret_cast<char*>(this)),
-    0, static_cast<size_t>(reinterpret_cast<char*>(&ack_safe_to_disconnect_) -
-    reinterpret_cast<char*>(&request_safe_to_disconnect_)) + sizeof(ack_safe_to_disconnect_));
+    0, static_cast<size_t>(reinterpret_cast<char*>(&park_connection_) -
+    reinterpret_cast<char*>(&request_safe_to_disconnect_)) + sizeof(park_connection_));
 }
 
 DisconnectionFrame::~DisconnectionFrame() {
@@ -9391,8 +9944,8 @@ void DisconnectionFrame::Clear() {
   (void) cached_has_bits;
 
   ::memset(&request_safe_to_disconnect_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&ack_safe_to_disconnect_) -
-      reinterpret_cast<char*>(&request_safe_to_disconnect_)) + sizeof(ack_safe_to_disconnect_));
+      reinterpret_cast<char*>(&park_connection_) -
+      reinterpret_cast<char*>(&request_safe_to_disconnect_)) + sizeof(park_connection_));
   _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
 }
@@ -9422,6 +9975,15 @@ const char* DisconnectionFrame::_InternalParse(const char* ptr, ::PROTOBUF_NAMES
         } else
           goto handle_unusual;
         continue;
+      // optional bool park_connection = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _Internal::set_has_park_connection(&has_bits);
+          park_connection_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -9465,6 +10027,12 @@ uint8_t* DisconnectionFrame::_InternalSerialize(
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(2, this->_internal_ack_safe_to_disconnect(), target);
   }
 
+  // optional bool park_connection = 3;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(3, this->_internal_park_connection(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -9482,7 +10050,7 @@ size_t DisconnectionFrame::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     // optional bool request_safe_to_disconnect = 1;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 + 1;
@@ -9493,7 +10061,12 @@ size_t DisconnectionFrame::ByteSizeLong() const {
       total_size += 1 + 1;
     }
 
-  }
+    // optional bool park_connection = 3;
+    if (cached_has_bits & 0x00000004u) {
+      total_size += 1 + 1;
+    }
+
+  }
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
   }
@@ -9515,13 +10088,16 @@ void DisconnectionFrame::MergeFrom(const DisconnectionFrame& from) {
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
       request_safe_to_disconnect_ = from.request_safe_to_disconnect_;
     }
     if (cached_has_bits & 0x00000002u) {
       ack_safe_to_disconnect_ = from.ack_safe_to_disconnect_;
     }
+    if (cached_has_bits & 0x00000004u) {
+      park_connection_ = from.park_connection_;
+    }
     _has_bits_[0] |= cached_has_bits;
   }
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
@@ -9543,8 +10119,8 @@ void DisconnectionFrame::InternalSwap(DisconnectionFrame* other) {
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   swap(_has_bits_[0], other->_has_bits_[0]);
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(DisconnectionFrame, ack_safe_to_disconnect_)
-      + sizeof(DisconnectionFrame::ack_safe_to_disconnect_)
+      PROTOBUF_FIELD_OFFSET(DisconnectionFrame, park_connection_)
+      + sizeof(DisconnectionFrame::park_connection_)
       - PROTOBUF_FIELD_OFFSET(DisconnectionFrame, request_safe_to_disconnect_)>(
           reinterpret_cast<char*>(&request_safe_to_disconnect_),
           reinterpret_cast<char*>(&other->request_safe_to_disconnect_));
@@ -10426,6 +11002,320 @@ std::string AutoResumeFrame::GetTypeName() const {
 }
 
 
+// ===================================================================
+
+class AutoReconnectFrame_SessionResumption::_Internal {
+ public:
+  using HasBits = decltype(std::declval<AutoReconnectFrame_SessionResumption>()._has_bits_);
+  static void set_has_ticket_id(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+  static void set_has_nonce(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static void set_has_mac(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
+};
+
+AutoReconnectFrame_SessionResumption::AutoReconnectFrame_SessionResumption(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor();
+  if (!is_message_owned) {
+    RegisterArenaDtor(arena);
+  }
+  // @@protoc_insertion_point(arena_constructor:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+}
+AutoReconnectFrame_SessionResumption::AutoReconnectFrame_SessionResumption(const AutoReconnectFrame_SessionResumption& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  ticket_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    ticket_id_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_ticket_id()) {
+    ticket_id_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_ticket_id(), 
+      GetArenaForAllocation());
+  }
+  nonce_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    nonce_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_nonce()) {
+    nonce_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_nonce(), 
+      GetArenaForAllocation());
+  }
+  mac_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    mac_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_mac()) {
+    mac_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_mac(), 
+      GetArenaForAllocation());
+  }
+  // @@protoc_insertion_point(copy_constructor:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+}
+
+inline void AutoReconnectFrame_SessionResumption::SharedCtor() {
+ticket_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  ticket_id_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+nonce_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  nonce_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+mac_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  mac_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+}
+
+AutoReconnectFrame_SessionResumption::~AutoReconnectFrame_SessionResumption() {
+  // @@protoc_insertion_point(destructor:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+  if (GetArenaForAllocation() != nullptr) return;
+  SharedDtor();
+  _internal_metadata_.Delete<std::string>();
+}
+
+inline void AutoReconnectFrame_SessionResumption::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  ticket_id_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  nonce_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  mac_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+
+void AutoReconnectFrame_SessionResumption::ArenaDtor(void* object) {
+  AutoReconnectFrame_SessionResumption* _this = reinterpret_cast< AutoReconnectFrame_SessionResumption* >(object);
+  (void)_this;
+}
+void AutoReconnectFrame_SessionResumption::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+}
+void AutoReconnectFrame_SessionResumption::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+
+void AutoReconnectFrame_SessionResumption::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000007u) {
+    if (cached_has_bits & 0x00000001u) {
+      ticket_id_.ClearNonDefaultToEmpty();
+    }
+    if (cached_has_bits & 0x00000002u) {
+      nonce_.ClearNonDefaultToEmpty();
+    }
+    if (cached_has_bits & 0x00000004u) {
+      mac_.ClearNonDefaultToEmpty();
+    }
+  }
+  _has_bits_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* AutoReconnectFrame_SessionResumption::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional bytes ticket_id = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 10)) {
+          auto str = _internal_mutable_ticket_id();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bytes nonce = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 18)) {
+          auto str = _internal_mutable_nonce();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bytes mac = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          auto str = _internal_mutable_mac();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* AutoReconnectFrame_SessionResumption::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // optional bytes ticket_id = 1;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->WriteBytesMaybeAliased(
+        1, this->_internal_ticket_id(), target);
+  }
+
+  // optional bytes nonce = 2;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->WriteBytesMaybeAliased(
+        2, this->_internal_nonce(), target);
+  }
+
+  // optional bytes mac = 3;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->WriteBytesMaybeAliased(
+        3, this->_internal_mac(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+  return target;
+}
+
+size_t AutoReconnectFrame_SessionResumption::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000007u) {
+    // optional bytes ticket_id = 1;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_ticket_id());
+    }
+
+    // optional bytes nonce = 2;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_nonce());
+    }
+
+    // optional bytes mac = 3;
+    if (cached_has_bits & 0x00000004u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::BytesSize(
+          this->_internal_mac());
+    }
+
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void AutoReconnectFrame_SessionResumption::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::PROTOBUF_NAMESPACE_ID::internal::DownCast<const AutoReconnectFrame_SessionResumption*>(
+      &from));
+}
+
+void AutoReconnectFrame_SessionResumption::MergeFrom(const AutoReconnectFrame_SessionResumption& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+  GOOGLE_DCHECK_NE(&from, this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 0x00000007u) {
+    if (cached_has_bits & 0x00000001u) {
+      _internal_set_ticket_id(from._internal_ticket_id());
+    }
+    if (cached_has_bits & 0x00000002u) {
+      _internal_set_nonce(from._internal_nonce());
+    }
+    if (cached_has_bits & 0x00000004u) {
+      _internal_set_mac(from._internal_mac());
+    }
+  }
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void AutoReconnectFrame_SessionResumption::CopyFrom(const AutoReconnectFrame_SessionResumption& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool AutoReconnectFrame_SessionResumption::IsInitialized() const {
+  return true;
+}
+
+void AutoReconnectFrame_SessionResumption::InternalSwap(AutoReconnectFrame_SessionResumption* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      &ticket_id_, lhs_arena,
+      &other->ticket_id_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      &nonce_, lhs_arena,
+      &other->nonce_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      &mac_, lhs_arena,
+      &other->mac_, rhs_arena
+  );
+}
+
+std::string AutoReconnectFrame_SessionResumption::GetTypeName() const {
+  return "location.nearby.connections.AutoReconnectFrame.SessionResumption";
+}
+
+
 // ===================================================================
 
 class AutoReconnectFrame::_Internal {
@@ -10435,10 +11325,18 @@ class AutoReconnectFrame::_Internal {
     (*has_bits)[0] |= 1u;
   }
   static void set_has_event_type(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
+  static const ::location::nearby::connections::AutoReconnectFrame_SessionResumption& session_resumption(const AutoReconnectFrame* msg);
+  static void set_has_session_resumption(HasBits* has_bits) {
     (*has_bits)[0] |= 2u;
   }
 };
 
+const ::location::nearby::connections::AutoReconnectFrame_SessionResumption&
+AutoReconnectFrame::_Internal::session_resumption(const AutoReconnectFrame* msg) {
+  return *msg->session_resumption_;
+}
 AutoReconnectFrame::AutoReconnectFrame(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
@@ -10460,6 +11358,11 @@ AutoReconnectFrame::AutoReconnectFrame(const AutoReconnectFrame& from)
     endpoint_id_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_endpoint_id(), 
       GetArenaForAllocation());
   }
+  if (from._internal_has_session_resumption()) {
+    session_resumption_ = new ::location::nearby::connections::AutoReconnectFrame_SessionResumption(*from.session_resumption_);
+  } else {
+    session_resumption_ = nullptr;
+  }
   event_type_ = from.event_type_;
   // @@protoc_insertion_point(copy_constructor:location.nearby.connections.AutoReconnectFrame)
 }
@@ -10469,7 +11372,10 @@ endpoint_id_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString
 #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
   endpoint_id_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-event_type_ = 0;
+::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
+    reinterpret_cast<char*>(&session_resumption_) - reinterpret_cast<char*>(this)),
+    0, static_cast<size_t>(reinterpret_cast<char*>(&event_type_) -
+    reinterpret_cast<char*>(&session_resumption_)) + sizeof(event_type_));
 }
 
 AutoReconnectFrame::~AutoReconnectFrame() {
@@ -10482,6 +11388,7 @@ AutoReconnectFrame::~AutoReconnectFrame() {
 inline void AutoReconnectFrame::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   endpoint_id_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  if (this != internal_default_instance()) delete session_resumption_;
 }
 
 void AutoReconnectFrame::ArenaDtor(void* object) {
@@ -10501,8 +11408,14 @@ void AutoReconnectFrame::Clear() {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000001u) {
-    endpoint_id_.ClearNonDefaultToEmpty();
+  if (cached_has_bits & 0x00000003u) {
+    if (cached_has_bits & 0x00000001u) {
+      endpoint_id_.ClearNonDefaultToEmpty();
+    }
+    if (cached_has_bits & 0x00000002u) {
+      GOOGLE_DCHECK(session_resumption_ != nullptr);
+      session_resumption_->Clear();
+    }
   }
   event_type_ = 0;
   _has_bits_.Clear();
@@ -10538,6 +11451,14 @@ const char* AutoReconnectFrame::_InternalParse(const char* ptr, ::PROTOBUF_NAMES
         } else
           goto handle_unusual;
         continue;
+      // optional .location.nearby.connections.AutoReconnectFrame.SessionResumption session_resumption = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 26)) {
+          ptr = ctx->ParseMessage(_internal_mutable_session_resumption(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -10576,12 +11497,20 @@ uint8_t* AutoReconnectFrame::_InternalSerialize(
   }
 
   // optional .location.nearby.connections.AutoReconnectFrame.EventType event_type = 2;
-  if (cached_has_bits & 0x00000002u) {
+  if (cached_has_bits & 0x00000004u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       2, this->_internal_event_type(), target);
   }
 
+  // optional .location.nearby.connections.AutoReconnectFrame.SessionResumption session_resumption = 3;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        3, _Internal::session_resumption(this), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -10599,7 +11528,7 @@ size_t AutoReconnectFrame::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     // optional string endpoint_id = 1;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -10607,8 +11536,15 @@ size_t AutoReconnectFrame::ByteSizeLong() const {
           this->_internal_endpoint_id());
     }
 
-    // optional .location.nearby.connections.AutoReconnectFrame.EventType event_type = 2;
+    // optional .location.nearby.connections.AutoReconnectFrame.SessionResumption session_resumption = 3;
     if (cached_has_bits & 0x00000002u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *session_resumption_);
+    }
+
+    // optional .location.nearby.connections.AutoReconnectFrame.EventType event_type = 2;
+    if (cached_has_bits & 0x00000004u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_event_type());
     }
@@ -10635,11 +11571,14 @@ void AutoReconnectFrame::MergeFrom(const AutoReconnectFrame& from) {
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
       _internal_set_endpoint_id(from._internal_endpoint_id());
     }
     if (cached_has_bits & 0x00000002u) {
+      _internal_mutable_session_resumption()->::location::nearby::connections::AutoReconnectFrame_SessionResumption::MergeFrom(from._internal_session_resumption());
+    }
+    if (cached_has_bits & 0x00000004u) {
       event_type_ = from.event_type_;
     }
     _has_bits_[0] |= cached_has_bits;
@@ -10669,7 +11608,12 @@ void AutoReconnectFrame::InternalSwap(AutoReconnectFrame* other) {
       &endpoint_id_, lhs_arena,
       &other->endpoint_id_, rhs_arena
   );
-  swap(event_type_, other->event_type_);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(AutoReconnectFrame, event_type_)
+      + sizeof(AutoReconnectFrame::event_type_)
+      - PROTOBUF_FIELD_OFFSET(AutoReconnectFrame, session_resumption_)>(
+          reinterpret_cast<char*>(&session_resumption_),
+          reinterpret_cast<char*>(&other->session_resumption_));
 }
 
 std::string AutoReconnectFrame::GetTypeName() const {
@@ -13799,6 +14743,9 @@ template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFra
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFrame_PayloadChunk* Arena::CreateMaybeMessage< ::location::nearby::connections::PayloadTransferFrame_PayloadChunk >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::PayloadTransferFrame_PayloadChunk >(arena);
 }
+template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* Arena::CreateMaybeMessage< ::location::nearby::connections::PayloadTransferFrame_BatchedPayload >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::location::nearby::connections::PayloadTransferFrame_BatchedPayload >(arena);
+}
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::PayloadTransferFrame_ControlMessage* Arena::CreateMaybeMessage< ::location::nearby::connections::PayloadTransferFrame_ControlMessage >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::PayloadTransferFrame_ControlMessage >(arena);
 }
@@ -13859,6 +14806,9 @@ template<> PROTOBUF_NOINLINE ::location::nearby::connections::AuthenticationResu
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::AutoResumeFrame* Arena::CreateMaybeMessage< ::location::nearby::connections::AutoResumeFrame >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::AutoResumeFrame >(arena);
 }
+template<> PROTOBUF_NOINLINE ::location::nearby::connections::AutoReconnectFrame_SessionResumption* Arena::CreateMaybeMessage< ::location::nearby::connections::AutoReconnectFrame_SessionResumption >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::location::nearby::connections::AutoReconnectFrame_SessionResumption >(arena);
+}
 template<> PROTOBUF_NOINLINE ::location::nearby::connections::AutoReconnectFrame* Arena::CreateMaybeMessage< ::location::nearby::connections::AutoReconnectFrame >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::connections::AutoReconnectFrame >(arena);
 }
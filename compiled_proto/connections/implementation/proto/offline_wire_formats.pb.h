@@ -45,7 +45,7 @@ struct TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fforma
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::AuxiliaryParseTableField aux[]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[38]
+  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[40]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::FieldMetadata field_metadata[];
   static const ::PROTOBUF_NAMESPACE_ID::internal::SerializationTable serialization_table[];
@@ -63,6 +63,9 @@ extern AuthenticationResultFrameDefaultTypeInternal _AuthenticationResultFrame_d
 class AutoReconnectFrame;
 struct AutoReconnectFrameDefaultTypeInternal;
 extern AutoReconnectFrameDefaultTypeInternal _AutoReconnectFrame_default_instance_;
+class AutoReconnectFrame_SessionResumption;
+struct AutoReconnectFrame_SessionResumptionDefaultTypeInternal;
+extern AutoReconnectFrame_SessionResumptionDefaultTypeInternal _AutoReconnectFrame_SessionResumption_default_instance_;
 class AutoResumeFrame;
 struct AutoResumeFrameDefaultTypeInternal;
 extern AutoResumeFrameDefaultTypeInternal _AutoResumeFrame_default_instance_;
@@ -141,6 +144,9 @@ extern PairedKeyEncryptionFrameDefaultTypeInternal _PairedKeyEncryptionFrame_def
 class PayloadTransferFrame;
 struct PayloadTransferFrameDefaultTypeInternal;
 extern PayloadTransferFrameDefaultTypeInternal _PayloadTransferFrame_default_instance_;
+class PayloadTransferFrame_BatchedPayload;
+struct PayloadTransferFrame_BatchedPayloadDefaultTypeInternal;
+extern PayloadTransferFrame_BatchedPayloadDefaultTypeInternal _PayloadTransferFrame_BatchedPayload_default_instance_;
 class PayloadTransferFrame_ControlMessage;
 struct PayloadTransferFrame_ControlMessageDefaultTypeInternal;
 extern PayloadTransferFrame_ControlMessageDefaultTypeInternal _PayloadTransferFrame_ControlMessage_default_instance_;
@@ -175,6 +181,7 @@ PROTOBUF_NAMESPACE_OPEN
 template<> ::location::nearby::connections::AuthenticationMessageFrame* Arena::CreateMaybeMessage<::location::nearby::connections::AuthenticationMessageFrame>(Arena*);
 template<> ::location::nearby::connections::AuthenticationResultFrame* Arena::CreateMaybeMessage<::location::nearby::connections::AuthenticationResultFrame>(Arena*);
 template<> ::location::nearby::connections::AutoReconnectFrame* Arena::CreateMaybeMessage<::location::nearby::connections::AutoReconnectFrame>(Arena*);
+template<> ::location::nearby::connections::AutoReconnectFrame_SessionResumption* Arena::CreateMaybeMessage<::location::nearby::connections::AutoReconnectFrame_SessionResumption>(Arena*);
 template<> ::location::nearby::connections::AutoResumeFrame* Arena::CreateMaybeMessage<::location::nearby::connections::AutoResumeFrame>(Arena*);
 template<> ::location::nearby::connections::AvailableChannels* Arena::CreateMaybeMessage<::location::nearby::connections::AvailableChannels>(Arena*);
 template<> ::location::nearby::connections::BandwidthUpgradeNegotiationFrame* Arena::CreateMaybeMessage<::location::nearby::connections::BandwidthUpgradeNegotiationFrame>(Arena*);
@@ -201,6 +208,7 @@ template<> ::location::nearby::connections::OfflineFrame* Arena::CreateMaybeMess
 template<> ::location::nearby::connections::OsInfo* Arena::CreateMaybeMessage<::location::nearby::connections::OsInfo>(Arena*);
 template<> ::location::nearby::connections::PairedKeyEncryptionFrame* Arena::CreateMaybeMessage<::location::nearby::connections::PairedKeyEncryptionFrame>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame>(Arena*);
+template<> ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_BatchedPayload>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame_ControlMessage* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_ControlMessage>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame_PayloadChunk* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_PayloadChunk>(Arena*);
 template<> ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* Arena::CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_PayloadHeader>(Arena*);
@@ -355,11 +363,12 @@ inline const std::string& PayloadTransferFrame_PayloadHeader_PayloadType_Name(T
 bool PayloadTransferFrame_PayloadHeader_PayloadType_Parse(
     ::PROTOBUF_NAMESPACE_ID::ConstStringParam name, PayloadTransferFrame_PayloadHeader_PayloadType* value);
 enum PayloadTransferFrame_PayloadChunk_Flags : int {
-  PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK = 1
+  PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK = 1,
+  PayloadTransferFrame_PayloadChunk_Flags_COMPRESSED = 2
 };
 bool PayloadTransferFrame_PayloadChunk_Flags_IsValid(int value);
 constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk_Flags_Flags_MIN = PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK;
-constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk_Flags_Flags_MAX = PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK;
+constexpr PayloadTransferFrame_PayloadChunk_Flags PayloadTransferFrame_PayloadChunk_Flags_Flags_MAX = PayloadTransferFrame_PayloadChunk_Flags_COMPRESSED;
 constexpr int PayloadTransferFrame_PayloadChunk_Flags_Flags_ARRAYSIZE = PayloadTransferFrame_PayloadChunk_Flags_Flags_MAX + 1;
 
 const std::string& PayloadTransferFrame_PayloadChunk_Flags_Name(PayloadTransferFrame_PayloadChunk_Flags value);
@@ -397,11 +406,12 @@ enum PayloadTransferFrame_PacketType : int {
   PayloadTransferFrame_PacketType_UNKNOWN_PACKET_TYPE = 0,
   PayloadTransferFrame_PacketType_DATA = 1,
   PayloadTransferFrame_PacketType_CONTROL = 2,
-  PayloadTransferFrame_PacketType_PAYLOAD_ACK = 3
+  PayloadTransferFrame_PacketType_PAYLOAD_ACK = 3,
+  PayloadTransferFrame_PacketType_BATCHED_DATA = 4
 };
 bool PayloadTransferFrame_PacketType_IsValid(int value);
 constexpr PayloadTransferFrame_PacketType PayloadTransferFrame_PacketType_PacketType_MIN = PayloadTransferFrame_PacketType_UNKNOWN_PACKET_TYPE;
-constexpr PayloadTransferFrame_PacketType PayloadTransferFrame_PacketType_PacketType_MAX = PayloadTransferFrame_PacketType_PAYLOAD_ACK;
+constexpr PayloadTransferFrame_PacketType PayloadTransferFrame_PacketType_PacketType_MAX = PayloadTransferFrame_PacketType_BATCHED_DATA;
 constexpr int PayloadTransferFrame_PacketType_PacketType_ARRAYSIZE = PayloadTransferFrame_PacketType_PacketType_MAX + 1;
 
 const std::string& PayloadTransferFrame_PacketType_Name(PayloadTransferFrame_PacketType value);
@@ -1860,11 +1870,16 @@ class ConnectionResponseFrame final :
   enum : int {
     kHandshakeDataFieldNumber = 2,
     kOsInfoFieldNumber = 4,
+    kLocationHintFieldNumber = 8,
     kStatusFieldNumber = 1,
     kResponseFieldNumber = 3,
     kMultiplexSocketBitmaskFieldNumber = 5,
     kNearbyConnectionsVersionFieldNumber = 6,
     kSafeToDisconnectVersionFieldNumber = 7,
+    kKeepAliveTimeoutMillisFieldNumber = 9,
+    kAeadRecordLayerVersionFieldNumber = 10,
+    kPayloadCompressionVersionFieldNumber = 11,
+    kPayloadBatchingVersionFieldNumber = 12,
   };
   // optional bytes handshake_data = 2;
   bool has_handshake_data() const;
@@ -1902,6 +1917,24 @@ class ConnectionResponseFrame final :
       ::location::nearby::connections::OsInfo* os_info);
   ::location::nearby::connections::OsInfo* unsafe_arena_release_os_info();
 
+  // optional .location.nearby.connections.LocationHint location_hint = 8;
+  bool has_location_hint() const;
+  private:
+  bool _internal_has_location_hint() const;
+  public:
+  void clear_location_hint();
+  const ::location::nearby::connections::LocationHint& location_hint() const;
+  PROTOBUF_NODISCARD ::location::nearby::connections::LocationHint* release_location_hint();
+  ::location::nearby::connections::LocationHint* mutable_location_hint();
+  void set_allocated_location_hint(::location::nearby::connections::LocationHint* location_hint);
+  private:
+  const ::location::nearby::connections::LocationHint& _internal_location_hint() const;
+  ::location::nearby::connections::LocationHint* _internal_mutable_location_hint();
+  public:
+  void unsafe_arena_set_allocated_location_hint(
+      ::location::nearby::connections::LocationHint* location_hint);
+  ::location::nearby::connections::LocationHint* unsafe_arena_release_location_hint();
+
   // optional int32 status = 1 [deprecated = true];
   PROTOBUF_DEPRECATED bool has_status() const;
   private:
@@ -1967,6 +2000,58 @@ class ConnectionResponseFrame final :
   void _internal_set_safe_to_disconnect_version(int32_t value);
   public:
 
+  // optional int32 keep_alive_timeout_millis = 9;
+  bool has_keep_alive_timeout_millis() const;
+  private:
+  bool _internal_has_keep_alive_timeout_millis() const;
+  public:
+  void clear_keep_alive_timeout_millis();
+  int32_t keep_alive_timeout_millis() const;
+  void set_keep_alive_timeout_millis(int32_t value);
+  private:
+  int32_t _internal_keep_alive_timeout_millis() const;
+  void _internal_set_keep_alive_timeout_millis(int32_t value);
+  public:
+
+  // optional int32 aead_record_layer_version = 10;
+  bool has_aead_record_layer_version() const;
+  private:
+  bool _internal_has_aead_record_layer_version() const;
+  public:
+  void clear_aead_record_layer_version();
+  int32_t aead_record_layer_version() const;
+  void set_aead_record_layer_version(int32_t value);
+  private:
+  int32_t _internal_aead_record_layer_version() const;
+  void _internal_set_aead_record_layer_version(int32_t value);
+  public:
+
+  // optional int32 payload_compression_version = 11;
+  bool has_payload_compression_version() const;
+  private:
+  bool _internal_has_payload_compression_version() const;
+  public:
+  void clear_payload_compression_version();
+  int32_t payload_compression_version() const;
+  void set_payload_compression_version(int32_t value);
+  private:
+  int32_t _internal_payload_compression_version() const;
+  void _internal_set_payload_compression_version(int32_t value);
+  public:
+
+  // optional int32 payload_batching_version = 12;
+  bool has_payload_batching_version() const;
+  private:
+  bool _internal_has_payload_batching_version() const;
+  public:
+  void clear_payload_batching_version();
+  int32_t payload_batching_version() const;
+  void set_payload_batching_version(int32_t value);
+  private:
+  int32_t _internal_payload_batching_version() const;
+  void _internal_set_payload_batching_version(int32_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:location.nearby.connections.ConnectionResponseFrame)
  private:
   class _Internal;
@@ -1978,11 +2063,16 @@ class ConnectionResponseFrame final :
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr handshake_data_;
   ::location::nearby::connections::OsInfo* os_info_;
+  ::location::nearby::connections::LocationHint* location_hint_;
   int32_t status_;
   int response_;
   int32_t multiplex_socket_bitmask_;
   int32_t nearby_connections_version_;
   int32_t safe_to_disconnect_version_;
+  int32_t keep_alive_timeout_millis_;
+  int32_t aead_record_layer_version_;
+  int32_t payload_compression_version_;
+  int32_t payload_batching_version_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
 };
 // -------------------------------------------------------------------
@@ -2357,6 +2447,8 @@ class PayloadTransferFrame_PayloadChunk final :
   typedef PayloadTransferFrame_PayloadChunk_Flags Flags;
   static constexpr Flags LAST_CHUNK =
     PayloadTransferFrame_PayloadChunk_Flags_LAST_CHUNK;
+  static constexpr Flags COMPRESSED =
+    PayloadTransferFrame_PayloadChunk_Flags_COMPRESSED;
   static inline bool Flags_IsValid(int value) {
     return PayloadTransferFrame_PayloadChunk_Flags_IsValid(value);
   }
@@ -2382,6 +2474,7 @@ class PayloadTransferFrame_PayloadChunk final :
 
   enum : int {
     kBodyFieldNumber = 3,
+    kSha256DigestFieldNumber = 5,
     kOffsetFieldNumber = 2,
     kFlagsFieldNumber = 1,
     kIndexFieldNumber = 4,
@@ -2404,6 +2497,24 @@ class PayloadTransferFrame_PayloadChunk final :
   std::string* _internal_mutable_body();
   public:
 
+  // optional bytes sha256_digest = 5;
+  bool has_sha256_digest() const;
+  private:
+  bool _internal_has_sha256_digest() const;
+  public:
+  void clear_sha256_digest();
+  const std::string& sha256_digest() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_sha256_digest(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_sha256_digest();
+  PROTOBUF_NODISCARD std::string* release_sha256_digest();
+  void set_allocated_sha256_digest(std::string* sha256_digest);
+  private:
+  const std::string& _internal_sha256_digest() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_sha256_digest(const std::string& value);
+  std::string* _internal_mutable_sha256_digest();
+  public:
+
   // optional int64 offset = 2;
   bool has_offset() const;
   private:
@@ -2453,6 +2564,7 @@ class PayloadTransferFrame_PayloadChunk final :
   ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr body_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr sha256_digest_;
   int64_t offset_;
   int32_t flags_;
   int32_t index_;
@@ -2460,6 +2572,173 @@ class PayloadTransferFrame_PayloadChunk final :
 };
 // -------------------------------------------------------------------
 
+class PayloadTransferFrame_BatchedPayload final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.PayloadTransferFrame.BatchedPayload) */ {
+ public:
+  inline PayloadTransferFrame_BatchedPayload() : PayloadTransferFrame_BatchedPayload(nullptr) {}
+  ~PayloadTransferFrame_BatchedPayload() override;
+  explicit constexpr PayloadTransferFrame_BatchedPayload(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  PayloadTransferFrame_BatchedPayload(const PayloadTransferFrame_BatchedPayload& from);
+  PayloadTransferFrame_BatchedPayload(PayloadTransferFrame_BatchedPayload&& from) noexcept
+    : PayloadTransferFrame_BatchedPayload() {
+    *this = ::std::move(from);
+  }
+
+  inline PayloadTransferFrame_BatchedPayload& operator=(const PayloadTransferFrame_BatchedPayload& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline PayloadTransferFrame_BatchedPayload& operator=(PayloadTransferFrame_BatchedPayload&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString);
+  }
+  inline std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<std::string>();
+  }
+
+  static const PayloadTransferFrame_BatchedPayload& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const PayloadTransferFrame_BatchedPayload* internal_default_instance() {
+    return reinterpret_cast<const PayloadTransferFrame_BatchedPayload*>(
+               &_PayloadTransferFrame_BatchedPayload_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    6;
+
+  friend void swap(PayloadTransferFrame_BatchedPayload& a, PayloadTransferFrame_BatchedPayload& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(PayloadTransferFrame_BatchedPayload* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(PayloadTransferFrame_BatchedPayload* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  PayloadTransferFrame_BatchedPayload* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<PayloadTransferFrame_BatchedPayload>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const PayloadTransferFrame_BatchedPayload& from);
+  void MergeFrom(const PayloadTransferFrame_BatchedPayload& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(PayloadTransferFrame_BatchedPayload* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "location.nearby.connections.PayloadTransferFrame.BatchedPayload";
+  }
+  protected:
+  explicit PayloadTransferFrame_BatchedPayload(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kBodyFieldNumber = 2,
+    kPayloadHeaderFieldNumber = 1,
+  };
+  // optional bytes body = 2;
+  bool has_body() const;
+  private:
+  bool _internal_has_body() const;
+  public:
+  void clear_body();
+  const std::string& body() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_body(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_body();
+  PROTOBUF_NODISCARD std::string* release_body();
+  void set_allocated_body(std::string* body);
+  private:
+  const std::string& _internal_body() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_body(const std::string& value);
+  std::string* _internal_mutable_body();
+  public:
+
+  // optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader payload_header = 1;
+  bool has_payload_header() const;
+  private:
+  bool _internal_has_payload_header() const;
+  public:
+  void clear_payload_header();
+  const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader& payload_header() const;
+  PROTOBUF_NODISCARD ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* release_payload_header();
+  ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* mutable_payload_header();
+  void set_allocated_payload_header(::location::nearby::connections::PayloadTransferFrame_PayloadHeader* payload_header);
+  private:
+  const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader& _internal_payload_header() const;
+  ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* _internal_mutable_payload_header();
+  public:
+  void unsafe_arena_set_allocated_payload_header(
+      ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* payload_header);
+  ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* unsafe_arena_release_payload_header();
+
+  // @@protoc_insertion_point(class_scope:location.nearby.connections.PayloadTransferFrame.BatchedPayload)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr body_;
+  ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* payload_header_;
+  friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
+};
+// -------------------------------------------------------------------
+
 class PayloadTransferFrame_ControlMessage final :
     public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.PayloadTransferFrame.ControlMessage) */ {
  public:
@@ -2506,7 +2785,7 @@ class PayloadTransferFrame_ControlMessage final :
                &_PayloadTransferFrame_ControlMessage_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    6;
+    7;
 
   friend void swap(PayloadTransferFrame_ControlMessage& a, PayloadTransferFrame_ControlMessage& b) {
     a.Swap(&b);
@@ -2693,7 +2972,7 @@ class PayloadTransferFrame final :
                &_PayloadTransferFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    7;
+    8;
 
   friend void swap(PayloadTransferFrame& a, PayloadTransferFrame& b) {
     a.Swap(&b);
@@ -2759,6 +3038,7 @@ class PayloadTransferFrame final :
 
   typedef PayloadTransferFrame_PayloadHeader PayloadHeader;
   typedef PayloadTransferFrame_PayloadChunk PayloadChunk;
+  typedef PayloadTransferFrame_BatchedPayload BatchedPayload;
   typedef PayloadTransferFrame_ControlMessage ControlMessage;
 
   typedef PayloadTransferFrame_PacketType PacketType;
@@ -2770,6 +3050,8 @@ class PayloadTransferFrame final :
     PayloadTransferFrame_PacketType_CONTROL;
   static constexpr PacketType PAYLOAD_ACK =
     PayloadTransferFrame_PacketType_PAYLOAD_ACK;
+  static constexpr PacketType BATCHED_DATA =
+    PayloadTransferFrame_PacketType_BATCHED_DATA;
   static inline bool PacketType_IsValid(int value) {
     return PayloadTransferFrame_PacketType_IsValid(value);
   }
@@ -2794,11 +3076,30 @@ class PayloadTransferFrame final :
   // accessors -------------------------------------------------------
 
   enum : int {
+    kBatchedPayloadsFieldNumber = 5,
     kPayloadHeaderFieldNumber = 2,
     kPayloadChunkFieldNumber = 3,
     kControlMessageFieldNumber = 4,
     kPacketTypeFieldNumber = 1,
   };
+  // repeated .location.nearby.connections.PayloadTransferFrame.BatchedPayload batched_payloads = 5;
+  int batched_payloads_size() const;
+  private:
+  int _internal_batched_payloads_size() const;
+  public:
+  void clear_batched_payloads();
+  ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* mutable_batched_payloads(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::connections::PayloadTransferFrame_BatchedPayload >*
+      mutable_batched_payloads();
+  private:
+  const ::location::nearby::connections::PayloadTransferFrame_BatchedPayload& _internal_batched_payloads(int index) const;
+  ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* _internal_add_batched_payloads();
+  public:
+  const ::location::nearby::connections::PayloadTransferFrame_BatchedPayload& batched_payloads(int index) const;
+  ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* add_batched_payloads();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::connections::PayloadTransferFrame_BatchedPayload >&
+      batched_payloads() const;
+
   // optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader payload_header = 2;
   bool has_payload_header() const;
   private:
@@ -2875,6 +3176,7 @@ class PayloadTransferFrame final :
   typedef void DestructorSkippable_;
   ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::connections::PayloadTransferFrame_BatchedPayload > batched_payloads_;
   ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* payload_header_;
   ::location::nearby::connections::PayloadTransferFrame_PayloadChunk* payload_chunk_;
   ::location::nearby::connections::PayloadTransferFrame_ControlMessage* control_message_;
@@ -2929,7 +3231,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials fi
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    8;
+    9;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials& b) {
     a.Swap(&b);
@@ -3147,7 +3449,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket final :
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    9;
+    10;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiLanSocket& b) {
     a.Swap(&b);
@@ -3309,7 +3611,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials fina
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    10;
+    11;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_BluetoothCredentials& b) {
     a.Swap(&b);
@@ -3476,7 +3778,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials fina
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    11;
+    12;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiAwareCredentials& b) {
     a.Swap(&b);
@@ -3663,7 +3965,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials fin
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    12;
+    13;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiDirectCredentials& b) {
     a.Swap(&b);
@@ -3901,7 +4203,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials final :
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    13;
+    14;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WebRtcCredentials& b) {
     a.Swap(&b);
@@ -4068,7 +4370,7 @@ class BandwidthUpgradeNegotiationFrame_UpgradePathInfo final :
                &_BandwidthUpgradeNegotiationFrame_UpgradePathInfo_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    14;
+    15;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_UpgradePathInfo& a, BandwidthUpgradeNegotiationFrame_UpgradePathInfo& b) {
     a.Swap(&b);
@@ -4413,7 +4715,7 @@ class BandwidthUpgradeNegotiationFrame_SafeToClosePriorChannel final :
                &_BandwidthUpgradeNegotiationFrame_SafeToClosePriorChannel_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    15;
+    16;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_SafeToClosePriorChannel& a, BandwidthUpgradeNegotiationFrame_SafeToClosePriorChannel& b) {
     a.Swap(&b);
@@ -4555,7 +4857,7 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroduction final :
                &_BandwidthUpgradeNegotiationFrame_ClientIntroduction_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    16;
+    17;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_ClientIntroduction& a, BandwidthUpgradeNegotiationFrame_ClientIntroduction& b) {
     a.Swap(&b);
@@ -4717,7 +5019,7 @@ class BandwidthUpgradeNegotiationFrame_ClientIntroductionAck final :
                &_BandwidthUpgradeNegotiationFrame_ClientIntroductionAck_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    17;
+    18;
 
   friend void swap(BandwidthUpgradeNegotiationFrame_ClientIntroductionAck& a, BandwidthUpgradeNegotiationFrame_ClientIntroductionAck& b) {
     a.Swap(&b);
@@ -4841,7 +5143,7 @@ class BandwidthUpgradeNegotiationFrame final :
                &_BandwidthUpgradeNegotiationFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    18;
+    19;
 
   friend void swap(BandwidthUpgradeNegotiationFrame& a, BandwidthUpgradeNegotiationFrame& b) {
     a.Swap(&b);
@@ -5104,7 +5406,7 @@ class BandwidthUpgradeRetryFrame final :
                &_BandwidthUpgradeRetryFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    19;
+    20;
 
   friend void swap(BandwidthUpgradeRetryFrame& a, BandwidthUpgradeRetryFrame& b) {
     a.Swap(&b);
@@ -5311,7 +5613,7 @@ class KeepAliveFrame final :
                &_KeepAliveFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    20;
+    21;
 
   friend void swap(KeepAliveFrame& a, KeepAliveFrame& b) {
     a.Swap(&b);
@@ -5468,7 +5770,7 @@ class DisconnectionFrame final :
                &_DisconnectionFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    21;
+    22;
 
   friend void swap(DisconnectionFrame& a, DisconnectionFrame& b) {
     a.Swap(&b);
@@ -5537,6 +5839,7 @@ class DisconnectionFrame final :
   enum : int {
     kRequestSafeToDisconnectFieldNumber = 1,
     kAckSafeToDisconnectFieldNumber = 2,
+    kParkConnectionFieldNumber = 3,
   };
   // optional bool request_safe_to_disconnect = 1;
   bool has_request_safe_to_disconnect() const;
@@ -5564,6 +5867,19 @@ class DisconnectionFrame final :
   void _internal_set_ack_safe_to_disconnect(bool value);
   public:
 
+  // optional bool park_connection = 3;
+  bool has_park_connection() const;
+  private:
+  bool _internal_has_park_connection() const;
+  public:
+  void clear_park_connection();
+  bool park_connection() const;
+  void set_park_connection(bool value);
+  private:
+  bool _internal_park_connection() const;
+  void _internal_set_park_connection(bool value);
+  public:
+
   // @@protoc_insertion_point(class_scope:location.nearby.connections.DisconnectionFrame)
  private:
   class _Internal;
@@ -5575,6 +5891,7 @@ class DisconnectionFrame final :
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   bool request_safe_to_disconnect_;
   bool ack_safe_to_disconnect_;
+  bool park_connection_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
 };
 // -------------------------------------------------------------------
@@ -5625,7 +5942,7 @@ class PairedKeyEncryptionFrame final :
                &_PairedKeyEncryptionFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    22;
+    23;
 
   friend void swap(PairedKeyEncryptionFrame& a, PairedKeyEncryptionFrame& b) {
     a.Swap(&b);
@@ -5772,7 +6089,7 @@ class AuthenticationMessageFrame final :
                &_AuthenticationMessageFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    23;
+    24;
 
   friend void swap(AuthenticationMessageFrame& a, AuthenticationMessageFrame& b) {
     a.Swap(&b);
@@ -5919,7 +6236,7 @@ class AuthenticationResultFrame final :
                &_AuthenticationResultFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    24;
+    25;
 
   friend void swap(AuthenticationResultFrame& a, AuthenticationResultFrame& b) {
     a.Swap(&b);
@@ -6061,7 +6378,7 @@ class AutoResumeFrame final :
                &_AutoResumeFrame_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    25;
+    26;
 
   friend void swap(AutoResumeFrame& a, AutoResumeFrame& b) {
     a.Swap(&b);
@@ -6215,24 +6532,24 @@ class AutoResumeFrame final :
 };
 // -------------------------------------------------------------------
 
-class AutoReconnectFrame final :
-    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.AutoReconnectFrame) */ {
+class AutoReconnectFrame_SessionResumption final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.AutoReconnectFrame.SessionResumption) */ {
  public:
-  inline AutoReconnectFrame() : AutoReconnectFrame(nullptr) {}
-  ~AutoReconnectFrame() override;
-  explicit constexpr AutoReconnectFrame(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+  inline AutoReconnectFrame_SessionResumption() : AutoReconnectFrame_SessionResumption(nullptr) {}
+  ~AutoReconnectFrame_SessionResumption() override;
+  explicit constexpr AutoReconnectFrame_SessionResumption(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
 
-  AutoReconnectFrame(const AutoReconnectFrame& from);
-  AutoReconnectFrame(AutoReconnectFrame&& from) noexcept
-    : AutoReconnectFrame() {
+  AutoReconnectFrame_SessionResumption(const AutoReconnectFrame_SessionResumption& from);
+  AutoReconnectFrame_SessionResumption(AutoReconnectFrame_SessionResumption&& from) noexcept
+    : AutoReconnectFrame_SessionResumption() {
     *this = ::std::move(from);
   }
 
-  inline AutoReconnectFrame& operator=(const AutoReconnectFrame& from) {
+  inline AutoReconnectFrame_SessionResumption& operator=(const AutoReconnectFrame_SessionResumption& from) {
     CopyFrom(from);
     return *this;
   }
-  inline AutoReconnectFrame& operator=(AutoReconnectFrame&& from) noexcept {
+  inline AutoReconnectFrame_SessionResumption& operator=(AutoReconnectFrame_SessionResumption&& from) noexcept {
     if (this == &from) return *this;
     if (GetOwningArena() == from.GetOwningArena()
   #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
@@ -6253,15 +6570,202 @@ class AutoReconnectFrame final :
     return _internal_metadata_.mutable_unknown_fields<std::string>();
   }
 
-  static const AutoReconnectFrame& default_instance() {
+  static const AutoReconnectFrame_SessionResumption& default_instance() {
     return *internal_default_instance();
   }
-  static inline const AutoReconnectFrame* internal_default_instance() {
-    return reinterpret_cast<const AutoReconnectFrame*>(
-               &_AutoReconnectFrame_default_instance_);
+  static inline const AutoReconnectFrame_SessionResumption* internal_default_instance() {
+    return reinterpret_cast<const AutoReconnectFrame_SessionResumption*>(
+               &_AutoReconnectFrame_SessionResumption_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    26;
+    27;
+
+  friend void swap(AutoReconnectFrame_SessionResumption& a, AutoReconnectFrame_SessionResumption& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(AutoReconnectFrame_SessionResumption* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(AutoReconnectFrame_SessionResumption* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  AutoReconnectFrame_SessionResumption* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<AutoReconnectFrame_SessionResumption>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const AutoReconnectFrame_SessionResumption& from);
+  void MergeFrom(const AutoReconnectFrame_SessionResumption& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(AutoReconnectFrame_SessionResumption* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "location.nearby.connections.AutoReconnectFrame.SessionResumption";
+  }
+  protected:
+  explicit AutoReconnectFrame_SessionResumption(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kTicketIdFieldNumber = 1,
+    kNonceFieldNumber = 2,
+    kMacFieldNumber = 3,
+  };
+  // optional bytes ticket_id = 1;
+  bool has_ticket_id() const;
+  private:
+  bool _internal_has_ticket_id() const;
+  public:
+  void clear_ticket_id();
+  const std::string& ticket_id() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_ticket_id(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_ticket_id();
+  PROTOBUF_NODISCARD std::string* release_ticket_id();
+  void set_allocated_ticket_id(std::string* ticket_id);
+  private:
+  const std::string& _internal_ticket_id() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_ticket_id(const std::string& value);
+  std::string* _internal_mutable_ticket_id();
+  public:
+
+  // optional bytes nonce = 2;
+  bool has_nonce() const;
+  private:
+  bool _internal_has_nonce() const;
+  public:
+  void clear_nonce();
+  const std::string& nonce() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_nonce(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_nonce();
+  PROTOBUF_NODISCARD std::string* release_nonce();
+  void set_allocated_nonce(std::string* nonce);
+  private:
+  const std::string& _internal_nonce() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_nonce(const std::string& value);
+  std::string* _internal_mutable_nonce();
+  public:
+
+  // optional bytes mac = 3;
+  bool has_mac() const;
+  private:
+  bool _internal_has_mac() const;
+  public:
+  void clear_mac();
+  const std::string& mac() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_mac(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_mac();
+  PROTOBUF_NODISCARD std::string* release_mac();
+  void set_allocated_mac(std::string* mac);
+  private:
+  const std::string& _internal_mac() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_mac(const std::string& value);
+  std::string* _internal_mutable_mac();
+  public:
+
+  // @@protoc_insertion_point(class_scope:location.nearby.connections.AutoReconnectFrame.SessionResumption)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr ticket_id_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr nonce_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr mac_;
+  friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
+};
+// -------------------------------------------------------------------
+
+class AutoReconnectFrame final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.connections.AutoReconnectFrame) */ {
+ public:
+  inline AutoReconnectFrame() : AutoReconnectFrame(nullptr) {}
+  ~AutoReconnectFrame() override;
+  explicit constexpr AutoReconnectFrame(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  AutoReconnectFrame(const AutoReconnectFrame& from);
+  AutoReconnectFrame(AutoReconnectFrame&& from) noexcept
+    : AutoReconnectFrame() {
+    *this = ::std::move(from);
+  }
+
+  inline AutoReconnectFrame& operator=(const AutoReconnectFrame& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline AutoReconnectFrame& operator=(AutoReconnectFrame&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString);
+  }
+  inline std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<std::string>();
+  }
+
+  static const AutoReconnectFrame& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const AutoReconnectFrame* internal_default_instance() {
+    return reinterpret_cast<const AutoReconnectFrame*>(
+               &_AutoReconnectFrame_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    28;
 
   friend void swap(AutoReconnectFrame& a, AutoReconnectFrame& b) {
     a.Swap(&b);
@@ -6325,6 +6829,8 @@ class AutoReconnectFrame final :
 
   // nested types ----------------------------------------------------
 
+  typedef AutoReconnectFrame_SessionResumption SessionResumption;
+
   typedef AutoReconnectFrame_EventType EventType;
   static constexpr EventType UNKNOWN_EVENT_TYPE =
     AutoReconnectFrame_EventType_UNKNOWN_EVENT_TYPE;
@@ -6357,6 +6863,7 @@ class AutoReconnectFrame final :
 
   enum : int {
     kEndpointIdFieldNumber = 1,
+    kSessionResumptionFieldNumber = 3,
     kEventTypeFieldNumber = 2,
   };
   // optional string endpoint_id = 1;
@@ -6377,6 +6884,24 @@ class AutoReconnectFrame final :
   std::string* _internal_mutable_endpoint_id();
   public:
 
+  // optional .location.nearby.connections.AutoReconnectFrame.SessionResumption session_resumption = 3;
+  bool has_session_resumption() const;
+  private:
+  bool _internal_has_session_resumption() const;
+  public:
+  void clear_session_resumption();
+  const ::location::nearby::connections::AutoReconnectFrame_SessionResumption& session_resumption() const;
+  PROTOBUF_NODISCARD ::location::nearby::connections::AutoReconnectFrame_SessionResumption* release_session_resumption();
+  ::location::nearby::connections::AutoReconnectFrame_SessionResumption* mutable_session_resumption();
+  void set_allocated_session_resumption(::location::nearby::connections::AutoReconnectFrame_SessionResumption* session_resumption);
+  private:
+  const ::location::nearby::connections::AutoReconnectFrame_SessionResumption& _internal_session_resumption() const;
+  ::location::nearby::connections::AutoReconnectFrame_SessionResumption* _internal_mutable_session_resumption();
+  public:
+  void unsafe_arena_set_allocated_session_resumption(
+      ::location::nearby::connections::AutoReconnectFrame_SessionResumption* session_resumption);
+  ::location::nearby::connections::AutoReconnectFrame_SessionResumption* unsafe_arena_release_session_resumption();
+
   // optional .location.nearby.connections.AutoReconnectFrame.EventType event_type = 2;
   bool has_event_type() const;
   private:
@@ -6400,6 +6925,7 @@ class AutoReconnectFrame final :
   ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr endpoint_id_;
+  ::location::nearby::connections::AutoReconnectFrame_SessionResumption* session_resumption_;
   int event_type_;
   friend struct ::TableStruct_connections_2fimplementation_2fproto_2foffline_5fwire_5fformats_2eproto;
 };
@@ -6451,7 +6977,7 @@ class MediumMetadata final :
                &_MediumMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    27;
+    29;
 
   friend void swap(MediumMetadata& a, MediumMetadata& b) {
     a.Swap(&b);
@@ -6778,7 +7304,7 @@ class AvailableChannels final :
                &_AvailableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    28;
+    30;
 
   friend void swap(AvailableChannels& a, AvailableChannels& b) {
     a.Swap(&b);
@@ -6929,7 +7455,7 @@ class WifiDirectCliUsableChannels final :
                &_WifiDirectCliUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    29;
+    31;
 
   friend void swap(WifiDirectCliUsableChannels& a, WifiDirectCliUsableChannels& b) {
     a.Swap(&b);
@@ -7080,7 +7606,7 @@ class WifiLanUsableChannels final :
                &_WifiLanUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    30;
+    32;
 
   friend void swap(WifiLanUsableChannels& a, WifiLanUsableChannels& b) {
     a.Swap(&b);
@@ -7231,7 +7757,7 @@ class WifiAwareUsableChannels final :
                &_WifiAwareUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    31;
+    33;
 
   friend void swap(WifiAwareUsableChannels& a, WifiAwareUsableChannels& b) {
     a.Swap(&b);
@@ -7382,7 +7908,7 @@ class WifiHotspotStaUsableChannels final :
                &_WifiHotspotStaUsableChannels_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    32;
+    34;
 
   friend void swap(WifiHotspotStaUsableChannels& a, WifiHotspotStaUsableChannels& b) {
     a.Swap(&b);
@@ -7533,7 +8059,7 @@ class LocationHint final :
                &_LocationHint_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    33;
+    35;
 
   friend void swap(LocationHint& a, LocationHint& b) {
     a.Swap(&b);
@@ -7695,7 +8221,7 @@ class LocationStandard final :
                &_LocationStandard_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    34;
+    36;
 
   friend void swap(LocationStandard& a, LocationStandard& b) {
     a.Swap(&b);
@@ -7847,7 +8373,7 @@ class OsInfo final :
                &_OsInfo_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    35;
+    37;
 
   friend void swap(OsInfo& a, OsInfo& b) {
     a.Swap(&b);
@@ -8023,7 +8549,7 @@ class ConnectionsDevice final :
                &_ConnectionsDevice_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    36;
+    38;
 
   friend void swap(ConnectionsDevice& a, ConnectionsDevice& b) {
     a.Swap(&b);
@@ -8225,7 +8751,7 @@ class PresenceDevice final :
                &_PresenceDevice_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    37;
+    39;
 
   friend void swap(PresenceDevice& a, PresenceDevice& b) {
     a.Swap(&b);
@@ -10566,7 +11092,7 @@ inline ConnectionRequestFrame::DeviceCase ConnectionRequestFrame::Device_case()
 
 // optional int32 status = 1 [deprecated = true];
 inline bool ConnectionResponseFrame::_internal_has_status() const {
-  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
   return value;
 }
 inline bool ConnectionResponseFrame::has_status() const {
@@ -10574,7 +11100,7 @@ inline bool ConnectionResponseFrame::has_status() const {
 }
 inline void ConnectionResponseFrame::clear_status() {
   status_ = 0;
-  _has_bits_[0] &= ~0x00000004u;
+  _has_bits_[0] &= ~0x00000008u;
 }
 inline int32_t ConnectionResponseFrame::_internal_status() const {
   return status_;
@@ -10584,7 +11110,7 @@ inline int32_t ConnectionResponseFrame::status() const {
   return _internal_status();
 }
 inline void ConnectionResponseFrame::_internal_set_status(int32_t value) {
-  _has_bits_[0] |= 0x00000004u;
+  _has_bits_[0] |= 0x00000008u;
   status_ = value;
 }
 inline void ConnectionResponseFrame::set_status(int32_t value) {
@@ -10663,7 +11189,7 @@ inline void ConnectionResponseFrame::set_allocated_handshake_data(std::string* h
 
 // optional .location.nearby.connections.ConnectionResponseFrame.ResponseStatus response = 3;
 inline bool ConnectionResponseFrame::_internal_has_response() const {
-  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
   return value;
 }
 inline bool ConnectionResponseFrame::has_response() const {
@@ -10671,7 +11197,7 @@ inline bool ConnectionResponseFrame::has_response() const {
 }
 inline void ConnectionResponseFrame::clear_response() {
   response_ = 0;
-  _has_bits_[0] &= ~0x00000008u;
+  _has_bits_[0] &= ~0x00000010u;
 }
 inline ::location::nearby::connections::ConnectionResponseFrame_ResponseStatus ConnectionResponseFrame::_internal_response() const {
   return static_cast< ::location::nearby::connections::ConnectionResponseFrame_ResponseStatus >(response_);
@@ -10682,7 +11208,7 @@ inline ::location::nearby::connections::ConnectionResponseFrame_ResponseStatus C
 }
 inline void ConnectionResponseFrame::_internal_set_response(::location::nearby::connections::ConnectionResponseFrame_ResponseStatus value) {
   assert(::location::nearby::connections::ConnectionResponseFrame_ResponseStatus_IsValid(value));
-  _has_bits_[0] |= 0x00000008u;
+  _has_bits_[0] |= 0x00000010u;
   response_ = value;
 }
 inline void ConnectionResponseFrame::set_response(::location::nearby::connections::ConnectionResponseFrame_ResponseStatus value) {
@@ -10782,7 +11308,7 @@ inline void ConnectionResponseFrame::set_allocated_os_info(::location::nearby::c
 
 // optional int32 multiplex_socket_bitmask = 5;
 inline bool ConnectionResponseFrame::_internal_has_multiplex_socket_bitmask() const {
-  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  bool value = (_has_bits_[0] & 0x00000020u) != 0;
   return value;
 }
 inline bool ConnectionResponseFrame::has_multiplex_socket_bitmask() const {
@@ -10790,7 +11316,7 @@ inline bool ConnectionResponseFrame::has_multiplex_socket_bitmask() const {
 }
 inline void ConnectionResponseFrame::clear_multiplex_socket_bitmask() {
   multiplex_socket_bitmask_ = 0;
-  _has_bits_[0] &= ~0x00000010u;
+  _has_bits_[0] &= ~0x00000020u;
 }
 inline int32_t ConnectionResponseFrame::_internal_multiplex_socket_bitmask() const {
   return multiplex_socket_bitmask_;
@@ -10800,7 +11326,7 @@ inline int32_t ConnectionResponseFrame::multiplex_socket_bitmask() const {
   return _internal_multiplex_socket_bitmask();
 }
 inline void ConnectionResponseFrame::_internal_set_multiplex_socket_bitmask(int32_t value) {
-  _has_bits_[0] |= 0x00000010u;
+  _has_bits_[0] |= 0x00000020u;
   multiplex_socket_bitmask_ = value;
 }
 inline void ConnectionResponseFrame::set_multiplex_socket_bitmask(int32_t value) {
@@ -10810,7 +11336,7 @@ inline void ConnectionResponseFrame::set_multiplex_socket_bitmask(int32_t value)
 
 // optional int32 nearby_connections_version = 6 [deprecated = true];
 inline bool ConnectionResponseFrame::_internal_has_nearby_connections_version() const {
-  bool value = (_has_bits_[0] & 0x00000020u) != 0;
+  bool value = (_has_bits_[0] & 0x00000040u) != 0;
   return value;
 }
 inline bool ConnectionResponseFrame::has_nearby_connections_version() const {
@@ -10818,7 +11344,7 @@ inline bool ConnectionResponseFrame::has_nearby_connections_version() const {
 }
 inline void ConnectionResponseFrame::clear_nearby_connections_version() {
   nearby_connections_version_ = 0;
-  _has_bits_[0] &= ~0x00000020u;
+  _has_bits_[0] &= ~0x00000040u;
 }
 inline int32_t ConnectionResponseFrame::_internal_nearby_connections_version() const {
   return nearby_connections_version_;
@@ -10828,7 +11354,7 @@ inline int32_t ConnectionResponseFrame::nearby_connections_version() const {
   return _internal_nearby_connections_version();
 }
 inline void ConnectionResponseFrame::_internal_set_nearby_connections_version(int32_t value) {
-  _has_bits_[0] |= 0x00000020u;
+  _has_bits_[0] |= 0x00000040u;
   nearby_connections_version_ = value;
 }
 inline void ConnectionResponseFrame::set_nearby_connections_version(int32_t value) {
@@ -10838,7 +11364,7 @@ inline void ConnectionResponseFrame::set_nearby_connections_version(int32_t valu
 
 // optional int32 safe_to_disconnect_version = 7;
 inline bool ConnectionResponseFrame::_internal_has_safe_to_disconnect_version() const {
-  bool value = (_has_bits_[0] & 0x00000040u) != 0;
+  bool value = (_has_bits_[0] & 0x00000080u) != 0;
   return value;
 }
 inline bool ConnectionResponseFrame::has_safe_to_disconnect_version() const {
@@ -10846,7 +11372,7 @@ inline bool ConnectionResponseFrame::has_safe_to_disconnect_version() const {
 }
 inline void ConnectionResponseFrame::clear_safe_to_disconnect_version() {
   safe_to_disconnect_version_ = 0;
-  _has_bits_[0] &= ~0x00000040u;
+  _has_bits_[0] &= ~0x00000080u;
 }
 inline int32_t ConnectionResponseFrame::_internal_safe_to_disconnect_version() const {
   return safe_to_disconnect_version_;
@@ -10856,7 +11382,7 @@ inline int32_t ConnectionResponseFrame::safe_to_disconnect_version() const {
   return _internal_safe_to_disconnect_version();
 }
 inline void ConnectionResponseFrame::_internal_set_safe_to_disconnect_version(int32_t value) {
-  _has_bits_[0] |= 0x00000040u;
+  _has_bits_[0] |= 0x00000080u;
   safe_to_disconnect_version_ = value;
 }
 inline void ConnectionResponseFrame::set_safe_to_disconnect_version(int32_t value) {
@@ -10864,44 +11390,246 @@ inline void ConnectionResponseFrame::set_safe_to_disconnect_version(int32_t valu
   // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.safe_to_disconnect_version)
 }
 
-// -------------------------------------------------------------------
-
-// PayloadTransferFrame_PayloadHeader
-
-// optional int64 id = 1;
-inline bool PayloadTransferFrame_PayloadHeader::_internal_has_id() const {
+// optional .location.nearby.connections.LocationHint location_hint = 8;
+inline bool ConnectionResponseFrame::_internal_has_location_hint() const {
   bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  PROTOBUF_ASSUME(!value || location_hint_ != nullptr);
   return value;
 }
-inline bool PayloadTransferFrame_PayloadHeader::has_id() const {
-  return _internal_has_id();
+inline bool ConnectionResponseFrame::has_location_hint() const {
+  return _internal_has_location_hint();
 }
-inline void PayloadTransferFrame_PayloadHeader::clear_id() {
-  id_ = int64_t{0};
+inline void ConnectionResponseFrame::clear_location_hint() {
+  if (location_hint_ != nullptr) location_hint_->Clear();
   _has_bits_[0] &= ~0x00000004u;
 }
-inline int64_t PayloadTransferFrame_PayloadHeader::_internal_id() const {
-  return id_;
+inline const ::location::nearby::connections::LocationHint& ConnectionResponseFrame::_internal_location_hint() const {
+  const ::location::nearby::connections::LocationHint* p = location_hint_;
+  return p != nullptr ? *p : reinterpret_cast<const ::location::nearby::connections::LocationHint&>(
+      ::location::nearby::connections::_LocationHint_default_instance_);
 }
-inline int64_t PayloadTransferFrame_PayloadHeader::id() const {
-  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.PayloadHeader.id)
-  return _internal_id();
+inline const ::location::nearby::connections::LocationHint& ConnectionResponseFrame::location_hint() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.location_hint)
+  return _internal_location_hint();
 }
-inline void PayloadTransferFrame_PayloadHeader::_internal_set_id(int64_t value) {
-  _has_bits_[0] |= 0x00000004u;
-  id_ = value;
+inline void ConnectionResponseFrame::unsafe_arena_set_allocated_location_hint(
+    ::location::nearby::connections::LocationHint* location_hint) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(location_hint_);
+  }
+  location_hint_ = location_hint;
+  if (location_hint) {
+    _has_bits_[0] |= 0x00000004u;
+  } else {
+    _has_bits_[0] &= ~0x00000004u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:location.nearby.connections.ConnectionResponseFrame.location_hint)
 }
-inline void PayloadTransferFrame_PayloadHeader::set_id(int64_t value) {
-  _internal_set_id(value);
-  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadHeader.id)
+inline ::location::nearby::connections::LocationHint* ConnectionResponseFrame::release_location_hint() {
+  _has_bits_[0] &= ~0x00000004u;
+  ::location::nearby::connections::LocationHint* temp = location_hint_;
+  location_hint_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
 }
-
-// optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader.PayloadType type = 2;
-inline bool PayloadTransferFrame_PayloadHeader::_internal_has_type() const {
-  bool value = (_has_bits_[0] & 0x00000010u) != 0;
-  return value;
+inline ::location::nearby::connections::LocationHint* ConnectionResponseFrame::unsafe_arena_release_location_hint() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.ConnectionResponseFrame.location_hint)
+  _has_bits_[0] &= ~0x00000004u;
+  ::location::nearby::connections::LocationHint* temp = location_hint_;
+  location_hint_ = nullptr;
+  return temp;
 }
-inline bool PayloadTransferFrame_PayloadHeader::has_type() const {
+inline ::location::nearby::connections::LocationHint* ConnectionResponseFrame::_internal_mutable_location_hint() {
+  _has_bits_[0] |= 0x00000004u;
+  if (location_hint_ == nullptr) {
+    auto* p = CreateMaybeMessage<::location::nearby::connections::LocationHint>(GetArenaForAllocation());
+    location_hint_ = p;
+  }
+  return location_hint_;
+}
+inline ::location::nearby::connections::LocationHint* ConnectionResponseFrame::mutable_location_hint() {
+  ::location::nearby::connections::LocationHint* _msg = _internal_mutable_location_hint();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.ConnectionResponseFrame.location_hint)
+  return _msg;
+}
+inline void ConnectionResponseFrame::set_allocated_location_hint(::location::nearby::connections::LocationHint* location_hint) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete location_hint_;
+  }
+  if (location_hint) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper<::location::nearby::connections::LocationHint>::GetOwningArena(location_hint);
+    if (message_arena != submessage_arena) {
+      location_hint = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, location_hint, submessage_arena);
+    }
+    _has_bits_[0] |= 0x00000004u;
+  } else {
+    _has_bits_[0] &= ~0x00000004u;
+  }
+  location_hint_ = location_hint;
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.ConnectionResponseFrame.location_hint)
+}
+
+// optional int32 keep_alive_timeout_millis = 9;
+inline bool ConnectionResponseFrame::_internal_has_keep_alive_timeout_millis() const {
+  bool value = (_has_bits_[0] & 0x00000100u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_keep_alive_timeout_millis() const {
+  return _internal_has_keep_alive_timeout_millis();
+}
+inline void ConnectionResponseFrame::clear_keep_alive_timeout_millis() {
+  keep_alive_timeout_millis_ = 0;
+  _has_bits_[0] &= ~0x00000100u;
+}
+inline int32_t ConnectionResponseFrame::_internal_keep_alive_timeout_millis() const {
+  return keep_alive_timeout_millis_;
+}
+inline int32_t ConnectionResponseFrame::keep_alive_timeout_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.keep_alive_timeout_millis)
+  return _internal_keep_alive_timeout_millis();
+}
+inline void ConnectionResponseFrame::_internal_set_keep_alive_timeout_millis(int32_t value) {
+  _has_bits_[0] |= 0x00000100u;
+  keep_alive_timeout_millis_ = value;
+}
+inline void ConnectionResponseFrame::set_keep_alive_timeout_millis(int32_t value) {
+  _internal_set_keep_alive_timeout_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.keep_alive_timeout_millis)
+}
+
+// optional int32 aead_record_layer_version = 10;
+inline bool ConnectionResponseFrame::_internal_has_aead_record_layer_version() const {
+  bool value = (_has_bits_[0] & 0x00000200u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_aead_record_layer_version() const {
+  return _internal_has_aead_record_layer_version();
+}
+inline void ConnectionResponseFrame::clear_aead_record_layer_version() {
+  aead_record_layer_version_ = 0;
+  _has_bits_[0] &= ~0x00000200u;
+}
+inline int32_t ConnectionResponseFrame::_internal_aead_record_layer_version() const {
+  return aead_record_layer_version_;
+}
+inline int32_t ConnectionResponseFrame::aead_record_layer_version() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.aead_record_layer_version)
+  return _internal_aead_record_layer_version();
+}
+inline void ConnectionResponseFrame::_internal_set_aead_record_layer_version(int32_t value) {
+  _has_bits_[0] |= 0x00000200u;
+  aead_record_layer_version_ = value;
+}
+inline void ConnectionResponseFrame::set_aead_record_layer_version(int32_t value) {
+  _internal_set_aead_record_layer_version(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.aead_record_layer_version)
+}
+
+// optional int32 payload_compression_version = 11;
+inline bool ConnectionResponseFrame::_internal_has_payload_compression_version() const {
+  bool value = (_has_bits_[0] & 0x00000400u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_payload_compression_version() const {
+  return _internal_has_payload_compression_version();
+}
+inline void ConnectionResponseFrame::clear_payload_compression_version() {
+  payload_compression_version_ = 0;
+  _has_bits_[0] &= ~0x00000400u;
+}
+inline int32_t ConnectionResponseFrame::_internal_payload_compression_version() const {
+  return payload_compression_version_;
+}
+inline int32_t ConnectionResponseFrame::payload_compression_version() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.payload_compression_version)
+  return _internal_payload_compression_version();
+}
+inline void ConnectionResponseFrame::_internal_set_payload_compression_version(int32_t value) {
+  _has_bits_[0] |= 0x00000400u;
+  payload_compression_version_ = value;
+}
+inline void ConnectionResponseFrame::set_payload_compression_version(int32_t value) {
+  _internal_set_payload_compression_version(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.payload_compression_version)
+}
+
+// optional int32 payload_batching_version = 12;
+inline bool ConnectionResponseFrame::_internal_has_payload_batching_version() const {
+  bool value = (_has_bits_[0] & 0x00000800u) != 0;
+  return value;
+}
+inline bool ConnectionResponseFrame::has_payload_batching_version() const {
+  return _internal_has_payload_batching_version();
+}
+inline void ConnectionResponseFrame::clear_payload_batching_version() {
+  payload_batching_version_ = 0;
+  _has_bits_[0] &= ~0x00000800u;
+}
+inline int32_t ConnectionResponseFrame::_internal_payload_batching_version() const {
+  return payload_batching_version_;
+}
+inline int32_t ConnectionResponseFrame::payload_batching_version() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.ConnectionResponseFrame.payload_batching_version)
+  return _internal_payload_batching_version();
+}
+inline void ConnectionResponseFrame::_internal_set_payload_batching_version(int32_t value) {
+  _has_bits_[0] |= 0x00000800u;
+  payload_batching_version_ = value;
+}
+inline void ConnectionResponseFrame::set_payload_batching_version(int32_t value) {
+  _internal_set_payload_batching_version(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.ConnectionResponseFrame.payload_batching_version)
+}
+
+// -------------------------------------------------------------------
+
+// PayloadTransferFrame_PayloadHeader
+
+// optional int64 id = 1;
+inline bool PayloadTransferFrame_PayloadHeader::_internal_has_id() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool PayloadTransferFrame_PayloadHeader::has_id() const {
+  return _internal_has_id();
+}
+inline void PayloadTransferFrame_PayloadHeader::clear_id() {
+  id_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline int64_t PayloadTransferFrame_PayloadHeader::_internal_id() const {
+  return id_;
+}
+inline int64_t PayloadTransferFrame_PayloadHeader::id() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.PayloadHeader.id)
+  return _internal_id();
+}
+inline void PayloadTransferFrame_PayloadHeader::_internal_set_id(int64_t value) {
+  _has_bits_[0] |= 0x00000004u;
+  id_ = value;
+}
+inline void PayloadTransferFrame_PayloadHeader::set_id(int64_t value) {
+  _internal_set_id(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadHeader.id)
+}
+
+// optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader.PayloadType type = 2;
+inline bool PayloadTransferFrame_PayloadHeader::_internal_has_type() const {
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  return value;
+}
+inline bool PayloadTransferFrame_PayloadHeader::has_type() const {
   return _internal_has_type();
 }
 inline void PayloadTransferFrame_PayloadHeader::clear_type() {
@@ -11125,7 +11853,7 @@ inline void PayloadTransferFrame_PayloadHeader::set_allocated_parent_folder(std:
 
 // optional int32 flags = 1;
 inline bool PayloadTransferFrame_PayloadChunk::_internal_has_flags() const {
-  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
   return value;
 }
 inline bool PayloadTransferFrame_PayloadChunk::has_flags() const {
@@ -11133,7 +11861,7 @@ inline bool PayloadTransferFrame_PayloadChunk::has_flags() const {
 }
 inline void PayloadTransferFrame_PayloadChunk::clear_flags() {
   flags_ = 0;
-  _has_bits_[0] &= ~0x00000004u;
+  _has_bits_[0] &= ~0x00000008u;
 }
 inline int32_t PayloadTransferFrame_PayloadChunk::_internal_flags() const {
   return flags_;
@@ -11143,7 +11871,7 @@ inline int32_t PayloadTransferFrame_PayloadChunk::flags() const {
   return _internal_flags();
 }
 inline void PayloadTransferFrame_PayloadChunk::_internal_set_flags(int32_t value) {
-  _has_bits_[0] |= 0x00000004u;
+  _has_bits_[0] |= 0x00000008u;
   flags_ = value;
 }
 inline void PayloadTransferFrame_PayloadChunk::set_flags(int32_t value) {
@@ -11153,7 +11881,7 @@ inline void PayloadTransferFrame_PayloadChunk::set_flags(int32_t value) {
 
 // optional int64 offset = 2;
 inline bool PayloadTransferFrame_PayloadChunk::_internal_has_offset() const {
-  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
   return value;
 }
 inline bool PayloadTransferFrame_PayloadChunk::has_offset() const {
@@ -11161,7 +11889,7 @@ inline bool PayloadTransferFrame_PayloadChunk::has_offset() const {
 }
 inline void PayloadTransferFrame_PayloadChunk::clear_offset() {
   offset_ = int64_t{0};
-  _has_bits_[0] &= ~0x00000002u;
+  _has_bits_[0] &= ~0x00000004u;
 }
 inline int64_t PayloadTransferFrame_PayloadChunk::_internal_offset() const {
   return offset_;
@@ -11171,7 +11899,7 @@ inline int64_t PayloadTransferFrame_PayloadChunk::offset() const {
   return _internal_offset();
 }
 inline void PayloadTransferFrame_PayloadChunk::_internal_set_offset(int64_t value) {
-  _has_bits_[0] |= 0x00000002u;
+  _has_bits_[0] |= 0x00000004u;
   offset_ = value;
 }
 inline void PayloadTransferFrame_PayloadChunk::set_offset(int64_t value) {
@@ -11179,47 +11907,307 @@ inline void PayloadTransferFrame_PayloadChunk::set_offset(int64_t value) {
   // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadChunk.offset)
 }
 
-// optional bytes body = 3;
-inline bool PayloadTransferFrame_PayloadChunk::_internal_has_body() const {
+// optional bytes body = 3;
+inline bool PayloadTransferFrame_PayloadChunk::_internal_has_body() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool PayloadTransferFrame_PayloadChunk::has_body() const {
+  return _internal_has_body();
+}
+inline void PayloadTransferFrame_PayloadChunk::clear_body() {
+  body_.ClearToEmpty();
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline const std::string& PayloadTransferFrame_PayloadChunk::body() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+  return _internal_body();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void PayloadTransferFrame_PayloadChunk::set_body(ArgT0&& arg0, ArgT... args) {
+ _has_bits_[0] |= 0x00000001u;
+ body_.SetBytes(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+}
+inline std::string* PayloadTransferFrame_PayloadChunk::mutable_body() {
+  std::string* _s = _internal_mutable_body();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+  return _s;
+}
+inline const std::string& PayloadTransferFrame_PayloadChunk::_internal_body() const {
+  return body_.Get();
+}
+inline void PayloadTransferFrame_PayloadChunk::_internal_set_body(const std::string& value) {
+  _has_bits_[0] |= 0x00000001u;
+  body_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
+}
+inline std::string* PayloadTransferFrame_PayloadChunk::_internal_mutable_body() {
+  _has_bits_[0] |= 0x00000001u;
+  return body_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
+}
+inline std::string* PayloadTransferFrame_PayloadChunk::release_body() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+  if (!_internal_has_body()) {
+    return nullptr;
+  }
+  _has_bits_[0] &= ~0x00000001u;
+  auto* p = body_.ReleaseNonDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (body_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    body_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
+}
+inline void PayloadTransferFrame_PayloadChunk::set_allocated_body(std::string* body) {
+  if (body != nullptr) {
+    _has_bits_[0] |= 0x00000001u;
+  } else {
+    _has_bits_[0] &= ~0x00000001u;
+  }
+  body_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), body,
+      GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (body_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    body_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+}
+
+// optional int32 index = 4;
+inline bool PayloadTransferFrame_PayloadChunk::_internal_has_index() const {
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  return value;
+}
+inline bool PayloadTransferFrame_PayloadChunk::has_index() const {
+  return _internal_has_index();
+}
+inline void PayloadTransferFrame_PayloadChunk::clear_index() {
+  index_ = 0;
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline int32_t PayloadTransferFrame_PayloadChunk::_internal_index() const {
+  return index_;
+}
+inline int32_t PayloadTransferFrame_PayloadChunk::index() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.PayloadChunk.index)
+  return _internal_index();
+}
+inline void PayloadTransferFrame_PayloadChunk::_internal_set_index(int32_t value) {
+  _has_bits_[0] |= 0x00000010u;
+  index_ = value;
+}
+inline void PayloadTransferFrame_PayloadChunk::set_index(int32_t value) {
+  _internal_set_index(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadChunk.index)
+}
+
+// optional bytes sha256_digest = 5;
+inline bool PayloadTransferFrame_PayloadChunk::_internal_has_sha256_digest() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool PayloadTransferFrame_PayloadChunk::has_sha256_digest() const {
+  return _internal_has_sha256_digest();
+}
+inline void PayloadTransferFrame_PayloadChunk::clear_sha256_digest() {
+  sha256_digest_.ClearToEmpty();
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline const std::string& PayloadTransferFrame_PayloadChunk::sha256_digest() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.PayloadChunk.sha256_digest)
+  return _internal_sha256_digest();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void PayloadTransferFrame_PayloadChunk::set_sha256_digest(ArgT0&& arg0, ArgT... args) {
+ _has_bits_[0] |= 0x00000002u;
+ sha256_digest_.SetBytes(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadChunk.sha256_digest)
+}
+inline std::string* PayloadTransferFrame_PayloadChunk::mutable_sha256_digest() {
+  std::string* _s = _internal_mutable_sha256_digest();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.PayloadChunk.sha256_digest)
+  return _s;
+}
+inline const std::string& PayloadTransferFrame_PayloadChunk::_internal_sha256_digest() const {
+  return sha256_digest_.Get();
+}
+inline void PayloadTransferFrame_PayloadChunk::_internal_set_sha256_digest(const std::string& value) {
+  _has_bits_[0] |= 0x00000002u;
+  sha256_digest_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
+}
+inline std::string* PayloadTransferFrame_PayloadChunk::_internal_mutable_sha256_digest() {
+  _has_bits_[0] |= 0x00000002u;
+  return sha256_digest_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
+}
+inline std::string* PayloadTransferFrame_PayloadChunk::release_sha256_digest() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.PayloadTransferFrame.PayloadChunk.sha256_digest)
+  if (!_internal_has_sha256_digest()) {
+    return nullptr;
+  }
+  _has_bits_[0] &= ~0x00000002u;
+  auto* p = sha256_digest_.ReleaseNonDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (sha256_digest_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    sha256_digest_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
+}
+inline void PayloadTransferFrame_PayloadChunk::set_allocated_sha256_digest(std::string* sha256_digest) {
+  if (sha256_digest != nullptr) {
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  sha256_digest_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), sha256_digest,
+      GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (sha256_digest_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    sha256_digest_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.PayloadChunk.sha256_digest)
+}
+
+// -------------------------------------------------------------------
+
+// PayloadTransferFrame_BatchedPayload
+
+// optional .location.nearby.connections.PayloadTransferFrame.PayloadHeader payload_header = 1;
+inline bool PayloadTransferFrame_BatchedPayload::_internal_has_payload_header() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  PROTOBUF_ASSUME(!value || payload_header_ != nullptr);
+  return value;
+}
+inline bool PayloadTransferFrame_BatchedPayload::has_payload_header() const {
+  return _internal_has_payload_header();
+}
+inline void PayloadTransferFrame_BatchedPayload::clear_payload_header() {
+  if (payload_header_ != nullptr) payload_header_->Clear();
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader& PayloadTransferFrame_BatchedPayload::_internal_payload_header() const {
+  const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* p = payload_header_;
+  return p != nullptr ? *p : reinterpret_cast<const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader&>(
+      ::location::nearby::connections::_PayloadTransferFrame_PayloadHeader_default_instance_);
+}
+inline const ::location::nearby::connections::PayloadTransferFrame_PayloadHeader& PayloadTransferFrame_BatchedPayload::payload_header() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.BatchedPayload.payload_header)
+  return _internal_payload_header();
+}
+inline void PayloadTransferFrame_BatchedPayload::unsafe_arena_set_allocated_payload_header(
+    ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* payload_header) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(payload_header_);
+  }
+  payload_header_ = payload_header;
+  if (payload_header) {
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:location.nearby.connections.PayloadTransferFrame.BatchedPayload.payload_header)
+}
+inline ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* PayloadTransferFrame_BatchedPayload::release_payload_header() {
+  _has_bits_[0] &= ~0x00000002u;
+  ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* temp = payload_header_;
+  payload_header_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* PayloadTransferFrame_BatchedPayload::unsafe_arena_release_payload_header() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.PayloadTransferFrame.BatchedPayload.payload_header)
+  _has_bits_[0] &= ~0x00000002u;
+  ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* temp = payload_header_;
+  payload_header_ = nullptr;
+  return temp;
+}
+inline ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* PayloadTransferFrame_BatchedPayload::_internal_mutable_payload_header() {
+  _has_bits_[0] |= 0x00000002u;
+  if (payload_header_ == nullptr) {
+    auto* p = CreateMaybeMessage<::location::nearby::connections::PayloadTransferFrame_PayloadHeader>(GetArenaForAllocation());
+    payload_header_ = p;
+  }
+  return payload_header_;
+}
+inline ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* PayloadTransferFrame_BatchedPayload::mutable_payload_header() {
+  ::location::nearby::connections::PayloadTransferFrame_PayloadHeader* _msg = _internal_mutable_payload_header();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.BatchedPayload.payload_header)
+  return _msg;
+}
+inline void PayloadTransferFrame_BatchedPayload::set_allocated_payload_header(::location::nearby::connections::PayloadTransferFrame_PayloadHeader* payload_header) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete payload_header_;
+  }
+  if (payload_header) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper<::location::nearby::connections::PayloadTransferFrame_PayloadHeader>::GetOwningArena(payload_header);
+    if (message_arena != submessage_arena) {
+      payload_header = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, payload_header, submessage_arena);
+    }
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  payload_header_ = payload_header;
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.BatchedPayload.payload_header)
+}
+
+// optional bytes body = 2;
+inline bool PayloadTransferFrame_BatchedPayload::_internal_has_body() const {
   bool value = (_has_bits_[0] & 0x00000001u) != 0;
   return value;
 }
-inline bool PayloadTransferFrame_PayloadChunk::has_body() const {
+inline bool PayloadTransferFrame_BatchedPayload::has_body() const {
   return _internal_has_body();
 }
-inline void PayloadTransferFrame_PayloadChunk::clear_body() {
+inline void PayloadTransferFrame_BatchedPayload::clear_body() {
   body_.ClearToEmpty();
   _has_bits_[0] &= ~0x00000001u;
 }
-inline const std::string& PayloadTransferFrame_PayloadChunk::body() const {
-  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+inline const std::string& PayloadTransferFrame_BatchedPayload::body() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.BatchedPayload.body)
   return _internal_body();
 }
 template <typename ArgT0, typename... ArgT>
 inline PROTOBUF_ALWAYS_INLINE
-void PayloadTransferFrame_PayloadChunk::set_body(ArgT0&& arg0, ArgT... args) {
+void PayloadTransferFrame_BatchedPayload::set_body(ArgT0&& arg0, ArgT... args) {
  _has_bits_[0] |= 0x00000001u;
  body_.SetBytes(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
-  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.BatchedPayload.body)
 }
-inline std::string* PayloadTransferFrame_PayloadChunk::mutable_body() {
+inline std::string* PayloadTransferFrame_BatchedPayload::mutable_body() {
   std::string* _s = _internal_mutable_body();
-  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.BatchedPayload.body)
   return _s;
 }
-inline const std::string& PayloadTransferFrame_PayloadChunk::_internal_body() const {
+inline const std::string& PayloadTransferFrame_BatchedPayload::_internal_body() const {
   return body_.Get();
 }
-inline void PayloadTransferFrame_PayloadChunk::_internal_set_body(const std::string& value) {
+inline void PayloadTransferFrame_BatchedPayload::_internal_set_body(const std::string& value) {
   _has_bits_[0] |= 0x00000001u;
   body_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
 }
-inline std::string* PayloadTransferFrame_PayloadChunk::_internal_mutable_body() {
+inline std::string* PayloadTransferFrame_BatchedPayload::_internal_mutable_body() {
   _has_bits_[0] |= 0x00000001u;
   return body_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
 }
-inline std::string* PayloadTransferFrame_PayloadChunk::release_body() {
-  // @@protoc_insertion_point(field_release:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
+inline std::string* PayloadTransferFrame_BatchedPayload::release_body() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.PayloadTransferFrame.BatchedPayload.body)
   if (!_internal_has_body()) {
     return nullptr;
   }
@@ -11232,7 +12220,7 @@ inline std::string* PayloadTransferFrame_PayloadChunk::release_body() {
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
   return p;
 }
-inline void PayloadTransferFrame_PayloadChunk::set_allocated_body(std::string* body) {
+inline void PayloadTransferFrame_BatchedPayload::set_allocated_body(std::string* body) {
   if (body != nullptr) {
     _has_bits_[0] |= 0x00000001u;
   } else {
@@ -11245,35 +12233,7 @@ inline void PayloadTransferFrame_PayloadChunk::set_allocated_body(std::string* b
     body_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
   }
 #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
-  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.PayloadChunk.body)
-}
-
-// optional int32 index = 4;
-inline bool PayloadTransferFrame_PayloadChunk::_internal_has_index() const {
-  bool value = (_has_bits_[0] & 0x00000008u) != 0;
-  return value;
-}
-inline bool PayloadTransferFrame_PayloadChunk::has_index() const {
-  return _internal_has_index();
-}
-inline void PayloadTransferFrame_PayloadChunk::clear_index() {
-  index_ = 0;
-  _has_bits_[0] &= ~0x00000008u;
-}
-inline int32_t PayloadTransferFrame_PayloadChunk::_internal_index() const {
-  return index_;
-}
-inline int32_t PayloadTransferFrame_PayloadChunk::index() const {
-  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.PayloadChunk.index)
-  return _internal_index();
-}
-inline void PayloadTransferFrame_PayloadChunk::_internal_set_index(int32_t value) {
-  _has_bits_[0] |= 0x00000008u;
-  index_ = value;
-}
-inline void PayloadTransferFrame_PayloadChunk::set_index(int32_t value) {
-  _internal_set_index(value);
-  // @@protoc_insertion_point(field_set:location.nearby.connections.PayloadTransferFrame.PayloadChunk.index)
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.BatchedPayload.body)
 }
 
 // -------------------------------------------------------------------
@@ -11640,6 +12600,46 @@ inline void PayloadTransferFrame::set_allocated_control_message(::location::near
   // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.PayloadTransferFrame.control_message)
 }
 
+// repeated .location.nearby.connections.PayloadTransferFrame.BatchedPayload batched_payloads = 5;
+inline int PayloadTransferFrame::_internal_batched_payloads_size() const {
+  return batched_payloads_.size();
+}
+inline int PayloadTransferFrame::batched_payloads_size() const {
+  return _internal_batched_payloads_size();
+}
+inline void PayloadTransferFrame::clear_batched_payloads() {
+  batched_payloads_.Clear();
+}
+inline ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* PayloadTransferFrame::mutable_batched_payloads(int index) {
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.PayloadTransferFrame.batched_payloads)
+  return batched_payloads_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::connections::PayloadTransferFrame_BatchedPayload >*
+PayloadTransferFrame::mutable_batched_payloads() {
+  // @@protoc_insertion_point(field_mutable_list:location.nearby.connections.PayloadTransferFrame.batched_payloads)
+  return &batched_payloads_;
+}
+inline const ::location::nearby::connections::PayloadTransferFrame_BatchedPayload& PayloadTransferFrame::_internal_batched_payloads(int index) const {
+  return batched_payloads_.Get(index);
+}
+inline const ::location::nearby::connections::PayloadTransferFrame_BatchedPayload& PayloadTransferFrame::batched_payloads(int index) const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.PayloadTransferFrame.batched_payloads)
+  return _internal_batched_payloads(index);
+}
+inline ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* PayloadTransferFrame::_internal_add_batched_payloads() {
+  return batched_payloads_.Add();
+}
+inline ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* PayloadTransferFrame::add_batched_payloads() {
+  ::location::nearby::connections::PayloadTransferFrame_BatchedPayload* _add = _internal_add_batched_payloads();
+  // @@protoc_insertion_point(field_add:location.nearby.connections.PayloadTransferFrame.batched_payloads)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::connections::PayloadTransferFrame_BatchedPayload >&
+PayloadTransferFrame::batched_payloads() const {
+  // @@protoc_insertion_point(field_list:location.nearby.connections.PayloadTransferFrame.batched_payloads)
+  return batched_payloads_;
+}
+
 // -------------------------------------------------------------------
 
 // BandwidthUpgradeNegotiationFrame_UpgradePathInfo_WifiHotspotCredentials
@@ -14198,6 +15198,34 @@ inline void DisconnectionFrame::set_ack_safe_to_disconnect(bool value) {
   // @@protoc_insertion_point(field_set:location.nearby.connections.DisconnectionFrame.ack_safe_to_disconnect)
 }
 
+// optional bool park_connection = 3;
+inline bool DisconnectionFrame::_internal_has_park_connection() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool DisconnectionFrame::has_park_connection() const {
+  return _internal_has_park_connection();
+}
+inline void DisconnectionFrame::clear_park_connection() {
+  park_connection_ = false;
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline bool DisconnectionFrame::_internal_park_connection() const {
+  return park_connection_;
+}
+inline bool DisconnectionFrame::park_connection() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.DisconnectionFrame.park_connection)
+  return _internal_park_connection();
+}
+inline void DisconnectionFrame::_internal_set_park_connection(bool value) {
+  _has_bits_[0] |= 0x00000004u;
+  park_connection_ = value;
+}
+inline void DisconnectionFrame::set_park_connection(bool value) {
+  _internal_set_park_connection(value);
+  // @@protoc_insertion_point(field_set:location.nearby.connections.DisconnectionFrame.park_connection)
+}
+
 // -------------------------------------------------------------------
 
 // PairedKeyEncryptionFrame
@@ -14467,6 +15495,217 @@ inline void AutoResumeFrame::set_next_payload_chunk_index(int32_t value) {
 
 // -------------------------------------------------------------------
 
+// AutoReconnectFrame_SessionResumption
+
+// optional bytes ticket_id = 1;
+inline bool AutoReconnectFrame_SessionResumption::_internal_has_ticket_id() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool AutoReconnectFrame_SessionResumption::has_ticket_id() const {
+  return _internal_has_ticket_id();
+}
+inline void AutoReconnectFrame_SessionResumption::clear_ticket_id() {
+  ticket_id_.ClearToEmpty();
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline const std::string& AutoReconnectFrame_SessionResumption::ticket_id() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.AutoReconnectFrame.SessionResumption.ticket_id)
+  return _internal_ticket_id();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void AutoReconnectFrame_SessionResumption::set_ticket_id(ArgT0&& arg0, ArgT... args) {
+ _has_bits_[0] |= 0x00000001u;
+ ticket_id_.SetBytes(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:location.nearby.connections.AutoReconnectFrame.SessionResumption.ticket_id)
+}
+inline std::string* AutoReconnectFrame_SessionResumption::mutable_ticket_id() {
+  std::string* _s = _internal_mutable_ticket_id();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.AutoReconnectFrame.SessionResumption.ticket_id)
+  return _s;
+}
+inline const std::string& AutoReconnectFrame_SessionResumption::_internal_ticket_id() const {
+  return ticket_id_.Get();
+}
+inline void AutoReconnectFrame_SessionResumption::_internal_set_ticket_id(const std::string& value) {
+  _has_bits_[0] |= 0x00000001u;
+  ticket_id_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
+}
+inline std::string* AutoReconnectFrame_SessionResumption::_internal_mutable_ticket_id() {
+  _has_bits_[0] |= 0x00000001u;
+  return ticket_id_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
+}
+inline std::string* AutoReconnectFrame_SessionResumption::release_ticket_id() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.AutoReconnectFrame.SessionResumption.ticket_id)
+  if (!_internal_has_ticket_id()) {
+    return nullptr;
+  }
+  _has_bits_[0] &= ~0x00000001u;
+  auto* p = ticket_id_.ReleaseNonDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (ticket_id_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    ticket_id_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
+}
+inline void AutoReconnectFrame_SessionResumption::set_allocated_ticket_id(std::string* ticket_id) {
+  if (ticket_id != nullptr) {
+    _has_bits_[0] |= 0x00000001u;
+  } else {
+    _has_bits_[0] &= ~0x00000001u;
+  }
+  ticket_id_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), ticket_id,
+      GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (ticket_id_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    ticket_id_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.AutoReconnectFrame.SessionResumption.ticket_id)
+}
+
+// optional bytes nonce = 2;
+inline bool AutoReconnectFrame_SessionResumption::_internal_has_nonce() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool AutoReconnectFrame_SessionResumption::has_nonce() const {
+  return _internal_has_nonce();
+}
+inline void AutoReconnectFrame_SessionResumption::clear_nonce() {
+  nonce_.ClearToEmpty();
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline const std::string& AutoReconnectFrame_SessionResumption::nonce() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.AutoReconnectFrame.SessionResumption.nonce)
+  return _internal_nonce();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void AutoReconnectFrame_SessionResumption::set_nonce(ArgT0&& arg0, ArgT... args) {
+ _has_bits_[0] |= 0x00000002u;
+ nonce_.SetBytes(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:location.nearby.connections.AutoReconnectFrame.SessionResumption.nonce)
+}
+inline std::string* AutoReconnectFrame_SessionResumption::mutable_nonce() {
+  std::string* _s = _internal_mutable_nonce();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.AutoReconnectFrame.SessionResumption.nonce)
+  return _s;
+}
+inline const std::string& AutoReconnectFrame_SessionResumption::_internal_nonce() const {
+  return nonce_.Get();
+}
+inline void AutoReconnectFrame_SessionResumption::_internal_set_nonce(const std::string& value) {
+  _has_bits_[0] |= 0x00000002u;
+  nonce_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
+}
+inline std::string* AutoReconnectFrame_SessionResumption::_internal_mutable_nonce() {
+  _has_bits_[0] |= 0x00000002u;
+  return nonce_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
+}
+inline std::string* AutoReconnectFrame_SessionResumption::release_nonce() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.AutoReconnectFrame.SessionResumption.nonce)
+  if (!_internal_has_nonce()) {
+    return nullptr;
+  }
+  _has_bits_[0] &= ~0x00000002u;
+  auto* p = nonce_.ReleaseNonDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (nonce_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    nonce_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
+}
+inline void AutoReconnectFrame_SessionResumption::set_allocated_nonce(std::string* nonce) {
+  if (nonce != nullptr) {
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  nonce_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), nonce,
+      GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (nonce_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    nonce_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.AutoReconnectFrame.SessionResumption.nonce)
+}
+
+// optional bytes mac = 3;
+inline bool AutoReconnectFrame_SessionResumption::_internal_has_mac() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool AutoReconnectFrame_SessionResumption::has_mac() const {
+  return _internal_has_mac();
+}
+inline void AutoReconnectFrame_SessionResumption::clear_mac() {
+  mac_.ClearToEmpty();
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline const std::string& AutoReconnectFrame_SessionResumption::mac() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.AutoReconnectFrame.SessionResumption.mac)
+  return _internal_mac();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void AutoReconnectFrame_SessionResumption::set_mac(ArgT0&& arg0, ArgT... args) {
+ _has_bits_[0] |= 0x00000004u;
+ mac_.SetBytes(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:location.nearby.connections.AutoReconnectFrame.SessionResumption.mac)
+}
+inline std::string* AutoReconnectFrame_SessionResumption::mutable_mac() {
+  std::string* _s = _internal_mutable_mac();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.AutoReconnectFrame.SessionResumption.mac)
+  return _s;
+}
+inline const std::string& AutoReconnectFrame_SessionResumption::_internal_mac() const {
+  return mac_.Get();
+}
+inline void AutoReconnectFrame_SessionResumption::_internal_set_mac(const std::string& value) {
+  _has_bits_[0] |= 0x00000004u;
+  mac_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
+}
+inline std::string* AutoReconnectFrame_SessionResumption::_internal_mutable_mac() {
+  _has_bits_[0] |= 0x00000004u;
+  return mac_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
+}
+inline std::string* AutoReconnectFrame_SessionResumption::release_mac() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.AutoReconnectFrame.SessionResumption.mac)
+  if (!_internal_has_mac()) {
+    return nullptr;
+  }
+  _has_bits_[0] &= ~0x00000004u;
+  auto* p = mac_.ReleaseNonDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (mac_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    mac_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
+}
+inline void AutoReconnectFrame_SessionResumption::set_allocated_mac(std::string* mac) {
+  if (mac != nullptr) {
+    _has_bits_[0] |= 0x00000004u;
+  } else {
+    _has_bits_[0] &= ~0x00000004u;
+  }
+  mac_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), mac,
+      GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (mac_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    mac_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.AutoReconnectFrame.SessionResumption.mac)
+}
+
+// -------------------------------------------------------------------
+
 // AutoReconnectFrame
 
 // optional string endpoint_id = 1;
@@ -14540,7 +15779,7 @@ inline void AutoReconnectFrame::set_allocated_endpoint_id(std::string* endpoint_
 
 // optional .location.nearby.connections.AutoReconnectFrame.EventType event_type = 2;
 inline bool AutoReconnectFrame::_internal_has_event_type() const {
-  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
   return value;
 }
 inline bool AutoReconnectFrame::has_event_type() const {
@@ -14548,7 +15787,7 @@ inline bool AutoReconnectFrame::has_event_type() const {
 }
 inline void AutoReconnectFrame::clear_event_type() {
   event_type_ = 0;
-  _has_bits_[0] &= ~0x00000002u;
+  _has_bits_[0] &= ~0x00000004u;
 }
 inline ::location::nearby::connections::AutoReconnectFrame_EventType AutoReconnectFrame::_internal_event_type() const {
   return static_cast< ::location::nearby::connections::AutoReconnectFrame_EventType >(event_type_);
@@ -14559,7 +15798,7 @@ inline ::location::nearby::connections::AutoReconnectFrame_EventType AutoReconne
 }
 inline void AutoReconnectFrame::_internal_set_event_type(::location::nearby::connections::AutoReconnectFrame_EventType value) {
   assert(::location::nearby::connections::AutoReconnectFrame_EventType_IsValid(value));
-  _has_bits_[0] |= 0x00000002u;
+  _has_bits_[0] |= 0x00000004u;
   event_type_ = value;
 }
 inline void AutoReconnectFrame::set_event_type(::location::nearby::connections::AutoReconnectFrame_EventType value) {
@@ -14567,6 +15806,96 @@ inline void AutoReconnectFrame::set_event_type(::location::nearby::connections::
   // @@protoc_insertion_point(field_set:location.nearby.connections.AutoReconnectFrame.event_type)
 }
 
+// optional .location.nearby.connections.AutoReconnectFrame.SessionResumption session_resumption = 3;
+inline bool AutoReconnectFrame::_internal_has_session_resumption() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  PROTOBUF_ASSUME(!value || session_resumption_ != nullptr);
+  return value;
+}
+inline bool AutoReconnectFrame::has_session_resumption() const {
+  return _internal_has_session_resumption();
+}
+inline void AutoReconnectFrame::clear_session_resumption() {
+  if (session_resumption_ != nullptr) session_resumption_->Clear();
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline const ::location::nearby::connections::AutoReconnectFrame_SessionResumption& AutoReconnectFrame::_internal_session_resumption() const {
+  const ::location::nearby::connections::AutoReconnectFrame_SessionResumption* p = session_resumption_;
+  return p != nullptr ? *p : reinterpret_cast<const ::location::nearby::connections::AutoReconnectFrame_SessionResumption&>(
+      ::location::nearby::connections::_AutoReconnectFrame_SessionResumption_default_instance_);
+}
+inline const ::location::nearby::connections::AutoReconnectFrame_SessionResumption& AutoReconnectFrame::session_resumption() const {
+  // @@protoc_insertion_point(field_get:location.nearby.connections.AutoReconnectFrame.session_resumption)
+  return _internal_session_resumption();
+}
+inline void AutoReconnectFrame::unsafe_arena_set_allocated_session_resumption(
+    ::location::nearby::connections::AutoReconnectFrame_SessionResumption* session_resumption) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(session_resumption_);
+  }
+  session_resumption_ = session_resumption;
+  if (session_resumption) {
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:location.nearby.connections.AutoReconnectFrame.session_resumption)
+}
+inline ::location::nearby::connections::AutoReconnectFrame_SessionResumption* AutoReconnectFrame::release_session_resumption() {
+  _has_bits_[0] &= ~0x00000002u;
+  ::location::nearby::connections::AutoReconnectFrame_SessionResumption* temp = session_resumption_;
+  session_resumption_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::location::nearby::connections::AutoReconnectFrame_SessionResumption* AutoReconnectFrame::unsafe_arena_release_session_resumption() {
+  // @@protoc_insertion_point(field_release:location.nearby.connections.AutoReconnectFrame.session_resumption)
+  _has_bits_[0] &= ~0x00000002u;
+  ::location::nearby::connections::AutoReconnectFrame_SessionResumption* temp = session_resumption_;
+  session_resumption_ = nullptr;
+  return temp;
+}
+inline ::location::nearby::connections::AutoReconnectFrame_SessionResumption* AutoReconnectFrame::_internal_mutable_session_resumption() {
+  _has_bits_[0] |= 0x00000002u;
+  if (session_resumption_ == nullptr) {
+    auto* p = CreateMaybeMessage<::location::nearby::connections::AutoReconnectFrame_SessionResumption>(GetArenaForAllocation());
+    session_resumption_ = p;
+  }
+  return session_resumption_;
+}
+inline ::location::nearby::connections::AutoReconnectFrame_SessionResumption* AutoReconnectFrame::mutable_session_resumption() {
+  ::location::nearby::connections::AutoReconnectFrame_SessionResumption* _msg = _internal_mutable_session_resumption();
+  // @@protoc_insertion_point(field_mutable:location.nearby.connections.AutoReconnectFrame.session_resumption)
+  return _msg;
+}
+inline void AutoReconnectFrame::set_allocated_session_resumption(::location::nearby::connections::AutoReconnectFrame_SessionResumption* session_resumption) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete session_resumption_;
+  }
+  if (session_resumption) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper<::location::nearby::connections::AutoReconnectFrame_SessionResumption>::GetOwningArena(session_resumption);
+    if (message_arena != submessage_arena) {
+      session_resumption = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, session_resumption, submessage_arena);
+    }
+    _has_bits_[0] |= 0x00000002u;
+  } else {
+    _has_bits_[0] &= ~0x00000002u;
+  }
+  session_resumption_ = session_resumption;
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.connections.AutoReconnectFrame.session_resumption)
+}
+
 // -------------------------------------------------------------------
 
 // MediumMetadata
@@ -16487,6 +17816,10 @@ PresenceDevice::mutable_identity_type() {
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
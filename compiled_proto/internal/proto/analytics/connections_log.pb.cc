@@ -56,6 +56,7 @@ constexpr ConnectionsLog_OperationResultWithMedium::ConnectionsLog_OperationResu
 
   , result_code_(0)
 
+  , latency_millis_(int64_t{0})
   , connection_mode_(0)
 {}
 struct ConnectionsLog_OperationResultWithMediumDefaultTypeInternal {
@@ -168,7 +169,8 @@ constexpr ConnectionsLog_AdvertisingPhase::ConnectionsLog_AdvertisingPhase(
   , duration_millis_(int64_t{0})
   , client_flow_id_(int64_t{0})
   , stop_reason_(0)
-{}
+
+  , instant_on_lost_restarts_saved_(0){}
 struct ConnectionsLog_AdvertisingPhaseDefaultTypeInternal {
   constexpr ConnectionsLog_AdvertisingPhaseDefaultTypeInternal()
     : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
@@ -228,6 +230,7 @@ constexpr ConnectionsLog_EstablishedConnection::ConnectionsLog_EstablishedConnec
   , received_payload_()
   , connection_token_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
   , operation_result_(nullptr)
+  , phase_latencies_(nullptr)
   , duration_millis_(int64_t{0})
   , medium_(0)
 
@@ -247,6 +250,23 @@ struct ConnectionsLog_EstablishedConnectionDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT ConnectionsLog_EstablishedConnectionDefaultTypeInternal _ConnectionsLog_EstablishedConnection_default_instance_;
+constexpr ConnectionsLog_ConnectionPhaseLatencies::ConnectionsLog_ConnectionPhaseLatencies(
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : medium_connect_millis_(int64_t{0})
+  , connection_request_millis_(int64_t{0})
+  , encryption_millis_(int64_t{0})
+  , local_accept_millis_(int64_t{0})
+  , remote_accept_millis_(int64_t{0})
+  , total_millis_(int64_t{0}){}
+struct ConnectionsLog_ConnectionPhaseLatenciesDefaultTypeInternal {
+  constexpr ConnectionsLog_ConnectionPhaseLatenciesDefaultTypeInternal()
+    : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
+  ~ConnectionsLog_ConnectionPhaseLatenciesDefaultTypeInternal() {}
+  union {
+    ConnectionsLog_ConnectionPhaseLatencies _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT ConnectionsLog_ConnectionPhaseLatenciesDefaultTypeInternal _ConnectionsLog_ConnectionPhaseLatencies_default_instance_;
 constexpr ConnectionsLog_Payload::ConnectionsLog_Payload(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : operation_result_(nullptr)
@@ -271,7 +291,8 @@ struct ConnectionsLog_PayloadDefaultTypeInternal {
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT ConnectionsLog_PayloadDefaultTypeInternal _ConnectionsLog_Payload_default_instance_;
 constexpr ConnectionsLog_BandwidthUpgradeAttempt::ConnectionsLog_BandwidthUpgradeAttempt(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
-  : connection_token_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  : medium_scores_()
+  , connection_token_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
   , operation_result_(nullptr)
   , duration_millis_(int64_t{0})
   , direction_(0)
@@ -294,6 +315,22 @@ struct ConnectionsLog_BandwidthUpgradeAttemptDefaultTypeInternal {
   };
 };
 PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT ConnectionsLog_BandwidthUpgradeAttemptDefaultTypeInternal _ConnectionsLog_BandwidthUpgradeAttempt_default_instance_;
+constexpr ConnectionsLog_UpgradeMediumScore::ConnectionsLog_UpgradeMediumScore(
+  ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
+  : adjustment_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
+  , estimated_bytes_per_second_(int64_t{0})
+  , medium_(0)
+
+  , from_history_(false){}
+struct ConnectionsLog_UpgradeMediumScoreDefaultTypeInternal {
+  constexpr ConnectionsLog_UpgradeMediumScoreDefaultTypeInternal()
+    : _instance(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized{}) {}
+  ~ConnectionsLog_UpgradeMediumScoreDefaultTypeInternal() {}
+  union {
+    ConnectionsLog_UpgradeMediumScore _instance;
+  };
+};
+PROTOBUF_ATTRIBUTE_NO_DESTROY PROTOBUF_CONSTINIT ConnectionsLog_UpgradeMediumScoreDefaultTypeInternal _ConnectionsLog_UpgradeMediumScore_default_instance_;
 constexpr ConnectionsLog_ErrorCode::ConnectionsLog_ErrorCode(
   ::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized)
   : service_id_(&::PROTOBUF_NAMESPACE_ID::internal::fixed_address_empty_string)
@@ -1054,6 +1091,9 @@ class ConnectionsLog_OperationResultWithMedium::_Internal {
     (*has_bits)[0] |= 8u;
   }
   static void set_has_connection_mode(HasBits* has_bits) {
+    (*has_bits)[0] |= 32u;
+  }
+  static void set_has_latency_millis(HasBits* has_bits) {
     (*has_bits)[0] |= 16u;
   }
 };
@@ -1112,7 +1152,7 @@ void ConnectionsLog_OperationResultWithMedium::Clear() {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x0000001fu) {
+  if (cached_has_bits & 0x0000003fu) {
     ::memset(&medium_, 0, static_cast<size_t>(
         reinterpret_cast<char*>(&connection_mode_) -
         reinterpret_cast<char*>(&medium_)) + sizeof(connection_mode_));
@@ -1189,6 +1229,15 @@ const char* ConnectionsLog_OperationResultWithMedium::_InternalParse(const char*
         } else
           goto handle_unusual;
         continue;
+      // optional int64 latency_millis = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          _Internal::set_has_latency_millis(&has_bits);
+          latency_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -1248,12 +1297,18 @@ uint8_t* ConnectionsLog_OperationResultWithMedium::_InternalSerialize(
   }
 
   // optional .location.nearby.proto.connections.ConnectionMode connection_mode = 5;
-  if (cached_has_bits & 0x00000010u) {
+  if (cached_has_bits & 0x00000020u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       5, this->_internal_connection_mode(), target);
   }
 
+  // optional int64 latency_millis = 6;
+  if (cached_has_bits & 0x00000010u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(6, this->_internal_latency_millis(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -1271,7 +1326,7 @@ size_t ConnectionsLog_OperationResultWithMedium::ByteSizeLong() const {
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x0000001fu) {
+  if (cached_has_bits & 0x0000003fu) {
     // optional .location.nearby.proto.connections.Medium medium = 1;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -1295,8 +1350,13 @@ size_t ConnectionsLog_OperationResultWithMedium::ByteSizeLong() const {
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_result_code());
     }
 
-    // optional .location.nearby.proto.connections.ConnectionMode connection_mode = 5;
+    // optional int64 latency_millis = 6;
     if (cached_has_bits & 0x00000010u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_latency_millis());
+    }
+
+    // optional .location.nearby.proto.connections.ConnectionMode connection_mode = 5;
+    if (cached_has_bits & 0x00000020u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_connection_mode());
     }
@@ -1323,7 +1383,7 @@ void ConnectionsLog_OperationResultWithMedium::MergeFrom(const ConnectionsLog_Op
   (void) cached_has_bits;
 
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x0000001fu) {
+  if (cached_has_bits & 0x0000003fu) {
     if (cached_has_bits & 0x00000001u) {
       medium_ = from.medium_;
     }
@@ -1337,6 +1397,9 @@ void ConnectionsLog_OperationResultWithMedium::MergeFrom(const ConnectionsLog_Op
       result_code_ = from.result_code_;
     }
     if (cached_has_bits & 0x00000010u) {
+      latency_millis_ = from.latency_millis_;
+    }
+    if (cached_has_bits & 0x00000020u) {
       connection_mode_ = from.connection_mode_;
     }
     _has_bits_[0] |= cached_has_bits;
@@ -3359,6 +3422,9 @@ class ConnectionsLog_AdvertisingPhase::_Internal {
   static void set_has_stop_reason(HasBits* has_bits) {
     (*has_bits)[0] |= 8u;
   }
+  static void set_has_instant_on_lost_restarts_saved(HasBits* has_bits) {
+    (*has_bits)[0] |= 16u;
+  }
 };
 
 const ::location::nearby::analytics::proto::ConnectionsLog_AdvertisingMetadata&
@@ -3390,16 +3456,16 @@ ConnectionsLog_AdvertisingPhase::ConnectionsLog_AdvertisingPhase(const Connectio
     advertising_metadata_ = nullptr;
   }
   ::memcpy(&duration_millis_, &from.duration_millis_,
-    static_cast<size_t>(reinterpret_cast<char*>(&stop_reason_) -
-    reinterpret_cast<char*>(&duration_millis_)) + sizeof(stop_reason_));
+    static_cast<size_t>(reinterpret_cast<char*>(&instant_on_lost_restarts_saved_) -
+    reinterpret_cast<char*>(&duration_millis_)) + sizeof(instant_on_lost_restarts_saved_));
   // @@protoc_insertion_point(copy_constructor:location.nearby.analytics.proto.ConnectionsLog.AdvertisingPhase)
 }
 
 inline void ConnectionsLog_AdvertisingPhase::SharedCtor() {
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
     reinterpret_cast<char*>(&advertising_metadata_) - reinterpret_cast<char*>(this)),
-    0, static_cast<size_t>(reinterpret_cast<char*>(&stop_reason_) -
-    reinterpret_cast<char*>(&advertising_metadata_)) + sizeof(stop_reason_));
+    0, static_cast<size_t>(reinterpret_cast<char*>(&instant_on_lost_restarts_saved_) -
+    reinterpret_cast<char*>(&advertising_metadata_)) + sizeof(instant_on_lost_restarts_saved_));
 }
 
 ConnectionsLog_AdvertisingPhase::~ConnectionsLog_AdvertisingPhase() {
@@ -3438,10 +3504,10 @@ void ConnectionsLog_AdvertisingPhase::Clear() {
     GOOGLE_DCHECK(advertising_metadata_ != nullptr);
     advertising_metadata_->Clear();
   }
-  if (cached_has_bits & 0x0000000eu) {
+  if (cached_has_bits & 0x0000001eu) {
     ::memset(&duration_millis_, 0, static_cast<size_t>(
-        reinterpret_cast<char*>(&stop_reason_) -
-        reinterpret_cast<char*>(&duration_millis_)) + sizeof(stop_reason_));
+        reinterpret_cast<char*>(&instant_on_lost_restarts_saved_) -
+        reinterpret_cast<char*>(&duration_millis_)) + sizeof(instant_on_lost_restarts_saved_));
   }
   _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
@@ -3540,6 +3606,15 @@ const char* ConnectionsLog_AdvertisingPhase::_InternalParse(const char* ptr, ::P
         } else
           goto handle_unusual;
         continue;
+      // optional int32 instant_on_lost_restarts_saved = 8;
+      case 8:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 64)) {
+          _Internal::set_has_instant_on_lost_restarts_saved(&has_bits);
+          instant_on_lost_restarts_saved_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -3621,6 +3696,12 @@ uint8_t* ConnectionsLog_AdvertisingPhase::_InternalSerialize(
       7, this->_internal_stop_reason(), target);
   }
 
+  // optional int32 instant_on_lost_restarts_saved = 8;
+  if (cached_has_bits & 0x00000010u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt32ToArray(8, this->_internal_instant_on_lost_restarts_saved(), target);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -3662,7 +3743,7 @@ size_t ConnectionsLog_AdvertisingPhase::ByteSizeLong() const {
   }
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x0000000fu) {
+  if (cached_has_bits & 0x0000001fu) {
     // optional .location.nearby.analytics.proto.ConnectionsLog.AdvertisingMetadata advertising_metadata = 5;
     if (cached_has_bits & 0x00000001u) {
       total_size += 1 +
@@ -3686,6 +3767,11 @@ size_t ConnectionsLog_AdvertisingPhase::ByteSizeLong() const {
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_stop_reason());
     }
 
+    // optional int32 instant_on_lost_restarts_saved = 8;
+    if (cached_has_bits & 0x00000010u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int32SizePlusOne(this->_internal_instant_on_lost_restarts_saved());
+    }
+
   }
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
@@ -3711,7 +3797,7 @@ void ConnectionsLog_AdvertisingPhase::MergeFrom(const ConnectionsLog_Advertising
   received_connection_request_.MergeFrom(from.received_connection_request_);
   adv_dis_result_.MergeFrom(from.adv_dis_result_);
   cached_has_bits = from._has_bits_[0];
-  if (cached_has_bits & 0x0000000fu) {
+  if (cached_has_bits & 0x0000001fu) {
     if (cached_has_bits & 0x00000001u) {
       _internal_mutable_advertising_metadata()->::location::nearby::analytics::proto::ConnectionsLog_AdvertisingMetadata::MergeFrom(from._internal_advertising_metadata());
     }
@@ -3724,6 +3810,9 @@ void ConnectionsLog_AdvertisingPhase::MergeFrom(const ConnectionsLog_Advertising
     if (cached_has_bits & 0x00000008u) {
       stop_reason_ = from.stop_reason_;
     }
+    if (cached_has_bits & 0x00000010u) {
+      instant_on_lost_restarts_saved_ = from.instant_on_lost_restarts_saved_;
+    }
     _has_bits_[0] |= cached_has_bits;
   }
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
@@ -3748,8 +3837,8 @@ void ConnectionsLog_AdvertisingPhase::InternalSwap(ConnectionsLog_AdvertisingPha
   received_connection_request_.InternalSwap(&other->received_connection_request_);
   adv_dis_result_.InternalSwap(&other->adv_dis_result_);
   ::PROTOBUF_NAMESPACE_ID::internal::memswap<
-      PROTOBUF_FIELD_OFFSET(ConnectionsLog_AdvertisingPhase, stop_reason_)
-      + sizeof(ConnectionsLog_AdvertisingPhase::stop_reason_)
+      PROTOBUF_FIELD_OFFSET(ConnectionsLog_AdvertisingPhase, instant_on_lost_restarts_saved_)
+      + sizeof(ConnectionsLog_AdvertisingPhase::instant_on_lost_restarts_saved_)
       - PROTOBUF_FIELD_OFFSET(ConnectionsLog_AdvertisingPhase, advertising_metadata_)>(
           reinterpret_cast<char*>(&advertising_metadata_),
           reinterpret_cast<char*>(&other->advertising_metadata_));
@@ -4635,36 +4724,44 @@ class ConnectionsLog_EstablishedConnection::_Internal {
  public:
   using HasBits = decltype(std::declval<ConnectionsLog_EstablishedConnection>()._has_bits_);
   static void set_has_duration_millis(HasBits* has_bits) {
-    (*has_bits)[0] |= 4u;
+    (*has_bits)[0] |= 8u;
   }
   static void set_has_medium(HasBits* has_bits) {
-    (*has_bits)[0] |= 8u;
+    (*has_bits)[0] |= 16u;
   }
   static void set_has_disconnection_reason(HasBits* has_bits) {
-    (*has_bits)[0] |= 16u;
+    (*has_bits)[0] |= 32u;
   }
   static void set_has_client_flow_id(HasBits* has_bits) {
-    (*has_bits)[0] |= 32u;
+    (*has_bits)[0] |= 64u;
   }
   static void set_has_connection_token(HasBits* has_bits) {
     (*has_bits)[0] |= 1u;
   }
   static void set_has_type(HasBits* has_bits) {
-    (*has_bits)[0] |= 64u;
+    (*has_bits)[0] |= 128u;
   }
   static void set_has_safe_disconnection_result(HasBits* has_bits) {
-    (*has_bits)[0] |= 128u;
+    (*has_bits)[0] |= 256u;
   }
   static const ::location::nearby::analytics::proto::ConnectionsLog_OperationResult& operation_result(const ConnectionsLog_EstablishedConnection* msg);
   static void set_has_operation_result(HasBits* has_bits) {
     (*has_bits)[0] |= 2u;
   }
+  static const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies& phase_latencies(const ConnectionsLog_EstablishedConnection* msg);
+  static void set_has_phase_latencies(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
 };
 
 const ::location::nearby::analytics::proto::ConnectionsLog_OperationResult&
 ConnectionsLog_EstablishedConnection::_Internal::operation_result(const ConnectionsLog_EstablishedConnection* msg) {
   return *msg->operation_result_;
 }
+const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies&
+ConnectionsLog_EstablishedConnection::_Internal::phase_latencies(const ConnectionsLog_EstablishedConnection* msg) {
+  return *msg->phase_latencies_;
+}
 ConnectionsLog_EstablishedConnection::ConnectionsLog_EstablishedConnection(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned),
@@ -4695,6 +4792,11 @@ ConnectionsLog_EstablishedConnection::ConnectionsLog_EstablishedConnection(const
   } else {
     operation_result_ = nullptr;
   }
+  if (from._internal_has_phase_latencies()) {
+    phase_latencies_ = new ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies(*from.phase_latencies_);
+  } else {
+    phase_latencies_ = nullptr;
+  }
   ::memcpy(&duration_millis_, &from.duration_millis_,
     static_cast<size_t>(reinterpret_cast<char*>(&safe_disconnection_result_) -
     reinterpret_cast<char*>(&duration_millis_)) + sizeof(safe_disconnection_result_));
@@ -4723,6 +4825,7 @@ inline void ConnectionsLog_EstablishedConnection::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
   connection_token_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
   if (this != internal_default_instance()) delete operation_result_;
+  if (this != internal_default_instance()) delete phase_latencies_;
 }
 
 void ConnectionsLog_EstablishedConnection::ArenaDtor(void* object) {
@@ -4744,7 +4847,7 @@ void ConnectionsLog_EstablishedConnection::Clear() {
   sent_payload_.Clear();
   received_payload_.Clear();
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000003u) {
+  if (cached_has_bits & 0x00000007u) {
     if (cached_has_bits & 0x00000001u) {
       connection_token_.ClearNonDefaultToEmpty();
     }
@@ -4752,12 +4855,17 @@ void ConnectionsLog_EstablishedConnection::Clear() {
       GOOGLE_DCHECK(operation_result_ != nullptr);
       operation_result_->Clear();
     }
+    if (cached_has_bits & 0x00000004u) {
+      GOOGLE_DCHECK(phase_latencies_ != nullptr);
+      phase_latencies_->Clear();
+    }
   }
-  if (cached_has_bits & 0x000000fcu) {
+  if (cached_has_bits & 0x000000f8u) {
     ::memset(&duration_millis_, 0, static_cast<size_t>(
-        reinterpret_cast<char*>(&safe_disconnection_result_) -
-        reinterpret_cast<char*>(&duration_millis_)) + sizeof(safe_disconnection_result_));
+        reinterpret_cast<char*>(&type_) -
+        reinterpret_cast<char*>(&duration_millis_)) + sizeof(type_));
   }
+  safe_disconnection_result_ = 0;
   _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
 }
@@ -4882,6 +4990,14 @@ const char* ConnectionsLog_EstablishedConnection::_InternalParse(const char* ptr
         } else
           goto handle_unusual;
         continue;
+      // optional .location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies phase_latencies = 11;
+      case 11:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 90)) {
+          ptr = ctx->ParseMessage(_internal_mutable_phase_latencies(), ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -4914,13 +5030,13 @@ uint8_t* ConnectionsLog_EstablishedConnection::_InternalSerialize(
 
   cached_has_bits = _has_bits_[0];
   // optional int64 duration_millis = 1;
-  if (cached_has_bits & 0x00000004u) {
+  if (cached_has_bits & 0x00000008u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(1, this->_internal_duration_millis(), target);
   }
 
   // optional .location.nearby.proto.connections.Medium medium = 2;
-  if (cached_has_bits & 0x00000008u) {
+  if (cached_has_bits & 0x00000010u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       2, this->_internal_medium(), target);
@@ -4943,14 +5059,14 @@ uint8_t* ConnectionsLog_EstablishedConnection::_InternalSerialize(
   }
 
   // optional .location.nearby.proto.connections.DisconnectionReason disconnection_reason = 5;
-  if (cached_has_bits & 0x00000010u) {
+  if (cached_has_bits & 0x00000020u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       5, this->_internal_disconnection_reason(), target);
   }
 
   // optional int64 client_flow_id = 6;
-  if (cached_has_bits & 0x00000020u) {
+  if (cached_has_bits & 0x00000040u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(6, this->_internal_client_flow_id(), target);
   }
@@ -4962,14 +5078,14 @@ uint8_t* ConnectionsLog_EstablishedConnection::_InternalSerialize(
   }
 
   // optional .location.nearby.proto.connections.ConnectionAttemptType type = 8;
-  if (cached_has_bits & 0x00000040u) {
+  if (cached_has_bits & 0x00000080u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       8, this->_internal_type(), target);
   }
 
   // optional .location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.SafeDisconnectionResult safe_disconnection_result = 9;
-  if (cached_has_bits & 0x00000080u) {
+  if (cached_has_bits & 0x00000100u) {
     target = stream->EnsureSpace(target);
     target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
       9, this->_internal_safe_disconnection_result(), target);
@@ -4983,6 +5099,14 @@ uint8_t* ConnectionsLog_EstablishedConnection::_InternalSerialize(
         10, _Internal::operation_result(this), target, stream);
   }
 
+  // optional .location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies phase_latencies = 11;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(
+        11, _Internal::phase_latencies(this), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -5029,41 +5153,48 @@ size_t ConnectionsLog_EstablishedConnection::ByteSizeLong() const {
           *operation_result_);
     }
 
-    // optional int64 duration_millis = 1;
+    // optional .location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies phase_latencies = 11;
     if (cached_has_bits & 0x00000004u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(
+          *phase_latencies_);
+    }
+
+    // optional int64 duration_millis = 1;
+    if (cached_has_bits & 0x00000008u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_duration_millis());
     }
 
     // optional .location.nearby.proto.connections.Medium medium = 2;
-    if (cached_has_bits & 0x00000008u) {
+    if (cached_has_bits & 0x00000010u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_medium());
     }
 
     // optional .location.nearby.proto.connections.DisconnectionReason disconnection_reason = 5;
-    if (cached_has_bits & 0x00000010u) {
+    if (cached_has_bits & 0x00000020u) {
       total_size += 1 +
         ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_disconnection_reason());
     }
 
     // optional int64 client_flow_id = 6;
-    if (cached_has_bits & 0x00000020u) {
+    if (cached_has_bits & 0x00000040u) {
       total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_client_flow_id());
     }
 
     // optional .location.nearby.proto.connections.ConnectionAttemptType type = 8;
-    if (cached_has_bits & 0x00000040u) {
-      total_size += 1 +
-        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_type());
-    }
-
-    // optional .location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.SafeDisconnectionResult safe_disconnection_result = 9;
     if (cached_has_bits & 0x00000080u) {
       total_size += 1 +
-        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_safe_disconnection_result());
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_type());
     }
 
   }
+  // optional .location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.SafeDisconnectionResult safe_disconnection_result = 9;
+  if (cached_has_bits & 0x00000100u) {
+    total_size += 1 +
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_safe_disconnection_result());
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
   }
@@ -5095,25 +5226,28 @@ void ConnectionsLog_EstablishedConnection::MergeFrom(const ConnectionsLog_Establ
       _internal_mutable_operation_result()->::location::nearby::analytics::proto::ConnectionsLog_OperationResult::MergeFrom(from._internal_operation_result());
     }
     if (cached_has_bits & 0x00000004u) {
-      duration_millis_ = from.duration_millis_;
+      _internal_mutable_phase_latencies()->::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies::MergeFrom(from._internal_phase_latencies());
     }
     if (cached_has_bits & 0x00000008u) {
-      medium_ = from.medium_;
+      duration_millis_ = from.duration_millis_;
     }
     if (cached_has_bits & 0x00000010u) {
-      disconnection_reason_ = from.disconnection_reason_;
+      medium_ = from.medium_;
     }
     if (cached_has_bits & 0x00000020u) {
-      client_flow_id_ = from.client_flow_id_;
+      disconnection_reason_ = from.disconnection_reason_;
     }
     if (cached_has_bits & 0x00000040u) {
-      type_ = from.type_;
+      client_flow_id_ = from.client_flow_id_;
     }
     if (cached_has_bits & 0x00000080u) {
-      safe_disconnection_result_ = from.safe_disconnection_result_;
+      type_ = from.type_;
     }
     _has_bits_[0] |= cached_has_bits;
   }
+  if (cached_has_bits & 0x00000100u) {
+    _internal_set_safe_disconnection_result(from._internal_safe_disconnection_result());
+  }
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
 }
 
@@ -5156,192 +5290,530 @@ std::string ConnectionsLog_EstablishedConnection::GetTypeName() const {
 
 // ===================================================================
 
-class ConnectionsLog_Payload::_Internal {
+class ConnectionsLog_ConnectionPhaseLatencies::_Internal {
  public:
-  using HasBits = decltype(std::declval<ConnectionsLog_Payload>()._has_bits_);
-  static void set_has_duration_millis(HasBits* has_bits) {
-    (*has_bits)[0] |= 2u;
+  using HasBits = decltype(std::declval<ConnectionsLog_ConnectionPhaseLatencies>()._has_bits_);
+  static void set_has_medium_connect_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
   }
-  static void set_has_type(HasBits* has_bits) {
-    (*has_bits)[0] |= 8u;
+  static void set_has_connection_request_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
   }
-  static void set_has_total_size_bytes(HasBits* has_bits) {
+  static void set_has_encryption_millis(HasBits* has_bits) {
     (*has_bits)[0] |= 4u;
   }
-  static void set_has_num_bytes_transferred(HasBits* has_bits) {
-    (*has_bits)[0] |= 32u;
+  static void set_has_local_accept_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 8u;
   }
-  static void set_has_num_chunks(HasBits* has_bits) {
+  static void set_has_remote_accept_millis(HasBits* has_bits) {
     (*has_bits)[0] |= 16u;
   }
-  static void set_has_status(HasBits* has_bits) {
-    (*has_bits)[0] |= 64u;
-  }
-  static void set_has_num_successful_auto_resume(HasBits* has_bits) {
-    (*has_bits)[0] |= 128u;
-  }
-  static const ::location::nearby::analytics::proto::ConnectionsLog_OperationResult& operation_result(const ConnectionsLog_Payload* msg);
-  static void set_has_operation_result(HasBits* has_bits) {
-    (*has_bits)[0] |= 1u;
-  }
-  static void set_has_num_failed_auto_resume(HasBits* has_bits) {
-    (*has_bits)[0] |= 256u;
+  static void set_has_total_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 32u;
   }
 };
 
-const ::location::nearby::analytics::proto::ConnectionsLog_OperationResult&
-ConnectionsLog_Payload::_Internal::operation_result(const ConnectionsLog_Payload* msg) {
-  return *msg->operation_result_;
-}
-ConnectionsLog_Payload::ConnectionsLog_Payload(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+ConnectionsLog_ConnectionPhaseLatencies::ConnectionsLog_ConnectionPhaseLatencies(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
   SharedCtor();
   if (!is_message_owned) {
     RegisterArenaDtor(arena);
   }
-  // @@protoc_insertion_point(arena_constructor:location.nearby.analytics.proto.ConnectionsLog.Payload)
+  // @@protoc_insertion_point(arena_constructor:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
 }
-ConnectionsLog_Payload::ConnectionsLog_Payload(const ConnectionsLog_Payload& from)
+ConnectionsLog_ConnectionPhaseLatencies::ConnectionsLog_ConnectionPhaseLatencies(const ConnectionsLog_ConnectionPhaseLatencies& from)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
       _has_bits_(from._has_bits_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
-  if (from._internal_has_operation_result()) {
-    operation_result_ = new ::location::nearby::analytics::proto::ConnectionsLog_OperationResult(*from.operation_result_);
-  } else {
-    operation_result_ = nullptr;
-  }
-  ::memcpy(&duration_millis_, &from.duration_millis_,
-    static_cast<size_t>(reinterpret_cast<char*>(&num_failed_auto_resume_) -
-    reinterpret_cast<char*>(&duration_millis_)) + sizeof(num_failed_auto_resume_));
-  // @@protoc_insertion_point(copy_constructor:location.nearby.analytics.proto.ConnectionsLog.Payload)
+  ::memcpy(&medium_connect_millis_, &from.medium_connect_millis_,
+    static_cast<size_t>(reinterpret_cast<char*>(&total_millis_) -
+    reinterpret_cast<char*>(&medium_connect_millis_)) + sizeof(total_millis_));
+  // @@protoc_insertion_point(copy_constructor:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
 }
 
-inline void ConnectionsLog_Payload::SharedCtor() {
+inline void ConnectionsLog_ConnectionPhaseLatencies::SharedCtor() {
 ::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
-    reinterpret_cast<char*>(&operation_result_) - reinterpret_cast<char*>(this)),
-    0, static_cast<size_t>(reinterpret_cast<char*>(&num_failed_auto_resume_) -
-    reinterpret_cast<char*>(&operation_result_)) + sizeof(num_failed_auto_resume_));
+    reinterpret_cast<char*>(&medium_connect_millis_) - reinterpret_cast<char*>(this)),
+    0, static_cast<size_t>(reinterpret_cast<char*>(&total_millis_) -
+    reinterpret_cast<char*>(&medium_connect_millis_)) + sizeof(total_millis_));
 }
 
-ConnectionsLog_Payload::~ConnectionsLog_Payload() {
-  // @@protoc_insertion_point(destructor:location.nearby.analytics.proto.ConnectionsLog.Payload)
+ConnectionsLog_ConnectionPhaseLatencies::~ConnectionsLog_ConnectionPhaseLatencies() {
+  // @@protoc_insertion_point(destructor:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
   if (GetArenaForAllocation() != nullptr) return;
   SharedDtor();
   _internal_metadata_.Delete<std::string>();
 }
 
-inline void ConnectionsLog_Payload::SharedDtor() {
+inline void ConnectionsLog_ConnectionPhaseLatencies::SharedDtor() {
   GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
-  if (this != internal_default_instance()) delete operation_result_;
 }
 
-void ConnectionsLog_Payload::ArenaDtor(void* object) {
-  ConnectionsLog_Payload* _this = reinterpret_cast< ConnectionsLog_Payload* >(object);
+void ConnectionsLog_ConnectionPhaseLatencies::ArenaDtor(void* object) {
+  ConnectionsLog_ConnectionPhaseLatencies* _this = reinterpret_cast< ConnectionsLog_ConnectionPhaseLatencies* >(object);
   (void)_this;
 }
-void ConnectionsLog_Payload::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+void ConnectionsLog_ConnectionPhaseLatencies::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
 }
-void ConnectionsLog_Payload::SetCachedSize(int size) const {
+void ConnectionsLog_ConnectionPhaseLatencies::SetCachedSize(int size) const {
   _cached_size_.Set(size);
 }
 
-void ConnectionsLog_Payload::Clear() {
-// @@protoc_insertion_point(message_clear_start:location.nearby.analytics.proto.ConnectionsLog.Payload)
+void ConnectionsLog_ConnectionPhaseLatencies::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
   uint32_t cached_has_bits = 0;
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
   cached_has_bits = _has_bits_[0];
-  if (cached_has_bits & 0x00000001u) {
-    GOOGLE_DCHECK(operation_result_ != nullptr);
-    operation_result_->Clear();
-  }
-  if (cached_has_bits & 0x000000feu) {
-    ::memset(&duration_millis_, 0, static_cast<size_t>(
-        reinterpret_cast<char*>(&num_successful_auto_resume_) -
-        reinterpret_cast<char*>(&duration_millis_)) + sizeof(num_successful_auto_resume_));
+  if (cached_has_bits & 0x0000003fu) {
+    ::memset(&medium_connect_millis_, 0, static_cast<size_t>(
+        reinterpret_cast<char*>(&total_millis_) -
+        reinterpret_cast<char*>(&medium_connect_millis_)) + sizeof(total_millis_));
   }
-  num_failed_auto_resume_ = 0;
   _has_bits_.Clear();
   _internal_metadata_.Clear<std::string>();
 }
 
-const char* ConnectionsLog_Payload::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+const char* ConnectionsLog_ConnectionPhaseLatencies::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
 #define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
   _Internal::HasBits has_bits{};
   while (!ctx->Done(&ptr)) {
     uint32_t tag;
     ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
     switch (tag >> 3) {
-      // optional int64 duration_millis = 1;
+      // optional int64 medium_connect_millis = 1;
       case 1:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
-          _Internal::set_has_duration_millis(&has_bits);
-          duration_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          _Internal::set_has_medium_connect_millis(&has_bits);
+          medium_connect_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
         } else
           goto handle_unusual;
         continue;
-      // optional .location.nearby.proto.connections.PayloadType type = 2;
+      // optional int64 connection_request_millis = 2;
       case 2:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
-          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          _Internal::set_has_connection_request_millis(&has_bits);
+          connection_request_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
-          if (PROTOBUF_PREDICT_TRUE(::location::nearby::proto::connections::PayloadType_IsValid(val))) {
-            _internal_set_type(static_cast<::location::nearby::proto::connections::PayloadType>(val));
-          } else {
-            ::PROTOBUF_NAMESPACE_ID::internal::WriteVarint(2, val, mutable_unknown_fields());
-          }
         } else
           goto handle_unusual;
         continue;
-      // optional int64 total_size_bytes = 3;
+      // optional int64 encryption_millis = 3;
       case 3:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
-          _Internal::set_has_total_size_bytes(&has_bits);
-          total_size_bytes_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          _Internal::set_has_encryption_millis(&has_bits);
+          encryption_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
         } else
           goto handle_unusual;
         continue;
-      // optional int64 num_bytes_transferred = 4;
+      // optional int64 local_accept_millis = 4;
       case 4:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
-          _Internal::set_has_num_bytes_transferred(&has_bits);
-          num_bytes_transferred_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          _Internal::set_has_local_accept_millis(&has_bits);
+          local_accept_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
         } else
           goto handle_unusual;
         continue;
-      // optional int32 num_chunks = 5;
+      // optional int64 remote_accept_millis = 5;
       case 5:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
-          _Internal::set_has_num_chunks(&has_bits);
-          num_chunks_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          _Internal::set_has_remote_accept_millis(&has_bits);
+          remote_accept_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
         } else
           goto handle_unusual;
         continue;
-      // optional .location.nearby.proto.connections.PayloadStatus status = 6;
+      // optional int64 total_millis = 6;
       case 6:
         if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
-          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          _Internal::set_has_total_millis(&has_bits);
+          total_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
           CHK_(ptr);
-          if (PROTOBUF_PREDICT_TRUE(::location::nearby::proto::connections::PayloadStatus_IsValid(val))) {
-            _internal_set_status(static_cast<::location::nearby::proto::connections::PayloadStatus>(val));
-          } else {
-            ::PROTOBUF_NAMESPACE_ID::internal::WriteVarint(6, val, mutable_unknown_fields());
-          }
         } else
           goto handle_unusual;
         continue;
-      // optional int32 num_successful_auto_resume = 7;
-      case 7:
-        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
-          _Internal::set_has_num_successful_auto_resume(&has_bits);
-          num_successful_auto_resume_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
-          CHK_(ptr);
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ConnectionsLog_ConnectionPhaseLatencies::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // optional int64 medium_connect_millis = 1;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(1, this->_internal_medium_connect_millis(), target);
+  }
+
+  // optional int64 connection_request_millis = 2;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(2, this->_internal_connection_request_millis(), target);
+  }
+
+  // optional int64 encryption_millis = 3;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(3, this->_internal_encryption_millis(), target);
+  }
+
+  // optional int64 local_accept_millis = 4;
+  if (cached_has_bits & 0x00000008u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(4, this->_internal_local_accept_millis(), target);
+  }
+
+  // optional int64 remote_accept_millis = 5;
+  if (cached_has_bits & 0x00000010u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(5, this->_internal_remote_accept_millis(), target);
+  }
+
+  // optional int64 total_millis = 6;
+  if (cached_has_bits & 0x00000020u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(6, this->_internal_total_millis(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
+  return target;
+}
+
+size_t ConnectionsLog_ConnectionPhaseLatencies::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x0000003fu) {
+    // optional int64 medium_connect_millis = 1;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_medium_connect_millis());
+    }
+
+    // optional int64 connection_request_millis = 2;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_connection_request_millis());
+    }
+
+    // optional int64 encryption_millis = 3;
+    if (cached_has_bits & 0x00000004u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_encryption_millis());
+    }
+
+    // optional int64 local_accept_millis = 4;
+    if (cached_has_bits & 0x00000008u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_local_accept_millis());
+    }
+
+    // optional int64 remote_accept_millis = 5;
+    if (cached_has_bits & 0x00000010u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_remote_accept_millis());
+    }
+
+    // optional int64 total_millis = 6;
+    if (cached_has_bits & 0x00000020u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_total_millis());
+    }
+
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void ConnectionsLog_ConnectionPhaseLatencies::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ConnectionsLog_ConnectionPhaseLatencies*>(
+      &from));
+}
+
+void ConnectionsLog_ConnectionPhaseLatencies::MergeFrom(const ConnectionsLog_ConnectionPhaseLatencies& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
+  GOOGLE_DCHECK_NE(&from, this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 0x0000003fu) {
+    if (cached_has_bits & 0x00000001u) {
+      medium_connect_millis_ = from.medium_connect_millis_;
+    }
+    if (cached_has_bits & 0x00000002u) {
+      connection_request_millis_ = from.connection_request_millis_;
+    }
+    if (cached_has_bits & 0x00000004u) {
+      encryption_millis_ = from.encryption_millis_;
+    }
+    if (cached_has_bits & 0x00000008u) {
+      local_accept_millis_ = from.local_accept_millis_;
+    }
+    if (cached_has_bits & 0x00000010u) {
+      remote_accept_millis_ = from.remote_accept_millis_;
+    }
+    if (cached_has_bits & 0x00000020u) {
+      total_millis_ = from.total_millis_;
+    }
+    _has_bits_[0] |= cached_has_bits;
+  }
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void ConnectionsLog_ConnectionPhaseLatencies::CopyFrom(const ConnectionsLog_ConnectionPhaseLatencies& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ConnectionsLog_ConnectionPhaseLatencies::IsInitialized() const {
+  return true;
+}
+
+void ConnectionsLog_ConnectionPhaseLatencies::InternalSwap(ConnectionsLog_ConnectionPhaseLatencies* other) {
+  using std::swap;
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(ConnectionsLog_ConnectionPhaseLatencies, total_millis_)
+      + sizeof(ConnectionsLog_ConnectionPhaseLatencies::total_millis_)
+      - PROTOBUF_FIELD_OFFSET(ConnectionsLog_ConnectionPhaseLatencies, medium_connect_millis_)>(
+          reinterpret_cast<char*>(&medium_connect_millis_),
+          reinterpret_cast<char*>(&other->medium_connect_millis_));
+}
+
+std::string ConnectionsLog_ConnectionPhaseLatencies::GetTypeName() const {
+  return "location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies";
+}
+
+
+// ===================================================================
+
+class ConnectionsLog_Payload::_Internal {
+ public:
+  using HasBits = decltype(std::declval<ConnectionsLog_Payload>()._has_bits_);
+  static void set_has_duration_millis(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static void set_has_type(HasBits* has_bits) {
+    (*has_bits)[0] |= 8u;
+  }
+  static void set_has_total_size_bytes(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
+  static void set_has_num_bytes_transferred(HasBits* has_bits) {
+    (*has_bits)[0] |= 32u;
+  }
+  static void set_has_num_chunks(HasBits* has_bits) {
+    (*has_bits)[0] |= 16u;
+  }
+  static void set_has_status(HasBits* has_bits) {
+    (*has_bits)[0] |= 64u;
+  }
+  static void set_has_num_successful_auto_resume(HasBits* has_bits) {
+    (*has_bits)[0] |= 128u;
+  }
+  static const ::location::nearby::analytics::proto::ConnectionsLog_OperationResult& operation_result(const ConnectionsLog_Payload* msg);
+  static void set_has_operation_result(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+  static void set_has_num_failed_auto_resume(HasBits* has_bits) {
+    (*has_bits)[0] |= 256u;
+  }
+};
+
+const ::location::nearby::analytics::proto::ConnectionsLog_OperationResult&
+ConnectionsLog_Payload::_Internal::operation_result(const ConnectionsLog_Payload* msg) {
+  return *msg->operation_result_;
+}
+ConnectionsLog_Payload::ConnectionsLog_Payload(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor();
+  if (!is_message_owned) {
+    RegisterArenaDtor(arena);
+  }
+  // @@protoc_insertion_point(arena_constructor:location.nearby.analytics.proto.ConnectionsLog.Payload)
+}
+ConnectionsLog_Payload::ConnectionsLog_Payload(const ConnectionsLog_Payload& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  if (from._internal_has_operation_result()) {
+    operation_result_ = new ::location::nearby::analytics::proto::ConnectionsLog_OperationResult(*from.operation_result_);
+  } else {
+    operation_result_ = nullptr;
+  }
+  ::memcpy(&duration_millis_, &from.duration_millis_,
+    static_cast<size_t>(reinterpret_cast<char*>(&num_failed_auto_resume_) -
+    reinterpret_cast<char*>(&duration_millis_)) + sizeof(num_failed_auto_resume_));
+  // @@protoc_insertion_point(copy_constructor:location.nearby.analytics.proto.ConnectionsLog.Payload)
+}
+
+inline void ConnectionsLog_Payload::SharedCtor() {
+::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
+    reinterpret_cast<char*>(&operation_result_) - reinterpret_cast<char*>(this)),
+    0, static_cast<size_t>(reinterpret_cast<char*>(&num_failed_auto_resume_) -
+    reinterpret_cast<char*>(&operation_result_)) + sizeof(num_failed_auto_resume_));
+}
+
+ConnectionsLog_Payload::~ConnectionsLog_Payload() {
+  // @@protoc_insertion_point(destructor:location.nearby.analytics.proto.ConnectionsLog.Payload)
+  if (GetArenaForAllocation() != nullptr) return;
+  SharedDtor();
+  _internal_metadata_.Delete<std::string>();
+}
+
+inline void ConnectionsLog_Payload::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  if (this != internal_default_instance()) delete operation_result_;
+}
+
+void ConnectionsLog_Payload::ArenaDtor(void* object) {
+  ConnectionsLog_Payload* _this = reinterpret_cast< ConnectionsLog_Payload* >(object);
+  (void)_this;
+}
+void ConnectionsLog_Payload::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+}
+void ConnectionsLog_Payload::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+
+void ConnectionsLog_Payload::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.analytics.proto.ConnectionsLog.Payload)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
+    GOOGLE_DCHECK(operation_result_ != nullptr);
+    operation_result_->Clear();
+  }
+  if (cached_has_bits & 0x000000feu) {
+    ::memset(&duration_millis_, 0, static_cast<size_t>(
+        reinterpret_cast<char*>(&num_successful_auto_resume_) -
+        reinterpret_cast<char*>(&duration_millis_)) + sizeof(num_successful_auto_resume_));
+  }
+  num_failed_auto_resume_ = 0;
+  _has_bits_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* ConnectionsLog_Payload::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional int64 duration_millis = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          _Internal::set_has_duration_millis(&has_bits);
+          duration_millis_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional .location.nearby.proto.connections.PayloadType type = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          if (PROTOBUF_PREDICT_TRUE(::location::nearby::proto::connections::PayloadType_IsValid(val))) {
+            _internal_set_type(static_cast<::location::nearby::proto::connections::PayloadType>(val));
+          } else {
+            ::PROTOBUF_NAMESPACE_ID::internal::WriteVarint(2, val, mutable_unknown_fields());
+          }
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 total_size_bytes = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _Internal::set_has_total_size_bytes(&has_bits);
+          total_size_bytes_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 num_bytes_transferred = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 32)) {
+          _Internal::set_has_num_bytes_transferred(&has_bits);
+          num_bytes_transferred_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int32 num_chunks = 5;
+      case 5:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 40)) {
+          _Internal::set_has_num_chunks(&has_bits);
+          num_chunks_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional .location.nearby.proto.connections.PayloadStatus status = 6;
+      case 6:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 48)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          if (PROTOBUF_PREDICT_TRUE(::location::nearby::proto::connections::PayloadStatus_IsValid(val))) {
+            _internal_set_status(static_cast<::location::nearby::proto::connections::PayloadStatus>(val));
+          } else {
+            ::PROTOBUF_NAMESPACE_ID::internal::WriteVarint(6, val, mutable_unknown_fields());
+          }
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int32 num_successful_auto_resume = 7;
+      case 7:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 56)) {
+          _Internal::set_has_num_successful_auto_resume(&has_bits);
+          num_successful_auto_resume_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint32(&ptr);
+          CHK_(ptr);
         } else
           goto handle_unusual;
         continue;
@@ -5642,7 +6114,8 @@ ConnectionsLog_BandwidthUpgradeAttempt::_Internal::operation_result(const Connec
 }
 ConnectionsLog_BandwidthUpgradeAttempt::ConnectionsLog_BandwidthUpgradeAttempt(::PROTOBUF_NAMESPACE_ID::Arena* arena,
                          bool is_message_owned)
-  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned),
+  medium_scores_(arena) {
   SharedCtor();
   if (!is_message_owned) {
     RegisterArenaDtor(arena);
@@ -5651,7 +6124,8 @@ ConnectionsLog_BandwidthUpgradeAttempt::ConnectionsLog_BandwidthUpgradeAttempt(:
 }
 ConnectionsLog_BandwidthUpgradeAttempt::ConnectionsLog_BandwidthUpgradeAttempt(const ConnectionsLog_BandwidthUpgradeAttempt& from)
   : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
-      _has_bits_(from._has_bits_) {
+      _has_bits_(from._has_bits_),
+      medium_scores_(from.medium_scores_) {
   _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
   connection_token_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
   #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
@@ -5712,6 +6186,7 @@ void ConnectionsLog_BandwidthUpgradeAttempt::Clear() {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  medium_scores_.Clear();
   cached_has_bits = _has_bits_[0];
   if (cached_has_bits & 0x00000003u) {
     if (cached_has_bits & 0x00000001u) {
@@ -5839,6 +6314,19 @@ const char* ConnectionsLog_BandwidthUpgradeAttempt::_InternalParse(const char* p
         } else
           goto handle_unusual;
         continue;
+      // repeated .location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore medium_scores = 10;
+      case 10:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 82)) {
+          ptr -= 1;
+          do {
+            ptr += 1;
+            ptr = ctx->ParseMessage(_internal_add_medium_scores(), ptr);
+            CHK_(ptr);
+            if (!ctx->DataAvailable(ptr)) break;
+          } while (::PROTOBUF_NAMESPACE_ID::internal::ExpectTag<82>(ptr));
+        } else
+          goto handle_unusual;
+        continue;
       default:
         goto handle_unusual;
     }  // switch
@@ -5931,6 +6419,14 @@ uint8_t* ConnectionsLog_BandwidthUpgradeAttempt::_InternalSerialize(
         9, _Internal::operation_result(this), target, stream);
   }
 
+  // repeated .location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore medium_scores = 10;
+  for (unsigned int i = 0,
+      n = static_cast<unsigned int>(this->_internal_medium_scores_size()); i < n; i++) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::
+      InternalWriteMessage(10, this->_internal_medium_scores(i), target, stream);
+  }
+
   if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
     target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
         static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
@@ -5947,6 +6443,13 @@ size_t ConnectionsLog_BandwidthUpgradeAttempt::ByteSizeLong() const {
   // Prevent compiler warnings about cached_has_bits being unused
   (void) cached_has_bits;
 
+  // repeated .location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore medium_scores = 10;
+  total_size += 1UL * this->_internal_medium_scores_size();
+  for (const auto& msg : this->medium_scores_) {
+    total_size +=
+      ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::MessageSize(msg);
+  }
+
   cached_has_bits = _has_bits_[0];
   if (cached_has_bits & 0x000000ffu) {
     // optional string connection_token = 8;
@@ -6024,6 +6527,7 @@ void ConnectionsLog_BandwidthUpgradeAttempt::MergeFrom(const ConnectionsLog_Band
   uint32_t cached_has_bits = 0;
   (void) cached_has_bits;
 
+  medium_scores_.MergeFrom(from.medium_scores_);
   cached_has_bits = from._has_bits_[0];
   if (cached_has_bits & 0x000000ffu) {
     if (cached_has_bits & 0x00000001u) {
@@ -6075,6 +6579,7 @@ void ConnectionsLog_BandwidthUpgradeAttempt::InternalSwap(ConnectionsLog_Bandwid
   auto* rhs_arena = other->GetArenaForAllocation();
   _internal_metadata_.InternalSwap(&other->_internal_metadata_);
   swap(_has_bits_[0], other->_has_bits_[0]);
+  medium_scores_.InternalSwap(&other->medium_scores_);
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
       &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
       &connection_token_, lhs_arena,
@@ -6093,6 +6598,323 @@ std::string ConnectionsLog_BandwidthUpgradeAttempt::GetTypeName() const {
 }
 
 
+// ===================================================================
+
+class ConnectionsLog_UpgradeMediumScore::_Internal {
+ public:
+  using HasBits = decltype(std::declval<ConnectionsLog_UpgradeMediumScore>()._has_bits_);
+  static void set_has_medium(HasBits* has_bits) {
+    (*has_bits)[0] |= 4u;
+  }
+  static void set_has_estimated_bytes_per_second(HasBits* has_bits) {
+    (*has_bits)[0] |= 2u;
+  }
+  static void set_has_from_history(HasBits* has_bits) {
+    (*has_bits)[0] |= 8u;
+  }
+  static void set_has_adjustment(HasBits* has_bits) {
+    (*has_bits)[0] |= 1u;
+  }
+};
+
+ConnectionsLog_UpgradeMediumScore::ConnectionsLog_UpgradeMediumScore(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                         bool is_message_owned)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(arena, is_message_owned) {
+  SharedCtor();
+  if (!is_message_owned) {
+    RegisterArenaDtor(arena);
+  }
+  // @@protoc_insertion_point(arena_constructor:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+}
+ConnectionsLog_UpgradeMediumScore::ConnectionsLog_UpgradeMediumScore(const ConnectionsLog_UpgradeMediumScore& from)
+  : ::PROTOBUF_NAMESPACE_ID::MessageLite(),
+      _has_bits_(from._has_bits_) {
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+  adjustment_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+  #ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+    adjustment_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  #endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (from._internal_has_adjustment()) {
+    adjustment_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, from._internal_adjustment(), 
+      GetArenaForAllocation());
+  }
+  ::memcpy(&estimated_bytes_per_second_, &from.estimated_bytes_per_second_,
+    static_cast<size_t>(reinterpret_cast<char*>(&from_history_) -
+    reinterpret_cast<char*>(&estimated_bytes_per_second_)) + sizeof(from_history_));
+  // @@protoc_insertion_point(copy_constructor:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+}
+
+inline void ConnectionsLog_UpgradeMediumScore::SharedCtor() {
+adjustment_.UnsafeSetDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  adjustment_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+::memset(reinterpret_cast<char*>(this) + static_cast<size_t>(
+    reinterpret_cast<char*>(&estimated_bytes_per_second_) - reinterpret_cast<char*>(this)),
+    0, static_cast<size_t>(reinterpret_cast<char*>(&from_history_) -
+    reinterpret_cast<char*>(&estimated_bytes_per_second_)) + sizeof(from_history_));
+}
+
+ConnectionsLog_UpgradeMediumScore::~ConnectionsLog_UpgradeMediumScore() {
+  // @@protoc_insertion_point(destructor:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+  if (GetArenaForAllocation() != nullptr) return;
+  SharedDtor();
+  _internal_metadata_.Delete<std::string>();
+}
+
+inline void ConnectionsLog_UpgradeMediumScore::SharedDtor() {
+  GOOGLE_DCHECK(GetArenaForAllocation() == nullptr);
+  adjustment_.DestroyNoArena(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited());
+}
+
+void ConnectionsLog_UpgradeMediumScore::ArenaDtor(void* object) {
+  ConnectionsLog_UpgradeMediumScore* _this = reinterpret_cast< ConnectionsLog_UpgradeMediumScore* >(object);
+  (void)_this;
+}
+void ConnectionsLog_UpgradeMediumScore::RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena*) {
+}
+void ConnectionsLog_UpgradeMediumScore::SetCachedSize(int size) const {
+  _cached_size_.Set(size);
+}
+
+void ConnectionsLog_UpgradeMediumScore::Clear() {
+// @@protoc_insertion_point(message_clear_start:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x00000001u) {
+    adjustment_.ClearNonDefaultToEmpty();
+  }
+  if (cached_has_bits & 0x0000000eu) {
+    ::memset(&estimated_bytes_per_second_, 0, static_cast<size_t>(
+        reinterpret_cast<char*>(&from_history_) -
+        reinterpret_cast<char*>(&estimated_bytes_per_second_)) + sizeof(from_history_));
+  }
+  _has_bits_.Clear();
+  _internal_metadata_.Clear<std::string>();
+}
+
+const char* ConnectionsLog_UpgradeMediumScore::_InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) {
+#define CHK_(x) if (PROTOBUF_PREDICT_FALSE(!(x))) goto failure
+  _Internal::HasBits has_bits{};
+  while (!ctx->Done(&ptr)) {
+    uint32_t tag;
+    ptr = ::PROTOBUF_NAMESPACE_ID::internal::ReadTag(ptr, &tag);
+    switch (tag >> 3) {
+      // optional .location.nearby.proto.connections.Medium medium = 1;
+      case 1:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 8)) {
+          uint64_t val = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+          if (PROTOBUF_PREDICT_TRUE(::location::nearby::proto::connections::Medium_IsValid(val))) {
+            _internal_set_medium(static_cast<::location::nearby::proto::connections::Medium>(val));
+          } else {
+            ::PROTOBUF_NAMESPACE_ID::internal::WriteVarint(1, val, mutable_unknown_fields());
+          }
+        } else
+          goto handle_unusual;
+        continue;
+      // optional int64 estimated_bytes_per_second = 2;
+      case 2:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 16)) {
+          _Internal::set_has_estimated_bytes_per_second(&has_bits);
+          estimated_bytes_per_second_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional bool from_history = 3;
+      case 3:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 24)) {
+          _Internal::set_has_from_history(&has_bits);
+          from_history_ = ::PROTOBUF_NAMESPACE_ID::internal::ReadVarint64(&ptr);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      // optional string adjustment = 4;
+      case 4:
+        if (PROTOBUF_PREDICT_TRUE(static_cast<uint8_t>(tag) == 34)) {
+          auto str = _internal_mutable_adjustment();
+          ptr = ::PROTOBUF_NAMESPACE_ID::internal::InlineGreedyStringParser(str, ptr, ctx);
+          CHK_(ptr);
+        } else
+          goto handle_unusual;
+        continue;
+      default:
+        goto handle_unusual;
+    }  // switch
+  handle_unusual:
+    if ((tag == 0) || ((tag & 7) == 4)) {
+      CHK_(ptr);
+      ctx->SetLastTag(tag);
+      goto message_done;
+    }
+    ptr = UnknownFieldParse(
+        tag,
+        _internal_metadata_.mutable_unknown_fields<std::string>(),
+        ptr, ctx);
+    CHK_(ptr != nullptr);
+  }  // while
+message_done:
+  _has_bits_.Or(has_bits);
+  return ptr;
+failure:
+  ptr = nullptr;
+  goto message_done;
+#undef CHK_
+}
+
+uint8_t* ConnectionsLog_UpgradeMediumScore::_InternalSerialize(
+    uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const {
+  // @@protoc_insertion_point(serialize_to_array_start:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  // optional .location.nearby.proto.connections.Medium medium = 1;
+  if (cached_has_bits & 0x00000004u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteEnumToArray(
+      1, this->_internal_medium(), target);
+  }
+
+  // optional int64 estimated_bytes_per_second = 2;
+  if (cached_has_bits & 0x00000002u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteInt64ToArray(2, this->_internal_estimated_bytes_per_second(), target);
+  }
+
+  // optional bool from_history = 3;
+  if (cached_has_bits & 0x00000008u) {
+    target = stream->EnsureSpace(target);
+    target = ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::WriteBoolToArray(3, this->_internal_from_history(), target);
+  }
+
+  // optional string adjustment = 4;
+  if (cached_has_bits & 0x00000001u) {
+    target = stream->WriteStringMaybeAliased(
+        4, this->_internal_adjustment(), target);
+  }
+
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    target = stream->WriteRaw(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).data(),
+        static_cast<int>(_internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size()), target);
+  }
+  // @@protoc_insertion_point(serialize_to_array_end:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+  return target;
+}
+
+size_t ConnectionsLog_UpgradeMediumScore::ByteSizeLong() const {
+// @@protoc_insertion_point(message_byte_size_start:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+  size_t total_size = 0;
+
+  uint32_t cached_has_bits = 0;
+  // Prevent compiler warnings about cached_has_bits being unused
+  (void) cached_has_bits;
+
+  cached_has_bits = _has_bits_[0];
+  if (cached_has_bits & 0x0000000fu) {
+    // optional string adjustment = 4;
+    if (cached_has_bits & 0x00000001u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::StringSize(
+          this->_internal_adjustment());
+    }
+
+    // optional int64 estimated_bytes_per_second = 2;
+    if (cached_has_bits & 0x00000002u) {
+      total_size += ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::Int64SizePlusOne(this->_internal_estimated_bytes_per_second());
+    }
+
+    // optional .location.nearby.proto.connections.Medium medium = 1;
+    if (cached_has_bits & 0x00000004u) {
+      total_size += 1 +
+        ::PROTOBUF_NAMESPACE_ID::internal::WireFormatLite::EnumSize(this->_internal_medium());
+    }
+
+    // optional bool from_history = 3;
+    if (cached_has_bits & 0x00000008u) {
+      total_size += 1 + 1;
+    }
+
+  }
+  if (PROTOBUF_PREDICT_FALSE(_internal_metadata_.have_unknown_fields())) {
+    total_size += _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString).size();
+  }
+  int cached_size = ::PROTOBUF_NAMESPACE_ID::internal::ToCachedSize(total_size);
+  SetCachedSize(cached_size);
+  return total_size;
+}
+
+void ConnectionsLog_UpgradeMediumScore::CheckTypeAndMergeFrom(
+    const ::PROTOBUF_NAMESPACE_ID::MessageLite& from) {
+  MergeFrom(*::PROTOBUF_NAMESPACE_ID::internal::DownCast<const ConnectionsLog_UpgradeMediumScore*>(
+      &from));
+}
+
+void ConnectionsLog_UpgradeMediumScore::MergeFrom(const ConnectionsLog_UpgradeMediumScore& from) {
+// @@protoc_insertion_point(class_specific_merge_from_start:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+  GOOGLE_DCHECK_NE(&from, this);
+  uint32_t cached_has_bits = 0;
+  (void) cached_has_bits;
+
+  cached_has_bits = from._has_bits_[0];
+  if (cached_has_bits & 0x0000000fu) {
+    if (cached_has_bits & 0x00000001u) {
+      _internal_set_adjustment(from._internal_adjustment());
+    }
+    if (cached_has_bits & 0x00000002u) {
+      estimated_bytes_per_second_ = from.estimated_bytes_per_second_;
+    }
+    if (cached_has_bits & 0x00000004u) {
+      medium_ = from.medium_;
+    }
+    if (cached_has_bits & 0x00000008u) {
+      from_history_ = from.from_history_;
+    }
+    _has_bits_[0] |= cached_has_bits;
+  }
+  _internal_metadata_.MergeFrom<std::string>(from._internal_metadata_);
+}
+
+void ConnectionsLog_UpgradeMediumScore::CopyFrom(const ConnectionsLog_UpgradeMediumScore& from) {
+// @@protoc_insertion_point(class_specific_copy_from_start:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+  if (&from == this) return;
+  Clear();
+  MergeFrom(from);
+}
+
+bool ConnectionsLog_UpgradeMediumScore::IsInitialized() const {
+  return true;
+}
+
+void ConnectionsLog_UpgradeMediumScore::InternalSwap(ConnectionsLog_UpgradeMediumScore* other) {
+  using std::swap;
+  auto* lhs_arena = GetArenaForAllocation();
+  auto* rhs_arena = other->GetArenaForAllocation();
+  _internal_metadata_.InternalSwap(&other->_internal_metadata_);
+  swap(_has_bits_[0], other->_has_bits_[0]);
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::InternalSwap(
+      &::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(),
+      &adjustment_, lhs_arena,
+      &other->adjustment_, rhs_arena
+  );
+  ::PROTOBUF_NAMESPACE_ID::internal::memswap<
+      PROTOBUF_FIELD_OFFSET(ConnectionsLog_UpgradeMediumScore, from_history_)
+      + sizeof(ConnectionsLog_UpgradeMediumScore::from_history_)
+      - PROTOBUF_FIELD_OFFSET(ConnectionsLog_UpgradeMediumScore, estimated_bytes_per_second_)>(
+          reinterpret_cast<char*>(&estimated_bytes_per_second_),
+          reinterpret_cast<char*>(&other->estimated_bytes_per_second_));
+}
+
+std::string ConnectionsLog_UpgradeMediumScore::GetTypeName() const {
+  return "location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore";
+}
+
+
 // ===================================================================
 
 class ConnectionsLog_ErrorCode::_Internal {
@@ -8905,12 +9727,18 @@ template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLo
 template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection >(arena);
 }
+template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies >(arena);
+}
 template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_Payload* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_Payload >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_Payload >(arena);
 }
 template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_BandwidthUpgradeAttempt* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_BandwidthUpgradeAttempt >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_BandwidthUpgradeAttempt >(arena);
 }
+template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore >(Arena* arena) {
+  return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore >(arena);
+}
 template<> PROTOBUF_NOINLINE ::location::nearby::analytics::proto::ConnectionsLog_ErrorCode* Arena::CreateMaybeMessage< ::location::nearby::analytics::proto::ConnectionsLog_ErrorCode >(Arena* arena) {
   return Arena::CreateMessageInternal< ::location::nearby::analytics::proto::ConnectionsLog_ErrorCode >(arena);
 }
@@ -47,7 +47,7 @@ struct TableStruct_internal_2fproto_2fanalytics_2fconnections_5flog_2eproto {
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::AuxiliaryParseTableField aux[]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
-  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[19]
+  static const ::PROTOBUF_NAMESPACE_ID::internal::ParseTable schema[21]
     PROTOBUF_SECTION_VARIABLE(protodesc_cold);
   static const ::PROTOBUF_NAMESPACE_ID::internal::FieldMetadata field_metadata[];
   static const ::PROTOBUF_NAMESPACE_ID::internal::SerializationTable serialization_table[];
@@ -78,6 +78,9 @@ extern ConnectionsLog_ConnectionAttemptDefaultTypeInternal _ConnectionsLog_Conne
 class ConnectionsLog_ConnectionAttemptMetadata;
 struct ConnectionsLog_ConnectionAttemptMetadataDefaultTypeInternal;
 extern ConnectionsLog_ConnectionAttemptMetadataDefaultTypeInternal _ConnectionsLog_ConnectionAttemptMetadata_default_instance_;
+class ConnectionsLog_ConnectionPhaseLatencies;
+struct ConnectionsLog_ConnectionPhaseLatenciesDefaultTypeInternal;
+extern ConnectionsLog_ConnectionPhaseLatenciesDefaultTypeInternal _ConnectionsLog_ConnectionPhaseLatencies_default_instance_;
 class ConnectionsLog_ConnectionRequest;
 struct ConnectionsLog_ConnectionRequestDefaultTypeInternal;
 extern ConnectionsLog_ConnectionRequestDefaultTypeInternal _ConnectionsLog_ConnectionRequest_default_instance_;
@@ -111,6 +114,9 @@ extern ConnectionsLog_RawUwbRangingEventDefaultTypeInternal _ConnectionsLog_RawU
 class ConnectionsLog_StrategySession;
 struct ConnectionsLog_StrategySessionDefaultTypeInternal;
 extern ConnectionsLog_StrategySessionDefaultTypeInternal _ConnectionsLog_StrategySession_default_instance_;
+class ConnectionsLog_UpgradeMediumScore;
+struct ConnectionsLog_UpgradeMediumScoreDefaultTypeInternal;
+extern ConnectionsLog_UpgradeMediumScoreDefaultTypeInternal _ConnectionsLog_UpgradeMediumScore_default_instance_;
 class ConnectionsLog_UwbRangingProcess;
 struct ConnectionsLog_UwbRangingProcessDefaultTypeInternal;
 extern ConnectionsLog_UwbRangingProcessDefaultTypeInternal _ConnectionsLog_UwbRangingProcess_default_instance_;
@@ -126,6 +132,7 @@ template<> ::location::nearby::analytics::proto::ConnectionsLog_BandwidthUpgrade
 template<> ::location::nearby::analytics::proto::ConnectionsLog_ClientSession* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_ClientSession>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_ConnectionAttempt* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_ConnectionAttempt>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_ConnectionAttemptMetadata* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_ConnectionAttemptMetadata>(Arena*);
+template<> ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_ConnectionRequest* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_ConnectionRequest>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_DiscoveredEndpoint* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_DiscoveredEndpoint>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_DiscoveryMetadata* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_DiscoveryMetadata>(Arena*);
@@ -137,6 +144,7 @@ template<> ::location::nearby::analytics::proto::ConnectionsLog_OperationResultW
 template<> ::location::nearby::analytics::proto::ConnectionsLog_Payload* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_Payload>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_RawUwbRangingEvent* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_RawUwbRangingEvent>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_StrategySession* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_StrategySession>(Arena*);
+template<> ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore>(Arena*);
 template<> ::location::nearby::analytics::proto::ConnectionsLog_UwbRangingProcess* Arena::CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_UwbRangingProcess>(Arena*);
 PROTOBUF_NAMESPACE_CLOSE
 namespace location {
@@ -637,6 +645,7 @@ class ConnectionsLog_OperationResultWithMedium final :
     kUpdateIndexFieldNumber = 2,
     kResultCategoryFieldNumber = 3,
     kResultCodeFieldNumber = 4,
+    kLatencyMillisFieldNumber = 6,
     kConnectionModeFieldNumber = 5,
   };
   // optional .location.nearby.proto.connections.Medium medium = 1;
@@ -691,6 +700,19 @@ class ConnectionsLog_OperationResultWithMedium final :
   void _internal_set_result_code(::location::nearby::proto::connections::OperationResultCode value);
   public:
 
+  // optional int64 latency_millis = 6;
+  bool has_latency_millis() const;
+  private:
+  bool _internal_has_latency_millis() const;
+  public:
+  void clear_latency_millis();
+  int64_t latency_millis() const;
+  void set_latency_millis(int64_t value);
+  private:
+  int64_t _internal_latency_millis() const;
+  void _internal_set_latency_millis(int64_t value);
+  public:
+
   // optional .location.nearby.proto.connections.ConnectionMode connection_mode = 5;
   bool has_connection_mode() const;
   private:
@@ -717,6 +739,7 @@ class ConnectionsLog_OperationResultWithMedium final :
   int32_t update_index_;
   int result_category_;
   int result_code_;
+  int64_t latency_millis_;
   int connection_mode_;
   friend struct ::TableStruct_internal_2fproto_2fanalytics_2fconnections_5flog_2eproto;
 };
@@ -2055,6 +2078,7 @@ class ConnectionsLog_AdvertisingPhase final :
     kDurationMillisFieldNumber = 1,
     kClientFlowIdFieldNumber = 4,
     kStopReasonFieldNumber = 7,
+    kInstantOnLostRestartsSavedFieldNumber = 8,
   };
   // repeated .location.nearby.proto.connections.Medium medium = 2;
   int medium_size() const;
@@ -2166,6 +2190,19 @@ class ConnectionsLog_AdvertisingPhase final :
   void _internal_set_stop_reason(::location::nearby::proto::connections::StopAdvertisingReason value);
   public:
 
+  // optional int32 instant_on_lost_restarts_saved = 8;
+  bool has_instant_on_lost_restarts_saved() const;
+  private:
+  bool _internal_has_instant_on_lost_restarts_saved() const;
+  public:
+  void clear_instant_on_lost_restarts_saved();
+  int32_t instant_on_lost_restarts_saved() const;
+  void set_instant_on_lost_restarts_saved(int32_t value);
+  private:
+  int32_t _internal_instant_on_lost_restarts_saved() const;
+  void _internal_set_instant_on_lost_restarts_saved(int32_t value);
+  public:
+
   // @@protoc_insertion_point(class_scope:location.nearby.analytics.proto.ConnectionsLog.AdvertisingPhase)
  private:
   class _Internal;
@@ -2182,6 +2219,7 @@ class ConnectionsLog_AdvertisingPhase final :
   int64_t duration_millis_;
   int64_t client_flow_id_;
   int stop_reason_;
+  int32_t instant_on_lost_restarts_saved_;
   friend struct ::TableStruct_internal_2fproto_2fanalytics_2fconnections_5flog_2eproto;
 };
 // -------------------------------------------------------------------
@@ -2825,6 +2863,7 @@ class ConnectionsLog_EstablishedConnection final :
     kReceivedPayloadFieldNumber = 4,
     kConnectionTokenFieldNumber = 7,
     kOperationResultFieldNumber = 10,
+    kPhaseLatenciesFieldNumber = 11,
     kDurationMillisFieldNumber = 1,
     kMediumFieldNumber = 2,
     kDisconnectionReasonFieldNumber = 5,
@@ -2904,6 +2943,24 @@ class ConnectionsLog_EstablishedConnection final :
       ::location::nearby::analytics::proto::ConnectionsLog_OperationResult* operation_result);
   ::location::nearby::analytics::proto::ConnectionsLog_OperationResult* unsafe_arena_release_operation_result();
 
+  // optional .location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies phase_latencies = 11;
+  bool has_phase_latencies() const;
+  private:
+  bool _internal_has_phase_latencies() const;
+  public:
+  void clear_phase_latencies();
+  const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies& phase_latencies() const;
+  PROTOBUF_NODISCARD ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* release_phase_latencies();
+  ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* mutable_phase_latencies();
+  void set_allocated_phase_latencies(::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* phase_latencies);
+  private:
+  const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies& _internal_phase_latencies() const;
+  ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* _internal_mutable_phase_latencies();
+  public:
+  void unsafe_arena_set_allocated_phase_latencies(
+      ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* phase_latencies);
+  ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* unsafe_arena_release_phase_latencies();
+
   // optional int64 duration_millis = 1;
   bool has_duration_millis() const;
   private:
@@ -2995,6 +3052,7 @@ class ConnectionsLog_EstablishedConnection final :
   ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_Payload > received_payload_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr connection_token_;
   ::location::nearby::analytics::proto::ConnectionsLog_OperationResult* operation_result_;
+  ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* phase_latencies_;
   int64_t duration_millis_;
   int medium_;
   int disconnection_reason_;
@@ -3005,6 +3063,223 @@ class ConnectionsLog_EstablishedConnection final :
 };
 // -------------------------------------------------------------------
 
+class ConnectionsLog_ConnectionPhaseLatencies final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies) */ {
+ public:
+  inline ConnectionsLog_ConnectionPhaseLatencies() : ConnectionsLog_ConnectionPhaseLatencies(nullptr) {}
+  ~ConnectionsLog_ConnectionPhaseLatencies() override;
+  explicit constexpr ConnectionsLog_ConnectionPhaseLatencies(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ConnectionsLog_ConnectionPhaseLatencies(const ConnectionsLog_ConnectionPhaseLatencies& from);
+  ConnectionsLog_ConnectionPhaseLatencies(ConnectionsLog_ConnectionPhaseLatencies&& from) noexcept
+    : ConnectionsLog_ConnectionPhaseLatencies() {
+    *this = ::std::move(from);
+  }
+
+  inline ConnectionsLog_ConnectionPhaseLatencies& operator=(const ConnectionsLog_ConnectionPhaseLatencies& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ConnectionsLog_ConnectionPhaseLatencies& operator=(ConnectionsLog_ConnectionPhaseLatencies&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString);
+  }
+  inline std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<std::string>();
+  }
+
+  static const ConnectionsLog_ConnectionPhaseLatencies& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ConnectionsLog_ConnectionPhaseLatencies* internal_default_instance() {
+    return reinterpret_cast<const ConnectionsLog_ConnectionPhaseLatencies*>(
+               &_ConnectionsLog_ConnectionPhaseLatencies_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    12;
+
+  friend void swap(ConnectionsLog_ConnectionPhaseLatencies& a, ConnectionsLog_ConnectionPhaseLatencies& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ConnectionsLog_ConnectionPhaseLatencies* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ConnectionsLog_ConnectionPhaseLatencies* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ConnectionsLog_ConnectionPhaseLatencies* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ConnectionsLog_ConnectionPhaseLatencies>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const ConnectionsLog_ConnectionPhaseLatencies& from);
+  void MergeFrom(const ConnectionsLog_ConnectionPhaseLatencies& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(ConnectionsLog_ConnectionPhaseLatencies* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies";
+  }
+  protected:
+  explicit ConnectionsLog_ConnectionPhaseLatencies(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kMediumConnectMillisFieldNumber = 1,
+    kConnectionRequestMillisFieldNumber = 2,
+    kEncryptionMillisFieldNumber = 3,
+    kLocalAcceptMillisFieldNumber = 4,
+    kRemoteAcceptMillisFieldNumber = 5,
+    kTotalMillisFieldNumber = 6,
+  };
+  // optional int64 medium_connect_millis = 1;
+  bool has_medium_connect_millis() const;
+  private:
+  bool _internal_has_medium_connect_millis() const;
+  public:
+  void clear_medium_connect_millis();
+  int64_t medium_connect_millis() const;
+  void set_medium_connect_millis(int64_t value);
+  private:
+  int64_t _internal_medium_connect_millis() const;
+  void _internal_set_medium_connect_millis(int64_t value);
+  public:
+
+  // optional int64 connection_request_millis = 2;
+  bool has_connection_request_millis() const;
+  private:
+  bool _internal_has_connection_request_millis() const;
+  public:
+  void clear_connection_request_millis();
+  int64_t connection_request_millis() const;
+  void set_connection_request_millis(int64_t value);
+  private:
+  int64_t _internal_connection_request_millis() const;
+  void _internal_set_connection_request_millis(int64_t value);
+  public:
+
+  // optional int64 encryption_millis = 3;
+  bool has_encryption_millis() const;
+  private:
+  bool _internal_has_encryption_millis() const;
+  public:
+  void clear_encryption_millis();
+  int64_t encryption_millis() const;
+  void set_encryption_millis(int64_t value);
+  private:
+  int64_t _internal_encryption_millis() const;
+  void _internal_set_encryption_millis(int64_t value);
+  public:
+
+  // optional int64 local_accept_millis = 4;
+  bool has_local_accept_millis() const;
+  private:
+  bool _internal_has_local_accept_millis() const;
+  public:
+  void clear_local_accept_millis();
+  int64_t local_accept_millis() const;
+  void set_local_accept_millis(int64_t value);
+  private:
+  int64_t _internal_local_accept_millis() const;
+  void _internal_set_local_accept_millis(int64_t value);
+  public:
+
+  // optional int64 remote_accept_millis = 5;
+  bool has_remote_accept_millis() const;
+  private:
+  bool _internal_has_remote_accept_millis() const;
+  public:
+  void clear_remote_accept_millis();
+  int64_t remote_accept_millis() const;
+  void set_remote_accept_millis(int64_t value);
+  private:
+  int64_t _internal_remote_accept_millis() const;
+  void _internal_set_remote_accept_millis(int64_t value);
+  public:
+
+  // optional int64 total_millis = 6;
+  bool has_total_millis() const;
+  private:
+  bool _internal_has_total_millis() const;
+  public:
+  void clear_total_millis();
+  int64_t total_millis() const;
+  void set_total_millis(int64_t value);
+  private:
+  int64_t _internal_total_millis() const;
+  void _internal_set_total_millis(int64_t value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  int64_t medium_connect_millis_;
+  int64_t connection_request_millis_;
+  int64_t encryption_millis_;
+  int64_t local_accept_millis_;
+  int64_t remote_accept_millis_;
+  int64_t total_millis_;
+  friend struct ::TableStruct_internal_2fproto_2fanalytics_2fconnections_5flog_2eproto;
+};
+// -------------------------------------------------------------------
+
 class ConnectionsLog_Payload final :
     public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.analytics.proto.ConnectionsLog.Payload) */ {
  public:
@@ -3051,7 +3326,7 @@ class ConnectionsLog_Payload final :
                &_ConnectionsLog_Payload_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    12;
+    13;
 
   friend void swap(ConnectionsLog_Payload& a, ConnectionsLog_Payload& b) {
     a.Swap(&b);
@@ -3318,7 +3593,7 @@ class ConnectionsLog_BandwidthUpgradeAttempt final :
                &_ConnectionsLog_BandwidthUpgradeAttempt_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    13;
+    14;
 
   friend void swap(ConnectionsLog_BandwidthUpgradeAttempt& a, ConnectionsLog_BandwidthUpgradeAttempt& b) {
     a.Swap(&b);
@@ -3385,6 +3660,7 @@ class ConnectionsLog_BandwidthUpgradeAttempt final :
   // accessors -------------------------------------------------------
 
   enum : int {
+    kMediumScoresFieldNumber = 10,
     kConnectionTokenFieldNumber = 8,
     kOperationResultFieldNumber = 9,
     kDurationMillisFieldNumber = 2,
@@ -3395,6 +3671,24 @@ class ConnectionsLog_BandwidthUpgradeAttempt final :
     kClientFlowIdFieldNumber = 7,
     kErrorStageFieldNumber = 6,
   };
+  // repeated .location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore medium_scores = 10;
+  int medium_scores_size() const;
+  private:
+  int _internal_medium_scores_size() const;
+  public:
+  void clear_medium_scores();
+  ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* mutable_medium_scores(int index);
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore >*
+      mutable_medium_scores();
+  private:
+  const ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore& _internal_medium_scores(int index) const;
+  ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* _internal_add_medium_scores();
+  public:
+  const ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore& medium_scores(int index) const;
+  ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* add_medium_scores();
+  const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore >&
+      medium_scores() const;
+
   // optional string connection_token = 8;
   bool has_connection_token() const;
   private:
@@ -3531,6 +3825,7 @@ class ConnectionsLog_BandwidthUpgradeAttempt final :
   typedef void DestructorSkippable_;
   ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
   mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore > medium_scores_;
   ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr connection_token_;
   ::location::nearby::analytics::proto::ConnectionsLog_OperationResult* operation_result_;
   int64_t duration_millis_;
@@ -3544,6 +3839,198 @@ class ConnectionsLog_BandwidthUpgradeAttempt final :
 };
 // -------------------------------------------------------------------
 
+class ConnectionsLog_UpgradeMediumScore final :
+    public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore) */ {
+ public:
+  inline ConnectionsLog_UpgradeMediumScore() : ConnectionsLog_UpgradeMediumScore(nullptr) {}
+  ~ConnectionsLog_UpgradeMediumScore() override;
+  explicit constexpr ConnectionsLog_UpgradeMediumScore(::PROTOBUF_NAMESPACE_ID::internal::ConstantInitialized);
+
+  ConnectionsLog_UpgradeMediumScore(const ConnectionsLog_UpgradeMediumScore& from);
+  ConnectionsLog_UpgradeMediumScore(ConnectionsLog_UpgradeMediumScore&& from) noexcept
+    : ConnectionsLog_UpgradeMediumScore() {
+    *this = ::std::move(from);
+  }
+
+  inline ConnectionsLog_UpgradeMediumScore& operator=(const ConnectionsLog_UpgradeMediumScore& from) {
+    CopyFrom(from);
+    return *this;
+  }
+  inline ConnectionsLog_UpgradeMediumScore& operator=(ConnectionsLog_UpgradeMediumScore&& from) noexcept {
+    if (this == &from) return *this;
+    if (GetOwningArena() == from.GetOwningArena()
+  #ifdef PROTOBUF_FORCE_COPY_IN_MOVE
+        && GetOwningArena() != nullptr
+  #endif  // !PROTOBUF_FORCE_COPY_IN_MOVE
+    ) {
+      InternalSwap(&from);
+    } else {
+      CopyFrom(from);
+    }
+    return *this;
+  }
+
+  inline const std::string& unknown_fields() const {
+    return _internal_metadata_.unknown_fields<std::string>(::PROTOBUF_NAMESPACE_ID::internal::GetEmptyString);
+  }
+  inline std::string* mutable_unknown_fields() {
+    return _internal_metadata_.mutable_unknown_fields<std::string>();
+  }
+
+  static const ConnectionsLog_UpgradeMediumScore& default_instance() {
+    return *internal_default_instance();
+  }
+  static inline const ConnectionsLog_UpgradeMediumScore* internal_default_instance() {
+    return reinterpret_cast<const ConnectionsLog_UpgradeMediumScore*>(
+               &_ConnectionsLog_UpgradeMediumScore_default_instance_);
+  }
+  static constexpr int kIndexInFileMessages =
+    15;
+
+  friend void swap(ConnectionsLog_UpgradeMediumScore& a, ConnectionsLog_UpgradeMediumScore& b) {
+    a.Swap(&b);
+  }
+  inline void Swap(ConnectionsLog_UpgradeMediumScore* other) {
+    if (other == this) return;
+  #ifdef PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() != nullptr &&
+        GetOwningArena() == other->GetOwningArena()) {
+   #else  // PROTOBUF_FORCE_COPY_IN_SWAP
+    if (GetOwningArena() == other->GetOwningArena()) {
+  #endif  // !PROTOBUF_FORCE_COPY_IN_SWAP
+      InternalSwap(other);
+    } else {
+      ::PROTOBUF_NAMESPACE_ID::internal::GenericSwap(this, other);
+    }
+  }
+  void UnsafeArenaSwap(ConnectionsLog_UpgradeMediumScore* other) {
+    if (other == this) return;
+    GOOGLE_DCHECK(GetOwningArena() == other->GetOwningArena());
+    InternalSwap(other);
+  }
+
+  // implements Message ----------------------------------------------
+
+  ConnectionsLog_UpgradeMediumScore* New(::PROTOBUF_NAMESPACE_ID::Arena* arena = nullptr) const final {
+    return CreateMaybeMessage<ConnectionsLog_UpgradeMediumScore>(arena);
+  }
+  void CheckTypeAndMergeFrom(const ::PROTOBUF_NAMESPACE_ID::MessageLite& from)  final;
+  void CopyFrom(const ConnectionsLog_UpgradeMediumScore& from);
+  void MergeFrom(const ConnectionsLog_UpgradeMediumScore& from);
+  PROTOBUF_ATTRIBUTE_REINITIALIZES void Clear() final;
+  bool IsInitialized() const final;
+
+  size_t ByteSizeLong() const final;
+  const char* _InternalParse(const char* ptr, ::PROTOBUF_NAMESPACE_ID::internal::ParseContext* ctx) final;
+  uint8_t* _InternalSerialize(
+      uint8_t* target, ::PROTOBUF_NAMESPACE_ID::io::EpsCopyOutputStream* stream) const final;
+  int GetCachedSize() const final { return _cached_size_.Get(); }
+
+  private:
+  void SharedCtor();
+  void SharedDtor();
+  void SetCachedSize(int size) const;
+  void InternalSwap(ConnectionsLog_UpgradeMediumScore* other);
+
+  private:
+  friend class ::PROTOBUF_NAMESPACE_ID::internal::AnyMetadata;
+  static ::PROTOBUF_NAMESPACE_ID::StringPiece FullMessageName() {
+    return "location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore";
+  }
+  protected:
+  explicit ConnectionsLog_UpgradeMediumScore(::PROTOBUF_NAMESPACE_ID::Arena* arena,
+                       bool is_message_owned = false);
+  private:
+  static void ArenaDtor(void* object);
+  inline void RegisterArenaDtor(::PROTOBUF_NAMESPACE_ID::Arena* arena);
+  public:
+
+  std::string GetTypeName() const final;
+
+  // nested types ----------------------------------------------------
+
+  // accessors -------------------------------------------------------
+
+  enum : int {
+    kAdjustmentFieldNumber = 4,
+    kEstimatedBytesPerSecondFieldNumber = 2,
+    kMediumFieldNumber = 1,
+    kFromHistoryFieldNumber = 3,
+  };
+  // optional string adjustment = 4;
+  bool has_adjustment() const;
+  private:
+  bool _internal_has_adjustment() const;
+  public:
+  void clear_adjustment();
+  const std::string& adjustment() const;
+  template <typename ArgT0 = const std::string&, typename... ArgT>
+  void set_adjustment(ArgT0&& arg0, ArgT... args);
+  std::string* mutable_adjustment();
+  PROTOBUF_NODISCARD std::string* release_adjustment();
+  void set_allocated_adjustment(std::string* adjustment);
+  private:
+  const std::string& _internal_adjustment() const;
+  inline PROTOBUF_ALWAYS_INLINE void _internal_set_adjustment(const std::string& value);
+  std::string* _internal_mutable_adjustment();
+  public:
+
+  // optional int64 estimated_bytes_per_second = 2;
+  bool has_estimated_bytes_per_second() const;
+  private:
+  bool _internal_has_estimated_bytes_per_second() const;
+  public:
+  void clear_estimated_bytes_per_second();
+  int64_t estimated_bytes_per_second() const;
+  void set_estimated_bytes_per_second(int64_t value);
+  private:
+  int64_t _internal_estimated_bytes_per_second() const;
+  void _internal_set_estimated_bytes_per_second(int64_t value);
+  public:
+
+  // optional .location.nearby.proto.connections.Medium medium = 1;
+  bool has_medium() const;
+  private:
+  bool _internal_has_medium() const;
+  public:
+  void clear_medium();
+  ::location::nearby::proto::connections::Medium medium() const;
+  void set_medium(::location::nearby::proto::connections::Medium value);
+  private:
+  ::location::nearby::proto::connections::Medium _internal_medium() const;
+  void _internal_set_medium(::location::nearby::proto::connections::Medium value);
+  public:
+
+  // optional bool from_history = 3;
+  bool has_from_history() const;
+  private:
+  bool _internal_has_from_history() const;
+  public:
+  void clear_from_history();
+  bool from_history() const;
+  void set_from_history(bool value);
+  private:
+  bool _internal_from_history() const;
+  void _internal_set_from_history(bool value);
+  public:
+
+  // @@protoc_insertion_point(class_scope:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore)
+ private:
+  class _Internal;
+
+  template <typename T> friend class ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper;
+  typedef void InternalArenaConstructable_;
+  typedef void DestructorSkippable_;
+  ::PROTOBUF_NAMESPACE_ID::internal::HasBits<1> _has_bits_;
+  mutable ::PROTOBUF_NAMESPACE_ID::internal::CachedSize _cached_size_;
+  ::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr adjustment_;
+  int64_t estimated_bytes_per_second_;
+  int medium_;
+  bool from_history_;
+  friend struct ::TableStruct_internal_2fproto_2fanalytics_2fconnections_5flog_2eproto;
+};
+// -------------------------------------------------------------------
+
 class ConnectionsLog_ErrorCode final :
     public ::PROTOBUF_NAMESPACE_ID::MessageLite /* @@protoc_insertion_point(class_definition:location.nearby.analytics.proto.ConnectionsLog.ErrorCode) */ {
  public:
@@ -3608,7 +4095,7 @@ class ConnectionsLog_ErrorCode final :
                &_ConnectionsLog_ErrorCode_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    14;
+    16;
 
   friend void swap(ConnectionsLog_ErrorCode& a, ConnectionsLog_ErrorCode& b) {
     a.Swap(&b);
@@ -4085,7 +4572,7 @@ class ConnectionsLog_AdvertisingMetadata final :
                &_ConnectionsLog_AdvertisingMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    15;
+    17;
 
   friend void swap(ConnectionsLog_AdvertisingMetadata& a, ConnectionsLog_AdvertisingMetadata& b) {
     a.Swap(&b);
@@ -4332,7 +4819,7 @@ class ConnectionsLog_DiscoveryMetadata final :
                &_ConnectionsLog_DiscoveryMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    16;
+    18;
 
   friend void swap(ConnectionsLog_DiscoveryMetadata& a, ConnectionsLog_DiscoveryMetadata& b) {
     a.Swap(&b);
@@ -4519,7 +5006,7 @@ class ConnectionsLog_ConnectionAttemptMetadata final :
                &_ConnectionsLog_ConnectionAttemptMetadata_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    17;
+    19;
 
   friend void swap(ConnectionsLog_ConnectionAttemptMetadata& a, ConnectionsLog_ConnectionAttemptMetadata& b) {
     a.Swap(&b);
@@ -4881,7 +5368,7 @@ class ConnectionsLog final :
                &_ConnectionsLog_default_instance_);
   }
   static constexpr int kIndexInFileMessages =
-    18;
+    20;
 
   friend void swap(ConnectionsLog& a, ConnectionsLog& b) {
     a.Swap(&b);
@@ -4957,8 +5444,10 @@ class ConnectionsLog final :
   typedef ConnectionsLog_ConnectionRequest ConnectionRequest;
   typedef ConnectionsLog_ConnectionAttempt ConnectionAttempt;
   typedef ConnectionsLog_EstablishedConnection EstablishedConnection;
+  typedef ConnectionsLog_ConnectionPhaseLatencies ConnectionPhaseLatencies;
   typedef ConnectionsLog_Payload Payload;
   typedef ConnectionsLog_BandwidthUpgradeAttempt BandwidthUpgradeAttempt;
+  typedef ConnectionsLog_UpgradeMediumScore UpgradeMediumScore;
   typedef ConnectionsLog_ErrorCode ErrorCode;
   typedef ConnectionsLog_AdvertisingMetadata AdvertisingMetadata;
   typedef ConnectionsLog_DiscoveryMetadata DiscoveryMetadata;
@@ -5448,7 +5937,7 @@ inline void ConnectionsLog_OperationResultWithMedium::set_result_code(::location
 
 // optional .location.nearby.proto.connections.ConnectionMode connection_mode = 5;
 inline bool ConnectionsLog_OperationResultWithMedium::_internal_has_connection_mode() const {
-  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  bool value = (_has_bits_[0] & 0x00000020u) != 0;
   return value;
 }
 inline bool ConnectionsLog_OperationResultWithMedium::has_connection_mode() const {
@@ -5456,7 +5945,7 @@ inline bool ConnectionsLog_OperationResultWithMedium::has_connection_mode() cons
 }
 inline void ConnectionsLog_OperationResultWithMedium::clear_connection_mode() {
   connection_mode_ = 0;
-  _has_bits_[0] &= ~0x00000010u;
+  _has_bits_[0] &= ~0x00000020u;
 }
 inline ::location::nearby::proto::connections::ConnectionMode ConnectionsLog_OperationResultWithMedium::_internal_connection_mode() const {
   return static_cast< ::location::nearby::proto::connections::ConnectionMode >(connection_mode_);
@@ -5467,7 +5956,7 @@ inline ::location::nearby::proto::connections::ConnectionMode ConnectionsLog_Ope
 }
 inline void ConnectionsLog_OperationResultWithMedium::_internal_set_connection_mode(::location::nearby::proto::connections::ConnectionMode value) {
   assert(::location::nearby::proto::connections::ConnectionMode_IsValid(value));
-  _has_bits_[0] |= 0x00000010u;
+  _has_bits_[0] |= 0x00000020u;
   connection_mode_ = value;
 }
 inline void ConnectionsLog_OperationResultWithMedium::set_connection_mode(::location::nearby::proto::connections::ConnectionMode value) {
@@ -5475,6 +5964,34 @@ inline void ConnectionsLog_OperationResultWithMedium::set_connection_mode(::loca
   // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.OperationResultWithMedium.connection_mode)
 }
 
+// optional int64 latency_millis = 6;
+inline bool ConnectionsLog_OperationResultWithMedium::_internal_has_latency_millis() const {
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_OperationResultWithMedium::has_latency_millis() const {
+  return _internal_has_latency_millis();
+}
+inline void ConnectionsLog_OperationResultWithMedium::clear_latency_millis() {
+  latency_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline int64_t ConnectionsLog_OperationResultWithMedium::_internal_latency_millis() const {
+  return latency_millis_;
+}
+inline int64_t ConnectionsLog_OperationResultWithMedium::latency_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.OperationResultWithMedium.latency_millis)
+  return _internal_latency_millis();
+}
+inline void ConnectionsLog_OperationResultWithMedium::_internal_set_latency_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000010u;
+  latency_millis_ = value;
+}
+inline void ConnectionsLog_OperationResultWithMedium::set_latency_millis(int64_t value) {
+  _internal_set_latency_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.OperationResultWithMedium.latency_millis)
+}
+
 // -------------------------------------------------------------------
 
 // ConnectionsLog_StrategySession
@@ -7011,6 +7528,34 @@ inline void ConnectionsLog_AdvertisingPhase::set_stop_reason(::location::nearby:
   // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.AdvertisingPhase.stop_reason)
 }
 
+// optional int32 instant_on_lost_restarts_saved = 8;
+inline bool ConnectionsLog_AdvertisingPhase::_internal_has_instant_on_lost_restarts_saved() const {
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_AdvertisingPhase::has_instant_on_lost_restarts_saved() const {
+  return _internal_has_instant_on_lost_restarts_saved();
+}
+inline void ConnectionsLog_AdvertisingPhase::clear_instant_on_lost_restarts_saved() {
+  instant_on_lost_restarts_saved_ = 0;
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline int32_t ConnectionsLog_AdvertisingPhase::_internal_instant_on_lost_restarts_saved() const {
+  return instant_on_lost_restarts_saved_;
+}
+inline int32_t ConnectionsLog_AdvertisingPhase::instant_on_lost_restarts_saved() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.AdvertisingPhase.instant_on_lost_restarts_saved)
+  return _internal_instant_on_lost_restarts_saved();
+}
+inline void ConnectionsLog_AdvertisingPhase::_internal_set_instant_on_lost_restarts_saved(int32_t value) {
+  _has_bits_[0] |= 0x00000010u;
+  instant_on_lost_restarts_saved_ = value;
+}
+inline void ConnectionsLog_AdvertisingPhase::set_instant_on_lost_restarts_saved(int32_t value) {
+  _internal_set_instant_on_lost_restarts_saved(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.AdvertisingPhase.instant_on_lost_restarts_saved)
+}
+
 // -------------------------------------------------------------------
 
 // ConnectionsLog_ConnectionRequest
@@ -7617,7 +8162,7 @@ inline void ConnectionsLog_ConnectionAttempt::set_connection_mode(::location::ne
 
 // optional int64 duration_millis = 1;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_duration_millis() const {
-  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_duration_millis() const {
@@ -7625,7 +8170,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_duration_millis() const {
 }
 inline void ConnectionsLog_EstablishedConnection::clear_duration_millis() {
   duration_millis_ = int64_t{0};
-  _has_bits_[0] &= ~0x00000004u;
+  _has_bits_[0] &= ~0x00000008u;
 }
 inline int64_t ConnectionsLog_EstablishedConnection::_internal_duration_millis() const {
   return duration_millis_;
@@ -7635,7 +8180,7 @@ inline int64_t ConnectionsLog_EstablishedConnection::duration_millis() const {
   return _internal_duration_millis();
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_duration_millis(int64_t value) {
-  _has_bits_[0] |= 0x00000004u;
+  _has_bits_[0] |= 0x00000008u;
   duration_millis_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_duration_millis(int64_t value) {
@@ -7645,7 +8190,7 @@ inline void ConnectionsLog_EstablishedConnection::set_duration_millis(int64_t va
 
 // optional .location.nearby.proto.connections.Medium medium = 2;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_medium() const {
-  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_medium() const {
@@ -7653,7 +8198,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_medium() const {
 }
 inline void ConnectionsLog_EstablishedConnection::clear_medium() {
   medium_ = 0;
-  _has_bits_[0] &= ~0x00000008u;
+  _has_bits_[0] &= ~0x00000010u;
 }
 inline ::location::nearby::proto::connections::Medium ConnectionsLog_EstablishedConnection::_internal_medium() const {
   return static_cast< ::location::nearby::proto::connections::Medium >(medium_);
@@ -7664,7 +8209,7 @@ inline ::location::nearby::proto::connections::Medium ConnectionsLog_Established
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_medium(::location::nearby::proto::connections::Medium value) {
   assert(::location::nearby::proto::connections::Medium_IsValid(value));
-  _has_bits_[0] |= 0x00000008u;
+  _has_bits_[0] |= 0x00000010u;
   medium_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_medium(::location::nearby::proto::connections::Medium value) {
@@ -7754,7 +8299,7 @@ ConnectionsLog_EstablishedConnection::received_payload() const {
 
 // optional .location.nearby.proto.connections.DisconnectionReason disconnection_reason = 5;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_disconnection_reason() const {
-  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  bool value = (_has_bits_[0] & 0x00000020u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_disconnection_reason() const {
@@ -7762,7 +8307,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_disconnection_reason() con
 }
 inline void ConnectionsLog_EstablishedConnection::clear_disconnection_reason() {
   disconnection_reason_ = 0;
-  _has_bits_[0] &= ~0x00000010u;
+  _has_bits_[0] &= ~0x00000020u;
 }
 inline ::location::nearby::proto::connections::DisconnectionReason ConnectionsLog_EstablishedConnection::_internal_disconnection_reason() const {
   return static_cast< ::location::nearby::proto::connections::DisconnectionReason >(disconnection_reason_);
@@ -7773,7 +8318,7 @@ inline ::location::nearby::proto::connections::DisconnectionReason ConnectionsLo
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_disconnection_reason(::location::nearby::proto::connections::DisconnectionReason value) {
   assert(::location::nearby::proto::connections::DisconnectionReason_IsValid(value));
-  _has_bits_[0] |= 0x00000010u;
+  _has_bits_[0] |= 0x00000020u;
   disconnection_reason_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_disconnection_reason(::location::nearby::proto::connections::DisconnectionReason value) {
@@ -7783,7 +8328,7 @@ inline void ConnectionsLog_EstablishedConnection::set_disconnection_reason(::loc
 
 // optional int64 client_flow_id = 6;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_client_flow_id() const {
-  bool value = (_has_bits_[0] & 0x00000020u) != 0;
+  bool value = (_has_bits_[0] & 0x00000040u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_client_flow_id() const {
@@ -7791,7 +8336,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_client_flow_id() const {
 }
 inline void ConnectionsLog_EstablishedConnection::clear_client_flow_id() {
   client_flow_id_ = int64_t{0};
-  _has_bits_[0] &= ~0x00000020u;
+  _has_bits_[0] &= ~0x00000040u;
 }
 inline int64_t ConnectionsLog_EstablishedConnection::_internal_client_flow_id() const {
   return client_flow_id_;
@@ -7801,7 +8346,7 @@ inline int64_t ConnectionsLog_EstablishedConnection::client_flow_id() const {
   return _internal_client_flow_id();
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_client_flow_id(int64_t value) {
-  _has_bits_[0] |= 0x00000020u;
+  _has_bits_[0] |= 0x00000040u;
   client_flow_id_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_client_flow_id(int64_t value) {
@@ -7880,7 +8425,7 @@ inline void ConnectionsLog_EstablishedConnection::set_allocated_connection_token
 
 // optional .location.nearby.proto.connections.ConnectionAttemptType type = 8;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_type() const {
-  bool value = (_has_bits_[0] & 0x00000040u) != 0;
+  bool value = (_has_bits_[0] & 0x00000080u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_type() const {
@@ -7888,7 +8433,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_type() const {
 }
 inline void ConnectionsLog_EstablishedConnection::clear_type() {
   type_ = 0;
-  _has_bits_[0] &= ~0x00000040u;
+  _has_bits_[0] &= ~0x00000080u;
 }
 inline ::location::nearby::proto::connections::ConnectionAttemptType ConnectionsLog_EstablishedConnection::_internal_type() const {
   return static_cast< ::location::nearby::proto::connections::ConnectionAttemptType >(type_);
@@ -7899,7 +8444,7 @@ inline ::location::nearby::proto::connections::ConnectionAttemptType Connections
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_type(::location::nearby::proto::connections::ConnectionAttemptType value) {
   assert(::location::nearby::proto::connections::ConnectionAttemptType_IsValid(value));
-  _has_bits_[0] |= 0x00000040u;
+  _has_bits_[0] |= 0x00000080u;
   type_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_type(::location::nearby::proto::connections::ConnectionAttemptType value) {
@@ -7909,7 +8454,7 @@ inline void ConnectionsLog_EstablishedConnection::set_type(::location::nearby::p
 
 // optional .location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.SafeDisconnectionResult safe_disconnection_result = 9;
 inline bool ConnectionsLog_EstablishedConnection::_internal_has_safe_disconnection_result() const {
-  bool value = (_has_bits_[0] & 0x00000080u) != 0;
+  bool value = (_has_bits_[0] & 0x00000100u) != 0;
   return value;
 }
 inline bool ConnectionsLog_EstablishedConnection::has_safe_disconnection_result() const {
@@ -7917,7 +8462,7 @@ inline bool ConnectionsLog_EstablishedConnection::has_safe_disconnection_result(
 }
 inline void ConnectionsLog_EstablishedConnection::clear_safe_disconnection_result() {
   safe_disconnection_result_ = 0;
-  _has_bits_[0] &= ~0x00000080u;
+  _has_bits_[0] &= ~0x00000100u;
 }
 inline ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection_SafeDisconnectionResult ConnectionsLog_EstablishedConnection::_internal_safe_disconnection_result() const {
   return static_cast< ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection_SafeDisconnectionResult >(safe_disconnection_result_);
@@ -7928,7 +8473,7 @@ inline ::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnectio
 }
 inline void ConnectionsLog_EstablishedConnection::_internal_set_safe_disconnection_result(::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection_SafeDisconnectionResult value) {
   assert(::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection_SafeDisconnectionResult_IsValid(value));
-  _has_bits_[0] |= 0x00000080u;
+  _has_bits_[0] |= 0x00000100u;
   safe_disconnection_result_ = value;
 }
 inline void ConnectionsLog_EstablishedConnection::set_safe_disconnection_result(::location::nearby::analytics::proto::ConnectionsLog_EstablishedConnection_SafeDisconnectionResult value) {
@@ -8026,6 +8571,268 @@ inline void ConnectionsLog_EstablishedConnection::set_allocated_operation_result
   // @@protoc_insertion_point(field_set_allocated:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.operation_result)
 }
 
+// optional .location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies phase_latencies = 11;
+inline bool ConnectionsLog_EstablishedConnection::_internal_has_phase_latencies() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  PROTOBUF_ASSUME(!value || phase_latencies_ != nullptr);
+  return value;
+}
+inline bool ConnectionsLog_EstablishedConnection::has_phase_latencies() const {
+  return _internal_has_phase_latencies();
+}
+inline void ConnectionsLog_EstablishedConnection::clear_phase_latencies() {
+  if (phase_latencies_ != nullptr) phase_latencies_->Clear();
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies& ConnectionsLog_EstablishedConnection::_internal_phase_latencies() const {
+  const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* p = phase_latencies_;
+  return p != nullptr ? *p : reinterpret_cast<const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies&>(
+      ::location::nearby::analytics::proto::_ConnectionsLog_ConnectionPhaseLatencies_default_instance_);
+}
+inline const ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies& ConnectionsLog_EstablishedConnection::phase_latencies() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.phase_latencies)
+  return _internal_phase_latencies();
+}
+inline void ConnectionsLog_EstablishedConnection::unsafe_arena_set_allocated_phase_latencies(
+    ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* phase_latencies) {
+  if (GetArenaForAllocation() == nullptr) {
+    delete reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(phase_latencies_);
+  }
+  phase_latencies_ = phase_latencies;
+  if (phase_latencies) {
+    _has_bits_[0] |= 0x00000004u;
+  } else {
+    _has_bits_[0] &= ~0x00000004u;
+  }
+  // @@protoc_insertion_point(field_unsafe_arena_set_allocated:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.phase_latencies)
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* ConnectionsLog_EstablishedConnection::release_phase_latencies() {
+  _has_bits_[0] &= ~0x00000004u;
+  ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* temp = phase_latencies_;
+  phase_latencies_ = nullptr;
+#ifdef PROTOBUF_FORCE_COPY_IN_RELEASE
+  auto* old =  reinterpret_cast<::PROTOBUF_NAMESPACE_ID::MessageLite*>(temp);
+  temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  if (GetArenaForAllocation() == nullptr) { delete old; }
+#else  // PROTOBUF_FORCE_COPY_IN_RELEASE
+  if (GetArenaForAllocation() != nullptr) {
+    temp = ::PROTOBUF_NAMESPACE_ID::internal::DuplicateIfNonNull(temp);
+  }
+#endif  // !PROTOBUF_FORCE_COPY_IN_RELEASE
+  return temp;
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* ConnectionsLog_EstablishedConnection::unsafe_arena_release_phase_latencies() {
+  // @@protoc_insertion_point(field_release:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.phase_latencies)
+  _has_bits_[0] &= ~0x00000004u;
+  ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* temp = phase_latencies_;
+  phase_latencies_ = nullptr;
+  return temp;
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* ConnectionsLog_EstablishedConnection::_internal_mutable_phase_latencies() {
+  _has_bits_[0] |= 0x00000004u;
+  if (phase_latencies_ == nullptr) {
+    auto* p = CreateMaybeMessage<::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies>(GetArenaForAllocation());
+    phase_latencies_ = p;
+  }
+  return phase_latencies_;
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* ConnectionsLog_EstablishedConnection::mutable_phase_latencies() {
+  ::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* _msg = _internal_mutable_phase_latencies();
+  // @@protoc_insertion_point(field_mutable:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.phase_latencies)
+  return _msg;
+}
+inline void ConnectionsLog_EstablishedConnection::set_allocated_phase_latencies(::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies* phase_latencies) {
+  ::PROTOBUF_NAMESPACE_ID::Arena* message_arena = GetArenaForAllocation();
+  if (message_arena == nullptr) {
+    delete phase_latencies_;
+  }
+  if (phase_latencies) {
+    ::PROTOBUF_NAMESPACE_ID::Arena* submessage_arena =
+        ::PROTOBUF_NAMESPACE_ID::Arena::InternalHelper<::location::nearby::analytics::proto::ConnectionsLog_ConnectionPhaseLatencies>::GetOwningArena(phase_latencies);
+    if (message_arena != submessage_arena) {
+      phase_latencies = ::PROTOBUF_NAMESPACE_ID::internal::GetOwnedMessage(
+          message_arena, phase_latencies, submessage_arena);
+    }
+    _has_bits_[0] |= 0x00000004u;
+  } else {
+    _has_bits_[0] &= ~0x00000004u;
+  }
+  phase_latencies_ = phase_latencies;
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.analytics.proto.ConnectionsLog.EstablishedConnection.phase_latencies)
+}
+
+// -------------------------------------------------------------------
+
+// ConnectionsLog_ConnectionPhaseLatencies
+
+// optional int64 medium_connect_millis = 1;
+inline bool ConnectionsLog_ConnectionPhaseLatencies::_internal_has_medium_connect_millis() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_ConnectionPhaseLatencies::has_medium_connect_millis() const {
+  return _internal_has_medium_connect_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::clear_medium_connect_millis() {
+  medium_connect_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::_internal_medium_connect_millis() const {
+  return medium_connect_millis_;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::medium_connect_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.medium_connect_millis)
+  return _internal_medium_connect_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::_internal_set_medium_connect_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000001u;
+  medium_connect_millis_ = value;
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::set_medium_connect_millis(int64_t value) {
+  _internal_set_medium_connect_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.medium_connect_millis)
+}
+
+// optional int64 connection_request_millis = 2;
+inline bool ConnectionsLog_ConnectionPhaseLatencies::_internal_has_connection_request_millis() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_ConnectionPhaseLatencies::has_connection_request_millis() const {
+  return _internal_has_connection_request_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::clear_connection_request_millis() {
+  connection_request_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::_internal_connection_request_millis() const {
+  return connection_request_millis_;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::connection_request_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.connection_request_millis)
+  return _internal_connection_request_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::_internal_set_connection_request_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000002u;
+  connection_request_millis_ = value;
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::set_connection_request_millis(int64_t value) {
+  _internal_set_connection_request_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.connection_request_millis)
+}
+
+// optional int64 encryption_millis = 3;
+inline bool ConnectionsLog_ConnectionPhaseLatencies::_internal_has_encryption_millis() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_ConnectionPhaseLatencies::has_encryption_millis() const {
+  return _internal_has_encryption_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::clear_encryption_millis() {
+  encryption_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::_internal_encryption_millis() const {
+  return encryption_millis_;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::encryption_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.encryption_millis)
+  return _internal_encryption_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::_internal_set_encryption_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000004u;
+  encryption_millis_ = value;
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::set_encryption_millis(int64_t value) {
+  _internal_set_encryption_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.encryption_millis)
+}
+
+// optional int64 local_accept_millis = 4;
+inline bool ConnectionsLog_ConnectionPhaseLatencies::_internal_has_local_accept_millis() const {
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_ConnectionPhaseLatencies::has_local_accept_millis() const {
+  return _internal_has_local_accept_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::clear_local_accept_millis() {
+  local_accept_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::_internal_local_accept_millis() const {
+  return local_accept_millis_;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::local_accept_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.local_accept_millis)
+  return _internal_local_accept_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::_internal_set_local_accept_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000008u;
+  local_accept_millis_ = value;
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::set_local_accept_millis(int64_t value) {
+  _internal_set_local_accept_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.local_accept_millis)
+}
+
+// optional int64 remote_accept_millis = 5;
+inline bool ConnectionsLog_ConnectionPhaseLatencies::_internal_has_remote_accept_millis() const {
+  bool value = (_has_bits_[0] & 0x00000010u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_ConnectionPhaseLatencies::has_remote_accept_millis() const {
+  return _internal_has_remote_accept_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::clear_remote_accept_millis() {
+  remote_accept_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000010u;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::_internal_remote_accept_millis() const {
+  return remote_accept_millis_;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::remote_accept_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.remote_accept_millis)
+  return _internal_remote_accept_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::_internal_set_remote_accept_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000010u;
+  remote_accept_millis_ = value;
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::set_remote_accept_millis(int64_t value) {
+  _internal_set_remote_accept_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.remote_accept_millis)
+}
+
+// optional int64 total_millis = 6;
+inline bool ConnectionsLog_ConnectionPhaseLatencies::_internal_has_total_millis() const {
+  bool value = (_has_bits_[0] & 0x00000020u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_ConnectionPhaseLatencies::has_total_millis() const {
+  return _internal_has_total_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::clear_total_millis() {
+  total_millis_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000020u;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::_internal_total_millis() const {
+  return total_millis_;
+}
+inline int64_t ConnectionsLog_ConnectionPhaseLatencies::total_millis() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.total_millis)
+  return _internal_total_millis();
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::_internal_set_total_millis(int64_t value) {
+  _has_bits_[0] |= 0x00000020u;
+  total_millis_ = value;
+}
+inline void ConnectionsLog_ConnectionPhaseLatencies::set_total_millis(int64_t value) {
+  _internal_set_total_millis(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.ConnectionPhaseLatencies.total_millis)
+}
+
 // -------------------------------------------------------------------
 
 // ConnectionsLog_Payload
@@ -8710,6 +9517,204 @@ inline void ConnectionsLog_BandwidthUpgradeAttempt::set_allocated_operation_resu
   // @@protoc_insertion_point(field_set_allocated:location.nearby.analytics.proto.ConnectionsLog.BandwidthUpgradeAttempt.operation_result)
 }
 
+// repeated .location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore medium_scores = 10;
+inline int ConnectionsLog_BandwidthUpgradeAttempt::_internal_medium_scores_size() const {
+  return medium_scores_.size();
+}
+inline int ConnectionsLog_BandwidthUpgradeAttempt::medium_scores_size() const {
+  return _internal_medium_scores_size();
+}
+inline void ConnectionsLog_BandwidthUpgradeAttempt::clear_medium_scores() {
+  medium_scores_.Clear();
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* ConnectionsLog_BandwidthUpgradeAttempt::mutable_medium_scores(int index) {
+  // @@protoc_insertion_point(field_mutable:location.nearby.analytics.proto.ConnectionsLog.BandwidthUpgradeAttempt.medium_scores)
+  return medium_scores_.Mutable(index);
+}
+inline ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore >*
+ConnectionsLog_BandwidthUpgradeAttempt::mutable_medium_scores() {
+  // @@protoc_insertion_point(field_mutable_list:location.nearby.analytics.proto.ConnectionsLog.BandwidthUpgradeAttempt.medium_scores)
+  return &medium_scores_;
+}
+inline const ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore& ConnectionsLog_BandwidthUpgradeAttempt::_internal_medium_scores(int index) const {
+  return medium_scores_.Get(index);
+}
+inline const ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore& ConnectionsLog_BandwidthUpgradeAttempt::medium_scores(int index) const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.BandwidthUpgradeAttempt.medium_scores)
+  return _internal_medium_scores(index);
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* ConnectionsLog_BandwidthUpgradeAttempt::_internal_add_medium_scores() {
+  return medium_scores_.Add();
+}
+inline ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* ConnectionsLog_BandwidthUpgradeAttempt::add_medium_scores() {
+  ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore* _add = _internal_add_medium_scores();
+  // @@protoc_insertion_point(field_add:location.nearby.analytics.proto.ConnectionsLog.BandwidthUpgradeAttempt.medium_scores)
+  return _add;
+}
+inline const ::PROTOBUF_NAMESPACE_ID::RepeatedPtrField< ::location::nearby::analytics::proto::ConnectionsLog_UpgradeMediumScore >&
+ConnectionsLog_BandwidthUpgradeAttempt::medium_scores() const {
+  // @@protoc_insertion_point(field_list:location.nearby.analytics.proto.ConnectionsLog.BandwidthUpgradeAttempt.medium_scores)
+  return medium_scores_;
+}
+
+// -------------------------------------------------------------------
+
+// ConnectionsLog_UpgradeMediumScore
+
+// optional .location.nearby.proto.connections.Medium medium = 1;
+inline bool ConnectionsLog_UpgradeMediumScore::_internal_has_medium() const {
+  bool value = (_has_bits_[0] & 0x00000004u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_UpgradeMediumScore::has_medium() const {
+  return _internal_has_medium();
+}
+inline void ConnectionsLog_UpgradeMediumScore::clear_medium() {
+  medium_ = 0;
+  _has_bits_[0] &= ~0x00000004u;
+}
+inline ::location::nearby::proto::connections::Medium ConnectionsLog_UpgradeMediumScore::_internal_medium() const {
+  return static_cast< ::location::nearby::proto::connections::Medium >(medium_);
+}
+inline ::location::nearby::proto::connections::Medium ConnectionsLog_UpgradeMediumScore::medium() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.medium)
+  return _internal_medium();
+}
+inline void ConnectionsLog_UpgradeMediumScore::_internal_set_medium(::location::nearby::proto::connections::Medium value) {
+  assert(::location::nearby::proto::connections::Medium_IsValid(value));
+  _has_bits_[0] |= 0x00000004u;
+  medium_ = value;
+}
+inline void ConnectionsLog_UpgradeMediumScore::set_medium(::location::nearby::proto::connections::Medium value) {
+  _internal_set_medium(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.medium)
+}
+
+// optional int64 estimated_bytes_per_second = 2;
+inline bool ConnectionsLog_UpgradeMediumScore::_internal_has_estimated_bytes_per_second() const {
+  bool value = (_has_bits_[0] & 0x00000002u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_UpgradeMediumScore::has_estimated_bytes_per_second() const {
+  return _internal_has_estimated_bytes_per_second();
+}
+inline void ConnectionsLog_UpgradeMediumScore::clear_estimated_bytes_per_second() {
+  estimated_bytes_per_second_ = int64_t{0};
+  _has_bits_[0] &= ~0x00000002u;
+}
+inline int64_t ConnectionsLog_UpgradeMediumScore::_internal_estimated_bytes_per_second() const {
+  return estimated_bytes_per_second_;
+}
+inline int64_t ConnectionsLog_UpgradeMediumScore::estimated_bytes_per_second() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.estimated_bytes_per_second)
+  return _internal_estimated_bytes_per_second();
+}
+inline void ConnectionsLog_UpgradeMediumScore::_internal_set_estimated_bytes_per_second(int64_t value) {
+  _has_bits_[0] |= 0x00000002u;
+  estimated_bytes_per_second_ = value;
+}
+inline void ConnectionsLog_UpgradeMediumScore::set_estimated_bytes_per_second(int64_t value) {
+  _internal_set_estimated_bytes_per_second(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.estimated_bytes_per_second)
+}
+
+// optional bool from_history = 3;
+inline bool ConnectionsLog_UpgradeMediumScore::_internal_has_from_history() const {
+  bool value = (_has_bits_[0] & 0x00000008u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_UpgradeMediumScore::has_from_history() const {
+  return _internal_has_from_history();
+}
+inline void ConnectionsLog_UpgradeMediumScore::clear_from_history() {
+  from_history_ = false;
+  _has_bits_[0] &= ~0x00000008u;
+}
+inline bool ConnectionsLog_UpgradeMediumScore::_internal_from_history() const {
+  return from_history_;
+}
+inline bool ConnectionsLog_UpgradeMediumScore::from_history() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.from_history)
+  return _internal_from_history();
+}
+inline void ConnectionsLog_UpgradeMediumScore::_internal_set_from_history(bool value) {
+  _has_bits_[0] |= 0x00000008u;
+  from_history_ = value;
+}
+inline void ConnectionsLog_UpgradeMediumScore::set_from_history(bool value) {
+  _internal_set_from_history(value);
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.from_history)
+}
+
+// optional string adjustment = 4;
+inline bool ConnectionsLog_UpgradeMediumScore::_internal_has_adjustment() const {
+  bool value = (_has_bits_[0] & 0x00000001u) != 0;
+  return value;
+}
+inline bool ConnectionsLog_UpgradeMediumScore::has_adjustment() const {
+  return _internal_has_adjustment();
+}
+inline void ConnectionsLog_UpgradeMediumScore::clear_adjustment() {
+  adjustment_.ClearToEmpty();
+  _has_bits_[0] &= ~0x00000001u;
+}
+inline const std::string& ConnectionsLog_UpgradeMediumScore::adjustment() const {
+  // @@protoc_insertion_point(field_get:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.adjustment)
+  return _internal_adjustment();
+}
+template <typename ArgT0, typename... ArgT>
+inline PROTOBUF_ALWAYS_INLINE
+void ConnectionsLog_UpgradeMediumScore::set_adjustment(ArgT0&& arg0, ArgT... args) {
+ _has_bits_[0] |= 0x00000001u;
+ adjustment_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, static_cast<ArgT0 &&>(arg0), args..., GetArenaForAllocation());
+  // @@protoc_insertion_point(field_set:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.adjustment)
+}
+inline std::string* ConnectionsLog_UpgradeMediumScore::mutable_adjustment() {
+  std::string* _s = _internal_mutable_adjustment();
+  // @@protoc_insertion_point(field_mutable:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.adjustment)
+  return _s;
+}
+inline const std::string& ConnectionsLog_UpgradeMediumScore::_internal_adjustment() const {
+  return adjustment_.Get();
+}
+inline void ConnectionsLog_UpgradeMediumScore::_internal_set_adjustment(const std::string& value) {
+  _has_bits_[0] |= 0x00000001u;
+  adjustment_.Set(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, value, GetArenaForAllocation());
+}
+inline std::string* ConnectionsLog_UpgradeMediumScore::_internal_mutable_adjustment() {
+  _has_bits_[0] |= 0x00000001u;
+  return adjustment_.Mutable(::PROTOBUF_NAMESPACE_ID::internal::ArenaStringPtr::EmptyDefault{}, GetArenaForAllocation());
+}
+inline std::string* ConnectionsLog_UpgradeMediumScore::release_adjustment() {
+  // @@protoc_insertion_point(field_release:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.adjustment)
+  if (!_internal_has_adjustment()) {
+    return nullptr;
+  }
+  _has_bits_[0] &= ~0x00000001u;
+  auto* p = adjustment_.ReleaseNonDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (adjustment_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    adjustment_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  return p;
+}
+inline void ConnectionsLog_UpgradeMediumScore::set_allocated_adjustment(std::string* adjustment) {
+  if (adjustment != nullptr) {
+    _has_bits_[0] |= 0x00000001u;
+  } else {
+    _has_bits_[0] &= ~0x00000001u;
+  }
+  adjustment_.SetAllocated(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), adjustment,
+      GetArenaForAllocation());
+#ifdef PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  if (adjustment_.IsDefault(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited())) {
+    adjustment_.Set(&::PROTOBUF_NAMESPACE_ID::internal::GetEmptyStringAlreadyInited(), "", GetArenaForAllocation());
+  }
+#endif // PROTOBUF_FORCE_COPY_DEFAULT_STRING
+  // @@protoc_insertion_point(field_set_allocated:location.nearby.analytics.proto.ConnectionsLog.UpgradeMediumScore.adjustment)
+}
+
 // -------------------------------------------------------------------
 
 // ConnectionsLog_ErrorCode
@@ -10824,6 +11829,10 @@ inline void ConnectionsLog::set_allocated_files_migration_phase(std::string* fil
 
 // -------------------------------------------------------------------
 
+// -------------------------------------------------------------------
+
+// -------------------------------------------------------------------
+
 
 // @@protoc_insertion_point(namespace_scope)
 
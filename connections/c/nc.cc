@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,12 +29,14 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "connections/advertising_options.h"
 #include "connections/c/nc_types.h"
 #include "connections/connection_options.h"
 #include "connections/core.h"
 #include "connections/discovery_options.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/listeners.h"
 #include "connections/medium_selector.h"
@@ -45,7 +48,9 @@
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/bluetooth_utils.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
 #include "internal/platform/file.h"
+#include "internal/platform/input_stream.h"
 #include "internal/platform/logging.h"
 
 namespace nearby::connections {
@@ -60,6 +65,13 @@ typedef struct NcContext {
   ::nearby::connections::Core* core = nullptr;
 } NcContext;
 
+// The content of an incoming bytes payload, handed to the received callback
+// as NC_BYTES_PAYLOAD.owner.
+typedef struct NcPayloadBytes {
+  nearby::ByteArray bytes;
+  bool retained = false;
+} NcPayloadBytes;
+
 absl::NoDestructor<absl::flat_hash_map<NC_INSTANCE, NcContext>> kNcContextMap;
 
 int64_t getFileSize(const char* filename) {
@@ -89,6 +101,50 @@ std::string convertIntToString(int input) {
   return result;
 }
 
+// An InputStream that pulls the content of an outgoing stream payload from
+// the callbacks of its NC_STREAM_PAYLOAD.
+class NcInputStream : public nearby::InputStream {
+ public:
+  NcInputStream(const NC_STREAM_PAYLOAD& stream, CALLER_CONTEXT context)
+      : stream_(stream), context_(context) {}
+  ~NcInputStream() override { Close(); }
+
+  nearby::ExceptionOr<nearby::ByteArray> Read(std::int64_t size) override {
+    if (closed_ || size < 0) return {nearby::Exception::kIo};
+    nearby::ByteArray bytes(static_cast<size_t>(size));
+    int read =
+        stream_.read_callback(stream_.stream, bytes.data(), size, context_);
+    if (read < 0 || read > size) return {nearby::Exception::kIo};
+    bytes.resize(read);
+    return nearby::ExceptionOr<nearby::ByteArray>(std::move(bytes));
+  }
+
+  nearby::ExceptionOr<size_t> Skip(size_t offset) override {
+    if (stream_.skip_callback == nullptr) {
+      return nearby::InputStream::Skip(offset);
+    }
+    if (closed_) return {nearby::Exception::kIo};
+    int skipped = stream_.skip_callback(stream_.stream, offset, context_);
+    if (skipped < 0) return {nearby::Exception::kIo};
+    return nearby::ExceptionOr<size_t>(skipped);
+  }
+
+  nearby::Exception Close() override {
+    if (closed_) return {nearby::Exception::kSuccess};
+    closed_ = true;
+    if (stream_.close_callback != nullptr &&
+        stream_.close_callback(stream_.stream, context_) < 0) {
+      return {nearby::Exception::kIo};
+    }
+    return {nearby::Exception::kSuccess};
+  }
+
+ private:
+  const NC_STREAM_PAYLOAD stream_;
+  const CALLER_CONTEXT context_;
+  bool closed_ = false;
+};
+
 NcContext* GetContext(NC_INSTANCE instance) {
   auto it = kNcContextMap->find(instance);
   if (it == kNcContextMap->end()) {
@@ -483,11 +539,14 @@ void NcAcceptConnection(NC_INSTANCE instance, int endpoint_id,
         nc_payload.id = payload.GetId();
         nc_payload.direction = NC_PAYLOAD_DIRECTION_INCOMING;
         nc_payload.type = static_cast<NC_PAYLOAD_TYPE>(payload.GetType());
+        // Freed when the callback returns, unless it retains the bytes.
+        std::unique_ptr<NcPayloadBytes> bytes;
         if (nc_payload.type == NC_PAYLOAD_TYPE_BYTES) {
-          const nearby::ByteArray& bytes = payload.AsBytes();
-          nc_payload.content.bytes.content.data =
-              const_cast<char*>(bytes.data());
-          nc_payload.content.bytes.content.size = bytes.size();
+          bytes = std::make_unique<NcPayloadBytes>();
+          bytes->bytes = std::move(payload).AsBytes();
+          nc_payload.content.bytes.content.data = bytes->bytes.data();
+          nc_payload.content.bytes.content.size = bytes->bytes.size();
+          nc_payload.content.bytes.owner = bytes.get();
         } else if (nc_payload.type == NC_PAYLOAD_TYPE_FILE) {
           nc_payload.content.file.file_name =
               (char*)payload.GetFileName().c_str();
@@ -500,6 +559,7 @@ void NcAcceptConnection(NC_INSTANCE instance, int endpoint_id,
 
         payload_listener.received_callback(
             instance, convertStringToInt(endpoint_id), &nc_payload, context);
+        if (bytes != nullptr && bytes->retained) bytes.release();
       };
 
   cpp_payload_listener.payload_progress_cb =
@@ -575,7 +635,13 @@ void NcSendPayload(NC_INSTANCE instance, size_t endpoint_ids_size,
     cpp_payload =
         ::nearby::connections::Payload(payload->id, std::move(input_file));
   } else if (payload->type == NC_PAYLOAD_TYPE_STREAM) {
-    // TODO(guogang): support stream later.
+    if (payload->content.stream.read_callback == nullptr) {
+      result_callback(NC_STATUS_PAYLOADUNKNOWN, context);
+      return;
+    }
+    cpp_payload = ::nearby::connections::Payload(
+        payload->id,
+        std::make_unique<NcInputStream>(payload->content.stream, context));
   }
 
   nc_context->core->SendPayload(
@@ -585,6 +651,18 @@ void NcSendPayload(NC_INSTANCE instance, size_t endpoint_ids_size,
       });
 }
 
+void NcRetainPayloadBytes(const NC_PAYLOAD* payload) {
+  if (payload == nullptr || payload->type != NC_PAYLOAD_TYPE_BYTES ||
+      payload->content.bytes.owner == nullptr) {
+    return;
+  }
+  static_cast<NcPayloadBytes*>(payload->content.bytes.owner)->retained = true;
+}
+
+void NcReleasePayloadBytes(NC_INSTANCE owner) {
+  delete static_cast<NcPayloadBytes*>(owner);
+}
+
 void NcCancelPayload(NC_INSTANCE instance, NC_PAYLOAD_ID payload_id,
                      NcCallbackResult result_callback, CALLER_CONTEXT context) {
   NcContext* nc_context = GetContext(instance);
@@ -644,6 +722,41 @@ void NcInitiateBandwidthUpgrade(NC_INSTANCE instance, int endpoint_id,
       });
 }
 
+void NcGetEndpointStats(NC_INSTANCE instance, int endpoint_id,
+                        NcCallbackEndpointStats stats_callback,
+                        CALLER_CONTEXT context) {
+  NcContext* nc_context = GetContext(instance);
+  if (nc_context == nullptr) {
+    stats_callback(NC_STATUS_ERROR, nullptr, context);
+    return;
+  }
+
+  nc_context->core->GetEndpointStats(
+      convertIntToString(endpoint_id),
+      [=](::nearby::connections::Status status,
+          ::nearby::connections::EndpointStats stats) {
+        if (!status.Ok()) {
+          stats_callback(static_cast<NC_STATUS>(status.value), nullptr,
+                         context);
+          return;
+        }
+        NC_ENDPOINT_STATS nc_stats = {
+            .medium = static_cast<NC_MEDIUM>(stats.medium),
+            .rtt_millis = stats.rtt == absl::InfiniteDuration()
+                              ? -1
+                              : absl::ToInt64Milliseconds(stats.rtt),
+            .send_bytes_per_second = stats.send_bytes_per_second,
+            .receive_bytes_per_second = stats.receive_bytes_per_second,
+            .send_queue_depth = stats.send_queue_depth,
+            .send_queue_bytes = stats.send_queue_bytes,
+            .incoming_bytes_held = stats.incoming_bytes_held,
+            .chunk_size = stats.chunk_size,
+            .max_transmit_packet_size = stats.max_transmit_packet_size,
+            .stalled = stats.stalled};
+        stats_callback(NC_STATUS_SUCCESS, &nc_stats, context);
+      });
+}
+
 int NcGetLocalEndpointId(NC_INSTANCE instance) {
   NcContext* nc_context = GetContext(instance);
   if (nc_context == nullptr) {
@@ -134,6 +134,20 @@ NC_API void NcSendPayload(NC_INSTANCE instance, size_t endpoint_ids_size,
                           NcCallbackResult result_callback,
                           CALLER_CONTEXT context);
 
+// Keeps the content of an incoming bytes payload valid after its received
+// callback returns, so that it can be handed on without being copied. Must be
+// called from within the callback, and be matched by a NcReleasePayloadBytes
+// call.
+//
+// payload - The payload passed to the received callback.
+NC_API void NcRetainPayloadBytes(const NC_PAYLOAD* payload);
+
+// Frees the content of an incoming bytes payload kept by NcRetainPayloadBytes.
+// Can be called from any thread.
+//
+// owner - The content.bytes.owner of the kept payload.
+NC_API void NcReleasePayloadBytes(NC_INSTANCE owner);
+
 // Cancels a Payload currently in-flight to or from remote endpoint(s).
 //
 // instance - The Nearby Connections instance is called by NcSendPayload.
@@ -170,6 +184,15 @@ NC_API void NcInitiateBandwidthUpgrade(NC_INSTANCE instance, int endpoint_id,
                                        NcCallbackResult result_callback,
                                        CALLER_CONTEXT context);
 
+// Gets the live stats of the connection to a remote endpoint.
+//
+// instance - The returned instance by NcOpenService.
+// endpoint_id - The ID of the connected remote endpoint.
+// stats_callback - Called with the stats, or with an error and null stats.
+NC_API void NcGetEndpointStats(NC_INSTANCE instance, int endpoint_id,
+                               NcCallbackEndpointStats stats_callback,
+                               CALLER_CONTEXT context);
+
 // Gets the local endpoint generated by Nearby Connections.
 NC_API int NcGetLocalEndpointId(NC_INSTANCE instance);
 
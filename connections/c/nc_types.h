@@ -180,9 +180,29 @@ typedef struct NC_CONNECTION_RESPONSE_INFO {
   bool is_connection_verified;
 } NC_CONNECTION_RESPONSE_INFO, *PNC_CONNECTION_RESPONSE_INFO;
 
+// The live state of the connection to one endpoint.
+typedef struct NC_ENDPOINT_STATS {
+  NC_MEDIUM medium;
+  // Smoothed keep-alive round trip time, or -1 while unknown.
+  int64_t rtt_millis;
+  int64_t send_bytes_per_second;
+  int64_t receive_bytes_per_second;
+  // Outgoing payloads not done yet, and their bytes left to send.
+  int send_queue_depth;
+  int64_t send_queue_bytes;
+  // Incoming bytes read and not handed to the client yet.
+  int64_t incoming_bytes_held;
+  int chunk_size;
+  int max_transmit_packet_size;
+  bool stalled;
+} NC_ENDPOINT_STATS, *PNC_ENDPOINT_STATS;
+
 // Defines callbacks in Nearby Connections.
 
 typedef void (*NcCallbackResult)(NC_STATUS status, CALLER_CONTEXT context);
+typedef void (*NcCallbackEndpointStats)(NC_STATUS status,
+                                       const NC_ENDPOINT_STATS* stats,
+                                       CALLER_CONTEXT context);
 
 typedef void (*NcCallbackConnectionInitiated)(
     NC_INSTANCE instance, int endpoint_id,
@@ -230,15 +250,28 @@ typedef struct NC_DISCOVERY_LISTENER {
 
 typedef struct NC_BYTES_PAYLOAD {
   NC_DATA content;
+  // Incoming payloads only. Owns the buffer of |content|, which the received
+  // callback can keep past its return with NcRetainPayloadBytes.
+  NC_INSTANCE owner;
 } NC_BYTES_PAYLOAD;
 
+// Reads at most |size| bytes of |stream| into |buffer|. Returns the number of
+// bytes read, 0 at the end of the stream, or a negative value on error.
 typedef int (*NcCallbackStreamRead)(NC_INSTANCE stream, char* buffer,
                                     int64_t size, CALLER_CONTEXT context);
+// Closes |stream|. Returns 0, or a negative value on error.
 typedef int (*NcCallbackStreamClose)(NC_INSTANCE stream,
                                      CALLER_CONTEXT context);
+// Skips |skip| bytes of |stream|. Returns the number of bytes skipped, which
+// is less than |skip| at the end of the stream, or a negative value on error.
 typedef int (*NcCallbackStreamSkip)(NC_INSTANCE stream, int64_t skip,
                                     CALLER_CONTEXT context);
 
+// A payload whose content is pulled from |stream| as it is sent, so that it
+// never has to be held in memory at once. The callbacks are called with the
+// context passed to NcSendPayload, from a thread of Nearby Connections, until
+// the close callback. |skip_callback| may be null, in which case skipped
+// bytes are read and dropped.
 typedef struct NC_STREAM_PAYLOAD {
   NC_INSTANCE stream;
   NcCallbackStreamRead read_callback;
@@ -246,6 +279,8 @@ typedef struct NC_STREAM_PAYLOAD {
   NcCallbackStreamClose close_callback;
 } NC_STREAM_PAYLOAD;
 
+// A payload sent from, or received to, the file at |parent_folder| /
+// |file_name|. Outgoing files are read chunk by chunk as they are sent.
 typedef struct NC_FILE_PAYLOAD {
   int64_t offset;
   char* file_name;
@@ -25,6 +25,7 @@
 #include "connections/advertising_options.h"
 #include "connections/connection_options.h"
 #include "connections/discovery_options.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/service_controller_router.h"
 #include "connections/implementation/service_id_constants.h"
 #include "connections/listeners.h"
@@ -207,6 +208,16 @@ void Core::SetCustomSavePath(absl::string_view path, ResultCallback callback) {
   router_->SetCustomSavePath(&client_, path, std::move(callback));
 }
 
+void Core::GetEndpointStats(absl::string_view endpoint_id,
+                            EndpointStatsCallback callback) {
+  if (endpoint_id.empty()) {
+    callback(Status{.value = Status::kEndpointUnknown}, {});
+    return;
+  }
+
+  router_->GetEndpointStats(&client_, endpoint_id, std::move(callback));
+}
+
 std::string Core::Dump() { return client_.Dump(); }
 
 // V3
@@ -231,20 +242,23 @@ void Core::StartAdvertisingV3(absl::string_view service_id,
                 });
           },
       .accepted_cb =
-          [v3_cb = listener.result_cb](const std::string& endpoint_id) {
+          [this, v3_cb = listener.result_cb](const std::string& endpoint_id) {
             auto remote_device = v3::ConnectionsDevice(endpoint_id, "", {});
             v3_cb(remote_device,
-                  v3::ConnectionResult{.status = Status{
-                                           .value = Status::kSuccess,
-                                       }});
+                  v3::ConnectionResult{
+                      .status = Status{.value = Status::kSuccess},
+                      .timeline = client_.GetConnectionTimeline(endpoint_id),
+                  });
           },
       .rejected_cb =
-          [v3_cb = listener.result_cb](const std::string& endpoint_id,
-                                       Status status) {
+          [this, v3_cb = listener.result_cb](const std::string& endpoint_id,
+                                             Status status) {
             auto remote_device = v3::ConnectionsDevice(endpoint_id, "", {});
-            v3_cb(remote_device, v3::ConnectionResult{
-                                     .status = status,
-                                 });
+            v3_cb(remote_device,
+                  v3::ConnectionResult{
+                      .status = status,
+                      .timeline = client_.GetConnectionTimeline(endpoint_id),
+                  });
           },
       .disconnected_cb =
           [&listener](const std::string& endpoint_id) {
@@ -452,6 +466,13 @@ void Core::AcceptConnectionV3(const NearbyDevice& remote_device,
                               std::move(result_cb));
 }
 
+void Core::AcceptConnectionsV3(
+    absl::Span<const NearbyDevice* const> remote_devices,
+    v3::PayloadListener listener_cb, v3::DeviceResultCallback result_cb) {
+  router_->AcceptConnectionsV3(&client_, remote_devices, std::move(listener_cb),
+                               std::move(result_cb));
+}
+
 void Core::RejectConnectionV3(const NearbyDevice& remote_device,
                               ResultCallback result_cb) {
   if (remote_device.GetEndpointId().empty()) {
@@ -474,6 +495,19 @@ void Core::SendPayloadV3(const NearbyDevice& remote_device, Payload payload,
                          std::move(result_cb));
 }
 
+void Core::SendPayloadToManyV3(
+    absl::Span<const NearbyDevice* const> remote_devices, Payload payload,
+    ResultCallback result_cb) {
+  CHECK(payload.GetType() != PayloadType::kUnknown);
+  if (remote_devices.empty()) {
+    result_cb(Status{.value = Status::kEndpointUnknown});
+    return;
+  }
+
+  router_->SendPayloadToManyV3(&client_, remote_devices, std::move(payload),
+                               std::move(result_cb));
+}
+
 void Core::CancelPayloadV3(const NearbyDevice& remote_device,
                            int64_t payload_id, ResultCallback result_cb) {
   CHECK_NE(payload_id, 0);
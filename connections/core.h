@@ -26,6 +26,7 @@
 #include "connections/advertising_options.h"
 #include "connections/connection_options.h"
 #include "connections/discovery_options.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/service_controller_router.h"
 #include "connections/listeners.h"
@@ -255,6 +256,18 @@ class Core {
   // path - The path where the received files will be saved to.
   void SetCustomSavePath(absl::string_view path, ResultCallback callback);
 
+  // Gets the live state of the connection to a remote endpoint: its medium,
+  // round trip time, throughput, and the payloads queued for it.
+  //
+  // endpoint_id - The identifier for the connected remote endpoint.
+  // callback    - to access the stats when available.
+  //   Possible status codes include:
+  //     Status::STATUS_OK - the stats are valid.
+  //     Status::STATUS_ENDPOINT_UNKNOWN if there's no connection to the
+  //         remote endpoint.
+  void GetEndpointStats(absl::string_view endpoint_id,
+                        EndpointStatsCallback callback);
+
   // Gets the local endpoint generated by Nearby Connections.
   std::string GetLocalEndpointId() { return client_.GetLocalEndpointId(); }
 
@@ -430,6 +443,21 @@ class Core {
                           v3::PayloadListener listener_cb,
                           ResultCallback result_cb);
 
+  // Accepts the connections to several remote endpoints at once, as
+  // AcceptConnectionV3() does for one. This is cheaper than accepting them
+  // one by one, which queues a task per endpoint.
+  //
+  // remote_devices - The remote devices.
+  //
+  // listener_cb - A callback for payloads exchanged with any of the remote
+  //               endpoints.
+  //
+  // result_cb   - called once for each of |remote_devices|, with the status
+  //               AcceptConnectionV3() would have reported for it.
+  void AcceptConnectionsV3(absl::Span<const NearbyDevice* const> remote_devices,
+                           v3::PayloadListener listener_cb,
+                           v3::DeviceResultCallback result_cb);
+
   // Rejects a connection to a remote endpoint.
   //
   // remote_device - The device for the remote endpoint. Should match the
@@ -464,6 +492,19 @@ class Core {
   void SendPayloadV3(const NearbyDevice& remote_device, Payload payload,
                      ResultCallback result_cb);
 
+  // Sends a Payload to several remote devices at once. The payload is read
+  // once, and each of its chunks is written to every device in turn, rather
+  // than sending it to each device separately.
+  //
+  // remote_devices - The remote devices to which the payload should be sent.
+  // payload      - The Payload to be sent.
+  // result_cb    - to access the status of the operation when available.
+  //   Possible status codes are those of SendPayloadV3(), with
+  //   Status::STATUS_ENDPOINT_UNKNOWN reported only if none of
+  //   |remote_devices| is connected.
+  void SendPayloadToManyV3(absl::Span<const NearbyDevice* const> remote_devices,
+                           Payload payload, ResultCallback result_cb);
+
   // Cancels a Payload currently in-flight to or from remote endpoint(s).
   //
   // remote_device - The remote device with which the payload is being
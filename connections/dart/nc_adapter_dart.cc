@@ -256,6 +256,10 @@ void ListenerEndpointDistanceChangedCB(NC_INSTANCE instance, int endpoint_id,
   }
 }
 
+void ReleasePayloadBytes(void *isolate_callback_data, void *peer) {
+  NcReleasePayloadBytes(peer);
+}
+
 void ListenerPayloadCB(NC_INSTANCE instance, int endpoint_id,
                        const NC_PAYLOAD *payload, void *context) {
   NEARBY_LOGS(INFO) << "Payload callback called. id: "
@@ -281,12 +285,18 @@ void ListenerPayloadCB(NC_INSTANCE instance, int endpoint_id,
         return;
       }
 
+      // Dart wraps the payload's own buffer rather than copying it into its
+      // heap, and releases it once the typed data is garbage collected.
+      NcRetainPayloadBytes(payload);
+      NC_INSTANCE owner = payload->content.bytes.owner;
       Dart_CObject dart_object_bytes;
-      dart_object_bytes.type = Dart_CObject_kTypedData;
-      dart_object_bytes.value.as_typed_data = {
+      dart_object_bytes.type = Dart_CObject_kExternalTypedData;
+      dart_object_bytes.value.as_external_typed_data = {
           .type = Dart_TypedData_kUint8,
           .length = static_cast<intptr_t>(bytes_size),
-          .values = reinterpret_cast<const uint8_t *>(bytes),
+          .data = reinterpret_cast<uint8_t *>(const_cast<char *>(bytes)),
+          .peer = owner,
+          .callback = &ReleasePayloadBytes,
       };
 
       Dart_CObject *elements[] = {
@@ -303,6 +313,8 @@ void ListenerPayloadCB(NC_INSTANCE instance, int endpoint_id,
               kClientState->GetPayloadListenerDart()->initial_byte_info_port,
               &dart_object_payload)) {
         NEARBY_LOGS(INFO) << "Posting message to port failed.";
+        // Dart didn't take the buffer, so it never finalizes it.
+        NcReleasePayloadBytes(owner);
       }
       return;
     }
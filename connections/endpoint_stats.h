@@ -0,0 +1,62 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_ENDPOINT_STATS_H_
+#define CORE_ENDPOINT_STATS_H_
+
+#include <cstdint>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "connections/medium_selector.h"
+#include "connections/status.h"
+
+namespace nearby {
+namespace connections {
+
+// The live state of the connection to one endpoint, e.g. to decide which
+// endpoints should get large transfers.
+struct EndpointStats {
+  // Medium of the channel currently in use.
+  Medium medium = Medium::UNKNOWN_MEDIUM;
+  // Smoothed round trip time of keep-alive probes, or absl::InfiniteDuration()
+  // until the endpoint answered one. Endpoints that don't acknowledge
+  // keep-alives never report one.
+  absl::Duration rtt = absl::InfiniteDuration();
+  // Over the last couple of seconds.
+  std::int64_t send_bytes_per_second = 0;
+  std::int64_t receive_bytes_per_second = 0;
+  // Outgoing payloads to the endpoint that are not done yet, and how many of
+  // their bytes are left to send. Streams of unknown size add no bytes.
+  int send_queue_depth = 0;
+  std::int64_t send_queue_bytes = 0;
+  // Bytes of incoming BYTES payloads from the endpoint that were read and not
+  // handed to the client yet.
+  std::int64_t incoming_bytes_held = 0;
+  // Size of the chunks outgoing payloads are split into.
+  int chunk_size = 0;
+  int max_transmit_packet_size = 0;
+  // A frame has been stuck in flight, or a payload waiting for its next chunk,
+  // for a few seconds, in either direction.
+  bool stalled = false;
+};
+
+// Called with Status::kSuccess and the stats, or with an error and empty
+// stats.
+using EndpointStatsCallback = absl::AnyInvocable<void(Status, EndpointStats)>;
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_ENDPOINT_STATS_H_
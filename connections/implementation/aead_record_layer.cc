@@ -0,0 +1,131 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/aead_record_layer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "internal/crypto_cros/aead.h"
+#include "internal/crypto_cros/hkdf.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+namespace connections {
+
+namespace {
+constexpr absl::string_view kKeyDerivationSalt =
+    "NearbyConnectionsAeadRecordLayer";
+constexpr absl::string_view kKeyDerivationInfo = "AES-256-GCM v1";
+constexpr size_t kKeyLength = 32;
+constexpr size_t kNonceLength = 12;
+
+// Layout of D2DConnectionContextV1::SaveSession(): a version byte, the encode
+// and decode sequence numbers, then the encode and decode keys.
+constexpr char kSavedSessionVersion = 1;
+constexpr size_t kSavedSessionEncodeKeyOffset = 1 + 4 + 4;
+constexpr size_t kSavedSessionDecodeKeyOffset =
+    kSavedSessionEncodeKeyOffset + kKeyLength;
+constexpr size_t kSavedSessionLength =
+    kSavedSessionDecodeKeyOffset + kKeyLength;
+
+std::string DeriveKey(absl::string_view secret) {
+  return crypto::HkdfSha256(secret, kKeyDerivationSalt, kKeyDerivationInfo,
+                            kKeyLength);
+}
+}  // namespace
+
+std::unique_ptr<AeadRecordLayer> AeadRecordLayer::Create(
+    EncryptionContext& context) {
+  std::string encode_key;
+  std::string decode_key;
+  if (!ExtractSessionKeys(context, &encode_key, &decode_key)) return nullptr;
+  return std::make_unique<AeadRecordLayer>(encode_key, decode_key);
+}
+
+bool AeadRecordLayer::ExtractSessionKeys(EncryptionContext& context,
+                                         std::string* encode_key,
+                                         std::string* decode_key) {
+  std::unique_ptr<std::string> session = context.SaveSession();
+  if (session == nullptr || session->size() != kSavedSessionLength ||
+      (*session)[0] != kSavedSessionVersion) {
+    NEARBY_LOGS(WARNING) << __func__
+                         << ": Unable to extract the UKEY2 session keys.";
+    return false;
+  }
+  *encode_key = session->substr(kSavedSessionEncodeKeyOffset, kKeyLength);
+  *decode_key = session->substr(kSavedSessionDecodeKeyOffset, kKeyLength);
+  return true;
+}
+
+AeadRecordLayer::AeadRecordLayer(absl::string_view encode_secret,
+                                 absl::string_view decode_secret)
+    : encode_key_(DeriveKey(encode_secret)),
+      decode_key_(DeriveKey(decode_secret)),
+      encode_aead_(std::make_unique<crypto::Aead>(crypto::Aead::AES_256_GCM)),
+      decode_aead_(std::make_unique<crypto::Aead>(crypto::Aead::AES_256_GCM)) {
+  encode_aead_->Init(&encode_key_);
+  decode_aead_->Init(&decode_key_);
+}
+
+AeadRecordLayer::~AeadRecordLayer() = default;
+
+std::unique_ptr<std::string> AeadRecordLayer::Encrypt(
+    absl::string_view plaintext) {
+  MutexLock lock(&encode_mutex_);
+  // Never wrap around and reuse a nonce.
+  if (encode_counter_ == std::numeric_limits<std::uint64_t>::max()) {
+    return nullptr;
+  }
+  auto record = std::make_unique<std::string>();
+  if (!encode_aead_->Seal(plaintext, MakeNonce(encode_counter_),
+                         /*additional_data=*/"", record.get())) {
+    return nullptr;
+  }
+  encode_counter_++;
+  return record;
+}
+
+std::unique_ptr<std::string> AeadRecordLayer::Decrypt(
+    absl::string_view record) {
+  MutexLock lock(&decode_mutex_);
+  if (decode_counter_ == std::numeric_limits<std::uint64_t>::max()) {
+    return nullptr;
+  }
+  auto plaintext = std::make_unique<std::string>();
+  if (!decode_aead_->Open(record, MakeNonce(decode_counter_),
+                         /*additional_data=*/"", plaintext.get())) {
+    return nullptr;
+  }
+  decode_counter_++;
+  return plaintext;
+}
+
+std::string AeadRecordLayer::MakeNonce(std::uint64_t counter) {
+  // The counter is stored big-endian in the last 8 bytes of the nonce.
+  std::string nonce(kNonceLength, '\0');
+  for (size_t i = 0; i < sizeof(counter); i++) {
+    nonce[kNonceLength - 1 - i] = static_cast<char>(counter & 0xFF);
+    counter >>= 8;
+  }
+  return nonce;
+}
+
+}  // namespace connections
+}  // namespace nearby
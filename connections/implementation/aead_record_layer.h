@@ -0,0 +1,103 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_AEAD_RECORD_LAYER_H_
+#define CORE_INTERNAL_AEAD_RECORD_LAYER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "securegcm/d2d_connection_context_v1.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace crypto {
+class Aead;
+}  // namespace crypto
+
+namespace connections {
+
+// An AES-256-GCM record layer for encrypted endpoint channels. Once both sides
+// advertised support for it in their ConnectionResponseFrame, it replaces the
+// D2D SecureMessage encoding of the UKEY2 context, which wraps every frame in
+// two protobufs and runs AES-CBC and HMAC over it in separate passes.
+//
+// Each direction has its own key, derived with HKDF from the UKEY2 key of that
+// direction, and its own 64-bit frame counter, which forms the nonce. Both
+// sides count frames, so nonces are never sent, and a frame that is dropped,
+// replayed or reordered fails to open. A record is the ciphertext followed by
+// the 16-byte GCM tag.
+//
+// One instance is shared by all the channels of an endpoint, so a channel
+// replaced by a bandwidth upgrade keeps counting where the previous one
+// stopped and a nonce is never used twice with the same key.
+class AeadRecordLayer {
+ public:
+  using EncryptionContext = ::securegcm::D2DConnectionContextV1;
+
+  // Version advertised in ConnectionResponseFrame.aead_record_layer_version.
+  static constexpr std::int32_t kVersion = 1;
+
+  // Derives the record layer from the session keys of |context|. Returns
+  // nullptr if the keys cannot be extracted from the context.
+  static std::unique_ptr<AeadRecordLayer> Create(EncryptionContext& context);
+
+  // Copies the UKEY2 keys of |context| for the frames we send and receive.
+  // Returns false if the keys cannot be extracted from the context.
+  static bool ExtractSessionKeys(EncryptionContext& context,
+                                 std::string* encode_key,
+                                 std::string* decode_key);
+
+  // |encode_secret| is the key material for frames we send, |decode_secret|
+  // the one for frames we receive; the peer uses them the other way around.
+  AeadRecordLayer(absl::string_view encode_secret,
+                  absl::string_view decode_secret);
+  ~AeadRecordLayer();
+  AeadRecordLayer(const AeadRecordLayer&) = delete;
+  AeadRecordLayer& operator=(const AeadRecordLayer&) = delete;
+
+  // Seals the next outgoing frame. Returns nullptr on failure.
+  std::unique_ptr<std::string> Encrypt(absl::string_view plaintext)
+      ABSL_LOCKS_EXCLUDED(encode_mutex_);
+
+  // Opens the next incoming frame. Returns nullptr if |record| is not the
+  // next frame sent by the peer; the failed record does not consume a nonce.
+  std::unique_ptr<std::string> Decrypt(absl::string_view record)
+      ABSL_LOCKS_EXCLUDED(decode_mutex_);
+
+ private:
+  static std::string MakeNonce(std::uint64_t counter);
+
+  // The Aead instances keep a reference to the keys.
+  const std::string encode_key_;
+  const std::string decode_key_;
+
+  // Reads and writes run on different threads; separate locks keep them from
+  // contending.
+  Mutex encode_mutex_;
+  std::unique_ptr<crypto::Aead> encode_aead_ ABSL_PT_GUARDED_BY(encode_mutex_);
+  std::uint64_t encode_counter_ ABSL_GUARDED_BY(encode_mutex_) = 0;
+
+  Mutex decode_mutex_;
+  std::unique_ptr<crypto::Aead> decode_aead_ ABSL_PT_GUARDED_BY(decode_mutex_);
+  std::uint64_t decode_counter_ ABSL_GUARDED_BY(decode_mutex_) = 0;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_AEAD_RECORD_LAYER_H_
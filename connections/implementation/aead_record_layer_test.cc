@@ -0,0 +1,104 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/aead_record_layer.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::string_view kSecretA = "0123456789abcdef0123456789abcdef";
+constexpr absl::string_view kSecretB = "fedcba9876543210fedcba9876543210";
+
+// Returns the layers of two peers; |first| encodes what |second| decodes.
+std::pair<std::unique_ptr<AeadRecordLayer>, std::unique_ptr<AeadRecordLayer>>
+CreatePeers() {
+  return {std::make_unique<AeadRecordLayer>(kSecretA, kSecretB),
+          std::make_unique<AeadRecordLayer>(kSecretB, kSecretA)};
+}
+
+TEST(AeadRecordLayerTest, RoundTripsInBothDirections) {
+  auto [layer_a, layer_b] = CreatePeers();
+
+  std::unique_ptr<std::string> record_a = layer_a->Encrypt("from a");
+  std::unique_ptr<std::string> record_b = layer_b->Encrypt("from b");
+  ASSERT_NE(record_a, nullptr);
+  ASSERT_NE(record_b, nullptr);
+  EXPECT_EQ(record_a->size(), std::string("from a").size() + 16);
+
+  std::unique_ptr<std::string> plaintext_b = layer_b->Decrypt(*record_a);
+  std::unique_ptr<std::string> plaintext_a = layer_a->Decrypt(*record_b);
+  ASSERT_NE(plaintext_a, nullptr);
+  ASSERT_NE(plaintext_b, nullptr);
+  EXPECT_EQ(*plaintext_b, "from a");
+  EXPECT_EQ(*plaintext_a, "from b");
+}
+
+TEST(AeadRecordLayerTest, SamePlaintextSealsToDifferentRecords) {
+  auto [layer_a, layer_b] = CreatePeers();
+
+  std::unique_ptr<std::string> first = layer_a->Encrypt("message");
+  std::unique_ptr<std::string> second = layer_a->Encrypt("message");
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+
+  EXPECT_NE(*first, *second);
+}
+
+TEST(AeadRecordLayerTest, RejectsTamperedRecord) {
+  auto [layer_a, layer_b] = CreatePeers();
+  std::unique_ptr<std::string> record = layer_a->Encrypt("message");
+  ASSERT_NE(record, nullptr);
+
+  std::string tampered = *record;
+  tampered[0] ^= 0x01;
+
+  EXPECT_EQ(layer_b->Decrypt(tampered), nullptr);
+  // A failed record does not consume a nonce.
+  std::unique_ptr<std::string> plaintext = layer_b->Decrypt(*record);
+  ASSERT_NE(plaintext, nullptr);
+  EXPECT_EQ(*plaintext, "message");
+}
+
+TEST(AeadRecordLayerTest, RejectsReplayedAndReorderedRecords) {
+  auto [layer_a, layer_b] = CreatePeers();
+  std::unique_ptr<std::string> first = layer_a->Encrypt("first");
+  std::unique_ptr<std::string> second = layer_a->Encrypt("second");
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+
+  EXPECT_EQ(layer_b->Decrypt(*second), nullptr);
+  ASSERT_NE(layer_b->Decrypt(*first), nullptr);
+  EXPECT_EQ(layer_b->Decrypt(*first), nullptr);
+  EXPECT_NE(layer_b->Decrypt(*second), nullptr);
+}
+
+TEST(AeadRecordLayerTest, RejectsRecordSealedForTheOtherDirection) {
+  auto [layer_a, layer_b] = CreatePeers();
+  std::unique_ptr<std::string> record = layer_a->Encrypt("message");
+  ASSERT_NE(record, nullptr);
+
+  EXPECT_EQ(layer_a->Decrypt(*record), nullptr);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -16,14 +16,18 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <iterator>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "absl/algorithm/container.h"
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/advertising_metadata_params.h"
@@ -105,6 +109,7 @@ using ::location::nearby::proto::connections::UPGRADE_SUCCESS;
 using ::location::nearby::proto::connections::UPGRADE_UNFINISHED;
 using ::location::nearby::proto::connections::UPGRADED;
 using ::nearby::analytics::EventLogger;
+using ::nearby::connections::ConnectionTimeline;
 using SafeDisconnectionResult = ::location::nearby::analytics::proto::
     ConnectionsLog::EstablishedConnection::SafeDisconnectionResult;
 
@@ -266,6 +271,21 @@ void AnalyticsRecorder::OnStopAdvertising() {
   RecordAdvertisingPhaseDurationAndReasonLocked(/* on_stop= */ true);
 }
 
+void AnalyticsRecorder::OnInstantOnLostRestartsSaved(int restarts_saved) {
+  MutexLock lock(&mutex_);
+  if (!CanRecordAnalyticsLocked("OnInstantOnLostRestartsSaved")) {
+    return;
+  }
+  if (current_advertising_phase_ == nullptr) {
+    NEARBY_LOGS(INFO) << "Unable to record instant on lost restarts saved due "
+                         "to null current_advertising_phase_";
+    return;
+  }
+  current_advertising_phase_->set_instant_on_lost_restarts_saved(
+      current_advertising_phase_->instant_on_lost_restarts_saved() +
+      restarts_saved);
+}
+
 int AnalyticsRecorder::GetNextAdvertisingUpdateIndex() {
   MutexLock lock(&mutex_);
 
@@ -648,19 +668,23 @@ void AnalyticsRecorder::OnOutgoingConnectionAttemptLocked(
 
 void AnalyticsRecorder::OnConnectionEstablished(
     const std::string &endpoint_id, Medium medium,
-    const std::string &connection_token) {
+    const std::string &connection_token, const ConnectionTimeline *timeline) {
   MutexLock lock(&mutex_);
   if (!CanRecordAnalyticsLocked("OnConnectionEstablished")) {
     return;
   }
   auto it = active_connections_.find(endpoint_id);
   if (it != active_connections_.end()) {
-    const std::unique_ptr<LogicalConnection> &logical_connection = it->second;
-    logical_connection->PhysicalConnectionEstablished(medium, connection_token);
+    it->second->PhysicalConnectionEstablished(medium, connection_token);
   } else {
-    active_connections_.insert(
-        {endpoint_id, std::make_unique<LogicalConnection>(
-                          medium, connection_token, no_record_time_millis_)});
+    it = active_connections_
+             .insert({endpoint_id,
+                      std::make_unique<LogicalConnection>(
+                          medium, connection_token, no_record_time_millis_)})
+             .first;
+  }
+  if (timeline != nullptr && !no_record_time_millis_) {
+    it->second->SetPhaseLatencies(medium, *timeline);
   }
 }
 
@@ -686,6 +710,7 @@ void AnalyticsRecorder::OnConnectionClosed(const std::string &endpoint_id,
     return;
   }
 
+  FlushChunkCountsLocked();
   auto it = active_connections_.find(endpoint_id);
   if (it == active_connections_.end()) {
     return;
@@ -725,16 +750,7 @@ void AnalyticsRecorder::OnIncomingPayloadStarted(
 void AnalyticsRecorder::OnPayloadChunkReceived(const std::string &endpoint_id,
                                                std::int64_t payload_id,
                                                std::int64_t chunk_size_bytes) {
-  MutexLock lock(&mutex_);
-  if (!CanRecordAnalyticsLocked("OnPayloadChunkReceived")) {
-    return;
-  }
-  auto it = active_connections_.find(endpoint_id);
-  if (it == active_connections_.end()) {
-    return;
-  }
-  const std::unique_ptr<LogicalConnection> &logical_connection = it->second;
-  logical_connection->ChunkReceived(payload_id, chunk_size_bytes);
+  CountChunk(endpoint_id, payload_id, /*incoming=*/true, chunk_size_bytes);
 }
 
 void AnalyticsRecorder::OnIncomingPayloadDone(
@@ -744,6 +760,7 @@ void AnalyticsRecorder::OnIncomingPayloadDone(
   if (!CanRecordAnalyticsLocked("OnIncomingPayloadDone")) {
     return;
   }
+  FlushChunkCountsLocked();
   auto it = active_connections_.find(endpoint_id);
   if (it == active_connections_.end()) {
     return;
@@ -774,16 +791,7 @@ void AnalyticsRecorder::OnOutgoingPayloadStarted(
 void AnalyticsRecorder::OnPayloadChunkSent(const std::string &endpoint_id,
                                            std::int64_t payload_id,
                                            std::int64_t chunk_size_bytes) {
-  MutexLock lock(&mutex_);
-  if (!CanRecordAnalyticsLocked("OnPayloadChunkSent")) {
-    return;
-  }
-  auto it = active_connections_.find(endpoint_id);
-  if (it == active_connections_.end()) {
-    return;
-  }
-  const std::unique_ptr<LogicalConnection> &logical_connection = it->second;
-  logical_connection->ChunkSent(payload_id, chunk_size_bytes);
+  CountChunk(endpoint_id, payload_id, /*incoming=*/false, chunk_size_bytes);
 }
 
 void AnalyticsRecorder::OnOutgoingPayloadDone(
@@ -793,6 +801,7 @@ void AnalyticsRecorder::OnOutgoingPayloadDone(
   if (!CanRecordAnalyticsLocked("OnOutgoingPayloadDone")) {
     return;
   }
+  FlushChunkCountsLocked();
   auto it = active_connections_.find(endpoint_id);
   if (it == active_connections_.end()) {
     return;
@@ -852,6 +861,23 @@ void AnalyticsRecorder::OnBandwidthUpgradeSuccess(
                              OperationResultCode::DETAIL_SUCCESS);
 }
 
+void AnalyticsRecorder::OnBandwidthUpgradeMediumScores(
+    const std::string &endpoint_id,
+    const std::vector<ConnectionsLog::UpgradeMediumScore> &scores) {
+  MutexLock lock(&mutex_);
+  if (!CanRecordAnalyticsLocked("OnBandwidthUpgradeMediumScores")) {
+    return;
+  }
+  auto it = bandwidth_upgrade_attempts_.find(endpoint_id);
+  if (it == bandwidth_upgrade_attempts_.end()) {
+    return;
+  }
+  it->second->clear_medium_scores();
+  for (const auto &score : scores) {
+    *it->second->add_medium_scores() = score;
+  }
+}
+
 void AnalyticsRecorder::OnErrorCode(const ErrorCodeParams &params) {
   MutexLock lock(&mutex_);
   if (!CanRecordAnalyticsLocked("OnErrorCode")) {
@@ -1032,6 +1058,46 @@ OperationResultCode AnalyticsRecorder::GetChannelIoErrorResultCodeFromMedium(
   }
 }
 
+void AnalyticsRecorder::CountChunk(const std::string &endpoint_id,
+                                   std::int64_t payload_id, bool incoming,
+                                   std::int64_t chunk_size_bytes) {
+  if (event_logger_ == nullptr) {
+    return;
+  }
+  ChunkCountShard &shard =
+      chunk_counts_[std::hash<std::thread::id>()(std::this_thread::get_id()) %
+                    kChunkCountShards];
+  MutexLock lock(&shard.mutex);
+  ChunkCount &count = shard.counts[{endpoint_id, payload_id, incoming}];
+  count.size_bytes += chunk_size_bytes;
+  count.num_chunks++;
+}
+
+void AnalyticsRecorder::FlushChunkCountsLocked() {
+  for (ChunkCountShard &shard : chunk_counts_) {
+    absl::flat_hash_map<std::tuple<std::string, std::int64_t, bool>,
+                        ChunkCount>
+        counts;
+    {
+      MutexLock lock(&shard.mutex);
+      counts.swap(shard.counts);
+    }
+    for (const auto &[key, count] : counts) {
+      const auto &[endpoint_id, payload_id, incoming] = key;
+      auto it = active_connections_.find(endpoint_id);
+      if (it == active_connections_.end()) {
+        continue;
+      }
+      if (incoming) {
+        it->second->ChunksReceived(payload_id, count.size_bytes,
+                                   count.num_chunks);
+      } else {
+        it->second->ChunksSent(payload_id, count.size_bytes, count.num_chunks);
+      }
+    }
+  }
+}
+
 bool AnalyticsRecorder::CanRecordAnalyticsLocked(
     absl::string_view method_name) {
   NEARBY_VLOG(1) << "AnalyticsRecorder LogEvent " << method_name
@@ -1372,6 +1438,7 @@ void AnalyticsRecorder::FinishStrategySessionLocked() {
   if (current_strategy_session_ != nullptr) {
     FinishAdvertisingPhaseLocked();
     FinishDiscoveryPhaseLocked();
+    FlushChunkCountsLocked();
 
     // Finish any unfinished LogicalConnections.
     for (const auto &item : active_connections_) {
@@ -1439,10 +1506,10 @@ PayloadType AnalyticsRecorder::PayloadTypeToProtoPayloadType(
   }
 }
 
-void AnalyticsRecorder::PendingPayload::AddChunk(
-    std::int64_t chunk_size_bytes) {
-  num_bytes_transferred_ += chunk_size_bytes;
-  num_chunks_++;
+void AnalyticsRecorder::PendingPayload::AddChunks(std::int64_t size_bytes,
+                                                  int num_chunks) {
+  num_bytes_transferred_ += size_bytes;
+  num_chunks_ += num_chunks;
 }
 
 ConnectionsLog::Payload AnalyticsRecorder::PendingPayload::GetProtoPayload(
@@ -1496,6 +1563,29 @@ void AnalyticsRecorder::LogicalConnection::PhysicalConnectionEstablished(
   current_medium_ = medium;
 }
 
+void AnalyticsRecorder::LogicalConnection::SetPhaseLatencies(
+    Medium medium, const ConnectionTimeline &timeline) {
+  auto it = physical_connections_.find(medium);
+  if (it == physical_connections_.end()) {
+    return;
+  }
+  ConnectionsLog::ConnectionPhaseLatencies *latencies =
+      it->second->mutable_phase_latencies();
+  if (!timeline.is_incoming) {
+    latencies->set_medium_connect_millis(
+        absl::ToInt64Milliseconds(timeline.MediumConnect()));
+  }
+  latencies->set_connection_request_millis(
+      absl::ToInt64Milliseconds(timeline.RequestExchange()));
+  latencies->set_encryption_millis(
+      absl::ToInt64Milliseconds(timeline.Encryption()));
+  latencies->set_local_accept_millis(
+      absl::ToInt64Milliseconds(timeline.LocalAccept()));
+  latencies->set_remote_accept_millis(
+      absl::ToInt64Milliseconds(timeline.RemoteAccept()));
+  latencies->set_total_millis(absl::ToInt64Milliseconds(timeline.Total()));
+}
+
 void AnalyticsRecorder::LogicalConnection::PhysicalConnectionClosed(
     Medium medium, DisconnectionReason reason, SafeDisconnectionResult result) {
   if (current_medium_ == UNKNOWN_MEDIUM) {
@@ -1583,14 +1673,14 @@ void AnalyticsRecorder::LogicalConnection::IncomingPayloadStarted(
                                                     no_record_time_millis_)});
 }
 
-void AnalyticsRecorder::LogicalConnection::ChunkReceived(
-    std::int64_t payload_id, std::int64_t size_bytes) {
+void AnalyticsRecorder::LogicalConnection::ChunksReceived(
+    std::int64_t payload_id, std::int64_t size_bytes, int num_chunks) {
   auto it = incoming_payloads_.find(payload_id);
   if (it == incoming_payloads_.end()) {
     return;
   }
   PendingPayload *pending_payload = it->second.get();
-  pending_payload->AddChunk(size_bytes);
+  pending_payload->AddChunks(size_bytes, num_chunks);
 }
 
 void AnalyticsRecorder::LogicalConnection::IncomingPayloadDone(
@@ -1622,14 +1712,15 @@ void AnalyticsRecorder::LogicalConnection::OutgoingPayloadStarted(
                                                     no_record_time_millis_)});
 }
 
-void AnalyticsRecorder::LogicalConnection::ChunkSent(std::int64_t payload_id,
-                                                     std::int64_t size_bytes) {
+void AnalyticsRecorder::LogicalConnection::ChunksSent(std::int64_t payload_id,
+                                                      std::int64_t size_bytes,
+                                                      int num_chunks) {
   auto it = outgoing_payloads_.find(payload_id);
   if (it == outgoing_payloads_.end()) {
     return;
   }
   PendingPayload *payload = it->second.get();
-  payload->AddChunk(size_bytes);
+  payload->AddChunks(size_bytes, num_chunks);
 }
 
 void AnalyticsRecorder::LogicalConnection::OutgoingPayloadDone(
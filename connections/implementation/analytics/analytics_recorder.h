@@ -15,19 +15,23 @@
 #ifndef ANALYTICS_ANALYTICS_RECORDER_H_
 #define ANALYTICS_ANALYTICS_RECORDER_H_
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/advertising_metadata_params.h"
 #include "connections/implementation/analytics/connection_attempt_metadata_params.h"
 #include "connections/implementation/analytics/discovery_metadata_params.h"
+#include "connections/listeners.h"
 #include "connections/payload_type.h"
 #include "connections/strategy.h"
 #include "internal/analytics/event_logger.h"
@@ -56,6 +60,10 @@ class AnalyticsRecorder {
       AdvertisingMetadataParams *advertising_metadata_params)
       ABSL_LOCKS_EXCLUDED(mutex_);
   void OnStopAdvertising() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Records the instant on lost advertisement restarts spared by batching,
+  // while stopping the current advertising phase.
+  void OnInstantOnLostRestartsSaved(int restarts_saved)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   // In case the client calls the {@link BasePcp#updateAdvertisingOptions()}
   // multiple times, adds one index value to group the mediums results within
@@ -155,7 +163,9 @@ class AnalyticsRecorder {
   void OnConnectionEstablished(
       const std::string &endpoint_id,
       location::nearby::proto::connections::Medium medium,
-      const std::string &connection_token) ABSL_LOCKS_EXCLUDED(mutex_);
+      const std::string &connection_token,
+      const connections::ConnectionTimeline *timeline = nullptr)
+      ABSL_LOCKS_EXCLUDED(mutex_);
   void OnConnectionClosed(
       const std::string &endpoint_id,
       location::nearby::proto::connections::Medium medium,
@@ -170,6 +180,8 @@ class AnalyticsRecorder {
                                 connections::PayloadType type,
                                 std::int64_t total_size_bytes)
       ABSL_LOCKS_EXCLUDED(mutex_);
+  // Chunks are only counted here, without taking |mutex_|; the counts are
+  // added to the payload when it is done or its connection is closed.
   void OnPayloadChunkReceived(const std::string &endpoint_id,
                               std::int64_t payload_id,
                               std::int64_t chunk_size_bytes)
@@ -211,6 +223,13 @@ class AnalyticsRecorder {
           operation_result_code) ABSL_LOCKS_EXCLUDED(mutex_);
   void OnBandwidthUpgradeSuccess(const std::string &endpoint_id)
       ABSL_LOCKS_EXCLUDED(mutex_);
+  // Records the scores the upgrade medium of the started attempt was chosen
+  // by.
+  void OnBandwidthUpgradeMediumScores(
+      const std::string &endpoint_id,
+      const std::vector<location::nearby::analytics::proto::ConnectionsLog::
+                            UpgradeMediumScore> &scores)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   // Error Code
   void OnErrorCode(const ErrorCodeParams &params);
@@ -256,7 +275,7 @@ class AnalyticsRecorder {
           no_record_time_millis_(no_record_time_millis) {}
     ~PendingPayload() = default;
 
-    void AddChunk(std::int64_t chunk_size_bytes);
+    void AddChunks(std::int64_t size_bytes, int num_chunks);
 
     location::nearby::analytics::proto::ConnectionsLog::Payload GetProtoPayload(
         location::nearby::proto::connections::PayloadStatus status);
@@ -313,12 +332,15 @@ class AnalyticsRecorder {
         location::nearby::analytics::proto::ConnectionsLog::
             EstablishedConnection::SafeDisconnectionResult result);
     void CloseAllPhysicalConnections();
+    void SetPhaseLatencies(location::nearby::proto::connections::Medium medium,
+                           const connections::ConnectionTimeline &timeline);
 
     void IncomingPayloadStarted(
         std::int64_t payload_id,
         location::nearby::proto::connections::PayloadType type,
         std::int64_t total_size_bytes);
-    void ChunkReceived(std::int64_t payload_id, std::int64_t size_bytes);
+    void ChunksReceived(std::int64_t payload_id, std::int64_t size_bytes,
+                        int num_chunks);
     void IncomingPayloadDone(
         std::int64_t payload_id,
         location::nearby::proto::connections::PayloadStatus status,
@@ -328,7 +350,8 @@ class AnalyticsRecorder {
         std::int64_t payload_id,
         location::nearby::proto::connections::PayloadType type,
         std::int64_t total_size_bytes);
-    void ChunkSent(std::int64_t payload_id, std::int64_t size_bytes);
+    void ChunksSent(std::int64_t payload_id, std::int64_t size_bytes,
+                    int num_chunks);
     void OutgoingPayloadDone(
         std::int64_t payload_id,
         location::nearby::proto::connections::PayloadStatus status,
@@ -372,6 +395,12 @@ class AnalyticsRecorder {
   bool CanRecordAnalyticsLocked(absl::string_view method_name)
       ABSL_SHARED_LOCKS_REQUIRED(mutex_);
 
+  // Counts a chunk of |payload_id| in the chunk counters of this thread.
+  void CountChunk(const std::string &endpoint_id, std::int64_t payload_id,
+                  bool incoming, std::int64_t chunk_size_bytes);
+  // Adds the chunks counted so far to their pending payloads.
+  void FlushChunkCountsLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // Callbacks the ConnectionsLog proto byte array data to the EventLogger with
   // ClientSession sub-proto.
   void LogClientSessionLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -471,6 +500,22 @@ class AnalyticsRecorder {
   // Protects all sub-protos reading and writing in ConnectionLog.
   Mutex mutex_;
 
+  // Chunk counts per endpoint, payload and direction (true if incoming),
+  // sharded by thread so that threads moving payloads don't contend.
+  // Locked after |mutex_|.
+  static constexpr int kChunkCountShards = 8;
+  struct ChunkCount {
+    std::int64_t size_bytes = 0;
+    int num_chunks = 0;
+  };
+  struct ChunkCountShard {
+    Mutex mutex;
+    absl::flat_hash_map<std::tuple<std::string, std::int64_t, bool>,
+                        ChunkCount>
+        counts ABSL_GUARDED_BY(mutex);
+  };
+  std::array<ChunkCountShard, kChunkCountShards> chunk_counts_;
+
   // For testing only.
   bool no_record_time_millis_ = false;
 
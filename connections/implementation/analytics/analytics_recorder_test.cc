@@ -34,6 +34,7 @@
 #include "internal/platform/error_code_params.h"
 #include "internal/platform/error_code_recorder.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/proto/analytics/connections_log.proto.h"
 #include "proto/connections_enums.proto.h"
 
@@ -229,6 +230,47 @@ TEST(AnalyticsRecorderTest, SetFieldsCorrectlyForNestedAdvertisingCalls) {
               (EqualsProto(strategy_session_proto)));
 }
 
+TEST(AnalyticsRecorderTest, InstantOnLostRestartsSavedAddUpInAdvertising) {
+  CountDownLatch client_session_done_latch(1);
+  FakeEventLogger event_logger(client_session_done_latch);
+  AnalyticsRecorder analytics_recorder(&event_logger,
+                                       /*no_record_time_millis=*/true);
+
+  auto advertising_metadata_params =
+      analytics_recorder.BuildAdvertisingMetadataParams();
+  analytics_recorder.OnStartAdvertising(connections::Strategy::kP2pCluster,
+                                        /*mediums=*/{BLE},
+                                        advertising_metadata_params.get());
+  analytics_recorder.OnInstantOnLostRestartsSaved(2);
+  analytics_recorder.OnInstantOnLostRestartsSaved(3);
+  analytics_recorder.OnStopAdvertising();
+  // Not recorded without an advertising phase.
+  analytics_recorder.OnInstantOnLostRestartsSaved(4);
+
+  analytics_recorder.LogSession();
+  ASSERT_TRUE(client_session_done_latch.Await(kDefaultTimeout).result());
+
+  ConnectionsLog::ClientSession strategy_session_proto =
+      ParseTextProtoOrDie(R"pb(
+        strategy_session {
+          strategy: P2P_CLUSTER
+          role: ADVERTISER
+          advertising_phase {
+            medium: BLE
+            advertising_metadata {
+              supports_extended_ble_advertisements: false
+              connected_ap_frequency: 0
+              supports_nfc_technology: false
+            }
+            stop_reason: CLIENT_STOP_ADVERTISING
+            instant_on_lost_restarts_saved: 5
+          }
+        })pb");
+
+  EXPECT_THAT(event_logger.GetLoggedClientSession(),
+              (EqualsProto(strategy_session_proto)));
+}
+
 TEST(AnalyticsRecorderTest, SetFieldsCorrectlyForNestedDiscoveryCalls) {
   connections::Strategy strategy = connections::Strategy::kP2pStar;
 
@@ -1076,6 +1118,56 @@ TEST(AnalyticsRecorderTest, OutgoingPayloadUpgraded) {
               EqualsProto(strategy_session_proto));
 }
 
+TEST(AnalyticsRecorderTest, CountsChunksFromManyThreads) {
+  std::string endpoint_id = "endpoint_id";
+  std::int64_t payload_id = 123456789;
+
+  CountDownLatch client_session_done_latch(1);
+  FakeEventLogger event_logger(client_session_done_latch);
+  AnalyticsRecorder analytics_recorder(&event_logger,
+                                       /*no_record_time_millis=*/true);
+
+  auto advertising_metadata_params =
+      analytics_recorder.BuildAdvertisingMetadataParams();
+  analytics_recorder.OnStartAdvertising(connections::Strategy::kP2pStar,
+                                        /*mediums=*/{BLE, BLUETOOTH},
+                                        advertising_metadata_params.get());
+  analytics_recorder.OnConnectionEstablished(endpoint_id, BLUETOOTH,
+                                             "connection_token");
+  analytics_recorder.OnOutgoingPayloadStarted(
+      {endpoint_id}, payload_id, connections::PayloadType::kFile, 4000);
+  {
+    MultiThreadExecutor executor(4);
+    CountDownLatch chunks_sent(4);
+    for (int i = 0; i < 4; ++i) {
+      executor.Execute([&]() {
+        for (int j = 0; j < 100; ++j) {
+          analytics_recorder.OnPayloadChunkSent(endpoint_id, payload_id, 10);
+        }
+        chunks_sent.CountDown();
+      });
+    }
+    ASSERT_TRUE(chunks_sent.Await(kDefaultTimeout).result());
+  }
+  analytics_recorder.OnOutgoingPayloadDone(endpoint_id, payload_id, SUCCESS,
+                                           OperationResultCode::DETAIL_SUCCESS);
+
+  analytics_recorder.LogSession();
+  ASSERT_TRUE(client_session_done_latch.Await(kDefaultTimeout).result());
+
+  const ConnectionsLog::ClientSession& client_session =
+      event_logger.GetLoggedClientSession();
+  ASSERT_EQ(client_session.strategy_session_size(), 1);
+  ASSERT_EQ(client_session.strategy_session(0).established_connection_size(),
+            1);
+  const ConnectionsLog::EstablishedConnection& established_connection =
+      client_session.strategy_session(0).established_connection(0);
+  ASSERT_EQ(established_connection.sent_payload_size(), 1);
+  EXPECT_EQ(established_connection.sent_payload(0).num_chunks(), 400);
+  EXPECT_EQ(established_connection.sent_payload(0).num_bytes_transferred(),
+            4000);
+}
+
 TEST(AnalyticsRecorderTest, UpgradeAttemptWorks) {
   std::string endpoint_id = "endpoint_id";
   std::string endpoint_id_1 = "endpoint_id_1";
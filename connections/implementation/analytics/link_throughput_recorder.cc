@@ -0,0 +1,208 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/analytics/link_throughput_recorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "connections/payload_type.h"
+#include "internal/platform/mutex_lock.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace analytics {
+
+using ::location::nearby::proto::connections::Medium;
+using ::nearby::connections::PayloadDirection;
+
+LinkThroughputRecorder::LinkThroughputRecorder(absl::Duration window,
+                                               absl::Duration stall_timeout)
+    : bucket_micros_(std::max<std::int64_t>(
+          1, absl::ToInt64Microseconds(window) / kWindowBuckets)),
+      stall_timeout_(stall_timeout) {}
+
+void LinkThroughputRecorder::OnFrameStarted(absl::Time now) {
+  frame_started_at_.store(absl::ToUnixMicros(now), std::memory_order_relaxed);
+}
+
+void LinkThroughputRecorder::OnFrame(std::int64_t bytes,
+                                     absl::Duration latency,
+                                     bool more_expected, absl::Time now) {
+  std::int64_t now_micros = absl::ToUnixMicros(now);
+  std::int64_t slice = now_micros / bucket_micros_;
+  Bucket& bucket = window_[slice % kWindowBuckets];
+  std::int64_t bucket_slice = bucket.slice.load(std::memory_order_acquire);
+  if (bucket_slice != slice &&
+      bucket.slice.compare_exchange_strong(bucket_slice, slice,
+                                           std::memory_order_acq_rel)) {
+    bucket.bytes.store(0, std::memory_order_relaxed);
+  }
+  bucket.bytes.fetch_add(bytes, std::memory_order_relaxed);
+
+  latencies_[GetLatencyBucket(latency)].fetch_add(1,
+                                                  std::memory_order_relaxed);
+  frames_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  busy_micros_.fetch_add(absl::ToInt64Microseconds(latency),
+                         std::memory_order_relaxed);
+
+  std::int64_t never = kNever;
+  first_frame_at_.compare_exchange_strong(never, now_micros,
+                                          std::memory_order_relaxed);
+  last_frame_at_.store(now_micros, std::memory_order_relaxed);
+  more_expected_.store(more_expected, std::memory_order_relaxed);
+  frame_started_at_.store(kNever, std::memory_order_relaxed);
+}
+
+LinkThroughputRecorder::Snapshot LinkThroughputRecorder::GetSnapshot(
+    absl::Time now) const {
+  Snapshot snapshot;
+  snapshot.frames = frames_.load(std::memory_order_relaxed);
+  snapshot.bytes = bytes_.load(std::memory_order_relaxed);
+  std::int64_t busy_micros = busy_micros_.load(std::memory_order_relaxed);
+  if (busy_micros > 0) {
+    snapshot.active_bytes_per_second = snapshot.bytes * 1000000 / busy_micros;
+  }
+
+  std::int64_t now_micros = absl::ToUnixMicros(now);
+  std::int64_t first_frame_at = first_frame_at_.load(std::memory_order_relaxed);
+  std::int64_t last_frame_at = last_frame_at_.load(std::memory_order_relaxed);
+  if (first_frame_at != kNever) {
+    std::int64_t slice = now_micros / bucket_micros_;
+    std::int64_t window_bytes = 0;
+    for (const Bucket& bucket : window_) {
+      std::int64_t bucket_slice = bucket.slice.load(std::memory_order_acquire);
+      if (bucket_slice > slice - kWindowBuckets && bucket_slice <= slice) {
+        window_bytes += bucket.bytes.load(std::memory_order_relaxed);
+      }
+    }
+    // The window ends with the current, partly elapsed, slice.
+    std::int64_t window_micros =
+        (kWindowBuckets - 1) * bucket_micros_ + now_micros % bucket_micros_;
+    window_micros = std::min(window_micros, now_micros - first_frame_at);
+    if (window_micros > 0) {
+      snapshot.bytes_per_second = window_bytes * 1000000 / window_micros;
+    }
+    snapshot.idle_for = absl::Microseconds(now_micros - last_frame_at);
+  }
+  snapshot.chunk_latency_p50 = GetLatencyPercentile(0.5);
+  snapshot.chunk_latency_p95 = GetLatencyPercentile(0.95);
+
+  std::int64_t frame_started_at =
+      frame_started_at_.load(std::memory_order_relaxed);
+  if (frame_started_at != kNever) {
+    snapshot.stalled =
+        absl::Microseconds(now_micros - frame_started_at) >= stall_timeout_;
+  } else if (more_expected_.load(std::memory_order_relaxed)) {
+    snapshot.stalled = snapshot.idle_for >= stall_timeout_;
+  }
+  return snapshot;
+}
+
+int LinkThroughputRecorder::GetLatencyBucket(absl::Duration latency) {
+  if (latency <= kMinLatency) return 0;
+  int bucket = static_cast<int>(std::ceil(
+      std::log(absl::FDivDuration(latency, kMinLatency)) /
+      std::log(kLatencyBucketGrowth)));
+  return std::min(bucket, kLatencyBuckets - 1);
+}
+
+absl::Duration LinkThroughputRecorder::GetLatencyPercentile(
+    double percentile) const {
+  std::int64_t counts[kLatencyBuckets];
+  std::int64_t total = 0;
+  for (int i = 0; i < kLatencyBuckets; ++i) {
+    counts[i] = latencies_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  if (total == 0) return absl::ZeroDuration();
+
+  // Report the upper bound of the bucket the percentile falls into.
+  auto rank = static_cast<std::int64_t>(std::ceil(percentile * total));
+  std::int64_t seen = 0;
+  for (int i = 0; i < kLatencyBuckets; ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      return kMinLatency * std::pow(kLatencyBucketGrowth, i);
+    }
+  }
+  return kMinLatency * std::pow(kLatencyBucketGrowth, kLatencyBuckets - 1);
+}
+
+std::shared_ptr<LinkThroughputRecorder> LinkThroughputRegistry::GetRecorder(
+    const std::string& endpoint_id, Medium medium,
+    PayloadDirection direction) {
+  MutexLock lock(&mutex_);
+  std::shared_ptr<LinkThroughputRecorder>& recorder =
+      recorders_[Key(endpoint_id, medium, direction)];
+  if (recorder == nullptr) {
+    recorder =
+        std::make_shared<LinkThroughputRecorder>(window_, stall_timeout_);
+  }
+  return recorder;
+}
+
+std::optional<LinkThroughputRecorder::Snapshot>
+LinkThroughputRegistry::GetSnapshot(const std::string& endpoint_id,
+                                    Medium medium,
+                                    PayloadDirection direction) {
+  std::shared_ptr<LinkThroughputRecorder> recorder;
+  {
+    MutexLock lock(&mutex_);
+    auto it = recorders_.find(Key(endpoint_id, medium, direction));
+    if (it == recorders_.end()) return std::nullopt;
+    recorder = it->second;
+  }
+  return recorder->GetSnapshot();
+}
+
+std::vector<std::pair<Medium, LinkThroughputRecorder::Snapshot>>
+LinkThroughputRegistry::GetSnapshots(const std::string& endpoint_id,
+                                     PayloadDirection direction) {
+  std::vector<std::pair<Medium, std::shared_ptr<LinkThroughputRecorder>>>
+      recorders;
+  {
+    MutexLock lock(&mutex_);
+    for (const auto& [key, recorder] : recorders_) {
+      if (std::get<0>(key) == endpoint_id && std::get<2>(key) == direction) {
+        recorders.emplace_back(std::get<1>(key), recorder);
+      }
+    }
+  }
+  std::vector<std::pair<Medium, LinkThroughputRecorder::Snapshot>> snapshots;
+  snapshots.reserve(recorders.size());
+  for (const auto& [medium, recorder] : recorders) {
+    snapshots.emplace_back(medium, recorder->GetSnapshot());
+  }
+  return snapshots;
+}
+
+void LinkThroughputRegistry::RemoveEndpoint(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+  absl::erase_if(recorders_, [&endpoint_id](const auto& entry) {
+    return std::get<0>(entry.first) == endpoint_id;
+  });
+}
+
+}  // namespace analytics
+}  // namespace nearby
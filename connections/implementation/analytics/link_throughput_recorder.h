@@ -0,0 +1,171 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYTICS_LINK_THROUGHPUT_RECORDER_H_
+#define ANALYTICS_LINK_THROUGHPUT_RECORDER_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/payload_type.h"
+#include "internal/platform/implementation/system_clock.h"
+#include "internal/platform/mutex.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace analytics {
+
+// Live statistics of the frames going one way over one medium connection to
+// one endpoint.
+//
+// Unlike ThroughputRecorder, which reports the average throughput of a payload
+// once it is done, this can be queried at any time: it keeps the bytes of the
+// last |window| in kWindowBuckets time buckets, and a histogram of the chunk
+// latencies since the link came up. Recording a frame only touches atomics,
+// so frames of different payloads can be recorded from any thread without
+// locking. A bucket that is recycled while another thread adds to it may lose
+// that frame, which is fine for statistics.
+class LinkThroughputRecorder {
+ public:
+  static constexpr int kWindowBuckets = 16;
+  // Chunk latencies are counted in buckets whose upper bounds grow by
+  // kLatencyBucketGrowth from kMinLatency on, so percentiles are accurate to
+  // within 25%.
+  static constexpr int kLatencyBuckets = 64;
+  static constexpr absl::Duration kMinLatency = absl::Microseconds(100);
+  static constexpr double kLatencyBucketGrowth = 1.25;
+
+  struct Snapshot {
+    // Since the link came up.
+    std::int64_t frames = 0;
+    std::int64_t bytes = 0;
+    // Over the last |window|, or since the first frame if that is shorter.
+    std::int64_t bytes_per_second = 0;
+    // Bytes per second of frame latency since the link came up: the
+    // throughput while frames were in flight, idle time left out.
+    std::int64_t active_bytes_per_second = 0;
+    absl::Duration chunk_latency_p50 = absl::ZeroDuration();
+    absl::Duration chunk_latency_p95 = absl::ZeroDuration();
+    // Time since the last frame, or zero if there was none.
+    absl::Duration idle_for = absl::ZeroDuration();
+    // A frame has been in flight, or a payload has been waiting for its next
+    // chunk, for longer than the stall timeout.
+    bool stalled = false;
+  };
+
+  LinkThroughputRecorder(absl::Duration window, absl::Duration stall_timeout);
+  LinkThroughputRecorder(const LinkThroughputRecorder&) = delete;
+  LinkThroughputRecorder& operator=(const LinkThroughputRecorder&) = delete;
+
+  // Called before a frame is written. Until OnFrame() records it, the link
+  // counts as stalled once the stall timeout has passed. Only the last frame
+  // started is tracked.
+  void OnFrameStarted(absl::Time now = SystemClock::ElapsedRealtime());
+
+  // Records a frame of |bytes| that took |latency| to send or receive. If
+  // |more_expected|, the frame is a chunk of a payload that is not done yet,
+  // and the link counts as stalled if no other frame follows within the
+  // stall timeout.
+  void OnFrame(std::int64_t bytes, absl::Duration latency, bool more_expected,
+               absl::Time now = SystemClock::ElapsedRealtime());
+
+  Snapshot GetSnapshot(absl::Time now = SystemClock::ElapsedRealtime()) const;
+
+ private:
+  static constexpr std::int64_t kNever = -1;
+
+  struct Bucket {
+    // Index of the time slice the bucket holds, or kNever.
+    std::atomic<std::int64_t> slice{kNever};
+    std::atomic<std::int64_t> bytes{0};
+  };
+
+  static int GetLatencyBucket(absl::Duration latency);
+  absl::Duration GetLatencyPercentile(double percentile) const;
+
+  const std::int64_t bucket_micros_;
+  const absl::Duration stall_timeout_;
+
+  std::array<Bucket, kWindowBuckets> window_;
+  std::array<std::atomic<std::int64_t>, kLatencyBuckets> latencies_{};
+  std::atomic<std::int64_t> frames_{0};
+  std::atomic<std::int64_t> bytes_{0};
+  // The sum of the frame latencies.
+  std::atomic<std::int64_t> busy_micros_{0};
+  // Unix micros, or kNever.
+  std::atomic<std::int64_t> first_frame_at_{kNever};
+  std::atomic<std::int64_t> last_frame_at_{kNever};
+  std::atomic<std::int64_t> frame_started_at_{kNever};
+  std::atomic<bool> more_expected_{false};
+};
+
+// Owns the LinkThroughputRecorders of all endpoints, per medium and direction.
+// Looking up a recorder takes a lock; recording into it does not.
+class LinkThroughputRegistry {
+ public:
+  LinkThroughputRegistry(absl::Duration window, absl::Duration stall_timeout)
+      : window_(window), stall_timeout_(stall_timeout) {}
+
+  // Returns the recorder of |endpoint_id| for |medium| and |direction|,
+  // creating it on first use.
+  std::shared_ptr<LinkThroughputRecorder> GetRecorder(
+      const std::string& endpoint_id,
+      location::nearby::proto::connections::Medium medium,
+      connections::PayloadDirection direction) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the statistics of |endpoint_id| for |medium| and |direction|, or
+  // nothing if GetRecorder() was never called for them.
+  std::optional<LinkThroughputRecorder::Snapshot> GetSnapshot(
+      const std::string& endpoint_id,
+      location::nearby::proto::connections::Medium medium,
+      connections::PayloadDirection direction) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the statistics of every medium |endpoint_id| used in |direction|.
+  std::vector<std::pair<location::nearby::proto::connections::Medium,
+                        LinkThroughputRecorder::Snapshot>>
+  GetSnapshots(const std::string& endpoint_id,
+               connections::PayloadDirection direction)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Forgets all recorders of |endpoint_id|.
+  void RemoveEndpoint(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  using Key =
+      std::tuple<std::string, location::nearby::proto::connections::Medium,
+                 connections::PayloadDirection>;
+
+  const absl::Duration window_;
+  const absl::Duration stall_timeout_;
+
+  Mutex mutex_;
+  absl::flat_hash_map<Key, std::shared_ptr<LinkThroughputRecorder>> recorders_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace analytics
+}  // namespace nearby
+
+#endif  // ANALYTICS_LINK_THROUGHPUT_RECORDER_H_
@@ -0,0 +1,167 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/analytics/link_throughput_recorder.h"
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "connections/payload_type.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace analytics {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+using ::nearby::connections::PayloadDirection;
+
+constexpr absl::Duration kWindow = absl::Seconds(2);
+constexpr absl::Duration kStallTimeout = absl::Seconds(1);
+
+const absl::Time kStart = absl::FromUnixSeconds(1000);
+
+TEST(LinkThroughputRecorderTest, EmptyRecorderReportsNothing) {
+  LinkThroughputRecorder recorder(kWindow, kStallTimeout);
+
+  LinkThroughputRecorder::Snapshot snapshot = recorder.GetSnapshot(kStart);
+
+  EXPECT_EQ(snapshot.frames, 0);
+  EXPECT_EQ(snapshot.bytes_per_second, 0);
+  EXPECT_EQ(snapshot.chunk_latency_p50, absl::ZeroDuration());
+  EXPECT_FALSE(snapshot.stalled);
+}
+
+TEST(LinkThroughputRecorderTest, ThroughputCoversSlidingWindow) {
+  LinkThroughputRecorder recorder(kWindow, kStallTimeout);
+  // 10 KB every 100ms for 4 seconds is 100 KB/s.
+  for (int i = 0; i < 40; ++i) {
+    recorder.OnFrame(10 * 1024, absl::Milliseconds(1), true,
+                     kStart + i * absl::Milliseconds(100));
+  }
+
+  LinkThroughputRecorder::Snapshot snapshot =
+      recorder.GetSnapshot(kStart + absl::Milliseconds(3950));
+  EXPECT_EQ(snapshot.frames, 40);
+  EXPECT_EQ(snapshot.bytes, 40 * 10 * 1024);
+  EXPECT_NEAR(snapshot.bytes_per_second, 100 * 1024, 10 * 1024);
+  // 10 KB per millisecond of frame latency.
+  EXPECT_EQ(snapshot.active_bytes_per_second, 10 * 1024 * 1000);
+
+  // Nothing was sent in the last window.
+  snapshot = recorder.GetSnapshot(kStart + absl::Seconds(10));
+  EXPECT_EQ(snapshot.bytes_per_second, 0);
+  EXPECT_EQ(snapshot.bytes, 40 * 10 * 1024);
+}
+
+TEST(LinkThroughputRecorderTest, ThroughputOfYoungLinkUsesItsAge) {
+  LinkThroughputRecorder recorder(kWindow, kStallTimeout);
+  recorder.OnFrame(1000, absl::Milliseconds(1), false, kStart);
+  recorder.OnFrame(1000, absl::Milliseconds(1), false,
+                   kStart + absl::Milliseconds(500));
+
+  EXPECT_EQ(recorder.GetSnapshot(kStart + absl::Milliseconds(500))
+                .bytes_per_second,
+            4000);
+}
+
+TEST(LinkThroughputRecorderTest, ReportsChunkLatencyPercentiles) {
+  LinkThroughputRecorder recorder(kWindow, kStallTimeout);
+  for (int i = 0; i < 90; ++i) {
+    recorder.OnFrame(1024, absl::Milliseconds(10), true, kStart);
+  }
+  for (int i = 0; i < 10; ++i) {
+    recorder.OnFrame(1024, absl::Milliseconds(200), true, kStart);
+  }
+
+  LinkThroughputRecorder::Snapshot snapshot = recorder.GetSnapshot(kStart);
+  EXPECT_GE(snapshot.chunk_latency_p50, absl::Milliseconds(10));
+  EXPECT_LE(snapshot.chunk_latency_p50, absl::Milliseconds(13));
+  EXPECT_GE(snapshot.chunk_latency_p95, absl::Milliseconds(200));
+  EXPECT_LE(snapshot.chunk_latency_p95, absl::Milliseconds(250));
+}
+
+TEST(LinkThroughputRecorderTest, DetectsPayloadWaitingForNextChunk) {
+  LinkThroughputRecorder recorder(kWindow, kStallTimeout);
+  recorder.OnFrame(1024, absl::Milliseconds(1), true, kStart);
+
+  EXPECT_FALSE(
+      recorder.GetSnapshot(kStart + absl::Milliseconds(500)).stalled);
+  LinkThroughputRecorder::Snapshot snapshot =
+      recorder.GetSnapshot(kStart + absl::Seconds(2));
+  EXPECT_TRUE(snapshot.stalled);
+  EXPECT_EQ(snapshot.idle_for, absl::Seconds(2));
+
+  // The last chunk leaves the link idle rather than stalled.
+  recorder.OnFrame(1024, absl::Milliseconds(1), false,
+                   kStart + absl::Seconds(2));
+  EXPECT_FALSE(recorder.GetSnapshot(kStart + absl::Seconds(10)).stalled);
+}
+
+TEST(LinkThroughputRecorderTest, DetectsFrameStuckInFlight) {
+  LinkThroughputRecorder recorder(kWindow, kStallTimeout);
+  recorder.OnFrameStarted(kStart);
+
+  EXPECT_FALSE(
+      recorder.GetSnapshot(kStart + absl::Milliseconds(500)).stalled);
+  EXPECT_TRUE(recorder.GetSnapshot(kStart + absl::Seconds(1)).stalled);
+
+  recorder.OnFrame(1024, absl::Seconds(1), false, kStart + absl::Seconds(1));
+  EXPECT_FALSE(recorder.GetSnapshot(kStart + absl::Seconds(1)).stalled);
+}
+
+TEST(LinkThroughputRegistryTest, KeepsRecordersPerEndpointMediumDirection) {
+  LinkThroughputRegistry registry(kWindow, kStallTimeout);
+  std::shared_ptr<LinkThroughputRecorder> recorder = registry.GetRecorder(
+      "ABCD", Medium::WIFI_LAN, PayloadDirection::OUTGOING_PAYLOAD);
+  recorder->OnFrame(1024, absl::Milliseconds(1), false);
+
+  EXPECT_EQ(registry.GetRecorder("ABCD", Medium::WIFI_LAN,
+                                 PayloadDirection::OUTGOING_PAYLOAD),
+            recorder);
+  EXPECT_NE(registry.GetRecorder("ABCD", Medium::BLUETOOTH,
+                                 PayloadDirection::OUTGOING_PAYLOAD),
+            recorder);
+  std::optional<LinkThroughputRecorder::Snapshot> snapshot =
+      registry.GetSnapshot("ABCD", Medium::WIFI_LAN,
+                           PayloadDirection::OUTGOING_PAYLOAD);
+  ASSERT_TRUE(snapshot.has_value());
+  EXPECT_EQ(snapshot->bytes, 1024);
+  EXPECT_FALSE(registry
+                   .GetSnapshot("ABCD", Medium::WIFI_LAN,
+                                PayloadDirection::INCOMING_PAYLOAD)
+                   .has_value());
+
+  std::vector<std::pair<Medium, LinkThroughputRecorder::Snapshot>> snapshots =
+      registry.GetSnapshots("ABCD", PayloadDirection::OUTGOING_PAYLOAD);
+  ASSERT_EQ(snapshots.size(), 2);
+  EXPECT_EQ(snapshots[0].first == Medium::WIFI_LAN
+                ? snapshots[0].second.bytes
+                : snapshots[1].second.bytes,
+            1024);
+
+  registry.RemoveEndpoint("ABCD");
+  EXPECT_FALSE(registry
+                   .GetSnapshot("ABCD", Medium::WIFI_LAN,
+                                PayloadDirection::OUTGOING_PAYLOAD)
+                   .has_value());
+}
+
+}  // namespace
+}  // namespace analytics
+}  // namespace nearby
@@ -30,6 +30,8 @@ struct PacketMetaData {
   absl::Time file_io_end_time;
   absl::Time encryption_start_time;
   absl::Time encryption_end_time;
+  absl::Time decryption_start_time;
+  absl::Time decryption_end_time;
   absl::Time socket_io_start_time;
   absl::Time socket_io_end_time;
 
@@ -64,6 +66,14 @@ struct PacketMetaData {
     encryption_end_time = SystemClock::ElapsedRealtime();
   }
 
+  void StartDecryption() {
+    decryption_start_time = SystemClock::ElapsedRealtime();
+  }
+
+  void StopDecryption() {
+    decryption_end_time = SystemClock::ElapsedRealtime();
+  }
+
   void StartSocketIo() {
     socket_io_start_time = SystemClock::ElapsedRealtime();
   }
@@ -80,6 +90,14 @@ struct PacketMetaData {
     return 0L;
   }
 
+  int64_t GetDecryptionTimeInMillis() {
+    if (decryption_end_time > decryption_start_time) {
+      return absl::ToInt64Milliseconds(decryption_end_time -
+                                       decryption_start_time);
+    }
+    return 0L;
+  }
+
   int64_t GetFileIoTimeInMillis() {
     if (file_io_end_time > file_io_start_time) {
       return absl::ToInt64Milliseconds(file_io_end_time - file_io_start_time);
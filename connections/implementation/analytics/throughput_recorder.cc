@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <new>
 #include <ostream>
 #include <string>
@@ -107,6 +108,13 @@ bool ThroughputRecorder::Stop() {
 
     throughputs_.clear();
 
+    if (chunk_size_ > 0) {
+      NEARBY_LOGS(INFO) << "Adaptive chunk size for payload_id:" << payload_id_
+                        << " ranged from " << min_chunk_size_ << " to "
+                        << max_chunk_size_ << " bytes, last " << chunk_size_
+                        << " bytes";
+    }
+
     int64_t total_millis =
         absl::ToInt64Milliseconds(stop_timestamp - start_timestamp_);
     throughput_kbps_ = CalculateThroughputKBps(total_byte_size, total_millis);
@@ -143,6 +151,23 @@ void ThroughputRecorder::MarkAsSuccess() {
   success_ = true;
 }
 
+void ThroughputRecorder::OnChunkSizeChanged(int chunk_size) {
+  MutexLock lock(&mutex_);
+  if (chunk_size_ == 0) {
+    min_chunk_size_ = chunk_size;
+    max_chunk_size_ = chunk_size;
+  } else {
+    min_chunk_size_ = std::min(min_chunk_size_, chunk_size);
+    max_chunk_size_ = std::max(max_chunk_size_, chunk_size);
+  }
+  chunk_size_ = chunk_size;
+}
+
+int ThroughputRecorder::GetChunkSize() {
+  MutexLock lock(&mutex_);
+  return chunk_size_;
+}
+
 int ThroughputRecorder::CalculateThroughputKBps(int64_t total_byte_size,
                                                 int64_t total_millis) {
   if (total_millis > 0) {
@@ -244,18 +269,20 @@ void ThroughputRecorder::OnFrameReceived(Medium medium,
   }
 
   // Add packetLostAlarm process later
-  duration_millis_ = packetMetaData.GetEncryptionTimeInMillis() +
+  duration_millis_ = packetMetaData.GetDecryptionTimeInMillis() +
                      packetMetaData.GetFileIoTimeInMillis() +
                      packetMetaData.GetSocketIoTimeInMillis();
   GetThroughput(medium, duration_millis_)
       .Add(packetMetaData.packet_size, packetMetaData.GetFileIoTimeInMillis(),
-           packetMetaData.GetEncryptionTimeInMillis(),
+           packetMetaData.GetDecryptionTimeInMillis(),
            packetMetaData.GetSocketIoTimeInMillis());
   CalculateDurationTimes(packetMetaData);
 }
 
 void ThroughputRecorder::CalculateDurationTimes(PacketMetaData packetMetaData) {
-  encryption_time_ += packetMetaData.GetEncryptionTimeInMillis();
+  // Frames are either sent or received, so only one of these is set.
+  encryption_time_ += packetMetaData.GetEncryptionTimeInMillis() +
+                      packetMetaData.GetDecryptionTimeInMillis();
   socket_io_time_ += packetMetaData.GetSocketIoTimeInMillis();
   file_io_time_ += packetMetaData.GetFileIoTimeInMillis();
 }
@@ -88,6 +88,10 @@ class ThroughputRecorder {
   void OnFrameSent(Medium medium, PacketMetaData& packetMetaData);
   void OnFrameReceived(Medium medium, PacketMetaData& packetMetaData);
   void MarkAsSuccess();
+  // Records the chunk size picked for the payload by the adaptive chunk
+  // sizing. GetChunkSize() returns the latest one, or 0 if none was recorded.
+  void OnChunkSizeChanged(int chunk_size) ABSL_LOCKS_EXCLUDED(mutex_);
+  int GetChunkSize() ABSL_LOCKS_EXCLUDED(mutex_);
 
  private:
   void CalculateDurationTimes(PacketMetaData packetMetaData);
@@ -106,6 +110,9 @@ class ThroughputRecorder {
   int64_t socket_io_time_ = 0;
   int64_t duration_millis_ = 0;
   int throughput_kbps_ = 0;
+  int chunk_size_ = 0;
+  int min_chunk_size_ = 0;
+  int max_chunk_size_ = 0;
 };
 
 class ThroughputRecorderContainer {
@@ -206,16 +206,16 @@ TEST_F(ThroughputRecorderTest, OnFrameReceivedCheckDurationMillis) {
   packet_meta_data.StartFileIo();
   absl::SleepFor(absl::Milliseconds(5));
   packet_meta_data.StopFileIo();
-  packet_meta_data.StartEncryption();
+  packet_meta_data.StartDecryption();
   absl::SleepFor(absl::Milliseconds(6));
-  packet_meta_data.StopEncryption();
+  packet_meta_data.StopDecryption();
   packet_meta_data.StartSocketIo();
   absl::SleepFor(absl::Milliseconds(7));
   packet_meta_data.StopSocketIo();
   TPRecorder->OnFrameReceived(location::nearby::proto::connections::BLE,
                               packet_meta_data);
   EXPECT_EQ(TPRecorder->GetDurationMillis(),
-            packet_meta_data.GetEncryptionTimeInMillis() +
+            packet_meta_data.GetDecryptionTimeInMillis() +
                 packet_meta_data.GetFileIoTimeInMillis() +
                 packet_meta_data.GetSocketIoTimeInMillis());
 }
@@ -228,6 +228,17 @@ TEST_F(ThroughputRecorderTest, OnTPRecorderNotStarted) {
   EXPECT_FALSE(throughput.dump());
 }
 
+TEST_F(ThroughputRecorderTest, OnChunkSizeChangedKeepsLatest) {
+  auto TPRecorder = tp_recorder_container_.GetTPRecorder(
+      kPayloadIdA, PayloadDirection::OUTGOING_PAYLOAD);
+  EXPECT_EQ(TPRecorder->GetChunkSize(), 0);
+
+  TPRecorder->OnChunkSizeChanged(64 * 1024);
+  TPRecorder->OnChunkSizeChanged(16 * 1024);
+
+  EXPECT_EQ(TPRecorder->GetChunkSize(), 16 * 1024);
+}
+
 }  // namespace
 }  // namespace analytics
 }  // namespace nearby
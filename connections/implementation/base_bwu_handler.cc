@@ -79,6 +79,13 @@ void BaseBwuHandler::RevertResponderState(const std::string& service_id) {
   HandleRevertInitiatorStateForService(service_id);
 }
 
+bool BaseBwuHandler::IsInitiatingUpgradeForService(
+    const std::string& upgrade_service_id) const {
+  auto it = upgrade_service_id_to_active_endpoint_ids_.find(upgrade_service_id);
+  return it != upgrade_service_id_to_active_endpoint_ids_.end() &&
+         !it->second.empty();
+}
+
 void BaseBwuHandler::NotifyOnIncomingConnection(
     ClientProxy* client, std::unique_ptr<IncomingSocketConnection> connection) {
   if (!incoming_connection_callback_) {
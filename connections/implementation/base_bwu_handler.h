@@ -56,6 +56,11 @@ class BaseBwuHandler : public BwuHandler {
   virtual void HandleRevertInitiatorStateForService(
       const std::string& upgrade_service_id) = 0;
 
+  // Returns whether an endpoint initiated a bandwidth upgrade through
+  // |upgrade_service_id| that hasn't been reverted yet.
+  bool IsInitiatingUpgradeForService(
+      const std::string& upgrade_service_id) const;
+
   // Notifies the caller about incoming connection.
   void NotifyOnIncomingConnection(
       ClientProxy* client,
@@ -25,13 +25,17 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
 #include "connections/implementation/endpoint_channel_manager.h"
+#include "connections/implementation/frame_read_ahead.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/implementation/offline_frames.h"
 #include "internal/flags/nearby_flags.h"
+#include "internal/platform/buffered_frame_reader.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/implementation/system_clock.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/logging.h"
@@ -47,18 +51,6 @@ using ::location::nearby::analytics::proto::ConnectionsLog;
 using DisconnectionReason =
     ::location::nearby::proto::connections::DisconnectionReason;
 
-std::int32_t BytesToInt(const ByteArray& bytes) {
-  const char* int_bytes = bytes.data();
-
-  std::int32_t result = 0;
-  result |= (static_cast<std::int32_t>(int_bytes[0]) & 0x0FF) << 24;
-  result |= (static_cast<std::int32_t>(int_bytes[1]) & 0x0FF) << 16;
-  result |= (static_cast<std::int32_t>(int_bytes[2]) & 0x0FF) << 8;
-  result |= (static_cast<std::int32_t>(int_bytes[3]) & 0x0FF);
-
-  return result;
-}
-
 ByteArray IntToBytes(std::int32_t value) {
   char int_bytes[sizeof(std::int32_t)];
   int_bytes[0] = static_cast<char>((value >> 24) & 0x0FF);
@@ -69,16 +61,19 @@ ByteArray IntToBytes(std::int32_t value) {
   return ByteArray(int_bytes, sizeof(int_bytes));
 }
 
-ExceptionOr<std::int32_t> ReadInt(InputStream* reader) {
-  ExceptionOr<ByteArray> read_bytes = reader->ReadExactly(sizeof(std::int32_t));
-  if (!read_bytes.ok()) {
-    return ExceptionOr<std::int32_t>(read_bytes.exception());
-  }
-  return ExceptionOr<std::int32_t>(BytesToInt(std::move(read_bytes.result())));
+// Writes the 4-byte length prefix and |body| as a single gather write, so
+// transports that support it send the frame in one operation.
+Exception WriteFrame(OutputStream* writer, const ByteArray& body) {
+  ByteArray header = IntToBytes(static_cast<std::int32_t>(body.size()));
+  const ByteArray* buffers[] = {&header, &body};
+  return writer->Writev(buffers);
 }
 
-Exception WriteInt(OutputStream* writer, std::int32_t value) {
-  return writer->Write(IntToBytes(value));
+std::unique_ptr<BufferedFrameReader> CreateBufferedReader(InputStream* reader) {
+  std::uint32_t buffer_size =
+      FeatureFlags::GetInstance().GetFlags().endpoint_channel_read_buffer_size;
+  if (reader == nullptr || buffer_size == 0) return nullptr;
+  return std::make_unique<BufferedFrameReader>(reader, buffer_size);
 }
 
 }  // namespace
@@ -111,8 +106,12 @@ BaseEndpointChannel::BaseEndpointChannel(
       channel_name_(channel_name),
       max_allowed_read_bytes_(GetMaxAllowedReadBytes()),
       default_max_transmit_packet_size_(GetDefaultMaxTransmitPacketSize()),
-      reader_(reader),
+      buffered_reader_(CreateBufferedReader(reader)),
+      reader_(buffered_reader_ != nullptr ? buffered_reader_.get() : reader),
       writer_(writer),
+      read_ahead_max_frames_(FeatureFlags::GetInstance()
+                                 .GetFlags()
+                                 .endpoint_channel_read_ahead_max_frames),
       technology_(technology),
       band_(band),
       frequency_(frequency),
@@ -125,82 +124,110 @@ ExceptionOr<ByteArray> BaseEndpointChannel::Read() {
 
 ExceptionOr<ByteArray> BaseEndpointChannel::Read(
     PacketMetaData& packet_meta_data) {
-  ByteArray result;
-  {
-    MutexLock lock(&reader_mutex_);
-
-    packet_meta_data.StartSocketIo();
-    ExceptionOr<std::int32_t> read_int = ReadInt(reader_);
-    if (!read_int.ok()) {
-      return ExceptionOr<ByteArray>(read_int.exception());
-    }
-
-    if (read_int.result() < 0 || read_int.result() > max_allowed_read_bytes_) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Read an invalid number of bytes: "
-                           << read_int.result();
-      return ExceptionOr<ByteArray>(Exception::kIo);
+  ExceptionOr<ByteArray> result;
+  std::shared_ptr<FrameReadAhead> read_ahead = GetReadAhead();
+  if (read_ahead != nullptr) {
+    // Taking the next frame and decrypting it under one lock keeps frames in
+    // order if Read() is called from several threads, while the read-ahead
+    // thread reads the frames that follow.
+    MutexLock lock(&read_order_mutex_);
+    result = read_ahead->Pop(packet_meta_data);
+    if (result.ok()) {
+      result = DecryptFrame(std::move(result.result()), packet_meta_data);
     }
-
-    ExceptionOr<ByteArray> read_bytes = reader_->ReadExactly(read_int.result());
-    if (!read_bytes.ok()) {
-      return read_bytes;
+  } else {
+    result = ReadFrame(packet_meta_data);
+    if (result.ok()) {
+      result = DecryptFrame(std::move(result.result()), packet_meta_data);
     }
-    packet_meta_data.StopSocketIo();
-    packet_meta_data.SetPacketSize(read_int.result() + sizeof(std::int32_t));
-    result = std::move(read_bytes.result());
+  }
+  if (!result.ok()) {
+    return result;
   }
 
   {
-    MutexLock crypto_lock(&crypto_mutex_);
-    Exception message_exception{Exception::kInvalidProtocolBuffer};
-    if (IsEncryptionEnabledLocked()) {
-      // If encryption is enabled, decode the message.
-      std::string input(std::move(result));
-      packet_meta_data.StartEncryption();
-      std::unique_ptr<std::string> decrypted_data =
-          crypto_context_->DecodeMessageFromPeer(input);
-      if (decrypted_data) {
-        result = ByteArray(std::move(*decrypted_data));
-      } else {
-        // It could be a protocol race, where remote party sends a KEEP_ALIVE
-        // before encryption is setup on their side, and we receive it after
-        // we switched to encryption mode.
-        // In this case, we verify that message is indeed a valid KEEP_ALIVE,
-        // and let it through if it is, otherwise message is erased.
-        // TODO(apolyudov): verify this happens at most once per session.
-        result = {};
-        auto parsed = parser::FromBytes(ByteArray(input));
-        if (parsed.ok()) {
-          if (parser::GetFrameType(parsed.result()) ==
-              location::nearby::connections::V1Frame::KEEP_ALIVE) {
-            NEARBY_LOGS(INFO)
-                << __func__
-                << ": Read unencrypted KEEP_ALIVE on encrypted channel.";
-            result = ByteArray(input);
-          } else {
-            NEARBY_LOGS(WARNING)
-                << __func__ << ": Read unexpected unencrypted frame of type "
-                << parser::GetFrameType(parsed.result());
-          }
+    MutexLock lock(&last_read_mutex_);
+    last_read_timestamp_ = SystemClock::ElapsedRealtime();
+  }
+  return result;
+}
+
+ExceptionOr<ByteArray> BaseEndpointChannel::ReadFrame(
+    PacketMetaData& packet_meta_data) {
+  MutexLock lock(&reader_mutex_);
+
+  packet_meta_data.StartSocketIo();
+  // Message-oriented readers hand out a frame that arrived as one message
+  // as is, without splitting off the length first.
+  ExceptionOr<ByteArray> read_bytes =
+      reader_->ReadLengthPrefixedFrame(max_allowed_read_bytes_);
+  if (!read_bytes.ok()) {
+    return read_bytes;
+  }
+  packet_meta_data.StopSocketIo();
+  packet_meta_data.SetPacketSize(read_bytes.result().size() +
+                                 sizeof(std::int32_t));
+  return read_bytes;
+}
+
+std::shared_ptr<FrameReadAhead> BaseEndpointChannel::GetReadAhead() {
+  if (read_ahead_max_frames_ == 0) return nullptr;
+  MutexLock lock(&read_ahead_mutex_);
+  if (read_ahead_ == nullptr && !read_ahead_stopped_) {
+    read_ahead_ = std::make_shared<FrameReadAhead>(
+        [this](PacketMetaData& packet_meta_data) {
+          return ReadFrame(packet_meta_data);
+        },
+        read_ahead_max_frames_);
+  }
+  return read_ahead_;
+}
+
+ExceptionOr<ByteArray> BaseEndpointChannel::DecryptFrame(
+    ByteArray result, PacketMetaData& packet_meta_data) {
+  MutexLock crypto_lock(&crypto_mutex_);
+  Exception message_exception{Exception::kInvalidProtocolBuffer};
+  if (IsEncryptionEnabledLocked()) {
+    // If encryption is enabled, decode the message.
+    std::string input(std::move(result));
+    packet_meta_data.StartDecryption();
+    std::unique_ptr<std::string> decrypted_data = DecodeLocked(input);
+    if (decrypted_data) {
+      result = ByteArray(std::move(*decrypted_data));
+    } else {
+      // It could be a protocol race, where remote party sends a KEEP_ALIVE
+      // before encryption is setup on their side, and we receive it after
+      // we switched to encryption mode.
+      // In this case, we verify that message is indeed a valid KEEP_ALIVE,
+      // and let it through if it is, otherwise message is erased.
+      // TODO(apolyudov): verify this happens at most once per session.
+      result = {};
+      auto parsed = parser::FromBytes(ByteArray(input));
+      if (parsed.ok()) {
+        if (parser::GetFrameType(parsed.result()) ==
+            location::nearby::connections::V1Frame::KEEP_ALIVE) {
+          NEARBY_LOGS(INFO)
+              << __func__
+              << ": Read unencrypted KEEP_ALIVE on encrypted channel.";
+          result = ByteArray(input);
         } else {
-          message_exception.value = parsed.exception();
           NEARBY_LOGS(WARNING)
-              << __func__ << ": Unable to parse data as unencrypted message.";
+              << __func__ << ": Read unexpected unencrypted frame of type "
+              << parser::GetFrameType(parsed.result());
         }
-      }
-      packet_meta_data.StopEncryption();
-      if (result.Empty()) {
-        NEARBY_LOGS(WARNING) << __func__ << ": Unable to parse read result.";
-        return ExceptionOr<ByteArray>(message_exception);
+      } else {
+        message_exception.value = parsed.exception();
+        NEARBY_LOGS(WARNING)
+            << __func__ << ": Unable to parse data as unencrypted message.";
       }
     }
+    packet_meta_data.StopDecryption();
+    if (result.Empty()) {
+      NEARBY_LOGS(WARNING) << __func__ << ": Unable to parse read result.";
+      return ExceptionOr<ByteArray>(message_exception);
+    }
   }
-
-  {
-    MutexLock lock(&last_read_mutex_);
-    last_read_timestamp_ = SystemClock::ElapsedRealtime();
-  }
-  return ExceptionOr<ByteArray>(result);
+  return ExceptionOr<ByteArray>(std::move(result));
 }
 
 Exception BaseEndpointChannel::Write(const ByteArray& data) {
@@ -217,60 +244,39 @@ Exception BaseEndpointChannel::Write(const ByteArray& data,
     }
   }
 
-  ByteArray encrypted_data;
-  const ByteArray* data_to_write = &data;
+  std::shared_ptr<EndpointChannel> successor;
   {
     // Holding both mutexes is necessary to prevent the keep alive and payload
     // threads from writing encrypted messages out of order which causes a
     // failure to decrypt on the reader side. However we need to release the
     // crypto lock after encrypting to ensure read decryption is not blocked.
     MutexLock lock(&writer_mutex_);
-    {
-      MutexLock crypto_lock(&crypto_mutex_);
-      if (IsEncryptionEnabledLocked()) {
-        // If encryption is enabled, encode the message.
-        packet_meta_data.StartEncryption();
-        std::unique_ptr<std::string> encrypted =
-            crypto_context_->EncodeMessageToPeer(std::string(data));
-        packet_meta_data.StopEncryption();
-        if (!encrypted) {
-          NEARBY_LOGS(WARNING) << __func__ << ": Failed to encrypt data.";
-          return {Exception::kIo};
-        }
-        encrypted_data = ByteArray(std::move(*encrypted));
-        data_to_write = &encrypted_data;
-      }
+    successor = write_successor_;
+    if (successor == nullptr) {
+      Exception write_exception = WriteLocked(data, packet_meta_data);
+      if (write_exception.Raised()) return write_exception;
     }
+  }
+  if (successor != nullptr) {
+    // This channel was handed off in a bandwidth upgrade.
+    return successor->Write(data, packet_meta_data);
+  }
 
-    size_t data_size = data_to_write->size();
-    if (data_size < 0 || data_size > max_allowed_read_bytes_) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Write an invalid number of bytes: "
-                           << data_size;
-      return {Exception::kIo};
-    }
+  {
+    MutexLock lock(&last_write_mutex_);
+    last_write_timestamp_ = SystemClock::ElapsedRealtime();
+  }
+  return {Exception::kSuccess};
+}
 
-    packet_meta_data.StartSocketIo();
-    Exception write_exception =
-        WriteInt(writer_, static_cast<std::int32_t>(data_size));
-    if (write_exception.Raised()) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Failed to write header: "
-                           << write_exception.value;
-      return write_exception;
-    }
-    write_exception = writer_->Write(*data_to_write);
-    if (write_exception.Raised()) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Failed to write data: "
-                           << write_exception.value;
-      return write_exception;
-    }
-    Exception flush_exception = writer_->Flush();
-    if (flush_exception.Raised()) {
-      NEARBY_LOGS(WARNING) << __func__ << ": Failed to flush writer: "
-                           << flush_exception.value;
-      return flush_exception;
-    }
-    packet_meta_data.StopSocketIo();
-    packet_meta_data.SetPacketSize(data_size + sizeof(std::uint32_t));
+Exception BaseEndpointChannel::WriteAndHandOff(
+    const ByteArray& last_frame, std::shared_ptr<EndpointChannel> successor) {
+  {
+    MutexLock lock(&writer_mutex_);
+    PacketMetaData packet_meta_data;
+    Exception write_exception = WriteLocked(last_frame, packet_meta_data);
+    if (write_exception.Raised()) return write_exception;
+    write_successor_ = std::move(successor);
   }
 
   {
@@ -280,6 +286,52 @@ Exception BaseEndpointChannel::Write(const ByteArray& data,
   return {Exception::kSuccess};
 }
 
+Exception BaseEndpointChannel::WriteLocked(const ByteArray& data,
+                                           PacketMetaData& packet_meta_data) {
+  ByteArray encrypted_data;
+  const ByteArray* data_to_write = &data;
+  {
+    MutexLock crypto_lock(&crypto_mutex_);
+    if (IsEncryptionEnabledLocked()) {
+      // If encryption is enabled, encode the message.
+      packet_meta_data.StartEncryption();
+      std::unique_ptr<std::string> encrypted =
+          EncodeLocked(data.AsStringRef());
+      packet_meta_data.StopEncryption();
+      if (!encrypted) {
+        NEARBY_LOGS(WARNING) << __func__ << ": Failed to encrypt data.";
+        return {Exception::kIo};
+      }
+      encrypted_data = ByteArray(std::move(*encrypted));
+      data_to_write = &encrypted_data;
+    }
+  }
+
+  size_t data_size = data_to_write->size();
+  if (data_size < 0 || data_size > max_allowed_read_bytes_) {
+    NEARBY_LOGS(WARNING) << __func__ << ": Write an invalid number of bytes: "
+                         << data_size;
+    return {Exception::kIo};
+  }
+
+  packet_meta_data.StartSocketIo();
+  Exception write_exception = WriteFrame(writer_, *data_to_write);
+  if (write_exception.Raised()) {
+    NEARBY_LOGS(WARNING) << __func__ << ": Failed to write frame: "
+                         << write_exception.value;
+    return write_exception;
+  }
+  Exception flush_exception = writer_->Flush();
+  if (flush_exception.Raised()) {
+    NEARBY_LOGS(WARNING) << __func__ << ": Failed to flush writer: "
+                         << flush_exception.value;
+    return flush_exception;
+  }
+  packet_meta_data.StopSocketIo();
+  packet_meta_data.SetPacketSize(data_size + sizeof(std::uint32_t));
+  return {Exception::kSuccess};
+}
+
 void BaseEndpointChannel::Close() {
   {
     // In case channel is paused, resume it first thing.
@@ -292,6 +344,17 @@ void BaseEndpointChannel::Close() {
     UnblockPausedWriter();
   }
   CloseIo();
+  std::shared_ptr<FrameReadAhead> read_ahead;
+  {
+    MutexLock lock(&read_ahead_mutex_);
+    read_ahead_stopped_ = true;
+    read_ahead = read_ahead_;
+  }
+  // The reader is closed, so a read in progress returns and the read-ahead
+  // thread can exit.
+  if (read_ahead != nullptr) {
+    read_ahead->Shutdown();
+  }
   CloseImpl();
 }
 
@@ -379,9 +442,18 @@ void BaseEndpointChannel::EnableEncryption(
   crypto_context_ = context;
 }
 
+void BaseEndpointChannel::EnableAeadRecordLayer(
+    std::shared_ptr<AeadRecordLayer> record_layer) {
+  MutexLock crypto_lock(&crypto_mutex_);
+  record_layer_ = std::move(record_layer);
+}
+
 void BaseEndpointChannel::DisableEncryption() {
+  MutexLock lock(&writer_mutex_);
+  write_successor_.reset();
   MutexLock crypto_lock(&crypto_mutex_);
   crypto_context_.reset();
+  record_layer_.reset();
 }
 
 bool BaseEndpointChannel::IsEncrypted() {
@@ -395,7 +467,7 @@ ExceptionOr<ByteArray> BaseEndpointChannel::TryDecrypt(const ByteArray& data) {
     return Exception::kFailed;
   }
   std::unique_ptr<std::string> decrypted_data =
-      crypto_context_->DecodeMessageFromPeer(data.string_data());
+      DecodeLocked(data.string_data());
   if (decrypted_data) {
     return ExceptionOr<ByteArray>(ByteArray(std::move(*decrypted_data)));
   }
@@ -446,17 +518,16 @@ int BaseEndpointChannel::GetFrequency() const { return frequency_; }
 int BaseEndpointChannel::GetTryCount() const { return try_count_; }
 
 int BaseEndpointChannel::GetMaxAllowedReadBytes() const {
-  int64_t max_allowed_read_bytes = NearbyFlags::GetInstance().GetInt64Flag(
-      config_package_nearby::nearby_connections_feature::
-          kMediumMaxAllowedReadBytes);
+  int64_t max_allowed_read_bytes =
+      NearbyFlags::Get<config_package_nearby::nearby_connections_feature::
+                           kMediumMaxAllowedReadBytes>();
   return max_allowed_read_bytes >= INT_MAX ? INT_MAX : max_allowed_read_bytes;
 }
 
 int BaseEndpointChannel::GetDefaultMaxTransmitPacketSize() const {
   int32_t default_max_transmit_packet_size =
-      NearbyFlags::GetInstance().GetInt64Flag(
-          config_package_nearby::nearby_connections_feature::
-              kMediumDefaultMaxTransmitPacketSize);
+      NearbyFlags::Get<config_package_nearby::nearby_connections_feature::
+                           kMediumDefaultMaxTransmitPacketSize>();
   return default_max_transmit_packet_size >= INT_MAX
              ? INT_MAX
              : default_max_transmit_packet_size;
@@ -466,6 +537,22 @@ bool BaseEndpointChannel::IsEncryptionEnabledLocked() const {
   return crypto_context_ != nullptr;
 }
 
+std::unique_ptr<std::string> BaseEndpointChannel::EncodeLocked(
+    const std::string& data) {
+  if (record_layer_ != nullptr) {
+    return record_layer_->Encrypt(data);
+  }
+  return crypto_context_->EncodeMessageToPeer(data);
+}
+
+std::unique_ptr<std::string> BaseEndpointChannel::DecodeLocked(
+    const std::string& data) {
+  if (record_layer_ != nullptr) {
+    return record_layer_->Decrypt(data);
+  }
+  return crypto_context_->DecodeMessageFromPeer(data);
+}
+
 void BaseEndpointChannel::BlockUntilUnpaused() {
   // For more on how this works, see
   // https://docs.oracle.com/javase/tutorial/essential/concurrency/guardmeth.html
@@ -490,7 +577,7 @@ std::unique_ptr<std::string> BaseEndpointChannel::EncodeMessageForTests(
     absl::string_view data) {
   MutexLock lock(&crypto_mutex_);
   DCHECK(IsEncryptionEnabledLocked());
-  return crypto_context_->EncodeMessageToPeer(std::string(data));
+  return EncodeLocked(std::string(data));
 }
 
 }  // namespace connections
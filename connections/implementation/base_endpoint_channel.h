@@ -21,9 +21,12 @@
 #include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
 #include "connections/implementation/endpoint_channel.h"
+#include "connections/implementation/frame_read_ahead.h"
+#include "internal/platform/buffered_frame_reader.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/input_stream.h"
@@ -56,6 +59,9 @@ class BaseEndpointChannel : public EndpointChannel {
   Exception Write(const ByteArray& data) override;
   Exception Write(const ByteArray& data, PacketMetaData& packet_meta_data)
       ABSL_LOCKS_EXCLUDED(writer_mutex_, crypto_mutex_) override;
+  Exception WriteAndHandOff(const ByteArray& last_frame,
+                            std::shared_ptr<EndpointChannel> successor)
+      ABSL_LOCKS_EXCLUDED(writer_mutex_, crypto_mutex_) override;
   void Close() ABSL_LOCKS_EXCLUDED(is_paused_mutex_) override;
   void Close(location::nearby::proto::connections::DisconnectionReason reason)
       override;
@@ -74,7 +80,10 @@ class BaseEndpointChannel : public EndpointChannel {
   int GetTryCount() const override;
   int GetMaxTransmitPacketSize() const override;
   void EnableEncryption(std::shared_ptr<EncryptionContext> context) override;
-  void DisableEncryption() override;
+  void EnableAeadRecordLayer(
+      std::shared_ptr<AeadRecordLayer> record_layer) override;
+  void DisableEncryption()
+      ABSL_LOCKS_EXCLUDED(writer_mutex_, crypto_mutex_) override;
   bool IsEncrypted() override;
   ExceptionOr<ByteArray> TryDecrypt(const ByteArray& data) override;
   bool IsPaused() const ABSL_LOCKS_EXCLUDED(is_paused_mutex_) override;
@@ -99,8 +108,31 @@ class BaseEndpointChannel : public EndpointChannel {
   // Gets the default maximum transmit unit/packet size.
   int GetDefaultMaxTransmitPacketSize() const;
 
+  // Reads one length-prefixed frame from |reader_|.
+  ExceptionOr<ByteArray> ReadFrame(PacketMetaData& packet_meta_data)
+      ABSL_LOCKS_EXCLUDED(reader_mutex_);
+  // Decrypts a frame returned by ReadFrame(), if encryption is enabled.
+  ExceptionOr<ByteArray> DecryptFrame(ByteArray result,
+                                      PacketMetaData& packet_meta_data)
+      ABSL_LOCKS_EXCLUDED(crypto_mutex_);
+  // Returns the read-ahead of this channel, starting it on first use. Returns
+  // nullptr if read-ahead is disabled or the channel was closed.
+  std::shared_ptr<FrameReadAhead> GetReadAhead()
+      ABSL_LOCKS_EXCLUDED(read_ahead_mutex_);
+
+  // Encrypts and writes one frame to |writer_|.
+  Exception WriteLocked(const ByteArray& data, PacketMetaData& packet_meta_data)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(writer_mutex_)
+          ABSL_LOCKS_EXCLUDED(crypto_mutex_);
+
   bool IsEncryptionEnabledLocked() const
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(crypto_mutex_);
+  // Encode/decode with the record layer if there is one, else with the
+  // encryption context. Return nullptr on failure.
+  std::unique_ptr<std::string> EncodeLocked(const std::string& data)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(crypto_mutex_);
+  std::unique_ptr<std::string> DecodeLocked(const std::string& data)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(crypto_mutex_);
   void UnblockPausedWriter() ABSL_EXCLUSIVE_LOCKS_REQUIRED(is_paused_mutex_);
   void BlockUntilUnpaused() ABSL_EXCLUSIVE_LOCKS_REQUIRED(is_paused_mutex_);
   void CloseIo() ABSL_NO_THREAD_SAFETY_ANALYSIS;
@@ -123,6 +155,9 @@ class BaseEndpointChannel : public EndpointChannel {
   const int max_allowed_read_bytes_;
   const int default_max_transmit_packet_size_;
 
+  // Set when frames are read through a buffer; |reader_| then points to it.
+  std::unique_ptr<BufferedFrameReader> buffered_reader_;
+
   // The reader and writer are synchronized independently since we can't have
   // writes waiting on reads that might potentially block forever.
   Mutex reader_mutex_;
@@ -130,11 +165,30 @@ class BaseEndpointChannel : public EndpointChannel {
 
   Mutex writer_mutex_;
   OutputStream* writer_ ABSL_PT_GUARDED_BY(writer_mutex_);
+  // Set by WriteAndHandOff(); later writes go to this channel instead.
+  std::shared_ptr<EndpointChannel> write_successor_
+      ABSL_GUARDED_BY(writer_mutex_);
+
+  // When read-ahead is enabled, a dedicated thread reads frames from
+  // |reader_| while Read() decrypts the ones read before. It is started by
+  // the first Read(), since |reader_| may not be usable before the derived
+  // channel is constructed, and stopped by Close(), so channels must be closed
+  // before they are destroyed.
+  const size_t read_ahead_max_frames_;
+  // Held by Read() from taking a frame until it is decrypted.
+  Mutex read_order_mutex_;
+  Mutex read_ahead_mutex_;
+  std::shared_ptr<FrameReadAhead> read_ahead_
+      ABSL_GUARDED_BY(read_ahead_mutex_);
+  bool read_ahead_stopped_ ABSL_GUARDED_BY(read_ahead_mutex_) = false;
 
   // An encryptor/decryptor. May be null.
   mutable Mutex crypto_mutex_;
   std::shared_ptr<EncryptionContext> crypto_context_
       ABSL_GUARDED_BY(crypto_mutex_) ABSL_PT_GUARDED_BY(crypto_mutex_);
+  // Replaces the encoding of |crypto_context_| when set. May be null.
+  std::shared_ptr<AeadRecordLayer> record_layer_
+      ABSL_GUARDED_BY(crypto_mutex_) ABSL_PT_GUARDED_BY(crypto_mutex_);
 
   mutable Mutex is_paused_mutex_;
   ConditionVariable is_paused_cond_{&is_paused_mutex_};
@@ -0,0 +1,144 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "securegcm/d2d_connection_context_v1.h"
+#include "securegcm/ukey2_handshake.h"
+#include "connections/implementation/aead_record_layer.h"
+#include "connections/implementation/base_endpoint_channel.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/input_stream.h"
+#include "internal/platform/output_stream.h"
+#include "internal/platform/pipe.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+using EncryptionContext = BaseEndpointChannel::EncryptionContext;
+
+constexpr securegcm::UKey2Handshake::HandshakeCipher kCipher =
+    securegcm::UKey2Handshake::HandshakeCipher::P256_SHA512;
+
+class PipeEndpointChannel : public BaseEndpointChannel {
+ public:
+  PipeEndpointChannel(InputStream* input, OutputStream* output)
+      : BaseEndpointChannel("service_id", "channel", input, output) {}
+
+  Medium GetMedium() const override { return Medium::WIFI_LAN; }
+  void CloseImpl() override {}
+};
+
+// Runs a UKEY2 handshake in memory and returns the contexts of the initiator
+// and the responder.
+std::pair<std::unique_ptr<EncryptionContext>,
+          std::unique_ptr<EncryptionContext>>
+RunHandshake() {
+  auto initiator = securegcm::UKey2Handshake::ForInitiator(kCipher);
+  auto responder = securegcm::UKey2Handshake::ForResponder(kCipher);
+  responder->ParseHandshakeMessage(*initiator->GetNextHandshakeMessage());
+  initiator->ParseHandshakeMessage(*responder->GetNextHandshakeMessage());
+  responder->ParseHandshakeMessage(*initiator->GetNextHandshakeMessage());
+  initiator->GetVerificationString(32);
+  responder->GetVerificationString(32);
+  initiator->VerifyHandshake();
+  responder->VerifyHandshake();
+  return {initiator->ToConnectionContext(), responder->ToConnectionContext()};
+}
+
+enum class Encryption { kNone, kUkey2, kAeadRecordLayer };
+
+// A writer and a reader channel on the two ends of one pipe. One thread
+// writes and reads every message, so there is no thread handoff in the
+// measurement.
+class ChannelPair {
+ public:
+  explicit ChannelPair(Encryption encryption) {
+    auto [input, output] = CreatePipe();
+    input_ = std::move(input);
+    output_ = std::move(output);
+    writer_ = std::make_unique<PipeEndpointChannel>(nullptr, output_.get());
+    reader_ = std::make_unique<PipeEndpointChannel>(input_.get(), nullptr);
+    if (encryption == Encryption::kNone) return;
+
+    auto [writer_context, reader_context] = RunHandshake();
+    std::shared_ptr<EncryptionContext> writer_shared =
+        std::move(writer_context);
+    std::shared_ptr<EncryptionContext> reader_shared =
+        std::move(reader_context);
+    writer_->EnableEncryption(writer_shared);
+    reader_->EnableEncryption(reader_shared);
+    if (encryption == Encryption::kAeadRecordLayer) {
+      writer_->EnableAeadRecordLayer(
+          AeadRecordLayer::Create(*writer_shared));
+      reader_->EnableAeadRecordLayer(
+          AeadRecordLayer::Create(*reader_shared));
+    }
+  }
+
+  BaseEndpointChannel& writer() { return *writer_; }
+  BaseEndpointChannel& reader() { return *reader_; }
+
+ private:
+  std::unique_ptr<InputStream> input_;
+  std::unique_ptr<OutputStream> output_;
+  std::unique_ptr<PipeEndpointChannel> writer_;
+  std::unique_ptr<PipeEndpointChannel> reader_;
+};
+
+// The message content is fixed, so that runs are comparable.
+ByteArray MakeMessage(int64_t size) {
+  std::string data(size, 0);
+  for (int64_t i = 0; i < size; i++) data[i] = static_cast<char>(i * 31);
+  return ByteArray(std::move(data));
+}
+
+void BM_WriteAndRead(benchmark::State& state, Encryption encryption) {
+  ChannelPair channels(encryption);
+  ByteArray message = MakeMessage(state.range(0));
+
+  for (auto _ : state) {
+    Exception write_result = channels.writer().Write(message);
+    ExceptionOr<ByteArray> read_result = channels.reader().Read();
+    if (write_result.Raised() || !read_result.ok()) {
+      state.SkipWithError("channel failed");
+      break;
+    }
+    benchmark::DoNotOptimize(read_result.result().data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_WriteAndRead, Plaintext, Encryption::kNone)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_WriteAndRead, Ukey2, Encryption::kUkey2)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16);
+BENCHMARK_CAPTURE(BM_WriteAndRead, AeadRecordLayer,
+                  Encryption::kAeadRecordLayer)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16);
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -15,6 +15,7 @@
 #include "connections/implementation/base_endpoint_channel.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -28,6 +29,8 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/encryption_runner.h"
 #include "connections/implementation/endpoint_channel.h"
@@ -35,6 +38,7 @@
 #include "internal/platform/byte_array.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/multi_thread_executor.h"
@@ -181,6 +185,63 @@ TEST(BaseEndpointChannelTest, ReadWrite) {
   EXPECT_EQ(rx_message, tx_message);
 }
 
+TEST(BaseEndpointChannelTest, ReadAheadKeepsFramesInOrder) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  flags.endpoint_channel_read_ahead_max_frames = 2;
+  auto pipe_a = CreatePipe();  // channel_a writes to pipe_a, reads from pipe_b.
+  auto pipe_b = CreatePipe();  // channel_b writes to pipe_b, reads from pipe_a.
+  TestEndpointChannel channel_a(pipe_b.first.get(), pipe_a.second.get());
+  TestEndpointChannel channel_b(pipe_a.first.get(), pipe_b.second.get());
+  flags.endpoint_channel_read_ahead_max_frames = 0;
+
+  for (int i = 0; i < 5; i++) {
+    ASSERT_TRUE(channel_a.Write(ByteArray(std::to_string(i))).Ok());
+  }
+  for (int i = 0; i < 5; i++) {
+    PacketMetaData packet_meta_data;
+    ExceptionOr<ByteArray> rx_message = channel_b.Read(packet_meta_data);
+    ASSERT_TRUE(rx_message.ok());
+    EXPECT_EQ(rx_message.result().AsStringView(), std::to_string(i));
+    EXPECT_EQ(packet_meta_data.GetPacketSize(), sizeof(std::int32_t) + 1);
+  }
+
+  channel_b.Close(DisconnectionReason::LOCAL_DISCONNECTION);
+  EXPECT_FALSE(channel_b.Read().ok());
+  channel_a.Close(DisconnectionReason::REMOTE_DISCONNECTION);
+}
+
+TEST(BaseEndpointChannelTest, WriteSendsHeaderAndBodyInOneWritev) {
+  class RecordingOutputStream : public OutputStream {
+   public:
+    Exception Write(const ByteArray& data) override {
+      writes++;
+      return {Exception::kSuccess};
+    }
+    Exception Writev(absl::Span<const ByteArray* const> buffers) override {
+      writevs++;
+      for (const ByteArray* buffer : buffers) {
+        written += std::string(*buffer);
+      }
+      return {Exception::kSuccess};
+    }
+    Exception Flush() override { return {Exception::kSuccess}; }
+    Exception Close() override { return {Exception::kSuccess}; }
+
+    int writes = 0;
+    int writevs = 0;
+    std::string written;
+  };
+  auto [input, unused_output] = CreatePipe();
+  RecordingOutputStream output;
+  TestEndpointChannel channel(input.get(), &output);
+
+  EXPECT_TRUE(channel.Write(ByteArray{"data message"}).Ok());
+
+  EXPECT_EQ(output.writes, 0);
+  EXPECT_EQ(output.writevs, 1);
+  EXPECT_EQ(output.written, std::string("\0\0\0\x0c", 4) + "data message");
+}
+
 TEST(BaseEndpointChannelTest, ChannelUnencryptedByDefault) {
   auto pipe = CreatePipe();
   TestEndpointChannel channel(pipe.first.get(), pipe.second.get());
@@ -346,6 +407,96 @@ TEST(BaseEndpointChannelTest, EncryptedReadWriteCanNotBeIntercepted) {
   channel_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
 }
 
+TEST(BaseEndpointChannelTest, ReadWriteWithAeadRecordLayer) {
+  auto pipe_a = CreatePipe();  // channel_a writes to pipe_a, reads from pipe_b.
+  auto pipe_b = CreatePipe();  // channel_b writes to pipe_b, reads from pipe_a.
+  TestEndpointChannel channel_a(pipe_b.first.get(), pipe_a.second.get());
+  TestEndpointChannel channel_b(pipe_a.first.get(), pipe_b.second.get());
+  auto [context_a, context_b] = DoDhKeyExchange(&channel_a, &channel_b);
+  ASSERT_NE(context_a, nullptr);
+  ASSERT_NE(context_b, nullptr);
+  std::shared_ptr<AeadRecordLayer> record_layer_a =
+      AeadRecordLayer::Create(*context_a);
+  std::shared_ptr<AeadRecordLayer> record_layer_b =
+      AeadRecordLayer::Create(*context_b);
+  ASSERT_NE(record_layer_a, nullptr);
+  ASSERT_NE(record_layer_b, nullptr);
+  channel_a.EnableEncryption(context_a);
+  channel_b.EnableEncryption(context_b);
+  channel_a.EnableAeadRecordLayer(record_layer_a);
+  channel_b.EnableAeadRecordLayer(record_layer_b);
+
+  ByteArray tx_message{"data message"};
+  ASSERT_TRUE(channel_a.Write(tx_message).Ok());
+  ASSERT_TRUE(channel_b.Write(tx_message).Ok());
+  ExceptionOr<ByteArray> rx_message_b = channel_b.Read();
+  ExceptionOr<ByteArray> rx_message_a = channel_a.Read();
+
+  ASSERT_TRUE(rx_message_a.ok());
+  ASSERT_TRUE(rx_message_b.ok());
+  EXPECT_EQ(rx_message_a.result(), tx_message);
+  EXPECT_EQ(rx_message_b.result(), tx_message);
+  // Frames sealed by the record layer can't be opened with the D2D encoding.
+  std::unique_ptr<std::string> record =
+      channel_a.EncodeMessageForTests("message");
+  ASSERT_NE(record, nullptr);
+  EXPECT_EQ(context_b->DecodeMessageFromPeer(*record), nullptr);
+
+  channel_a.Close(DisconnectionReason::LOCAL_DISCONNECTION);
+  channel_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
+}
+
+TEST(BaseEndpointChannelTest, WriteAndHandOffMovesLaterWritesToSuccessor) {
+  auto pipe_a = CreatePipe();  // channel_a writes to pipe_a, reads from pipe_b.
+  auto pipe_b = CreatePipe();  // channel_b writes to pipe_b, reads from pipe_a.
+  auto new_pipe_a = CreatePipe();
+  auto new_pipe_b = CreatePipe();
+  TestEndpointChannel channel_a(pipe_b.first.get(), pipe_a.second.get());
+  TestEndpointChannel channel_b(pipe_a.first.get(), pipe_b.second.get());
+  auto new_channel_a = std::make_shared<TestEndpointChannel>(
+      new_pipe_b.first.get(), new_pipe_a.second.get());
+  TestEndpointChannel new_channel_b(new_pipe_a.first.get(),
+                                    new_pipe_b.second.get());
+  auto [context_a, context_b] = DoDhKeyExchange(&channel_a, &channel_b);
+  ASSERT_NE(context_a, nullptr);
+  ASSERT_NE(context_b, nullptr);
+  // As after a bandwidth upgrade, both channels share one encryption context.
+  channel_a.EnableEncryption(context_a);
+  new_channel_a->EnableEncryption(context_a);
+  channel_b.EnableEncryption(context_b);
+  new_channel_b.EnableEncryption(context_b);
+
+  ASSERT_TRUE(channel_a.Write(ByteArray("before")).Ok());
+  ASSERT_TRUE(
+      channel_a.WriteAndHandOff(ByteArray("last"), new_channel_a).Ok());
+  ASSERT_TRUE(channel_a.Write(ByteArray("after")).Ok());
+
+  // The remote device reads the prior channel up to the hand-off, then the new
+  // one, decrypting every frame in sequence.
+  ExceptionOr<ByteArray> rx_message = channel_b.Read();
+  ASSERT_TRUE(rx_message.ok());
+  EXPECT_EQ(rx_message.result(), ByteArray("before"));
+  rx_message = channel_b.Read();
+  ASSERT_TRUE(rx_message.ok());
+  EXPECT_EQ(rx_message.result(), ByteArray("last"));
+  rx_message = new_channel_b.Read();
+  ASSERT_TRUE(rx_message.ok());
+  EXPECT_EQ(rx_message.result(), ByteArray("after"));
+
+  // The unencrypted closing handshake stays on the prior channel.
+  channel_a.DisableEncryption();
+  channel_b.DisableEncryption();
+  ASSERT_TRUE(channel_a.Write(ByteArray("disconnection")).Ok());
+  rx_message = channel_b.Read();
+  ASSERT_TRUE(rx_message.ok());
+  EXPECT_EQ(rx_message.result(), ByteArray("disconnection"));
+
+  channel_a.Close(DisconnectionReason::LOCAL_DISCONNECTION);
+  channel_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
+  new_channel_a->Close(DisconnectionReason::LOCAL_DISCONNECTION);
+  new_channel_b.Close(DisconnectionReason::REMOTE_DISCONNECTION);
+}
+
 TEST(BaseEndpointChannelTest, CanBesuspendedAndResumed) {
   // Setup test communication environment.
   auto pipe_a = CreatePipe();  // channel_a writes to pipe_a, reads from pipe_b.
@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -24,7 +25,6 @@
 
 #include "securegcm/ukey2_handshake.h"
 #include "absl/base/thread_annotations.h"
-#include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
@@ -34,9 +34,11 @@
 #include "connections/advertising_options.h"
 #include "connections/connection_options.h"
 #include "connections/discovery_options.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/analytics/connection_attempt_metadata_params.h"
 #include "connections/implementation/bwu_manager.h"
 #include "connections/implementation/client_proxy.h"
+#include "connections/implementation/connection_pool.h"
 #include "connections/implementation/connections_authentication_transport.h"
 #include "connections/implementation/encryption_runner.h"
 #include "connections/implementation/endpoint_channel.h"
@@ -48,6 +50,7 @@
 #include "connections/implementation/mediums/webrtc_peer_id.h"
 #include "connections/implementation/offline_frames.h"
 #include "connections/implementation/pcp.h"
+#include "connections/implementation/peer_medium_cache.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/listeners.h"
 #include "connections/medium_selector.h"
@@ -66,6 +69,9 @@
 #include "internal/platform/bluetooth_utils.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancelable_alarm.h"
+#include "internal/platform/cancellation_flag.h"
+#include "internal/platform/cancellation_flag_listener.h"
+#include "internal/platform/condition_variable.h"
 #include "internal/platform/connection_info.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
@@ -74,6 +80,8 @@
 #include "internal/platform/implementation/system_clock.h"
 #include "internal/platform/implementation/wifi.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/prng.h"
 #include "internal/platform/runnable.h"
@@ -97,6 +105,19 @@ std::string AuthenticationStatusToString(nearby::AuthenticationStatus status) {
       return "failure";
   }
 }
+
+std::string FormatConnectionTimeline(const ConnectionTimeline& timeline) {
+  return absl::StrCat(
+      "medium=",
+      location::nearby::proto::connections::Medium_Name(timeline.medium),
+      "; medium_connect=", absl::FormatDuration(timeline.MediumConnect()),
+      "; request=", absl::FormatDuration(timeline.RequestExchange()),
+      "; ukey2=", absl::FormatDuration(timeline.Encryption()),
+      "; local_accept=", absl::FormatDuration(timeline.LocalAccept()),
+      "; remote_accept=", absl::FormatDuration(timeline.RemoteAccept()),
+      "; total=", absl::FormatDuration(timeline.Total()));
+}
+
 }  // namespace
 
 using ::location::nearby::analytics::proto::ConnectionsLog;
@@ -118,7 +139,21 @@ BasePcpHandler::BasePcpHandler(Mediums* mediums,
       endpoint_manager_(endpoint_manager),
       channel_manager_(channel_manager),
       pcp_(pcp),
-      bwu_manager_(bwu_manager) {}
+      bwu_manager_(bwu_manager) {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  if (flags.enable_medium_connection_racing) {
+    connection_race_executor_ = std::make_unique<MultiThreadExecutor>(
+        std::max<int>(1, flags.medium_connection_racing_max_mediums));
+  }
+  if (flags.enable_async_connection_request_read) {
+    incoming_request_executor_ = std::make_unique<MultiThreadExecutor>(
+        std::max<int>(1, flags.connection_request_max_readers));
+  }
+  if (flags.enable_async_device_authentication) {
+    authentication_executor_ = std::make_unique<MultiThreadExecutor>(
+        std::max<int>(1, flags.device_authentication_max_concurrent));
+  }
+}
 
 BasePcpHandler::~BasePcpHandler() {
   NEARBY_VLOG(1) << __func__;
@@ -139,8 +174,21 @@ void BasePcpHandler::Shutdown() {
   // Stop discovery of Bluetooth Classic.
   mediums_->GetBluetoothClassic().StopAllDiscovery();
 
+  // The reads still running end at the latest when their timeout alarm
+  // closes the channel, so the readers go down before the alarms.
+  if (incoming_request_executor_ != nullptr) {
+    incoming_request_executor_->Shutdown();
+  }
+  // The authentications post their result to the PCP handler thread, so they
+  // go down before it.
+  if (authentication_executor_ != nullptr) {
+    authentication_executor_->Shutdown();
+  }
   serial_executor_.Shutdown();
   alarm_executor_.Shutdown();
+  if (connection_race_executor_ != nullptr) {
+    connection_race_executor_->Shutdown();
+  }
   NEARBY_LOGS(INFO) << "BasePcpHandler(" << strategy_.GetName()
                     << ") has shut down.";
 }
@@ -152,6 +200,8 @@ void BasePcpHandler::DisconnectFromEndpointManager() {
   // Unregister ourselves from EPM message dispatcher.
   endpoint_manager_->UnregisterFrameProcessor(V1Frame::CONNECTION_RESPONSE,
                                               this);
+  endpoint_manager_->UnregisterFrameProcessor(V1Frame::CONNECTION_REQUEST,
+                                              this);
 }
 
 std::pair<Status, std::vector<ConnectionInfoVariant>>
@@ -450,7 +500,8 @@ Status BasePcpHandler::StartDiscovery(ClientProxy* client,
             // clear out any old endpoints we had discovered.
             {
               MutexLock lock(&discovered_endpoint_mutex_);
-              discovered_endpoints_.clear();
+              SetDiscoveredEndpointTable(
+                  std::make_shared<DiscoveredEndpointTable>());
             }
             client->StartedDiscovery(
                 service_id, GetStrategy(), std::move(listener),
@@ -648,19 +699,78 @@ void BasePcpHandler::OnEncryptionSuccessRunnableV3(
   NEARBY_VLOG(1)
       << __func__
       << ": beginning authentication to the remote device as an initiator";
-  ConnectionsAuthenticationTransport connections_authentication_transport =
-      ConnectionsAuthenticationTransport(endpoint_channel);
-  connection_info.authentication_status =
-      device_provider.AuthenticateAsInitiator(
-          /*remote_device=*/remote_device,
-          /*shared_secret=*/auth_token,
-          /*authentication_transport=*/connections_authentication_transport);
+  // The authentication runs on the channel; the pending connection gets it
+  // back once the authentication is done.
+  std::unique_ptr<EndpointChannel> channel = std::move(connection_info.channel);
+  // The round trips of the authentication block on the channel, so they run
+  // off the PCP handler thread when possible. The task can outlive the
+  // caller's device, so it runs on a copy of it.
+  std::unique_ptr<NearbyDevice> remote_device_copy = remote_device.Clone();
+  if (authentication_executor_ == nullptr || remote_device_copy == nullptr) {
+    ConnectionsAuthenticationTransport connections_authentication_transport =
+        ConnectionsAuthenticationTransport(*channel);
+    AuthenticationStatus authentication_status =
+        device_provider.AuthenticateAsInitiator(
+            /*remote_device=*/remote_device,
+            /*shared_secret=*/auth_token,
+            /*authentication_transport=*/connections_authentication_transport);
+    OnDeviceAuthenticationDone(remote_device.GetEndpointId(),
+                               std::move(channel), std::move(ukey2),
+                               auth_token, raw_auth_token,
+                               authentication_status);
+    return;
+  }
+
+  authentication_executor_->Execute(
+      "device-authentication",
+      [this, client = connection_info.client,
+       remote_device = std::move(remote_device_copy),
+       channel = std::move(channel), ukey2 = std::move(ukey2),
+       auth_token = std::string(auth_token), raw_auth_token]() mutable {
+        ConnectionsAuthenticationTransport authentication_transport(*channel);
+        AuthenticationStatus authentication_status =
+            client->GetLocalDeviceProvider()->AuthenticateAsInitiator(
+                /*remote_device=*/*remote_device,
+                /*shared_secret=*/auth_token,
+                /*authentication_transport=*/authentication_transport);
+        RunOnPcpHandlerThread(
+            "device-authentication-done",
+            [this, endpoint_id = remote_device->GetEndpointId(),
+             channel = std::move(channel), ukey2 = std::move(ukey2),
+             auth_token, raw_auth_token,
+             authentication_status]() RUN_ON_PCP_HANDLER_THREAD() mutable {
+              OnDeviceAuthenticationDone(
+                  endpoint_id, std::move(channel), std::move(ukey2),
+                  auth_token, raw_auth_token, authentication_status);
+            });
+      });
+}
+
+void BasePcpHandler::OnDeviceAuthenticationDone(
+    const std::string& endpoint_id, std::unique_ptr<EndpointChannel> channel,
+    std::unique_ptr<UKey2Handshake> ukey2, absl::string_view auth_token,
+    const ByteArray& raw_auth_token,
+    AuthenticationStatus authentication_status) {
   NEARBY_LOGS(INFO) << __func__ << ": authentication result = "
-                    << AuthenticationStatusToString(
-                           connection_info.authentication_status);
+                    << AuthenticationStatusToString(authentication_status);
+  // The connection may have gone away while the authentication ran off the
+  // PCP handler thread.
+  auto it = pending_connections_.find(endpoint_id);
+  if (it == pending_connections_.end()) {
+    NEARBY_LOGS(ERROR)
+        << __func__
+        << ": Connection not found on authentication complete; endpoint_id="
+        << endpoint_id;
+    channel->Close(
+        location::nearby::proto::connections::DisconnectionReason::SHUTDOWN);
+    return;
+  }
 
+  BasePcpHandler::PendingConnectionInfo& connection_info = it->second;
+  connection_info.channel = std::move(channel);
+  connection_info.authentication_status = authentication_status;
   RegisterDeviceAfterEncryptionSuccess(
-      /*endpoint_id=*/remote_device.GetEndpointId(),
+      /*endpoint_id=*/endpoint_id,
       /*ukey2=*/std::move(ukey2), /*auth_token=*/auth_token,
       /*raw_auth_token=*/raw_auth_token,
       /*connection_info=*/connection_info);
@@ -704,6 +814,7 @@ void BasePcpHandler::RegisterDeviceAfterEncryptionSuccess(
     std::string_view endpoint_id, std::unique_ptr<UKey2Handshake> ukey2,
     std::string_view auth_token, const ByteArray& raw_auth_token,
     BasePcpHandler::PendingConnectionInfo& connection_info) {
+  connection_info.timeline.encrypted = SystemClock::ElapsedRealtime();
   connection_info.SetCryptoContext(std::move(ukey2));
   connection_info.connection_token = GetHashedConnectionToken(raw_auth_token);
   NEARBY_LOGS(INFO)
@@ -712,6 +823,11 @@ void BasePcpHandler::RegisterDeviceAfterEncryptionSuccess(
 
   // Set ourselves up so that we receive all acceptance/rejection messages
   endpoint_manager_->RegisterFrameProcessor(V1Frame::CONNECTION_RESPONSE, this);
+  // And the requests resuming the connection once it is parked.
+  if (connection_info.client->IsConnectionPoolEnabled()) {
+    endpoint_manager_->RegisterFrameProcessor(V1Frame::CONNECTION_REQUEST,
+                                              this);
+  }
 
   ConnectionOptions connection_options = connection_info.connection_options;
   connection_options.allowed =
@@ -732,6 +848,14 @@ void BasePcpHandler::RegisterDeviceAfterEncryptionSuccess(
       connection_options, std::move(connection_info.channel),
       connection_info.listener, connection_info.connection_token);
 
+  // Prepare the bandwidth upgrade while the client decides whether to accept
+  // the connection. Incoming connections are the ones we upgrade.
+  if (connection_info.client->AutoUpgradeBandwidth()) {
+    bwu_manager_->PrewarmBwuForEndpoint(connection_info.client,
+                                        std::string(endpoint_id),
+                                        connection_info.is_incoming);
+  }
+
   if (auto future_status = connection_info.result.lock()) {
     NEARBY_LOGS(INFO) << "Connection established; Finalising future OK.";
     future_status->Set({Status::kSuccess});
@@ -821,6 +945,12 @@ Status BasePcpHandler::RequestConnection(
        result]() RUN_ON_PCP_HANDLER_THREAD() {
         absl::Time start_time = SystemClock::ElapsedRealtime();
 
+        if (std::optional<Status> status = ResumeOutgoingConnection(
+                client, endpoint_id, info, connection_options, start_time)) {
+          result->Set(*status);
+          return;
+        }
+
         DiscoveredEndpoint* endpoint = GetDiscoveredEndpoint(endpoint_id);
         if (endpoint == nullptr) {
           NEARBY_LOGS(INFO)
@@ -843,18 +973,41 @@ Status BasePcpHandler::RequestConnection(
         if (AppendWebRTCEndpoint(endpoint_id, client->GetDiscoveryOptions()))
           NEARBY_LOGS(INFO) << "Appended Web RTC endpoint.";
 
-        auto discovered_endpoints = GetDiscoveredEndpoints(endpoint_id);
+        std::vector<std::shared_ptr<DiscoveredEndpoint>> connect_endpoints;
+        for (auto& connect_endpoint :
+             GetSharedDiscoveredEndpoints(endpoint_id)) {
+          if (MediumSupportedByClientOptions(connect_endpoint->medium,
+                                             connection_options)) {
+            connect_endpoints.push_back(std::move(connect_endpoint));
+          }
+        }
+        PeerMediumCache* peer_medium_cache =
+            endpoint_manager_->GetPeerMediumCache();
+        std::string peer_key;
+        if (peer_medium_cache != nullptr) {
+          peer_key = PeerMediumCache::GetPeerKey(endpoint->service_id,
+                                                 endpoint->endpoint_info);
+          OrderEndpointsForPeer(peer_key, connect_endpoints);
+        }
+        absl::Time connect_started_at = SystemClock::ElapsedRealtime();
+        ConnectImplResult connect_impl_result =
+            ConnectToDiscoveredEndpoints(client, connect_endpoints);
+        absl::Time medium_connected_at = SystemClock::ElapsedRealtime();
         std::unique_ptr<EndpointChannel> channel;
-        ConnectImplResult connect_impl_result;
-
-        for (auto connect_endpoint : discovered_endpoints) {
-          if (!MediumSupportedByClientOptions(connect_endpoint->medium,
-                                              connection_options))
-            continue;
-          connect_impl_result = ConnectImpl(client, connect_endpoint);
-          if (connect_impl_result.status.Ok()) {
-            channel = std::move(connect_impl_result.endpoint_channel);
-            break;
+        if (connect_impl_result.status.Ok()) {
+          channel = std::move(connect_impl_result.endpoint_channel);
+        }
+        if (peer_medium_cache != nullptr && channel != nullptr) {
+          peer_medium_cache->RecordConnection(
+              peer_key, channel->GetMedium(), /*succeeded=*/true,
+              medium_connected_at - connect_started_at);
+        } else if (peer_medium_cache != nullptr &&
+                   !Cancelled(client, endpoint_id)) {
+          // None of the mediums connected.
+          for (const auto& connect_endpoint : connect_endpoints) {
+            peer_medium_cache->RecordConnection(
+                peer_key, connect_endpoint->medium, /*succeeded=*/false,
+                absl::ZeroDuration());
           }
         }
 
@@ -880,8 +1033,9 @@ Status BasePcpHandler::RequestConnection(
 
         const NearbyDevice* local_device = client->GetLocalDevice();
         Exception write_exception = WriteConnectionRequestFrame(
-            local_device->GetType(), local_device->ToProtoBytes(),
+            local_device->GetType(), client->GetLocalDeviceProtoBytes(),
             connection_info, channel.get());
+        absl::Time request_written_at = SystemClock::ElapsedRealtime();
         if (!write_exception.Ok()) {
           NEARBY_LOGS(INFO) << "Failed to send connection request: endpoint_id="
                             << endpoint_id;
@@ -912,6 +1066,9 @@ Status BasePcpHandler::RequestConnection(
         pendingConnectionInfo.nonce = connection_info.nonce;
         pendingConnectionInfo.is_incoming = false;
         pendingConnectionInfo.start_time = start_time;
+        pendingConnectionInfo.timeline.started = start_time;
+        pendingConnectionInfo.timeline.medium_connected = medium_connected_at;
+        pendingConnectionInfo.timeline.request_exchanged = request_written_at;
         pendingConnectionInfo.listener = info.listener;
         pendingConnectionInfo.connection_options = connection_options;
         pendingConnectionInfo.result = result;
@@ -982,25 +1139,21 @@ Status BasePcpHandler::RequestConnectionV3(
         if (AppendWebRTCEndpoint(endpoint_id, client->GetDiscoveryOptions()))
           NEARBY_LOGS(INFO) << "Appended Web RTC endpoint.";
 
-        auto discovered_endpoints = GetDiscoveredEndpoints(endpoint_id);
-        std::unique_ptr<EndpointChannel> channel;
-        ConnectImplResult connect_impl_result;
-
-        for (auto connect_endpoint : discovered_endpoints) {
-          if (!MediumSupportedByClientOptions(connect_endpoint->medium,
-                                              connection_options))
-            continue;
-          NEARBY_LOGS(INFO)
-              << "Try to connect with endpoint(id=" << endpoint_id
-              << ") by Medium: "
-              << location::nearby::proto::connections::Medium_Name(
-                     connect_endpoint->medium);
-          connect_impl_result = ConnectImpl(client, connect_endpoint);
-          if (connect_impl_result.status.Ok()) {
-            channel = std::move(connect_impl_result.endpoint_channel);
-            break;
+        std::vector<std::shared_ptr<DiscoveredEndpoint>> connect_endpoints;
+        for (auto& connect_endpoint :
+             GetSharedDiscoveredEndpoints(endpoint_id)) {
+          if (MediumSupportedByClientOptions(connect_endpoint->medium,
+                                             connection_options)) {
+            connect_endpoints.push_back(std::move(connect_endpoint));
           }
         }
+        ConnectImplResult connect_impl_result =
+            ConnectToDiscoveredEndpoints(client, connect_endpoints);
+        absl::Time medium_connected_at = SystemClock::ElapsedRealtime();
+        std::unique_ptr<EndpointChannel> channel;
+        if (connect_impl_result.status.Ok()) {
+          channel = std::move(connect_impl_result.endpoint_channel);
+        }
 
         Medium channel_medium =
             channel ? channel->GetMedium() : Medium::UNKNOWN_MEDIUM;
@@ -1027,8 +1180,9 @@ Status BasePcpHandler::RequestConnectionV3(
 
         const NearbyDevice* local_device = client->GetLocalDevice();
         Exception write_exception = WriteConnectionRequestFrame(
-            local_device->GetType(), local_device->ToProtoBytes(),
+            local_device->GetType(), client->GetLocalDeviceProtoBytes(),
             connection_info, channel.get());
+        absl::Time request_written_at = SystemClock::ElapsedRealtime();
 
         if (!write_exception.Ok()) {
           NEARBY_LOGS(INFO) << "Failed to send connection request: endpoint_id="
@@ -1060,6 +1214,9 @@ Status BasePcpHandler::RequestConnectionV3(
         pendingConnectionInfo.nonce = connection_info.nonce;
         pendingConnectionInfo.is_incoming = true;
         pendingConnectionInfo.start_time = start_time;
+        pendingConnectionInfo.timeline.started = start_time;
+        pendingConnectionInfo.timeline.medium_connected = medium_connected_at;
+        pendingConnectionInfo.timeline.request_exchanged = request_written_at;
         pendingConnectionInfo.listener = info.listener;
         pendingConnectionInfo.connection_options = connection_options;
         pendingConnectionInfo.result = result;
@@ -1201,24 +1358,32 @@ void BasePcpHandler::StripOutUnavailableMediums(
 // Get any single discovered endpoint for a given endpoint_id.
 BasePcpHandler::DiscoveredEndpoint* BasePcpHandler::GetDiscoveredEndpoint(
     const std::string& endpoint_id) {
-  MutexLock lock(&discovered_endpoint_mutex_);
-  auto it = discovered_endpoints_.find(endpoint_id);
-  if (it == discovered_endpoints_.end()) {
+  std::shared_ptr<const DiscoveredEndpointTable> table =
+      GetDiscoveredEndpointTable();
+  const DiscoveredEndpointTable::Endpoints& endpoints =
+      table->Find(endpoint_id);
+  if (endpoints.empty()) {
     return nullptr;
   }
-  return it->second.get();
+  return endpoints.front().get();
 }
 
 std::vector<BasePcpHandler::DiscoveredEndpoint*>
 BasePcpHandler::GetDiscoveredEndpoints(const std::string& endpoint_id) {
   std::vector<BasePcpHandler::DiscoveredEndpoint*> result;
-  MutexLock lock(&discovered_endpoint_mutex_);
-  auto it = discovered_endpoints_.equal_range(endpoint_id);
-  for (auto item = it.first; item != it.second; item++) {
-    result.push_back(item->second.get());
+  for (const auto& endpoint : GetSharedDiscoveredEndpoints(endpoint_id)) {
+    result.push_back(endpoint.get());
   }
+  return result;
+}
+
+std::vector<std::shared_ptr<BasePcpHandler::DiscoveredEndpoint>>
+BasePcpHandler::GetSharedDiscoveredEndpoints(const std::string& endpoint_id) {
+  std::vector<std::shared_ptr<BasePcpHandler::DiscoveredEndpoint>> result =
+      GetDiscoveredEndpointTable()->Find(endpoint_id);
   std::sort(result.begin(), result.end(),
-            [this](DiscoveredEndpoint* a, DiscoveredEndpoint* b) -> bool {
+            [this](const std::shared_ptr<DiscoveredEndpoint>& a,
+                   const std::shared_ptr<DiscoveredEndpoint>& b) -> bool {
               return IsPreferred(*a, *b);
             });
 
@@ -1229,15 +1394,85 @@ std::vector<BasePcpHandler::DiscoveredEndpoint*>
 BasePcpHandler::GetDiscoveredEndpoints(
     location::nearby::proto::connections::Medium medium) {
   std::vector<BasePcpHandler::DiscoveredEndpoint*> result;
-  MutexLock lock(&discovered_endpoint_mutex_);
-  for (const auto& item : discovered_endpoints_) {
-    if (item.second->medium == medium) {
-      result.push_back(item.second.get());
-    }
+  std::shared_ptr<const DiscoveredEndpointTable> table =
+      GetDiscoveredEndpointTable();
+  for (const auto& endpoint : table->Find(medium)) {
+    result.push_back(endpoint.get());
   }
   return result;
 }
 
+std::shared_ptr<const BasePcpHandler::DiscoveredEndpointTable>
+BasePcpHandler::GetDiscoveredEndpointTable() const {
+  MutexLock lock(&discovered_endpoints_snapshot_mutex_);
+  return discovered_endpoints_;
+}
+
+void BasePcpHandler::SetDiscoveredEndpointTable(
+    std::shared_ptr<const DiscoveredEndpointTable> table) {
+  std::shared_ptr<const DiscoveredEndpointTable> previous_table;
+  {
+    MutexLock lock(&discovered_endpoints_snapshot_mutex_);
+    previous_table = std::move(discovered_endpoints_);
+    discovered_endpoints_ = std::move(table);
+  }
+  // The previous snapshot, and the endpoints only it holds, may be destroyed
+  // here, outside of the lock.
+}
+
+const BasePcpHandler::DiscoveredEndpointTable::Endpoints&
+BasePcpHandler::DiscoveredEndpointTable::Find(
+    const std::string& endpoint_id) const {
+  static const Endpoints* const kNoEndpoints = new Endpoints();
+  auto it = by_endpoint_id_.find(endpoint_id);
+  return it == by_endpoint_id_.end() ? *kNoEndpoints : it->second;
+}
+
+const BasePcpHandler::DiscoveredEndpointTable::Endpoints&
+BasePcpHandler::DiscoveredEndpointTable::Find(Medium medium) const {
+  static const Endpoints* const kNoEndpoints = new Endpoints();
+  auto it = by_medium_.find(medium);
+  return it == by_medium_.end() ? *kNoEndpoints : it->second;
+}
+
+void BasePcpHandler::DiscoveredEndpointTable::Add(
+    std::shared_ptr<DiscoveredEndpoint> endpoint) {
+  by_medium_[endpoint->medium].push_back(endpoint);
+  by_endpoint_id_[endpoint->endpoint_id].push_back(std::move(endpoint));
+}
+
+void BasePcpHandler::DiscoveredEndpointTable::Remove(
+    const DiscoveredEndpoint* endpoint) {
+  auto is_endpoint =
+      [endpoint](const std::shared_ptr<DiscoveredEndpoint>& item) {
+        return item.get() == endpoint;
+      };
+  auto id_it = by_endpoint_id_.find(endpoint->endpoint_id);
+  if (id_it != by_endpoint_id_.end()) {
+    std::erase_if(id_it->second, is_endpoint);
+    if (id_it->second.empty()) by_endpoint_id_.erase(id_it);
+  }
+  auto medium_it = by_medium_.find(endpoint->medium);
+  if (medium_it != by_medium_.end()) {
+    std::erase_if(medium_it->second, is_endpoint);
+    if (medium_it->second.empty()) by_medium_.erase(medium_it);
+  }
+}
+
+void BasePcpHandler::DiscoveredEndpointTable::RemoveAll(
+    const std::string& endpoint_id) {
+  auto id_it = by_endpoint_id_.find(endpoint_id);
+  if (id_it == by_endpoint_id_.end()) return;
+  Endpoints endpoints = std::move(id_it->second);
+  by_endpoint_id_.erase(id_it);
+  for (const auto& endpoint : endpoints) {
+    auto medium_it = by_medium_.find(endpoint->medium);
+    if (medium_it == by_medium_.end()) continue;
+    std::erase(medium_it->second, endpoint);
+    if (medium_it->second.empty()) by_medium_.erase(medium_it);
+  }
+}
+
 namespace {
 std::string GetEndpointLostByMediumAlarmKey(absl::string_view endpoint_id,
                                             Medium medium) {
@@ -1448,6 +1683,8 @@ Status BasePcpHandler::AcceptConnection(ClientProxy* client,
 
         NEARBY_LOGS(INFO) << "AcceptConnection: accepting locally: endpoint_id="
                           << endpoint_id;
+        connection_info.timeline.local_responded =
+            SystemClock::ElapsedRealtime();
         connection_info.LocalEndpointAcceptedConnection(
             endpoint_id, std::move(payload_listener));
         EvaluateConnectionResult(client, endpoint_id,
@@ -1511,6 +1748,8 @@ Status BasePcpHandler::RejectConnection(ClientProxy* client,
 
         NEARBY_LOGS(INFO) << "RejectConnection: rejecting locally: endpoint_id="
                           << endpoint_id;
+        connection_info.timeline.local_responded =
+            SystemClock::ElapsedRealtime();
         connection_info.LocalEndpointRejectedConnection(endpoint_id);
         EvaluateConnectionResult(client, endpoint_id,
                                  false /* can_close_immediately */);
@@ -1526,6 +1765,18 @@ void BasePcpHandler::OnIncomingFrame(
     location::nearby::proto::connections::Medium medium,
     PacketMetaData& packet_meta_data) {
   CountDownLatch latch(1);
+  if (parser::GetFrameType(frame) == V1Frame::CONNECTION_REQUEST) {
+    RunOnPcpHandlerThread(
+        "resume-connection",
+        [this, client, endpoint_id, frame,
+         &latch]() RUN_ON_PCP_HANDLER_THREAD() {
+          ResumeIncomingConnection(client, endpoint_id,
+                                   frame.v1().connection_request());
+          latch.CountDown();
+        });
+    WaitForLatch("OnIncomingFrame()", &latch);
+    return;
+  }
   RunOnPcpHandlerThread(
       "incoming-frame",
       [this, client, endpoint_id, frame, &latch]() RUN_ON_PCP_HANDLER_THREAD() {
@@ -1541,6 +1792,11 @@ void BasePcpHandler::OnIncomingFrame(
 
         const ConnectionResponseFrame& connection_response =
             frame.v1().connection_response();
+        auto pending = pending_connections_.find(endpoint_id);
+        if (pending != pending_connections_.end()) {
+          pending->second.timeline.remote_responded =
+              SystemClock::ElapsedRealtime();
+        }
 
         // For backward compatible, here still check both status and
         // response parameters until the response feature is roll out in all
@@ -1581,6 +1837,19 @@ void BasePcpHandler::OnIncomingFrame(
           client->SetRemoteSafeToDisconnectVersion(
               endpoint_id, connection_response.safe_to_disconnect_version());
         }
+
+        if (connection_response.has_aead_record_layer_version()) {
+          client->SetRemoteAeadRecordLayerVersion(
+              endpoint_id, connection_response.aead_record_layer_version());
+        }
+        if (connection_response.has_payload_compression_version()) {
+          client->SetRemotePayloadCompressionVersion(
+              endpoint_id, connection_response.payload_compression_version());
+        }
+        if (connection_response.has_payload_batching_version()) {
+          client->SetRemotePayloadBatchingVersion(
+              endpoint_id, connection_response.payload_batching_version());
+        }
         channel_manager_->UpdateSafeToDisconnectForEndpoint(
             endpoint_id, client->IsSafeToDisconnectEnabled(endpoint_id));
         EvaluateConnectionResult(client, endpoint_id,
@@ -1631,11 +1900,13 @@ void BasePcpHandler::OnEndpointFound(
                            endpoint->medium)
                     << " [enter]";
   MutexLock lock(&discovered_endpoint_mutex_);
-  auto range = discovered_endpoints_.equal_range(endpoint->endpoint_id);
-  bool is_range_empty = range.first == range.second;
+  std::shared_ptr<const DiscoveredEndpointTable> snapshot =
+      GetDiscoveredEndpointTable();
+  const DiscoveredEndpointTable::Endpoints& discovered_endpoints =
+      snapshot->Find(endpoint_id);
+  bool is_range_empty = discovered_endpoints.empty();
   DiscoveredEndpoint* owned_endpoint = nullptr;
-  for (auto& item = range.first; item != range.second; ++item) {
-    auto& discovered_endpoint = item->second;
+  for (const auto& discovered_endpoint : discovered_endpoints) {
     if (discovered_endpoint->endpoint_info != endpoint->endpoint_info) {
       // Endpoint info should be same for an endpoint ID. If it is changed,
       // we should reset discovered endpoints of the endpoint ID, and use the
@@ -1646,12 +1917,13 @@ void BasePcpHandler::OnEndpointFound(
                                endpoint->medium);
       // Report endpoint lost
       client->OnEndpointLost(endpoint->service_id, endpoint->endpoint_id);
-      // Reset discovered endpoints
-      discovered_endpoints_.erase(item->first);
-      // Add the endpoint as discovered endpoint.
-      owned_endpoint =
-          discovered_endpoints_.emplace(endpoint_id, std::move(endpoint))
-              ->second.get();
+      // Reset discovered endpoints, and add the endpoint as discovered
+      // endpoint.
+      auto table = std::make_shared<DiscoveredEndpointTable>(*snapshot);
+      table->RemoveAll(endpoint_id);
+      owned_endpoint = endpoint.get();
+      table->Add(std::move(endpoint));
+      SetDiscoveredEndpointTable(std::move(table));
       StopEndpointLostByMediumAlarm(owned_endpoint->endpoint_id,
                                     owned_endpoint->medium);
       client->OnEndpointFound(
@@ -1667,9 +1939,10 @@ void BasePcpHandler::OnEndpointFound(
     }
   }
 
-  owned_endpoint =
-      discovered_endpoints_.emplace(endpoint_id, std::move(endpoint))
-          ->second.get();
+  auto table = std::make_shared<DiscoveredEndpointTable>(*snapshot);
+  owned_endpoint = endpoint.get();
+  table->Add(std::move(endpoint));
+  SetDiscoveredEndpointTable(std::move(table));
 
   NEARBY_LOGS(INFO) << "Adding new medium for endpoint: endpoint_id="
                     << endpoint_id << "; medium="
@@ -1691,18 +1964,17 @@ void BasePcpHandler::OnEndpointLost(
   // Look up the DiscoveredEndpoint we have in our cache.
   NEARBY_LOGS(INFO) << "OnEndpointLost: id=" << endpoint.endpoint_id;
   MutexLock lock(&discovered_endpoint_mutex_);
-  auto range = discovered_endpoints_.equal_range(endpoint.endpoint_id);
-  bool is_range_empty = range.first == range.second;
-  if (is_range_empty) {
+  std::shared_ptr<const DiscoveredEndpointTable> snapshot =
+      GetDiscoveredEndpointTable();
+  const DiscoveredEndpointTable::Endpoints& discovered_endpoints =
+      snapshot->Find(endpoint.endpoint_id);
+  if (discovered_endpoints.empty()) {
     NEARBY_LOGS(INFO) << "No previous endpoint (nothing to lose): endpoint_id="
                       << endpoint.endpoint_id;
     return;
   }
-  int count = discovered_endpoints_.count(endpoint.endpoint_id);
-  absl::btree_multimap<std::string,
-                       std::shared_ptr<DiscoveredEndpoint>>::iterator item;
-  for (item = range.first; item != range.second; ++item) {
-    auto& discovered_endpoint = item->second;
+  int count = discovered_endpoints.size();
+  for (const auto& discovered_endpoint : discovered_endpoints) {
     if (discovered_endpoint->medium != endpoint.medium) continue;
 
     // Validate that the cached endpoint has the same info as the one reported
@@ -1723,7 +1995,9 @@ void BasePcpHandler::OnEndpointLost(
     if (--count == 0) {
       client->OnEndpointLost(endpoint.service_id, endpoint.endpoint_id);
     }
-    discovered_endpoints_.erase(item);
+    auto table = std::make_shared<DiscoveredEndpointTable>(*snapshot);
+    table->Remove(discovered_endpoint.get());
+    SetDiscoveredEndpointTable(std::move(table));
     break;
   }
 }
@@ -1845,13 +2119,117 @@ bool BasePcpHandler::IsPreferred(
   return false;
 }
 
+namespace {
+// Returns the options of the incoming connection, as requested by the remote
+// endpoint.
+ConnectionOptions GetIncomingConnectionOptions(
+    const ConnectionRequestFrame& connection_request) {
+  // Retrieve the keep-alive frame interval and timeout fields. If the frame
+  // doesn't have those fields, we need to get them as default from feature
+  // flags to prevent 0-values causing thread ill.
+  ConnectionOptions connection_options;
+  connection_options.keep_alive_interval_millis = 0;
+  connection_options.keep_alive_timeout_millis = 0;
+  if (connection_request.has_keep_alive_interval_millis() &&
+      connection_request.has_keep_alive_timeout_millis()) {
+    connection_options.keep_alive_interval_millis =
+        connection_request.keep_alive_interval_millis();
+    connection_options.keep_alive_timeout_millis =
+        connection_request.keep_alive_timeout_millis();
+  }
+  if (connection_options.keep_alive_interval_millis == 0 ||
+      connection_options.keep_alive_timeout_millis == 0 ||
+      connection_options.keep_alive_interval_millis >=
+          connection_options.keep_alive_timeout_millis) {
+    NEARBY_LOGS(WARNING)
+        << "Incoming connection has wrong keep-alive frame interval="
+        << connection_options.keep_alive_interval_millis
+        << ", timeout=" << connection_options.keep_alive_timeout_millis
+        << " values; correct them as default.",
+        connection_options.keep_alive_interval_millis =
+            FeatureFlags::GetInstance().GetFlags().keep_alive_interval_millis;
+    connection_options.keep_alive_timeout_millis =
+        FeatureFlags::GetInstance().GetFlags().keep_alive_timeout_millis;
+  }
+
+  const MediumMetadata& medium_metadata = connection_request.medium_metadata();
+  ConnectionInfo& connection_info = connection_options.connection_info;
+  connection_info.supports_5_ghz = medium_metadata.supports_5_ghz();
+  connection_info.bssid = medium_metadata.bssid();
+  connection_info.ap_frequency = medium_metadata.ap_frequency();
+  connection_info.ip_address = medium_metadata.ip_address();
+  NEARBY_LOGS(INFO) << connection_request.endpoint_id()
+                    << "'s WIFI information: is_supports_5_ghz="
+                    << connection_info.supports_5_ghz
+                    << "; bssid=" << connection_info.bssid
+                    << "; ap_frequency=" << connection_info.ap_frequency
+                    << "Mhz; ip_address in bytes format="
+                    << absl::BytesToHexString(connection_info.ip_address);
+  return connection_options;
+}
+}  // namespace
+
 Exception BasePcpHandler::OnIncomingConnection(
     ClientProxy* client, const ByteArray& remote_endpoint_info,
     std::unique_ptr<EndpointChannel> channel,
     location::nearby::proto::connections::Medium medium,
     NearbyDevice::Type listening_device_type) {
   absl::Time start_time = SystemClock::ElapsedRealtime();
+  if (!IsAcceptingIncomingConnections(client, channel->GetMedium())) {
+    return {Exception::kIo};
+  }
+
+  // Endpoints connecting to us will always tell us about themselves first.
+  ExceptionOr<OfflineFrame> wrapped_frame =
+      ReadConnectionRequestFrame(channel.get());
+  absl::Time request_read_at = SystemClock::ElapsedRealtime();
+  return OnIncomingConnectionRequest(
+      client, remote_endpoint_info, std::move(channel), medium,
+      listening_device_type, start_time, std::move(wrapped_frame),
+      request_read_at);
+}
+
+void BasePcpHandler::AcceptIncomingConnection(
+    ClientProxy* client, const ByteArray& remote_endpoint_info,
+    std::unique_ptr<EndpointChannel> channel,
+    location::nearby::proto::connections::Medium medium,
+    NearbyDevice::Type listening_device_type) {
+  if (incoming_request_executor_ == nullptr) {
+    OnIncomingConnection(client, remote_endpoint_info, std::move(channel),
+                         medium, listening_device_type);
+    return;
+  }
+  absl::Time start_time = SystemClock::ElapsedRealtime();
+  if (!IsAcceptingIncomingConnections(client, channel->GetMedium())) return;
+
+  incoming_request_executor_->Execute(
+      "read-connection-request",
+      [this, client, remote_endpoint_info, channel = std::move(channel),
+       medium, listening_device_type, start_time]() mutable {
+        ExceptionOr<OfflineFrame> wrapped_frame =
+            ReadConnectionRequestFrame(channel.get());
+        absl::Time request_read_at = SystemClock::ElapsedRealtime();
+        RunOnPcpHandlerThread(
+            "on-incoming-connection-request",
+            [this, client, remote_endpoint_info, channel = std::move(channel),
+             medium, listening_device_type, start_time,
+             wrapped_frame = std::move(wrapped_frame),
+             request_read_at]() RUN_ON_PCP_HANDLER_THREAD() mutable {
+              // The client may have stopped waiting during the read.
+              if (!IsAcceptingIncomingConnections(client,
+                                                  channel->GetMedium())) {
+                return;
+              }
+              OnIncomingConnectionRequest(
+                  client, remote_endpoint_info, std::move(channel), medium,
+                  listening_device_type, start_time, std::move(wrapped_frame),
+                  request_read_at);
+            });
+      });
+}
 
+bool BasePcpHandler::IsAcceptingIncomingConnections(
+    ClientProxy* client, location::nearby::proto::connections::Medium medium) {
   //  Fixes an NPE in ClientProxy.OnConnectionAccepted. The crash happened when
   //  the client stopped advertising and we nulled out state, followed by an
   //  incoming connection where we attempted to check that state.
@@ -1859,16 +2237,20 @@ Exception BasePcpHandler::OnIncomingConnection(
       !client->IsListeningForIncomingConnections()) {
     NEARBY_LOGS(WARNING) << "Ignoring incoming connection on medium "
                          << location::nearby::proto::connections::Medium_Name(
-                                channel->GetMedium())
+                                medium)
                          << " because client=" << client->GetClientId()
                          << " is no longer waiting for incoming connections.";
-    return {Exception::kIo};
+    return false;
   }
+  return true;
+}
 
-  // Endpoints connecting to us will always tell us about themselves first.
-  ExceptionOr<OfflineFrame> wrapped_frame =
-      ReadConnectionRequestFrame(channel.get());
-
+Exception BasePcpHandler::OnIncomingConnectionRequest(
+    ClientProxy* client, const ByteArray& remote_endpoint_info,
+    std::unique_ptr<EndpointChannel> channel,
+    location::nearby::proto::connections::Medium medium,
+    NearbyDevice::Type listening_device_type, absl::Time start_time,
+    ExceptionOr<OfflineFrame> wrapped_frame, absl::Time request_read_at) {
   if (!wrapped_frame.ok()) {
     if (wrapped_frame.exception()) {
       NEARBY_LOGS(ERROR)
@@ -1944,47 +2326,8 @@ Exception BasePcpHandler::OnIncomingConnection(
                                     ? connection_request.endpoint_info()
                                     : connection_request.endpoint_name()};
 
-  // Retrieve the keep-alive frame interval and timeout fields. If the frame
-  // doesn't have those fields, we need to get them as default from feature
-  // flags to prevent 0-values causing thread ill.
-  ConnectionOptions connection_options;
-  connection_options.keep_alive_interval_millis = 0;
-  connection_options.keep_alive_timeout_millis = 0;
-  if (connection_request.has_keep_alive_interval_millis() &&
-      connection_request.has_keep_alive_timeout_millis()) {
-    connection_options.keep_alive_interval_millis =
-        connection_request.keep_alive_interval_millis();
-    connection_options.keep_alive_timeout_millis =
-        connection_request.keep_alive_timeout_millis();
-  }
-  if (connection_options.keep_alive_interval_millis == 0 ||
-      connection_options.keep_alive_timeout_millis == 0 ||
-      connection_options.keep_alive_interval_millis >=
-          connection_options.keep_alive_timeout_millis) {
-    NEARBY_LOGS(WARNING)
-        << "Incoming connection has wrong keep-alive frame interval="
-        << connection_options.keep_alive_interval_millis
-        << ", timeout=" << connection_options.keep_alive_timeout_millis
-        << " values; correct them as default.",
-        connection_options.keep_alive_interval_millis =
-            FeatureFlags::GetInstance().GetFlags().keep_alive_interval_millis;
-    connection_options.keep_alive_timeout_millis =
-        FeatureFlags::GetInstance().GetFlags().keep_alive_timeout_millis;
-  }
-
-  const MediumMetadata& medium_metadata = connection_request.medium_metadata();
-  ConnectionInfo& connection_info = connection_options.connection_info;
-  connection_info.supports_5_ghz = medium_metadata.supports_5_ghz();
-  connection_info.bssid = medium_metadata.bssid();
-  connection_info.ap_frequency = medium_metadata.ap_frequency();
-  connection_info.ip_address = medium_metadata.ip_address();
-  NEARBY_LOGS(INFO) << connection_request.endpoint_id()
-                    << "'s WIFI information: is_supports_5_ghz="
-                    << connection_info.supports_5_ghz
-                    << "; bssid=" << connection_info.bssid
-                    << "; ap_frequency=" << connection_info.ap_frequency
-                    << "Mhz; ip_address in bytes format="
-                    << absl::BytesToHexString(connection_info.ip_address);
+  ConnectionOptions connection_options =
+      GetIncomingConnectionOptions(connection_request);
 
   // We've successfully connected to the device, and are now about to jump on to
   // the EncryptionRunner thread to start running our encryption protocol. We'll
@@ -1998,6 +2341,9 @@ Exception BasePcpHandler::OnIncomingConnection(
   pendingConnectionInfo.nonce = connection_request.nonce();
   pendingConnectionInfo.is_incoming = true;
   pendingConnectionInfo.start_time = start_time;
+  pendingConnectionInfo.timeline.is_incoming = true;
+  pendingConnectionInfo.timeline.started = start_time;
+  pendingConnectionInfo.timeline.request_exchanged = request_read_at;
   pendingConnectionInfo.listener =
       client->GetAdvertisingOrIncomingConnectionListener();
   pendingConnectionInfo.connection_options = connection_options;
@@ -2017,6 +2363,114 @@ Exception BasePcpHandler::OnIncomingConnection(
   return {Exception::kSuccess};
 }
 
+std::optional<Status> BasePcpHandler::ResumeOutgoingConnection(
+    ClientProxy* client, const std::string& endpoint_id,
+    const ConnectionRequestInfo& info,
+    const ConnectionOptions& connection_options, absl::Time start_time) {
+  std::optional<ConnectionPool::Entry> parked =
+      client->TakeParkedConnection(endpoint_id);
+  if (!parked.has_value()) return std::nullopt;
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) return std::nullopt;
+
+  NEARBY_LOGS(INFO) << "Resuming parked connection: endpoint_id="
+                    << endpoint_id;
+  ConnectionInfo connection_info =
+      FillConnectionInfo(client, info, connection_options);
+  const NearbyDevice* local_device = client->GetLocalDevice();
+  Exception write_exception = WriteConnectionRequestFrame(
+      local_device->GetType(), client->GetLocalDeviceProtoBytes(),
+      connection_info, channel.get());
+  if (!write_exception.Ok()) {
+    NEARBY_LOGS(INFO) << "Failed to send connection request over parked "
+                         "channel: endpoint_id="
+                      << endpoint_id;
+    endpoint_manager_->DiscardEndpoint(client, endpoint_id,
+                                       DisconnectionReason::IO_ERROR);
+    return Status{Status::kEndpointIoError};
+  }
+
+  // The channel is still encrypted, so there is no UKEY2 context: the
+  // connection is pending until both sides accept it, as usual.
+  PendingConnectionInfo pendingConnectionInfo{};
+  pendingConnectionInfo.client = client;
+  pendingConnectionInfo.remote_endpoint_info =
+      parked->info.remote_endpoint_info;
+  pendingConnectionInfo.nonce = connection_info.nonce;
+  pendingConnectionInfo.is_incoming = false;
+  pendingConnectionInfo.start_time = start_time;
+  pendingConnectionInfo.listener = info.listener;
+  pendingConnectionInfo.connection_options = connection_options;
+  pendingConnectionInfo.medium = channel->GetMedium();
+  pendingConnectionInfo.connection_token = parked->connection_token;
+  pending_connections_.emplace(endpoint_id, std::move(pendingConnectionInfo));
+
+  ConnectionResponseInfo response_info = parked->info;
+  response_info.is_incoming_connection = false;
+  if (!endpoint_manager_->ResumeEndpoint(client, endpoint_id, response_info,
+                                         connection_options, info.listener,
+                                         parked->connection_token)) {
+    pending_connections_.erase(endpoint_id);
+    return Status{Status::kEndpointIoError};
+  }
+  return Status{Status::kSuccess};
+}
+
+void BasePcpHandler::ResumeIncomingConnection(
+    ClientProxy* client, const std::string& endpoint_id,
+    const ConnectionRequestFrame& connection_request) {
+  std::optional<ConnectionPool::Entry> parked =
+      client->TakeParkedConnection(endpoint_id);
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  // Both sides resuming the connection at once is a tie neither wins, as
+  // neither has a parked connection left.
+  if (!parked.has_value() || channel == nullptr ||
+      connection_request.endpoint_id() != endpoint_id ||
+      (!client->IsAdvertising() &&
+       !client->IsListeningForIncomingConnections())) {
+    NEARBY_LOGS(WARNING) << "Can't resume parked connection: endpoint_id="
+                         << endpoint_id;
+    endpoint_manager_->DiscardEndpoint(client, endpoint_id,
+                                       DisconnectionReason::UNFINISHED);
+    return;
+  }
+
+  NEARBY_LOGS(INFO) << "Resuming parked connection: endpoint_id="
+                    << endpoint_id;
+  const ByteArray endpoint_info{connection_request.has_endpoint_info()
+                                    ? connection_request.endpoint_info()
+                                    : connection_request.endpoint_name()};
+  ConnectionOptions connection_options =
+      GetIncomingConnectionOptions(connection_request);
+  ConnectionListener listener =
+      client->GetAdvertisingOrIncomingConnectionListener();
+
+  PendingConnectionInfo pendingConnectionInfo{};
+  pendingConnectionInfo.client = client;
+  pendingConnectionInfo.remote_endpoint_info = endpoint_info;
+  pendingConnectionInfo.nonce = connection_request.nonce();
+  pendingConnectionInfo.is_incoming = true;
+  pendingConnectionInfo.start_time = SystemClock::ElapsedRealtime();
+  pendingConnectionInfo.listener = listener;
+  pendingConnectionInfo.connection_options = connection_options;
+  pendingConnectionInfo.supported_mediums =
+      parser::ConnectionRequestMediumsToMediums(connection_request);
+  pendingConnectionInfo.medium = channel->GetMedium();
+  pendingConnectionInfo.connection_token = parked->connection_token;
+  pending_connections_.emplace(endpoint_id, std::move(pendingConnectionInfo));
+
+  ConnectionResponseInfo response_info = parked->info;
+  response_info.remote_endpoint_info = endpoint_info;
+  response_info.is_incoming_connection = true;
+  if (!endpoint_manager_->ResumeEndpoint(client, endpoint_id, response_info,
+                                         connection_options, listener,
+                                         parked->connection_token)) {
+    pending_connections_.erase(endpoint_id);
+  }
+}
+
 bool BasePcpHandler::BreakTie(ClientProxy* client,
                               const std::string& endpoint_id,
                               std::int32_t incoming_nonce,
@@ -2128,14 +2582,16 @@ bool BasePcpHandler::AppendRemoteBluetoothMacAddressEndpoint(
     return false;
   }
   MutexLock lock(&discovered_endpoint_mutex_);
-
-  auto it = discovered_endpoints_.equal_range(endpoint_id);
-  if (it.first == it.second) {
+  std::shared_ptr<const DiscoveredEndpointTable> snapshot =
+      GetDiscoveredEndpointTable();
+  const DiscoveredEndpointTable::Endpoints& discovered_endpoints =
+      snapshot->Find(endpoint_id);
+  if (discovered_endpoints.empty()) {
     return false;
   }
-  auto endpoint = it.first->second.get();
-  for (auto item = it.first; item != it.second; item++) {
-    if (item->second->medium ==
+  auto endpoint = discovered_endpoints.front().get();
+  for (const auto& item : discovered_endpoints) {
+    if (item->medium ==
         location::nearby::proto::connections::Medium::BLUETOOTH) {
       NEARBY_LOGS(INFO)
           << "Cannot append remote Bluetooth MAC Address endpoint, because "
@@ -2163,7 +2619,9 @@ bool BasePcpHandler::AppendRemoteBluetoothMacAddressEndpoint(
           remote_bluetooth_device,
       });
 
-  discovered_endpoints_.emplace(endpoint_id, std::move(bluetooth_endpoint));
+  auto table = std::make_shared<DiscoveredEndpointTable>(*snapshot);
+  table->Add(std::move(bluetooth_endpoint));
+  SetDiscoveredEndpointTable(std::move(table));
   return true;
 }
 
@@ -2174,13 +2632,16 @@ bool BasePcpHandler::AppendWebRTCEndpoint(
     return false;
   }
   MutexLock lock(&discovered_endpoint_mutex_);
+  std::shared_ptr<const DiscoveredEndpointTable> snapshot =
+      GetDiscoveredEndpointTable();
+  const DiscoveredEndpointTable::Endpoints& discovered_endpoints =
+      snapshot->Find(endpoint_id);
 
   bool should_connect_web_rtc = false;
-  auto it = discovered_endpoints_.equal_range(endpoint_id);
-  if (it.first == it.second) return false;
-  auto endpoint = it.first->second.get();
-  for (auto item = it.first; item != it.second; item++) {
-    if (item->second->web_rtc_state != WebRtcState::kUnconnectable) {
+  if (discovered_endpoints.empty()) return false;
+  auto endpoint = discovered_endpoints.front().get();
+  for (const auto& item : discovered_endpoints) {
+    if (item->web_rtc_state != WebRtcState::kUnconnectable) {
       should_connect_web_rtc = true;
       break;
     }
@@ -2195,7 +2656,9 @@ bool BasePcpHandler::AppendWebRTCEndpoint(
                                     endpoint->endpoint_info),
   });
 
-  discovered_endpoints_.emplace(endpoint_id, std::move(webrtc_endpoint));
+  auto table = std::make_shared<DiscoveredEndpointTable>(*snapshot);
+  table->Add(std::move(webrtc_endpoint));
+  SetDiscoveredEndpointTable(std::move(table));
   return true;
 }
 
@@ -2238,6 +2701,11 @@ void BasePcpHandler::EvaluateConnectionResult(ClientProxy* client,
   }
 
   Medium medium = endpint_channel->GetMedium();
+  ConnectionTimeline& timeline = connection_info.timeline;
+  timeline.medium = medium;
+  timeline.finished = SystemClock::ElapsedRealtime();
+  NEARBY_LOGS(INFO) << "Connection timeline: endpoint_id=" << endpoint_id
+                    << "; " << FormatConnectionTimeline(timeline);
 
   Status response_code;
   if (is_connection_accepted) {
@@ -2245,42 +2713,60 @@ void BasePcpHandler::EvaluateConnectionResult(ClientProxy* client,
                       << endpoint_id;
     response_code = {Status::kSuccess};
 
-    // Both sides have accepted, so we can now start talking over encrypted
-    // channels
-    // Now, after both parties accepted connection (presumably after verifying &
-    // matching security tokens), we are allowed to extract the shared key.
-    auto ukey2 = std::move(connection_info.ukey2);
-    bool succeeded = ukey2->VerifyHandshake();
-    CHECK(succeeded);  // If this fails, it's a UKEY2 protocol bug.
-    auto context = ukey2->ToConnectionContext();
-    CHECK(context);  // there is no way how this can fail, if Verify succeeded.
-    // If it did, it's a UKEY2 protocol bug.
-
-    if (!channel_manager_->EncryptChannelForEndpoint(endpoint_id,
-                                                     std::move(context))) {
-      response_code = {Status::kEndpointUnknown};
-    }
+    // A connection resumed from the connection pool is still encrypted with
+    // the keys of the connection it was parked from.
+    if (connection_info.ukey2 != nullptr) {
+      // Both sides have accepted, so we can now start talking over encrypted
+      // channels
+      // Now, after both parties accepted connection (presumably after
+      // verifying & matching security tokens), we are allowed to extract the
+      // shared key.
+      auto ukey2 = std::move(connection_info.ukey2);
+      bool succeeded = ukey2->VerifyHandshake();
+      CHECK(succeeded);  // If this fails, it's a UKEY2 protocol bug.
+      auto context = ukey2->ToConnectionContext();
+      // There is no way how this can fail, if Verify succeeded. If it did,
+      // it's a UKEY2 protocol bug.
+      CHECK(context);
+
+      // The record layer is derived from the UKEY2 keys, so it has to be
+      // created before the context is handed over. Without it, both sides fall
+      // back to the D2D encoding of the context.
+      std::unique_ptr<AeadRecordLayer> record_layer;
+      if (client->IsAeadRecordLayerEnabled(endpoint_id)) {
+        record_layer = AeadRecordLayer::Create(*context);
+        if (record_layer == nullptr) {
+          response_code = {Status::kError};
+        }
+      }
 
-    std::shared_ptr<EndpointChannel> channel =
-        channel_manager_->GetChannelForEndpoint(endpoint_id);
-    if (channel != nullptr) {
-      if (client->IsMultiplexSocketSupported(endpoint_id,
-                                             channel->GetMedium())) {
-        if (!channel->EnableMultiplexSocket()) {
-          NEARBY_LOGS(INFO)
-              << "MultiplexSocket is not implemented for Medium: "
-              << location::nearby::proto::connections::Medium_Name(
-                     channel->GetMedium());
-        } else {
-          NEARBY_LOGS(INFO)
-              << "MultiplexSocket is supported for Medium: "
-              << location::nearby::proto::connections::Medium_Name(
-                     channel->GetMedium())
-              << " on both sides.";
+      if (response_code.Ok() &&
+          !channel_manager_->EncryptChannelForEndpoint(
+              endpoint_id, std::move(context), std::move(record_layer))) {
+        response_code = {Status::kEndpointUnknown};
+      }
+
+      std::shared_ptr<EndpointChannel> channel =
+          channel_manager_->GetChannelForEndpoint(endpoint_id);
+      if (channel != nullptr) {
+        if (client->IsMultiplexSocketSupported(endpoint_id,
+                                               channel->GetMedium())) {
+          if (!channel->EnableMultiplexSocket()) {
+            NEARBY_LOGS(INFO)
+                << "MultiplexSocket is not implemented for Medium: "
+                << location::nearby::proto::connections::Medium_Name(
+                       channel->GetMedium());
+          } else {
+            NEARBY_LOGS(INFO)
+                << "MultiplexSocket is supported for Medium: "
+                << location::nearby::proto::connections::Medium_Name(
+                       channel->GetMedium())
+                << " on both sides.";
+          }
         }
+      } else {
+        NEARBY_LOGS(INFO) << "channel is null";
       }
-    } else {
-      NEARBY_LOGS(INFO) << "channel is null";
     }
   } else {
     NEARBY_LOGS(INFO) << "Pending connection rejected; endpoint_id="
@@ -2290,7 +2776,7 @@ void BasePcpHandler::EvaluateConnectionResult(ClientProxy* client,
 
   // If the connection failed, clean everything up and short circuit.
   if (!response_code.Ok()) {
-    client->OnConnectionRejected(endpoint_id, response_code);
+    client->OnConnectionRejected(endpoint_id, response_code, timeline);
 
     // Clean up the channel in EndpointManager if it's no longer required.
     if (can_close_immediately) {
@@ -2312,10 +2798,10 @@ void BasePcpHandler::EvaluateConnectionResult(ClientProxy* client,
   }
 
   client->GetAnalyticsRecorder().OnConnectionEstablished(
-      endpoint_id, medium, connection_info.connection_token);
+      endpoint_id, medium, connection_info.connection_token, &timeline);
 
   // Invoke the client callback to let it know of the connection result.
-  client->OnConnectionAccepted(endpoint_id);
+  client->OnConnectionAccepted(endpoint_id, timeline);
 
   // Report the current bandwidth to the client
   if (FeatureFlags::GetInstance()
@@ -2449,6 +2935,191 @@ void BasePcpHandler::LogConnectionAttemptSuccess(
   }
 }
 
+// The state of a RaceConnectImpl() call, shared with its connection attempts,
+// which may outlive it.
+struct BasePcpHandler::ConnectionRace {
+  explicit ConnectionRace(int attempts) : cancellation_flags(attempts) {}
+
+  // One flag per attempt, cancelled when the attempt loses the race.
+  std::vector<CancellationFlag> cancellation_flags;
+
+  Mutex mutex;
+  ConditionVariable cond{&mutex};
+  // Number of attempts in progress.
+  int running ABSL_GUARDED_BY(mutex) = 0;
+  // Set when an attempt fails, so the next one starts right away.
+  bool attempt_failed ABSL_GUARDED_BY(mutex) = false;
+  // Set once RaceConnectImpl() returns; attempts that connect after that close
+  // their channel.
+  bool decided ABSL_GUARDED_BY(mutex) = false;
+  // The first attempt that connected, if any.
+  std::optional<int> winner ABSL_GUARDED_BY(mutex);
+  ConnectImplResult result ABSL_GUARDED_BY(mutex);
+};
+
+void BasePcpHandler::OrderEndpointsForPeer(
+    const std::string& peer_key,
+    std::vector<std::shared_ptr<DiscoveredEndpoint>>& endpoints) const {
+  PeerMediumCache* peer_medium_cache = endpoint_manager_->GetPeerMediumCache();
+  if (peer_medium_cache == nullptr || endpoints.size() < 2) return;
+
+  std::vector<Medium> mediums;
+  for (const auto& endpoint : endpoints) {
+    mediums.push_back(endpoint->medium);
+  }
+  std::vector<Medium> ordered_mediums =
+      peer_medium_cache->OrderConnectionMediums(peer_key, mediums);
+  if (ordered_mediums == mediums) return;
+
+  std::vector<std::shared_ptr<DiscoveredEndpoint>> ordered_endpoints;
+  for (Medium medium : ordered_mediums) {
+    for (auto& endpoint : endpoints) {
+      if (endpoint != nullptr && endpoint->medium == medium) {
+        ordered_endpoints.push_back(std::move(endpoint));
+        break;
+      }
+    }
+  }
+  NEARBY_LOGS(INFO) << "Connecting to endpoint(id="
+                    << ordered_endpoints.front()->endpoint_id << ") over "
+                    << location::nearby::proto::connections::Medium_Name(
+                           ordered_endpoints.front()->medium)
+                    << " first, as it worked with the device before";
+  endpoints = std::move(ordered_endpoints);
+}
+
+BasePcpHandler::ConnectImplResult BasePcpHandler::ConnectToDiscoveredEndpoints(
+    ClientProxy* client,
+    const std::vector<std::shared_ptr<DiscoveredEndpoint>>& endpoints) {
+  ConnectImplResult result;
+  if (connection_race_executor_ != nullptr && endpoints.size() > 1) {
+    result = RaceConnectImpl(client, endpoints);
+  } else {
+    for (const auto& endpoint : endpoints) {
+      NEARBY_LOGS(INFO) << "Try to connect with endpoint(id="
+                        << endpoint->endpoint_id << ") by Medium: "
+                        << location::nearby::proto::connections::Medium_Name(
+                               endpoint->medium);
+      result = ConnectImpl(client, endpoint.get());
+      if (result.status.Ok()) break;
+    }
+  }
+  // Attempts that lost a race don't touch the client.
+  if (result.status.Ok() && !result.bluetooth_mac_address.empty()) {
+    client->SetBluetoothMacAddress(endpoints.front()->endpoint_id,
+                                   result.bluetooth_mac_address);
+  }
+  return result;
+}
+
+BasePcpHandler::ConnectImplResult BasePcpHandler::RaceConnectImpl(
+    ClientProxy* client,
+    const std::vector<std::shared_ptr<DiscoveredEndpoint>>& endpoints) {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  const int max_running =
+      std::max<int>(1, flags.medium_connection_racing_max_mediums);
+  const absl::Duration stagger_delay =
+      flags.medium_connection_racing_stagger_delay;
+  const int num_endpoints = endpoints.size();
+  auto race = std::make_shared<ConnectionRace>(num_endpoints);
+
+  // Cancelling the endpoint cancels all the attempts.
+  CancellationFlag* endpoint_cancellation_flag =
+      client->GetCancellationFlag(endpoints.front()->endpoint_id);
+  CancellationFlagListener cancellation_listener(
+      endpoint_cancellation_flag, [race]() {
+        for (CancellationFlag& flag : race->cancellation_flags) {
+          flag.Cancel();
+        }
+      });
+
+  int next = 0;
+  std::optional<int> winner;
+  ConnectImplResult result;
+  {
+    MutexLock lock(&race->mutex);
+    absl::Time next_start_time = absl::InfinitePast();
+    while (!race->winner.has_value()) {
+      absl::Time now = SystemClock::ElapsedRealtime();
+      if (race->attempt_failed) {
+        race->attempt_failed = false;
+        next_start_time = now;
+      }
+      if (next < num_endpoints && race->running < max_running &&
+          now >= next_start_time) {
+        int index = next++;
+        std::shared_ptr<DiscoveredEndpoint> endpoint = endpoints[index];
+        NEARBY_LOGS(INFO) << "Try to connect with endpoint(id="
+                          << endpoint->endpoint_id << ") by Medium: "
+                          << location::nearby::proto::connections::Medium_Name(
+                                 endpoint->medium);
+        if (endpoint_cancellation_flag->Cancelled()) {
+          race->cancellation_flags[index].Cancel();
+        }
+        race->running++;
+        next_start_time = now + stagger_delay;
+        connection_race_executor_->Execute(
+            "connect-race", [this, client, race, index, endpoint]() {
+              ConnectImplResult attempt_result = CancellableConnectImpl(
+                  client, endpoint.get(), &race->cancellation_flags[index]);
+              std::unique_ptr<EndpointChannel> lost_channel;
+              {
+                MutexLock lock(&race->mutex);
+                race->running--;
+                if (!attempt_result.status.Ok()) {
+                  race->attempt_failed = true;
+                  if (!race->winner.has_value()) {
+                    race->result = std::move(attempt_result);
+                  }
+                } else if (race->decided || race->winner.has_value()) {
+                  lost_channel = std::move(attempt_result.endpoint_channel);
+                } else {
+                  race->winner = index;
+                  race->result = std::move(attempt_result);
+                }
+                race->cond.Notify();
+              }
+              if (lost_channel != nullptr) {
+                NEARBY_LOGS(INFO) << "Closing channel to endpoint(id="
+                                  << endpoint->endpoint_id << ") over "
+                                  << lost_channel->GetType()
+                                  << ", which connected after another medium.";
+                lost_channel->Close();
+              }
+            });
+        continue;
+      }
+      if (race->running == 0) {
+        // Every attempt failed.
+        break;
+      }
+      if (next < num_endpoints && race->running < max_running) {
+        race->cond.Wait(next_start_time - now);
+      } else {
+        race->cond.Wait();
+      }
+    }
+    race->decided = true;
+    winner = race->winner;
+    result = std::move(race->result);
+  }
+
+  // Cancel the attempts that lost outside of the lock, so they may finish.
+  for (int i = 0; i < next; i++) {
+    if (i != winner) {
+      race->cancellation_flags[i].Cancel();
+    }
+  }
+  if (winner.has_value()) {
+    NEARBY_LOGS(INFO) << "Connected to endpoint(id="
+                      << endpoints[*winner]->endpoint_id << ") by Medium: "
+                      << location::nearby::proto::connections::Medium_Name(
+                             endpoints[*winner]->medium)
+                      << ", out of " << next << " racing attempts.";
+  }
+  return result;
+}
+
 bool BasePcpHandler::Cancelled(ClientProxy* client,
                                const std::string& endpoint_id) {
   if (endpoint_id.empty()) {
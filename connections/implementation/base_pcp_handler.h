@@ -17,6 +17,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -24,7 +25,6 @@
 
 #include "securegcm/ukey2_handshake.h"
 #include "absl/base/thread_annotations.h"
-#include "absl/container/btree_map.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
@@ -58,10 +58,12 @@
 #include "internal/platform/bluetooth_adapter.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancelable_alarm.h"
+#include "internal/platform/cancellation_flag.h"
 #include "internal/platform/connection_info.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/future.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/nsd_service_info.h"
 #include "internal/platform/runnable.h"
@@ -281,6 +283,9 @@ class BasePcpHandler : public PcpHandler,
         operation_result_code = location::nearby::proto::connections::
             OperationResultCode::DETAIL_UNKNOWN;
     std::unique_ptr<EndpointChannel> endpoint_channel;
+    // The MAC address of the remote device, when connected over Bluetooth.
+    // Only recorded with the client for the connection that is kept.
+    std::string bluetooth_mac_address;
   };
 
   void Shutdown();
@@ -308,6 +313,15 @@ class BasePcpHandler : public PcpHandler,
       location::nearby::proto::connections::Medium medium,
       NearbyDevice::Type listening_device_type);  // throws Exception::IO
 
+  // Handles an incoming connection like OnIncomingConnection(), but reads its
+  // ConnectionRequestFrame on incoming_request_executor_, when there is one,
+  // and then handles the frame on the PCP handler thread.
+  void AcceptIncomingConnection(
+      ClientProxy* client, const ByteArray& remote_endpoint_info,
+      std::unique_ptr<EndpointChannel> endpoint_channel,
+      location::nearby::proto::connections::Medium medium,
+      NearbyDevice::Type listening_device_type);
+
   virtual bool HasOutgoingConnections(ClientProxy* client) const;
   virtual bool HasIncomingConnections(ClientProxy* client) const;
 
@@ -349,6 +363,16 @@ class BasePcpHandler : public PcpHandler,
                                         DiscoveredEndpoint* endpoint)
       RUN_ON_PCP_HANDLER_THREAD() = 0;
 
+  // Same as ConnectImpl(), but the connection attempt is cancelled through
+  // |cancellation_flag| instead of the cancellation flag of the endpoint. Used
+  // to race connection attempts over several mediums, so the attempts that
+  // lose can be cancelled on their own. Runs on the racing threads, not on the
+  // PCP handler thread, so it may only do the medium I/O of the attempt and
+  // must not touch state owned by the PCP handler thread.
+  virtual ConnectImplResult CancellableConnectImpl(
+      ClientProxy* client, DiscoveredEndpoint* endpoint,
+      CancellationFlag* cancellation_flag) = 0;
+
   virtual StartOperationResult UpdateAdvertisingOptionsImpl(
       ClientProxy* client, absl::string_view service_id,
       absl::string_view local_endpoint_id,
@@ -379,18 +403,24 @@ class BasePcpHandler : public PcpHandler,
 
   // Returns the first discovered endpoint for the given endpoint_id.
   DiscoveredEndpoint* GetDiscoveredEndpoint(const std::string& endpoint_id)
-      ABSL_LOCKS_EXCLUDED(discovered_endpoint_mutex_);
+      ABSL_LOCKS_EXCLUDED(discovered_endpoints_snapshot_mutex_);
 
   // Returns a vector of discovered endpoints, sorted in order of decreasing
   // preference.
   std::vector<BasePcpHandler::DiscoveredEndpoint*> GetDiscoveredEndpoints(
       const std::string& endpoint_id)
-      ABSL_LOCKS_EXCLUDED(discovered_endpoint_mutex_);
+      ABSL_LOCKS_EXCLUDED(discovered_endpoints_snapshot_mutex_);
+
+  // Same as above, but shares the ownership of the discovered endpoints, so
+  // they outlive their removal while a connection attempt uses them.
+  std::vector<std::shared_ptr<BasePcpHandler::DiscoveredEndpoint>>
+  GetSharedDiscoveredEndpoints(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(discovered_endpoints_snapshot_mutex_);
 
   // Returns a vector of discovered endpoints that share a given Medium.
   std::vector<BasePcpHandler::DiscoveredEndpoint*> GetDiscoveredEndpoints(
       location::nearby::proto::connections::Medium medium)
-      ABSL_LOCKS_EXCLUDED(discovered_endpoint_mutex_);
+      ABSL_LOCKS_EXCLUDED(discovered_endpoints_snapshot_mutex_);
 
   // Start alarms for endpoints lost by their mediums. Used when updating
   // discovery options.
@@ -484,7 +514,8 @@ class BasePcpHandler : public PcpHandler,
     // Keep track of a channel before we pass it to EndpointChannelManager. This
     // is owned until the call to OnEncryptionSuccessRunnableV3 or
     // OnEncryptionSuccessRunnable when ownership is transferred to the
-    // EndpointManager.
+    // EndpointManager. The device authentication of v3 connections holds it
+    // while it runs.
     std::unique_ptr<EndpointChannel> channel;
 
     // Crypto context; initially empty; established first thing after channel
@@ -500,6 +531,9 @@ class BasePcpHandler : public PcpHandler,
 
     // The medium that the connection was established on.
     location::nearby::proto::connections::Medium medium;
+
+    // When the attempt crossed each of its phase boundaries.
+    ConnectionTimeline timeline;
   };
 
   // @EncryptionRunnerThread
@@ -530,6 +564,13 @@ class BasePcpHandler : public PcpHandler,
       absl::string_view auth_token, const ByteArray& raw_auth_token,
       const EndpointChannel& endpoint_channel,
       const NearbyDeviceProvider& device_provider);
+  // Registers the connection to |endpoint_id| once its device authentication
+  // on |channel| ended with |authentication_status|.
+  void OnDeviceAuthenticationDone(
+      const std::string& endpoint_id, std::unique_ptr<EndpointChannel> channel,
+      std::unique_ptr<::securegcm::UKey2Handshake> ukey2,
+      absl::string_view auth_token, const ByteArray& raw_auth_token,
+      AuthenticationStatus authentication_status);
   void OnEncryptionFailureRunnable(const std::string& endpoint_id,
                                    EndpointChannel* endpoint_channel);
   void RegisterDeviceAfterEncryptionSuccess(
@@ -538,6 +579,22 @@ class BasePcpHandler : public PcpHandler,
       std::string_view auth_token, const ByteArray& raw_auth_token,
       BasePcpHandler::PendingConnectionInfo& connection_info);
 
+  // Resumes the connection to the endpoint parked by the client, if any, by
+  // sending the connection request over its channel, which is still
+  // encrypted. Returns nullopt if there is no parked connection to resume.
+  std::optional<Status> ResumeOutgoingConnection(
+      ClientProxy* client, const std::string& endpoint_id,
+      const ConnectionRequestInfo& info,
+      const ConnectionOptions& connection_options, absl::Time start_time)
+      RUN_ON_PCP_HANDLER_THREAD();
+  // Resumes the connection parked for the endpoint, on the connection request
+  // it sent over the parked channel. Discards the endpoint if there is no
+  // parked connection to resume.
+  void ResumeIncomingConnection(
+      ClientProxy* client, const std::string& endpoint_id,
+      const location::nearby::connections::ConnectionRequestFrame&
+          connection_request) RUN_ON_PCP_HANDLER_THREAD();
+
   static Exception WriteConnectionRequestFrame(
       NearbyDevice::Type device_type, absl::string_view device_proto_bytes,
       const ConnectionInfo& conection_info, EndpointChannel* endpoint_channel);
@@ -563,8 +620,7 @@ class BasePcpHandler : public PcpHandler,
                            PendingConnectionInfo* info);
 
   // Returns true if the bluetooth endpoint based on remote bluetooth mac
-  // address is created and appended into discovered_endpoints_ with key
-  // endpoint_id.
+  // address is created and appended into discovered_endpoints_.
   bool AppendRemoteBluetoothMacAddressEndpoint(
       const std::string& endpoint_id,
       const std::string& remote_bluetooth_mac_address,
@@ -575,7 +631,7 @@ class BasePcpHandler : public PcpHandler,
                                  ClientProxy* client);
 
   // Returns true if the webrtc endpoint is created and appended into
-  // discovered_endpoints_ with key endpoint_id.
+  // discovered_endpoints_.
   bool AppendWebRTCEndpoint(const std::string& endpoint_id,
                             const DiscoveryOptions& local_discovery_options)
       ABSL_LOCKS_EXCLUDED(discovered_endpoint_mutex_);
@@ -608,6 +664,21 @@ class BasePcpHandler : public PcpHandler,
   ExceptionOr<location::nearby::connections::OfflineFrame>
   ReadConnectionRequestFrame(EndpointChannel* channel);
 
+  // Returns whether |client| still waits for incoming connections, and logs
+  // why the connection on |medium| is ignored if not.
+  bool IsAcceptingIncomingConnections(
+      ClientProxy* client, location::nearby::proto::connections::Medium medium);
+
+  // Goes on with an incoming connection once its ConnectionRequestFrame, or
+  // the failure to read it, is in |wrapped_frame|.
+  Exception OnIncomingConnectionRequest(
+      ClientProxy* client, const ByteArray& remote_endpoint_info,
+      std::unique_ptr<EndpointChannel> channel,
+      location::nearby::proto::connections::Medium medium,
+      NearbyDevice::Type listening_device_type, absl::Time start_time,
+      ExceptionOr<location::nearby::connections::OfflineFrame> wrapped_frame,
+      absl::Time request_read_at);
+
   // Returns an 8 characters length hashed string generated via a token byte
   // array.
   std::string GetHashedConnectionToken(const ByteArray& token_bytes);
@@ -627,6 +698,32 @@ class BasePcpHandler : public PcpHandler,
   // endpoint id. This is done by CancellationFlag.
   static bool Cancelled(ClientProxy* client, const std::string& endpoint_id);
 
+  // Moves the endpoints on the mediums that connected to the device of
+  // |peer_key| last time to the front, and the ones on mediums that failed to
+  // the back, if feature flag enable_peer_medium_cache is enabled.
+  void OrderEndpointsForPeer(
+      const std::string& peer_key,
+      std::vector<std::shared_ptr<DiscoveredEndpoint>>& endpoints) const;
+
+  // Connects to the first of |endpoints|, the discovered endpoints of one
+  // remote endpoint in order of preference, that accepts a connection. Tries
+  // them one after the other, or races them when medium connection racing is
+  // enabled. Returns the result of the last failed attempt if none connects.
+  ConnectImplResult ConnectToDiscoveredEndpoints(
+      ClientProxy* client,
+      const std::vector<std::shared_ptr<DiscoveredEndpoint>>& endpoints)
+      RUN_ON_PCP_HANDLER_THREAD();
+
+  // Starts connection attempts to |endpoints| on connection_race_executor_,
+  // at most medium_connection_racing_max_mediums at a time. Every attempt
+  // starts the stagger delay after the one before, or as soon as one fails.
+  // Keeps the channel of the first attempt that connects, and cancels the
+  // others; a channel connected after that is closed.
+  ConnectImplResult RaceConnectImpl(
+      ClientProxy* client,
+      const std::vector<std::shared_ptr<DiscoveredEndpoint>>& endpoints)
+      RUN_ON_PCP_HANDLER_THREAD();
+
   void WaitForLatch(const std::string& method_name, CountDownLatch* latch);
   Status WaitForResult(const std::string& method_name, std::int64_t client_id,
                        Future<Status>* future);
@@ -667,10 +764,58 @@ class BasePcpHandler : public PcpHandler,
   void OptionsAllowed(const BooleanMediumSelector& allowed,
                       std::ostringstream& result) const;
 
+  struct ConnectionRace;
+
+  // A snapshot of the discovered endpoints, indexed by endpoint id and by
+  // medium. A published snapshot is never changed: writers change a copy of
+  // the latest snapshot and publish the copy, so readers never wait for them.
+  class DiscoveredEndpointTable {
+   public:
+    using Endpoints = std::vector<std::shared_ptr<DiscoveredEndpoint>>;
+
+    // Returns the discovered endpoints of |endpoint_id|, in the order they
+    // were added.
+    const Endpoints& Find(const std::string& endpoint_id) const;
+    // Returns the discovered endpoints found over |medium|, in the order they
+    // were added.
+    const Endpoints& Find(
+        location::nearby::proto::connections::Medium medium) const;
+
+    void Add(std::shared_ptr<DiscoveredEndpoint> endpoint);
+    void Remove(const DiscoveredEndpoint* endpoint);
+    void RemoveAll(const std::string& endpoint_id);
+
+   private:
+    absl::flat_hash_map<std::string, Endpoints> by_endpoint_id_;
+    absl::flat_hash_map<location::nearby::proto::connections::Medium,
+                        Endpoints>
+        by_medium_;
+  };
+
+  std::shared_ptr<const DiscoveredEndpointTable> GetDiscoveredEndpointTable()
+      const ABSL_LOCKS_EXCLUDED(discovered_endpoints_snapshot_mutex_);
+  // Publishes |table| as the latest snapshot. Writers hold
+  // discovered_endpoint_mutex_ from reading the snapshot they copy until they
+  // publish the copy, so they don't drop each other's changes.
+  void SetDiscoveredEndpointTable(
+      std::shared_ptr<const DiscoveredEndpointTable> table)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(discovered_endpoint_mutex_)
+          ABSL_LOCKS_EXCLUDED(discovered_endpoints_snapshot_mutex_);
+
   AtomicBoolean closed_{false};
   ScheduledExecutor alarm_executor_;
   SingleThreadExecutor serial_executor_;
-  Mutex discovered_endpoint_mutex_;
+  // Runs racing connection attempts. Only created when medium connection
+  // racing is enabled.
+  std::unique_ptr<MultiThreadExecutor> connection_race_executor_;
+  // Reads the ConnectionRequestFrame of incoming connections. Only created
+  // when asynchronous connection request reads are enabled.
+  std::unique_ptr<MultiThreadExecutor> incoming_request_executor_;
+  // Runs the device authentication of v3 connections. Only created when
+  // asynchronous device authentication is enabled.
+  std::unique_ptr<MultiThreadExecutor> authentication_executor_;
+  Mutex discovered_endpoint_mutex_{
+      "BasePcpHandler::discovered_endpoint_mutex_"};
 
   // A map of endpoint id -> PendingConnectionInfo. Entries in this map imply
   // that there is an active connection to the endpoint and we're waiting for
@@ -678,9 +823,11 @@ class BasePcpHandler : public PcpHandler,
   // the connection is decided (either accepted or rejected), it should be
   // removed from this map.
   absl::flat_hash_map<std::string, PendingConnectionInfo> pending_connections_;
-  // A map of endpoint id -> DiscoveredEndpoint.
-  absl::btree_multimap<std::string, std::shared_ptr<DiscoveredEndpoint>>
-      discovered_endpoints_ ABSL_GUARDED_BY(discovered_endpoint_mutex_);
+  // The latest snapshot of the discovered endpoints.
+  mutable Mutex discovered_endpoints_snapshot_mutex_;
+  std::shared_ptr<const DiscoveredEndpointTable> discovered_endpoints_
+      ABSL_GUARDED_BY(discovered_endpoints_snapshot_mutex_) =
+          std::make_shared<DiscoveredEndpointTable>();
   // A map of endpoint id -> alarm. These alarms delay closing the
   // EndpointChannel to give the other side enough time to read the rejection
   // message. It's expected that the other side will close the connection
@@ -58,6 +58,7 @@
 #include "internal/interop/device.h"
 #include "internal/interop/device_provider.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/feature_flags.h"
 #include "internal/platform/future.h"
@@ -237,6 +238,10 @@ class MockPcpHandler : public BasePcpHandler {
               (override));
   MOCK_METHOD(ConnectImplResult, ConnectImpl,
               (ClientProxy * client, DiscoveredEndpoint* endpoint), (override));
+  MOCK_METHOD(ConnectImplResult, CancellableConnectImpl,
+              (ClientProxy * client, DiscoveredEndpoint* endpoint,
+               CancellationFlag* cancellation_flag),
+              (override));
   MOCK_METHOD(location::nearby::proto::connections::Medium,
               GetDefaultUpgradeMedium, (), (override));
   MOCK_METHOD(StartOperationResult, UpdateAdvertisingOptionsImpl,
@@ -281,6 +286,10 @@ class MockPcpHandler : public BasePcpHandler {
       const std::string& endpoint_id) {
     return BasePcpHandler::GetDiscoveredEndpoints(endpoint_id);
   }
+  std::vector<std::shared_ptr<BasePcpHandler::DiscoveredEndpoint>>
+  GetSharedDiscoveredEndpoints(const std::string& endpoint_id) {
+    return BasePcpHandler::GetSharedDiscoveredEndpoints(endpoint_id);
+  }
 
   std::vector<BasePcpHandler::DiscoveredEndpoint*> GetDiscoveredEndpoints(
       location::nearby::proto::connections::Medium medium) {
@@ -346,6 +355,16 @@ class MockPcpHandler : public BasePcpHandler {
                                                 medium, listening_device_type);
   }
 
+  void AcceptIncomingConnection(
+      ClientProxy* client, const ByteArray& remote_endpoint_info,
+      std::unique_ptr<EndpointChannel> endpoint_channel,
+      location::nearby::proto::connections::Medium medium,
+      NearbyDevice::Type listening_device_type) {
+    BasePcpHandler::AcceptIncomingConnection(
+        client, remote_endpoint_info, std::move(endpoint_channel), medium,
+        listening_device_type);
+  }
+
   bool NeedsToTurnOffAdvertisingMedium(
       location::nearby::proto::connections::Medium medium,
       const AdvertisingOptions& old_options,
@@ -1012,6 +1031,51 @@ TEST_P(BasePcpHandlerTest, StartStopStartDiscoveryClearsEndpoints) {
   env_.Stop();
 }
 
+TEST_F(BasePcpHandlerTest, DiscoveredEndpointsAreIndexedByIdAndMedium) {
+  env_.Start();
+  BooleanMediumSelector allowed{
+      .bluetooth = true,
+      .ble = true,
+      .wifi_lan = true,
+  };
+  auto make_endpoint = [](const std::string& endpoint_id, Medium medium) {
+    return std::make_shared<MockDiscoveredEndpoint>(MockDiscoveredEndpoint{
+        {endpoint_id, ByteArray("1234"), "service", medium,
+         WebRtcState::kUndefined},
+        MockContext{nullptr}});
+  };
+
+  ClientProxy client;
+  Mediums m;
+  EndpointChannelManager ecm;
+  EndpointManager em(&ecm);
+  BwuManager bwu(m, em, ecm, {}, {});
+  MockPcpHandler pcp_handler(&m, &em, &ecm, &bwu);
+  StartDiscovery(&client, &pcp_handler, allowed);
+  EXPECT_CALL(mock_discovery_listener_.endpoint_found_cb, Call).Times(2);
+  pcp_handler.OnEndpointFound(&client, make_endpoint("ABCD", Medium::BLE));
+  pcp_handler.OnEndpointFound(&client, make_endpoint("ABCD", Medium::WIFI_LAN));
+  pcp_handler.OnEndpointFound(&client, make_endpoint("DEFG", Medium::BLE));
+
+  EXPECT_EQ(pcp_handler.GetDiscoveredEndpoints("ABCD").size(), 2);
+  EXPECT_EQ(pcp_handler.GetDiscoveredEndpoints("DEFG").size(), 1);
+  EXPECT_EQ(pcp_handler.GetDiscoveredEndpoints(Medium::BLE).size(), 2);
+  EXPECT_EQ(pcp_handler.GetDiscoveredEndpoints(Medium::WIFI_LAN).size(), 1);
+
+  // An endpoint held by a reader outlives its removal.
+  auto lost_endpoints = pcp_handler.GetSharedDiscoveredEndpoints("DEFG");
+  ASSERT_EQ(lost_endpoints.size(), 1);
+  EXPECT_CALL(mock_discovery_listener_.endpoint_lost_cb, Call).Times(1);
+  pcp_handler.OnEndpointLost(&client, *lost_endpoints[0]);
+
+  EXPECT_EQ(pcp_handler.GetDiscoveredEndpoint("DEFG"), nullptr);
+  EXPECT_EQ(pcp_handler.GetDiscoveredEndpoints(Medium::BLE).size(), 1);
+  EXPECT_EQ(pcp_handler.GetDiscoveredEndpoints("ABCD").size(), 2);
+  EXPECT_EQ(lost_endpoints[0]->endpoint_id, "DEFG");
+  bwu.Shutdown();
+  env_.Stop();
+}
+
 TEST_F(BasePcpHandlerTest, ShouldLostEndpointWhenReportInstantLost) {
   EnableInstantOnLostFeature();
   env_.Start({.use_simulated_clock = true});
@@ -1451,6 +1515,96 @@ TEST_P(BasePcpHandlerTest, RequestConnection_ConnectImplFailure) {
   env_.Stop();
 }
 
+TEST_F(BasePcpHandlerTest, RequestConnection_RacesMediums) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.enable_medium_connection_racing = true;
+  flags.medium_connection_racing_max_mediums = 2;
+  flags.medium_connection_racing_stagger_delay = absl::Milliseconds(10);
+  env_.Start();
+  ClientProxy client;
+  FakePresenceDeviceProvider provider;
+  EXPECT_CALL(provider.local_device_, GetType)
+      .WillRepeatedly(Return(NearbyDevice::Type::kUnknownDevice));
+  client.RegisterDeviceProvider(&provider);
+  Mediums m;
+  EndpointChannelManager ecm;
+  EndpointManager em(&ecm);
+  BwuManager bwu(m, em, ecm, {}, {});
+  MockPcpHandler pcp_handler(&m, &em, &ecm, &bwu);
+  BooleanMediumSelector allowed{
+      .bluetooth = true,
+      .ble = true,
+      .wifi_lan = true,
+  };
+  StartDiscovery(&client, &pcp_handler, allowed);
+  EXPECT_CALL(mock_connection_listener_.rejected_cb, Call).Times(AtLeast(0));
+  ConnectionRequestInfo info{
+      .endpoint_info = ByteArray{"ABCD"},
+      .listener = connection_listener_,
+  };
+  ConnectionOptions connection_options{
+      .keep_alive_interval_millis =
+          FeatureFlags::GetInstance().GetFlags().keep_alive_interval_millis,
+      .keep_alive_timeout_millis =
+          FeatureFlags::GetInstance().GetFlags().keep_alive_timeout_millis,
+  };
+  EXPECT_CALL(mock_discovery_listener_.endpoint_found_cb, Call);
+  EXPECT_CALL(pcp_handler, CanSendOutgoingConnection)
+      .WillRepeatedly(Return(true));
+  EXPECT_CALL(pcp_handler, GetStrategy)
+      .WillRepeatedly(Return(Strategy::kP2pCluster));
+  auto allowed_mediums = pcp_handler.GetDiscoveryMediums(&client);
+  ASSERT_EQ(allowed_mediums.size(), 3);
+
+  // Every attempt fails after a while, so the attempts overlap.
+  std::atomic_int running = 0;
+  std::atomic_int max_running = 0;
+  EXPECT_CALL(pcp_handler, ConnectImpl).Times(0);
+  EXPECT_CALL(pcp_handler, CancellableConnectImpl)
+      .Times(allowed_mediums.size())
+      .WillRepeatedly(Invoke([&running, &max_running](
+                                 ClientProxy* client,
+                                 MockPcpHandler::DiscoveredEndpoint* endpoint,
+                                 CancellationFlag* cancellation_flag) {
+        int now_running = ++running;
+        int max = max_running.load();
+        while (now_running > max &&
+               !max_running.compare_exchange_weak(max, now_running)) {
+        }
+        absl::SleepFor(absl::Milliseconds(100));
+        --running;
+        return MockPcpHandler::ConnectImplResult{
+            .medium = endpoint->medium,
+            .status = {Status::kError},
+            .endpoint_channel = nullptr,
+        };
+      }));
+
+  for (const auto& discovered_medium : allowed_mediums) {
+    pcp_handler.OnEndpointFound(
+        &client,
+        std::make_shared<MockDiscoveredEndpoint>(MockDiscoveredEndpoint{
+            {
+                std::string(kTestEndpointId),
+                info.endpoint_info,
+                "service",
+                discovered_medium,
+                WebRtcState::kUndefined,
+            },
+            MockContext{nullptr},
+        }));
+  }
+  EXPECT_EQ(pcp_handler.RequestConnection(&client, std::string(kTestEndpointId),
+                                          info, connection_options),
+            Status{Status::kError});
+  EXPECT_EQ(max_running.load(), 2);
+  bwu.Shutdown();
+  pcp_handler.DisconnectFromEndpointManager();
+  env_.Stop();
+  flags = saved_flags;
+}
+
 TEST_P(BasePcpHandlerTest, IoError_RequestConnectionV3Fails) {
   env_.Start();
   ClientProxy client;
@@ -2242,6 +2396,45 @@ TEST_F(BasePcpHandlerTest, TestDeviceFilterForConnectionsWithUnknown) {
   env_.Stop();
 }
 
+TEST_F(BasePcpHandlerTest, AsyncRequestReadDoesNotHoldPcpThread) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.enable_async_connection_request_read = true;
+  env_.Start();
+  ClientProxy client;
+  Mediums m;
+  EndpointChannelManager ecm;
+  EndpointManager em(&ecm);
+  BwuManager bwu(m, em, ecm, {}, {});
+  MockPcpHandler pcp_handler(&m, &em, &ecm, &bwu);
+  v3::ConnectionListeningOptions options = {
+      .strategy = Strategy::kP2pCluster,
+      .enable_bluetooth_listening = true,
+      .listening_endpoint_type = NearbyDevice::Type::kConnectionsDevice};
+  EXPECT_CALL(pcp_handler, StartListeningForIncomingConnectionsImpl)
+      .WillOnce(Return(
+          MockPcpHandler::StartOperationResult{.status = {Status::kSuccess}}));
+  ASSERT_TRUE(
+      pcp_handler
+          .StartListeningForIncomingConnections(&client, "service", options, {})
+          .first.Ok());
+  auto channel_pair = SetupConnection(Medium::BLUETOOTH);
+  absl::Time start = absl::Now();
+
+  // The peer never sends its request, but the PCP handler thread goes on.
+  pcp_handler.AcceptIncomingConnection(
+      &client, ByteArray("remote endpoint"), std::move(channel_pair.second),
+      Medium::BLUETOOTH, NearbyDevice::Type::kConnectionsDevice);
+  pcp_handler.StopListeningForIncomingConnections(&client);
+
+  // Reading the request alone would take its 2 second timeout.
+  EXPECT_LT(absl::Now() - start, absl::Seconds(1));
+  EXPECT_FALSE(client.IsListeningForIncomingConnections());
+  pcp_handler.DisconnectFromEndpointManager();
+  env_.Stop();
+  flags = saved_flags;
+}
+
 TEST_F(BasePcpHandlerTest, TestDeviceFilterForPresenceWithUnknown) {
   env_.Start();
   ClientProxy client;
@@ -17,8 +17,11 @@
 #include <string>
 #include <utility>
 
+#include "absl/types/optional.h"
 #include "internal/platform/ble_v2.h"
+#include "internal/platform/implementation/ble_v2.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
 
 namespace nearby {
 namespace connections {
@@ -58,6 +61,40 @@ int BleV2EndpointChannel::GetMaxTransmitPacketSize() const {
   return kDefaultBleMaxTransmitPacketSize;
 }
 
+void BleV2EndpointChannel::RequestHighThroughput() {
+  MutexLock lock(&mutex_);
+  if (high_throughput_requests_++ == 0) {
+    RequestConnectionParameters(/*high_throughput=*/true);
+  }
+}
+
+void BleV2EndpointChannel::ReleaseHighThroughput() {
+  MutexLock lock(&mutex_);
+  // Requests made on a previous channel of the endpoint may be released on
+  // this one.
+  if (high_throughput_requests_ == 0) return;
+  if (--high_throughput_requests_ == 0) {
+    RequestConnectionParameters(/*high_throughput=*/false);
+  }
+}
+
+void BleV2EndpointChannel::RequestConnectionParameters(bool high_throughput) {
+  if (!ble_socket_.IsValid()) return;
+  absl::optional<api::ble_v2::BleConnectionParameters> granted =
+      ble_socket_.RequestConnectionParameters(high_throughput);
+  if (!granted.has_value()) {
+    NEARBY_LOGS(INFO) << "BleEndpointChannel " << GetName()
+                      << " can't change its connection parameters";
+    return;
+  }
+  NEARBY_LOGS(INFO) << "BleEndpointChannel " << GetName() << " switched to "
+                    << (high_throughput ? "high throughput" : "balanced")
+                    << " connection parameters: interval="
+                    << granted->connection_interval
+                    << ", att_mtu=" << granted->att_mtu
+                    << ", le_2m_phy=" << granted->le_2m_phy;
+}
+
 void BleV2EndpointChannel::CloseImpl() {
   Exception status = ble_socket_.Close();
   if (!status.Ok()) {
@@ -17,8 +17,10 @@
 
 #include <string>
 
+#include "absl/base/thread_annotations.h"
 #include "connections/implementation/base_endpoint_channel.h"
 #include "internal/platform/ble_v2.h"
+#include "internal/platform/mutex.h"
 
 namespace nearby {
 namespace connections {
@@ -33,12 +35,21 @@ class BleV2EndpointChannel final : public BaseEndpointChannel {
 
   int GetMaxTransmitPacketSize() const override;
 
+  // Switches the connection to high throughput parameters while at least one
+  // request is held, and back to power-balanced ones after the last release.
+  void RequestHighThroughput() override ABSL_LOCKS_EXCLUDED(mutex_);
+  void ReleaseHighThroughput() override ABSL_LOCKS_EXCLUDED(mutex_);
+
  private:
   static constexpr int kDefaultBleMaxTransmitPacketSize = 512;  // 512 bytes
 
   void CloseImpl() override;
+  void RequestConnectionParameters(bool high_throughput)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   BleV2Socket ble_socket_;
+  Mutex mutex_;
+  int high_throughput_requests_ ABSL_GUARDED_BY(mutex_) = 0;
 };
 
 }  // namespace connections
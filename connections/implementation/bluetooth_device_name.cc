@@ -16,7 +16,9 @@
 
 #include <inttypes.h>
 
+#include <cstdint>
 #include <cstring>
+#include <string>
 #include <utility>
 
 #include "absl/strings/escaping.h"
@@ -24,6 +26,7 @@
 #include "internal/platform/base64_utils.h"
 #include "internal/platform/base_input_stream.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
 
 namespace nearby {
 namespace connections {
@@ -205,5 +208,28 @@ BluetoothDeviceName::operator std::string() const {
   return Base64Utils::Encode(ByteArray{std::move(out)});
 }
 
+BluetoothDeviceName BluetoothDeviceNameCache::Get(
+    absl::string_view bluetooth_device_name_string) {
+  MutexLock lock(&mutex_);
+  std::int64_t use = ++uses_;
+  auto it = names_.find(bluetooth_device_name_string);
+  if (it != names_.end()) {
+    it->second.last_use = use;
+    return it->second.name;
+  }
+
+  if (names_.size() >= kMaxNames) {
+    auto oldest = names_.begin();
+    for (auto entry = names_.begin(); entry != names_.end(); ++entry) {
+      if (entry->second.last_use < oldest->second.last_use) oldest = entry;
+    }
+    names_.erase(oldest);
+  }
+  Entry& entry = names_[bluetooth_device_name_string];
+  entry.name = BluetoothDeviceName(bluetooth_device_name_string);
+  entry.last_use = use;
+  return entry.name;
+}
+
 }  // namespace connections
 }  // namespace nearby
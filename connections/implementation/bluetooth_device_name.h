@@ -15,12 +15,17 @@
 #ifndef CORE_INTERNAL_BLUETOOTH_DEVICE_NAME_H_
 #define CORE_INTERNAL_BLUETOOTH_DEVICE_NAME_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <string>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "connections/implementation/base_pcp_handler.h"
 #include "connections/implementation/pcp.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/mutex.h"
 
 namespace nearby {
 namespace connections {
@@ -85,6 +90,33 @@ class BluetoothDeviceName {
   WebRtcState web_rtc_state_{WebRtcState::kUndefined};
 };
 
+// Remembers the BluetoothDeviceName parsed from each device name string.
+//
+// Bluetooth discovery reports the same devices over and over, and most of
+// them aren't advertising for Nearby at all; the cache spares decoding and
+// parsing their names each time. Only the |kMaxNames| most recently used
+// names are kept.
+class BluetoothDeviceNameCache {
+ public:
+  static constexpr std::size_t kMaxNames = 64;
+
+  // Returns the BluetoothDeviceName parsed from |bluetooth_device_name_string|,
+  // which is invalid if the string isn't a Nearby device name.
+  BluetoothDeviceName Get(absl::string_view bluetooth_device_name_string)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Entry {
+    BluetoothDeviceName name;
+    std::int64_t last_use = 0;
+  };
+
+  Mutex mutex_;
+  absl::flat_hash_map<std::string, Entry> names_ ABSL_GUARDED_BY(mutex_);
+  // Orders the lookups, to find the least recently used name.
+  std::int64_t uses_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
 }  // namespace connections
 }  // namespace nearby
 
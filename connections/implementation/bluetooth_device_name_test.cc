@@ -14,10 +14,13 @@
 
 #include "connections/implementation/bluetooth_device_name.h"
 
+#include <cstddef>
 #include <cstring>
 #include <memory>
+#include <string>
 
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "internal/platform/base64_utils.h"
 
 namespace nearby {
@@ -200,6 +203,39 @@ TEST(BluetoothDeviceNameTest, CanParseGeneratedName) {
   EXPECT_EQ(name1.GetWebRtcState(), name2.GetWebRtcState());
 }
 
+TEST(BluetoothDeviceNameCacheTest, ReturnsParsedNames) {
+  ByteArray service_id_hash{std::string(kServiceIDHashBytes)};
+  ByteArray endpoint_info{std::string(kEndPointName)};
+  std::string name_string(BluetoothDeviceName{
+      kVersion, kPcp, kEndPointID, service_id_hash, endpoint_info, ByteArray{},
+      kWebRtcState});
+  BluetoothDeviceNameCache cache;
+
+  for (int i = 0; i < 2; ++i) {
+    BluetoothDeviceName name = cache.Get(name_string);
+    EXPECT_TRUE(name.IsValid());
+    EXPECT_EQ(name.GetEndpointId(), kEndPointID);
+    EXPECT_EQ(name.GetEndpointInfo(), endpoint_info);
+    EXPECT_EQ(name.GetWebRtcState(), kWebRtcState);
+  }
+  EXPECT_FALSE(cache.Get("Pixel 7").IsValid());
+}
+
+TEST(BluetoothDeviceNameCacheTest, KeepsMostRecentlyUsedNames) {
+  ByteArray service_id_hash{std::string(kServiceIDHashBytes)};
+  ByteArray endpoint_info{std::string(kEndPointName)};
+  std::string name_string(BluetoothDeviceName{
+      kVersion, kPcp, kEndPointID, service_id_hash, endpoint_info, ByteArray{},
+      kWebRtcState});
+  BluetoothDeviceNameCache cache;
+
+  ASSERT_TRUE(cache.Get(name_string).IsValid());
+  for (std::size_t i = 0; i < 2 * BluetoothDeviceNameCache::kMaxNames; ++i) {
+    EXPECT_FALSE(cache.Get(absl::StrCat("device ", i)).IsValid());
+    ASSERT_TRUE(cache.Get(name_string).IsValid());
+  }
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -95,6 +95,17 @@ class BwuHandler {
 
   virtual void OnEndpointDisconnect(ClientProxy* client,
                                     const std::string& endpoint_id) = 0;
+
+  // Called when a connection that may later be upgraded to this medium is
+  // initiated, to prepare what the upgrade doesn't need the remote device
+  // for. |is_initiator| tells whether this device will initiate the upgrade.
+  // Everything prepared for an endpoint that isn't upgraded is released in
+  // OnEndpointDisconnect(). Does nothing by default.
+  // @BwuHandlerThread
+  virtual void PrewarmUpgradedMediumForEndpoint(ClientProxy* client,
+                                                const std::string& service_id,
+                                                const std::string& endpoint_id,
+                                                bool is_initiator) {}
 };
 
 }  // namespace connections
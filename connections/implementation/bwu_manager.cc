@@ -17,22 +17,26 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/bind_front.h"
+#include "absl/strings/str_cat.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/connection_attempt_metadata_params.h"
 #include "connections/implementation/bluetooth_bwu_handler.h"
 #include "connections/implementation/bwu_handler.h"
+#include "connections/implementation/bwu_medium_scorer.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/endpoint_channel_manager.h"
 #include "connections/implementation/endpoint_manager.h"
 #include "connections/implementation/mediums/mediums.h"
 #include "connections/implementation/offline_frames.h"
+#include "connections/implementation/peer_medium_cache.h"
 #include "connections/implementation/service_id_constants.h"
 #ifdef NO_WEBRTC
 #include "connections/implementation/webrtc_bwu_handler_stub.h"
@@ -51,6 +55,8 @@
 #include "internal/platform/implementation/system_clock.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/runnable.h"
+#include "internal/platform/trace_event.h"
+#include "internal/proto/analytics/connections_log.pb.h"
 #include "proto/connections_enums.pb.h"
 
 namespace nearby {
@@ -66,6 +72,22 @@ using ::location::nearby::proto::connections::ConnectionAttemptResult;
 using ::location::nearby::proto::connections::ConnectionAttemptType;
 using ::location::nearby::proto::connections::DisconnectionReason;
 using ::location::nearby::proto::connections::OperationResultCode;
+
+std::vector<::location::nearby::analytics::proto::ConnectionsLog::
+                UpgradeMediumScore>
+ToProto(const std::vector<UpgradeMediumScore>& scores) {
+  std::vector<
+      ::location::nearby::analytics::proto::ConnectionsLog::UpgradeMediumScore>
+      protos;
+  for (const UpgradeMediumScore& score : scores) {
+    auto& proto = protos.emplace_back();
+    proto.set_medium(score.medium);
+    proto.set_estimated_bytes_per_second(score.estimated_bytes_per_second);
+    proto.set_from_history(score.from_history);
+    proto.set_adjustment(score.adjustment);
+  }
+  return protos;
+}
 }  // namespace
 
 BwuManager::BwuManager(
@@ -174,10 +196,15 @@ void BwuManager::Shutdown() {
     if (!channel) continue;
     channel->Close(DisconnectionReason::SHUTDOWN);
   }
+  for (auto& item : pending_upgrade_channels_) {
+    item.second.channel->Close(DisconnectionReason::SHUTDOWN);
+  }
+  pending_upgrade_channels_.clear();
 
   CancelAllRetryUpgradeAlarms();
   medium_ = Medium::UNKNOWN_MEDIUM;
   endpoint_id_to_bwu_medium_.clear();
+  prewarmed_bwu_mediums_.clear();
   for (auto& medium_handler_pair : handlers_) {
     assert(medium_handler_pair.second);
     medium_handler_pair.second->RevertInitiatorState();
@@ -205,16 +232,21 @@ void BwuManager::ShutdownExecutors() {
 void BwuManager::InitiateBwuForEndpoint(ClientProxy* client,
                                         const std::string& endpoint_id,
                                         Medium new_medium) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.bwu", "Initiate",
+                               TraceFlowIdForEndpoint(endpoint_id));
   // Select the best medium if one is not provided.
+  std::vector<UpgradeMediumScore> scores;
   Medium proposed_medium =
       new_medium == Medium::UNKNOWN_MEDIUM
           ? ChooseBestUpgradeMedium(
                 endpoint_id,
-                client->GetUpgradeMediums(endpoint_id).GetMediums(true))
+                client->GetUpgradeMediums(endpoint_id).GetMediums(true),
+                &scores)
           : new_medium;
 
   RunOnBwuManagerThread("bwu-init", [this, client, endpoint_id,
-                                     proposed_medium]() {
+                                     proposed_medium,
+                                     scores = std::move(scores)]() {
     NEARBY_LOGS(INFO) << "InitiateBwuForEndpoint for endpoint " << endpoint_id
                       << " with medium "
                       << location::nearby::proto::connections::Medium_Name(
@@ -258,6 +290,10 @@ void BwuManager::InitiateBwuForEndpoint(ClientProxy* client,
         endpoint_id, channel_medium, proposed_medium,
         location::nearby::proto::connections::INCOMING,
         client->GetConnectionToken(endpoint_id));
+    if (!scores.empty()) {
+      client->GetAnalyticsRecorder().OnBandwidthUpgradeMediumScores(
+          endpoint_id, ToProto(scores));
+    }
     if (channel == nullptr) {
       NEARBY_LOGS(INFO)
           << "BwuManager couldn't complete the upgrade for endpoint "
@@ -339,6 +375,32 @@ void BwuManager::InitiateBwuForEndpoint(ClientProxy* client,
   });
 }
 
+void BwuManager::PrewarmBwuForEndpoint(ClientProxy* client,
+                                       const std::string& endpoint_id,
+                                       bool is_initiator) {
+  if (!FeatureFlags::GetInstance().GetFlags().enable_bwu_prewarm) return;
+
+  Medium medium = ChooseBestUpgradeMedium(
+      endpoint_id, client->GetUpgradeMediums(endpoint_id).GetMediums(true));
+  RunOnBwuManagerThread("bwu-prewarm", [this, client, endpoint_id, medium,
+                                        is_initiator]() {
+    BwuHandler* handler = GetHandlerForMedium(medium);
+    auto channel = channel_manager_->GetChannelForEndpoint(endpoint_id);
+    if (handler == nullptr || channel == nullptr ||
+        channel->GetMedium() == medium) {
+      return;
+    }
+
+    NEARBY_LOGS(INFO) << "BwuManager is preparing the upgrade of endpoint "
+                      << endpoint_id << " to medium "
+                      << location::nearby::proto::connections::Medium_Name(
+                             medium);
+    prewarmed_bwu_mediums_[endpoint_id] = medium;
+    handler->PrewarmUpgradedMediumForEndpoint(client, channel->GetServiceId(),
+                                              endpoint_id, is_initiator);
+  });
+}
+
 void BwuManager::OnIncomingFrame(OfflineFrame& frame,
                                  const std::string& endpoint_id,
                                  ClientProxy* client, Medium medium,
@@ -385,6 +447,13 @@ void BwuManager::OnEndpointDisconnect(ClientProxy* client,
     if (handler) {
       handler->OnEndpointDisconnect(client, endpoint_id);
     }
+    auto prewarmed = prewarmed_bwu_mediums_.extract(endpoint_id);
+    if (!prewarmed.empty() && prewarmed.mapped() != medium) {
+      BwuHandler* prewarmed_handler = GetHandlerForMedium(prewarmed.mapped());
+      if (prewarmed_handler) {
+        prewarmed_handler->OnEndpointDisconnect(client, endpoint_id);
+      }
+    }
 
     auto item = previous_endpoint_channels_.extract(endpoint_id);
     if (!item.empty()) {
@@ -393,6 +462,10 @@ void BwuManager::OnEndpointDisconnect(ClientProxy* client,
         old_channel->Close(DisconnectionReason::SHUTDOWN);
       }
     }
+    auto pending_channel = pending_upgrade_channels_.extract(endpoint_id);
+    if (!pending_channel.empty()) {
+      pending_channel.mapped().channel->Close(DisconnectionReason::SHUTDOWN);
+    }
     in_progress_upgrades_.erase(endpoint_id);
     retry_delays_.erase(endpoint_id);
     CancelRetryUpgradeAlarm(endpoint_id);
@@ -494,6 +567,8 @@ BwuHandler* BwuManager::GetHandlerForMedium(Medium medium) const {
 void BwuManager::OnBwuNegotiationFrame(ClientProxy* client,
                                        const BwuNegotiationFrame frame,
                                        const std::string& endpoint_id) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.bwu", "Negotiation frame",
+                               TraceFlowIdForEndpoint(endpoint_id));
   NEARBY_LOGS(INFO) << "OnBwuNegotiationFrame: processing incoming "
                     << BwuNegotiationFrame::EventType_Name(frame.event_type())
                     << " frame for endpoint " << endpoint_id;
@@ -545,6 +620,7 @@ void BwuManager::OnBwuNegotiationFrame(ClientProxy* client,
 void BwuManager::OnIncomingConnection(
     ClientProxy* client,
     std::unique_ptr<BwuHandler::IncomingSocketConnection> mutable_connection) {
+  NEARBY_TRACE_EVENT("connections.bwu", "Incoming connection");
   NEARBY_LOGS(INFO) << "BwuManager process incoming connection";
   std::shared_ptr<BwuHandler::IncomingSocketConnection> connection(
       mutable_connection.release());
@@ -681,8 +757,21 @@ void BwuManager::RunUpgradeProtocol(
         OperationResultCode::NEARBY_GENERIC_OLD_ENDPOINT_CHANNEL_NULL);
     return;
   }
-  channel_manager_->ReplaceChannelForEndpoint(
-      client, endpoint_id, std::move(new_channel), enable_encryption);
+  if (FeatureFlags::GetInstance().GetFlags().enable_bwu_make_before_break) {
+    // Make-before-break: keep writing over the previous EndpointChannel, and
+    // only hand writes over to the new one once the last encrypted frame has
+    // been written to the previous one, in
+    // ProcessLastWriteToPriorChannelEvent(). The remote device reads the
+    // previous EndpointChannel until it is closed, so it still receives these
+    // writes, in order, whether or not it does the same.
+    pending_upgrade_channels_.insert_or_assign(
+        endpoint_id, PendingUpgradeChannel{.channel = std::move(new_channel),
+                                           .enable_encryption =
+                                               enable_encryption});
+  } else {
+    channel_manager_->ReplaceChannelForEndpoint(
+        client, endpoint_id, std::move(new_channel), enable_encryption);
+  }
 
   // Next, initiate a clean shutdown for the previous EndpointChannel used for
   // this endpoint by telling the remote device that it will not receive any
@@ -722,6 +811,8 @@ void BwuManager::RunUpgradeProtocol(
 void BwuManager::ProcessBwuPathAvailableEvent(
     ClientProxy* client, const std::string& endpoint_id,
     const UpgradePathInfo& upgrade_path_info) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.bwu", "Path available",
+                               TraceFlowIdForEndpoint(endpoint_id));
   Medium upgrade_medium =
       parser::UpgradePathInfoMediumToMedium(upgrade_path_info.medium());
   NEARBY_LOGS(INFO) << "ProcessBwuPathAvailableEvent for endpoint "
@@ -772,6 +863,10 @@ void BwuManager::ProcessBwuPathAvailableEvent(
       new_channel->Resume();
       new_channel->Close(DisconnectionReason::UNFINISHED);
     }
+    auto pending_channel = pending_upgrade_channels_.extract(endpoint_id);
+    if (!pending_channel.empty()) {
+      pending_channel.mapped().channel->Close(DisconnectionReason::UNFINISHED);
+    }
 
     return;
   }
@@ -973,6 +1068,8 @@ BwuManager::ProcessBwuPathAvailableEventInternal(
 void BwuManager::RunUpgradeFailedProtocol(
     ClientProxy* client, const std::string& endpoint_id,
     const UpgradePathInfo& upgrade_path_info) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.bwu", "Upgrade failed protocol",
+                               TraceFlowIdForEndpoint(endpoint_id));
   NEARBY_LOGS(INFO) << "RunUpgradeFailedProtocol for endpoint " << endpoint_id
                     << " medium "
                     << location::nearby::proto::connections::Medium_Name(
@@ -1114,6 +1211,8 @@ bool BwuManager::WriteClientIntroductionAckFrame(EndpointChannel* channel) {
 
 void BwuManager::ProcessLastWriteToPriorChannelEvent(
     ClientProxy* client, const std::string& endpoint_id) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.bwu", "Last write to prior channel",
+                               TraceFlowIdForEndpoint(endpoint_id));
   // By this point in the upgrade protocol, there is the guarantee that both
   // involved endpoints have registered a new EndpointChannel with the
   // EndpointChannelManager as the official channel for communication; given
@@ -1140,7 +1239,17 @@ void BwuManager::ProcessLastWriteToPriorChannelEvent(
                     << location::nearby::proto::connections::Medium_Name(
                            previous_endpoint_channel->GetMedium());
 
-  if (!previous_endpoint_channel->Write(parser::ForBwuSafeToClose()).Ok()) {
+  Exception write_result;
+  auto pending_channel = pending_upgrade_channels_.extract(endpoint_id);
+  if (!pending_channel.empty()) {
+    write_result = HandOffToUpgradedChannel(
+        client, endpoint_id, previous_endpoint_channel,
+        std::move(pending_channel.mapped()));
+  } else {
+    write_result =
+        previous_endpoint_channel->Write(parser::ForBwuSafeToClose());
+  }
+  if (!write_result.Ok()) {
     previous_endpoint_channel->Close(DisconnectionReason::IO_ERROR);
     // Remove this prior EndpointChannel from previous_endpoint_channels to
     // avoid leaks.
@@ -1168,8 +1277,44 @@ void BwuManager::ProcessLastWriteToPriorChannelEvent(
   // from the remote device.
 }
 
+Exception BwuManager::HandOffToUpgradedChannel(
+    ClientProxy* client, const std::string& endpoint_id,
+    EndpointChannel* previous_endpoint_channel,
+    PendingUpgradeChannel pending_channel) {
+  // The new EndpointChannel is still paused, so writers that pick it up from
+  // here on wait until the SAFE_TO_CLOSE_PRIOR_CHANNEL frame, the last frame
+  // encrypted on the previous EndpointChannel, has been written.
+  EndpointChannel* new_channel = pending_channel.channel.get();
+  channel_manager_->ReplaceChannelForEndpoint(
+      client, endpoint_id, std::move(pending_channel.channel),
+      pending_channel.enable_encryption);
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr || channel.get() != new_channel) {
+    NEARBY_LOGS(WARNING)
+        << "BwuManager couldn't register the upgraded EndpointChannel for "
+           "endpoint "
+        << endpoint_id << "; keep writing over the previous one.";
+    return previous_endpoint_channel->Write(parser::ForBwuSafeToClose());
+  }
+
+  // Writers still holding the previous EndpointChannel are redirected to the
+  // new one.
+  Exception write_result = previous_endpoint_channel->WriteAndHandOff(
+      parser::ForBwuSafeToClose(), channel);
+  channel->Resume();
+  NEARBY_LOGS(INFO) << "BwuManager handed writes for endpoint " << endpoint_id
+                    << " over to the upgraded "
+                    << location::nearby::proto::connections::Medium_Name(
+                           channel->GetMedium())
+                    << " EndpointChannel.";
+  return write_result;
+}
+
 void BwuManager::ProcessSafeToClosePriorChannelEvent(
     ClientProxy* client, const std::string& endpoint_id) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.bwu", "Safe to close prior channel",
+                               TraceFlowIdForEndpoint(endpoint_id));
   NEARBY_LOGS(INFO) << "ProcessSafeToClosePriorChannelEvent for endpoint "
                     << endpoint_id;
   // By this point in the upgrade protocol, there's no more writes happening
@@ -1244,6 +1389,7 @@ void BwuManager::ProcessSafeToClosePriorChannelEvent(
   }
 
   channel->Resume();
+  RecordUpgradeForPeer(endpoint_id, channel->GetMedium(), /*succeeded=*/true);
 
   // Report the success to the client
   Medium medium = channel->GetMedium();
@@ -1262,6 +1408,8 @@ void BwuManager::ProcessUpgradeFailureEvent(
     ClientProxy* client, const std::string& endpoint_id,
     const UpgradePathInfo& upgrade_info, BandwidthUpgradeResult result,
     bool record_analytic, OperationResultCode operation_result_code) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.bwu", "Upgrade failure",
+                               TraceFlowIdForEndpoint(endpoint_id));
   NEARBY_LOGS(INFO) << "ProcessUpgradeFailureEvent for endpoint " << endpoint_id
                     << " from medium: "
                     << location::nearby::proto::connections::Medium_Name(
@@ -1314,8 +1462,8 @@ void BwuManager::ProcessUpgradeFailureEvent(
   // top element until we get to the medium we last attempted to upgrade to. The
   // remainder of the list will contain the mediums we haven't attempted yet.
   Medium last = parser::UpgradePathInfoMediumToMedium(upgrade_info.medium());
-  std::vector<Medium> all_possible_mediums =
-      client->GetUpgradeMediums(endpoint_id).GetMediums(true);
+  std::vector<Medium> all_possible_mediums = OrderUpgradeMediums(
+      endpoint_id, client->GetUpgradeMediums(endpoint_id).GetMediums(true));
   std::vector<Medium> untried_mediums(all_possible_mediums);
   for (Medium medium : all_possible_mediums) {
     untried_mediums.erase(untried_mediums.begin());
@@ -1323,6 +1471,8 @@ void BwuManager::ProcessUpgradeFailureEvent(
       break;
     }
   }
+  // Recorded only now, so the order above is the one the upgrade used.
+  RecordUpgradeForPeer(endpoint_id, last, /*succeeded=*/false);
 
   TryNextBestUpgradeMediums(client, endpoint_id, untried_mediums);
 }
@@ -1404,6 +1554,59 @@ std::vector<Medium> BwuManager::StripOutUnavailableMediums(
   return available_mediums;
 }
 
+std::vector<Medium> BwuManager::OrderUpgradeMediums(
+    const std::string& endpoint_id, const std::vector<Medium>& mediums,
+    std::vector<UpgradeMediumScore>* scores) const {
+  if (!FeatureFlags::GetInstance().GetFlags().enable_bwu_medium_scoring) {
+    return mediums;
+  }
+  api::WifiInformation& wifi_information = mediums_->GetWifi().GetInformation();
+  UpgradeRadioState radio_state{
+      .wifi_lan_connected = channel_manager_->isWifiLanConnected(),
+      .ap_connected = wifi_information.is_connected,
+      .ap_frequency = wifi_information.ap_frequency,
+  };
+  std::optional<PeerMediumCache::PeerStats> peer;
+  if (PeerMediumCache* peer_medium_cache =
+          endpoint_manager_->GetPeerMediumCache()) {
+    peer =
+        peer_medium_cache->GetPeer(endpoint_manager_->GetPeerKey(endpoint_id));
+  }
+  std::vector<UpgradeMediumScore> medium_scores = ScoreUpgradeMediums(
+      endpoint_id, mediums, radio_state,
+      endpoint_manager_->GetMediumThroughputHistory(),
+      peer.has_value() ? &*peer : nullptr);
+
+  std::vector<Medium> ordered_mediums;
+  std::string scores_string;
+  for (const UpgradeMediumScore& score : medium_scores) {
+    if (score.estimated_bytes_per_second > 0) {
+      ordered_mediums.push_back(score.medium);
+    }
+    absl::StrAppend(
+        &scores_string,
+        location::nearby::proto::connections::Medium_Name(score.medium), "=",
+        score.estimated_bytes_per_second,
+        score.from_history ? " measured" : "",
+        score.adjustment.empty() ? "" : absl::StrCat(", ", score.adjustment),
+        "; ");
+  }
+  NEARBY_LOGS(INFO) << "Upgrade mediums for endpoint " << endpoint_id
+                    << " by estimated bytes per second: " << scores_string;
+  if (scores != nullptr) {
+    *scores = std::move(medium_scores);
+  }
+  return ordered_mediums;
+}
+
+void BwuManager::RecordUpgradeForPeer(const std::string& endpoint_id,
+                                      Medium medium, bool succeeded) {
+  PeerMediumCache* peer_medium_cache = endpoint_manager_->GetPeerMediumCache();
+  if (peer_medium_cache == nullptr) return;
+  peer_medium_cache->RecordUpgrade(endpoint_manager_->GetPeerKey(endpoint_id),
+                                   medium, succeeded);
+}
+
 // Returns the optimal medium supported by both devices.
 // Each medium in the passed in list is checked for its availability with the
 // medium_manager_ to ensure that the chosen upgrade medium is supported and
@@ -1415,14 +1618,16 @@ std::vector<Medium> BwuManager::StripOutUnavailableMediums(
 // connections (although it's suboptimal for bandwidth throughput). When all
 // endpoints disconnect, we reset the bandwidth upgrade medium.
 Medium BwuManager::ChooseBestUpgradeMedium(
-    const std::string& endpoint_id, const std::vector<Medium>& mediums) const {
-  auto available_mediums = StripOutUnavailableMediums(mediums);
+    const std::string& endpoint_id, const std::vector<Medium>& mediums,
+    std::vector<UpgradeMediumScore>* scores) const {
+  auto available_mediums = StripOutUnavailableMediums(
+      OrderUpgradeMediums(endpoint_id, mediums, scores));
   Medium current_medium = GetBwuMediumForEndpoint(endpoint_id);
   if (current_medium == Medium::UNKNOWN_MEDIUM) {
     if (!available_mediums.empty()) {
       // Case 1: This is our first time upgrading, and we have at least one
       // supported medium to choose from. Return the first medium in the list,
-      // since they are ordered by preference.
+      // since they are ordered by preference, or by estimated throughput.
       return available_mediums[0];
     }
     // Case 2: This is our first time upgrading, but there are no available
@@ -24,6 +24,7 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/time/time.h"
 #include "connections/implementation/bwu_handler.h"
+#include "connections/implementation/bwu_medium_scorer.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/endpoint_channel_manager.h"
@@ -32,6 +33,7 @@
 #include "connections/medium_selector.h"
 #include "internal/platform/cancelable_alarm.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/exception.h"
 #include "internal/platform/expected.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/scheduled_executor.h"
@@ -87,6 +89,14 @@ class BwuManager : public EndpointManager::FrameProcessor {
                               const std::string& endpoint_id,
                               Medium new_medium = Medium::UNKNOWN_MEDIUM);
 
+  // Lets the handler of the medium the endpoint would be upgraded to prepare
+  // the upgrade, if feature flag enable_bwu_prewarm is enabled. Called when a
+  // connection is initiated; |is_initiator| tells whether this device will
+  // initiate the upgrade.
+  void PrewarmBwuForEndpoint(ClientProxy* client,
+                             const std::string& endpoint_id,
+                             bool is_initiator);
+
   // == EndpointManager::FrameProcessor interface ==.
   // This is also an entry point for handling messages for both outbound and
   // inbound BWU protocol.
@@ -129,12 +139,31 @@ class BwuManager : public EndpointManager::FrameProcessor {
   static constexpr absl::Duration kReadClientIntroductionFrameTimeout =
       absl::Seconds(5);
 
+  // An upgraded EndpointChannel waiting for a make-before-break upgrade to
+  // hand writes over to it.
+  struct PendingUpgradeChannel {
+    std::unique_ptr<EndpointChannel> channel;
+    bool enable_encryption;
+  };
+
   void InitBwuHandlers();
   void RunOnBwuManagerThread(const std::string& name, Runnable runnable);
   std::vector<Medium> StripOutUnavailableMediums(
       const std::vector<Medium>& mediums) const;
-  Medium ChooseBestUpgradeMedium(const std::string& endpoint_id,
-                                 const std::vector<Medium>& mediums) const;
+  // Orders |mediums| by their estimated throughput with the endpoint, and
+  // leaves out the ones that must not be used, if feature flag
+  // enable_bwu_medium_scoring is enabled; fills in |scores| then, if not
+  // null. Returns |mediums| as they are otherwise.
+  std::vector<Medium> OrderUpgradeMediums(
+      const std::string& endpoint_id, const std::vector<Medium>& mediums,
+      std::vector<UpgradeMediumScore>* scores = nullptr) const;
+  Medium ChooseBestUpgradeMedium(
+      const std::string& endpoint_id, const std::vector<Medium>& mediums,
+      std::vector<UpgradeMediumScore>* scores = nullptr) const;
+  // Records the outcome of an upgrade of |endpoint_id| to |medium| in the
+  // PeerMediumCache, if feature flag enable_peer_medium_cache is enabled.
+  void RecordUpgradeForPeer(const std::string& endpoint_id, Medium medium,
+                            bool succeeded);
 
   // BaseBwuHandler
   using ClientIntroduction = BwuNegotiationFrame::ClientIntroduction;
@@ -182,6 +211,13 @@ class BwuManager : public EndpointManager::FrameProcessor {
                                            const std::string& endpoint_id);
   void ProcessSafeToClosePriorChannelEvent(ClientProxy* client,
                                            const std::string& endpoint_id);
+  // Registers the pending upgraded EndpointChannel of a make-before-break
+  // upgrade, and hands the writes of |previous_endpoint_channel| over to it
+  // with the SAFE_TO_CLOSE_PRIOR_CHANNEL frame.
+  Exception HandOffToUpgradedChannel(
+      ClientProxy* client, const std::string& endpoint_id,
+      EndpointChannel* previous_endpoint_channel,
+      PendingUpgradeChannel pending_channel);
   bool ReadClientIntroductionFrame(EndpointChannel* endpoint_channel,
                                    ClientIntroduction& introduction);
   bool ReadClientIntroductionAckFrame(EndpointChannel* endpoint_channel);
@@ -236,6 +272,11 @@ class BwuManager : public EndpointManager::FrameProcessor {
   absl::flat_hash_map<std::string, std::shared_ptr<EndpointChannel>>
       previous_endpoint_channels_;
   absl::flat_hash_set<std::string> successfully_upgraded_endpoints_;
+  // Stores each endpoint's upgraded EndpointChannel while a make-before-break
+  // upgrade completes, until ProcessLastWriteToPriorChannelEvent() hands writes
+  // over to it. The prior EndpointChannel stays in use until then.
+  absl::flat_hash_map<std::string, PendingUpgradeChannel>
+      pending_upgrade_channels_;
   // Maps endpointId -> ClientProxy for which
   // initiateBwuForEndpoint() has been called but which have not
   // yet completed the upgrade via onIncomingConnection().
@@ -250,6 +291,10 @@ class BwuManager : public EndpointManager::FrameProcessor {
   // retry happen, then we can not find the last delay used in the alarm. Thus
   // using a different map to keep track of the delays per endpoint.
   absl::flat_hash_map<std::string, absl::Duration> retry_delays_;
+  // Maps endpointId -> the medium whose handler prepared its upgrade in
+  // PrewarmBwuForEndpoint(), so the handler hears of its disconnection even if
+  // the upgrade never started.
+  absl::flat_hash_map<std::string, Medium> prewarmed_bwu_mediums_;
 };
 
 }  // namespace connections
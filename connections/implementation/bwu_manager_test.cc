@@ -398,6 +398,51 @@ TEST_P(BwuManagerTestParam,
   UnRegisterChannelForEndpoint(kEndpointId1);
 }
 
+TEST_F(BwuManagerTest, InitiateBwu_MakeBeforeBreak_KeepsWritingOnPriorChannel) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_bwu_make_before_break = true;
+  FakeEndpointChannel* initial_channel = CreateInitialEndpoint(
+      &client_, kServiceIdA, kEndpointId1, Medium::BLUETOOTH);
+  // Keeps the initial channel alive once the upgrade has dropped it.
+  std::shared_ptr<EndpointChannel> shared_initial_channel =
+      ecm_.GetChannelForEndpoint(std::string(kEndpointId1));
+  bwu_manager_->InitiateBwuForEndpoint(&client_, std::string(kEndpointId1),
+                                       Medium::WEB_RTC);
+
+  // The upgraded channel is connected, but writes keep going over the initial
+  // channel.
+  FakeEndpointChannel* upgraded_channel =
+      fake_web_rtc_bwu_handler_->NotifyBwuManagerOfIncomingConnection(
+          /*initialize_call_index=*/0u, bwu_manager_.get());
+  EXPECT_EQ(initial_channel,
+            ecm_.GetChannelForEndpoint(std::string(kEndpointId1)).get());
+  EXPECT_FALSE(initial_channel->IsPaused());
+
+  // Writes move to the upgraded channel once SAFE_TO_CLOSE_PRIOR_CHANNEL is
+  // written, in reply to the remote LAST_WRITE_TO_PRIOR_CHANNEL.
+  ExceptionOr<OfflineFrame> last_write_frame =
+      parser::FromBytes(parser::ForBwuLastWrite());
+  bwu_manager_->OnIncomingFrame(last_write_frame.result(),
+                                std::string(kEndpointId1), &client_,
+                                Medium::BLUETOOTH, packet_meta_data_);
+  EXPECT_EQ(upgraded_channel,
+            ecm_.GetChannelForEndpoint(std::string(kEndpointId1)).get());
+  EXPECT_FALSE(upgraded_channel->IsPaused());
+  EXPECT_FALSE(initial_channel->is_closed());
+
+  ExceptionOr<OfflineFrame> safe_to_close_frame =
+      parser::FromBytes(parser::ForBwuSafeToClose());
+  bwu_manager_->OnIncomingFrame(safe_to_close_frame.result(),
+                                std::string(kEndpointId1), &client_,
+                                Medium::BLUETOOTH, packet_meta_data_);
+  EXPECT_TRUE(initial_channel->is_closed());
+  EXPECT_EQ(location::nearby::proto::connections::DisconnectionReason::UPGRADED,
+            initial_channel->disconnection_reason());
+  EXPECT_FALSE(upgraded_channel->IsPaused());
+  FeatureFlags::GetMutableFlagsForTesting().enable_bwu_make_before_break =
+      false;
+  UnRegisterChannelForEndpoint(kEndpointId1);
+}
+
 TEST_F(BwuManagerTest,
        InitiateBwu_Revert_OnDisconnect_MultipleEndpoints_FlagEnabled) {
   FeatureFlags::GetMutableFlagsForTesting().support_multiple_bwu_mediums = true;
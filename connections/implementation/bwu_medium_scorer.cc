@@ -0,0 +1,122 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/bwu_medium_scorer.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "connections/implementation/medium_throughput_history.h"
+#include "connections/implementation/peer_medium_cache.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+
+// Typical throughput of each medium, used until one is measured.
+std::int64_t GetDefaultBytesPerSecond(Medium medium) {
+  switch (medium) {
+    case Medium::WIFI_LAN:
+      return 12 * 1024 * 1024;
+    case Medium::WIFI_DIRECT:
+      return 10 * 1024 * 1024;
+    case Medium::WIFI_HOTSPOT:
+      return 8 * 1024 * 1024;
+    case Medium::WEB_RTC:
+    case Medium::WEB_RTC_NON_CELLULAR:
+      return 1024 * 1024;
+    case Medium::BLUETOOTH:
+      return 150 * 1024;
+    case Medium::BLE:
+      return 30 * 1024;
+    default:
+      return 0;
+  }
+}
+
+bool Is24GhzFrequency(int frequency) {
+  return frequency > 0 && frequency < 3000;
+}
+
+}  // namespace
+
+std::vector<UpgradeMediumScore> ScoreUpgradeMediums(
+    const std::string& endpoint_id, const std::vector<Medium>& mediums,
+    const UpgradeRadioState& radio_state,
+    const MediumThroughputHistory& history,
+    const PeerMediumCache::PeerStats* peer) {
+  std::vector<UpgradeMediumScore> scores;
+  scores.reserve(mediums.size());
+  for (Medium medium : mediums) {
+    UpgradeMediumScore score{.medium = medium};
+    if (medium == Medium::WIFI_HOTSPOT && radio_state.wifi_lan_connected) {
+      // Joining the hotspot would drop the endpoints on WIFI_LAN.
+      score.adjustment = "WIFI_LAN in use";
+      scores.push_back(score);
+      continue;
+    }
+    const PeerMediumCache::MediumStats* peer_stats = nullptr;
+    if (peer != nullptr) {
+      auto it = peer->find(medium);
+      if (it != peer->end()) peer_stats = &it->second;
+    }
+    std::optional<std::int64_t> measured =
+        history.GetBytesPerSecond(endpoint_id, medium);
+    if (measured.has_value()) {
+      score.estimated_bytes_per_second = *measured;
+      score.from_history = true;
+    } else if (peer_stats != nullptr && peer_stats->bytes_per_second > 0) {
+      score.estimated_bytes_per_second = peer_stats->bytes_per_second;
+      score.from_history = true;
+    } else {
+      score.estimated_bytes_per_second = GetDefaultBytesPerSecond(medium);
+      if (medium == Medium::WIFI_LAN &&
+          Is24GhzFrequency(radio_state.ap_frequency)) {
+        score.estimated_bytes_per_second /= 2;
+        score.adjustment = "2.4 GHz AP";
+      } else if (medium == Medium::WIFI_HOTSPOT && radio_state.ap_connected) {
+        // The radio is shared with the AP, or the AP is dropped.
+        score.estimated_bytes_per_second /= 2;
+        score.adjustment = "AP connected";
+      }
+    }
+    if (peer_stats != nullptr &&
+        !peer_stats->last_upgrade_succeeded.value_or(true)) {
+      score.estimated_bytes_per_second /= 2;
+      score.adjustment = score.adjustment.empty()
+                             ? "last upgrade failed"
+                             : absl::StrCat(score.adjustment,
+                                            ", last upgrade failed");
+    }
+    scores.push_back(score);
+  }
+  std::stable_sort(scores.begin(), scores.end(),
+                   [](const UpgradeMediumScore& a,
+                      const UpgradeMediumScore& b) {
+                     return a.estimated_bytes_per_second >
+                            b.estimated_bytes_per_second;
+                   });
+  return scores;
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,65 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_BWU_MEDIUM_SCORER_H_
+#define CORE_INTERNAL_BWU_MEDIUM_SCORER_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "connections/implementation/medium_throughput_history.h"
+#include "connections/implementation/peer_medium_cache.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+
+// The state of the local radios that bears on the upgrade mediums.
+struct UpgradeRadioState {
+  // Some endpoint is connected over WIFI_LAN.
+  bool wifi_lan_connected = false;
+  // The WiFi interface is associated with an AP.
+  bool ap_connected = false;
+  // The frequency of that AP in MHz, or -1.
+  int ap_frequency = -1;
+};
+
+struct UpgradeMediumScore {
+  location::nearby::proto::connections::Medium medium;
+  std::int64_t estimated_bytes_per_second = 0;
+  // The estimate was measured with the endpoint, rather than a default.
+  bool from_history = false;
+  // Why the estimate was lowered, or empty.
+  std::string adjustment;
+};
+
+// Scores the upgrade |mediums| of |endpoint_id| by their estimated
+// throughput: the one measured with the endpoint before, if any, or with its
+// device in an earlier session, per |peer|, or else a default for the medium
+// lowered for the current |radio_state|. A medium the last upgrade of the
+// device to failed scores half. Returns the scores best first; mediums
+// scoring the same keep their order in |mediums|, which is the order of
+// preference. A medium scoring 0 must not be used. |peer| may be null.
+std::vector<UpgradeMediumScore> ScoreUpgradeMediums(
+    const std::string& endpoint_id,
+    const std::vector<location::nearby::proto::connections::Medium>& mediums,
+    const UpgradeRadioState& radio_state,
+    const MediumThroughputHistory& history,
+    const PeerMediumCache::PeerStats* peer = nullptr);
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_BWU_MEDIUM_SCORER_H_
@@ -0,0 +1,113 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/bwu_medium_scorer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "connections/implementation/medium_throughput_history.h"
+#include "connections/implementation/peer_medium_cache.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+
+constexpr std::int64_t kBytes = MediumThroughputHistory::kMinSampleBytes;
+
+std::vector<Medium> GetMediums(const std::vector<UpgradeMediumScore>& scores) {
+  std::vector<Medium> mediums;
+  for (const auto& score : scores) mediums.push_back(score.medium);
+  return mediums;
+}
+
+TEST(BwuMediumScorerTest, DefaultsKeepPreferenceOrderOfWifiMediums) {
+  MediumThroughputHistory history;
+
+  std::vector<UpgradeMediumScore> scores = ScoreUpgradeMediums(
+      "ABCD",
+      {Medium::WIFI_LAN, Medium::WIFI_DIRECT, Medium::WIFI_HOTSPOT,
+       Medium::BLUETOOTH},
+      UpgradeRadioState(), history);
+
+  EXPECT_EQ(GetMediums(scores),
+            (std::vector<Medium>{Medium::WIFI_LAN, Medium::WIFI_DIRECT,
+                                 Medium::WIFI_HOTSPOT, Medium::BLUETOOTH}));
+  EXPECT_FALSE(scores[0].from_history);
+  EXPECT_TRUE(scores[0].adjustment.empty());
+}
+
+TEST(BwuMediumScorerTest, PrefersMeasuredThroughput) {
+  MediumThroughputHistory history;
+  history.Record("ABCD", Medium::WIFI_LAN, kBytes, 2 * 1024 * 1024);
+
+  std::vector<UpgradeMediumScore> scores = ScoreUpgradeMediums(
+      "ABCD", {Medium::WIFI_LAN, Medium::WIFI_DIRECT}, UpgradeRadioState(),
+      history);
+
+  EXPECT_EQ(GetMediums(scores),
+            (std::vector<Medium>{Medium::WIFI_DIRECT, Medium::WIFI_LAN}));
+  EXPECT_TRUE(scores[1].from_history);
+  EXPECT_EQ(scores[1].estimated_bytes_per_second, 2 * 1024 * 1024);
+}
+
+TEST(BwuMediumScorerTest, LowersWifiLanOn24GhzAp) {
+  MediumThroughputHistory history;
+
+  std::vector<UpgradeMediumScore> scores = ScoreUpgradeMediums(
+      "ABCD", {Medium::WIFI_LAN, Medium::WIFI_DIRECT},
+      UpgradeRadioState{.ap_connected = true, .ap_frequency = 2437}, history);
+
+  EXPECT_EQ(GetMediums(scores),
+            (std::vector<Medium>{Medium::WIFI_DIRECT, Medium::WIFI_LAN}));
+  EXPECT_EQ(scores[1].adjustment, "2.4 GHz AP");
+}
+
+TEST(BwuMediumScorerTest, RulesOutHotspotWhileWifiLanIsUsed) {
+  MediumThroughputHistory history;
+  history.Record("ABCD", Medium::WIFI_HOTSPOT, kBytes, 20 * 1024 * 1024);
+
+  std::vector<UpgradeMediumScore> scores = ScoreUpgradeMediums(
+      "ABCD", {Medium::WIFI_HOTSPOT, Medium::BLUETOOTH},
+      UpgradeRadioState{.wifi_lan_connected = true}, history);
+
+  EXPECT_EQ(GetMediums(scores),
+            (std::vector<Medium>{Medium::BLUETOOTH, Medium::WIFI_HOTSPOT}));
+  EXPECT_EQ(scores[1].estimated_bytes_per_second, 0);
+}
+
+TEST(BwuMediumScorerTest, UsesPeerStatsFromEarlierSessions) {
+  MediumThroughputHistory history;
+  PeerMediumCache::PeerStats peer;
+  peer[Medium::WIFI_LAN].bytes_per_second = 2 * 1024 * 1024;
+  peer[Medium::WIFI_DIRECT].last_upgrade_succeeded = false;
+
+  std::vector<UpgradeMediumScore> scores = ScoreUpgradeMediums(
+      "ABCD", {Medium::WIFI_LAN, Medium::WIFI_DIRECT, Medium::WIFI_HOTSPOT},
+      UpgradeRadioState(), history, &peer);
+
+  EXPECT_EQ(GetMediums(scores),
+            (std::vector<Medium>{Medium::WIFI_HOTSPOT, Medium::WIFI_DIRECT,
+                                 Medium::WIFI_LAN}));
+  EXPECT_EQ(scores[1].estimated_bytes_per_second, 5 * 1024 * 1024);
+  EXPECT_EQ(scores[1].adjustment, "last upgrade failed");
+  EXPECT_TRUE(scores[2].from_history);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
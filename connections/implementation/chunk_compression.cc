@@ -0,0 +1,230 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_compression.h"
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace nearby {
+namespace connections {
+namespace chunk_compression {
+
+namespace {
+
+// Constants of the LZ4 block format.
+constexpr std::size_t kMinMatch = 4;
+// The last match must start at least this many bytes before the end.
+constexpr std::size_t kMatchStartLimit = 12;
+// The last this many bytes are always literals.
+constexpr std::size_t kLastLiterals = 5;
+constexpr std::size_t kMaxOffset = 65535;
+constexpr int kHashBits = 14;
+
+std::uint32_t Load32(const char* p) {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+std::uint32_t Hash(std::uint32_t sequence) {
+  return (sequence * 2654435761U) >> (32 - kHashBits);
+}
+
+void AppendLength(std::string& out, std::size_t length) {
+  while (length >= 255) {
+    out.push_back(static_cast<char>(255));
+    length -= 255;
+  }
+  out.push_back(static_cast<char>(length));
+}
+
+// Appends a sequence of the literals in [literals, literals + literal_length)
+// followed by a match, or by nothing if |match_length| is 0.
+void AppendSequence(std::string& out, const char* literals,
+                    std::size_t literal_length, std::size_t offset,
+                    std::size_t match_length) {
+  std::size_t match_code = match_length == 0 ? 0 : match_length - kMinMatch;
+  out.push_back(static_cast<char>(((literal_length < 15 ? literal_length : 15)
+                                   << 4) |
+                                  (match_code < 15 ? match_code : 15)));
+  if (literal_length >= 15) AppendLength(out, literal_length - 15);
+  out.append(literals, literal_length);
+  if (match_length == 0) return;
+  out.push_back(static_cast<char>(offset & 0xff));
+  out.push_back(static_cast<char>(offset >> 8));
+  if (match_code >= 15) AppendLength(out, match_code - 15);
+}
+
+void AppendVarint(std::string& out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+std::optional<std::uint64_t> ReadVarint(absl::string_view& in) {
+  std::uint64_t value = 0;
+  for (int shift = 0; shift < 64 && !in.empty(); shift += 7) {
+    auto byte = static_cast<std::uint8_t>(in.front());
+    in.remove_prefix(1);
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return value;
+  }
+  return std::nullopt;
+}
+
+// Reads the extra bytes of a literal or match length that didn't fit in the
+// token.
+bool ReadLength(absl::string_view& in, std::size_t& length) {
+  std::uint8_t byte;
+  do {
+    if (in.empty()) return false;
+    byte = static_cast<std::uint8_t>(in.front());
+    in.remove_prefix(1);
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+void CompressBlock(absl::string_view in, std::string& out) {
+  const char* base = in.data();
+  std::size_t size = in.size();
+  std::size_t anchor = 0;
+  if (size >= kMatchStartLimit + 1) {
+    std::vector<std::int32_t> table(std::size_t{1} << kHashBits, -1);
+    std::size_t match_end_limit = size - kLastLiterals;
+    std::size_t pos = 0;
+    while (pos + kMatchStartLimit <= size) {
+      std::uint32_t sequence = Load32(base + pos);
+      std::uint32_t hash = Hash(sequence);
+      std::int32_t candidate = table[hash];
+      table[hash] = static_cast<std::int32_t>(pos);
+      if (candidate < 0 ||
+          pos - static_cast<std::size_t>(candidate) > kMaxOffset ||
+          Load32(base + candidate) != sequence) {
+        pos++;
+        continue;
+      }
+      std::size_t length = kMinMatch;
+      while (pos + length < match_end_limit &&
+             base[candidate + length] == base[pos + length]) {
+        length++;
+      }
+      AppendSequence(out, base + anchor, pos - anchor, pos - candidate,
+                     length);
+      pos += length;
+      anchor = pos;
+    }
+  }
+  AppendSequence(out, base + anchor, size - anchor, /*offset=*/0,
+                 /*match_length=*/0);
+}
+
+}  // namespace
+
+double EstimateEntropy(absl::string_view data) {
+  if (data.empty()) return 0;
+  std::size_t samples =
+      data.size() < kEntropySampleSize ? data.size() : kEntropySampleSize;
+  std::size_t stride = data.size() / samples;
+  std::array<std::size_t, 256> counts{};
+  for (std::size_t i = 0; i < samples; i++) {
+    counts[static_cast<std::uint8_t>(data[i * stride])]++;
+  }
+  double entropy = 0;
+  for (std::size_t count : counts) {
+    if (count == 0) continue;
+    double p = static_cast<double>(count) / samples;
+    entropy -= p * std::log2(p);
+  }
+  return entropy;
+}
+
+std::optional<std::string> Compress(absl::string_view body) {
+  if (body.size() < kMinBodySize ||
+      EstimateEntropy(body) > kMaxEntropyBitsPerByte) {
+    return std::nullopt;
+  }
+  std::string compressed;
+  compressed.reserve(body.size());
+  AppendVarint(compressed, body.size());
+  CompressBlock(body, compressed);
+  if (compressed.size() > body.size() - body.size() / 8) return std::nullopt;
+  return compressed;
+}
+
+std::optional<std::string> Decompress(absl::string_view compressed,
+                                      std::size_t max_size) {
+  std::optional<std::uint64_t> size = ReadVarint(compressed);
+  if (!size.has_value() || *size > max_size) return std::nullopt;
+
+  std::string out;
+  out.reserve(*size);
+  while (!compressed.empty()) {
+    auto token = static_cast<std::uint8_t>(compressed.front());
+    compressed.remove_prefix(1);
+
+    std::size_t literal_length = token >> 4;
+    if (literal_length == 15 && !ReadLength(compressed, literal_length)) {
+      return std::nullopt;
+    }
+    if (literal_length > compressed.size() ||
+        literal_length > *size - out.size()) {
+      return std::nullopt;
+    }
+    out.append(compressed.data(), literal_length);
+    compressed.remove_prefix(literal_length);
+    // The last sequence has no match.
+    if (compressed.empty()) break;
+
+    if (compressed.size() < 2) return std::nullopt;
+    std::size_t offset = static_cast<std::uint8_t>(compressed[0]) |
+                         static_cast<std::uint8_t>(compressed[1]) << 8;
+    compressed.remove_prefix(2);
+    std::size_t match_length = token & 0x0f;
+    if (match_length == 15 && !ReadLength(compressed, match_length)) {
+      return std::nullopt;
+    }
+    match_length += kMinMatch;
+    if (offset == 0 || offset > out.size() ||
+        match_length > *size - out.size()) {
+      return std::nullopt;
+    }
+    std::size_t from = out.size() - offset;
+    if (offset >= match_length) {
+      out.append(out, from, match_length);
+    } else {
+      // The match overlaps the bytes it produces.
+      for (std::size_t i = 0; i < match_length; i++) {
+        out.push_back(out[from + i]);
+      }
+    }
+  }
+  if (out.size() != *size) return std::nullopt;
+  return out;
+}
+
+}  // namespace chunk_compression
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,65 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_CHUNK_COMPRESSION_H_
+#define CORE_INTERNAL_CHUNK_COMPRESSION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace nearby {
+namespace connections {
+
+// Compression of the bodies of payload chunks flagged COMPRESSED.
+//
+// A compressed body is the size of the uncompressed body as a base 128
+// varint, followed by a single block in the LZ4 block format. Each chunk is
+// compressed on its own, so chunks can still be sent and received
+// independently.
+namespace chunk_compression {
+
+// The version advertised in
+// ConnectionResponseFrame.payload_compression_version.
+inline constexpr std::int32_t kVersion = 1;
+
+// Bodies smaller than this aren't worth the varint and the LZ4 token.
+inline constexpr std::size_t kMinBodySize = 64;
+// The entropy of at most this many bytes is estimated before compressing.
+inline constexpr std::size_t kEntropySampleSize = 4096;
+// Bodies whose sample has more bits of entropy per byte are taken to be
+// compressed or encrypted already, and are sent as they are.
+inline constexpr double kMaxEntropyBitsPerByte = 7.5;
+
+// Returns the Shannon entropy of the byte distribution of up to
+// |kEntropySampleSize| bytes spread evenly over |data|, in bits per byte.
+double EstimateEntropy(absl::string_view data);
+
+// Returns the compressed |body|, or nothing if |body| is too small, looks
+// incompressible, or wouldn't shrink by at least an eighth.
+std::optional<std::string> Compress(absl::string_view body);
+
+// Returns the body |compressed| was compressed from, or nothing if it is
+// malformed or its body would be larger than |max_size| bytes.
+std::optional<std::string> Decompress(absl::string_view compressed,
+                                      std::size_t max_size);
+
+}  // namespace chunk_compression
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_CHUNK_COMPRESSION_H_
@@ -0,0 +1,143 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_compression.h"
+
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+
+namespace nearby {
+namespace connections {
+namespace chunk_compression {
+namespace {
+
+std::string RandomBytes(std::size_t size) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::string bytes(size, '\0');
+  for (char& byte : bytes) byte = static_cast<char>(distribution(generator));
+  return bytes;
+}
+
+std::string Json(int records) {
+  std::string json = "[";
+  for (int i = 0; i < records; i++) {
+    absl::StrAppend(&json, "{\"id\":", i, ",\"name\":\"endpoint-", i % 7,
+                    "\",\"connected\":true},");
+  }
+  json.back() = ']';
+  return json;
+}
+
+void ExpectRoundTrip(const std::string& body) {
+  std::optional<std::string> compressed = Compress(body);
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_LE(compressed->size(), body.size() - body.size() / 8);
+
+  std::optional<std::string> decompressed =
+      Decompress(*compressed, body.size());
+  ASSERT_TRUE(decompressed.has_value());
+  EXPECT_EQ(*decompressed, body);
+}
+
+TEST(ChunkCompressionTest, RoundTripsJson) { ExpectRoundTrip(Json(100)); }
+
+TEST(ChunkCompressionTest, RoundTripsRuns) {
+  // A single repeated byte decodes from matches overlapping their output.
+  ExpectRoundTrip(std::string(1000, 'a'));
+  ExpectRoundTrip(absl::StrCat(std::string(100, 'a'), "abcabcabcabcabcabc",
+                               std::string(100, 'b')));
+}
+
+TEST(ChunkCompressionTest, RoundTripsLargeBodies) {
+  // Long literal runs between matches further apart than the LZ4 window.
+  std::string random = RandomBytes(200);
+  std::string body;
+  for (int i = 0; i < 2000; i++) {
+    absl::StrAppend(&body, Json(3), random.substr(i % 100, 20));
+  }
+  ASSERT_GT(body.size(), 64 * 1024);
+
+  ExpectRoundTrip(body);
+}
+
+TEST(ChunkCompressionTest, SkipsSmallBodies) {
+  EXPECT_FALSE(Compress(std::string(kMinBodySize - 1, 'a')).has_value());
+  EXPECT_TRUE(Compress(std::string(kMinBodySize, 'a')).has_value());
+}
+
+TEST(ChunkCompressionTest, SkipsIncompressibleBodies) {
+  std::string random = RandomBytes(64 * 1024);
+
+  EXPECT_GT(EstimateEntropy(random), kMaxEntropyBitsPerByte);
+  EXPECT_FALSE(Compress(random).has_value());
+}
+
+TEST(ChunkCompressionTest, EstimatesEntropy) {
+  EXPECT_EQ(EstimateEntropy(""), 0);
+  EXPECT_EQ(EstimateEntropy(std::string(100, 'a')), 0);
+  EXPECT_DOUBLE_EQ(EstimateEntropy("abababab"), 1);
+}
+
+TEST(ChunkCompressionTest, RejectsBodiesLargerThanMaxSize) {
+  std::string body = Json(100);
+  std::optional<std::string> compressed = Compress(body);
+  ASSERT_TRUE(compressed.has_value());
+
+  EXPECT_FALSE(Decompress(*compressed, body.size() - 1).has_value());
+}
+
+TEST(ChunkCompressionTest, RejectsTruncatedInput) {
+  std::string body = Json(100);
+  std::optional<std::string> compressed = Compress(body);
+  ASSERT_TRUE(compressed.has_value());
+
+  for (std::size_t size = 0; size < compressed->size(); size++) {
+    EXPECT_FALSE(Decompress(compressed->substr(0, size), body.size()))
+        << "size " << size;
+  }
+}
+
+TEST(ChunkCompressionTest, RejectsMalformedInput) {
+  // Size 8, then a match before any output.
+  EXPECT_FALSE(Decompress(std::string("\x08\x04\x01\x00", 4), 100));
+  // Size 8, then a match with offset 0.
+  EXPECT_FALSE(
+      Decompress(std::string("\x08\x14"
+                             "a\x00\x00",
+                             5),
+                 100));
+  // Size 2, but 3 literals.
+  EXPECT_FALSE(Decompress(std::string("\x02\x30"
+                                      "abc",
+                                      5),
+                          100));
+  // Size 3, but 2 literals.
+  EXPECT_FALSE(Decompress(std::string("\x03\x20"
+                                      "ab",
+                                      4),
+                          100));
+  // An unterminated varint.
+  EXPECT_FALSE(Decompress("\x80\x80", 100));
+}
+
+}  // namespace
+}  // namespace chunk_compression
+}  // namespace connections
+}  // namespace nearby
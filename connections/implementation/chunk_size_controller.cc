@@ -0,0 +1,82 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_size_controller.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "absl/time/time.h"
+#include "connections/implementation/analytics/packet_meta_data.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+namespace connections {
+
+ChunkSizeController::ChunkSizeController(absl::Duration target_frame_duration,
+                                         int grow_after_frames)
+    : target_frame_duration_(target_frame_duration),
+      grow_after_frames_(std::max(grow_after_frames, 1)) {}
+
+int ChunkSizeController::GetChunkSize(const std::string& endpoint_id,
+                                      int max_chunk_size) {
+  MutexLock lock(&mutex_);
+  return GetStateLocked(endpoint_id, max_chunk_size).chunk_size;
+}
+
+int ChunkSizeController::OnFrameSent(
+    const std::string& endpoint_id, int max_chunk_size,
+    analytics::PacketMetaData packet_meta_data) {
+  absl::Duration frame_duration =
+      absl::Milliseconds(packet_meta_data.GetFileIoTimeInMillis() +
+                         packet_meta_data.GetEncryptionTimeInMillis() +
+                         packet_meta_data.GetSocketIoTimeInMillis());
+  int min_chunk_size = std::min(
+      max_chunk_size, std::max(max_chunk_size / kMaxShrinkFactor,
+                               kMinChunkSize));
+
+  MutexLock lock(&mutex_);
+  EndpointState& state = GetStateLocked(endpoint_id, max_chunk_size);
+  if (frame_duration > target_frame_duration_) {
+    state.chunk_size = std::max(state.chunk_size / 2, min_chunk_size);
+    state.fast_frames = 0;
+  } else if (frame_duration * 2 <= target_frame_duration_) {
+    if (++state.fast_frames >= grow_after_frames_) {
+      state.chunk_size = static_cast<int>(std::min<std::int64_t>(
+          std::int64_t{state.chunk_size} * 2, max_chunk_size));
+      state.fast_frames = 0;
+    }
+  } else {
+    state.fast_frames = 0;
+  }
+  return state.chunk_size;
+}
+
+void ChunkSizeController::RemoveEndpoint(const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+  endpoints_.erase(endpoint_id);
+}
+
+ChunkSizeController::EndpointState& ChunkSizeController::GetStateLocked(
+    const std::string& endpoint_id, int max_chunk_size) {
+  EndpointState& state = endpoints_[endpoint_id];
+  if (state.max_chunk_size != max_chunk_size) {
+    state = {.max_chunk_size = max_chunk_size, .chunk_size = max_chunk_size};
+  }
+  return state;
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,82 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_CHUNK_SIZE_CONTROLLER_H_
+#define CORE_INTERNAL_CHUNK_SIZE_CONTROLLER_H_
+
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/implementation/analytics/packet_meta_data.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace connections {
+
+// Picks the size of outgoing payload chunks per endpoint from the time it
+// took to send the previous chunks.
+//
+// Every endpoint starts at the maximum chunk size of its medium. A chunk that
+// takes longer than |target_frame_duration| to read, encrypt and write halves
+// the chunk size; |grow_after_frames| chunks in a row that take less than half
+// of it double the chunk size again. The size always stays between
+// max_chunk_size / kMaxShrinkFactor and max_chunk_size, and starts over from
+// max_chunk_size when the medium changes it, e.g. after a bandwidth upgrade.
+class ChunkSizeController {
+ public:
+  static constexpr int kMaxShrinkFactor = 16;
+  static constexpr int kMinChunkSize = 512;
+
+  ChunkSizeController(absl::Duration target_frame_duration,
+                      int grow_after_frames);
+
+  // Returns the chunk size to use for the next chunk sent to |endpoint_id|.
+  int GetChunkSize(const std::string& endpoint_id, int max_chunk_size)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Updates the chunk size of |endpoint_id| from the timings of a data frame
+  // that was sent to it. Returns the new chunk size.
+  int OnFrameSent(const std::string& endpoint_id, int max_chunk_size,
+                  analytics::PacketMetaData packet_meta_data)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Forgets the state of |endpoint_id|.
+  void RemoveEndpoint(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct EndpointState {
+    int max_chunk_size = 0;
+    int chunk_size = 0;
+    int fast_frames = 0;
+  };
+
+  EndpointState& GetStateLocked(const std::string& endpoint_id,
+                                int max_chunk_size)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const absl::Duration target_frame_duration_;
+  const int grow_after_frames_;
+
+  Mutex mutex_;
+  absl::flat_hash_map<std::string, EndpointState> endpoints_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_CHUNK_SIZE_CONTROLLER_H_
@@ -0,0 +1,136 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/chunk_size_controller.h"
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "connections/implementation/analytics/packet_meta_data.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::nearby::analytics::PacketMetaData;
+
+constexpr absl::Duration kTarget = absl::Milliseconds(100);
+constexpr int kMaxChunkSize = 64 * 1024;
+constexpr char kEndpointId[] = "endpoint";
+
+PacketMetaData MakeFrame(absl::Duration socket_io_time) {
+  PacketMetaData packet_meta_data;
+  absl::Time start = absl::UnixEpoch() + absl::Seconds(1);
+  packet_meta_data.file_io_start_time = start;
+  packet_meta_data.file_io_end_time = start;
+  packet_meta_data.encryption_start_time = start;
+  packet_meta_data.encryption_end_time = start;
+  packet_meta_data.socket_io_start_time = start;
+  packet_meta_data.socket_io_end_time = start + socket_io_time;
+  return packet_meta_data;
+}
+
+TEST(ChunkSizeControllerTest, StartsAtMaxChunkSize) {
+  ChunkSizeController controller(kTarget, /*grow_after_frames=*/2);
+
+  EXPECT_EQ(controller.GetChunkSize(kEndpointId, kMaxChunkSize),
+            kMaxChunkSize);
+}
+
+TEST(ChunkSizeControllerTest, SlowFramesShrinkDownToLowerBound) {
+  ChunkSizeController controller(kTarget, /*grow_after_frames=*/2);
+
+  EXPECT_EQ(controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                                   MakeFrame(absl::Milliseconds(300))),
+            kMaxChunkSize / 2);
+  for (int i = 0; i < 10; i++) {
+    controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                           MakeFrame(absl::Milliseconds(300)));
+  }
+  EXPECT_EQ(controller.GetChunkSize(kEndpointId, kMaxChunkSize),
+            kMaxChunkSize / ChunkSizeController::kMaxShrinkFactor);
+}
+
+TEST(ChunkSizeControllerTest, ConsecutiveFastFramesGrowUpToMax) {
+  ChunkSizeController controller(kTarget, /*grow_after_frames=*/2);
+  controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(300)));
+  controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(300)));
+  ASSERT_EQ(controller.GetChunkSize(kEndpointId, kMaxChunkSize),
+            kMaxChunkSize / 4);
+
+  // One fast frame is not enough; a frame close to the target resets the run.
+  controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(10)));
+  controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(80)));
+  controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(10)));
+  EXPECT_EQ(controller.GetChunkSize(kEndpointId, kMaxChunkSize),
+            kMaxChunkSize / 4);
+
+  EXPECT_EQ(controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                                   MakeFrame(absl::Milliseconds(10))),
+            kMaxChunkSize / 2);
+  for (int i = 0; i < 10; i++) {
+    controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                           MakeFrame(absl::Milliseconds(10)));
+  }
+  EXPECT_EQ(controller.GetChunkSize(kEndpointId, kMaxChunkSize),
+            kMaxChunkSize);
+}
+
+TEST(ChunkSizeControllerTest, EndpointsAreTrackedSeparately) {
+  ChunkSizeController controller(kTarget, /*grow_after_frames=*/2);
+
+  controller.OnFrameSent("slow", kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(300)));
+
+  EXPECT_EQ(controller.GetChunkSize("slow", kMaxChunkSize), kMaxChunkSize / 2);
+  EXPECT_EQ(controller.GetChunkSize("fast", kMaxChunkSize), kMaxChunkSize);
+}
+
+TEST(ChunkSizeControllerTest, MaxChunkSizeChangeStartsOver) {
+  ChunkSizeController controller(kTarget, /*grow_after_frames=*/2);
+  controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(300)));
+
+  EXPECT_EQ(controller.GetChunkSize(kEndpointId, 4 * kMaxChunkSize),
+            4 * kMaxChunkSize);
+}
+
+TEST(ChunkSizeControllerTest, SmallMaxChunkSizeIsNotShrunkBelowMinimum) {
+  ChunkSizeController controller(kTarget, /*grow_after_frames=*/2);
+
+  controller.OnFrameSent(kEndpointId, 1024, MakeFrame(absl::Milliseconds(300)));
+  controller.OnFrameSent(kEndpointId, 1024, MakeFrame(absl::Milliseconds(300)));
+
+  EXPECT_EQ(controller.GetChunkSize(kEndpointId, 1024),
+            ChunkSizeController::kMinChunkSize);
+}
+
+TEST(ChunkSizeControllerTest, RemoveEndpointResetsState) {
+  ChunkSizeController controller(kTarget, /*grow_after_frames=*/2);
+  controller.OnFrameSent(kEndpointId, kMaxChunkSize,
+                         MakeFrame(absl::Milliseconds(300)));
+
+  controller.RemoveEndpoint(kEndpointId);
+
+  EXPECT_EQ(controller.GetChunkSize(kEndpointId, kMaxChunkSize),
+            kMaxChunkSize);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
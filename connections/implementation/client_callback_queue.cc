@@ -0,0 +1,152 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/client_callback_queue.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+namespace connections {
+
+ClientCallbackQueue::ClientCallbackQueue(std::size_t max_pending,
+                                         absl::Duration max_wait)
+    : max_pending_(std::max<std::size_t>(max_pending, 1)),
+      max_wait_(max_wait) {}
+
+ClientCallbackQueue::~ClientCallbackQueue() {
+  {
+    MutexLock lock(&mutex_);
+    stopped_ = true;
+    coalescible_entries_.clear();
+    entries_.clear();
+    cond_.Notify();
+  }
+  executor_.Shutdown();
+
+  MutexLock lock(&mutex_);
+  if (stats_.delivered > 0) {
+    NEARBY_LOGS(INFO) << "ClientCallbackQueue: delivered=" << stats_.delivered
+                      << "; coalesced=" << stats_.coalesced
+                      << "; overflowed=" << stats_.overflowed
+                      << "; mean_delay="
+                      << stats_.total_delay / stats_.delivered
+                      << "; max_delay=" << stats_.max_delay
+                      << "; max_duration=" << stats_.max_duration;
+  }
+}
+
+void ClientCallbackQueue::Post(absl::AnyInvocable<void()> callback) {
+  Post(/*coalescing_key=*/"", std::move(callback));
+}
+
+void ClientCallbackQueue::Post(const std::string& coalescing_key,
+                               absl::AnyInvocable<void()> callback) {
+  MutexLock lock(&mutex_);
+  if (stopped_) return;
+  auto it = coalescible_entries_.find(coalescing_key);
+  if (it == coalescible_entries_.end() && entries_.size() >= max_pending_) {
+    absl::Time deadline = SystemClock::ElapsedRealtime() + max_wait_;
+    while (!stopped_ && entries_.size() >= max_pending_) {
+      absl::Duration remaining = deadline - SystemClock::ElapsedRealtime();
+      if (remaining <= absl::ZeroDuration()) {
+        stats_.overflowed++;
+        break;
+      }
+      cond_.Wait(remaining);
+    }
+    if (stopped_) return;
+    it = coalescible_entries_.find(coalescing_key);
+  }
+  if (it != coalescible_entries_.end()) {
+    it->second->callback = std::move(callback);
+    stats_.coalesced++;
+    return;
+  }
+  Enqueue(Entry{
+      .coalescing_key = coalescing_key,
+      .callback = std::move(callback),
+      .posted = SystemClock::ElapsedRealtime(),
+  });
+}
+
+void ClientCallbackQueue::Flush() {
+  MutexLock lock(&mutex_);
+  while (!stopped_ && delivering_) cond_.Wait();
+}
+
+ClientCallbackQueue::Stats ClientCallbackQueue::GetStats() const {
+  MutexLock lock(&mutex_);
+  return stats_;
+}
+
+void ClientCallbackQueue::Enqueue(Entry entry) {
+  entries_.push_back(std::move(entry));
+  Entry& queued = entries_.back();
+  if (!queued.coalescing_key.empty()) {
+    coalescible_entries_[queued.coalescing_key] = &queued;
+  }
+  if (delivering_) return;
+  delivering_ = true;
+  executor_.Execute("client-callbacks", [this]() { Deliver(); });
+}
+
+void ClientCallbackQueue::Deliver() {
+  while (true) {
+    Entry entry;
+    {
+      MutexLock lock(&mutex_);
+      if (stopped_ || entries_.empty()) {
+        delivering_ = false;
+        cond_.Notify();
+        return;
+      }
+      entry = std::move(entries_.front());
+      entries_.pop_front();
+      if (!entry.coalescing_key.empty()) {
+        coalescible_entries_.erase(entry.coalescing_key);
+      }
+      // Wakes up the threads waiting for room.
+      cond_.Notify();
+    }
+
+    absl::Time start = SystemClock::ElapsedRealtime();
+    entry.callback();
+    absl::Time end = SystemClock::ElapsedRealtime();
+
+    absl::Duration delay = start - entry.posted;
+    absl::Duration duration = end - start;
+    if (duration >= kSlowCallbackDuration) {
+      NEARBY_LOGS(WARNING) << "ClientCallbackQueue: a client callback ran for "
+                           << duration << "; queued for " << delay;
+    }
+    MutexLock lock(&mutex_);
+    stats_.delivered++;
+    stats_.total_delay += delay;
+    stats_.max_delay = std::max(stats_.max_delay, delay);
+    stats_.total_duration += duration;
+    stats_.max_duration = std::max(stats_.max_duration, duration);
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
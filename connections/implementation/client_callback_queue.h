@@ -0,0 +1,114 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_CLIENT_CALLBACK_QUEUE_H_
+#define CORE_INTERNAL_CLIENT_CALLBACK_QUEUE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+
+// Delivers the listener callbacks of a client on a thread of its own, in the
+// order they were posted, so a slow client never stalls the thread reporting
+// the event.
+//
+// A callback posted with a coalescing key replaces the callback with the same
+// key that is still waiting, if any, in its place in the queue: a client that
+// lags behind gets the latest progress of a payload once, instead of every
+// update in between.
+//
+// Once |max_pending| callbacks wait, posting another one waits up to
+// |max_wait| for the client to catch up, and then queues it anyway; callbacks
+// are never dropped, and the reporting thread is never held for longer.
+class ClientCallbackQueue {
+ public:
+  // Callbacks running for longer than this are logged.
+  static constexpr absl::Duration kSlowCallbackDuration =
+      absl::Milliseconds(100);
+
+  struct Stats {
+    std::int64_t delivered = 0;
+    // Callbacks replaced by a later one with the same coalescing key.
+    std::int64_t coalesced = 0;
+    // Callbacks queued after waiting |max_wait| for room.
+    std::int64_t overflowed = 0;
+    // Time from posting a callback to running it.
+    absl::Duration total_delay = absl::ZeroDuration();
+    absl::Duration max_delay = absl::ZeroDuration();
+    // Time spent running callbacks.
+    absl::Duration total_duration = absl::ZeroDuration();
+    absl::Duration max_duration = absl::ZeroDuration();
+  };
+
+  ClientCallbackQueue(std::size_t max_pending, absl::Duration max_wait);
+  // Drops the callbacks still waiting, and waits for the running one.
+  ~ClientCallbackQueue();
+
+  ClientCallbackQueue(const ClientCallbackQueue&) = delete;
+  ClientCallbackQueue& operator=(const ClientCallbackQueue&) = delete;
+
+  void Post(absl::AnyInvocable<void()> callback) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Replaces the waiting callback posted with |coalescing_key|, if any.
+  void Post(const std::string& coalescing_key,
+            absl::AnyInvocable<void()> callback) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Waits until the callbacks posted so far are delivered. Must not be
+  // called from a callback.
+  void Flush() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  Stats GetStats() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Entry {
+    std::string coalescing_key;
+    absl::AnyInvocable<void()> callback;
+    absl::Time posted;
+  };
+
+  void Enqueue(Entry entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Runs the queued callbacks until the queue is empty.
+  void Deliver() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const std::size_t max_pending_;
+  const absl::Duration max_wait_;
+  mutable Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  // Set while a Deliver() task is scheduled or running.
+  bool delivering_ ABSL_GUARDED_BY(mutex_) = false;
+  std::deque<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // The waiting entries posted with a coalescing key. Pushing to and popping
+  // from the ends of |entries_| keeps these pointers valid.
+  absl::flat_hash_map<std::string, Entry*> coalescible_entries_
+      ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+  SingleThreadExecutor executor_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_CLIENT_CALLBACK_QUEUE_H_
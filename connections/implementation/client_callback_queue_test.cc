@@ -0,0 +1,138 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/client_callback_queue.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+TEST(ClientCallbackQueueTest, DeliversCallbacksInOrder) {
+  ClientCallbackQueue queue(/*max_pending=*/16, absl::Milliseconds(10));
+  std::vector<std::string> delivered;
+
+  queue.Post([&]() { delivered.push_back("a"); });
+  queue.Post("key", [&]() { delivered.push_back("b"); });
+  queue.Post([&]() { delivered.push_back("c"); });
+  queue.Flush();
+
+  EXPECT_THAT(delivered, ElementsAre("a", "b", "c"));
+  EXPECT_EQ(queue.GetStats().delivered, 3);
+}
+
+TEST(ClientCallbackQueueTest, SlowCallbackDoesNotBlockPost) {
+  ClientCallbackQueue queue(/*max_pending=*/16, absl::Milliseconds(10));
+  CountDownLatch started(1);
+  CountDownLatch released(1);
+  CountDownLatch delivered(1);
+
+  queue.Post([&]() {
+    started.CountDown();
+    released.Await();
+  });
+  ASSERT_TRUE(started.Await(kDefaultTimeout).result());
+  absl::Time start = absl::Now();
+  queue.Post([&]() { delivered.CountDown(); });
+
+  EXPECT_LT(absl::Now() - start, absl::Milliseconds(10));
+  released.CountDown();
+  EXPECT_TRUE(delivered.Await(kDefaultTimeout).result());
+}
+
+TEST(ClientCallbackQueueTest, CoalescesWaitingCallbacks) {
+  ClientCallbackQueue queue(/*max_pending=*/16, absl::Milliseconds(10));
+  CountDownLatch started(1);
+  CountDownLatch released(1);
+  std::vector<std::string> delivered;
+
+  queue.Post([&]() {
+    started.CountDown();
+    released.Await();
+  });
+  ASSERT_TRUE(started.Await(kDefaultTimeout).result());
+  queue.Post("progress", [&]() { delivered.push_back("progress 1"); });
+  queue.Post([&]() { delivered.push_back("payload"); });
+  queue.Post("progress", [&]() { delivered.push_back("progress 2"); });
+  queue.Post("other", [&]() { delivered.push_back("other"); });
+  released.CountDown();
+  queue.Flush();
+
+  // The latest callback takes the place of the one it replaced.
+  EXPECT_THAT(delivered, ElementsAre("progress 2", "payload", "other"));
+  EXPECT_EQ(queue.GetStats().coalesced, 1);
+
+  // Once delivered, a key is posted again.
+  queue.Post("progress", [&]() { delivered.push_back("progress 3"); });
+  queue.Flush();
+  EXPECT_EQ(delivered.back(), "progress 3");
+}
+
+TEST(ClientCallbackQueueTest, FullQueueWaitsUpToMaxWait) {
+  ClientCallbackQueue queue(/*max_pending=*/1, absl::Milliseconds(50));
+  CountDownLatch started(1);
+  CountDownLatch released(1);
+  int delivered = 0;
+
+  queue.Post([&]() {
+    started.CountDown();
+    released.Await();
+  });
+  ASSERT_TRUE(started.Await(kDefaultTimeout).result());
+  queue.Post([&]() { delivered++; });
+  absl::Time start = absl::Now();
+  queue.Post([&]() { delivered++; });
+
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(50));
+  released.CountDown();
+  queue.Flush();
+  EXPECT_EQ(delivered, 2);
+  EXPECT_EQ(queue.GetStats().overflowed, 1);
+}
+
+TEST(ClientCallbackQueueTest, CoalescingDoesNotWaitForRoom) {
+  ClientCallbackQueue queue(/*max_pending=*/1, absl::Seconds(10));
+  CountDownLatch started(1);
+  CountDownLatch released(1);
+  int progress = 0;
+
+  queue.Post([&]() {
+    started.CountDown();
+    released.Await();
+  });
+  ASSERT_TRUE(started.Await(kDefaultTimeout).result());
+  queue.Post("progress", [&]() { progress = 1; });
+  queue.Post("progress", [&]() { progress = 2; });
+  released.CountDown();
+  queue.Flush();
+
+  EXPECT_EQ(progress, 2);
+  EXPECT_EQ(queue.GetStats().overflowed, 0);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
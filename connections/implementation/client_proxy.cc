@@ -29,16 +29,22 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "connections/advertising_options.h"
 #include "connections/connection_options.h"
 #include "connections/discovery_options.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/analytics/advertising_metadata_params.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
 #include "connections/implementation/analytics/discovery_metadata_params.h"
+#include "connections/implementation/chunk_compression.h"
+#include "connections/implementation/client_callback_queue.h"
+#include "connections/implementation/connection_pool.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
+#include "connections/implementation/payload_batcher.h"
 #include "connections/listeners.h"
 #include "connections/medium_selector.h"
 #include "connections/payload.h"
@@ -64,6 +70,7 @@
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/os_name.h"
 #include "internal/platform/prng.h"
+#include "internal/platform/system_clock.h"
 #include "proto/connections_enums.pb.h"
 
 namespace nearby {
@@ -86,7 +93,9 @@ bool IsFeatureUseStableEndpointIdEnabled() {
 }  // namespace
 
 ClientProxy::ClientProxy(::nearby::analytics::EventLogger* event_logger)
-    : client_id_(Prng().NextInt64()) {
+    : client_id_(Prng().NextInt64()),
+      connection_pool_(
+          FeatureFlags::GetInstance().GetFlags().connection_pool_idle_timeout) {
   NEARBY_LOGS(INFO) << "ClientProxy ctor event_logger=" << event_logger;
   analytics_recorder_ =
       std::make_unique<analytics::AnalyticsRecorder>(event_logger);
@@ -96,6 +105,12 @@ ClientProxy::ClientProxy(::nearby::analytics::EventLogger* event_logger)
       });
   local_os_info_.set_type(
       OSNameToOsInfoType(api::ImplementationPlatform::GetCurrentOS()));
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  if (flags.enable_client_callback_queue) {
+    callback_queue_ = std::make_unique<ClientCallbackQueue>(
+        flags.client_callback_queue_max_pending,
+        flags.client_callback_queue_max_wait);
+  }
   supports_safe_to_disconnect_ = NearbyFlags::GetInstance().GetBoolFlag(
       config_package_nearby::nearby_connections_feature::
           kEnableSafeToDisconnect);
@@ -147,6 +162,22 @@ const NearbyDevice* ClientProxy::GetLocalDevice() {
   return GetLocalDeviceProvider()->GetLocalDevice();
 }
 
+std::string ClientProxy::GetLocalDeviceProtoBytes() {
+  MutexLock lock(&mutex_);
+  const NearbyDevice* local_device = GetLocalDevice();
+  const NearbyDeviceProvider* provider = GetLocalDeviceProvider();
+  // Read the version first, so a change made while serializing is picked up
+  // by the next call.
+  std::uint64_t version = provider->GetLocalDeviceVersion();
+  if (local_device_proto_bytes_provider_ != provider ||
+      local_device_proto_bytes_version_ != version) {
+    local_device_proto_bytes_ = local_device->ToProtoBytes();
+    local_device_proto_bytes_provider_ = provider;
+    local_device_proto_bytes_version_ = version;
+  }
+  return local_device_proto_bytes_;
+}
+
 std::string ClientProxy::GetConnectionToken(const std::string& endpoint_id) {
   ConnectionPair* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
@@ -339,15 +370,20 @@ ConnectionListener ClientProxy::GetAdvertisingOrIncomingConnectionListener() {
               auto remote_device = v3::ConnectionsDevice(endpoint_id, "", {});
               this->listening_info_.listener.result_cb(
                   remote_device,
-                  v3::ConnectionResult{.status = Status{
-                                           .value = Status::kSuccess,
-                                       }});
+                  v3::ConnectionResult{
+                      .status = Status{.value = Status::kSuccess},
+                      .timeline = GetConnectionTimeline(endpoint_id),
+                  });
             },
         .rejected_cb =
             [this](const std::string& endpoint_id, Status status) {
               auto remote_device = v3::ConnectionsDevice(endpoint_id, "", {});
               this->listening_info_.listener.result_cb(
-                  remote_device, v3::ConnectionResult{.status = status});
+                  remote_device,
+                  v3::ConnectionResult{
+                      .status = status,
+                      .timeline = GetConnectionTimeline(endpoint_id),
+                  });
             },
         .disconnected_cb =
             [this](const std::string& endpoint_id) {
@@ -374,7 +410,19 @@ void ClientProxy::StartedDiscovery(
         operation_result_with_mediums,
     const DiscoveryOptions& discovery_options) {
   MutexLock lock(&mutex_);
-  discovery_info_ = DiscoveryInfo{service_id, std::move(listener)};
+  discovery_event_coalescer_.reset();
+  if (callback_queue_ != nullptr) {
+    listener = DeliverOnCallbackQueue(std::move(listener));
+  }
+  absl::Duration coalescing_window =
+      FeatureFlags::GetInstance().GetFlags().discovery_event_coalescing_window;
+  if (coalescing_window > absl::ZeroDuration()) {
+    discovery_event_coalescer_ = std::make_unique<DiscoveryEventCoalescer>(
+        coalescing_window, std::move(listener), &single_thread_executor_);
+    discovery_info_ = DiscoveryInfo{service_id, {}};
+  } else {
+    discovery_info_ = DiscoveryInfo{service_id, std::move(listener)};
+  }
   discovery_options_ = discovery_options;
 
   const std::vector<location::nearby::proto::connections::Medium> medium_vector(
@@ -393,6 +441,7 @@ void ClientProxy::StoppedDiscovery() {
 
   if (IsDiscovering()) {
     discovered_endpoint_ids_.clear();
+    discovery_event_coalescer_.reset();
     discovery_info_.Clear();
     analytics_recorder_->OnStopDiscovery();
   }
@@ -445,8 +494,13 @@ void ClientProxy::OnEndpointFound(
   }
 
   discovered_endpoint_ids_.insert(endpoint_id);
-  discovery_info_.listener.endpoint_found_cb(endpoint_id, endpoint_info,
-                                             service_id);
+  if (discovery_event_coalescer_ != nullptr) {
+    discovery_event_coalescer_->OnEndpointFound(endpoint_id, endpoint_info,
+                                                service_id);
+  } else {
+    discovery_info_.listener.endpoint_found_cb(endpoint_id, endpoint_info,
+                                               service_id);
+  }
   analytics_recorder_->OnEndpointFound(medium);
 }
 
@@ -472,7 +526,33 @@ void ClientProxy::OnEndpointLost(const std::string& service_id,
   }
 
   discovered_endpoint_ids_.erase(it);
-  discovery_info_.listener.endpoint_lost_cb(endpoint_id);
+  if (discovery_event_coalescer_ != nullptr) {
+    discovery_event_coalescer_->OnEndpointLost(endpoint_id);
+  } else {
+    discovery_info_.listener.endpoint_lost_cb(endpoint_id);
+  }
+}
+
+void ClientProxy::OnEndpointDistanceChanged(const std::string& service_id,
+                                            const std::string& endpoint_id,
+                                            DistanceInfo distance_info) {
+  MutexLock lock(&mutex_);
+
+  if (!IsDiscoveringServiceId(service_id) ||
+      !discovered_endpoint_ids_.contains(endpoint_id)) {
+    NEARBY_LOGS(INFO)
+        << "ClientProxy [Endpoint Distance Changed]: Ignoring event for id="
+        << endpoint_id << " because this client is not discovering it.";
+    return;
+  }
+
+  if (discovery_event_coalescer_ != nullptr) {
+    discovery_event_coalescer_->OnEndpointDistanceChanged(endpoint_id,
+                                                          distance_info);
+  } else {
+    discovery_info_.listener.endpoint_distance_changed_cb(endpoint_id,
+                                                          distance_info);
+  }
 }
 
 void ClientProxy::OnRequestConnection(
@@ -498,6 +578,7 @@ void ClientProxy::OnConnectionInitiated(
                            .connection_listener = listener,
                            .connection_options = connection_options,
                            .connection_token = connection_token,
+                           .response_info = info,
                        },
                        PayloadListener{
                            .payload_cb = [](absl::string_view, Payload) {},
@@ -529,7 +610,8 @@ void ClientProxy::OnConnectionInitiated(
   }
 }
 
-void ClientProxy::OnConnectionAccepted(const std::string& endpoint_id) {
+void ClientProxy::OnConnectionAccepted(const std::string& endpoint_id,
+                                       const ConnectionTimeline& timeline) {
   NEARBY_LOGS(INFO) << "ClientProxy [ConnectionAccepted]: id=" << endpoint_id;
   MutexLock lock(&mutex_);
 
@@ -543,13 +625,16 @@ void ClientProxy::OnConnectionAccepted(const std::string& endpoint_id) {
   // Notify the client.
   ConnectionPair* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
+    item->first.timeline = timeline;
+    item->first.connection_listener.timeline_cb(endpoint_id, timeline);
     item->first.connection_listener.accepted_cb(endpoint_id);
     item->first.status = Connection::kConnected;
   }
 }
 
 void ClientProxy::OnConnectionRejected(const std::string& endpoint_id,
-                                       const Status& status) {
+                                       const Status& status,
+                                       const ConnectionTimeline& timeline) {
   NEARBY_LOGS(INFO) << "ClientProxy [ConnectionRejected]: id=" << endpoint_id;
   MutexLock lock(&mutex_);
 
@@ -561,13 +646,23 @@ void ClientProxy::OnConnectionRejected(const std::string& endpoint_id,
   }
 
   // Notify the client.
-  const ConnectionPair* item = LookupConnection(endpoint_id);
+  ConnectionPair* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
+    item->first.timeline = timeline;
+    item->first.connection_listener.timeline_cb(endpoint_id, timeline);
     item->first.connection_listener.rejected_cb(endpoint_id, status);
     OnDisconnected(endpoint_id, false /* notify */);
   }
 }
 
+ConnectionTimeline ClientProxy::GetConnectionTimeline(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+
+  const ConnectionPair* item = LookupConnection(endpoint_id);
+  return item != nullptr ? item->first.timeline : ConnectionTimeline{};
+}
+
 void ClientProxy::OnBandwidthChanged(const std::string& endpoint_id,
                                      Medium new_medium) {
   NEARBY_LOGS(INFO) << "ClientProxy [BandwidthChanged]: id=" << endpoint_id;
@@ -590,11 +685,12 @@ void ClientProxy::OnDisconnected(const std::string& endpoint_id, bool notify) {
   const ConnectionPair* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
     if (notify) {
-      item->first.connection_listener.disconnected_cb({endpoint_id});
+      NotifyDisconnected(item->first.connection_listener, endpoint_id);
     }
     connections_.erase(endpoint_id);
     OnSessionComplete();
   }
+  connection_pool_.Remove(endpoint_id);
 
   CancelEndpoint(endpoint_id);
 
@@ -605,6 +701,59 @@ void ClientProxy::OnDisconnected(const std::string& endpoint_id, bool notify) {
   }
 }
 
+bool ClientProxy::IsConnectionPoolEnabled() const {
+  MutexLock lock(&mutex_);
+  return connection_pool_.IsEnabled();
+}
+
+bool ClientProxy::ParkConnection(const std::string& endpoint_id, bool notify) {
+  MutexLock lock(&mutex_);
+
+  const ConnectionPair* item = LookupConnection(endpoint_id);
+  if (!connection_pool_.IsEnabled() || item == nullptr ||
+      item->first.status != Connection::kConnected) {
+    return false;
+  }
+  NEARBY_LOGS(INFO) << "ClientProxy [ParkConnection]: id=" << endpoint_id;
+  connection_pool_.Park(endpoint_id, item->first.response_info,
+                        item->first.connection_token,
+                        SystemClock::ElapsedRealtime());
+  if (notify) {
+    NotifyDisconnected(item->first.connection_listener, endpoint_id);
+  }
+  connections_.erase(endpoint_id);
+  OnSessionComplete();
+  CancelEndpoint(endpoint_id);
+
+  // A parked connection is disconnected for the client, so the cached
+  // endpoint id expires just as after OnDisconnected().
+  if (IsFeatureUseStableEndpointIdEnabled()) {
+    if (!stable_endpoint_id_mode_ && !HasOngoingConnection()) {
+      ScheduleClearCachedEndpointIdAlarm();
+    }
+  }
+  return true;
+}
+
+std::optional<ConnectionPool::Entry> ClientProxy::TakeParkedConnection(
+    const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+  return connection_pool_.Take(endpoint_id, SystemClock::ElapsedRealtime());
+}
+
+bool ClientProxy::HasParkedConnection(const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+  return connection_pool_.Contains(endpoint_id,
+                                   SystemClock::ElapsedRealtime());
+}
+
+bool ClientProxy::IsParkedConnectionExpired(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+  return connection_pool_.IsExpired(endpoint_id,
+                                    SystemClock::ElapsedRealtime());
+}
+
 bool ClientProxy::ConnectionStatusMatches(const std::string& endpoint_id,
                                           Connection::Status status) const {
   MutexLock lock(&mutex_);
@@ -793,7 +942,9 @@ void ClientProxy::LocalEndpointAcceptedConnection(
   NEARBY_LOGS(INFO) << "ClientProxy [Local Accepted]: id=" << endpoint_id;
   ConnectionPair* item = LookupConnection(endpoint_id);
   if (item != nullptr) {
-    item->second = std::move(listener);
+    item->second = callback_queue_ != nullptr
+                       ? DeliverOnCallbackQueue(std::move(listener))
+                       : std::move(listener);
   }
   analytics_recorder_->OnLocalEndpointAccepted(endpoint_id);
 }
@@ -1068,6 +1219,15 @@ void ClientProxy::OnPayloadProgress(const std::string& endpoint_id,
   }
 }
 
+PayloadProgressCadence ClientProxy::GetPayloadProgressCadence(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+
+  const ConnectionPair* item = LookupConnection(endpoint_id);
+  return item != nullptr ? item->second.progress_cadence
+                         : PayloadProgressCadence{};
+}
+
 void ClientProxy::RemoveAllEndpoints() {
   MutexLock lock(&mutex_);
 
@@ -1282,6 +1442,66 @@ bool ClientProxy::IsMultiplexSocketSupported(absl::string_view endpoint_id,
   }
 }
 
+void ClientProxy::SetRemoteAeadRecordLayerVersion(absl::string_view endpoint_id,
+                                                  std::int32_t version) {
+  MutexLock lock(&mutex_);
+  ConnectionPair* item = LookupConnection(endpoint_id);
+  if (item != nullptr) {
+    item->first.remote_aead_record_layer_version = version;
+  }
+}
+
+bool ClientProxy::IsAeadRecordLayerEnabled(
+    absl::string_view endpoint_id) const {
+  if (!FeatureFlags::GetInstance().GetFlags().enable_aead_record_layer) {
+    return false;
+  }
+  MutexLock lock(&mutex_);
+  const ConnectionPair* item = LookupConnection(endpoint_id);
+  return item != nullptr && item->first.remote_aead_record_layer_version >=
+                                AeadRecordLayer::kVersion;
+}
+
+void ClientProxy::SetRemotePayloadCompressionVersion(
+    absl::string_view endpoint_id, std::int32_t version) {
+  MutexLock lock(&mutex_);
+  ConnectionPair* item = LookupConnection(endpoint_id);
+  if (item != nullptr) {
+    item->first.remote_payload_compression_version = version;
+  }
+}
+
+bool ClientProxy::IsPayloadCompressionEnabled(
+    absl::string_view endpoint_id) const {
+  if (!FeatureFlags::GetInstance().GetFlags().enable_payload_compression) {
+    return false;
+  }
+  MutexLock lock(&mutex_);
+  const ConnectionPair* item = LookupConnection(endpoint_id);
+  return item != nullptr && item->first.remote_payload_compression_version >=
+                                chunk_compression::kVersion;
+}
+
+void ClientProxy::SetRemotePayloadBatchingVersion(absl::string_view endpoint_id,
+                                                  std::int32_t version) {
+  MutexLock lock(&mutex_);
+  ConnectionPair* item = LookupConnection(endpoint_id);
+  if (item != nullptr) {
+    item->first.remote_payload_batching_version = version;
+  }
+}
+
+bool ClientProxy::IsPayloadBatchingEnabled(
+    absl::string_view endpoint_id) const {
+  if (!FeatureFlags::GetInstance().GetFlags().enable_payload_batching) {
+    return false;
+  }
+  MutexLock lock(&mutex_);
+  const ConnectionPair* item = LookupConnection(endpoint_id);
+  return item != nullptr && item->first.remote_payload_batching_version >=
+                                PayloadBatcher::kVersion;
+}
+
 bool ClientProxy::GetWebRtcNonCellular() { return webrtc_non_cellular_; }
 
 void ClientProxy::SetWebRtcNonCellular(bool webrtc_non_cellular) {
@@ -1305,6 +1525,92 @@ std::string ClientProxy::ToString(PayloadProgressInfo::Status status) const {
   }
 }
 
+void ClientProxy::NotifyDisconnected(const ConnectionListener& listener,
+                                     const std::string& endpoint_id) {
+  if (callback_queue_ == nullptr) {
+    listener.disconnected_cb(endpoint_id);
+    return;
+  }
+  // Behind the payload callbacks already queued for the endpoint, so the
+  // client isn't told about its payloads after it's gone.
+  callback_queue_->Post(
+      [disconnected_cb = listener.disconnected_cb, endpoint_id]() {
+        disconnected_cb(endpoint_id);
+      });
+}
+
+PayloadListener ClientProxy::DeliverOnCallbackQueue(PayloadListener listener) {
+  ClientCallbackQueue* queue = callback_queue_.get();
+  // Shared with the queued callbacks, so they outlive the connection.
+  auto shared = std::make_shared<PayloadListener>(std::move(listener));
+  return PayloadListener{
+      .payload_cb =
+          [queue, shared](absl::string_view endpoint_id, Payload payload) {
+            queue->Post([shared, endpoint_id = std::string(endpoint_id),
+                         payload = std::move(payload)]() mutable {
+              shared->payload_cb(endpoint_id, std::move(payload));
+            });
+          },
+      .payload_progress_cb =
+          [queue, shared](absl::string_view endpoint_id,
+                          const PayloadProgressInfo& info) {
+            auto callback = [shared, endpoint_id = std::string(endpoint_id),
+                             info]() {
+              shared->payload_progress_cb(endpoint_id, info);
+            };
+            // Only the latest progress of a payload in progress matters.
+            if (info.status == PayloadProgressInfo::Status::kInProgress) {
+              queue->Post(absl::StrCat("progress/", endpoint_id, "/",
+                                       info.payload_id),
+                          std::move(callback));
+            } else {
+              queue->Post(std::move(callback));
+            }
+          },
+      .progress_cadence = shared->progress_cadence,
+  };
+}
+
+DiscoveryListener ClientProxy::DeliverOnCallbackQueue(
+    DiscoveryListener listener) {
+  ClientCallbackQueue* queue = callback_queue_.get();
+  auto shared = std::make_shared<DiscoveryListener>(std::move(listener));
+  DiscoveryListener wrapped{
+      .endpoint_found_cb =
+          [queue, shared](const std::string& endpoint_id,
+                          const ByteArray& endpoint_info,
+                          const std::string& service_id) {
+            queue->Post([shared, endpoint_id, endpoint_info, service_id]() {
+              shared->endpoint_found_cb(endpoint_id, endpoint_info,
+                                        service_id);
+            });
+          },
+      .endpoint_lost_cb =
+          [queue, shared](const std::string& endpoint_id) {
+            queue->Post([shared, endpoint_id]() {
+              shared->endpoint_lost_cb(endpoint_id);
+            });
+          },
+      .endpoint_distance_changed_cb =
+          [queue, shared](const std::string& endpoint_id, DistanceInfo info) {
+            queue->Post([shared, endpoint_id, info]() {
+              shared->endpoint_distance_changed_cb(endpoint_id, info);
+            });
+          },
+  };
+  // Left unset unless the client sets it, since it replaces the callbacks
+  // above.
+  if (shared->endpoints_changed_cb) {
+    wrapped.endpoints_changed_cb =
+        [queue, shared](const std::vector<DiscoveryEvent>& events) {
+          queue->Post([shared, events]() {
+            shared->endpoints_changed_cb(events);
+          });
+        };
+  }
+  return wrapped;
+}
+
 std::string ClientProxy::Dump() {
   std::stringstream sstream;
   sstream << "Nearby Connections State" << std::endl;
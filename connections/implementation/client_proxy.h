@@ -29,6 +29,9 @@
 #include "connections/connection_options.h"
 #include "connections/discovery_options.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
+#include "connections/implementation/client_callback_queue.h"
+#include "connections/implementation/connection_pool.h"
+#include "connections/implementation/discovery_event_coalescer.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/listeners.h"
 #include "connections/medium_selector.h"
@@ -46,6 +49,7 @@
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/error_code_recorder.h"
 #include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
 // Prefer using absl:: versions of a set and a map; they tend to be more
 // efficient: implementation is using open-addressing hash tables.
 #include "absl/container/flat_hash_map.h"
@@ -87,6 +91,9 @@ class ClientProxy final {
   void SetBluetoothMacAddress(const std::string& endpoint_id,
                               const std::string& bluetooth_mac_address);
   const NearbyDevice* GetLocalDevice();
+  // Returns the serialized local device sent in connection requests. The bytes
+  // are reused until the device provider reports a new local device version.
+  std::string GetLocalDeviceProtoBytes();
   NearbyDeviceProvider* GetLocalDeviceProvider() {
     if (external_device_provider_ != nullptr) {
       return external_device_provider_;
@@ -160,6 +167,11 @@ class ClientProxy final {
   // Proxies to the client's DiscoveryListener::OnEndpointLost() callback.
   void OnEndpointLost(const std::string& service_id,
                       const std::string& endpoint_id);
+  // Proxies to the client's DiscoveryListener::OnEndpointDistanceChanged()
+  // callback.
+  void OnEndpointDistanceChanged(const std::string& service_id,
+                                 const std::string& endpoint_id,
+                                 DistanceInfo distance_info);
 
   // Triggered when client request connection to remote device.
   void OnRequestConnection(const Strategy& strategy,
@@ -173,11 +185,20 @@ class ClientProxy final {
                              const ConnectionListener& listener,
                              const std::string& connection_token);
 
-  // Proxies to the client's ConnectionListener::OnAccepted() callback.
-  void OnConnectionAccepted(const std::string& endpoint_id);
-  // Proxies to the client's ConnectionListener::OnRejected() callback.
+  // Proxies to the client's ConnectionListener::OnAccepted() callback, after
+  // reporting `timeline` to its timeline_cb.
+  void OnConnectionAccepted(const std::string& endpoint_id,
+                            const ConnectionTimeline& timeline = {});
+  // Proxies to the client's ConnectionListener::OnRejected() callback, after
+  // reporting `timeline` to its timeline_cb.
   void OnConnectionRejected(const std::string& endpoint_id,
-                            const Status& status);
+                            const Status& status,
+                            const ConnectionTimeline& timeline = {});
+
+  // Returns the timeline the connection to `endpoint_id` was accepted or
+  // rejected with, or an empty one.
+  ConnectionTimeline GetConnectionTimeline(
+      const std::string& endpoint_id) const;
 
   void OnBandwidthChanged(const std::string& endpoint_id, Medium new_medium);
 
@@ -186,6 +207,21 @@ class ClientProxy final {
   // ConnectionListener.disconnected_cb() callback.
   void OnDisconnected(const std::string& endpoint_id, bool notify);
 
+  // Returns true if disconnected connections may be parked for reuse.
+  bool IsConnectionPoolEnabled() const;
+  // Parks the connection to the endpoint, and removes it from the list of
+  // connected endpoints like OnDisconnected(). Returns false, and does
+  // nothing, if the pool is disabled or the endpoint isn't connected.
+  bool ParkConnection(const std::string& endpoint_id, bool notify);
+  // Removes and returns the connection parked for the endpoint, or nullopt
+  // if there is none, or it expired.
+  std::optional<ConnectionPool::Entry> TakeParkedConnection(
+      const std::string& endpoint_id);
+  // Returns true if a connection to the endpoint is parked, and not expired.
+  bool HasParkedConnection(const std::string& endpoint_id) const;
+  // Returns true if the connection parked for the endpoint expired.
+  bool IsParkedConnectionExpired(const std::string& endpoint_id) const;
+
   // Returns the medium we're currently connected to the endpoint over, or
   // UNKNOWN if we don't know or don't have a connection.
   Medium GetConnectedMedium(const std::string& endpoint_id) const;
@@ -253,6 +289,10 @@ class ClientProxy final {
   // Proxies to the client's PayloadListener::OnPayloadProgress() callback.
   void OnPayloadProgress(const std::string& endpoint_id,
                          const PayloadProgressInfo& info);
+  // Returns how often the client wants to hear about the progress of payloads
+  // exchanged with endpoint id.
+  PayloadProgressCadence GetPayloadProgressCadence(
+      const std::string& endpoint_id) const;
   bool LocalConnectionIsAccepted(std::string endpoint_id) const;
   bool RemoteConnectionIsAccepted(std::string endpoint_id) const;
 
@@ -293,12 +333,16 @@ class ClientProxy final {
       const location::nearby::connections::OsInfo& remote_os_info);
 
   void RegisterDeviceProvider(NearbyDeviceProvider* provider) {
+    MutexLock lock(&mutex_);
     external_device_provider_ = provider;
+    local_device_proto_bytes_provider_ = nullptr;
   }
 
   void RegisterConnectionsDeviceProvider(
       std::unique_ptr<v3::ConnectionsDeviceProvider> provider) {
+    MutexLock lock(&mutex_);
     connections_device_provider_ = std::move(provider);
+    local_device_proto_bytes_provider_ = nullptr;
   }
 
   const bool& IsSupportSafeToDisconnect() const {
@@ -333,6 +377,25 @@ class ClientProxy final {
   // Returns true if the multiplex socket is supported for the given medium.
   bool IsMultiplexSocketSupported(absl::string_view endpoint_id, Medium medium);
 
+  // Sets the AES-GCM record layer version advertised by the remote device.
+  void SetRemoteAeadRecordLayerVersion(absl::string_view endpoint_id,
+                                       std::int32_t version);
+  // Returns true if both sides support the AES-GCM record layer for the
+  // encrypted channel of this endpoint.
+  bool IsAeadRecordLayerEnabled(absl::string_view endpoint_id) const;
+
+  // Sets the payload compression version advertised by the remote device.
+  void SetRemotePayloadCompressionVersion(absl::string_view endpoint_id,
+                                          std::int32_t version);
+  // Returns true if payload chunks sent to this endpoint may be compressed.
+  bool IsPayloadCompressionEnabled(absl::string_view endpoint_id) const;
+
+  // Sets the payload batching version advertised by the remote device.
+  void SetRemotePayloadBatchingVersion(absl::string_view endpoint_id,
+                                       std::int32_t version);
+  // Returns true if BYTES payloads may be sent to this endpoint in batches.
+  bool IsPayloadBatchingEnabled(absl::string_view endpoint_id) const;
+
   // Gets the WebRTC non cellular network status.
   bool GetWebRtcNonCellular();
 
@@ -380,9 +443,15 @@ class ClientProxy final {
     DiscoveryOptions discovery_options;
     AdvertisingOptions advertising_options;
     std::string connection_token;
+    // As the connection was initiated; kept to resume it once parked.
+    ConnectionResponseInfo response_info;
     std::optional<location::nearby::connections::OsInfo> os_info;
     std::int32_t safe_to_disconnect_version;
     std::int32_t remote_multiplex_socket_bitmask;
+    std::int32_t remote_aead_record_layer_version = 0;
+    std::int32_t remote_payload_compression_version = 0;
+    std::int32_t remote_payload_batching_version = 0;
+    ConnectionTimeline timeline;
   };
   using ConnectionPair = std::pair<Connection, PayloadListener>;
 
@@ -436,7 +505,16 @@ class ClientProxy final {
 
   std::string ToString(PayloadProgressInfo::Status status) const;
 
-  mutable RecursiveMutex mutex_;
+  // Calls the disconnected_cb() of |listener| for |endpoint_id|, on
+  // callback_queue_ if it's set.
+  void NotifyDisconnected(const ConnectionListener& listener,
+                          const std::string& endpoint_id);
+  // Returns listeners that deliver the callbacks of |listener| on
+  // callback_queue_.
+  PayloadListener DeliverOnCallbackQueue(PayloadListener listener);
+  DiscoveryListener DeliverOnCallbackQueue(DiscoveryListener listener);
+
+  mutable RecursiveMutex mutex_{"ClientProxy::mutex_"};
   std::int64_t client_id_;
   std::string local_endpoint_id_;
   std::string local_endpoint_info_;
@@ -454,6 +532,9 @@ class ClientProxy final {
   // Caches the endpoint id for stable endpoint ID mode.
   std::string cached_endpoint_id_;
 
+  // Set if the payload, discovery and disconnection callbacks are delivered on
+  // a thread of their own. Outlives the listeners posting to it.
+  std::unique_ptr<ClientCallbackQueue> callback_queue_;
   ScheduledExecutor single_thread_executor_;
   std::unique_ptr<CancelableAlarm> cached_endpoint_id_alarm_;
 
@@ -463,6 +544,9 @@ class ClientProxy final {
 
   // If not empty, we are currently discovering for the given service_id.
   DiscoveryInfo discovery_info_;
+  // Set while discovering with coalesced discovery events; owns the
+  // discovery listener then, instead of discovery_info_.
+  std::unique_ptr<DiscoveryEventCoalescer> discovery_event_coalescer_;
 
   // If not empty, we are currently listening for the given service_id.
   ListeningInfo listening_info_;
@@ -486,6 +570,9 @@ class ClientProxy final {
   // Maps endpoint_id to endpoint connection state.
   absl::flat_hash_map<std::string, ConnectionPair> connections_;
 
+  // The connections parked after they were disconnected, by endpoint_id.
+  ConnectionPool connection_pool_;
+
   // Maps endpoint_id to Bluetooth Mac Addresses.
   absl::flat_hash_map<std::string, std::string> bluetooth_mac_addresses_;
 
@@ -516,6 +603,11 @@ class ClientProxy final {
   NearbyDeviceProvider* external_device_provider_ = nullptr;
   // For Nearby Connections' own device provider.
   std::unique_ptr<v3::ConnectionsDeviceProvider> connections_device_provider_;
+  // The serialized local device, and the provider and local device version it
+  // was serialized from.
+  std::string local_device_proto_bytes_;
+  const NearbyDeviceProvider* local_device_proto_bytes_provider_ = nullptr;
+  std::uint64_t local_device_proto_bytes_version_ = 0;
   bool supports_safe_to_disconnect_;
   bool support_auto_reconnect_;
   std::int32_t local_safe_to_disconnect_version_;
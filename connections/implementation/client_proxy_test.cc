@@ -33,6 +33,7 @@
 #include "connections/advertising_options.h"
 #include "connections/connection_options.h"
 #include "connections/discovery_options.h"
+#include "connections/implementation/connection_pool.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/listeners.h"
 #include "connections/medium_selector.h"
@@ -65,7 +66,9 @@ using ::location::nearby::connections::OsInfo;
 using ::location::nearby::proto::connections::CLIENT_SESSION;
 using ::location::nearby::proto::connections::START_CLIENT_SESSION;
 using ::location::nearby::proto::connections::STOP_CLIENT_SESSION;
+using ::testing::_;
 using ::testing::MockFunction;
+using ::testing::Return;
 using ::testing::StrictMock;
 
 constexpr FeatureFlags::Flags kTestCases[] = {
@@ -120,6 +123,15 @@ class FakeEventLogger : public ::nearby::analytics::MockEventLogger {
 class MockDeviceProvider : public nearby::NearbyDeviceProvider {
  public:
   MOCK_METHOD((const NearbyDevice*), GetLocalDevice, (), (override));
+  MOCK_METHOD(std::uint64_t, GetLocalDeviceVersion, (), (const, override));
+};
+
+class MockNearbyDevice : public nearby::NearbyDevice {
+ public:
+  MOCK_METHOD(std::string, GetEndpointId, (), (const, override));
+  MOCK_METHOD(std::vector<ConnectionInfoVariant>, GetConnectionInfos, (),
+              (const, override));
+  MOCK_METHOD(std::string, ToProtoBytes, (), (const, override));
 };
 
 class ClientProxyTest : public ::testing::TestWithParam<FeatureFlags::Flags> {
@@ -661,6 +673,45 @@ TEST_F(ClientProxyTest, OnBandwidthChangedFiresNotificationInDiscovery) {
   OnDiscoveryBandwidthChanged(client2(), advertising_endpoint);
 }
 
+TEST_F(ClientProxyTest, OnConnectionAcceptedReportsTimelineFirst) {
+  StrictMock<MockFunction<void(const std::string& endpoint_id,
+                               const ConnectionTimeline& timeline)>>
+      timeline_cb;
+  discovery_connection_listener_.timeline_cb = timeline_cb.AsStdFunction();
+  Endpoint advertising_endpoint =
+      StartAdvertising(client1(), advertising_connection_listener_);
+  StartDiscovery(client2(), GetDiscoveryListener());
+  OnDiscoveryEndpointFound(client2(), advertising_endpoint);
+  OnDiscoveryConnectionInitiated(client2(), advertising_endpoint);
+  OnDiscoveryConnectionLocalAccepted(client2(), advertising_endpoint);
+  OnDiscoveryConnectionRemoteAccepted(client2(), advertising_endpoint);
+  absl::Time started = absl::Now();
+  ConnectionTimeline timeline{
+      .medium = Medium::WIFI_LAN,
+      .started = started,
+      .medium_connected = started + absl::Milliseconds(10),
+      .request_exchanged = started + absl::Milliseconds(15),
+      .encrypted = started + absl::Milliseconds(40),
+      .local_responded = started + absl::Milliseconds(50),
+      .remote_responded = started + absl::Milliseconds(60),
+      .finished = started + absl::Milliseconds(60),
+  };
+
+  ::testing::InSequence in_sequence;
+  EXPECT_CALL(timeline_cb, Call(advertising_endpoint.id, _));
+  EXPECT_CALL(mock_discovery_connection_.accepted_cb, Call);
+  client2()->OnConnectionAccepted(advertising_endpoint.id, timeline);
+
+  ConnectionTimeline stored =
+      client2()->GetConnectionTimeline(advertising_endpoint.id);
+  EXPECT_EQ(stored.MediumConnect(), absl::Milliseconds(10));
+  EXPECT_EQ(stored.RequestExchange(), absl::Milliseconds(5));
+  EXPECT_EQ(stored.Encryption(), absl::Milliseconds(25));
+  EXPECT_EQ(stored.LocalAccept(), absl::Milliseconds(10));
+  EXPECT_EQ(stored.RemoteAccept(), absl::Milliseconds(20));
+  EXPECT_EQ(stored.Total(), absl::Milliseconds(60));
+}
+
 TEST_F(ClientProxyTest, OnDisconnectedFiresNotificationInDiscovery) {
   Endpoint advertising_endpoint =
       StartAdvertising(client1(), advertising_connection_listener_);
@@ -670,6 +721,87 @@ TEST_F(ClientProxyTest, OnDisconnectedFiresNotificationInDiscovery) {
   OnDiscoveryConnectionDisconnected(client2(), advertising_endpoint);
 }
 
+TEST_F(ClientProxyTest, OnDisconnectedIsQueuedBehindPayloads) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.enable_client_callback_queue = true;
+  ClientProxy client(&event_logger2_);
+  flags = saved_flags;
+  Endpoint advertising_endpoint =
+      StartAdvertising(client1(), advertising_connection_listener_);
+  StartDiscovery(&client, GetDiscoveryListener());
+  OnDiscoveryEndpointFound(&client, advertising_endpoint);
+  OnDiscoveryConnectionInitiated(&client, advertising_endpoint);
+  OnDiscoveryConnectionLocalAccepted(&client, advertising_endpoint);
+  OnDiscoveryConnectionRemoteAccepted(&client, advertising_endpoint);
+  OnDiscoveryConnectionAccepted(&client, advertising_endpoint);
+
+  // The client is still handling the payload when the endpoint disconnects.
+  CountDownLatch payload_handled(1);
+  CountDownLatch disconnected(1);
+  ::testing::InSequence in_sequence;
+  EXPECT_CALL(mock_discovery_payload_.payload_cb, Call)
+      .WillOnce([&payload_handled](absl::string_view endpoint_id,
+                                   Payload payload) {
+        payload_handled.Await();
+      });
+  EXPECT_CALL(mock_discovery_connection_.disconnected_cb, Call)
+      .WillOnce([&disconnected](const std::string& endpoint_id) {
+        disconnected.CountDown();
+      });
+  client.OnPayload(advertising_endpoint.id, Payload(payload_bytes_));
+  client.OnDisconnected(advertising_endpoint.id, true);
+  payload_handled.CountDown();
+
+  EXPECT_TRUE(disconnected.Await(absl::Seconds(1)).result());
+}
+
+TEST_F(ClientProxyTest, ParkConnectionKeepsItForResuming) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.connection_pool_idle_timeout = absl::Minutes(1);
+  ClientProxy client(&event_logger2_);
+  flags = saved_flags;
+  Endpoint advertising_endpoint =
+      StartAdvertising(client1(), advertising_connection_listener_);
+  StartDiscovery(&client, GetDiscoveryListener());
+  OnDiscoveryEndpointFound(&client, advertising_endpoint);
+  OnDiscoveryConnectionInitiated(&client, advertising_endpoint);
+  // Only connected endpoints are parked.
+  EXPECT_FALSE(client.ParkConnection(advertising_endpoint.id, true));
+  OnDiscoveryConnectionLocalAccepted(&client, advertising_endpoint);
+  OnDiscoveryConnectionRemoteAccepted(&client, advertising_endpoint);
+  OnDiscoveryConnectionAccepted(&client, advertising_endpoint);
+
+  EXPECT_CALL(mock_discovery_connection_.disconnected_cb, Call).Times(1);
+  EXPECT_TRUE(client.ParkConnection(advertising_endpoint.id, true));
+  EXPECT_FALSE(client.IsConnectedToEndpoint(advertising_endpoint.id));
+  EXPECT_TRUE(client.HasParkedConnection(advertising_endpoint.id));
+
+  std::optional<ConnectionPool::Entry> parked =
+      client.TakeParkedConnection(advertising_endpoint.id);
+  ASSERT_TRUE(parked.has_value());
+  EXPECT_EQ(parked->info.authentication_token, auth_token_);
+  EXPECT_FALSE(parked->info.is_incoming_connection);
+  EXPECT_FALSE(client.HasParkedConnection(advertising_endpoint.id));
+}
+
+TEST_F(ClientProxyTest, ParkConnectionFailsWithPoolDisabled) {
+  Endpoint advertising_endpoint =
+      StartAdvertising(client1(), advertising_connection_listener_);
+  StartDiscovery(client2(), GetDiscoveryListener());
+  OnDiscoveryEndpointFound(client2(), advertising_endpoint);
+  OnDiscoveryConnectionInitiated(client2(), advertising_endpoint);
+  OnDiscoveryConnectionLocalAccepted(client2(), advertising_endpoint);
+  OnDiscoveryConnectionRemoteAccepted(client2(), advertising_endpoint);
+  OnDiscoveryConnectionAccepted(client2(), advertising_endpoint);
+
+  EXPECT_FALSE(client2()->IsConnectionPoolEnabled());
+  EXPECT_FALSE(client2()->ParkConnection(advertising_endpoint.id, true));
+  EXPECT_TRUE(client2()->IsConnectedToEndpoint(advertising_endpoint.id));
+  EXPECT_FALSE(client2()->HasParkedConnection(advertising_endpoint.id));
+}
+
 TEST_F(ClientProxyTest, LocalEndpointAcceptedConnectionChangesState) {
   Endpoint advertising_endpoint =
       StartAdvertising(client1(), advertising_connection_listener_);
@@ -1476,6 +1608,24 @@ TEST_F(ClientProxyTest, GetLocalDeviceWorksWithDeviceProvider) {
   client1()->GetLocalDevice();
 }
 
+TEST_F(ClientProxyTest, GetLocalDeviceProtoBytesIsReusedUntilDeviceChanges) {
+  MockDeviceProvider provider;
+  MockNearbyDevice device;
+  client1()->RegisterDeviceProvider(&provider);
+  EXPECT_CALL(provider, GetLocalDevice).WillRepeatedly(Return(&device));
+  EXPECT_CALL(provider, GetLocalDeviceVersion)
+      .WillOnce(Return(1))
+      .WillOnce(Return(1))
+      .WillOnce(Return(2));
+  EXPECT_CALL(device, ToProtoBytes)
+      .WillOnce(Return("device"))
+      .WillOnce(Return("updated device"));
+
+  EXPECT_EQ(client1()->GetLocalDeviceProtoBytes(), "device");
+  EXPECT_EQ(client1()->GetLocalDeviceProtoBytes(), "device");
+  EXPECT_EQ(client1()->GetLocalDeviceProtoBytes(), "updated device");
+}
+
 TEST_F(ClientProxyTest, TestGetSetLocalEndpointInfo) {
   client1()->UpdateLocalEndpointInfo("endpoint_info");
   EXPECT_EQ(client1()->GetLocalEndpointInfo(), "endpoint_info");
@@ -0,0 +1,68 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/connection_pool.h"
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+
+namespace nearby {
+namespace connections {
+
+ConnectionPool::ConnectionPool(absl::Duration idle_timeout)
+    : idle_timeout_(idle_timeout) {}
+
+void ConnectionPool::Park(const std::string& endpoint_id,
+                          ConnectionResponseInfo info,
+                          std::string connection_token, absl::Time now) {
+  if (!IsEnabled()) return;
+  entries_.insert_or_assign(endpoint_id,
+                            Entry{
+                                .info = std::move(info),
+                                .connection_token = std::move(connection_token),
+                                .expires_at = now + idle_timeout_,
+                            });
+}
+
+std::optional<ConnectionPool::Entry> ConnectionPool::Take(
+    const std::string& endpoint_id, absl::Time now) {
+  auto it = entries_.find(endpoint_id);
+  if (it == entries_.end()) return std::nullopt;
+  auto node = entries_.extract(it);
+  if (node.mapped().expires_at <= now) return std::nullopt;
+  return std::move(node.mapped());
+}
+
+bool ConnectionPool::Contains(const std::string& endpoint_id,
+                              absl::Time now) const {
+  auto it = entries_.find(endpoint_id);
+  return it != entries_.end() && it->second.expires_at > now;
+}
+
+bool ConnectionPool::IsExpired(const std::string& endpoint_id,
+                               absl::Time now) const {
+  auto it = entries_.find(endpoint_id);
+  return it != entries_.end() && it->second.expires_at <= now;
+}
+
+void ConnectionPool::Remove(const std::string& endpoint_id) {
+  entries_.erase(endpoint_id);
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,76 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_CONNECTION_POOL_H_
+#define CORE_INTERNAL_CONNECTION_POOL_H_
+
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+
+namespace nearby {
+namespace connections {
+
+// Keeps the connections disconnected by the client parked for an idle
+// timeout, keyed by the id of the remote endpoint. The channel of a parked
+// connection stays registered with the EndpointManager, encrypted and kept
+// alive, so the next connection request to the same endpoint reuses it,
+// instead of connecting a medium and running UKEY2 again.
+//
+// Not thread safe; ClientProxy guards it with its own lock.
+class ConnectionPool {
+ public:
+  struct Entry {
+    // The connection as it was initiated, with its authentication tokens.
+    ConnectionResponseInfo info;
+    std::string connection_token;
+    absl::Time expires_at;
+  };
+
+  // A zero |idle_timeout| disables the pool.
+  explicit ConnectionPool(absl::Duration idle_timeout);
+
+  bool IsEnabled() const { return idle_timeout_ > absl::ZeroDuration(); }
+
+  // Parks the connection to |endpoint_id| until the idle timeout after |now|.
+  // Does nothing if the pool is disabled.
+  void Park(const std::string& endpoint_id, ConnectionResponseInfo info,
+            std::string connection_token, absl::Time now);
+
+  // Removes and returns the connection parked for |endpoint_id|, or nullopt
+  // if there is none, or it expired.
+  std::optional<Entry> Take(const std::string& endpoint_id, absl::Time now);
+
+  // Whether a connection to |endpoint_id| is parked and not expired.
+  bool Contains(const std::string& endpoint_id, absl::Time now) const;
+
+  // Whether a connection to |endpoint_id| is parked, and expired.
+  bool IsExpired(const std::string& endpoint_id, absl::Time now) const;
+
+  void Remove(const std::string& endpoint_id);
+
+  int GetSize() const { return entries_.size(); }
+
+ private:
+  const absl::Duration idle_timeout_;
+  absl::flat_hash_map<std::string, Entry> entries_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_CONNECTION_POOL_H_
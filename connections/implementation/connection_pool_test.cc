@@ -0,0 +1,106 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/connection_pool.h"
+
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr char kEndpointId[] = "ABCD";
+constexpr absl::Duration kIdleTimeout = absl::Seconds(30);
+
+ConnectionResponseInfo MakeInfo(const char* auth_token) {
+  return ConnectionResponseInfo{
+      .authentication_token = auth_token,
+      .is_incoming_connection = true,
+  };
+}
+
+TEST(ConnectionPoolTest, TakeReturnsParkedConnectionOnce) {
+  ConnectionPool pool(kIdleTimeout);
+  absl::Time now = absl::UnixEpoch();
+
+  pool.Park(kEndpointId, MakeInfo("token"), "connection_token", now);
+  EXPECT_TRUE(pool.Contains(kEndpointId, now));
+
+  std::optional<ConnectionPool::Entry> entry =
+      pool.Take(kEndpointId, now + absl::Seconds(1));
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->info.authentication_token, "token");
+  EXPECT_TRUE(entry->info.is_incoming_connection);
+  EXPECT_EQ(entry->connection_token, "connection_token");
+  EXPECT_EQ(entry->expires_at, now + kIdleTimeout);
+
+  EXPECT_FALSE(pool.Contains(kEndpointId, now));
+  EXPECT_FALSE(pool.Take(kEndpointId, now).has_value());
+}
+
+TEST(ConnectionPoolTest, ExpiredConnectionIsNotTaken) {
+  ConnectionPool pool(kIdleTimeout);
+  absl::Time now = absl::UnixEpoch();
+
+  pool.Park(kEndpointId, MakeInfo("token"), "connection_token", now);
+  EXPECT_FALSE(pool.IsExpired(kEndpointId, now + kIdleTimeout / 2));
+  EXPECT_TRUE(pool.IsExpired(kEndpointId, now + kIdleTimeout));
+  EXPECT_FALSE(pool.Contains(kEndpointId, now + kIdleTimeout));
+
+  EXPECT_FALSE(pool.Take(kEndpointId, now + kIdleTimeout).has_value());
+  EXPECT_EQ(pool.GetSize(), 0);
+}
+
+TEST(ConnectionPoolTest, ParkingAgainRestartsTheTimeout) {
+  ConnectionPool pool(kIdleTimeout);
+  absl::Time now = absl::UnixEpoch();
+
+  pool.Park(kEndpointId, MakeInfo("old"), "connection_token", now);
+  pool.Park(kEndpointId, MakeInfo("new"), "connection_token",
+            now + absl::Seconds(10));
+  EXPECT_EQ(pool.GetSize(), 1);
+
+  std::optional<ConnectionPool::Entry> entry =
+      pool.Take(kEndpointId, now + kIdleTimeout);
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->info.authentication_token, "new");
+}
+
+TEST(ConnectionPoolTest, DisabledPoolParksNothing) {
+  ConnectionPool pool(absl::ZeroDuration());
+  absl::Time now = absl::UnixEpoch();
+
+  EXPECT_FALSE(pool.IsEnabled());
+  pool.Park(kEndpointId, MakeInfo("token"), "connection_token", now);
+  EXPECT_EQ(pool.GetSize(), 0);
+  EXPECT_FALSE(pool.Take(kEndpointId, now).has_value());
+}
+
+TEST(ConnectionPoolTest, RemoveDropsTheConnection) {
+  ConnectionPool pool(kIdleTimeout);
+  absl::Time now = absl::UnixEpoch();
+
+  pool.Park(kEndpointId, MakeInfo("token"), "connection_token", now);
+  pool.Remove(kEndpointId);
+  EXPECT_FALSE(pool.Contains(kEndpointId, now));
+  EXPECT_FALSE(pool.IsExpired(kEndpointId, now));
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
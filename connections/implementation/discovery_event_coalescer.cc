@@ -0,0 +1,177 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/discovery_event_coalescer.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/scheduled_executor.h"
+
+namespace nearby {
+namespace connections {
+
+DiscoveryEventCoalescer::DiscoveryEventCoalescer(absl::Duration window,
+                                                 DiscoveryListener listener,
+                                                 ScheduledExecutor* executor)
+    : window_(window),
+      executor_(executor),
+      state_(std::make_shared<State>(std::move(listener))) {}
+
+DiscoveryEventCoalescer::~DiscoveryEventCoalescer() {
+  MutexLock lock(&state_->mutex);
+  state_->stopped = true;
+  state_->pending.clear();
+  state_->pending_order.clear();
+}
+
+void DiscoveryEventCoalescer::OnEndpointFound(const std::string& endpoint_id,
+                                              const ByteArray& endpoint_info,
+                                              const std::string& service_id) {
+  MutexLock lock(&state_->mutex);
+  std::optional<EndpointState> latest = state_->GetLatest(endpoint_id);
+  EndpointState endpoint_state{
+      .endpoint_info = endpoint_info,
+      .service_id = service_id,
+  };
+  // The distance of an endpoint holds until its endpoint info changes.
+  if (latest.has_value() && latest->endpoint_info == endpoint_info) {
+    endpoint_state.distance_info = latest->distance_info;
+  }
+  SetPending(endpoint_id, std::move(endpoint_state));
+}
+
+void DiscoveryEventCoalescer::OnEndpointLost(const std::string& endpoint_id) {
+  MutexLock lock(&state_->mutex);
+  SetPending(endpoint_id, std::nullopt);
+}
+
+void DiscoveryEventCoalescer::OnEndpointDistanceChanged(
+    const std::string& endpoint_id, DistanceInfo distance_info) {
+  MutexLock lock(&state_->mutex);
+  std::optional<EndpointState> latest = state_->GetLatest(endpoint_id);
+  if (!latest.has_value()) return;
+  latest->distance_info = distance_info;
+  SetPending(endpoint_id, std::move(latest));
+}
+
+void DiscoveryEventCoalescer::Flush() { Deliver(*state_); }
+
+void DiscoveryEventCoalescer::SetPending(
+    const std::string& endpoint_id,
+    std::optional<EndpointState> endpoint_state) {
+  auto [it, inserted] =
+      state_->pending.insert_or_assign(endpoint_id, std::move(endpoint_state));
+  if (inserted) {
+    state_->pending_order.push_back(endpoint_id);
+  }
+  if (state_->delivery_scheduled) return;
+  state_->delivery_scheduled = true;
+  executor_->Schedule([state = state_]() { Deliver(*state); }, window_);
+}
+
+void DiscoveryEventCoalescer::Deliver(State& state) {
+  MutexLock delivery_lock(&state.delivery_mutex);
+  std::vector<DiscoveryEvent> events;
+  {
+    MutexLock lock(&state.mutex);
+    if (state.stopped) return;
+    state.delivery_scheduled = false;
+    events = state.TakeEvents();
+  }
+  if (events.empty()) return;
+
+  DiscoveryListener& listener = state.listener;
+  if (listener.endpoints_changed_cb) {
+    listener.endpoints_changed_cb(events);
+    return;
+  }
+  for (const DiscoveryEvent& event : events) {
+    switch (event.type) {
+      case DiscoveryEvent::Type::kFound:
+        listener.endpoint_found_cb(event.endpoint_id, event.endpoint_info,
+                                   event.service_id);
+        break;
+      case DiscoveryEvent::Type::kLost:
+        listener.endpoint_lost_cb(event.endpoint_id);
+        break;
+      case DiscoveryEvent::Type::kDistanceChanged:
+        listener.endpoint_distance_changed_cb(event.endpoint_id,
+                                              event.distance_info);
+        break;
+    }
+  }
+}
+
+std::optional<DiscoveryEventCoalescer::EndpointState>
+DiscoveryEventCoalescer::State::GetLatest(
+    const std::string& endpoint_id) const {
+  auto pending_it = pending.find(endpoint_id);
+  if (pending_it != pending.end()) return pending_it->second;
+  auto delivered_it = delivered.find(endpoint_id);
+  if (delivered_it != delivered.end()) return delivered_it->second;
+  return std::nullopt;
+}
+
+std::vector<DiscoveryEvent> DiscoveryEventCoalescer::State::TakeEvents() {
+  std::vector<DiscoveryEvent> events;
+  for (const std::string& endpoint_id : pending_order) {
+    std::optional<EndpointState>& latest = pending[endpoint_id];
+    auto it = delivered.find(endpoint_id);
+    if (it != delivered.end() &&
+        (!latest.has_value() ||
+         it->second.endpoint_info != latest->endpoint_info)) {
+      events.push_back(DiscoveryEvent{
+          .type = DiscoveryEvent::Type::kLost,
+          .endpoint_id = endpoint_id,
+      });
+      delivered.erase(it);
+      it = delivered.end();
+    }
+    if (!latest.has_value()) continue;
+
+    bool distance_changed = latest->distance_info.has_value();
+    if (it == delivered.end()) {
+      events.push_back(DiscoveryEvent{
+          .type = DiscoveryEvent::Type::kFound,
+          .endpoint_id = endpoint_id,
+          .endpoint_info = latest->endpoint_info,
+          .service_id = latest->service_id,
+      });
+    } else {
+      distance_changed &= latest->distance_info != it->second.distance_info;
+    }
+    if (distance_changed) {
+      events.push_back(DiscoveryEvent{
+          .type = DiscoveryEvent::Type::kDistanceChanged,
+          .endpoint_id = endpoint_id,
+          .distance_info = *latest->distance_info,
+      });
+    }
+    delivered.insert_or_assign(endpoint_id, *std::move(latest));
+  }
+  pending.clear();
+  pending_order.clear();
+  return events;
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,117 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_DISCOVERY_EVENT_COALESCER_H_
+#define CORE_INTERNAL_DISCOVERY_EVENT_COALESCER_H_
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/scheduled_executor.h"
+
+namespace nearby {
+namespace connections {
+
+// Coalesces the discovery events of a client over a window, and delivers the
+// resulting changes to its DiscoveryListener, at most once per window.
+//
+// Every endpoint whose state changed over the window gets at most one lost
+// event, followed by at most one found event and one distance changed event,
+// compared to what was delivered before: e.g. an endpoint found and lost in
+// the same window isn't reported, and an endpoint found again with the same
+// endpoint info isn't reported twice. Events are delivered in the order the
+// endpoints first changed, to endpoints_changed_cb if the listener sets it,
+// and to the individual callbacks otherwise.
+//
+// Events are delivered on |executor|, or on the thread calling Flush(). The
+// listener may call back into the client; destroying the coalescer doesn't
+// wait for a delivery in progress.
+class DiscoveryEventCoalescer {
+ public:
+  DiscoveryEventCoalescer(absl::Duration window, DiscoveryListener listener,
+                          ScheduledExecutor* executor);
+  ~DiscoveryEventCoalescer();
+
+  void OnEndpointFound(const std::string& endpoint_id,
+                       const ByteArray& endpoint_info,
+                       const std::string& service_id);
+  void OnEndpointLost(const std::string& endpoint_id);
+  // Ignored unless the endpoint is found.
+  void OnEndpointDistanceChanged(const std::string& endpoint_id,
+                                 DistanceInfo distance_info);
+
+  // Delivers the pending changes right away.
+  void Flush();
+
+ private:
+  struct EndpointState {
+    ByteArray endpoint_info;
+    std::string service_id;
+    std::optional<DistanceInfo> distance_info;
+  };
+
+  // Shared with the scheduled deliveries, which may outlive the coalescer.
+  struct State {
+    explicit State(DiscoveryListener listener)
+        : listener(std::move(listener)) {}
+
+    // Returns the latest state of |endpoint_id|, or nullopt if it is lost.
+    std::optional<EndpointState> GetLatest(const std::string& endpoint_id)
+        const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex);
+    // Returns the changes from the delivered to the latest states, and makes
+    // the latest states the delivered ones.
+    std::vector<DiscoveryEvent> TakeEvents()
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex);
+
+    // Held while delivering, so deliveries don't interleave.
+    Mutex delivery_mutex;
+    DiscoveryListener listener ABSL_GUARDED_BY(delivery_mutex);
+
+    mutable Mutex mutex;
+    bool stopped ABSL_GUARDED_BY(mutex) = false;
+    bool delivery_scheduled ABSL_GUARDED_BY(mutex) = false;
+    // The state of the found endpoints, as delivered.
+    absl::flat_hash_map<std::string, EndpointState> delivered
+        ABSL_GUARDED_BY(mutex);
+    // The latest state of the endpoints changed since, nullopt if lost.
+    absl::flat_hash_map<std::string, std::optional<EndpointState>> pending
+        ABSL_GUARDED_BY(mutex);
+    // The endpoints of |pending|, in the order they first changed.
+    std::vector<std::string> pending_order ABSL_GUARDED_BY(mutex);
+  };
+
+  static void Deliver(State& state);
+
+  void SetPending(const std::string& endpoint_id,
+                  std::optional<EndpointState> endpoint_state)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(state_->mutex);
+
+  const absl::Duration window_;
+  ScheduledExecutor* const executor_;
+  const std::shared_ptr<State> state_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_DISCOVERY_EVENT_COALESCER_H_
@@ -0,0 +1,219 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/discovery_event_coalescer.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/scheduled_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr char kServiceId[] = "service";
+constexpr absl::Duration kLongWindow = absl::Hours(1);
+
+// Appends the events of |batch| to |events| as e.g. "found:A", "lost:A" or
+// "distance:A".
+void Record(const std::vector<DiscoveryEvent>& batch,
+            std::vector<std::string>& events) {
+  for (const DiscoveryEvent& event : batch) {
+    switch (event.type) {
+      case DiscoveryEvent::Type::kFound:
+        events.push_back("found:" + event.endpoint_id);
+        break;
+      case DiscoveryEvent::Type::kLost:
+        events.push_back("lost:" + event.endpoint_id);
+        break;
+      case DiscoveryEvent::Type::kDistanceChanged:
+        events.push_back("distance:" + event.endpoint_id);
+        break;
+    }
+  }
+}
+
+class DiscoveryEventCoalescerTest : public ::testing::Test {
+ protected:
+  DiscoveryListener MakeBatchedListener() {
+    return DiscoveryListener{
+        .endpoints_changed_cb =
+            [this](const std::vector<DiscoveryEvent>& batch) {
+              batches_++;
+              Record(batch, events_);
+            },
+    };
+  }
+
+  ScheduledExecutor executor_;
+  int batches_ = 0;
+  std::vector<std::string> events_;
+};
+
+TEST_F(DiscoveryEventCoalescerTest, FoundAndLostInOneWindowIsNotDelivered) {
+  DiscoveryEventCoalescer coalescer(kLongWindow, MakeBatchedListener(),
+                                    &executor_);
+
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.OnEndpointLost("A");
+  coalescer.Flush();
+
+  EXPECT_EQ(batches_, 0);
+  EXPECT_TRUE(events_.empty());
+}
+
+TEST_F(DiscoveryEventCoalescerTest, DeliversChangesInOneBatch) {
+  std::vector<DiscoveryEvent> delivered;
+  DiscoveryEventCoalescer coalescer(
+      kLongWindow,
+      DiscoveryListener{
+          .endpoints_changed_cb =
+              [&delivered](const std::vector<DiscoveryEvent>& batch) {
+                delivered = batch;
+              },
+      },
+      &executor_);
+
+  coalescer.OnEndpointFound("B", ByteArray("info-b"), kServiceId);
+  coalescer.OnEndpointFound("A", ByteArray("info-a"), kServiceId);
+  coalescer.OnEndpointDistanceChanged("B", DistanceInfo::kClose);
+  coalescer.Flush();
+
+  ASSERT_EQ(delivered.size(), 3);
+  EXPECT_EQ(delivered[0].type, DiscoveryEvent::Type::kFound);
+  EXPECT_EQ(delivered[0].endpoint_id, "B");
+  EXPECT_EQ(delivered[0].endpoint_info, ByteArray("info-b"));
+  EXPECT_EQ(delivered[0].service_id, kServiceId);
+  EXPECT_EQ(delivered[1].type, DiscoveryEvent::Type::kDistanceChanged);
+  EXPECT_EQ(delivered[1].endpoint_id, "B");
+  EXPECT_EQ(delivered[1].distance_info, DistanceInfo::kClose);
+  EXPECT_EQ(delivered[2].type, DiscoveryEvent::Type::kFound);
+  EXPECT_EQ(delivered[2].endpoint_id, "A");
+}
+
+TEST_F(DiscoveryEventCoalescerTest, RepeatedFoundIsDeliveredOnce) {
+  DiscoveryEventCoalescer coalescer(kLongWindow, MakeBatchedListener(),
+                                    &executor_);
+
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.Flush();
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.Flush();
+  // Lost and found again with the same info, within one window.
+  coalescer.OnEndpointLost("A");
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.Flush();
+
+  EXPECT_EQ(batches_, 1);
+  EXPECT_EQ(events_, std::vector<std::string>({"found:A"}));
+}
+
+TEST_F(DiscoveryEventCoalescerTest, ChangedEndpointInfoIsLostThenFound) {
+  DiscoveryEventCoalescer coalescer(kLongWindow, MakeBatchedListener(),
+                                    &executor_);
+
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.OnEndpointDistanceChanged("A", DistanceInfo::kFar);
+  coalescer.Flush();
+  coalescer.OnEndpointFound("A", ByteArray("other info"), kServiceId);
+  coalescer.Flush();
+
+  EXPECT_EQ(events_, std::vector<std::string>(
+                         {"found:A", "distance:A", "lost:A", "found:A"}));
+}
+
+TEST_F(DiscoveryEventCoalescerTest, DistanceIsDeliveredWhenItChanges) {
+  DiscoveryEventCoalescer coalescer(kLongWindow, MakeBatchedListener(),
+                                    &executor_);
+
+  // Ignored, the endpoint isn't found.
+  coalescer.OnEndpointDistanceChanged("A", DistanceInfo::kFar);
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.Flush();
+  coalescer.OnEndpointDistanceChanged("A", DistanceInfo::kFar);
+  coalescer.Flush();
+  coalescer.OnEndpointDistanceChanged("A", DistanceInfo::kClose);
+  coalescer.OnEndpointDistanceChanged("A", DistanceInfo::kFar);
+  coalescer.Flush();
+  coalescer.OnEndpointDistanceChanged("A", DistanceInfo::kClose);
+  coalescer.Flush();
+
+  EXPECT_EQ(events_, std::vector<std::string>(
+                         {"found:A", "distance:A", "distance:A"}));
+}
+
+TEST_F(DiscoveryEventCoalescerTest, FallsBackToIndividualCallbacks) {
+  DiscoveryEventCoalescer coalescer(
+      kLongWindow,
+      DiscoveryListener{
+          .endpoint_found_cb =
+              [this](const std::string& endpoint_id, const ByteArray&,
+                     const std::string& service_id) {
+                EXPECT_EQ(service_id, kServiceId);
+                events_.push_back("found:" + endpoint_id);
+              },
+          .endpoint_lost_cb =
+              [this](const std::string& endpoint_id) {
+                events_.push_back("lost:" + endpoint_id);
+              },
+          .endpoint_distance_changed_cb =
+              [this](const std::string& endpoint_id, DistanceInfo) {
+                events_.push_back("distance:" + endpoint_id);
+              },
+      },
+      &executor_);
+
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.OnEndpointFound("B", ByteArray("info"), kServiceId);
+  coalescer.Flush();
+  coalescer.OnEndpointLost("A");
+  coalescer.OnEndpointDistanceChanged("B", DistanceInfo::kVeryClose);
+  coalescer.Flush();
+
+  EXPECT_EQ(events_, std::vector<std::string>(
+                         {"found:A", "found:B", "lost:A", "distance:B"}));
+}
+
+TEST_F(DiscoveryEventCoalescerTest, DeliversOnExecutorAfterWindow) {
+  CountDownLatch latch(1);
+  std::vector<std::string> events;
+  DiscoveryEventCoalescer coalescer(
+      absl::Milliseconds(50),
+      DiscoveryListener{
+          .endpoints_changed_cb =
+              [&](const std::vector<DiscoveryEvent>& batch) {
+                Record(batch, events);
+                latch.CountDown();
+              },
+      },
+      &executor_);
+
+  coalescer.OnEndpointFound("A", ByteArray("info"), kServiceId);
+  coalescer.OnEndpointFound("B", ByteArray("info"), kServiceId);
+
+  ASSERT_TRUE(latch.Await(absl::Seconds(5)).result());
+  EXPECT_EQ(events, std::vector<std::string>({"found:A", "found:B"}));
+  executor_.Shutdown();
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
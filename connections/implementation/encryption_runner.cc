@@ -30,8 +30,12 @@
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancelable_alarm.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/scheduled_executor.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/trace_event.h"
 
 namespace nearby {
 namespace connections {
@@ -92,6 +96,8 @@ class ServerRunnable final {
         listener_(std::move(listener)) {}
 
   void operator()() {
+    NEARBY_TRACE_EVENT_WITH_FLOW("connections", "UKEY2 handshake (server)",
+                                 TraceFlowIdForEndpoint(endpoint_id_));
     CancelableAlarm timeout_alarm(
         "EncryptionRunner.StartServer() timeout",
         [this]() { CancelableAlarmRunnable(client_, endpoint_id_, channel_); },
@@ -230,6 +236,8 @@ class ClientRunnable final {
         listener_(std::move(listener)) {}
 
   void operator()() {
+    NEARBY_TRACE_EVENT_WITH_FLOW("connections", "UKEY2 handshake (client)",
+                                 TraceFlowIdForEndpoint(endpoint_id_));
     CancelableAlarm timeout_alarm(
         "EncryptionRunner.StartClient() timeout",
         [this]() { CancelableAlarmRunnable(client_, endpoint_id_, channel_); },
@@ -357,6 +365,16 @@ class ClientRunnable final {
 
 }  // namespace
 
+EncryptionRunner::EncryptionRunner() {
+  int max_handshakes = static_cast<int>(
+      FeatureFlags::GetInstance().GetFlags().max_concurrent_server_handshakes);
+  if (max_handshakes > 1) {
+    server_executor_ = std::make_unique<MultiThreadExecutor>(max_handshakes);
+  } else {
+    server_executor_ = std::make_unique<SingleThreadExecutor>();
+  }
+}
+
 EncryptionRunner::~EncryptionRunner() { Shutdown(); }
 
 void EncryptionRunner::StartServer(ClientProxy* client,
@@ -365,7 +383,7 @@ void EncryptionRunner::StartServer(ClientProxy* client,
                                    EncryptionRunner::ResultListener listener) {
   ServerRunnable runnable(client, &alarm_executor_, endpoint_id,
                           endpoint_channel, std::move(listener));
-  server_executor_.Execute("encryption-server", std::move(runnable));
+  server_executor_->Execute("encryption-server", std::move(runnable));
 }
 
 void EncryptionRunner::StartClient(ClientProxy* client,
@@ -384,7 +402,7 @@ void EncryptionRunner::Shutdown() {
 
   // Stop all the ongoing Runnables (as gracefully as possible).
   client_executor_.Shutdown();
-  server_executor_.Shutdown();
+  server_executor_->Shutdown();
   alarm_executor_.Shutdown();
 }
 
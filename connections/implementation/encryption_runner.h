@@ -26,6 +26,7 @@
 #include "internal/platform/byte_array.h"
 #include "internal/platform/scheduled_executor.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/submittable_executor.h"
 
 namespace nearby {
 namespace connections {
@@ -37,7 +38,7 @@ namespace connections {
 // indefinite connection to us.
 class EncryptionRunner {
  public:
-  EncryptionRunner() = default;
+  EncryptionRunner();
   ~EncryptionRunner();
 
   struct ResultListener {
@@ -85,7 +86,9 @@ class EncryptionRunner {
  private:
   AtomicBoolean is_stopped_{false};
   ScheduledExecutor alarm_executor_;
-  SingleThreadExecutor server_executor_;
+  // Runs up to FeatureFlags::max_concurrent_server_handshakes handshakes at
+  // a time.
+  std::unique_ptr<SubmittableExecutor> server_executor_;
   SingleThreadExecutor client_executor_;
 };
 
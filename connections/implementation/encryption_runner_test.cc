@@ -14,10 +14,15 @@
 
 #include "connections/implementation/encryption_runner.h"
 
+#include <atomic>
 #include <cstddef>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
 #include "connections/implementation/client_proxy.h"
@@ -25,6 +30,7 @@
 #include "internal/platform/byte_array.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/output_stream.h"
 #include "internal/platform/pipe.h"
@@ -133,6 +139,42 @@ struct Response {
   Status client_status = Status::kUnknown;
 };
 
+// Two ends of a connection over a pair of pipes.
+struct Connection {
+  Connection()
+      : from_client(CreatePipe()),
+        from_server(CreatePipe()),
+        server_channel(from_client.first.get(), from_server.second.get()),
+        client_channel(from_server.first.get(), from_client.second.get()) {}
+
+  std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
+      from_client;
+  std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
+      from_server;
+  FakeEndpointChannel server_channel;
+  FakeEndpointChannel client_channel;
+};
+
+// Counts down |latch| once the handshake is over, and counts the successful
+// ones in |succeeded|.
+EncryptionRunner::ResultListener CountingListener(CountDownLatch& latch,
+                                                  std::atomic<int>& succeeded) {
+  return {
+      .on_success_cb =
+          [&latch, &succeeded](
+              const std::string& endpoint_id,
+              std::unique_ptr<securegcm::UKey2Handshake> ukey2,
+              const std::string& auth_token, const ByteArray& raw_auth_token) {
+            succeeded++;
+            latch.CountDown();
+          },
+      .on_failure_cb = [&latch](const std::string& endpoint_id,
+                                EndpointChannel* channel) {
+        latch.CountDown();
+      },
+  };
+}
+
 TEST(EncryptionRunnerTest, ConstructorDestructorWorks) { EncryptionRunner enc; }
 
 TEST(EncryptionRunnerTest, ReadWrite) {
@@ -185,6 +227,71 @@ TEST(EncryptionRunnerTest, ReadWrite) {
   EXPECT_EQ(response.client_status, Response::Status::kDone);
 }
 
+TEST(EncryptionRunnerTest, StalledHandshakeDoesNotHoldUpOthers) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.max_concurrent_server_handshakes = 4;
+  EncryptionRunner hub;
+  EncryptionRunner client_runner;
+  ClientProxy hub_client;
+  ClientProxy client;
+  Connection stalled;
+  Connection connection;
+  CountDownLatch stalled_latch(1);
+  CountDownLatch latch(2);
+  std::atomic<int> stalled_succeeded = 0;
+  std::atomic<int> succeeded = 0;
+
+  // The client of |stalled| never starts its handshake.
+  hub.StartServer(&hub_client, "stalled", &stalled.server_channel,
+                  CountingListener(stalled_latch, stalled_succeeded));
+  hub.StartServer(&hub_client, "endpoint_id", &connection.server_channel,
+                  CountingListener(latch, succeeded));
+  client_runner.StartClient(&client, "endpoint_id", &connection.client_channel,
+                            CountingListener(latch, succeeded));
+
+  // The stalled handshake times out after 15 seconds.
+  EXPECT_TRUE(latch.Await(absl::Seconds(5)).result());
+  EXPECT_EQ(succeeded.load(), 2);
+  stalled.server_channel.Close();
+  EXPECT_TRUE(stalled_latch.Await(absl::Seconds(5)).result());
+  EXPECT_EQ(stalled_succeeded.load(), 0);
+  flags = saved_flags;
+}
+
+TEST(EncryptionRunnerTest, HubAcceptsManyClients) {
+  constexpr int kClients = 200;
+  constexpr int kClientRunners = 8;
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.max_concurrent_server_handshakes = 8;
+  EncryptionRunner hub;
+  std::vector<std::unique_ptr<EncryptionRunner>> client_runners;
+  for (int i = 0; i < kClientRunners; ++i) {
+    client_runners.push_back(std::make_unique<EncryptionRunner>());
+  }
+  ClientProxy hub_client;
+  ClientProxy client;
+  std::vector<std::unique_ptr<Connection>> connections;
+  CountDownLatch latch(2 * kClients);
+  std::atomic<int> succeeded = 0;
+
+  for (int i = 0; i < kClients; ++i) {
+    connections.push_back(std::make_unique<Connection>());
+    std::string endpoint_id = absl::StrCat("endpoint_", i);
+    hub.StartServer(&hub_client, endpoint_id,
+                    &connections.back()->server_channel,
+                    CountingListener(latch, succeeded));
+    client_runners[i % kClientRunners]->StartClient(
+        &client, endpoint_id, &connections.back()->client_channel,
+        CountingListener(latch, succeeded));
+  }
+
+  EXPECT_TRUE(latch.Await(absl::Seconds(30)).result());
+  EXPECT_EQ(succeeded.load(), 2 * kClients);
+  flags = saved_flags;
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
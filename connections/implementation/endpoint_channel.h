@@ -15,9 +15,11 @@
 #ifndef CORE_INTERNAL_ENDPOINT_CHANNEL_H_
 #define CORE_INTERNAL_ENDPOINT_CHANNEL_H_
 
+#include <memory>
 #include <string>
 
 #include "securegcm/d2d_connection_context_v1.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
 #include "internal/platform/byte_array.h"
@@ -96,6 +98,22 @@ class EndpointChannel {
   // Enables encryption on the EndpointChannel.
   virtual void EnableEncryption(std::shared_ptr<EncryptionContext> context) = 0;
 
+  // Seals and opens frames with |record_layer| instead of the D2D encoding of
+  // the EncryptionContext. Only takes effect while encryption is enabled, and
+  // is dropped by DisableEncryption().
+  virtual void EnableAeadRecordLayer(
+      std::shared_ptr<AeadRecordLayer> record_layer) {}
+
+  // Writes |last_frame|, then hands every later write over to |successor|, so
+  // frames sealed with an encryption context shared by both channels reach
+  // the remote device in order. Used to switch channels at a frame boundary
+  // in a bandwidth upgrade. DisableEncryption() ends the hand-off, so the
+  // unencrypted closing handshake stays on this channel.
+  virtual Exception WriteAndHandOff(
+      const ByteArray& last_frame, std::shared_ptr<EndpointChannel> successor) {
+    return Write(last_frame);
+  }
+
   // Disables encryption on the EndpointChannel.
   virtual void DisableEncryption() = 0;
 
@@ -132,6 +150,12 @@ class EndpointChannel {
 
   // Enables the multiplex socket on the EndpointChannel.
   virtual bool EnableMultiplexSocket() {return false;}
+
+  // Asks the medium for link settings suited to bulk transfer, until the
+  // matching ReleaseHighThroughput(). Requests nest. Mediums with nothing to
+  // tune ignore them.
+  virtual void RequestHighThroughput() {}
+  virtual void ReleaseHighThroughput() {}
 };
 
 inline bool operator==(const EndpointChannel& lhs, const EndpointChannel& rhs) {
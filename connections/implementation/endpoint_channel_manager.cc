@@ -15,6 +15,7 @@
 #include "connections/implementation/endpoint_channel_manager.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -22,7 +23,9 @@
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/offline_frames.h"
+#include "connections/implementation/session_resumption.h"
 #include "internal/platform/condition_variable.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/implementation/system_clock.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex.h"
@@ -81,15 +84,49 @@ void EndpointChannelManager::ReplaceChannelForEndpoint(
 
 bool EndpointChannelManager::EncryptChannelForEndpoint(
     const std::string& endpoint_id,
-    std::unique_ptr<EncryptionContext> context) {
+    std::unique_ptr<EncryptionContext> context,
+    std::unique_ptr<AeadRecordLayer> record_layer) {
   MutexLock lock(&mutex_);
 
-  channel_state_.UpdateEncryptionContextForEndpoint(endpoint_id,
-                                                    std::move(context));
+  channel_state_.UpdateEncryptionContextForEndpoint(
+      endpoint_id, std::move(context), std::move(record_layer));
   auto* endpoint = channel_state_.LookupEndpointData(endpoint_id);
   return channel_state_.EncryptChannel(endpoint);
 }
 
+std::optional<std::string>
+EndpointChannelManager::GetResumptionSecretForEndpoint(
+    const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+
+  auto* endpoint = channel_state_.LookupEndpointData(endpoint_id);
+  if (endpoint == nullptr || !endpoint->IsEncrypted() ||
+      endpoint->resumption_secret.empty()) {
+    return std::nullopt;
+  }
+  return endpoint->resumption_secret;
+}
+
+bool EndpointChannelManager::ResumeEncryptionForEndpoint(
+    const std::string& endpoint_id,
+    std::unique_ptr<AeadRecordLayer> record_layer, std::string next_secret) {
+  MutexLock lock(&mutex_);
+
+  auto* endpoint = channel_state_.LookupEndpointData(endpoint_id);
+  if (endpoint == nullptr || !endpoint->IsEncrypted()) return false;
+  endpoint->record_layer = std::move(record_layer);
+  endpoint->resumption_secret = std::move(next_secret);
+  return channel_state_.EncryptChannel(endpoint);
+}
+
+void EndpointChannelManager::ClearResumptionSecretForEndpoint(
+    const std::string& endpoint_id) {
+  MutexLock lock(&mutex_);
+
+  auto* endpoint = channel_state_.LookupEndpointData(endpoint_id);
+  if (endpoint != nullptr) endpoint->resumption_secret.clear();
+}
+
 std::shared_ptr<EndpointChannel> EndpointChannelManager::GetChannelForEndpoint(
     const std::string& endpoint_id) {
   MutexLock lock(&mutex_);
@@ -167,6 +204,9 @@ bool EndpointChannelManager::ChannelState::EncryptChannel(
   if (endpoint != nullptr && endpoint->channel != nullptr &&
       endpoint->context != nullptr) {
     endpoint->channel->EnableEncryption(endpoint->context);
+    if (endpoint->record_layer != nullptr) {
+      endpoint->channel->EnableAeadRecordLayer(endpoint->record_layer);
+    }
     return true;
   }
   return false;
@@ -196,9 +236,18 @@ void EndpointChannelManager::ChannelState::UpdateChannelForEndpoint(
 
 void EndpointChannelManager::ChannelState::UpdateEncryptionContextForEndpoint(
     const std::string& endpoint_id,
-    std::unique_ptr<EncryptionContext> context) {
+    std::unique_ptr<EncryptionContext> context,
+    std::unique_ptr<AeadRecordLayer> record_layer) {
   // Create EndpointData instance, if necessary, and populate crypto context.
-  endpoints_[endpoint_id].context = std::move(context);
+  EndpointData& endpoint = endpoints_[endpoint_id];
+  endpoint.resumption_secret.clear();
+  if (context != nullptr &&
+      FeatureFlags::GetInstance().GetFlags().enable_session_resumption) {
+    endpoint.resumption_secret =
+        SessionResumption::DeriveSecret(*context).value_or("");
+  }
+  endpoint.context = std::move(context);
+  endpoint.record_layer = std::move(record_layer);
 }
 
 void EndpointChannelManager::ChannelState::UpdateSafeToDisconnectForEndpoint(
@@ -16,11 +16,13 @@
 #define CORE_INTERNAL_ENDPOINT_CHANNEL_MANAGER_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/time/time.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "internal/platform/mutex.h"
@@ -71,8 +73,32 @@ class EndpointChannelManager final {
                                  bool enable_encryption)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
-  bool EncryptChannelForEndpoint(const std::string& endpoint_id,
-                                 std::unique_ptr<EncryptionContext> context)
+  // Encrypts the channel of an endpoint with |context|. If |record_layer| is
+  // set, frames are sealed with it instead of the D2D encoding of |context|;
+  // both are carried over to channels that replace this one.
+  bool EncryptChannelForEndpoint(
+      const std::string& endpoint_id,
+      std::unique_ptr<EncryptionContext> context,
+      std::unique_ptr<AeadRecordLayer> record_layer = nullptr)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the secret that resumes the encryption of an endpoint over a
+  // reconnected channel, or nullopt if it can't be resumed. See
+  // SessionResumption.
+  std::optional<std::string> GetResumptionSecretForEndpoint(
+      const std::string& endpoint_id) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Seals the frames of an endpoint with |record_layer| from here on, keeping
+  // its encryption context, and replaces its resumption secret with
+  // |next_secret|. Returns false if the endpoint isn't encrypted.
+  bool ResumeEncryptionForEndpoint(
+      const std::string& endpoint_id,
+      std::unique_ptr<AeadRecordLayer> record_layer, std::string next_secret)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops the resumption secret of an endpoint, so that its next reconnection
+  // runs a full UKEY2 handshake.
+  void ClearResumptionSecretForEndpoint(const std::string& endpoint_id)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
   // NOTE(shared_ptr<> usage):
@@ -142,6 +168,9 @@ class EndpointChannelManager final {
 
       std::shared_ptr<EndpointChannel> channel;
       std::shared_ptr<EncryptionContext> context;
+      std::shared_ptr<AeadRecordLayer> record_layer;
+      // Empty unless session resumption is enabled.
+      std::string resumption_secret;
       DisconnectionReason disconnect_reason =
           DisconnectionReason::UNKNOWN_DISCONNECTION_REASON;
       bool safe_to_disconnect_enabled = false;
@@ -174,7 +203,8 @@ class EndpointChannelManager final {
     // Prevoius one is destroyed, if it existed.
     void UpdateEncryptionContextForEndpoint(
         const std::string& endpoint_id,
-        std::unique_ptr<EncryptionContext> context);
+        std::unique_ptr<EncryptionContext> context,
+        std::unique_ptr<AeadRecordLayer> record_layer);
 
     void UpdateSafeToDisconnectForEndpoint(const std::string& endpoint_id,
                                            bool safe_to_disconnect_enabled);
@@ -211,7 +241,7 @@ class EndpointChannelManager final {
                                 bool enable_encryption)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
-  mutable Mutex mutex_;
+  mutable Mutex mutex_{"EndpointChannelManager::mutex_"};
   ChannelState channel_state_;
 };
 
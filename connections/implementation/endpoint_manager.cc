@@ -15,21 +15,34 @@
 #include "connections/implementation/endpoint_manager.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/cleanup/cleanup.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/time/time.h"
 #include "connections/connection_options.h"
+#include "connections/endpoint_stats.h"
+#include "connections/implementation/analytics/link_throughput_recorder.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
 #include "connections/implementation/analytics/throughput_recorder.h"
+#include "connections/implementation/chunk_size_controller.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/endpoint_channel_manager.h"
+#include "connections/implementation/keep_alive_task.h"
+#include "connections/implementation/medium_throughput_history.h"
 #include "connections/implementation/offline_frames.h"
+#include "connections/implementation/offline_frames_validator.h"
+#include "connections/implementation/peer_medium_cache.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/implementation/service_id_constants.h"
 #include "connections/listeners.h"
@@ -39,12 +52,16 @@
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/feature_flags.h"
+#include "internal/platform/implementation/platform.h"
 #include "internal/platform/implementation/system_clock.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_wheel.h"
+#include "internal/platform/trace_event.h"
 #include "internal/proto/analytics/connections_log.pb.h"
 #include "proto/connections_enums.pb.h"
 
@@ -53,6 +70,7 @@ namespace connections {
 
 namespace {
 using ::location::nearby::analytics::proto::ConnectionsLog;
+using ::location::nearby::connections::KeepAliveFrame;
 using ::location::nearby::connections::OfflineFrame;
 using ::location::nearby::connections::PayloadTransferFrame;
 using ::location::nearby::connections::V1Frame;
@@ -68,40 +86,57 @@ constexpr absl::Time kInvalidTimestamp = absl::InfinitePast();
 // The maximum time we will wait for the encryption setup during negotiating a
 // connection.
 constexpr absl::Duration kDecryptRetryTimeout = absl::Seconds(3);
+// The threads writing keep-alive frames in shared keep-alive mode. Each write
+// is short unless its channel stalls, and a stalled channel holds a thread
+// only until it's closed.
+constexpr int kKeepAliveWriteThreads = 4;
 }  // namespace
 
+// Keeps the processor of a FrameProcessorSlot from being replaced or
+// unregistered while it's in use.
 class EndpointManager::LockedFrameProcessor {
  public:
-  explicit LockedFrameProcessor(FrameProcessorWithMutex* fp)
-      : lock_{std::make_unique<MutexLock>(&fp->mutex_)},
-        frame_processor_with_mutex_{fp} {}
+  LockedFrameProcessor(EndpointManager* endpoint_manager,
+                       FrameProcessorSlot* slot)
+      : endpoint_manager_(endpoint_manager), slot_(slot) {
+    // Counting the user before loading the processor pairs with
+    // WaitForFrameDispatches() clearing the processor before it waits.
+    slot_->users.fetch_add(1);
+    frame_processor_ = slot_->processor.load();
+    if (frame_processor_ == nullptr) Release();
+  }
 
   // Constructor of a no-op object.
   LockedFrameProcessor() = default;
 
+  LockedFrameProcessor(LockedFrameProcessor&& other)
+      : endpoint_manager_(other.endpoint_manager_),
+        slot_(std::exchange(other.slot_, nullptr)),
+        frame_processor_(std::exchange(other.frame_processor_, nullptr)) {}
+  LockedFrameProcessor& operator=(LockedFrameProcessor&&) = delete;
+
+  ~LockedFrameProcessor() { Release(); }
+
   explicit operator bool() const { return get() != nullptr; }
 
   FrameProcessor* operator->() const { return get(); }
 
-  void set(FrameProcessor* frame_processor) {
-    if (frame_processor_with_mutex_)
-      frame_processor_with_mutex_->frame_processor_ = frame_processor;
-  }
-
-  FrameProcessor* get() const {
-    return frame_processor_with_mutex_
-               ? frame_processor_with_mutex_->frame_processor_
-               : nullptr;
-  }
+  FrameProcessor* get() const { return frame_processor_; }
 
-  void reset() {
-    if (frame_processor_with_mutex_)
-      frame_processor_with_mutex_->frame_processor_ = nullptr;
+ private:
+  void Release() {
+    if (slot_ == nullptr) return;
+    if (slot_->users.fetch_sub(1) == 1 && slot_->waiters.load() > 0) {
+      MutexLock lock(&endpoint_manager_->frame_processors_mutex_);
+      endpoint_manager_->frame_processors_released_.Notify();
+    }
+    slot_ = nullptr;
+    frame_processor_ = nullptr;
   }
 
- private:
-  std::unique_ptr<MutexLock> lock_;
-  FrameProcessorWithMutex* frame_processor_with_mutex_ = nullptr;
+  EndpointManager* endpoint_manager_ = nullptr;
+  FrameProcessorSlot* slot_ = nullptr;
+  FrameProcessor* frame_processor_ = nullptr;
 };
 
 // A Runnable that continuously grabs the most recent EndpointChannel available
@@ -227,11 +262,19 @@ ExceptionOr<bool> EndpointManager::HandleData(
     const std::string& endpoint_id, ClientProxy* client,
     EndpointChannel* endpoint_channel) {
   bool try_decrypting = !endpoint_channel->IsEncrypted();
+  std::shared_ptr<analytics::LinkThroughputRecorder> link_throughput =
+      link_throughput_.GetRecorder(endpoint_id, endpoint_channel->GetMedium(),
+                                   PayloadDirection::INCOMING_PAYLOAD);
   // Read as much as we can from the healthy EndpointChannel - when it is no
   // longer in good shape (i.e. our read from it throws an Exception), our
   // super class will loop back around and try our luck in case there's been
   // a replacement for this endpoint since we last checked with the
   // EndpointChannelManager.
+  // Every frame is parsed into this one, so that the messages of a frame are
+  // only allocated once per reader, rather than for every chunk.
+  OfflineFrame frame;
+  // The file names of a payload are checked on its first chunk only.
+  parser::ValidatedPayloadHeaders validated_headers;
   while (true) {
     PacketMetaData packet_meta_data;
     ExceptionOr<ByteArray> bytes = endpoint_channel->Read(packet_meta_data);
@@ -240,8 +283,9 @@ ExceptionOr<bool> EndpointManager::HandleData(
                         << bytes.exception();
       return ExceptionOr<bool>(bytes.exception());
     }
-    ExceptionOr<OfflineFrame> wrapped_frame = parser::FromBytes(bytes.result());
-    if (!wrapped_frame.ok() && try_decrypting) {
+    Exception parse_exception =
+        parser::FromBytes(bytes.result(), frame, &validated_headers);
+    if (parse_exception.Raised() && try_decrypting) {
       // Workaround for a race condition where the remote party has sent an
       // encrypted message but our end was still configured as unencrypted when
       // the message was received. The workaround is to wait until the
@@ -255,32 +299,57 @@ ExceptionOr<bool> EndpointManager::HandleData(
       ExceptionOr<OfflineFrame> decrypted =
           TryDecryptFrame(bytes.result(), endpoint_channel);
       if (decrypted.ok()) {
-        wrapped_frame = std::move(decrypted);
+        frame = std::move(decrypted.result());
+        parse_exception = {Exception::kSuccess};
       }
     }
-    if (!wrapped_frame.ok()) {
-      if (wrapped_frame.GetException().Raised(
-              Exception::kInvalidProtocolBuffer)) {
+    if (parse_exception.Raised()) {
+      if (parse_exception.Raised(Exception::kInvalidProtocolBuffer)) {
         NEARBY_LOGS(INFO) << "Failed to decode; endpoint=" << endpoint_id
                           << "; channel=" << endpoint_channel->GetType()
                           << "; skip";
         continue;
       } else {
         NEARBY_LOGS(INFO) << "Stop reading on parse-time exception: "
-                          << wrapped_frame.exception();
-        return ExceptionOr<bool>(wrapped_frame.exception());
+                          << parse_exception.value;
+        return ExceptionOr<bool>(parse_exception);
       }
     }
-    OfflineFrame& frame = wrapped_frame.result();
 
     // Route the incoming offlineFrame to its registered processor.
     V1Frame::FrameType frame_type = parser::GetFrameType(frame);
+    const PayloadTransferFrame& payload_transfer =
+        frame.v1().payload_transfer();
+    bool more_chunks_expected =
+        frame_type == V1Frame::PAYLOAD_TRANSFER &&
+        payload_transfer.packet_type() == PayloadTransferFrame::DATA &&
+        (payload_transfer.payload_chunk().flags() &
+         PayloadTransferFrame::PayloadChunk::LAST_CHUNK) == 0;
+    link_throughput->OnFrame(
+        bytes.result().size(),
+        (packet_meta_data.socket_io_end_time -
+         packet_meta_data.socket_io_start_time) +
+            (packet_meta_data.decryption_end_time -
+             packet_meta_data.decryption_start_time),
+        more_chunks_expected);
     LockedFrameProcessor frame_processor = GetFrameProcessor(frame_type);
     if (!frame_processor) {
       // report messages without handlers, except KEEP_ALIVE, which has
       // no explicit handler.
       if (frame_type == V1Frame::KEEP_ALIVE) {
         NEARBY_LOGS(INFO) << "KeepAlive message for endpoint " << endpoint_id;
+        const KeepAliveFrame& keep_alive = frame.v1().keep_alive();
+        if (keep_alive.ack()) {
+          OnKeepAliveAck(endpoint_id, keep_alive.seq_num());
+        } else if (keep_alive.has_seq_num()) {
+          // Echo the probe, so that the endpoint can measure the round trip.
+          Exception write_exception = endpoint_channel->Write(
+              parser::ForKeepAlive(/*ack=*/true, keep_alive.seq_num()));
+          if (!write_exception.Ok()) {
+            NEARBY_LOGS(INFO) << "Failed to ack KeepAlive for endpoint "
+                              << endpoint_id;
+          }
+        }
       } else if (frame_type == V1Frame::DISCONNECTION) {
         NEARBY_LOGS(INFO) << "Disconnect message for endpoint " << endpoint_id;
         ProcessDisconnectionFrame(client, endpoint_id, endpoint_channel, frame);
@@ -301,6 +370,23 @@ ExceptionOr<bool> EndpointManager::HandleData(
 void EndpointManager::ProcessDisconnectionFrame(
     ClientProxy* client, const std::string& endpoint_id,
     EndpointChannel* endpoint_channel, OfflineFrame& frame) {
+  if (frame.v1().disconnection().park_connection() &&
+      client->IsConnectionPoolEnabled()) {
+    NEARBY_LOGS(INFO) << "EndpointManager received a DISCONNECTION frame "
+                         "parking the connection to endpoint "
+                      << endpoint_id << " on channel "
+                      << endpoint_channel->GetType();
+    RunOnEndpointManagerThread("park-endpoint", [this, client, endpoint_id]() {
+      if (!ParkEndpoint(client, endpoint_id,
+                        DisconnectionReason::REMOTE_DISCONNECTION)) {
+        RemoveEndpoint(client, endpoint_id,
+                       /*notify=*/client->IsConnectedToEndpoint(endpoint_id),
+                       DisconnectionReason::REMOTE_DISCONNECTION);
+      }
+    });
+    return;
+  }
+
   if (!client->IsSafeToDisconnectEnabled(endpoint_id)) {
     NEARBY_LOGS(INFO)
         << "EndpointManager received a DISCONNECTION frame from endpoint "
@@ -355,9 +441,34 @@ void EndpointManager::ProcessDisconnectionFrame(
 }
 
 ExceptionOr<bool> EndpointManager::HandleKeepAlive(
-    EndpointChannel* endpoint_channel, absl::Duration keep_alive_interval,
-    absl::Duration keep_alive_timeout, Mutex* keep_alive_waiter_mutex,
-    ConditionVariable* keep_alive_waiter) {
+    const std::string& endpoint_id, EndpointChannel* endpoint_channel,
+    absl::Duration keep_alive_interval, absl::Duration keep_alive_timeout,
+    Mutex* keep_alive_waiter_mutex, ConditionVariable* keep_alive_waiter) {
+  ExceptionOr<absl::Duration> wait_for =
+      CheckKeepAlive(endpoint_id, endpoint_channel, keep_alive_interval,
+                     keep_alive_timeout);
+  if (!wait_for.ok()) {
+    return ExceptionOr<bool>(wait_for.exception());
+  }
+  if (wait_for.result() <= absl::ZeroDuration()) {
+    return ExceptionOr<bool>(false);
+  }
+
+  {
+    MutexLock lock(keep_alive_waiter_mutex);
+    Exception wait_exception = keep_alive_waiter->Wait(wait_for.result());
+    if (!wait_exception.Ok()) {
+      return ExceptionOr<bool>(wait_exception);
+    }
+  }
+
+  return ExceptionOr<bool>(true);
+}
+
+ExceptionOr<absl::Duration> EndpointManager::CheckKeepAlive(
+    const std::string& endpoint_id, EndpointChannel* endpoint_channel,
+    absl::Duration keep_alive_interval, absl::Duration keep_alive_timeout,
+    absl::AnyInvocable<Exception(ByteArray)> write) {
   // Check if it has been too long since we received a frame from our endpoint.
   absl::Time last_read_time = endpoint_channel->GetLastReadTimestamp();
   absl::Duration duration_until_timeout =
@@ -366,7 +477,7 @@ ExceptionOr<bool> EndpointManager::HandleKeepAlive(
           : last_read_time + keep_alive_timeout -
                 SystemClock::ElapsedRealtime();
   if (duration_until_timeout <= absl::ZeroDuration()) {
-    return ExceptionOr<bool>(false);
+    return ExceptionOr<absl::Duration>(absl::ZeroDuration());
   }
 
   // If we haven't written anything to the endpoint for a while, attempt to
@@ -379,25 +490,125 @@ ExceptionOr<bool> EndpointManager::HandleKeepAlive(
           ? keep_alive_interval
           : last_write_time + keep_alive_interval -
                 SystemClock::ElapsedRealtime();
+  if (suppress_keep_alive_while_reading_ &&
+      last_write_time != kInvalidTimestamp &&
+      last_read_time != kInvalidTimestamp && last_read_time > last_write_time) {
+    // The link is busy the other way. The endpoint only needs to hear from
+    // us before its keep-alive timeout, which is the same as ours.
+    absl::Time keep_alive_due =
+        std::min(last_read_time + keep_alive_interval,
+                 last_write_time + keep_alive_timeout / 2);
+    duration_until_write_keep_alive =
+        std::max(keep_alive_due, last_write_time + keep_alive_interval) -
+        SystemClock::ElapsedRealtime();
+  }
   if (duration_until_write_keep_alive <= absl::ZeroDuration()) {
-    Exception write_exception = endpoint_channel->Write(parser::ForKeepAlive());
+    ByteArray keep_alive =
+        parser::ForKeepAlive(/*ack=*/false, StartRttProbe(endpoint_id));
+    Exception write_exception = write ? write(std::move(keep_alive))
+                                      : endpoint_channel->Write(keep_alive);
     if (!write_exception.Ok()) {
-      return ExceptionOr<bool>(write_exception);
+      return ExceptionOr<absl::Duration>(write_exception);
     }
     duration_until_write_keep_alive = keep_alive_interval;
   }
 
-  absl::Duration wait_for =
-      std::min(duration_until_timeout, duration_until_write_keep_alive);
-  {
-    MutexLock lock(keep_alive_waiter_mutex);
-    Exception wait_exception = keep_alive_waiter->Wait(wait_for);
-    if (!wait_exception.Ok()) {
-      return ExceptionOr<bool>(wait_exception);
-    }
+  return ExceptionOr<absl::Duration>(
+      std::min(duration_until_timeout, duration_until_write_keep_alive));
+}
+
+std::uint32_t EndpointManager::StartRttProbe(const std::string& endpoint_id) {
+  MutexLock lock(&rtt_mutex_);
+  RttState& rtt = rtts_[endpoint_id];
+  // 0 reads the same as no sequence number.
+  if (++rtt.probe_seq_num == 0) ++rtt.probe_seq_num;
+  rtt.probe_sent_at = SystemClock::ElapsedRealtime();
+  return rtt.probe_seq_num;
+}
+
+void EndpointManager::OnKeepAliveAck(const std::string& endpoint_id,
+                                     std::uint32_t seq_num) {
+  MutexLock lock(&rtt_mutex_);
+  auto it = rtts_.find(endpoint_id);
+  if (it == rtts_.end()) return;
+  RttState& rtt = it->second;
+  if (seq_num != rtt.probe_seq_num ||
+      rtt.probe_sent_at == absl::InfinitePast()) {
+    return;
   }
+  absl::Duration sample = SystemClock::ElapsedRealtime() - rtt.probe_sent_at;
+  rtt.probe_sent_at = absl::InfinitePast();
+  rtt.smoothed_rtt = rtt.smoothed_rtt.has_value()
+                         ? (1 - kRttSmoothing) * *rtt.smoothed_rtt +
+                               kRttSmoothing * sample
+                         : sample;
+}
 
-  return ExceptionOr<bool>(true);
+std::optional<absl::Duration> EndpointManager::RunSharedKeepAliveStep(
+    ClientProxy* client, const std::string& endpoint_id,
+    absl::Duration keep_alive_interval, absl::Duration keep_alive_timeout,
+    Medium& last_failed_medium,
+    std::shared_ptr<KeepAliveWriteState> write_state) {
+  if (client->IsParkedConnectionExpired(endpoint_id)) {
+    NEARBY_LOGS(INFO) << "Parked connection expired for endpoint "
+                      << endpoint_id;
+    return std::nullopt;
+  }
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) {
+    NEARBY_LOGS(INFO) << "Endpoint channel is nullptr, bail out.";
+    return std::nullopt;
+  }
+  // A keep-alive that failed to be written since the last step counts as
+  // having failed in that step.
+  Medium failed_medium =
+      write_state->failed_medium.exchange(Medium::UNKNOWN_MEDIUM);
+  if (failed_medium != Medium::UNKNOWN_MEDIUM) {
+    last_failed_medium = failed_medium;
+  }
+  if ((last_failed_medium != Medium::UNKNOWN_MEDIUM) &&
+      (channel->GetMedium() == last_failed_medium)) {
+    NEARBY_LOGS(INFO)
+        << "No new endpoint channel is found after a failure, exit loop.";
+    return std::nullopt;
+  }
+
+  ExceptionOr<absl::Duration> wait_for = CheckKeepAlive(
+      endpoint_id, channel.get(), keep_alive_interval, keep_alive_timeout,
+      [this, channel, write_state](ByteArray keep_alive) {
+        // The keep-alive still being written stands in for this one.
+        if (write_state->in_flight.exchange(true)) {
+          return Exception{Exception::kSuccess};
+        }
+        keep_alive_write_executor_->Execute(
+            "keep-alive-write",
+            [channel, write_state, keep_alive = std::move(keep_alive)]() {
+              if (!channel->Write(keep_alive).Ok()) {
+                write_state->failed_medium = channel->GetMedium();
+              }
+              write_state->in_flight = false;
+            });
+        return Exception{Exception::kSuccess};
+      });
+  if (!wait_for.ok()) {
+    if (wait_for.GetException().Raised(Exception::kIo)) {
+      // Retry right away, in case the channel has been replaced.
+      last_failed_medium = channel->GetMedium();
+      return absl::ZeroDuration();
+    }
+    return std::nullopt;
+  }
+  if (wait_for.result() <= absl::ZeroDuration()) {
+    NEARBY_LOGS(INFO) << "Keep-alive timed out for endpoint " << endpoint_id;
+    if (client->IsSafeToDisconnectEnabled(endpoint_id)) {
+      channel_manager_->MarkEndpointStopWaitToDisconnect(
+          endpoint_id, /* is_safe_to_disconnect */ false,
+          /* notify_stop_waiting */ true);
+    }
+    return std::nullopt;
+  }
+  return wait_for.result();
 }
 
 bool operator==(const EndpointManager::FrameProcessor& lhs,
@@ -415,12 +626,47 @@ bool operator<(const EndpointManager::FrameProcessor& lhs,
 }
 
 EndpointManager::EndpointManager(EndpointChannelManager* manager)
-    : EndpointManager(manager, std::make_unique<SingleThreadExecutor>()) {}
+    : EndpointManager(
+          manager, std::make_unique<SingleThreadExecutor>("EndpointManager")) {}
 
 EndpointManager::EndpointManager(
     EndpointChannelManager* manager,
     std::unique_ptr<SingleThreadExecutor> serial_executor)
-    : channel_manager_(manager), serial_executor_(std::move(serial_executor)) {}
+    : channel_manager_(manager), serial_executor_(std::move(serial_executor)) {
+  if (FeatureFlags::GetInstance()
+          .GetFlags()
+          .enable_shared_endpoint_keep_alive) {
+    keep_alive_timer_wheel_ = std::make_unique<TimerWheel>();
+    keep_alive_executor_ = std::make_unique<SingleThreadExecutor>();
+    keep_alive_write_executor_ =
+        std::make_unique<MultiThreadExecutor>(kKeepAliveWriteThreads);
+  }
+  std::uint32_t max_parallel_writes = FeatureFlags::GetInstance()
+                                         .GetFlags()
+                                         .payload_fan_out_max_parallel_writes;
+  if (max_parallel_writes > 1) {
+    fan_out_executor_ =
+        std::make_unique<MultiThreadExecutor>(max_parallel_writes);
+  }
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  suppress_keep_alive_while_reading_ = flags.enable_keep_alive_suppression;
+  if (flags.endpoint_teardown_max_parallel_disconnects > 1) {
+    teardown_executor_ = std::make_unique<MultiThreadExecutor>(
+        flags.endpoint_teardown_max_parallel_disconnects);
+  }
+  if (flags.enable_adaptive_chunk_size) {
+    chunk_size_controller_ = std::make_unique<ChunkSizeController>(
+        flags.adaptive_chunk_size_target_frame_duration,
+        flags.adaptive_chunk_size_grow_after_frames);
+  }
+  if (flags.enable_peer_medium_cache) {
+    peer_preferences_manager_ =
+        api::ImplementationPlatform::CreatePreferencesManager(
+            PeerMediumCache::kPreferencesFilePath);
+    peer_medium_cache_ =
+        std::make_unique<PeerMediumCache>(peer_preferences_manager_.get());
+  }
+}
 
 EndpointManager::~EndpointManager() {
   NEARBY_LOGS(INFO) << "Initiating shutdown of EndpointManager.";
@@ -437,6 +683,20 @@ EndpointManager::~EndpointManager() {
   });
   latch.Await();
 
+  if (keep_alive_executor_) {
+    NEARBY_LOGS(INFO) << "Bringing down keep-alive threads";
+    keep_alive_timer_wheel_->Shutdown();
+    keep_alive_executor_->Shutdown();
+    keep_alive_write_executor_->Shutdown();
+  }
+  if (fan_out_executor_) {
+    NEARBY_LOGS(INFO) << "Bringing down fan-out write threads";
+    fan_out_executor_->Shutdown();
+  }
+  if (teardown_executor_) {
+    NEARBY_LOGS(INFO) << "Bringing down teardown threads";
+    teardown_executor_->Shutdown();
+  }
   NEARBY_LOGS(INFO) << "Bringing down control thread";
   serial_executor_->Shutdown();
   NEARBY_LOGS(INFO) << "EndpointManager is down";
@@ -444,21 +704,23 @@ EndpointManager::~EndpointManager() {
 
 void EndpointManager::RegisterFrameProcessor(
     V1Frame::FrameType frame_type, EndpointManager::FrameProcessor* processor) {
-  if (auto frame_processor = GetFrameProcessor(frame_type)) {
+  FrameProcessorSlot* slot = GetFrameProcessorSlot(frame_type);
+  if (slot == nullptr) return;
+  MutexLock lock(&frame_processors_mutex_);
+  FrameProcessor* previous = slot->processor.exchange(processor);
+  if (previous != nullptr) {
     NEARBY_LOGS(INFO) << "EndpointManager received request to update "
                          "registration of frame processor "
                       << processor << " for frame type "
                       << V1Frame::FrameType_Name(frame_type) << ", self"
                       << this;
-    frame_processor.set(processor);
+    WaitForFrameDispatches(*slot);
   } else {
-    MutexLock lock(&frame_processors_lock_);
     NEARBY_LOGS(INFO) << "EndpointManager received request to add registration "
                          "of frame processor "
                       << processor << " for frame type "
                       << V1Frame::FrameType_Name(frame_type)
                       << ", self=" << this;
-    frame_processors_.emplace(frame_type, processor);
   }
 }
 
@@ -468,34 +730,51 @@ void EndpointManager::UnregisterFrameProcessor(
   NEARBY_LOGS(INFO) << "UnregisterFrameProcessor [enter]: processor ="
                     << processor;
   if (processor == nullptr) return;
-  if (auto frame_processor = GetFrameProcessor(frame_type)) {
-    if (frame_processor.get() == processor) {
-      frame_processor.reset();
-      NEARBY_LOGS(INFO) << "EndpointManager unregister frame processor "
-                        << processor << " for frame type "
-                        << V1Frame::FrameType_Name(frame_type)
-                        << ", self=" << this;
-    } else {
-      NEARBY_LOGS(INFO) << "EndpointManager cannot unregister frame processor "
-                        << processor
-                        << " because it is not registered for frame type "
-                        << V1Frame::FrameType_Name(frame_type)
-                        << ", expected=" << frame_processor.get();
-    }
-  } else {
+  FrameProcessorSlot* slot = GetFrameProcessorSlot(frame_type);
+  if (slot == nullptr) return;
+  MutexLock lock(&frame_processors_mutex_);
+  FrameProcessor* registered = slot->processor.load();
+  if (registered == nullptr) {
     NEARBY_LOGS(INFO) << "UnregisterFrameProcessor [not found]: processor="
                       << processor;
+  } else if (registered == processor) {
+    slot->processor.store(nullptr);
+    WaitForFrameDispatches(*slot);
+    NEARBY_LOGS(INFO) << "EndpointManager unregister frame processor "
+                      << processor << " for frame type "
+                      << V1Frame::FrameType_Name(frame_type)
+                      << ", self=" << this;
+  } else {
+    NEARBY_LOGS(INFO) << "EndpointManager cannot unregister frame processor "
+                      << processor
+                      << " because it is not registered for frame type "
+                      << V1Frame::FrameType_Name(frame_type)
+                      << ", expected=" << registered;
   }
 }
 
-EndpointManager::LockedFrameProcessor EndpointManager::GetFrameProcessor(
+EndpointManager::FrameProcessorSlot* EndpointManager::GetFrameProcessorSlot(
     V1Frame::FrameType frame_type) {
-  MutexLock lock(&frame_processors_lock_);
-  auto it = frame_processors_.find(frame_type);
-  if (it != frame_processors_.end()) {
-    return LockedFrameProcessor(&it->second);
+  if (frame_type < 0 ||
+      static_cast<size_t>(frame_type) >= frame_processors_.size()) {
+    return nullptr;
+  }
+  return &frame_processors_[frame_type];
+}
+
+void EndpointManager::WaitForFrameDispatches(FrameProcessorSlot& slot) {
+  slot.waiters.fetch_add(1);
+  while (slot.users.load() != 0) {
+    frame_processors_released_.Wait();
   }
-  return LockedFrameProcessor();
+  slot.waiters.fetch_sub(1);
+}
+
+EndpointManager::LockedFrameProcessor EndpointManager::GetFrameProcessor(
+    V1Frame::FrameType frame_type) {
+  FrameProcessorSlot* slot = GetFrameProcessorSlot(frame_type);
+  if (slot == nullptr) return LockedFrameProcessor();
+  return LockedFrameProcessor(this, slot);
 }
 
 void EndpointManager::RemoveEndpointState(const std::string& endpoint_id) {
@@ -507,6 +786,27 @@ void EndpointManager::RemoveEndpointState(const std::string& endpoint_id) {
     // terminate soon. Removing EndpointState waits for workers to complete.
     endpoints_.erase(item);
     NEARBY_VLOG(1) << "Workers terminated for endpoint " << endpoint_id;
+    if (chunk_size_controller_) {
+      chunk_size_controller_->RemoveEndpoint(endpoint_id);
+    }
+    std::string peer_key = GetPeerKey(endpoint_id);
+    for (const auto& [medium, snapshot] : link_throughput_.GetSnapshots(
+             endpoint_id, PayloadDirection::OUTGOING_PAYLOAD)) {
+      medium_throughput_history_.Record(endpoint_id, medium, snapshot.bytes,
+                                        snapshot.active_bytes_per_second);
+      if (peer_medium_cache_ != nullptr &&
+          snapshot.bytes >= MediumThroughputHistory::kMinSampleBytes) {
+        peer_medium_cache_->RecordThroughput(peer_key, medium,
+                                             snapshot.active_bytes_per_second);
+      }
+    }
+    {
+      MutexLock lock(&peer_key_mutex_);
+      peer_keys_.erase(endpoint_id);
+    }
+    link_throughput_.RemoveEndpoint(endpoint_id);
+    MutexLock lock(&rtt_mutex_);
+    rtts_.erase(endpoint_id);
   } else {
     NEARBY_LOGS(INFO) << "EndpointState not found for endpoint " << endpoint_id;
   }
@@ -554,6 +854,11 @@ void EndpointManager::RegisterEndpoint(
     // Pass ownership of channel to EndpointChannelManager
     NEARBY_LOGS(INFO) << "Registering endpoint with channel manager: endpoint "
                       << endpoint_id;
+    if (peer_medium_cache_ != nullptr) {
+      MutexLock lock(&peer_key_mutex_);
+      peer_keys_[endpoint_id] = PeerMediumCache::GetPeerKey(
+          channel->GetServiceId(), info.remote_endpoint_info);
+    }
     channel_manager_->RegisterChannelForEndpoint(
         client, endpoint_id, std::unique_ptr<EndpointChannel>(channel));
 
@@ -592,20 +897,46 @@ void EndpointManager::RegisterEndpoint(
     // listen for the pong.
     NEARBY_VLOG(1) << "EndpointManager enabling KeepAlive for endpoint "
                    << endpoint_id;
-    endpoint_state.StartEndpointKeepAliveManager(
-        [this, client, endpoint_id, keep_alive_interval, keep_alive_timeout](
-            Mutex* keep_alive_waiter_mutex,
-            ConditionVariable* keep_alive_waiter) {
-          EndpointChannelLoopRunnable(
-              "KeepAliveManager", client, endpoint_id,
-              [this, keep_alive_interval, keep_alive_timeout,
-               keep_alive_waiter_mutex,
-               keep_alive_waiter](EndpointChannel* channel) {
-                return HandleKeepAlive(
-                    channel, keep_alive_interval, keep_alive_timeout,
-                    keep_alive_waiter_mutex, keep_alive_waiter);
-              });
-        });
+    if (keep_alive_executor_) {
+      endpoint_state.StartSharedKeepAliveManager(
+          keep_alive_timer_wheel_.get(), keep_alive_executor_.get(),
+          [this, client, endpoint_id, keep_alive_interval, keep_alive_timeout,
+           last_failed_medium = Medium::UNKNOWN_MEDIUM,
+           write_state = std::make_shared<KeepAliveWriteState>()]() mutable {
+            return RunSharedKeepAliveStep(client, endpoint_id,
+                                          keep_alive_interval,
+                                          keep_alive_timeout,
+                                          last_failed_medium, write_state);
+          },
+          [this, client, endpoint_id]() {
+            NEARBY_LOGS(INFO) << "Keep-alive done; endpoint_id="
+                              << endpoint_id;
+            DiscardEndpoint(client, endpoint_id,
+                            DisconnectionReason::IO_ERROR);
+          });
+    } else {
+      endpoint_state.StartEndpointKeepAliveManager(
+          [this, client, endpoint_id, keep_alive_interval, keep_alive_timeout](
+              Mutex* keep_alive_waiter_mutex,
+              ConditionVariable* keep_alive_waiter) {
+            EndpointChannelLoopRunnable(
+                "KeepAliveManager", client, endpoint_id,
+                [this, client, endpoint_id, keep_alive_interval,
+                 keep_alive_timeout, keep_alive_waiter_mutex,
+                 keep_alive_waiter](EndpointChannel* channel) {
+                  if (client->IsParkedConnectionExpired(endpoint_id)) {
+                    NEARBY_LOGS(INFO)
+                        << "Parked connection expired for endpoint "
+                        << endpoint_id;
+                    return ExceptionOr<bool>(false);
+                  }
+                  return HandleKeepAlive(
+                      endpoint_id, channel, keep_alive_interval,
+                      keep_alive_timeout, keep_alive_waiter_mutex,
+                      keep_alive_waiter);
+                });
+          });
+    }
     NEARBY_LOGS(INFO) << "Registering endpoint " << endpoint_id
                       << ", workers started and notifying client.";
 
@@ -624,14 +955,71 @@ void EndpointManager::UnregisterEndpoint(ClientProxy* client,
   CountDownLatch latch(1);
   RunOnEndpointManagerThread(
       "unregister-endpoint", [this, client, endpoint_id, &latch]() {
-        RemoveEndpoint(client, endpoint_id,
-                       /*notify=*/client->IsConnectedToEndpoint(endpoint_id),
-                       DisconnectionReason::LOCAL_DISCONNECTION);
+        if (!ParkEndpoint(client, endpoint_id,
+                          DisconnectionReason::LOCAL_DISCONNECTION)) {
+          RemoveEndpoint(client, endpoint_id,
+                         /*notify=*/client->IsConnectedToEndpoint(endpoint_id),
+                         DisconnectionReason::LOCAL_DISCONNECTION);
+        }
         latch.CountDown();
       });
   latch.Await();
 }
 
+void EndpointManager::UnregisterEndpoints(
+    ClientProxy* client, const std::vector<std::string>& endpoint_ids) {
+  if (teardown_executor_ == nullptr || endpoint_ids.size() < 2) {
+    for (const std::string& endpoint_id : endpoint_ids) {
+      UnregisterEndpoint(client, endpoint_id);
+    }
+    return;
+  }
+  NEARBY_LOGS(INFO) << "UnregisterEndpoints for " << endpoint_ids.size()
+                    << " endpoints";
+  CountDownLatch latch(1);
+  RunOnEndpointManagerThread(
+      "unregister-endpoints", [this, client, &endpoint_ids, &latch]() {
+        std::vector<std::string> removed_endpoint_ids;
+        for (const std::string& endpoint_id : endpoint_ids) {
+          if (!ParkEndpoint(client, endpoint_id,
+                            DisconnectionReason::LOCAL_DISCONNECTION)) {
+            removed_endpoint_ids.push_back(endpoint_id);
+          }
+        }
+        RemoveEndpoints(client, removed_endpoint_ids,
+                        DisconnectionReason::LOCAL_DISCONNECTION);
+        latch.CountDown();
+      });
+  latch.Await();
+}
+
+bool EndpointManager::ResumeEndpoint(
+    ClientProxy* client, const std::string& endpoint_id,
+    const ConnectionResponseInfo& info,
+    const ConnectionOptions& connection_options,
+    const ConnectionListener& listener, const std::string& connection_token) {
+  CountDownLatch latch(1);
+  bool resumed = false;
+  RunOnEndpointManagerThread(
+      "resume-endpoint",
+      [this, client, &endpoint_id, &info, &connection_options, &listener,
+       &connection_token, &resumed, &latch]() {
+        // The workers of a parked endpoint keep running with the keep-alive
+        // settings it was registered with.
+        if (endpoints_.contains(endpoint_id) &&
+            channel_manager_->GetChannelForEndpoint(endpoint_id) != nullptr) {
+          NEARBY_LOGS(INFO) << "Resuming parked connection to endpoint "
+                            << endpoint_id;
+          client->OnConnectionInitiated(endpoint_id, info, connection_options,
+                                        listener, connection_token);
+          resumed = true;
+        }
+        latch.CountDown();
+      });
+  latch.Await();
+  return resumed;
+}
+
 int EndpointManager::GetMaxTransmitPacketSize(const std::string& endpoint_id) {
   std::shared_ptr<EndpointChannel> channel =
       channel_manager_->GetChannelForEndpoint(endpoint_id);
@@ -642,20 +1030,115 @@ int EndpointManager::GetMaxTransmitPacketSize(const std::string& endpoint_id) {
   return channel->GetMaxTransmitPacketSize();
 }
 
+int EndpointManager::GetChunkSize(const std::string& endpoint_id) {
+  int max_chunk_size = GetMaxTransmitPacketSize(endpoint_id);
+  if (chunk_size_controller_ == nullptr || max_chunk_size <= 0) {
+    return max_chunk_size;
+  }
+  return chunk_size_controller_->GetChunkSize(endpoint_id, max_chunk_size);
+}
+
+void EndpointManager::RequestHighThroughput(const std::string& endpoint_id) {
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) {
+    return;
+  }
+  channel->RequestHighThroughput();
+}
+
+void EndpointManager::ReleaseHighThroughput(const std::string& endpoint_id) {
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) {
+    return;
+  }
+  channel->ReleaseHighThroughput();
+}
+
+std::string EndpointManager::GetPeerKey(const std::string& endpoint_id) {
+  MutexLock lock(&peer_key_mutex_);
+  auto it = peer_keys_.find(endpoint_id);
+  return it == peer_keys_.end() ? "" : it->second;
+}
+
+std::optional<analytics::LinkThroughputRecorder::Snapshot>
+EndpointManager::GetLinkThroughput(const std::string& endpoint_id,
+                                   PayloadDirection direction) {
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) {
+    return std::nullopt;
+  }
+  return link_throughput_.GetSnapshot(endpoint_id, channel->GetMedium(),
+                                      direction);
+}
+
+std::optional<EndpointStats> EndpointManager::GetEndpointStats(
+    const std::string& endpoint_id) {
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) {
+    return std::nullopt;
+  }
+  EndpointStats stats;
+  stats.medium = channel->GetMedium();
+  stats.max_transmit_packet_size = channel->GetMaxTransmitPacketSize();
+  stats.chunk_size = GetChunkSize(endpoint_id);
+  std::optional<analytics::LinkThroughputRecorder::Snapshot> sent =
+      link_throughput_.GetSnapshot(endpoint_id, stats.medium,
+                                   PayloadDirection::OUTGOING_PAYLOAD);
+  if (sent.has_value()) {
+    stats.send_bytes_per_second = sent->bytes_per_second;
+    stats.stalled = sent->stalled;
+  }
+  std::optional<analytics::LinkThroughputRecorder::Snapshot> received =
+      link_throughput_.GetSnapshot(endpoint_id, stats.medium,
+                                   PayloadDirection::INCOMING_PAYLOAD);
+  if (received.has_value()) {
+    stats.receive_bytes_per_second = received->bytes_per_second;
+    stats.stalled = stats.stalled || received->stalled;
+  }
+  {
+    MutexLock lock(&rtt_mutex_);
+    auto rtt = rtts_.find(endpoint_id);
+    if (rtt != rtts_.end() && rtt->second.smoothed_rtt.has_value()) {
+      stats.rtt = *rtt->second.smoothed_rtt;
+    }
+  }
+  return stats;
+}
+
 std::vector<std::string> EndpointManager::SendPayloadChunk(
     const PayloadTransferFrame::PayloadHeader& payload_header,
-    const PayloadTransferFrame::PayloadChunk& payload_chunk,
+    PayloadTransferFrame::PayloadChunk payload_chunk,
     const std::vector<std::string>& endpoint_ids,
-    PacketMetaData& packet_meta_data) {
+    PacketMetaData& packet_meta_data, bool high_priority) {
+  std::int64_t offset = payload_chunk.offset();
   ByteArray bytes =
-      parser::ForDataPayloadTransfer(payload_header, payload_chunk);
+      parser::ForDataPayloadTransfer(payload_header, std::move(payload_chunk));
 
   return SendTransferFrameBytes(
-      endpoint_ids, bytes, payload_header.id(),
-      /*offset=*/payload_chunk.offset(),
+      endpoint_ids, bytes, payload_header.id(), offset,
       /*packet_type=*/
       PayloadTransferFrame::PacketType_Name(PayloadTransferFrame::DATA),
-      packet_meta_data);
+      packet_meta_data, high_priority);
+}
+
+std::vector<std::string> EndpointManager::SendBatchedPayloads(
+    std::vector<PayloadTransferFrame::BatchedPayload> batched_payloads,
+    const std::vector<std::string>& endpoint_ids,
+    PacketMetaData& packet_meta_data) {
+  std::int64_t payload_id =
+      batched_payloads.empty() ? 0 : batched_payloads[0].payload_header().id();
+  ByteArray bytes =
+      parser::ForBatchedDataPayloadTransfer(std::move(batched_payloads));
+
+  return SendTransferFrameBytes(
+      endpoint_ids, bytes, payload_id, /*offset=*/0,
+      /*packet_type=*/
+      PayloadTransferFrame::PacketType_Name(PayloadTransferFrame::BATCHED_DATA),
+      packet_meta_data, /*high_priority=*/true);
 }
 
 // Designed to run asynchronously. It is called from IO thread pools, and
@@ -730,7 +1213,7 @@ std::vector<std::string> EndpointManager::SendControlMessage(
       /*offset=*/control.offset(),
       /*packet_type=*/
       PayloadTransferFrame::PacketType_Name(PayloadTransferFrame::CONTROL),
-      packet_meta_data);
+      packet_meta_data, /*high_priority=*/true);
 }
 
 // @EndpointManagerThread
@@ -785,6 +1268,124 @@ void EndpointManager::RemoveEndpoint(ClientProxy* client,
   RemoveEndpointState(endpoint_id);
 }
 
+// @EndpointManagerThread
+void EndpointManager::RemoveEndpoints(
+    ClientProxy* client, const std::vector<std::string>& endpoint_ids,
+    DisconnectionReason reason) {
+  struct Removal {
+    std::string endpoint_id;
+    std::string service_id;
+    bool notify = false;
+    std::shared_ptr<EndpointChannel> channel;
+    SafeDisconnectionResult safe_disconnect_result =
+        ConnectionsLog::EstablishedConnection::SAFE_DISCONNECTION;
+    bool unregistered = false;
+  };
+  std::vector<Removal> removals(endpoint_ids.size());
+  for (size_t i = 0; i < endpoint_ids.size(); i++) {
+    Removal& removal = removals[i];
+    removal.endpoint_id = endpoint_ids[i];
+    removal.notify = client->IsConnectedToEndpoint(removal.endpoint_id);
+    // Grab the service ID before we destroy the channel.
+    removal.channel = channel_manager_->GetChannelForEndpoint(
+        removal.endpoint_id);
+    removal.service_id = removal.channel ? removal.channel->GetServiceId()
+                                         : std::string(kUnknownServiceId);
+  }
+
+  // Each handshake waits up to its own timeout for the remote endpoint, so
+  // they all run at once.
+  CountDownLatch safe_to_disconnect_latch(removals.size());
+  for (Removal& removal : removals) {
+    if (removal.channel == nullptr ||
+        !client->IsSafeToDisconnectEnabled(removal.endpoint_id)) {
+      safe_to_disconnect_latch.CountDown();
+      continue;
+    }
+    teardown_executor_->Execute(
+        "safe-to-disconnect",
+        [this, &removal, reason, &safe_to_disconnect_latch]() {
+          removal.safe_disconnect_result =
+              ApplySafeToDisconnect(removal.endpoint_id, removal.channel.get(),
+                                    reason)
+                  ? ConnectionsLog::EstablishedConnection::SAFE_DISCONNECTION
+                  : ConnectionsLog::EstablishedConnection::
+                        UNSAFE_DISCONNECTION;
+          safe_to_disconnect_latch.CountDown();
+        });
+  }
+  safe_to_disconnect_latch.Await();
+
+  // Closing every channel first lets the reader and keep-alive threads of
+  // all endpoints wind down together.
+  for (Removal& removal : removals) {
+    removal.unregistered = channel_manager_->UnregisterChannelForEndpoint(
+        removal.endpoint_id, reason, removal.safe_disconnect_result);
+  }
+
+  std::vector<CountDownLatch> barriers;
+  for (const Removal& removal : removals) {
+    if (!removal.unregistered) continue;
+    barriers.push_back(NotifyFrameProcessorsOnEndpointDisconnect(
+        client, removal.service_id, removal.endpoint_id, reason));
+  }
+  absl::Time deadline =
+      SystemClock::ElapsedRealtime() + kProcessEndpointDisconnectionTimeout;
+  for (CountDownLatch& barrier : barriers) {
+    absl::Duration remaining = std::max(
+        deadline - SystemClock::ElapsedRealtime(), absl::ZeroDuration());
+    if (!barrier.Await(remaining).result()) {
+      NEARBY_LOGS(INFO) << "Failed to disconnect frame processors from all "
+                           "endpoints in time";
+      break;
+    }
+  }
+
+  for (const Removal& removal : removals) {
+    if (removal.unregistered) {
+      client->OnDisconnected(removal.endpoint_id, removal.notify);
+      NEARBY_LOGS(INFO) << "Removed endpoint for endpoint "
+                        << removal.endpoint_id;
+    }
+    RemoveEndpointState(removal.endpoint_id);
+  }
+}
+
+// @EndpointManagerThread
+bool EndpointManager::ParkEndpoint(ClientProxy* client,
+                                   const std::string& endpoint_id,
+                                   DisconnectionReason reason) {
+  if (!client->IsConnectionPoolEnabled() ||
+      !client->IsConnectedToEndpoint(endpoint_id) ||
+      !endpoints_.contains(endpoint_id)) {
+    return false;
+  }
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+  if (channel == nullptr) return false;
+
+  if (reason == DisconnectionReason::LOCAL_DISCONNECTION) {
+    // A remote endpoint that doesn't park the connection closes the channel,
+    // and the parked connection is then discarded, as the read fails.
+    channel->Resume();
+    Exception write_exception = channel->Write(parser::ForParkConnection());
+    if (!write_exception.Ok()) {
+      NEARBY_LOGS(INFO) << "Failed to park the connection to endpoint "
+                        << endpoint_id;
+      return false;
+    }
+  }
+
+  NEARBY_LOGS(INFO) << "Parking connection to endpoint " << endpoint_id
+                    << ", reason: " << reason;
+  // The frame processors drop the state of the endpoint as if it were
+  // disconnected; e.g. a reverted bandwidth upgrade medium may close the
+  // parked channel too, which discards it.
+  WaitForEndpointDisconnectionProcessing(client, channel->GetServiceId(),
+                                         endpoint_id, reason);
+  return client->ParkConnection(endpoint_id, /*notify=*/true);
+}
+
 bool EndpointManager::ApplySafeToDisconnect(const std::string& endpoint_id,
                                             EndpointChannel* endpoint_channel,
                                             DisconnectionReason reason) {
@@ -882,24 +1483,26 @@ CountDownLatch EndpointManager::NotifyFrameProcessorsOnEndpointDisconnect(
   NEARBY_LOGS(INFO) << "NotifyFrameProcessorsOnEndpointDisconnect: client="
                     << client << "; service_id=" << service_id
                     << "; endpoint_id=" << endpoint_id;
-  MutexLock lock(&frame_processors_lock_);
-  auto total_size = frame_processors_.size();
-  NEARBY_LOGS(INFO) << "Total frame processors: " << total_size;
-  CountDownLatch barrier(total_size);
-
-  int valid = 0;
-  for (auto& item : frame_processors_) {
-    LockedFrameProcessor processor(&item.second);
-    NEARBY_LOGS(INFO) << "processor=" << processor.get()
-                      << "; frame type=" << V1Frame::FrameType_Name(item.first);
-    if (processor) {
-      valid++;
-      processor->OnEndpointDisconnect(client, service_id, endpoint_id, barrier,
-                                      reason);
-    } else {
-      barrier.CountDown();
+  // A processor registered for several frame types is notified once.
+  absl::flat_hash_set<FrameProcessor*> notified;
+  std::vector<LockedFrameProcessor> processors;
+  for (size_t frame_type = 0; frame_type < frame_processors_.size();
+       frame_type++) {
+    LockedFrameProcessor processor(this, &frame_processors_[frame_type]);
+    if (processor && notified.insert(processor.get()).second) {
+      NEARBY_LOGS(INFO) << "processor=" << processor.get() << "; frame type="
+                        << V1Frame::FrameType_Name(
+                               static_cast<V1Frame::FrameType>(frame_type));
+      processors.push_back(std::move(processor));
     }
   }
+  int valid = processors.size();
+  NEARBY_LOGS(INFO) << "Total frame processors: " << valid;
+  CountDownLatch barrier(valid);
+  for (LockedFrameProcessor& processor : processors) {
+    processor->OnEndpointDisconnect(client, service_id, endpoint_id, barrier,
+                                    reason);
+  }
 
   if (!valid) {
     NEARBY_LOGS(INFO) << "No valid frame processors.";
@@ -919,46 +1522,115 @@ std::vector<std::string> EndpointManager::SendPayloadAck(
       /* offset= */ -1,
       /*packet_type=*/
       PayloadTransferFrame::PacketType_Name(PayloadTransferFrame::PAYLOAD_ACK),
-      packet_meta_data);
+      packet_meta_data, /*high_priority=*/true);
 }
 
 std::vector<std::string> EndpointManager::SendTransferFrameBytes(
     const std::vector<std::string>& endpoint_ids, const ByteArray& bytes,
     std::int64_t payload_id, std::int64_t offset,
-    const std::string& packet_type, PacketMetaData& packet_meta_data) {
+    const std::string& packet_type, PacketMetaData& packet_meta_data,
+    bool high_priority) {
   std::vector<std::string> failed_endpoint_ids;
-  for (const std::string& endpoint_id : endpoint_ids) {
-    std::shared_ptr<EndpointChannel> channel =
-        channel_manager_->GetChannelForEndpoint(endpoint_id);
-
-    if (channel == nullptr) {
-      // We no longer know about this endpoint (it was either explicitly
-      // unregistered, or a read/write error made us unregister it
-      // internally).
-      NEARBY_LOGS(ERROR) << "EndpointManager failed to find EndpointChannel "
-                            "over which to write "
-                         << packet_type << " at offset " << offset
-                         << " of Payload " << payload_id << " to endpoint "
-                         << endpoint_id;
-
-      failed_endpoint_ids.push_back(endpoint_id);
-      continue;
+  if (fan_out_executor_ == nullptr || endpoint_ids.size() < 2) {
+    for (const std::string& endpoint_id : endpoint_ids) {
+      if (!WriteTransferFrameBytes(endpoint_id, bytes, payload_id, offset,
+                                   packet_type, packet_meta_data,
+                                   high_priority)) {
+        failed_endpoint_ids.push_back(endpoint_id);
+      }
     }
+    return failed_endpoint_ids;
+  }
 
-    Exception write_exception = channel->Write(bytes, packet_meta_data);
-    if (!write_exception.Ok()) {
-      failed_endpoint_ids.push_back(endpoint_id);
-      NEARBY_LOGS(INFO) << "Failed to send packet; endpoint_id=" << endpoint_id;
-      continue;
-    }
-    analytics::ThroughputRecorderContainer::GetInstance()
-        .GetTPRecorder(payload_id, PayloadDirection::OUTGOING_PAYLOAD)
-        ->OnFrameSent(channel->GetMedium(), packet_meta_data);
+  // Each channel encrypts the frame with its own session key, so only the
+  // serialized frame can be shared. Write it to all endpoints at once, so
+  // sending takes as long as the slowest channel rather than the sum of all
+  // of them. Every write gets its own copy of the timings.
+  std::vector<PacketMetaData> meta_data(endpoint_ids.size(), packet_meta_data);
+  std::vector<std::uint8_t> succeeded(endpoint_ids.size(), 0);
+  // The latch is counted down when a task is destroyed, so a task dropped by
+  // an executor that is shutting down counts as a failed write instead of
+  // blocking the caller forever.
+  CountDownLatch latch(endpoint_ids.size() - 1);
+  for (size_t i = 1; i < endpoint_ids.size(); i++) {
+    fan_out_executor_->Execute(
+        "fan-out-write",
+        [this, &endpoint_ids, &bytes, payload_id, offset, &packet_type,
+         &meta_data, &succeeded, high_priority, i,
+         count_down = absl::MakeCleanup([&latch]() { latch.CountDown(); })]() {
+          succeeded[i] = WriteTransferFrameBytes(
+              endpoint_ids[i], bytes, payload_id, offset, packet_type,
+              meta_data[i], high_priority);
+        });
   }
+  // The calling thread takes the first endpoint itself.
+  succeeded[0] =
+      WriteTransferFrameBytes(endpoint_ids[0], bytes, payload_id, offset,
+                              packet_type, meta_data[0], high_priority);
+  latch.Await();
 
+  packet_meta_data = meta_data[0];
+  for (size_t i = 0; i < endpoint_ids.size(); i++) {
+    if (!succeeded[i]) failed_endpoint_ids.push_back(endpoint_ids[i]);
+  }
   return failed_endpoint_ids;
 }
 
+bool EndpointManager::WriteTransferFrameBytes(
+    const std::string& endpoint_id, const ByteArray& bytes,
+    std::int64_t payload_id, std::int64_t offset,
+    const std::string& packet_type, PacketMetaData& packet_meta_data,
+    bool high_priority) {
+  std::shared_ptr<EndpointChannel> channel =
+      channel_manager_->GetChannelForEndpoint(endpoint_id);
+
+  if (channel == nullptr) {
+    // We no longer know about this endpoint (it was either explicitly
+    // unregistered, or a read/write error made us unregister it
+    // internally).
+    NEARBY_LOGS(ERROR) << "EndpointManager failed to find EndpointChannel "
+                          "over which to write "
+                       << packet_type << " at offset " << offset
+                       << " of Payload " << payload_id << " to endpoint "
+                       << endpoint_id;
+    return false;
+  }
+
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.payload", packet_type,
+                               TraceFlowIdForPayload(payload_id));
+  if (high_priority) {
+    write_priority_gate_.BeginHighPriorityWrite(endpoint_id);
+  } else {
+    write_priority_gate_.WaitForLowPriorityTurn(endpoint_id);
+  }
+  std::shared_ptr<analytics::LinkThroughputRecorder> link_throughput =
+      link_throughput_.GetRecorder(endpoint_id, channel->GetMedium(),
+                                   PayloadDirection::OUTGOING_PAYLOAD);
+  absl::Time start_time = SystemClock::ElapsedRealtime();
+  link_throughput->OnFrameStarted(start_time);
+  Exception write_exception = channel->Write(bytes, packet_meta_data);
+  if (high_priority) {
+    write_priority_gate_.EndHighPriorityWrite(endpoint_id);
+  }
+  if (!write_exception.Ok()) {
+    NEARBY_LOGS(INFO) << "Failed to send packet; endpoint_id=" << endpoint_id;
+    return false;
+  }
+  link_throughput->OnFrame(bytes.size(),
+                           SystemClock::ElapsedRealtime() - start_time, false);
+  analytics::ThroughputRecorder* throughput_recorder =
+      analytics::ThroughputRecorderContainer::GetInstance().GetTPRecorder(
+          payload_id, PayloadDirection::OUTGOING_PAYLOAD);
+  throughput_recorder->OnFrameSent(channel->GetMedium(), packet_meta_data);
+  if (chunk_size_controller_ &&
+      packet_type ==
+          PayloadTransferFrame::PacketType_Name(PayloadTransferFrame::DATA)) {
+    throughput_recorder->OnChunkSizeChanged(chunk_size_controller_->OnFrameSent(
+        endpoint_id, channel->GetMaxTransmitPacketSize(), packet_meta_data));
+  }
+  return true;
+}
+
 EndpointManager::EndpointState::~EndpointState() {
   // We must unregister the endpoint first to signal the runnables that they
   // should exit their loops. SingleThreadExecutor destructors will wait for
@@ -972,6 +1644,12 @@ EndpointManager::EndpointState::~EndpointState() {
         ConnectionsLog::EstablishedConnection::SAFE_DISCONNECTION);
   }
 
+  // In shared keep-alive mode, cancel the next step (and wait for a running
+  // one) so it cannot touch this endpoint anymore.
+  if (keep_alive_task_) {
+    keep_alive_task_->Stop();
+  }
+
   // Make sure the KeepAlive thread isn't blocking shutdown.
   if (keep_alive_waiter_mutex_ && keep_alive_waiter_) {
     MutexLock lock(keep_alive_waiter_mutex_.get());
@@ -993,6 +1671,13 @@ void EndpointManager::EndpointState::StartEndpointKeepAliveManager(
       });
 }
 
+void EndpointManager::EndpointState::StartSharedKeepAliveManager(
+    TimerWheel* timer_wheel, SingleThreadExecutor* executor,
+    KeepAliveTask::Step step, absl::AnyInvocable<void()> on_done) {
+  keep_alive_task_ = KeepAliveTask::Start(timer_wheel, executor,
+                                          std::move(step), std::move(on_done));
+}
+
 void EndpointManager::RunOnEndpointManagerThread(const std::string& name,
                                                  Runnable runnable) {
   serial_executor_->Execute(name, std::move(runnable));
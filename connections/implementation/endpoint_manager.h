@@ -15,9 +15,12 @@
 #ifndef CORE_INTERNAL_ENDPOINT_MANAGER_H_
 #define CORE_INTERNAL_ENDPOINT_MANAGER_H_
 
+#include <array>
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,17 +30,29 @@
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/time/time.h"
+#include "connections/endpoint_stats.h"
+#include "connections/implementation/analytics/link_throughput_recorder.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
+#include "connections/implementation/chunk_size_controller.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/endpoint_channel_manager.h"
+#include "connections/implementation/keep_alive_task.h"
+#include "connections/implementation/medium_throughput_history.h"
+#include "connections/implementation/peer_medium_cache.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
+#include "connections/implementation/write_priority_gate.h"
 #include "connections/listeners.h"
+#include "connections/payload_type.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/condition_variable.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/implementation/preferences_manager.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_wheel.h"
 
 namespace nearby {
 namespace connections {
@@ -59,6 +74,10 @@ namespace connections {
 // chunks) originates on one of those threads before control is transferred over
 // to PayloadManager::ProcessFrame() (still running on that
 // same dedicated reader thread).
+//
+// Keep-alives run either on one dedicated thread per endpoint, or, when
+// FeatureFlags::enable_shared_endpoint_keep_alive is set, as KeepAliveTasks
+// driven by one TimerWheel and one executor shared by all endpoints.
 
 class EndpointManager {
  public:
@@ -119,21 +138,85 @@ class EndpointManager {
                         const std::string& connection_token);
   // Called when a client explicitly asks to disconnect from this endpoint. In
   // this case, we do not notify the client of onDisconnected().
+  // If the client's connection pool is enabled, the connection is parked
+  // instead, see ClientProxy::ParkConnection().
   void UnregisterEndpoint(ClientProxy* client, const std::string& endpoint_id);
+  // Like UnregisterEndpoint() for each of |endpoint_ids|. With parallel
+  // teardown enabled, the endpoints are disconnected all at once, which takes
+  // about as long as disconnecting the slowest of them.
+  void UnregisterEndpoints(ClientProxy* client,
+                           const std::vector<std::string>& endpoint_ids);
+  // Lets the client know of a connection resumed over the channel it was
+  // parked with, like RegisterEndpoint() does for a new one. Returns false if
+  // the endpoint isn't registered anymore.
+  // Blocks until the client is notified.
+  bool ResumeEndpoint(ClientProxy* client, const std::string& endpoint_id,
+                      const ConnectionResponseInfo& info,
+                      const ConnectionOptions& connection_options,
+                      const ConnectionListener& listener,
+                      const std::string& connection_token);
 
   // Returns the maximum supported transmit packet size(MTU) for the underlying
   // transport.
   int GetMaxTransmitPacketSize(const std::string& endpoint_id);
 
+  // Returns the size of the next payload chunk to send to the endpoint. This
+  // is the MTU, unless adaptive chunk sizing picked a smaller size from the
+  // timings of the previous chunks.
+  int GetChunkSize(const std::string& endpoint_id);
+
+  // Asks the current channel of the endpoint for link settings suited to
+  // bulk transfer, until the matching ReleaseHighThroughput().
+  void RequestHighThroughput(const std::string& endpoint_id);
+  void ReleaseHighThroughput(const std::string& endpoint_id);
+
+  // Returns live statistics of the frames sent to, or received from, the
+  // endpoint over its current channel, or nothing if it has no channel or no
+  // frames went that way over it yet.
+  std::optional<analytics::LinkThroughputRecorder::Snapshot> GetLinkThroughput(
+      const std::string& endpoint_id, PayloadDirection direction);
+
+  // Returns the throughput each medium reached with the endpoints that
+  // disconnected.
+  const MediumThroughputHistory& GetMediumThroughputHistory() const {
+    return medium_throughput_history_;
+  }
+
+  // Returns how the mediums fared with the remote devices connected in
+  // earlier sessions, or null if feature flag enable_peer_medium_cache is
+  // disabled.
+  PeerMediumCache* GetPeerMediumCache() { return peer_medium_cache_.get(); }
+
+  // Returns the PeerMediumCache key of a registered endpoint, or an empty
+  // string if it has none.
+  std::string GetPeerKey(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(peer_key_mutex_);
+
+  // Returns the live state of the endpoint's connection, or nothing if it has
+  // no channel. The send queue is left for PayloadManager to fill in.
+  std::optional<EndpointStats> GetEndpointStats(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(rtt_mutex_);
+
   // Returns the list of endpoints to which sending this chunk failed.
+  // |payload_chunk| is consumed; its body is moved into the outgoing frame.
+  // Chunks of high priority payloads are written ahead of the chunks of low
+  // priority payloads waiting for the same endpoint.
   //
   // Invoked from the PayloadManager's sendPayload() method.
   std::vector<std::string> SendPayloadChunk(
       const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
           payload_header,
-      const location::nearby::connections::PayloadTransferFrame::PayloadChunk&
+      location::nearby::connections::PayloadTransferFrame::PayloadChunk
           payload_chunk,
       const std::vector<std::string>& endpoint_ids,
+      analytics::PacketMetaData& packet_meta_data, bool high_priority = false);
+  // Sends complete BYTES payloads in one BATCHED_DATA frame, with high
+  // priority. Returns the list of endpoints to which sending it failed.
+  std::vector<std::string> SendBatchedPayloads(
+      std::vector<
+          location::nearby::connections::PayloadTransferFrame::BatchedPayload>
+          batched_payloads,
+      const std::vector<std::string>& endpoint_ids,
       analytics::PacketMetaData& packet_meta_data);
   std::vector<std::string> SendControlMessage(
       const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
@@ -167,6 +250,17 @@ class EndpointManager {
                   std::unique_ptr<SingleThreadExecutor> serial_executor);
 
  private:
+  // Link throughput is averaged over this long, and a frame that took, or a
+  // payload chunk that is overdue by, more than the stall timeout is a stall.
+  static constexpr absl::Duration kLinkThroughputWindow = absl::Seconds(2);
+  static constexpr absl::Duration kLinkThroughputStallTimeout =
+      absl::Seconds(3);
+  // Weight of the latest sample in the smoothed round trip time, as in TCP.
+  static constexpr double kRttSmoothing = 0.125;
+  // How long a low priority frame holds back for high priority ones, at most.
+  static constexpr absl::Duration kMaxLowPriorityWriteDelay =
+      absl::Milliseconds(100);
+
   class EndpointState {
    public:
     EndpointState(const std::string& endpoint_id,
@@ -188,7 +282,8 @@ class EndpointManager {
           keep_alive_waiter_mutex_{
               std::exchange(other.keep_alive_waiter_mutex_, nullptr)},
           keep_alive_waiter_{std::exchange(other.keep_alive_waiter_, nullptr)},
-          keep_alive_thread_{std::move(other.keep_alive_thread_)} {}
+          keep_alive_thread_{std::move(other.keep_alive_thread_)},
+          keep_alive_task_{std::move(other.keep_alive_task_)} {}
     EndpointState& operator=(const EndpointState&) = delete;
     EndpointState&& operator=(EndpointState&&) = delete;
     ~EndpointState();
@@ -196,6 +291,12 @@ class EndpointManager {
     void StartEndpointReader(Runnable&& runnable);
     void StartEndpointKeepAliveManager(
         absl::AnyInvocable<void(Mutex*, ConditionVariable*)> runnable);
+    // Runs keep-alive steps on |executor|, with deadlines tracked by
+    // |timer_wheel|, instead of on |keep_alive_thread_|.
+    void StartSharedKeepAliveManager(TimerWheel* timer_wheel,
+                                     SingleThreadExecutor* executor,
+                                     KeepAliveTask::Step step,
+                                     absl::AnyInvocable<void()> on_done);
 
    private:
     const std::string endpoint_id_;
@@ -210,36 +311,91 @@ class EndpointManager {
     mutable std::unique_ptr<Mutex> keep_alive_waiter_mutex_;
     std::unique_ptr<ConditionVariable> keep_alive_waiter_;
     SingleThreadExecutor keep_alive_thread_;
+    // Only set in shared keep-alive mode.
+    std::shared_ptr<KeepAliveTask> keep_alive_task_;
+  };
+
+  // Keep-alive frames carry a sequence number, which the remote endpoint
+  // echoes back in an ack; the time in between is a round trip. Only the
+  // latest probe is tracked.
+  struct RttState {
+    std::uint32_t probe_seq_num = 0;
+    // When the latest probe was sent, or InfinitePast() once it was acked.
+    absl::Time probe_sent_at = absl::InfinitePast();
+    std::optional<absl::Duration> smoothed_rtt;
+  };
+
+  // The keep-alive writes to one endpoint in shared keep-alive mode, which
+  // run on |keep_alive_write_executor_| instead of the keep-alive thread.
+  struct KeepAliveWriteState {
+    // Whether a keep-alive frame is being written to the endpoint.
+    std::atomic<bool> in_flight{false};
+    // The medium of the channel the latest keep-alive frame failed to be
+    // written to, until the next keep-alive step handles the failure.
+    std::atomic<location::nearby::proto::connections::Medium> failed_medium{
+        location::nearby::proto::connections::Medium::UNKNOWN_MEDIUM};
   };
 
   // RAII accessor for FrameProcessor
   class LockedFrameProcessor;
 
-  // Provides a mutex per FrameProcessor to prevent unregistering (and
-  // destroying) a FrameProcessor when it's in use.
-  class FrameProcessorWithMutex {
-   public:
-    explicit FrameProcessorWithMutex(FrameProcessor* frame_processor = nullptr)
-        : frame_processor_{frame_processor} {}
-
-   private:
-    FrameProcessor* frame_processor_;
-    Mutex mutex_;
-    friend class LockedFrameProcessor;
+  // The FrameProcessor registered for one frame type. Frames are dispatched
+  // without taking a lock: a dispatch counts itself in |users| while it uses
+  // the processor, and replacing or unregistering the processor waits for
+  // |users| to drop to zero, so that the old processor can be destroyed.
+  struct FrameProcessorSlot {
+    std::atomic<FrameProcessor*> processor{nullptr};
+    std::atomic<int> users{0};
+    // Registration changes waiting for |users| to drop to zero.
+    std::atomic<int> waiters{0};
   };
 
   LockedFrameProcessor GetFrameProcessor(
       location::nearby::connections::V1Frame::FrameType frame_type);
+  // Returns the slot of |frame_type|, or nullptr for an unknown frame type.
+  FrameProcessorSlot* GetFrameProcessorSlot(
+      location::nearby::connections::V1Frame::FrameType frame_type);
+  // Waits until no dispatch uses the processor that was just removed from
+  // |slot|.
+  void WaitForFrameDispatches(FrameProcessorSlot& slot)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(frame_processors_mutex_);
 
   ExceptionOr<bool> HandleData(const std::string& endpoint_id,
                                ClientProxy* client_proxy,
                                EndpointChannel* endpoint_channel);
 
-  ExceptionOr<bool> HandleKeepAlive(EndpointChannel* endpoint_channel,
+  ExceptionOr<bool> HandleKeepAlive(const std::string& endpoint_id,
+                                    EndpointChannel* endpoint_channel,
                                     absl::Duration keep_alive_interval,
                                     absl::Duration keep_alive_timeout,
                                     Mutex* keep_alive_waiter_mutex,
                                     ConditionVariable* keep_alive_waiter);
+  // Sends a KeepAlive frame if one is due, through |write| if set, or straight
+  // to |endpoint_channel| otherwise. Returns the time until the next check is
+  // needed, or a non-positive duration if the endpoint has not been heard from
+  // within |keep_alive_timeout|.
+  ExceptionOr<absl::Duration> CheckKeepAlive(
+      const std::string& endpoint_id, EndpointChannel* endpoint_channel,
+      absl::Duration keep_alive_interval, absl::Duration keep_alive_timeout,
+      absl::AnyInvocable<Exception(ByteArray)> write = nullptr);
+  // Returns the sequence number of a new keep-alive probe to |endpoint_id|.
+  std::uint32_t StartRttProbe(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(rtt_mutex_);
+  // Updates the round trip time of |endpoint_id| if |seq_num| acks its latest
+  // probe.
+  void OnKeepAliveAck(const std::string& endpoint_id, std::uint32_t seq_num)
+      ABSL_LOCKS_EXCLUDED(rtt_mutex_);
+  // One iteration of the keep-alive loop in shared keep-alive mode; mirrors
+  // EndpointChannelLoopRunnable() around CheckKeepAlive(). Returns the delay
+  // until the next step, or std::nullopt once the endpoint must be discarded.
+  // Keep-alive frames are written on |keep_alive_write_executor_|, so a
+  // stalled channel doesn't hold back the steps of the other endpoints; one
+  // isn't sent while the previous one is still being written.
+  std::optional<absl::Duration> RunSharedKeepAliveStep(
+      ClientProxy* client, const std::string& endpoint_id,
+      absl::Duration keep_alive_interval, absl::Duration keep_alive_timeout,
+      location::nearby::proto::connections::Medium& last_failed_medium,
+      std::shared_ptr<KeepAliveWriteState> write_state);
 
   // Waits for a given endpoint EndpointChannelLoopRunnable() workers to
   // terminate.
@@ -266,6 +422,21 @@ class EndpointManager {
   // @EndpointManagerThread
   void RemoveEndpoint(ClientProxy* client, const std::string& endpoint_id,
                       bool notify, DisconnectionReason reason);
+  // Parks the connection to the endpoint with the client, keeping its channel
+  // and workers running. A local disconnection asks the remote endpoint to
+  // park it as well. Returns false if the connection couldn't be parked, and
+  // must be removed instead.
+  // @EndpointManagerThread
+  bool ParkEndpoint(ClientProxy* client, const std::string& endpoint_id,
+                    DisconnectionReason reason);
+  // Removes several endpoints like RemoveEndpoint() does, but each step is
+  // taken for all of them before the next one: the safe-to-disconnect
+  // handshakes run in parallel, all channels are closed, and the frame
+  // processors are waited for up to a single deadline.
+  // @EndpointManagerThread
+  void RemoveEndpoints(ClientProxy* client,
+                       const std::vector<std::string>& endpoint_ids,
+                       DisconnectionReason reason);
   bool ApplySafeToDisconnect(const std::string& endpoint_id,
                              EndpointChannel* endpoint_channel,
                              DisconnectionReason reason);
@@ -281,11 +452,21 @@ class EndpointManager {
       ClientProxy* client, const std::string& service_id,
       const std::string& endpoint_id, DisconnectionReason reason);
 
+  // Control frames and payload acks are always written with high priority.
   std::vector<std::string> SendTransferFrameBytes(
       const std::vector<std::string>& endpoint_ids,
       const ByteArray& payload_transfer_frame_bytes, std::int64_t payload_id,
       std::int64_t offset, const std::string& packet_type,
-      analytics::PacketMetaData& packet_meta_data);
+      analytics::PacketMetaData& packet_meta_data, bool high_priority);
+  // Writes the frame to a single endpoint and records its throughput. Low
+  // priority frames first let the endpoint's pending high priority frames go.
+  // Returns false if the endpoint is gone or the write failed.
+  bool WriteTransferFrameBytes(const std::string& endpoint_id,
+                               const ByteArray& payload_transfer_frame_bytes,
+                               std::int64_t payload_id, std::int64_t offset,
+                               const std::string& packet_type,
+                               analytics::PacketMetaData& packet_meta_data,
+                               bool high_priority);
 
   // Executes all jobs sequentially, on a serial_executor_.
   void RunOnEndpointManagerThread(const std::string& name, Runnable runnable);
@@ -294,10 +475,57 @@ class EndpointManager {
                                             EndpointChannel* endpoint_channel);
   EndpointChannelManager* channel_manager_;
 
-  RecursiveMutex frame_processors_lock_;
-  absl::flat_hash_map<location::nearby::connections::V1Frame::FrameType,
-                      FrameProcessorWithMutex>
-      frame_processors_ ABSL_GUARDED_BY(frame_processors_lock_);
+  // Indexed by frame type. Only registration changes take
+  // |frame_processors_mutex_|, which they also use to wait for dispatches.
+  std::array<FrameProcessorSlot,
+             location::nearby::connections::V1Frame::FrameType_ARRAYSIZE>
+      frame_processors_;
+  Mutex frame_processors_mutex_{"EndpointManager::frame_processors_mutex_"};
+  ConditionVariable frame_processors_released_{&frame_processors_mutex_};
+
+  // Drive keep-alives of all endpoints in shared keep-alive mode; null
+  // otherwise. Declared before |endpoints_| so they outlive their tasks.
+  std::unique_ptr<TimerWheel> keep_alive_timer_wheel_;
+  std::unique_ptr<SingleThreadExecutor> keep_alive_executor_;
+  // Writes the keep-alive frames in shared keep-alive mode; null otherwise.
+  std::unique_ptr<MultiThreadExecutor> keep_alive_write_executor_;
+  // Whether keep-alives are held back while frames are read from the
+  // endpoint.
+  bool suppress_keep_alive_while_reading_ = false;
+
+  // Writes a frame to several endpoints in parallel; null if fan-out writes
+  // are disabled.
+  std::unique_ptr<MultiThreadExecutor> fan_out_executor_;
+
+  // Runs the safe-to-disconnect handshakes of endpoints disconnected
+  // together; null if parallel teardown is disabled.
+  std::unique_ptr<MultiThreadExecutor> teardown_executor_;
+
+  // Sizes outgoing chunks per endpoint; null if adaptive chunk sizing is
+  // disabled.
+  std::unique_ptr<ChunkSizeController> chunk_size_controller_;
+
+  // Throughput, chunk latency and stalls of every endpoint's channels.
+  analytics::LinkThroughputRegistry link_throughput_{
+      kLinkThroughputWindow, kLinkThroughputStallTimeout};
+
+  // Throughput of the mediums of the endpoints that disconnected, sampled
+  // from |link_throughput_| before their recorders are dropped.
+  MediumThroughputHistory medium_throughput_history_;
+
+  // Null if feature flag enable_peer_medium_cache is disabled.
+  std::unique_ptr<api::PreferencesManager> peer_preferences_manager_;
+  std::unique_ptr<PeerMediumCache> peer_medium_cache_;
+  Mutex peer_key_mutex_;
+  // The PeerMediumCache keys of the registered endpoints.
+  absl::flat_hash_map<std::string, std::string> peer_keys_
+      ABSL_GUARDED_BY(peer_key_mutex_);
+
+  // Orders the frames written to each endpoint by priority.
+  WritePriorityGate write_priority_gate_{kMaxLowPriorityWriteDelay};
+
+  Mutex rtt_mutex_;
+  absl::flat_hash_map<std::string, RttState> rtts_ ABSL_GUARDED_BY(rtt_mutex_);
 
   // We keep track of all registered channel endpoints here.
   absl::flat_hash_map<std::string, EndpointState> endpoints_;
@@ -311,7 +539,7 @@ class EndpointManager {
   // pending tasks during it's destruction, and the "discard-endpoints"
   // task checks `is_shutdown_` to prevent accessing an invalid `ClientProxy`
   // pointer.
-  mutable RecursiveMutex mutex_;
+  mutable RecursiveMutex mutex_{"EndpointManager::mutex_"};
   bool is_shutdown_ ABSL_GUARDED_BY(mutex_) = false;
 
   std::unique_ptr<SingleThreadExecutor> serial_executor_;
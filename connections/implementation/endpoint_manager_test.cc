@@ -17,6 +17,7 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,17 +30,20 @@
 #include "absl/time/time.h"
 #include "connections/connection_options.h"
 #include "connections/implementation/analytics/analytics_recorder.h"
+#include "connections/implementation/analytics/link_throughput_recorder.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/endpoint_channel_manager.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/implementation/offline_frames.h"
 #include "connections/listeners.h"
+#include "connections/payload_type.h"
 #include "connections/status.h"
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/single_thread_executor.h"
 #include "internal/test/fake_single_thread_executor.h"
@@ -56,6 +60,7 @@ using ::location::nearby::proto::connections::DisconnectionReason;
 using ::location::nearby::proto::connections::Medium;
 using ::testing::_;
 using ::testing::Eq;
+using ::testing::InvokeWithoutArgs;
 using ::testing::MockFunction;
 using ::testing::Return;
 using ::testing::StrictMock;
@@ -316,6 +321,57 @@ TEST_F(EndpointManagerTest, UnregisterFrameProcessorWorks) {
   em_.UnregisterEndpoint(client_.get(), endpoint_id_);
 }
 
+TEST_F(EndpointManagerTest, UnregisterFrameProcessorWaitsForDispatch) {
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  auto connect_request = std::make_unique<MockFrameProcessor>();
+  ByteArray endpoint_info{"endpoint_name"};
+  ConnectionInfo connection_info{
+      "endpoint_id",
+      endpoint_info,
+      1234 /*nonce*/,
+      false /*supports_5_ghz*/,
+      "" /*bssid*/,
+      2412 /*ap_frequency*/,
+      "8xqT" /*ip_address in 4 bytes format*/,
+      std::vector<Medium>{Medium::BLE} /*supported_mediums*/,
+      0 /*keep_alive_interval_millis*/,
+      0 /*keep_alive_timeout_millis*/};
+  CountDownLatch dispatching(1);
+  CountDownLatch release(1);
+  CountDownLatch unregistered(1);
+
+  auto read_data = parser::ForConnectionRequestConnections({}, connection_info);
+  EXPECT_CALL(*connect_request, OnIncomingFrame)
+      .WillOnce(InvokeWithoutArgs([&dispatching, &release]() {
+        dispatching.CountDown();
+        EXPECT_TRUE(release.Await(absl::Seconds(5)).result());
+      }));
+  EXPECT_CALL(*connect_request, OnEndpointDisconnect).Times(0);
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillOnce(Return(ExceptionOr<ByteArray>(read_data)))
+      .WillRepeatedly(Return(ExceptionOr<ByteArray>(Exception::kIo)));
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+  em_.RegisterFrameProcessor(V1Frame::CONNECTION_REQUEST,
+                             connect_request.get());
+  RegisterEndpoint(std::move(endpoint_channel), false);
+  ASSERT_TRUE(dispatching.Await(absl::Seconds(5)).result());
+
+  // The processor is in use, so unregistering it has to wait.
+  SingleThreadExecutor executor;
+  executor.Execute([this, &connect_request, &unregistered]() {
+    em_.UnregisterFrameProcessor(V1Frame::CONNECTION_REQUEST,
+                                 connect_request.get());
+    unregistered.CountDown();
+  });
+  EXPECT_FALSE(unregistered.Await(absl::Milliseconds(100)).result());
+  release.CountDown();
+  EXPECT_TRUE(unregistered.Await(absl::Seconds(5)).result());
+
+  processors_.emplace_back(std::move(connect_request));
+  em_.UnregisterEndpoint(client_.get(), endpoint_id_);
+}
+
 TEST_F(EndpointManagerTest, SendControlMessageAndPayloadAckWorks) {
   auto endpoint_channel = std::make_unique<MockEndpointChannel>();
   PayloadTransferFrame::PayloadHeader header;
@@ -356,6 +412,93 @@ TEST_F(EndpointManagerTest, SendControlMessageAndPayloadAckWorks) {
   NEARBY_LOGS(INFO) << "Will call destructors now";
 }
 
+TEST_F(EndpointManagerTest, SentFramesShowUpInLinkThroughput) {
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  ON_CALL(*endpoint_channel, Read(_))
+      .WillByDefault([channel = endpoint_channel.get()]() {
+        while (!channel->IsClosed()) absl::SleepFor(absl::Milliseconds(10));
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  ON_CALL(*endpoint_channel, Close(_))
+      .WillByDefault([channel = endpoint_channel.get()](
+                         DisconnectionReason reason) { channel->DoClose(); });
+  EXPECT_CALL(*endpoint_channel, Write(_, _))
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+  EXPECT_FALSE(em_.GetLinkThroughput(endpoint_id_,
+                                     PayloadDirection::OUTGOING_PAYLOAD)
+                   .has_value());
+
+  RegisterEndpoint(std::move(endpoint_channel), false);
+  EXPECT_EQ(em_.SendPayloadAck(12345, {endpoint_id_}),
+            std::vector<std::string>{});
+  EXPECT_EQ(em_.SendPayloadAck(12345, {endpoint_id_}),
+            std::vector<std::string>{});
+
+  std::optional<analytics::LinkThroughputRecorder::Snapshot> snapshot =
+      em_.GetLinkThroughput(endpoint_id_, PayloadDirection::OUTGOING_PAYLOAD);
+  ASSERT_TRUE(snapshot.has_value());
+  EXPECT_EQ(snapshot->frames, 2);
+  EXPECT_GT(snapshot->bytes, 0);
+  EXPECT_FALSE(snapshot->stalled);
+  em_.UnregisterEndpoint(client_.get(), endpoint_id_);
+}
+
+TEST_F(EndpointManagerTest, ReportsEndpointStats) {
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  ON_CALL(*endpoint_channel, Read(_))
+      .WillByDefault([channel = endpoint_channel.get()]() {
+        while (!channel->IsClosed()) absl::SleepFor(absl::Milliseconds(10));
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  ON_CALL(*endpoint_channel, Close(_))
+      .WillByDefault([channel = endpoint_channel.get()](
+                         DisconnectionReason reason) { channel->DoClose(); });
+  EXPECT_CALL(*endpoint_channel, Write(_, _))
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+  EXPECT_CALL(*endpoint_channel, GetMaxTransmitPacketSize())
+      .WillRepeatedly(Return(1024));
+  EXPECT_FALSE(em_.GetEndpointStats(endpoint_id_).has_value());
+
+  RegisterEndpoint(std::move(endpoint_channel), false);
+  EXPECT_EQ(em_.SendPayloadAck(12345, {endpoint_id_}),
+            std::vector<std::string>{});
+
+  std::optional<EndpointStats> stats = em_.GetEndpointStats(endpoint_id_);
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->medium, Medium::BLE);
+  EXPECT_EQ(stats->max_transmit_packet_size, 1024);
+  EXPECT_GT(stats->chunk_size, 0);
+  EXPECT_LE(stats->chunk_size, 1024);
+  EXPECT_GT(stats->send_bytes_per_second, 0);
+  EXPECT_EQ(stats->receive_bytes_per_second, 0);
+  // No keep-alive probe was acked yet.
+  EXPECT_EQ(stats->rtt, absl::InfiniteDuration());
+  EXPECT_FALSE(stats->stalled);
+  em_.UnregisterEndpoint(client_.get(), endpoint_id_);
+}
+
+TEST_F(EndpointManagerTest, AcksKeepAliveProbe) {
+  CountDownLatch acked(1);
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillOnce(Return(ExceptionOr<ByteArray>(
+          parser::ForKeepAlive(/*ack=*/false, /*seq_num=*/7))))
+      .WillRepeatedly([&acked](PacketMetaData& packet_meta_data) {
+        acked.Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+  EXPECT_CALL(*endpoint_channel,
+              Write(Eq(parser::ForKeepAlive(/*ack=*/true, /*seq_num=*/7))))
+      .WillOnce([&acked](const ByteArray& data) {
+        acked.CountDown();
+        return Exception{Exception::kSuccess};
+      });
+
+  RegisterEndpoint(std::move(endpoint_channel));
+}
+
 TEST_F(EndpointManagerTest, SingleReadOnReadError) {
   auto endpoint_channel = std::make_unique<MockEndpointChannel>();
   EXPECT_CALL(*endpoint_channel, Read(_))
@@ -507,6 +650,251 @@ TEST_F(EndpointManagerTest, DisconnectEndpointDuringDestruction) {
   endpoint_manager.reset();
 }
 
+TEST_F(EndpointManagerTest, SharedKeepAliveDiscardsSilentEndpoint) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_shared_endpoint_keep_alive =
+      true;
+  EndpointManager endpoint_manager(&ecm_);
+  FeatureFlags::GetMutableFlagsForTesting().enable_shared_endpoint_keep_alive =
+      false;
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  CountDownLatch closed(1);
+  // Keep the reader blocked, so the endpoint can only be discarded by the
+  // keep-alive timeout.
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillRepeatedly([&closed](PacketMetaData& packet_meta_data) {
+        closed.Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly(Return(Exception{Exception::kSuccess}));
+  EXPECT_CALL(*endpoint_channel, Close(_))
+      .WillRepeatedly(
+          [&closed](DisconnectionReason reason) { closed.CountDown(); });
+  EXPECT_CALL(*endpoint_channel, GetMedium())
+      .WillRepeatedly(Return(Medium::BLE));
+  EXPECT_CALL(*endpoint_channel, GetLastReadTimestamp())
+      .WillRepeatedly(Return(start_time_));
+  EXPECT_CALL(*endpoint_channel, GetLastWriteTimestamp())
+      .WillRepeatedly(Return(start_time_));
+  EXPECT_CALL(mock_listener_.initiated_cb, Call).Times(1);
+  ConnectionOptions connection_options{
+      .keep_alive_interval_millis = 50,
+      .keep_alive_timeout_millis = 100,
+  };
+
+  endpoint_manager.RegisterEndpoint(client_.get(), endpoint_id_, info_,
+                                    connection_options,
+                                    std::move(endpoint_channel), listener_,
+                                    connection_token_);
+
+  EXPECT_TRUE(closed.Await(absl::Milliseconds(1000)).result());
+}
+
+TEST_F(EndpointManagerTest, SharedKeepAliveWritesPastStalledChannel) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_shared_endpoint_keep_alive =
+      true;
+  EndpointManager endpoint_manager(&ecm_);
+  FeatureFlags::GetMutableFlagsForTesting().enable_shared_endpoint_keep_alive =
+      false;
+  ConnectionOptions connection_options{
+      .keep_alive_interval_millis = 20,
+      .keep_alive_timeout_millis = 10000,
+  };
+  EXPECT_CALL(mock_listener_.initiated_cb, Call).Times(2);
+
+  // The first channel's keep-alive write doesn't return until it's closed.
+  auto stalled_channel = std::make_unique<MockEndpointChannel>();
+  CountDownLatch stalled_closed(1);
+  CountDownLatch stalled_write_started(1);
+  EXPECT_CALL(*stalled_channel, Read(_))
+      .WillRepeatedly([&stalled_closed](PacketMetaData& packet_meta_data) {
+        stalled_closed.Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  EXPECT_CALL(*stalled_channel, Write(_))
+      .WillRepeatedly([&stalled_closed, &stalled_write_started](
+                          const ByteArray& data) {
+        stalled_write_started.CountDown();
+        stalled_closed.Await();
+        return Exception{Exception::kIo};
+      });
+  EXPECT_CALL(*stalled_channel, Close(_))
+      .WillRepeatedly([&stalled_closed](DisconnectionReason reason) {
+        stalled_closed.CountDown();
+      });
+  EXPECT_CALL(*stalled_channel, GetMedium())
+      .WillRepeatedly(Return(Medium::BLE));
+  EXPECT_CALL(*stalled_channel, GetLastReadTimestamp())
+      .WillRepeatedly([]() { return absl::Now(); });
+  EXPECT_CALL(*stalled_channel, GetLastWriteTimestamp())
+      .WillRepeatedly(Return(start_time_));
+  endpoint_manager.RegisterEndpoint(client_.get(), endpoint_id_, info_,
+                                    connection_options,
+                                    std::move(stalled_channel), listener_,
+                                    connection_token_);
+  ASSERT_TRUE(stalled_write_started.Await(absl::Milliseconds(1000)).result());
+
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  CountDownLatch closed(1);
+  CountDownLatch written(1);
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillRepeatedly([&closed](PacketMetaData& packet_meta_data) {
+        closed.Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  EXPECT_CALL(*endpoint_channel, Write(_))
+      .WillRepeatedly([&written](const ByteArray& data) {
+        written.CountDown();
+        return Exception{Exception::kSuccess};
+      });
+  EXPECT_CALL(*endpoint_channel, Close(_))
+      .WillRepeatedly(
+          [&closed](DisconnectionReason reason) { closed.CountDown(); });
+  EXPECT_CALL(*endpoint_channel, GetMedium())
+      .WillRepeatedly(Return(Medium::BLE));
+  EXPECT_CALL(*endpoint_channel, GetLastReadTimestamp())
+      .WillRepeatedly([]() { return absl::Now(); });
+  EXPECT_CALL(*endpoint_channel, GetLastWriteTimestamp())
+      .WillRepeatedly(Return(start_time_));
+  endpoint_manager.RegisterEndpoint(client_.get(), "other_endpoint_id", info_,
+                                    connection_options,
+                                    std::move(endpoint_channel), listener_,
+                                    connection_token_);
+
+  EXPECT_TRUE(written.Await(absl::Milliseconds(1000)).result());
+}
+
+TEST_F(EndpointManagerTest, KeepAliveSuppressedWhileReading) {
+  FeatureFlags::GetMutableFlagsForTesting().enable_keep_alive_suppression =
+      true;
+  EndpointManager endpoint_manager(&ecm_);
+  FeatureFlags::GetMutableFlagsForTesting().enable_keep_alive_suppression =
+      false;
+  auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+  CountDownLatch closed(1);
+  EXPECT_CALL(*endpoint_channel, Read(_))
+      .WillRepeatedly([&closed](PacketMetaData& packet_meta_data) {
+        closed.Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      });
+  // Frames keep arriving, but nothing was written since the start.
+  EXPECT_CALL(*endpoint_channel, GetLastReadTimestamp())
+      .WillRepeatedly([]() { return absl::Now(); });
+  EXPECT_CALL(*endpoint_channel, GetLastWriteTimestamp())
+      .WillRepeatedly(Return(start_time_));
+  EXPECT_CALL(*endpoint_channel, Write(_)).Times(0);
+  EXPECT_CALL(*endpoint_channel, Close(_))
+      .WillRepeatedly(
+          [&closed](DisconnectionReason reason) { closed.CountDown(); });
+  EXPECT_CALL(*endpoint_channel, GetMedium())
+      .WillRepeatedly(Return(Medium::BLE));
+  EXPECT_CALL(mock_listener_.initiated_cb, Call).Times(1);
+  ConnectionOptions connection_options{
+      .keep_alive_interval_millis = 20,
+      .keep_alive_timeout_millis = 10000,
+  };
+
+  endpoint_manager.RegisterEndpoint(client_.get(), endpoint_id_, info_,
+                                    connection_options,
+                                    std::move(endpoint_channel), listener_,
+                                    connection_token_);
+  // Without suppression, a keep-alive would be written every 20ms.
+  absl::SleepFor(absl::Milliseconds(200));
+}
+
+TEST_F(EndpointManagerTest, FanOutWritesToEndpointsInParallel) {
+  FeatureFlags::GetMutableFlagsForTesting()
+      .payload_fan_out_max_parallel_writes = 2;
+  EndpointManager endpoint_manager(&ecm_);
+  FeatureFlags::GetMutableFlagsForTesting()
+      .payload_fan_out_max_parallel_writes = 1;
+  // Each write waits for the other one to start, so the frame is only
+  // delivered to both endpoints if they are written to concurrently.
+  CountDownLatch writes_started(2);
+  std::vector<std::string> endpoint_ids = {"endpoint_1", "endpoint_2"};
+  EXPECT_CALL(mock_listener_.initiated_cb, Call).Times(2);
+  for (const std::string& endpoint_id : endpoint_ids) {
+    auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+    ON_CALL(*endpoint_channel, Read(_))
+        .WillByDefault([channel = endpoint_channel.get()]() {
+          while (!channel->IsClosed()) {
+            absl::SleepFor(absl::Milliseconds(10));
+          }
+          return ExceptionOr<ByteArray>(Exception::kIo);
+        });
+    ON_CALL(*endpoint_channel, Close(_))
+        .WillByDefault([channel = endpoint_channel.get()](
+                           DisconnectionReason reason) { channel->DoClose(); });
+    EXPECT_CALL(*endpoint_channel, Write(_, _))
+        .WillRepeatedly([&writes_started](const ByteArray& data,
+                                          PacketMetaData& packet_meta_data) {
+          writes_started.CountDown();
+          if (!writes_started.Await(absl::Milliseconds(1000)).result()) {
+            return Exception{Exception::kTimeout};
+          }
+          return Exception{Exception::kSuccess};
+        });
+    EXPECT_CALL(*endpoint_channel, GetMedium())
+        .WillRepeatedly(Return(Medium::BLE));
+    EXPECT_CALL(*endpoint_channel, GetLastReadTimestamp())
+        .WillRepeatedly(Return(start_time_));
+    EXPECT_CALL(*endpoint_channel, GetLastWriteTimestamp())
+        .WillRepeatedly(Return(start_time_));
+    endpoint_manager.RegisterEndpoint(client_.get(), endpoint_id, info_,
+                                      connection_options_,
+                                      std::move(endpoint_channel), listener_,
+                                      connection_token_);
+  }
+
+  EXPECT_EQ(endpoint_manager.SendPayloadAck(/*payload_id=*/12345,
+                                            endpoint_ids),
+            std::vector<std::string>{});
+}
+
+TEST_F(EndpointManagerTest, ParallelTeardownUnregistersAllEndpoints) {
+  FeatureFlags::GetMutableFlagsForTesting()
+      .endpoint_teardown_max_parallel_disconnects = 4;
+  EndpointManager endpoint_manager(&ecm_);
+  FeatureFlags::GetMutableFlagsForTesting()
+      .endpoint_teardown_max_parallel_disconnects = 1;
+  std::vector<std::string> endpoint_ids = {"endpoint_1", "endpoint_2",
+                                           "endpoint_3"};
+  CountDownLatch closed(endpoint_ids.size());
+  EXPECT_CALL(mock_listener_.initiated_cb, Call).Times(endpoint_ids.size());
+  for (const std::string& endpoint_id : endpoint_ids) {
+    auto endpoint_channel = std::make_unique<MockEndpointChannel>();
+    ON_CALL(*endpoint_channel, Read(_))
+        .WillByDefault([channel = endpoint_channel.get()]() {
+          while (!channel->IsClosed()) {
+            absl::SleepFor(absl::Milliseconds(10));
+          }
+          return ExceptionOr<ByteArray>(Exception::kIo);
+        });
+    ON_CALL(*endpoint_channel, Close(_))
+        .WillByDefault([channel = endpoint_channel.get(),
+                        &closed](DisconnectionReason reason) {
+          channel->DoClose();
+          closed.CountDown();
+        });
+    EXPECT_CALL(*endpoint_channel, GetMedium())
+        .WillRepeatedly(Return(Medium::BLE));
+    EXPECT_CALL(*endpoint_channel, GetLastReadTimestamp())
+        .WillRepeatedly(Return(start_time_));
+    EXPECT_CALL(*endpoint_channel, GetLastWriteTimestamp())
+        .WillRepeatedly(Return(start_time_));
+    endpoint_manager.RegisterEndpoint(client_.get(), endpoint_id, info_,
+                                      connection_options_,
+                                      std::move(endpoint_channel), listener_,
+                                      connection_token_);
+  }
+  ASSERT_EQ(ecm_.GetConnectedEndpointsCount(), 3);
+
+  endpoint_manager.UnregisterEndpoints(client_.get(), endpoint_ids);
+
+  EXPECT_TRUE(closed.Await(absl::Milliseconds(1000)).result());
+  EXPECT_EQ(ecm_.GetConnectedEndpointsCount(), 0);
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
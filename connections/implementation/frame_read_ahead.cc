@@ -0,0 +1,100 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/frame_read_ahead.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "connections/implementation/analytics/packet_meta_data.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+namespace connections {
+
+FrameReadAhead::FrameReadAhead(ReadFrameCallback read_frame, size_t max_frames)
+    : read_frame_(std::move(read_frame)),
+      max_frames_(std::max<size_t>(max_frames, 1)) {
+  executor_.Execute("frame-read-ahead", [this]() { Loop(); });
+}
+
+FrameReadAhead::~FrameReadAhead() { Shutdown(); }
+
+ExceptionOr<ByteArray> FrameReadAhead::Pop(
+    analytics::PacketMetaData& packet_meta_data) {
+  MutexLock lock(&mutex_);
+  while (!shutdown_ && frames_.empty()) {
+    cond_.Wait();
+  }
+  if (shutdown_) return {Exception::kIo};
+  Frame& frame = frames_.front();
+  packet_meta_data.socket_io_start_time =
+      frame.packet_meta_data.socket_io_start_time;
+  packet_meta_data.socket_io_end_time =
+      frame.packet_meta_data.socket_io_end_time;
+  packet_meta_data.SetPacketSize(frame.packet_meta_data.GetPacketSize());
+  // The failed read is the last one; keep handing it out.
+  if (!frame.result.ok()) {
+    return ExceptionOr<ByteArray>(frame.result.exception());
+  }
+  ExceptionOr<ByteArray> result = std::move(frame.result);
+  frames_.pop_front();
+  cond_.Notify();
+  return result;
+}
+
+void FrameReadAhead::Shutdown() {
+  {
+    MutexLock lock(&mutex_);
+    if (shutdown_) return;
+    shutdown_ = true;
+    frames_.clear();
+    cond_.Notify();
+  }
+  executor_.Shutdown();
+}
+
+size_t FrameReadAhead::GetBufferedFrames() const {
+  MutexLock lock(&mutex_);
+  return frames_.size();
+}
+
+void FrameReadAhead::Loop() {
+  while (true) {
+    {
+      MutexLock lock(&mutex_);
+      while (!shutdown_ && frames_.size() >= max_frames_) {
+        cond_.Wait();
+      }
+      if (shutdown_) return;
+    }
+    analytics::PacketMetaData packet_meta_data{};
+    ExceptionOr<ByteArray> result = read_frame_(packet_meta_data);
+    bool failed = !result.ok();
+    {
+      MutexLock lock(&mutex_);
+      if (shutdown_) return;
+      frames_.push_back({.result = std::move(result),
+                         .packet_meta_data = packet_meta_data});
+      cond_.Notify();
+    }
+    if (failed) return;
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,87 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_FRAME_READ_AHEAD_H_
+#define CORE_INTERNAL_FRAME_READ_AHEAD_H_
+
+#include <cstddef>
+#include <deque>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "connections/implementation/analytics/packet_meta_data.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+
+// Reads frames from an endpoint channel on a dedicated thread, at most
+// |max_frames| ahead of the consumer. This keeps the socket drained while the
+// consumer decrypts and dispatches the frames read before.
+//
+// Frames are handed out in the order they were read. A read that fails stops
+// the read thread; its exception is handed out after the frames read before
+// it, and to every Pop() after that.
+class FrameReadAhead {
+ public:
+  // Reads the next frame, filling in its socket IO times and packet size.
+  using ReadFrameCallback = absl::AnyInvocable<ExceptionOr<ByteArray>(
+      analytics::PacketMetaData& packet_meta_data)>;
+
+  // Starts reading right away.
+  FrameReadAhead(ReadFrameCallback read_frame, size_t max_frames);
+  ~FrameReadAhead();
+
+  FrameReadAhead(const FrameReadAhead&) = delete;
+  FrameReadAhead& operator=(const FrameReadAhead&) = delete;
+
+  // Blocks until the next frame has been read, and copies its socket IO times
+  // and packet size into |packet_meta_data|. Returns Exception::kIo once shut
+  // down.
+  ExceptionOr<ByteArray> Pop(analytics::PacketMetaData& packet_meta_data)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Unblocks Pop(), drops the buffered frames and waits for the read thread
+  // to exit. The underlying stream must be closed first, so a read in
+  // progress returns.
+  void Shutdown() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Number of frames read but not popped yet. For tests and logging.
+  size_t GetBufferedFrames() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Frame {
+    ExceptionOr<ByteArray> result;
+    analytics::PacketMetaData packet_meta_data;
+  };
+
+  void Loop() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  ReadFrameCallback read_frame_;
+  const size_t max_frames_;
+  mutable Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  std::deque<Frame> frames_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  SingleThreadExecutor executor_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_FRAME_READ_AHEAD_H_
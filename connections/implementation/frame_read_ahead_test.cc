@@ -0,0 +1,132 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/frame_read_ahead.h"
+
+#include <atomic>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "connections/implementation/analytics/packet_meta_data.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::nearby::analytics::PacketMetaData;
+
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(100);
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+TEST(FrameReadAheadTest, DeliversFramesInOrder) {
+  int next_frame = 0;
+  FrameReadAhead read_ahead(
+      [&next_frame](PacketMetaData& packet_meta_data) {
+        packet_meta_data.SetPacketSize(next_frame + 4);
+        return ExceptionOr<ByteArray>(
+            ByteArray("frame " + std::to_string(next_frame++)));
+      },
+      /*max_frames=*/2);
+
+  for (int i = 0; i < 5; i++) {
+    PacketMetaData packet_meta_data{};
+    ExceptionOr<ByteArray> frame = read_ahead.Pop(packet_meta_data);
+    ASSERT_TRUE(frame.ok());
+    EXPECT_EQ(frame.result().AsStringView(), "frame " + std::to_string(i));
+    EXPECT_EQ(packet_meta_data.GetPacketSize(), i + 4);
+  }
+}
+
+TEST(FrameReadAheadTest, StopsReadingWhenFull) {
+  std::atomic<int> reads = 0;
+  FrameReadAhead read_ahead(
+      [&reads](PacketMetaData& packet_meta_data) {
+        reads++;
+        return ExceptionOr<ByteArray>(ByteArray(std::string("frame")));
+      },
+      /*max_frames=*/2);
+
+  absl::Time deadline = absl::Now() + kDefaultTimeout;
+  while (read_ahead.GetBufferedFrames() < 2 && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  absl::SleepFor(kShortTimeout);
+  EXPECT_EQ(read_ahead.GetBufferedFrames(), 2);
+  EXPECT_EQ(reads, 2);
+
+  PacketMetaData packet_meta_data{};
+  ASSERT_TRUE(read_ahead.Pop(packet_meta_data).ok());
+  deadline = absl::Now() + kDefaultTimeout;
+  while (reads < 3 && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(reads, 3);
+}
+
+TEST(FrameReadAheadTest, HandsOutReadErrorAfterBufferedFrames) {
+  int reads = 0;
+  FrameReadAhead read_ahead(
+      [&reads](PacketMetaData& packet_meta_data) {
+        if (reads++ == 0) {
+          return ExceptionOr<ByteArray>(ByteArray(std::string("frame")));
+        }
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      },
+      /*max_frames=*/4);
+  PacketMetaData packet_meta_data{};
+
+  ExceptionOr<ByteArray> frame = read_ahead.Pop(packet_meta_data);
+  ASSERT_TRUE(frame.ok());
+  EXPECT_EQ(frame.result().AsStringView(), "frame");
+  EXPECT_EQ(read_ahead.Pop(packet_meta_data).exception(), Exception::kIo);
+  EXPECT_EQ(read_ahead.Pop(packet_meta_data).exception(), Exception::kIo);
+  EXPECT_EQ(reads, 2);
+}
+
+TEST(FrameReadAheadTest, ShutdownUnblocksPop) {
+  // Stands in for a stream that blocks until it is closed.
+  CountDownLatch stream_closed(1);
+  FrameReadAhead read_ahead(
+      [&stream_closed](PacketMetaData& packet_meta_data) {
+        stream_closed.Await();
+        return ExceptionOr<ByteArray>(Exception::kIo);
+      },
+      /*max_frames=*/2);
+  SingleThreadExecutor executor;
+  CountDownLatch popped(1);
+  Exception::Value result = Exception::kSuccess;
+
+  executor.Execute([&read_ahead, &popped, &result]() {
+    PacketMetaData packet_meta_data{};
+    result = read_ahead.Pop(packet_meta_data).exception();
+    popped.CountDown();
+  });
+  EXPECT_FALSE(popped.Await(kShortTimeout).result());
+
+  stream_closed.CountDown();
+  read_ahead.Shutdown();
+  EXPECT_TRUE(popped.Await(kDefaultTimeout).result());
+  EXPECT_EQ(result, Exception::kIo);
+  EXPECT_EQ(read_ahead.GetBufferedFrames(), 0);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,122 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "connections/implementation/incoming_bytes_budget.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/time/time.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+namespace connections {
+
+IncomingBytesBudget::Reservation::Reservation(Reservation&& other)
+    : budget_(other.budget_),
+      endpoint_id_(std::move(other.endpoint_id_)),
+      bytes_(other.bytes_) {
+  other.budget_ = nullptr;
+}
+
+IncomingBytesBudget::Reservation& IncomingBytesBudget::Reservation::operator=(
+    Reservation&& other) {
+  if (this != &other) {
+    if (budget_ != nullptr) budget_->Release(endpoint_id_, bytes_);
+    budget_ = other.budget_;
+    endpoint_id_ = std::move(other.endpoint_id_);
+    bytes_ = other.bytes_;
+    other.budget_ = nullptr;
+  }
+  return *this;
+}
+
+IncomingBytesBudget::Reservation::~Reservation() {
+  if (budget_ != nullptr) budget_->Release(endpoint_id_, bytes_);
+}
+
+IncomingBytesBudget::IncomingBytesBudget(std::int64_t max_bytes,
+                                         std::int64_t max_endpoint_bytes,
+                                         absl::Duration max_wait)
+    : max_bytes_(max_bytes),
+      max_endpoint_bytes_(max_endpoint_bytes),
+      max_wait_(max_wait) {}
+
+IncomingBytesBudget::Reservation IncomingBytesBudget::Acquire(
+    const std::string& endpoint_id, std::int64_t bytes) {
+  MutexLock lock(&mutex_);
+  // A payload larger than a budget goes on once nothing else is held in it.
+  auto fits = [bytes](std::int64_t held, std::int64_t max) {
+    return max <= 0 || held == 0 || held + bytes <= max;
+  };
+  auto has_room = [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    auto endpoint = endpoint_held_bytes_.find(endpoint_id);
+    return fits(stats_.held_bytes, max_bytes_) &&
+           fits(endpoint == endpoint_held_bytes_.end() ? 0 : endpoint->second,
+                max_endpoint_bytes_);
+  };
+  if (!shutdown_ && !has_room()) {
+    stats_.delayed++;
+    absl::Time deadline = SystemClock::ElapsedRealtime() + max_wait_;
+    while (!shutdown_ && !has_room()) {
+      absl::Duration remaining = deadline - SystemClock::ElapsedRealtime();
+      if (remaining <= absl::ZeroDuration()) {
+        stats_.overflowed++;
+        break;
+      }
+      cond_.Wait(remaining);
+    }
+  }
+  stats_.held_bytes += bytes;
+  stats_.peak_bytes = std::max(stats_.peak_bytes, stats_.held_bytes);
+  endpoint_held_bytes_[endpoint_id] += bytes;
+  return Reservation(this, endpoint_id, bytes);
+}
+
+void IncomingBytesBudget::Shutdown() {
+  MutexLock lock(&mutex_);
+  shutdown_ = true;
+  cond_.Notify();
+}
+
+IncomingBytesBudget::Stats IncomingBytesBudget::GetStats() const {
+  MutexLock lock(&mutex_);
+  return stats_;
+}
+
+std::int64_t IncomingBytesBudget::GetHeldBytes(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+  auto endpoint = endpoint_held_bytes_.find(endpoint_id);
+  return endpoint == endpoint_held_bytes_.end() ? 0 : endpoint->second;
+}
+
+void IncomingBytesBudget::Release(const std::string& endpoint_id,
+                                  std::int64_t bytes) {
+  MutexLock lock(&mutex_);
+  stats_.held_bytes -= bytes;
+  auto endpoint = endpoint_held_bytes_.find(endpoint_id);
+  if (endpoint != endpoint_held_bytes_.end()) {
+    endpoint->second -= bytes;
+    if (endpoint->second <= 0) endpoint_held_bytes_.erase(endpoint);
+  }
+  cond_.Notify();
+}
+
+}  // namespace connections
+}  // namespace nearby
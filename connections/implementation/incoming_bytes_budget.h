@@ -0,0 +1,117 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef CORE_INTERNAL_INCOMING_BYTES_BUDGET_H_
+#define CORE_INTERNAL_INCOMING_BYTES_BUDGET_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace connections {
+
+// Bounds the memory held by incoming BYTES payloads from the time they are
+// read until they are handed to the client.
+//
+// The reader of an endpoint acquires the size of a payload before going on
+// with it, so once |max_bytes| are held, endpoints stop being read and the
+// senders are held back by the flow control of their mediums. Once an
+// endpoint holds |max_endpoint_bytes|, only its own reader waits, so a peer
+// that floods the client can't take the whole budget from the others. A
+// reader waits at most |max_wait|, to stay within the keep-alive timeout, and
+// then goes on regardless; a payload larger than a budget only waits for the
+// others to be released. A budget of 0 is unbounded, and only accounts for
+// the bytes.
+class IncomingBytesBudget {
+ public:
+  // Releases the bytes it holds when destroyed.
+  class Reservation {
+   public:
+    Reservation() = default;
+    Reservation(Reservation&& other);
+    Reservation& operator=(Reservation&& other);
+    ~Reservation();
+
+   private:
+    friend class IncomingBytesBudget;
+    Reservation(IncomingBytesBudget* budget, std::string endpoint_id,
+                std::int64_t bytes)
+        : budget_(budget),
+          endpoint_id_(std::move(endpoint_id)),
+          bytes_(bytes) {}
+
+    IncomingBytesBudget* budget_ = nullptr;
+    std::string endpoint_id_;
+    std::int64_t bytes_ = 0;
+  };
+
+  struct Stats {
+    std::int64_t held_bytes = 0;
+    // The most bytes ever held at once.
+    std::int64_t peak_bytes = 0;
+    // Payloads that had to wait for room, and those that went on after
+    // |max_wait| without it.
+    std::int64_t delayed = 0;
+    std::int64_t overflowed = 0;
+  };
+
+  IncomingBytesBudget(std::int64_t max_bytes, std::int64_t max_endpoint_bytes,
+                      absl::Duration max_wait);
+  ~IncomingBytesBudget() = default;
+
+  IncomingBytesBudget(const IncomingBytesBudget&) = delete;
+  IncomingBytesBudget& operator=(const IncomingBytesBudget&) = delete;
+
+  // Waits for room for |bytes| from |endpoint_id|, up to |max_wait|, and holds
+  // them until the returned reservation is destroyed. Reservations must not
+  // outlive the budget.
+  Reservation Acquire(const std::string& endpoint_id, std::int64_t bytes)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Stops waiting for room; Acquire() returns right away from now on.
+  void Shutdown() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  Stats GetStats() const ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns the bytes held for |endpoint_id|.
+  std::int64_t GetHeldBytes(const std::string& endpoint_id) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  void Release(const std::string& endpoint_id, std::int64_t bytes)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const std::int64_t max_bytes_;
+  const std::int64_t max_endpoint_bytes_;
+  const absl::Duration max_wait_;
+  mutable Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+  // Bytes held per endpoint; endpoints holding none are dropped.
+  absl::flat_hash_map<std::string, std::int64_t> endpoint_held_bytes_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_INCOMING_BYTES_BUDGET_H_
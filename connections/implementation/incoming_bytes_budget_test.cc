@@ -0,0 +1,131 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "connections/implementation/incoming_bytes_budget.h"
+
+#include <memory>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+TEST(IncomingBytesBudgetTest, TracksHeldAndPeakBytes) {
+  IncomingBytesBudget budget(/*max_bytes=*/100, /*max_endpoint_bytes=*/0,
+                             kDefaultTimeout);
+  {
+    IncomingBytesBudget::Reservation first = budget.Acquire("A", 40);
+    IncomingBytesBudget::Reservation second = budget.Acquire("B", 60);
+    EXPECT_EQ(budget.GetStats().held_bytes, 100);
+  }
+  EXPECT_EQ(budget.GetStats().held_bytes, 0);
+  EXPECT_EQ(budget.GetStats().peak_bytes, 100);
+  EXPECT_EQ(budget.GetStats().delayed, 0);
+}
+
+TEST(IncomingBytesBudgetTest, WaitsForRoom) {
+  IncomingBytesBudget budget(/*max_bytes=*/100, /*max_endpoint_bytes=*/0,
+                             kDefaultTimeout);
+  auto first = std::make_unique<IncomingBytesBudget::Reservation>(
+      budget.Acquire("A", 80));
+  CountDownLatch acquired(1);
+  SingleThreadExecutor executor;
+  executor.Execute([&]() {
+    IncomingBytesBudget::Reservation second = budget.Acquire("B", 40);
+    acquired.CountDown();
+  });
+
+  EXPECT_FALSE(acquired.Await(absl::Milliseconds(50)).result());
+  first.reset();
+  EXPECT_TRUE(acquired.Await(kDefaultTimeout).result());
+  executor.Shutdown();
+  EXPECT_EQ(budget.GetStats().delayed, 1);
+  EXPECT_EQ(budget.GetStats().overflowed, 0);
+  EXPECT_EQ(budget.GetStats().peak_bytes, 80);
+}
+
+TEST(IncomingBytesBudgetTest, GoesOnAfterMaxWait) {
+  IncomingBytesBudget budget(/*max_bytes=*/100, /*max_endpoint_bytes=*/0,
+                             absl::Milliseconds(20));
+  IncomingBytesBudget::Reservation first = budget.Acquire("A", 80);
+  absl::Time start = absl::Now();
+  IncomingBytesBudget::Reservation second = budget.Acquire("B", 40);
+
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(20));
+  EXPECT_EQ(budget.GetStats().held_bytes, 120);
+  EXPECT_EQ(budget.GetStats().overflowed, 1);
+}
+
+TEST(IncomingBytesBudgetTest, PayloadLargerThanBudgetGoesOnAlone) {
+  IncomingBytesBudget budget(/*max_bytes=*/100, /*max_endpoint_bytes=*/0,
+                             kDefaultTimeout);
+  absl::Time start = absl::Now();
+  IncomingBytesBudget::Reservation reservation = budget.Acquire("A", 1000);
+
+  EXPECT_LT(absl::Now() - start, kDefaultTimeout);
+  EXPECT_EQ(budget.GetStats().delayed, 0);
+}
+
+TEST(IncomingBytesBudgetTest, TracksHeldBytesPerEndpoint) {
+  IncomingBytesBudget budget(/*max_bytes=*/0, /*max_endpoint_bytes=*/0,
+                             kDefaultTimeout);
+  IncomingBytesBudget::Reservation first = budget.Acquire("A", 40);
+  {
+    IncomingBytesBudget::Reservation second = budget.Acquire("A", 60);
+    IncomingBytesBudget::Reservation third = budget.Acquire("B", 1000);
+    EXPECT_EQ(budget.GetHeldBytes("A"), 100);
+    EXPECT_EQ(budget.GetHeldBytes("B"), 1000);
+  }
+  EXPECT_EQ(budget.GetHeldBytes("A"), 40);
+  EXPECT_EQ(budget.GetHeldBytes("B"), 0);
+  EXPECT_EQ(budget.GetStats().held_bytes, 40);
+  EXPECT_EQ(budget.GetStats().delayed, 0);
+}
+
+TEST(IncomingBytesBudgetTest, FullEndpointOnlyHoldsBackItself) {
+  IncomingBytesBudget budget(/*max_bytes=*/100, /*max_endpoint_bytes=*/50,
+                             kDefaultTimeout);
+  auto first = std::make_unique<IncomingBytesBudget::Reservation>(
+      budget.Acquire("A", 50));
+  CountDownLatch acquired(1);
+  SingleThreadExecutor executor;
+  executor.Execute([&]() {
+    IncomingBytesBudget::Reservation second = budget.Acquire("A", 10);
+    acquired.CountDown();
+  });
+
+  // Other endpoints still have room.
+  absl::Time start = absl::Now();
+  IncomingBytesBudget::Reservation other = budget.Acquire("B", 40);
+  EXPECT_LT(absl::Now() - start, kDefaultTimeout);
+  EXPECT_FALSE(acquired.Await(absl::Milliseconds(50)).result());
+  first.reset();
+  EXPECT_TRUE(acquired.Await(kDefaultTimeout).result());
+  executor.Shutdown();
+  EXPECT_EQ(budget.GetStats().delayed, 1);
+  EXPECT_EQ(budget.GetStats().overflowed, 0);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
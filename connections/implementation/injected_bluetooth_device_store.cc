@@ -14,7 +14,11 @@
 
 #include "connections/implementation/injected_bluetooth_device_store.h"
 
+#include <memory>
 #include <string>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
 
 #include "connections/implementation/bluetooth_device_name.h"
 #include "internal/platform/implementation/bluetooth_classic.h"
@@ -74,14 +78,15 @@ BluetoothDevice InjectedBluetoothDeviceStore::CreateInjectedBluetoothDevice(
   // malformed.
   if (!name.IsValid()) return BluetoothDevice(/*device=*/nullptr);
 
-  auto injected_device = std::make_unique<InjectedBluetoothDevice>(
-      static_cast<std::string>(name), remote_bluetooth_mac_address_str);
-  BluetoothDevice device_to_return(injected_device.get());
-
-  // Store underlying device to ensure that it is kept alive for future use.
-  devices_.emplace_back(std::move(injected_device));
-
-  return device_to_return;
+  std::string name_str = static_cast<std::string>(name);
+  std::unique_ptr<api::BluetoothDevice>& injected_device =
+      devices_[absl::StrCat(remote_bluetooth_mac_address_str, "/", name_str)];
+  if (injected_device == nullptr) {
+    // Store underlying device to ensure that it is kept alive for future use.
+    injected_device = std::make_unique<InjectedBluetoothDevice>(
+        name_str, remote_bluetooth_mac_address_str);
+  }
+  return BluetoothDevice(injected_device.get());
 }
 
 }  // namespace connections
@@ -16,8 +16,9 @@
 #define CORE_INTERNAL_INJECTED_BLUETOOTH_DEVICE_STORE_H_
 
 #include <memory>
-#include <vector>
+#include <string>
 
+#include "absl/container/flat_hash_map.h"
 #include "connections/implementation/pcp.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/bluetooth_adapter.h"
@@ -47,7 +48,8 @@ class InjectedBluetoothDeviceStore {
   //
   // Note that successfully-injected devices stay valid for the lifetime of the
   // InjectedBluetoothDeviceStore and are not cleared until this object is
-  // deleted.
+  // deleted. Injecting the same device again returns the device created the
+  // first time.
   BluetoothDevice CreateInjectedBluetoothDevice(
       const ByteArray& remote_bluetooth_mac_address,
       const std::string& endpoint_id, const ByteArray& endpoint_info,
@@ -57,8 +59,10 @@ class InjectedBluetoothDeviceStore {
   // Devices created by this class. BluetoothDevice objects returned by
   // CreateInjectedBluetoothDevice() store pointers to underlying
   // api::BluetoothDevice objects, so this maintains these underlying devices
-  // to ensure that they are not deleted before they are referenced.
-  std::vector<std::unique_ptr<api::BluetoothDevice>> devices_;
+  // to ensure that they are not deleted before they are referenced. Indexed by
+  // MAC address and device name.
+  absl::flat_hash_map<std::string, std::unique_ptr<api::BluetoothDevice>>
+      devices_;
 };
 
 }  // namespace connections
@@ -61,6 +61,28 @@ TEST_F(InjectedBluetoothDeviceStoreTest, Success) {
   EXPECT_EQ(Pcp::kP2pPointToPoint, name.GetPcp());
 }
 
+TEST_F(InjectedBluetoothDeviceStoreTest, ReusesDevicesInjectedAgain) {
+  ByteArray remote_bluetooth_mac_address(kTestRemoteBluetoothMacAddress);
+  ByteArray endpoint_info(kTestEndpointInfo);
+  ByteArray service_id_hash(kTestServiceIdHash);
+
+  BluetoothDevice device1 = store_.CreateInjectedBluetoothDevice(
+      remote_bluetooth_mac_address, kTestEndpointId, endpoint_info,
+      service_id_hash, Pcp::kP2pPointToPoint);
+  BluetoothDevice device2 = store_.CreateInjectedBluetoothDevice(
+      remote_bluetooth_mac_address, kTestEndpointId, endpoint_info,
+      service_id_hash, Pcp::kP2pPointToPoint);
+  BluetoothDevice device3 = store_.CreateInjectedBluetoothDevice(
+      remote_bluetooth_mac_address, "efgh", endpoint_info, service_id_hash,
+      Pcp::kP2pPointToPoint);
+  ASSERT_TRUE(device1.IsValid());
+  ASSERT_TRUE(device3.IsValid());
+
+  EXPECT_EQ(&device1.GetImpl(), &device2.GetImpl());
+  EXPECT_NE(&device1.GetImpl(), &device3.GetImpl());
+  EXPECT_NE(device1.GetName(), device3.GetName());
+}
+
 TEST_F(InjectedBluetoothDeviceStoreTest, Fail_InvalidBluetoothMac) {
   // Use address with only 1 byte.
   ByteArray remote_bluetooth_mac_address(std::array<char, 1>{0x00});
@@ -16,6 +16,7 @@
 #define CORE_INTERNAL_INTERNAL_PAYLOAD_H_
 
 #include <cstdint>
+#include <string>
 
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/payload.h"
@@ -82,7 +83,7 @@ class InternalPayload {
   // @param chunk The next chunk; this being null signals that this is the last
   // chunk, which will typically be used as a trigger to perform whatever state
   // cleanup may be required by the concrete implementation.
-  virtual Exception AttachNextChunk(const ByteArray& chunk) = 0;
+  virtual Exception AttachNextChunk(ByteArray chunk) = 0;
 
   // Skips current stream pointer to the offset.
   //
@@ -92,6 +93,12 @@ class InternalPayload {
   // @return the offset really skipped
   virtual ExceptionOr<size_t> SkipToOffset(size_t offset) = 0;
 
+  // Returns the SHA-256 digest of the content that went through this payload,
+  // once all of it did. Empty if the content isn't hashed: for bytes and
+  // stream payloads, without the enable_file_payload_digest flag, or when the
+  // transfer resumed from an offset.
+  virtual std::string GetSha256Digest() const { return {}; }
+
   // Cleans up any resources used by this Payload. Called when we're stopping
   // early, e.g. after being cancelled or having no more recipients left.
   virtual void Close() {}
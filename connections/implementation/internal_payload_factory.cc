@@ -23,11 +23,15 @@
 #include "absl/strings/str_cat.h"
 #include "connections/implementation/internal_payload.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
+#include "connections/implementation/write_behind_sink.h"
 #include "connections/payload.h"
 #include "connections/payload_type.h"
+#include "internal/crypto_cros/secure_hash.h"
+#include "internal/crypto_cros/sha2.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/expected.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/file.h"
 #include "internal/platform/implementation/platform.h"
 #include "internal/platform/input_stream.h"
@@ -43,6 +47,45 @@ namespace {
 using ::location::nearby::connections::PayloadTransferFrame;
 using ::location::nearby::proto::connections::OperationResultCode;
 
+// Hashes the content of a file payload as its chunks go through, so its digest
+// costs no second pass over the file.
+class ContentHasher {
+ public:
+  // Hashes nothing unless the enable_file_payload_digest flag is set.
+  explicit ContentHasher(std::int64_t total_size) : total_size_(total_size) {
+    if (FeatureFlags::GetInstance().GetFlags().enable_file_payload_digest) {
+      hash_ = crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+    }
+  }
+
+  void Update(const ByteArray& chunk) {
+    if (hash_ == nullptr) return;
+    hash_->Update(chunk.data(), chunk.size());
+    hashed_bytes_ += chunk.size();
+  }
+
+  // Finishes the digest, if every byte of the content was hashed.
+  void Finish() {
+    if (hash_ == nullptr) return;
+    if (hashed_bytes_ == total_size_) {
+      digest_.resize(crypto::kSHA256Length);
+      hash_->Finish(digest_.data(), digest_.size());
+    }
+    hash_.reset();
+  }
+
+  // Stops hashing, e.g. when the content doesn't start at offset 0.
+  void Abandon() { hash_.reset(); }
+
+  const std::string& digest() const { return digest_; }
+
+ private:
+  const std::int64_t total_size_;
+  std::unique_ptr<crypto::SecureHash> hash_;
+  std::int64_t hashed_bytes_ = 0;
+  std::string digest_;
+};
+
 class BytesInternalPayload : public InternalPayload {
  public:
   explicit BytesInternalPayload(Payload payload)
@@ -71,7 +114,7 @@ class BytesInternalPayload : public InternalPayload {
   }
 
   // Does nothing.
-  Exception AttachNextChunk(const ByteArray& chunk) override {
+  Exception AttachNextChunk(ByteArray chunk) override {
     return {Exception::kSuccess};
   }
 
@@ -125,7 +168,7 @@ class OutgoingStreamInternalPayload : public InternalPayload {
     return scoped_bytes_read;
   }
 
-  Exception AttachNextChunk(const ByteArray& chunk) override {
+  Exception AttachNextChunk(ByteArray chunk) override {
     return {Exception::kIo};
   }
 
@@ -170,7 +213,7 @@ class IncomingStreamInternalPayload : public InternalPayload {
 
   ByteArray DetachNextChunk(int chunk_size) override { return {}; }
 
-  Exception AttachNextChunk(const ByteArray& chunk) override {
+  Exception AttachNextChunk(ByteArray chunk) override {
     if (chunk.Empty()) {
       NEARBY_LOGS(INFO) << "Received null last chunk for incoming payload "
                         << this << ", closing OutputStream.";
@@ -197,7 +240,8 @@ class OutgoingFileInternalPayload : public InternalPayload {
  public:
   explicit OutgoingFileInternalPayload(Payload payload)
       : InternalPayload(std::move(payload)),
-        total_size_{payload_.AsFile()->GetTotalSize()} {}
+        total_size_{payload_.AsFile()->GetTotalSize()},
+        hasher_(total_size_) {}
 
   location::nearby::connections::PayloadTransferFrame::PayloadHeader::
       PayloadType
@@ -223,18 +267,22 @@ class OutgoingFileInternalPayload : public InternalPayload {
       // No more data for outgoing payload.
 
       file->Close();
+      hasher_.Finish();
       return {};
     }
 
+    hasher_.Update(bytes);
     return bytes;
   }
 
-  Exception AttachNextChunk(const ByteArray& chunk) override {
+  Exception AttachNextChunk(ByteArray chunk) override {
     return {Exception::kIo};
   }
 
   ExceptionOr<size_t> SkipToOffset(size_t offset) override {
     NEARBY_LOGS(INFO) << "SkipToOffset " << offset;
+    // The receiver only gets the rest of the file.
+    if (offset > 0) hasher_.Abandon();
     InputFile* file = payload_.AsFile();
     if (!file) {
       return {Exception::kIo};
@@ -260,8 +308,11 @@ class OutgoingFileInternalPayload : public InternalPayload {
     if (file) file->Close();
   }
 
+  std::string GetSha256Digest() const override { return hasher_.digest(); }
+
  private:
   std::int64_t total_size_;
+  ContentHasher hasher_;
 };
 
 class IncomingFileInternalPayload : public InternalPayload {
@@ -270,7 +321,22 @@ class IncomingFileInternalPayload : public InternalPayload {
                               std::int64_t total_size)
       : InternalPayload(std::move(payload)),
         output_file_(std::move(output_file)),
-        total_size_(total_size) {}
+        total_size_(total_size),
+        hasher_(total_size_) {
+    const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+    if (flags.enable_incoming_file_preallocation && total_size_ > 0 &&
+        !output_file_.Preallocate(total_size_).Ok()) {
+      // Only costs the extent growth while the chunks are written.
+      NEARBY_LOGS(WARNING) << "Failed to preallocate " << total_size_
+                           << " bytes for incoming file payload " << GetId();
+    }
+    if (flags.enable_incoming_file_write_behind) {
+      write_behind_sink_ = std::make_unique<WriteBehindSink>(
+          output_file_.GetOutputStream(),
+          flags.incoming_file_write_behind_max_buffered_bytes,
+          flags.incoming_file_write_behind_coalesce_bytes);
+    }
+  }
 
   location::nearby::connections::PayloadTransferFrame::PayloadHeader::
       PayloadType
@@ -283,13 +349,25 @@ class IncomingFileInternalPayload : public InternalPayload {
 
   ByteArray DetachNextChunk(int chunk_size) override { return {}; }
 
-  Exception AttachNextChunk(const ByteArray& chunk) override {
+  Exception AttachNextChunk(ByteArray chunk) override {
     if (chunk.Empty()) {
-      // Received null last chunk for incoming payload.
+      // Received null last chunk for incoming payload. Everything must be on
+      // disk before the payload is reported as complete.
+      Exception flushed{Exception::kSuccess};
+      if (write_behind_sink_) {
+        flushed = write_behind_sink_->Flush();
+        write_behind_sink_.reset();
+      }
       output_file_.Close();
-      return {Exception::kSuccess};
+      hasher_.Finish();
+      return flushed;
     }
 
+    hasher_.Update(chunk);
+
+    if (write_behind_sink_) {
+      return write_behind_sink_->Write(std::move(chunk));
+    }
     return output_file_.Write(chunk);
   }
 
@@ -299,11 +377,21 @@ class IncomingFileInternalPayload : public InternalPayload {
     return {Exception::kIo};
   }
 
-  void Close() override { output_file_.Close(); }
+  void Close() override {
+    // Waits for buffered chunks to be written before the file is closed.
+    write_behind_sink_.reset();
+    output_file_.Close();
+  }
+
+  std::string GetSha256Digest() const override { return hasher_.digest(); }
 
  private:
   OutputFile output_file_;
   const std::int64_t total_size_;
+  // Writes chunks to |output_file_| in the background; null if write-behind
+  // is disabled.
+  std::unique_ptr<WriteBehindSink> write_behind_sink_;
+  ContentHasher hasher_;
 };
 
 }  // namespace
@@ -354,7 +442,7 @@ std::string make_path(const std::string& custom_save_path,
 }
 
 ErrorOr<std::unique_ptr<InternalPayload>> CreateIncomingInternalPayload(
-    const location::nearby::connections::PayloadTransferFrame& frame,
+    location::nearby::connections::PayloadTransferFrame& frame,
     const std::string& custom_save_path) {
   if (frame.packet_type() !=
       location::nearby::connections::PayloadTransferFrame::DATA) {
@@ -366,7 +454,9 @@ ErrorOr<std::unique_ptr<InternalPayload>> CreateIncomingInternalPayload(
   switch (frame.payload_header().type()) {
     case PayloadTransferFrame::PayloadHeader::BYTES: {
       return {std::make_unique<BytesInternalPayload>(
-          Payload(payload_id, ByteArray(frame.payload_chunk().body())))};
+          Payload(payload_id,
+                  ByteArray(std::move(
+                      *frame.mutable_payload_chunk()->mutable_body()))))};
     }
 
     case PayloadTransferFrame::PayloadHeader::STREAM: {
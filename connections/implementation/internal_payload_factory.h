@@ -30,9 +30,10 @@ ErrorOr<std::unique_ptr<InternalPayload>> CreateOutgoingInternalPayload(
     Payload payload);
 
 // Creates an InternalPayload representing an incoming Payload from a remote
-// endpoint.
+// endpoint. The chunk body of a BYTES payload, which is the whole payload, is
+// moved into it.
 ErrorOr<std::unique_ptr<InternalPayload>> CreateIncomingInternalPayload(
-    const location::nearby::connections::PayloadTransferFrame& frame,
+    location::nearby::connections::PayloadTransferFrame& frame,
     const std::string& custom_save_path);
 
 }  // namespace connections
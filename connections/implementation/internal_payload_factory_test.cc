@@ -21,13 +21,16 @@
 #include <utility>
 
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "connections/implementation/internal_payload.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/payload.h"
 #include "connections/payload_type.h"
+#include "internal/crypto_cros/sha2.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/expected.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/file.h"
 #include "internal/platform/pipe.h"
 
@@ -105,6 +108,27 @@ TEST(InternalPayloadFactoryTest, CanCreateInternalPayloadFromByteMessage) {
   EXPECT_EQ(payload.AsBytes(), ByteArray(kText));
 }
 
+TEST(InternalPayloadFactoryTest, IncomingBytesPayloadTakesChunkBody) {
+  PayloadTransferFrame frame;
+  frame.set_packet_type(PayloadTransferFrame::DATA);
+  auto& header = *frame.mutable_payload_header();
+  header.set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  header.set_id(12345);
+  header.set_total_size(1024);
+  frame.mutable_payload_chunk()->set_offset(0);
+  frame.mutable_payload_chunk()->set_body(std::string(1024, 'a'));
+  const char* body = frame.payload_chunk().body().data();
+
+  ErrorOr<std::unique_ptr<InternalPayload>> result =
+      CreateIncomingInternalPayload(frame, /*custom_save_path=*/"");
+  ASSERT_FALSE(result.has_error());
+  Payload payload = result.value()->ReleasePayload();
+
+  // The body is moved into the payload rather than copied.
+  EXPECT_EQ(payload.AsBytes().data(), body);
+  EXPECT_EQ(payload.AsBytes().size(), 1024);
+}
+
 TEST(InternalPayloadFactoryTest, CanCreateInternalPayloadFromStreamMessage) {
   PayloadTransferFrame frame;
   std::string path = "C:\\Downloads";
@@ -253,6 +277,67 @@ TEST(InternalPayloadFactoryTest,
   EXPECT_EQ(contents_after_skip, ByteArray("6789"));
 }
 
+PayloadTransferFrame MakeFileFrame(Payload::Id payload_id,
+                                   std::int64_t total_size) {
+  PayloadTransferFrame frame;
+  frame.set_packet_type(PayloadTransferFrame::DATA);
+  auto& header = *frame.mutable_payload_header();
+  header.set_type(PayloadTransferFrame::PayloadHeader::FILE);
+  header.set_id(payload_id);
+  header.set_total_size(total_size);
+  header.set_file_name(absl::StrCat("incoming_", payload_id));
+  return frame;
+}
+
+TEST(InternalPayloadFactoryTest, FilePayloadsReportDigestOfContent) {
+  FeatureFlags::Flags saved_flags = FeatureFlags::GetInstance().GetFlags();
+  FeatureFlags::GetMutableFlagsForTesting().enable_file_payload_digest = true;
+  ByteArray contents("0123456789");
+  Payload::Id payload_id = Payload::GenerateId();
+  CreateFileWithContents(payload_id, contents);
+  ErrorOr<std::unique_ptr<InternalPayload>> outgoing =
+      CreateOutgoingInternalPayload(
+          Payload{payload_id, InputFile(payload_id, contents.size())});
+  ASSERT_FALSE(outgoing.has_error());
+  PayloadTransferFrame frame = MakeFileFrame(Payload::GenerateId(), 10);
+  ErrorOr<std::unique_ptr<InternalPayload>> incoming =
+      CreateIncomingInternalPayload(frame, /*custom_save_path=*/"");
+  ASSERT_FALSE(incoming.has_error());
+
+  while (true) {
+    ByteArray chunk = outgoing.value()->DetachNextChunk(4);
+    bool is_last_chunk = chunk.Empty();
+    EXPECT_TRUE(incoming.value()->AttachNextChunk(std::move(chunk)).Ok());
+    if (is_last_chunk) break;
+    // Nothing is reported until the whole file went through.
+    EXPECT_EQ(outgoing.value()->GetSha256Digest(), "");
+    EXPECT_EQ(incoming.value()->GetSha256Digest(), "");
+  }
+
+  std::string digest = crypto::SHA256HashString("0123456789");
+  EXPECT_EQ(outgoing.value()->GetSha256Digest(), digest);
+  EXPECT_EQ(incoming.value()->GetSha256Digest(), digest);
+  FeatureFlags::GetMutableFlagsForTesting() = saved_flags;
+}
+
+TEST(InternalPayloadFactoryTest, ResumedFilePayloadReportsNoDigest) {
+  FeatureFlags::Flags saved_flags = FeatureFlags::GetInstance().GetFlags();
+  FeatureFlags::GetMutableFlagsForTesting().enable_file_payload_digest = true;
+  ByteArray contents("0123456789");
+  Payload::Id payload_id = Payload::GenerateId();
+  CreateFileWithContents(payload_id, contents);
+  ErrorOr<std::unique_ptr<InternalPayload>> outgoing =
+      CreateOutgoingInternalPayload(
+          Payload{payload_id, InputFile(payload_id, contents.size())});
+  ASSERT_FALSE(outgoing.has_error());
+
+  EXPECT_TRUE(outgoing.value()->SkipToOffset(4).ok());
+  EXPECT_EQ(outgoing.value()->DetachNextChunk(10), ByteArray("456789"));
+  EXPECT_EQ(outgoing.value()->DetachNextChunk(10), ByteArray());
+  EXPECT_EQ(outgoing.value()->GetSha256Digest(), "");
+  FeatureFlags::GetMutableFlagsForTesting() = saved_flags;
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -0,0 +1,106 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/keep_alive_task.h"
+
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_wheel.h"
+
+namespace nearby {
+namespace connections {
+
+KeepAliveTask::KeepAliveTask(TimerWheel* timer_wheel,
+                             SingleThreadExecutor* executor, Step step,
+                             absl::AnyInvocable<void()> on_done)
+    : timer_wheel_(timer_wheel),
+      executor_(executor),
+      step_(std::move(step)),
+      on_done_(std::move(on_done)) {}
+
+std::shared_ptr<KeepAliveTask> KeepAliveTask::Start(
+    TimerWheel* timer_wheel, SingleThreadExecutor* executor, Step step,
+    absl::AnyInvocable<void()> on_done) {
+  std::shared_ptr<KeepAliveTask> task(new KeepAliveTask(
+      timer_wheel, executor, std::move(step), std::move(on_done)));
+  task->Post();
+  return task;
+}
+
+void KeepAliveTask::Stop() {
+  TimerWheel::TimerId timer_id;
+  {
+    MutexLock lock(&mutex_);
+    stopped_ = true;
+    timer_id = std::exchange(timer_id_, TimerWheel::kInvalidTimerId);
+  }
+  // Must not hold |mutex_| here: Cancel() waits for a firing timer, and that
+  // timer posts a step which takes |mutex_|.
+  timer_wheel_->Cancel(timer_id);
+  MutexLock lock(&mutex_);
+  while (running_) {
+    step_done_.Wait();
+  }
+}
+
+void KeepAliveTask::Post() {
+  // A weak reference lets a task released by its owner simply stop running.
+  executor_->Execute("keep-alive",
+                     [weak_task = weak_from_this()]() {
+                       if (std::shared_ptr<KeepAliveTask> task =
+                               weak_task.lock()) {
+                         task->Run();
+                       }
+                     });
+}
+
+void KeepAliveTask::Run() {
+  {
+    MutexLock lock(&mutex_);
+    if (stopped_) return;
+    running_ = true;
+  }
+  std::optional<absl::Duration> next_delay = step_();
+  {
+    MutexLock lock(&mutex_);
+    running_ = false;
+    step_done_.Notify();
+    if (stopped_) return;
+    if (!next_delay.has_value()) {
+      stopped_ = true;
+    } else if (*next_delay > absl::ZeroDuration()) {
+      timer_id_ = timer_wheel_->Schedule(
+          *next_delay, [weak_task = weak_from_this()]() {
+            if (std::shared_ptr<KeepAliveTask> task = weak_task.lock()) {
+              task->Post();
+            }
+          });
+      return;
+    }
+  }
+  if (next_delay.has_value()) {
+    Post();
+    return;
+  }
+  on_done_();
+}
+
+}  // namespace connections
+}  // namespace nearby
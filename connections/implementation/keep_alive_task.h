@@ -0,0 +1,86 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_KEEP_ALIVE_TASK_H_
+#define CORE_INTERNAL_KEEP_ALIVE_TASK_H_
+
+#include <memory>
+#include <optional>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_wheel.h"
+
+namespace nearby {
+namespace connections {
+
+// Runs the keep-alive checks of one endpoint off a TimerWheel and an executor
+// that are shared by all endpoints, instead of parking a dedicated thread on a
+// condition variable between two checks.
+//
+// The wheel only tracks the deadline; the step itself runs on |executor|.
+// Steps of all endpoints share that one thread, so a step must not block: a
+// step blocked on a slow channel write would hold back the steps of the other
+// endpoints until it returns. EndpointManager writes keep-alive frames on
+// another executor for that reason.
+//
+// Each step returns the delay until the next step, or std::nullopt once the
+// endpoint is done with; |on_done| is then invoked once, on the executor.
+// Steps of one task never run concurrently, since the next step is scheduled
+// only after the current one returned.
+class KeepAliveTask : public std::enable_shared_from_this<KeepAliveTask> {
+ public:
+  using Step = absl::AnyInvocable<std::optional<absl::Duration>()>;
+
+  // Schedules the first step to run immediately.
+  static std::shared_ptr<KeepAliveTask> Start(
+      TimerWheel* timer_wheel, SingleThreadExecutor* executor, Step step,
+      absl::AnyInvocable<void()> on_done);
+
+  KeepAliveTask(const KeepAliveTask&) = delete;
+  KeepAliveTask& operator=(const KeepAliveTask&) = delete;
+  ~KeepAliveTask() = default;
+
+  // Cancels the pending step. If a step is running, blocks until it returns.
+  // |on_done| is not invoked after Stop().
+  void Stop() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  KeepAliveTask(TimerWheel* timer_wheel, SingleThreadExecutor* executor,
+                Step step, absl::AnyInvocable<void()> on_done);
+
+  void Post() ABSL_LOCKS_EXCLUDED(mutex_);
+  void Run() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  TimerWheel* const timer_wheel_;
+  SingleThreadExecutor* const executor_;
+  Step step_;
+  absl::AnyInvocable<void()> on_done_;
+
+  Mutex mutex_;
+  ConditionVariable step_done_{&mutex_};
+  TimerWheel::TimerId timer_id_ ABSL_GUARDED_BY(mutex_) =
+      TimerWheel::kInvalidTimerId;
+  bool running_ ABSL_GUARDED_BY(mutex_) = false;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_KEEP_ALIVE_TASK_H_
@@ -0,0 +1,127 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/keep_alive_task.h"
+
+#include <atomic>
+#include <memory>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_wheel.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+TEST(KeepAliveTaskTest, RunsStepsUntilDone) {
+  TimerWheel timer_wheel(absl::Milliseconds(1));
+  SingleThreadExecutor executor;
+  std::atomic<int> steps = 0;
+  CountDownLatch done(1);
+
+  std::shared_ptr<KeepAliveTask> task = KeepAliveTask::Start(
+      &timer_wheel, &executor,
+      [&steps]() -> std::optional<absl::Duration> {
+        if (++steps == 3) return std::nullopt;
+        return absl::Milliseconds(10);
+      },
+      [&done]() { done.CountDown(); });
+
+  EXPECT_TRUE(done.Await(kDefaultTimeout).result());
+  EXPECT_EQ(steps, 3);
+}
+
+TEST(KeepAliveTaskTest, StopCancelsPendingStep) {
+  TimerWheel timer_wheel(absl::Milliseconds(1));
+  SingleThreadExecutor executor;
+  std::atomic<int> steps = 0;
+  std::atomic<bool> on_done_called = false;
+  CountDownLatch first_step(1);
+
+  std::shared_ptr<KeepAliveTask> task = KeepAliveTask::Start(
+      &timer_wheel, &executor,
+      [&steps, &first_step]() -> std::optional<absl::Duration> {
+        steps++;
+        first_step.CountDown();
+        return absl::Milliseconds(100);
+      },
+      [&on_done_called]() { on_done_called = true; });
+  EXPECT_TRUE(first_step.Await(kDefaultTimeout).result());
+
+  task->Stop();
+  absl::SleepFor(absl::Milliseconds(200));
+
+  EXPECT_EQ(steps, 1);
+  EXPECT_FALSE(on_done_called);
+}
+
+TEST(KeepAliveTaskTest, StopWaitsForRunningStep) {
+  TimerWheel timer_wheel(absl::Milliseconds(1));
+  SingleThreadExecutor executor;
+  std::atomic<bool> step_finished = false;
+  CountDownLatch step_started(1);
+
+  std::shared_ptr<KeepAliveTask> task = KeepAliveTask::Start(
+      &timer_wheel, &executor,
+      [&step_finished, &step_started]() -> std::optional<absl::Duration> {
+        step_started.CountDown();
+        absl::SleepFor(absl::Milliseconds(100));
+        step_finished = true;
+        return absl::Milliseconds(10);
+      },
+      []() {});
+  EXPECT_TRUE(step_started.Await(kDefaultTimeout).result());
+
+  task->Stop();
+
+  EXPECT_TRUE(step_finished);
+}
+
+TEST(KeepAliveTaskTest, TasksShareOneExecutor) {
+  TimerWheel timer_wheel(absl::Milliseconds(1));
+  SingleThreadExecutor executor;
+  CountDownLatch done(2);
+  std::atomic<int> steps_a = 0;
+  std::atomic<int> steps_b = 0;
+
+  std::shared_ptr<KeepAliveTask> task_a = KeepAliveTask::Start(
+      &timer_wheel, &executor,
+      [&steps_a]() -> std::optional<absl::Duration> {
+        if (++steps_a == 2) return std::nullopt;
+        return absl::Milliseconds(10);
+      },
+      [&done]() { done.CountDown(); });
+  std::shared_ptr<KeepAliveTask> task_b = KeepAliveTask::Start(
+      &timer_wheel, &executor,
+      [&steps_b]() -> std::optional<absl::Duration> {
+        if (++steps_b == 4) return std::nullopt;
+        return absl::Milliseconds(5);
+      },
+      [&done]() { done.CountDown(); });
+
+  EXPECT_TRUE(done.Await(kDefaultTimeout).result());
+  EXPECT_EQ(steps_a, 2);
+  EXPECT_EQ(steps_b, 4);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
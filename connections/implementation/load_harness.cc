@@ -0,0 +1,450 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/load_harness.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <memory>
+#include <string>
+#include <system_error>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/bind_front.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "connections/implementation/offline_simulation_user.h"
+#include "connections/listeners.h"
+#include "connections/medium_selector.h"
+#include "connections/payload.h"
+#include "connections/payload_type.h"
+#include "connections/status.h"
+#include "connections/strategy.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/file.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/medium_environment.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/output_stream.h"
+#include "internal/platform/pipe.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr char kServiceId[] = "load-harness-service";
+constexpr std::int64_t kStreamChunkSize = 64 * 1024;
+
+// Collects what the users of one run observe.
+class LoadStats {
+ public:
+  LoadStats(int connections, int payloads)
+      : connected_latch_(connections), payload_latch_(payloads) {}
+
+  void OnConnected(absl::Duration time_to_connect) {
+    {
+      MutexLock lock(&mutex_);
+      connect_times_.push_back(time_to_connect);
+      last_connected_at_ = absl::Now();
+    }
+    connected_latch_.CountDown();
+  }
+
+  void OnConnectionFailed() { connected_latch_.CountDown(); }
+
+  void OnPayloadReceived(std::int64_t bytes) {
+    {
+      MutexLock lock(&mutex_);
+      ++payloads_received_;
+      bytes_received_ += bytes;
+      last_received_at_ = absl::Now();
+    }
+    payload_latch_.CountDown();
+  }
+
+  void OnPayloadFailed() { payload_latch_.CountDown(); }
+
+  bool AwaitConnections(absl::Duration timeout) {
+    return connected_latch_.Await(timeout).GetResult();
+  }
+
+  bool AwaitPayloads(absl::Duration timeout) {
+    return payload_latch_.Await(timeout).GetResult();
+  }
+
+  // Fills in the connection results, for connections requested at `start`.
+  void ReportConnections(absl::Time start, LoadReport& report) {
+    MutexLock lock(&mutex_);
+    report.connections_established = connect_times_.size();
+    if (connect_times_.empty()) return;
+    std::sort(connect_times_.begin(), connect_times_.end());
+    auto percentile = [this](int p) {
+      // Nearest rank.
+      size_t rank = (p * connect_times_.size() + 99) / 100;
+      return connect_times_[std::max<size_t>(rank, 1) - 1];
+    };
+    report.time_to_connect_p50 = percentile(50);
+    report.time_to_connect_p90 = percentile(90);
+    report.time_to_connect_p99 = percentile(99);
+    report.time_to_connect_max = connect_times_.back();
+    double seconds = absl::ToDoubleSeconds(last_connected_at_ - start);
+    if (seconds > 0) {
+      report.connections_per_second = connect_times_.size() / seconds;
+    }
+  }
+
+  // Fills in the payload results, for payloads sent from `start`.
+  void ReportPayloads(absl::Time start, LoadReport& report) {
+    MutexLock lock(&mutex_);
+    report.payloads_received = payloads_received_;
+    report.bytes_received = bytes_received_;
+    double seconds = absl::ToDoubleSeconds(last_received_at_ - start);
+    if (seconds > 0) {
+      report.megabytes_per_second = bytes_received_ / (1024.0 * 1024) / seconds;
+    }
+  }
+
+ private:
+  CountDownLatch connected_latch_;
+  CountDownLatch payload_latch_;
+  Mutex mutex_;
+  std::vector<absl::Duration> connect_times_ ABSL_GUARDED_BY(mutex_);
+  absl::Time last_connected_at_ ABSL_GUARDED_BY(mutex_);
+  int payloads_received_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::int64_t bytes_received_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::Time last_received_at_ ABSL_GUARDED_BY(mutex_);
+};
+
+// An OfflineSimulationUser that may be connected to many endpoints at once,
+// accepts every connection it is offered and reports to LoadStats.
+//
+// Connection requests and acceptances run on the user's own executor: the
+// listener callbacks run on the thread that would have to serve them.
+class LoadSimulationUser : public OfflineSimulationUser {
+ public:
+  LoadSimulationUser(absl::string_view device_name, const Strategy& strategy,
+                     BooleanMediumSelector mediums, LoadStats* stats)
+      : OfflineSimulationUser(device_name, mediums), stats_(stats) {
+    advertising_options_.strategy = strategy;
+    discovery_options_.strategy = strategy;
+    connection_options_.strategy = strategy;
+  }
+
+  Status StartAdvertising() {
+    return ctrl_.StartAdvertising(&client_, kServiceId, advertising_options_,
+                                  {
+                                      .endpoint_info = info_,
+                                      .listener = MakeConnectionListener(),
+                                  });
+  }
+
+  // Starts discovery, counting `found_latch` down once `target` is found.
+  Status StartDiscovery(const ByteArray& target, CountDownLatch* found_latch) {
+    {
+      MutexLock lock(&mutex_);
+      target_info_ = target;
+      target_found_latch_ = found_latch;
+    }
+    DiscoveryListener listener = {
+        .endpoint_found_cb =
+            absl::bind_front(&LoadSimulationUser::OnEndpointFound, this),
+    };
+    return ctrl_.StartDiscovery(&client_, kServiceId, discovery_options_,
+                                std::move(listener));
+  }
+
+  // Asynchronously requests a connection to the target passed to
+  // StartDiscovery().
+  void RequestConnection() {
+    executor_.Execute([this]() {
+      std::string endpoint_id;
+      {
+        MutexLock lock(&mutex_);
+        endpoint_id = target_endpoint_id_;
+        requested_at_ = absl::Now();
+      }
+      client_.AddCancellationFlag(endpoint_id);
+      Status status = ctrl_.RequestConnection(
+          &client_, endpoint_id,
+          {
+              .endpoint_info = info_,
+              .listener = MakeConnectionListener(),
+          },
+          connection_options_);
+      if (!status.Ok()) {
+        NEARBY_LOGS(WARNING) << "RequestConnection to " << endpoint_id
+                             << " failed: " << status.ToString();
+        stats_->OnConnectionFailed();
+      }
+    });
+  }
+
+  // Sends `payload` to the target passed to StartDiscovery().
+  void SendToTarget(Payload payload) {
+    std::string endpoint_id;
+    {
+      MutexLock lock(&mutex_);
+      endpoint_id = target_endpoint_id_;
+    }
+    ctrl_.SendPayload(&client_, {endpoint_id}, std::move(payload));
+  }
+
+  bool IsConnectedToTarget() {
+    std::string endpoint_id;
+    {
+      MutexLock lock(&mutex_);
+      endpoint_id = target_endpoint_id_;
+    }
+    return !endpoint_id.empty() && client_.IsConnectedToEndpoint(endpoint_id);
+  }
+
+  // Stops the user and removes the files it received.
+  void Shutdown() {
+    executor_.Shutdown();
+    Stop();
+    MutexLock lock(&mutex_);
+    incoming_payloads_.clear();
+    for (const std::string& path : received_files_) {
+      std::error_code error;
+      std::filesystem::remove(path, error);
+    }
+    received_files_.clear();
+  }
+
+ private:
+  ConnectionListener MakeConnectionListener() {
+    return {
+        .initiated_cb =
+            absl::bind_front(&LoadSimulationUser::OnInitiated, this),
+        .accepted_cb = absl::bind_front(&LoadSimulationUser::OnAccepted, this),
+        .rejected_cb = absl::bind_front(&LoadSimulationUser::OnRejected, this),
+    };
+  }
+
+  void OnEndpointFound(const std::string& endpoint_id,
+                       const ByteArray& endpoint_info,
+                       const std::string& service_id) {
+    MutexLock lock(&mutex_);
+    if (endpoint_info != target_info_ || !target_endpoint_id_.empty()) return;
+    target_endpoint_id_ = endpoint_id;
+    if (target_found_latch_) target_found_latch_->CountDown();
+  }
+
+  void OnInitiated(const std::string& endpoint_id,
+                   const ConnectionResponseInfo& info) {
+    executor_.Execute([this, endpoint_id]() {
+      PayloadListener listener = {
+          .payload_cb = absl::bind_front(&LoadSimulationUser::OnPayload, this),
+          .payload_progress_cb =
+              absl::bind_front(&LoadSimulationUser::OnPayloadProgress, this),
+      };
+      ctrl_.AcceptConnection(&client_, endpoint_id, std::move(listener));
+    });
+  }
+
+  void OnAccepted(const std::string& endpoint_id) {
+    absl::Time requested_at;
+    {
+      MutexLock lock(&mutex_);
+      // Only the requesting side reports the connection.
+      if (endpoint_id != target_endpoint_id_) return;
+      requested_at = requested_at_;
+    }
+    stats_->OnConnected(absl::Now() - requested_at);
+  }
+
+  void OnRejected(const std::string& endpoint_id, Status status) {
+    {
+      MutexLock lock(&mutex_);
+      if (endpoint_id != target_endpoint_id_) return;
+    }
+    NEARBY_LOGS(WARNING) << "Connection to " << endpoint_id
+                         << " rejected: " << status.ToString();
+    stats_->OnConnectionFailed();
+  }
+
+  void OnPayload(absl::string_view endpoint_id, Payload payload) {
+    MutexLock lock(&mutex_);
+    if (payload.GetType() == PayloadType::kFile) {
+      received_files_.push_back(payload.AsFile()->GetFilePath());
+    }
+    // Streams and files are still being written to, keep them open until
+    // they are complete.
+    Payload::Id id = payload.GetId();
+    incoming_payloads_.emplace(id, std::move(payload));
+  }
+
+  void OnPayloadProgress(absl::string_view endpoint_id,
+                         const PayloadProgressInfo& info) {
+    if (info.status == PayloadProgressInfo::Status::kInProgress) return;
+    {
+      MutexLock lock(&mutex_);
+      // Progress of outgoing payloads is reported here as well.
+      if (incoming_payloads_.erase(info.payload_id) == 0) return;
+    }
+    if (info.status == PayloadProgressInfo::Status::kSuccess) {
+      stats_->OnPayloadReceived(info.bytes_transferred);
+    } else {
+      stats_->OnPayloadFailed();
+    }
+  }
+
+  LoadStats* const stats_;
+  Mutex mutex_;
+  ByteArray target_info_ ABSL_GUARDED_BY(mutex_);
+  CountDownLatch* target_found_latch_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  std::string target_endpoint_id_ ABSL_GUARDED_BY(mutex_);
+  absl::Time requested_at_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<Payload::Id, Payload> incoming_payloads_
+      ABSL_GUARDED_BY(mutex_);
+  std::vector<std::string> received_files_ ABSL_GUARDED_BY(mutex_);
+  SingleThreadExecutor executor_;
+};
+
+std::string Percentage(int part, int whole) {
+  if (whole == 0) return "-";
+  return absl::StrFormat("%.1f%%", 100.0 * part / whole);
+}
+
+}  // namespace
+
+std::string LoadReport::ToString() const {
+  return absl::StrFormat(
+      "strategy=%s connections=%d/%d (%s) connections/s=%.2f "
+      "time_to_connect p50=%s p90=%s p99=%s max=%s payloads=%d/%d (%s) "
+      "bytes=%d MB/s=%.2f",
+      strategy.GetName(), connections_established, connections_requested,
+      Percentage(connections_established, connections_requested),
+      connections_per_second, absl::FormatDuration(time_to_connect_p50),
+      absl::FormatDuration(time_to_connect_p90),
+      absl::FormatDuration(time_to_connect_p99),
+      absl::FormatDuration(time_to_connect_max), payloads_received,
+      payloads_sent, Percentage(payloads_received, payloads_sent),
+      bytes_received, megabytes_per_second);
+}
+
+LoadReport RunLoad(const LoadHarnessOptions& options) {
+  LoadReport report;
+  report.strategy = options.strategy;
+  report.connections_requested = options.discoverers;
+  int payloads_per_connection =
+      options.bytes_payloads + options.file_payloads + options.stream_payloads;
+
+  MediumEnvironment& env = MediumEnvironment::Instance();
+  env.Start();
+  // Start() resets the environment, shaping included.
+  for (const auto& [medium, shaping] : options.link_shaping) {
+    env.SetLinkShaping(medium, shaping);
+  }
+
+  LoadStats stats(options.discoverers,
+                  options.discoverers * payloads_per_connection);
+  std::vector<std::unique_ptr<LoadSimulationUser>> advertisers;
+  std::vector<std::unique_ptr<LoadSimulationUser>> discoverers;
+  for (int i = 0; i < options.advertisers; ++i) {
+    advertisers.push_back(std::make_unique<LoadSimulationUser>(
+        absl::StrCat("advertiser-", i), options.strategy, options.mediums,
+        &stats));
+    advertisers.back()->StartAdvertising();
+  }
+  CountDownLatch found_latch(options.discoverers);
+  for (int i = 0; i < options.discoverers; ++i) {
+    discoverers.push_back(std::make_unique<LoadSimulationUser>(
+        absl::StrCat("discoverer-", i), options.strategy, options.mediums,
+        &stats));
+    discoverers.back()->StartDiscovery(
+        advertisers[i % options.advertisers]->GetInfo(), &found_latch);
+  }
+
+  if (!found_latch.Await(options.timeout).GetResult()) {
+    NEARBY_LOGS(WARNING) << "Not all advertisers were discovered in time";
+  } else {
+    // Connection storm: every discoverer requests its connection at once.
+    absl::Time connect_start = absl::Now();
+    for (auto& discoverer : discoverers) discoverer->RequestConnection();
+    if (!stats.AwaitConnections(options.timeout)) {
+      NEARBY_LOGS(WARNING) << "Not all connections completed in time";
+    }
+    stats.ReportConnections(connect_start, report);
+
+    absl::Time payload_start = absl::Now();
+    std::vector<std::unique_ptr<OutputStream>> stream_writers;
+    std::vector<std::string> sent_files;
+    for (auto& discoverer : discoverers) {
+      if (!discoverer->IsConnectedToTarget()) continue;
+      for (int i = 0; i < options.bytes_payloads; ++i) {
+        discoverer->SendToTarget(Payload(
+            ByteArray(static_cast<size_t>(options.bytes_payload_size))));
+      }
+      for (int i = 0; i < options.file_payloads; ++i) {
+        Payload::Id id = Payload::GenerateId();
+        std::string path = (std::filesystem::temp_directory_path() /
+                            absl::StrCat("nearby_load_", id))
+                               .string();
+        OutputFile file(path);
+        file.Write(ByteArray(static_cast<size_t>(options.file_payload_size)));
+        file.Close();
+        sent_files.push_back(path);
+        discoverer->SendToTarget(
+            Payload(id, InputFile(path, options.file_payload_size)));
+      }
+      for (int i = 0; i < options.stream_payloads; ++i) {
+        auto [input, output] = CreatePipe();
+        discoverer->SendToTarget(Payload(std::move(input)));
+        stream_writers.push_back(std::move(output));
+      }
+      report.payloads_sent += payloads_per_connection;
+    }
+    // Streams are written once all payloads are queued, so that they are
+    // transferred alongside the others.
+    for (auto& writer : stream_writers) {
+      for (std::int64_t written = 0; written < options.stream_payload_size;
+           written += kStreamChunkSize) {
+        writer->Write(ByteArray(static_cast<size_t>(std::min(
+            kStreamChunkSize, options.stream_payload_size - written))));
+      }
+      writer->Close();
+    }
+    if (!stats.AwaitPayloads(options.timeout)) {
+      NEARBY_LOGS(WARNING) << "Not all payloads were received in time";
+    }
+    stats.ReportPayloads(payload_start, report);
+    for (const std::string& path : sent_files) {
+      std::error_code error;
+      std::filesystem::remove(path, error);
+    }
+  }
+
+  for (auto& discoverer : discoverers) discoverer->Shutdown();
+  for (auto& advertiser : advertisers) advertiser->Shutdown();
+  discoverers.clear();
+  advertisers.clear();
+  env.Stop();
+  NEARBY_LOGS(INFO) << "Load report: " << report.ToString();
+  return report;
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,89 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_LOAD_HARNESS_H_
+#define CORE_INTERNAL_LOAD_HARNESS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "connections/medium_selector.h"
+#include "connections/strategy.h"
+#include "internal/platform/pipe.h"
+#include "proto/connections_enums.pb.h"
+
+// Test-only load harness for nearby connections.
+//
+// Runs a number of advertisers and discoverers as OfflineSimulationUsers on
+// top of MediumEnvironment, has every discoverer connect to an advertiser at
+// once, then sends a mix of payloads over every connection and reports how
+// fast that went.
+
+namespace nearby {
+namespace connections {
+
+struct LoadHarnessOptions {
+  int advertisers = 1;
+  // Discoverer i connects to advertiser i % advertisers. With
+  // kP2pPointToPoint there must be no more discoverers than advertisers.
+  int discoverers = 1;
+  Strategy strategy = Strategy::kP2pCluster;
+  BooleanMediumSelector mediums = BooleanMediumSelector{.wifi_lan = true};
+  // Latency and bandwidth of the sockets of each simulated medium.
+  absl::flat_hash_map<location::nearby::proto::connections::Medium,
+                      LinkShaping>
+      link_shaping;
+
+  // Payloads every discoverer sends to its advertiser once all are connected.
+  int bytes_payloads = 1;
+  std::int64_t bytes_payload_size = 1024;
+  int file_payloads = 0;
+  std::int64_t file_payload_size = 1024 * 1024;
+  int stream_payloads = 0;
+  std::int64_t stream_payload_size = 1024 * 1024;
+
+  // How long discovery, the connection storm and the payloads may take each.
+  absl::Duration timeout = absl::Seconds(30);
+};
+
+struct LoadReport {
+  Strategy strategy;
+  int connections_requested = 0;
+  int connections_established = 0;
+  double connections_per_second = 0;
+  // Time from RequestConnection() until the connection was accepted by both
+  // sides, over the established connections.
+  absl::Duration time_to_connect_p50 = absl::ZeroDuration();
+  absl::Duration time_to_connect_p90 = absl::ZeroDuration();
+  absl::Duration time_to_connect_p99 = absl::ZeroDuration();
+  absl::Duration time_to_connect_max = absl::ZeroDuration();
+  int payloads_sent = 0;
+  int payloads_received = 0;
+  std::int64_t bytes_received = 0;
+  double megabytes_per_second = 0;
+
+  std::string ToString() const;
+};
+
+// Runs a load test as described by `options` and returns its results. Starts
+// and stops MediumEnvironment, which must not be in use by anything else
+// meanwhile, and must not be using a simulated clock.
+LoadReport RunLoad(const LoadHarnessOptions& options);
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_LOAD_HARNESS_H_
@@ -0,0 +1,76 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/load_harness.h"
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "connections/medium_selector.h"
+#include "connections/strategy.h"
+#include "internal/platform/pipe.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+
+class LoadHarnessTest : public ::testing::TestWithParam<Strategy> {};
+
+TEST_P(LoadHarnessTest, ConnectsAllAndDeliversPayloadMix) {
+  LoadReport report = RunLoad({
+      .advertisers = 2,
+      .discoverers = 2,
+      .strategy = GetParam(),
+      .mediums = BooleanMediumSelector{.wifi_lan = true},
+      .bytes_payloads = 2,
+      .bytes_payload_size = 1024,
+      .file_payloads = 1,
+      .file_payload_size = 64 * 1024,
+      .stream_payloads = 1,
+      .stream_payload_size = 200 * 1024,
+  });
+
+  EXPECT_EQ(report.strategy, GetParam());
+  EXPECT_EQ(report.connections_requested, 2);
+  EXPECT_EQ(report.connections_established, 2);
+  EXPECT_GT(report.connections_per_second, 0);
+  EXPECT_LE(report.time_to_connect_p50, report.time_to_connect_max);
+  EXPECT_EQ(report.payloads_sent, 8);
+  EXPECT_EQ(report.payloads_received, 8);
+  EXPECT_EQ(report.bytes_received, 2 * (2 * 1024 + 64 * 1024 + 200 * 1024));
+  EXPECT_GT(report.megabytes_per_second, 0);
+}
+
+INSTANTIATE_TEST_SUITE_P(Strategies, LoadHarnessTest,
+                         ::testing::Values(Strategy::kP2pCluster,
+                                           Strategy::kP2pStar,
+                                           Strategy::kP2pPointToPoint));
+
+TEST(LoadHarnessShapingTest, LatencySlowsDownConnections) {
+  LoadReport report = RunLoad({
+      .link_shaping = {{Medium::WIFI_LAN,
+                        LinkShaping{.latency = absl::Milliseconds(50)}}},
+  });
+
+  EXPECT_EQ(report.connections_established, 1);
+  // The connection handshake takes several trips over the link.
+  EXPECT_GE(report.time_to_connect_p50, absl::Milliseconds(100));
+  EXPECT_EQ(report.payloads_received, 1);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,61 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/medium_throughput_history.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "internal/platform/mutex_lock.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+
+using ::location::nearby::proto::connections::Medium;
+
+void MediumThroughputHistory::Record(const std::string& endpoint_id,
+                                     Medium medium, std::int64_t bytes,
+                                     std::int64_t bytes_per_second) {
+  if (bytes < kMinSampleBytes || bytes_per_second <= 0) return;
+  MutexLock lock(&mutex_);
+  if (!endpoints_.contains(endpoint_id) && endpoints_.size() >= kMaxEndpoints) {
+    auto oldest = endpoints_.begin();
+    for (auto it = endpoints_.begin(); it != endpoints_.end(); ++it) {
+      if (it->second.last_update < oldest->second.last_update) oldest = it;
+    }
+    endpoints_.erase(oldest);
+  }
+  EndpointHistory& history = endpoints_[endpoint_id];
+  history.last_update = ++updates_;
+  auto [it, inserted] =
+      history.bytes_per_second.emplace(medium, bytes_per_second);
+  if (!inserted) {
+    it->second = (it->second + bytes_per_second) / 2;
+  }
+}
+
+std::optional<std::int64_t> MediumThroughputHistory::GetBytesPerSecond(
+    const std::string& endpoint_id, Medium medium) const {
+  MutexLock lock(&mutex_);
+  auto history = endpoints_.find(endpoint_id);
+  if (history == endpoints_.end()) return std::nullopt;
+  auto it = history->second.bytes_per_second.find(medium);
+  if (it == history->second.bytes_per_second.end()) return std::nullopt;
+  return it->second;
+}
+
+}  // namespace connections
+}  // namespace nearby
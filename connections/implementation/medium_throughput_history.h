@@ -0,0 +1,75 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_MEDIUM_THROUGHPUT_HISTORY_H_
+#define CORE_INTERNAL_MEDIUM_THROUGHPUT_HISTORY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "internal/platform/mutex.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+
+// Remembers the throughput each medium reached with an endpoint, so that the
+// next bandwidth upgrade with it can pick the medium that did best.
+//
+// Each medium keeps the mean of its previous estimate and the latest sample,
+// so one bad transfer doesn't outweigh the ones before it. Only the
+// |kMaxEndpoints| most recently updated endpoints are kept.
+class MediumThroughputHistory {
+ public:
+  static constexpr std::size_t kMaxEndpoints = 64;
+  // Links that carried less than this are too short-lived to judge by.
+  static constexpr std::int64_t kMinSampleBytes = 1024 * 1024;
+
+  // Records that |medium| carried |bytes| to |endpoint_id| at
+  // |bytes_per_second|.
+  void Record(const std::string& endpoint_id,
+              location::nearby::proto::connections::Medium medium,
+              std::int64_t bytes, std::int64_t bytes_per_second)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the estimated throughput of |medium| with |endpoint_id|, or
+  // nothing if it wasn't measured.
+  std::optional<std::int64_t> GetBytesPerSecond(
+      const std::string& endpoint_id,
+      location::nearby::proto::connections::Medium medium) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct EndpointHistory {
+    absl::flat_hash_map<location::nearby::proto::connections::Medium,
+                        std::int64_t>
+        bytes_per_second;
+    std::int64_t last_update = 0;
+  };
+
+  mutable Mutex mutex_;
+  absl::flat_hash_map<std::string, EndpointHistory> endpoints_
+      ABSL_GUARDED_BY(mutex_);
+  // Orders the updates, to find the least recently updated endpoint.
+  std::int64_t updates_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_MEDIUM_THROUGHPUT_HISTORY_H_
@@ -0,0 +1,68 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/medium_throughput_history.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+
+constexpr std::int64_t kBytes = MediumThroughputHistory::kMinSampleBytes;
+
+TEST(MediumThroughputHistoryTest, AveragesSamples) {
+  MediumThroughputHistory history;
+
+  EXPECT_FALSE(history.GetBytesPerSecond("ABCD", Medium::WIFI_LAN).has_value());
+  history.Record("ABCD", Medium::WIFI_LAN, kBytes, 1000);
+  EXPECT_EQ(history.GetBytesPerSecond("ABCD", Medium::WIFI_LAN), 1000);
+  history.Record("ABCD", Medium::WIFI_LAN, kBytes, 3000);
+  EXPECT_EQ(history.GetBytesPerSecond("ABCD", Medium::WIFI_LAN), 2000);
+  EXPECT_FALSE(
+      history.GetBytesPerSecond("ABCD", Medium::WIFI_DIRECT).has_value());
+  EXPECT_FALSE(history.GetBytesPerSecond("EFGH", Medium::WIFI_LAN).has_value());
+}
+
+TEST(MediumThroughputHistoryTest, IgnoresShortTransfers) {
+  MediumThroughputHistory history;
+
+  history.Record("ABCD", Medium::WIFI_LAN, kBytes - 1, 1000);
+
+  EXPECT_FALSE(history.GetBytesPerSecond("ABCD", Medium::WIFI_LAN).has_value());
+}
+
+TEST(MediumThroughputHistoryTest, EvictsLeastRecentlyUpdatedEndpoint) {
+  MediumThroughputHistory history;
+  for (int i = 0; i < MediumThroughputHistory::kMaxEndpoints; ++i) {
+    history.Record(absl::StrCat(i), Medium::WIFI_LAN, kBytes, 1000);
+  }
+  history.Record("0", Medium::WIFI_LAN, kBytes, 1000);
+
+  history.Record("new", Medium::WIFI_LAN, kBytes, 1000);
+
+  EXPECT_TRUE(history.GetBytesPerSecond("0", Medium::WIFI_LAN).has_value());
+  EXPECT_FALSE(history.GetBytesPerSecond("1", Medium::WIFI_LAN).has_value());
+  EXPECT_TRUE(history.GetBytesPerSecond("new", Medium::WIFI_LAN).has_value());
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -149,9 +149,13 @@ ErrorOr<bool> BleV2::StartAdvertising(const std::string& service_id,
   // Wrap the connections advertisement to the medium advertisement.
   ByteArray service_id_hash = mediums::bleutils::GenerateHash(
       service_id, mediums::BleAdvertisement::kServiceIdHashLength);
-  // Get psm value from L2CAP server if L2CAP is supported. Now just use the
-  // default value.
+  // Advertise the PSM of the L2CAP server socket, if the service accepts
+  // connections over L2CAP.
   int psm = mediums::BleAdvertisementHeader::kDefaultPsmValue;
+  if (const auto it = l2cap_server_sockets_.find(service_id);
+      it != l2cap_server_sockets_.end()) {
+    psm = it->second.GetPsm();
+  }
   mediums::BleAdvertisement medium_advertisement = {
       mediums::BleAdvertisement::Version::kV2,
       mediums::BleAdvertisement::SocketVersion::kV2,
@@ -259,6 +263,10 @@ bool BleV2::IsAdvertisingForLegacyDevice(const std::string& service_id) const {
   return IsAdvertisingForLegacyDeviceLocked(service_id);
 }
 
+int BleV2::GetInstantOnLostRestartsSaved() {
+  return instant_on_lost_manager_.GetRestartsSaved();
+}
+
 ErrorOr<bool> BleV2::StartLegacyAdvertising(
     const std::string& input_service_id, const std::string& local_endpoint_id,
     const std::string& fast_advertisement_service_uuid) {
@@ -529,14 +537,39 @@ ErrorOr<bool> BleV2::StartAcceptingConnections(
   auto owned_server_socket =
       server_sockets_.insert({service_id, std::move(server_socket)})
           .first->second;
+  auto shared_callback =
+      std::make_shared<AcceptedConnectionCallback>(std::move(callback));
+  StartAcceptLoopLocked(service_id, std::move(owned_server_socket),
+                        shared_callback);
+
+  if (FeatureFlags::GetInstance().GetFlags().enable_ble_l2cap_sockets) {
+    BleV2ServerSocket l2cap_server_socket =
+        medium_.OpenL2capServerSocket(service_id);
+    if (l2cap_server_socket.IsValid()) {
+      LOG(INFO) << "Accepting BLE connections for service_id=" << service_id
+                << " over L2CAP too, psm=" << l2cap_server_socket.GetPsm();
+      auto owned_l2cap_server_socket =
+          l2cap_server_sockets_
+              .insert({service_id, std::move(l2cap_server_socket)})
+              .first->second;
+      StartAcceptLoopLocked(service_id, std::move(owned_l2cap_server_socket),
+                            shared_callback);
+    }
+  }
+
+  return {true};
+}
 
+void BleV2::StartAcceptLoopLocked(
+    const std::string& service_id, BleV2ServerSocket server_socket,
+    std::shared_ptr<AcceptedConnectionCallback> callback) {
   // Start the accept loop on a dedicated thread - this stays alive and
   // listening for new incoming connections until StopAcceptingConnections() is
   // invoked.
   accept_loops_runner_.Execute(
       "ble-accept",
       [this, service_id = service_id, callback = std::move(callback),
-       server_socket = std::move(owned_server_socket)]() mutable {
+       server_socket = std::move(server_socket)]() mutable {
         while (true) {
           BleV2Socket client_socket = server_socket.Accept();
           if (!client_socket.IsValid()) {
@@ -552,13 +585,11 @@ ErrorOr<bool> BleV2::StartAcceptingConnections(
             });
             incoming_sockets_.insert({service_id, client_socket});
           }
-          if (callback) {
-            callback(std::move(client_socket), service_id);
+          if (*callback) {
+            (*callback)(std::move(client_socket), service_id);
           }
         }
       });
-
-  return {true};
 }
 
 bool BleV2::StopAcceptingConnections(const std::string& service_id) {
@@ -576,6 +607,12 @@ bool BleV2::StopAcceptingConnections(const std::string& service_id) {
   // That may take some time to complete, but there's no particular reason to
   // wait around for it.
   auto item = server_sockets_.extract(it);
+  if (auto l2cap_item = l2cap_server_sockets_.extract(service_id)) {
+    if (!l2cap_item.mapped().Close().Ok()) {
+      LOG(INFO) << "Failed to close Ble L2CAP server socket for service_id="
+                << service_id;
+    }
+  }
 
   // Store a handle to the BleServerSocket, so we can use it after
   // removing the entry from server_sockets_; making it scoped
@@ -626,6 +663,26 @@ ErrorOr<BleV2Socket> BleV2::Connect(const std::string& service_id,
                       CLIENT_CANCELLATION_CANCEL_BLE_OUTGOING_CONNECTION)};
   }
 
+  int psm = peripheral.GetPsm();
+  if (FeatureFlags::GetInstance().GetFlags().enable_ble_l2cap_sockets &&
+      psm != mediums::BleAdvertisementHeader::kDefaultPsmValue) {
+    socket = medium_.ConnectOverL2cap(
+        psm, service_id, PowerLevelToTxPowerLevel(PowerLevel::kHighPower),
+        peripheral, cancellation_flag);
+    if (socket.IsValid()) {
+      LOG(INFO) << "Connected via Ble L2CAP [service_id=" << service_id
+                << ", psm=" << psm << "]";
+      return socket;
+    }
+    if (cancellation_flag->Cancelled()) {
+      LOG(INFO) << "Can't create client Ble socket due to cancel.";
+      return {Error(OperationResultCode::
+                        CLIENT_CANCELLATION_CANCEL_BLE_OUTGOING_CONNECTION)};
+    }
+    LOG(INFO) << "Failed to connect via Ble L2CAP [service_id=" << service_id
+              << ", psm=" << psm << "], falling back to GATT.";
+  }
+
   socket = medium_.Connect(service_id,
                            PowerLevelToTxPowerLevel(PowerLevel::kHighPower),
                            peripheral, cancellation_flag);
@@ -854,9 +911,9 @@ ByteArray BleV2::CreateAdvertisementHeader(
       Utils::GenerateRandomBytes(kDummyServiceIdLength);
   std::string dummy_service_id{dummy_service_id_bytes};
 
-  mediums::BloomFilter bloom_filter(
-      std::make_unique<mediums::BitSetImpl<
-          mediums::BleAdvertisementHeader::kServiceIdBloomFilterByteLength>>());
+  mediums::BloomFilter<
+      mediums::BleAdvertisementHeader::kServiceIdBloomFilterByteLength>
+      bloom_filter;
   bloom_filter.Add(dummy_service_id);
 
   ByteArray advertisement_hash =
@@ -91,6 +91,10 @@ class BleV2 final {
   bool IsAdvertisingForLegacyDevice(const std::string& service_id) const
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Returns the number of instant on lost advertisement restarts spared by
+  // batching the stopped advertisements so far.
+  int GetInstantOnLostRestartsSaved();
+
   // Use dummy bytes to do ble advertising, only for legacy devices.
   // Returns true, if data is successfully set, and false otherwise.
   ErrorOr<bool> StartLegacyAdvertising(
@@ -233,9 +237,17 @@ class BleV2 final {
 
   api::ble_v2::TxPowerLevel PowerLevelToTxPowerLevel(PowerLevel power_level);
 
+  // Runs the accept loop of |server_socket| until it is closed.
+  void StartAcceptLoopLocked(
+      const std::string& service_id, BleV2ServerSocket server_socket,
+      std::shared_ptr<AcceptedConnectionCallback> callback)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   void RunOnBleThread(Runnable runnable);
 
-  static constexpr int kMaxConcurrentAcceptLoops = 5;
+  // Every service accepts connections over GATT and, with L2CAP sockets
+  // enabled, over L2CAP.
+  static constexpr int kMaxConcurrentAcceptLoops = 10;
 
   SingleThreadExecutor serial_executor_;
   ScheduledExecutor alarm_executor_;
@@ -274,6 +286,10 @@ class BleV2 final {
   // are currently listening for incoming connections.
   absl::flat_hash_map<std::string, BleV2ServerSocket> server_sockets_
       ABSL_GUARDED_BY(mutex_);
+  // The L2CAP server sockets of the services above, if the platform supports
+  // L2CAP channels. Their PSMs are advertised.
+  absl::flat_hash_map<std::string, BleV2ServerSocket> l2cap_server_sockets_
+      ABSL_GUARDED_BY(mutex_);
 
   // Tracks currently connected incoming sockets. This lets the device know when
   // it's okay to restart GATT server related operations.
@@ -0,0 +1,93 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/mediums/ble_v2/advertisement_cache.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "connections/implementation/mediums/ble_v2/ble_advertisement.h"
+#include "connections/implementation/mediums/ble_v2/ble_utils.h"
+#include "internal/platform/byte_array.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+
+AdvertisementCache::AdvertisementCache(int max_entries, std::size_t max_bytes)
+    : max_entries_(max_entries), max_bytes_(max_bytes) {}
+
+const AdvertisementCache::DecodedAdvertisement& AdvertisementCache::Decode(
+    const ByteArray& advertisement_bytes) {
+  if (max_entries_ <= 0) {
+    stats_.misses++;
+    uncached_ = DecodeUncached(advertisement_bytes);
+    return uncached_;
+  }
+
+  const auto it = index_.find(advertisement_bytes.AsStringView());
+  if (it != index_.end()) {
+    stats_.hits++;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return it->second->decoded;
+  }
+
+  stats_.misses++;
+  entries_.push_front(Entry{
+      .advertisement_bytes = std::string(advertisement_bytes),
+      .decoded = DecodeUncached(advertisement_bytes),
+  });
+  Entry& entry = entries_.front();
+  // The bytes are held twice, as the key and in the decoded advertisement.
+  entry.cost = sizeof(Entry) + 2 * entry.advertisement_bytes.size();
+  bytes_ += entry.cost;
+  index_.emplace(entry.advertisement_bytes, entries_.begin());
+  EvictOverflow();
+  return entries_.front().decoded;
+}
+
+void AdvertisementCache::Clear() {
+  index_.clear();
+  entries_.clear();
+  bytes_ = 0;
+}
+
+AdvertisementCache::DecodedAdvertisement AdvertisementCache::DecodeUncached(
+    const ByteArray& advertisement_bytes) {
+  return DecodedAdvertisement{
+      .advertisement =
+          BleAdvertisement::CreateBleAdvertisement(advertisement_bytes),
+      .advertisement_hash =
+          bleutils::GenerateAdvertisementHash(advertisement_bytes),
+  };
+}
+
+void AdvertisementCache::EvictOverflow() {
+  // Never evict the entry just added, even if it doesn't fit alone.
+  while (entries_.size() > 1 &&
+         (static_cast<int>(entries_.size()) > max_entries_ ||
+          bytes_ > max_bytes_)) {
+    Entry& entry = entries_.back();
+    index_.erase(entry.advertisement_bytes);
+    bytes_ -= entry.cost;
+    entries_.pop_back();
+    stats_.evictions++;
+  }
+}
+
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
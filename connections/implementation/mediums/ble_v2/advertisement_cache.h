@@ -0,0 +1,100 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_MEDIUMS_BLE_V2_ADVERTISEMENT_CACHE_H_
+#define CORE_INTERNAL_MEDIUMS_BLE_V2_ADVERTISEMENT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "connections/implementation/mediums/ble_v2/ble_advertisement.h"
+#include "internal/platform/byte_array.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+
+// Remembers the decoded form of the advertisement bytes seen last, so a
+// peripheral re-broadcasting the same bytes costs a hash lookup instead of a
+// parse and a SHA-256 hash.
+//
+// Entries are keyed by the raw bytes, and the least recently used ones are
+// evicted once the cache holds more than |max_entries| entries or
+// |max_bytes| bytes. A cache with |max_entries| 0 decodes every time.
+//
+// Not thread-safe; callers serialize the calls.
+class AdvertisementCache {
+ public:
+  struct DecodedAdvertisement {
+    absl::StatusOr<BleAdvertisement> advertisement;
+    // The hash of the advertisement bytes, as carried by the advertisement
+    // header of a fast advertisement.
+    ByteArray advertisement_hash;
+  };
+
+  struct Stats {
+    std::int64_t hits = 0;
+    std::int64_t misses = 0;
+    std::int64_t evictions = 0;
+  };
+
+  AdvertisementCache(int max_entries, std::size_t max_bytes);
+  AdvertisementCache(const AdvertisementCache&) = delete;
+  AdvertisementCache& operator=(const AdvertisementCache&) = delete;
+
+  // Returns the decoded advertisement bytes. The reference is valid until the
+  // next call.
+  const DecodedAdvertisement& Decode(const ByteArray& advertisement_bytes);
+
+  void Clear();
+
+  int GetSize() const { return static_cast<int>(index_.size()); }
+  std::size_t GetBytes() const { return bytes_; }
+  Stats GetStats() const { return stats_; }
+
+ private:
+  struct Entry {
+    std::string advertisement_bytes;
+    DecodedAdvertisement decoded;
+    std::size_t cost;
+  };
+
+  static DecodedAdvertisement DecodeUncached(
+      const ByteArray& advertisement_bytes);
+
+  void EvictOverflow();
+
+  const int max_entries_;
+  const std::size_t max_bytes_;
+
+  // Most recently used first.
+  std::list<Entry> entries_;
+  // Keyed by views of the bytes of entries_, whose nodes don't move.
+  absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator> index_;
+  std::size_t bytes_ = 0;
+  // The last decoded advertisement when caching is disabled.
+  DecodedAdvertisement uncached_;
+  Stats stats_;
+};
+
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_MEDIUMS_BLE_V2_ADVERTISEMENT_CACHE_H_
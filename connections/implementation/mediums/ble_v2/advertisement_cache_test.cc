@@ -0,0 +1,135 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/mediums/ble_v2/advertisement_cache.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "connections/implementation/mediums/ble_v2/ble_advertisement.h"
+#include "connections/implementation/mediums/ble_v2/ble_utils.h"
+#include "internal/platform/byte_array.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+namespace {
+
+constexpr absl::string_view kServiceIDHashBytes{"\x0a\x0b\x0c"};
+constexpr absl::string_view kDeviceToken{"\x04\x20"};
+
+ByteArray CreateAdvertisementBytes(const std::string& data) {
+  return ByteArray(BleAdvertisement(
+      BleAdvertisement::Version::kV2, BleAdvertisement::SocketVersion::kV2,
+      ByteArray(std::string(kServiceIDHashBytes)), ByteArray(data),
+      ByteArray(std::string(kDeviceToken))));
+}
+
+TEST(AdvertisementCacheTest, DecodesAdvertisement) {
+  AdvertisementCache cache(/*max_entries=*/4, /*max_bytes=*/4096);
+  ByteArray advertisement_bytes = CreateAdvertisementBytes("data");
+
+  const AdvertisementCache::DecodedAdvertisement& decoded =
+      cache.Decode(advertisement_bytes);
+
+  ASSERT_TRUE(decoded.advertisement.ok());
+  EXPECT_EQ(decoded.advertisement->GetData(), ByteArray(std::string("data")));
+  EXPECT_EQ(decoded.advertisement_hash,
+            bleutils::GenerateAdvertisementHash(advertisement_bytes));
+}
+
+TEST(AdvertisementCacheTest, RepeatedBytesHitTheCache) {
+  AdvertisementCache cache(/*max_entries=*/4, /*max_bytes=*/4096);
+
+  cache.Decode(CreateAdvertisementBytes("data"));
+  const AdvertisementCache::DecodedAdvertisement& decoded =
+      cache.Decode(CreateAdvertisementBytes("data"));
+
+  ASSERT_TRUE(decoded.advertisement.ok());
+  EXPECT_EQ(decoded.advertisement->GetData(), ByteArray(std::string("data")));
+  EXPECT_EQ(cache.GetSize(), 1);
+  EXPECT_EQ(cache.GetStats().hits, 1);
+  EXPECT_EQ(cache.GetStats().misses, 1);
+}
+
+TEST(AdvertisementCacheTest, CachesInvalidAdvertisements) {
+  AdvertisementCache cache(/*max_entries=*/4, /*max_bytes=*/4096);
+  ByteArray invalid_bytes(std::string("\xff"));
+
+  EXPECT_FALSE(cache.Decode(invalid_bytes).advertisement.ok());
+  EXPECT_FALSE(cache.Decode(invalid_bytes).advertisement.ok());
+  EXPECT_EQ(cache.GetStats().hits, 1);
+}
+
+TEST(AdvertisementCacheTest, EvictsLeastRecentlyUsedEntry) {
+  AdvertisementCache cache(/*max_entries=*/2, /*max_bytes=*/4096);
+
+  cache.Decode(CreateAdvertisementBytes("a"));
+  cache.Decode(CreateAdvertisementBytes("b"));
+  // Makes "b" the least recently used entry.
+  cache.Decode(CreateAdvertisementBytes("a"));
+  cache.Decode(CreateAdvertisementBytes("c"));
+
+  EXPECT_EQ(cache.GetSize(), 2);
+  EXPECT_EQ(cache.GetStats().evictions, 1);
+  cache.Decode(CreateAdvertisementBytes("a"));
+  EXPECT_EQ(cache.GetStats().hits, 2);
+  cache.Decode(CreateAdvertisementBytes("b"));
+  EXPECT_EQ(cache.GetStats().hits, 2);
+}
+
+TEST(AdvertisementCacheTest, BoundsCachedBytes) {
+  AdvertisementCache cache(/*max_entries=*/100, /*max_bytes=*/1024);
+
+  for (int i = 0; i < 100; i++) {
+    cache.Decode(CreateAdvertisementBytes(std::string(100, 'a' + i % 26) +
+                                          std::to_string(i)));
+    EXPECT_LE(cache.GetBytes(), 1024);
+  }
+  EXPECT_GT(cache.GetSize(), 0);
+  EXPECT_LT(cache.GetSize(), 100);
+  EXPECT_EQ(cache.GetStats().evictions, 100 - cache.GetSize());
+}
+
+TEST(AdvertisementCacheTest, ZeroEntriesDisablesCaching) {
+  AdvertisementCache cache(/*max_entries=*/0, /*max_bytes=*/4096);
+
+  cache.Decode(CreateAdvertisementBytes("data"));
+  const AdvertisementCache::DecodedAdvertisement& decoded =
+      cache.Decode(CreateAdvertisementBytes("data"));
+
+  ASSERT_TRUE(decoded.advertisement.ok());
+  EXPECT_EQ(decoded.advertisement->GetData(), ByteArray(std::string("data")));
+  EXPECT_EQ(cache.GetSize(), 0);
+  EXPECT_EQ(cache.GetStats().hits, 0);
+  EXPECT_EQ(cache.GetStats().misses, 2);
+}
+
+TEST(AdvertisementCacheTest, ClearDropsEntries) {
+  AdvertisementCache cache(/*max_entries=*/4, /*max_bytes=*/4096);
+
+  cache.Decode(CreateAdvertisementBytes("data"));
+  cache.Clear();
+
+  EXPECT_EQ(cache.GetSize(), 0);
+  EXPECT_EQ(cache.GetBytes(), 0);
+  cache.Decode(CreateAdvertisementBytes("data"));
+  EXPECT_EQ(cache.GetStats().misses, 2);
+}
+
+}  // namespace
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
@@ -15,81 +15,92 @@
 #ifndef CORE_INTERNAL_MEDIUMS_BLE_V2_BLOOM_FILTER_H_
 #define CORE_INTERNAL_MEDIUMS_BLE_V2_BLOOM_FILTER_H_
 
-#include <bitset>
-#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 
+#include "absl/strings/string_view.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/logging.h"
 
 namespace nearby {
 namespace connections {
 namespace mediums {
 
-// Interface to set bits of the given bit array, by inserting a user element.
-class BitSet {
- public:
-  virtual ~BitSet() = default;
-
-  // Gets a binary string representation of the bitset where the leftmost
-  // character corresponds to bitset position (total size) - 1.
-  //
-  // If the bitset's internal representation is:
-  //     [position 0]     0 0 1 1 0 0 0 1 0 1 0 1     [position 11]
-  // The string representation will be outputted like this:
-  //                     "1 0 1 0 1 0 0 0 1 1 0 0"
-  virtual std::string ToString() const = 0;
-  virtual void Set(size_t pos, bool value) = 0;
-  virtual bool Test(size_t pos) const = 0;
-  virtual size_t Size() const = 0;
-};
+namespace bloom_filter_internal {
 
-// A bloom filter that gives access to the underlying BitSet. The implementation
-// is copied from our Java version of Bloom filter, which in turn copies from
-// Guava's BloomFilter.
-class BloomFilter {
- public:
-  // Constructs by injecting BitSet implementation. The bit_set will be default
-  // zero-out.
-  explicit BloomFilter(std::unique_ptr<BitSet> bit_set)
-      : BloomFilter(std::move(bit_set), {}) {}
-
-  // Constructs by injecting BitSet implementation with bytes of other
-  // BloomFilter. The `bit_set` will be filled with the bit_set of other
-  // BloomFilter.
-  //
-  // Note: The capacity size of current bit_set should be the same as the one
-  // of other BloomFilter, or there is no impact and fallback to the first
-  // constructor.
-  BloomFilter(std::unique_ptr<BitSet> bit_set, const ByteArray& bytes);
-  BloomFilter(BloomFilter&& other) = default;
-  BloomFilter& operator=(BloomFilter&& other) = default;
+inline constexpr int kHasherNumberOfRepetitions = 5;
 
-  explicit operator ByteArray() const;
+// Returns the non-negative hashes whose positions modulo the filter size are
+// the bits of |s|.
+std::array<std::int32_t, kHasherNumberOfRepetitions> GetHashes(
+    absl::string_view s);
 
-  void Add(const std::string& s);
-  bool PossiblyContains(const std::string& s);
+}  // namespace bloom_filter_internal
 
- private:
-  std::vector<std::int32_t> GetHashes(const std::string& s);
-  int GetMinBytesForBits() const { return (bit_set_->Size() + 7) >> 3; }
-
-  std::unique_ptr<BitSet> bit_set_;
-};
-
-// A default bit set implementation.
+// A bloom filter of CapacityInBytes bytes. The implementation is copied from
+// our Java version of Bloom filter, which in turn copies from Guava's
+// BloomFilter.
 //
-// It is templatized on the size of the byte array and not the size of
-// the bit set to ensure the bit set's length is a multiple of 8 (and can
-// neatly be returned as a ByteArray).
+// It is templatized on the size of the byte array and not the size of the bit
+// set to ensure the bit set's length is a multiple of 8 (and can neatly be
+// returned as a ByteArray). The bits are stored in their serialized layout,
+// bit i being bit (i % 8) of byte (i / 8), so the filter converts from and to
+// a ByteArray with a copy, and never allocates otherwise.
 template <size_t CapacityInBytes>
-class BitSetImpl final : public BitSet {
+class BloomFilter {
  public:
-  std::string ToString() const override { return bits_.to_string(); }
-  void Set(size_t pos, bool value) override { bits_.set(pos, value); }
-  bool Test(size_t pos) const override { return bits_.test(pos); }
-  size_t Size() const override { return bits_.size(); }
+  // Constructs a zeroed-out filter.
+  BloomFilter() = default;
+
+  // Constructs with the bytes of another BloomFilter.
+  //
+  // Note: The size of bytes should be CapacityInBytes, or there is no impact
+  // and fallback to the first constructor.
+  explicit BloomFilter(const ByteArray& bytes) {
+    if (bytes.size() == 0) {
+      // Ignore it; we don't need to copy the bit for the empty bytes.
+      return;
+    }
+    // If the size is not matched, fall out.
+    if (bytes.size() != CapacityInBytes) {
+      NEARBY_LOGS(INFO) << "Cannot construct from bytes since the size is not "
+                           "matched. bytes.size(x8) = "
+                        << bytes.size() << ", bit_set.size=" << kSizeInBits;
+      return;
+    }
+    for (size_t i = 0; i < CapacityInBytes; i++) {
+      bytes_[i] = static_cast<std::uint8_t>(bytes.data()[i]);
+    }
+  }
+
+  explicit operator ByteArray() const {
+    return ByteArray(reinterpret_cast<const char*>(bytes_.data()),
+                     CapacityInBytes);
+  }
+
+  void Add(absl::string_view s) {
+    for (std::int32_t hash : bloom_filter_internal::GetHashes(s)) {
+      size_t position = static_cast<size_t>(hash) % kSizeInBits;
+      bytes_[position >> 3] |= 1 << (position & 7);
+    }
+  }
+
+  bool PossiblyContains(absl::string_view s) const {
+    for (std::int32_t hash : bloom_filter_internal::GetHashes(s)) {
+      size_t position = static_cast<size_t>(hash) % kSizeInBits;
+      if ((bytes_[position >> 3] & (1 << (position & 7))) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
 
  private:
-  std::bitset<CapacityInBytes * 8> bits_;
+  static constexpr size_t kSizeInBits = CapacityInBytes * 8;
+
+  std::array<std::uint8_t, CapacityInBytes> bytes_ = {};
 };
 
 }  // namespace mediums
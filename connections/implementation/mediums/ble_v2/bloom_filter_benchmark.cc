@@ -0,0 +1,73 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/string_view.h"
+#include "connections/implementation/mediums/ble_v2/ble_advertisement_header.h"
+#include "connections/implementation/mediums/ble_v2/bloom_filter.h"
+#include "internal/platform/byte_array.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+namespace {
+
+// The filter size of the service id bloom filter in BLE advertisement
+// headers, which is what the medium builds and parses.
+using ServiceIdBloomFilter =
+    BloomFilter<BleAdvertisementHeader::kServiceIdBloomFilterByteLength>;
+
+constexpr std::array<absl::string_view, 4> kServiceIds = {
+    "com.google.location.nearby.apps.helloworld",
+    "com.google.location.nearby.apps.fileshare",
+    "NearbySharing",
+    "com.google.android.gms.nearby.fastpair",
+};
+
+// What an advertising device does for every advertisement header it builds.
+void BM_AddAndSerialize(benchmark::State& state) {
+  for (auto _ : state) {
+    ServiceIdBloomFilter bloom_filter;
+    for (absl::string_view service_id : kServiceIds) {
+      bloom_filter.Add(service_id);
+    }
+    ByteArray bytes(bloom_filter);
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_AddAndSerialize);
+
+// What a scanning device does for every advertisement header it reads: the
+// filter is parsed and probed with each service id being discovered.
+void BM_ParseAndLookUp(benchmark::State& state) {
+  ServiceIdBloomFilter advertised;
+  advertised.Add(kServiceIds[0]);
+  advertised.Add(kServiceIds[1]);
+  ByteArray bytes(advertised);
+
+  for (auto _ : state) {
+    ServiceIdBloomFilter bloom_filter(bytes);
+    for (absl::string_view service_id : kServiceIds) {
+      benchmark::DoNotOptimize(bloom_filter.PossiblyContains(service_id));
+    }
+  }
+}
+BENCHMARK(BM_ParseAndLookUp);
+
+}  // namespace
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
@@ -26,7 +26,7 @@ namespace {
 constexpr size_t kByteArrayLength = 100;
 
 TEST(BloomFilterTest, EmptyFilterReturnsEmptyArray) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   ByteArray bloom_filter_bytes(bloom_filter);
   std::string empty_string(kByteArrayLength, '\0');
@@ -35,7 +35,7 @@ TEST(BloomFilterTest, EmptyFilterReturnsEmptyArray) {
 }
 
 TEST(BloomFilterTest, EmptyFilterNeverContains) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   EXPECT_FALSE(bloom_filter.PossiblyContains("ELEMENT_1"));
   EXPECT_FALSE(bloom_filter.PossiblyContains("ELEMENT_2"));
@@ -43,7 +43,7 @@ TEST(BloomFilterTest, EmptyFilterNeverContains) {
 }
 
 TEST(BloomFilterTest, AddSuccess) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   EXPECT_FALSE(bloom_filter.PossiblyContains("ELEMENT_1"));
 
@@ -53,7 +53,7 @@ TEST(BloomFilterTest, AddSuccess) {
 }
 
 TEST(BloomFilterTest, AddOnlyGivenArg) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   bloom_filter.Add("ELEMENT_1");
 
@@ -63,7 +63,7 @@ TEST(BloomFilterTest, AddOnlyGivenArg) {
 }
 
 TEST(BloomFilterTest, AddMultipleArgs) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   bloom_filter.Add("ELEMENT_1");
   bloom_filter.Add("ELEMENT_2");
@@ -74,7 +74,7 @@ TEST(BloomFilterTest, AddMultipleArgs) {
 }
 
 TEST(BloomFilterTest, AddMultipleArgsReturnsNonemptyArray) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<10>>());
+  BloomFilter<10> bloom_filter;
 
   bloom_filter.Add("ELEMENT_1");
   bloom_filter.Add("ELEMENT_2");
@@ -86,22 +86,33 @@ TEST(BloomFilterTest, AddMultipleArgsReturnsNonemptyArray) {
   EXPECT_NE(std::string(bloom_filter_bytes), empty_string);
 }
 
+TEST(BloomFilterTest, SerializesBitsInAdvertisedLayout) {
+  BloomFilter<10> bloom_filter;
+
+  bloom_filter.Add("ELEMENT_1");
+  bloom_filter.Add("ELEMENT_2");
+
+  // Bit i is bit (i % 8) of byte (i / 8), as remote devices expect.
+  EXPECT_EQ(std::string(ByteArray(bloom_filter)),
+            std::string("\x00\x10\x14\x20\x04\x04\x04\x60\x00\x00", 10));
+}
+
 TEST(BloomFilterTest, MoveConstructorSuccess) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   bloom_filter.Add("ELEMENT_1");
 
-  BloomFilter bloom_filter_move{std::move(bloom_filter)};
+  BloomFilter<kByteArrayLength> bloom_filter_move{std::move(bloom_filter)};
 
   EXPECT_TRUE(bloom_filter_move.PossiblyContains("ELEMENT_1"));
 }
 
 TEST(BloomFilterTest, MoveAssignmentSuccess) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   bloom_filter.Add("ELEMENT_1");
 
-  BloomFilter bloom_filter_move = std::move(bloom_filter);
+  BloomFilter<kByteArrayLength> bloom_filter_move = std::move(bloom_filter);
 
   EXPECT_TRUE(bloom_filter_move.PossiblyContains("ELEMENT_1"));
 }
@@ -118,7 +129,7 @@ TEST(BloomFilterTest, MoveAssignmentSuccess) {
  * something like [ 0, 1, 0, 0, 1, 1, 0, 0, 0, 1, ..., 1, 0].
  */
 TEST(BloomFilterTest, RandomnessNoEndBias) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   // Add one element to our BloomFilter.
   bloom_filter.Add("ELEMENT_1");
@@ -162,7 +173,7 @@ TEST(BloomFilterTest, RandomnessNoEndBias) {
 }
 
 TEST(BloomFilterTest, RandomnessFalsePositiveRate) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   // Add 5 distinct elements to the BloomFilter.
   bloom_filter.Add("ELEMENT_1");
@@ -185,13 +196,12 @@ TEST(BloomFilterTest, RandomnessFalsePositiveRate) {
 }
 
 TEST(BloomFilterTest, ConstructWithNonEmptyByteArrayWorks) {
-  BloomFilter bloom_filter(std::make_unique<BitSetImpl<kByteArrayLength>>());
+  BloomFilter<kByteArrayLength> bloom_filter;
 
   bloom_filter.Add("ELEMENT_1");
   ByteArray original_bloom_filter_bytes(bloom_filter);
 
-  BloomFilter bloom_filter_inherited(
-      std::make_unique<BitSetImpl<kByteArrayLength>>(),
+  BloomFilter<kByteArrayLength> bloom_filter_inherited(
       original_bloom_filter_bytes);
 
   EXPECT_TRUE(bloom_filter_inherited.PossiblyContains("ELEMENT_1"));
@@ -199,14 +209,12 @@ TEST(BloomFilterTest, ConstructWithNonEmptyByteArrayWorks) {
 
 TEST(BloomFilterTest, ConstructLongByteArrayFails) {
   // Make 1 more byte in original BloomFilter.
-  BloomFilter bloom_filter(
-      std::make_unique<BitSetImpl<kByteArrayLength + 1>>());
+  BloomFilter<kByteArrayLength + 1> bloom_filter;
 
   bloom_filter.Add("ELEMENT_1");
   ByteArray original_bloom_filter_bytes(bloom_filter);
 
-  BloomFilter bloom_filter_inherited(
-      std::make_unique<BitSetImpl<kByteArrayLength>>(),
+  BloomFilter<kByteArrayLength> bloom_filter_inherited(
       original_bloom_filter_bytes);
 
   EXPECT_FALSE(bloom_filter_inherited.PossiblyContains("ELEMENT_1"));
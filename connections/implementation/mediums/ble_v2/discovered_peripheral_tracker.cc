@@ -15,8 +15,10 @@
 #include "connections/implementation/mediums/ble_v2/discovered_peripheral_tracker.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -51,29 +53,41 @@ namespace nearby {
 namespace connections {
 namespace mediums {
 namespace {
-constexpr int kGattThreadCount = 1;
 constexpr absl::Duration kInstantLostAdvertisementTimeout = absl::Seconds(60);
 }  // namespace
 
 DiscoveredPeripheralTracker::DiscoveredPeripheralTracker(
     bool is_extended_advertisement_available)
     : is_extended_advertisement_available_(
-          is_extended_advertisement_available) {
+          is_extended_advertisement_available),
+      max_in_flight_gatt_fetches_(std::max<int>(
+          1, FeatureFlags::GetInstance()
+                 .GetFlags()
+                 .ble_v2_gatt_fetch_max_concurrency)),
+      advertisement_cache_(FeatureFlags::GetInstance()
+                               .GetFlags()
+                               .ble_v2_advertisement_cache_max_entries,
+                           FeatureFlags::GetInstance()
+                               .GetFlags()
+                               .ble_v2_advertisement_cache_max_bytes) {
   if (NearbyFlags::GetInstance().GetBoolFlag(
           config_package_nearby::nearby_connections_feature::
               kEnableGattQueryInThread)) {
-    executor_ = std::make_unique<MultiThreadExecutor>(kGattThreadCount);
+    executor_ =
+        std::make_unique<MultiThreadExecutor>(max_in_flight_gatt_fetches_);
   }
 }
 
 DiscoveredPeripheralTracker::~DiscoveredPeripheralTracker() {
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::
-              kEnableGattQueryInThread)) {
+  // Reads running in a thread lock mutex_ when they complete, so shut down
+  // without holding it.
+  std::unique_ptr<MultiThreadExecutor> executor;
+  {
     MutexLock lock(&mutex_);
-    if (executor_ != nullptr) {
-      executor_->Shutdown();
-    }
+    executor = std::move(executor_);
+  }
+  if (executor != nullptr) {
+    executor->Shutdown();
   }
 }
 
@@ -88,7 +102,8 @@ void DiscoveredPeripheralTracker::StartTracking(
           std::move(discovered_peripheral_callback),
       .lost_entity_tracker =
           std::make_unique<LostEntityTracker<BleAdvertisement>>(),
-      .fast_advertisement_service_uuid = fast_advertisement_service_uuid};
+      .fast_advertisement_service_uuid = fast_advertisement_service_uuid,
+      .service_id_hash = bleutils::GenerateServiceIdHash(service_id)};
 
   // Replace if key exists.
   service_id_infos_.insert_or_assign(service_id, std::move(service_id_info));
@@ -171,47 +186,50 @@ bool DiscoveredPeripheralTracker::HandleOnLostAdvertisementLocked(
             << absl::BytesToHexString(on_lost_advertisement->ToBytes());
 
   for (const auto& hash : on_lost_advertisement->hashes()) {
-    for (const auto& it : gatt_advertisement_infos_) {
-      if (it.second.advertisement_header.GetAdvertisementHash().string_data() ==
-          hash) {
-        auto discovery_cb_it = service_id_infos_.find(it.second.service_id);
-        if (discovery_cb_it == service_id_infos_.end()) {
-          LOG(INFO)
-              << __func__
-              << ": Discarding OnLost advertisement for untracked service_id";
-          break;
-        }
-
-        auto gatt_advertisements =
-            gatt_advertisements_[it.second.advertisement_header];
-
-        // Need to report OnLost for each gatt_advertisement.
-        for (const auto& gatt_advertisement : gatt_advertisements) {
-          BleV2Peripheral lost_peripheral = it.second.peripheral;
-          lost_peripheral.SetId(ByteArray(gatt_advertisement));
-          if (gatt_advertisement.IsValid()) {
-            if (NearbyFlags::GetInstance().GetBoolFlag(
-                    config_package_nearby::nearby_connections_feature::
-                        kEnableInstantOnLost)) {
-              AddInstantLostAdvertisement(it.second.advertisement_header);
-              discovery_cb_it->second.discovered_peripheral_callback
-                  .instant_lost_cb(lost_peripheral, it.second.service_id,
-                                   gatt_advertisement.GetData(),
-                                   gatt_advertisement.IsFastAdvertisement());
-            } else {
-              discovery_cb_it->second.discovered_peripheral_callback
-                  .peripheral_lost_cb(lost_peripheral, it.second.service_id,
-                                      gatt_advertisement.GetData(),
-                                      gatt_advertisement.IsFastAdvertisement());
-            }
-            LOG(INFO) << __func__ << ": OnLost triggered for service_id "
-                      << it.second.service_id;
-          }
+    const auto hash_it = gatt_advertisements_by_hash_.find(hash);
+    if (hash_it == gatt_advertisements_by_hash_.end()) {
+      continue;
+    }
+    const auto gai_it =
+        gatt_advertisement_infos_.find(*hash_it->second.begin());
+    if (gai_it == gatt_advertisement_infos_.end()) {
+      continue;
+    }
+    // Copied, since the GATT advertisements are cleared below.
+    GattAdvertisementInfo info = gai_it->second;
+    auto discovery_cb_it = service_id_infos_.find(info.service_id);
+    if (discovery_cb_it == service_id_infos_.end()) {
+      LOG(INFO) << __func__
+                << ": Discarding OnLost advertisement for untracked service_id";
+      continue;
+    }
 
-          ClearGattAdvertisement(gatt_advertisement);
+    auto gatt_advertisements = gatt_advertisements_[info.advertisement_header];
+
+    // Need to report OnLost for each gatt_advertisement.
+    for (const auto& gatt_advertisement : gatt_advertisements) {
+      BleV2Peripheral lost_peripheral = info.peripheral;
+      lost_peripheral.SetId(ByteArray(gatt_advertisement));
+      if (gatt_advertisement.IsValid()) {
+        if (NearbyFlags::GetInstance().GetBoolFlag(
+                config_package_nearby::nearby_connections_feature::
+                    kEnableInstantOnLost)) {
+          AddInstantLostAdvertisement(info.advertisement_header);
+          discovery_cb_it->second.discovered_peripheral_callback
+              .instant_lost_cb(lost_peripheral, info.service_id,
+                               gatt_advertisement.GetData(),
+                               gatt_advertisement.IsFastAdvertisement());
+        } else {
+          discovery_cb_it->second.discovered_peripheral_callback
+              .peripheral_lost_cb(lost_peripheral, info.service_id,
+                                  gatt_advertisement.GetData(),
+                                  gatt_advertisement.IsFastAdvertisement());
         }
-        break;
+        LOG(INFO) << __func__ << ": OnLost triggered for service_id "
+                  << info.service_id;
       }
+
+      ClearGattAdvertisement(gatt_advertisement);
     }
   }
   return true;
@@ -248,6 +266,12 @@ void DiscoveredPeripheralTracker::ProcessLostGattAdvertisements() {
 
   LOG(INFO) << __func__ << ": Lost " << lost_count
             << " GATT advertisements due to peripheral timeout.";
+  AdvertisementCache::Stats cache_stats = advertisement_cache_.GetStats();
+  VLOG(1) << __func__ << ": Advertisement cache holds "
+          << advertisement_cache_.GetSize() << " advertisements in "
+          << advertisement_cache_.GetBytes() << " bytes, "
+          << cache_stats.hits << " hits, " << cache_stats.misses
+          << " misses, " << cache_stats.evictions << " evictions.";
 }
 
 void DiscoveredPeripheralTracker::ClearDataForServiceId(
@@ -287,6 +311,8 @@ void DiscoveredPeripheralTracker::ClearGattAdvertisement(
   }
   auto item = gatt_advertisement_infos_.extract(gai_it);
   GattAdvertisementInfo& gatt_advertisement_info = item.mapped();
+  RemoveFromAdvertisementHashIndex(
+      gatt_advertisement, gatt_advertisement_info.advertisement_header);
 
   const auto ga_it =
       gatt_advertisements_.find(gatt_advertisement_info.advertisement_header);
@@ -309,6 +335,36 @@ void DiscoveredPeripheralTracker::ClearGattAdvertisement(
   }
 }
 
+void DiscoveredPeripheralTracker::SetGattAdvertisementInfo(
+    const BleAdvertisement& gatt_advertisement,
+    GattAdvertisementInfo gatt_advertisement_info) {
+  auto [it, inserted] = gatt_advertisement_infos_.try_emplace(
+      gatt_advertisement, GattAdvertisementInfo{});
+  if (!inserted) {
+    RemoveFromAdvertisementHashIndex(gatt_advertisement,
+                                     it->second.advertisement_header);
+  }
+  gatt_advertisements_by_hash_[std::string(
+                                   gatt_advertisement_info.advertisement_header
+                                       .GetAdvertisementHash())]
+      .insert(gatt_advertisement);
+  it->second = std::move(gatt_advertisement_info);
+}
+
+void DiscoveredPeripheralTracker::RemoveFromAdvertisementHashIndex(
+    const BleAdvertisement& gatt_advertisement,
+    const BleAdvertisementHeader& advertisement_header) {
+  const auto it = gatt_advertisements_by_hash_.find(
+      std::string(advertisement_header.GetAdvertisementHash()));
+  if (it == gatt_advertisements_by_hash_.end()) {
+    return;
+  }
+  it->second.erase(gatt_advertisement);
+  if (it->second.empty()) {
+    gatt_advertisements_by_hash_.erase(it);
+  }
+}
+
 void DiscoveredPeripheralTracker::HandleAdvertisement(
     BleV2Peripheral peripheral,
     const nearby::api::ble_v2::BleAdvertisementData& advertisement_data) {
@@ -342,8 +398,8 @@ void DiscoveredPeripheralTracker::HandleAdvertisement(
 
   // Create a header tied to this fast advertisement. This helps us track the
   // advertisement when reporting it as lost or connecting.
-  BleAdvertisementHeader advertisement_header =
-      CreateAdvertisementHeader(advertisement_bytes);
+  BleAdvertisementHeader advertisement_header = CreateAdvertisementHeader(
+      advertisement_cache_.Decode(advertisement_bytes).advertisement_hash);
 
   // Process the fast advertisement like we would a GATT advertisement and
   // insert a placeholder AdvertisementReadResult.
@@ -374,17 +430,15 @@ ByteArray DiscoveredPeripheralTracker::ExtractInterestingAdvertisementBytes(
 }
 
 BleAdvertisementHeader DiscoveredPeripheralTracker::CreateAdvertisementHeader(
-    const ByteArray& advertisement_bytes) {
+    const ByteArray& advertisement_hash) {
   // Our end goal is to have a fully zeroed-out byte array of the correct
   // length representing an empty bloom filter.
-  BloomFilter bloom_filter(
-      std::make_unique<BitSetImpl<
-          BleAdvertisementHeader::kServiceIdBloomFilterByteLength>>());
+  BloomFilter<BleAdvertisementHeader::kServiceIdBloomFilterByteLength>
+      bloom_filter;
 
   return BleAdvertisementHeader(
       BleAdvertisementHeader::Version::kV2, /*extended_advertisement=*/false,
-      /*num_slots=*/1, ByteArray(bloom_filter),
-      bleutils::GenerateAdvertisementHash(advertisement_bytes),
+      /*num_slots=*/1, ByteArray(bloom_filter), advertisement_hash,
       /*psm=*/BleAdvertisementHeader::kDefaultPsmValue);
 }
 
@@ -482,8 +536,8 @@ BleAdvertisementHeader DiscoveredPeripheralTracker::HandleRawGattAdvertisements(
         .service_id = service_id,
         .advertisement_header = new_advertisement_header,
         .peripheral = peripheral};
-    gatt_advertisement_infos_.insert_or_assign(
-        gatt_advertisement, std::move(gatt_advertisement_info));
+    SetGattAdvertisementInfo(gatt_advertisement,
+                             std::move(gatt_advertisement_info));
   }
 
   // Insert the list of read GATT advertisements for this advertisement
@@ -504,13 +558,13 @@ DiscoveredPeripheralTracker::ParseRawGattAdvertisements(
   for (const auto gatt_advertisement_bytes : gatt_advertisement_bytes_list) {
     // First, parse the raw bytes into a BleAdvertisement.
 
-    auto gatt_advertisement_status_or =
-        BleAdvertisement::CreateBleAdvertisement(*gatt_advertisement_bytes);
+    const absl::StatusOr<BleAdvertisement>& gatt_advertisement_status_or =
+        advertisement_cache_.Decode(*gatt_advertisement_bytes).advertisement;
     if (!gatt_advertisement_status_or.ok()) {
       VLOG(1) << gatt_advertisement_status_or.status();
       continue;
     }
-    auto gatt_advertisement = gatt_advertisement_status_or.value();
+    BleAdvertisement gatt_advertisement = gatt_advertisement_status_or.value();
 
     // Make sure the advertisement belongs to a service ID we're tracking.
     for (const auto& item : service_id_infos_) {
@@ -543,7 +597,7 @@ DiscoveredPeripheralTracker::ParseRawGattAdvertisements(
       }
 
       // Map the service ID to the advertisement if the service_id_hash match.
-      if (bleutils::GenerateServiceIdHash(service_id) ==
+      if (item.second.service_id_hash ==
           gatt_advertisement.GetServiceIdHash()) {
         LOG(INFO) << "Matched service_id=" << service_id
                   << " to GATT advertisement="
@@ -592,9 +646,8 @@ bool DiscoveredPeripheralTracker::IsDummyAdvertisementHeader(
   // regular advertisement has different value, it will include PSM value if
   // received it from extended advertisement protocol and it will not has PSM
   // value if it fetched from GATT connection.
-  BloomFilter bloom_filter(
-      std::make_unique<BitSetImpl<
-          BleAdvertisementHeader::kServiceIdBloomFilterByteLength>>());
+  BloomFilter<BleAdvertisementHeader::kServiceIdBloomFilterByteLength>
+      bloom_filter;
   return advertisement_header.GetVersion() ==
              BleAdvertisementHeader::Version::kV2 &&
          advertisement_header.GetNumSlots() == 1 &&
@@ -656,15 +709,19 @@ void DiscoveredPeripheralTracker::HandleAdvertisementHeader(
 
       if (executor_ == nullptr) {
         // The situation happens when flag value changed
-        executor_ = std::make_unique<MultiThreadExecutor>(kGattThreadCount);
+        executor_ =
+            std::make_unique<MultiThreadExecutor>(max_in_flight_gatt_fetches_);
       }
-      executor_->Execute(
-          [this, peripheral, advertisement_header,
-           advertisement_fetcher = std::move(advertisement_fetcher),
-           advertisement_data = std::move(advertisement_data)]() mutable {
-            FetchRawAdvertisementsInThread(peripheral, advertisement_header,
-                                           std::move(advertisement_fetcher));
-          });
+      // A header read before is retried; a header never read before is new,
+      // or the peripheral changed it.
+      bool is_retry =
+          advertisement_read_results_.contains(advertisement_header);
+      QueueGattFetch(GattFetch{
+          .peripheral = peripheral,
+          .advertisement_header = advertisement_header,
+          .advertisement_fetcher = std::move(advertisement_fetcher),
+          .is_retry = is_retry,
+      });
       return;
     } else {
       std::vector<const ByteArray*> gatt_advertisement_bytes_list =
@@ -699,10 +756,8 @@ ByteArray DiscoveredPeripheralTracker::ExtractAdvertisementHeaderBytes(
 
 bool DiscoveredPeripheralTracker::IsInterestingAdvertisementHeader(
     const BleAdvertisementHeader& advertisement_header) {
-  BloomFilter bloom_filter(
-      std::make_unique<BitSetImpl<
-          BleAdvertisementHeader::kServiceIdBloomFilterByteLength>>(),
-      advertisement_header.GetServiceIdBloomFilter());
+  BloomFilter<BleAdvertisementHeader::kServiceIdBloomFilterByteLength>
+      bloom_filter(advertisement_header.GetServiceIdBloomFilter());
 
   for (const auto& item : service_id_infos_) {
     const std::string& service_id = item.first;
@@ -800,7 +855,6 @@ void DiscoveredPeripheralTracker::FetchRawAdvertisementsInThread(
     if (!IsInterestingAdvertisementHeader(advertisement_header)) {
       LOG(INFO) << ": Ignore to read raw advertisement from server due to it "
                    "is not interesting header now.";
-      fetching_advertisements_.erase(advertisement_header);
       return;
     }
 
@@ -831,7 +885,6 @@ void DiscoveredPeripheralTracker::FetchRawAdvertisementsInThread(
 
     if (gatt_advertisement_bytes_list.empty() ||
         !IsInterestingAdvertisementHeader(advertisement_header)) {
-      fetching_advertisements_.erase(advertisement_header);
       return;
     }
 
@@ -839,7 +892,6 @@ void DiscoveredPeripheralTracker::FetchRawAdvertisementsInThread(
                                 gatt_advertisement_bytes_list,
                                 /*service_uuid=*/{});
     UpdateCommonStateForFoundBleAdvertisement(advertisement_header);
-    fetching_advertisements_.erase(advertisement_header);
     VLOG(1) << ": Completed to handle GATT advertisement header with hash "
             << absl::BytesToHexString(
                    advertisement_header.GetAdvertisementHash().AsStringView())
@@ -847,6 +899,74 @@ void DiscoveredPeripheralTracker::FetchRawAdvertisementsInThread(
   }
 }
 
+void DiscoveredPeripheralTracker::QueueGattFetch(GattFetch gatt_fetch) {
+  gatt_fetch.sequence = next_gatt_fetch_sequence_++;
+  std::optional<api::ble_v2::BlePeripheral::UniqueId> peripheral_id =
+      gatt_fetch.peripheral.GetUniqueId();
+  GattFetchKey key =
+      peripheral_id.has_value()
+          ? GattFetchKey{.has_peripheral_id = true, .id = *peripheral_id}
+          : GattFetchKey{.has_peripheral_id = false,
+                         .id = gatt_fetch.sequence};
+  const auto it = queued_gatt_fetches_.find(key);
+  if (it != queued_gatt_fetches_.end()) {
+    // The peripheral changed its header before the read of the previous one
+    // started; read the latest header only.
+    VLOG(1) << ": Replace the queued GATT read of the advertisement header "
+               "with hash "
+            << absl::BytesToHexString(it->second.advertisement_header
+                                          .GetAdvertisementHash()
+                                          .AsStringView());
+    fetching_advertisements_.erase(it->second.advertisement_header);
+    gatt_fetch.sequence = it->second.sequence;
+    gatt_fetch.is_retry = gatt_fetch.is_retry && it->second.is_retry;
+    it->second = std::move(gatt_fetch);
+  } else {
+    queued_gatt_fetches_.emplace(key, std::move(gatt_fetch));
+  }
+  StartQueuedGattFetches();
+}
+
+void DiscoveredPeripheralTracker::StartQueuedGattFetches() {
+  if (executor_ == nullptr) {
+    // Shutting down.
+    return;
+  }
+  while (static_cast<int>(in_flight_gatt_fetches_.size()) <
+         max_in_flight_gatt_fetches_) {
+    auto next = queued_gatt_fetches_.end();
+    for (auto it = queued_gatt_fetches_.begin();
+         it != queued_gatt_fetches_.end(); ++it) {
+      if (in_flight_gatt_fetches_.contains(it->first)) {
+        continue;
+      }
+      if (next == queued_gatt_fetches_.end() ||
+          std::make_pair(it->second.is_retry, it->second.sequence) <
+              std::make_pair(next->second.is_retry, next->second.sequence)) {
+        next = it;
+      }
+    }
+    if (next == queued_gatt_fetches_.end()) {
+      return;
+    }
+
+    GattFetchKey key = next->first;
+    GattFetch gatt_fetch = std::move(next->second);
+    queued_gatt_fetches_.erase(next);
+    in_flight_gatt_fetches_.insert(key);
+    executor_->Execute([this, key,
+                        gatt_fetch = std::move(gatt_fetch)]() mutable {
+      FetchRawAdvertisementsInThread(
+          gatt_fetch.peripheral, gatt_fetch.advertisement_header,
+          std::move(gatt_fetch.advertisement_fetcher));
+      MutexLock lock(&mutex_);
+      fetching_advertisements_.erase(gatt_fetch.advertisement_header);
+      in_flight_gatt_fetches_.erase(key);
+      StartQueuedGattFetches();
+    });
+  }
+}
+
 void DiscoveredPeripheralTracker::UpdateCommonStateForFoundBleAdvertisement(
     const BleAdvertisementHeader& advertisement_header) {
   const auto ga_it = gatt_advertisements_.find(advertisement_header);
@@ -904,33 +1024,31 @@ void DiscoveredPeripheralTracker::AddInstantLostAdvertisement(
   LOG(INFO) << "Add instant lost advertisement header with hash "
             << absl::BytesToHexString(
                    advertisement_header.GetAdvertisementHash().AsStringView());
-  lost_advertisment_infos_[std::string(
-      advertisement_header.GetAdvertisementHash())] =
-      SystemClock::ElapsedRealtime();
+  std::string hash(advertisement_header.GetAdvertisementHash());
+  absl::Time now = SystemClock::ElapsedRealtime();
+  lost_advertisment_infos_[hash] = now;
+  lost_advertisement_expiries_.emplace_back(now, std::move(hash));
 }
 
 void DiscoveredPeripheralTracker::RemoveExpiredInstantLostAdvertisements() {
   absl::Time now = SystemClock::ElapsedRealtime();
-  if (now - last_lost_info_update_time_ < kInstantLostAdvertisementTimeout) {
-    return;
-  }
-
-  auto it = lost_advertisment_infos_.begin(),
-       end = lost_advertisment_infos_.end();
-
-  LOG(INFO) << "Start to remove expired lost advertisements.";
   int count = 0;
-  while (it != end) {
-    if (now - it->second >= kInstantLostAdvertisementTimeout) {
-      lost_advertisment_infos_.erase(it++);
+  while (!lost_advertisement_expiries_.empty() &&
+         now - lost_advertisement_expiries_.front().first >=
+             kInstantLostAdvertisementTimeout) {
+    const auto& [lost_time, hash] = lost_advertisement_expiries_.front();
+    const auto it = lost_advertisment_infos_.find(hash);
+    // Skip the hashes reported lost again since; they expire later.
+    if (it != lost_advertisment_infos_.end() && it->second == lost_time) {
+      lost_advertisment_infos_.erase(it);
       ++count;
-    } else {
-      ++it;
     }
+    lost_advertisement_expiries_.pop_front();
   }
 
-  last_lost_info_update_time_ = now;
-  LOG(INFO) << "Removed " << count << " expired lost advertisements.";
+  if (count > 0) {
+    LOG(INFO) << "Removed " << count << " expired lost advertisements.";
+  }
 }
 
 }  // namespace mediums
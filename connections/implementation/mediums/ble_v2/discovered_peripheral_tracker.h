@@ -16,8 +16,11 @@
 #define CORE_INTERNAL_MEDIUMS_BLE_V2_DISCOVERED_PERIPHERAL_TRACKER_H_
 
 #include <array>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
@@ -26,6 +29,7 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/time/time.h"
 #include "connections/implementation/mediums//lost_entity_tracker.h"
+#include "connections/implementation/mediums/ble_v2/advertisement_cache.h"
 #include "connections/implementation/mediums/ble_v2/advertisement_read_result.h"
 #include "connections/implementation/mediums/ble_v2/ble_advertisement.h"
 #include "connections/implementation/mediums/ble_v2/ble_advertisement_header.h"
@@ -120,6 +124,9 @@ class DiscoveredPeripheralTracker {
     // Used to check for fast advertisements delivered through BLE advertisement
     // service data, under the given UUID.
     Uuid fast_advertisement_service_uuid;
+
+    // The hash GATT advertisements of the service ID carry.
+    ByteArray service_id_hash;
   };
 
   // A container to hold the related informations for a GATT advertisement.
@@ -138,6 +145,33 @@ class DiscoveredPeripheralTracker {
     BleV2Peripheral peripheral;
   };
 
+  // A GATT advertisement read to run in a thread.
+  struct GattFetch {
+    BleV2Peripheral peripheral;
+    BleAdvertisementHeader advertisement_header;
+    AdvertisementFetcher advertisement_fetcher;
+    // Retries of failed reads run after reads of new or changed headers.
+    bool is_retry = false;
+    // Orders the reads of the same priority by arrival.
+    std::uint64_t sequence = 0;
+  };
+
+  // Identifies the queued and running GATT reads of one peripheral. A
+  // peripheral without a unique id can't be told apart from the others, so
+  // its read is keyed by its own sequence and is never merged with another.
+  struct GattFetchKey {
+    bool has_peripheral_id = false;
+    std::uint64_t id = 0;
+
+    bool operator==(const GattFetchKey& other) const {
+      return has_peripheral_id == other.has_peripheral_id && id == other.id;
+    }
+    template <typename H>
+    friend H AbslHashValue(H h, const GattFetchKey& key) {
+      return H::combine(std::move(h), key.has_peripheral_id, key.id);
+    }
+  };
+
   // Clears stale data from any previous sessions.
   void ClearDataForServiceId(const std::string& service_id)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -161,6 +195,16 @@ class DiscoveredPeripheralTracker {
   void ClearGattAdvertisement(const BleAdvertisement& gatt_advertisement)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Sets the info of `gatt_advertisement` in gatt_advertisement_infos_, and
+  // keeps gatt_advertisements_by_hash_ in sync with it.
+  void SetGattAdvertisementInfo(const BleAdvertisement& gatt_advertisement,
+                                GattAdvertisementInfo gatt_advertisement_info)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void RemoveFromAdvertisementHashIndex(
+      const BleAdvertisement& gatt_advertisement,
+      const BleAdvertisementHeader& advertisement_header)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // Handles the legacy fast advertisement or the extended fast/regular
   // advertisement.
   void HandleAdvertisement(
@@ -176,7 +220,7 @@ class DiscoveredPeripheralTracker {
   // Creates an advertisement header that's purely a hash of the fast/regular
   // advertisement, since they come with no header.
   BleAdvertisementHeader CreateAdvertisementHeader(
-      const ByteArray& advertisement_bytes);
+      const ByteArray& advertisement_hash);
 
   // Returns BleAdvertisementHeader, it may be replaced if the header is mock
   // and there's a psm value in advertisement.
@@ -246,6 +290,17 @@ class DiscoveredPeripheralTracker {
       const BleAdvertisementHeader& advertisement_header,
       AdvertisementFetcher advertisement_fetcher);
 
+  // Queues a GATT advertisement read to run in a thread. A read queued for
+  // the same peripheral, and not started yet, is replaced by this one, which
+  // takes its place in the queue.
+  void QueueGattFetch(GattFetch gatt_fetch)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Starts the queued GATT advertisement reads, highest priority first, as
+  // long as fewer than max_in_flight_gatt_fetches_ are running. Skips the
+  // reads of peripherals with a read running.
+  void StartQueuedGattFetches() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // Updates `gatt_advertisement_infos_` map no matter whether we read a new
   // GATT advertisement by the input `advertisement_header` and 'mac_address`.
   void UpdateCommonStateForFoundBleAdvertisement(
@@ -278,6 +333,7 @@ class DiscoveredPeripheralTracker {
 
   Mutex mutex_;
   bool is_extended_advertisement_available_;
+  const int max_in_flight_gatt_fetches_;
 
   // ------------ SERVICE ID MAPS ------------
   // Entries in these maps all follow the same lifecycle. Entries are added in
@@ -318,6 +374,15 @@ class DiscoveredPeripheralTracker {
   absl::flat_hash_map<BleAdvertisement, GattAdvertisementInfo>
       gatt_advertisement_infos_ ABSL_GUARDED_BY(mutex_);
 
+  // Maps advertisement hashes to the GATT advertisements whose header has the
+  // hash. A reverse index of gatt_advertisement_infos_, used to find the
+  // advertisements an Instant On Lost advertisement reports lost.
+  absl::flat_hash_map<std::string, BleAdvertisementSet>
+      gatt_advertisements_by_hash_ ABSL_GUARDED_BY(mutex_);
+
+  // Decodes the fast and GATT advertisements, remembering the ones seen last.
+  AdvertisementCache advertisement_cache_ ABSL_GUARDED_BY(mutex_);
+
   // Tracks the advertisements in GATT fetching.
   absl::flat_hash_set<BleAdvertisementHeader> fetching_advertisements_
       ABSL_GUARDED_BY(mutex_);
@@ -325,12 +390,23 @@ class DiscoveredPeripheralTracker {
   std::unique_ptr<MultiThreadExecutor> executor_ ABSL_GUARDED_BY(mutex_) =
       nullptr;
 
+  // The GATT advertisement reads waiting to run in a thread, by peripheral.
+  absl::flat_hash_map<GattFetchKey, GattFetch> queued_gatt_fetches_
+      ABSL_GUARDED_BY(mutex_);
+  // The peripherals with a GATT advertisement read running.
+  absl::flat_hash_set<GattFetchKey> in_flight_gatt_fetches_
+      ABSL_GUARDED_BY(mutex_);
+  std::uint64_t next_gatt_fetch_sequence_ ABSL_GUARDED_BY(mutex_) = 0;
+
   // Maps an advertisement header's hash with the time it's reported lost.
   // Ignores subsequent discovery events for the same advertisement header.
   absl::flat_hash_map<std::string, absl::Time> lost_advertisment_infos_
       ABSL_GUARDED_BY(mutex_);
-  absl::Time last_lost_info_update_time_ ABSL_GUARDED_BY(mutex_) =
-      absl::InfinitePast();
+  // The hashes of lost_advertisment_infos_ with the time they were reported
+  // lost, oldest first. They all expire after the same timeout, so they
+  // expire in this order; a hash reported lost again is queued again.
+  std::deque<std::pair<absl::Time, std::string>> lost_advertisement_expiries_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace mediums
@@ -93,9 +93,8 @@ ByteArray CreateLegacyBleAdvertisement(const std::string& service_id,
 
 BleAdvertisementHeader CreateFastBleAdvertisementHeader(
     const ByteArray& advertisement_bytes) {
-  BloomFilter bloom_filter(
-      std::make_unique<BitSetImpl<
-          BleAdvertisementHeader::kServiceIdBloomFilterByteLength>>());
+  BloomFilter<BleAdvertisementHeader::kServiceIdBloomFilterByteLength>
+      bloom_filter;
 
   return BleAdvertisementHeader(
       BleAdvertisementHeader::Version::kV2, /*extended_advertisement=*/false,
@@ -107,9 +106,8 @@ BleAdvertisementHeader CreateFastBleAdvertisementHeader(
 ByteArray CreateBleAdvertisementHeader(const ByteArray& advertisement_hash,
                                        int psm,
                                        std::vector<std::string>& service_ids) {
-  BloomFilter service_id_bloom_filter(
-      std::make_unique<BitSetImpl<
-          BleAdvertisementHeader::kServiceIdBloomFilterByteLength>>());
+  BloomFilter<BleAdvertisementHeader::kServiceIdBloomFilterByteLength>
+      service_id_bloom_filter;
 
   for (const std::string& service_id : service_ids) {
     service_id_bloom_filter.Add(service_id);
@@ -1591,6 +1589,55 @@ TEST_P(DiscoveredPeripheralTrackerTest,
   EXPECT_EQ(GetFetchAdvertisementCallbackCount(), 2);
 }
 
+TEST_P(DiscoveredPeripheralTrackerTest,
+       FetchLatestGattAdvertisementOfPeripheralInThread) {
+  EnableFetchGattAdvertisementInThread();
+  std::vector<std::string> service_ids = {std::string(kServiceIdA)};
+  std::vector<ByteArray> advertisement_header_bytes_list;
+  std::vector<ByteArray> advertisement_bytes_list;
+  for (const char* data : {"data-1", "data-2", "data-3"}) {
+    advertisement_header_bytes_list.push_back(CreateBleAdvertisementHeader(
+        GenerateRandomAdvertisementHash(), service_ids));
+    advertisement_bytes_list.push_back(CreateBleAdvertisement(
+        std::string(kServiceIdA), ByteArray(std::string(data)),
+        ByteArray(std::string(kDeviceToken))));
+  }
+  Mutex found_mutex;
+  std::vector<std::string> found_data;
+  CountDownLatch found_latch(2);
+  CountDownLatch fetch_latch(2);
+
+  discovered_peripheral_tracker_.StartTracking(
+      std::string(kServiceIdA),
+      {
+          .peripheral_discovered_cb =
+              [&](BleV2Peripheral peripheral, const std::string& service_id,
+                  const ByteArray& advertisement_bytes,
+                  bool fast_advertisement) {
+                MutexLock lock(&found_mutex);
+                found_data.push_back(std::string(advertisement_bytes));
+                found_latch.CountDown();
+              },
+      },
+      {});
+
+  // The peripheral changes its header twice while its first header is read;
+  // only the latest one is read next.
+  for (int i = 0; i < 3; i++) {
+    api::ble_v2::BleAdvertisementData advertisement_data{};
+    advertisement_data.service_data.insert(
+        {bleutils::kCopresenceServiceUuid, advertisement_header_bytes_list[i]});
+    FindAdvertisementWithSlowFetcher(
+        advertisement_data, {advertisement_bytes_list[i]}, fetch_latch);
+  }
+
+  fetch_latch.Await(kWaitDuration);
+  EXPECT_TRUE(found_latch.Await(kWaitDuration).result());
+  EXPECT_EQ(GetFetchAdvertisementCallbackCount(), 2);
+  MutexLock lock(&found_mutex);
+  EXPECT_EQ(found_data, std::vector<std::string>({"data-1", "data-3"}));
+}
+
 INSTANTIATE_TEST_SUITE_P(DiscoveredPeripheralTrackerFlagsTest,
                          DiscoveredPeripheralTrackerTest,
                          /*kEnableGattQueryInThread=*/testing::Bool());
@@ -17,6 +17,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/strings/escaping.h"
 #include "absl/time/clock.h"
@@ -26,6 +27,7 @@
 #include "internal/platform/ble_v2.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancelable_alarm.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/implementation/ble_v2.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
@@ -40,6 +42,14 @@ constexpr int kMaxAdvertisingOnLostHashCount =
 constexpr absl::Duration kInstantOnLostAdvertiseDuration = absl::Seconds(2);
 }  // namespace
 
+InstantOnLostManager::InstantOnLostManager()
+    : InstantOnLostManager(FeatureFlags::GetInstance()
+                               .GetFlags()
+                               .instant_on_lost_batching_window) {}
+
+InstantOnLostManager::InstantOnLostManager(absl::Duration batching_window)
+    : batching_window_(batching_window) {}
+
 void InstantOnLostManager::OnAdvertisingStarted(
     const std::string& service_id, const ByteArray& advertisement_data) {
   MutexLock lock(&mutex_);
@@ -64,14 +74,14 @@ void InstantOnLostManager::OnAdvertisingStarted(
   // Check whether the hash is in on lost list.
   for (auto& it : active_on_lost_advertising_list_) {
     if (it.hash == std::string(advertisement_hash)) {
-      StopOnLostAdvertising();
-      if (stop_advertising_alarm_ != nullptr) {
-        stop_advertising_alarm_->Cancel();
-      }
-
       active_on_lost_advertising_list_.remove(it);
-      if (!active_on_lost_advertising_list_.empty()) {
-        StartInstantOnLostAdvertisement();
+      if (active_on_lost_advertising_list_.empty()) {
+        StopOnLostAdvertising();
+        if (stop_advertising_alarm_ != nullptr) {
+          stop_advertising_alarm_->Cancel();
+        }
+      } else {
+        UpdateInstantOnLostAdvertisement();
       }
       NEARBY_LOGS(INFO) << __func__ << ": Remove the lost hash "
                         << absl::BytesToHexString(
@@ -116,7 +126,7 @@ void InstantOnLostManager::OnAdvertisingStopped(const std::string& service_id) {
   active_on_lost_advertising_list_.push_back(
       {absl::Now(), std::string(advertisement_hash)});
 
-  if (!StartInstantOnLostAdvertisement()) {
+  if (!UpdateInstantOnLostAdvertisement()) {
     NEARBY_LOGS(ERROR) << __func__
                        << ": Failed to advertise instant onLost BLE.";
   }
@@ -126,22 +136,36 @@ void InstantOnLostManager::OnAdvertisingStopped(const std::string& service_id) {
 }
 
 bool InstantOnLostManager::Shutdown() {
-  MutexLock lock(&mutex_);
-  if (is_shutdown_) {
-    NEARBY_LOGS(WARNING) << __func__
-                         << ": InstantOnLostManager is already shutdown.";
-    return false;
-  }
+  // The alarms are cancelled without holding mutex_, since their callbacks
+  // take it.
+  std::unique_ptr<CancelableAlarm> stop_advertising_alarm;
+  std::unique_ptr<CancelableAlarm> batching_window_alarm;
+  {
+    MutexLock lock(&mutex_);
+    if (is_shutdown_) {
+      NEARBY_LOGS(WARNING) << __func__
+                           << ": InstantOnLostManager is already shutdown.";
+      return false;
+    }
 
-  if (stop_advertising_alarm_ != nullptr) {
-    stop_advertising_alarm_->Cancel();
-  }
+    stop_advertising_alarm = std::move(stop_advertising_alarm_);
+    batching_window_alarm = std::move(batching_window_alarm_);
+    is_batching_window_open_ = false;
+    is_restart_pending_ = false;
 
-  StopOnLostAdvertising();
+    StopOnLostAdvertising();
+
+    active_on_lost_advertising_list_.clear();
+    active_advertising_map_.clear();
+    is_shutdown_ = true;
+  }
 
-  active_on_lost_advertising_list_.clear();
-  active_advertising_map_.clear();
-  is_shutdown_ = true;
+  if (stop_advertising_alarm != nullptr) {
+    stop_advertising_alarm->Cancel();
+  }
+  if (batching_window_alarm != nullptr) {
+    batching_window_alarm->Cancel();
+  }
 
   NEARBY_LOGS(INFO) << __func__ << ": InstantOnLostManager is shutdown.";
   return true;
@@ -157,6 +181,51 @@ bool InstantOnLostManager::IsOnLostAdvertising() {
   return is_on_lost_advertising_;
 }
 
+int InstantOnLostManager::GetRestartsSaved() {
+  MutexLock lock(&mutex_);
+  return restarts_saved_;
+}
+
+bool InstantOnLostManager::UpdateInstantOnLostAdvertisement() {
+  if (is_batching_window_open_) {
+    // The first change of the window costs the restart at its end; the
+    // following ones come for free.
+    if (is_restart_pending_) {
+      ++restarts_saved_;
+    }
+    is_restart_pending_ = true;
+    return true;
+  }
+
+  bool started = StartInstantOnLostAdvertisement();
+  if (started && batching_window_ > absl::ZeroDuration()) {
+    is_batching_window_open_ = true;
+    batching_window_alarm_ = std::make_unique<CancelableAlarm>(
+        "instant_on_lost_batching_window", [this]() { OnBatchingWindowEnd(); },
+        batching_window_, &executor_);
+  }
+  return started;
+}
+
+void InstantOnLostManager::OnBatchingWindowEnd() {
+  MutexLock lock(&mutex_);
+  if (is_shutdown_) {
+    return;
+  }
+  is_batching_window_open_ = false;
+  if (!is_restart_pending_) {
+    return;
+  }
+  is_restart_pending_ = false;
+  if (active_on_lost_advertising_list_.empty()) {
+    return;
+  }
+  if (!UpdateInstantOnLostAdvertisement()) {
+    NEARBY_LOGS(ERROR) << __func__
+                       << ": Failed to advertise instant onLost BLE.";
+  }
+}
+
 bool InstantOnLostManager::StartInstantOnLostAdvertisement() {
   api::ble_v2::BleAdvertisementData advertisement_data;
   api::ble_v2::AdvertiseParameters advertise_parameters;
@@ -194,6 +263,9 @@ bool InstantOnLostManager::StartInstantOnLostAdvertisement() {
       "stop_instant_on_lost_advertising",
       [this]() {
         MutexLock lock(&mutex_);
+        if (is_shutdown_) {
+          return;
+        }
         StopOnLostAdvertising();
         // All hashes already advertised for enough time, we should clear the
         // list.
@@ -33,9 +33,18 @@ namespace nearby {
 namespace connections {
 namespace mediums {
 
+// Advertises the hashes of the stopped advertisements for a while, so that
+// nearby discoverers report them lost right away.
+//
+// Restarting the advertisement for a lost hash opens a batching window; every
+// change to the lost hashes over the window is applied by a single restart at
+// its end. Stopping many advertisements at once then restarts the radio once
+// for the first of them, and once for all the others.
 class InstantOnLostManager {
  public:
-  InstantOnLostManager() = default;
+  // Uses the batching window of the feature flags.
+  InstantOnLostManager();
+  explicit InstantOnLostManager(absl::Duration batching_window);
   ~InstantOnLostManager() = default;
 
   void OnAdvertisingStarted(const std::string& service_id,
@@ -48,6 +57,8 @@ class InstantOnLostManager {
 
   std::list<std::string> GetOnLostHashes() ABSL_LOCKS_EXCLUDED(mutex_);
   bool IsOnLostAdvertising() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns the number of advertisement restarts spared by batching so far.
+  int GetRestartsSaved() ABSL_LOCKS_EXCLUDED(mutex_);
 
  private:
   struct OnLostAdvertisementHashInfo {
@@ -59,6 +70,10 @@ class InstantOnLostManager {
     }
   };
 
+  // Restarts the advertisement with the current hashes, or batches the
+  // restart while a batching window is open.
+  bool UpdateInstantOnLostAdvertisement() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void OnBatchingWindowEnd() ABSL_LOCKS_EXCLUDED(mutex_);
   bool StartInstantOnLostAdvertisement() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   bool StopOnLostAdvertising() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   void RemoveExpiredOnLostAdvertisements()
@@ -66,10 +81,18 @@ class InstantOnLostManager {
   std::list<std::string> GetOnLostHashesInternal()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  const absl::Duration batching_window_;
+
   Mutex mutex_;
 
   std::unique_ptr<CancelableAlarm> stop_advertising_alarm_
       ABSL_GUARDED_BY(mutex_);
+  std::unique_ptr<CancelableAlarm> batching_window_alarm_
+      ABSL_GUARDED_BY(mutex_);
+  bool is_batching_window_open_ ABSL_GUARDED_BY(mutex_) = false;
+  // Whether the hashes changed since the batching window opened.
+  bool is_restart_pending_ ABSL_GUARDED_BY(mutex_) = false;
+  int restarts_saved_ ABSL_GUARDED_BY(mutex_) = 0;
 
   // BLE medium used for lost packet advertising.
   BluetoothAdapter adapter_ ABSL_GUARDED_BY(mutex_);
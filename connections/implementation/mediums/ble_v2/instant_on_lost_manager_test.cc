@@ -144,6 +144,45 @@ TEST(InstantOnLostManager, RemoveExpiredOnLostAdvertisement) {
   instant_on_lost_manager.Shutdown();
 }
 
+TEST(InstantOnLostManager, BatchesChangesWithinBatchingWindow) {
+  InstantOnLostManager instant_on_lost_manager(absl::Milliseconds(500));
+  instant_on_lost_manager.OnAdvertisingStarted(
+      std::string(kServiceIdA), ByteArray(kData1.data(), kData1.size()));
+  instant_on_lost_manager.OnAdvertisingStarted(
+      std::string(kServiceIdB), ByteArray(kData2.data(), kData2.size()));
+  instant_on_lost_manager.OnAdvertisingStarted(
+      std::string(kServiceIdC), ByteArray(kData3.data(), kData3.size()));
+
+  // The first lost hash restarts the advertisement right away, the others wait
+  // for the end of the window.
+  instant_on_lost_manager.OnAdvertisingStopped(std::string(kServiceIdA));
+  EXPECT_TRUE(instant_on_lost_manager.IsOnLostAdvertising());
+  instant_on_lost_manager.OnAdvertisingStopped(std::string(kServiceIdB));
+  instant_on_lost_manager.OnAdvertisingStopped(std::string(kServiceIdC));
+  EXPECT_EQ(instant_on_lost_manager.GetOnLostHashes().size(), 3);
+  EXPECT_EQ(instant_on_lost_manager.GetRestartsSaved(), 1);
+
+  absl::SleepFor(absl::Milliseconds(600));
+  EXPECT_TRUE(instant_on_lost_manager.IsOnLostAdvertising());
+  EXPECT_EQ(instant_on_lost_manager.GetOnLostHashes().size(), 3);
+  EXPECT_EQ(instant_on_lost_manager.GetRestartsSaved(), 1);
+  instant_on_lost_manager.Shutdown();
+}
+
+TEST(InstantOnLostManager, NoBatchingWithZeroBatchingWindow) {
+  InstantOnLostManager instant_on_lost_manager(absl::ZeroDuration());
+  instant_on_lost_manager.OnAdvertisingStarted(
+      std::string(kServiceIdA), ByteArray(kData1.data(), kData1.size()));
+  instant_on_lost_manager.OnAdvertisingStarted(
+      std::string(kServiceIdB), ByteArray(kData2.data(), kData2.size()));
+  instant_on_lost_manager.OnAdvertisingStopped(std::string(kServiceIdA));
+  instant_on_lost_manager.OnAdvertisingStopped(std::string(kServiceIdB));
+  EXPECT_TRUE(instant_on_lost_manager.IsOnLostAdvertising());
+  EXPECT_EQ(instant_on_lost_manager.GetOnLostHashes().size(), 2);
+  EXPECT_EQ(instant_on_lost_manager.GetRestartsSaved(), 0);
+  instant_on_lost_manager.Shutdown();
+}
+
 }  // namespace
 }  // namespace mediums
 }  // namespace connections
@@ -28,6 +28,11 @@ namespace mediums {
 // of whether a specific entity was rediscovered since the last call to
 // ComputeLostEntities.
 //
+// An entity is either found since the last computation, or only before it, so
+// recording a found entity moves it between the two sets, and computing the
+// lost entities hands out the second set as is. Both take constant time, no
+// matter how many entities are tracked.
+//
 // Note: Entity must overload the < and == operators.
 template <typename Entity>
 class LostEntityTracker {
@@ -47,7 +52,10 @@ class LostEntityTracker {
 
  private:
   Mutex mutex_;
+  // The entities found since the last call to ComputeLostEntities.
   EntitySet current_entities_ ABSL_GUARDED_BY(mutex_);
+  // The entities found before the last call to ComputeLostEntities, and not
+  // since. Disjoint from current_entities_.
   EntitySet previously_found_entities_ ABSL_GUARDED_BY(mutex_);
 };
 
@@ -65,7 +73,9 @@ template <typename Entity>
 void LostEntityTracker<Entity>::RecordFoundEntity(const Entity& entity) {
   MutexLock lock(&mutex_);
 
-  current_entities_.insert(entity);
+  if (current_entities_.insert(entity).second) {
+    previously_found_entities_.erase(entity);
+  }
 }
 
 template <typename Entity>
@@ -74,10 +84,7 @@ LostEntityTracker<Entity>::ComputeLostEntities() {
   MutexLock lock(&mutex_);
 
   // The set of lost entities is the previously found set MINUS the currently
-  // found set.
-  for (const auto& item : current_entities_) {
-    previously_found_entities_.erase(item);
-  }
+  // found set, which RecordFoundEntity() removed from it already.
   auto lost_entities = std::move(previously_found_entities_);
   previously_found_entities_ = std::move(current_entities_);
   current_entities_ = {};
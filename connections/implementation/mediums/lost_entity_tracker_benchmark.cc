@@ -0,0 +1,80 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+#include "connections/implementation/mediums/lost_entity_tracker.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+namespace {
+
+// Every round, 1 in kLostOneIn entities isn't found again and is replaced by
+// a new one, like peripherals moving in and out of range between scans.
+constexpr int64_t kLostOneIn = 100;
+
+// A discovery round over state.range(0) entities: every entity found is
+// recorded, then the lost entities are computed.
+void BM_Round(benchmark::State& state) {
+  const int64_t entities = state.range(0);
+  LostEntityTracker<int64_t> tracker;
+  for (int64_t i = 0; i < entities; i++) tracker.RecordFoundEntity(i);
+  tracker.ComputeLostEntities();
+
+  int64_t first = 0;
+  for (auto _ : state) {
+    const int64_t lost = entities / kLostOneIn;
+    for (int64_t i = first + lost; i < first + entities + lost; i++) {
+      tracker.RecordFoundEntity(i);
+    }
+    benchmark::DoNotOptimize(tracker.ComputeLostEntities());
+    first += lost;
+  }
+  state.SetItemsProcessed(state.iterations() * entities);
+}
+BENCHMARK(BM_Round)->RangeMultiplier(10)->Range(100, 10000);
+
+// Only the computation at the end of a round, which used to walk every entity
+// found in it.
+void BM_ComputeLostEntities(benchmark::State& state) {
+  const int64_t entities = state.range(0);
+  LostEntityTracker<int64_t> tracker;
+  for (int64_t i = 0; i < entities; i++) tracker.RecordFoundEntity(i);
+  tracker.ComputeLostEntities();
+
+  int64_t first = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    const int64_t lost = entities / kLostOneIn;
+    for (int64_t i = first + lost; i < first + entities + lost; i++) {
+      tracker.RecordFoundEntity(i);
+    }
+    first += lost;
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(tracker.ComputeLostEntities());
+  }
+}
+// Recording a round takes far longer than computing its result, so the
+// iterations are fixed rather than scaled to the measured time.
+BENCHMARK(BM_ComputeLostEntities)
+    ->RangeMultiplier(10)
+    ->Range(100, 10000)
+    ->Iterations(1000);
+
+}  // namespace
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
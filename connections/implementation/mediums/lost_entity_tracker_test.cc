@@ -129,6 +129,36 @@ TEST(LostEntityTrackerTest, SameEntityMultipleCopies) {
   EXPECT_TRUE(lost_entities.find(entity_1_copy) != lost_entities.end());
 }
 
+TEST(LostEntityTrackerTest, LostEntityIsReportedOnce) {
+  LostEntityTracker<TestEntity> lost_entity_tracker;
+  TestEntity entity_1{1};
+  TestEntity entity_2{2};
+
+  lost_entity_tracker.RecordFoundEntity(entity_1);
+  lost_entity_tracker.RecordFoundEntity(entity_2);
+  EXPECT_TRUE(lost_entity_tracker.ComputeLostEntities().empty());
+
+  // Rediscover one entity more than once within a round.
+  lost_entity_tracker.RecordFoundEntity(entity_1);
+  lost_entity_tracker.RecordFoundEntity(entity_1);
+  typename LostEntityTracker<TestEntity>::EntitySet lost_entities =
+      lost_entity_tracker.ComputeLostEntities();
+  EXPECT_EQ(lost_entities.size(), 1);
+  EXPECT_TRUE(lost_entities.contains(entity_2));
+
+  lost_entities = lost_entity_tracker.ComputeLostEntities();
+  EXPECT_EQ(lost_entities.size(), 1);
+  EXPECT_TRUE(lost_entities.contains(entity_1));
+
+  // Nothing is left to lose, until an entity is found again.
+  EXPECT_TRUE(lost_entity_tracker.ComputeLostEntities().empty());
+  lost_entity_tracker.RecordFoundEntity(entity_2);
+  EXPECT_TRUE(lost_entity_tracker.ComputeLostEntities().empty());
+  lost_entities = lost_entity_tracker.ComputeLostEntities();
+  EXPECT_EQ(lost_entities.size(), 1);
+  EXPECT_TRUE(lost_entities.contains(entity_2));
+}
+
 }  // namespace
 }  // namespace mediums
 }  // namespace connections
@@ -14,26 +14,77 @@
 
 #include "connections/implementation/mediums/mediums.h"
 
+#include <memory>
+
+#include "absl/base/call_once.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/system_clock.h"
+
 namespace nearby {
 namespace connections {
 
-BluetoothRadio& Mediums::GetBluetoothRadio() { return bluetooth_radio_; }
+template <typename T, typename F>
+T& Mediums::GetOrCreate(LazyMedium<T>& lazy, absl::string_view name,
+                        F create) {
+  absl::call_once(lazy.once, [&]() {
+    absl::Time start = SystemClock::ElapsedRealtime();
+    lazy.medium = create();
+    NEARBY_LOGS(INFO) << "Mediums: created " << name << " in "
+                      << absl::ToInt64Milliseconds(
+                             SystemClock::ElapsedRealtime() - start)
+                      << " ms";
+  });
+  return *lazy.medium;
+}
+
+BluetoothRadio& Mediums::GetBluetoothRadio() {
+  return GetOrCreate(bluetooth_radio_, "BluetoothRadio",
+                     []() { return std::make_unique<BluetoothRadio>(); });
+}
 
-BluetoothClassic& Mediums::GetBluetoothClassic() { return bluetooth_classic_; }
+BluetoothClassic& Mediums::GetBluetoothClassic() {
+  return GetOrCreate(bluetooth_classic_, "BluetoothClassic", [this]() {
+    return std::make_unique<BluetoothClassic>(GetBluetoothRadio());
+  });
+}
 
-Ble& Mediums::GetBle() { return ble_; }
+Ble& Mediums::GetBle() {
+  return GetOrCreate(ble_, "Ble", [this]() {
+    return std::make_unique<Ble>(GetBluetoothRadio());
+  });
+}
 
-BleV2& Mediums::GetBleV2() { return ble_v2_; }
+BleV2& Mediums::GetBleV2() {
+  return GetOrCreate(ble_v2_, "BleV2", [this]() {
+    return std::make_unique<BleV2>(GetBluetoothRadio());
+  });
+}
 
-Wifi& Mediums::GetWifi() { return wifi_; }
+Wifi& Mediums::GetWifi() {
+  return GetOrCreate(wifi_, "Wifi", []() { return std::make_unique<Wifi>(); });
+}
 
-WifiLan& Mediums::GetWifiLan() { return wifi_lan_; }
+WifiLan& Mediums::GetWifiLan() {
+  return GetOrCreate(wifi_lan_, "WifiLan",
+                     []() { return std::make_unique<WifiLan>(); });
+}
 
-WifiHotspot& Mediums::GetWifiHotspot() { return wifi_hotspot_; }
+WifiHotspot& Mediums::GetWifiHotspot() {
+  return GetOrCreate(wifi_hotspot_, "WifiHotspot",
+                     []() { return std::make_unique<WifiHotspot>(); });
+}
 
-WifiDirect& Mediums::GetWifiDirect() { return wifi_direct_; }
+WifiDirect& Mediums::GetWifiDirect() {
+  return GetOrCreate(wifi_direct_, "WifiDirect",
+                     []() { return std::make_unique<WifiDirect>(); });
+}
 
-mediums::WebRtc& Mediums::GetWebRtc() { return webrtc_; }
+mediums::WebRtc& Mediums::GetWebRtc() {
+  return GetOrCreate(webrtc_, "WebRtc",
+                     []() { return std::make_unique<mediums::WebRtc>(); });
+}
 
 }  // namespace connections
 }  // namespace nearby
@@ -15,6 +15,10 @@
 #ifndef CORE_INTERNAL_MEDIUMS_MEDIUMS_H_
 #define CORE_INTERNAL_MEDIUMS_MEDIUMS_H_
 
+#include <memory>
+
+#include "absl/base/call_once.h"
+#include "absl/strings/string_view.h"
 #include "connections/implementation/mediums/ble.h"
 #include "connections/implementation/mediums/ble_v2.h"
 #include "connections/implementation/mediums/bluetooth_classic.h"
@@ -33,6 +37,10 @@ namespace nearby {
 namespace connections {
 
 // Facilitates convenient and reliable usage of various wireless mediums.
+//
+// Each medium is constructed on first use, since constructing one touches the
+// platform adapters; a client that only uses some mediums never pays for the
+// others. The getters are thread-safe.
 class Mediums {
  public:
   Mediums() = default;
@@ -66,23 +74,30 @@ class Mediums {
   mediums::WebRtc& GetWebRtc();
 
  private:
-  // The order of declaration is critical for both construction and
-  // destruction.
-  //
-  // 1) Construction: The individual mediums have a dependency on the
-  // corresponding radio, so the radio must be initialized first.
-  //
-  // 2) Destruction: The individual mediums should be shut down before the
-  // corresponding radio.
-  BluetoothRadio bluetooth_radio_;
-  BluetoothClassic bluetooth_classic_{bluetooth_radio_};
-  Ble ble_{bluetooth_radio_};
-  BleV2 ble_v2_{bluetooth_radio_};
-  Wifi wifi_;
-  WifiLan wifi_lan_;
-  WifiHotspot wifi_hotspot_;
-  WifiDirect wifi_direct_;
-  mediums::WebRtc webrtc_;
+  template <typename T>
+  struct LazyMedium {
+    absl::once_flag once;
+    std::unique_ptr<T> medium;
+  };
+
+  // Returns the medium held by |lazy|, creating it with |create| on first
+  // use. Logs how long the creation took.
+  template <typename T, typename F>
+  static T& GetOrCreate(LazyMedium<T>& lazy, absl::string_view name,
+                        F create);
+
+  // The order of declaration is critical for destruction: the individual
+  // mediums should be shut down before the corresponding radio. Creating an
+  // individual medium creates its radio first.
+  LazyMedium<BluetoothRadio> bluetooth_radio_;
+  LazyMedium<BluetoothClassic> bluetooth_classic_;
+  LazyMedium<Ble> ble_;
+  LazyMedium<BleV2> ble_v2_;
+  LazyMedium<Wifi> wifi_;
+  LazyMedium<WifiLan> wifi_lan_;
+  LazyMedium<WifiHotspot> wifi_hotspot_;
+  LazyMedium<WifiDirect> wifi_direct_;
+  LazyMedium<mediums::WebRtc> webrtc_;
 };
 
 }  // namespace connections
@@ -0,0 +1,118 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "connections/implementation/mediums/multiplex/multiplex_frames.h"
+#include "connections/implementation/mediums/multiplex/multiplex_output_stream.h"
+#include "internal/platform/atomic_boolean.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/output_stream.h"
+#include "proto/mediums/multiplex_frames.pb.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+namespace multiplex {
+namespace {
+
+using ::location::nearby::mediums::MultiplexFrame;
+
+constexpr char kServiceId[] = "service_id";
+constexpr char kSalt[] = "salt";
+
+// The data is fixed, so that runs are comparable.
+ByteArray MakeData(int64_t size) {
+  std::string data(size, 0);
+  for (int64_t i = 0; i < size; i++) data[i] = static_cast<char>(i * 31);
+  return ByteArray(std::move(data));
+}
+
+// Discards what is written to the physical socket.
+class NullOutputStream : public OutputStream {
+ public:
+  Exception Write(const ByteArray& data) override {
+    bytes_.fetch_add(data.size(), std::memory_order_relaxed);
+    return {Exception::kSuccess};
+  }
+  Exception Flush() override { return {Exception::kSuccess}; }
+  Exception Close() override { return {Exception::kSuccess}; }
+
+ private:
+  std::atomic<int64_t> bytes_{0};
+};
+
+void BM_SerializeDataFrame(benchmark::State& state) {
+  ByteArray data = MakeData(state.range(0));
+
+  for (auto _ : state) {
+    ByteArray bytes =
+        ForData(kServiceId, kSalt, /*should_pass_salt=*/false, data);
+    benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SerializeDataFrame)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+void BM_ParseDataFrame(benchmark::State& state) {
+  ByteArray bytes = ForData(kServiceId, kSalt, /*should_pass_salt=*/false,
+                            MakeData(state.range(0)));
+
+  for (auto _ : state) {
+    ExceptionOr<MultiplexFrame> frame = FromBytes(bytes);
+    if (!frame.ok()) {
+      state.SkipWithError("parse failed");
+      break;
+    }
+    benchmark::DoNotOptimize(IsValidDataFrame(frame.result()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseDataFrame)->RangeMultiplier(8)->Range(1 << 10, 1 << 16);
+
+// A write to a virtual socket, which is framed and handed to the writer
+// thread of the physical socket before it returns.
+void BM_VirtualOutputStreamWrite(benchmark::State& state) {
+  NullOutputStream physical_writer;
+  AtomicBoolean enabled{true};
+  MultiplexOutputStream multiplex_output_stream(&physical_writer, enabled);
+  OutputStream* virtual_stream =
+      multiplex_output_stream.CreateVirtualOutputStreamForFirstVirtualSocket(
+          kServiceId, kSalt);
+  ByteArray data = MakeData(state.range(0));
+
+  for (auto _ : state) {
+    if (virtual_stream->Write(data).Raised()) {
+      state.SkipWithError("write failed");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  multiplex_output_stream.Shutdown();
+}
+BENCHMARK(BM_VirtualOutputStreamWrite)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace multiplex
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
@@ -14,6 +14,7 @@
 
 #include "connections/implementation/mediums/multiplex/multiplex_output_stream.h"
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,7 +23,6 @@
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "connections/implementation/mediums/multiplex/multiplex_frames.h"
-#include "internal/platform/array_blocking_queue.h"
 #include "internal/platform/atomic_boolean.h"
 #include "internal/platform/base64_utils.h"
 #include "internal/platform/byte_array.h"
@@ -82,7 +82,7 @@ bool MultiplexOutputStream::WriteConnectionRequestFrame(
     return false;
   }
   Future<bool> future;
-  multiplex_writer_.EnqueueToSend(
+  multiplex_writer_.EnqueueHighPriorityToSend(
       &future, ForConnectionRequest(service_id, service_id_hash_salt),
       "MultiplexFrame::CONNECTION_REQUEST");
   if (WaitForResult("MultiplexFrame::CONNECTION_REQUEST", &future).Ok())
@@ -98,7 +98,7 @@ bool MultiplexOutputStream::WriteConnectionResponseFrame(
     return false;
   }
   Future<bool> future;
-  multiplex_writer_.EnqueueToSend(
+  multiplex_writer_.EnqueueHighPriorityToSend(
       &future,
       ForConnectionResponse(salted_service_id_hash, service_id_hash_salt,
                             response_code),
@@ -122,7 +122,7 @@ bool MultiplexOutputStream::Close(const std::string& service_id) {
     multiplex_writer_.EnqueueToSend(
         &future,
         ForDisconnection(service_id, item->second->GetServiceIdHashSalt()),
-        "MultiplexFrame::DISCONNECTION");
+        "MultiplexFrame::DISCONNECTION", service_id);
     WaitForResult("MultiplexFrame::DISCONNECTION", &future);
   }
   virtual_output_streams_.erase(service_id);
@@ -141,7 +141,7 @@ void MultiplexOutputStream::CloseAll() {
           &future,
           ForDisconnection(service_id,
                            virtual_output_stream->GetServiceIdHashSalt()),
-          "MultiplexFrame::DISCONNECTION");
+          "MultiplexFrame::DISCONNECTION", service_id);
       WaitForResult("MultiplexFrame::DISCONNECTION", &future);
     }
     virtual_output_stream->Close();
@@ -199,49 +199,123 @@ MultiplexOutputStream::MultiplexWriter::~MultiplexWriter() {
 }
 
 void MultiplexOutputStream::MultiplexWriter::EnqueueToSend(
+    Future<bool>* future, const ByteArray& data, const std::string& frame_name,
+    const std::string& service_id) {
+  MutexLock lock(&writing_mutex_);
+  // A frame larger than the per-service limit is still accepted into an empty
+  // queue, so it can't wait forever.
+  while (!is_closed_) {
+    auto item = service_queues_.find(service_id);
+    bool service_has_space =
+        item == service_queues_.end() || item->second.queued_bytes == 0 ||
+        item->second.queued_bytes + data.size() <=
+            max_queued_bytes_per_service_;
+    if (service_has_space && queued_frames_ < max_queued_frames_) break;
+    has_space_cond_.Wait();
+  }
+  if (is_closed_) {
+    NEARBY_LOGS(INFO) << "MultiplexWriter is closed; drop " << frame_name;
+    future->SetException({Exception::kIo});
+    return;
+  }
+
+  ServiceQueue& queue = service_queues_[service_id];
+  if (queue.frames.empty()) {
+    active_services_.push_back(service_id);
+  }
+  queue.frames.emplace_back(future, data);
+  queue.queued_bytes += data.size();
+  queued_frames_++;
+  StartWriterThreadLocked();
+}
+
+void MultiplexOutputStream::MultiplexWriter::EnqueueHighPriorityToSend(
     Future<bool>* future, const ByteArray& data,
     const std::string& frame_name) {
   MutexLock lock(&writing_mutex_);
-  data_queue_.Put(EnqueuedFrame(future, data));
-
-  if (is_writing_) {
+  if (is_closed_) {
+    NEARBY_LOGS(INFO) << "MultiplexWriter is closed; drop " << frame_name;
+    future->SetException({Exception::kIo});
     return;
   }
-  is_writing_ = true;
-  is_writing_cond_.Notify();
+  high_priority_frames_.emplace_back(future, data);
+  StartWriterThreadLocked();
+}
+
+size_t MultiplexOutputStream::MultiplexWriter::GetQueuedFrames(
+    const std::string& service_id) const {
+  MutexLock lock(&writing_mutex_);
+  auto item = service_queues_.find(service_id);
+  return item == service_queues_.end() ? 0 : item->second.frames.size();
+}
+
+size_t MultiplexOutputStream::MultiplexWriter::GetQueuedBytes(
+    const std::string& service_id) const {
+  MutexLock lock(&writing_mutex_);
+  auto item = service_queues_.find(service_id);
+  return item == service_queues_.end() ? 0 : item->second.queued_bytes;
+}
+
+void MultiplexOutputStream::MultiplexWriter::StartWriterThreadLocked() {
+  has_frame_cond_.Notify();
   if (!is_write_loop_running_) {
     is_write_loop_running_ = true;
     writer_thread_.Execute("Start writing", [this] { StartWriting(); });
   }
 }
 
+std::optional<MultiplexOutputStream::EnqueuedFrame>
+MultiplexOutputStream::MultiplexWriter::TakeNextFrameLocked() {
+  if (!high_priority_frames_.empty()) {
+    EnqueuedFrame frame = std::move(high_priority_frames_.front());
+    high_priority_frames_.pop_front();
+    return frame;
+  }
+  // Every pass over a queue that can't afford its head frame adds a quantum to
+  // its credit, so this ends within a few rounds.
+  while (!active_services_.empty()) {
+    ServiceQueue& queue = service_queues_[active_services_.front()];
+    if (!queue.in_turn) {
+      queue.deficit += quantum_bytes_;
+      queue.in_turn = true;
+    }
+    size_t frame_size = queue.frames.front().data_.size();
+    if (frame_size > queue.deficit) {
+      // Out of credit; the next queue takes its turn.
+      queue.in_turn = false;
+      active_services_.push_back(std::move(active_services_.front()));
+      active_services_.pop_front();
+      continue;
+    }
+    queue.deficit -= frame_size;
+    EnqueuedFrame frame = std::move(queue.frames.front());
+    queue.frames.pop_front();
+    queue.queued_bytes -= frame_size;
+    queued_frames_--;
+    if (queue.frames.empty()) {
+      // An idle queue doesn't save up credit.
+      service_queues_.erase(active_services_.front());
+      active_services_.pop_front();
+    }
+    has_space_cond_.Notify();
+    return frame;
+  }
+  return std::nullopt;
+}
+
 void MultiplexOutputStream::MultiplexWriter::StartWriting() {
   NEARBY_LOGS(INFO) << "Writing loop started.";
   while (true) {
-    auto enqueued_frame = data_queue_.TryTake();
-    if (enqueued_frame != std::nullopt) {
-      Write(enqueued_frame.value());
-      continue;
-    }
+    std::optional<EnqueuedFrame> enqueued_frame;
     {
       MutexLock lock(&writing_mutex_);
-      if (data_queue_.Empty() && is_writing_ && !is_closed_) {
-        is_writing_ = false;
-        NEARBY_LOGS(INFO) << "Waiting for data_queue_ has data.";
-        Exception wait_succeeded = is_writing_cond_.Wait();
-        if (!wait_succeeded.Ok()) {
-          NEARBY_LOGS(WARNING)
-              << "Failure waiting to wait: " << wait_succeeded.value;
-          return;
-        }
-      }
-      if (is_closed_) {
-        NEARBY_LOGS(INFO) << "Notify to close_writing_thread";
-        MutexLock lock(&close_writing_thread_mutex_);
-        close_writing_thread_cond_.Notify();
-        break;
+      while (!is_closed_ &&
+             !(enqueued_frame = TakeNextFrameLocked()).has_value()) {
+        has_frame_cond_.Wait();
       }
+      if (is_closed_) break;
     }
+    Write(*enqueued_frame);
   }
   NEARBY_LOGS(INFO) << "Writing loop stopped.";
 }
@@ -267,28 +341,31 @@ void MultiplexOutputStream::MultiplexWriter::Write(
 }
 
 void MultiplexOutputStream::MultiplexWriter::Close() {
-  if (is_closed_) {
-    NEARBY_LOGS(INFO) << "MultiplexWriter is already closed.";
-    return;
-  }
-  NEARBY_LOGS(INFO) << "Stop writing loop and Shutdown writer thread.";
   {
     MutexLock lock(&writing_mutex_);
-    is_closed_ = true;
-    if (!is_write_loop_running_) {
-      writer_thread_.Shutdown();
+    if (is_closed_) {
+      NEARBY_LOGS(INFO) << "MultiplexWriter is already closed.";
       return;
     }
-    is_write_loop_running_ = false;
-    is_writing_cond_.Notify();
-  }
-  NEARBY_LOGS(INFO) << "Wait to close_writing_thread";
-  {
-    MutexLock lock(&close_writing_thread_mutex_);
-    close_writing_thread_cond_.Wait(absl::Milliseconds(20));
-    NEARBY_LOGS(INFO) << "Shutdown writer thread.";
-    writer_thread_.Shutdown();
+    NEARBY_LOGS(INFO) << "Stop writing loop and Shutdown writer thread.";
+    is_closed_ = true;
+    // The writers of the frames still queued are waiting for their futures.
+    for (EnqueuedFrame& frame : high_priority_frames_) {
+      frame.future_->SetException({Exception::kIo});
+    }
+    high_priority_frames_.clear();
+    for (auto& [service_id, queue] : service_queues_) {
+      for (EnqueuedFrame& frame : queue.frames) {
+        frame.future_->SetException({Exception::kIo});
+      }
+    }
+    service_queues_.clear();
+    active_services_.clear();
+    queued_frames_ = 0;
+    has_frame_cond_.Notify();
+    has_space_cond_.Notify();
   }
+  writer_thread_.Shutdown();
 }
 
 MultiplexOutputStream::VirtualOutputStream::VirtualOutputStream(
@@ -334,7 +411,7 @@ Exception MultiplexOutputStream::VirtualOutputStream::Write(
         ForData(service_id_, service_id_hash_salt_, should_pass_salt, data);
     Future<bool> future;
     multiplex_writer_.EnqueueToSend(&future, data_frame,
-                                    "MultiplexFrame::DATA_FRAME");
+                                    "MultiplexFrame::DATA_FRAME", service_id_);
     return multiplex_output_stream_.WaitForResult("MultiplexFrame::DATA_FRAME",
                                                   &future);
   } else {
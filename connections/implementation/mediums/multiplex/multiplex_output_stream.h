@@ -15,14 +15,19 @@
 #ifndef CORE_INTERNAL_MEDIUMS_MULTIPLEX_MULTIPLEX_OUTPUT_STREAM_H_
 #define CORE_INTERNAL_MEDIUMS_MULTIPLEX_MULTIPLEX_OUTPUT_STREAM_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
-#include "internal/platform/array_blocking_queue.h"
 #include "internal/platform/atomic_boolean.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/condition_variable.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/feature_flags.h"
 #include "internal/platform/future.h"
@@ -101,30 +106,83 @@ class MultiplexOutputStream {
   // Shuts down the multiplex output stream.
   void Shutdown();
 
+  // Gets the number of frames and bytes waiting to be sent for the virtual
+  // output stream of |service_id|.
+  size_t GetQueuedFrames(const std::string& service_id) const {
+    return multiplex_writer_.GetQueuedFrames(service_id);
+  }
+  size_t GetQueuedBytes(const std::string& service_id) const {
+    return multiplex_writer_.GetQueuedBytes(service_id);
+  }
+
   class EnqueuedFrame {
    public:
     EnqueuedFrame(Future<bool>* future, ByteArray data)
-        : future_(future), data_(data) {}
+        : future_(future), data_(std::move(data)) {}
+    EnqueuedFrame(EnqueuedFrame&&) = default;
+    EnqueuedFrame& operator=(EnqueuedFrame&&) = default;
     ~EnqueuedFrame() = default;
 
     Future<bool>* future_;
     ByteArray data_;
   };
 
+  // Sends out the enqueued frames on a single writer thread.
+  //
+  // Control frames enqueued with EnqueueHighPriorityToSend() are written
+  // before anything else. Every other frame is queued per service id, and the
+  // queues are served in deficit round robin order: each turn, a queue may
+  // send as many bytes as it has accumulated credit for, and gains
+  // multiplex_socket_scheduler_quantum_bytes of credit per round. A service
+  // sending large chunks thus can't hold back the small frames of another one.
+  //
+  // A service may keep at most multiplex_socket_virtual_socket_max_queued_bytes
+  // queued, and all services together at most
+  // multiplex_socket_middle_priority_queue_capacity frames; EnqueueToSend()
+  // waits for space beyond that.
   class MultiplexWriter {
    public:
     explicit MultiplexWriter(OutputStream* physical_writer);
     ~MultiplexWriter();
 
-    // Enqueues the frame to be sent out.
+    // Enqueues the frame of |service_id| to be sent out.
     void EnqueueToSend(Future<bool>* future, const ByteArray& data,
-                       const std::string& frame_name);
-    // Closes the writer.
-    void Close();
+                       const std::string& frame_name,
+                       const std::string& service_id)
+        ABSL_LOCKS_EXCLUDED(writing_mutex_);
+    // Enqueues the control frame to be sent out ahead of all queued frames.
+    void EnqueueHighPriorityToSend(Future<bool>* future, const ByteArray& data,
+                                   const std::string& frame_name)
+        ABSL_LOCKS_EXCLUDED(writing_mutex_);
+    // Closes the writer. Frames still queued complete with Exception::kIo.
+    void Close() ABSL_LOCKS_EXCLUDED(writing_mutex_);
+
+    // Gets the number of frames and bytes queued for |service_id|.
+    size_t GetQueuedFrames(const std::string& service_id) const
+        ABSL_LOCKS_EXCLUDED(writing_mutex_);
+    size_t GetQueuedBytes(const std::string& service_id) const
+        ABSL_LOCKS_EXCLUDED(writing_mutex_);
 
    private:
+    struct ServiceQueue {
+      std::deque<EnqueuedFrame> frames;
+      size_t queued_bytes = 0;
+      // Bytes the queue may still send in the current round.
+      size_t deficit = 0;
+      // Whether the queue already got its quantum for its current turn.
+      bool in_turn = false;
+    };
+
+    // Starts the writer thread if it is not running yet.
+    void StartWriterThreadLocked()
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(writing_mutex_);
+
     // Starts the writer thread.
-    void StartWriting();
+    void StartWriting() ABSL_LOCKS_EXCLUDED(writing_mutex_);
+
+    // Takes the next frame to send, in priority and round robin order.
+    std::optional<EnqueuedFrame> TakeNextFrameLocked()
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(writing_mutex_);
 
     // Writes the enqueued frame.
     void Write(EnqueuedFrame& enqueued_frame);
@@ -132,20 +190,37 @@ class MultiplexOutputStream {
     Mutex writer_mutex_;
     OutputStream* physical_writer_ ABSL_PT_GUARDED_BY(writer_mutex_);
 
-    ArrayBlockingQueue<EnqueuedFrame> data_queue_{
+    const size_t max_queued_frames_ =
+        FeatureFlags::GetInstance()
+            .GetFlags()
+            .multiplex_socket_middle_priority_queue_capacity;
+    const size_t max_queued_bytes_per_service_ =
+        FeatureFlags::GetInstance()
+            .GetFlags()
+            .multiplex_socket_virtual_socket_max_queued_bytes;
+    const size_t quantum_bytes_ = std::max<size_t>(
         FeatureFlags::GetInstance()
             .GetFlags()
-            .multiplex_socket_middle_priority_queue_capacity};
+            .multiplex_socket_scheduler_quantum_bytes,
+        1);
+
     mutable Mutex writing_mutex_;
-    ConditionVariable is_writing_cond_{&writing_mutex_};
-    bool is_writing_ ABSL_GUARDED_BY(writing_mutex_) = false;
-    bool is_closed_ = false;
-    mutable Mutex close_writing_thread_mutex_;
-    ConditionVariable close_writing_thread_cond_{&close_writing_thread_mutex_};
+    // Signaled when a frame is enqueued, or the writer is closed.
+    ConditionVariable has_frame_cond_{&writing_mutex_};
+    // Signaled when a queued frame is taken, or the writer is closed.
+    ConditionVariable has_space_cond_{&writing_mutex_};
+    std::deque<EnqueuedFrame> high_priority_frames_
+        ABSL_GUARDED_BY(writing_mutex_);
+    absl::flat_hash_map<std::string, ServiceQueue> service_queues_
+        ABSL_GUARDED_BY(writing_mutex_);
+    // Service ids with queued frames, in round robin order.
+    std::deque<std::string> active_services_ ABSL_GUARDED_BY(writing_mutex_);
+    size_t queued_frames_ ABSL_GUARDED_BY(writing_mutex_) = 0;
+    bool is_closed_ ABSL_GUARDED_BY(writing_mutex_) = false;
+    bool is_write_loop_running_ ABSL_GUARDED_BY(writing_mutex_) = false;
 
     // The single thread to write all enqueued frames.
     SingleThreadExecutor writer_thread_;
-    bool is_write_loop_running_ = false;
   };
 
   class VirtualOutputStream : public OutputStream {
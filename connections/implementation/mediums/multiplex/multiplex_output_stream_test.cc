@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
@@ -29,6 +30,7 @@
 #include "internal/platform/byte_array.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/multi_thread_executor.h"
@@ -247,6 +249,167 @@ TEST_F(MultiplexOutputStreamTest, CreateTwoVirtualStreams_SendData) {
   multiplex_output_stream_->Shutdown();
 }
 
+// Holds back every write to the pipe until Release() is called, so frames pile
+// up in the writer queues.
+class GatedOutputStream : public OutputStream {
+ public:
+  explicit GatedOutputStream(OutputStream* writer) : writer_(writer) {}
+
+  Exception Write(const ByteArray& data) override {
+    released_.Await(absl::Seconds(5));
+    return writer_->Write(data);
+  }
+  Exception Flush() override { return writer_->Flush(); }
+  Exception Close() override {
+    Release();
+    return writer_->Close();
+  }
+
+  void Release() { released_.CountDown(); }
+
+ private:
+  OutputStream* writer_;
+  CountDownLatch released_{1};
+};
+
+// Waits until the writer has queued |frames| frames for |service_id|.
+bool WaitForQueuedFrames(MultiplexOutputStream& stream,
+                         absl::string_view service_id, size_t frames) {
+  for (int i = 0; i < 500; i++) {
+    if (stream.GetQueuedFrames(std::string(service_id)) == frames) return true;
+    absl::SleepFor(absl::Milliseconds(10));
+  }
+  return false;
+}
+
+TEST_F(MultiplexOutputStreamTest, SmallFrameIsNotStuckBehindLargeFrames) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  const FeatureFlags::Flags saved_flags = flags;
+  flags.multiplex_socket_scheduler_quantum_bytes = 100;
+  GatedOutputStream gated_writer(writer_.get());
+  multiplex_output_stream_ =
+      std::make_unique<MultiplexOutputStream>(&gated_writer, enabled_);
+  flags = saved_flags;
+  auto bulk_stream = multiplex_output_stream_->CreateVirtualOutputStream(
+      std::string(kServiceId_1), std::string(kSalt_1));
+  auto control_stream = multiplex_output_stream_->CreateVirtualOutputStream(
+      std::string(kServiceId_2), std::string(kSalt_2));
+
+  const ByteArray chunk(std::string(200, 'x'));
+  const ByteArray message("ping");
+  MultiThreadExecutor executor(5);
+  CountDownLatch latch(5);
+  // The first chunk is taken by the writer thread, and blocks it.
+  executor.Execute([&]() {
+    bulk_stream->Write(chunk);
+    latch.CountDown();
+  });
+  absl::SleepFor(absl::Milliseconds(100));
+  for (int i = 0; i < 3; i++) {
+    executor.Execute([&]() {
+      bulk_stream->Write(chunk);
+      latch.CountDown();
+    });
+  }
+  ASSERT_TRUE(WaitForQueuedFrames(*multiplex_output_stream_, kServiceId_1, 3));
+  executor.Execute([&]() {
+    control_stream->Write(message);
+    latch.CountDown();
+  });
+  ASSERT_TRUE(WaitForQueuedFrames(*multiplex_output_stream_, kServiceId_2, 1));
+  EXPECT_GT(multiplex_output_stream_->GetQueuedBytes(std::string(kServiceId_1)),
+            3 * chunk.size());
+
+  gated_writer.Release();
+  EXPECT_TRUE(latch.Await(absl::Milliseconds(5000)).result());
+  std::vector<std::string> received;
+  for (int i = 0; i < 5; i++) {
+    auto frame_data = ReadFrame();
+    ASSERT_TRUE(frame_data.ok());
+    received.push_back(frame_data.result().data_frame().data());
+  }
+  EXPECT_EQ(received[0], std::string(chunk));
+  EXPECT_EQ(received[1], std::string(message));
+  EXPECT_EQ(
+      multiplex_output_stream_->GetQueuedFrames(std::string(kServiceId_1)), 0);
+  multiplex_output_stream_->Shutdown();
+}
+
+TEST_F(MultiplexOutputStreamTest, WriteWaitsForVirtualSocketCredit) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  const FeatureFlags::Flags saved_flags = flags;
+  flags.multiplex_socket_virtual_socket_max_queued_bytes = 10;
+  GatedOutputStream gated_writer(writer_.get());
+  multiplex_output_stream_ =
+      std::make_unique<MultiplexOutputStream>(&gated_writer, enabled_);
+  flags = saved_flags;
+  auto stream_1 = multiplex_output_stream_->CreateVirtualOutputStream(
+      std::string(kServiceId_1), std::string(kSalt_1));
+  auto stream_2 = multiplex_output_stream_->CreateVirtualOutputStream(
+      std::string(kServiceId_2), std::string(kSalt_2));
+
+  const ByteArray data("abcdefg");
+  MultiThreadExecutor executor(4);
+  CountDownLatch latch(4);
+  executor.Execute([&]() {
+    stream_1->Write(data);
+    latch.CountDown();
+  });
+  absl::SleepFor(absl::Milliseconds(100));
+  // One frame fits into the credit of the virtual socket; the next one waits
+  // until it is sent, without holding back the other virtual socket.
+  for (int i = 0; i < 2; i++) {
+    executor.Execute([&]() {
+      stream_1->Write(data);
+      latch.CountDown();
+    });
+  }
+  executor.Execute([&]() {
+    stream_2->Write(data);
+    latch.CountDown();
+  });
+  ASSERT_TRUE(WaitForQueuedFrames(*multiplex_output_stream_, kServiceId_2, 1));
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_EQ(
+      multiplex_output_stream_->GetQueuedFrames(std::string(kServiceId_1)), 1);
+
+  gated_writer.Release();
+  EXPECT_TRUE(latch.Await(absl::Milliseconds(5000)).result());
+  for (int i = 0; i < 4; i++) {
+    ASSERT_TRUE(ReadFrame().ok());
+  }
+  multiplex_output_stream_->Shutdown();
+}
+
+TEST_F(MultiplexOutputStreamTest, ShutdownFailsQueuedFrames) {
+  GatedOutputStream gated_writer(writer_.get());
+  multiplex_output_stream_ =
+      std::make_unique<MultiplexOutputStream>(&gated_writer, enabled_);
+  auto stream = multiplex_output_stream_->CreateVirtualOutputStream(
+      std::string(kServiceId_1), std::string(kSalt_1));
+
+  const ByteArray data("abcdefg");
+  MultiThreadExecutor executor(2);
+  CountDownLatch latch(2);
+  Exception results[2];
+  for (int i = 0; i < 2; i++) {
+    executor.Execute([&, i]() {
+      results[i] = stream->Write(data);
+      latch.CountDown();
+    });
+  }
+  ASSERT_TRUE(WaitForQueuedFrames(*multiplex_output_stream_, kServiceId_1, 1));
+
+  multiplex_output_stream_->Shutdown();
+  EXPECT_TRUE(latch.Await(absl::Milliseconds(5000)).result());
+  // The frame taken by the writer fails on the closed pipe, the queued one
+  // fails when the writer closes.
+  EXPECT_FALSE(results[0].Ok());
+  EXPECT_FALSE(results[1].Ok());
+  EXPECT_EQ(
+      multiplex_output_stream_->GetQueuedFrames(std::string(kServiceId_1)), 0);
+}
+
 }  // namespace multiplex
 }  // namespace mediums
 }  // namespace connections
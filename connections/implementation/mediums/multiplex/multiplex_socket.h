@@ -15,6 +15,7 @@
 #ifndef CORE_INTERNAL_MEDIUMS_MULTIPLEX_MULTIPLEX_SOCKET_H_
 #define CORE_INTERNAL_MEDIUMS_MULTIPLEX_MULTIPLEX_SOCKET_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -100,6 +101,14 @@ class MultiplexSocket {
   MediumSocket* GetVirtualSocket(const std::string& service_id);
   // Gets the virtual socket count.
   int GetVirtualSocketCount();
+  // Gets the number of outgoing frames and bytes queued for the virtual socket
+  // of |service_id|, waiting for the physical socket.
+  size_t GetQueuedOutgoingFrames(const std::string& service_id) const {
+    return multiplex_output_stream_.GetQueuedFrames(service_id);
+  }
+  size_t GetQueuedOutgoingBytes(const std::string& service_id) const {
+    return multiplex_output_stream_.GetQueuedBytes(service_id);
+  }
 
   void ListVirtualSocket();
 
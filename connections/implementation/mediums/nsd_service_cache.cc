@@ -0,0 +1,85 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "connections/implementation/mediums/nsd_service_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "internal/platform/nsd_service_info.h"
+
+namespace nearby {
+namespace connections {
+
+namespace {
+
+bool IsSameServiceInfo(const NsdServiceInfo& a, const NsdServiceInfo& b) {
+  return a.GetServiceName() == b.GetServiceName() &&
+         a.GetServiceType() == b.GetServiceType() &&
+         a.GetIPAddress() == b.GetIPAddress() && a.GetPort() == b.GetPort() &&
+         a.GetTxtRecords() == b.GetTxtRecords();
+}
+
+}  // namespace
+
+bool NsdServiceCache::Put(const std::string& service_id,
+                          const NsdServiceInfo& service_info, absl::Time now) {
+  Entry& entry = services_[service_id][service_info.GetServiceName()];
+  bool is_same = entry.expiry_time > now &&
+                 IsSameServiceInfo(entry.service_info, service_info);
+  entry.service_info = service_info;
+  entry.expiry_time = now + ttl_;
+  return !is_same;
+}
+
+bool NsdServiceCache::Remove(const std::string& service_id,
+                             const std::string& service_name) {
+  auto it = services_.find(service_id);
+  if (it == services_.end() || it->second.erase(service_name) == 0) {
+    return false;
+  }
+  if (it->second.empty()) {
+    services_.erase(it);
+  }
+  return true;
+}
+
+std::vector<NsdServiceInfo> NsdServiceCache::Get(const std::string& service_id,
+                                                 absl::Time now) {
+  std::vector<NsdServiceInfo> result;
+  auto it = services_.find(service_id);
+  if (it == services_.end()) {
+    return result;
+  }
+  absl::erase_if(it->second, [now](const auto& item) {
+    return item.second.expiry_time <= now;
+  });
+  for (const auto& item : it->second) {
+    result.push_back(item.second.service_info);
+  }
+  if (it->second.empty()) {
+    services_.erase(it);
+  }
+  return result;
+}
+
+int NsdServiceCache::GetSize(const std::string& service_id) const {
+  auto it = services_.find(service_id);
+  return it == services_.end() ? 0 : it->second.size();
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,68 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef CORE_INTERNAL_MEDIUMS_NSD_SERVICE_CACHE_H_
+#define CORE_INTERNAL_MEDIUMS_NSD_SERVICE_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/nsd_service_info.h"
+
+namespace nearby {
+namespace connections {
+
+// Caches the NSD services found by WifiLan discovery, per service id, so a
+// restarted discovery can report them before they are resolved again.
+//
+// Every service expires |ttl| after it was last found. Not thread safe.
+class NsdServiceCache {
+ public:
+  explicit NsdServiceCache(absl::Duration ttl) : ttl_(ttl) {}
+
+  // Caches |service_info| found at |now|. Returns false if the same service
+  // info was cached already, and hasn't expired.
+  bool Put(const std::string& service_id, const NsdServiceInfo& service_info,
+           absl::Time now);
+
+  // Removes the service named |service_name|. Returns false if it wasn't
+  // cached.
+  bool Remove(const std::string& service_id, const std::string& service_name);
+
+  // Returns the services of |service_id| that haven't expired at |now|, and
+  // drops the expired ones.
+  std::vector<NsdServiceInfo> Get(const std::string& service_id,
+                                  absl::Time now);
+
+  int GetSize(const std::string& service_id) const;
+
+ private:
+  struct Entry {
+    NsdServiceInfo service_info;
+    absl::Time expiry_time;
+  };
+
+  const absl::Duration ttl_;
+  // A map of service_id -> service name -> Entry.
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, Entry>>
+      services_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_MEDIUMS_NSD_SERVICE_CACHE_H_
@@ -0,0 +1,98 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "connections/implementation/mediums/nsd_service_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/nsd_service_info.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr char kServiceId[] = "service_id";
+constexpr absl::Duration kTtl = absl::Seconds(10);
+
+NsdServiceInfo MakeServiceInfo(const std::string& name,
+                               const std::string& endpoint_info) {
+  NsdServiceInfo service_info;
+  service_info.SetServiceName(name);
+  service_info.SetTxtRecord("n", endpoint_info);
+  service_info.SetIPAddress("\x7f\x00\x00\x01");
+  service_info.SetPort(1234);
+  return service_info;
+}
+
+TEST(NsdServiceCacheTest, PutReportsNewAndChangedServices) {
+  NsdServiceCache cache(kTtl);
+  absl::Time now = absl::UnixEpoch();
+
+  EXPECT_TRUE(cache.Put(kServiceId, MakeServiceInfo("a", "info"), now));
+  EXPECT_FALSE(cache.Put(kServiceId, MakeServiceInfo("a", "info"), now));
+  EXPECT_TRUE(cache.Put(kServiceId, MakeServiceInfo("a", "new info"), now));
+  EXPECT_TRUE(cache.Put(kServiceId, MakeServiceInfo("b", "info"), now));
+  EXPECT_EQ(cache.GetSize(kServiceId), 2);
+}
+
+TEST(NsdServiceCacheTest, GetReturnsLatestServiceInfo) {
+  NsdServiceCache cache(kTtl);
+  absl::Time now = absl::UnixEpoch();
+  cache.Put(kServiceId, MakeServiceInfo("a", "info"), now);
+  cache.Put(kServiceId, MakeServiceInfo("a", "new info"), now);
+
+  std::vector<NsdServiceInfo> service_infos = cache.Get(kServiceId, now);
+
+  ASSERT_EQ(service_infos.size(), 1);
+  EXPECT_EQ(service_infos[0].GetServiceName(), "a");
+  EXPECT_EQ(service_infos[0].GetTxtRecord("n"), "new info");
+  EXPECT_TRUE(cache.Get("other_service_id", now).empty());
+}
+
+TEST(NsdServiceCacheTest, ServicesExpireTtlAfterLastFound) {
+  NsdServiceCache cache(kTtl);
+  absl::Time now = absl::UnixEpoch();
+  cache.Put(kServiceId, MakeServiceInfo("a", "info"), now);
+  cache.Put(kServiceId, MakeServiceInfo("b", "info"), now);
+  cache.Put(kServiceId, MakeServiceInfo("b", "info"), now + absl::Seconds(5));
+
+  std::vector<NsdServiceInfo> service_infos =
+      cache.Get(kServiceId, now + kTtl);
+
+  ASSERT_EQ(service_infos.size(), 1);
+  EXPECT_EQ(service_infos[0].GetServiceName(), "b");
+  EXPECT_EQ(cache.GetSize(kServiceId), 1);
+  // An expired service found again is new.
+  EXPECT_TRUE(cache.Put(kServiceId, MakeServiceInfo("b", "info"),
+                        now + absl::Seconds(20)));
+}
+
+TEST(NsdServiceCacheTest, RemoveDropsService) {
+  NsdServiceCache cache(kTtl);
+  absl::Time now = absl::UnixEpoch();
+  cache.Put(kServiceId, MakeServiceInfo("a", "info"), now);
+
+  EXPECT_TRUE(cache.Remove(kServiceId, "a"));
+  EXPECT_FALSE(cache.Remove(kServiceId, "a"));
+  EXPECT_EQ(cache.GetSize(kServiceId), 0);
+  EXPECT_TRUE(cache.Put(kServiceId, MakeServiceInfo("a", "info"), now));
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
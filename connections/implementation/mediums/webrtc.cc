@@ -41,6 +41,7 @@
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/runnable.h"
+#include "internal/platform/system_clock.h"
 #include "internal/platform/webrtc.h"
 #include "webrtc/api/jsep.h"
 
@@ -120,7 +121,7 @@ bool WebRtc::StartAcceptingConnections(const std::string& service_id,
   info.self_peer_id = self_peer_id;
   info.accepted_connection_callback = std::move(callback);
 
-  medium_->SetNonCellular(non_cellular);
+  SetNonCellular(non_cellular);
 
   // Create a new SignalingMessenger so that we can communicate w/ Tachyon.
   info.signaling_messenger =
@@ -214,7 +215,10 @@ ErrorOr<WebRtcSocketWrapper> WebRtc::Connect(
     const LocationHint& location_hint, CancellationFlag* cancellation_flag,
     bool non_cellular) {
   service_id_to_connect_attempts_count_map_[service_id] = 1;
-  medium_->SetNonCellular(non_cellular);
+  {
+    MutexLock lock(&mutex_);
+    SetNonCellular(non_cellular);
+  }
   ErrorOr<WebRtcSocketWrapper> wrapper_result = {
       Error(OperationResultCode::DETAIL_UNKNOWN)};
   while (service_id_to_connect_attempts_count_map_[service_id] <=
@@ -723,10 +727,29 @@ std::unique_ptr<ConnectionFlow> WebRtc::CreateConnectionFlow(
     const std::string& service_id, const WebrtcPeerId& remote_peer_id) {
   RemoveConnectionFlow(remote_peer_id);
 
+  std::unique_ptr<ConnectionFlow> connection_flow;
+  std::shared_ptr<ConnectionFlowPeer> peer;
+  if (prewarmed_connection_flow_.has_value() &&
+      prewarmed_connection_flow_->non_cellular == non_cellular_) {
+    NEARBY_LOGS(INFO) << "Using the pre-warmed ConnectionFlow for peer "
+                      << remote_peer_id.GetId();
+    prewarmed_connection_flow_->expiry_alarm->Cancel();
+    connection_flow = std::move(prewarmed_connection_flow_->connection_flow);
+    peer = std::move(prewarmed_connection_flow_->peer);
+    prewarmed_connection_flow_.reset();
+  } else {
+    peer = std::make_shared<ConnectionFlowPeer>();
+    connection_flow = NewConnectionFlow(peer);
+  }
+  peer->Set(service_id, remote_peer_id);
+  return connection_flow;
+}
+
+std::unique_ptr<ConnectionFlow> WebRtc::NewConnectionFlow(
+    std::shared_ptr<ConnectionFlowPeer> peer) {
   return ConnectionFlow::Create(
       {.local_ice_candidate_found_cb =
-           {[this, service_id, remote_peer_id](
-                const webrtc::IceCandidateInterface* ice_candidate) {
+           {[this, peer](const webrtc::IceCandidateInterface* ice_candidate) {
              // Note: We need to encode the ice candidate here, before we jump
              // off the thread. Otherwise, it gets destroyed and we can't read
              // it later.
@@ -734,25 +757,30 @@ std::unique_ptr<ConnectionFlow> WebRtc::CreateConnectionFlow(
                  webrtc_frames::EncodeIceCandidate(*ice_candidate);
              OffloadFromThread(
                  "rtc-ice-candidates",
-                 [this, service_id, remote_peer_id, encoded_ice_candidate]() {
+                 [this, service_id = peer->GetServiceId(),
+                  remote_peer_id = peer->GetRemotePeerId(),
+                  encoded_ice_candidate]() {
                    ProcessLocalIceCandidate(service_id, remote_peer_id,
                                             encoded_ice_candidate);
                  });
            }}},
       {
-          .data_channel_open_cb = {[this, service_id, remote_peer_id](
+          .data_channel_open_cb = {[this, peer](
                                        WebRtcSocketWrapper socket_wrapper) {
             OffloadFromThread(
                 "rtc-channel-created",
-                [this, service_id, remote_peer_id, socket_wrapper]() {
+                [this, service_id = peer->GetServiceId(),
+                 remote_peer_id = peer->GetRemotePeerId(), socket_wrapper]() {
                   ProcessDataChannelOpen(service_id, remote_peer_id,
                                          socket_wrapper);
                 });
           }},
-          .data_channel_closed_cb = {[this, remote_peer_id]() {
-            OffloadFromThread("rtc-channel-closed", [this, remote_peer_id]() {
-              ProcessDataChannelClosed(remote_peer_id);
-            });
+          .data_channel_closed_cb = {[this, peer]() {
+            OffloadFromThread(
+                "rtc-channel-closed",
+                [this, remote_peer_id = peer->GetRemotePeerId()]() {
+                  ProcessDataChannelClosed(remote_peer_id);
+                });
           }},
       },
       {
@@ -770,6 +798,86 @@ std::unique_ptr<ConnectionFlow> WebRtc::CreateConnectionFlow(
       *medium_);
 }
 
+void WebRtc::PrewarmConnectionFlow(bool non_cellular) {
+  OffloadFromThread("rtc-prewarm-connection-flow", [this, non_cellular]() {
+    MutexLock lock(&mutex_);
+    if (!IsAvailable()) {
+      NEARBY_LOGS(INFO) << "Cannot pre-warm a WebRTC ConnectionFlow because "
+                           "WebRTC is not available.";
+      return;
+    }
+    if (prewarmed_connection_flow_.has_value() &&
+        prewarmed_connection_flow_->non_cellular == non_cellular) {
+      return;
+    }
+
+    // The medium creates the peer connection with its current cellular
+    // setting, which the connections in progress rely on. Switch it over only
+    // while our peer connection is created.
+    auto peer = std::make_shared<ConnectionFlowPeer>();
+    bool previous_non_cellular = non_cellular_;
+    SetNonCellular(non_cellular);
+    std::unique_ptr<ConnectionFlow> connection_flow = NewConnectionFlow(peer);
+    SetNonCellular(previous_non_cellular);
+    if (!connection_flow) {
+      NEARBY_LOGS(INFO) << "Failed to pre-warm a WebRTC ConnectionFlow.";
+      return;
+    }
+
+    prewarmed_connection_flow_ = PrewarmedConnectionFlow{
+        .connection_flow = std::move(connection_flow),
+        .peer = std::move(peer),
+        .non_cellular = non_cellular,
+        .expires_at =
+            SystemClock::ElapsedRealtime() + kPrewarmedConnectionFlowLifetime,
+        .expiry_alarm = std::make_unique<CancelableAlarm>(
+            "expire_prewarmed_connection_flow_webrtc",
+            [this]() { DropExpiredPrewarmedConnectionFlow(); },
+            kPrewarmedConnectionFlowLifetime, &single_thread_executor_),
+    };
+    NEARBY_LOGS(INFO) << "Pre-warmed a WebRTC ConnectionFlow.";
+  });
+}
+
+void WebRtc::DropExpiredPrewarmedConnectionFlow() {
+  MutexLock lock(&mutex_);
+  // The alarm may have fired while its ConnectionFlow was taken, and another
+  // one pre-warmed since.
+  if (!prewarmed_connection_flow_.has_value() ||
+      SystemClock::ElapsedRealtime() < prewarmed_connection_flow_->expires_at) {
+    return;
+  }
+  NEARBY_LOGS(INFO) << "Dropping the unused pre-warmed WebRTC ConnectionFlow.";
+  prewarmed_connection_flow_.reset();
+}
+
+bool WebRtc::HasPrewarmedConnectionFlow() {
+  MutexLock lock(&mutex_);
+  return prewarmed_connection_flow_.has_value();
+}
+
+void WebRtc::SetNonCellular(bool non_cellular) {
+  non_cellular_ = non_cellular;
+  medium_->SetNonCellular(non_cellular);
+}
+
+void WebRtc::ConnectionFlowPeer::Set(const std::string& service_id,
+                                     const WebrtcPeerId& remote_peer_id) {
+  MutexLock lock(&mutex_);
+  service_id_ = service_id;
+  remote_peer_id_ = remote_peer_id;
+}
+
+std::string WebRtc::ConnectionFlowPeer::GetServiceId() {
+  MutexLock lock(&mutex_);
+  return service_id_;
+}
+
+WebrtcPeerId WebRtc::ConnectionFlowPeer::GetRemotePeerId() {
+  MutexLock lock(&mutex_);
+  return remote_peer_id_;
+}
+
 void WebRtc::AdapterTypeChangedHandler(rtc::AdapterType adapter_type) {
   MutexLock lock(&mutex_);
   is_using_cellular_ = adapter_type == rtc::ADAPTER_TYPE_CELLULAR ||
@@ -19,12 +19,14 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
 #include "connections/implementation/mediums/webrtc/connection_flow.h"
 #include "connections/implementation/mediums/webrtc/session_description_wrapper.h"
 #include "connections/implementation/mediums/webrtc_peer_id.h"
@@ -93,10 +95,20 @@ class WebRtc {
 
   bool IsUsingCellular() ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Creates a peer connection ahead of the next connection, outgoing or
+  // incoming, so that the connection only has to exchange the offer, the
+  // answer and the ICE candidates. The peer connection is dropped if no
+  // connection used it after kPrewarmedConnectionFlowLifetime. Doesn't block.
+  void PrewarmConnectionFlow(bool non_cellular) ABSL_LOCKS_EXCLUDED(mutex_);
+
  protected:
   // Use for unit tests only to inject a WebRtcMedium.
   explicit WebRtc(std::unique_ptr<WebRtcMedium> medium);
 
+  // Used in unit tests to check whether a pre-warmed ConnectionFlow is waiting
+  // for a connection.
+  bool HasPrewarmedConnectionFlow() ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Used in unit tests to determine how many calls to `AttemptToConnect`
   // occured during a call to `Connect`, per service id.
   std::map<std::string, int> service_id_to_connect_attempts_count_map_;
@@ -104,6 +116,8 @@ class WebRtc {
  private:
   static constexpr int kConnectAttemptsLimit = 3;
   static constexpr int kRestartAcceptConnectionsLimit = 3;
+  static constexpr absl::Duration kPrewarmedConnectionFlowLifetime =
+      absl::Seconds(30);
 
   enum class Role {
     kNone = 0,
@@ -148,6 +162,34 @@ class WebRtc {
     Future<WebRtcSocketWrapper> socket_future;
   };
 
+  // The service and the remote peer a ConnectionFlow connects to. A pre-warmed
+  // ConnectionFlow is created before they are known, so its callbacks look
+  // them up when they run.
+  class ConnectionFlowPeer {
+   public:
+    void Set(const std::string& service_id, const WebrtcPeerId& remote_peer_id)
+        ABSL_LOCKS_EXCLUDED(mutex_);
+    std::string GetServiceId() ABSL_LOCKS_EXCLUDED(mutex_);
+    WebrtcPeerId GetRemotePeerId() ABSL_LOCKS_EXCLUDED(mutex_);
+
+   private:
+    Mutex mutex_;
+    std::string service_id_ ABSL_GUARDED_BY(mutex_);
+    WebrtcPeerId remote_peer_id_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  struct PrewarmedConnectionFlow {
+    std::unique_ptr<ConnectionFlow> connection_flow;
+    std::shared_ptr<ConnectionFlowPeer> peer;
+
+    // The cellular setting the peer connection was created with.
+    bool non_cellular = false;
+
+    // Drops the ConnectionFlow once it expired.
+    absl::Time expires_at;
+    std::unique_ptr<CancelableAlarm> expiry_alarm;
+  };
+
   // Attempt to initiates a WebRtc connection with peer device identified by
   // |peer_id|.
   // Runs on @MainThread.
@@ -203,6 +245,17 @@ class WebRtc {
       const std::string& service_id, const WebrtcPeerId& remote_peer_id)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Creates a ConnectionFlow whose callbacks report to whoever |peer| names.
+  std::unique_ptr<ConnectionFlow> NewConnectionFlow(
+      std::shared_ptr<ConnectionFlowPeer> peer)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Runs on |single_thread_executor_|.
+  void DropExpiredPrewarmedConnectionFlow() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Sets the cellular setting of the peer connections created from now on.
+  void SetNonCellular(bool non_cellular) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // Runs on |single_thread_executor_|.
   std::unique_ptr<ConnectionFlow> GetConnectionFlow(
       const WebrtcPeerId& remote_peer_id) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -264,7 +317,15 @@ class WebRtc {
   absl::flat_hash_map<std::string, std::unique_ptr<ConnectionFlow>>
       connection_flows_ ABSL_GUARDED_BY(mutex_);
 
+  // A ConnectionFlow created ahead of the connection it will serve. Taken by
+  // the next CreateConnectionFlow() with the same cellular setting.
+  std::optional<PrewarmedConnectionFlow> prewarmed_connection_flow_
+      ABSL_GUARDED_BY(mutex_);
+
   bool is_using_cellular_ ABSL_GUARDED_BY(mutex_) = true;
+
+  // The cellular setting last passed to |medium_|.
+  bool non_cellular_ ABSL_GUARDED_BY(mutex_) = false;
 };
 
 }  // namespace mediums
@@ -0,0 +1,58 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/mediums/webrtc/send_buffer_watermarks.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+
+void SendBufferWatermarks::OnSent(std::uint64_t bytes, absl::Time now) {
+  if (sample_start_ == absl::InfinitePast()) {
+    // The first report only starts the clock; the bytes were sent during an
+    // unknown time before it.
+    sample_start_ = now;
+    return;
+  }
+  sample_bytes_ += bytes;
+  absl::Duration elapsed = now - sample_start_;
+  if (elapsed < kSampleInterval) return;
+
+  double sample = sample_bytes_ / absl::ToDoubleSeconds(elapsed);
+  drain_rate_ =
+      drain_rate_ == 0
+          ? sample
+          : drain_rate_ + kDrainRateSmoothing * (sample - drain_rate_);
+  sample_start_ = now;
+  sample_bytes_ = 0;
+
+  double target = drain_rate_ * absl::ToDoubleSeconds(kTargetDrainTime);
+  high_watermark_ = std::clamp(static_cast<std::uint64_t>(target),
+                               kMinHighWatermark, kMaxHighWatermark);
+}
+
+bool SendBufferWatermarks::CanSend(std::uint64_t buffered_amount,
+                                   bool waiting) const {
+  if (waiting) return buffered_amount <= GetLowWatermark();
+  return buffered_amount < GetHighWatermark();
+}
+
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,72 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_MEDIUMS_WEBRTC_SEND_BUFFER_WATERMARKS_H_
+#define CORE_INTERNAL_MEDIUMS_WEBRTC_SEND_BUFFER_WATERMARKS_H_
+
+#include <cstdint>
+
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+
+// Decides how much data may wait in the send buffer of a WebRTC data channel.
+//
+// The buffer should hold about |target_drain_time| worth of data: enough to
+// keep a fast path busy while the writer is woken up, but not so much that a
+// slow relay queues seconds of data. The drain rate is measured from the
+// bytes the data channel reports as sent. Writers may add data while the
+// buffer is below the high watermark; once it is reached they wait until the
+// buffer drained to the low watermark, half of it.
+//
+// Not thread-safe.
+class SendBufferWatermarks {
+ public:
+  static constexpr std::uint64_t kInitialHighWatermark = 1024 * 1024;
+  static constexpr std::uint64_t kMinHighWatermark = 64 * 1024;
+  // Well below the 16 MB at which the data channel refuses to buffer more.
+  static constexpr std::uint64_t kMaxHighWatermark = 8 * 1024 * 1024;
+  static constexpr absl::Duration kTargetDrainTime = absl::Milliseconds(250);
+  // Sent bytes are turned into a drain rate sample at most this often.
+  static constexpr absl::Duration kSampleInterval = absl::Milliseconds(100);
+  // Weight of the latest sample in the drain rate.
+  static constexpr double kDrainRateSmoothing = 0.25;
+
+  // Reports that the data channel sent |bytes| from its buffer at |now|.
+  void OnSent(std::uint64_t bytes, absl::Time now);
+
+  // Returns whether a writer may add data to a buffer holding
+  // |buffered_amount| bytes. |waiting| tells whether the writer is already
+  // waiting for the buffer to drain.
+  bool CanSend(std::uint64_t buffered_amount, bool waiting) const;
+
+  std::uint64_t GetHighWatermark() const { return high_watermark_; }
+  std::uint64_t GetLowWatermark() const { return high_watermark_ / 2; }
+  // 0 until measured.
+  double GetDrainRate() const { return drain_rate_; }
+
+ private:
+  std::uint64_t high_watermark_ = kInitialHighWatermark;
+  double drain_rate_ = 0;
+  absl::Time sample_start_ = absl::InfinitePast();
+  std::uint64_t sample_bytes_ = 0;
+};
+
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_MEDIUMS_WEBRTC_SEND_BUFFER_WATERMARKS_H_
@@ -0,0 +1,95 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/mediums/webrtc/send_buffer_watermarks.h"
+
+#include <cstdint>
+
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace connections {
+namespace mediums {
+namespace {
+
+// Reports |bytes_per_second| worth of sends for a second, in 100 ms steps.
+void DrainAt(SendBufferWatermarks& watermarks, double bytes_per_second,
+             absl::Time& now) {
+  for (int i = 0; i < 10; i++) {
+    now += absl::Milliseconds(100);
+    watermarks.OnSent(static_cast<std::uint64_t>(bytes_per_second / 10), now);
+  }
+}
+
+TEST(SendBufferWatermarksTest, StartsAtOneMegabyte) {
+  SendBufferWatermarks watermarks;
+
+  EXPECT_EQ(watermarks.GetHighWatermark(), 1024 * 1024);
+  EXPECT_EQ(watermarks.GetLowWatermark(), 512 * 1024);
+  EXPECT_EQ(watermarks.GetDrainRate(), 0);
+}
+
+TEST(SendBufferWatermarksTest, FollowsDrainRate) {
+  SendBufferWatermarks watermarks;
+  absl::Time now = absl::Now();
+  watermarks.OnSent(0, now);
+
+  // 8 MB/s keeps 2 MB buffered for the 250 ms target.
+  DrainAt(watermarks, 8 * 1024 * 1024, now);
+
+  EXPECT_NEAR(watermarks.GetDrainRate(), 8 * 1024 * 1024, 1024);
+  EXPECT_NEAR(watermarks.GetHighWatermark(), 2 * 1024 * 1024, 1024);
+}
+
+TEST(SendBufferWatermarksTest, ShrinksOnSlowPaths) {
+  SendBufferWatermarks watermarks;
+  absl::Time now = absl::Now();
+  watermarks.OnSent(0, now);
+
+  DrainAt(watermarks, 10 * 1024, now);
+
+  EXPECT_EQ(watermarks.GetHighWatermark(),
+            SendBufferWatermarks::kMinHighWatermark);
+}
+
+TEST(SendBufferWatermarksTest, IsCappedOnFastPaths) {
+  SendBufferWatermarks watermarks;
+  absl::Time now = absl::Now();
+  watermarks.OnSent(0, now);
+
+  DrainAt(watermarks, 1024 * 1024 * 1024, now);
+
+  EXPECT_EQ(watermarks.GetHighWatermark(),
+            SendBufferWatermarks::kMaxHighWatermark);
+}
+
+TEST(SendBufferWatermarksTest, WaitingWritersResumeAtLowWatermark) {
+  SendBufferWatermarks watermarks;
+  std::uint64_t high = watermarks.GetHighWatermark();
+  std::uint64_t low = watermarks.GetLowWatermark();
+
+  EXPECT_TRUE(watermarks.CanSend(high - 1, /*waiting=*/false));
+  EXPECT_FALSE(watermarks.CanSend(high, /*waiting=*/false));
+  // Once waiting, the buffer has to drain to the low watermark.
+  EXPECT_FALSE(watermarks.CanSend(high - 1, /*waiting=*/true));
+  EXPECT_FALSE(watermarks.CanSend(low + 1, /*waiting=*/true));
+  EXPECT_TRUE(watermarks.CanSend(low, /*waiting=*/true));
+}
+
+}  // namespace
+}  // namespace mediums
+}  // namespace connections
+}  // namespace nearby
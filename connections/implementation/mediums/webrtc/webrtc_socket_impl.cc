@@ -12,40 +12,125 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <string>
-#include <tuple>
 #include <utility>
 
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/input_stream.h"
-#include "internal/platform/pipe.h"
 #ifndef NO_WEBRTC
 
 #include "connections/implementation/mediums/webrtc/webrtc_socket_impl.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
 
 namespace nearby {
 namespace connections {
 namespace mediums {
 
+// InputStreamImpl
+void WebRtcSocket::InputStreamImpl::Push(
+    const rtc::CopyOnWriteBuffer& message) {
+  // An empty read means end of stream, so empty messages are skipped.
+  if (message.size() == 0) return;
+  MutexLock lock(&mutex_);
+  if (closed_) return;
+  messages_.push_back(message);
+  message_cond_.Notify();
+}
+
+bool WebRtcSocket::InputStreamImpl::WaitForMessage() {
+  while (!closed_ && messages_.empty()) {
+    message_cond_.Wait();
+  }
+  return !closed_;
+}
+
+ExceptionOr<ByteArray> WebRtcSocket::InputStreamImpl::Read(std::int64_t size) {
+  MutexLock lock(&mutex_);
+  if (!WaitForMessage()) {
+    return ExceptionOr<ByteArray>(Exception::kIo);
+  }
+  if (size <= 0) {
+    return ExceptionOr<ByteArray>(ByteArray());
+  }
+  const rtc::CopyOnWriteBuffer& message = messages_.front();
+  size_t read_size =
+      std::min(static_cast<size_t>(size), message.size() - front_offset_);
+  ByteArray bytes(message.data<char>() + front_offset_, read_size);
+  front_offset_ += read_size;
+  if (front_offset_ == message.size()) {
+    messages_.pop_front();
+    front_offset_ = 0;
+  }
+  return ExceptionOr<ByteArray>(std::move(bytes));
+}
+
+ExceptionOr<ByteArray> WebRtcSocket::InputStreamImpl::ReadLengthPrefixedFrame(
+    std::int32_t max_size) {
+  {
+    MutexLock lock(&mutex_);
+    if (!WaitForMessage()) {
+      return ExceptionOr<ByteArray>(Exception::kIo);
+    }
+    const rtc::CopyOnWriteBuffer& message = messages_.front();
+    if (front_offset_ == 0 && message.size() >= sizeof(std::int32_t)) {
+      const std::uint8_t* header = message.data();
+      std::int64_t size = (static_cast<std::int64_t>(header[0]) << 24) |
+                          (header[1] << 16) | (header[2] << 8) | header[3];
+      if (size <= max_size &&
+          static_cast<size_t>(size) + sizeof(std::int32_t) == message.size()) {
+        ByteArray bytes(message.data<char>() + sizeof(std::int32_t), size);
+        messages_.pop_front();
+        return ExceptionOr<ByteArray>(std::move(bytes));
+      }
+    }
+  }
+  // The frame is split over several messages, e.g. sent by a peer that
+  // writes its length on its own.
+  return InputStream::ReadLengthPrefixedFrame(max_size);
+}
+
+Exception WebRtcSocket::InputStreamImpl::Close() {
+  MutexLock lock(&mutex_);
+  closed_ = true;
+  messages_.clear();
+  front_offset_ = 0;
+  message_cond_.Notify();
+  return {Exception::kSuccess};
+}
+
 // OutputStreamImpl
 Exception WebRtcSocket::OutputStreamImpl::Write(const ByteArray& data) {
-  if (data.size() > kMaxDataSize) {
+  const ByteArray* buffers[] = {&data};
+  return Writev(buffers);
+}
+
+Exception WebRtcSocket::OutputStreamImpl::Writev(
+    absl::Span<const ByteArray* const> buffers) {
+  size_t size = 0;
+  for (const ByteArray* buffer : buffers) size += buffer->size();
+  if (size > kMaxDataSize) {
+    if (buffers.size() > 1) {
+      // Each buffer may still fit in a message of its own.
+      return OutputStream::Writev(buffers);
+    }
     NEARBY_LOGS(WARNING) << "Sending data larger than 1MB";
     return {Exception::kIo};
   }
 
-  socket_->BlockUntilSufficientSpaceInBuffer(data.size());
+  socket_->BlockUntilSufficientSpaceInBuffer();
 
   if (socket_->IsClosed()) {
     NEARBY_LOGS(WARNING) << "Tried sending message while socket is closed";
     return {Exception::kIo};
   }
 
-  if (!socket_->SendMessage(data)) {
+  if (!socket_->SendMessage(buffers, size)) {
     NEARBY_LOGS(INFO) << "Unable to write data to socket.";
     return {Exception::kIo};
   }
@@ -69,7 +154,6 @@ WebRtcSocket::WebRtcSocket(
     : name_(name), data_channel_(std::move(data_channel)) {
   NEARBY_LOGS(INFO) << "WebRtcSocket::WebRtcSocket(" << name_
                     << ") this: " << this;
-  std::tie(pipe_input_, pipe_output_) = CreatePipe();
   data_channel_->RegisterObserver(this);
 }
 
@@ -86,7 +170,7 @@ WebRtcSocket::~WebRtcSocket() {
                     << ") this: " << this << " done";
 }
 
-InputStream& WebRtcSocket::GetInputStream() { return *pipe_input_; }
+InputStream& WebRtcSocket::GetInputStream() { return input_stream_; }
 
 OutputStream& WebRtcSocket::GetOutputStream() { return output_stream_; }
 
@@ -94,7 +178,7 @@ Exception WebRtcSocket::Close() {
   NEARBY_LOGS(INFO) << "WebRtcSocket::Close(" << name_ << ") this: " << this;
   if (closed_.Set(true)) return {Exception::kSuccess};
 
-  ClosePipe();
+  CloseStreams();
   // NOTE: This call blocks and triggers a state change on the siginaling thread
   // to 'closing' but does not block until 'closed' is sent so the data channel
   // is not fully closed when this call is done.
@@ -128,51 +212,56 @@ void WebRtcSocket::OnStateChange() {
       socket_listener_.socket_closed_cb(this);
 
       if (!closed_.Set(true)) {
-        OffloadFromSignalingThread([this] { ClosePipe(); });
+        OffloadFromSignalingThread([this] { CloseStreams(); });
       }
       break;
   }
 }
 void WebRtcSocket::OnMessage(const webrtc::DataBuffer& buffer) {
-  // This is a data channel callback on the signaling thread, lets off load so
-  // we don't block signaling.
-  OffloadFromSignalingThread(
-      [this, buffer = ByteArray(buffer.data.data<char>(), buffer.size())] {
-        if (!pipe_output_->Write(buffer).Ok()) {
-          Close();
-          return;
-        }
-
-        if (!pipe_output_->Flush().Ok()) {
-          Close();
-        }
-      });
+  // This is a data channel callback on the signaling thread. Queueing the
+  // message only takes a reference to its data, and never blocks.
+  input_stream_.Push(buffer.data);
 }
 
 void WebRtcSocket::OnBufferedAmountChange(uint64_t sent_data_size) {
   // This is a data channel callback on the signaling thread, lets off load so
   // we don't block signaling.
-  OffloadFromSignalingThread([this] { WakeUpWriter(); });
+  OffloadFromSignalingThread([this, sent_data_size] {
+    MutexLock lock(&backpressure_mutex_);
+    watermarks_.OnSent(sent_data_size, SystemClock::ElapsedRealtime());
+    buffer_variable_.Notify();
+  });
 }
 
-bool WebRtcSocket::SendMessage(const ByteArray& data) {
-  return data_channel_->Send(
-      webrtc::DataBuffer(std::string(data.data(), data.size())));
+WebRtcSocket::SendBufferStats WebRtcSocket::GetSendBufferStats() const {
+  MutexLock lock(&backpressure_mutex_);
+  return {.buffered_amount = data_channel_->buffered_amount(),
+          .high_watermark = watermarks_.GetHighWatermark(),
+          .low_watermark = watermarks_.GetLowWatermark(),
+          .drain_bytes_per_second = watermarks_.GetDrainRate()};
+}
+
+bool WebRtcSocket::SendMessage(absl::Span<const ByteArray* const> buffers,
+                               size_t size) {
+  rtc::CopyOnWriteBuffer message;
+  message.EnsureCapacity(size);
+  for (const ByteArray* buffer : buffers) {
+    message.AppendData(buffer->data(), buffer->size());
+  }
+  return data_channel_->Send(webrtc::DataBuffer(message, /*binary=*/false));
 }
 
 bool WebRtcSocket::IsClosed() { return closed_.Get(); }
 
-void WebRtcSocket::ClosePipe() {
-  NEARBY_LOGS(INFO) << "WebRtcSocket::ClosePipe(" << name_
+void WebRtcSocket::CloseStreams() {
+  NEARBY_LOGS(INFO) << "WebRtcSocket::CloseStreams(" << name_
                     << ") this: " << this;
-  // This is thread-safe to close these sockets even if a read or write is in
-  // process on another thread, Close will wait for the exclusive mutex before
-  // setting state.
-  pipe_input_->Close();
-  pipe_output_->Close();
+  // This is thread-safe even if a read or write is in progress on another
+  // thread; both wait for their stream's mutex before changing state.
+  input_stream_.Close();
   WakeUpWriter();
-  NEARBY_LOGS(INFO) << "WebRtcSocket::ClosePipe(" << name_ << ") this: " << this
-                    << " done";
+  NEARBY_LOGS(INFO) << "WebRtcSocket::CloseStreams(" << name_
+                    << ") this: " << this << " done";
 }
 
 // Must not be called on signalling thread.
@@ -185,10 +274,12 @@ void WebRtcSocket::SetSocketListener(SocketListener&& listener) {
   socket_listener_ = std::move(listener);
 }
 
-void WebRtcSocket::BlockUntilSufficientSpaceInBuffer(int length) {
+void WebRtcSocket::BlockUntilSufficientSpaceInBuffer() {
   MutexLock lock(&backpressure_mutex_);
+  bool waiting = false;
   while (!IsClosed() &&
-         (data_channel_->buffered_amount() + length > kMaxDataSize)) {
+         !watermarks_.CanSend(data_channel_->buffered_amount(), waiting)) {
+    waiting = true;
     // TODO(himanshujaju): Add wait with timeout.
     buffer_variable_.Wait();
   }
@@ -15,7 +15,9 @@
 #ifndef CORE_INTERNAL_MEDIUMS_WEBRTC_WEBRTC_SOCKET_IMPL_H_
 #define CORE_INTERNAL_MEDIUMS_WEBRTC_WEBRTC_SOCKET_IMPL_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <string>
 #include <memory>
 
@@ -24,6 +26,9 @@
 #include "internal/platform/listeners.h"
 #include "internal/platform/runnable.h"
 #ifndef NO_WEBRTC
+#include "absl/base/thread_annotations.h"
+#include "absl/types/span.h"
+#include "connections/implementation/mediums/webrtc/send_buffer_watermarks.h"
 #include "internal/platform/atomic_boolean.h"
 #include "internal/platform/condition_variable.h"
 #include "internal/platform/input_stream.h"
@@ -73,7 +78,55 @@ class WebRtcSocket : public Socket, public webrtc::DataChannelObserver {
 
   void SetSocketListener(SocketListener&& listener);
 
+  struct SendBufferStats {
+    std::uint64_t buffered_amount = 0;
+    // Writers wait at the high watermark until the buffer drained to the low
+    // one. Both follow the drain rate.
+    std::uint64_t high_watermark = 0;
+    std::uint64_t low_watermark = 0;
+    double drain_bytes_per_second = 0;
+  };
+
+  SendBufferStats GetSendBufferStats() const;
+
  private:
+  // Serves reads straight from the received messages, which it holds by
+  // reference.
+  class InputStreamImpl : public InputStream {
+   public:
+    InputStreamImpl() = default;
+    ~InputStreamImpl() override = default;
+
+    InputStreamImpl(const InputStreamImpl& other) = delete;
+    InputStreamImpl& operator=(const InputStreamImpl& other) = delete;
+
+    // Queues |message| for reading. Ignored once closed.
+    void Push(const rtc::CopyOnWriteBuffer& message)
+        ABSL_LOCKS_EXCLUDED(mutex_);
+
+    // InputStream:
+    // Reads from one message at a time.
+    ExceptionOr<ByteArray> Read(std::int64_t size)
+        ABSL_LOCKS_EXCLUDED(mutex_) override;
+    // A frame that arrived as one message is returned without splitting off
+    // its length first.
+    ExceptionOr<ByteArray> ReadLengthPrefixedFrame(std::int32_t max_size)
+        ABSL_LOCKS_EXCLUDED(mutex_) override;
+    // Fails pending and later reads, and drops the queued messages.
+    Exception Close() ABSL_LOCKS_EXCLUDED(mutex_) override;
+
+   private:
+    // Waits for a message; returns false if closed.
+    bool WaitForMessage() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+    Mutex mutex_;
+    ConditionVariable message_cond_{&mutex_};
+    std::deque<rtc::CopyOnWriteBuffer> messages_ ABSL_GUARDED_BY(mutex_);
+    // Bytes of the front message that were read already.
+    size_t front_offset_ ABSL_GUARDED_BY(mutex_) = 0;
+    bool closed_ ABSL_GUARDED_BY(mutex_) = false;
+  };
+
   class OutputStreamImpl : public OutputStream {
    public:
     explicit OutputStreamImpl(WebRtcSocket* const socket) : socket_(socket) {}
@@ -84,6 +137,9 @@ class WebRtcSocket : public Socket, public webrtc::DataChannelObserver {
 
     // OutputStream:
     Exception Write(const ByteArray& data) override;
+    // Sends |buffers| as one message, so that the receiver gets a frame and
+    // its length together.
+    Exception Writev(absl::Span<const ByteArray* const> buffers) override;
     Exception Flush() override;
     Exception Close() override;
 
@@ -94,16 +150,16 @@ class WebRtcSocket : public Socket, public webrtc::DataChannelObserver {
 
   void WakeUpWriter();
   bool IsClosed();
-  void ClosePipe();
-  bool SendMessage(const ByteArray& data);
-  void BlockUntilSufficientSpaceInBuffer(int length);
+  void CloseStreams();
+  bool SendMessage(absl::Span<const ByteArray* const> buffers, size_t size);
+  // Waits while the data channel buffers as much as the watermarks allow.
+  void BlockUntilSufficientSpaceInBuffer();
   void OffloadFromSignalingThread(Runnable runnable);
 
   std::string name_;
   rtc::scoped_refptr<webrtc::DataChannelInterface> data_channel_;
 
-  std::unique_ptr<InputStream> pipe_input_;
-  std::unique_ptr<OutputStream> pipe_output_;
+  InputStreamImpl input_stream_;
   OutputStreamImpl output_stream_{this};
 
   AtomicBoolean closed_{false};
@@ -112,6 +168,7 @@ class WebRtcSocket : public Socket, public webrtc::DataChannelObserver {
 
   mutable Mutex backpressure_mutex_;
   ConditionVariable buffer_variable_{&backpressure_mutex_};
+  SendBufferWatermarks watermarks_ ABSL_GUARDED_BY(backpressure_mutex_);
 
   // This should be destroyed first to ensure any remaining tasks flushed on
   // shutdown get run while the other members are still alive.
@@ -15,6 +15,7 @@
 #include "connections/implementation/mediums/webrtc/webrtc_socket_impl.h"
 
 #include <memory>
+#include <string>
 
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
@@ -92,6 +93,64 @@ TEST(WebRtcSocketTest, ReadMultipleMessages) {
   EXPECT_EQ(result.result(), ByteArray{"ge"});
 }
 
+TEST(WebRtcSocketTest, ReadPartsOfOneMessage) {
+  rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
+  WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
+
+  webrtc_socket.OnMessage(webrtc::DataBuffer{"Message"});
+
+  ExceptionOr<ByteArray> result = webrtc_socket.GetInputStream().Read(2);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.result(), ByteArray{"Me"});
+
+  result = webrtc_socket.GetInputStream().Read(7);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.result(), ByteArray{"ssage"});
+}
+
+TEST(WebRtcSocketTest, ReadFrameSentAsOneMessage) {
+  rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
+  WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
+
+  webrtc_socket.OnMessage(
+      webrtc::DataBuffer{std::string("\0\0\0\x07Message", 11)});
+
+  ExceptionOr<ByteArray> result =
+      webrtc_socket.GetInputStream().ReadLengthPrefixedFrame(1024);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.result(), ByteArray{"Message"});
+}
+
+TEST(WebRtcSocketTest, ReadFrameSplitOverMessages) {
+  rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
+  WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
+
+  webrtc_socket.OnMessage(webrtc::DataBuffer{std::string("\0\0\0\x07", 4)});
+  webrtc_socket.OnMessage(webrtc::DataBuffer{"Mess"});
+  webrtc_socket.OnMessage(webrtc::DataBuffer{"age"});
+
+  ExceptionOr<ByteArray> result =
+      webrtc_socket.GetInputStream().ReadLengthPrefixedFrame(1024);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(result.result(), ByteArray{"Message"});
+}
+
+TEST(WebRtcSocketTest, WritevSendsOneMessage) {
+  const ByteArray kHeader{std::string("\0\0\0\x07", 4)};
+  const ByteArray kMessage{"Message"};
+  const ByteArray* buffers[] = {&kHeader, &kMessage};
+  rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
+  WebRtcSocket webrtc_socket(kSocketName, mock_data_channel);
+
+  EXPECT_CALL(*mock_data_channel, Send(testing::_))
+      .WillOnce([](const webrtc::DataBuffer& buffer) {
+        EXPECT_EQ(std::string(buffer.data.data<char>(), buffer.size()),
+                  std::string("\0\0\0\x07Message", 11));
+        return true;
+      });
+  EXPECT_TRUE(webrtc_socket.GetOutputStream().Writev(buffers).Ok());
+}
+
 TEST(WebRtcSocketTest, WriteToSocket) {
   const ByteArray kMessage{"Message"};
   rtc::scoped_refptr<MockDataChannel> mock_data_channel(new MockDataChannel());
@@ -55,6 +55,8 @@ class TestWebRtc : public WebRtc {
   int connect_attempts_count(std::string service_id) {
     return service_id_to_connect_attempts_count_map_[service_id];
   }
+
+  bool has_prewarmed_connection_flow() { return HasPrewarmedConnectionFlow(); }
 };
 
 class WebRtcTest : public ::testing::TestWithParam<WebRtcTestParams> {
@@ -391,6 +393,48 @@ TEST_P(WebRtcTest, ConnectBothDevicesAndSendData) {
   env_.Stop();
 }
 
+// Tests that the next connection uses the pre-warmed ConnectionFlow.
+TEST_P(WebRtcTest, ConnectWithPrewarmedConnectionFlow) {
+  env_.Start({.webrtc_enabled = true});
+  TestWebRtc receiver(std::make_unique<WebRtcMedium>());
+  WebRtc sender;
+  WebRtcSocketWrapper receiver_socket;
+  WebRtcTestParams params = GetParam();
+  const WebrtcPeerId self_id("self_id");
+  const std::string service_id("NearbySharing");
+  LocationHint location_hint;
+  Future<bool> connected;
+  ByteArray message("message");
+
+  receiver.PrewarmConnectionFlow(params.non_cellular);
+  receiver.StartAcceptingConnections(
+      service_id, self_id, location_hint,
+      [&receiver_socket, connected](const std::string& service_id,
+                                    WebRtcSocketWrapper wrapper) mutable {
+        receiver_socket = wrapper;
+        connected.Set(receiver_socket.IsValid());
+      },
+      params.non_cellular);
+
+  CancellationFlag flag;
+  ErrorOr<WebRtcSocketWrapper> sender_socket_result = sender.Connect(
+      service_id, self_id, location_hint, &flag, params.non_cellular);
+  ASSERT_TRUE(sender_socket_result.has_value());
+  ExceptionOr<bool> devices_connected = connected.Get();
+  ASSERT_TRUE(devices_connected.ok());
+  EXPECT_TRUE(devices_connected.result());
+  EXPECT_FALSE(receiver.has_prewarmed_connection_flow());
+
+  sender_socket_result.value().GetOutputStream().Write(message);
+  ExceptionOr<ByteArray> received_msg =
+      receiver_socket.GetInputStream().Read(/*size=*/32);
+  ASSERT_TRUE(received_msg.ok());
+  EXPECT_EQ(message, received_msg.result());
+
+  receiver_socket.Close();
+  env_.Stop();
+}
+
 TEST_P(WebRtcTest, Connect_NullPeerConnection) {
   env_.Start({.webrtc_enabled = true});
   WebRtcTestParams params = GetParam();
@@ -14,14 +14,17 @@
 
 #include "connections/implementation/mediums/wifi_direct.h"
 
+#include <cstdint>
 #include <string>
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/expected.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
 #include "internal/platform/wifi_direct.h"
 #include "internal/platform/wifi_credential.h"
 
@@ -33,6 +36,7 @@ using ::location::nearby::proto::connections::OperationResultCode;
 }  // namespace
 
 WifiDirect::~WifiDirect() {
+  release_executor_.Shutdown();
   while (!server_sockets_.empty()) {
     StopAcceptingConnections(server_sockets_.begin()->first);
   }
@@ -77,11 +81,14 @@ bool WifiDirect::IsGOStarted() {
 // connect
 bool WifiDirect::StartWifiDirect() {
   MutexLock lock(&mutex_);
+  // Cancels the scheduled stop of a released group.
+  ++go_generation_;
   if (is_go_started_) {
     NEARBY_LOGS(INFO) << "No need to start GO because it is already started.";
     return true;
   }
   is_go_started_ = medium_.StartWifiDirect();
+  go_started_at_ = SystemClock::ElapsedRealtime();
   return is_go_started_;
 }
 
@@ -91,9 +98,36 @@ bool WifiDirect::StopWifiDirect() {
     NEARBY_LOGS(INFO) << "No need to stop GO because it is not started.";
     return true;
   }
+  StopWifiDirectLocked();
+  return true;
+}
+
+void WifiDirect::ReleaseWifiDirect(absl::Duration reuse_timeout) {
+  MutexLock lock(&mutex_);
+  if (!is_go_started_) return;
+  if (reuse_timeout <= absl::ZeroDuration() ||
+      SystemClock::ElapsedRealtime() - go_started_at_ >=
+          kMaxGroupReuseLifetime) {
+    StopWifiDirectLocked();
+    return;
+  }
+  NEARBY_LOGS(INFO) << "Keeping GO up for " << reuse_timeout << " for reuse.";
+  std::uint64_t generation = ++go_generation_;
+  release_executor_.Schedule(
+      [this, generation]() {
+        MutexLock lock(&mutex_);
+        if (generation != go_generation_) return;
+        NEARBY_LOGS(INFO) << "Stopping GO that was not reused.";
+        StopWifiDirectLocked();
+      },
+      reuse_timeout);
+}
+
+void WifiDirect::StopWifiDirectLocked() {
+  ++go_generation_;
+  if (!is_go_started_) return;
   is_go_started_ = false;
   medium_.StopWifiDirect();
-  return true;
 }
 
 bool WifiDirect::IsConnectedToGO() {
@@ -103,14 +137,22 @@ bool WifiDirect::IsConnectedToGO() {
 }
 
 bool WifiDirect::ConnectWifiDirect(const std::string& ssid,
-                                   const std::string& password) {
+                                   const std::string& password,
+                                   int frequency) {
   MutexLock lock(&mutex_);
+  // Cancels the scheduled disconnect of a released connection.
+  ++connection_generation_;
   if (is_connected_to_go_) {
-    NEARBY_LOGS(INFO)
-        << "No need to connect to GO because it is already connected.";
-    return true;
+    if (ssid == connected_ssid_) {
+      NEARBY_LOGS(INFO)
+          << "No need to connect to GO because it is already connected.";
+      return true;
+    }
+    // Still connected to a released group of another upgrade.
+    DisconnectWifiDirectLocked();
   }
-  is_connected_to_go_ = medium_.ConnectWifiDirect(ssid, password);
+  is_connected_to_go_ = medium_.ConnectWifiDirect(ssid, password, frequency);
+  if (is_connected_to_go_) connected_ssid_ = ssid;
   return is_connected_to_go_;
 }
 
@@ -121,7 +163,34 @@ bool WifiDirect::DisconnectWifiDirect() {
         << "No need to disconnect to GO because it is not connected.";
     return true;
   }
+  return DisconnectWifiDirectLocked();
+}
+
+void WifiDirect::ReleaseWifiDirectConnection(absl::Duration reuse_timeout) {
+  MutexLock lock(&mutex_);
+  if (!is_connected_to_go_) return;
+  if (reuse_timeout <= absl::ZeroDuration()) {
+    DisconnectWifiDirectLocked();
+    return;
+  }
+  NEARBY_LOGS(INFO) << "Staying connected to GO " << connected_ssid_ << " for "
+                    << reuse_timeout << " for reuse.";
+  std::uint64_t generation = ++connection_generation_;
+  release_executor_.Schedule(
+      [this, generation]() {
+        MutexLock lock(&mutex_);
+        if (generation != connection_generation_) return;
+        NEARBY_LOGS(INFO) << "Disconnecting from GO that was not reused.";
+        DisconnectWifiDirectLocked();
+      },
+      reuse_timeout);
+}
+
+bool WifiDirect::DisconnectWifiDirectLocked() {
+  ++connection_generation_;
+  if (!is_connected_to_go_) return true;
   is_connected_to_go_ = false;
+  connected_ssid_.clear();
   return medium_.DisconnectWifiDirect();
 }
 
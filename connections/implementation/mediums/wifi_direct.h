@@ -15,15 +15,18 @@
 #ifndef CORE_INTERNAL_MEDIUMS_WIFI_DIRECT_H_
 #define CORE_INTERNAL_MEDIUMS_WIFI_DIRECT_H_
 
+#include <cstdint>
 #include <string>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/expected.h"
 #include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/mutex.h"
+#include "internal/platform/scheduled_executor.h"
 #include "internal/platform/wifi_credential.h"
 #include "internal/platform/wifi_direct.h"
 
@@ -36,6 +39,11 @@ class WifiDirect {
   using AcceptedConnectionCallback = absl::AnyInvocable<void(
       const std::string& service_id, WifiDirectSocket socket)>;
 
+  // Longest time a group is kept up for reuse; a group released after being
+  // up for this long is stopped right away, so its credentials are renewed
+  // for the next upgrade.
+  static constexpr absl::Duration kMaxGroupReuseLifetime = absl::Minutes(10);
+
   WifiDirect() : is_go_started_(false), is_connected_to_go_(false) {}
   ~WifiDirect();
   // Not copyable or movable
@@ -56,14 +64,25 @@ class WifiDirect {
   bool StartWifiDirect() ABSL_LOCKS_EXCLUDED(mutex_);
   // Stop WifiDirect Group Owner
   bool StopWifiDirect() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Stops the Group Owner once |reuse_timeout| passes, unless
+  // StartWifiDirect() reuses the group, with the same credentials, in the
+  // meantime. Stops it right away if |reuse_timeout| is zero.
+  void ReleaseWifiDirect(absl::Duration reuse_timeout)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   // If WifiDirect Group Client connects to Group Owner
   bool IsConnectedToGO() ABSL_LOCKS_EXCLUDED(mutex_);
-  // WifiDirect Group Client request to connect to the Group Owner
-  bool ConnectWifiDirect(const std::string& ssid, const std::string& password)
-      ABSL_LOCKS_EXCLUDED(mutex_);
+  // WifiDirect Group Client request to connect to the Group Owner. A known
+  // |frequency| of the group spares the platform a full scan.
+  bool ConnectWifiDirect(const std::string& ssid, const std::string& password,
+                         int frequency = -1) ABSL_LOCKS_EXCLUDED(mutex_);
   // WifiDirect Group Client request to disconnect from the Group Owner
   bool DisconnectWifiDirect() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Disconnects from the Group Owner once |reuse_timeout| passes, unless
+  // ConnectWifiDirect() to the same SSID reuses the connection in the
+  // meantime. Disconnects right away if |reuse_timeout| is zero.
+  void ReleaseWifiDirectConnection(absl::Duration reuse_timeout)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   // Starts a worker thread, creates a WifiDirect socket, associates it with a
   // service id.
@@ -104,8 +123,19 @@ class WifiDirect {
   bool IsAcceptingConnectionsLocked(const std::string& service_id)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  void StopWifiDirectLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool DisconnectWifiDirectLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   bool is_go_started_ ABSL_GUARDED_BY(mutex_);
+  absl::Time go_started_at_ ABSL_GUARDED_BY(mutex_);
   bool is_connected_to_go_ ABSL_GUARDED_BY(mutex_);
+  std::string connected_ssid_ ABSL_GUARDED_BY(mutex_);
+  // Bumped whenever the group, or the connection to one, is started, stopped
+  // or released, so that a scheduled release that was overtaken does nothing.
+  std::uint64_t go_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::uint64_t connection_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Runs the scheduled stops and disconnects of released groups.
+  ScheduledExecutor release_executor_;
   WifiDirectMedium medium_ ABSL_GUARDED_BY(mutex_);
 
   // A thread pool dedicated to running all the accept loops from
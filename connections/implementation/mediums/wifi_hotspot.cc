@@ -14,14 +14,17 @@
 
 #include "connections/implementation/mediums/wifi_hotspot.h"
 
+#include <cstdint>
 #include <string>
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/expected.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
 #include "internal/platform/wifi_credential.h"
 #include "internal/platform/wifi_hotspot.h"
 
@@ -33,6 +36,7 @@ using ::location::nearby::proto::connections::OperationResultCode;
 }  // namespace
 
 WifiHotspot::~WifiHotspot() {
+  release_executor_.Shutdown();
   while (!server_sockets_.empty()) {
     StopAcceptingConnections(server_sockets_.begin()->first);
   }
@@ -74,12 +78,15 @@ bool WifiHotspot::IsHotspotStarted() {
 // connect
 bool WifiHotspot::StartWifiHotspot() {
   MutexLock lock(&mutex_);
+  // Cancels the scheduled stop of a released hotspot.
+  ++hotspot_generation_;
   if (is_hotspot_started_) {
     NEARBY_LOGS(INFO)
         << "No need to start Hotspot because it is already started.";
     return true;
   }
   is_hotspot_started_ = medium_.StartWifiHotspot();
+  hotspot_started_at_ = SystemClock::ElapsedRealtime();
   return is_hotspot_started_;
 }
 
@@ -89,9 +96,37 @@ bool WifiHotspot::StopWifiHotspot() {
     NEARBY_LOGS(INFO) << "No need to stop Hotspot because it is not started.";
     return true;
   }
+  StopWifiHotspotLocked();
+  return true;
+}
+
+void WifiHotspot::ReleaseWifiHotspot(absl::Duration reuse_timeout) {
+  MutexLock lock(&mutex_);
+  if (!is_hotspot_started_) return;
+  if (reuse_timeout <= absl::ZeroDuration() ||
+      SystemClock::ElapsedRealtime() - hotspot_started_at_ >=
+          kMaxHotspotReuseLifetime) {
+    StopWifiHotspotLocked();
+    return;
+  }
+  NEARBY_LOGS(INFO) << "Keeping Hotspot up for " << reuse_timeout
+                    << " for reuse.";
+  std::uint64_t generation = ++hotspot_generation_;
+  release_executor_.Schedule(
+      [this, generation]() {
+        MutexLock lock(&mutex_);
+        if (generation != hotspot_generation_) return;
+        NEARBY_LOGS(INFO) << "Stopping Hotspot that was not reused.";
+        StopWifiHotspotLocked();
+      },
+      reuse_timeout);
+}
+
+void WifiHotspot::StopWifiHotspotLocked() {
+  ++hotspot_generation_;
+  if (!is_hotspot_started_) return;
   is_hotspot_started_ = false;
   medium_.StopWifiHotspot();
-  return true;
 }
 
 bool WifiHotspot::IsConnectedToHotspot() {
@@ -104,13 +139,20 @@ bool WifiHotspot::ConnectWifiHotspot(const std::string& ssid,
                                      const std::string& password,
                                      int frequency) {
   MutexLock lock(&mutex_);
+  // Cancels the scheduled disconnect of a released connection.
+  ++connection_generation_;
   if (is_connected_to_hotspot_) {
-    NEARBY_LOGS(INFO)
-        << "No need to connect to Hotspot because it is already connected.";
-    return true;
+    if (ssid == connected_ssid_) {
+      NEARBY_LOGS(INFO)
+          << "No need to connect to Hotspot because it is already connected.";
+      return true;
+    }
+    // Still connected to a released hotspot of another upgrade.
+    DisconnectWifiHotspotLocked();
   }
   is_connected_to_hotspot_ =
       medium_.ConnectWifiHotspot(ssid, password, frequency);
+  if (is_connected_to_hotspot_) connected_ssid_ = ssid;
   return is_connected_to_hotspot_;
 }
 
@@ -121,9 +163,36 @@ bool WifiHotspot::DisconnectWifiHotspot() {
         << "No need to disconnect to Hotspot because it is not connected.";
     return true;
   }
+  DisconnectWifiHotspotLocked();
+  return true;
+}
+
+void WifiHotspot::ReleaseHotspotConnection(absl::Duration reuse_timeout) {
+  MutexLock lock(&mutex_);
+  if (!is_connected_to_hotspot_) return;
+  if (reuse_timeout <= absl::ZeroDuration()) {
+    DisconnectWifiHotspotLocked();
+    return;
+  }
+  NEARBY_LOGS(INFO) << "Staying connected to Hotspot " << connected_ssid_
+                    << " for " << reuse_timeout << " for reuse.";
+  std::uint64_t generation = ++connection_generation_;
+  release_executor_.Schedule(
+      [this, generation]() {
+        MutexLock lock(&mutex_);
+        if (generation != connection_generation_) return;
+        NEARBY_LOGS(INFO) << "Disconnecting from Hotspot that was not reused.";
+        DisconnectWifiHotspotLocked();
+      },
+      reuse_timeout);
+}
+
+void WifiHotspot::DisconnectWifiHotspotLocked() {
+  ++connection_generation_;
+  if (!is_connected_to_hotspot_) return;
   is_connected_to_hotspot_ = false;
+  connected_ssid_.clear();
   medium_.DisconnectWifiHotspot();
-  return true;
 }
 
 HotspotCredentials* WifiHotspot::GetCredentials(absl::string_view service_id) {
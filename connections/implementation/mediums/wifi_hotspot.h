@@ -15,15 +15,18 @@
 #ifndef CORE_INTERNAL_MEDIUMS_WIFI_HOTSPOT_H_
 #define CORE_INTERNAL_MEDIUMS_WIFI_HOTSPOT_H_
 
+#include <cstdint>
 #include <string>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/expected.h"
 #include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/mutex.h"
+#include "internal/platform/scheduled_executor.h"
 #include "internal/platform/wifi_credential.h"
 #include "internal/platform/wifi_hotspot.h"
 
@@ -36,6 +39,11 @@ class WifiHotspot {
   using AcceptedConnectionCallback = absl::AnyInvocable<void(
       const std::string& service_id, WifiHotspotSocket socket)>;
 
+  // Longest time a hotspot is kept up for reuse; a hotspot released after
+  // being up for this long is stopped right away, so its credentials are
+  // renewed for the next upgrade.
+  static constexpr absl::Duration kMaxHotspotReuseLifetime = absl::Minutes(10);
+
   WifiHotspot() : is_hotspot_started_(false), is_connected_to_hotspot_(false) {}
   ~WifiHotspot();
   // Not copyable or movable
@@ -51,11 +59,21 @@ class WifiHotspot {
   bool IsHotspotStarted() ABSL_LOCKS_EXCLUDED(mutex_);
   bool StartWifiHotspot() ABSL_LOCKS_EXCLUDED(mutex_);
   bool StopWifiHotspot() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Stops the hotspot once |reuse_timeout| passes, unless StartWifiHotspot()
+  // reuses it, with the same credentials, in the meantime. Stops it right
+  // away if |reuse_timeout| is zero.
+  void ReleaseWifiHotspot(absl::Duration reuse_timeout)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   bool IsConnectedToHotspot() ABSL_LOCKS_EXCLUDED(mutex_);
   bool ConnectWifiHotspot(const std::string& ssid, const std::string& password,
                           int frequency) ABSL_LOCKS_EXCLUDED(mutex_);
   bool DisconnectWifiHotspot() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Disconnects from the hotspot once |reuse_timeout| passes, unless
+  // ConnectWifiHotspot() to the same SSID reuses the connection in the
+  // meantime. Disconnects right away if |reuse_timeout| is zero.
+  void ReleaseHotspotConnection(absl::Duration reuse_timeout)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   // Starts a worker thread, creates a WifiHotspot socket, associates it with a
   // service id.
@@ -97,8 +115,20 @@ class WifiHotspot {
   bool IsAcceptingConnectionsLocked(const std::string& service_id)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  void StopWifiHotspotLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void DisconnectWifiHotspotLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   bool is_hotspot_started_ ABSL_GUARDED_BY(mutex_);
+  absl::Time hotspot_started_at_ ABSL_GUARDED_BY(mutex_);
   bool is_connected_to_hotspot_ ABSL_GUARDED_BY(mutex_);
+  std::string connected_ssid_ ABSL_GUARDED_BY(mutex_);
+  // Bumped whenever the hotspot, or the connection to one, is started,
+  // stopped or released, so that a scheduled release that was overtaken does
+  // nothing.
+  std::uint64_t hotspot_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::uint64_t connection_generation_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Runs the scheduled stops and disconnects of released hotspots.
+  ScheduledExecutor release_executor_;
   WifiHotspotMedium medium_ ABSL_GUARDED_BY(mutex_);
 
   // A thread pool dedicated to running all the accept loops from
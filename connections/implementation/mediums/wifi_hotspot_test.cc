@@ -21,10 +21,12 @@
 
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/expected.h"
 #include "internal/platform/feature_flags.h"
 #include "internal/platform/medium_environment.h"
+#include "internal/platform/system_clock.h"
 #include "internal/platform/wifi_credential.h"
 #include "internal/platform/wifi_hotspot.h"
 
@@ -192,6 +194,38 @@ TEST_F(WifiHotspotTest, CanStartHotspotTheOtherFailConnect) {
   EXPECT_TRUE(wifi_hotspot_a->StopWifiHotspot());
 }
 
+TEST_F(WifiHotspotTest, ReleasedHotspotIsReusedWithSameCredentials) {
+  std::string service_id(kServiceID);
+  auto wifi_hotspot_a = std::make_unique<WifiHotspot>();
+  ASSERT_TRUE(wifi_hotspot_a->StartWifiHotspot());
+  std::string ssid = wifi_hotspot_a->GetCredentials(service_id)->GetSSID();
+
+  wifi_hotspot_a->ReleaseWifiHotspot(absl::Seconds(10));
+  EXPECT_TRUE(wifi_hotspot_a->IsHotspotStarted());
+  EXPECT_TRUE(wifi_hotspot_a->StartWifiHotspot());
+
+  EXPECT_EQ(wifi_hotspot_a->GetCredentials(service_id)->GetSSID(), ssid);
+}
+
+TEST_F(WifiHotspotTest, ReleasedHotspotStopsAfterReuseTimeout) {
+  auto wifi_hotspot_a = std::make_unique<WifiHotspot>();
+  ASSERT_TRUE(wifi_hotspot_a->StartWifiHotspot());
+
+  wifi_hotspot_a->ReleaseWifiHotspot(absl::Milliseconds(50));
+  SystemClock::Sleep(absl::Milliseconds(500));
+
+  EXPECT_FALSE(wifi_hotspot_a->IsHotspotStarted());
+}
+
+TEST_F(WifiHotspotTest, ReleaseWithoutReuseTimeoutStopsHotspot) {
+  auto wifi_hotspot_a = std::make_unique<WifiHotspot>();
+  ASSERT_TRUE(wifi_hotspot_a->StartWifiHotspot());
+
+  wifi_hotspot_a->ReleaseWifiHotspot(absl::ZeroDuration());
+
+  EXPECT_FALSE(wifi_hotspot_a->IsHotspotStarted());
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
@@ -34,6 +35,7 @@
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/nsd_service_info.h"
 #include "internal/platform/socket.h"
+#include "internal/platform/system_clock.h"
 #include "internal/platform/types.h"
 #include "internal/platform/wifi_lan.h"
 
@@ -171,41 +173,73 @@ bool WifiLan::IsAdvertisingLocked(const std::string& service_id) {
 
 ErrorOr<bool> WifiLan::StartDiscovery(const std::string& service_id,
                                       DiscoveredServiceCallback callback) {
-  MutexLock lock(&mutex_);
+  std::shared_ptr<CachedDiscovery> discovery;
+  {
+    MutexLock lock(&mutex_);
 
-  if (service_id.empty()) {
-    NEARBY_LOGS(INFO)
-        << "Refusing to start WifiLan discovering with empty service_id.";
-    return {Error(OperationResultCode::NEARBY_LOCAL_CLIENT_STATE_WRONG)};
-  }
+    if (service_id.empty()) {
+      NEARBY_LOGS(INFO)
+          << "Refusing to start WifiLan discovering with empty service_id.";
+      return {Error(OperationResultCode::NEARBY_LOCAL_CLIENT_STATE_WRONG)};
+    }
 
-  if (!IsAvailableLocked()) {
-    NEARBY_LOGS(INFO)
-        << "Can't discover WifiLan services because WifiLan isn't available.";
-    return {Error(
-        OperationResultCode::MEDIUM_UNAVAILABLE_WIFI_AWARE_NOT_AVAILABLE)};
-  }
+    if (!IsAvailableLocked()) {
+      NEARBY_LOGS(INFO)
+          << "Can't discover WifiLan services because WifiLan isn't available.";
+      return {Error(
+          OperationResultCode::MEDIUM_UNAVAILABLE_WIFI_AWARE_NOT_AVAILABLE)};
+    }
 
-  if (IsDiscoveringLocked(service_id)) {
-    NEARBY_LOGS(INFO)
-        << "Refusing to start discovery of WifiLan services because another "
-           "discovery is already in-progress.";
-    return {Error(OperationResultCode::CLIENT_WIFI_LAN_DUPLICATE_DISCOVERING)};
-  }
+    if (IsDiscoveringLocked(service_id)) {
+      NEARBY_LOGS(INFO)
+          << "Refusing to start discovery of WifiLan services because another "
+             "discovery is already in-progress.";
+      return {
+          Error(OperationResultCode::CLIENT_WIFI_LAN_DUPLICATE_DISCOVERING)};
+    }
 
-  std::string service_type = GenerateServiceType(service_id);
-  bool ret =
-      medium_.StartDiscovery(service_id, service_type, std::move(callback));
-  if (!ret) {
-    NEARBY_LOGS(INFO) << "Failed to start discovery of WifiLan services.";
-    return {Error(
-        OperationResultCode::CONNECTIVITY_WIFI_LAN_START_DISCOVERY_FAILURE)};
+    if (nsd_cache_ttl_ > absl::ZeroDuration()) {
+      discovery = std::make_shared<CachedDiscovery>(std::move(callback));
+      callback = {
+          .service_discovered_cb =
+              [this, discovery](NsdServiceInfo service_info,
+                                const std::string& reported_service_id) {
+                OnCachedDiscoveryServiceFound(discovery, reported_service_id,
+                                              std::move(service_info));
+              },
+          .service_lost_cb =
+              [this, discovery](NsdServiceInfo service_info,
+                                const std::string& reported_service_id) {
+                OnCachedDiscoveryServiceLost(discovery, reported_service_id,
+                                             std::move(service_info));
+              },
+      };
+      MutexLock cache_lock(&cache_mutex_);
+      cached_discoveries_[service_id] = discovery;
+    }
+
+    std::string service_type = GenerateServiceType(service_id);
+    bool ret =
+        medium_.StartDiscovery(service_id, service_type, std::move(callback));
+    if (!ret) {
+      NEARBY_LOGS(INFO) << "Failed to start discovery of WifiLan services.";
+      if (discovery != nullptr) {
+        MutexLock cache_lock(&cache_mutex_);
+        cached_discoveries_.erase(service_id);
+      }
+      return {Error(
+          OperationResultCode::CONNECTIVITY_WIFI_LAN_START_DISCOVERY_FAILURE)};
+    }
+
+    NEARBY_LOGS(INFO) << "Turned on WifiLan discovering with service_id="
+                      << service_id;
+    // Mark the fact that we're currently performing a WifiLan discovering.
+    discovering_info_.Add(service_id);
   }
 
-  NEARBY_LOGS(INFO) << "Turned on WifiLan discovering with service_id="
-                    << service_id;
-  // Mark the fact that we're currently performing a WifiLan discovering.
-  discovering_info_.Add(service_id);
+  if (discovery != nullptr) {
+    ReportCachedServices(discovery, service_id);
+  }
   return {true};
 }
 
@@ -224,6 +258,20 @@ bool WifiLan::StopDiscovery(const std::string& service_id) {
                     << service_id << ", service_type=" << service_type;
   bool ret = medium_.StopDiscovery(service_type);
   discovering_info_.Remove(service_id);
+
+  std::shared_ptr<CachedDiscovery> discovery;
+  {
+    MutexLock cache_lock(&cache_mutex_);
+    auto it = cached_discoveries_.find(service_id);
+    if (it != cached_discoveries_.end()) {
+      discovery = std::move(it->second);
+      cached_discoveries_.erase(it);
+    }
+  }
+  // The revalidation timeout takes cache_mutex_, so cancel it without.
+  if (discovery != nullptr && discovery->revalidation_alarm != nullptr) {
+    discovery->revalidation_alarm->Cancel();
+  }
   return ret;
 }
 
@@ -605,6 +653,114 @@ std::pair<std::string, int> WifiLan::GetCredentials(
                                      it->second.GetPort());
 }
 
+void WifiLan::OnCachedDiscoveryServiceFound(
+    const std::shared_ptr<CachedDiscovery>& discovery,
+    const std::string& service_id, NsdServiceInfo service_info) {
+  std::string service_name = service_info.GetServiceName();
+  {
+    MutexLock lock(&cache_mutex_);
+    bool is_changed = nsd_service_cache_.Put(service_id, service_info,
+                                             SystemClock::ElapsedRealtime());
+    auto it = cached_discoveries_.find(service_id);
+    if (it == cached_discoveries_.end() || it->second != discovery) {
+      return;
+    }
+    discovery->unconfirmed_services.erase(service_name);
+    if (!discovery->reported_services.insert(service_name).second &&
+        !is_changed) {
+      NEARBY_VLOG(1) << "WifiLan service " << service_name
+                     << " found again with the same service info.";
+      return;
+    }
+  }
+  discovery->callback.service_discovered_cb(std::move(service_info),
+                                            service_id);
+}
+
+void WifiLan::OnCachedDiscoveryServiceLost(
+    const std::shared_ptr<CachedDiscovery>& discovery,
+    const std::string& service_id, NsdServiceInfo service_info) {
+  std::string service_name = service_info.GetServiceName();
+  {
+    MutexLock lock(&cache_mutex_);
+    nsd_service_cache_.Remove(service_id, service_name);
+    auto it = cached_discoveries_.find(service_id);
+    if (it == cached_discoveries_.end() || it->second != discovery) {
+      return;
+    }
+    discovery->unconfirmed_services.erase(service_name);
+    if (discovery->reported_services.erase(service_name) == 0) {
+      return;
+    }
+  }
+  discovery->callback.service_lost_cb(std::move(service_info), service_id);
+}
+
+void WifiLan::ReportCachedServices(
+    const std::shared_ptr<CachedDiscovery>& discovery,
+    const std::string& service_id) {
+  std::vector<NsdServiceInfo> service_infos;
+  {
+    MutexLock lock(&cache_mutex_);
+    auto it = cached_discoveries_.find(service_id);
+    if (it == cached_discoveries_.end() || it->second != discovery) {
+      return;
+    }
+    for (NsdServiceInfo& service_info :
+         nsd_service_cache_.Get(service_id, SystemClock::ElapsedRealtime())) {
+      std::string service_name = service_info.GetServiceName();
+      // Already found again by the platform.
+      if (!discovery->reported_services.insert(service_name).second) {
+        continue;
+      }
+      discovery->unconfirmed_services.insert({service_name, service_info});
+      service_infos.push_back(std::move(service_info));
+    }
+    if (service_infos.empty()) {
+      return;
+    }
+    discovery->revalidation_alarm = std::make_unique<CancelableAlarm>(
+        "wifi_lan_nsd_cache_revalidation",
+        [this, discovery, service_id]() {
+          OnRevalidationTimeout(discovery, service_id);
+        },
+        nsd_cache_revalidation_timeout_, &cache_executor_);
+  }
+  NEARBY_LOGS(INFO) << "Reporting " << service_infos.size()
+                    << " cached WifiLan services for service_id="
+                    << service_id;
+  for (NsdServiceInfo& service_info : service_infos) {
+    discovery->callback.service_discovered_cb(std::move(service_info),
+                                              service_id);
+  }
+}
+
+void WifiLan::OnRevalidationTimeout(
+    const std::shared_ptr<CachedDiscovery>& discovery,
+    const std::string& service_id) {
+  std::vector<NsdServiceInfo> service_infos;
+  {
+    MutexLock lock(&cache_mutex_);
+    auto it = cached_discoveries_.find(service_id);
+    if (it == cached_discoveries_.end() || it->second != discovery) {
+      return;
+    }
+    for (auto& [service_name, service_info] :
+         discovery->unconfirmed_services) {
+      nsd_service_cache_.Remove(service_id, service_name);
+      discovery->reported_services.erase(service_name);
+      service_infos.push_back(std::move(service_info));
+    }
+    discovery->unconfirmed_services.clear();
+  }
+  for (NsdServiceInfo& service_info : service_infos) {
+    NEARBY_LOGS(INFO) << "Cached WifiLan service "
+                      << service_info.GetServiceName()
+                      << " wasn't found again, reporting it lost.";
+    discovery->callback.service_lost_cb(std::move(service_info), service_id);
+  }
+}
+
 std::string WifiLan::GenerateServiceType(const std::string& service_id) {
   std::string service_id_hash_string;
 
@@ -16,6 +16,7 @@
 #define CORE_INTERNAL_MEDIUMS_WIFI_LAN_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -23,15 +24,20 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/implementation/mediums/multiplex/multiplex_socket.h"
+#include "connections/implementation/mediums/nsd_service_cache.h"
 #include "internal/flags/nearby_flags.h"
+#include "internal/platform/cancelable_alarm.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/expected.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/nsd_service_info.h"
+#include "internal/platform/scheduled_executor.h"
 #include "internal/platform/wifi_lan.h"
 
 namespace nearby {
@@ -68,6 +74,10 @@ class WifiLan {
 
   // Enables WifiLan discovery. Will report any discoverable services
   // through a callback.
+  // The services found by earlier discoveries, and not expired from the NSD
+  // service cache, are reported right away; the ones not found again within
+  // the revalidation timeout are then reported lost. Services found again
+  // with the same service info are only reported once.
   // Returns true, if discovery was enabled, false otherwise.
   ErrorOr<bool> StartDiscovery(const std::string& service_id,
                                DiscoveredServiceCallback callback)
@@ -154,6 +164,19 @@ class WifiLan {
     absl::flat_hash_set<std::string> service_ids;
   };
 
+  // A discovery reporting the services of the NSD service cache.
+  struct CachedDiscovery {
+    explicit CachedDiscovery(DiscoveredServiceCallback callback)
+        : callback(std::move(callback)) {}
+
+    DiscoveredServiceCallback callback;
+    // Names of the services reported found by this discovery.
+    absl::flat_hash_set<std::string> reported_services;
+    // The services reported from the cache, and not found again yet, by name.
+    absl::flat_hash_map<std::string, NsdServiceInfo> unconfirmed_services;
+    std::unique_ptr<CancelableAlarm> revalidation_alarm;
+  };
+
   static constexpr int kMaxConcurrentAcceptLoops = 5;
 
   // Establishes connection to WifiLan service by ip address through
@@ -186,6 +209,25 @@ class WifiLan {
   // Generates mDNS type.
   std::string GenerateServiceType(const std::string& service_id);
 
+  // Callbacks of the discoveries reporting the NSD service cache.
+  void OnCachedDiscoveryServiceFound(
+      const std::shared_ptr<CachedDiscovery>& discovery,
+      const std::string& service_id, NsdServiceInfo service_info)
+      ABSL_LOCKS_EXCLUDED(cache_mutex_);
+  void OnCachedDiscoveryServiceLost(
+      const std::shared_ptr<CachedDiscovery>& discovery,
+      const std::string& service_id, NsdServiceInfo service_info)
+      ABSL_LOCKS_EXCLUDED(cache_mutex_);
+  // Reports the cached services of |service_id| to |discovery|, and schedules
+  // their revalidation.
+  void ReportCachedServices(const std::shared_ptr<CachedDiscovery>& discovery,
+                            const std::string& service_id)
+      ABSL_LOCKS_EXCLUDED(cache_mutex_);
+  // Reports the cached services not found again as lost.
+  void OnRevalidationTimeout(const std::shared_ptr<CachedDiscovery>& discovery,
+                             const std::string& service_id)
+      ABSL_LOCKS_EXCLUDED(cache_mutex_);
+
   // Generates port number based on port_range_.
   int GeneratePort(const std::string& service_id,
                    std::pair<std::int32_t, std::int32_t> port_range);
@@ -213,6 +255,24 @@ class WifiLan {
   // A map of IpAddress -> MultiplexSocket.
   absl::flat_hash_map<std::string, mediums::multiplex::MultiplexSocket*>
       multiplex_sockets_ ABSL_GUARDED_BY(mutex_);
+
+  const absl::Duration nsd_cache_ttl_ =
+      FeatureFlags::GetInstance().GetFlags().wifi_lan_nsd_cache_ttl;
+  const absl::Duration nsd_cache_revalidation_timeout_ =
+      FeatureFlags::GetInstance()
+          .GetFlags()
+          .wifi_lan_nsd_cache_revalidation_timeout;
+
+  // Guards the NSD service cache, and is never held while calling into the
+  // platform medium, which reports services on its own threads.
+  Mutex cache_mutex_;
+  NsdServiceCache nsd_service_cache_ ABSL_GUARDED_BY(cache_mutex_){
+      nsd_cache_ttl_};
+  // A map of service_id -> discovery, when the NSD service cache is enabled.
+  absl::flat_hash_map<std::string, std::shared_ptr<CachedDiscovery>>
+      cached_discoveries_ ABSL_GUARDED_BY(cache_mutex_);
+  // Runs the revalidation timeouts. Declared last, so it shuts down first.
+  ScheduledExecutor cache_executor_;
 };
 
 }  // namespace connections
@@ -14,6 +14,7 @@
 
 #include "connections/implementation/mediums/wifi_lan.h"
 
+#include <atomic>
 #include <string>
 #include <utility>
 
@@ -407,6 +408,113 @@ TEST_F(WifiLanTest, CanDiscoverThatOtherMediumAdvertise) {
   env_.Stop();
 }
 
+TEST_F(WifiLanTest, RestartedDiscoveryReportsCachedServices) {
+  ::nearby::FeatureFlags::Flags& flags =
+      ::nearby::FeatureFlags::GetMutableFlagsForTesting();
+  ::nearby::FeatureFlags::Flags saved_flags = flags;
+  flags.wifi_lan_nsd_cache_ttl = absl::Seconds(120);
+  env_.Start();
+  WifiLan wifi_lan_a;
+  WifiLan wifi_lan_b;
+  std::string service_id(kServiceID);
+  CountDownLatch discovered_latch(1);
+  std::atomic<int> rediscovered_count = 0;
+
+  EXPECT_TRUE(wifi_lan_b.StartAcceptingConnections(service_id, {}));
+  NsdServiceInfo nsd_service_info;
+  nsd_service_info.SetServiceName(std::string(kServiceInfoName));
+  nsd_service_info.SetTxtRecord(std::string(kEndpointInfoKey),
+                                std::string(kEndpointName));
+  EXPECT_TRUE(wifi_lan_b.StartAdvertising(service_id, nsd_service_info));
+
+  EXPECT_TRUE(wifi_lan_a.StartDiscovery(
+      service_id, DiscoveredServiceCallback{
+                      .service_discovered_cb =
+                          [&discovered_latch](NsdServiceInfo service_info,
+                                              const std::string& service_id) {
+                            discovered_latch.CountDown();
+                          },
+                  }));
+  EXPECT_TRUE(discovered_latch.Await(kWaitDuration).result());
+  EXPECT_TRUE(wifi_lan_a.StopDiscovery(service_id));
+
+  EXPECT_TRUE(wifi_lan_a.StartDiscovery(
+      service_id, DiscoveredServiceCallback{
+                      .service_discovered_cb =
+                          [&rediscovered_count](NsdServiceInfo service_info,
+                                                const std::string& service_id) {
+                            rediscovered_count++;
+                          },
+                  }));
+  // Reported from the cache, before the platform finds it again.
+  EXPECT_EQ(rediscovered_count, 1);
+  env_.Sync();
+  // Found again with the same service info, so not reported twice.
+  EXPECT_EQ(rediscovered_count, 1);
+  EXPECT_TRUE(wifi_lan_a.StopDiscovery(service_id));
+  EXPECT_TRUE(wifi_lan_b.StopAdvertising(service_id));
+  EXPECT_TRUE(wifi_lan_b.StopAcceptingConnections(service_id));
+  env_.Stop();
+  flags = saved_flags;
+}
+
+TEST_F(WifiLanTest, CachedServiceNotFoundAgainIsReportedLost) {
+  ::nearby::FeatureFlags::Flags& flags =
+      ::nearby::FeatureFlags::GetMutableFlagsForTesting();
+  ::nearby::FeatureFlags::Flags saved_flags = flags;
+  flags.wifi_lan_nsd_cache_ttl = absl::Seconds(120);
+  flags.wifi_lan_nsd_cache_revalidation_timeout = absl::Milliseconds(100);
+  env_.Start();
+  WifiLan wifi_lan_a;
+  WifiLan wifi_lan_b;
+  std::string service_id(kServiceID);
+  CountDownLatch discovered_latch(1);
+  CountDownLatch rediscovered_latch(1);
+  CountDownLatch lost_latch(1);
+
+  EXPECT_TRUE(wifi_lan_b.StartAcceptingConnections(service_id, {}));
+  NsdServiceInfo nsd_service_info;
+  nsd_service_info.SetServiceName(std::string(kServiceInfoName));
+  nsd_service_info.SetTxtRecord(std::string(kEndpointInfoKey),
+                                std::string(kEndpointName));
+  EXPECT_TRUE(wifi_lan_b.StartAdvertising(service_id, nsd_service_info));
+
+  EXPECT_TRUE(wifi_lan_a.StartDiscovery(
+      service_id, DiscoveredServiceCallback{
+                      .service_discovered_cb =
+                          [&discovered_latch](NsdServiceInfo service_info,
+                                              const std::string& service_id) {
+                            discovered_latch.CountDown();
+                          },
+                  }));
+  EXPECT_TRUE(discovered_latch.Await(kWaitDuration).result());
+  EXPECT_TRUE(wifi_lan_a.StopDiscovery(service_id));
+  // Stops advertising while a isn't discovering, so a isn't told.
+  EXPECT_TRUE(wifi_lan_b.StopAdvertising(service_id));
+  env_.Sync();
+
+  EXPECT_TRUE(wifi_lan_a.StartDiscovery(
+      service_id,
+      DiscoveredServiceCallback{
+          .service_discovered_cb =
+              [&rediscovered_latch](NsdServiceInfo service_info,
+                                    const std::string& service_id) {
+                rediscovered_latch.CountDown();
+              },
+          .service_lost_cb =
+              [&lost_latch](NsdServiceInfo service_info,
+                            const std::string& service_id) {
+                lost_latch.CountDown();
+              },
+      }));
+  EXPECT_TRUE(rediscovered_latch.Await(absl::ZeroDuration()).result());
+  EXPECT_TRUE(lost_latch.Await(kWaitDuration).result());
+  EXPECT_TRUE(wifi_lan_a.StopDiscovery(service_id));
+  EXPECT_TRUE(wifi_lan_b.StopAcceptingConnections(service_id));
+  env_.Stop();
+  flags = saved_flags;
+}
+
 }  // namespace
 }  // namespace connections
 }  // namespace nearby
@@ -15,10 +15,13 @@
 #ifndef CORE_INTERNAL_MOCK_SERVICE_CONTROLLER_H_
 #define CORE_INTERNAL_MOCK_SERVICE_CONTROLLER_H_
 
+#include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/service_controller.h"
 #include "connections/listeners.h"
 #include "connections/v3/connection_listening_options.h"
@@ -119,6 +122,10 @@ class MockServiceController : public ServiceController {
 
   MOCK_METHOD(void, SetCustomSavePath,
               (ClientProxy * client, const std::string& path), (override));
+
+  MOCK_METHOD(std::optional<EndpointStats>, GetEndpointStats,
+              (ClientProxy * client, const std::string& endpoint_id),
+              (override));
 };
 
 }  // namespace connections
@@ -16,6 +16,7 @@
 #define CORE_INTERNAL_MOCK_SERVICE_CONTROLLER_ROUTER_H_
 
 #include "gmock/gmock.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/service_controller_router.h"
 #include "connections/listeners.h"
 
@@ -93,6 +94,11 @@ class MockServiceControllerRouter : public ServiceControllerRouter {
                ResultCallback callback),
               (override));
 
+  MOCK_METHOD(void, GetEndpointStats,
+              (ClientProxy * client, absl::string_view endpoint_id,
+               EndpointStatsCallback callback),
+              (override));
+
   MOCK_METHOD(void, RequestConnectionV3,
               (ClientProxy * client, const NearbyDevice&,
                v3::ConnectionRequestInfo, const ConnectionOptions&,
@@ -104,6 +110,11 @@ class MockServiceControllerRouter : public ServiceControllerRouter {
                ResultCallback callback),
               (override));
 
+  MOCK_METHOD(void, AcceptConnectionsV3,
+              (ClientProxy * client, absl::Span<const NearbyDevice* const>,
+               v3::PayloadListener, v3::DeviceResultCallback callback),
+              (override));
+
   MOCK_METHOD(void, RejectConnectionV3,
               (ClientProxy * client, const NearbyDevice&,
                ResultCallback callback),
@@ -119,6 +130,11 @@ class MockServiceControllerRouter : public ServiceControllerRouter {
                ResultCallback callback),
               (override));
 
+  MOCK_METHOD(void, SendPayloadToManyV3,
+              (ClientProxy * client, absl::Span<const NearbyDevice* const>,
+               Payload, ResultCallback callback),
+              (override));
+
   MOCK_METHOD(void, DisconnectFromDeviceV3,
               (ClientProxy * client, const NearbyDevice&,
                ResultCallback callback),
@@ -19,14 +19,18 @@
 #include <utility>
 #include <vector>
 
+#include "connections/implementation/aead_record_layer.h"
+#include "connections/implementation/chunk_compression.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/implementation/internal_payload.h"
 #include "connections/implementation/offline_frames_validator.h"
+#include "connections/implementation/payload_batcher.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/medium_selector.h"
 #include "connections/status.h"
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/feature_flags.h"
 
 namespace nearby {
 namespace connections {
@@ -45,27 +49,38 @@ using ::location::nearby::connections::PayloadTransferFrame;
 using ::location::nearby::connections::V1Frame;
 using ::location::nearby::connections::AutoReconnectFrame;
 
-ByteArray ToBytes(OfflineFrame&& frame) {
-  ByteArray bytes(frame.ByteSizeLong());
+ByteArray ToBytes(OfflineFrame& frame) {
   frame.set_version(OfflineFrame::V1);
-  frame.SerializeToArray(bytes.data(), bytes.size());
+  ByteArray bytes(frame.ByteSizeLong());
+  // The sizes were just computed; don't walk the frame a second time.
+  frame.SerializeWithCachedSizesToArray(
+      reinterpret_cast<std::uint8_t*>(bytes.data()));
   return bytes;
 }
 
+ByteArray ToBytes(OfflineFrame&& frame) { return ToBytes(frame); }
+
 }  // namespace
 
 ExceptionOrOfflineFrame FromBytes(const ByteArray& bytes) {
   OfflineFrame frame;
+  Exception exception = FromBytes(bytes, frame);
+  if (exception.Raised()) return ExceptionOrOfflineFrame(exception);
+  return ExceptionOrOfflineFrame(std::move(frame));
+}
 
-  if (frame.ParseFromString(std::string(bytes))) {
-    Exception validation_exception = EnsureValidOfflineFrame(frame);
-    if (validation_exception.Raised()) {
-      return ExceptionOrOfflineFrame(validation_exception);
-    }
-    return ExceptionOrOfflineFrame(std::move(frame));
-  } else {
-    return ExceptionOrOfflineFrame(Exception::kInvalidProtocolBuffer);
+Exception FromBytes(const ByteArray& bytes, OfflineFrame& frame) {
+  return FromBytes(bytes, frame, nullptr);
+}
+
+Exception FromBytes(const ByteArray& bytes, OfflineFrame& frame,
+                    ValidatedPayloadHeaders* validated_headers) {
+  // Parsing clears the frame first, which keeps its sub-messages and the
+  // capacity of its strings for the fields of the new frame.
+  if (!frame.ParseFromArray(bytes.data(), bytes.size())) {
+    return {Exception::kInvalidProtocolBuffer};
   }
+  return EnsureValidOfflineFrame(frame, validated_headers);
 }
 
 V1Frame::FrameType GetFrameType(const OfflineFrame& frame) {
@@ -191,14 +206,25 @@ ByteArray ForConnectionResponse(std::int32_t status, const OsInfo& os_info,
       NearbyFlags::GetInstance().GetInt64Flag(
           config_package_nearby::nearby_connections_feature::
               kSafeToDisconnectVersion));
+  if (FeatureFlags::GetInstance().GetFlags().enable_aead_record_layer) {
+    sub_frame->set_aead_record_layer_version(AeadRecordLayer::kVersion);
+  }
+  if (FeatureFlags::GetInstance().GetFlags().enable_payload_compression) {
+    sub_frame->set_payload_compression_version(chunk_compression::kVersion);
+  }
+  if (FeatureFlags::GetInstance().GetFlags().enable_payload_batching) {
+    sub_frame->set_payload_batching_version(PayloadBatcher::kVersion);
+  }
 
   return ToBytes(std::move(frame));
 }
 
 ByteArray ForDataPayloadTransfer(
     const PayloadTransferFrame::PayloadHeader& header,
-    const PayloadTransferFrame::PayloadChunk& chunk) {
-  OfflineFrame frame;
+    PayloadTransferFrame::PayloadChunk chunk) {
+  // Every data frame built on this thread reuses the same messages, and the
+  // capacity of the header strings, instead of allocating them per chunk.
+  thread_local OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
   auto* v1_frame = frame.mutable_v1();
@@ -206,7 +232,39 @@ ByteArray ForDataPayloadTransfer(
   auto* sub_frame = v1_frame->mutable_payload_transfer();
   sub_frame->set_packet_type(PayloadTransferFrame::DATA);
   *sub_frame->mutable_payload_header() = header;
-  *sub_frame->mutable_payload_chunk() = chunk;
+  // Swap, rather than copy, the chunk body into the frame, and back out of it
+  // once serialized, so that the frame doesn't keep it alive.
+  PayloadTransferFrame::PayloadChunk* frame_chunk =
+      sub_frame->mutable_payload_chunk();
+  frame_chunk->Swap(&chunk);
+  ByteArray bytes = ToBytes(frame);
+  frame_chunk->Swap(&chunk);
+
+  return bytes;
+}
+
+ByteArray ForBatchedDataPayloadTransfer(
+    std::vector<PayloadTransferFrame::BatchedPayload> batched_payloads) {
+  OfflineFrame frame;
+
+  frame.set_version(OfflineFrame::V1);
+  auto* v1_frame = frame.mutable_v1();
+  v1_frame->set_type(V1Frame::PAYLOAD_TRANSFER);
+  auto* sub_frame = v1_frame->mutable_payload_transfer();
+  sub_frame->set_packet_type(PayloadTransferFrame::BATCHED_DATA);
+  // The header describes the batch as a whole, for validation and logs.
+  auto* header = sub_frame->mutable_payload_header();
+  header->set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  std::int64_t total_size = 0;
+  for (PayloadTransferFrame::BatchedPayload& batched_payload :
+       batched_payloads) {
+    if (!header->has_id()) {
+      header->set_id(batched_payload.payload_header().id());
+    }
+    total_size += batched_payload.body().size();
+    *sub_frame->add_batched_payloads() = std::move(batched_payload);
+  }
+  header->set_total_size(total_size);
 
   return ToBytes(std::move(frame));
 }
@@ -474,6 +532,19 @@ ByteArray ForKeepAlive() {
   return ToBytes(std::move(frame));
 }
 
+ByteArray ForKeepAlive(bool ack, std::uint32_t seq_num) {
+  OfflineFrame frame;
+
+  frame.set_version(OfflineFrame::V1);
+  auto* v1_frame = frame.mutable_v1();
+  v1_frame->set_type(V1Frame::KEEP_ALIVE);
+  auto* keep_alive = v1_frame->mutable_keep_alive();
+  keep_alive->set_ack(ack);
+  keep_alive->set_seq_num(seq_num);
+
+  return ToBytes(std::move(frame));
+}
+
 ByteArray ForDisconnection(bool request_safe_to_disconnect,
                            bool ack_safe_to_disconnect) {
   OfflineFrame frame;
@@ -488,7 +559,20 @@ ByteArray ForDisconnection(bool request_safe_to_disconnect,
   return ToBytes(std::move(frame));
 }
 
-ByteArray ForAutoReconnectIntroduction(const std::string& endpoint_id) {
+ByteArray ForParkConnection() {
+  OfflineFrame frame;
+
+  frame.set_version(OfflineFrame::V1);
+  auto* v1_frame = frame.mutable_v1();
+  v1_frame->set_type(V1Frame::DISCONNECTION);
+  v1_frame->mutable_disconnection()->set_park_connection(true);
+
+  return ToBytes(std::move(frame));
+}
+
+ByteArray ForAutoReconnectIntroduction(
+    const std::string& endpoint_id,
+    const AutoReconnectFrame::SessionResumption& session_resumption) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
@@ -497,11 +581,15 @@ ByteArray ForAutoReconnectIntroduction(const std::string& endpoint_id) {
   auto* auto_reconnect = v1_frame->mutable_auto_reconnect();
   auto_reconnect->set_endpoint_id(endpoint_id);
   auto_reconnect->set_event_type(AutoReconnectFrame::CLIENT_INTRODUCTION);
+  if (session_resumption.ByteSizeLong() > 0) {
+    *auto_reconnect->mutable_session_resumption() = session_resumption;
+  }
 
   return ToBytes(std::move(frame));
 }
 
-ByteArray ForAutoReconnectIntroductionAck() {
+ByteArray ForAutoReconnectIntroductionAck(
+    const AutoReconnectFrame::SessionResumption& session_resumption) {
   OfflineFrame frame;
 
   frame.set_version(OfflineFrame::V1);
@@ -509,6 +597,9 @@ ByteArray ForAutoReconnectIntroductionAck() {
   v1_frame->set_type(V1Frame::AUTO_RECONNECT);
   auto* auto_reconnect = v1_frame->mutable_auto_reconnect();
   auto_reconnect->set_event_type(AutoReconnectFrame::CLIENT_INTRODUCTION_ACK);
+  if (session_resumption.ByteSizeLong() > 0) {
+    *auto_reconnect->mutable_session_resumption() = session_resumption;
+  }
 
   return ToBytes(std::move(frame));
 }
@@ -19,6 +19,7 @@
 #include <string>
 #include <vector>
 
+#include "connections/implementation/offline_frames_validator.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/connection_options.h"
 #include "internal/platform/byte_array.h"
@@ -38,6 +39,15 @@ using UpgradePathInfo = ::location::nearby::connections::
 // Exception::kInvalidProtocolBuffer, if parser failed.
 ExceptionOr<location::nearby::connections::OfflineFrame> FromBytes(
     const ByteArray& offline_frame_bytes);
+// As above, but parses into |offline_frame|, whose sub-messages and string
+// capacity are reused. Readers keep one frame for all the frames they read.
+Exception FromBytes(const ByteArray& offline_frame_bytes,
+                    location::nearby::connections::OfflineFrame& offline_frame);
+// As above, but skips the checks of the payload headers that the reader
+// already validated in |validated_headers|; see EnsureValidOfflineFrame().
+Exception FromBytes(const ByteArray& offline_frame_bytes,
+                    location::nearby::connections::OfflineFrame& offline_frame,
+                    ValidatedPayloadHeaders* validated_headers);
 
 // Returns FrameType of a parsed message, or
 // V1Frame::UNKNOWN_FRAME_TYPE, if frame contents is not recognized.
@@ -57,11 +67,17 @@ ByteArray ForConnectionResponse(
     std::int32_t multiplex_socket_bitmask);
 
 // Builds Payload transfer messages.
+// |chunk| is taken by value so that callers can move the chunk body into the
+// frame instead of copying it.
 ByteArray ForDataPayloadTransfer(
     const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
         header,
-    const location::nearby::connections::PayloadTransferFrame::PayloadChunk&
-        chunk);
+    location::nearby::connections::PayloadTransferFrame::PayloadChunk chunk);
+// Builds a BATCHED_DATA frame; the bodies are moved into it.
+ByteArray ForBatchedDataPayloadTransfer(
+    std::vector<
+        location::nearby::connections::PayloadTransferFrame::BatchedPayload>
+        batched_payloads);
 ByteArray ForControlPayloadTransfer(
     const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
         header,
@@ -101,10 +117,19 @@ ByteArray ForBwuLastWrite();
 ByteArray ForBwuSafeToClose();
 
 ByteArray ForKeepAlive();
+// A keep-alive probe carrying |seq_num|, or the ack of one if |ack|.
+ByteArray ForKeepAlive(bool ack, std::uint32_t seq_num);
 ByteArray ForDisconnection(bool request_safe_to_disconnect,
                            bool ack_safe_to_disconnect);
-ByteArray ForAutoReconnectIntroduction(const std::string& endpoint_id);
-ByteArray ForAutoReconnectIntroductionAck();
+ByteArray ForParkConnection();
+// |session_resumption| is sent when it has any field set.
+ByteArray ForAutoReconnectIntroduction(
+    const std::string& endpoint_id,
+    const location::nearby::connections::AutoReconnectFrame::SessionResumption&
+        session_resumption = {});
+ByteArray ForAutoReconnectIntroductionAck(
+    const location::nearby::connections::AutoReconnectFrame::SessionResumption&
+        session_resumption = {});
 UpgradePathInfo::Medium MediumToUpgradePathInfoMedium(Medium medium);
 Medium UpgradePathInfoMediumToMedium(UpgradePathInfo::Medium medium);
 
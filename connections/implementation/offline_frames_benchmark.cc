@@ -0,0 +1,114 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "connections/implementation/offline_frames.h"
+#include "connections/implementation/proto/offline_wire_formats.pb.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::connections::OfflineFrame;
+using ::location::nearby::connections::PayloadTransferFrame;
+
+PayloadTransferFrame::PayloadHeader MakeHeader(int64_t total_size) {
+  PayloadTransferFrame::PayloadHeader header;
+  header.set_id(12345);
+  header.set_type(PayloadTransferFrame::PayloadHeader::FILE);
+  header.set_total_size(total_size);
+  return header;
+}
+
+// The chunk content is fixed, so that runs are comparable.
+PayloadTransferFrame::PayloadChunk MakeChunk(int64_t size) {
+  std::string body(size, 0);
+  for (int64_t i = 0; i < size; i++) body[i] = static_cast<char>(i * 31);
+  PayloadTransferFrame::PayloadChunk chunk;
+  chunk.set_offset(size);
+  chunk.set_flags(0);
+  chunk.set_body(std::move(body));
+  return chunk;
+}
+
+void BM_SerializeDataPayloadTransfer(benchmark::State& state) {
+  PayloadTransferFrame::PayloadHeader header = MakeHeader(state.range(0) * 4);
+  PayloadTransferFrame::PayloadChunk chunk = MakeChunk(state.range(0));
+
+  for (auto _ : state) {
+    // The chunk is copied in, as the sender has to detach a new body for
+    // every frame anyway.
+    ByteArray bytes = parser::ForDataPayloadTransfer(header, chunk);
+    benchmark::DoNotOptimize(bytes.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SerializeDataPayloadTransfer)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16);
+
+void BM_ParseDataPayloadTransfer(benchmark::State& state) {
+  ByteArray bytes = parser::ForDataPayloadTransfer(
+      MakeHeader(state.range(0) * 4), MakeChunk(state.range(0)));
+
+  for (auto _ : state) {
+    ExceptionOr<OfflineFrame> frame = parser::FromBytes(bytes);
+    if (!frame.ok()) {
+      state.SkipWithError("parse failed");
+      break;
+    }
+    benchmark::DoNotOptimize(parser::GetFrameType(frame.result()));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseDataPayloadTransfer)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16);
+
+void BM_ParseDataPayloadTransferIntoReusedFrame(benchmark::State& state) {
+  ByteArray bytes = parser::ForDataPayloadTransfer(
+      MakeHeader(state.range(0) * 4), MakeChunk(state.range(0)));
+  OfflineFrame frame;
+
+  for (auto _ : state) {
+    if (!parser::FromBytes(bytes, frame).Ok()) {
+      state.SkipWithError("parse failed");
+      break;
+    }
+    benchmark::DoNotOptimize(parser::GetFrameType(frame));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ParseDataPayloadTransferIntoReusedFrame)
+    ->RangeMultiplier(8)
+    ->Range(1 << 10, 1 << 16);
+
+void BM_SerializePayloadAck(benchmark::State& state) {
+  int64_t payload_id = 0;
+  for (auto _ : state) {
+    ByteArray bytes = parser::ForPayloadAckPayloadTransfer(payload_id++);
+    benchmark::DoNotOptimize(bytes.data());
+  }
+}
+BENCHMARK(BM_SerializePayloadAck);
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
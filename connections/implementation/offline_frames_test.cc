@@ -23,16 +23,21 @@
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
+#include "connections/implementation/aead_record_layer.h"
+#include "connections/implementation/chunk_compression.h"
+#include "connections/implementation/payload_batcher.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/feature_flags.h"
 
 namespace nearby {
 namespace connections {
 namespace parser {
 namespace {
 
+using ::location::nearby::connections::AutoReconnectFrame;
 using ::location::nearby::connections::OfflineFrame;
 using ::location::nearby::connections::OsInfo;
 using ::location::nearby::connections::PayloadTransferFrame;
@@ -289,6 +294,69 @@ TEST(OfflineFramesTest, CanGenerateConnectionResponse) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, ConnectionResponseAdvertisesAeadRecordLayer) {
+  OsInfo os_info;
+  os_info.set_type(OsInfo::LINUX);
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  flags.enable_aead_record_layer = false;
+  auto legacy_response = FromBytes(
+      ForConnectionResponse(0, os_info, /*multiplex_socket_bitmask=*/0));
+  flags.enable_aead_record_layer = true;
+  auto response = FromBytes(
+      ForConnectionResponse(0, os_info, /*multiplex_socket_bitmask=*/0));
+  flags.enable_aead_record_layer = false;
+
+  ASSERT_TRUE(legacy_response.ok());
+  ASSERT_TRUE(response.ok());
+  EXPECT_FALSE(legacy_response.result()
+                   .v1()
+                   .connection_response()
+                   .has_aead_record_layer_version());
+  EXPECT_EQ(
+      response.result().v1().connection_response().aead_record_layer_version(),
+      AeadRecordLayer::kVersion);
+}
+
+TEST(OfflineFramesTest, ConnectionResponseAdvertisesPayloadCompression) {
+  OsInfo os_info;
+  os_info.set_type(OsInfo::LINUX);
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  flags.enable_payload_compression = false;
+  auto legacy_response = FromBytes(
+      ForConnectionResponse(0, os_info, /*multiplex_socket_bitmask=*/0));
+  flags.enable_payload_compression = true;
+  auto response = FromBytes(
+      ForConnectionResponse(0, os_info, /*multiplex_socket_bitmask=*/0));
+  flags.enable_payload_compression = false;
+
+  ASSERT_TRUE(legacy_response.ok());
+  ASSERT_TRUE(response.ok());
+  EXPECT_FALSE(legacy_response.result()
+                   .v1()
+                   .connection_response()
+                   .has_payload_compression_version());
+  EXPECT_EQ(response.result()
+                .v1()
+                .connection_response()
+                .payload_compression_version(),
+            chunk_compression::kVersion);
+}
+
+TEST(OfflineFramesTest, ConnectionResponseAdvertisesPayloadBatching) {
+  OsInfo os_info;
+  os_info.set_type(OsInfo::LINUX);
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  flags.enable_payload_batching = true;
+  auto response = FromBytes(
+      ForConnectionResponse(0, os_info, /*multiplex_socket_bitmask=*/0));
+  flags.enable_payload_batching = false;
+
+  ASSERT_TRUE(response.ok());
+  EXPECT_EQ(
+      response.result().v1().connection_response().payload_batching_version(),
+      PayloadBatcher::kVersion);
+}
+
 TEST(OfflineFramesTest, CanGenerateControlPayloadTransfer) {
   PayloadTransferFrame::PayloadHeader header;
   PayloadTransferFrame::ControlMessage control;
@@ -344,6 +412,45 @@ TEST(OfflineFramesTest, CanGenerateDataPayloadTransfer) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, ReusesBuilderForDataPayloadTransfers) {
+  PayloadTransferFrame::PayloadHeader file_header;
+  file_header.set_id(1);
+  file_header.set_type(PayloadTransferFrame::PayloadHeader::FILE);
+  file_header.set_total_size(1024);
+  file_header.set_file_name("file.txt");
+  PayloadTransferFrame::PayloadHeader bytes_header;
+  bytes_header.set_id(2);
+  bytes_header.set_type(PayloadTransferFrame::PayloadHeader::BYTES);
+  bytes_header.set_total_size(4);
+  PayloadTransferFrame::PayloadChunk chunk;
+  chunk.set_body("data");
+  chunk.set_offset(0);
+  chunk.set_flags(0);
+
+  ByteArray file_bytes = ForDataPayloadTransfer(file_header, chunk);
+  ByteArray bytes = ForDataPayloadTransfer(bytes_header, chunk);
+
+  // Nothing of the first frame is left in the second one.
+  OfflineFrame message;
+  ASSERT_TRUE(FromBytes(file_bytes, message).Ok());
+  ASSERT_TRUE(FromBytes(bytes, message).Ok());
+  EXPECT_THAT(message.v1().payload_transfer().payload_header(),
+              EqualsProto(bytes_header));
+  EXPECT_THAT(message.v1().payload_transfer().payload_chunk(),
+              EqualsProto(chunk));
+}
+
+TEST(OfflineFramesTest, ParsesIntoReusedFrame) {
+  OfflineFrame message;
+  ASSERT_TRUE(FromBytes(ForKeepAlive(), message).Ok());
+  ASSERT_TRUE(FromBytes(ForPayloadAckPayloadTransfer(12345), message).Ok());
+
+  EXPECT_FALSE(message.v1().has_keep_alive());
+  EXPECT_EQ(message.v1().payload_transfer().payload_header().id(), 12345);
+  EXPECT_TRUE(FromBytes(ByteArray("\xff"), message)
+                  .Raised(Exception::kInvalidProtocolBuffer));
+}
+
 TEST(OfflineFramesTest, CanGeneratePayloadAckPayloadTransfer) {
   constexpr absl::string_view kExpected =
       R"pb(
@@ -565,6 +672,21 @@ TEST(OfflineFramesTest, CanGenerateKeepAlive) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, CanGenerateKeepAliveAck) {
+  constexpr absl::string_view kExpected =
+      R"pb(
+    version: V1
+    v1: <
+      type: KEEP_ALIVE
+      keep_alive: < ack: true seq_num: 7 >
+    >)pb";
+  ByteArray bytes = ForKeepAlive(/*ack=*/true, /*seq_num=*/7);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = response.result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
 TEST(OfflineFramesTest, CanGenerateDisconnection) {
   constexpr absl::string_view kExpected =
       R"pb(
@@ -584,6 +706,21 @@ TEST(OfflineFramesTest, CanGenerateDisconnection) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, CanGenerateParkConnection) {
+  constexpr absl::string_view kExpected =
+      R"pb(
+    version: V1
+    v1: <
+      type: DISCONNECTION
+      disconnection: < park_connection: true >
+    >)pb";
+  ByteArray bytes = ForParkConnection();
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = response.result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
 TEST(OfflineFramesTest, CanGenerateAutoReconnectIntroduction) {
   constexpr absl::string_view kExpected =
       R"pb(
@@ -619,6 +756,29 @@ TEST(OfflineFramesTest, CanGenerateAutoReconnectIntroductionAck) {
   EXPECT_THAT(message, EqualsProto(kExpected));
 }
 
+TEST(OfflineFramesTest, CanGenerateAutoReconnectIntroductionWithResumption) {
+  constexpr absl::string_view kExpected =
+      R"pb(
+    version: V1
+    v1: <
+      type: AUTO_RECONNECT
+      auto_reconnect: <
+        event_type: CLIENT_INTRODUCTION
+        endpoint_id: "ABC"
+        session_resumption: < ticket_id: "ticket" nonce: "nonce" >
+      >
+    >)pb";
+  AutoReconnectFrame::SessionResumption session_resumption;
+  session_resumption.set_ticket_id("ticket");
+  session_resumption.set_nonce("nonce");
+  ByteArray bytes = ForAutoReconnectIntroduction(std::string(kEndpointId),
+                                                 session_resumption);
+  auto response = FromBytes(bytes);
+  ASSERT_TRUE(response.ok());
+  OfflineFrame message = response.result();
+  EXPECT_THAT(message, EqualsProto(kExpected));
+}
+
 
 }  // namespace
 }  // namespace parser
@@ -15,6 +15,7 @@
 #include "connections/implementation/offline_frames_validator.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <regex>  //NOLINT
 #include <string>
 
@@ -33,6 +34,8 @@ using PayloadChunk =
     ::location::nearby::connections::PayloadTransferFrame::PayloadChunk;
 using ControlMessage =
     ::location::nearby::connections::PayloadTransferFrame::ControlMessage;
+using BatchedPayload =
+    ::location::nearby::connections::PayloadTransferFrame::BatchedPayload;
 using ClientIntroduction = ::location::nearby::connections::
     BandwidthUpgradeNegotiationFrame::ClientIntroduction;
 using WifiHotspotCredentials = UpgradePathInfo::WifiHotspotCredentials;
@@ -118,6 +121,29 @@ Exception EnsureValidPayloadTransferDataFrame(const PayloadChunk& payload_chunk,
   return {Exception::kSuccess};
 }
 
+Exception EnsureValidPayloadTransferBatchedDataFrame(
+    const PayloadTransferFrame& frame) {
+  if (frame.batched_payloads().empty()) {
+    LOG(ERROR) << "Missing batched payloads";
+    return {Exception::kInvalidProtocolBuffer};
+  }
+  for (const BatchedPayload& batched_payload : frame.batched_payloads()) {
+    const PayloadTransferFrame::PayloadHeader& header =
+        batched_payload.payload_header();
+    // Only complete BYTES payloads are batched.
+    if (!header.has_id() ||
+        header.type() != PayloadTransferFrame::PayloadHeader::BYTES ||
+        !batched_payload.has_body() ||
+        header.total_size() !=
+            static_cast<std::int64_t>(batched_payload.body().size())) {
+      LOG(ERROR) << "Invalid batched payload";
+      return {Exception::kInvalidProtocolBuffer};
+    }
+  }
+
+  return {Exception::kSuccess};
+}
+
 Exception EnsureValidPayloadTransferControlFrame(
     const ControlMessage& control_message, std::int64_t totalSize) {
   if (!control_message.has_offset() || control_message.offset() < 0) {
@@ -161,7 +187,27 @@ bool CheckForIllegalCharacters(std::string toBeValidated,
   return false;
 }
 
-Exception EnsureValidPayloadTransferFrame(const PayloadTransferFrame& frame) {
+Exception EnsureValidPayloadHeaderNames(
+    const PayloadTransferFrame::PayloadHeader& header) {
+  if (header.has_file_name()) {
+    if (CheckForIllegalCharacters(header.file_name(), kIllegalFileNamePatterns,
+                                  kIllegalFileNamePatternsSize)) {
+      return {Exception::kIllegalCharacters};
+    }
+  }
+  if (header.has_parent_folder()) {
+    if (CheckForIllegalCharacters(header.parent_folder(),
+                                  kIllegalParentFolderPatterns,
+                                  kIllegalParentFolderPatternsSize)) {
+      return {Exception::kIllegalCharacters};
+    }
+  }
+  return {Exception::kSuccess};
+}
+
+Exception EnsureValidPayloadTransferFrame(
+    const PayloadTransferFrame& frame,
+    ValidatedPayloadHeaders* validated_headers) {
   if (!frame.has_payload_header()) {
     LOG(ERROR) << "Missing payload header";
     return {Exception::kInvalidProtocolBuffer};
@@ -179,25 +225,17 @@ Exception EnsureValidPayloadTransferFrame(const PayloadTransferFrame& frame) {
     return {Exception::kInvalidProtocolBuffer};
   }
   if (frame.payload_header().has_type() &&
-        frame.payload_header().type() ==
-            location::nearby::connections::PayloadTransferFrame::
-                PayloadHeader::FILE) {
-    if (frame.payload_header()
-            .has_file_name()) {
-      if (CheckForIllegalCharacters(frame.payload_header()
-                                        .file_name(),
-                                    kIllegalFileNamePatterns,
-                                    kIllegalFileNamePatternsSize)) {
-        return {Exception::kIllegalCharacters};
-      }
-    }
-    if (frame.payload_header()
-            .has_parent_folder()) {
-      if (CheckForIllegalCharacters(frame.payload_header()
-                                        .parent_folder(),
-                                    kIllegalParentFolderPatterns,
-                                    kIllegalParentFolderPatternsSize)) {
-        return {Exception::kIllegalCharacters};
+      frame.payload_header().type() ==
+          PayloadTransferFrame::PayloadHeader::FILE) {
+    // Every chunk of a file carries its header; only the first one needs its
+    // names checked.
+    if (validated_headers == nullptr ||
+        !validated_headers->Contains(frame.payload_header())) {
+      Exception exception =
+          EnsureValidPayloadHeaderNames(frame.payload_header());
+      if (exception.Raised()) return exception;
+      if (validated_headers != nullptr) {
+        validated_headers->Add(frame.payload_header());
       }
     }
   }
@@ -222,6 +260,9 @@ Exception EnsureValidPayloadTransferFrame(const PayloadTransferFrame& frame) {
       LOG(ERROR) << "Missing control message";
       return {Exception::kInvalidProtocolBuffer};
 
+    case PayloadTransferFrame::BATCHED_DATA:
+      return EnsureValidPayloadTransferBatchedDataFrame(frame);
+
     default:
       break;
   }
@@ -417,8 +458,39 @@ Exception EnsureValidBandwidthUpgradeNegotiationFrame(
 
 }  // namespace
 
+bool ValidatedPayloadHeaders::Contains(
+    const PayloadTransferFrame::PayloadHeader& header) const {
+  for (const Entry& entry : entries_) {
+    if (entry.id == header.id()) {
+      return entry.file_name == header.file_name() &&
+             entry.parent_folder == header.parent_folder();
+    }
+  }
+  return false;
+}
+
+void ValidatedPayloadHeaders::Add(
+    const PayloadTransferFrame::PayloadHeader& header) {
+  for (Entry& entry : entries_) {
+    if (entry.id == header.id()) {
+      entry.file_name = header.file_name();
+      entry.parent_folder = header.parent_folder();
+      return;
+    }
+  }
+  if (entries_.size() == kMaxSize) entries_.pop_front();
+  entries_.push_back(
+      {header.id(), header.file_name(), header.parent_folder()});
+}
+
 Exception EnsureValidOfflineFrame(
     const location::nearby::connections::OfflineFrame& offline_frame) {
+  return EnsureValidOfflineFrame(offline_frame, nullptr);
+}
+
+Exception EnsureValidOfflineFrame(
+    const location::nearby::connections::OfflineFrame& offline_frame,
+    ValidatedPayloadHeaders* validated_headers) {
   V1Frame::FrameType frame_type = GetFrameType(offline_frame);
   switch (frame_type) {
     case V1Frame::CONNECTION_REQUEST:
@@ -442,7 +514,7 @@ Exception EnsureValidOfflineFrame(
     case V1Frame::PAYLOAD_TRANSFER:
       if (offline_frame.has_v1() && offline_frame.v1().has_payload_transfer()) {
         return EnsureValidPayloadTransferFrame(
-            offline_frame.v1().payload_transfer());
+            offline_frame.v1().payload_transfer(), validated_headers);
       }
       LOG(ERROR) << "Missing payload transfer";
       return {Exception::kInvalidProtocolBuffer};
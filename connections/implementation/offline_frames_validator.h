@@ -15,6 +15,9 @@
 #ifndef CORE_INTERNAL_OFFLINE_FRAMES_VALIDATOR_H_
 #define CORE_INTERNAL_OFFLINE_FRAMES_VALIDATOR_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -36,8 +39,40 @@ const size_t kIllegalParentFolderPatternsSize =
     sizeof(kIllegalParentFolderPatterns) /
     sizeof(*kIllegalParentFolderPatterns);
 
+// Remembers the FILE payload headers whose file name and parent folder
+// passed the illegal pattern checks, so that the chunks of a payload after
+// its first one skip them. A header is only taken as validated if its id and
+// both names match exactly; any change has it checked again.
+//
+// Kept by a single reader, so it is not thread-safe.
+class ValidatedPayloadHeaders {
+ public:
+  // The number of payloads remembered; a reader rarely has more in flight.
+  static constexpr std::size_t kMaxSize = 16;
+
+  bool Contains(const location::nearby::connections::PayloadTransferFrame::
+                    PayloadHeader& header) const;
+  // Remembers |header|, forgetting the oldest header if full.
+  void Add(const location::nearby::connections::PayloadTransferFrame::
+               PayloadHeader& header);
+
+ private:
+  struct Entry {
+    std::int64_t id;
+    std::string file_name;
+    std::string parent_folder;
+  };
+
+  std::deque<Entry> entries_;
+};
+
 Exception EnsureValidOfflineFrame(
     const location::nearby::connections::OfflineFrame& offline_frame);
+// As above, but skips the checks of payload headers in |validated_headers|,
+// and adds those that pass to it.
+Exception EnsureValidOfflineFrame(
+    const location::nearby::connections::OfflineFrame& offline_frame,
+    ValidatedPayloadHeaders* validated_headers);
 
 }  // namespace parser
 }  // namespace connections
@@ -15,6 +15,7 @@
 #include "connections/implementation/offline_frames_validator.h"
 
 #include <array>
+#include <cstddef>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -237,6 +238,27 @@ TEST(OfflineFramesValidatorTest, ValidatesAsOkWithValidPayloadTransferFrame) {
   ASSERT_TRUE(ret_value.Ok());
 }
 
+TEST(OfflineFramesValidatorTest, ValidatesBatchedPayloadTransferFrame) {
+  PayloadTransferFrame::BatchedPayload batched_payload;
+  batched_payload.mutable_payload_header()->set_id(12345);
+  batched_payload.mutable_payload_header()->set_type(
+      PayloadTransferFrame::PayloadHeader::BYTES);
+  batched_payload.mutable_payload_header()->set_total_size(12);
+  batched_payload.set_body("payload data");
+  PayloadTransferFrame::BatchedPayload truncated_payload = batched_payload;
+  truncated_payload.set_body("payload");
+
+  OfflineFrame offline_frame;
+  offline_frame.ParseFromString(
+      std::string(ForBatchedDataPayloadTransfer({batched_payload})));
+  OfflineFrame truncated_offline_frame;
+  truncated_offline_frame.ParseFromString(std::string(
+      ForBatchedDataPayloadTransfer({batched_payload, truncated_payload})));
+
+  EXPECT_TRUE(EnsureValidOfflineFrame(offline_frame).Ok());
+  EXPECT_FALSE(EnsureValidOfflineFrame(truncated_offline_frame).Ok());
+}
+
 TEST(OfflineFramesValidatorTest,
      ValidatesAsOkTypeFileWithEmptyFilePathAndParent) {
   PayloadTransferFrame::PayloadHeader header;
@@ -363,6 +385,75 @@ TEST(OfflineFramesValidatorTest,
   EXPECT_EQ(ret_value.value, Exception::kIllegalCharacters);
 }
 
+TEST(OfflineFramesValidatorTest, ChecksChunksOfValidatedFileHeaders) {
+  PayloadTransferFrame::PayloadHeader header;
+  PayloadTransferFrame::PayloadChunk chunk;
+  header.set_id(12345);
+  header.set_type(PayloadTransferFrame::PayloadHeader::FILE);
+  header.set_total_size(1024);
+  header.set_file_name("earth.jpg");
+  chunk.set_body("payload data");
+  chunk.set_offset(0);
+  chunk.set_flags(0);
+  ValidatedPayloadHeaders validated_headers;
+  OfflineFrame offline_frame;
+
+  offline_frame.ParseFromString(
+      std::string(ForDataPayloadTransfer(header, chunk)));
+  EXPECT_TRUE(EnsureValidOfflineFrame(offline_frame, &validated_headers).Ok());
+  EXPECT_TRUE(validated_headers.Contains(header));
+
+  // The chunks of a validated header still have their offsets checked.
+  chunk.set_offset(2048);
+  offline_frame.ParseFromString(
+      std::string(ForDataPayloadTransfer(header, chunk)));
+  EXPECT_EQ(EnsureValidOfflineFrame(offline_frame, &validated_headers).value,
+            Exception::kInvalidProtocolBuffer);
+}
+
+TEST(OfflineFramesValidatorTest, ChecksChangedFileHeadersAgain) {
+  PayloadTransferFrame::PayloadHeader header;
+  PayloadTransferFrame::PayloadChunk chunk;
+  header.set_id(12345);
+  header.set_type(PayloadTransferFrame::PayloadHeader::FILE);
+  header.set_total_size(1024);
+  header.set_file_name("earth.jpg");
+  chunk.set_body("payload data");
+  chunk.set_offset(0);
+  chunk.set_flags(0);
+  ValidatedPayloadHeaders validated_headers;
+  OfflineFrame offline_frame;
+
+  offline_frame.ParseFromString(
+      std::string(ForDataPayloadTransfer(header, chunk)));
+  EXPECT_TRUE(EnsureValidOfflineFrame(offline_frame, &validated_headers).Ok());
+
+  // A later chunk of the same payload can't sneak in another name.
+  header.set_file_name("../earth.jpg");
+  offline_frame.ParseFromString(
+      std::string(ForDataPayloadTransfer(header, chunk)));
+  EXPECT_EQ(EnsureValidOfflineFrame(offline_frame, &validated_headers).value,
+            Exception::kIllegalCharacters);
+  EXPECT_FALSE(validated_headers.Contains(header));
+}
+
+TEST(OfflineFramesValidatorTest, ForgetsOldestValidatedHeaders) {
+  PayloadTransferFrame::PayloadHeader header;
+  header.set_type(PayloadTransferFrame::PayloadHeader::FILE);
+  header.set_file_name("earth.jpg");
+  ValidatedPayloadHeaders validated_headers;
+
+  for (std::size_t id = 0; id <= ValidatedPayloadHeaders::kMaxSize; id++) {
+    header.set_id(id);
+    validated_headers.Add(header);
+  }
+
+  header.set_id(0);
+  EXPECT_FALSE(validated_headers.Contains(header));
+  header.set_id(ValidatedPayloadHeaders::kMaxSize);
+  EXPECT_TRUE(validated_headers.Contains(header));
+}
+
 TEST(OfflineFramesValidatorTest, ValidatesAsFailWithNullPayloadTransferFrame) {
   PayloadTransferFrame::PayloadHeader header;
   PayloadTransferFrame::PayloadChunk chunk;
@@ -15,6 +15,7 @@
 #include "connections/implementation/offline_service_controller.h"
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -24,7 +25,9 @@
 #include "connections/advertising_options.h"
 #include "connections/connection_options.h"
 #include "connections/discovery_options.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/client_proxy.h"
+#include "connections/implementation/payload_manager.h"
 #include "connections/listeners.h"
 #include "connections/out_of_band_connection_metadata.h"
 #include "connections/params.h"
@@ -201,6 +204,15 @@ void OfflineServiceController::DisconnectFromEndpoint(
   endpoint_manager_.UnregisterEndpoint(client, endpoint_id);
 }
 
+void OfflineServiceController::DisconnectFromEndpoints(
+    ClientProxy* client, const std::vector<std::string>& endpoint_ids) {
+  if (stop_) return;
+  NEARBY_LOGS(INFO) << "Client " << client->GetClientId()
+                    << " requested a disconnection from endpoint_ids {"
+                    << absl::StrJoin(endpoint_ids, ",") << "}";
+  endpoint_manager_.UnregisterEndpoints(client, endpoint_ids);
+}
+
 Status OfflineServiceController::UpdateAdvertisingOptions(
     ClientProxy* client, absl::string_view service_id,
     const AdvertisingOptions& advertising_options) {
@@ -232,6 +244,21 @@ void OfflineServiceController::SetCustomSavePath(ClientProxy* client,
   payload_manager_.SetCustomSavePath(client, path);
 }
 
+std::optional<EndpointStats> OfflineServiceController::GetEndpointStats(
+    ClientProxy* client, const std::string& endpoint_id) {
+  if (stop_) return std::nullopt;
+  std::optional<EndpointStats> stats =
+      endpoint_manager_.GetEndpointStats(endpoint_id);
+  if (!stats.has_value()) return std::nullopt;
+  PayloadManager::SendQueueStats send_queue =
+      payload_manager_.GetSendQueueStats(endpoint_id);
+  stats->send_queue_depth = send_queue.payloads;
+  stats->send_queue_bytes = send_queue.bytes;
+  stats->incoming_bytes_held =
+      payload_manager_.GetIncomingBytesHeld(endpoint_id);
+  return stats;
+}
+
 void OfflineServiceController::ShutdownBwuManagerExecutors() {
   NEARBY_LOGS(INFO) << "Shutting down BwuManager executors.";
   bwu_manager_.ShutdownExecutors();
@@ -16,9 +16,11 @@
 #define CORE_INTERNAL_OFFLINE_SERVICE_CONTROLLER_H_
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <vector>
 
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/bwu_manager.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel_manager.h"
@@ -87,6 +89,9 @@ class OfflineServiceController : public ServiceController {
 
   void DisconnectFromEndpoint(ClientProxy* client,
                               const std::string& endpoint_id) override;
+  void DisconnectFromEndpoints(
+      ClientProxy* client,
+      const std::vector<std::string>& endpoint_ids) override;
 
   Status UpdateAdvertisingOptions(
       ClientProxy* client, absl::string_view service_id,
@@ -100,6 +105,9 @@ class OfflineServiceController : public ServiceController {
 
   void SetCustomSavePath(ClientProxy* client, const std::string& path) override;
 
+  std::optional<EndpointStats> GetEndpointStats(
+      ClientProxy* client, const std::string& endpoint_id) override;
+
   void ShutdownBwuManagerExecutors() override;
 
  private:
@@ -0,0 +1,142 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/outgoing_payload_scheduler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+namespace connections {
+
+OutgoingPayloadScheduler::OutgoingPayloadScheduler(size_t max_workers)
+    : max_workers_(std::max<size_t>(max_workers, 1)),
+      // With a single worker there is nothing to reserve.
+      max_low_priority_workers_(std::max<size_t>(max_workers_ - 1, 1)),
+      workers_(max_workers_) {
+  for (size_t i = 0; i < max_workers_; i++) {
+    workers_.Execute("outgoing-payload-worker", [this]() { RunWorker(); });
+  }
+}
+
+OutgoingPayloadScheduler::~OutgoingPayloadScheduler() { Shutdown(); }
+
+void OutgoingPayloadScheduler::Schedule(const std::vector<std::string>& keys,
+                                        Priority priority,
+                                        absl::AnyInvocable<void()> task) {
+  MutexLock lock(&mutex_);
+  if (shut_down_) return;
+  TaskId id = next_task_id_++;
+  Task& scheduled = tasks_[id];
+  scheduled.keys = keys;
+  // A key listed twice would wait for itself.
+  std::sort(scheduled.keys.begin(), scheduled.keys.end());
+  scheduled.keys.erase(
+      std::unique(scheduled.keys.begin(), scheduled.keys.end()),
+      scheduled.keys.end());
+  scheduled.priority = priority;
+  scheduled.run = std::move(task);
+  for (const std::string& key : scheduled.keys) {
+    queues_[QueueKey{key, priority}].push_back(id);
+  }
+  MaybeMarkReady(id);
+}
+
+void OutgoingPayloadScheduler::Shutdown() {
+  {
+    MutexLock lock(&mutex_);
+    if (shut_down_) return;
+    shut_down_ = true;
+    cond_.Notify();
+  }
+  workers_.Shutdown();
+}
+
+void OutgoingPayloadScheduler::MaybeMarkReady(TaskId id) {
+  Task& task = tasks_.find(id)->second;
+  if (task.ready) return;
+  for (const std::string& key : task.keys) {
+    if (queues_.find(QueueKey{key, task.priority})->second.front() != id) {
+      return;
+    }
+  }
+  task.ready = true;
+  ready_[static_cast<size_t>(task.priority)].push_back(id);
+  cond_.Notify();
+}
+
+bool OutgoingPayloadScheduler::PickReadyTask(TaskId& id) {
+  auto& high = ready_[static_cast<size_t>(Priority::kHigh)];
+  if (!high.empty()) {
+    id = high.front();
+    high.pop_front();
+    return true;
+  }
+  auto& low = ready_[static_cast<size_t>(Priority::kLow)];
+  if (!low.empty() && running_low_priority_ < max_low_priority_workers_) {
+    id = low.front();
+    low.pop_front();
+    return true;
+  }
+  return false;
+}
+
+void OutgoingPayloadScheduler::RunWorker() {
+  mutex_.Lock();
+  while (true) {
+    TaskId id;
+    if (!PickReadyTask(id)) {
+      // Every worker keeps going until the scheduled tasks are drained. A
+      // task still running marks its successors ready for its own worker.
+      if (shut_down_ && ready_[0].empty() && ready_[1].empty()) break;
+      cond_.Wait();
+      continue;
+    }
+
+    Task& task = tasks_.find(id)->second;
+    absl::AnyInvocable<void()> run = std::move(task.run);
+    Priority priority = task.priority;
+    if (priority == Priority::kLow) running_low_priority_++;
+
+    mutex_.Unlock();
+    run();
+    mutex_.Lock();
+
+    if (priority == Priority::kLow) running_low_priority_--;
+    // |task| may have moved while the lock was released.
+    auto it = tasks_.find(id);
+    std::vector<std::string> keys = std::move(it->second.keys);
+    tasks_.erase(it);
+    for (const std::string& key : keys) {
+      auto queue = queues_.find(QueueKey{key, priority});
+      queue->second.pop_front();
+      if (queue->second.empty()) {
+        queues_.erase(queue);
+      } else {
+        MaybeMarkReady(queue->second.front());
+      }
+    }
+    cond_.Notify();
+  }
+  mutex_.Unlock();
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,107 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_OUTGOING_PAYLOAD_SCHEDULER_H_
+#define CORE_INTERNAL_OUTGOING_PAYLOAD_SCHEDULER_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace connections {
+
+// Runs the send loops of outgoing payloads on a bounded pool of threads.
+//
+// Every task has a set of keys, the endpoints its payload goes to. Tasks of
+// the same priority that share a key run one at a time, in the order they were
+// scheduled; tasks without a common key run concurrently. This keeps the
+// payloads to one peer in order, also when some of them go to other peers
+// too, while a slow peer no longer holds up the payloads to the others.
+//
+// Ready high priority tasks always run before low priority ones, and low
+// priority tasks never occupy the last worker, so that small payloads aren't
+// stuck behind bulk transfers.
+class OutgoingPayloadScheduler {
+ public:
+  enum class Priority {
+    kHigh = 0,
+    kLow = 1,
+  };
+
+  explicit OutgoingPayloadScheduler(size_t max_workers);
+  ~OutgoingPayloadScheduler();
+
+  OutgoingPayloadScheduler(const OutgoingPayloadScheduler&) = delete;
+  OutgoingPayloadScheduler& operator=(const OutgoingPayloadScheduler&) =
+      delete;
+
+  // Runs |task| once the tasks scheduled before it with the same |priority|
+  // and any of its |keys| are done. Dropped after Shutdown().
+  void Schedule(const std::vector<std::string>& keys, Priority priority,
+                absl::AnyInvocable<void()> task) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Runs the tasks scheduled so far, then stops the workers.
+  void Shutdown() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  using QueueKey = std::pair<std::string, Priority>;
+  using TaskId = std::uint64_t;
+
+  struct Task {
+    std::vector<std::string> keys;
+    Priority priority;
+    absl::AnyInvocable<void()> run;
+    // Whether the task was added to ready_.
+    bool ready = false;
+  };
+
+  void RunWorker() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Adds |id| to ready_ if it is first in the queues of all its keys.
+  void MaybeMarkReady(TaskId id) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Returns the task to run next, if any may run now.
+  bool PickReadyTask(TaskId& id) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t max_workers_;
+  const size_t max_low_priority_workers_;
+  Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  absl::flat_hash_map<TaskId, Task> tasks_ ABSL_GUARDED_BY(mutex_);
+  // The tasks of every key and priority, in the order they were scheduled.
+  // A task stays first in its queues until it is done.
+  absl::flat_hash_map<QueueKey, std::deque<TaskId>> queues_
+      ABSL_GUARDED_BY(mutex_);
+  // The tasks ready to run, by priority, oldest first.
+  std::array<std::deque<TaskId>, 2> ready_ ABSL_GUARDED_BY(mutex_);
+  TaskId next_task_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t running_low_priority_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shut_down_ ABSL_GUARDED_BY(mutex_) = false;
+  MultiThreadExecutor workers_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_OUTGOING_PAYLOAD_SCHEDULER_H_
@@ -0,0 +1,153 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/outgoing_payload_scheduler.h"
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using Priority = OutgoingPayloadScheduler::Priority;
+using ::testing::ElementsAre;
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+TEST(OutgoingPayloadSchedulerTest, RunsTasksOfOneKeyInOrder) {
+  Mutex mutex;
+  std::vector<int> order;
+  {
+    OutgoingPayloadScheduler scheduler(4);
+    for (int i = 0; i < 10; i++) {
+      scheduler.Schedule({"endpoint"}, Priority::kLow, [&mutex, &order, i]() {
+        MutexLock lock(&mutex);
+        order.push_back(i);
+      });
+    }
+    scheduler.Shutdown();
+  }
+
+  EXPECT_THAT(order, ElementsAre(0, 1, 2, 3, 4, 5, 6, 7, 8, 9));
+}
+
+TEST(OutgoingPayloadSchedulerTest, RunsTasksOfDifferentKeysConcurrently) {
+  CountDownLatch started(2);
+  CountDownLatch done(2);
+  OutgoingPayloadScheduler scheduler(3);
+
+  // Each task waits for the other one to start.
+  for (const std::string& key : {"endpoint1", "endpoint2"}) {
+    scheduler.Schedule({key}, Priority::kLow, [&started, &done]() {
+      started.CountDown();
+      EXPECT_TRUE(started.Await(kTimeout).result());
+      done.CountDown();
+    });
+  }
+
+  EXPECT_TRUE(done.Await(kTimeout).result());
+}
+
+TEST(OutgoingPayloadSchedulerTest, RunsTasksSharingAKeyInOrder) {
+  Mutex mutex;
+  std::vector<std::string> order;
+  CountDownLatch release(1);
+  CountDownLatch other_done(1);
+  {
+    OutgoingPayloadScheduler scheduler(4);
+    scheduler.Schedule({"endpoint1", "endpoint2"}, Priority::kHigh,
+                       [&mutex, &order, &release]() {
+                         EXPECT_TRUE(release.Await(kTimeout).result());
+                         MutexLock lock(&mutex);
+                         order.push_back("both");
+                       });
+    scheduler.Schedule({"endpoint2"}, Priority::kHigh, [&mutex, &order]() {
+      MutexLock lock(&mutex);
+      order.push_back("endpoint2");
+    });
+    // Tasks without a common key aren't held up.
+    scheduler.Schedule({"endpoint3"}, Priority::kHigh,
+                       [&other_done]() { other_done.CountDown(); });
+    EXPECT_TRUE(other_done.Await(kTimeout).result());
+    release.CountDown();
+    scheduler.Shutdown();
+  }
+
+  EXPECT_THAT(order, ElementsAre("both", "endpoint2"));
+}
+
+TEST(OutgoingPayloadSchedulerTest, KeepsAWorkerForHighPriorityTasks) {
+  CountDownLatch release_low(1);
+  CountDownLatch high_done(1);
+  OutgoingPayloadScheduler scheduler(2);
+
+  // Two slow low priority tasks only get one of the two workers.
+  for (const std::string& key : {"endpoint1", "endpoint2"}) {
+    scheduler.Schedule({key}, Priority::kLow, [&release_low]() {
+      EXPECT_TRUE(release_low.Await(kTimeout).result());
+    });
+  }
+  scheduler.Schedule({"endpoint3"}, Priority::kHigh,
+                     [&high_done]() { high_done.CountDown(); });
+
+  EXPECT_TRUE(high_done.Await(kTimeout).result());
+  release_low.CountDown();
+}
+
+TEST(OutgoingPayloadSchedulerTest, RunsHighPriorityTasksFirst) {
+  Mutex mutex;
+  std::vector<std::string> order;
+  CountDownLatch release(1);
+  {
+    OutgoingPayloadScheduler scheduler(1);
+    // Occupies the only worker while the other tasks are queued.
+    scheduler.Schedule({"blocker"}, Priority::kHigh, [&release]() {
+      EXPECT_TRUE(release.Await(kTimeout).result());
+    });
+    scheduler.Schedule({"file"}, Priority::kLow, [&mutex, &order]() {
+      MutexLock lock(&mutex);
+      order.push_back("file");
+    });
+    scheduler.Schedule({"bytes"}, Priority::kHigh, [&mutex, &order]() {
+      MutexLock lock(&mutex);
+      order.push_back("bytes");
+    });
+    release.CountDown();
+    scheduler.Shutdown();
+  }
+
+  EXPECT_THAT(order, ElementsAre("bytes", "file"));
+}
+
+TEST(OutgoingPayloadSchedulerTest, DropsTasksAfterShutdown) {
+  OutgoingPayloadScheduler scheduler(2);
+  scheduler.Shutdown();
+
+  bool ran = false;
+  scheduler.Schedule({"endpoint"}, Priority::kHigh, [&ran]() { ran = true; });
+
+  EXPECT_FALSE(ran);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
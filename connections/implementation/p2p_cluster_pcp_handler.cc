@@ -21,10 +21,14 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/btree_map.h"
 #include "absl/functional/bind_front.h"
+#include "absl/functional/function_ref.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "connections/advertising_options.h"
 #include "connections/discovery_options.h"
 #include "connections/implementation/base_pcp_handler.h"
@@ -58,11 +62,18 @@
 #include "internal/platform/bluetooth_adapter.h"
 #include "internal/platform/bluetooth_classic.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
 #include "internal/platform/expected.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/implementation/platform.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
 #include "internal/platform/nsd_service_info.h"
 #include "internal/platform/os_name.h"
+#include "internal/platform/runnable.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/system_clock.h"
+#include "internal/platform/trace_event.h"
 #include "internal/platform/types.h"
 #include "internal/platform/wifi_lan.h"
 #include "proto/connections_enums.pb.h"
@@ -79,6 +90,38 @@ using ::location::nearby::proto::connections::Medium::UNKNOWN_MEDIUM;
 using ::location::nearby::proto::connections::Medium::WEB_RTC;
 using ::location::nearby::proto::connections::Medium::WIFI_LAN;
 
+// Returns the result of |start|, and sets |latency| to the time it took.
+ErrorOr<Medium> MeasureMediumStartup(
+    absl::FunctionRef<ErrorOr<Medium>()> start, absl::Duration& latency) {
+  absl::Time start_time = SystemClock::ElapsedRealtime();
+  ErrorOr<Medium> result = start();
+  latency = SystemClock::ElapsedRealtime() - start_time;
+  return result;
+}
+
+bool IsBleV2Enabled() {
+  return NearbyFlags::Get<
+      config_package_nearby::nearby_connections_feature::kEnableBleV2>();
+}
+
+bool IsBluetoothClassicScanningDisabled() {
+  return NearbyFlags::Get<config_package_nearby::nearby_connections_feature::
+                              kDisableBluetoothClassicScanning>();
+}
+
+// The service name and TXT records of |service_info|, in a stable order.
+std::string EncodeNsdServiceInfo(const NsdServiceInfo& service_info) {
+  absl::btree_map<std::string, std::string> txt_records;
+  for (const auto& [key, value] : service_info.GetTxtRecords()) {
+    txt_records.emplace(key, value);
+  }
+  std::string encoded = service_info.GetServiceName();
+  for (const auto& [key, value] : txt_records) {
+    absl::StrAppend(&encoded, "\n", key, "=", value);
+  }
+  return encoded;
+}
+
 }  // namespace
 
 ByteArray P2pClusterPcpHandler::GenerateHash(const std::string& source,
@@ -86,6 +129,84 @@ ByteArray P2pClusterPcpHandler::GenerateHash(const std::string& source,
   return Utils::Sha256Hash(source, size);
 }
 
+ByteArray P2pClusterPcpHandler::EncodeBleAdvertisement(
+    const std::string& service_id, const std::string& local_endpoint_id,
+    const ByteArray& local_endpoint_info,
+    const AdvertisingOptions& advertising_options, WebRtcState web_rtc_state) {
+  // If a fast advertisement service UUID was provided, create a fast
+  // BleAdvertisement.
+  // TODO(b/169550050): Implement UWBAddress.
+  if (!advertising_options.fast_advertisement_service_uuid.empty()) {
+    return ByteArray(BleAdvertisement(kBleAdvertisementVersion, GetPcp(),
+                                      local_endpoint_id, local_endpoint_info,
+                                      /*uwb_address=*/ByteArray{}));
+  }
+  PowerLevel power_level = advertising_options.low_power
+                               ? PowerLevel::kLowPower
+                               : PowerLevel::kHighPower;
+  const ByteArray service_id_hash =
+      GenerateHash(service_id, BleAdvertisement::kServiceIdHashLength);
+  std::string bluetooth_mac_address;
+  if (bluetooth_medium_.IsAvailable() &&
+      ShouldAdvertiseBluetoothMacOverBle(power_level))
+    bluetooth_mac_address = bluetooth_medium_.GetMacAddress();
+  return ByteArray(BleAdvertisement(
+      kBleAdvertisementVersion, GetPcp(), service_id_hash, local_endpoint_id,
+      local_endpoint_info, bluetooth_mac_address,
+      /*uwb_address=*/ByteArray{}, web_rtc_state));
+}
+
+std::string P2pClusterPcpHandler::EncodeBluetoothDeviceName(
+    const ByteArray& service_id_hash, const std::string& local_endpoint_id,
+    const ByteArray& local_endpoint_info, WebRtcState web_rtc_state) {
+  // TODO(b/169550050): Implement UWBAddress.
+  return std::string(BluetoothDeviceName(
+      kBluetoothDeviceNameVersion, GetPcp(), local_endpoint_id, service_id_hash,
+      local_endpoint_info, ByteArray{}, web_rtc_state));
+}
+
+NsdServiceInfo P2pClusterPcpHandler::EncodeWifiLanServiceInfo(
+    const std::string& service_id, const std::string& local_endpoint_id,
+    const ByteArray& local_endpoint_info, WebRtcState web_rtc_state) {
+  // TODO(b/169550050): Implement UWBAddress.
+  const ByteArray service_id_hash =
+      GenerateHash(service_id, WifiLanServiceInfo::kServiceIdHashLength);
+  WifiLanServiceInfo service_info{kWifiLanServiceInfoVersion,
+                                  GetPcp(),
+                                  local_endpoint_id,
+                                  service_id_hash,
+                                  local_endpoint_info,
+                                  ByteArray{},
+                                  web_rtc_state};
+  return NsdServiceInfo(service_info);
+}
+
+void P2pClusterPcpHandler::OnAdvertisementStarted(
+    const std::string& service_id, Medium medium,
+    MediumAdvertisement advertisement) {
+  MutexLock lock(&advertisements_mutex_);
+  advertisements_[service_id][medium] = std::move(advertisement);
+}
+
+void P2pClusterPcpHandler::OnAdvertisementStopped(
+    const std::string& service_id, Medium medium) {
+  MutexLock lock(&advertisements_mutex_);
+  auto it = advertisements_.find(service_id);
+  if (it == advertisements_.end()) return;
+  it->second.erase(medium);
+  if (it->second.empty()) advertisements_.erase(it);
+}
+
+bool P2pClusterPcpHandler::IsAdvertisementChanged(
+    const std::string& service_id, Medium medium,
+    const MediumAdvertisement& advertisement) const {
+  MutexLock lock(&advertisements_mutex_);
+  auto it = advertisements_.find(service_id);
+  if (it == advertisements_.end()) return true;
+  auto medium_it = it->second.find(medium);
+  return medium_it == it->second.end() || !(medium_it->second == advertisement);
+}
+
 bool P2pClusterPcpHandler::ShouldAdvertiseBluetoothMacOverBle(
     PowerLevel power_level) {
   return power_level == PowerLevel::kHighPower;
@@ -110,7 +231,11 @@ P2pClusterPcpHandler::P2pClusterPcpHandler(
       wifi_hotspot_medium_(mediums->GetWifiHotspot()),
       wifi_direct_medium_(mediums->GetWifiDirect()),
       webrtc_medium_(mediums->GetWebRtc()),
-      injected_bluetooth_device_store_(injected_bluetooth_device_store) {}
+      injected_bluetooth_device_store_(injected_bluetooth_device_store) {
+  if (FeatureFlags::GetInstance().GetFlags().enable_parallel_medium_startup) {
+    medium_startup_executor_ = std::make_unique<SingleThreadExecutor>();
+  }
+}
 
 P2pClusterPcpHandler::~P2pClusterPcpHandler() {
   NEARBY_VLOG(1) << __func__;
@@ -131,8 +256,7 @@ std::vector<Medium> P2pClusterPcpHandler::GetConnectionMediumsByPriority() {
   if (bluetooth_medium_.IsAvailable()) {
     mediums.push_back(BLUETOOTH);
   }
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+  if (IsBleV2Enabled()) {
     if (ble_v2_medium_.IsAvailable()) {
       mediums.push_back(BLE);
     }
@@ -147,6 +271,15 @@ std::vector<Medium> P2pClusterPcpHandler::GetConnectionMediumsByPriority() {
 
 Medium P2pClusterPcpHandler::GetDefaultUpgradeMedium() { return WIFI_LAN; }
 
+void P2pClusterPcpHandler::RunMediumStartup(const std::string& name,
+                                            Runnable&& runnable) {
+  if (medium_startup_executor_ == nullptr) {
+    runnable();
+    return;
+  }
+  medium_startup_executor_->Execute(name, std::move(runnable));
+}
+
 BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartAdvertisingImpl(
     ClientProxy* client, const std::string& service_id,
     const std::string& local_endpoint_id, const ByteArray& local_endpoint_info,
@@ -157,34 +290,37 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartAdvertisingImpl(
 
   WebRtcState web_rtc_state{WebRtcState::kUnconnectable};
 
+  // WifiLan doesn't share a radio with the other mediums, so it may start
+  // alongside them. Bluetooth and BLE share the Bluetooth radio, and start one
+  // after the other.
+  ErrorOr<Medium> wifi_lan_result = {
+      Error(OperationResultCode::DETAIL_UNKNOWN)};
+  absl::Duration wifi_lan_latency;
+  CountDownLatch wifi_lan_started(1);
   if (advertising_options.allowed.wifi_lan) {
-    ErrorOr<Medium> wifi_lan_result =
-        StartWifiLanAdvertising(client, service_id, local_endpoint_id,
-                                local_endpoint_info, web_rtc_state);
-    Medium wifi_lan_medium = UNKNOWN_MEDIUM;
-    if (wifi_lan_result.has_value()) {
-      wifi_lan_medium = wifi_lan_result.value();
-    }
-    if (wifi_lan_medium != UNKNOWN_MEDIUM) {
-      NEARBY_LOGS(INFO)
-          << "P2pClusterPcpHandler::StartAdvertisingImpl: WifiLan added";
-      mediums_started_successfully.push_back(wifi_lan_medium);
-    }
-    std::unique_ptr<ConnectionsLog::OperationResultWithMedium>
-        operation_result_with_medium = GetOperationResultWithMediumByResultCode(
-            client, WIFI_LAN, /*update_index=*/0,
-            wifi_lan_result.has_error()
-                ? wifi_lan_result.error().operation_result_code().value()
-                : OperationResultCode::DETAIL_SUCCESS);
-    operation_result_with_mediums.push_back(*operation_result_with_medium);
+    RunMediumStartup("start-wifi-lan-advertising", [&]() {
+      wifi_lan_result = MeasureMediumStartup(
+          [&]() {
+            return StartWifiLanAdvertising(client, service_id,
+                                           local_endpoint_id,
+                                           local_endpoint_info, web_rtc_state);
+          },
+          wifi_lan_latency);
+      wifi_lan_started.CountDown();
+    });
   }
 
   if (advertising_options.allowed.bluetooth) {
     const ByteArray bluetooth_hash =
         GenerateHash(service_id, BluetoothDeviceName::kServiceIdHashLength);
-    ErrorOr<Medium> bluetooth_result = StartBluetoothAdvertising(
-        client, service_id, bluetooth_hash, local_endpoint_id,
-        local_endpoint_info, web_rtc_state);
+    absl::Duration bluetooth_latency;
+    ErrorOr<Medium> bluetooth_result = MeasureMediumStartup(
+        [&]() {
+          return StartBluetoothAdvertising(client, service_id, bluetooth_hash,
+                                           local_endpoint_id,
+                                           local_endpoint_info, web_rtc_state);
+        },
+        bluetooth_latency);
     Medium bluetooth_medium = UNKNOWN_MEDIUM;
     if (bluetooth_result.has_value()) {
       bluetooth_medium = bluetooth_result.value();
@@ -196,9 +332,7 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartAdvertisingImpl(
       // TODO(hais): update this after ble_v2 refactor.
       if (api::ImplementationPlatform::GetCurrentOS() ==
               api::OSName::kChromeOS &&
-          !NearbyFlags::GetInstance().GetBoolFlag(
-              config_package_nearby::nearby_connections_feature::
-                  kEnableBleV2)) {
+          !IsBleV2Enabled()) {
         if (ble_medium_.StartLegacyAdvertising(
                 service_id, local_endpoint_id,
                 advertising_options.fast_advertisement_service_uuid)) {
@@ -219,9 +353,7 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartAdvertisingImpl(
                       api::OSName::kChromeOS ||
                   api::ImplementationPlatform::GetCurrentOS() ==
                       api::OSName::kLinux) &&
-                 NearbyFlags::GetInstance().GetBoolFlag(
-                     config_package_nearby::nearby_connections_feature::
-                         kEnableBleV2)) {
+                 IsBleV2Enabled()) {
         if (ble_v2_medium_.StartLegacyAdvertising(
                 service_id, local_endpoint_id,
                 advertising_options.fast_advertisement_service_uuid)) {
@@ -250,25 +382,35 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartAdvertisingImpl(
             bluetooth_result.has_error()
                 ? bluetooth_result.error().operation_result_code().value()
                 : OperationResultCode::DETAIL_SUCCESS);
+    operation_result_with_medium->set_latency_millis(
+        absl::ToInt64Milliseconds(bluetooth_latency));
     operation_result_with_mediums.push_back(*operation_result_with_medium);
   }
 
   if (advertising_options.allowed.ble) {
     ErrorOr<Medium> ble_result = {Error(OperationResultCode::DETAIL_UNKNOWN)};
-    if (NearbyFlags::GetInstance().GetBoolFlag(
-            config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
-      ble_result = StartBleV2Advertising(client, service_id, local_endpoint_id,
+    absl::Duration ble_latency;
+    if (IsBleV2Enabled()) {
+      ble_result = MeasureMediumStartup(
+          [&]() {
+            return StartBleV2Advertising(client, service_id, local_endpoint_id,
                                          local_endpoint_info,
                                          advertising_options, web_rtc_state);
+          },
+          ble_latency);
       if (ble_result.has_value() && ble_result.value() != UNKNOWN_MEDIUM) {
         NEARBY_LOGS(INFO)
             << "P2pClusterPcpHandler::StartAdvertisingImpl: Ble added";
         mediums_started_successfully.push_back(ble_result.value());
       }
     } else {
-      ble_result = StartBleAdvertising(client, service_id, local_endpoint_id,
+      ble_result = MeasureMediumStartup(
+          [&]() {
+            return StartBleAdvertising(client, service_id, local_endpoint_id,
                                        local_endpoint_info, advertising_options,
                                        web_rtc_state);
+          },
+          ble_latency);
       if (ble_result.has_value() && ble_result.value() != UNKNOWN_MEDIUM) {
         NEARBY_LOGS(INFO)
             << "P2pClusterPcpHandler::StartAdvertisingImpl: Ble added";
@@ -281,6 +423,33 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartAdvertisingImpl(
             ble_result.has_error()
                 ? ble_result.error().operation_result_code().value()
                 : OperationResultCode::DETAIL_SUCCESS);
+    operation_result_with_medium->set_latency_millis(
+        absl::ToInt64Milliseconds(ble_latency));
+    operation_result_with_mediums.push_back(*operation_result_with_medium);
+  }
+
+  if (advertising_options.allowed.wifi_lan) {
+    wifi_lan_started.Await();
+    Medium wifi_lan_medium = UNKNOWN_MEDIUM;
+    if (wifi_lan_result.has_value()) {
+      wifi_lan_medium = wifi_lan_result.value();
+    }
+    if (wifi_lan_medium != UNKNOWN_MEDIUM) {
+      NEARBY_LOGS(INFO)
+          << "P2pClusterPcpHandler::StartAdvertisingImpl: WifiLan added";
+      mediums_started_successfully.insert(mediums_started_successfully.begin(),
+                                          wifi_lan_medium);
+    }
+    std::unique_ptr<ConnectionsLog::OperationResultWithMedium>
+        operation_result_with_medium = GetOperationResultWithMediumByResultCode(
+            client, WIFI_LAN, /*update_index=*/0,
+            wifi_lan_result.has_error()
+                ? wifi_lan_result.error().operation_result_code().value()
+                : OperationResultCode::DETAIL_SUCCESS);
+    operation_result_with_medium->set_latency_millis(
+        absl::ToInt64Milliseconds(wifi_lan_latency));
+    operation_result_with_mediums.insert(operation_result_with_mediums.begin(),
+                                         *operation_result_with_medium);
   }
 
   if (mediums_started_successfully.empty()) {
@@ -311,16 +480,13 @@ Status P2pClusterPcpHandler::StopAdvertisingImpl(ClientProxy* client) {
     bluetooth_medium_.TurnOffDiscoverability();
     // TODO(hais): update this after ble_v2 refactor.
     if (api::ImplementationPlatform::GetCurrentOS() == api::OSName::kChromeOS &&
-        !NearbyFlags::GetInstance().GetBoolFlag(
-            config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+        !IsBleV2Enabled()) {
       ble_medium_.StopLegacyAdvertising(client->GetAdvertisingServiceId());
     } else if ((api::ImplementationPlatform::GetCurrentOS() ==
                     api::OSName::kChromeOS ||
                 api::ImplementationPlatform::GetCurrentOS() ==
                     api::OSName::kLinux) &&
-               NearbyFlags::GetInstance().GetBoolFlag(
-                   config_package_nearby::nearby_connections_feature::
-                       kEnableBleV2)) {
+               IsBleV2Enabled()) {
       ble_v2_medium_.StopLegacyAdvertising(client->GetAdvertisingServiceId());
     }
     bluetooth_classic_advertiser_client_id_ = 0;
@@ -333,9 +499,15 @@ Status P2pClusterPcpHandler::StopAdvertisingImpl(ClientProxy* client) {
 
   bluetooth_medium_.StopAcceptingConnections(client->GetAdvertisingServiceId());
 
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+  if (IsBleV2Enabled()) {
+    int restarts_saved = ble_v2_medium_.GetInstantOnLostRestartsSaved();
     ble_v2_medium_.StopAdvertising(client->GetAdvertisingServiceId());
+    restarts_saved =
+        ble_v2_medium_.GetInstantOnLostRestartsSaved() - restarts_saved;
+    if (restarts_saved > 0) {
+      client->GetAnalyticsRecorder().OnInstantOnLostRestartsSaved(
+          restarts_saved);
+    }
     ble_v2_medium_.StopAcceptingConnections(client->GetAdvertisingServiceId());
   } else {
     ble_medium_.StopAdvertising(client->GetAdvertisingServiceId());
@@ -345,6 +517,10 @@ Status P2pClusterPcpHandler::StopAdvertisingImpl(ClientProxy* client) {
   wifi_lan_medium_.StopAdvertising(client->GetAdvertisingServiceId());
   wifi_lan_medium_.StopAcceptingConnections(client->GetAdvertisingServiceId());
 
+  {
+    MutexLock lock(&advertisements_mutex_);
+    advertisements_.erase(client->GetAdvertisingServiceId());
+  }
   return {Status::kSuccess};
 }
 
@@ -402,7 +578,8 @@ void P2pClusterPcpHandler::BluetoothDeviceDiscoveredHandler(
 
             // Parse the Bluetooth device name.
             const std::string device_name_string = device.GetName();
-            BluetoothDeviceName device_name(device_name_string);
+            BluetoothDeviceName device_name =
+                bluetooth_device_names_.Get(device_name_string);
 
             // Make sure the Bluetooth device name points to a valid
             // endpoint we're discovering.
@@ -454,7 +631,8 @@ void P2pClusterPcpHandler::BluetoothNameChangedHandler(
 
             // Parse the Bluetooth device name.
             const std::string device_name_string = device.GetName();
-            BluetoothDeviceName device_name(device_name_string);
+            BluetoothDeviceName device_name =
+                bluetooth_device_names_.Get(device_name_string);
             NEARBY_LOGS(INFO)
                 << "BT discovery handler (CHANGED) [client_id="
                 << client->GetClientId() << ", service_id=" << service_id
@@ -539,7 +717,8 @@ void P2pClusterPcpHandler::BluetoothDeviceLostHandler(
         }
 
         // Parse the Bluetooth device name.
-        BluetoothDeviceName device_name(device_name_string);
+        BluetoothDeviceName device_name =
+            bluetooth_device_names_.Get(device_name_string);
 
         // Make sure the Bluetooth device name points to a valid
         // endpoint we're discovering.
@@ -985,9 +1164,7 @@ void P2pClusterPcpHandler::BleV2InstantLostHandler(
 }
 
 void P2pClusterPcpHandler::BleV2LegacyDeviceDiscoveredHandler() {
-  if (!NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::
-              kDisableBluetoothClassicScanning)) {
+  if (!IsBluetoothClassicScanningDisabled()) {
     return;
   }
 
@@ -1160,32 +1337,30 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartDiscoveryImpl(
   std::vector<ConnectionsLog::OperationResultWithMedium>
       operation_result_with_mediums;
 
+  // As when advertising, WifiLan may start alongside the mediums sharing the
+  // Bluetooth radio.
+  ErrorOr<Medium> wifi_lan_result = {
+      Error(OperationResultCode::DETAIL_UNKNOWN)};
+  absl::Duration wifi_lan_latency;
+  CountDownLatch wifi_lan_started(1);
   if (discovery_options.allowed.wifi_lan) {
-    ErrorOr<Medium> wifi_lan_result = StartWifiLanDiscovery(client, service_id);
-    Medium wifi_lan_medium = UNKNOWN_MEDIUM;
-    if (wifi_lan_result.has_value()) {
-      wifi_lan_medium = wifi_lan_result.value();
-    }
-    if (wifi_lan_medium != UNKNOWN_MEDIUM) {
-      NEARBY_LOGS(INFO)
-          << "P2pClusterPcpHandler::StartDiscoveryImpl: WifiLan added";
-      mediums_started_successfully.push_back(wifi_lan_medium);
-    }
-    std::unique_ptr<ConnectionsLog::OperationResultWithMedium>
-        operation_result_with_medium = GetOperationResultWithMediumByResultCode(
-            client, WIFI_LAN,
-            /*update_index=*/0,
-            wifi_lan_result.has_error()
-                ? wifi_lan_result.error().operation_result_code().value()
-                : OperationResultCode::DETAIL_SUCCESS);
-    operation_result_with_mediums.push_back(*operation_result_with_medium);
+    RunMediumStartup("start-wifi-lan-discovery", [&]() {
+      wifi_lan_result = MeasureMediumStartup(
+          [&]() { return StartWifiLanDiscovery(client, service_id); },
+          wifi_lan_latency);
+      wifi_lan_started.CountDown();
+    });
   }
 
   if (discovery_options.allowed.ble) {
     ErrorOr<Medium> ble_result = {Error(OperationResultCode::DETAIL_UNKNOWN)};
-    if (NearbyFlags::GetInstance().GetBoolFlag(
-            config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
-      ble_result = StartBleV2Scanning(client, service_id, discovery_options);
+    absl::Duration ble_latency;
+    if (IsBleV2Enabled()) {
+      ble_result = MeasureMediumStartup(
+          [&]() {
+            return StartBleV2Scanning(client, service_id, discovery_options);
+          },
+          ble_latency);
       Medium ble_v2_medium = UNKNOWN_MEDIUM;
       if (ble_result.has_value()) {
         ble_v2_medium = ble_result.value();
@@ -1196,9 +1371,13 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartDiscoveryImpl(
         mediums_started_successfully.push_back(ble_v2_medium);
       }
     } else {
-      ble_result =
-          StartBleScanning(client, service_id,
-                           discovery_options.fast_advertisement_service_uuid);
+      ble_result = MeasureMediumStartup(
+          [&]() {
+            return StartBleScanning(
+                client, service_id,
+                discovery_options.fast_advertisement_service_uuid);
+          },
+          ble_latency);
       Medium ble_medium = UNKNOWN_MEDIUM;
       if (ble_result.has_value()) {
         ble_medium = ble_result.value();
@@ -1216,19 +1395,21 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartDiscoveryImpl(
             ble_result.has_error()
                 ? ble_result.error().operation_result_code().value()
                 : OperationResultCode::DETAIL_SUCCESS);
+    operation_result_with_medium->set_latency_millis(
+        absl::ToInt64Milliseconds(ble_latency));
     operation_result_with_mediums.push_back(*operation_result_with_medium);
   }
 
   if (discovery_options.allowed.bluetooth) {
-    if (NearbyFlags::GetInstance().GetBoolFlag(
-            config_package_nearby::nearby_connections_feature::
-                kDisableBluetoothClassicScanning)) {
+    if (IsBluetoothClassicScanningDisabled()) {
       StartBluetoothDiscoveryWithPause(
           client, service_id, discovery_options, mediums_started_successfully,
           operation_result_with_mediums, /*update_index=*/0);
     } else {
-      ErrorOr<Medium> bluetooth_result =
-          StartBluetoothDiscovery(client, service_id);
+      absl::Duration bluetooth_latency;
+      ErrorOr<Medium> bluetooth_result = MeasureMediumStartup(
+          [&]() { return StartBluetoothDiscovery(client, service_id); },
+          bluetooth_latency);
       if (bluetooth_result.has_value()) {
         NEARBY_LOGS(INFO)
             << "P2pClusterPcpHandler::StartDiscoveryImpl: BT added";
@@ -1244,10 +1425,37 @@ BasePcpHandler::StartOperationResult P2pClusterPcpHandler::StartDiscoveryImpl(
                   bluetooth_result.has_error()
                       ? bluetooth_result.error().operation_result_code().value()
                       : OperationResultCode::DETAIL_SUCCESS);
+      operation_result_with_medium->set_latency_millis(
+          absl::ToInt64Milliseconds(bluetooth_latency));
       operation_result_with_mediums.push_back(*operation_result_with_medium);
     }
   }
 
+  if (discovery_options.allowed.wifi_lan) {
+    wifi_lan_started.Await();
+    Medium wifi_lan_medium = UNKNOWN_MEDIUM;
+    if (wifi_lan_result.has_value()) {
+      wifi_lan_medium = wifi_lan_result.value();
+    }
+    if (wifi_lan_medium != UNKNOWN_MEDIUM) {
+      NEARBY_LOGS(INFO)
+          << "P2pClusterPcpHandler::StartDiscoveryImpl: WifiLan added";
+      mediums_started_successfully.insert(mediums_started_successfully.begin(),
+                                          wifi_lan_medium);
+    }
+    std::unique_ptr<ConnectionsLog::OperationResultWithMedium>
+        operation_result_with_medium = GetOperationResultWithMediumByResultCode(
+            client, WIFI_LAN,
+            /*update_index=*/0,
+            wifi_lan_result.has_error()
+                ? wifi_lan_result.error().operation_result_code().value()
+                : OperationResultCode::DETAIL_SUCCESS);
+    operation_result_with_medium->set_latency_millis(
+        absl::ToInt64Milliseconds(wifi_lan_latency));
+    operation_result_with_mediums.insert(operation_result_with_mediums.begin(),
+                                         *operation_result_with_medium);
+  }
+
   if (mediums_started_successfully.empty()) {
     NEARBY_LOGS(ERROR)
         << "Failed StartDiscovery() for client=" << client->GetClientId()
@@ -1283,16 +1491,13 @@ Status P2pClusterPcpHandler::StopDiscoveryImpl(ClientProxy* client) {
                       << " because it is not in discovery.";
   }
 
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+  if (IsBleV2Enabled()) {
     ble_v2_medium_.StopScanning(client->GetDiscoveryServiceId());
   } else {
     ble_medium_.StopScanning(client->GetDiscoveryServiceId());
   }
 
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::
-              kDisableBluetoothClassicScanning)) {
+  if (IsBluetoothClassicScanningDisabled()) {
     paused_bluetooth_clients_discoveries_.erase(
         client->GetDiscoveryServiceId());
   }
@@ -1333,27 +1538,42 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::ConnectImpl(
         .status = {Status::kError},
     };
   }
+  return CancellableConnectImpl(
+      client, endpoint, client->GetCancellationFlag(endpoint->endpoint_id));
+}
+
+BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::CancellableConnectImpl(
+    ClientProxy* client, BasePcpHandler::DiscoveredEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
+  if (!endpoint) {
+    return BasePcpHandler::ConnectImplResult{
+        .status = {Status::kError},
+    };
+  }
+  NEARBY_TRACE_EVENT_WITH_FLOW(
+      "connections.connect",
+      location::nearby::proto::connections::Medium_Name(endpoint->medium),
+      TraceFlowIdForEndpoint(endpoint->endpoint_id));
   switch (endpoint->medium) {
     case BLUETOOTH: {
       auto* bluetooth_endpoint = down_cast<BluetoothEndpoint*>(endpoint);
       if (bluetooth_endpoint) {
-        return BluetoothConnectImpl(client, bluetooth_endpoint);
+        return BluetoothConnectImpl(client, bluetooth_endpoint,
+                                    cancellation_flag);
       }
       break;
     }
     case BLE: {
-      if (NearbyFlags::GetInstance().GetBoolFlag(
-              config_package_nearby::nearby_connections_feature::
-                  kEnableBleV2)) {
+      if (IsBleV2Enabled()) {
         auto* ble_v2_endpoint = down_cast<BleV2Endpoint*>(endpoint);
         if (ble_v2_endpoint) {
-          return BleV2ConnectImpl(client, ble_v2_endpoint);
+          return BleV2ConnectImpl(client, ble_v2_endpoint, cancellation_flag);
         }
 
       } else {
         auto* ble_endpoint = down_cast<BleEndpoint*>(endpoint);
         if (ble_endpoint) {
-          return BleConnectImpl(client, ble_endpoint);
+          return BleConnectImpl(client, ble_endpoint, cancellation_flag);
         }
       }
       break;
@@ -1361,7 +1581,7 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::ConnectImpl(
     case WIFI_LAN: {
       auto* wifi_lan_endpoint = down_cast<WifiLanEndpoint*>(endpoint);
       if (wifi_lan_endpoint) {
-        return WifiLanConnectImpl(client, wifi_lan_endpoint);
+        return WifiLanConnectImpl(client, wifi_lan_endpoint, cancellation_flag);
       }
       break;
     }
@@ -1411,8 +1631,7 @@ P2pClusterPcpHandler::StartListeningForIncomingConnectionsImpl(
     operation_result_with_mediums.push_back(*operation_result_with_medium);
   }
   // ble
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+  if (IsBleV2Enabled()) {
     // ble_v2
     if (options.enable_ble_listening &&
         !ble_v2_medium_.IsAcceptingConnections(std::string(service_id))) {
@@ -1503,8 +1722,7 @@ void P2pClusterPcpHandler::StopListeningForIncomingConnectionsImpl(
           << "Unable to stop bluetooth medium from accepting connections.";
     }
   }
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+  if (IsBleV2Enabled()) {
     if (ble_v2_medium_.IsAcceptingConnections(
             client->GetListeningForIncomingConnectionsServiceId())) {
       if (!ble_v2_medium_.StopAcceptingConnections(
@@ -1532,11 +1750,55 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
     const AdvertisingOptions& advertising_options) {
   AdvertisingOptions old_options = client->GetAdvertisingOptions();
   bool needs_restart = old_options.low_power != advertising_options.low_power;
+  WebRtcState web_rtc_state = webrtc_medium_.IsAvailable()
+                                  ? WebRtcState::kConnectable
+                                  : WebRtcState::kUndefined;
+  bool restart_ble = needs_restart;
+  bool restart_wifi_lan = needs_restart;
+  bool restart_bluetooth = needs_restart;
+  if (FeatureFlags::GetInstance()
+          .GetFlags()
+          .enable_incremental_advertising_update) {
+    // Advertises what StartAdvertisingImpl() does, so that an update alone
+    // doesn't change the advertisements.
+    web_rtc_state = WebRtcState::kUnconnectable;
+    if (!needs_restart) {
+      // Only the mediums whose advertisement changes restart.
+      std::string service_id_str(service_id);
+      std::string endpoint_id(local_endpoint_id);
+      ByteArray endpoint_info{std::string(local_endpoint_info)};
+      restart_ble =
+          old_options.allowed.ble &&
+          IsAdvertisementChanged(
+              service_id_str, BLE,
+              {.encoded = std::string(EncodeBleAdvertisement(
+                   service_id_str, endpoint_id, endpoint_info,
+                   advertising_options, web_rtc_state)),
+               .low_power = advertising_options.low_power,
+               .fast_advertisement_service_uuid =
+                   advertising_options.fast_advertisement_service_uuid});
+      restart_wifi_lan =
+          old_options.allowed.wifi_lan &&
+          IsAdvertisementChanged(
+              service_id_str, WIFI_LAN,
+              {.encoded = EncodeNsdServiceInfo(EncodeWifiLanServiceInfo(
+                   service_id_str, endpoint_id, endpoint_info,
+                   web_rtc_state))});
+      restart_bluetooth =
+          old_options.allowed.bluetooth &&
+          IsAdvertisementChanged(
+              service_id_str, BLUETOOTH,
+              {.encoded = EncodeBluetoothDeviceName(
+                   GenerateHash(service_id_str,
+                                BluetoothDeviceName::kServiceIdHashLength),
+                   endpoint_id, endpoint_info, web_rtc_state)});
+    }
+  }
   // ble
   if (NeedsToTurnOffAdvertisingMedium(BLE, old_options, advertising_options) ||
-      needs_restart) {
-    if (NearbyFlags::GetInstance().GetBoolFlag(
-            config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+      restart_ble) {
+    OnAdvertisementStopped(std::string(service_id), BLE);
+    if (IsBleV2Enabled()) {
       mediums_->GetBleV2().StopAdvertising(std::string(service_id));
       mediums_->GetBleV2().StopAcceptingConnections(std::string(service_id));
     } else {
@@ -1547,14 +1809,16 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
   // wifi lan
   if (NeedsToTurnOffAdvertisingMedium(WIFI_LAN, old_options,
                                       advertising_options) ||
-      needs_restart) {
+      restart_wifi_lan) {
+    OnAdvertisementStopped(std::string(service_id), WIFI_LAN);
     mediums_->GetWifiLan().StopAdvertising(std::string(service_id));
     mediums_->GetWifiLan().StopAcceptingConnections(std::string(service_id));
   }
   // Bluetooth classic
   if (NeedsToTurnOffAdvertisingMedium(BLUETOOTH, old_options,
                                       advertising_options) ||
-      needs_restart) {
+      restart_bluetooth) {
+    OnAdvertisementStopped(std::string(service_id), BLUETOOTH);
     // BT classic equivalent for advertising.
     mediums_->GetBluetoothClassic().TurnOffDiscoverability();
     mediums_->GetBluetoothClassic().StopAcceptingConnections(
@@ -1566,9 +1830,7 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
                     api::OSName::kChromeOS ||
                 api::ImplementationPlatform::GetCurrentOS() ==
                     api::OSName::kLinux) &&
-               NearbyFlags::GetInstance().GetBoolFlag(
-                   config_package_nearby::nearby_connections_feature::
-                       kEnableBleV2)) {
+               IsBleV2Enabled()) {
       mediums_->GetBleV2().StopLegacyAdvertising(
           client->GetAdvertisingServiceId());
     }
@@ -1581,14 +1843,11 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
   int update_index =
       client->GetAnalyticsRecorder().GetNextAdvertisingUpdateIndex();
   Status status = {Status::kSuccess};
-  WebRtcState web_rtc_state = webrtc_medium_.IsAvailable()
-                                  ? WebRtcState::kConnectable
-                                  : WebRtcState::kUndefined;
   // ble
   auto new_mediums = advertising_options.allowed;
   auto old_mediums = old_options.allowed;
   if (new_mediums.ble) {
-    if (old_mediums.ble && !needs_restart) {
+    if (old_mediums.ble && !restart_ble) {
       restarted_mediums.push_back(BLE);
       std::unique_ptr<ConnectionsLog::OperationResultWithMedium>
           operation_result_with_medium =
@@ -1598,9 +1857,7 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
       operation_result_with_mediums.push_back(*operation_result_with_medium);
     } else {
       ErrorOr<Medium> ble_result = {Error(OperationResultCode::DETAIL_UNKNOWN)};
-      if (NearbyFlags::GetInstance().GetBoolFlag(
-              config_package_nearby::nearby_connections_feature::
-                  kEnableBleV2)) {
+      if (IsBleV2Enabled()) {
         ble_result = StartBleV2Advertising(
             client, std::string(service_id), std::string(local_endpoint_id),
             ByteArray(std::string(local_endpoint_info)), advertising_options,
@@ -1633,7 +1890,7 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
   }
   // wifi lan
   if (new_mediums.wifi_lan && !advertising_options.low_power) {
-    if (old_mediums.wifi_lan && !needs_restart) {
+    if (old_mediums.wifi_lan && !restart_wifi_lan) {
       restarted_mediums.push_back(WIFI_LAN);
       std::unique_ptr<ConnectionsLog::OperationResultWithMedium>
           operation_result_with_medium =
@@ -1663,7 +1920,7 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
   }
   // bluetooth classic
   if (new_mediums.bluetooth && !advertising_options.low_power) {
-    if (old_mediums.bluetooth && !needs_restart) {
+    if (old_mediums.bluetooth && !restart_bluetooth) {
       restarted_mediums.push_back(BLUETOOTH);
       std::unique_ptr<ConnectionsLog::OperationResultWithMedium>
           operation_result_with_medium =
@@ -1683,9 +1940,7 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
         // TODO(hais): update this after ble_v2 refactor.
         if (api::ImplementationPlatform::GetCurrentOS() ==
                 api::OSName::kChromeOS &&
-            !NearbyFlags::GetInstance().GetBoolFlag(
-                config_package_nearby::nearby_connections_feature::
-                    kEnableBleV2)) {
+            !IsBleV2Enabled()) {
           if (ble_medium_.StartLegacyAdvertising(
                   std::string(service_id), std::string(local_endpoint_id),
                   advertising_options.fast_advertisement_service_uuid)) {
@@ -1706,9 +1961,7 @@ P2pClusterPcpHandler::UpdateAdvertisingOptionsImpl(
                         api::OSName::kChromeOS ||
                     api::ImplementationPlatform::GetCurrentOS() ==
                         api::OSName::kLinux) &&
-                   NearbyFlags::GetInstance().GetBoolFlag(
-                       config_package_nearby::nearby_connections_feature::
-                           kEnableBleV2)) {
+                   IsBleV2Enabled()) {
           if (ble_v2_medium_.StartLegacyAdvertising(
                   std::string(service_id), std::string(local_endpoint_id),
                   advertising_options.fast_advertisement_service_uuid)) {
@@ -1772,8 +2025,7 @@ P2pClusterPcpHandler::UpdateDiscoveryOptionsImpl(
   bool needs_restart = old_options.low_power != discovery_options.low_power;
   // ble
   if (NeedsToTurnOffDiscoveryMedium(BLE, old_options, discovery_options)) {
-    if (NearbyFlags::GetInstance().GetBoolFlag(
-            config_package_nearby::nearby_connections_feature::kEnableBleV2)) {
+    if (IsBleV2Enabled()) {
       ble_v2_medium_.StopScanning(std::string(service_id));
     } else {
       ble_medium_.StopScanning(std::string(service_id));
@@ -1815,9 +2067,7 @@ P2pClusterPcpHandler::UpdateDiscoveryOptionsImpl(
       operation_result_with_mediums.push_back(*operation_result_with_medium);
     } else {
       ErrorOr<Medium> ble_result = {Error(OperationResultCode::DETAIL_UNKNOWN)};
-      if (NearbyFlags::GetInstance().GetBoolFlag(
-              config_package_nearby::nearby_connections_feature::
-                  kEnableBleV2)) {
+      if (IsBleV2Enabled()) {
         ble_result = StartBleV2Scanning(client, std::string(service_id),
                                         discovery_options);
         if (ble_result.has_value()) {
@@ -1859,9 +2109,7 @@ P2pClusterPcpHandler::UpdateDiscoveryOptionsImpl(
                   OperationResultCode::DETAIL_SUCCESS);
       operation_result_with_mediums.push_back(*operation_result_with_medium);
     } else {
-      if (NearbyFlags::GetInstance().GetBoolFlag(
-              config_package_nearby::nearby_connections_feature::
-                  kDisableBluetoothClassicScanning)) {
+      if (IsBluetoothClassicScanningDisabled()) {
         StartBluetoothDiscoveryWithPause(
             client, std::string(service_id), discovery_options,
             restarted_mediums, operation_result_with_mediums, update_index);
@@ -1950,8 +2198,9 @@ void P2pClusterPcpHandler::BluetoothConnectionAcceptedHandler(
                 /*channel_name=*/remote_device_name, socket);
             ByteArray remote_device_info{remote_device_name};
 
-            OnIncomingConnection(client, remote_device_info, std::move(channel),
-                                 BLUETOOTH, device_type);
+            AcceptIncomingConnection(client, remote_device_info,
+                                     std::move(channel), BLUETOOTH,
+                                     device_type);
           });
 }
 
@@ -2002,10 +2251,8 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBluetoothAdvertising(
 
   // Generate a BluetoothDeviceName with which to become Bluetooth
   // discoverable.
-  // TODO(b/169550050): Implement UWBAddress.
-  std::string device_name(BluetoothDeviceName(
-      kBluetoothDeviceNameVersion, GetPcp(), local_endpoint_id, service_id_hash,
-      local_endpoint_info, ByteArray{}, web_rtc_state));
+  std::string device_name = EncodeBluetoothDeviceName(
+      service_id_hash, local_endpoint_id, local_endpoint_info, web_rtc_state);
   if (device_name.empty()) {
     NEARBY_LOGS(WARNING) << "In StartBluetoothAdvertising("
                          << absl::BytesToHexString(local_endpoint_info.data())
@@ -2048,6 +2295,7 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBluetoothAdvertising(
       << "), client=" << client->GetClientId()
       << " started Bluetooth advertising with BluetoothDeviceName "
       << device_name;
+  OnAdvertisementStarted(service_id, BLUETOOTH, {.encoded = device_name});
   return {BLUETOOTH};
 }
 
@@ -2157,15 +2405,16 @@ void P2pClusterPcpHandler::StartBluetoothDiscoveryWithPause(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BluetoothConnectImpl(
-    ClientProxy* client, BluetoothEndpoint* endpoint) {
+    ClientProxy* client, BluetoothEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_VLOG(1) << "Client " << client->GetClientId()
                  << " is attempting to connect to endpoint(id="
                  << endpoint->endpoint_id << ") over Bluetooth Classic.";
   BluetoothDevice& device = endpoint->bluetooth_device;
 
-  ErrorOr<BluetoothSocket> bluetooth_socket_result = bluetooth_medium_.Connect(
-      device, endpoint->service_id,
-      client->GetCancellationFlag(endpoint->endpoint_id));
+  ErrorOr<BluetoothSocket> bluetooth_socket_result =
+      bluetooth_medium_.Connect(device, endpoint->service_id,
+                                cancellation_flag);
   if (bluetooth_socket_result.has_error()) {
     NEARBY_LOGS(ERROR)
         << "In BluetoothConnectImpl(), failed to connect to Bluetooth device "
@@ -2183,12 +2432,12 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BluetoothConnectImpl(
   NEARBY_VLOG(1) << "Client" << client->GetClientId()
                  << " created Bluetooth endpoint channel to endpoint(id="
                  << endpoint->endpoint_id << ").";
-  client->SetBluetoothMacAddress(endpoint->endpoint_id, device.GetMacAddress());
   return BasePcpHandler::ConnectImplResult{
       .medium = BLUETOOTH,
       .status = {Status::kSuccess},
       .operation_result_code = OperationResultCode::DETAIL_SUCCESS,
-      .endpoint_channel = std::move(channel)
+      .endpoint_channel = std::move(channel),
+      .bluetooth_mac_address = device.GetMacAddress(),
   };
 }
 
@@ -2214,8 +2463,8 @@ void P2pClusterPcpHandler::BleConnectionAcceptedHandler(
             ByteArray remote_peripheral_info =
                 socket.GetRemotePeripheral().GetAdvertisementBytes(service_id);
 
-            OnIncomingConnection(client, remote_peripheral_info,
-                                 std::move(channel), BLE, device_type);
+            AcceptIncomingConnection(client, remote_peripheral_info,
+                                     std::move(channel), BLE, device_type);
           });
 }
 
@@ -2320,27 +2569,10 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBleAdvertising(
                     << " start to generate BleAdvertisement with service_id="
                     << service_id
                     << ", local endpoint_id=" << local_endpoint_id;
-  // Generate a BleAdvertisement. If a fast advertisement service UUID was
-  // provided, create a fast BleAdvertisement.
-  ByteArray advertisement_bytes;
-  // TODO(b/169550050): Implement UWBAddress.
-  if (fast_advertisement) {
-    advertisement_bytes = ByteArray(
-        BleAdvertisement(kBleAdvertisementVersion, GetPcp(), local_endpoint_id,
-                         local_endpoint_info, ByteArray{}));
-  } else {
-    const ByteArray service_id_hash =
-        GenerateHash(service_id, BleAdvertisement::kServiceIdHashLength);
-    std::string bluetooth_mac_address;
-    if (bluetooth_medium_.IsAvailable() &&
-        ShouldAdvertiseBluetoothMacOverBle(power_level))
-      bluetooth_mac_address = bluetooth_medium_.GetMacAddress();
-
-    advertisement_bytes = ByteArray(
-        BleAdvertisement(kBleAdvertisementVersion, GetPcp(), service_id_hash,
-                         local_endpoint_id, local_endpoint_info,
-                         bluetooth_mac_address, ByteArray{}, web_rtc_state));
-  }
+  ByteArray advertisement_bytes =
+      EncodeBleAdvertisement(service_id, local_endpoint_id,
+                             local_endpoint_info, advertising_options,
+                             web_rtc_state);
   if (advertisement_bytes.Empty()) {
     NEARBY_LOGS(WARNING) << "In StartBleAdvertising("
                          << absl::BytesToHexString(local_endpoint_info.data())
@@ -2376,6 +2608,12 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBleAdvertising(
                     << "), client=" << client->GetClientId()
                     << " started BLE Advertising with BleAdvertisement "
                     << absl::BytesToHexString(advertisement_bytes.data());
+  OnAdvertisementStarted(
+      service_id, BLE,
+      {.encoded = std::string(advertisement_bytes),
+       .low_power = advertising_options.low_power,
+       .fast_advertisement_service_uuid =
+           advertising_options.fast_advertisement_service_uuid});
   return {BLE};
 }
 
@@ -2415,7 +2653,8 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBleScanning(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleConnectImpl(
-    ClientProxy* client, BleEndpoint* endpoint) {
+    ClientProxy* client, BleEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_VLOG(1) << "Client " << client->GetClientId()
                  << " is attempting to connect to endpoint(id="
                  << endpoint->endpoint_id << ") over BLE.";
@@ -2423,8 +2662,7 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleConnectImpl(
   BlePeripheral& peripheral = endpoint->ble_peripheral;
 
   ErrorOr<BleSocket> ble_socket_result =
-      ble_medium_.Connect(peripheral, endpoint->service_id,
-                          client->GetCancellationFlag(endpoint->endpoint_id));
+      ble_medium_.Connect(peripheral, endpoint->service_id, cancellation_flag);
   if (ble_socket_result.has_error()) {
     NEARBY_LOGS(ERROR)
         << "In BleConnectImpl(), failed to connect to BLE device "
@@ -2467,8 +2705,8 @@ void P2pClusterPcpHandler::BleV2ConnectionAcceptedHandler(
         auto channel = std::make_unique<BleV2EndpointChannel>(
             service_id, std::string(remote_peripheral_info), socket);
 
-        OnIncomingConnection(client, remote_peripheral_info, std::move(channel),
-                             BLE, device_type);
+        AcceptIncomingConnection(client, remote_peripheral_info,
+                                 std::move(channel), BLE, device_type);
       });
 }
 
@@ -2571,28 +2809,10 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBleV2Advertising(
                     << " start to generate BleAdvertisement with service_id="
                     << service_id
                     << ", local endpoint_id=" << local_endpoint_id;
-  // Generate a BleAdvertisement. If a fast advertisement service UUID was
-  // provided, create a fast BleAdvertisement.
-  ByteArray advertisement_bytes;
-  bool fast_advertisement =
-      !advertising_options.fast_advertisement_service_uuid.empty();
-  if (fast_advertisement) {
-    advertisement_bytes = ByteArray(
-        BleAdvertisement(kBleAdvertisementVersion, GetPcp(), local_endpoint_id,
-                         local_endpoint_info, /*uwb_address=*/ByteArray{}));
-  } else {
-    const ByteArray service_id_hash =
-        GenerateHash(service_id, BleAdvertisement::kServiceIdHashLength);
-    std::string bluetooth_mac_address;
-    if (bluetooth_medium_.IsAvailable() &&
-        ShouldAdvertiseBluetoothMacOverBle(power_level))
-      bluetooth_mac_address = bluetooth_medium_.GetMacAddress();
-
-    advertisement_bytes = ByteArray(BleAdvertisement(
-        kBleAdvertisementVersion, GetPcp(), service_id_hash, local_endpoint_id,
-        local_endpoint_info, bluetooth_mac_address,
-        /*uwb_address=*/ByteArray{}, web_rtc_state));
-  }
+  ByteArray advertisement_bytes =
+      EncodeBleAdvertisement(service_id, local_endpoint_id,
+                             local_endpoint_info, advertising_options,
+                             web_rtc_state);
   if (advertisement_bytes.Empty()) {
     NEARBY_LOGS(WARNING) << "In StartBleV2Advertising("
                          << absl::BytesToHexString(local_endpoint_info.data())
@@ -2626,6 +2846,12 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBleV2Advertising(
                     << "), client=" << client->GetClientId()
                     << " started BLE Advertising with BleAdvertisement "
                     << absl::BytesToHexString(advertisement_bytes.data());
+  OnAdvertisementStarted(
+      service_id, BLE,
+      {.encoded = std::string(advertisement_bytes),
+       .low_power = advertising_options.low_power,
+       .fast_advertisement_service_uuid =
+           advertising_options.fast_advertisement_service_uuid});
   return {BLE};
 }
 
@@ -2671,7 +2897,8 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartBleV2Scanning(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleV2ConnectImpl(
-    ClientProxy* client, BleV2Endpoint* endpoint) {
+    ClientProxy* client, BleV2Endpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_VLOG(1) << "Client " << client->GetClientId()
                  << " is attempting to connect to endpoint(id="
                  << endpoint->endpoint_id << ") over BLE.";
@@ -2679,8 +2906,7 @@ BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::BleV2ConnectImpl(
   BleV2Peripheral& peripheral = endpoint->ble_peripheral;
 
   ErrorOr<BleV2Socket> ble_socket_result = ble_v2_medium_.Connect(
-      endpoint->service_id, peripheral,
-      client->GetCancellationFlag(endpoint->endpoint_id));
+      endpoint->service_id, peripheral, cancellation_flag);
   if (ble_socket_result.has_error()) {
     NEARBY_LOGS(ERROR)
         << "In BleV2ConnectImpl(), failed to connect to BLE device "
@@ -2724,8 +2950,8 @@ void P2pClusterPcpHandler::WifiLanConnectionAcceptedHandler(
             service_id, /*channel_name=*/remote_service_name, socket);
         ByteArray remote_service_name_byte{remote_service_name};
 
-        OnIncomingConnection(client, remote_service_name_byte,
-                             std::move(channel), WIFI_LAN, device_type);
+        AcceptIncomingConnection(client, remote_service_name_byte,
+                                 std::move(channel), WIFI_LAN, device_type);
       });
 }
 
@@ -2763,17 +2989,8 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartWifiLanAdvertising(
   }
 
   // Generate a WifiLanServiceInfo with which to become WifiLan discoverable.
-  // TODO(b/169550050): Implement UWBAddress.
-  const ByteArray service_id_hash =
-      GenerateHash(service_id, WifiLanServiceInfo::kServiceIdHashLength);
-  WifiLanServiceInfo service_info{kWifiLanServiceInfoVersion,
-                                  GetPcp(),
-                                  local_endpoint_id,
-                                  service_id_hash,
-                                  local_endpoint_info,
-                                  ByteArray{},
-                                  web_rtc_state};
-  NsdServiceInfo nsd_service_info(service_info);
+  NsdServiceInfo nsd_service_info = EncodeWifiLanServiceInfo(
+      service_id, local_endpoint_id, local_endpoint_info, web_rtc_state);
   if (!nsd_service_info.IsValid()) {
     NEARBY_LOGS(WARNING) << "In StartWifiLanAdvertising("
                          << absl::BytesToHexString(local_endpoint_info.data())
@@ -2782,8 +2999,7 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartWifiLanAdvertising(
                          << static_cast<int>(kWifiLanServiceInfoVersion)
                          << ", pcp=" << PcpToStrategy(GetPcp()).GetName()
                          << ", endpoint_id=" << local_endpoint_id
-                         << ", service_id_hash="
-                         << absl::BytesToHexString(service_id_hash.data())
+                         << ", service_id=" << service_id
                          << ", endpoint_info="
                          << absl::BytesToHexString(local_endpoint_info.data())
                          << "}.";
@@ -2814,6 +3030,8 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartWifiLanAdvertising(
                     << "), client=" << client->GetClientId()
                     << " advertised with WifiLanServiceInfo "
                     << nsd_service_info.GetServiceName();
+  OnAdvertisementStarted(service_id, WIFI_LAN,
+                         {.encoded = EncodeNsdServiceInfo(nsd_service_info)});
   return {WIFI_LAN};
 }
 
@@ -2844,13 +3062,13 @@ ErrorOr<Medium> P2pClusterPcpHandler::StartWifiLanDiscovery(
 }
 
 BasePcpHandler::ConnectImplResult P2pClusterPcpHandler::WifiLanConnectImpl(
-    ClientProxy* client, WifiLanEndpoint* endpoint) {
+    ClientProxy* client, WifiLanEndpoint* endpoint,
+    CancellationFlag* cancellation_flag) {
   NEARBY_LOGS(INFO) << "Client " << client->GetClientId()
                     << " is attempting to connect to endpoint(id="
                     << endpoint->endpoint_id << ") over WifiLan.";
   ErrorOr<WifiLanSocket> socket_result = wifi_lan_medium_.Connect(
-      endpoint->service_id, endpoint->service_info,
-      client->GetCancellationFlag(endpoint->endpoint_id));
+      endpoint->service_id, endpoint->service_info, cancellation_flag);
   if (socket_result.has_error()) {
     NEARBY_LOGS(ERROR)
         << "In WifiLanConnectImpl(), failed to connect to service "
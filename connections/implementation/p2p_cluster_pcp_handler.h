@@ -17,9 +17,11 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "connections/advertising_options.h"
@@ -50,7 +52,10 @@
 #include "internal/platform/ble_v2.h"
 #include "internal/platform/bluetooth_adapter.h"
 #include "internal/platform/bluetooth_classic.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/nsd_service_info.h"
+#include "internal/platform/runnable.h"
+#include "internal/platform/single_thread_executor.h"
 #include "internal/platform/wifi_lan.h"
 #ifdef NO_WEBRTC
 #include "connections/implementation/mediums/webrtc_socket_stub.h"
@@ -116,6 +121,10 @@ class P2pClusterPcpHandler : public BasePcpHandler {
       ClientProxy* client,
       BasePcpHandler::DiscoveredEndpoint* endpoint) override;
 
+  BasePcpHandler::ConnectImplResult CancellableConnectImpl(
+      ClientProxy* client, BasePcpHandler::DiscoveredEndpoint* endpoint,
+      CancellationFlag* cancellation_flag) override;
+
   // @PCPHandlerThread
   BasePcpHandler::StartOperationResult StartListeningForIncomingConnectionsImpl(
       ClientProxy* client_proxy, absl::string_view service_id,
@@ -174,7 +183,49 @@ class P2pClusterPcpHandler : public BasePcpHandler {
   static constexpr WifiLanServiceInfo::Version kWifiLanServiceInfoVersion =
       WifiLanServiceInfo::Version::kV1;
 
+  // What a medium advertises for a service: its encoded advertisement, and
+  // the options it was started with that aren't part of the encoding.
+  struct MediumAdvertisement {
+    std::string encoded;
+    bool low_power = false;
+    std::string fast_advertisement_service_uuid;
+
+    bool operator==(const MediumAdvertisement& other) const {
+      return encoded == other.encoded && low_power == other.low_power &&
+             fast_advertisement_service_uuid ==
+                 other.fast_advertisement_service_uuid;
+    }
+  };
+
   static ByteArray GenerateHash(const std::string& source, size_t size);
+  // Encode the advertisement of each medium. Return an empty advertisement on
+  // failure.
+  ByteArray EncodeBleAdvertisement(
+      const std::string& service_id, const std::string& local_endpoint_id,
+      const ByteArray& local_endpoint_info,
+      const AdvertisingOptions& advertising_options, WebRtcState web_rtc_state);
+  std::string EncodeBluetoothDeviceName(const ByteArray& service_id_hash,
+                                        const std::string& local_endpoint_id,
+                                        const ByteArray& local_endpoint_info,
+                                        WebRtcState web_rtc_state);
+  NsdServiceInfo EncodeWifiLanServiceInfo(const std::string& service_id,
+                                          const std::string& local_endpoint_id,
+                                          const ByteArray& local_endpoint_info,
+                                          WebRtcState web_rtc_state);
+  // Records the advertisement |medium| went on air with for |service_id|.
+  void OnAdvertisementStarted(const std::string& service_id, Medium medium,
+                              MediumAdvertisement advertisement)
+      ABSL_LOCKS_EXCLUDED(advertisements_mutex_);
+  void OnAdvertisementStopped(const std::string& service_id, Medium medium)
+      ABSL_LOCKS_EXCLUDED(advertisements_mutex_);
+  // Returns whether |medium| is on air for |service_id| with another
+  // advertisement than |advertisement|, or with none known.
+  bool IsAdvertisementChanged(const std::string& service_id, Medium medium,
+                              const MediumAdvertisement& advertisement) const
+      ABSL_LOCKS_EXCLUDED(advertisements_mutex_);
+  // Runs |runnable| on medium_startup_executor_ when parallel medium startup
+  // is enabled, and right away otherwise.
+  void RunMediumStartup(const std::string& name, Runnable&& runnable);
   static bool ShouldAdvertiseBluetoothMacOverBle(PowerLevel power_level);
   static bool ShouldAcceptBluetoothConnections(
       const AdvertisingOptions& advertising_options);
@@ -213,7 +264,8 @@ class P2pClusterPcpHandler : public BasePcpHandler {
                       OperationResultWithMedium>& operation_result_with_mediums,
       int update_index);
   BasePcpHandler::ConnectImplResult BluetoothConnectImpl(
-      ClientProxy* client, BluetoothEndpoint* endpoint);
+      ClientProxy* client, BluetoothEndpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   // Ble
   bool IsRecognizedBleEndpoint(const std::string& service_id,
@@ -238,8 +290,9 @@ class P2pClusterPcpHandler : public BasePcpHandler {
   ErrorOr<location::nearby::proto::connections::Medium> StartBleScanning(
       ClientProxy* client, const std::string& service_id,
       const std::string& fast_advertisement_service_uuid);
-  BasePcpHandler::ConnectImplResult BleConnectImpl(ClientProxy* client,
-                                                   BleEndpoint* endpoint);
+  BasePcpHandler::ConnectImplResult BleConnectImpl(
+      ClientProxy* client, BleEndpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   // BleV2
   bool IsRecognizedBleV2Endpoint(absl::string_view service_id,
@@ -273,8 +326,9 @@ class P2pClusterPcpHandler : public BasePcpHandler {
   ErrorOr<location::nearby::proto::connections::Medium> StartBleV2Scanning(
       ClientProxy* client, const std::string& service_id,
       const DiscoveryOptions& discovery_options);
-  BasePcpHandler::ConnectImplResult BleV2ConnectImpl(ClientProxy* client,
-                                                     BleV2Endpoint* endpoint);
+  BasePcpHandler::ConnectImplResult BleV2ConnectImpl(
+      ClientProxy* client, BleV2Endpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   // WifiLan
   bool IsRecognizedWifiLanEndpoint(
@@ -299,7 +353,8 @@ class P2pClusterPcpHandler : public BasePcpHandler {
   ErrorOr<location::nearby::proto::connections::Medium> StartWifiLanDiscovery(
       ClientProxy* client, const std::string& service_id);
   BasePcpHandler::ConnectImplResult WifiLanConnectImpl(
-      ClientProxy* client, WifiLanEndpoint* endpoint);
+      ClientProxy* client, WifiLanEndpoint* endpoint,
+      CancellationFlag* cancellation_flag);
 
   BluetoothRadio& bluetooth_radio_;
   BluetoothClassic& bluetooth_medium_;
@@ -310,6 +365,17 @@ class P2pClusterPcpHandler : public BasePcpHandler {
   WifiDirect& wifi_direct_medium_;
   mediums::WebRtc& webrtc_medium_;
   InjectedBluetoothDeviceStore& injected_bluetooth_device_store_;
+  // The names of the Bluetooth devices discovered lately, parsed.
+  BluetoothDeviceNameCache bluetooth_device_names_;
+  // Starts the mediums not sharing a radio with the others concurrently with
+  // them. Only created when parallel medium startup is enabled.
+  std::unique_ptr<SingleThreadExecutor> medium_startup_executor_;
+  // The advertisements on air, by service id and medium. Updated from the
+  // medium startup thread as well.
+  mutable Mutex advertisements_mutex_;
+  absl::flat_hash_map<std::string,
+                      absl::flat_hash_map<Medium, MediumAdvertisement>>
+      advertisements_ ABSL_GUARDED_BY(advertisements_mutex_);
   // Maintains a map of client_id to service_id for bluetooth classic
   // discoverer.
   absl::flat_hash_map<std::int64_t, std::string>
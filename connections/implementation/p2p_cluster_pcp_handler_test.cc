@@ -41,6 +41,7 @@
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/medium_environment.h"
 
@@ -571,6 +572,99 @@ TEST_P(P2pClusterPcpHandlerTestWithParam, CanDiscover) {
   env_.Stop();
 }
 
+TEST_P(P2pClusterPcpHandlerTestWithParam,
+       UpdateAdvertisingOptionsRestartsChangedMediumsOnly) {
+  bool ble_v2_enabled = std::get<1>(GetParam());
+  if (!ble_v2_enabled) {
+    // Just don't run the test if ble_v2 is disabled.
+    return;
+  }
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.enable_incremental_advertising_update = true;
+  env_.Start();
+  std::string endpoint_name{"endpoint_name"};
+  Mediums mediums_a;
+  EndpointChannelManager ecm_a;
+  EndpointManager em_a(&ecm_a);
+  BwuManager bwu_a(mediums_a, em_a, ecm_a, {}, {});
+  InjectedBluetoothDeviceStore ibds_a;
+  P2pClusterPcpHandler handler_a(&mediums_a, &em_a, &ecm_a, &bwu_a, ibds_a);
+  BooleanMediumSelector enabled = advertising_options_.allowed;
+  EXPECT_EQ(
+      handler_a.StartAdvertising(&client_a_, service_id_, advertising_options_,
+                                 {.endpoint_info = ByteArray{endpoint_name}}),
+      Status{Status::kSuccess});
+  // Take the mediums off air behind the handler's back, to tell which ones
+  // the update restarts.
+  mediums_a.GetBleV2().StopAdvertising(service_id_);
+  mediums_a.GetWifiLan().StopAdvertising(service_id_);
+  mediums_a.GetBluetoothClassic().TurnOffDiscoverability();
+
+  // Nothing changes.
+  EXPECT_EQ(handler_a.UpdateAdvertisingOptions(&client_a_, service_id_,
+                                               advertising_options_),
+            Status{Status::kSuccess});
+  EXPECT_FALSE(mediums_a.GetBleV2().IsAdvertising(service_id_));
+  EXPECT_FALSE(mediums_a.GetWifiLan().IsAdvertising(service_id_));
+  EXPECT_FALSE(mediums_a.GetBluetoothClassic().TurnOffDiscoverability());
+
+  // Only the BLE advertisement changes.
+  AdvertisingOptions new_options = advertising_options_;
+  new_options.fast_advertisement_service_uuid =
+      "0000FEF3-0000-1000-8000-00805F9B34FB";
+  EXPECT_EQ(
+      handler_a.UpdateAdvertisingOptions(&client_a_, service_id_, new_options),
+      Status{Status::kSuccess});
+  EXPECT_EQ(enabled.ble, mediums_a.GetBleV2().IsAdvertising(service_id_));
+  EXPECT_FALSE(mediums_a.GetWifiLan().IsAdvertising(service_id_));
+  EXPECT_FALSE(mediums_a.GetBluetoothClassic().TurnOffDiscoverability());
+  handler_a.StopAdvertising(&client_a_);
+  env_.Stop();
+  flags = saved_flags;
+}
+
+TEST_P(P2pClusterPcpHandlerTestWithParam, CanDiscoverWithParallelStartup) {
+  FeatureFlags::Flags& flags = FeatureFlags::GetMutableFlagsForTesting();
+  FeatureFlags::Flags saved_flags = flags;
+  flags.enable_parallel_medium_startup = true;
+  env_.Start();
+  std::string endpoint_name{"endpoint_name"};
+  Mediums mediums_a;
+  Mediums mediums_b;
+  EndpointChannelManager ecm_a;
+  EndpointChannelManager ecm_b;
+  EndpointManager em_a(&ecm_a);
+  EndpointManager em_b(&ecm_b);
+  BwuManager bwu_a(mediums_a, em_a, ecm_a, {}, {});
+  BwuManager bwu_b(mediums_b, em_b, ecm_b, {}, {});
+  InjectedBluetoothDeviceStore ibds_a;
+  InjectedBluetoothDeviceStore ibds_b;
+  P2pClusterPcpHandler handler_a(&mediums_a, &em_a, &ecm_a, &bwu_a, ibds_a);
+  P2pClusterPcpHandler handler_b(&mediums_b, &em_b, &ecm_b, &bwu_b, ibds_b);
+  CountDownLatch latch(1);
+  EXPECT_EQ(
+      handler_a.StartAdvertising(&client_a_, service_id_, advertising_options_,
+                                 {.endpoint_info = ByteArray{endpoint_name}}),
+      Status{Status::kSuccess});
+  EXPECT_EQ(handler_b.StartDiscovery(
+                &client_b_, service_id_, discovery_options_,
+                {
+                    .endpoint_found_cb =
+                        [&latch](const std::string& endpoint_id,
+                                 const ByteArray& endpoint_info,
+                                 const std::string& service_id) {
+                          latch.CountDown();
+                        },
+                }),
+            Status{Status::kSuccess});
+  EXPECT_TRUE(latch.Await(absl::Milliseconds(1000)).result());
+  handler_b.StopDiscovery(&client_b_);
+  handler_a.StopAdvertising(&client_a_);
+  env_.Stop();
+  flags = saved_flags;
+}
+
 TEST_P(P2pClusterPcpHandlerTestWithParam, CanDiscoverLegacy) {
   env_.Start();
   std::string endpoint_name{"endpoint_name"};
@@ -34,6 +34,12 @@ namespace connections {
 //
 // Currently, this implementation advertises/discovers over Bluetooth
 // and connects over Bluetooth.
+//
+// A hub accepting many clients scales with
+// FeatureFlags::enable_async_connection_request_read and
+// max_concurrent_server_handshakes, which accept the clients in parallel,
+// and enable_shared_endpoint_keep_alive, which keeps them alive from one
+// thread.
 class P2pStarPcpHandler : public P2pClusterPcpHandler {
  public:
   P2pStarPcpHandler(
@@ -0,0 +1,112 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_batcher.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_join.h"
+#include "absl/time/time.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+namespace connections {
+
+PayloadBatcher::PayloadBatcher(std::size_t max_batch_bytes,
+                               absl::Duration max_delay)
+    : max_batch_bytes_(max_batch_bytes), max_delay_(max_delay) {}
+
+std::vector<std::string> PayloadBatcher::Normalize(
+    std::vector<std::string> endpoint_ids) {
+  std::sort(endpoint_ids.begin(), endpoint_ids.end());
+  endpoint_ids.erase(std::unique(endpoint_ids.begin(), endpoint_ids.end()),
+                     endpoint_ids.end());
+  return endpoint_ids;
+}
+
+bool PayloadBatcher::Add(const std::vector<std::string>& endpoint_ids,
+                         std::int64_t payload_id, std::size_t size) {
+  MutexLock lock(&mutex_);
+  std::vector<std::string> normalized_ids = Normalize(endpoint_ids);
+  Batches& entry = batches_[absl::StrJoin(normalized_ids, ",")];
+  if (entry.batches.empty()) entry.endpoint_ids = normalized_ids;
+  std::deque<Batch>& batches = entry.batches;
+  bool opened = false;
+  if (batches.empty() || batches.back().closed ||
+      batches.back().bytes + size > max_batch_bytes_) {
+    // The new batch is sent after the open ones to the same endpoints.
+    CloseLocked(normalized_ids);
+    Batch batch;
+    batch.deadline = SystemClock::ElapsedRealtime() + max_delay_;
+    batches.push_back(std::move(batch));
+    opened = true;
+  }
+  Batch& batch = batches.back();
+  batch.payload_ids.push_back(payload_id);
+  batch.bytes += size;
+  if (batch.bytes >= max_batch_bytes_) batch.closed = true;
+  cond_.Notify();
+  return opened;
+}
+
+void PayloadBatcher::Close(const std::vector<std::string>& endpoint_ids) {
+  MutexLock lock(&mutex_);
+  CloseLocked(Normalize(endpoint_ids));
+}
+
+void PayloadBatcher::CloseLocked(
+    const std::vector<std::string>& endpoint_ids) {
+  for (auto& [key, batches] : batches_) {
+    if (batches.batches.empty()) continue;
+    bool overlaps = std::any_of(
+        endpoint_ids.begin(), endpoint_ids.end(),
+        [&batches](const std::string& endpoint_id) {
+          return std::binary_search(batches.endpoint_ids.begin(),
+                                    batches.endpoint_ids.end(), endpoint_id);
+        });
+    if (overlaps) batches.batches.back().closed = true;
+  }
+  cond_.Notify();
+}
+
+std::vector<std::int64_t> PayloadBatcher::Take(
+    const std::vector<std::string>& endpoint_ids) {
+  MutexLock lock(&mutex_);
+  std::string key = absl::StrJoin(Normalize(endpoint_ids), ",");
+  while (true) {
+    auto it = batches_.find(key);
+    if (it == batches_.end() || it->second.batches.empty()) return {};
+    Batch& batch = it->second.batches.front();
+    absl::Duration remaining =
+        batch.deadline - SystemClock::ElapsedRealtime();
+    if (!batch.closed && remaining > absl::ZeroDuration()) {
+      cond_.Wait(remaining);
+      continue;
+    }
+    std::vector<std::int64_t> payload_ids = std::move(batch.payload_ids);
+    it->second.batches.pop_front();
+    if (it->second.batches.empty()) batches_.erase(it);
+    return payload_ids;
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
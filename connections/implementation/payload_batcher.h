@@ -0,0 +1,107 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_PAYLOAD_BATCHER_H_
+#define CORE_INTERNAL_PAYLOAD_BATCHER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace connections {
+
+// Collects small outgoing payloads into batches that are sent in one frame.
+//
+// The first payload added for a set of endpoints opens a batch, and the
+// caller schedules a send task for it. Payloads to the same endpoints added
+// until that task takes the batch join it, so a busy peer gets fewer, larger
+// frames, while an idle one gets its payload after at most |max_delay|. A
+// batch is taken early once it holds |max_batch_bytes| bytes or is closed.
+//
+// The send tasks are scheduled on the OutgoingPayloadScheduler, which keeps
+// the order of the tasks to every endpoint. A payload may only join a batch
+// if nothing was scheduled for any of its endpoints since the batch opened,
+// so opening a batch closes the open batches to any of the same endpoints.
+class PayloadBatcher {
+ public:
+  // The version advertised in ConnectionResponseFrame.payload_batching_version.
+  static constexpr std::int32_t kVersion = 1;
+
+  PayloadBatcher(std::size_t max_batch_bytes, absl::Duration max_delay);
+  ~PayloadBatcher() = default;
+
+  PayloadBatcher(const PayloadBatcher&) = delete;
+  PayloadBatcher& operator=(const PayloadBatcher&) = delete;
+
+  // Adds a payload of |size| bytes to the open batch to |endpoint_ids|.
+  // Returns true if the payload opened a new batch, which the caller must then
+  // Take().
+  bool Add(const std::vector<std::string>& endpoint_ids,
+           std::int64_t payload_id, std::size_t size)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Closes the open batches to any of |endpoint_ids|, so that no payload sent
+  // after this call joins them. Called before a payload to |endpoint_ids| is
+  // sent on its own.
+  void Close(const std::vector<std::string>& endpoint_ids)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Waits until the oldest batch to |endpoint_ids| is full, closed, or
+  // |max_delay| old, and returns the ids of its payloads in the order they
+  // were added.
+  std::vector<std::int64_t> Take(const std::vector<std::string>& endpoint_ids)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Batch {
+    std::vector<std::int64_t> payload_ids;
+    std::size_t bytes = 0;
+    absl::Time deadline;
+    bool closed = false;
+  };
+
+  struct Batches {
+    // Sorted, without duplicates.
+    std::vector<std::string> endpoint_ids;
+    // Oldest first. Only the newest one may be open.
+    std::deque<Batch> batches;
+  };
+
+  // Returns |endpoint_ids| sorted, without duplicates.
+  static std::vector<std::string> Normalize(
+      std::vector<std::string> endpoint_ids);
+  void CloseLocked(const std::vector<std::string>& endpoint_ids)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::size_t max_batch_bytes_;
+  const absl::Duration max_delay_;
+  Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  // Batches by their comma separated, normalized endpoint ids.
+  absl::flat_hash_map<std::string, Batches> batches_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_PAYLOAD_BATCHER_H_
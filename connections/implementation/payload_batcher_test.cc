@@ -0,0 +1,125 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_batcher.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(100);
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+TEST(PayloadBatcherTest, FirstPayloadOpensBatch) {
+  PayloadBatcher batcher(/*max_batch_bytes=*/1024, absl::ZeroDuration());
+
+  EXPECT_TRUE(batcher.Add({"A"}, 1, 10));
+  EXPECT_FALSE(batcher.Add({"A"}, 2, 10));
+  EXPECT_TRUE(batcher.Add({"B"}, 3, 10));
+
+  EXPECT_THAT(batcher.Take({"A"}), ElementsAre(1, 2));
+  EXPECT_THAT(batcher.Take({"B"}), ElementsAre(3));
+  EXPECT_THAT(batcher.Take({"A"}), IsEmpty());
+}
+
+TEST(PayloadBatcherTest, TakeWaitsForMaxDelay) {
+  PayloadBatcher batcher(/*max_batch_bytes=*/1024, absl::Milliseconds(50));
+  absl::Time start = absl::Now();
+
+  EXPECT_TRUE(batcher.Add({"A"}, 1, 10));
+
+  EXPECT_THAT(batcher.Take({"A"}), ElementsAre(1));
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(50));
+}
+
+TEST(PayloadBatcherTest, FullBatchIsTakenRightAway) {
+  PayloadBatcher batcher(/*max_batch_bytes=*/20, absl::Seconds(10));
+  SingleThreadExecutor executor;
+  CountDownLatch taken(1);
+  std::vector<std::int64_t> payload_ids;
+
+  EXPECT_TRUE(batcher.Add({"A"}, 1, 10));
+  executor.Execute([&]() {
+    payload_ids = batcher.Take({"A"});
+    taken.CountDown();
+  });
+
+  EXPECT_FALSE(taken.Await(kShortTimeout).result());
+  EXPECT_FALSE(batcher.Add({"A"}, 2, 10));
+  EXPECT_TRUE(taken.Await(kDefaultTimeout).result());
+  EXPECT_THAT(payload_ids, ElementsAre(1, 2));
+}
+
+TEST(PayloadBatcherTest, PayloadThatDoesNotFitOpensNextBatch) {
+  PayloadBatcher batcher(/*max_batch_bytes=*/20, absl::Seconds(10));
+
+  EXPECT_TRUE(batcher.Add({"A"}, 1, 15));
+  EXPECT_TRUE(batcher.Add({"A"}, 2, 15));
+
+  EXPECT_THAT(batcher.Take({"A"}), ElementsAre(1));
+  // Filled up, the second batch doesn't wait either.
+  EXPECT_FALSE(batcher.Add({"A"}, 3, 5));
+  EXPECT_THAT(batcher.Take({"A"}), ElementsAre(2, 3));
+}
+
+TEST(PayloadBatcherTest, ClosedBatchTakesNoMorePayloads) {
+  PayloadBatcher batcher(/*max_batch_bytes=*/1024, absl::Seconds(10));
+
+  EXPECT_TRUE(batcher.Add({"A"}, 1, 10));
+  batcher.Close({"A"});
+  EXPECT_TRUE(batcher.Add({"A"}, 2, 10));
+  batcher.Close({"A"});
+
+  EXPECT_THAT(batcher.Take({"A"}), ElementsAre(1));
+  EXPECT_THAT(batcher.Take({"A"}), ElementsAre(2));
+}
+
+TEST(PayloadBatcherTest, ClosesBatchesSharingAnEndpoint) {
+  PayloadBatcher batcher(/*max_batch_bytes=*/1024, absl::Seconds(10));
+
+  EXPECT_TRUE(batcher.Add({"A", "B"}, 1, 10));
+  EXPECT_TRUE(batcher.Add({"C"}, 2, 10));
+  // A payload sent to A on its own is sent after the batch to A and B, so
+  // the next payload to A and B can't join it.
+  batcher.Close({"A"});
+  EXPECT_TRUE(batcher.Add({"B", "A"}, 3, 10));
+  EXPECT_FALSE(batcher.Add({"C"}, 4, 10));
+  // Opening a batch to B closes the one to A and B the same way.
+  EXPECT_TRUE(batcher.Add({"B"}, 5, 10));
+  EXPECT_TRUE(batcher.Add({"A", "B"}, 6, 10));
+  batcher.Close({"A", "B", "C"});
+
+  EXPECT_THAT(batcher.Take({"A", "B"}), ElementsAre(1));
+  EXPECT_THAT(batcher.Take({"A", "B"}), ElementsAre(3));
+  EXPECT_THAT(batcher.Take({"B"}), ElementsAre(5));
+  EXPECT_THAT(batcher.Take({"A", "B"}), ElementsAre(6));
+  EXPECT_THAT(batcher.Take({"C"}), ElementsAre(2, 4));
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
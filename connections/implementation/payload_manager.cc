@@ -19,6 +19,7 @@
 #include <cstdint>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,18 +27,21 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/functional/bind_front.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
 #include "connections/implementation/analytics/throughput_recorder.h"
+#include "connections/implementation/chunk_compression.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel_manager.h"
 #include "connections/implementation/endpoint_manager.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/implementation/internal_payload.h"
 #include "connections/implementation/internal_payload_factory.h"
+#include "connections/implementation/outgoing_payload_scheduler.h"
 #include "connections/implementation/proto/offline_wire_formats.pb.h"
 #include "connections/listeners.h"
 #include "connections/medium_selector.h"
@@ -46,6 +50,7 @@
 #include "connections/status.h"
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag_listener.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/expected.h"
@@ -53,6 +58,7 @@
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/trace_event.h"
 #include "proto/connections_enums.pb.h"
 
 namespace nearby {
@@ -70,26 +76,31 @@ using ::nearby::analytics::ThroughputRecorderContainer;
 using PayloadDirection = ::nearby::connections::PayloadDirection;
 
 constexpr absl::Duration kMinTransferUpdateInterval = absl::Milliseconds(50);
+// How long the reader of an endpoint waits for room in the incoming bytes
+// budget; well within the keep-alive timeout.
+constexpr absl::Duration kIncomingBytesMaxWait = absl::Seconds(5);
 }  // namespace
 
 bool PayloadManager::SendPayloadLoop(
     ClientProxy* client, PendingPayload& pending_payload,
     PayloadTransferFrame::PayloadHeader& payload_header,
-    std::int64_t& next_chunk_offset, size_t resume_offset, int index) {
-  // in lieu of structured binding:
-  auto pair = GetAvailableAndUnavailableEndpoints(pending_payload);
-  const EndpointIds& available_endpoint_ids =
-      EndpointsToEndpointIds(pair.first);
-  const Endpoints& unavailable_endpoints = pair.second;
+    std::int64_t& next_chunk_offset, size_t resume_offset, int index,
+    ChunkReader* chunk_reader, bool high_priority, bool compress) {
   PacketMetaData packet_meta_data;
 
   // First, handle any non-available endpoints.
-  for (const auto& endpoint : unavailable_endpoints) {
-    HandleFinishedOutgoingPayload(
-        client, {endpoint->id}, payload_header, next_chunk_offset,
-        EndpointInfoStatusToOperationResultCode(endpoint->status.Get()),
-        EndpointInfoStatusToPayloadStatus(endpoint->status.Get()));
+  if (pending_payload.HasUnavailableEndpoints()) {
+    for (const auto& endpoint :
+         GetAvailableAndUnavailableEndpoints(pending_payload).second) {
+      HandleFinishedOutgoingPayload(
+          client, {endpoint->id}, payload_header, next_chunk_offset,
+          EndpointInfoStatusToOperationResultCode(endpoint->status.Get()),
+          EndpointInfoStatusToPayloadStatus(endpoint->status.Get()));
+    }
   }
+  std::shared_ptr<const EndpointIds> available_endpoints =
+      pending_payload.GetAvailableEndpointIds();
+  const EndpointIds& available_endpoint_ids = *available_endpoints;
 
   // Update the still-active recipients of this payload.
   if (available_endpoint_ids.empty()) {
@@ -143,11 +154,29 @@ bool PayloadManager::SendPayloadLoop(
   // This will block if there is no data to transfer.
   // It will resume when new data arrives, or if Close() is called.
   int chunk_size = GetOptimalChunkSize(available_endpoint_ids);
-  packet_meta_data.StartFileIo();
-  ByteArray next_chunk =
-      pending_payload.GetInternalPayload()->DetachNextChunk(chunk_size);
-  packet_meta_data.StopFileIo();
+  ByteArray next_chunk;
+  {
+    // A cancel unblocks the wait for the next chunk, instead of taking effect
+    // once data arrives.
+    CancellationFlagListener cancellation_listener(
+        &pending_payload.GetCancellationFlag(),
+        [&pending_payload, chunk_reader]() {
+          if (chunk_reader != nullptr) {
+            chunk_reader->window.Close();
+          } else {
+            pending_payload.Close();
+          }
+        });
+    // Canceled before the listener was registered.
+    if (pending_payload.IsLocallyCanceled()) return true;
+    packet_meta_data.StartFileIo();
+    next_chunk = DetachNextChunk(pending_payload, chunk_size, chunk_reader);
+    packet_meta_data.StopFileIo();
+  }
   if (shutdown_.Get()) return false;
+  // The chunk, if any, is dropped; the cancellation is reported at the top of
+  // the next iteration.
+  if (pending_payload.IsLocallyCanceled()) return true;
   // Save chunk size. We'll need it after we move next_chunk.
   auto next_chunk_size = next_chunk.size();
   if (!next_chunk_size &&
@@ -168,8 +197,23 @@ bool PayloadManager::SendPayloadLoop(
   // happened.
   PayloadTransferFrame::PayloadChunk payload_chunk(CreatePayloadChunk(
       next_chunk_offset - resume_offset, std::move(next_chunk), index));
+  if (compress) {
+    MaybeCompressPayloadChunk(client, available_endpoint_ids, payload_chunk);
+  }
+  if (IsLastChunk(payload_chunk)) {
+    // For the receiver to check the file it wrote.
+    std::string digest =
+        pending_payload.GetInternalPayload()->GetSha256Digest();
+    if (!digest.empty()) payload_chunk.set_sha256_digest(std::move(digest));
+  }
+  // The chunk body is moved into the outgoing frame, so keep what we need for
+  // bookkeeping before handing it over.
+  const std::int32_t payload_chunk_flags = payload_chunk.flags();
+  const std::int64_t payload_chunk_offset = payload_chunk.offset();
+  bool is_last_chunk = IsLastChunk(payload_chunk);
   const EndpointIds& failed_endpoint_ids = endpoint_manager_->SendPayloadChunk(
-      payload_header, payload_chunk, available_endpoint_ids, packet_meta_data);
+      payload_header, std::move(payload_chunk), available_endpoint_ids,
+      packet_meta_data, high_priority);
   // Check whether at least one endpoint failed.
   if (!failed_endpoint_ids.empty()) {
     LOG(INFO) << "Payload xfer: endpoints failed: payload_id="
@@ -180,7 +224,6 @@ bool PayloadManager::SendPayloadLoop(
             OperationResultCode::CONNECTIVITY_GENERIC_WRITING_CHANNEL_IO_ERROR,
             PayloadStatus::ENDPOINT_IO_ERROR);
   }
-  bool is_last_chunk = IsLastChunk(payload_chunk);
   // Check whether at least one endpoint succeeded -- if they all failed,
   // we'll just go right back to the top of the loop and break out when
   // availableEndpointIds is re-synced and found to be empty at that point.
@@ -194,9 +237,9 @@ bool PayloadManager::SendPayloadLoop(
           continue;
         }
 
-        HandleSuccessfulOutgoingChunk(
-            client, endpoint_id, payload_header, payload_chunk.flags(),
-            payload_chunk.offset(), payload_chunk.body().size());
+        HandleSuccessfulOutgoingChunk(client, endpoint_id, payload_header,
+                                      payload_chunk_flags, payload_chunk_offset,
+                                      next_chunk_size);
       }
     }
     NEARBY_VLOG(1) << "PayloadManager done sending chunk at offset "
@@ -220,6 +263,78 @@ bool PayloadManager::SendPayloadLoop(
   return true;
 }
 
+ByteArray PayloadManager::DetachNextChunk(PendingPayload& pending_payload,
+                                          int chunk_size,
+                                          ChunkReader* chunk_reader) {
+  if (chunk_reader == nullptr) {
+    return pending_payload.GetInternalPayload()->DetachNextChunk(chunk_size);
+  }
+  // The reader is started lazily so that it only runs after the payload has
+  // been skipped to its resume offset.
+  if (!chunk_reader->started) {
+    chunk_reader->started = true;
+    StartChunkReader(pending_payload, chunk_size, *chunk_reader);
+  }
+  ExceptionOr<ByteArray> next_chunk = chunk_reader->window.Pop();
+  if (!next_chunk.ok()) {
+    return {};
+  }
+  return std::move(next_chunk).result();
+}
+
+void PayloadManager::StartChunkReader(PendingPayload& pending_payload,
+                                      int chunk_size,
+                                      ChunkReader& chunk_reader) {
+  file_chunk_reader_executor_.Execute(
+      "read-payload-chunks",
+      [this, &pending_payload, chunk_size, &chunk_reader]() mutable {
+        while (!shutdown_.Get()) {
+          // Pick up MTU changes, e.g. after a bandwidth upgrade. Keep the
+          // previous size if every endpoint has gone away; the sender will
+          // notice that on its own.
+          std::shared_ptr<const EndpointIds> endpoint_ids =
+              pending_payload.GetAvailableEndpointIds();
+          if (!endpoint_ids->empty()) {
+            chunk_size = GetOptimalChunkSize(*endpoint_ids);
+          }
+          ByteArray chunk =
+              pending_payload.GetInternalPayload()->DetachNextChunk(
+                  chunk_size);
+          bool is_last_chunk = chunk.Empty();
+          if (!chunk_reader.window.Push(std::move(chunk)) || is_last_chunk) {
+            break;
+          }
+        }
+        if (shutdown_.Get()) {
+          // Unblock the sender; it checks |shutdown_| after every chunk.
+          chunk_reader.window.Close();
+        }
+        chunk_reader.done.CountDown();
+      });
+}
+
+size_t PayloadManager::GetSendWindowSize(
+    ClientProxy* client, const EndpointIds& endpoint_ids) const {
+  const auto& flags = FeatureFlags::GetInstance().GetFlags();
+  size_t window_size = flags.payload_send_window_high_bandwidth_max_chunks;
+  for (const auto& endpoint_id : endpoint_ids) {
+    switch (client->GetConnectedMedium(endpoint_id)) {
+      case Medium::WIFI_LAN:
+      case Medium::WIFI_HOTSPOT:
+      case Medium::WIFI_DIRECT:
+      case Medium::WIFI_AWARE:
+      case Medium::WEB_RTC:
+      case Medium::WEB_RTC_NON_CELLULAR:
+        break;
+      default:
+        window_size = std::min<size_t>(
+            window_size, flags.payload_send_window_low_bandwidth_max_chunks);
+        break;
+    }
+  }
+  return std::max<size_t>(window_size, 1);
+}
+
 std::pair<PayloadManager::Endpoints, PayloadManager::Endpoints>
 PayloadManager::GetAvailableAndUnavailableEndpoints(
     const PendingPayload& pending_payload) {
@@ -315,19 +430,42 @@ Payload::Id PayloadManager::CreateOutgoingPayload(
   std::unique_ptr<InternalPayload> internal_payload = std::move(result.value());
   Payload::Id payload_id = internal_payload->GetId();
   LOG(INFO) << "CreateOutgoingPayload: payload_id=" << payload_id;
+  auto pending_payload = std::make_unique<PendingPayload>(
+      std::move(internal_payload), endpoint_ids,
+      /*is_incoming=*/false,
+      absl::bind_front(&PayloadManager::OnPendingPayloadDestroy, this));
+  // Requested while the payload is not yet tracked, and can't be destroyed.
+  RequestHighThroughput(pending_payload.get(), endpoint_ids);
   MutexLock lock(&mutex_);
-  pending_payloads_.StartTrackingPayload(
-      payload_id,
-      std::make_unique<PendingPayload>(
-          std::move(internal_payload), endpoint_ids,
-          /*is_incoming=*/false,
-          absl::bind_front(&PayloadManager::OnPendingPayloadDestroy, this)));
+  pending_payloads_.StartTrackingPayload(payload_id,
+                                         std::move(pending_payload));
 
   return payload_id;
 }
 
 PayloadManager::PayloadManager(EndpointManager& endpoint_manager)
-    : endpoint_manager_(&endpoint_manager) {
+    : outgoing_payload_scheduler_(FeatureFlags::GetInstance()
+                                      .GetFlags()
+                                      .max_concurrent_outgoing_payloads),
+      file_chunk_reader_executor_(
+          std::max<int>(FeatureFlags::GetInstance()
+                            .GetFlags()
+                            .max_concurrent_outgoing_payloads,
+                        1)),
+      payload_status_update_executor_("PayloadStatusUpdate"),
+      endpoint_manager_(&endpoint_manager) {
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  // Always account for the incoming bytes, even when they are not bounded,
+  // for the endpoint stats.
+  incoming_bytes_budget_ = std::make_unique<IncomingBytesBudget>(
+      flags.incoming_bytes_memory_budget,
+      flags.incoming_bytes_endpoint_memory_budget, kIncomingBytesMaxWait);
+  if (flags.enable_payload_batching) {
+    payload_batcher_ = std::make_unique<PayloadBatcher>(
+        flags.payload_batching_max_batch_size,
+        flags.payload_batching_max_delay);
+    max_batched_payload_size_ = flags.payload_batching_max_payload_size;
+  }
   endpoint_manager_->RegisterFrameProcessor(V1Frame::PAYLOAD_TRANSFER, this);
   custom_save_path_ = "";
 }
@@ -364,13 +502,19 @@ void PayloadManager::DisconnectFromEndpointManager() {
 
 PayloadManager::~PayloadManager() {
   LOG(INFO) << "PayloadManager: going down; self=" << this;
+  // Readers waiting for room would hold up the disconnection below.
+  incoming_bytes_budget_->Shutdown();
+  IncomingBytesBudget::Stats stats = incoming_bytes_budget_->GetStats();
+  LOG(INFO) << "PayloadManager: incoming bytes peak=" << stats.peak_bytes
+            << "; delayed=" << stats.delayed
+            << "; overflowed=" << stats.overflowed;
   ThroughputRecorderContainer::GetInstance().Shutdown();
   DisconnectFromEndpointManager();
   CancelAllPayloads();
   LOG(INFO) << "PayloadManager: turn down payload executors; self=" << this;
-  bytes_payload_executor_.Shutdown();
+  outgoing_payload_scheduler_.Shutdown();
   stream_payload_executor_.Shutdown();
-  file_payload_executor_.Shutdown();
+  file_chunk_reader_executor_.Shutdown();
   send_payload_ack_executor_.Shutdown();
 
   CountDownLatch stop_latch(1);
@@ -422,11 +566,12 @@ void PayloadManager::SendPayload(ClientProxy* client,
       break;
   }
 
-  auto executor = GetOutgoingPayloadExecutor(payload.GetType());
-  // The |executor| will be null if the payload is of a type we cannot work
-  // with. This should never be reached since the ServiceControllerRouter has
+  PayloadType payload_type = payload.GetType();
+  // This should never be reached since the ServiceControllerRouter has
   // already checked whether or not we can work with this Payload type.
-  if (!executor) {
+  if (payload_type != PayloadType::kBytes &&
+      payload_type != PayloadType::kFile &&
+      payload_type != PayloadType::kStream) {
     RecordInvalidPayloadAnalytics(
         client, endpoint_ids, payload.GetId(), payload.GetType(),
         payload.GetOffset(), payload_total_size,
@@ -438,21 +583,33 @@ void PayloadManager::SendPayload(ClientProxy* client,
     return;
   }
 
-  // Each payload is sent in FCFS order within each Payload type, blocking any
-  // other payload of the same type from even starting until this one is
-  // completely done with. If we ever want to provide isolation across
-  // ClientProxy objects this will need to be significantly re-architected.
-  PayloadType payload_type = payload.GetType();
+  // Each payload is sent in FCFS order among the payloads of the same priority
+  // to any of its endpoints, blocking them from even starting until this one
+  // is completely done with. Payloads to other endpoints aren't held up.
   size_t resume_offset =
       FeatureFlags::GetInstance().GetFlags().enable_send_payload_offset
           ? payload.GetOffset()
           : 0;
+  bool high_priority = IsHighPriority(payload_type, payload.GetPriority());
+  bool compress = (payload_type == PayloadType::kBytes ||
+                   payload_type == PayloadType::kStream) &&
+                  payload.GetCompression() != PayloadCompression::kNone;
+  if (payload_batcher_ != nullptr && high_priority) {
+    if (payload_type == PayloadType::kBytes && resume_offset == 0 &&
+        IsBatchable(client, endpoint_ids, payload_total_size)) {
+      SendBatchedPayload(client, endpoint_ids, std::move(payload));
+      return;
+    }
+    // The batched payloads sent before this one must not wait for it.
+    payload_batcher_->Close(endpoint_ids);
+  }
 
   Payload::Id payload_id =
       CreateOutgoingPayload(std::move(payload), endpoint_ids);
-  executor->Execute("send-payload", [this, client, endpoint_ids, payload_id,
-                                     payload_type, resume_offset,
-                                     payload_total_size]() {
+  ScheduleOutgoingPayload(payload_type, high_priority, endpoint_ids,
+                          [this, client, endpoint_ids, payload_id,
+                           payload_type, resume_offset, payload_total_size,
+                           high_priority, compress]() {
     if (shutdown_.Get()) return;
     PendingPayloadHandle pending_payload = GetPayload(payload_id);
     if (!pending_payload) {
@@ -483,16 +640,37 @@ void PayloadManager::SendPayload(ClientProxy* client,
     std::int64_t next_chunk_offset = 0;
     int index = 0;
 
+    // Only file payloads are read ahead. Bytes payloads are a single chunk
+    // and stream payloads may block indefinitely waiting on the client.
+    std::unique_ptr<ChunkReader> chunk_reader;
+    if (payload_type == PayloadType::kFile) {
+      size_t window_size = GetSendWindowSize(client, endpoint_ids);
+      if (window_size > 1) {
+        chunk_reader = std::make_unique<ChunkReader>(
+            window_size, FeatureFlags::GetInstance()
+                             .GetFlags()
+                             .payload_send_window_max_bytes);
+      }
+    }
+
     ThroughputRecorderContainer::GetInstance()
         .GetTPRecorder(payload_id, PayloadDirection::OUTGOING_PAYLOAD)
         ->Start(payload_type, PayloadDirection::OUTGOING_PAYLOAD);
     while (should_continue && !shutdown_.Get()) {
-      should_continue =
-          SendPayloadLoop(client, *pending_payload, payload_header,
-                          next_chunk_offset, resume_offset, index);
+      should_continue = SendPayloadLoop(
+          client, *pending_payload, payload_header, next_chunk_offset,
+          resume_offset, index, chunk_reader.get(), high_priority,
+          compress);
       index++;
     }
 
+    if (chunk_reader != nullptr && chunk_reader->started) {
+      // The reader holds a reference to |pending_payload|; wait for it before
+      // the handle is released.
+      chunk_reader->window.Close();
+      chunk_reader->done.Await();
+    }
+
     RunOnStatusUpdateThread("destroy-payload",
                             [this, payload_id]()
                                 RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
@@ -566,9 +744,14 @@ void PayloadManager::OnIncomingFrame(OfflineFrame& offline_frame,
       ProcessControlPacket(to_client, from_endpoint_id, frame);
       break;
     case PayloadTransferFrame::DATA:
+      if (!DecompressDataPacket(to_client, from_endpoint_id, frame)) break;
       ProcessDataPacket(to_client, from_endpoint_id, frame, current_medium,
                         packet_meta_data);
       break;
+    case PayloadTransferFrame::BATCHED_DATA:
+      ProcessBatchedDataPacket(to_client, from_endpoint_id, frame,
+                               current_medium, packet_meta_data);
+      break;
     case PayloadTransferFrame::PAYLOAD_ACK:
       LOG(INFO) << "[safe-to-disconnect][PAYLOAD_RECEIVED_ACK] sender "
                    "received payload ack from "
@@ -730,25 +913,173 @@ PayloadProgressInfo::Status PayloadManager::PayloadStatusToTransferUpdateStatus(
   }
 }
 
-SingleThreadExecutor* PayloadManager::GetOutgoingPayloadExecutor(
-    PayloadType payload_type) {
+bool PayloadManager::IsHighPriority(PayloadType payload_type,
+                                    PayloadPriority priority) {
+  switch (priority) {
+    case PayloadPriority::kHigh:
+      return true;
+    case PayloadPriority::kLow:
+      return false;
+    case PayloadPriority::kDefault:
+      break;
+  }
+  return payload_type == PayloadType::kBytes;
+}
+
+void PayloadManager::ScheduleOutgoingPayload(
+    PayloadType payload_type, bool high_priority,
+    const EndpointIds& endpoint_ids, absl::AnyInvocable<void()> runnable) {
   switch (payload_type) {
     case PayloadType::kBytes:
-      return &bytes_payload_executor_;
     case PayloadType::kFile:
-      return &file_payload_executor_;
+      outgoing_payload_scheduler_.Schedule(
+          endpoint_ids,
+          high_priority ? OutgoingPayloadScheduler::Priority::kHigh
+                        : OutgoingPayloadScheduler::Priority::kLow,
+          std::move(runnable));
+      break;
     case PayloadType::kStream:
-      return &stream_payload_executor_;
+      // Streams stay open as long as the client feeds them, so they keep
+      // their own thread instead of holding on to a worker of the scheduler.
+      stream_payload_executor_.Execute("send-payload", std::move(runnable));
+      break;
     default:
-      return nullptr;
+      break;
   }
 }
 
-int PayloadManager::GetOptimalChunkSize(EndpointIds endpoint_ids) {
+bool PayloadManager::IsBatchable(ClientProxy* client,
+                                 const EndpointIds& endpoint_ids,
+                                 std::int64_t size) const {
+  if (size <= 0 || size > max_batched_payload_size_) return false;
+  for (const auto& endpoint_id : endpoint_ids) {
+    if (!client->IsPayloadBatchingEnabled(endpoint_id)) return false;
+  }
+  return true;
+}
+
+void PayloadManager::SendBatchedPayload(ClientProxy* client,
+                                        const EndpointIds& endpoint_ids,
+                                        Payload payload) {
+  std::int64_t size = payload.AsBytes().size();
+  Payload::Id payload_id =
+      CreateOutgoingPayload(std::move(payload), endpoint_ids);
+  if (!payload_batcher_->Add(endpoint_ids, payload_id, size)) {
+    NEARBY_VLOG(1) << "PayloadManager: batched payload_id=" << payload_id;
+    return;
+  }
+  ScheduleOutgoingPayload(
+      PayloadType::kBytes, /*high_priority=*/true, endpoint_ids,
+      [this, client, endpoint_ids]() {
+        if (shutdown_.Get()) return;
+        SendPayloadBatch(client, endpoint_ids,
+                         payload_batcher_->Take(endpoint_ids));
+      });
+  LOG(INFO) << "PayloadManager: batch scheduled: self=" << this
+            << "; payload_id=" << payload_id;
+}
+
+void PayloadManager::SendPayloadBatch(
+    ClientProxy* client, const EndpointIds& endpoint_ids,
+    const std::vector<Payload::Id>& payload_ids) {
+  std::vector<PendingPayloadHandle> pending_payloads;
+  std::vector<PayloadTransferFrame::PayloadHeader> payload_headers;
+  std::vector<PayloadTransferFrame::BatchedPayload> batched_payloads;
+  // An endpoint only becomes unavailable for some payloads of a batch if it
+  // is canceled or fails while they are collected, so the frame goes to every
+  // endpoint still available for any of them.
+  EndpointIds recipient_ids;
+  for (Payload::Id payload_id : payload_ids) {
+    PendingPayloadHandle pending_payload = GetPayload(payload_id);
+    if (!pending_payload) continue;
+    InternalPayload* internal_payload = pending_payload->GetInternalPayload();
+    RecordPayloadStartedAnalytics(client, endpoint_ids, payload_id,
+                                  PayloadType::kBytes, /*offset=*/0,
+                                  internal_payload->GetTotalSize());
+    PayloadTransferFrame::PayloadHeader payload_header{CreatePayloadHeader(
+        *internal_payload, /*offset=*/0, internal_payload->GetParentFolder(),
+        internal_payload->GetFileName())};
+
+    auto pair = GetAvailableAndUnavailableEndpoints(*pending_payload);
+    const EndpointIds& available_endpoint_ids =
+        EndpointsToEndpointIds(pair.first);
+    for (const auto& endpoint : pair.second) {
+      HandleFinishedOutgoingPayload(
+          client, {endpoint->id}, payload_header, /*offset=*/0,
+          EndpointInfoStatusToOperationResultCode(endpoint->status.Get()),
+          EndpointInfoStatusToPayloadStatus(endpoint->status.Get()));
+    }
+    if (pending_payload->IsLocallyCanceled()) {
+      HandleFinishedOutgoingPayload(
+          client, available_endpoint_ids, payload_header, /*offset=*/0,
+          OperationResultCode::CLIENT_CANCELLATION_LOCAL_CANCEL_PAYLOAD,
+          PayloadStatus::LOCAL_CANCELLATION);
+      continue;
+    }
+    if (available_endpoint_ids.empty()) continue;
+    for (const auto& endpoint_id : available_endpoint_ids) {
+      if (std::find(recipient_ids.begin(), recipient_ids.end(),
+                    endpoint_id) == recipient_ids.end()) {
+        recipient_ids.push_back(endpoint_id);
+      }
+    }
+
+    PayloadTransferFrame::BatchedPayload batched_payload;
+    *batched_payload.mutable_payload_header() = payload_header;
+    batched_payload.set_body(
+        std::string(internal_payload->DetachNextChunk(/*chunk_size=*/0)));
+    batched_payloads.push_back(std::move(batched_payload));
+    payload_headers.push_back(std::move(payload_header));
+    pending_payloads.push_back(std::move(pending_payload));
+  }
+
+  if (!batched_payloads.empty()) {
+    PacketMetaData packet_meta_data;
+    const EndpointIds& failed_endpoint_ids =
+        endpoint_manager_->SendBatchedPayloads(
+            std::move(batched_payloads), recipient_ids, packet_meta_data);
+    LOG(INFO) << "PayloadManager: sent batch of " << payload_headers.size()
+              << " payloads; failed endpoint_ids={"
+              << ToString(failed_endpoint_ids) << "}";
+    for (const auto& payload_header : payload_headers) {
+      if (!failed_endpoint_ids.empty()) {
+        HandleFinishedOutgoingPayload(
+            client, failed_endpoint_ids, payload_header, /*offset=*/0,
+            OperationResultCode::CONNECTIVITY_GENERIC_WRITING_CHANNEL_IO_ERROR,
+            PayloadStatus::ENDPOINT_IO_ERROR);
+      }
+      for (const auto& endpoint_id : recipient_ids) {
+        if (std::find(failed_endpoint_ids.begin(), failed_endpoint_ids.end(),
+                      endpoint_id) != failed_endpoint_ids.end()) {
+          continue;
+        }
+        // As if the body and the last chunk were sent one after the other.
+        HandleSuccessfulOutgoingChunk(client, endpoint_id, payload_header,
+                                      /*payload_chunk_flags=*/0,
+                                      /*payload_chunk_offset=*/0,
+                                      payload_header.total_size());
+        HandleSuccessfulOutgoingChunk(
+            client, endpoint_id, payload_header,
+            PayloadTransferFrame::PayloadChunk::LAST_CHUNK,
+            payload_header.total_size(), /*payload_chunk_body_size=*/0);
+      }
+    }
+  }
+
+  for (Payload::Id payload_id : payload_ids) {
+    RunOnStatusUpdateThread("destroy-payload",
+                            [this, payload_id]()
+                                RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
+                                  DestroyPendingPayload(payload_id);
+                                });
+  }
+}
+
+int PayloadManager::GetOptimalChunkSize(const EndpointIds& endpoint_ids) {
   int minChunkSize = std::numeric_limits<int>::max();
   for (const auto& endpoint_id : endpoint_ids) {
-    minChunkSize = std::min(
-        minChunkSize, endpoint_manager_->GetMaxTransmitPacketSize(endpoint_id));
+    minChunkSize =
+        std::min(minChunkSize, endpoint_manager_->GetChunkSize(endpoint_id));
   }
   return minChunkSize;
 }
@@ -793,8 +1124,25 @@ PayloadTransferFrame::PayloadChunk PayloadManager::CreatePayloadChunk(
   return payload_chunk;
 }
 
+void PayloadManager::MaybeCompressPayloadChunk(
+    ClientProxy* client, const EndpointIds& endpoint_ids,
+    PayloadTransferFrame::PayloadChunk& payload_chunk) {
+  if (payload_chunk.body().empty()) return;
+  // Chunks are written once for all endpoints, so they are only compressed if
+  // every endpoint can decompress them.
+  for (const auto& endpoint_id : endpoint_ids) {
+    if (!client->IsPayloadCompressionEnabled(endpoint_id)) return;
+  }
+  std::optional<std::string> compressed =
+      chunk_compression::Compress(payload_chunk.body());
+  if (!compressed.has_value()) return;
+  payload_chunk.set_body(*std::move(compressed));
+  payload_chunk.set_flags(payload_chunk.flags() |
+                          PayloadTransferFrame::PayloadChunk::COMPRESSED);
+}
+
 ErrorOr<PayloadManager::PendingPayloadHandle>
-PayloadManager::CreateIncomingPayload(const PayloadTransferFrame& frame,
+PayloadManager::CreateIncomingPayload(PayloadTransferFrame& frame,
                                       const std::string& endpoint_id) {
   ErrorOr<std::unique_ptr<InternalPayload>> result =
       CreateIncomingInternalPayload(frame, custom_save_path_);
@@ -804,11 +1152,12 @@ PayloadManager::CreateIncomingPayload(const PayloadTransferFrame& frame,
   std::unique_ptr<InternalPayload> internal_payload = std::move(result.value());
   Payload::Id payload_id = internal_payload->GetId();
   LOG(INFO) << "CreateIncomingPayload: payload_id=" << payload_id;
-  pending_payloads_.StartTrackingPayload(
-      payload_id,
-      std::make_unique<PendingPayload>(
-          std::move(internal_payload), EndpointIds{endpoint_id}, true,
-          absl::bind_front(&PayloadManager::OnPendingPayloadDestroy, this)));
+  auto pending_payload = std::make_unique<PendingPayload>(
+      std::move(internal_payload), EndpointIds{endpoint_id}, true,
+      absl::bind_front(&PayloadManager::OnPendingPayloadDestroy, this));
+  RequestHighThroughput(pending_payload.get(), EndpointIds{endpoint_id});
+  pending_payloads_.StartTrackingPayload(payload_id,
+                                         std::move(pending_payload));
   return {pending_payloads_.GetPayload(payload_id)};
 }
 
@@ -819,12 +1168,38 @@ void PayloadManager::OnPendingPayloadDestroy(const PendingPayload* payload) {
       payload->GetId(), payload->IsIncoming()
                             ? PayloadDirection::INCOMING_PAYLOAD
                             : PayloadDirection::OUTGOING_PAYLOAD);
+  ReleaseHighThroughput(payload);
   if (payload->IsIncoming()) return;
   RunOnStatusUpdateThread(
       "~PendingPayload",
       [this]() RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() { NotifyShutdown(); });
 }
 
+void PayloadManager::RequestHighThroughput(PendingPayload* payload,
+                                           const EndpointIds& endpoint_ids) {
+  // BYTES payloads are over before new link settings would take effect.
+  PayloadTransferFrame::PayloadHeader::PayloadType type =
+      payload->GetInternalPayload()->GetType();
+  if (type != PayloadTransferFrame::PayloadHeader::FILE &&
+      type != PayloadTransferFrame::PayloadHeader::STREAM) {
+    return;
+  }
+  MutexLock lock(&high_throughput_mutex_);
+  for (const std::string& endpoint_id : endpoint_ids) {
+    endpoint_manager_->RequestHighThroughput(endpoint_id);
+  }
+  high_throughput_endpoints_[payload] = endpoint_ids;
+}
+
+void PayloadManager::ReleaseHighThroughput(const PendingPayload* payload) {
+  MutexLock lock(&high_throughput_mutex_);
+  auto node = high_throughput_endpoints_.extract(payload);
+  if (node.empty()) return;
+  for (const std::string& endpoint_id : node.mapped()) {
+    endpoint_manager_->ReleaseHighThroughput(endpoint_id);
+  }
+}
+
 void PayloadManager::SendClientCallbacksForFinishedOutgoingPayload(
     ClientProxy* client, const EndpointIds& finished_endpoint_ids,
     const PayloadTransferFrame::PayloadHeader& payload_header,
@@ -998,6 +1373,13 @@ bool PayloadManager::WaitForReceivedAck(
       return false;
     }
     {
+      // A cancel wakes up the wait below, instead of taking effect once it
+      // times out.
+      CancellationFlagListener cancellation_listener(
+          &latest_pending_payload->GetCancellationFlag(), [endpoint_info]() {
+            MutexLock lock(&endpoint_info->payload_received_ack_mutex);
+            endpoint_info->payload_received_ack_cond.Notify();
+          });
       MutexLock lock(&endpoint_info->payload_received_ack_mutex);
       if (endpoint_info->is_payload_received_ack) {
         LOG(INFO) << "[safe-to-disconnect][PAYLOAD_RECEIVED_ACK] sender already"
@@ -1006,6 +1388,9 @@ bool PayloadManager::WaitForReceivedAck(
         endpoint_info->is_payload_received_ack = false;
         return true;
       }
+      // Checked under the lock, so that a cancel from now on finds this thread
+      // waiting.
+      if (latest_pending_payload->IsLocallyCanceled()) continue;
       Exception wait_exception = endpoint_info->payload_received_ack_cond.Wait(
           FeatureFlags::GetInstance()
               .GetFlags()
@@ -1018,6 +1403,11 @@ bool PayloadManager::WaitForReceivedAck(
             << endpoint_id << " end with exception: " << wait_exception.value;
         return false;
       }
+      if (!endpoint_info->is_payload_received_ack &&
+          latest_pending_payload->IsLocallyCanceled()) {
+        // Reported at the top of the loop.
+        continue;
+      }
       if (endpoint_info->is_payload_received_ack) {
         LOG(INFO) << "[safe-to-disconnect][PAYLOAD_RECEIVED_ACK] Received "
                      "notification that sender "
@@ -1039,9 +1429,8 @@ bool PayloadManager::WaitForReceivedAck(
 bool PayloadManager::IsPayloadReceivedAckEnabled(
     ClientProxy* client, const std::string& endpoint_id,
     PendingPayload& pending_payload) {
-  return NearbyFlags::GetInstance().GetBoolFlag(
-             config_package_nearby::nearby_connections_feature::
-                 kEnablePayloadReceivedAck) &&
+  return NearbyFlags::Get<config_package_nearby::nearby_connections_feature::
+                              kEnablePayloadReceivedAck>() &&
          client->IsPayloadReceivedAckEnabled(endpoint_id) &&
          (pending_payload.GetInternalPayload()->GetType() !=
           nearby::connections::PayloadTransferFrame::PayloadTransferFrame::
@@ -1123,57 +1512,22 @@ void PayloadManager::HandleSuccessfulOutgoingChunk(
     const PayloadTransferFrame::PayloadHeader& payload_header,
     std::int32_t payload_chunk_flags, std::int64_t payload_chunk_offset,
     std::int64_t payload_chunk_body_size) {
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::
-              kEnablePayloadManagerToSkipChunkUpdate)) {
-    MutexLock lock(&chunk_update_mutex_);
-    ++outgoing_chunk_update_count_;
+  bool is_last_chunk = (payload_chunk_flags &
+                        PayloadTransferFrame::PayloadChunk::LAST_CHUNK) != 0;
+  if (!is_last_chunk) {
+    client->GetAnalyticsRecorder().OnPayloadChunkSent(
+        endpoint_id, payload_header.id(), payload_chunk_body_size);
+    UpdatePayloadProgress(client, endpoint_id, payload_header,
+                          payload_chunk_offset + payload_chunk_body_size);
+    return;
   }
+
   RunOnStatusUpdateThread(
       "outgoing-chunk-success",
-      [this, client, endpoint_id, payload_header, payload_chunk_flags,
-       payload_chunk_offset,
-       payload_chunk_body_size]() RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
+      [this, client, endpoint_id, payload_header,
+       payload_chunk_offset]() RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
         // Make sure we're still tracking this payload and its associated
         // endpoint.
-        bool is_last_chunk =
-            (payload_chunk_flags &
-             PayloadTransferFrame::PayloadChunk::LAST_CHUNK) != 0;
-
-        if (NearbyFlags::GetInstance().GetBoolFlag(
-                config_package_nearby::nearby_connections_feature::
-                    kEnablePayloadManagerToSkipChunkUpdate)) {
-          MutexLock lock(&chunk_update_mutex_);
-          --outgoing_chunk_update_count_;
-          if (payload_header.has_type() &&
-              payload_header.type() ==
-                  PayloadTransferFrame::PayloadTransferFrame::PayloadHeader::
-                      FILE) {
-            if (outgoing_chunk_update_count_ > 0 && !is_last_chunk &&
-                payload_chunk_offset != 0) {
-              VLOG(1) << "Skip the outgoing chunk update with offset="
-                      << payload_chunk_offset;
-              client->GetAnalyticsRecorder().OnPayloadChunkSent(
-                  endpoint_id, payload_header.id(), payload_chunk_body_size);
-              return;
-            }
-
-            absl::Time current_time = absl::Now();
-            if (!is_last_chunk && payload_chunk_offset != 0 &&
-                current_time - last_outgoing_chunk_update_time_ <
-                    kMinTransferUpdateInterval) {
-              VLOG(1) << "Skip the outgoing chunk update with offset="
-                      << payload_chunk_offset
-                      << " because it's too close to the previous update.";
-              client->GetAnalyticsRecorder().OnPayloadChunkSent(
-                  endpoint_id, payload_header.id(), payload_chunk_body_size);
-              return;
-            }
-
-            last_outgoing_chunk_update_time_ = current_time;
-          }
-        }
-
         PendingPayloadHandle pending_payload = GetPayload(payload_header.id());
         if (!pending_payload || !pending_payload->GetEndpoint(endpoint_id)) {
           LOG(INFO) << "HandleSuccessfulOutgoingChunk: endpoint not found: "
@@ -1183,31 +1537,23 @@ void PayloadManager::HandleSuccessfulOutgoingChunk(
         }
 
         PayloadProgressInfo update{
-            payload_header.id(),
-            is_last_chunk ? PayloadProgressInfo::Status::kSuccess
-                          : PayloadProgressInfo::Status::kInProgress,
-            payload_header.total_size(),
-            is_last_chunk ? payload_chunk_offset
-                          : payload_chunk_offset + payload_chunk_body_size};
+            payload_header.id(), PayloadProgressInfo::Status::kSuccess,
+            payload_header.total_size(), payload_chunk_offset,
+            pending_payload->GetInternalPayload()->GetSha256Digest()};
 
         // Notify the client.
         client->OnPayloadProgress(endpoint_id, update);
 
-        if (is_last_chunk) {
-          client->GetAnalyticsRecorder().OnOutgoingPayloadDone(
-              endpoint_id, payload_header.id(), PayloadStatus::SUCCESS,
-              OperationResultCode::DETAIL_SUCCESS);
+        client->GetAnalyticsRecorder().OnOutgoingPayloadDone(
+            endpoint_id, payload_header.id(), PayloadStatus::SUCCESS,
+            OperationResultCode::DETAIL_SUCCESS);
 
-          // Stop tracking this endpoint.
-          pending_payload->RemoveEndpoints({endpoint_id});
+        // Stop tracking this endpoint.
+        pending_payload->RemoveEndpoints({endpoint_id});
 
-          // Close the payload if no endpoints remain.
-          if (pending_payload->GetEndpoints().empty()) {
-            pending_payload->Close();
-          }
-        } else {
-          client->GetAnalyticsRecorder().OnPayloadChunkSent(
-              endpoint_id, payload_header.id(), payload_chunk_body_size);
+        // Close the payload if no endpoints remain.
+        if (pending_payload->GetEndpoints().empty()) {
+          pending_payload->Close();
         }
       });
 }
@@ -1222,85 +1568,97 @@ void PayloadManager::HandleSuccessfulIncomingChunk(
     const PayloadTransferFrame::PayloadHeader& payload_header,
     std::int32_t payload_chunk_flags, std::int64_t payload_chunk_offset,
     std::int64_t payload_chunk_body_size) {
-  if (NearbyFlags::GetInstance().GetBoolFlag(
-          config_package_nearby::nearby_connections_feature::
-              kEnablePayloadManagerToSkipChunkUpdate)) {
-    MutexLock lock(&chunk_update_mutex_);
-    ++incoming_chunk_update_count_;
+  bool is_last_chunk = (payload_chunk_flags &
+                        PayloadTransferFrame::PayloadChunk::LAST_CHUNK) != 0;
+  if (!is_last_chunk) {
+    client->GetAnalyticsRecorder().OnPayloadChunkReceived(
+        endpoint_id, payload_header.id(), payload_chunk_body_size);
+    UpdatePayloadProgress(client, endpoint_id, payload_header,
+                          payload_chunk_offset + payload_chunk_body_size);
+    return;
   }
+
   RunOnStatusUpdateThread(
       "incoming-chunk-success",
-      [this, client, endpoint_id, payload_header, payload_chunk_flags,
-       payload_chunk_offset,
-       payload_chunk_body_size]() RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
+      [this, client, endpoint_id, payload_header,
+       payload_chunk_offset]() RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
         // Make sure we're still tracking this payload.
-        bool is_last_chunk =
-            (payload_chunk_flags &
-             PayloadTransferFrame::PayloadChunk::LAST_CHUNK) != 0;
-
-        if (NearbyFlags::GetInstance().GetBoolFlag(
-                config_package_nearby::nearby_connections_feature::
-                    kEnablePayloadManagerToSkipChunkUpdate)) {
-          MutexLock lock(&chunk_update_mutex_);
-          --incoming_chunk_update_count_;
-          if (payload_header.has_type() &&
-              payload_header.type() ==
-                  PayloadTransferFrame::PayloadTransferFrame::PayloadHeader::
-                      FILE) {
-            if (incoming_chunk_update_count_ > 0 && !is_last_chunk &&
-                payload_chunk_offset != 0) {
-              VLOG(1) << "Skip the incoming chunk update with offset="
-                      << payload_chunk_offset;
-              client->GetAnalyticsRecorder().OnPayloadChunkReceived(
-                  endpoint_id, payload_header.id(), payload_chunk_body_size);
-              return;
-            }
-
-            absl::Time current_time = absl::Now();
-            if (!is_last_chunk && payload_chunk_offset != 0 &&
-                current_time - last_incoming_chunk_update_time_ <
-                    kMinTransferUpdateInterval) {
-              VLOG(1) << "Skip the incoming chunk update with offset="
-                      << payload_chunk_offset
-                      << " because it's too close to the previous update.";
-              client->GetAnalyticsRecorder().OnPayloadChunkSent(
-                  endpoint_id, payload_header.id(), payload_chunk_body_size);
-              return;
-            }
-
-            last_incoming_chunk_update_time_ = current_time;
-          }
-        }
-
         PendingPayloadHandle pending_payload = GetPayload(payload_header.id());
         if (!pending_payload) {
           return;
         }
 
         PayloadProgressInfo update{
-            payload_header.id(),
-            is_last_chunk ? PayloadProgressInfo::Status::kSuccess
-                          : PayloadProgressInfo::Status::kInProgress,
-            payload_header.total_size(),
-            is_last_chunk ? payload_chunk_offset
-                          : payload_chunk_offset + payload_chunk_body_size};
+            payload_header.id(), PayloadProgressInfo::Status::kSuccess,
+            payload_header.total_size(), payload_chunk_offset,
+            pending_payload->GetInternalPayload()->GetSha256Digest()};
 
         // Notify the client of this update.
         NotifyClientOfIncomingPayloadProgressInfo(client, endpoint_id, update);
 
         // Analyze the success.
-        if (is_last_chunk) {
-          DestroyPendingPayload(payload_header.id());
-          client->GetAnalyticsRecorder().OnIncomingPayloadDone(
-              endpoint_id, payload_header.id(), PayloadStatus::SUCCESS,
-              OperationResultCode::DETAIL_SUCCESS);
-        } else {
-          client->GetAnalyticsRecorder().OnPayloadChunkReceived(
-              endpoint_id, payload_header.id(), payload_chunk_body_size);
-        }
+        DestroyPendingPayload(payload_header.id());
+        client->GetAnalyticsRecorder().OnIncomingPayloadDone(
+            endpoint_id, payload_header.id(), PayloadStatus::SUCCESS,
+            OperationResultCode::DETAIL_SUCCESS);
       });
 }
 
+void PayloadManager::UpdatePayloadProgress(
+    ClientProxy* client, const std::string& endpoint_id,
+    const PayloadTransferFrame::PayloadHeader& payload_header,
+    std::int64_t bytes_transferred) {
+  PendingPayloadHandle pending_payload = GetPayload(payload_header.id());
+  if (!pending_payload) return;
+  EndpointInfo* endpoint = pending_payload->GetEndpoint(endpoint_id);
+  if (endpoint == nullptr || !endpoint->progress->Update(bytes_transferred)) {
+    return;
+  }
+  RunOnStatusUpdateThread(
+      "payload-progress",
+      [this, client, endpoint_id, payload_header]()
+          RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
+            FlushPayloadProgress(client, endpoint_id, payload_header);
+          });
+}
+
+// @PayloadManagerStatusUpdateThread
+void PayloadManager::FlushPayloadProgress(
+    ClientProxy* client, const std::string& endpoint_id,
+    const PayloadTransferFrame::PayloadHeader& payload_header) {
+  PendingPayloadHandle pending_payload = GetPayload(payload_header.id());
+  if (!pending_payload) return;
+  EndpointInfo* endpoint = pending_payload->GetEndpoint(endpoint_id);
+  if (endpoint == nullptr) return;
+  std::optional<std::int64_t> bytes_transferred = endpoint->progress->Flush(
+      GetPayloadProgressCadence(client, endpoint_id, payload_header),
+      absl::Now());
+  if (!bytes_transferred.has_value()) return;
+
+  PayloadProgressInfo update{payload_header.id(),
+                             PayloadProgressInfo::Status::kInProgress,
+                             payload_header.total_size(), *bytes_transferred};
+  client->OnPayloadProgress(endpoint_id, update);
+}
+
+PayloadProgressCadence PayloadManager::GetPayloadProgressCadence(
+    ClientProxy* client, const std::string& endpoint_id,
+    const PayloadTransferFrame::PayloadHeader& payload_header) const {
+  PayloadProgressCadence cadence =
+      client->GetPayloadProgressCadence(endpoint_id);
+  if (cadence.bytes > 0 || cadence.interval > absl::ZeroDuration()) {
+    return cadence;
+  }
+  // Without a cadence from the client, file transfers still don't report
+  // progress more often than every kMinTransferUpdateInterval.
+  if (payload_header.type() == PayloadTransferFrame::PayloadHeader::FILE &&
+      NearbyFlags::Get<config_package_nearby::nearby_connections_feature::
+                           kEnablePayloadManagerToSkipChunkUpdate>()) {
+    cadence.interval = kMinTransferUpdateInterval;
+  }
+  return cadence;
+}
+
 // @EndpointManagerDataPool
 void PayloadManager::ProcessDataPacket(
     ClientProxy* to_client, const std::string& from_endpoint_id,
@@ -1310,6 +1668,8 @@ void PayloadManager::ProcessDataPacket(
       *payload_transfer_frame.mutable_payload_header();
   PayloadTransferFrame::PayloadChunk& payload_chunk =
       *payload_transfer_frame.mutable_payload_chunk();
+  NEARBY_TRACE_EVENT_WITH_FLOW("connections.payload", "Receive chunk",
+                               TraceFlowIdForPayload(payload_header.id()));
   NEARBY_VLOG(1) << "PayloadManager got data OfflineFrame for payload_id="
                  << payload_header.id()
                  << " from endpoint_id=" << from_endpoint_id << " at offset "
@@ -1325,6 +1685,8 @@ void PayloadManager::ProcessDataPacket(
     return;
   }
   Payload::Id payload_id = payload_header.id();
+  // Save size of packet before we move it.
+  std::int64_t payload_body_size = payload_chunk.body().size();
   PendingPayloadHandle pending_payload;
   if (payload_chunk.offset() == 0) {
     ThroughputRecorderContainer::GetInstance()
@@ -1343,6 +1705,13 @@ void PayloadManager::ProcessDataPacket(
               payload_header.total_size());
         });
 
+    // Holds back this endpoint's reader while incoming BYTES payloads wait
+    // for the client.
+    IncomingBytesBudget::Reservation reservation;
+    if (payload_header.type() == PayloadTransferFrame::PayloadHeader::BYTES) {
+      reservation =
+          incoming_bytes_budget_->Acquire(from_endpoint_id, payload_body_size);
+    }
     ErrorOr<PendingPayloadHandle> result =
         CreateIncomingPayload(payload_transfer_frame, from_endpoint_id);
     if (result.has_error()) {
@@ -1374,8 +1743,8 @@ void PayloadManager::ProcessDataPacket(
     // Also, let the client know of this new incoming payload.
     RunOnStatusUpdateThread(
         "process-data-packet",
-        [to_client, from_endpoint_id,
-         pending_payload = GetPayload(payload_id)]()
+        [to_client, from_endpoint_id, pending_payload = GetPayload(payload_id),
+         reservation = std::move(reservation)]()
             RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD() {
               if (!pending_payload) return;
               LOG(INFO) << "PayloadManager received new payload_id="
@@ -1414,9 +1783,6 @@ void PayloadManager::ProcessDataPacket(
   pending_payload->SetOffsetForEndpoint(from_endpoint_id,
                                         payload_chunk.offset());
 
-  // Save size of packet before we move it.
-  std::int64_t payload_body_size = payload_chunk.body().size();
-
   packet_meta_data.StartFileIo();
   if (pending_payload->GetInternalPayload()
           ->AttachNextChunk(ByteArray(std::move(*payload_chunk.mutable_body())))
@@ -1432,6 +1798,20 @@ void PayloadManager::ProcessDataPacket(
   packet_meta_data.StopFileIo();
   bool is_last_chunk = (payload_chunk.flags() &
                         PayloadTransferFrame::PayloadChunk::LAST_CHUNK) != 0;
+  if (is_last_chunk && payload_chunk.has_sha256_digest()) {
+    std::string digest =
+        pending_payload->GetInternalPayload()->GetSha256Digest();
+    if (!digest.empty() && digest != payload_chunk.sha256_digest()) {
+      LOG(ERROR) << "ProcessDataPacket: [data: digest mismatch] endpoint_id="
+                 << from_endpoint_id
+                 << "; payload_id=" << pending_payload->GetId();
+      HandleFinishedIncomingPayload(
+          to_client, from_endpoint_id, payload_header, payload_chunk.offset(),
+          PayloadStatus::LOCAL_ERROR,
+          OperationResultCode::IO_FILE_WRITING_ERROR);
+      return;
+    }
+  }
   SendPayloadReceivedAck(to_client, *pending_payload, from_endpoint_id,
                          is_last_chunk);
 
@@ -1449,6 +1829,75 @@ void PayloadManager::ProcessDataPacket(
   }
 }
 
+// @EndpointManagerDataPool
+void PayloadManager::ProcessBatchedDataPacket(
+    ClientProxy* to_client, const std::string& from_endpoint_id,
+    PayloadTransferFrame& payload_transfer_frame, Medium medium,
+    PacketMetaData& packet_meta_data) {
+  NEARBY_VLOG(1) << "PayloadManager got "
+                 << payload_transfer_frame.batched_payloads_size()
+                 << " batched payloads from endpoint_id=" << from_endpoint_id;
+  for (PayloadTransferFrame::BatchedPayload& batched_payload :
+       *payload_transfer_frame.mutable_batched_payloads()) {
+    PayloadTransferFrame data_frame;
+    data_frame.set_packet_type(PayloadTransferFrame::DATA);
+    *data_frame.mutable_payload_header() = batched_payload.payload_header();
+    std::int64_t size = batched_payload.body().size();
+
+    PayloadTransferFrame::PayloadChunk* payload_chunk =
+        data_frame.mutable_payload_chunk();
+    payload_chunk->set_offset(0);
+    payload_chunk->set_flags(0);
+    payload_chunk->set_body(std::move(*batched_payload.mutable_body()));
+    ProcessDataPacket(to_client, from_endpoint_id, data_frame, medium,
+                      packet_meta_data);
+
+    payload_chunk = data_frame.mutable_payload_chunk();
+    payload_chunk->Clear();
+    payload_chunk->set_offset(size);
+    payload_chunk->set_flags(PayloadTransferFrame::PayloadChunk::LAST_CHUNK);
+    ProcessDataPacket(to_client, from_endpoint_id, data_frame, medium,
+                      packet_meta_data);
+  }
+}
+
+bool PayloadManager::DecompressDataPacket(
+    ClientProxy* to_client, const std::string& from_endpoint_id,
+    PayloadTransferFrame& payload_transfer_frame) {
+  PayloadTransferFrame::PayloadChunk& payload_chunk =
+      *payload_transfer_frame.mutable_payload_chunk();
+  if ((payload_chunk.flags() &
+       PayloadTransferFrame::PayloadChunk::COMPRESSED) == 0) {
+    return true;
+  }
+  std::optional<std::string> body = chunk_compression::Decompress(
+      payload_chunk.body(),
+      FeatureFlags::GetInstance().GetFlags().connection_max_frame_length);
+  if (body.has_value()) {
+    payload_chunk.set_body(*std::move(body));
+    payload_chunk.set_flags(payload_chunk.flags() &
+                            ~PayloadTransferFrame::PayloadChunk::COMPRESSED);
+    return true;
+  }
+
+  const PayloadTransferFrame::PayloadHeader& payload_header =
+      payload_transfer_frame.payload_header();
+  LOG(ERROR) << "DecompressDataPacket: [malformed] endpoint_id="
+             << from_endpoint_id << "; payload_id=" << payload_header.id()
+             << "; offset=" << payload_chunk.offset();
+  if (GetPayload(payload_header.id())) {
+    HandleFinishedIncomingPayload(to_client, from_endpoint_id, payload_header,
+                                  payload_chunk.offset(),
+                                  PayloadStatus::LOCAL_ERROR,
+                                  OperationResultCode::IO_FILE_WRITING_ERROR);
+  } else {
+    SendControlMessage({from_endpoint_id}, payload_header,
+                       payload_chunk.offset(),
+                       PayloadTransferFrame::ControlMessage::PAYLOAD_ERROR);
+  }
+  return false;
+}
+
 // @EndpointManagerDataPool
 void PayloadManager::ProcessControlPacket(
     ClientProxy* to_client, const std::string& from_endpoint_id,
@@ -1584,6 +2033,27 @@ void PayloadManager::SetCustomSavePath(ClientProxy* client,
   custom_save_path_ = path;
 }
 
+PayloadManager::SendQueueStats PayloadManager::GetSendQueueStats(
+    const std::string& endpoint_id) {
+  SendQueueStats stats;
+  pending_payloads_.ForEachPayload([&](PendingPayload* pending_payload) {
+    if (pending_payload->IsIncoming()) return;
+    std::optional<std::int64_t> offset =
+        pending_payload->GetOffsetForEndpoint(endpoint_id);
+    if (!offset.has_value()) return;
+    stats.payloads++;
+    std::int64_t total_size =
+        pending_payload->GetInternalPayload()->GetTotalSize();
+    if (total_size > *offset) stats.bytes += total_size - *offset;
+  });
+  return stats;
+}
+
+std::int64_t PayloadManager::GetIncomingBytesHeld(
+    const std::string& endpoint_id) {
+  return incoming_bytes_budget_->GetHeldBytes(endpoint_id);
+}
+
 ///////////////////////////////// EndpointInfo
 ////////////////////////////////////
 
@@ -1648,6 +2118,7 @@ PayloadManager::PendingPayload::PendingPayload(
 
     endpoints_.emplace(id, std::move(endpoint_info));
   }
+  UpdateAvailableEndpointIds();
 }
 
 Payload::Id PayloadManager::PendingPayload::GetId() const {
@@ -1664,6 +2135,7 @@ bool PayloadManager::PendingPayload::IsLocallyCanceled() const {
 
 void PayloadManager::PendingPayload::MarkLocallyCanceled() {
   is_locally_canceled_.Set(true);
+  cancellation_flag_.Cancel();
 }
 
 void PayloadManager::PendingPayload::MarkReceivedAckFromEndpoint(
@@ -1705,6 +2177,7 @@ void PayloadManager::PendingPayload::RemoveEndpoints(
   for (const auto& id : endpoint_ids) {
     endpoints_.erase(id);
   }
+  UpdateAvailableEndpointIds();
 }
 
 void PayloadManager::PendingPayload::SetEndpointStatusFromControlMessage(
@@ -1715,6 +2188,7 @@ void PayloadManager::PendingPayload::SetEndpointStatusFromControlMessage(
   auto item = endpoints_.find(endpoint_id);
   if (item != endpoints_.end()) {
     item->second.SetStatusFromControlMessage(control_message);
+    UpdateAvailableEndpointIds();
   }
 }
 
@@ -1728,6 +2202,38 @@ void PayloadManager::PendingPayload::SetOffsetForEndpoint(
   }
 }
 
+std::optional<std::int64_t>
+PayloadManager::PendingPayload::GetOffsetForEndpoint(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&mutex_);
+
+  auto item = endpoints_.find(endpoint_id);
+  if (item == endpoints_.end()) return std::nullopt;
+  return item->second.offset;
+}
+
+std::shared_ptr<const PayloadManager::EndpointIds>
+PayloadManager::PendingPayload::GetAvailableEndpointIds() const {
+  MutexLock lock(&mutex_);
+  return available_endpoint_ids_;
+}
+
+bool PayloadManager::PendingPayload::HasUnavailableEndpoints() const {
+  MutexLock lock(&mutex_);
+  return available_endpoint_ids_->size() != endpoints_.size();
+}
+
+void PayloadManager::PendingPayload::UpdateAvailableEndpointIds() {
+  auto endpoint_ids = std::make_shared<EndpointIds>();
+  endpoint_ids->reserve(endpoints_.size());
+  for (const auto& item : endpoints_) {
+    if (item.second.status.Get() == EndpointInfo::Status::kAvailable) {
+      endpoint_ids->push_back(item.first);
+    }
+  }
+  available_endpoint_ids_ = std::move(endpoint_ids);
+}
+
 void PayloadManager::PendingPayload::Close() {
   bool was_closed = is_closed_.Set(true);
   if (was_closed) return;
@@ -1743,47 +2249,54 @@ void PayloadManager::RunOnStatusUpdateThread(
 
 void PayloadManager::PendingPayloads::StartTrackingPayload(
     Payload::Id payload_id, std::unique_ptr<PendingPayload> pending_payload) {
-  MutexLock lock(&mutex_);
+  Shard& shard = GetShard(payload_id);
+  MutexLock lock(&shard.mutex);
 
   // If the |payload_id| is being re-used, always prefer the newer payload.
-  Remove(pending_payloads_.find(payload_id));
+  Remove(shard, shard.pending_payloads.find(payload_id));
   LOG(INFO) << "StartTrackingPayload: " << pending_payload->ToString();
   pending_payload->IncRefCount();
-  pending_payloads_[payload_id] = std::move(pending_payload);
+  shard.pending_payloads[payload_id] = std::move(pending_payload);
 }
 
 void PayloadManager::PendingPayloads::StopTrackingPayload(
     Payload::Id payload_id) {
-  MutexLock lock(&mutex_);
+  Shard& shard = GetShard(payload_id);
+  MutexLock lock(&shard.mutex);
   LOG(INFO) << "StopTrackingPayload " << payload_id;
-  Remove(pending_payloads_.find(payload_id));
+  Remove(shard, shard.pending_payloads.find(payload_id));
 }
 
-void PayloadManager::PendingPayloads::Remove(
-    absl::flat_hash_map<Payload::Id, std::unique_ptr<PendingPayload>>::iterator
-        it) {
-  if (it != pending_payloads_.end()) {
+PayloadManager::PendingPayloads::Shard&
+PayloadManager::PendingPayloads::GetShard(Payload::Id payload_id) const {
+  return shards_[absl::Hash<Payload::Id>{}(payload_id) % kShardCount];
+}
+
+void PayloadManager::PendingPayloads::Remove(Shard& shard,
+                                             PayloadMap::iterator it) {
+  if (it != shard.pending_payloads.end()) {
     int refcount = it->second->DecRefCount();
     if (refcount == 0) {
       // Nobody is using the payload, we can remove it.
       NEARBY_VLOG(1) << "Erase payload " << it->second->ToString();
-      pending_payloads_.erase(it);
+      shard.pending_payloads.erase(it);
     } else {
       // Someone is still using the payload. Move it to the garbage bin. The
       // payload will be removed when they release it.
       NEARBY_VLOG(1) << "Bin payload " << it->second->ToString();
-      payload_garbage_bin_.push_back(
-          std::move(pending_payloads_.extract(it).mapped()));
+      shard.payload_garbage_bin.push_back(
+          std::move(shard.pending_payloads.extract(it).mapped()));
     }
   }
 }
 
 PayloadManager::PendingPayloadHandle
 PayloadManager::PendingPayloads::GetPayload(Payload::Id payload_id) const {
-  MutexLock lock(&mutex_);
+  Shard& shard = GetShard(payload_id);
+  MutexLock lock(&shard.mutex);
 
-  auto item = pending_payloads_.find(payload_id);
-  if (item == pending_payloads_.end()) {
+  auto item = shard.pending_payloads.find(payload_id);
+  if (item == shard.pending_payloads.end()) {
     return PendingPayloadHandle();
   }
   PendingPayload* payload = item->second.get();
@@ -1794,40 +2307,44 @@ PayloadManager::PendingPayloads::GetPayload(Payload::Id payload_id) const {
 }
 
 void PayloadManager::PendingPayloads::StopTrackingAllPayloads() {
-  MutexLock lock(&mutex_);
-
-  for (auto it = pending_payloads_.begin(); it != pending_payloads_.end();) {
-    Remove(it++);
+  for (Shard& shard : shards_) {
+    MutexLock lock(&shard.mutex);
+    for (auto it = shard.pending_payloads.begin();
+         it != shard.pending_payloads.end();) {
+      Remove(shard, it++);
+    }
   }
 }
 
 void PayloadManager::PendingPayloads::ForEachPayload(
     absl::AnyInvocable<void(PendingPayload*)> callback) {
-  MutexLock lock(&mutex_);
-
-  for (const auto& item : pending_payloads_) {
-    callback(item.second.get());
+  for (Shard& shard : shards_) {
+    MutexLock lock(&shard.mutex);
+    for (const auto& item : shard.pending_payloads) {
+      callback(item.second.get());
+    }
   }
 }
 
 void PayloadManager::PendingPayloads::Release(PendingPayload* payload) {
   // Called when `PendingPayloadHandle` is destroyed.
-  MutexLock lock(&mutex_);
+  Shard& shard = GetShard(payload->GetId());
+  MutexLock lock(&shard.mutex);
   NEARBY_VLOG(1) << __func__ << " " << payload->ToString();
-  auto it = pending_payloads_.find(payload->GetId());
-  if (it != pending_payloads_.end() && it->second.get() == payload) {
+  auto it = shard.pending_payloads.find(payload->GetId());
+  if (it != shard.pending_payloads.end() && it->second.get() == payload) {
     // The payload is still tracked.
     payload->DecRefCount();
     return;
   }
-  auto bin_it =
-      std::find_if(payload_garbage_bin_.begin(), payload_garbage_bin_.end(),
-                   [payload](auto& item) { return item.get() == payload; });
-  if (bin_it != payload_garbage_bin_.end()) {
+  auto bin_it = std::find_if(
+      shard.payload_garbage_bin.begin(), shard.payload_garbage_bin.end(),
+      [payload](auto& item) { return item.get() == payload; });
+  if (bin_it != shard.payload_garbage_bin.end()) {
     int refcount = payload->DecRefCount();
     if (refcount == 0) {
       // The payload is not tracked and it was the last reference.
-      payload_garbage_bin_.erase(bin_it);
+      shard.payload_garbage_bin.erase(bin_it);
     }
   }
 }
@@ -15,9 +15,11 @@
 #ifndef CORE_INTERNAL_PAYLOAD_MANAGER_H_
 #define CORE_INTERNAL_PAYLOAD_MANAGER_H_
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -27,9 +29,14 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/time/time.h"
 #include "connections/implementation/analytics/packet_meta_data.h"
+#include "connections/implementation/incoming_bytes_budget.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_manager.h"
 #include "connections/implementation/internal_payload.h"
+#include "connections/implementation/outgoing_payload_scheduler.h"
+#include "connections/implementation/payload_batcher.h"
+#include "connections/implementation/payload_progress_coalescer.h"
+#include "connections/implementation/payload_send_window.h"
 #include "connections/listeners.h"
 #include "connections/payload.h"
 #include "connections/payload_type.h"
@@ -37,9 +44,11 @@
 #include "internal/platform/atomic_boolean.h"
 #include "internal/platform/atomic_reference.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/cancellation_flag.h"
 #include "internal/platform/condition_variable.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/expected.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/single_thread_executor.h"
 
@@ -81,6 +90,18 @@ class PayloadManager : public EndpointManager::FrameProcessor {
 
   void SetCustomSavePath(ClientProxy* client, const std::string& path);
 
+  struct SendQueueStats {
+    // Outgoing payloads to the endpoint that are not done yet.
+    int payloads = 0;
+    // Bytes of them left to send; streams of unknown size add none.
+    std::int64_t bytes = 0;
+  };
+  SendQueueStats GetSendQueueStats(const std::string& endpoint_id);
+
+  // Returns the bytes of incoming BYTES payloads from |endpoint_id| that were
+  // read and not handed to the client yet.
+  std::int64_t GetIncomingBytesHeld(const std::string& endpoint_id);
+
  private:
   // Information about an endpoint for a particular payload.
   struct EndpointInfo {
@@ -110,6 +131,9 @@ class PayloadManager : public EndpointManager::FrameProcessor {
     ConditionVariable payload_received_ack_cond{&payload_received_ack_mutex};
     bool is_payload_received_ack ABSL_GUARDED_BY(payload_received_ack_mutex) =
         false;
+    // Progress of the payload to this endpoint not reported to the client yet.
+    std::unique_ptr<PayloadProgressCoalescer> progress =
+        std::make_unique<PayloadProgressCoalescer>();
   };
 
   // Tracks state for an InternalPayload and the endpoints associated with it.
@@ -135,6 +159,9 @@ class PayloadManager : public EndpointManager::FrameProcessor {
 
     bool IsLocallyCanceled() const;
     void MarkLocallyCanceled();
+    // Canceled along with the payload; its listeners interrupt the waits of
+    // the sender thread.
+    CancellationFlag& GetCancellationFlag() { return cancellation_flag_; }
     void MarkReceivedAckFromEndpoint(const std::string& from_endpoint_id);
     bool IsIncoming() const;
 
@@ -160,6 +187,17 @@ class PayloadManager : public EndpointManager::FrameProcessor {
     // Sets the offset for a particular endpoint.
     void SetOffsetForEndpoint(const std::string& endpoint_id,
                               std::int64_t offset) ABSL_LOCKS_EXCLUDED(mutex_);
+    // Returns nothing if `endpoint_id` is not associated with the payload.
+    std::optional<std::int64_t> GetOffsetForEndpoint(
+        const std::string& endpoint_id) const ABSL_LOCKS_EXCLUDED(mutex_);
+
+    // Returns the ids of the endpoints still available for this payload. The
+    // list is only rebuilt when an endpoint is removed or changes status, so
+    // sending a chunk doesn't copy it.
+    std::shared_ptr<const EndpointIds> GetAvailableEndpointIds() const
+        ABSL_LOCKS_EXCLUDED(mutex_);
+    // Returns true if an endpoint of this payload was canceled or failed.
+    bool HasUnavailableEndpoints() const ABSL_LOCKS_EXCLUDED(mutex_);
 
     // Closes internal_payload_.
     // Close is called when a pending peyload does not have associated
@@ -174,14 +212,19 @@ class PayloadManager : public EndpointManager::FrameProcessor {
     int DecRefCount() { return --refcount_; }
 
    private:
-    mutable Mutex mutex_;
+    void UpdateAvailableEndpointIds() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+    mutable Mutex mutex_{"PendingPayload::mutex_"};
     bool is_incoming_;
     AtomicBoolean is_locally_canceled_{false};
+    CancellationFlag cancellation_flag_;
     AtomicBoolean is_closed_;
     std::unique_ptr<InternalPayload> internal_payload_;
     DestroyCallback destroy_callback_;
     absl::flat_hash_map<std::string, EndpointInfo> endpoints_
         ABSL_GUARDED_BY(mutex_);
+    std::shared_ptr<const EndpointIds> available_endpoint_ids_
+        ABSL_GUARDED_BY(mutex_);
     int refcount_ = 0;
   };
 
@@ -229,32 +272,39 @@ class PayloadManager : public EndpointManager::FrameProcessor {
     ~PendingPayloads() = default;
 
     void StartTrackingPayload(Payload::Id payload_id,
-                              std::unique_ptr<PendingPayload> pending_payload)
-        ABSL_LOCKS_EXCLUDED(mutex_);
-    void StopTrackingPayload(Payload::Id payload_id)
-        ABSL_LOCKS_EXCLUDED(mutex_);
-    void StopTrackingAllPayloads() ABSL_LOCKS_EXCLUDED(mutex_);
-    PendingPayloadHandle GetPayload(Payload::Id payload_id) const
-        ABSL_LOCKS_EXCLUDED(mutex_);
-    // Calls `callback` for each tracked payload. The callback must not call
-    // other `PendingPayloads` methods.
-    void ForEachPayload(absl::AnyInvocable<void(PendingPayload*)> callback)
-        ABSL_LOCKS_EXCLUDED(mutex_);
+                              std::unique_ptr<PendingPayload> pending_payload);
+    void StopTrackingPayload(Payload::Id payload_id);
+    void StopTrackingAllPayloads();
+    PendingPayloadHandle GetPayload(Payload::Id payload_id) const;
+    // Calls `callback` for each tracked payload, one shard at a time. The
+    // callback must not call other `PendingPayloads` methods.
+    void ForEachPayload(absl::AnyInvocable<void(PendingPayload*)> callback);
 
    private:
-    void Release(PendingPayload* payload) ABSL_LOCKS_EXCLUDED(mutex_);
-    void Remove(absl::flat_hash_map<
-                Payload::Id, std::unique_ptr<PendingPayload>>::iterator it)
-        ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
-    mutable Mutex mutex_;
-    absl::flat_hash_map<Payload::Id, std::unique_ptr<PendingPayload>>
-        pending_payloads_ ABSL_GUARDED_BY(mutex_);
-    // When we stop tracking a payload but someone is still holding a handle to
-    // the payload, we can't delete it just yet. Instead, we move it to the
-    // garbage bin. When the `PendingPayloadHandle` is released, the payload
-    // will be removed from the bin.
-    std::vector<std::unique_ptr<PendingPayload>> payload_garbage_bin_
-        ABSL_GUARDED_BY(mutex_);
+    using PayloadMap =
+        absl::flat_hash_map<Payload::Id, std::unique_ptr<PendingPayload>>;
+
+    // Payloads are spread over independently locked shards by id, so that
+    // frames and acks of different payloads don't contend on one mutex. A
+    // payload's refcount is only touched under the lock of its shard.
+    struct Shard {
+      mutable Mutex mutex;
+      PayloadMap pending_payloads ABSL_GUARDED_BY(mutex);
+      // When we stop tracking a payload but someone is still holding a handle
+      // to the payload, we can't delete it just yet. Instead, we move it to
+      // the garbage bin. When the `PendingPayloadHandle` is released, the
+      // payload will be removed from the bin.
+      std::vector<std::unique_ptr<PendingPayload>> payload_garbage_bin
+          ABSL_GUARDED_BY(mutex);
+    };
+    static constexpr size_t kShardCount = 16;
+
+    Shard& GetShard(Payload::Id payload_id) const;
+    void Release(PendingPayload* payload);
+    static void Remove(Shard& shard, PayloadMap::iterator it)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(shard.mutex);
+
+    mutable std::array<Shard, kShardCount> shards_;
   };
 
   using Endpoints = std::vector<const EndpointInfo*>;
@@ -273,11 +323,33 @@ class PayloadManager : public EndpointManager::FrameProcessor {
   // Returns list of endpoint ids.
   static EndpointIds EndpointsToEndpointIds(const Endpoints& endpoints);
 
+  // Reads chunks of an outgoing payload ahead of the sender thread, on
+  // |chunk_reader_executor_|, bounded by |window|.
+  struct ChunkReader {
+    ChunkReader(size_t max_chunks, size_t max_bytes)
+        : window(max_chunks, max_bytes) {}
+
+    PayloadSendWindow window;
+    CountDownLatch done{1};
+    bool started = false;
+  };
+
+  // |chunk_reader| is null when chunks are detached on the sender thread.
+  // |compress| tells whether the payload's chunks may be compressed.
   bool SendPayloadLoop(
       ClientProxy* client, PendingPayload& pending_payload,
       location::nearby::connections::PayloadTransferFrame::PayloadHeader&
           payload_header,
-      std::int64_t& next_chunk_offset, size_t resume_offset, int index);
+      std::int64_t& next_chunk_offset, size_t resume_offset, int index,
+      ChunkReader* chunk_reader, bool high_priority, bool compress);
+  ByteArray DetachNextChunk(PendingPayload& pending_payload, int chunk_size,
+                            ChunkReader* chunk_reader);
+  void StartChunkReader(PendingPayload& pending_payload, int chunk_size,
+                        ChunkReader& chunk_reader);
+  // Returns the number of chunks that may be in flight between the chunk
+  // reader and the endpoint channels, based on the slowest connected medium.
+  size_t GetSendWindowSize(ClientProxy* client,
+                           const EndpointIds& endpoint_ids) const;
   void SendClientCallbacksForFinishedIncomingPayloadRunnable(
       ClientProxy* client, const std::string& endpoint_id,
       const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
@@ -308,7 +380,7 @@ class PayloadManager : public EndpointManager::FrameProcessor {
   static PayloadProgressInfo::Status PayloadStatusToTransferUpdateStatus(
       location::nearby::proto::connections::PayloadStatus status);
 
-  int GetOptimalChunkSize(EndpointIds endpoint_ids);
+  int GetOptimalChunkSize(const EndpointIds& endpoint_ids);
 
   location::nearby::connections::PayloadTransferFrame::PayloadHeader
   CreatePayloadHeader(const InternalPayload& internal_payload, size_t offset,
@@ -317,6 +389,12 @@ class PayloadManager : public EndpointManager::FrameProcessor {
 
   location::nearby::connections::PayloadTransferFrame::PayloadChunk
   CreatePayloadChunk(std::int64_t offset, ByteArray body, int index);
+  // Compresses the body of |payload_chunk| if all of |endpoint_ids| support
+  // it and it shrinks enough.
+  void MaybeCompressPayloadChunk(
+      ClientProxy* client, const EndpointIds& endpoint_ids,
+      location::nearby::connections::PayloadTransferFrame::PayloadChunk&
+          payload_chunk);
   bool IsLastChunk(
       location::nearby::connections::PayloadTransferFrame::PayloadChunk
           payload_chunk) {
@@ -325,8 +403,9 @@ class PayloadManager : public EndpointManager::FrameProcessor {
                  LAST_CHUNK) != 0);
   }
 
+  // Moves the chunk body of a BYTES payload out of |frame|.
   ErrorOr<PendingPayloadHandle> CreateIncomingPayload(
-      const location::nearby::connections::PayloadTransferFrame& frame,
+      location::nearby::connections::PayloadTransferFrame& frame,
       const std::string& endpoint_id) ABSL_LOCKS_EXCLUDED(mutex_);
 
   Payload::Id CreateOutgoingPayload(Payload payload,
@@ -412,6 +491,20 @@ class PayloadManager : public EndpointManager::FrameProcessor {
                              payload_transfer_frame,
                          location::nearby::proto::connections::Medium medium,
                          analytics::PacketMetaData& packet_meta_data);
+  // Replaces the body of a COMPRESSED data frame by the uncompressed one.
+  // Returns false, after failing the payload, if it can't be decompressed.
+  bool DecompressDataPacket(ClientProxy* to_client,
+                            const std::string& from_endpoint_id,
+                            location::nearby::connections::PayloadTransferFrame&
+                                payload_transfer_frame);
+  // Passes each payload of a BATCHED_DATA frame to ProcessDataPacket(), as a
+  // data frame with its body followed by its last chunk.
+  void ProcessBatchedDataPacket(
+      ClientProxy* to_client, const std::string& from_endpoint_id,
+      location::nearby::connections::PayloadTransferFrame&
+          payload_transfer_frame,
+      location::nearby::proto::connections::Medium medium,
+      analytics::PacketMetaData& packet_meta_data);
   void ProcessControlPacket(ClientProxy* to_client,
                             const std::string& from_endpoint_id,
                             location::nearby::connections::PayloadTransferFrame&
@@ -421,12 +514,47 @@ class PayloadManager : public EndpointManager::FrameProcessor {
       location::nearby::connections::PayloadTransferFrame&
           payload_transfer_frame);
 
+  // Merges the progress of a chunk into the pending progress update of the
+  // payload to |endpoint_id|, and schedules the update if none is pending.
+  void UpdatePayloadProgress(
+      ClientProxy* client, const std::string& endpoint_id,
+      const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
+          payload_header,
+      std::int64_t bytes_transferred);
+  void FlushPayloadProgress(
+      ClientProxy* client, const std::string& endpoint_id,
+      const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
+          payload_header) RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD();
+  PayloadProgressCadence GetPayloadProgressCadence(
+      ClientProxy* client, const std::string& endpoint_id,
+      const location::nearby::connections::PayloadTransferFrame::PayloadHeader&
+          payload_header) const;
+
   void NotifyClientOfIncomingPayloadProgressInfo(
       ClientProxy* client, const std::string& endpoint_id,
       const PayloadProgressInfo& payload_transfer_update)
       RUN_ON_PAYLOAD_STATUS_UPDATE_THREAD();
 
-  SingleThreadExecutor* GetOutgoingPayloadExecutor(PayloadType payload_type);
+  // Returns whether an outgoing payload goes out with high priority, see
+  // PayloadPriority.
+  static bool IsHighPriority(PayloadType payload_type,
+                             PayloadPriority priority);
+  // Returns whether a BYTES payload of |size| bytes to |endpoint_ids| may be
+  // sent in a batch.
+  bool IsBatchable(ClientProxy* client, const EndpointIds& endpoint_ids,
+                   std::int64_t size) const;
+  // Adds an outgoing payload to the batch of its endpoints, and schedules the
+  // batch if the payload opened it.
+  void SendBatchedPayload(ClientProxy* client, const EndpointIds& endpoint_ids,
+                          Payload payload);
+  // Sends the payloads of a batch in one BATCHED_DATA frame.
+  void SendPayloadBatch(ClientProxy* client, const EndpointIds& endpoint_ids,
+                        const std::vector<Payload::Id>& payload_ids);
+  // Runs the send loop of an outgoing payload of |payload_type| to
+  // |endpoint_ids|.
+  void ScheduleOutgoingPayload(PayloadType payload_type, bool high_priority,
+                               const EndpointIds& endpoint_ids,
+                               absl::AnyInvocable<void()> runnable);
 
   void RunOnStatusUpdateThread(const std::string& name,
                                absl::AnyInvocable<void()> runnable);
@@ -455,30 +583,40 @@ class PayloadManager : public EndpointManager::FrameProcessor {
           PayloadType type);
 
   void OnPendingPayloadDestroy(const PendingPayload* payload);
-  mutable Mutex mutex_;
+
+  // Holds high throughput link settings for the endpoints of a FILE or
+  // STREAM payload until the payload is destroyed.
+  void RequestHighThroughput(PendingPayload* payload,
+                             const EndpointIds& endpoint_ids)
+      ABSL_LOCKS_EXCLUDED(high_throughput_mutex_);
+  void ReleaseHighThroughput(const PendingPayload* payload)
+      ABSL_LOCKS_EXCLUDED(high_throughput_mutex_);
+  mutable Mutex mutex_{"PayloadManager::mutex_"};
   std::string custom_save_path_;
   AtomicBoolean shutdown_{false};
   std::unique_ptr<CountDownLatch> shutdown_barrier_;
   int send_payload_count_ = 0;
-  SingleThreadExecutor bytes_payload_executor_;
-  SingleThreadExecutor file_payload_executor_;
+  // Runs bytes and file payloads, concurrently across endpoints.
+  OutgoingPayloadScheduler outgoing_payload_scheduler_;
+  // One reader per file payload sent at a time.
+  MultiThreadExecutor file_chunk_reader_executor_;
   SingleThreadExecutor stream_payload_executor_;
   SingleThreadExecutor payload_status_update_executor_;
   SingleThreadExecutor send_payload_ack_executor_;
   PendingPayloads pending_payloads_;
   EndpointManager* endpoint_manager_;
-
-  // When callback processing cannot keep the speed of callback update, the
-  // callback thread will be lag to the real transfer. In order to keep sync
-  // between callback and sending/receiving threads, we will skip
-  // non-important callbacks during file transfer.
-  mutable Mutex chunk_update_mutex_;
-  int outgoing_chunk_update_count_ ABSL_GUARDED_BY(chunk_update_mutex_) = 0;
-  absl::Time last_outgoing_chunk_update_time_
-      ABSL_GUARDED_BY(chunk_update_mutex_) = absl::InfinitePast();
-  int incoming_chunk_update_count_ ABSL_GUARDED_BY(chunk_update_mutex_) = 0;
-  absl::Time last_incoming_chunk_update_time_
-      ABSL_GUARDED_BY(chunk_update_mutex_) = absl::InfinitePast();
+  // Accounts for the bytes of incoming BYTES payloads waiting for the client
+  // per endpoint, and holds back their readers while there are too many.
+  std::unique_ptr<IncomingBytesBudget> incoming_bytes_budget_;
+  // Batches small outgoing BYTES payloads; null if payload batching is
+  // disabled.
+  std::unique_ptr<PayloadBatcher> payload_batcher_;
+  std::int64_t max_batched_payload_size_ = 0;
+  Mutex high_throughput_mutex_;
+  // The endpoints that FILE and STREAM payloads requested high throughput
+  // link settings from.
+  absl::flat_hash_map<const PendingPayload*, EndpointIds>
+      high_throughput_endpoints_ ABSL_GUARDED_BY(high_throughput_mutex_);
 };
 
 }  // namespace connections
@@ -0,0 +1,206 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "connections/implementation/base_endpoint_channel.h"
+#include "connections/implementation/client_proxy.h"
+#include "connections/implementation/endpoint_channel_manager.h"
+#include "connections/implementation/endpoint_manager.h"
+#include "connections/implementation/offline_frames.h"
+#include "connections/implementation/payload_manager.h"
+#include "connections/implementation/proto/offline_wire_formats.pb.h"
+#include "connections/payload.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/input_stream.h"
+#include "internal/platform/output_stream.h"
+#include "internal/platform/pipe.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::connections::OfflineFrame;
+using ::location::nearby::connections::PayloadTransferFrame;
+using ::location::nearby::connections::V1Frame;
+using ::location::nearby::proto::connections::Medium;
+
+constexpr char kEndpointId[] = "endpoint";
+constexpr absl::Duration kPayloadTimeout = absl::Seconds(30);
+
+class PipeEndpointChannel : public BaseEndpointChannel {
+ public:
+  PipeEndpointChannel(InputStream* input, OutputStream* output)
+      : BaseEndpointChannel("service_id", "channel", input, output) {}
+
+  Medium GetMedium() const override { return Medium::WIFI_LAN; }
+  void CloseImpl() override {}
+};
+
+// A PayloadManager sending to `endpoints` endpoints, each with a pipe as its
+// channel. A receiver thread per endpoint reads the frames off its pipe and
+// counts the payloads it got the last chunk of. No acks are sent back, since
+// kEnablePayloadReceivedAck is off by default.
+class PayloadSender {
+ public:
+  explicit PayloadSender(int endpoints = 1) : endpoints_(endpoints) {
+    for (int i = 0; i < endpoints; i++) {
+      Endpoint& endpoint = endpoints_[i];
+      endpoint.id = absl::StrCat(kEndpointId, i);
+      auto [input, output] = CreatePipe();
+      endpoint.input = std::move(input);
+      endpoint.output = std::move(output);
+      ecm_.RegisterChannelForEndpoint(
+          &client_, endpoint.id,
+          std::make_unique<PipeEndpointChannel>(nullptr,
+                                                endpoint.output.get()));
+      endpoint.receiver = std::thread([&endpoint]() { Receive(endpoint); });
+    }
+  }
+
+  ~PayloadSender() {
+    payload_manager_.reset();
+    for (Endpoint& endpoint : endpoints_) {
+      endpoint.output->Close();
+      endpoint.receiver.join();
+    }
+  }
+
+  // Sends a bytes payload of `size` to the `index`th endpoint and waits until
+  // its receiver has read all of it.
+  bool Send(int index, int64_t size) {
+    Endpoint& endpoint = endpoints_[index];
+    int64_t expected;
+    {
+      absl::MutexLock lock(&endpoint.mutex);
+      expected = ++endpoint.sent;
+    }
+    payload_manager_->SendPayload(&client_, {endpoint.id},
+                                  Payload(ByteArray(size)));
+    absl::MutexLock lock(&endpoint.mutex);
+    auto received = [&endpoint, expected]()
+                        ABSL_EXCLUSIVE_LOCKS_REQUIRED(endpoint.mutex) {
+                          return endpoint.received >= expected;
+                        };
+    return endpoint.mutex.AwaitWithTimeout(absl::Condition(&received),
+                                           kPayloadTimeout);
+  }
+
+ private:
+  struct Endpoint {
+    std::string id;
+    std::unique_ptr<InputStream> input;
+    std::unique_ptr<OutputStream> output;
+    std::thread receiver;
+
+    absl::Mutex mutex;
+    int64_t sent ABSL_GUARDED_BY(mutex) = 0;
+    int64_t received ABSL_GUARDED_BY(mutex) = 0;
+  };
+
+  static void Receive(Endpoint& endpoint) {
+    PipeEndpointChannel channel(endpoint.input.get(), nullptr);
+    while (true) {
+      ExceptionOr<ByteArray> bytes = channel.Read();
+      if (!bytes.ok() || bytes.result().Empty()) return;
+      ExceptionOr<OfflineFrame> frame = parser::FromBytes(bytes.result());
+      if (!frame.ok() ||
+          parser::GetFrameType(frame.result()) != V1Frame::PAYLOAD_TRANSFER) {
+        continue;
+      }
+      const PayloadTransferFrame& transfer =
+          frame.result().v1().payload_transfer();
+      if (transfer.packet_type() == PayloadTransferFrame::DATA &&
+          (transfer.payload_chunk().flags() &
+           PayloadTransferFrame::PayloadChunk::LAST_CHUNK) != 0) {
+        absl::MutexLock lock(&endpoint.mutex);
+        endpoint.received++;
+      }
+    }
+  }
+
+  // Endpoints are neither copied nor moved once the receivers run.
+  std::deque<Endpoint> endpoints_;
+  ClientProxy client_;
+  EndpointChannelManager ecm_;
+  EndpointManager em_{&ecm_};
+  std::unique_ptr<PayloadManager> payload_manager_ =
+      std::make_unique<PayloadManager>(em_);
+};
+
+void BM_SendBytesPayload(benchmark::State& state) {
+  PayloadSender sender;
+
+  for (auto _ : state) {
+    if (!sender.Send(0, state.range(0))) {
+      state.SkipWithError("payload wasn't received in time");
+      break;
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+// The send loop runs on the PayloadManager's executors, so wall time is what
+// counts.
+BENCHMARK(BM_SendBytesPayload)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 22)
+    ->UseRealTime();
+
+// Every benchmark thread sends small payloads to an endpoint of its own
+// through one PayloadManager. Each chunk sent and each payload finished
+// looks its payload up in the pending payloads, so this measures how
+// transfers to different endpoints contend on them.
+constexpr int kMaxConcurrentEndpoints = 16;
+PayloadSender* concurrent_sender = nullptr;
+
+void SetUpConcurrentSender(const benchmark::State& state) {
+  concurrent_sender = new PayloadSender(kMaxConcurrentEndpoints);
+}
+
+void TearDownConcurrentSender(const benchmark::State& state) {
+  delete concurrent_sender;
+  concurrent_sender = nullptr;
+}
+
+void BM_SendBytesPayloadConcurrently(benchmark::State& state) {
+  for (auto _ : state) {
+    if (!concurrent_sender->Send(state.thread_index(), state.range(0))) {
+      state.SkipWithError("payload wasn't received in time");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SendBytesPayloadConcurrently)
+    ->Arg(1 << 10)
+    ->Setup(SetUpConcurrentSender)
+    ->Teardown(TearDownConcurrentSender)
+    ->ThreadRange(1, kMaxConcurrentEndpoints)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -367,6 +367,38 @@ TEST_P(PayloadManagerTest, CanCancelPayloadOnSenderSide) {
   env_.Stop();
 }
 
+TEST_P(PayloadManagerTest, SenderCancelInterruptsWaitForData) {
+  env_.Start();
+  PayloadSimulationUser user_a(kDeviceA, GetParam());
+  PayloadSimulationUser user_b(kDeviceB, GetParam());
+  ASSERT_TRUE(SetupConnection(user_a, user_b));
+  auto [input, tx] = CreatePipe();
+  user_a.ExpectPayload(payload_latch_);
+  const ByteArray message{std::string(kMessage)};
+  tx->Write(message);
+
+  user_b.SendPayload(Payload(std::move(input)));
+  ASSERT_TRUE(payload_latch_.Await(kDefaultTimeout).result());
+  EXPECT_TRUE(user_a.WaitForProgress(
+      [&message](const PayloadProgressInfo& info) {
+        return info.bytes_transferred >= message.size();
+      },
+      kProgressTimeout));
+
+  // The sender is blocked waiting for more data; the cancel must not wait for
+  // it.
+  EXPECT_EQ(user_b.CancelPayload(), Status{Status::kSuccess});
+  EXPECT_TRUE(user_a.WaitForProgress(
+      [status = PayloadProgressInfo::Status::kCanceled](
+          const PayloadProgressInfo& info) { return info.status == status; },
+      kProgressTimeout));
+
+  tx->Close();
+  user_a.Stop();
+  user_b.Stop();
+  env_.Stop();
+}
+
 TEST_P(PayloadManagerTest, SendPayloadWithSkip_StreamPayload) {
   constexpr size_t kOffset = 3;
   env_.Start();
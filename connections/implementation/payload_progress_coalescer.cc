@@ -0,0 +1,67 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_progress_coalescer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+
+namespace nearby {
+namespace connections {
+
+bool PayloadProgressCoalescer::Update(std::int64_t bytes_transferred) {
+  // Updates from different threads may race each other; only ever move
+  // forward.
+  std::int64_t current = bytes_transferred_.load(std::memory_order_relaxed);
+  while (current < bytes_transferred &&
+         !bytes_transferred_.compare_exchange_weak(
+             current, bytes_transferred, std::memory_order_release,
+             std::memory_order_relaxed)) {
+  }
+  return !flush_pending_.exchange(true, std::memory_order_acq_rel);
+}
+
+std::optional<std::int64_t> PayloadProgressCoalescer::Flush(
+    const PayloadProgressCadence& cadence, absl::Time now) {
+  // Clear the flag before reading, so that an update racing with this flush
+  // schedules the next one rather than getting lost.
+  flush_pending_.store(false, std::memory_order_release);
+  std::int64_t bytes_transferred =
+      bytes_transferred_.load(std::memory_order_acquire);
+  if (bytes_transferred == reported_bytes_) return std::nullopt;
+
+  // The first update of a payload is always reported.
+  if (reported_bytes_ >= 0) {
+    bool has_cadence =
+        cadence.bytes > 0 || cadence.interval > absl::ZeroDuration();
+    bool bytes_reached = cadence.bytes > 0 &&
+                         bytes_transferred - reported_bytes_ >= cadence.bytes;
+    bool interval_reached = cadence.interval > absl::ZeroDuration() &&
+                            now - reported_time_ >= cadence.interval;
+    if (has_cadence && !bytes_reached && !interval_reached) {
+      return std::nullopt;
+    }
+  }
+
+  reported_bytes_ = bytes_transferred;
+  reported_time_ = now;
+  return bytes_transferred;
+}
+
+}  // namespace connections
+}  // namespace nearby
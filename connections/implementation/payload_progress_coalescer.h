@@ -0,0 +1,65 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_PAYLOAD_PROGRESS_COALESCER_H_
+#define CORE_INTERNAL_PAYLOAD_PROGRESS_COALESCER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+
+namespace nearby {
+namespace connections {
+
+// Merges the progress of one payload to one endpoint between two progress
+// callbacks.
+//
+// The threads sending or receiving chunks call Update(), which only touches
+// atomics; the first update after a flush asks its caller to schedule the
+// next Flush() on the thread delivering callbacks, and every later update is
+// merged into it until it runs. This way the callback thread never lags
+// behind the transfer with a queue of stale updates, and every tick delivers
+// exactly one callback with the latest progress.
+class PayloadProgressCoalescer {
+ public:
+  PayloadProgressCoalescer() = default;
+  PayloadProgressCoalescer(const PayloadProgressCoalescer&) = delete;
+  PayloadProgressCoalescer& operator=(const PayloadProgressCoalescer&) =
+      delete;
+
+  // Merges |bytes_transferred| into the pending progress. Returns true if
+  // the caller has to schedule a Flush(), because none is pending yet.
+  bool Update(std::int64_t bytes_transferred);
+
+  // Takes the pending progress. Returns the bytes transferred to report, or
+  // nullopt if there is nothing new or |cadence| says it is too early to
+  // report again. Must only be called from one thread at a time.
+  std::optional<std::int64_t> Flush(const PayloadProgressCadence& cadence,
+                                    absl::Time now);
+
+ private:
+  std::atomic<std::int64_t> bytes_transferred_{0};
+  std::atomic<bool> flush_pending_{false};
+  // Only touched by Flush().
+  std::int64_t reported_bytes_ = -1;
+  absl::Time reported_time_ = absl::InfinitePast();
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_PAYLOAD_PROGRESS_COALESCER_H_
@@ -0,0 +1,98 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_progress_coalescer.h"
+
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "connections/listeners.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::Time kStart = absl::UnixEpoch();
+
+TEST(PayloadProgressCoalescerTest, MergesUpdatesUntilTheFlush) {
+  PayloadProgressCoalescer coalescer;
+
+  EXPECT_TRUE(coalescer.Update(100));
+  EXPECT_FALSE(coalescer.Update(200));
+  EXPECT_FALSE(coalescer.Update(300));
+
+  EXPECT_EQ(coalescer.Flush({}, kStart), 300);
+  EXPECT_TRUE(coalescer.Update(400));
+}
+
+TEST(PayloadProgressCoalescerTest, NeverGoesBackward) {
+  PayloadProgressCoalescer coalescer;
+
+  coalescer.Update(300);
+  coalescer.Update(200);
+
+  EXPECT_EQ(coalescer.Flush({}, kStart), 300);
+}
+
+TEST(PayloadProgressCoalescerTest, DoesNotReportTheSameProgressTwice) {
+  PayloadProgressCoalescer coalescer;
+
+  coalescer.Update(100);
+  EXPECT_EQ(coalescer.Flush({}, kStart), 100);
+  // A flush scheduled by an update that the previous flush already took.
+  EXPECT_EQ(coalescer.Flush({}, kStart), std::nullopt);
+}
+
+TEST(PayloadProgressCoalescerTest, ReportsEveryBytesCadence) {
+  PayloadProgressCoalescer coalescer;
+  PayloadProgressCadence cadence = {.bytes = 1000};
+
+  coalescer.Update(100);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart), 100);
+  coalescer.Update(600);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart), std::nullopt);
+  coalescer.Update(1100);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart), 1100);
+}
+
+TEST(PayloadProgressCoalescerTest, ReportsEveryIntervalCadence) {
+  PayloadProgressCoalescer coalescer;
+  PayloadProgressCadence cadence = {.interval = absl::Milliseconds(100)};
+
+  coalescer.Update(100);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart), 100);
+  coalescer.Update(200);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart + absl::Milliseconds(50)),
+            std::nullopt);
+  coalescer.Update(300);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart + absl::Milliseconds(100)), 300);
+}
+
+TEST(PayloadProgressCoalescerTest, ReportsWhicheverCadenceComesFirst) {
+  PayloadProgressCoalescer coalescer;
+  PayloadProgressCadence cadence = {.bytes = 1000,
+                                    .interval = absl::Milliseconds(100)};
+
+  coalescer.Update(100);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart), 100);
+  coalescer.Update(1100);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart + absl::Milliseconds(1)), 1100);
+  coalescer.Update(1200);
+  EXPECT_EQ(coalescer.Flush(cadence, kStart + absl::Milliseconds(101)), 1200);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
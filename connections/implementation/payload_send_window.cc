@@ -0,0 +1,81 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_send_window.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+namespace connections {
+
+PayloadSendWindow::PayloadSendWindow(size_t max_chunks, size_t max_bytes)
+    : max_chunks_(std::max<size_t>(max_chunks, 1)), max_bytes_(max_bytes) {}
+
+bool PayloadSendWindow::Push(ByteArray chunk) {
+  MutexLock lock(&mutex_);
+  while (!closed_ && IsFull()) {
+    cond_.Wait();
+  }
+  if (closed_) return false;
+  buffered_bytes_ += chunk.size();
+  chunks_.push_back(std::move(chunk));
+  cond_.Notify();
+  return true;
+}
+
+ExceptionOr<ByteArray> PayloadSendWindow::Pop() {
+  MutexLock lock(&mutex_);
+  while (!closed_ && chunks_.empty()) {
+    cond_.Wait();
+  }
+  if (closed_) return {Exception::kInterrupted};
+  ByteArray chunk = std::move(chunks_.front());
+  chunks_.pop_front();
+  buffered_bytes_ -= chunk.size();
+  cond_.Notify();
+  return ExceptionOr<ByteArray>(std::move(chunk));
+}
+
+void PayloadSendWindow::Close() {
+  MutexLock lock(&mutex_);
+  closed_ = true;
+  chunks_.clear();
+  buffered_bytes_ = 0;
+  cond_.Notify();
+}
+
+size_t PayloadSendWindow::GetBufferedChunks() const {
+  MutexLock lock(&mutex_);
+  return chunks_.size();
+}
+
+size_t PayloadSendWindow::GetBufferedBytes() const {
+  MutexLock lock(&mutex_);
+  return buffered_bytes_;
+}
+
+bool PayloadSendWindow::IsFull() const {
+  if (chunks_.size() >= max_chunks_) return true;
+  // A single chunk larger than |max_bytes_| must still make progress.
+  return !chunks_.empty() && buffered_bytes_ >= max_bytes_;
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,80 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_PAYLOAD_SEND_WINDOW_H_
+#define CORE_INTERNAL_PAYLOAD_SEND_WINDOW_H_
+
+#include <cstddef>
+#include <deque>
+
+#include "absl/base/thread_annotations.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace connections {
+
+// A bounded hand-off between the stage that detaches chunks from an outgoing
+// payload and the stage that writes them to the endpoint channels.
+//
+// The reader stage may run ahead of the writer by at most |max_chunks| chunks
+// or |max_bytes| bytes, whichever limit is reached first. This lets file
+// reads for chunk N+1 overlap with the encryption and socket write of chunk N
+// without letting a slow link buffer an unbounded amount of the file.
+//
+// An empty chunk marks the end of the payload (or a read failure), exactly as
+// it does for InternalPayload::DetachNextChunk(), and is always delivered.
+class PayloadSendWindow {
+ public:
+  PayloadSendWindow(size_t max_chunks, size_t max_bytes);
+  ~PayloadSendWindow() = default;
+
+  PayloadSendWindow(const PayloadSendWindow&) = delete;
+  PayloadSendWindow& operator=(const PayloadSendWindow&) = delete;
+
+  // Called by the reader stage. Blocks while the window is full.
+  // Returns false if the window was closed; |chunk| is dropped in that case.
+  bool Push(ByteArray chunk) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Called by the writer stage. Blocks until a chunk is available.
+  // Returns Exception::kInterrupted if the window was closed before a chunk
+  // became available.
+  ExceptionOr<ByteArray> Pop() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Unblocks both stages and discards any buffered chunks. Used when the
+  // writer stops early (cancellation, endpoint failure, shutdown).
+  void Close() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Number of chunks / bytes currently buffered. For tests and logging.
+  size_t GetBufferedChunks() const ABSL_LOCKS_EXCLUDED(mutex_);
+  size_t GetBufferedBytes() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  bool IsFull() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t max_chunks_;
+  const size_t max_bytes_;
+  mutable Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  std::deque<ByteArray> chunks_ ABSL_GUARDED_BY(mutex_);
+  size_t buffered_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool closed_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_PAYLOAD_SEND_WINDOW_H_
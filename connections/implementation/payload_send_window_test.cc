@@ -0,0 +1,128 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/payload_send_window.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(100);
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+TEST(PayloadSendWindowTest, DeliversChunksInOrder) {
+  PayloadSendWindow window(/*max_chunks=*/4, /*max_bytes=*/1024);
+
+  EXPECT_TRUE(window.Push(ByteArray(std::string("a"))));
+  EXPECT_TRUE(window.Push(ByteArray(std::string("bc"))));
+  EXPECT_TRUE(window.Push(ByteArray()));
+  EXPECT_EQ(window.GetBufferedChunks(), 3);
+  EXPECT_EQ(window.GetBufferedBytes(), 3);
+
+  ExceptionOr<ByteArray> first = window.Pop();
+  ASSERT_TRUE(first.ok());
+  EXPECT_EQ(first.result().AsStringView(), "a");
+  ExceptionOr<ByteArray> second = window.Pop();
+  ASSERT_TRUE(second.ok());
+  EXPECT_EQ(second.result().AsStringView(), "bc");
+  ExceptionOr<ByteArray> last = window.Pop();
+  ASSERT_TRUE(last.ok());
+  EXPECT_TRUE(last.result().Empty());
+  EXPECT_EQ(window.GetBufferedBytes(), 0);
+}
+
+TEST(PayloadSendWindowTest, PushBlocksWhenChunkLimitReached) {
+  PayloadSendWindow window(/*max_chunks=*/2, /*max_bytes=*/1024);
+  SingleThreadExecutor executor;
+  CountDownLatch pushed(1);
+
+  EXPECT_TRUE(window.Push(ByteArray(std::string("a"))));
+  EXPECT_TRUE(window.Push(ByteArray(std::string("b"))));
+  executor.Execute([&window, &pushed]() {
+    window.Push(ByteArray(std::string("c")));
+    pushed.CountDown();
+  });
+
+  EXPECT_FALSE(pushed.Await(kShortTimeout).result());
+  ASSERT_TRUE(window.Pop().ok());
+  EXPECT_TRUE(pushed.Await(kDefaultTimeout).result());
+  EXPECT_EQ(window.GetBufferedChunks(), 2);
+}
+
+TEST(PayloadSendWindowTest, PushBlocksWhenByteLimitReached) {
+  PayloadSendWindow window(/*max_chunks=*/8, /*max_bytes=*/4);
+  SingleThreadExecutor executor;
+  CountDownLatch pushed(1);
+
+  // A chunk larger than the byte limit is still accepted into an empty window.
+  EXPECT_TRUE(window.Push(ByteArray(std::string("abcdef"))));
+  executor.Execute([&window, &pushed]() {
+    window.Push(ByteArray(std::string("g")));
+    pushed.CountDown();
+  });
+
+  EXPECT_FALSE(pushed.Await(kShortTimeout).result());
+  ASSERT_TRUE(window.Pop().ok());
+  EXPECT_TRUE(pushed.Await(kDefaultTimeout).result());
+}
+
+TEST(PayloadSendWindowTest, CloseUnblocksPop) {
+  PayloadSendWindow window(/*max_chunks=*/2, /*max_bytes=*/1024);
+  SingleThreadExecutor executor;
+  CountDownLatch popped(1);
+  Exception::Value result = Exception::kSuccess;
+
+  executor.Execute([&window, &popped, &result]() {
+    result = window.Pop().exception();
+    popped.CountDown();
+  });
+  EXPECT_FALSE(popped.Await(kShortTimeout).result());
+
+  window.Close();
+  EXPECT_TRUE(popped.Await(kDefaultTimeout).result());
+  EXPECT_EQ(result, Exception::kInterrupted);
+}
+
+TEST(PayloadSendWindowTest, CloseUnblocksPushAndDropsChunks) {
+  PayloadSendWindow window(/*max_chunks=*/1, /*max_bytes=*/1024);
+  SingleThreadExecutor executor;
+  CountDownLatch pushed(1);
+  bool accepted = true;
+
+  EXPECT_TRUE(window.Push(ByteArray(std::string("a"))));
+  executor.Execute([&window, &pushed, &accepted]() {
+    accepted = window.Push(ByteArray(std::string("b")));
+    pushed.CountDown();
+  });
+  EXPECT_FALSE(pushed.Await(kShortTimeout).result());
+
+  window.Close();
+  EXPECT_TRUE(pushed.Await(kDefaultTimeout).result());
+  EXPECT_FALSE(accepted);
+  EXPECT_EQ(window.GetBufferedChunks(), 0);
+  EXPECT_FALSE(window.Push(ByteArray(std::string("c"))));
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
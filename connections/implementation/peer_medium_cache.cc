@@ -0,0 +1,264 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/peer_medium_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/time.h"
+#include "nlohmann/json.hpp"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/crypto.h"
+#include "internal/platform/implementation/preferences_manager.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+using json = ::nlohmann::json;
+
+// Bytes of the SHA-256 hash kept in a peer key.
+constexpr std::size_t kPeerKeyHashSize = 16;
+
+std::int64_t GetInt(const json& object, const char* key) {
+  auto it = object.find(key);
+  if (it == object.end() || !it->is_number_integer()) return 0;
+  return it->get<std::int64_t>();
+}
+
+std::optional<bool> GetOptionalBool(const json& object, const char* key) {
+  auto it = object.find(key);
+  if (it == object.end() || !it->is_boolean()) return std::nullopt;
+  return it->get<bool>();
+}
+
+json MediumStatsToJson(Medium medium,
+                       const PeerMediumCache::MediumStats& stats) {
+  json object = {
+      {"medium", static_cast<int>(medium)},
+      {"connect_successes", stats.connect_successes},
+      {"connect_failures", stats.connect_failures},
+      {"connect_latency_millis",
+       absl::ToInt64Milliseconds(stats.connect_latency)},
+      {"upgrade_successes", stats.upgrade_successes},
+      {"upgrade_failures", stats.upgrade_failures},
+      {"bytes_per_second", stats.bytes_per_second},
+  };
+  if (stats.last_connect_succeeded.has_value()) {
+    object["last_connect_succeeded"] = *stats.last_connect_succeeded;
+  }
+  if (stats.last_upgrade_succeeded.has_value()) {
+    object["last_upgrade_succeeded"] = *stats.last_upgrade_succeeded;
+  }
+  return object;
+}
+
+PeerMediumCache::MediumStats MediumStatsFromJson(const json& object) {
+  PeerMediumCache::MediumStats stats;
+  stats.connect_successes = GetInt(object, "connect_successes");
+  stats.connect_failures = GetInt(object, "connect_failures");
+  stats.last_connect_succeeded =
+      GetOptionalBool(object, "last_connect_succeeded");
+  stats.connect_latency =
+      absl::Milliseconds(GetInt(object, "connect_latency_millis"));
+  stats.upgrade_successes = GetInt(object, "upgrade_successes");
+  stats.upgrade_failures = GetInt(object, "upgrade_failures");
+  stats.last_upgrade_succeeded =
+      GetOptionalBool(object, "last_upgrade_succeeded");
+  stats.bytes_per_second = GetInt(object, "bytes_per_second");
+  return stats;
+}
+
+// 0 for a medium that connected last time, 1 for an unknown one, and 2 for
+// one that failed.
+int GetConnectionRank(const PeerMediumCache::MediumStats* stats) {
+  if (stats == nullptr || !stats->last_connect_succeeded.has_value()) {
+    return 1;
+  }
+  return *stats->last_connect_succeeded ? 0 : 2;
+}
+
+}  // namespace
+
+PeerMediumCache::PeerMediumCache(api::PreferencesManager* preferences_manager,
+                                 std::size_t max_peers)
+    : preferences_manager_(preferences_manager),
+      max_peers_(std::max<std::size_t>(max_peers, 1)) {
+  MutexLock lock(&mutex_);
+  LoadLocked();
+}
+
+std::string PeerMediumCache::GetPeerKey(const std::string& service_id,
+                                        const ByteArray& endpoint_info) {
+  if (endpoint_info.Empty()) return "";
+  std::string hash = static_cast<std::string>(Crypto::Sha256(
+      absl::StrCat(service_id, "/", endpoint_info.AsStringView())));
+  return absl::BytesToHexString(hash.substr(0, kPeerKeyHashSize));
+}
+
+void PeerMediumCache::RecordConnection(const std::string& peer_key,
+                                       Medium medium, bool succeeded,
+                                       absl::Duration latency) {
+  if (peer_key.empty()) return;
+  MutexLock lock(&mutex_);
+  MediumStats& stats = GetMediumStatsLocked(peer_key, medium);
+  stats.last_connect_succeeded = succeeded;
+  if (succeeded) {
+    stats.connect_latency = stats.connect_successes == 0
+                                ? latency
+                                : (stats.connect_latency + latency) / 2;
+    stats.connect_successes++;
+  } else {
+    stats.connect_failures++;
+  }
+  SaveLocked();
+}
+
+void PeerMediumCache::RecordUpgrade(const std::string& peer_key, Medium medium,
+                                    bool succeeded) {
+  if (peer_key.empty()) return;
+  MutexLock lock(&mutex_);
+  MediumStats& stats = GetMediumStatsLocked(peer_key, medium);
+  stats.last_upgrade_succeeded = succeeded;
+  if (succeeded) {
+    stats.upgrade_successes++;
+  } else {
+    stats.upgrade_failures++;
+  }
+  SaveLocked();
+}
+
+void PeerMediumCache::RecordThroughput(const std::string& peer_key,
+                                       Medium medium,
+                                       std::int64_t bytes_per_second) {
+  if (peer_key.empty() || bytes_per_second <= 0) return;
+  MutexLock lock(&mutex_);
+  MediumStats& stats = GetMediumStatsLocked(peer_key, medium);
+  stats.bytes_per_second =
+      stats.bytes_per_second == 0
+          ? bytes_per_second
+          : (stats.bytes_per_second + bytes_per_second) / 2;
+  SaveLocked();
+}
+
+std::optional<PeerMediumCache::PeerStats> PeerMediumCache::GetPeer(
+    const std::string& peer_key) const {
+  MutexLock lock(&mutex_);
+  auto it = peers_.find(peer_key);
+  if (it == peers_.end()) return std::nullopt;
+  return it->second.mediums;
+}
+
+std::vector<Medium> PeerMediumCache::OrderConnectionMediums(
+    const std::string& peer_key, const std::vector<Medium>& mediums) const {
+  std::optional<PeerStats> peer = GetPeer(peer_key);
+  if (!peer.has_value()) return mediums;
+
+  auto get_stats = [&peer](Medium medium) -> const MediumStats* {
+    auto it = peer->find(medium);
+    return it == peer->end() ? nullptr : &it->second;
+  };
+  std::vector<Medium> ordered(mediums);
+  std::stable_sort(ordered.begin(), ordered.end(),
+                   [&get_stats](Medium a, Medium b) {
+                     const MediumStats* a_stats = get_stats(a);
+                     const MediumStats* b_stats = get_stats(b);
+                     int a_rank = GetConnectionRank(a_stats);
+                     int b_rank = GetConnectionRank(b_stats);
+                     if (a_rank != b_rank) return a_rank < b_rank;
+                     return a_rank == 0 &&
+                            a_stats->connect_latency < b_stats->connect_latency;
+                   });
+  return ordered;
+}
+
+PeerMediumCache::MediumStats& PeerMediumCache::GetMediumStatsLocked(
+    const std::string& peer_key, Medium medium) {
+  if (!peers_.contains(peer_key) && peers_.size() >= max_peers_) {
+    EvictLeastRecentlyUsedLocked();
+  }
+  Peer& peer = peers_[peer_key];
+  peer.last_used = ++uses_;
+  return peer.mediums[medium];
+}
+
+void PeerMediumCache::EvictLeastRecentlyUsedLocked() {
+  auto oldest = peers_.begin();
+  for (auto it = peers_.begin(); it != peers_.end(); ++it) {
+    if (it->second.last_used < oldest->second.last_used) oldest = it;
+  }
+  peers_.erase(oldest);
+}
+
+void PeerMediumCache::LoadLocked() {
+  if (preferences_manager_ == nullptr) return;
+  json peers = preferences_manager_->Get(kPreferencesKey, json::object());
+  if (!peers.is_object()) {
+    NEARBY_LOGS(WARNING) << "PeerMediumCache: ignoring malformed preferences";
+    return;
+  }
+  for (const auto& [peer_key, object] : peers.items()) {
+    if (!object.is_object()) continue;
+    Peer peer;
+    peer.last_used = GetInt(object, "last_used");
+    auto mediums = object.find("mediums");
+    if (mediums != object.end() && mediums->is_array()) {
+      for (const json& medium : *mediums) {
+        if (!medium.is_object()) continue;
+        int value = GetInt(medium, "medium");
+        if (!location::nearby::proto::connections::Medium_IsValid(value)) {
+          continue;
+        }
+        peer.mediums[static_cast<Medium>(value)] = MediumStatsFromJson(medium);
+      }
+    }
+    uses_ = std::max(uses_, peer.last_used);
+    peers_.emplace(peer_key, std::move(peer));
+  }
+  // Drops the least recently used peers if |max_peers_| was lowered.
+  while (peers_.size() > max_peers_) {
+    EvictLeastRecentlyUsedLocked();
+  }
+}
+
+void PeerMediumCache::SaveLocked() {
+  if (preferences_manager_ == nullptr) return;
+  json peers = json::object();
+  for (const auto& [peer_key, peer] : peers_) {
+    json mediums = json::array();
+    for (const auto& [medium, stats] : peer.mediums) {
+      mediums.push_back(MediumStatsToJson(medium, stats));
+    }
+    peers[peer_key] = {{"last_used", peer.last_used}, {"mediums", mediums}};
+  }
+  if (!preferences_manager_->Set(kPreferencesKey, peers)) {
+    NEARBY_LOGS(WARNING) << "PeerMediumCache: failed to save the peers";
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,136 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_PEER_MEDIUM_CACHE_H_
+#define CORE_INTERNAL_PEER_MEDIUM_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/implementation/preferences_manager.h"
+#include "internal/platform/mutex.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+
+// Remembers, across sessions, how each medium fared with the remote devices
+// connected before: which mediums connected and how fast, which bandwidth
+// upgrades succeeded, and the throughput reached. A later connection to the
+// same device tries the mediums that worked first.
+//
+// Devices are told apart by their service id and endpoint info, the only
+// identity that outlives the random endpoint ids; devices advertising random
+// endpoint info are never recognized. The |max_peers| most recently used
+// devices are kept, and persisted in the preferences, if any.
+class PeerMediumCache {
+ public:
+  static constexpr std::size_t kDefaultMaxPeers = 128;
+  // The preferences file, relative to the application data directory.
+  static constexpr char kPreferencesFilePath[] = "Google/Nearby/Connections";
+  static constexpr char kPreferencesKey[] = "nearby_connections.peer_mediums";
+
+  struct MediumStats {
+    int connect_successes = 0;
+    int connect_failures = 0;
+    // The outcome of the latest connection attempt, if any.
+    std::optional<bool> last_connect_succeeded;
+    // Time to connect the medium, averaged like the throughput.
+    absl::Duration connect_latency = absl::ZeroDuration();
+    int upgrade_successes = 0;
+    int upgrade_failures = 0;
+    // The outcome of the latest bandwidth upgrade to the medium, if any.
+    std::optional<bool> last_upgrade_succeeded;
+    // The mean of the previous estimate and the latest sample, or 0.
+    std::int64_t bytes_per_second = 0;
+  };
+
+  using PeerStats =
+      absl::flat_hash_map<location::nearby::proto::connections::Medium,
+                          MediumStats>;
+
+  // |preferences_manager| may be null for an in-memory only cache.
+  explicit PeerMediumCache(api::PreferencesManager* preferences_manager,
+                           std::size_t max_peers = kDefaultMaxPeers);
+  PeerMediumCache(const PeerMediumCache&) = delete;
+  PeerMediumCache& operator=(const PeerMediumCache&) = delete;
+
+  // Returns the key of the device with |endpoint_info| advertising
+  // |service_id|, or an empty string if |endpoint_info| is empty.
+  static std::string GetPeerKey(const std::string& service_id,
+                                const ByteArray& endpoint_info);
+
+  // Records a connection attempt to |peer_key| over |medium|. |latency| is
+  // ignored if it failed.
+  void RecordConnection(const std::string& peer_key,
+                        location::nearby::proto::connections::Medium medium,
+                        bool succeeded, absl::Duration latency)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Records a bandwidth upgrade of |peer_key| to |medium|.
+  void RecordUpgrade(const std::string& peer_key,
+                     location::nearby::proto::connections::Medium medium,
+                     bool succeeded) ABSL_LOCKS_EXCLUDED(mutex_);
+  void RecordThroughput(const std::string& peer_key,
+                        location::nearby::proto::connections::Medium medium,
+                        std::int64_t bytes_per_second)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the statistics of |peer_key|, or nothing if it is not known.
+  std::optional<PeerStats> GetPeer(const std::string& peer_key) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Orders |mediums| for connecting to |peer_key|: the mediums it last
+  // connected over, fastest first, then the ones not tried yet, then the
+  // ones that failed last. Mediums ranking the same keep their order.
+  std::vector<location::nearby::proto::connections::Medium>
+  OrderConnectionMediums(
+      const std::string& peer_key,
+      const std::vector<location::nearby::proto::connections::Medium>& mediums)
+      const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Peer {
+    PeerStats mediums;
+    std::int64_t last_used = 0;
+  };
+
+  // Returns the statistics of |medium| with |peer_key|, adding them, and
+  // evicting the least recently used peer to make room, if needed.
+  MediumStats& GetMediumStatsLocked(
+      const std::string& peer_key,
+      location::nearby::proto::connections::Medium medium)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void EvictLeastRecentlyUsedLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void LoadLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void SaveLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  api::PreferencesManager* const preferences_manager_;
+  const std::size_t max_peers_;
+  mutable Mutex mutex_;
+  absl::flat_hash_map<std::string, Peer> peers_ ABSL_GUARDED_BY(mutex_);
+  // Orders the uses, to find the least recently used peer.
+  std::int64_t uses_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_PEER_MEDIUM_CACHE_H_
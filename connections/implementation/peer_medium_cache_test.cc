@@ -0,0 +1,135 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/peer_medium_cache.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/implementation/platform.h"
+#include "internal/platform/implementation/preferences_manager.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+using ::testing::ElementsAre;
+
+constexpr char kPreferencesFilePath[] = "Google/Nearby/ConnectionsTest";
+
+const std::string& GetPeerKey() {
+  static const std::string* const kPeerKey = new std::string(
+      PeerMediumCache::GetPeerKey("service", ByteArray("endpoint info")));
+  return *kPeerKey;
+}
+
+TEST(PeerMediumCacheTest, PeerKeyDependsOnServiceAndEndpointInfo) {
+  EXPECT_FALSE(GetPeerKey().empty());
+  EXPECT_EQ(PeerMediumCache::GetPeerKey("service", ByteArray("endpoint info")),
+            GetPeerKey());
+  EXPECT_NE(PeerMediumCache::GetPeerKey("other", ByteArray("endpoint info")),
+            GetPeerKey());
+  EXPECT_TRUE(PeerMediumCache::GetPeerKey("service", ByteArray()).empty());
+}
+
+TEST(PeerMediumCacheTest, RecordsOutcomesPerMedium) {
+  PeerMediumCache cache(/*preferences_manager=*/nullptr);
+
+  cache.RecordConnection(GetPeerKey(), Medium::BLUETOOTH, true,
+                         absl::Milliseconds(400));
+  cache.RecordConnection(GetPeerKey(), Medium::BLUETOOTH, true,
+                         absl::Milliseconds(200));
+  cache.RecordConnection(GetPeerKey(), Medium::BLE, false,
+                         absl::ZeroDuration());
+  cache.RecordUpgrade(GetPeerKey(), Medium::WIFI_LAN, false);
+  cache.RecordThroughput(GetPeerKey(), Medium::BLUETOOTH, 100 * 1024);
+
+  std::optional<PeerMediumCache::PeerStats> peer = cache.GetPeer(GetPeerKey());
+  ASSERT_TRUE(peer.has_value());
+  const PeerMediumCache::MediumStats& bluetooth = peer->at(Medium::BLUETOOTH);
+  EXPECT_EQ(bluetooth.connect_successes, 2);
+  EXPECT_EQ(bluetooth.last_connect_succeeded, true);
+  EXPECT_EQ(bluetooth.connect_latency, absl::Milliseconds(300));
+  EXPECT_EQ(bluetooth.bytes_per_second, 100 * 1024);
+  EXPECT_EQ(peer->at(Medium::BLE).last_connect_succeeded, false);
+  EXPECT_EQ(peer->at(Medium::WIFI_LAN).upgrade_failures, 1);
+  EXPECT_EQ(peer->at(Medium::WIFI_LAN).last_upgrade_succeeded, false);
+}
+
+TEST(PeerMediumCacheTest, OrdersConnectionMediumsByLastOutcome) {
+  PeerMediumCache cache(/*preferences_manager=*/nullptr);
+  std::vector<Medium> mediums = {Medium::BLE, Medium::BLUETOOTH,
+                                 Medium::WIFI_LAN, Medium::WEB_RTC};
+
+  EXPECT_EQ(cache.OrderConnectionMediums(GetPeerKey(), mediums), mediums);
+
+  cache.RecordConnection(GetPeerKey(), Medium::BLE, false,
+                         absl::ZeroDuration());
+  cache.RecordConnection(GetPeerKey(), Medium::WIFI_LAN, true,
+                         absl::Milliseconds(500));
+  cache.RecordConnection(GetPeerKey(), Medium::WEB_RTC, true,
+                         absl::Milliseconds(100));
+
+  EXPECT_THAT(cache.OrderConnectionMediums(GetPeerKey(), mediums),
+              ElementsAre(Medium::WEB_RTC, Medium::WIFI_LAN,
+                          Medium::BLUETOOTH, Medium::BLE));
+}
+
+TEST(PeerMediumCacheTest, EvictsLeastRecentlyUsedPeer) {
+  PeerMediumCache cache(/*preferences_manager=*/nullptr, /*max_peers=*/2);
+
+  cache.RecordUpgrade("a", Medium::WIFI_LAN, true);
+  cache.RecordUpgrade("b", Medium::WIFI_LAN, true);
+  cache.RecordUpgrade("a", Medium::WIFI_LAN, true);
+  cache.RecordUpgrade("c", Medium::WIFI_LAN, true);
+
+  EXPECT_TRUE(cache.GetPeer("a").has_value());
+  EXPECT_FALSE(cache.GetPeer("b").has_value());
+  EXPECT_TRUE(cache.GetPeer("c").has_value());
+}
+
+TEST(PeerMediumCacheTest, PersistsPeersInPreferences) {
+  std::unique_ptr<api::PreferencesManager> preferences_manager =
+      api::ImplementationPlatform::CreatePreferencesManager(
+          kPreferencesFilePath);
+  preferences_manager->Remove(PeerMediumCache::kPreferencesKey);
+  {
+    PeerMediumCache cache(preferences_manager.get());
+    cache.RecordConnection(GetPeerKey(), Medium::BLUETOOTH, true,
+                           absl::Milliseconds(250));
+    cache.RecordUpgrade(GetPeerKey(), Medium::WIFI_HOTSPOT, false);
+  }
+
+  PeerMediumCache cache(preferences_manager.get());
+
+  std::optional<PeerMediumCache::PeerStats> peer = cache.GetPeer(GetPeerKey());
+  ASSERT_TRUE(peer.has_value());
+  EXPECT_EQ(peer->at(Medium::BLUETOOTH).connect_successes, 1);
+  EXPECT_EQ(peer->at(Medium::BLUETOOTH).connect_latency,
+            absl::Milliseconds(250));
+  EXPECT_FALSE(peer->at(Medium::BLUETOOTH).last_upgrade_succeeded.has_value());
+  EXPECT_EQ(peer->at(Medium::WIFI_HOTSPOT).last_upgrade_succeeded, false);
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -14,12 +14,15 @@
 
 #include "connections/implementation/reconnect_manager.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "securegcm/ukey2_handshake.h"
+#include "absl/cleanup/cleanup.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/functional/bind_front.h"
@@ -32,7 +35,9 @@
 #include "connections/implementation/endpoint_channel_manager.h"
 #include "connections/implementation/mediums/mediums.h"
 #include "connections/implementation/offline_frames.h"
+#include "connections/implementation/reconnect_strategy.h"
 #include "connections/implementation/service_id_constants.h"
+#include "connections/implementation/session_resumption.h"
 #include "internal/platform/bluetooth_adapter.h"
 #include "internal/platform/bluetooth_classic.h"
 #include "internal/platform/byte_array.h"
@@ -53,6 +58,19 @@ namespace nearby {
 namespace connections {
 constexpr absl::string_view TAG = "[ReconnectManager]";
 
+// Mediums ranked like the connection mediums of the PCP handlers.
+constexpr Medium kReconnectMediumsByPriority[] = {
+    Medium::WIFI_LAN, Medium::WEB_RTC, Medium::BLUETOOTH, Medium::BLE};
+
+namespace {
+
+// Whether RunOnce() can reconnect over |medium|. Only these are raced.
+bool IsReconnectSupported(Medium medium) {
+  return medium == Medium::BLUETOOTH;
+}
+
+}  // namespace
+
 ReconnectManager::ReconnectManager(Mediums& mediums,
                                    EndpointChannelManager& channel_manager)
     : mediums_(&mediums), channel_manager_(&channel_manager) {}
@@ -97,11 +115,14 @@ bool ReconnectManager::AutoReconnect(ClientProxy* client,
   }
   std::string reconnect_service_id =
       WrapInitiatorReconnectServiceId(endpoint_channel->GetServiceId());
-  endpoint_id_metadata_map_.emplace(
-      endpoint_id,
-      ReconnectMetadata(is_incoming, std::move(callback),
-                        send_disconnection_notification, disconnection_reason,
-                        reconnect_service_id));
+  {
+    MutexLock lock(&metadata_mutex_);
+    endpoint_id_metadata_map_.emplace(
+        endpoint_id,
+        ReconnectMetadata(is_incoming, std::move(callback),
+                          send_disconnection_notification,
+                          disconnection_reason, reconnect_service_id));
+  }
   LOG(INFO) << TAG << "add a new endpoint_id " << endpoint_id
                     << " into metadata_by_service_id_map.";
 
@@ -133,35 +154,58 @@ bool ReconnectManager::Start(bool is_incoming, ClientProxy* client,
                              const std::string& endpoint_id,
                              const std::string& reconnect_service_id,
                              Medium medium) {
-  auto retry_delay_millis =
-      FeatureFlags::GetInstance()
-          .GetFlags()
-          .safe_to_disconnect_reconnect_retry_delay_millis;
-  auto reconnect_retry_num = FeatureFlags::GetInstance()
-                                 .GetFlags()
-                                 .safe_to_disconnect_reconnect_retry_attempts;
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  ReconnectStrategy strategy({
+      .initial_delay = flags.safe_to_disconnect_reconnect_retry_delay_millis,
+      .max_delay = flags.safe_to_disconnect_reconnect_max_retry_delay,
+      .multiplier = flags.safe_to_disconnect_reconnect_backoff_multiplier,
+      .jitter = flags.safe_to_disconnect_reconnect_retry_jitter,
+      .max_racing_mediums =
+          flags.safe_to_disconnect_reconnect_max_racing_mediums,
+  });
+  auto reconnect_retry_num = flags.safe_to_disconnect_reconnect_retry_attempts;
+  // Rank the lost medium among the supported ones, then leave out any
+  // candidate without a reconnect implementation.
+  std::vector<Medium> mediums_by_priority;
+  for (Medium ranked_medium : kReconnectMediumsByPriority) {
+    if (ranked_medium == medium || IsReconnectSupported(ranked_medium)) {
+      mediums_by_priority.push_back(ranked_medium);
+    }
+  }
+  std::vector<Medium> mediums =
+      strategy.GetCandidateMediums(medium, mediums_by_priority);
+  mediums.erase(std::remove_if(mediums.begin(), mediums.end(),
+                               [](Medium candidate) {
+                                 return !IsReconnectSupported(candidate);
+                               }),
+                mediums.end());
   LOG(INFO) << TAG << " " << (is_incoming ? "rehost" : "reconnect")
                     << " for medium: "
                     << location::nearby::proto::connections::Medium_Name(medium)
+                    << " over " << mediums.size() << " medium(s)"
                     << " for endpoint_id " << endpoint_id << " started...";
   bool final_result = false;
   CountDownLatch latch(1);
   reconnect_executor_.Execute(
       "reconnect-start", [this, &final_result, is_incoming, client, endpoint_id,
-                          &reconnect_service_id, retry_delay_millis,
-                          reconnect_retry_num, medium, &latch]() mutable {
+                          &reconnect_service_id, &strategy, reconnect_retry_num,
+                          &mediums, &latch]() mutable {
         for (int i = 0; i < reconnect_retry_num; ++i) {
           if (client->GetCancellationFlag(endpoint_id)->Cancelled()) {
             LOG(INFO)
                 << TAG << " Stop retry, Endpoint connection is cancelled";
             break;
           }
-          if (RunOnce(is_incoming, client, endpoint_id, reconnect_service_id,
-                      medium)) {
+          if (ReconnectStrategy::Race(
+                  mediums, [this, is_incoming, client, &endpoint_id,
+                            &reconnect_service_id](Medium medium) {
+                    return RunOnce(is_incoming, client, endpoint_id,
+                                   reconnect_service_id, medium);
+                  })) {
             final_result = true;
             break;
           }
-          SystemClock::Sleep(retry_delay_millis);
+          SystemClock::Sleep(strategy.GetBackoffDelay(i));
         }
         LOG(INFO) << "Reconnect "
                           << (final_result ? "succeeded" : "failed");
@@ -200,7 +244,14 @@ bool ReconnectManager::RunOnce(bool is_incoming, ClientProxy* client,
 void ReconnectManager::ClearReconnectData(
     ClientProxy* client, const std::string& reconnect_service_id,
     bool is_incoming) {
-  for (auto& item : endpoint_id_metadata_map_) {
+  // The callbacks run without holding metadata_mutex_.
+  absl::flat_hash_map<std::string, ReconnectMetadata> metadata_map;
+  {
+    MutexLock lock(&metadata_mutex_);
+    metadata_map = std::move(endpoint_id_metadata_map_);
+    endpoint_id_metadata_map_.clear();
+  }
+  for (auto& item : metadata_map) {
     if (item.second.reconnect_service_id == reconnect_service_id &&
         item.second.is_incoming == is_incoming) {
       if (item.second.reconnect_cb.on_reconnect_failure_cb) {
@@ -210,7 +261,6 @@ void ReconnectManager::ClearReconnectData(
       }
     }
     LOG(INFO) << TAG << "erase endpoint_id " << item.first;
-    endpoint_id_metadata_map_.erase(item.first);
   }
 }
 
@@ -221,7 +271,10 @@ void ReconnectManager::Shutdown() {
     listen_timeout_alarm_by_service_id_.clear();
   }
   new_endpoint_channels_.clear();
-  endpoint_id_metadata_map_.clear();
+  {
+    MutexLock lock(&metadata_mutex_);
+    endpoint_id_metadata_map_.clear();
+  }
   resumed_endpoints_.clear();
 
   alarm_executor_.Shutdown();
@@ -231,6 +284,30 @@ void ReconnectManager::Shutdown() {
   LOG(INFO) << TAG << "ReconnectManager has shut down.";
 }
 
+bool ReconnectManager::BeginReplaceChannel(const std::string& endpoint_id) {
+  MutexLock lock(&replace_channel_mutex_);
+  while (replacing_channel_endpoints_.contains(endpoint_id)) {
+    replace_channel_cond_.Wait();
+  }
+  if (!HasReconnectMetadata(endpoint_id)) {
+    return false;
+  }
+  replacing_channel_endpoints_.insert(endpoint_id);
+  return true;
+}
+
+void ReconnectManager::EndReplaceChannel(const std::string& endpoint_id) {
+  MutexLock lock(&replace_channel_mutex_);
+  replacing_channel_endpoints_.erase(endpoint_id);
+  replace_channel_cond_.Notify();
+}
+
+bool ReconnectManager::HasReconnectMetadata(
+    const std::string& endpoint_id) const {
+  MutexLock lock(&metadata_mutex_);
+  return endpoint_id_metadata_map_.contains(endpoint_id);
+}
+
 bool ReconnectManager::BaseMediumImpl::Run() {
   if (!IsMediumRadioOn()) {
     LOG(INFO) << TAG
@@ -369,20 +446,56 @@ bool ReconnectManager::BaseMediumImpl::ReconnectToRemoteDevice() {
                       << " failed.";
     return false;
   }
+  // Mediums raced for the endpoint replace its channel one at a time; the
+  // first one wins, and clears the reconnect metadata of the endpoint.
+  if (!reconnect_manager_.BeginReplaceChannel(endpoint_id_)) {
+    LOG(INFO) << TAG << "Endpoint " << endpoint_id_
+              << " already reconnected over another medium.";
+    QuietlyCloseChannelAndSocket();
+    return false;
+  }
+  absl::Cleanup end_replace_channel = [this]() {
+    reconnect_manager_.EndReplaceChannel(endpoint_id_);
+  };
   LOG(INFO) << TAG << "Write CLIENT_INTRODUCTION frame";
-  Exception write_exception = reconnect_channel_->Write(
-      parser::ForAutoReconnectIntroduction(client_->GetLocalEndpointId()));
+  AutoReconnectFrame::SessionResumption offer =
+      OfferSessionResumption(endpoint_id_);
+  Exception write_exception =
+      reconnect_channel_->Write(parser::ForAutoReconnectIntroduction(
+          client_->GetLocalEndpointId(), offer));
   if (!write_exception.Ok()) {
     LOG(ERROR)
         << TAG << "Failed to write forAutoReconnectClientIntroductionEvent.";
     QuietlyCloseChannelAndSocket();
     return false;
   }
-  if (!ReadClientIntroductionAckFrame(reconnect_channel_.get())) {
+  AutoReconnectFrame::SessionResumption answer;
+  if (!ReadClientIntroductionAckFrame(reconnect_channel_.get(), &answer)) {
     LOG(ERROR) << TAG << "Failed to read ClientIntroductionAck frame.";
     QuietlyCloseChannelAndSocket();
     return false;
   }
+  if (offer.has_nonce() && answer.has_nonce()) {
+    std::optional<std::string> secret =
+        channel_manager_->GetResumptionSecretForEndpoint(endpoint_id_);
+    if (!secret.has_value() ||
+        !SessionResumption::VerifyServerMac(*secret, offer.nonce(),
+                                            answer.nonce(), answer.mac())) {
+      // Don't offer the secret again; the next attempt runs a full handshake.
+      LOG(ERROR) << TAG << "Failed to verify the session resumption of "
+                 << endpoint_id_;
+      channel_manager_->ClearResumptionSecretForEndpoint(endpoint_id_);
+      QuietlyCloseChannelAndSocket();
+      return false;
+    }
+    return ResumeChannelForEndpoint(
+        client_, endpoint_id_, std::move(reconnect_channel_),
+        SessionResumption::CreateRecordLayer(*secret, /*is_client=*/true,
+                                             offer.nonce(), answer.nonce()),
+        SessionResumption::DeriveNextSecret(*secret, offer.nonce(),
+                                            answer.nonce()),
+        nullptr);
+  }
   if (ReplaceChannelForEndpoint(client_, endpoint_id_,
                                 std::move(reconnect_channel_),
                                 SupportEncryptionDisabled(), nullptr)) {
@@ -405,15 +518,24 @@ void ReconnectManager::BaseMediumImpl::OnIncomingConnection(
   LOG(INFO) << TAG << "Received reconnection successfully";
   reconnect_manager_.incoming_connection_cb_executor_.Execute(
       "OnIncomingConnection", [this]() {
+        AutoReconnectFrame::SessionResumption offer;
         auto incoming_endpoint_id =
-            ReadClientIntroductionFrame(reconnect_channel_.get());
+            ReadClientIntroductionFrame(reconnect_channel_.get(), &offer);
         if (incoming_endpoint_id.empty()) {
           LOG(ERROR) << TAG << "read ClientIntroductionFrame failed";
           QuietlyCloseChannelAndSocket();
           return;
         }
+        std::optional<std::string> secret =
+            AcceptSessionResumption(incoming_endpoint_id, offer);
+        AutoReconnectFrame::SessionResumption answer;
+        if (secret.has_value()) {
+          answer.set_nonce(SessionResumption::GenerateNonce());
+          answer.set_mac(SessionResumption::ComputeServerMac(
+              *secret, offer.nonce(), answer.nonce()));
+        }
         Exception write_exception = reconnect_channel_->Write(
-            parser::ForAutoReconnectIntroductionAck());
+            parser::ForAutoReconnectIntroductionAck(answer));
         if (!write_exception.Ok()) {
           LOG(ERROR)
               << TAG
@@ -426,6 +548,16 @@ void ReconnectManager::BaseMediumImpl::OnIncomingConnection(
                       " ClientIntroductionAckFrame with"
             << location::nearby::proto::connections::Medium_Name(medium_)
             << " for the incoming endpointId " << incoming_endpoint_id;
+        if (secret.has_value()) {
+          ResumeChannelForEndpoint(
+              client_, incoming_endpoint_id, std::move(reconnect_channel_),
+              SessionResumption::CreateRecordLayer(
+                  *secret, /*is_client=*/false, offer.nonce(), answer.nonce()),
+              SessionResumption::DeriveNextSecret(*secret, offer.nonce(),
+                                                  answer.nonce()),
+              [this]() { StopListeningForIncomingConnections(); });
+          return;
+        }
         if (ReplaceChannelForEndpoint(
                 client_, incoming_endpoint_id, std::move(reconnect_channel_),
                 SupportEncryptionDisabled(),
@@ -448,7 +580,8 @@ void ReconnectManager::BaseMediumImpl::OnIncomingConnection(
 }
 
 std::string ReconnectManager::BaseMediumImpl::ReadClientIntroductionFrame(
-    EndpointChannel* endpoint_channel) {
+    EndpointChannel* endpoint_channel,
+    AutoReconnectFrame::SessionResumption* session_resumption) {
   LOG(INFO) << TAG << "Read CLIENT_INTRODUCTION frame";
 
   auto timeout = FeatureFlags::GetInstance()
@@ -500,11 +633,13 @@ std::string ReconnectManager::BaseMediumImpl::ReadClientIntroductionFrame(
                        << " instead.";
     return {};
   }
+  *session_resumption = frame.v1().auto_reconnect().session_resumption();
   return frame.v1().auto_reconnect().endpoint_id();
 }
 
 bool ReconnectManager::BaseMediumImpl::ReadClientIntroductionAckFrame(
-    EndpointChannel* endpoint_channel) {
+    EndpointChannel* endpoint_channel,
+    AutoReconnectFrame::SessionResumption* session_resumption) {
   LOG(INFO) << TAG << "Read CLIENT_INTRODUCTION_ACK frame";
 
   auto timeout = FeatureFlags::GetInstance()
@@ -550,22 +685,99 @@ bool ReconnectManager::BaseMediumImpl::ReadClientIntroductionAckFrame(
                        << " instead.";
     return false;
   }
+  *session_resumption = frame.v1().auto_reconnect().session_resumption();
   return true;
 }
 
-bool ReconnectManager::BaseMediumImpl::ReplaceChannelForEndpoint(
+AutoReconnectFrame::SessionResumption
+ReconnectManager::BaseMediumImpl::OfferSessionResumption(
+    const std::string& endpoint_id) {
+  AutoReconnectFrame::SessionResumption offer;
+  if (!FeatureFlags::GetInstance().GetFlags().enable_session_resumption) {
+    return offer;
+  }
+  std::optional<std::string> secret =
+      channel_manager_->GetResumptionSecretForEndpoint(endpoint_id);
+  if (!secret.has_value()) return offer;
+  offer.set_ticket_id(SessionResumption::GetTicketId(*secret));
+  offer.set_nonce(SessionResumption::GenerateNonce());
+  return offer;
+}
+
+std::optional<std::string>
+ReconnectManager::BaseMediumImpl::AcceptSessionResumption(
+    const std::string& endpoint_id,
+    const AutoReconnectFrame::SessionResumption& offer) {
+  if (!FeatureFlags::GetInstance().GetFlags().enable_session_resumption ||
+      offer.nonce().size() != SessionResumption::kNonceLength) {
+    return std::nullopt;
+  }
+  std::optional<std::string> secret =
+      channel_manager_->GetResumptionSecretForEndpoint(endpoint_id);
+  if (!secret.has_value() ||
+      offer.ticket_id() != SessionResumption::GetTicketId(*secret)) {
+    LOG(INFO) << TAG << "Unknown session resumption ticket from "
+              << endpoint_id << ", running a full handshake.";
+    return std::nullopt;
+  }
+  return secret;
+}
+
+bool ReconnectManager::BaseMediumImpl::ResumeChannelForEndpoint(
     ClientProxy* client, const std::string& endpoint_id,
     std::unique_ptr<EndpointChannel> new_channel,
-    bool support_encryption_disabled,
+    std::unique_ptr<AeadRecordLayer> record_layer, std::string next_secret,
     absl::AnyInvocable<void(void)> stop_listening_incoming_connection) {
-  auto& endpoint_id_metadata_map = reconnect_manager_.endpoint_id_metadata_map_;
-  auto reconnect_metadata = endpoint_id_metadata_map.find(endpoint_id);
-  if (reconnect_metadata == endpoint_id_metadata_map.end()) {
+  if (!reconnect_manager_.HasReconnectMetadata(endpoint_id)) {
     LOG(ERROR) << TAG << "ReconnectMetadata is null for endpointId: "
-                       << endpoint_id << " ,please retry!";
+               << endpoint_id << " ,please retry!";
+    new_channel->Close(DisconnectionReason::UNFINISHED);
     return false;
   }
 
+  // Install the record layer before the channel, so that the channel is
+  // encrypted as soon as it is registered.
+  Medium medium = new_channel->GetMedium();
+  if (!channel_manager_->ResumeEncryptionForEndpoint(
+          endpoint_id, std::move(record_layer), std::move(next_secret))) {
+    LOG(ERROR) << TAG << "Failed to resume the encryption of endpointId: "
+               << endpoint_id;
+    new_channel->Close(DisconnectionReason::UNFINISHED);
+    ProcessFailedReconnection(endpoint_id,
+                              std::move(stop_listening_incoming_connection));
+    return false;
+  }
+  channel_manager_->ReplaceChannelForEndpoint(client, endpoint_id,
+                                              std::move(new_channel),
+                                              /*enable_encryption=*/true);
+  LOG(INFO) << TAG << "Resumed the encrypted session of endpointId: "
+            << endpoint_id << " without a UKEY2 handshake.";
+  ProcessSuccessfulReconnection(endpoint_id,
+                                std::move(stop_listening_incoming_connection));
+  client->GetAnalyticsRecorder().OnConnectionEstablished(
+      endpoint_id, medium, client->GetConnectionToken(endpoint_id));
+  return true;
+}
+
+bool ReconnectManager::BaseMediumImpl::ReplaceChannelForEndpoint(
+    ClientProxy* client, const std::string& endpoint_id,
+    std::unique_ptr<EndpointChannel> new_channel,
+    bool support_encryption_disabled,
+    absl::AnyInvocable<void(void)> stop_listening_incoming_connection) {
+  bool is_incoming;
+  {
+    MutexLock lock(&reconnect_manager_.metadata_mutex_);
+    auto& endpoint_id_metadata_map =
+        reconnect_manager_.endpoint_id_metadata_map_;
+    auto reconnect_metadata = endpoint_id_metadata_map.find(endpoint_id);
+    if (reconnect_metadata == endpoint_id_metadata_map.end()) {
+      LOG(ERROR) << TAG << "ReconnectMetadata is null for endpointId: "
+                 << endpoint_id << " ,please retry!";
+      return false;
+    }
+    is_incoming = reconnect_metadata->second.is_incoming;
+  }
+
   EndpointChannel* endpoint_channel =
       reconnect_manager_.new_endpoint_channels_
           .emplace(endpoint_id, std::move(new_channel))
@@ -574,7 +786,7 @@ bool ReconnectManager::BaseMediumImpl::ReplaceChannelForEndpoint(
     MutexLock lock(&mutex_);
     replace_channel_succeed_ = false;
     wait_encryption_to_finish_ = std::make_unique<CountDownLatch>(1);
-    if (reconnect_metadata->second.is_incoming) {
+    if (is_incoming) {
       reconnect_manager_.encryption_runner_.StartServer(
           client, endpoint_id, endpoint_channel, GetResultListener());
     } else {
@@ -722,19 +934,22 @@ void ReconnectManager::BaseMediumImpl::OnEncryptionFailureRunnable(
 void ReconnectManager::BaseMediumImpl::ProcessSuccessfulReconnection(
     const std::string& endpoint_id,
     absl::AnyInvocable<void(void)> stop_listening_incoming_connection) {
-  auto& endpoint_id_metadata_map = reconnect_manager_.endpoint_id_metadata_map_;
-  auto reconnect_metadata = endpoint_id_metadata_map.find(endpoint_id);
-  if (reconnect_metadata == endpoint_id_metadata_map.end()) {
-    LOG(ERROR) << TAG
-                       << "when ProcessSuccessfulReconnection, endpoint_id: "
-                       << endpoint_id
-                       << " is already removed fromendpoint_id_metadata_map.";
-    return;
+  std::optional<ReconnectMetadata> medatdata;
+  {
+    MutexLock lock(&reconnect_manager_.metadata_mutex_);
+    auto& endpoint_id_metadata_map =
+        reconnect_manager_.endpoint_id_metadata_map_;
+    auto reconnect_metadata = endpoint_id_metadata_map.find(endpoint_id);
+    if (reconnect_metadata == endpoint_id_metadata_map.end()) {
+      LOG(ERROR) << TAG << "when ProcessSuccessfulReconnection, endpoint_id: "
+                 << endpoint_id
+                 << " is already removed fromendpoint_id_metadata_map.";
+      return;
+    }
+    medatdata.emplace(std::move(reconnect_metadata->second));
+    endpoint_id_metadata_map.erase(reconnect_metadata);
   }
-
-  auto medatdata = std::move(reconnect_metadata->second);
-  endpoint_id_metadata_map.erase(reconnect_metadata);
-  auto& callback = medatdata.reconnect_cb;
+  auto& callback = medatdata->reconnect_cb;
   if (callback.on_reconnect_success_cb) {
     callback.on_reconnect_success_cb(client_, endpoint_id);
   } else {
@@ -744,8 +959,8 @@ void ReconnectManager::BaseMediumImpl::ProcessSuccessfulReconnection(
                        << " callback.on_reconnect_success_cb is null";
   }
 
-  if (medatdata.is_incoming && stop_listening_incoming_connection) {
-    StopListeningIfAllConnected(medatdata.reconnect_service_id,
+  if (medatdata->is_incoming && stop_listening_incoming_connection) {
+    StopListeningIfAllConnected(medatdata->reconnect_service_id,
                                 std::move(stop_listening_incoming_connection),
                                 /* forceStop= */ false);
   }
@@ -753,24 +968,30 @@ void ReconnectManager::BaseMediumImpl::ProcessSuccessfulReconnection(
 void ReconnectManager::BaseMediumImpl::ProcessFailedReconnection(
     const std::string& endpoint_id,
     absl::AnyInvocable<void(void)> stop_listening_incoming_connection) {
-  auto& endpoint_id_metadata_map = reconnect_manager_.endpoint_id_metadata_map_;
-  auto reconnect_metadata = endpoint_id_metadata_map.find(endpoint_id);
-  if (reconnect_metadata == endpoint_id_metadata_map.end()) {
-    LOG(ERROR) << TAG << "when ProcessFailedReconnection, endpoint_id: "
-                       << endpoint_id
-                       << " is already removed fromendpoint_id_metadata_map.";
-    return;
+  std::optional<ReconnectMetadata> medatdata;
+  {
+    MutexLock lock(&reconnect_manager_.metadata_mutex_);
+    auto& endpoint_id_metadata_map =
+        reconnect_manager_.endpoint_id_metadata_map_;
+    auto reconnect_metadata = endpoint_id_metadata_map.find(endpoint_id);
+    if (reconnect_metadata == endpoint_id_metadata_map.end()) {
+      LOG(ERROR) << TAG << "when ProcessFailedReconnection, endpoint_id: "
+                 << endpoint_id
+                 << " is already removed fromendpoint_id_metadata_map.";
+      return;
+    }
+    medatdata.emplace(std::move(reconnect_metadata->second));
+    if (medatdata->is_incoming) {
+      endpoint_id_metadata_map.erase(reconnect_metadata);
+    }
   }
+  auto& callback = medatdata->reconnect_cb;
 
-  auto medatdata = std::move(reconnect_metadata->second);
-  auto& callback = medatdata.reconnect_cb;
-
-  if (medatdata.is_incoming) {
-    endpoint_id_metadata_map.erase(reconnect_metadata);
+  if (medatdata->is_incoming) {
     if (callback.on_reconnect_failure_cb) {
       callback.on_reconnect_failure_cb(
-          client_, endpoint_id, medatdata.send_disconnection_notification,
-          medatdata.disconnection_reason);
+          client_, endpoint_id, medatdata->send_disconnection_notification,
+          medatdata->disconnection_reason);
     } else {
       LOG(ERROR) << TAG
                          << "when ProcessFailedReconnection, endpoint_id: "
@@ -779,7 +1000,7 @@ void ReconnectManager::BaseMediumImpl::ProcessFailedReconnection(
     }
 
     if (stop_listening_incoming_connection) {
-      StopListeningIfAllConnected(medatdata.reconnect_service_id,
+      StopListeningIfAllConnected(medatdata->reconnect_service_id,
                                   std::move(stop_listening_incoming_connection),
                                   /* forceStop= */ false);
     }
@@ -804,6 +1025,7 @@ void ReconnectManager::BaseMediumImpl::StopListeningIfAllConnected(
 
 bool ReconnectManager::BaseMediumImpl::HasPendingIncomingConnections(
     const std::string& reconnect_service_id) {
+  MutexLock lock(&reconnect_manager_.metadata_mutex_);
   for (auto& item : reconnect_manager_.endpoint_id_metadata_map_) {
     if (item.second.reconnect_service_id == reconnect_service_id &&
         item.second.is_incoming) {
@@ -830,23 +1052,26 @@ void ReconnectManager::BaseMediumImpl::CancelClearHostTimeoutAlarm(
 
 void ReconnectManager::BaseMediumImpl::ClearReconnectData(
     const std::string& service_id, bool is_incoming) {
-  absl::flat_hash_set<std::string> endpoint_ids_pending_removal;
-  auto& metadata_map = reconnect_manager_.endpoint_id_metadata_map_;
-  for (auto item = metadata_map.begin(); item != metadata_map.end();) {
-    if (item->second.reconnect_service_id == service_id && is_incoming) {
-      auto& callback = item->second.reconnect_cb.on_reconnect_failure_cb;
-      if (callback)
-        callback(client_, item->first,
-                 item->second.send_disconnection_notification,
-                 item->second.disconnection_reason);
-      endpoint_ids_pending_removal.insert(item->first);
-    } else {
-      ++item;
+  // The callbacks run without holding metadata_mutex_.
+  std::vector<std::pair<std::string, ReconnectMetadata>> removed_metadata;
+  {
+    MutexLock lock(&reconnect_manager_.metadata_mutex_);
+    auto& metadata_map = reconnect_manager_.endpoint_id_metadata_map_;
+    for (auto item = metadata_map.begin(); item != metadata_map.end();) {
+      if (item->second.reconnect_service_id == service_id && is_incoming) {
+        removed_metadata.emplace_back(item->first, std::move(item->second));
+        metadata_map.erase(item++);
+      } else {
+        ++item;
+      }
     }
   }
 
-  for (const auto& endpoint_id : endpoint_ids_pending_removal) {
-    metadata_map.erase(endpoint_id);
+  for (auto& [endpoint_id, metadata] : removed_metadata) {
+    auto& callback = metadata.reconnect_cb.on_reconnect_failure_cb;
+    if (callback)
+      callback(client_, endpoint_id, metadata.send_disconnection_notification,
+               metadata.disconnection_reason);
   }
 }
 
@@ -16,6 +16,7 @@
 #define CORE_INTERNAL_RECONNECTION_MANAGER_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -24,6 +25,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
+#include "connections/implementation/aead_record_layer.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/encryption_runner.h"
 #include "connections/implementation/endpoint_channel.h"
@@ -34,6 +36,7 @@
 #include "internal/platform/bluetooth_classic.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancelable_alarm.h"
+#include "internal/platform/condition_variable.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/scheduled_executor.h"
@@ -140,8 +143,30 @@ class ReconnectManager {
     bool RehostForIncomingConnections(bool is_last_medium);
     bool ReconnectToRemoteDevice();
 
-    std::string ReadClientIntroductionFrame(EndpointChannel* endpoint_channel);
-    bool ReadClientIntroductionAckFrame(EndpointChannel* endpoint_channel);
+    // The frames' session resumption fields are copied to
+    // |session_resumption|.
+    std::string ReadClientIntroductionFrame(
+        EndpointChannel* endpoint_channel,
+        AutoReconnectFrame::SessionResumption* session_resumption);
+    bool ReadClientIntroductionAckFrame(
+        EndpointChannel* endpoint_channel,
+        AutoReconnectFrame::SessionResumption* session_resumption);
+    // Returns the resumption fields the client introduces itself with, empty
+    // if the encryption of the endpoint can't be resumed.
+    AutoReconnectFrame::SessionResumption OfferSessionResumption(
+        const std::string& endpoint_id);
+    // Returns the resumption secret matching the client's offer, or nullopt
+    // if the server runs a full handshake instead.
+    std::optional<std::string> AcceptSessionResumption(
+        const std::string& endpoint_id,
+        const AutoReconnectFrame::SessionResumption& offer);
+    // Replaces the channel of the endpoint with |new_channel|, and seals its
+    // frames with |record_layer| instead of running a UKEY2 handshake.
+    bool ResumeChannelForEndpoint(
+        ClientProxy* client, const std::string& endpoint_id,
+        std::unique_ptr<EndpointChannel> new_channel,
+        std::unique_ptr<AeadRecordLayer> record_layer, std::string next_secret,
+        absl::AnyInvocable<void(void)> stop_listening_incoming_connection);
     bool ReplaceChannelForEndpoint(
         ClientProxy* client, const std::string& endpoint_id,
         std::unique_ptr<EndpointChannel> new_channel,
@@ -214,6 +239,16 @@ class ReconnectManager {
                           bool is_incoming);
   void Shutdown();
 
+  // Waits until no raced attempt replaces the channel of |endpoint_id|, then
+  // claims the replacement. Returns false if the endpoint reconnected
+  // meanwhile.
+  bool BeginReplaceChannel(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(replace_channel_mutex_);
+  void EndReplaceChannel(const std::string& endpoint_id)
+      ABSL_LOCKS_EXCLUDED(replace_channel_mutex_);
+  bool HasReconnectMetadata(const std::string& endpoint_id) const
+      ABSL_LOCKS_EXCLUDED(metadata_mutex_);
+
   Mediums* mediums_;
   EndpointChannelManager* channel_manager_;
   EncryptionRunner encryption_runner_;
@@ -223,12 +258,20 @@ class ReconnectManager {
   SingleThreadExecutor incoming_connection_cb_executor_;
   SingleThreadExecutor encryption_cb_executor_;
 
+  // The endpoints whose channel a raced reconnect attempt is replacing. The
+  // attempts over the other mediums wait for it on replace_channel_cond_.
+  Mutex replace_channel_mutex_;
+  ConditionVariable replace_channel_cond_{&replace_channel_mutex_};
+  absl::flat_hash_set<std::string> replacing_channel_endpoints_
+      ABSL_GUARDED_BY(replace_channel_mutex_);
   mutable RecursiveMutex mutex_;
   absl::flat_hash_map<std::string, std::unique_ptr<CancelableAlarm>>
       listen_timeout_alarm_by_service_id_ ABSL_GUARDED_BY(mutex_);
   absl::flat_hash_map<std::string, std::unique_ptr<EndpointChannel>>
       new_endpoint_channels_;
-  absl::flat_hash_map<std::string, ReconnectMetadata> endpoint_id_metadata_map_;
+  mutable Mutex metadata_mutex_;
+  absl::flat_hash_map<std::string, ReconnectMetadata> endpoint_id_metadata_map_
+      ABSL_GUARDED_BY(metadata_mutex_);
   absl::flat_hash_set<std::string> resumed_endpoints_;
 };
 
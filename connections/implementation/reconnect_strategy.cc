@@ -0,0 +1,79 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/reconnect_strategy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/random/random.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/multi_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+
+ReconnectStrategy::ReconnectStrategy(Options options) : options_(options) {}
+
+std::vector<ReconnectStrategy::Medium> ReconnectStrategy::GetCandidateMediums(
+    Medium lost_medium, absl::Span<const Medium> mediums_by_priority) const {
+  std::vector<Medium> candidates = {lost_medium};
+  auto it = std::find(mediums_by_priority.begin(), mediums_by_priority.end(),
+                      lost_medium);
+  if (it == mediums_by_priority.end()) return candidates;
+  for (++it; it != mediums_by_priority.end() &&
+             candidates.size() < options_.max_racing_mediums;
+       ++it) {
+    candidates.push_back(*it);
+  }
+  return candidates;
+}
+
+absl::Duration ReconnectStrategy::GetBackoffDelay(int round) {
+  absl::Duration delay =
+      options_.initial_delay * std::pow(options_.multiplier, round);
+  delay = std::min(delay, options_.max_delay);
+  double jitter = std::clamp(options_.jitter, 0.0, 1.0);
+  if (jitter > 0) {
+    delay -= delay * absl::Uniform(bit_gen_, 0.0, jitter);
+  }
+  return delay;
+}
+
+bool ReconnectStrategy::Race(const std::vector<Medium>& mediums,
+                             absl::AnyInvocable<bool(Medium)> attempt) {
+  if (mediums.empty()) return false;
+  if (mediums.size() == 1) return attempt(mediums.front());
+
+  std::atomic<bool> succeeded = false;
+  CountDownLatch latch(mediums.size());
+  MultiThreadExecutor executor(mediums.size());
+  for (Medium medium : mediums) {
+    executor.Execute("reconnect-race",
+                     [&attempt, &succeeded, &latch, medium]() {
+                       if (attempt(medium)) succeeded = true;
+                       latch.CountDown();
+                     });
+  }
+  latch.Await();
+  return succeeded;
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,80 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_RECONNECT_STRATEGY_H_
+#define CORE_INTERNAL_RECONNECT_STRATEGY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/random/random.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "proto/connections_enums.pb.h"
+
+namespace nearby {
+namespace connections {
+
+// Decides how ReconnectManager retries a dropped connection: which mediums it
+// tries at once, and how long it waits between rounds of attempts.
+//
+// Every round races the medium that dropped against the mediums ranked below
+// it, so that a connection lost over WiFi comes back over Bluetooth as soon
+// as possible, instead of after the WiFi attempts ran out. The wait after
+// every failed round grows exponentially up to a maximum, and is shortened by
+// a random fraction so that the devices around don't retry in lockstep.
+class ReconnectStrategy {
+ public:
+  using Medium = ::location::nearby::proto::connections::Medium;
+
+  struct Options {
+    // Wait after the first failed round.
+    absl::Duration initial_delay;
+    // Upper bound of the wait after any round.
+    absl::Duration max_delay;
+    // Growth of the wait after every failed round; 1 keeps it constant.
+    double multiplier = 1.0;
+    // At most this fraction of every wait is cut at random, in [0, 1].
+    double jitter = 0.0;
+    // Maximum number of mediums raced in a round, including the one that
+    // dropped.
+    std::uint32_t max_racing_mediums = 1;
+  };
+
+  explicit ReconnectStrategy(Options options);
+
+  // Returns the mediums to race after a connection dropped over
+  // |lost_medium|: the lost medium first, then the mediums ranked below it in
+  // |mediums_by_priority|, most preferred first.
+  std::vector<Medium> GetCandidateMediums(
+      Medium lost_medium, absl::Span<const Medium> mediums_by_priority) const;
+
+  // Returns the wait after the failed round |round|, counted from 0.
+  absl::Duration GetBackoffDelay(int round);
+
+  // Runs |attempt| for all |mediums| at once, from as many threads, and
+  // returns true if any of them succeeded. Returns once all attempts are done.
+  static bool Race(const std::vector<Medium>& mediums,
+                   absl::AnyInvocable<bool(Medium)> attempt);
+
+ private:
+  const Options options_;
+  absl::BitGen bit_gen_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_RECONNECT_STRATEGY_H_
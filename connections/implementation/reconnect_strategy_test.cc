@@ -0,0 +1,121 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/reconnect_strategy.h"
+
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+using ::location::nearby::proto::connections::Medium;
+using ::testing::ElementsAre;
+
+constexpr Medium kMediumsByPriority[] = {Medium::WIFI_LAN, Medium::WEB_RTC,
+                                         Medium::BLUETOOTH, Medium::BLE};
+
+ReconnectStrategy::Options MakeOptions() {
+  return {
+      .initial_delay = absl::Seconds(1),
+      .max_delay = absl::Seconds(10),
+  };
+}
+
+TEST(ReconnectStrategyTest, OnlyRetriesTheLostMediumByDefault) {
+  ReconnectStrategy strategy(MakeOptions());
+
+  EXPECT_THAT(strategy.GetCandidateMediums(Medium::WIFI_LAN,
+                                           kMediumsByPriority),
+              ElementsAre(Medium::WIFI_LAN));
+}
+
+TEST(ReconnectStrategyTest, RacesTheMediumsRankedBelowTheLostOne) {
+  ReconnectStrategy::Options options = MakeOptions();
+  options.max_racing_mediums = 3;
+  ReconnectStrategy strategy(options);
+
+  EXPECT_THAT(strategy.GetCandidateMediums(Medium::WIFI_LAN,
+                                           kMediumsByPriority),
+              ElementsAre(Medium::WIFI_LAN, Medium::WEB_RTC,
+                          Medium::BLUETOOTH));
+  EXPECT_THAT(strategy.GetCandidateMediums(Medium::BLUETOOTH,
+                                           kMediumsByPriority),
+              ElementsAre(Medium::BLUETOOTH, Medium::BLE));
+  EXPECT_THAT(
+      strategy.GetCandidateMediums(Medium::WIFI_HOTSPOT, kMediumsByPriority),
+      ElementsAre(Medium::WIFI_HOTSPOT));
+}
+
+TEST(ReconnectStrategyTest, ConstantDelayByDefault) {
+  ReconnectStrategy strategy(MakeOptions());
+
+  EXPECT_EQ(strategy.GetBackoffDelay(0), absl::Seconds(1));
+  EXPECT_EQ(strategy.GetBackoffDelay(3), absl::Seconds(1));
+}
+
+TEST(ReconnectStrategyTest, DelayGrowsUpToTheMaximum) {
+  ReconnectStrategy::Options options = MakeOptions();
+  options.multiplier = 2;
+  ReconnectStrategy strategy(options);
+
+  EXPECT_EQ(strategy.GetBackoffDelay(0), absl::Seconds(1));
+  EXPECT_EQ(strategy.GetBackoffDelay(1), absl::Seconds(2));
+  EXPECT_EQ(strategy.GetBackoffDelay(3), absl::Seconds(8));
+  EXPECT_EQ(strategy.GetBackoffDelay(4), absl::Seconds(10));
+}
+
+TEST(ReconnectStrategyTest, JitterShortensTheDelay) {
+  ReconnectStrategy::Options options = MakeOptions();
+  options.multiplier = 2;
+  options.jitter = 0.5;
+  ReconnectStrategy strategy(options);
+
+  for (int i = 0; i < 100; i++) {
+    absl::Duration delay = strategy.GetBackoffDelay(2);
+    EXPECT_GT(delay, absl::Seconds(2));
+    EXPECT_LE(delay, absl::Seconds(4));
+  }
+}
+
+TEST(ReconnectStrategyTest, RaceRunsTheAttemptsAtOnce) {
+  // Every attempt waits for the others to start, so the race only ends if
+  // they run in parallel.
+  CountDownLatch started(3);
+  std::vector<Medium> mediums = {Medium::WIFI_LAN, Medium::BLUETOOTH,
+                                 Medium::BLE};
+
+  EXPECT_TRUE(ReconnectStrategy::Race(mediums, [&started](Medium medium) {
+    started.CountDown();
+    started.Await();
+    return medium == Medium::BLUETOOTH;
+  }));
+}
+
+TEST(ReconnectStrategyTest, RaceFailsWhenEveryAttemptFails) {
+  std::vector<Medium> mediums = {Medium::WIFI_LAN, Medium::BLUETOOTH};
+
+  EXPECT_FALSE(
+      ReconnectStrategy::Race(mediums, [](Medium medium) { return false; }));
+  EXPECT_FALSE(ReconnectStrategy::Race({}, [](Medium medium) { return true; }));
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -16,11 +16,13 @@
 #define CORE_INTERNAL_SERVICE_CONTROLLER_H_
 
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "connections/advertising_options.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/listeners.h"
 #include "connections/out_of_band_connection_metadata.h"
@@ -116,6 +118,15 @@ class ServiceController {
   virtual void DisconnectFromEndpoint(ClientProxy* client,
                                       const std::string& endpoint_id) = 0;
 
+  // Disconnects from all of |endpoint_ids|, e.g. when the client stops all
+  // endpoints.
+  virtual void DisconnectFromEndpoints(
+      ClientProxy* client, const std::vector<std::string>& endpoint_ids) {
+    for (const std::string& endpoint_id : endpoint_ids) {
+      DisconnectFromEndpoint(client, endpoint_id);
+    }
+  }
+
   virtual Status UpdateAdvertisingOptions(
       ClientProxy* client, absl::string_view service_id,
       const AdvertisingOptions& advertising_options) = 0;
@@ -126,6 +137,10 @@ class ServiceController {
 
   virtual void SetCustomSavePath(ClientProxy* client,
                                  const std::string& path) = 0;
+
+  // Returns nothing if `endpoint_id` has no channel.
+  virtual std::optional<EndpointStats> GetEndpointStats(
+      ClientProxy* client, const std::string& endpoint_id) = 0;
 };
 
 }  // namespace connections
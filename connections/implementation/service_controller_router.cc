@@ -15,11 +15,15 @@
 #include "connections/implementation/service_controller_router.h"
 
 #include <cstddef>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "connections/discovery_options.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
 #include "connections/implementation/offline_service_controller.h"
@@ -33,6 +37,7 @@
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
 
 // TODO(b/285657711): Add tests for uncovered logic, even if trivial.
 namespace nearby {
@@ -110,10 +115,16 @@ ServiceControllerRouter::ServiceControllerRouter(bool enable_ble_v2)
 ServiceControllerRouter::~ServiceControllerRouter() {
   NEARBY_LOGS(INFO) << "ServiceControllerRouter going down.";
 
-  if (service_controller_) {
-    service_controller_->Stop();
+  ServiceController* service_controller;
+  {
+    MutexLock lock(&service_controller_mutex_);
+    service_controller = service_controller_.get();
+  }
+  if (service_controller) {
+    service_controller->Stop();
   }
   // And make sure that cleanup is the last thing we do.
+  client_executor_.Shutdown();
   serializer_.Shutdown();
 }
 
@@ -122,7 +133,7 @@ void ServiceControllerRouter::StartAdvertising(
     const AdvertisingOptions& advertising_options,
     const ConnectionRequestInfo& info, ResultCallback callback) {
   RouteToServiceController(
-      "scr-start-advertising",
+      "scr-start-advertising", client, RouteScope::kRadios,
       [this, client, service_id = std::string(service_id), advertising_options,
        info, callback = std::move(callback)]() mutable {
         if (client->IsAdvertising()) {
@@ -138,7 +149,7 @@ void ServiceControllerRouter::StartAdvertising(
 void ServiceControllerRouter::StopAdvertising(ClientProxy* client,
                                               ResultCallback callback) {
   RouteToServiceController(
-      "scr-stop-advertising",
+      "scr-stop-advertising", client, RouteScope::kRadios,
       [this, client, callback = std::move(callback)]() mutable {
         if (client->IsAdvertising()) {
           GetServiceController()->StopAdvertising(client);
@@ -152,7 +163,7 @@ void ServiceControllerRouter::StartDiscovery(
     const DiscoveryOptions& discovery_options, DiscoveryListener listener,
     ResultCallback callback) {
   RouteToServiceController(
-      "scr-start-discovery",
+      "scr-start-discovery", client, RouteScope::kRadios,
       [this, client, service_id = std::string(service_id), discovery_options,
        listener = std::move(listener),
        callback = std::move(callback)]() mutable {
@@ -169,7 +180,7 @@ void ServiceControllerRouter::StartDiscovery(
 void ServiceControllerRouter::StopDiscovery(ClientProxy* client,
                                             ResultCallback callback) {
   RouteToServiceController(
-      "scr-stop-discovery",
+      "scr-stop-discovery", client, RouteScope::kRadios,
       [this, client, callback = std::move(callback)]() mutable {
         if (client->IsDiscovering()) {
           GetServiceController()->StopDiscovery(client);
@@ -182,7 +193,7 @@ void ServiceControllerRouter::InjectEndpoint(
     ClientProxy* client, absl::string_view service_id,
     const OutOfBandConnectionMetadata& metadata, ResultCallback callback) {
   RouteToServiceController(
-      "scr-inject-endpoint",
+      "scr-inject-endpoint", client, RouteScope::kRadios,
       [this, client, service_id = std::string(service_id), metadata,
        callback = std::move(callback)]() mutable {
         // Currently, Bluetooth is the only supported medium for endpoint
@@ -223,7 +234,7 @@ void ServiceControllerRouter::RequestConnection(
   client->AddCancellationFlag(std::string(endpoint_id));
 
   RouteToServiceController(
-      "scr-request-connection",
+      "scr-request-connection", client, RouteScope::kRadios,
       [this, client, endpoint_id = std::string(endpoint_id), info,
        connection_options, callback = std::move(callback)]() mutable {
         if (client->HasPendingConnectionToEndpoint(endpoint_id) ||
@@ -246,27 +257,12 @@ void ServiceControllerRouter::AcceptConnection(ClientProxy* client,
                                                PayloadListener listener,
                                                ResultCallback callback) {
   RouteToServiceController(
-      "scr-accept-connection",
+      "scr-accept-connection", client, RouteScope::kClient,
       [this, client, endpoint_id = std::string(endpoint_id),
        listener = std::move(listener),
        callback = std::move(callback)]() mutable {
-        if (client->IsConnectedToEndpoint(endpoint_id)) {
-          callback({Status::kAlreadyConnectedToEndpoint});
-          return;
-        }
-
-        if (client->HasLocalEndpointResponded(endpoint_id)) {
-          NEARBY_LOGS(WARNING)
-              << "Client " << client->GetClientId()
-              << " invoked acceptConnectionRequest() after having already "
-                 "accepted/rejected the connection to endpoint(id="
-              << endpoint_id << ")";
-          callback({Status::kOutOfOrderApiCall});
-          return;
-        }
-
-        callback(GetServiceController()->AcceptConnection(client, endpoint_id,
-                                                          std::move(listener)));
+        callback(AcceptConnectionOnServiceController(client, endpoint_id,
+                                                     std::move(listener)));
       });
 }
 
@@ -276,7 +272,7 @@ void ServiceControllerRouter::RejectConnection(ClientProxy* client,
   client->CancelEndpoint(std::string(endpoint_id));
 
   RouteToServiceController(
-      "scr-reject-connection",
+      "scr-reject-connection", client, RouteScope::kClient,
       [this, client, endpoint_id = std::string(endpoint_id),
        callback = std::move(callback)]() mutable {
         if (client->IsConnectedToEndpoint(endpoint_id)) {
@@ -302,8 +298,9 @@ void ServiceControllerRouter::InitiateBandwidthUpgrade(
     ClientProxy* client, absl::string_view endpoint_id,
     ResultCallback callback) {
   RouteToServiceController(
-      "scr-init-bwu", [this, client, endpoint_id = std::string(endpoint_id),
-                       callback = std::move(callback)]() mutable {
+      "scr-init-bwu", client, RouteScope::kRadios,
+      [this, client, endpoint_id = std::string(endpoint_id),
+       callback = std::move(callback)]() mutable {
         if (!client->IsConnectedToEndpoint(endpoint_id)) {
           callback({Status::kOutOfOrderApiCall});
           return;
@@ -324,7 +321,7 @@ void ServiceControllerRouter::SendPayload(
       std::vector<std::string>(endpoint_ids.begin(), endpoint_ids.end());
 
   RouteToServiceController(
-      "scr-send-payload",
+      "scr-send-payload", client, RouteScope::kClient,
       [this, client, payload = std::move(payload), endpoints,
        callback = std::move(callback)]() mutable {
         if (!ClientHasConnectionToAtLeastOneEndpoint(client, endpoints)) {
@@ -347,7 +344,7 @@ void ServiceControllerRouter::CancelPayload(ClientProxy* client,
                                             std::uint64_t payload_id,
                                             ResultCallback callback) {
   RouteToServiceController(
-      "scr-cancel-payload",
+      "scr-cancel-payload", client, RouteScope::kClient,
       [this, client, payload_id, callback = std::move(callback)]() mutable {
         callback(GetServiceController()->CancelPayload(client, payload_id));
       });
@@ -361,7 +358,7 @@ void ServiceControllerRouter::DisconnectFromEndpoint(
   client->CancelEndpoint(std::string(endpoint_id));
 
   RouteToServiceController(
-      "scr-disconnect-endpoint",
+      "scr-disconnect-endpoint", client, RouteScope::kClient,
       [this, client, endpoint_id = std::string(endpoint_id),
        callback = std::move(callback)]() mutable {
         if (!client->IsConnectedToEndpoint(endpoint_id) &&
@@ -381,7 +378,8 @@ void ServiceControllerRouter::StartListeningForIncomingConnectionsV3(
     const v3::ConnectionListeningOptions& options,
     v3::ListeningResultListener callback) {
   RouteToServiceController(
-      "scr-start-listening-for-incoming-connections",
+      "scr-start-listening-for-incoming-connections", client,
+      RouteScope::kRadios,
       [this, client, callback = std::move(callback), service_id,
        listener = std::move(listener), options]() mutable {
         if (client->IsListeningForIncomingConnections()) {
@@ -406,7 +404,8 @@ void ServiceControllerRouter::StartListeningForIncomingConnectionsV3(
 void ServiceControllerRouter::StopListeningForIncomingConnectionsV3(
     ClientProxy* client) {
   RouteToServiceController(
-      "scr-stop-listening-for-incoming-connections", [this, client]() {
+      "scr-stop-listening-for-incoming-connections", client,
+      RouteScope::kRadios, [this, client]() {
         if (!client->IsListeningForIncomingConnections()) {
           return;
         }
@@ -423,7 +422,7 @@ void ServiceControllerRouter::RequestConnectionV3(
   client->AddCancellationFlag(remote_device.GetEndpointId());
 
   RouteToServiceController(
-      "scr-request-connection-v3",
+      "scr-request-connection-v3", client, RouteScope::kRadios,
       [this, client, &remote_device, v3_info = std::move(info),
        connection_options, callback = std::move(callback)]() mutable {
         std::string endpoint_id = remote_device.GetEndpointId();
@@ -510,25 +509,10 @@ void ServiceControllerRouter::AcceptConnectionV3(
     ClientProxy* client, const NearbyDevice& remote_device,
     v3::PayloadListener listener, ResultCallback callback) {
   RouteToServiceController(
-      "scr-accept-connection",
+      "scr-accept-connection", client, RouteScope::kClient,
       [this, client, endpoint_id = remote_device.GetEndpointId(),
        v3_listener = std::move(listener),
        callback = std::move(callback)]() mutable {
-        if (client->IsConnectedToEndpoint(endpoint_id)) {
-          callback({Status::kAlreadyConnectedToEndpoint});
-          return;
-        }
-
-        if (client->HasLocalEndpointResponded(endpoint_id)) {
-          NEARBY_LOGS(WARNING)
-              << "Client " << client->GetClientId()
-              << " invoked acceptConnectionRequest() after having already "
-                 "accepted/rejected the connection to endpoint(id="
-              << endpoint_id << ")";
-          callback({Status::kOutOfOrderApiCall});
-          return;
-        }
-
         PayloadListener old_listener = {
             .payload_cb =
                 [v3_received = std::move(v3_listener.payload_received_cb)](
@@ -543,8 +527,45 @@ void ServiceControllerRouter::AcceptConnectionV3(
                   v3_cb(v3::ConnectionsDevice(endpoint_id, "", {}), info);
                 }};
 
-        callback(GetServiceController()->AcceptConnection(
-            client, endpoint_id, std::move(old_listener)));
+        callback(AcceptConnectionOnServiceController(client, endpoint_id,
+                                                     std::move(old_listener)));
+      });
+}
+
+void ServiceControllerRouter::AcceptConnectionsV3(
+    ClientProxy* client, absl::Span<const NearbyDevice* const> remote_devices,
+    v3::PayloadListener listener, v3::DeviceResultCallback callback) {
+  std::vector<std::string> endpoint_ids;
+  endpoint_ids.reserve(remote_devices.size());
+  for (const NearbyDevice* remote_device : remote_devices) {
+    endpoint_ids.push_back(remote_device->GetEndpointId());
+  }
+
+  RouteToServiceController(
+      "scr-accept-connections", client, RouteScope::kClient,
+      [this, client, endpoint_ids = std::move(endpoint_ids),
+       v3_listener =
+           std::make_shared<v3::PayloadListener>(std::move(listener)),
+       callback = std::move(callback)]() mutable {
+        for (const std::string& endpoint_id : endpoint_ids) {
+          PayloadListener old_listener = {
+              .payload_cb =
+                  [v3_listener](absl::string_view endpoint_id,
+                                Payload payload) {
+                    v3_listener->payload_received_cb(
+                        v3::ConnectionsDevice(endpoint_id, "", {}),
+                        std::move(payload));
+                  },
+              .payload_progress_cb =
+                  [v3_listener](absl::string_view endpoint_id,
+                                const PayloadProgressInfo& info) {
+                    v3_listener->payload_progress_cb(
+                        v3::ConnectionsDevice(endpoint_id, "", {}), info);
+                  }};
+          callback(v3::ConnectionsDevice(endpoint_id, "", {}),
+                   AcceptConnectionOnServiceController(
+                       client, endpoint_id, std::move(old_listener)));
+        }
       });
 }
 
@@ -554,7 +575,7 @@ void ServiceControllerRouter::RejectConnectionV3(
   client->CancelEndpoint(remote_device.GetEndpointId());
 
   RouteToServiceController(
-      "scr-reject-connection",
+      "scr-reject-connection", client, RouteScope::kClient,
       [this, client, endpoint_id = remote_device.GetEndpointId(),
        callback = std::move(callback)]() mutable {
         if (client->IsConnectedToEndpoint(endpoint_id)) {
@@ -580,7 +601,7 @@ void ServiceControllerRouter::InitiateBandwidthUpgradeV3(
     ClientProxy* client, const NearbyDevice& remote_device,
     ResultCallback callback) {
   RouteToServiceController(
-      "scr-init-bwu",
+      "scr-init-bwu", client, RouteScope::kRadios,
       [this, client, endpoint_id = remote_device.GetEndpointId(),
        callback = std::move(callback)]() mutable {
         if (!client->IsConnectedToEndpoint(endpoint_id)) {
@@ -600,9 +621,10 @@ void ServiceControllerRouter::SendPayloadV3(
     ClientProxy* client, const NearbyDevice& recipient_device, Payload payload,
     ResultCallback callback) {
   RouteToServiceController(
-      "scr-send-payload", [this, client, payload = std::move(payload),
-                           endpoint_id = recipient_device.GetEndpointId(),
-                           callback = std::move(callback)]() mutable {
+      "scr-send-payload", client, RouteScope::kClient,
+      [this, client, payload = std::move(payload),
+       endpoint_id = recipient_device.GetEndpointId(),
+       callback = std::move(callback)]() mutable {
         if (!client->IsConnectedToEndpoint(endpoint_id)) {
           callback({Status::kEndpointUnknown});
           return;
@@ -619,11 +641,26 @@ void ServiceControllerRouter::SendPayloadV3(
       });
 }
 
+void ServiceControllerRouter::SendPayloadToManyV3(
+    ClientProxy* client,
+    absl::Span<const NearbyDevice* const> recipient_devices, Payload payload,
+    ResultCallback callback) {
+  std::vector<std::string> endpoint_ids;
+  endpoint_ids.reserve(recipient_devices.size());
+  for (const NearbyDevice* recipient_device : recipient_devices) {
+    endpoint_ids.push_back(recipient_device->GetEndpointId());
+  }
+
+  // Queued once for all the devices, so the payload is read once and its
+  // chunks are written to each of them in turn.
+  SendPayload(client, endpoint_ids, std::move(payload), std::move(callback));
+}
+
 void ServiceControllerRouter::CancelPayloadV3(
     ClientProxy* client, const NearbyDevice& recipient_device,
     uint64_t payload_id, ResultCallback callback) {
   RouteToServiceController(
-      "scr-cancel-payload",
+      "scr-cancel-payload", client, RouteScope::kClient,
       [this, client, payload_id, callback = std::move(callback)]() mutable {
         callback(GetServiceController()->CancelPayload(client, payload_id));
       });
@@ -637,7 +674,7 @@ void ServiceControllerRouter::DisconnectFromDeviceV3(
   client->CancelEndpoint(remote_device.GetEndpointId());
 
   RouteToServiceController(
-      "scr-disconnect-endpoint",
+      "scr-disconnect-endpoint", client, RouteScope::kClient,
       [this, client, endpoint_id = remote_device.GetEndpointId(),
        callback = std::move(callback)]() mutable {
         if (!client->IsConnectedToEndpoint(endpoint_id) &&
@@ -655,7 +692,7 @@ void ServiceControllerRouter::UpdateAdvertisingOptionsV3(
     ClientProxy* client, absl::string_view service_id,
     const AdvertisingOptions& options, ResultCallback callback) {
   RouteToServiceController(
-      "scr-update-advertising-options",
+      "scr-update-advertising-options", client, RouteScope::kRadios,
       [this, client, options, callback = std::move(callback),
        service_id]() mutable {
         callback(GetServiceController()->UpdateAdvertisingOptions(
@@ -667,7 +704,7 @@ void ServiceControllerRouter::UpdateDiscoveryOptionsV3(
     ClientProxy* client, absl::string_view service_id,
     const DiscoveryOptions& options, ResultCallback callback) {
   RouteToServiceController(
-      "scr-update-discovery-options",
+      "scr-update-discovery-options", client, RouteScope::kRadios,
       [this, client, options, callback = std::move(callback),
        service_id]() mutable {
         callback(GetServiceController()->UpdateDiscoveryOptions(
@@ -682,7 +719,7 @@ void ServiceControllerRouter::StopAllEndpoints(ClientProxy* client,
   client->CancelAllEndpoints();
 
   RouteToServiceController(
-      "scr-stop-all-endpoints",
+      "scr-stop-all-endpoints", client, RouteScope::kRadios,
       [this, client, callback = std::move(callback)]() mutable {
         NEARBY_LOGS(INFO) << "Client " << client->GetClientId()
                           << " has requested us to stop all endpoints. We will "
@@ -696,8 +733,9 @@ void ServiceControllerRouter::SetCustomSavePath(ClientProxy* client,
                                                 absl::string_view path,
                                                 ResultCallback callback) {
   RouteToServiceController(
-      "scr-set-custom-save-path", [this, client, path = std::string(path),
-                                   callback = std::move(callback)]() mutable {
+      "scr-set-custom-save-path", client, RouteScope::kClient,
+      [this, client, path = std::string(path),
+       callback = std::move(callback)]() mutable {
         NEARBY_LOGS(INFO) << "Client " << client->GetClientId()
                           << " has requested us to set custom save path to "
                           << path;
@@ -706,27 +744,70 @@ void ServiceControllerRouter::SetCustomSavePath(ClientProxy* client,
       });
 }
 
+void ServiceControllerRouter::GetEndpointStats(ClientProxy* client,
+                                               absl::string_view endpoint_id,
+                                               EndpointStatsCallback callback) {
+  RouteToServiceController(
+      "scr-get-endpoint-stats", client, RouteScope::kClient,
+      [this, client, endpoint_id = std::string(endpoint_id),
+       callback = std::move(callback)]() mutable {
+        if (!client->IsConnectedToEndpoint(endpoint_id)) {
+          callback({Status::kEndpointUnknown}, {});
+          return;
+        }
+
+        std::optional<EndpointStats> stats =
+            GetServiceController()->GetEndpointStats(client, endpoint_id);
+        if (!stats.has_value()) {
+          callback({Status::kEndpointUnknown}, {});
+          return;
+        }
+        callback({Status::kSuccess}, *stats);
+      });
+}
+
 void ServiceControllerRouter::SetServiceControllerForTesting(
     std::unique_ptr<ServiceController> service_controller) {
+  MutexLock lock(&service_controller_mutex_);
   service_controller_ = std::move(service_controller);
 }
 
 ServiceController* ServiceControllerRouter::GetServiceController() {
+  MutexLock lock(&service_controller_mutex_);
   if (!service_controller_) {
     service_controller_ = std::make_unique<OfflineServiceController>();
   }
   return service_controller_.get();
 }
 
-void ServiceControllerRouter::FinishClientSession(ClientProxy* client) {
-  // Disconnect from all the connected endpoints tied to this clientProxy.
-  for (auto& endpoint_id : client->GetPendingConnectedEndpoints()) {
-    GetServiceController()->DisconnectFromEndpoint(client, endpoint_id);
+Status ServiceControllerRouter::AcceptConnectionOnServiceController(
+    ClientProxy* client, const std::string& endpoint_id,
+    PayloadListener listener) {
+  if (client->IsConnectedToEndpoint(endpoint_id)) {
+    return {Status::kAlreadyConnectedToEndpoint};
+  }
+
+  if (client->HasLocalEndpointResponded(endpoint_id)) {
+    NEARBY_LOGS(WARNING)
+        << "Client " << client->GetClientId()
+        << " invoked acceptConnectionRequest() after having already "
+           "accepted/rejected the connection to endpoint(id="
+        << endpoint_id << ")";
+    return {Status::kOutOfOrderApiCall};
   }
 
+  return GetServiceController()->AcceptConnection(client, endpoint_id,
+                                                  std::move(listener));
+}
+
+void ServiceControllerRouter::FinishClientSession(ClientProxy* client) {
+  // Disconnect from all the connected endpoints tied to this clientProxy.
+  std::vector<std::string> endpoint_ids =
+      client->GetPendingConnectedEndpoints();
   for (auto& endpoint_id : client->GetConnectedEndpoints()) {
-    GetServiceController()->DisconnectFromEndpoint(client, endpoint_id);
+    endpoint_ids.push_back(endpoint_id);
   }
+  GetServiceController()->DisconnectFromEndpoints(client, endpoint_ids);
 
   // Stop any advertising and discovery that may be underway due to this client.
   GetServiceController()->StopAdvertising(client);
@@ -738,8 +819,42 @@ void ServiceControllerRouter::FinishClientSession(ClientProxy* client) {
 }
 
 void ServiceControllerRouter::RouteToServiceController(const std::string& name,
+                                                       ClientProxy* client,
+                                                       RouteScope scope,
                                                        Runnable runnable) {
-  serializer_.Execute(name, std::move(runnable));
+  MutexLock lock(&mutex_);
+  std::deque<RoutedTask>& tasks = client_tasks_[client];
+  tasks.push_back({name, scope, std::move(runnable)});
+  // Otherwise, it runs once the client's earlier tasks are done.
+  if (tasks.size() == 1) ExecuteNextTask(client);
+}
+
+void ServiceControllerRouter::ExecuteNextTask(ClientProxy* client) {
+  const RoutedTask& task = client_tasks_[client].front();
+  Runnable run = [this, client]() { RunNextTask(client); };
+  if (task.scope == RouteScope::kRadios) {
+    serializer_.Execute(task.name, std::move(run));
+  } else {
+    client_executor_.Execute(task.name, std::move(run));
+  }
+}
+
+void ServiceControllerRouter::RunNextTask(ClientProxy* client) {
+  Runnable runnable;
+  {
+    MutexLock lock(&mutex_);
+    runnable = std::move(client_tasks_[client].front().runnable);
+  }
+  runnable();
+
+  MutexLock lock(&mutex_);
+  auto it = client_tasks_.find(client);
+  it->second.pop_front();
+  if (it->second.empty()) {
+    client_tasks_.erase(it);
+  } else {
+    ExecuteNextTask(client);
+  }
 }
 
 }  // namespace connections
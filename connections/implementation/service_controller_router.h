@@ -15,13 +15,17 @@
 #ifndef CORE_INTERNAL_SERVICE_CONTROLLER_ROUTER_H_
 #define CORE_INTERNAL_SERVICE_CONTROLLER_ROUTER_H_
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
+#include "connections/endpoint_stats.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/service_controller.h"
 #include "connections/listeners.h"
@@ -31,6 +35,8 @@
 #include "connections/v3/listening_result.h"
 #include "connections/v3/params.h"
 #include "internal/interop/device.h"
+#include "internal/platform/multi_thread_executor.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/single_thread_executor.h"
 
@@ -51,8 +57,11 @@ namespace connections {
 //
 // Every activity is handled the same way:
 // 1) all the arguments to the call are captured by value;
-// 2) the actual processing is scheduled on a private single-threaded executor,
-//    which makes locking unnecessary, when internal data is being manipulated.
+// 2) the actual processing is scheduled after the earlier activities of the
+//    same client, so each client's activities run one at a time and in order.
+//    Activities that touch the radios shared by all clients (advertising,
+//    discovery, connecting, bandwidth upgrades) also run one at a time across
+//    clients; the others run in parallel with those of other clients.
 // 3) activity handlers are delegating much of their work to an implementation
 //    of a ServiceController interface, which does the actual job.
 class ServiceControllerRouter {
@@ -136,6 +145,12 @@ class ServiceControllerRouter {
                                   v3::PayloadListener listener,
                                   ResultCallback callback);
 
+  // Accepts the connections to all of |remote_devices| in one task of the
+  // router, with |listener| shared by all of them.
+  virtual void AcceptConnectionsV3(
+      ClientProxy* client, absl::Span<const NearbyDevice* const> remote_devices,
+      v3::PayloadListener listener, v3::DeviceResultCallback callback);
+
   virtual void RejectConnectionV3(ClientProxy* client,
                                   const NearbyDevice& remote_device,
                                   ResultCallback callback);
@@ -148,6 +163,12 @@ class ServiceControllerRouter {
                              const NearbyDevice& recipient_device,
                              Payload payload, ResultCallback callback);
 
+  // Sends |payload| to all of |recipient_devices| at once, like SendPayload().
+  virtual void SendPayloadToManyV3(
+      ClientProxy* client,
+      absl::Span<const NearbyDevice* const> recipient_devices, Payload payload,
+      ResultCallback callback);
+
   virtual void CancelPayloadV3(ClientProxy* client,
                                const NearbyDevice& recipient_device,
                                std::uint64_t payload_id,
@@ -171,18 +192,65 @@ class ServiceControllerRouter {
   virtual void SetCustomSavePath(ClientProxy* client, absl::string_view path,
                                  ResultCallback callback);
 
+  virtual void GetEndpointStats(ClientProxy* client,
+                                absl::string_view endpoint_id,
+                                EndpointStatsCallback callback);
+
   void SetServiceControllerForTesting(
       std::unique_ptr<ServiceController> service_controller);
 
  private:
-  // Lazily create ServiceController.
-  ServiceController* GetServiceController();
+  // The activities an activity waits for, besides the earlier ones of its
+  // client.
+  enum class RouteScope {
+    // None; it runs in parallel with the activities of other clients.
+    kClient,
+    // It touches radios shared by all clients, so it also waits for the other
+    // activities with this scope.
+    kRadios,
+  };
+
+  struct RoutedTask {
+    std::string name;
+    RouteScope scope;
+    Runnable runnable;
+  };
 
-  void RouteToServiceController(const std::string& name, Runnable runnable);
+  // Lazily create ServiceController.
+  ServiceController* GetServiceController()
+      ABSL_LOCKS_EXCLUDED(service_controller_mutex_);
+
+  void RouteToServiceController(const std::string& name, ClientProxy* client,
+                                RouteScope scope, Runnable runnable)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Hands the oldest task of |client| to the executor of its scope.
+  void ExecuteNextTask(ClientProxy* client)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Runs the oldest task of |client|, then executes its next one, if any.
+  void RunNextTask(ClientProxy* client) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Accepts the connection to |endpoint_id|, unless it was already accepted
+  // or rejected. Runs on the router's executor.
+  Status AcceptConnectionOnServiceController(ClientProxy* client,
+                                             const std::string& endpoint_id,
+                                             PayloadListener listener);
   void FinishClientSession(ClientProxy* client);
 
-  std::unique_ptr<ServiceController> service_controller_;
+  // The number of clients whose activities run at the same time, except for
+  // those that touch the radios.
+  static constexpr int kMaxParallelClients = 4;
+
+  Mutex service_controller_mutex_;
+  std::unique_ptr<ServiceController> service_controller_
+      ABSL_GUARDED_BY(service_controller_mutex_);
+  Mutex mutex_;
+  // The tasks of each client with any, oldest first. The oldest one is
+  // running, or queued in one of the executors.
+  absl::flat_hash_map<ClientProxy*, std::deque<RoutedTask>> client_tasks_
+      ABSL_GUARDED_BY(mutex_);
+  // Runs the tasks that touch the radios, one at a time.
   SingleThreadExecutor serializer_;
+  // Runs the other tasks.
+  MultiThreadExecutor client_executor_{kMaxParallelClients};
 };
 
 }  // namespace connections
@@ -20,10 +20,12 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
@@ -48,6 +50,10 @@ namespace nearby {
 namespace connections {
 
 namespace {
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::InvokeWithoutArgs;
+using ::testing::Pair;
 using ::testing::Return;
 constexpr std::array<char, 6> kFakeMacAddress = {'a', 'b', 'c', 'd', 'e', 'f'};
 constexpr std::array<char, 6> kFakeInjectedEndpointInfo = {'g', 'h', 'i'};
@@ -524,6 +530,9 @@ class ServiceControllerRouterTest : public testing::Test {
 };
 
 namespace {
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(100);
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
 TEST_F(ServiceControllerRouterTest, QualityConversionWorks) {
   EXPECT_EQ(router_.GetMediumQuality(Medium::UNKNOWN_MEDIUM),
             v3::Quality::kUnknown);
@@ -845,6 +854,39 @@ TEST_F(ServiceControllerRouterTest, DisconnectFromEndpointCalled) {
   });
 }
 
+TEST_F(ServiceControllerRouterTest, BusyClientDoesNotBlockOtherClients) {
+  ClientProxy other_client;
+  CountDownLatch advertising_started(1);
+  CountDownLatch advertising_released(1);
+  CountDownLatch advertised(1);
+  CountDownLatch cancelled(1);
+  CountDownLatch other_cancelled(1);
+  EXPECT_CALL(*mock_, StartAdvertising).WillOnce(InvokeWithoutArgs([&]() {
+    advertising_started.CountDown();
+    advertising_released.Await();
+    return Status{Status::kSuccess};
+  }));
+  EXPECT_CALL(*mock_, CancelPayload)
+      .Times(2)
+      .WillRepeatedly(Return(Status{Status::kSuccess}));
+
+  router_.StartAdvertising(&client_, kServiceId, kAdvertisingOptions,
+                           kConnectionRequestInfo,
+                           [&](Status status) { advertised.CountDown(); });
+  ASSERT_TRUE(advertising_started.Await(kDefaultTimeout).result());
+  router_.CancelPayload(&client_, kPayloadId,
+                        [&](Status status) { cancelled.CountDown(); });
+  router_.CancelPayload(&other_client, kPayloadId,
+                        [&](Status status) { other_cancelled.CountDown(); });
+
+  // The other client goes ahead, while this one waits for its advertising.
+  EXPECT_TRUE(other_cancelled.Await(kDefaultTimeout).result());
+  EXPECT_FALSE(cancelled.Await(kShortTimeout).result());
+  advertising_released.CountDown();
+  EXPECT_TRUE(advertised.Await(kDefaultTimeout).result());
+  EXPECT_TRUE(cancelled.Await(kDefaultTimeout).result());
+}
+
 TEST_F(ServiceControllerRouterTest, RequestConnectionCalledV3) {
   // Either Advertising, or Discovery should be ongoing.
   StartDiscovery(&client_, kServiceId, kDiscoveryOptions, DiscoveryListener{},
@@ -1207,6 +1249,107 @@ TEST_F(ServiceControllerRouterTest, SendPayloadCalledV3) {
                 });
 }
 
+TEST_F(ServiceControllerRouterTest, AcceptConnectionsCalledV3) {
+  // Either Advertising, or Discovery should be ongoing.
+  StartDiscovery(&client_, kServiceId, kDiscoveryOptions, DiscoveryListener{},
+                 [this](Status status) {
+                   MutexLock lock(&mutex_);
+                   result_ = status;
+                   complete_ = true;
+                   cond_.Notify();
+                 });
+  // Establish connection.
+  auto local_device =
+      v3::ConnectionsDevice(client_.GetLocalEndpointId(), kRequestorName, {});
+  RequestConnectionV3(
+      &client_, kRemoteDevice,
+      v3::ConnectionRequestInfo{
+          .local_device = local_device,
+          .listener = {},
+      },
+      [this](Status status) {
+        MutexLock lock(&mutex_);
+        result_ = status;
+        complete_ = true;
+        cond_.Notify();
+      },
+      false);
+  // Now, we can accept connections; the unknown device is reported apart.
+  const v3::ConnectionsDevice unknown_device("unknown endpoint id", "", {});
+  const NearbyDevice* devices[] = {&kRemoteDevice, &unknown_device};
+  EXPECT_CALL(*mock_, AcceptConnection)
+      .WillOnce(Return(Status{Status::kSuccess}))
+      .WillOnce(Return(Status{Status::kEndpointUnknown}));
+  CountDownLatch latch(2);
+  std::vector<std::pair<std::string, Status>> results;
+  router_.AcceptConnectionsV3(
+      &client_, devices, {},
+      [&](const NearbyDevice& device, Status status) {
+        results.push_back({device.GetEndpointId(), status});
+        latch.CountDown();
+      });
+  ASSERT_TRUE(latch.Await(absl::Seconds(1)).result());
+  EXPECT_THAT(results,
+              ElementsAre(Pair(kRemoteEndpointId, Status{Status::kSuccess}),
+                          Pair("unknown endpoint id",
+                               Status{Status::kEndpointUnknown})));
+}
+
+TEST_F(ServiceControllerRouterTest, SendPayloadToManyCalledV3) {
+  // Either Advertising, or Discovery should be ongoing.
+  StartDiscovery(&client_, kServiceId, kDiscoveryOptions, DiscoveryListener{},
+                 [this](Status status) {
+                   MutexLock lock(&mutex_);
+                   result_ = status;
+                   complete_ = true;
+                   cond_.Notify();
+                 });
+  // Establish connection.
+  auto local_device =
+      v3::ConnectionsDevice(client_.GetLocalEndpointId(), kRequestorName, {});
+  RequestConnectionV3(
+      &client_, kRemoteDevice,
+      v3::ConnectionRequestInfo{
+          .local_device = local_device,
+          .listener = {},
+      },
+      [this](Status status) {
+        MutexLock lock(&mutex_);
+        result_ = status;
+        complete_ = true;
+        cond_.Notify();
+      },
+      false);
+  // Now, we can accept connection.
+  AcceptConnectionV3(&client_, kRemoteDevice, [this](Status status) {
+    MutexLock lock(&mutex_);
+    result_ = status;
+    complete_ = true;
+    cond_.Notify();
+  });
+  // Now we can send one payload to all the devices, of which one is connected.
+  const v3::ConnectionsDevice unknown_device("unknown endpoint id", "", {});
+  const NearbyDevice* devices[] = {&kRemoteDevice, &unknown_device};
+  EXPECT_CALL(*mock_, SendPayload(_,
+                                  ElementsAre(kRemoteEndpointId,
+                                              "unknown endpoint id"),
+                                  _))
+      .Times(1);
+  {
+    MutexLock lock(&mutex_);
+    complete_ = false;
+    router_.SendPayloadToManyV3(&client_, devices, Payload{ByteArray("data")},
+                                [this](Status status) {
+                                  MutexLock lock(&mutex_);
+                                  result_ = status;
+                                  complete_ = true;
+                                  cond_.Notify();
+                                });
+    while (!complete_) cond_.Wait();
+    EXPECT_EQ(result_, Status{Status::kSuccess});
+  }
+}
+
 TEST_F(ServiceControllerRouterTest, DisconnectFromDeviceCalledV3) {
   // Either Advertising, or Discovery should be ongoing.
   StartDiscovery(&client_, kServiceId, kDiscoveryOptions, DiscoveryListener{},
@@ -0,0 +1,123 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/session_resumption.h"
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "connections/implementation/aead_record_layer.h"
+#include "internal/crypto_cros/hkdf.h"
+#include "internal/crypto_cros/hmac.h"
+#include "internal/platform/crypto.h"
+
+namespace nearby {
+namespace connections {
+
+namespace {
+constexpr absl::string_view kSecretSalt = "NearbyConnectionsSessionResumption";
+constexpr absl::string_view kSecretInfo = "resumption secret v1";
+constexpr absl::string_view kTicketIdInfo = "ticket id";
+constexpr absl::string_view kServerMacInfo = "server mac";
+constexpr absl::string_view kClientToServerInfo = "client to server";
+constexpr absl::string_view kServerToClientInfo = "server to client";
+constexpr absl::string_view kNextSecretInfo = "next secret";
+constexpr size_t kSecretLength = 32;
+constexpr size_t kTicketIdLength = 16;
+
+// Keys derived for one resumption are bound to both of its nonces.
+std::string Derive(absl::string_view secret, absl::string_view client_nonce,
+                   absl::string_view server_nonce, absl::string_view info) {
+  return crypto::HkdfSha256(secret, absl::StrCat(client_nonce, server_nonce),
+                            info, kSecretLength);
+}
+}  // namespace
+
+std::optional<std::string> SessionResumption::DeriveSecret(
+    EncryptionContext& context) {
+  std::string encode_key;
+  std::string decode_key;
+  if (!AeadRecordLayer::ExtractSessionKeys(context, &encode_key,
+                                           &decode_key)) {
+    return std::nullopt;
+  }
+  // The peer holds the same keys the other way around; order them so both
+  // sides derive the same secret.
+  std::string keys = encode_key < decode_key
+                         ? absl::StrCat(encode_key, decode_key)
+                         : absl::StrCat(decode_key, encode_key);
+  return crypto::HkdfSha256(keys, kSecretSalt, kSecretInfo, kSecretLength);
+}
+
+std::string SessionResumption::GetTicketId(absl::string_view secret) {
+  return crypto::HkdfSha256(secret, kSecretSalt, kTicketIdInfo,
+                            kTicketIdLength);
+}
+
+std::string SessionResumption::GenerateNonce() {
+  std::string nonce(kNonceLength, '\0');
+  RandBytes(nonce.data(), nonce.size());
+  return nonce;
+}
+
+std::string SessionResumption::ComputeServerMac(
+    absl::string_view secret, absl::string_view client_nonce,
+    absl::string_view server_nonce) {
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  std::string mac(hmac.DigestLength(), '\0');
+  if (!hmac.Init(Derive(secret, client_nonce, server_nonce, kServerMacInfo)) ||
+      !hmac.Sign(absl::StrCat(client_nonce, server_nonce),
+                 reinterpret_cast<unsigned char*>(mac.data()), mac.size())) {
+    return {};
+  }
+  return mac;
+}
+
+bool SessionResumption::VerifyServerMac(absl::string_view secret,
+                                        absl::string_view client_nonce,
+                                        absl::string_view server_nonce,
+                                        absl::string_view mac) {
+  crypto::HMAC hmac(crypto::HMAC::SHA256);
+  if (mac.size() != hmac.DigestLength() ||
+      !hmac.Init(Derive(secret, client_nonce, server_nonce, kServerMacInfo))) {
+    return false;
+  }
+  return hmac.Verify(absl::StrCat(client_nonce, server_nonce), mac);
+}
+
+std::unique_ptr<AeadRecordLayer> SessionResumption::CreateRecordLayer(
+    absl::string_view secret, bool is_client, absl::string_view client_nonce,
+    absl::string_view server_nonce) {
+  std::string client_to_server =
+      Derive(secret, client_nonce, server_nonce, kClientToServerInfo);
+  std::string server_to_client =
+      Derive(secret, client_nonce, server_nonce, kServerToClientInfo);
+  return is_client ? std::make_unique<AeadRecordLayer>(client_to_server,
+                                                       server_to_client)
+                   : std::make_unique<AeadRecordLayer>(server_to_client,
+                                                       client_to_server);
+}
+
+std::string SessionResumption::DeriveNextSecret(
+    absl::string_view secret, absl::string_view client_nonce,
+    absl::string_view server_nonce) {
+  return Derive(secret, client_nonce, server_nonce, kNextSecretInfo);
+}
+
+}  // namespace connections
+}  // namespace nearby
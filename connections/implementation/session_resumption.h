@@ -0,0 +1,89 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_SESSION_RESUMPTION_H_
+#define CORE_INTERNAL_SESSION_RESUMPTION_H_
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "securegcm/d2d_connection_context_v1.h"
+#include "connections/implementation/aead_record_layer.h"
+
+namespace nearby {
+namespace connections {
+
+// Key schedule of the abbreviated handshake that resumes the encryption of an
+// endpoint over a reconnected channel, instead of running a new UKEY2
+// handshake.
+//
+// Both sides derive the same resumption secret from the UKEY2 keys of the
+// session, and never send it. The reconnecting side (the client) introduces
+// itself with the ticket id of the secret and a random nonce; the side that
+// rehosts (the server) answers with its own nonce and a MAC over both nonces,
+// proving it holds the secret. Both then seal frames with an AeadRecordLayer
+// keyed from the secret and both nonces, so the keys are fresh for every
+// reconnection, and the first frame the client sends proves it holds the
+// secret too. A side that can't resume answers or introduces itself without
+// resumption fields, and both fall back to the full handshake.
+//
+// Every resumption replaces the secret with the next one derived from it, so
+// a ticket is only accepted once.
+class SessionResumption {
+ public:
+  using EncryptionContext = ::securegcm::D2DConnectionContextV1;
+
+  static constexpr size_t kNonceLength = 32;
+
+  // Derives the resumption secret of the session UKEY2 established. Both sides
+  // get the same secret. Returns nullopt if the keys cannot be extracted from
+  // |context|.
+  static std::optional<std::string> DeriveSecret(EncryptionContext& context);
+
+  // Identifies |secret| to the peer, without revealing it.
+  static std::string GetTicketId(absl::string_view secret);
+
+  // Returns kNonceLength cryptographically secure random bytes.
+  static std::string GenerateNonce();
+
+  // Returns the server's proof that it holds |secret|.
+  static std::string ComputeServerMac(absl::string_view secret,
+                                      absl::string_view client_nonce,
+                                      absl::string_view server_nonce);
+
+  // Checks |mac| against the server's proof, in constant time.
+  static bool VerifyServerMac(absl::string_view secret,
+                              absl::string_view client_nonce,
+                              absl::string_view server_nonce,
+                              absl::string_view mac);
+
+  // Returns the record layer sealing the frames of the resumed session, for
+  // the client or the server side of the resumption.
+  static std::unique_ptr<AeadRecordLayer> CreateRecordLayer(
+      absl::string_view secret, bool is_client, absl::string_view client_nonce,
+      absl::string_view server_nonce);
+
+  // Returns the secret that replaces |secret| once it is used.
+  static std::string DeriveNextSecret(absl::string_view secret,
+                                      absl::string_view client_nonce,
+                                      absl::string_view server_nonce);
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_SESSION_RESUMPTION_H_
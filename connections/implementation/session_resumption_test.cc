@@ -0,0 +1,117 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/session_resumption.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "connections/implementation/aead_record_layer.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::string_view kSecret = "0123456789abcdef0123456789abcdef";
+constexpr absl::string_view kOtherSecret = "fedcba9876543210fedcba9876543210";
+
+TEST(SessionResumptionTest, TicketIdDoesNotRevealTheSecret) {
+  std::string ticket_id = SessionResumption::GetTicketId(kSecret);
+
+  EXPECT_EQ(ticket_id, SessionResumption::GetTicketId(kSecret));
+  EXPECT_NE(ticket_id, SessionResumption::GetTicketId(kOtherSecret));
+  EXPECT_EQ(std::string(kSecret).find(ticket_id), std::string::npos);
+}
+
+TEST(SessionResumptionTest, NoncesAreRandom) {
+  std::string nonce = SessionResumption::GenerateNonce();
+
+  EXPECT_EQ(nonce.size(), SessionResumption::kNonceLength);
+  EXPECT_NE(nonce, SessionResumption::GenerateNonce());
+}
+
+TEST(SessionResumptionTest, ServerMacProvesTheSecret) {
+  std::string client_nonce = SessionResumption::GenerateNonce();
+  std::string server_nonce = SessionResumption::GenerateNonce();
+  std::string mac = SessionResumption::ComputeServerMac(kSecret, client_nonce,
+                                                        server_nonce);
+
+  EXPECT_TRUE(SessionResumption::VerifyServerMac(kSecret, client_nonce,
+                                                 server_nonce, mac));
+  EXPECT_FALSE(SessionResumption::VerifyServerMac(kOtherSecret, client_nonce,
+                                                  server_nonce, mac));
+  // A MAC replayed from another resumption doesn't match the new nonce.
+  EXPECT_FALSE(SessionResumption::VerifyServerMac(
+      kSecret, SessionResumption::GenerateNonce(), server_nonce, mac));
+  EXPECT_FALSE(SessionResumption::VerifyServerMac(kSecret, client_nonce,
+                                                  server_nonce, ""));
+}
+
+TEST(SessionResumptionTest, ClientAndServerRecordLayersMatch) {
+  std::string client_nonce = SessionResumption::GenerateNonce();
+  std::string server_nonce = SessionResumption::GenerateNonce();
+  std::unique_ptr<AeadRecordLayer> client =
+      SessionResumption::CreateRecordLayer(kSecret, /*is_client=*/true,
+                                           client_nonce, server_nonce);
+  std::unique_ptr<AeadRecordLayer> server =
+      SessionResumption::CreateRecordLayer(kSecret, /*is_client=*/false,
+                                           client_nonce, server_nonce);
+
+  std::unique_ptr<std::string> record = client->Encrypt("from client");
+  ASSERT_NE(record, nullptr);
+  std::unique_ptr<std::string> plaintext = server->Decrypt(*record);
+  ASSERT_NE(plaintext, nullptr);
+  EXPECT_EQ(*plaintext, "from client");
+
+  record = server->Encrypt("from server");
+  ASSERT_NE(record, nullptr);
+  plaintext = client->Decrypt(*record);
+  ASSERT_NE(plaintext, nullptr);
+  EXPECT_EQ(*plaintext, "from server");
+}
+
+TEST(SessionResumptionTest, EveryResumptionHasItsOwnKeys) {
+  std::string client_nonce = SessionResumption::GenerateNonce();
+  std::unique_ptr<AeadRecordLayer> client =
+      SessionResumption::CreateRecordLayer(kSecret, /*is_client=*/true,
+                                           client_nonce,
+                                           SessionResumption::GenerateNonce());
+  std::unique_ptr<AeadRecordLayer> server =
+      SessionResumption::CreateRecordLayer(kSecret, /*is_client=*/false,
+                                           client_nonce,
+                                           SessionResumption::GenerateNonce());
+
+  std::unique_ptr<std::string> record = client->Encrypt("from client");
+  ASSERT_NE(record, nullptr);
+  EXPECT_EQ(server->Decrypt(*record), nullptr);
+}
+
+TEST(SessionResumptionTest, NextSecretReplacesTheTicket) {
+  std::string client_nonce = SessionResumption::GenerateNonce();
+  std::string server_nonce = SessionResumption::GenerateNonce();
+  std::string next_secret =
+      SessionResumption::DeriveNextSecret(kSecret, client_nonce, server_nonce);
+
+  EXPECT_NE(next_secret, kSecret);
+  EXPECT_EQ(next_secret, SessionResumption::DeriveNextSecret(
+                             kSecret, client_nonce, server_nonce));
+  EXPECT_NE(SessionResumption::GetTicketId(next_secret),
+            SessionResumption::GetTicketId(kSecret));
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
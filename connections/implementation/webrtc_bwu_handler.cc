@@ -30,6 +30,7 @@
 #include "connections/implementation/mediums/webrtc_peer_id.h"
 #include "connections/implementation/mediums/webrtc_socket.h"
 #include "connections/implementation/offline_frames.h"
+#include "connections/implementation/service_id_constants.h"
 #include "connections/implementation/webrtc_endpoint_channel.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/expected.h"
@@ -110,6 +111,7 @@ WebrtcBwuHandler::CreateUpgradedEndpointChannel(
 void WebrtcBwuHandler::HandleRevertInitiatorStateForService(
     const std::string& upgrade_service_id) {
   webrtc_.StopAcceptingConnections(upgrade_service_id);
+  self_peer_ids_.erase(upgrade_service_id);
   NEARBY_LOGS(INFO)
       << "WebrtcBwuHandler successfully reverted state for service "
       << upgrade_service_id;
@@ -121,29 +123,80 @@ void WebrtcBwuHandler::HandleRevertInitiatorStateForService(
 ByteArray WebrtcBwuHandler::HandleInitializeUpgradedMediumForEndpoint(
     ClientProxy* client, const std::string& upgrade_service_id,
     const std::string& endpoint_id) {
-  LocationHint location_hint =
-      Utils::BuildLocationHint(webrtc_.GetDefaultCountryCode());
+  if (!StartAcceptingConnections(client, upgrade_service_id)) {
+    NEARBY_LOGS(ERROR) << "WebRtcBwuHandler couldn't initiate the WEB_RTC "
+                          "upgrade for endpoint "
+                       << endpoint_id
+                       << " because it failed to start listening for "
+                          "incoming WebRTC connections.";
+    return {};
+  }
+  // From now on, the upgrade reverts the state for the endpoint.
+  prewarmed_upgrade_service_ids_.erase(endpoint_id);
 
-  mediums::WebrtcPeerId self_id{mediums::WebrtcPeerId::FromRandom()};
-  if (!webrtc_.IsAcceptingConnections(upgrade_service_id)) {
-    if (!webrtc_.StartAcceptingConnections(
-            upgrade_service_id, self_id, location_hint,
-            absl::bind_front(&WebrtcBwuHandler::OnIncomingWebrtcConnection,
-                             this, client),
-            client->GetWebRtcNonCellular())) {
-      NEARBY_LOGS(ERROR) << "WebRtcBwuHandler couldn't initiate the WEB_RTC "
+  return parser::ForBwuWebrtcPathAvailable(
+      self_peer_ids_[upgrade_service_id].GetId(),
+      Utils::BuildLocationHint(webrtc_.GetDefaultCountryCode()));
+}
+
+// Called by both sides when the connection is initiated. Creates the peer
+// connection early, and lets the initiator register with the signaling server
+// early, so the upgrade can go straight to the offer and answer.
+void WebrtcBwuHandler::PrewarmUpgradedMediumForEndpoint(
+    ClientProxy* client, const std::string& service_id,
+    const std::string& endpoint_id, bool is_initiator) {
+  webrtc_.PrewarmConnectionFlow(client->GetWebRtcNonCellular());
+  if (!is_initiator) return;
+
+  std::string upgrade_service_id = WrapInitiatorUpgradeServiceId(service_id);
+  if (!StartAcceptingConnections(client, upgrade_service_id)) {
+    NEARBY_LOGS(WARNING) << "WebRtcBwuHandler couldn't prepare the WEB_RTC "
                             "upgrade for endpoint "
-                         << endpoint_id
-                         << " because it failed to start listening for "
-                            "incoming WebRTC connections.";
-      return {};
-    }
-    NEARBY_LOGS(INFO) << "WebRtcBwuHandler successfully started listening for "
-                         "incoming WebRTC connections while upgrading endpoint "
-                      << endpoint_id;
+                         << endpoint_id;
+    return;
   }
+  prewarmed_upgrade_service_ids_[endpoint_id] = upgrade_service_id;
+}
 
-  return parser::ForBwuWebrtcPathAvailable(self_id.GetId(), location_hint);
+void WebrtcBwuHandler::OnEndpointDisconnect(ClientProxy* client,
+                                            const std::string& endpoint_id) {
+  auto prewarmed = prewarmed_upgrade_service_ids_.extract(endpoint_id);
+  if (prewarmed.empty()) return;
+
+  // Keep accepting connections while another endpoint may still upgrade
+  // through the service.
+  const std::string& upgrade_service_id = prewarmed.mapped();
+  if (IsInitiatingUpgradeForService(upgrade_service_id)) return;
+  for (const auto& item : prewarmed_upgrade_service_ids_) {
+    if (item.second == upgrade_service_id) return;
+  }
+  if (webrtc_.IsAcceptingConnections(upgrade_service_id)) {
+    HandleRevertInitiatorStateForService(upgrade_service_id);
+  }
+}
+
+bool WebrtcBwuHandler::StartAcceptingConnections(
+    ClientProxy* client, const std::string& upgrade_service_id) {
+  if (self_peer_ids_.contains(upgrade_service_id) &&
+      webrtc_.IsAcceptingConnections(upgrade_service_id)) {
+    return true;
+  }
+
+  LocationHint location_hint =
+      Utils::BuildLocationHint(webrtc_.GetDefaultCountryCode());
+  mediums::WebrtcPeerId self_id{mediums::WebrtcPeerId::FromRandom()};
+  if (!webrtc_.StartAcceptingConnections(
+          upgrade_service_id, self_id, location_hint,
+          absl::bind_front(&WebrtcBwuHandler::OnIncomingWebrtcConnection, this,
+                           client),
+          client->GetWebRtcNonCellular())) {
+    return false;
+  }
+  self_peer_ids_[upgrade_service_id] = self_id;
+  NEARBY_LOGS(INFO) << "WebRtcBwuHandler successfully started listening for "
+                       "incoming WebRTC connections for service "
+                    << upgrade_service_id;
+  return true;
 }
 
 // Accept Connection Callback.
@@ -21,12 +21,14 @@
 #include <string>
 #include <utility>
 
+#include "absl/container/flat_hash_map.h"
 #include "connections/implementation/base_bwu_handler.h"
 #include "connections/implementation/bwu_handler.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
 #include "connections/implementation/mediums/mediums.h"
 #include "connections/implementation/mediums/webrtc.h"
+#include "connections/implementation/mediums/webrtc_peer_id.h"
 #include "connections/implementation/mediums/webrtc_socket.h"
 #include "connections/medium_selector.h"
 #include "internal/platform/byte_array.h"
@@ -67,7 +69,11 @@ class WebrtcBwuHandler : public BaseBwuHandler {
     return Medium::WEB_RTC;
   }
   void OnEndpointDisconnect(ClientProxy* client,
-                            const std::string& endpoint_id) final {}
+                            const std::string& endpoint_id) final;
+  void PrewarmUpgradedMediumForEndpoint(ClientProxy* client,
+                                        const std::string& service_id,
+                                        const std::string& endpoint_id,
+                                        bool is_initiator) final;
 
   // BaseBwuHandler implementation:
   ByteArray HandleInitializeUpgradedMediumForEndpoint(
@@ -76,12 +82,26 @@ class WebrtcBwuHandler : public BaseBwuHandler {
   void HandleRevertInitiatorStateForService(
       const std::string& upgrade_service_id) final;
 
+  // Starts accepting incoming WebRTC connections for |upgrade_service_id|,
+  // unless we already are. Returns whether we are.
+  bool StartAcceptingConnections(ClientProxy* client,
+                                 const std::string& upgrade_service_id);
+
   void OnIncomingWebrtcConnection(ClientProxy* client,
                                   const std::string& upgrade_service_id,
                                   mediums::WebRtcSocketWrapper socket);
 
   Mediums& mediums_;
   mediums::WebRtc& webrtc_{mediums_.GetWebRtc()};
+
+  // Maps an upgrade service ID -> the peer ID we accept connections as, while
+  // we do.
+  absl::flat_hash_map<std::string, mediums::WebrtcPeerId> self_peer_ids_;
+
+  // Maps an endpoint ID -> the upgrade service ID we started accepting
+  // connections for in PrewarmUpgradedMediumForEndpoint(), until the endpoint
+  // initiates its upgrade.
+  absl::flat_hash_map<std::string, std::string> prewarmed_upgrade_service_ids_;
 };
 
 }  // namespace connections
@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "absl/functional/bind_front.h"
+#include "absl/time/time.h"
 #include "connections/implementation/base_bwu_handler.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
@@ -28,6 +29,7 @@
 #include "connections/implementation/wifi_direct_endpoint_channel.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/expected.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/wifi_credential.h"
 #include "internal/platform/wifi_direct.h"
@@ -96,9 +98,11 @@ ByteArray WifiDirectBwuHandler::HandleInitializeUpgradedMediumForEndpoint(
 
 void WifiDirectBwuHandler::HandleRevertInitiatorStateForService(
     const std::string& upgrade_service_id) {
+  absl::Duration reuse_timeout =
+      FeatureFlags::GetInstance().GetFlags().wifi_bwu_group_reuse_timeout;
   wifi_direct_medium_.StopAcceptingConnections(upgrade_service_id);
-  wifi_direct_medium_.StopWifiDirect();
-  wifi_direct_medium_.DisconnectWifiDirect();
+  wifi_direct_medium_.ReleaseWifiDirect(reuse_timeout);
+  wifi_direct_medium_.ReleaseWifiDirectConnection(reuse_timeout);
 
   NEARBY_LOGS(INFO)
       << "WifiDirectBwuHandler successfully reverted all states for "
@@ -121,12 +125,13 @@ WifiDirectBwuHandler::CreateUpgradedEndpointChannel(
   const std::string& password = upgrade_path_info_credentials.password();
   std::int32_t port = upgrade_path_info_credentials.port();
   const std::string& gateway = upgrade_path_info_credentials.gateway();
+  std::int32_t frequency = upgrade_path_info_credentials.frequency();
 
   NEARBY_LOGS(INFO) << "Received WifiDirect credential SSID: " << ssid
                     << ",  Password:" << password << ",  Port:" << port
-                    << ",  Gateway:" << gateway;
+                    << ",  Gateway:" << gateway << ",  Frequency:" << frequency;
 
-  if (!wifi_direct_medium_.ConnectWifiDirect(ssid, password)) {
+  if (!wifi_direct_medium_.ConnectWifiDirect(ssid, password, frequency)) {
     NEARBY_LOGS(ERROR) << "Connect to WifiDiret GO failed";
     return {Error(
         OperationResultCode::CONNECTIVITY_WIFI_DIRECT_INVALID_CREDENTIAL)};
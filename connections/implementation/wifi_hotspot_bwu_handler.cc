@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "absl/functional/bind_front.h"
+#include "absl/time/time.h"
 #include "connections/implementation/base_bwu_handler.h"
 #include "connections/implementation/client_proxy.h"
 #include "connections/implementation/endpoint_channel.h"
@@ -29,6 +30,7 @@
 #include "connections/strategy.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/expected.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/wifi_credential.h"
 #include "internal/platform/wifi_hotspot.h"
@@ -100,9 +102,11 @@ ByteArray WifiHotspotBwuHandler::HandleInitializeUpgradedMediumForEndpoint(
 
 void WifiHotspotBwuHandler::HandleRevertInitiatorStateForService(
     const std::string& upgrade_service_id) {
+  absl::Duration reuse_timeout =
+      FeatureFlags::GetInstance().GetFlags().wifi_bwu_group_reuse_timeout;
   wifi_hotspot_medium_.StopAcceptingConnections(upgrade_service_id);
-  wifi_hotspot_medium_.StopWifiHotspot();
-  wifi_hotspot_medium_.DisconnectWifiHotspot();
+  wifi_hotspot_medium_.ReleaseWifiHotspot(reuse_timeout);
+  wifi_hotspot_medium_.ReleaseHotspotConnection(reuse_timeout);
 
   NEARBY_LOGS(INFO)
       << "WifiHotspotBwuHandler successfully reverted all states for "
@@ -0,0 +1,123 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/write_behind_sink.h"
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/output_stream.h"
+
+namespace nearby {
+namespace connections {
+
+WriteBehindSink::WriteBehindSink(OutputStream& output,
+                                 size_t max_buffered_bytes,
+                                 size_t coalesce_bytes)
+    : output_(output),
+      max_buffered_bytes_(max_buffered_bytes),
+      coalesce_bytes_(coalesce_bytes) {}
+
+WriteBehindSink::~WriteBehindSink() {
+  Flush();
+  executor_.Shutdown();
+}
+
+Exception WriteBehindSink::Write(ByteArray chunk) {
+  MutexLock lock(&mutex_);
+  while (error_.Ok() && buffered_bytes_ > 0 &&
+         buffered_bytes_ + chunk.size() > max_buffered_bytes_) {
+    cond_.Wait();
+  }
+  if (error_.Raised()) return error_;
+
+  buffered_bytes_ += chunk.size();
+  if (pending_.empty() && chunk.size() >= coalesce_bytes_) {
+    // Large enough on its own; hand it over without copying.
+    queue_.push_back(std::string(std::move(chunk)));
+  } else {
+    pending_.append(chunk.data(), chunk.size());
+    if (pending_.size() >= coalesce_bytes_) QueuePendingLocked();
+  }
+  StartWriterLocked();
+  return {Exception::kSuccess};
+}
+
+Exception WriteBehindSink::Flush() {
+  {
+    MutexLock lock(&mutex_);
+    QueuePendingLocked();
+    StartWriterLocked();
+    while (writing_) {
+      cond_.Wait();
+    }
+    if (error_.Raised()) return error_;
+  }
+  return output_.Flush();
+}
+
+size_t WriteBehindSink::GetBufferedBytes() const {
+  MutexLock lock(&mutex_);
+  return buffered_bytes_;
+}
+
+void WriteBehindSink::QueuePendingLocked() {
+  if (pending_.empty()) return;
+  queue_.push_back(std::move(pending_));
+  pending_.clear();
+}
+
+void WriteBehindSink::StartWriterLocked() {
+  if (writing_ || queue_.empty()) return;
+  writing_ = true;
+  executor_.Execute("write-behind", [this]() { WriteQueued(); });
+}
+
+void WriteBehindSink::WriteQueued() {
+  while (true) {
+    std::string data;
+    {
+      MutexLock lock(&mutex_);
+      if (queue_.empty()) {
+        writing_ = false;
+        cond_.Notify();
+        return;
+      }
+      data = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    size_t size = data.size();
+    Exception result = output_.Write(ByteArray(std::move(data)));
+    MutexLock lock(&mutex_);
+    buffered_bytes_ -= size;
+    if (result.Raised() && error_.Ok()) {
+      error_ = result;
+      // Nothing after a failed write can end up in the right place.
+      for (const std::string& dropped : queue_) {
+        buffered_bytes_ -= dropped.size();
+      }
+      queue_.clear();
+      buffered_bytes_ -= pending_.size();
+      pending_.clear();
+    }
+    cond_.Notify();
+  }
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,88 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_WRITE_BEHIND_SINK_H_
+#define CORE_INTERNAL_WRITE_BEHIND_SINK_H_
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/output_stream.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+
+// Writes incoming payload chunks to an OutputStream on a background thread,
+// so a slow disk does not hold up the reader of the endpoint channel.
+//
+// Small chunks are coalesced into writes of at least |coalesce_bytes|. At most
+// |max_buffered_bytes| may be waiting to be written; Write() blocks beyond
+// that, which pushes back on the sender the same way a synchronous write did.
+//
+// A failed background write is reported by the next Write() or Flush(), and
+// everything after it is dropped.
+class WriteBehindSink {
+ public:
+  WriteBehindSink(OutputStream& output, size_t max_buffered_bytes,
+                  size_t coalesce_bytes);
+  // Writes out whatever is still buffered.
+  ~WriteBehindSink();
+
+  WriteBehindSink(const WriteBehindSink&) = delete;
+  WriteBehindSink& operator=(const WriteBehindSink&) = delete;
+
+  // Queues |chunk| to be written. Returns the error of an earlier background
+  // write, if there was one; |chunk| is dropped in that case.
+  Exception Write(ByteArray chunk) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Blocks until everything queued has been written, then flushes |output|.
+  // Returns the first error hit on the way.
+  Exception Flush() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Bytes accepted by Write() and not written to |output| yet.
+  size_t GetBufferedBytes() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // Hands the coalescing buffer over to the background writer.
+  void QueuePendingLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void StartWriterLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void WriteQueued() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  OutputStream& output_;
+  const size_t max_buffered_bytes_;
+  const size_t coalesce_bytes_;
+
+  mutable Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  // Chunks being coalesced into the next write.
+  std::string pending_ ABSL_GUARDED_BY(mutex_);
+  std::deque<std::string> queue_ ABSL_GUARDED_BY(mutex_);
+  size_t buffered_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool writing_ ABSL_GUARDED_BY(mutex_) = false;
+  Exception error_ ABSL_GUARDED_BY(mutex_) = {Exception::kSuccess};
+
+  SingleThreadExecutor executor_;
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_WRITE_BEHIND_SINK_H_
@@ -0,0 +1,158 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/write_behind_sink.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/output_stream.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(100);
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+// Records every write; writes block while the stream is paused.
+class FakeOutputStream : public OutputStream {
+ public:
+  Exception Write(const ByteArray& data) override {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(
+        +[](bool* paused) { return !*paused; }, &paused_));
+    if (fail_) return {Exception::kIo};
+    writes_.push_back(std::string(data));
+    return {Exception::kSuccess};
+  }
+  Exception Flush() override {
+    absl::MutexLock lock(&mutex_);
+    flushes_++;
+    return {Exception::kSuccess};
+  }
+  Exception Close() override { return {Exception::kSuccess}; }
+
+  void SetPaused(bool paused) {
+    absl::MutexLock lock(&mutex_);
+    paused_ = paused;
+  }
+  void SetFail(bool fail) {
+    absl::MutexLock lock(&mutex_);
+    fail_ = fail;
+  }
+  std::vector<std::string> GetWrites() {
+    absl::MutexLock lock(&mutex_);
+    return writes_;
+  }
+  int GetFlushes() {
+    absl::MutexLock lock(&mutex_);
+    return flushes_;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  bool paused_ = false;
+  bool fail_ = false;
+  std::vector<std::string> writes_;
+  int flushes_ = 0;
+};
+
+TEST(WriteBehindSinkTest, CoalescesSmallChunks) {
+  FakeOutputStream output;
+  WriteBehindSink sink(output, /*max_buffered_bytes=*/1024,
+                       /*coalesce_bytes=*/4);
+
+  EXPECT_TRUE(sink.Write(ByteArray(std::string("ab"))).Ok());
+  EXPECT_TRUE(sink.Write(ByteArray(std::string("cd"))).Ok());
+  EXPECT_TRUE(sink.Write(ByteArray(std::string("e"))).Ok());
+  EXPECT_TRUE(sink.Flush().Ok());
+
+  EXPECT_EQ(output.GetWrites(), (std::vector<std::string>{"abcd", "e"}));
+  EXPECT_EQ(output.GetFlushes(), 1);
+  EXPECT_EQ(sink.GetBufferedBytes(), 0);
+}
+
+TEST(WriteBehindSinkTest, WriteDoesNotWaitForOutput) {
+  FakeOutputStream output;
+  output.SetPaused(true);
+  WriteBehindSink sink(output, /*max_buffered_bytes=*/1024,
+                       /*coalesce_bytes=*/1);
+
+  EXPECT_TRUE(sink.Write(ByteArray(std::string("abc"))).Ok());
+  EXPECT_TRUE(sink.Write(ByteArray(std::string("def"))).Ok());
+  EXPECT_EQ(sink.GetBufferedBytes(), 6);
+
+  output.SetPaused(false);
+  EXPECT_TRUE(sink.Flush().Ok());
+  EXPECT_EQ(output.GetWrites(), (std::vector<std::string>{"abc", "def"}));
+}
+
+TEST(WriteBehindSinkTest, WriteBlocksWhenBufferIsFull) {
+  FakeOutputStream output;
+  output.SetPaused(true);
+  WriteBehindSink sink(output, /*max_buffered_bytes=*/4,
+                       /*coalesce_bytes=*/1);
+  SingleThreadExecutor executor;
+  CountDownLatch written(1);
+
+  EXPECT_TRUE(sink.Write(ByteArray(std::string("abcd"))).Ok());
+  executor.Execute([&sink, &written]() {
+    sink.Write(ByteArray(std::string("e")));
+    written.CountDown();
+  });
+
+  EXPECT_FALSE(written.Await(kShortTimeout).result());
+  output.SetPaused(false);
+  EXPECT_TRUE(written.Await(kDefaultTimeout).result());
+  EXPECT_TRUE(sink.Flush().Ok());
+  EXPECT_EQ(output.GetWrites(), (std::vector<std::string>{"abcd", "e"}));
+}
+
+TEST(WriteBehindSinkTest, FailedWriteIsReportedAndDropsLaterChunks) {
+  FakeOutputStream output;
+  output.SetFail(true);
+  WriteBehindSink sink(output, /*max_buffered_bytes=*/1024,
+                       /*coalesce_bytes=*/1);
+
+  EXPECT_TRUE(sink.Write(ByteArray(std::string("abc"))).Ok());
+
+  EXPECT_EQ(sink.Flush(), Exception{Exception::kIo});
+  EXPECT_EQ(sink.Write(ByteArray(std::string("def"))),
+            Exception{Exception::kIo});
+  EXPECT_EQ(output.GetFlushes(), 0);
+  EXPECT_EQ(sink.GetBufferedBytes(), 0);
+}
+
+TEST(WriteBehindSinkTest, DestructorWritesBufferedChunks) {
+  FakeOutputStream output;
+  {
+    WriteBehindSink sink(output, /*max_buffered_bytes=*/1024,
+                         /*coalesce_bytes=*/16);
+    EXPECT_TRUE(sink.Write(ByteArray(std::string("abc"))).Ok());
+  }
+
+  EXPECT_EQ(output.GetWrites(), std::vector<std::string>{"abc"});
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
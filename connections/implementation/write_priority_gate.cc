@@ -0,0 +1,66 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/write_priority_gate.h"
+
+#include <string>
+
+#include "absl/time/time.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+namespace connections {
+
+WritePriorityGate::WritePriorityGate(absl::Duration max_low_priority_delay)
+    : max_low_priority_delay_(max_low_priority_delay) {}
+
+void WritePriorityGate::BeginHighPriorityWrite(const std::string& key) {
+  MutexLock lock(&mutex_);
+  ++pending_high_[key];
+}
+
+void WritePriorityGate::EndHighPriorityWrite(const std::string& key) {
+  MutexLock lock(&mutex_);
+  auto it = pending_high_.find(key);
+  if (it == pending_high_.end()) return;
+  if (--it->second <= 0) {
+    pending_high_.erase(it);
+    changed_cond_.Notify();
+  }
+}
+
+absl::Duration WritePriorityGate::WaitForLowPriorityTurn(
+    const std::string& key) {
+  MutexLock lock(&mutex_);
+  if (!pending_high_.contains(key)) return absl::ZeroDuration();
+  absl::Time start = SystemClock::ElapsedRealtime();
+  absl::Time deadline = start + max_low_priority_delay_;
+  while (pending_high_.contains(key)) {
+    absl::Duration left = deadline - SystemClock::ElapsedRealtime();
+    if (left <= absl::ZeroDuration()) break;
+    changed_cond_.Wait(left);
+  }
+  return SystemClock::ElapsedRealtime() - start;
+}
+
+int WritePriorityGate::GetPendingHighPriorityWrites(
+    const std::string& key) const {
+  MutexLock lock(&mutex_);
+  auto it = pending_high_.find(key);
+  return it == pending_high_.end() ? 0 : it->second;
+}
+
+}  // namespace connections
+}  // namespace nearby
@@ -0,0 +1,69 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CORE_INTERNAL_WRITE_PRIORITY_GATE_H_
+#define CORE_INTERNAL_WRITE_PRIORITY_GATE_H_
+
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace connections {
+
+// Lets high priority frames cut in line between the chunks of bulk transfers
+// to the same endpoint.
+//
+// A channel write holds the channel's writer lock for the whole frame, and a
+// bulk sender takes the lock again as soon as it has written a chunk, so a
+// small frame may wait for several chunks to go out first. Writers of high
+// priority frames announce themselves before taking the lock, and writers of
+// low priority frames hold back while any are announced. A low priority
+// writer holds back for at most |max_low_priority_delay| per frame, so that a
+// steady stream of high priority frames can't stall bulk transfers.
+class WritePriorityGate {
+ public:
+  explicit WritePriorityGate(absl::Duration max_low_priority_delay);
+
+  // Announces a high priority write to |key|, e.g. an endpoint id, until the
+  // matching EndHighPriorityWrite().
+  void BeginHighPriorityWrite(const std::string& key)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void EndHighPriorityWrite(const std::string& key) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Blocks while high priority writes to |key| are announced, for at most
+  // |max_low_priority_delay|. Returns how long it blocked.
+  absl::Duration WaitForLowPriorityTurn(const std::string& key)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  int GetPendingHighPriorityWrites(const std::string& key) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  const absl::Duration max_low_priority_delay_;
+
+  mutable Mutex mutex_;
+  ConditionVariable changed_cond_{&mutex_};
+  // Only keys with pending high priority writes have an entry.
+  absl::flat_hash_map<std::string, int> pending_high_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace connections
+}  // namespace nearby
+
+#endif  // CORE_INTERNAL_WRITE_PRIORITY_GATE_H_
@@ -0,0 +1,102 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "connections/implementation/write_priority_gate.h"
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace connections {
+namespace {
+
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(100);
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(1);
+
+TEST(WritePriorityGateTest, LowPriorityWriteGoesRightAwayWhenAlone) {
+  WritePriorityGate gate(/*max_low_priority_delay=*/absl::Seconds(10));
+
+  EXPECT_EQ(gate.WaitForLowPriorityTurn("A"), absl::ZeroDuration());
+}
+
+TEST(WritePriorityGateTest, LowPriorityWriteWaitsForHighPriorityWrite) {
+  WritePriorityGate gate(/*max_low_priority_delay=*/absl::Seconds(10));
+  SingleThreadExecutor executor;
+  CountDownLatch written(1);
+
+  gate.BeginHighPriorityWrite("A");
+  executor.Execute([&gate, &written]() {
+    gate.WaitForLowPriorityTurn("A");
+    written.CountDown();
+  });
+
+  EXPECT_FALSE(written.Await(kShortTimeout).result());
+  gate.EndHighPriorityWrite("A");
+  EXPECT_TRUE(written.Await(kDefaultTimeout).result());
+}
+
+TEST(WritePriorityGateTest, WaitsUntilAllHighPriorityWritesAreDone) {
+  WritePriorityGate gate(/*max_low_priority_delay=*/absl::Seconds(10));
+  SingleThreadExecutor executor;
+  CountDownLatch written(1);
+
+  gate.BeginHighPriorityWrite("A");
+  gate.BeginHighPriorityWrite("A");
+  EXPECT_EQ(gate.GetPendingHighPriorityWrites("A"), 2);
+  executor.Execute([&gate, &written]() {
+    gate.WaitForLowPriorityTurn("A");
+    written.CountDown();
+  });
+
+  gate.EndHighPriorityWrite("A");
+  EXPECT_FALSE(written.Await(kShortTimeout).result());
+  gate.EndHighPriorityWrite("A");
+  EXPECT_TRUE(written.Await(kDefaultTimeout).result());
+  EXPECT_EQ(gate.GetPendingHighPriorityWrites("A"), 0);
+}
+
+TEST(WritePriorityGateTest, OtherKeysAreNotHeldUp) {
+  WritePriorityGate gate(/*max_low_priority_delay=*/absl::Seconds(10));
+
+  gate.BeginHighPriorityWrite("A");
+
+  EXPECT_EQ(gate.WaitForLowPriorityTurn("B"), absl::ZeroDuration());
+  gate.EndHighPriorityWrite("A");
+}
+
+TEST(WritePriorityGateTest, LowPriorityWaitIsBounded) {
+  WritePriorityGate gate(/*max_low_priority_delay=*/absl::Milliseconds(50));
+
+  gate.BeginHighPriorityWrite("A");
+  absl::Duration waited = gate.WaitForLowPriorityTurn("A");
+
+  EXPECT_GE(waited, absl::Milliseconds(50));
+  EXPECT_LT(waited, kDefaultTimeout);
+  gate.EndHighPriorityWrite("A");
+}
+
+TEST(WritePriorityGateTest, UnmatchedEndIsIgnored) {
+  WritePriorityGate gate(/*max_low_priority_delay=*/absl::Seconds(10));
+
+  gate.EndHighPriorityWrite("A");
+
+  EXPECT_EQ(gate.GetPendingHighPriorityWrites("A"), 0);
+  EXPECT_EQ(gate.WaitForLowPriorityTurn("A"), absl::ZeroDuration());
+}
+
+}  // namespace
+}  // namespace connections
+}  // namespace nearby
@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 // This file defines all the protocol listeners and their parameter structures.
 // Listeners are defined as collections of std::function<T> instances, which is
@@ -28,7 +29,9 @@
 // - callbacks may be initialized with lambdas; lambda definitions are concize.
 
 #include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
 #include "connections/connection_options.h"
+#include "connections/medium_selector.h"
 #include "connections/payload.h"
 #include "connections/status.h"
 #include "internal/interop/authentication_status.h"
@@ -63,6 +66,57 @@ struct ConnectionResponseInfo {
   AuthenticationStatus authentication_status = AuthenticationStatus::kUnknown;
 };
 
+// When a connection attempt crossed the boundaries between its phases, on the
+// monotonic SystemClock::ElapsedRealtime() clock. Boundaries the attempt did
+// not reach are absl::InfinitePast(), and the phases they end last zero.
+struct ConnectionTimeline {
+  Medium medium = Medium::UNKNOWN_MEDIUM;
+  bool is_incoming = false;
+
+  // RequestConnection() was called, or an incoming channel was handed over.
+  absl::Time started = absl::InfinitePast();
+  // Outgoing only: the medium connected the channel.
+  absl::Time medium_connected = absl::InfinitePast();
+  // The connection request was written, or read if incoming.
+  absl::Time request_exchanged = absl::InfinitePast();
+  // UKEY2 completed; initiated_cb is called right after.
+  absl::Time encrypted = absl::InfinitePast();
+  // The local client accepted or rejected the connection.
+  absl::Time local_responded = absl::InfinitePast();
+  // The remote endpoint's response was received.
+  absl::Time remote_responded = absl::InfinitePast();
+  // Both sides responded and the connection was established or rejected.
+  absl::Time finished = absl::InfinitePast();
+
+  absl::Duration MediumConnect() const {
+    return Between(started, medium_connected);
+  }
+  absl::Duration RequestExchange() const {
+    return Between(is_incoming ? started : medium_connected,
+                   request_exchanged);
+  }
+  absl::Duration Encryption() const {
+    return Between(request_exchanged, encrypted);
+  }
+  // The local and remote responses are awaited at the same time, so these
+  // two overlap.
+  absl::Duration LocalAccept() const {
+    return Between(encrypted, local_responded);
+  }
+  absl::Duration RemoteAccept() const {
+    return Between(encrypted, remote_responded);
+  }
+  absl::Duration Total() const { return Between(started, finished); }
+
+ private:
+  static absl::Duration Between(absl::Time from, absl::Time to) {
+    if (from == absl::InfinitePast() || to == absl::InfinitePast()) {
+      return absl::ZeroDuration();
+    }
+    return to - from;
+  }
+};
+
 struct PayloadProgressInfo {
   std::int64_t payload_id = 0;
   enum class Status {
@@ -73,6 +127,23 @@ struct PayloadProgressInfo {
   } status = Status::kSuccess;
   std::int64_t total_bytes = 0;
   std::int64_t bytes_transferred = 0;
+  // The SHA-256 digest of a file payload, in its kSuccess update, when the
+  // enable_file_payload_digest flag is set and the file was transferred from
+  // its start. Empty otherwise.
+  std::string sha256_digest;
+};
+
+// How often PayloadListener::payload_progress_cb reports a payload that is
+// still in progress. An update is reported once either threshold that is set
+// is reached; with neither set, every update is reported. Updates that arrive
+// faster than the client handles them are merged into the latest one, and the
+// first and the final update of a payload are always reported.
+struct PayloadProgressCadence {
+  // Report once at least this many more bytes were transferred; 0 if unset.
+  std::int64_t bytes = 0;
+  // Report once at least this long passed since the previous report; zero if
+  // unset.
+  absl::Duration interval = absl::ZeroDuration();
 };
 
 enum class DistanceInfo {
@@ -133,6 +204,33 @@ struct ConnectionListener {
   // medium      - Medium we upgraded to.
   std::function<void(const std::string& endpoint_id, Medium medium)>
       bandwidth_changed_cb = [](const std::string&, Medium) {};
+
+  // Called right before accepted_cb or rejected_cb, with how long each phase
+  // of the connection attempt took.
+  //
+  // endpoint_id - The identifier for the remote endpoint.
+  // timeline    - When the attempt crossed each of its phase boundaries.
+  std::function<void(const std::string& endpoint_id,
+                     const ConnectionTimeline& timeline)>
+      timeline_cb = [](const std::string&, const ConnectionTimeline&) {};
+};
+
+// A change to a discovered remote endpoint, as delivered in batches by
+// DiscoveryListener::endpoints_changed_cb.
+struct DiscoveryEvent {
+  enum class Type {
+    kFound = 1,
+    kLost = 2,
+    kDistanceChanged = 3,
+  };
+
+  Type type;
+  std::string endpoint_id;
+  // Set for kFound events.
+  ByteArray endpoint_info;
+  std::string service_id;
+  // Set for kDistanceChanged events.
+  DistanceInfo distance_info = DistanceInfo::kUnknown;
 };
 
 struct DiscoveryListener {
@@ -162,6 +260,16 @@ struct DiscoveryListener {
   //   info        - The distance info, encoded as enum value.
   absl::AnyInvocable<void(const std::string& endpoint_id, DistanceInfo info)>
       endpoint_distance_changed_cb = [](const std::string&, DistanceInfo) {};
+
+  // Called instead of the callbacks above when discovery events are coalesced
+  // (see FeatureFlags::Flags::discovery_event_coalescing_window), if set.
+  // Every call delivers the changes to the discovered endpoints since the
+  // call before, in order, without the changes that cancelled each other out:
+  // an endpoint found and lost again in between isn't reported at all.
+  //
+  // events - The found, lost and distance changed events.
+  absl::AnyInvocable<void(const std::vector<DiscoveryEvent>& events)>
+      endpoints_changed_cb;
 };
 
 struct PayloadListener {
@@ -187,6 +295,9 @@ struct PayloadListener {
                           const PayloadProgressInfo& info)>
       payload_progress_cb =
           [](absl::string_view, const PayloadProgressInfo&) {};
+
+  // How often payload_progress_cb reports payloads in progress.
+  PayloadProgressCadence progress_cadence;
 };
 
 }  // namespace connections
@@ -111,6 +111,10 @@ const ByteArray& Payload::AsBytes() const& {
   auto* result = std::get_if<ByteArray>(&content_);
   return result ? *result : empty;
 }
+ByteArray Payload::AsBytes() && {
+  auto* result = std::get_if<ByteArray>(&content_);
+  return result ? std::move(*result) : ByteArray();
+}
 // Returns InputStream* payload, if it has been defined, or nullptr.
 InputStream* Payload::AsStream() {
   auto* result = std::get_if<std::unique_ptr<InputStream>>(&content_);
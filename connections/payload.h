@@ -33,6 +33,27 @@
 namespace nearby {
 namespace connections {
 
+// How urgently an outgoing payload is sent, relative to the other payloads to
+// the same endpoints.
+enum class PayloadPriority {
+  // Bytes payloads are sent with high priority, files and streams with low
+  // priority.
+  kDefault = 0,
+  // Chunks of high priority payloads are written between the chunks of low
+  // priority ones, instead of queueing up behind them.
+  kHigh = 1,
+  kLow = 2,
+};
+
+// Whether the chunks of an outgoing payload may be compressed.
+enum class PayloadCompression {
+  // Chunks of bytes and stream payloads are compressed when the remote
+  // endpoint supports it and they look compressible.
+  kAuto = 0,
+  // Chunks are sent as they are, e.g. for content known to be compressed.
+  kNone = 1,
+};
+
 // Payload is default-constructible, and moveable, but not copyable container
 // that holds at most one instance of one of:
 // ByteArray, InputStream, or InputFile.
@@ -84,6 +105,8 @@ class Payload {
 
   // Returns ByteArray payload, if it has been defined, or empty ByteArray.
   const ByteArray& AsBytes() const&;
+  // As above, but moves the ByteArray out of the payload.
+  ByteArray AsBytes() &&;
   // Returns InputStream* payload, if it has been defined, or nullptr.
   InputStream* AsStream();
   // Returns InputFile* payload, if it has been defined, or nullptr.
@@ -100,6 +123,16 @@ class Payload {
 
   size_t GetOffset();
 
+  // Sets the priority of an outgoing payload; ignored for incoming ones.
+  void SetPriority(PayloadPriority priority) { priority_ = priority; }
+  PayloadPriority GetPriority() const { return priority_; }
+
+  // Sets the compression of an outgoing payload; ignored for incoming ones.
+  void SetCompression(PayloadCompression compression) {
+    compression_ = compression;
+  }
+  PayloadCompression GetCompression() const { return compression_; }
+
   // Generate Payload Id; to be passed to outgoing file constructor.
   static Id GenerateId();
 
@@ -111,6 +144,8 @@ class Payload {
 
   Id id_{GenerateId()};
   size_t offset_{0};
+  PayloadPriority priority_{PayloadPriority::kDefault};
+  PayloadCompression compression_{PayloadCompression::kAuto};
 
   std::string parent_folder_;
   std::string file_name_;
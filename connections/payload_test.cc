@@ -15,6 +15,7 @@
 #include "connections/payload.h"
 
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -43,6 +44,18 @@ TEST(PayloadTest, SupportsByteArrayType) {
   EXPECT_EQ(payload.AsBytes(), bytes);
 }
 
+TEST(PayloadTest, MovesBytesOutOfPayload) {
+  const ByteArray expected(std::string(1024, 'a'));
+  Payload payload(expected);
+  const char* data = payload.AsBytes().data();
+
+  ByteArray bytes = std::move(payload).AsBytes();
+
+  EXPECT_EQ(bytes, expected);
+  // The moved bytes are the payload's own buffer, not a copy of it.
+  EXPECT_EQ(bytes.data(), data);
+}
+
 TEST(PayloadTest, SupportsFileType) {
   constexpr size_t kOffset = 99;
   const auto payload_id = Payload::GenerateId();
@@ -122,6 +135,22 @@ TEST(PayloadTest, PayloadIsMoveable) {
   EXPECT_EQ(payload1.GetId(), id);
 }
 
+TEST(PayloadTest, PriorityMovesWithPayload) {
+  Payload payload1(ByteArray("bytes"));
+  EXPECT_EQ(payload1.GetPriority(), PayloadPriority::kDefault);
+  payload1.SetPriority(PayloadPriority::kLow);
+  Payload payload2 = std::move(payload1);
+  EXPECT_EQ(payload2.GetPriority(), PayloadPriority::kLow);
+}
+
+TEST(PayloadTest, CompressionMovesWithPayload) {
+  Payload payload1(ByteArray("bytes"));
+  EXPECT_EQ(payload1.GetCompression(), PayloadCompression::kAuto);
+  payload1.SetCompression(PayloadCompression::kNone);
+  Payload payload2 = std::move(payload1);
+  EXPECT_EQ(payload2.GetCompression(), PayloadCompression::kNone);
+}
+
 TEST(PayloadTest, PayloadHasUniqueId) {
   Payload payload1;
   Payload payload2;
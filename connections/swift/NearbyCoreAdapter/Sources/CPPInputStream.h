@@ -25,6 +25,9 @@
 
 #ifdef __cplusplus
 
+#include <cstdint>
+#include <vector>
+
 // TODO(b/239758418): Change this to the non-internal version when available.
 #include "internal/platform/input_stream.h"
 
@@ -40,6 +43,8 @@ class CPPInputStream : public nearby::InputStream {
 
  private:
   NSInputStream *iStream_;
+  // Receives the bytes of each read.
+  std::vector<uint8_t> buffer_;
 };
 
 #endif
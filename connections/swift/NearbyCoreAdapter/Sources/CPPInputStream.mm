@@ -28,16 +28,22 @@ CPPInputStream::CPPInputStream(NSInputStream *iStream) : iStream_(iStream) { [iS
 CPPInputStream::~CPPInputStream() { Close(); }
 
 ExceptionOr<ByteArray> CPPInputStream::Read(std::int64_t size) {
-  std::vector<uint8_t> buffer;
-  buffer.reserve(size);
-  NSInteger numberOfBytesRead = [iStream_ read:buffer.data() maxLength:size];
+  if (size <= 0) {
+    return ExceptionOr<ByteArray>(ByteArray());
+  }
+  // The buffer is reused across reads, so a stream read in chunks of the same size only allocates
+  // the bytes it returns.
+  if (buffer_.size() < static_cast<size_t>(size)) {
+    buffer_.resize(size);
+  }
+  NSInteger numberOfBytesRead = [iStream_ read:buffer_.data() maxLength:size];
   if (numberOfBytesRead == 0) {
     return ExceptionOr<ByteArray>();
   }
   if (numberOfBytesRead < 0) {
     return ExceptionOr<ByteArray>(Exception::kIo);
   }
-  return ExceptionOr<ByteArray>(ByteArray((const char *)buffer.data(), numberOfBytesRead));
+  return ExceptionOr<ByteArray>(ByteArray((const char *)buffer_.data(), numberOfBytesRead));
 }
 
 Exception CPPInputStream::Close() {
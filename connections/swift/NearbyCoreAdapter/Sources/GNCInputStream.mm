@@ -17,6 +17,7 @@
 #import <Foundation/Foundation.h>
 
 #include <algorithm>
+#include <utility>
 
 #include "connections/payload.h"
 
@@ -60,14 +61,15 @@ using ::nearby::connections::Payload;
     return -1;
   }
 
-  ByteArray byteArray = readResult.GetResult();
+  ByteArray byteArray = std::move(readResult).result();
   if (byteArray.size() == 0) {
     _streamStatus = NSStreamStatusAtEnd;
     return 0;
   }
 
-  memcpy(buffer, byteArray.data(), std::min(maxLen, byteArray.size()));
-  return byteArray.size();
+  NSUInteger length = std::min(maxLen, byteArray.size());
+  memcpy(buffer, byteArray.data(), length);
+  return length;
 }
 
 - (BOOL)getBuffer:(uint8_t **)buffer length:(NSUInteger *)length {
@@ -17,6 +17,7 @@
 #import <Foundation/Foundation.h>
 
 #include <string>
+#include <utility>
 
 #include "connections/payload.h"
 
@@ -28,14 +29,28 @@ using ::nearby::ByteArray;
 using ::nearby::InputFile;
 using ::nearby::connections::Payload;
 
+namespace {
+
+// Wraps the bytes of |byteArray| in an NSData without copying them; the NSData owns them from now
+// on, and frees them when it is deallocated.
+NSData *NSDataFromByteArrayNoCopy(ByteArray &&byteArray) {
+  auto *bytes = new std::string(static_cast<std::string>(std::move(byteArray)));
+  return [[NSData alloc] initWithBytesNoCopy:bytes->data()
+                                      length:bytes->size()
+                                 deallocator:^(void *, NSUInteger) {
+                                   delete bytes;
+                                 }];
+}
+
+}  // namespace
+
 @implementation GNCPayload (CppConversions)
 
 + (GNCPayload *)fromCpp:(Payload)payload {
   int64_t payloadId = payload.GetId();
   switch (payload.GetType()) {
     case nearby::connections::PayloadType::kBytes: {
-      ByteArray bytes = payload.AsBytes();
-      NSData *payloadData = [NSData dataWithBytes:bytes.data() length:bytes.size()];
+      NSData *payloadData = NSDataFromByteArrayNoCopy(std::move(payload).AsBytes());
       return [[GNCBytesPayload alloc] initWithData:payloadData identifier:payloadId];
     }
     case nearby::connections::PayloadType::kFile: {
@@ -17,6 +17,7 @@
 
 #include <string>
 
+#include "connections/listeners.h"
 #include "connections/status.h"
 #include "internal/interop/authentication_status.h"
 
@@ -26,6 +27,8 @@ namespace v3 {
 
 struct ConnectionResult {
   nearby::connections::Status status;
+  // How long each phase of the connection attempt took.
+  nearby::connections::ConnectionTimeline timeline;
 };
 
 // These fields should never be empty.
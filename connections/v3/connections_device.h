@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_CONNECTIONS_V3_CONNECTIONS_DEVICE_H_
 #define THIRD_PARTY_NEARBY_CONNECTIONS_V3_CONNECTIONS_DEVICE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -52,6 +53,9 @@ class ConnectionsDevice : public nearby::NearbyDevice {
     return connection_infos_;
   }
   Type GetType() const override { return Type::kConnectionsDevice; }
+  std::unique_ptr<NearbyDevice> Clone() const override {
+    return std::make_unique<ConnectionsDevice>(*this);
+  }
 
   std::string GetEndpointInfo() const { return endpoint_info_; }
   std::string ToProtoBytes() const override;
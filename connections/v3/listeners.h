@@ -19,6 +19,7 @@
 
 #include "absl/functional/any_invocable.h"
 #include "connections/listeners.h"
+#include "connections/status.h"
 #include "connections/v3/bandwidth_info.h"
 #include "connections/v3/connection_result.h"
 #include "internal/interop/device.h"
@@ -132,6 +133,11 @@ struct PayloadListener {
           [](const NearbyDevice&, const PayloadProgressInfo&) {};
 };
 
+// Called once for each device of a call that operates on several devices,
+// with the status of the operation on that device.
+using DeviceResultCallback =
+    absl::AnyInvocable<void(const NearbyDevice& remote_device, Status status)>;
+
 }  // namespace v3
 }  // namespace connections
 }  // namespace nearby
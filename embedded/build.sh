@@ -45,6 +45,7 @@ fi
 
 CC=arm-none-eabi-gcc
 AR=arm-none-eabi-ar
+SIZE=arm-none-eabi-size
 
 UNAME_OUT="$(uname -s)"
 case "${UNAME_OUT}" in
@@ -62,6 +63,7 @@ if [ "${ARCH}" = "gLinux" ] ; then
     CC=clang-3.8
   fi
   AR=ar
+  SIZE=size
 else
   echo "Invalid target specified on command line ${ARCH}"
   exit 1
@@ -83,6 +85,7 @@ make \
   -C "${NEARBY}" \
   CC="${CC}" \
   AR="${AR}" \
+  SIZE="${SIZE}" \
   ARCH="${ARCH}" \
   $@
 
@@ -606,13 +606,109 @@ static nearby_platform_status HandleActionRequest(
 #endif /* NEARBY_FP_ENABLE_ADDITIONAL_DATA */
 }
 
+// Returns true if the decrypted key based pairing request is addressed to
+// this device.
+static bool IsRequestForThisDevice(uint8_t* decrypted_request) {
+  uint8_t ble_address[BT_ADDRESS_LENGTH];
+  uint8_t public_address[BT_ADDRESS_LENGTH];
+  nearby_utils_CopyBigEndian(ble_address, nearby_platform_GetBleAddress(),
+                             BT_ADDRESS_LENGTH);
+  nearby_utils_CopyBigEndian(public_address, nearby_platform_GetPublicAddress(),
+                             BT_ADDRESS_LENGTH);
+  return BtAddressMatch(ble_address,
+                        decrypted_request + REQUEST_BT_ADDRESS_OFFSET) ||
+         BtAddressMatch(public_address,
+                        decrypted_request + REQUEST_BT_ADDRESS_OFFSET);
+}
+
+// Responds to a key based pairing request once it has been decrypted with a
+// known account key or a new shared secret.
+static nearby_platform_status FinishKeyBasedPairing(
+    uint64_t peer_address, uint8_t* decrypted_request) {
+  nearby_platform_status status;
+  pairing_failure_count = 0;
+  gatt_peer_address = peer_address;
+
+  DiscardPendingAccountKey();
+
+  bool extended_response =
+      decrypted_request[0] == KEY_BASED_PAIRING_REQUEST_FLAG &&
+      decrypted_request[1] & KBPR_SEEKER_SUPPORTS_BLE_DEVICES_MASK;
+  status = SendKeyBasedPairingResponse(peer_address, extended_response);
+  if (status != kNearbyStatusOK) return status;
+
+  // TODO(jsobczak): Note that at the end of the packet there is a salt
+  // attached. When possible, these salts should be tracked, and if the
+  // Provider receives a request containing an already used salt, the request
+  // should be ignored to prevent replay attacks.
+  if (decrypted_request[0] == KEY_BASED_PAIRING_REQUEST_FLAG) {
+    return HandleKeyBasedPairingRequest(peer_address, decrypted_request);
+  } else if (decrypted_request[0] == ACTION_REQUEST_FLAG) {
+    return HandleActionRequest(peer_address, decrypted_request);
+  }
+  return kNearbyStatusOK;
+}
+
+// Handles a key based pairing request that came with the seeker's public key,
+// `key` being the shared secret created from it.
+static nearby_platform_status HandleRequestWithSharedSecret(
+    uint64_t peer_address, const uint8_t* request,
+    const uint8_t key[ACCOUNT_KEY_SIZE_BYTES]) {
+  nearby_platform_status status;
+  uint8_t decrypted_request[ENCRYPTED_REQUEST_LENGTH];
+  status = nearby_platform_Aes128Decrypt(request, decrypted_request, key);
+  if (status != kNearbyStatusOK) {
+    NEARBY_TRACE(ERROR, "Failed to decrypt request, error: %d", status);
+    return status;
+  }
+  if (!IsRequestForThisDevice(decrypted_request)) {
+    NEARBY_TRACE(INFO, "Invalid incoming BT address %s",
+                 nearby_utils_ArrayToString(decrypted_request, 6));
+    AccountKeyRejected();
+    return kNearbyStatusOK;
+  }
+  memcpy(account_key_info.account_key, key, ACCOUNT_KEY_SIZE_BYTES);
+#ifdef NEARBY_FP_ENABLE_SASS
+  account_key_info.peer_address = peer_address;
+#endif /* NEARBY_FP_ENABLE_SASS */
+  return FinishKeyBasedPairing(peer_address, decrypted_request);
+}
+
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+// The key based pairing request waiting for its shared secret.
+static struct {
+  uint64_t peer_address;
+  uint8_t request[ENCRYPTED_REQUEST_LENGTH];
+  // Set while the shared secret is being created for this request.
+  bool in_flight;
+  // Set when the request has been handled, with the result in `status`.
+  bool completed;
+  nearby_platform_status status;
+} pending_key_based_pairing;
+
+static void OnSharedSecretCreated(nearby_platform_status status,
+                                  const uint8_t key[ACCOUNT_KEY_SIZE_BYTES]) {
+  if (status != kNearbyStatusOK) {
+    NEARBY_TRACE(ERROR, "Failed to create shared key, error: %d", status);
+  } else {
+    status = HandleRequestWithSharedSecret(
+        pending_key_based_pairing.peer_address,
+        pending_key_based_pairing.request, key);
+    if (status != kNearbyStatusOK) {
+      NEARBY_TRACE(ERROR, "Key based pairing failed, error: %d", status);
+    }
+  }
+  pending_key_based_pairing.in_flight = false;
+  pending_key_based_pairing.completed = true;
+  pending_key_based_pairing.status = status;
+}
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
+
 static nearby_platform_status OnWriteKeyBasedPairing(uint64_t peer_address,
                                                      const uint8_t* request,
                                                      size_t length) {
   nearby_platform_status status;
   uint8_t decrypted_request[ENCRYPTED_REQUEST_LENGTH];
-  uint8_t ble_address[BT_ADDRESS_LENGTH];
-  uint8_t public_address[BT_ADDRESS_LENGTH];
 
   NEARBY_TRACE(VERBOSE, "OnWriteKeyBasedPairing");
   if (pairing_failure_count >= MAX_PAIRING_FAILURE_COUNT) {
@@ -626,19 +722,35 @@ static nearby_platform_status OnWriteKeyBasedPairing(uint64_t peer_address,
       pairing_failure_count = 0;
     }
   }
-  nearby_utils_CopyBigEndian(ble_address, nearby_platform_GetBleAddress(),
-                             BT_ADDRESS_LENGTH);
-  nearby_utils_CopyBigEndian(public_address, nearby_platform_GetPublicAddress(),
-                             BT_ADDRESS_LENGTH);
   // When the device is nondiscoverable, accept a saved account key.
   // or accept a new account key for retroactive pairing
   // When the device is discoverable, we can accept a new account key too.
   if (length == ENCRYPTED_REQUEST_LENGTH + PUBLIC_KEY_LENGTH) {
-    uint8_t key[ACCOUNT_KEY_SIZE_BYTES];
     uint8_t remote_public_key[PUBLIC_KEY_LENGTH];
     memcpy(remote_public_key, request + ENCRYPTED_REQUEST_LENGTH,
            PUBLIC_KEY_LENGTH);
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+    // The ECDH runs on the crypto engine, the request is handled when the
+    // shared secret is ready. Only one request can wait for it, and the
+    // pending one must not be overwritten.
+    if (pending_key_based_pairing.in_flight) {
+      NEARBY_TRACE(WARNING, "Key based pairing already in progress");
+      return kNearbyStatusResourceExhausted;
+    }
+    pending_key_based_pairing.peer_address = peer_address;
+    memcpy(pending_key_based_pairing.request, request,
+           ENCRYPTED_REQUEST_LENGTH);
+    pending_key_based_pairing.in_flight = true;
+    pending_key_based_pairing.completed = false;
+    status = nearby_fp_CreateSharedSecretAsync(remote_public_key,
+                                               OnSharedSecretCreated);
+    if (status != kNearbyStatusOK) {
+      pending_key_based_pairing.in_flight = false;
+    }
+#else
+    uint8_t key[ACCOUNT_KEY_SIZE_BYTES];
     status = nearby_fp_CreateSharedSecret(remote_public_key, key);
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
     if (status != kNearbyStatusOK) {
       NEARBY_TRACE(ERROR, "Failed to create shared key, error: %d", status);
       NEARBY_TRACE(
@@ -646,24 +758,15 @@ static nearby_platform_status OnWriteKeyBasedPairing(uint64_t peer_address,
           nearby_utils_ArrayToString(remote_public_key, PUBLIC_KEY_LENGTH));
       return status;
     }
-    status = nearby_platform_Aes128Decrypt(request, decrypted_request, key);
-    if (status != kNearbyStatusOK) {
-      NEARBY_TRACE(ERROR, "Failed to decrypt request, error: %d", status);
-      return status;
-    }
-    if (!BtAddressMatch(ble_address,
-                        decrypted_request + REQUEST_BT_ADDRESS_OFFSET) &&
-        !BtAddressMatch(public_address,
-                        decrypted_request + REQUEST_BT_ADDRESS_OFFSET)) {
-      NEARBY_TRACE(INFO, "Invalid incoming BT address %s",
-                   nearby_utils_ArrayToString(decrypted_request, 6));
-      AccountKeyRejected();
-      return kNearbyStatusOK;
-    }
-    memcpy(account_key_info.account_key, key, ACCOUNT_KEY_SIZE_BYTES);
-#ifdef NEARBY_FP_ENABLE_SASS
-    account_key_info.peer_address = peer_address;
-#endif /* NEARBY_FP_ENABLE_SASS */
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+    // Report the result to the GATT write if the platform completed the
+    // request right away.
+    return pending_key_based_pairing.completed
+               ? pending_key_based_pairing.status
+               : kNearbyStatusOK;
+#else
+    return HandleRequestWithSharedSecret(peer_address, request, key);
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
   } else if (length == ENCRYPTED_REQUEST_LENGTH) {
     // try each key in the persisted Account Key List
     int num_keys = nearby_fp_GetAccountKeyCount();
@@ -676,10 +779,7 @@ static nearby_platform_status OnWriteKeyBasedPairing(uint64_t peer_address,
         NEARBY_TRACE(ERROR, "Failed to decrypt request, error: %d", status);
         return status;
       }
-      if (BtAddressMatch(ble_address,
-                         decrypted_request + REQUEST_BT_ADDRESS_OFFSET) ||
-          BtAddressMatch(public_address,
-                         decrypted_request + REQUEST_BT_ADDRESS_OFFSET)) {
+      if (IsRequestForThisDevice(decrypted_request)) {
         NEARBY_TRACE(VERBOSE, "Matched key number: %d", i);
         nearby_fp_CopyAccountKey(&account_key_info, i);
 #ifdef NEARBY_FP_ENABLE_SASS
@@ -697,33 +797,13 @@ static nearby_platform_status OnWriteKeyBasedPairing(uint64_t peer_address,
       AccountKeyRejected();
       return kNearbyStatusOK;
     }
+    return FinishKeyBasedPairing(peer_address, decrypted_request);
   } else {
     NEARBY_TRACE(WARNING,
                  "Unexpected key based pairing request length %d Request: %s",
                  length, nearby_utils_ArrayToString(request, length));
     return kNearbyStatusError;
   }
-  pairing_failure_count = 0;
-  gatt_peer_address = peer_address;
-
-  DiscardPendingAccountKey();
-
-  bool extended_response =
-      decrypted_request[0] == KEY_BASED_PAIRING_REQUEST_FLAG &&
-      decrypted_request[1] & KBPR_SEEKER_SUPPORTS_BLE_DEVICES_MASK;
-  status = SendKeyBasedPairingResponse(peer_address, extended_response);
-  if (status != kNearbyStatusOK) return status;
-
-  // TODO(jsobczak): Note that at the end of the packet there is a salt
-  // attached. When possible, these salts should be tracked, and if the
-  // Provider receives a request containing an already used salt, the request
-  // should be ignored to prevent replay attacks.
-  if (decrypted_request[0] == KEY_BASED_PAIRING_REQUEST_FLAG) {
-    return HandleKeyBasedPairingRequest(peer_address, decrypted_request);
-  } else if (decrypted_request[0] == ACTION_REQUEST_FLAG) {
-    return HandleActionRequest(peer_address, decrypted_request);
-  }
-  return kNearbyStatusOK;
 }
 
 static nearby_platform_status NotifyProviderPasskey(uint64_t peer_address) {
@@ -1980,6 +2060,9 @@ nearby_platform_status nearby_fp_client_Init(
   address_rotation_task = NULL;
   peer_public_address = 0;
   DiscardPendingAccountKey();
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+  memset(&pending_key_based_pairing, 0, sizeof(pending_key_based_pairing));
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
 
   status = nearby_platform_OsInit();
   if (status != kNearbyStatusOK) return status;
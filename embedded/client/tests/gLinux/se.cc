@@ -15,6 +15,7 @@
 #include <openssl/bn.h>
 #include <openssl/ec.h>
 #include <openssl/evp.h>
+#include <openssl/hmac.h>
 #include <openssl/sha.h>
 
 #include <cerrno>
@@ -196,6 +197,35 @@ nearby_platform_status nearby_platform_GenSec256r1Secret(
 }
 #endif /* NEARBY_PLATFORM_HAS_SE */
 
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+// Completes the request right away, which the SDK has to handle as well as a
+// later completion.
+nearby_platform_status nearby_platform_GenSec256r1SecretAsync(
+    const uint8_t remote_party_public_key[64],
+    nearby_platform_GenSecretCallback callback) {
+  uint8_t secret[32];
+  nearby_platform_status status =
+      nearby_platform_GenSec256r1Secret(remote_party_public_key, secret);
+  if (status != kNearbyStatusOK) return status;
+  callback(kNearbyStatusOK, secret);
+  return kNearbyStatusOK;
+}
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
+
+#ifdef NEARBY_PLATFORM_HAS_HMAC_SHA256
+nearby_platform_status nearby_platform_HmacSha256(uint8_t out[32],
+                                                  const uint8_t *key,
+                                                  size_t key_length,
+                                                  const uint8_t *data,
+                                                  size_t data_length) {
+  unsigned int out_length = 32;
+  if (NULL == HMAC(EVP_sha256(), key, key_length, data, data_length, out,
+                   &out_length))
+    return kNearbyStatusError;
+  return kNearbyStatusOK;
+}
+#endif /* NEARBY_PLATFORM_HAS_HMAC_SHA256 */
+
 void nearby_test_fakes_SetRandomNumber(unsigned int value) {
   random_value = value;
 }
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <deque>
 #include <iostream>
 #include <vector>
@@ -108,10 +109,12 @@ class MessageStreamTest : public ::testing::Test {
   void SetUp() override;
 
   std::deque<StreamMessage> received_messages_;
+  const uint8_t* last_message_data_ = nullptr;
 
  private:
   void AddMessage(nearby_message_stream_Message* message) {
     received_messages_.emplace_back(StreamMessage(message));
+    last_message_data_ = message->data;
   }
   // To allow access to |AddMessage|
   friend void OnMessageReceived(uint64_t peer_address,
@@ -289,6 +292,60 @@ TEST_F(MessageStreamTest, ReadTwoMessagesByteByByte) {
             received_messages_[1]);
 }
 
+#if NEARBY_MESSAGE_STREAM_ZERO_COPY
+TEST_F(MessageStreamTest, ReadWholeMessageDoesNotCopyPayload) {
+  uint8_t group = 120;
+  uint8_t code = 130;
+  uint8_t message[] = {group, code, 0, 2, 30, 31};
+
+  Read(message, sizeof(message));
+
+  ASSERT_EQ(1, received_messages_.size());
+  ASSERT_EQ(message + kHeaderSize, last_message_data_);
+}
+#endif /* NEARBY_MESSAGE_STREAM_ZERO_COPY */
+
+TEST_F(MessageStreamTest, ReadMessagesSplitBetweenReads) {
+  uint8_t message[] = {120, 130, 0, 3, 30, 31, 32, 121, 131, 0, 1, 33};
+  constexpr size_t kSplit = 6;
+
+  Read(message, kSplit);
+  Read(message + kSplit, sizeof(message) - kSplit);
+
+  ASSERT_EQ(2, received_messages_.size());
+  ASSERT_EQ(StreamMessage(120, 130, {30, 31, 32}), received_messages_[0]);
+  ASSERT_EQ(StreamMessage(121, 131, {33}), received_messages_[1]);
+}
+
+// Reads a long stream of battery updates in reads of arbitrary size, the way
+// they arrive over RFCOMM.
+TEST_F(MessageStreamTest, ReadManyMessages) {
+  constexpr uint8_t kGroup = 3;
+  constexpr uint8_t kCode = 3;
+  constexpr size_t kMessageCount = 1000;
+  constexpr size_t kReadSize = 27;
+  std::vector<uint8_t> stream;
+  for (size_t i = 0; i < kMessageCount; i++) {
+    uint8_t battery = i % 100;
+    stream.insert(stream.end(), {kGroup, kCode, 0, 3, battery,
+                                 (uint8_t)(battery + 1),
+                                 (uint8_t)(battery + 2)});
+  }
+
+  for (size_t offset = 0; offset < stream.size(); offset += kReadSize) {
+    Read(stream.data() + offset, std::min(kReadSize, stream.size() - offset));
+  }
+
+  ASSERT_EQ(kMessageCount, received_messages_.size());
+  for (size_t i = 0; i < kMessageCount; i++) {
+    uint8_t battery = i % 100;
+    ASSERT_EQ(StreamMessage(kGroup, kCode,
+                            {battery, (uint8_t)(battery + 1),
+                             (uint8_t)(battery + 2)}),
+              received_messages_[i]);
+  }
+}
+
 TEST_F(MessageStreamTest, SendMessageNoPayload) {
   nearby_message_stream_Message message{
       .message_group = 10,
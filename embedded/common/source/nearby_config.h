@@ -15,6 +15,17 @@
 #ifndef NEARBY_CONFIG_H
 #define NEARBY_CONFIG_H
 
+// Memory profile of the build. NEARBY_FP_FOOTPRINT_DEFAULT sizes the static
+// tables for a typical headset. NEARBY_FP_FOOTPRINT_SMALL trims them for
+// MCUs with little RAM: a single message stream connection, a single pending
+// retroactive pairing and a shorter personalized name. Every limit below can
+// still be overridden on its own.
+#define NEARBY_FP_FOOTPRINT_DEFAULT 0
+#define NEARBY_FP_FOOTPRINT_SMALL 1
+#ifndef NEARBY_FP_FOOTPRINT_PROFILE
+#define NEARBY_FP_FOOTPRINT_PROFILE NEARBY_FP_FOOTPRINT_DEFAULT
+#endif /* NEARBY_FP_FOOTPRINT_PROFILE */
+
 // Support FP Battery Notification extension
 #ifndef NEARBY_FP_ENABLE_BATTERY_NOTIFICATION
 #define NEARBY_FP_ENABLE_BATTERY_NOTIFICATION 1
@@ -26,7 +37,13 @@
 #endif /* NEARBY_FP_ENABLE_ADDITIONAL_DATA */
 
 // Personalized name max size in bytes
+#ifndef PERSONALIZED_NAME_MAX_SIZE
+#if NEARBY_FP_FOOTPRINT_PROFILE == NEARBY_FP_FOOTPRINT_SMALL
+#define PERSONALIZED_NAME_MAX_SIZE 32
+#else
 #define PERSONALIZED_NAME_MAX_SIZE 64
+#endif
+#endif /* PERSONALIZED_NAME_MAX_SIZE */
 
 // Support FP Message Stream extension
 #ifndef NEARBY_FP_MESSAGE_STREAM
@@ -44,10 +61,25 @@
 
 // The maximum size in bytes of additional data in a message in Message Stream.
 // Bigger payloads will be truncated.
+#ifndef MAX_MESSAGE_STREAM_PAYLOAD_SIZE
 #define MAX_MESSAGE_STREAM_PAYLOAD_SIZE 22
+#endif /* MAX_MESSAGE_STREAM_PAYLOAD_SIZE */
+
+// Hand the complete messages in an RFCOMM read to the message handler straight
+// from the read buffer, instead of copying them to the message stream buffer
+// first. Only partial messages, split between reads, are copied.
+#ifndef NEARBY_MESSAGE_STREAM_ZERO_COPY
+#define NEARBY_MESSAGE_STREAM_ZERO_COPY 1
+#endif /* NEARBY_MESSAGE_STREAM_ZERO_COPY */
 
 // The maximum number of concurrent RFCOMM connections
+#ifndef NEARBY_MAX_RFCOMM_CONNECTIONS
+#if NEARBY_FP_FOOTPRINT_PROFILE == NEARBY_FP_FOOTPRINT_SMALL
+#define NEARBY_MAX_RFCOMM_CONNECTIONS 1
+#else
 #define NEARBY_MAX_RFCOMM_CONNECTIONS 2
+#endif
+#endif /* NEARBY_MAX_RFCOMM_CONNECTIONS */
 
 // Support Retroactive pairing extension
 #ifndef NEARBY_FP_RETROACTIVE_PAIRING
@@ -55,7 +87,13 @@
 #endif /* NEARBY_FP_RETROACTIVE_PAIRING */
 
 // The maximum number of concurrent retroactive pairing process
+#ifndef NEARBY_MAX_RETROACTIVE_PAIRING
+#if NEARBY_FP_FOOTPRINT_PROFILE == NEARBY_FP_FOOTPRINT_SMALL
+#define NEARBY_MAX_RETROACTIVE_PAIRING 1
+#else
 #define NEARBY_MAX_RETROACTIVE_PAIRING 2
+#endif
+#endif /* NEARBY_MAX_RETROACTIVE_PAIRING */
 
 // Is this platform a BLE-only device?
 #ifndef NEARBY_FP_BLE_ONLY
@@ -75,5 +113,9 @@
 #endif /* NEARBY_FP_PREFER_LE_TRANSPORT */
 
 // The maximum number of account keys that can be stored on the device.
+// The Fast Pair spec requires room for at least 5 keys, so the small profile
+// keeps this one.
+#ifndef NEARBY_MAX_ACCOUNT_KEYS
 #define NEARBY_MAX_ACCOUNT_KEYS 5
+#endif /* NEARBY_MAX_ACCOUNT_KEYS */
 #endif /* NEARBY_CONFIG_H */
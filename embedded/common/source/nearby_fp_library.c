@@ -496,6 +496,33 @@ nearby_platform_status nearby_fp_CreateSharedSecret(
   return status;
 }
 
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+static nearby_fp_SharedSecretCallback shared_secret_callback;
+
+static void OnSecretGenerated(nearby_platform_status status,
+                              const uint8_t secret[32]) {
+  uint8_t hash[32] = {0};
+  nearby_fp_SharedSecretCallback callback = shared_secret_callback;
+  shared_secret_callback = NULL;
+  if (status == kNearbyStatusOK) {
+    status = nearby_fp_Sha256(hash, secret, 32);
+  }
+  callback(status, hash);
+}
+
+nearby_platform_status nearby_fp_CreateSharedSecretAsync(
+    const uint8_t remote_public_key[64],
+    nearby_fp_SharedSecretCallback callback) {
+  nearby_platform_status status;
+  if (shared_secret_callback != NULL) return kNearbyStatusResourceExhausted;
+  shared_secret_callback = callback;
+  status = nearby_platform_GenSec256r1SecretAsync(remote_public_key,
+                                                  OnSecretGenerated);
+  if (status != kNearbyStatusOK) shared_secret_callback = NULL;
+  return status;
+}
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
+
 nearby_platform_status nearby_fp_CreateRawKeybasedPairingResponse(
     uint8_t output[AES_MESSAGE_SIZE_BYTES], bool extended_response) {
   int i = 0;
@@ -601,6 +628,9 @@ nearby_platform_status nearby_fp_HmacSha256(uint8_t out[SHA256_KEY_SIZE],
                                             size_t key_length,
                                             const uint8_t* data,
                                             size_t data_length) {
+#ifdef NEARBY_PLATFORM_HAS_HMAC_SHA256
+  return nearby_platform_HmacSha256(out, key, key_length, data, data_length);
+#else
   uint8_t hmac_key[HMAC_SHA256_KEY_SIZE];
   // out = HASH(Key XOR ipad, data)
   PadKey(hmac_key, key, key_length, IPAD);
@@ -608,6 +638,7 @@ nearby_platform_status nearby_fp_HmacSha256(uint8_t out[SHA256_KEY_SIZE],
   // out = HASH(Key XOR opad, out)
   PadKey(hmac_key, key, key_length, OPAD);
   return HmacSha256(out, hmac_key, out, SHA256_KEY_SIZE);
+#endif /* NEARBY_PLATFORM_HAS_HMAC_SHA256 */
 }
 
 nearby_platform_status nearby_fp_HkdfExtractSha256(uint8_t out[SHA256_KEY_SIZE],
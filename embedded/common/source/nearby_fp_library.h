@@ -164,6 +164,26 @@ nearby_platform_status nearby_fp_CreateSharedSecret(
     const uint8_t remote_public_key[64],
     uint8_t output[ACCOUNT_KEY_SIZE_BYTES]);
 
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+// Called with the result of nearby_fp_CreateSharedSecretAsync().
+//
+// status - kNearbyStatusOK if the shared secret was created.
+// key    - The shared secret. Only valid during the call.
+typedef void (*nearby_fp_SharedSecretCallback)(
+    nearby_platform_status status, const uint8_t key[ACCOUNT_KEY_SIZE_BYTES]);
+
+// Creates shared secret from remote public key on the platform crypto engine.
+// Only one request can be in flight, later ones fail with
+// kNearbyStatusResourceExhausted until the callback runs.
+//
+// remote_public_key - 512 bit peer public key.
+// callback          - Receives the shared secret. Not called if this function
+//                     returns an error.
+nearby_platform_status nearby_fp_CreateSharedSecretAsync(
+    const uint8_t remote_public_key[64],
+    nearby_fp_SharedSecretCallback callback);
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
+
 // Creates raw key based paring response.
 //
 // output - Buffer returning the pairing response.
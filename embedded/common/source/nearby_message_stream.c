@@ -32,6 +32,35 @@ void nearby_message_stream_Init(const nearby_message_stream_State* state) {
       state->buffer + sizeof(nearby_message_stream_Metadata);
 }
 
+#if NEARBY_MESSAGE_STREAM_ZERO_COPY
+// Delivers the complete messages at the front of |data| without copying them
+// to the buffer - the message payload points into |data|. Returns the number
+// of bytes consumed.
+static size_t ReadInPlace(const nearby_message_stream_State* state,
+                          const uint8_t* data, size_t length) {
+  uint16_t available_space =
+      state->length - sizeof(nearby_message_stream_Metadata);
+  size_t consumed = 0;
+  while (length - consumed >= HEADER_SIZE) {
+    const uint8_t* header = data + consumed;
+    uint16_t payload_length = (((uint16_t)header[2]) << 8) + header[3];
+    if (length - consumed - HEADER_SIZE < payload_length) break;
+    nearby_message_stream_Message message = {
+        .message_group = header[0],
+        .message_code = header[1],
+        .length = payload_length,
+        .data = (uint8_t*)header + HEADER_SIZE};
+    if (message.length > available_space) {
+      // Message truncated, same as when it is read into the buffer
+      message.length = available_space;
+    }
+    state->on_message_received(state->peer_address, &message);
+    consumed += HEADER_SIZE + payload_length;
+  }
+  return consumed;
+}
+#endif /* NEARBY_MESSAGE_STREAM_ZERO_COPY */
+
 void nearby_message_stream_Read(const nearby_message_stream_State* state,
                                 const uint8_t* data, size_t length) {
   nearby_message_stream_Metadata* metadata =
@@ -40,6 +69,15 @@ void nearby_message_stream_Read(const nearby_message_stream_State* state,
   uint16_t available_space =
       state->length - sizeof(nearby_message_stream_Metadata);
   while (length > 0) {
+#if NEARBY_MESSAGE_STREAM_ZERO_COPY
+    if (metadata->bytes_read == 0) {
+      size_t read = ReadInPlace(state, data, length);
+      data += read;
+      length -= read;
+      if (length == 0) break;
+    }
+#endif /* NEARBY_MESSAGE_STREAM_ZERO_COPY */
+    size_t consumed = 1;
     switch (metadata->bytes_read) {
       case 0:
         message->message_group = *data;
@@ -54,15 +92,20 @@ void nearby_message_stream_Read(const nearby_message_stream_State* state,
         message->length += *data;
         break;
       default: {
+        // Copy as much of the payload as there is in |data| at once
         uint16_t offset = metadata->bytes_read - HEADER_SIZE;
-        if (offset < message->length && offset < available_space) {
-          message->data[offset] = *data;
+        consumed = message->length - offset;
+        if (consumed > length) consumed = length;
+        if (offset < available_space) {
+          size_t stored = available_space - offset;
+          if (stored > consumed) stored = consumed;
+          memcpy(message->data + offset, data, stored);
         }
       }
     }
-    data++;
-    length--;
-    metadata->bytes_read++;
+    data += consumed;
+    length -= consumed;
+    metadata->bytes_read += consumed;
     if (metadata->bytes_read - HEADER_SIZE == message->length) {
       if (message->length > available_space) {
         // Message truncated
@@ -72,6 +72,9 @@ void nearby_message_stream_Init(const nearby_message_stream_State* state);
 // incomplete packets. When the parses reads a complete message, it calls
 // |on_message_received|. If the message payload is too big to fit the buffer -
 // bigger than GetMaxPayloadSize(), then the payload is truncated.
+// With NEARBY_MESSAGE_STREAM_ZERO_COPY, the payload of a message that is
+// complete in |data| points into |data|, so |on_message_received| must not
+// modify it or use it after returning.
 void nearby_message_stream_Read(const nearby_message_stream_State* state,
                                 const uint8_t* data, size_t length);
 
@@ -70,6 +70,48 @@ nearby_platform_status nearby_platform_Aes128Decrypt(
 nearby_platform_status nearby_platform_GenSec256r1Secret(
     const uint8_t remote_party_public_key[64], uint8_t secret[32]);
 
+#ifdef NEARBY_PLATFORM_HAS_ASYNC_SE
+// Called when the shared secret requested with
+// nearby_platform_GenSec256r1SecretAsync() is ready.
+//
+// status - kNearbyStatusOK if the secret was generated.
+// secret - 256 bit shared secret. Only valid during the call.
+typedef void (*nearby_platform_GenSecretCallback)(nearby_platform_status status,
+                                                  const uint8_t secret[32]);
+
+// Starts generating a shared sec256p1 secret on a crypto engine, so that key
+// based pairing doesn't block the SDK thread for the duration of the ECDH.
+// Only used when the platform defines NEARBY_PLATFORM_HAS_ASYNC_SE. The SDK
+// keeps at most one request in flight.
+//
+// The callback must be invoked on the SDK thread, see the threading model
+// in README.md. It may be invoked before this function returns.
+//
+// remote_party_public_key - Remote key.
+// callback                - Completion callback. Not called if this function
+//                           returns an error.
+nearby_platform_status nearby_platform_GenSec256r1SecretAsync(
+    const uint8_t remote_party_public_key[64],
+    nearby_platform_GenSecretCallback callback);
+#endif /* NEARBY_PLATFORM_HAS_ASYNC_SE */
+
+#ifdef NEARBY_PLATFORM_HAS_HMAC_SHA256
+// Computes HMAC-SHA256 on a crypto engine. Only used when the platform defines
+// NEARBY_PLATFORM_HAS_HMAC_SHA256, otherwise the SDK computes the HMAC with
+// nearby_platform_Sha256Start() and friends.
+//
+// out         - Contains the resulting 256 bit HMAC.
+// key         - HMAC key.
+// key_length  - Length of the key. At most 64 bytes.
+// data        - Data to authenticate.
+// data_length - Length of the data.
+nearby_platform_status nearby_platform_HmacSha256(uint8_t out[32],
+                                                  const uint8_t* key,
+                                                  size_t key_length,
+                                                  const uint8_t* data,
+                                                  size_t data_length);
+#endif /* NEARBY_PLATFORM_HAS_HMAC_SHA256 */
+
 // Returns anti-spoofing 128 bit private key.
 // Only used if the implementation also uses the
 // nearby_platform_GenSec256r1Secret() routine defined in gen_secret.c.
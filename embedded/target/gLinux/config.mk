@@ -4,6 +4,10 @@ NEARBY_PLATFORM_USE_MBEDTLS ?= 0
 # Use the hardware SE to generate the secp256r1 secret. Alternatively, generate
 # the secret in software.
 NEARBY_PLATFORM_HAS_SE ?= 1
+# Generate the secp256r1 secret asynchronously, as a crypto engine would.
+NEARBY_PLATFORM_HAS_ASYNC_SE ?= 0
+# Compute HMAC-SHA256 in the platform instead of the SDK.
+NEARBY_PLATFORM_HAS_HMAC_SHA256 ?= 0
 
 CFLAGS_EXTRA ?=
 CFLAGS += -g \
@@ -34,6 +38,14 @@ ifeq ($(NEARBY_PLATFORM_HAS_SE),1)
 CFLAGS += -DNEARBY_PLATFORM_HAS_SE
 endif
 
+ifeq ($(NEARBY_PLATFORM_HAS_ASYNC_SE),1)
+CFLAGS += -DNEARBY_PLATFORM_HAS_ASYNC_SE
+endif
+
+ifeq ($(NEARBY_PLATFORM_HAS_HMAC_SHA256),1)
+CFLAGS += -DNEARBY_PLATFORM_HAS_HMAC_SHA256
+endif
+
 TEST_INCLUDES = \
                 -I$(GTEST_DIR)/include -I$(GTEST_DIR) \
                 -I$(GMOCK_DIR)/include -I$(GMOCK_DIR) \
@@ -15,9 +15,12 @@
 #ifndef THIRD_PARTY_NEARBY_FASTPAIR_COMMON_ACCOUNT_KEY_FILTER_H_
 #define THIRD_PARTY_NEARBY_FASTPAIR_COMMON_ACCOUNT_KEY_FILTER_H_
 
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "fastpair/common/account_key.h"
 #include "fastpair/common/non_discoverable_advertisement.h"
 
@@ -36,7 +39,14 @@ class AccountKeyFilter {
   // Returns true if the `account_key` is possibly in the account key set
   // defined by the filter.
   // Return false if `account_key` is definitely not in set.
-  bool IsPossiblyInSet(const AccountKey& account_key);
+  bool IsPossiblyInSet(const AccountKey& account_key) const;
+
+  // Returns the index of the first of `account_keys` that is possibly in the
+  // account key set defined by the filter, or std::nullopt if none is. Checking
+  // all saved account keys at once avoids rebuilding the salted input for
+  // every key.
+  std::optional<size_t> FindPossiblyInSet(
+      absl::Span<const AccountKey> account_keys) const;
 
  private:
   std::vector<uint8_t> bit_sets_;
@@ -18,6 +18,8 @@
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/types/span.h"
+#include "fastpair/common/account_key.h"
 #include "fastpair/common/battery_notification.h"
 #include "fastpair/common/non_discoverable_advertisement.h"
 
@@ -98,6 +100,26 @@ TEST_F(AccountKeyFilterTest, MissingAccountKey) {
       AccountKeyFilter(filter_1_and_2_, salt_).IsPossiblyInSet(account_key));
 }
 
+TEST_F(AccountKeyFilterTest, FindPossiblyInSet) {
+  const std::vector<uint8_t> bytes{0x12, 0x22, 0x33, 0x44, 0x55, 0x66,
+                                   0x77, 0x88, 0x99, 0x00, 0xAA, 0xBB,
+                                   0xCC, 0xDD, 0xEE, 0xFF};
+  std::vector<AccountKey> account_keys{AccountKey(""), AccountKey(bytes),
+                                       AccountKey(account_key_2_),
+                                       AccountKey(account_key_1_)};
+
+  EXPECT_EQ(AccountKeyFilter(filter_1_, salt_).FindPossiblyInSet(account_keys),
+            3u);
+  EXPECT_EQ(
+      AccountKeyFilter(filter_1_and_2_, salt_).FindPossiblyInSet(account_keys),
+      2u);
+  EXPECT_EQ(AccountKeyFilter(filter_1_, salt_).FindPossiblyInSet(
+                absl::MakeConstSpan(account_keys).first(3)),
+            std::nullopt);
+  EXPECT_EQ(AccountKeyFilter({}, {}).FindPossiblyInSet(account_keys),
+            std::nullopt);
+}
+
 TEST_F(AccountKeyFilterTest, AccountKeyWithBatteryData) {
   std::vector<uint8_t> salt_1 = salt_;
   for (auto& byte : battery_data_) salt_1.push_back(byte);
@@ -22,10 +22,13 @@ using json = ::nlohmann::json;
 }
 
 const char kNearbyFastPairUsersName[] = "nearby_fastpair.users";
+const char kNearbyFastPairDeviceMetadataName[] =
+    "nearby_fastpair.device_metadata";
 
 void RegisterNearbyFastPairPrefs(
     preferences::PreferencesManager* preferences_manager) {
   preferences_manager->Set(kNearbyFastPairUsersName, json::object());
+  preferences_manager->Set(kNearbyFastPairDeviceMetadataName, json::object());
 }
 
 }  // namespace prefs
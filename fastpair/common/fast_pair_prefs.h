@@ -23,6 +23,7 @@ namespace fastpair {
 namespace prefs {
 
 ABSL_CONST_INIT extern const char kNearbyFastPairUsersName[];
+ABSL_CONST_INIT extern const char kNearbyFastPairDeviceMetadataName[];
 
 void RegisterNearbyFastPairPrefs(
     preferences::PreferencesManager* preferences_manager);
@@ -19,6 +19,7 @@
 #include <iterator>
 #include <optional>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #ifdef NEARBY_CHROMIUM
@@ -32,7 +33,10 @@
 #include "fastpair/common/constant.h"
 #include "fastpair/crypto/fast_pair_key_pair.h"
 #include "fastpair/crypto/fast_pair_message_type.h"
+#include "absl/base/thread_annotations.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
 #include <openssl/aes.h>
 #include <openssl/base.h>
 #include <openssl/ec.h>
@@ -65,6 +69,40 @@ bssl::UniquePtr<EC_POINT> GetEcPointFromPublicAntiSpoofingKey(
   return new_ec_point;
 }
 
+// An ephemeral secp256r1 key generated ahead of the key exchange that will use
+// it. Every key is handed out once.
+struct PreparedEcKey {
+  Mutex mutex;
+  bssl::UniquePtr<EC_KEY> key ABSL_GUARDED_BY(mutex);
+};
+
+PreparedEcKey& GetPreparedEcKey() {
+  static PreparedEcKey* prepared_key = new PreparedEcKey();
+  return *prepared_key;
+}
+
+bssl::UniquePtr<EC_KEY> GenerateEcKey() {
+  bssl::UniquePtr<EC_KEY> ec_key(
+      EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
+  if (!EC_KEY_generate_key(ec_key.get())) {
+    NEARBY_LOGS(INFO) << __func__ << ": Failed to generate ec key";
+    return nullptr;
+  }
+  return ec_key;
+}
+
+// Returns the prepared key if there is one, otherwise generates a new key.
+bssl::UniquePtr<EC_KEY> TakeEcKey() {
+  PreparedEcKey& prepared_key = GetPreparedEcKey();
+  {
+    MutexLock lock(&prepared_key.mutex);
+    if (prepared_key.key) {
+      return std::move(prepared_key.key);
+    }
+  }
+  return GenerateEcKey();
+}
+
 // Key derivation function to be used in hashing the generated secret key.
 void* KDF(const void* in, size_t inlen, void* out, size_t* outlen) {
   // Set this to 16 since that's the amount of bytes we want to use
@@ -86,14 +124,11 @@ std::optional<KeyPair> FastPairEncryption::GenerateKeysWithEcdhKeyAgreement(
     return std::nullopt;
   }
 
-  // Generate the secp256r1 key-pair.
+  // Get the secp256r1 key-pair.
   bssl::UniquePtr<EC_GROUP> ec_group(
       EC_GROUP_new_by_curve_name(NID_X9_62_prime256v1));
-  bssl::UniquePtr<EC_KEY> ec_key(
-      EC_KEY_new_by_curve_name(NID_X9_62_prime256v1));
-
-  if (!EC_KEY_generate_key(ec_key.get())) {
-    NEARBY_LOGS(INFO) << __func__ << ": Failed to generate ec key";
+  bssl::UniquePtr<EC_KEY> ec_key = TakeEcKey();
+  if (!ec_key) {
     return std::nullopt;
   }
 
@@ -148,6 +183,25 @@ std::optional<KeyPair> FastPairEncryption::GenerateKeysWithEcdhKeyAgreement(
   return KeyPair(shared_secret_key, public_key);
 }
 
+void FastPairEncryption::PrepareEphemeralKey() {
+  PreparedEcKey& prepared_key = GetPreparedEcKey();
+  {
+    MutexLock lock(&prepared_key.mutex);
+    if (prepared_key.key) {
+      return;
+    }
+  }
+  // Generate outside the lock so a concurrent key exchange doesn't wait on it.
+  bssl::UniquePtr<EC_KEY> ec_key = GenerateEcKey();
+  if (!ec_key) {
+    return;
+  }
+  MutexLock lock(&prepared_key.mutex);
+  if (!prepared_key.key) {
+    prepared_key.key = std::move(ec_key);
+  }
+}
+
 std::array<uint8_t, kAesBlockByteSize> FastPairEncryption::EncryptBytes(
     const std::array<uint8_t, kAesBlockByteSize>& aes_key_bytes,
     const std::array<uint8_t, kAesBlockByteSize>& bytes_to_encrypt) {
@@ -35,6 +35,12 @@ class FastPairEncryption {
   static std::optional<KeyPair> GenerateKeysWithEcdhKeyAgreement(
       std::string_view decoded_public_anti_spoofing);
 
+  // Generates the ephemeral secp256r1 key used by the next
+  // `GenerateKeysWithEcdhKeyAgreement()` call, so that the key exchange only
+  // has to compute the shared secret. Meant to be called off the pairing path,
+  // e.g. when a device is found. Does nothing if a key is already prepared.
+  static void PrepareEphemeralKey();
+
   static std::array<uint8_t, kAesBlockByteSize> EncryptBytes(
       const std::array<uint8_t, kAesBlockByteSize>& aes_key_bytes,
       const std::array<uint8_t, kAesBlockByteSize>& bytes_to_encrypt);
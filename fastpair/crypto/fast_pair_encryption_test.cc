@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <array>
 #include <iterator>
+#include <optional>
 #include <string>
 
 #include "gtest/gtest.h"
@@ -79,6 +80,26 @@ TEST(FastPairEncryptionTest, GenerateKeysWithEcdhKeyAgreement_ValidKey) {
           .has_value());
 }
 
+TEST(FastPairEncryptionTest,
+     GenerateKeysWithEcdhKeyAgreement_UsesEachPreparedKeyOnce) {
+  const std::string anti_spoofing_key =
+      DecodeKey("U2PWc3FHTxah/o0YU9n1VRvtm57SNIRSXOEBXm4fdtMo+06tNoFlt8D0/"
+                "2BsN8auolz5ikwLRvQh+MiQ6oYveg==");
+  FastPairEncryption::PrepareEphemeralKey();
+  // A second call keeps the key that is already prepared.
+  FastPairEncryption::PrepareEphemeralKey();
+
+  std::optional<KeyPair> first =
+      FastPairEncryption::GenerateKeysWithEcdhKeyAgreement(anti_spoofing_key);
+  std::optional<KeyPair> second =
+      FastPairEncryption::GenerateKeysWithEcdhKeyAgreement(anti_spoofing_key);
+
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_NE(first->public_key, second->public_key);
+  EXPECT_NE(first->shared_secret_key, second->shared_secret_key);
+}
+
 }  // namespace
 }  // namespace fastpair
 }  // namespace nearby
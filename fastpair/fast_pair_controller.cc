@@ -180,7 +180,7 @@ void FastPairController::OnBleAddressUpdated(absl::string_view address) {
 }
 
 void FastPairController::OnBatteryUpdated(
-    std::vector<MessageStream::BatteryInfo> battery_levels) {}
+    absl::Span<const MessageStream::BatteryInfo> battery_levels) {}
 void FastPairController::OnRemainingBatteryTime(absl::Duration duration) {}
 bool FastPairController::OnRing(uint8_t components, absl::Duration duration) {
   return false;
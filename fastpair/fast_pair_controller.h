@@ -23,6 +23,7 @@
 
 #include "absl/functional/any_invocable.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "fastpair/common/fast_pair_device.h"
 #include "fastpair/handshake/fast_pair_data_encryptor.h"
 #include "fastpair/handshake/fast_pair_gatt_service_client_impl.h"
@@ -151,7 +152,7 @@ class FastPairController : public MessageStream::Observer {
   void OnModelId(absl::string_view model_id) override;
   void OnBleAddressUpdated(absl::string_view address) override;
   void OnBatteryUpdated(
-      std::vector<MessageStream::BatteryInfo> battery_levels) override;
+      absl::Span<const MessageStream::BatteryInfo> battery_levels) override;
   void OnRemainingBatteryTime(absl::Duration duration) override;
   bool OnRing(uint8_t components, absl::Duration duration) override;
 
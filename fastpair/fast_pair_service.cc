@@ -69,8 +69,8 @@ FastPairService::FastPairService(
       fast_pair_client_(std::make_unique<FastPairClientImpl>(
           authentication_manager_.get(), account_manager_.get(),
           http_client_.get(), &fast_pair_http_notifier_, device_info_.get())),
-      fast_pair_repository_(
-          std::make_unique<FastPairRepositoryImpl>(fast_pair_client_.get())),
+      fast_pair_repository_(std::make_unique<FastPairRepositoryImpl>(
+          fast_pair_client_.get(), preferences_manager_.get())),
       on_device_destroyed_callback_(
           [this](const FastPairDevice& device) { OnDeviceDestroyed(device); }) {
   NearbyFlags::GetInstance().OverrideBoolFlagValue(
@@ -29,6 +29,7 @@
 #include "fastpair/internal/mediums/robust_gatt_client.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_impl.h"
 
 namespace nearby {
 namespace fastpair {
@@ -20,6 +20,7 @@
 #include <utility>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
 #include "fastpair/common/fast_pair_device.h"
 #include "fastpair/common/pair_failure.h"
 #include "fastpair/handshake/fast_pair_data_encryptor.h"
@@ -35,7 +36,8 @@ namespace fastpair {
 //
 // The procedure steps are as follows:
 //  1. Create a GATT connection to the device.
-//  2. Create a data encryptor instance with the generated keys.
+//  2. Create a data encryptor instance with the generated keys, while the GATT
+//  connection is being set up.
 //  3. Write the Key-Based Pairing Request to the characteristic
 //  (https://developers.google.com/nearby/fast-pair/spec#table1.1)
 //  4. Decrypt the response.
@@ -70,8 +72,15 @@ class FastPairHandshake {
     return fast_pair_gatt_service_client_.get();
   }
 
+  // Time from the start of the handshake until the Key-Based Pairing response
+  // was received, if it was.
+  std::optional<absl::Duration> key_based_pairing_response_time() const {
+    return key_based_pairing_response_time_;
+  }
+
  protected:
   bool completed_successfully_ = false;
+  std::optional<absl::Duration> key_based_pairing_response_time_;
   OnCompleteCallback on_complete_callback_;
   std::unique_ptr<FastPairDataEncryptor> fast_pair_data_encryptor_;
   std::unique_ptr<FastPairGattServiceClient> fast_pair_gatt_service_client_;
@@ -20,6 +20,8 @@
 #include <vector>
 
 #include "absl/functional/bind_front.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "fastpair/common/constant.h"
 #include "fastpair/common/pair_failure.h"
 #include "fastpair/handshake/fast_pair_data_encryptor_impl.h"
@@ -27,6 +29,7 @@
 #include "internal/base/bluetooth_address.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/system_clock.h"
 
 namespace nearby {
 namespace fastpair {
@@ -35,13 +38,51 @@ FastPairHandshakeImpl::FastPairHandshakeImpl(FastPairDevice& device,
                                              Mediums& mediums,
                                              OnCompleteCallback on_complete,
                                              SingleThreadExecutor* executor)
-    : FastPairHandshake(std::move(on_complete), nullptr, nullptr) {
+    : FastPairHandshake(std::move(on_complete), nullptr, nullptr),
+      start_time_(SystemClock::ElapsedRealtime()) {
   fast_pair_gatt_service_client_ =
       FastPairGattServiceClientImpl::Factory::Create(device, mediums, executor);
   fast_pair_gatt_service_client_->InitializeGattConnection(
       [&](std::optional<PairFailure> failure) {
         OnGattClientInitializedCallback(device, failure);
       });
+  // The data encryptor doesn't need the GATT connection, so the key exchange
+  // runs while the connection is being set up rather than after it.
+  executor->Execute("create-data-encryptor", [&]() {
+    FastPairDataEncryptorImpl::Factory::CreateAsync(
+        device,
+        [&](std::unique_ptr<FastPairDataEncryptor> fast_pair_data_encryptor) {
+          OnDataEncryptorCreateAsync(device,
+                                     std::move(fast_pair_data_encryptor));
+        });
+  });
+}
+
+void FastPairHandshakeImpl::MaybeWriteRequest(FastPairDevice& device) {
+  if (completed_ || request_written_ || !gatt_initialized_ ||
+      !fast_pair_data_encryptor_) {
+    return;
+  }
+  request_written_ = true;
+  NEARBY_LOGS(INFO) << __func__ << ": Beginning key-based pairing protocol";
+  fast_pair_gatt_service_client_->WriteRequestAsync(
+      /*message_type=*/kKeyBasedPairingType,
+      /*flags=*/kInitialOrSubsequentFlags,
+      /*provider_address=*/device.GetBleAddress(),
+      /*seekers_address=*/"", *fast_pair_data_encryptor_,
+      [&](absl::string_view response, std::optional<PairFailure> failure) {
+        OnWriteResponse(device, response, failure);
+      });
+}
+
+void FastPairHandshakeImpl::Complete(FastPairDevice& device,
+                                     std::optional<PairFailure> failure) {
+  // The GATT connection and the data encryptor may both fail, only the first
+  // failure is reported.
+  if (completed_) return;
+  completed_ = true;
+  completed_successfully_ = !failure.has_value();
+  std::move(on_complete_callback_)(device, failure);
 }
 
 void FastPairHandshakeImpl::OnGattClientInitializedCallback(
@@ -50,18 +91,15 @@ void FastPairHandshakeImpl::OnGattClientInitializedCallback(
     NEARBY_LOGS(WARNING) << __func__
                          << ": Failed to init gatt client with failure = "
                          << failure.value();
-    std::move(on_complete_callback_)(device, failure.value());
+    Complete(device, failure.value());
     return;
   }
 
   NEARBY_LOGS(INFO)
       << __func__
       << ": Fast Pair GATT service client initialization successful.";
-  FastPairDataEncryptorImpl::Factory::CreateAsync(
-      device,
-      [&](std::unique_ptr<FastPairDataEncryptor> fast_pair_data_encryptor) {
-        OnDataEncryptorCreateAsync(device, std::move(fast_pair_data_encryptor));
-      });
+  gatt_initialized_ = true;
+  MaybeWriteRequest(device);
 }
 
 void FastPairHandshakeImpl::OnDataEncryptorCreateAsync(
@@ -70,21 +108,12 @@ void FastPairHandshakeImpl::OnDataEncryptorCreateAsync(
   if (!fast_pair_data_encryptor) {
     NEARBY_LOGS(WARNING) << __func__
                          << ": Failed to create Fast Pair Data Encryptor.";
-    std::move(on_complete_callback_)(device,
-                                     PairFailure::kDataEncryptorRetrieval);
+    Complete(device, PairFailure::kDataEncryptorRetrieval);
     return;
   }
 
   fast_pair_data_encryptor_ = std::move(fast_pair_data_encryptor);
-  NEARBY_LOGS(INFO) << __func__ << ": Beginning key-based pairing protocol";
-  fast_pair_gatt_service_client_->WriteRequestAsync(
-      /*message_type=*/kKeyBasedPairingType,
-      /*flags=*/kInitialOrSubsequentFlags,
-      /*provider_address=*/device.GetBleAddress(),
-      /*seekers_address=*/"", *fast_pair_data_encryptor_,
-      [&](absl::string_view response, std::optional<PairFailure> failure) {
-        OnWriteResponse(device, response, failure);
-      });
+  MaybeWriteRequest(device);
 }
 
 void FastPairHandshakeImpl::OnWriteResponse(
@@ -95,17 +124,20 @@ void FastPairHandshakeImpl::OnWriteResponse(
         << __func__
         << ": Failed during key-based pairing protocol with failure = "
         << failure.value();
-    std::move(on_complete_callback_)(device, failure.value());
+    Complete(device, failure.value());
     return;
   }
 
-  NEARBY_LOGS(INFO) << __func__ << ": Successfully wrote response.";
+  key_based_pairing_response_time_ =
+      SystemClock::ElapsedRealtime() - start_time_;
+  NEARBY_LOGS(INFO) << __func__ << ": Successfully wrote response. Received "
+                    << "the key-based pairing response after "
+                    << *key_based_pairing_response_time_;
 
   if (response.size() != kAesBlockByteSize) {
     NEARBY_LOGS(WARNING)
         << __func__ << ": Handshake failed because of incorrect response size.";
-    std::move(on_complete_callback_)(
-        device, PairFailure::kKeybasedPairingResponseDecryptFailure);
+    Complete(device, PairFailure::kKeybasedPairingResponseDecryptFailure);
     return;
   }
 
@@ -121,8 +153,7 @@ void FastPairHandshakeImpl::OnParseDecryptedResponse(
   if (!response.has_value()) {
     NEARBY_LOGS(WARNING) << __func__
                          << ": Missing decrypted response from parse.";
-    std::move(on_complete_callback_)(
-        device, PairFailure::kKeybasedPairingResponseDecryptFailure);
+    Complete(device, PairFailure::kKeybasedPairingResponseDecryptFailure);
     return;
   }
   NEARBY_LOGS(INFO) << __func__
@@ -130,8 +161,7 @@ void FastPairHandshakeImpl::OnParseDecryptedResponse(
 
   device.SetPublicAddress(
       device::CanonicalizeBluetoothAddress(response->address_bytes));
-  completed_successfully_ = true;
-  std::move(on_complete_callback_)(device, std::nullopt);
+  Complete(device, std::nullopt);
 }
 
 }  // namespace fastpair
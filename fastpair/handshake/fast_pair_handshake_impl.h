@@ -18,11 +18,13 @@
 #include <memory>
 #include <optional>
 
+#include "absl/time/time.h"
 #include "fastpair/common/fast_pair_device.h"
 #include "fastpair/common/pair_failure.h"
 #include "fastpair/crypto/decrypted_response.h"
 #include "fastpair/handshake/fast_pair_handshake.h"
 #include "fastpair/internal/mediums/mediums.h"
+#include "internal/platform/single_thread_executor.h"
 
 namespace nearby {
 namespace fastpair {
@@ -36,6 +38,10 @@ class FastPairHandshakeImpl : public FastPairHandshake {
   FastPairHandshakeImpl& operator=(const FastPairHandshakeImpl&) = delete;
 
  private:
+  // Writes the Key-Based Pairing request once both the GATT connection and the
+  // data encryptor are ready.
+  void MaybeWriteRequest(FastPairDevice& device);
+  void Complete(FastPairDevice& device, std::optional<PairFailure> failure);
   void OnGattClientInitializedCallback(FastPairDevice& device,
                                        std::optional<PairFailure> failure);
   void OnDataEncryptorCreateAsync(
@@ -45,6 +51,12 @@ class FastPairHandshakeImpl : public FastPairHandshake {
                        std::optional<PairFailure> failure);
   void OnParseDecryptedResponse(FastPairDevice& device,
                                 std::optional<DecryptedResponse>& response);
+
+  const absl::Time start_time_;
+  // These are only accessed on the executor.
+  bool gatt_initialized_ = false;
+  bool request_written_ = false;
+  bool completed_ = false;
 };
 
 }  // namespace fastpair
@@ -221,6 +221,7 @@ TEST_F(FastPairHandshakeImplTest, Success) {
       &executor_);
   latch.Await();
   EXPECT_TRUE(handshake_->completed_successfully());
+  EXPECT_TRUE(handshake_->key_based_pairing_response_time().has_value());
 }
 
 TEST_F(FastPairHandshakeImplTest, GattError) {
@@ -279,6 +280,7 @@ TEST_F(FastPairHandshakeImplTest, WriteResponseError) {
       &executor_);
   latch.Await();
   EXPECT_FALSE(handshake_->completed_successfully());
+  EXPECT_FALSE(handshake_->key_based_pairing_response_time().has_value());
 }
 
 TEST_F(FastPairHandshakeImplTest, WriteResponseWrongSize) {
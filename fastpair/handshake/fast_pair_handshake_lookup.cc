@@ -14,13 +14,17 @@
 
 #include "fastpair/handshake/fast_pair_handshake_lookup.h"
 
+#include <algorithm>
 #include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "fastpair/handshake/fast_pair_handshake_impl.h"
+#include "internal/platform/system_clock.h"
 
 namespace nearby {
 namespace fastpair {
@@ -43,14 +47,33 @@ FastPairHandshakeLookup* FastPairHandshakeLookup::GetInstance() {
 
 // static Create function override which can be set by tests.
 void FastPairHandshakeLookup::SetCreateFunctionForTesting(
-    CreateFunction create_function) {
+    std::optional<CreateFunction> create_function) {
   g_test_create_function = std::move(create_function);
 }
 
 FastPairHandshake* FastPairHandshakeLookup::Get(FastPairDevice* device) {
   absl::MutexLock lock(&mutex_);
   auto it = fast_pair_handshakes_.find(device);
-  return it != fast_pair_handshakes_.end() ? it->second.get() : nullptr;
+  if (it != fast_pair_handshakes_.end()) {
+    return it->second.get();
+  }
+  EraseExpiredLocked();
+  auto retained = std::find_if(
+      retained_handshakes_.begin(), retained_handshakes_.end(),
+      [device](const RetainedHandshake& retained) {
+        return retained.protocol == device->GetProtocol() &&
+               ((!device->GetBleAddress().empty() &&
+                 retained.ble_address == device->GetBleAddress()) ||
+                (device->GetPublicAddress().has_value() &&
+                 retained.public_address == device->GetPublicAddress()));
+      });
+  if (retained == retained_handshakes_.end()) {
+    return nullptr;
+  }
+  FastPairHandshake* handshake = retained->handshake.get();
+  fast_pair_handshakes_.emplace(device, std::move(retained->handshake));
+  retained_handshakes_.erase(retained);
+  return handshake;
 }
 
 FastPairHandshake* FastPairHandshakeLookup::Get(absl::string_view address) {
@@ -81,9 +104,42 @@ bool FastPairHandshakeLookup::Erase(absl::string_view address) {
   return false;
 }
 
+bool FastPairHandshakeLookup::Retain(FastPairDevice* device,
+                                     absl::Duration timeout) {
+  absl::MutexLock lock(&mutex_);
+  auto node = fast_pair_handshakes_.extract(device);
+  if (node.empty() || !node.mapped()->completed_successfully()) {
+    return false;
+  }
+  retained_handshakes_.push_back(RetainedHandshake{
+      .ble_address = std::string(device->GetBleAddress()),
+      .public_address = device->GetPublicAddress(),
+      .protocol = device->GetProtocol(),
+      .expiry = SystemClock::ElapsedRealtime() + timeout,
+      .handshake = std::move(node.mapped()),
+  });
+  return true;
+}
+
+void FastPairHandshakeLookup::EraseExpired() {
+  absl::MutexLock lock(&mutex_);
+  EraseExpiredLocked();
+}
+
+void FastPairHandshakeLookup::EraseExpiredLocked() {
+  absl::Time now = SystemClock::ElapsedRealtime();
+  retained_handshakes_.erase(
+      std::remove_if(retained_handshakes_.begin(), retained_handshakes_.end(),
+                     [now](const RetainedHandshake& retained) {
+                       return retained.expiry <= now;
+                     }),
+      retained_handshakes_.end());
+}
+
 void FastPairHandshakeLookup::Clear() {
   absl::MutexLock lock(&mutex_);
   fast_pair_handshakes_.clear();
+  retained_handshakes_.clear();
 }
 
 FastPairHandshake* FastPairHandshakeLookup::Create(
@@ -18,12 +18,16 @@
 #include <functional>
 #include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "fastpair/common/fast_pair_device.h"
 #include "fastpair/common/pair_failure.h"
+#include "fastpair/common/protocol.h"
 #include "fastpair/handshake/fast_pair_handshake.h"
 #include "fastpair/internal/mediums/mediums.h"
 
@@ -45,14 +49,17 @@ class FastPairHandshakeLookup {
   // stored in the static field.
   static FastPairHandshakeLookup* GetInstance();
 
-  static void SetCreateFunctionForTesting(CreateFunction create_function);
+  static void SetCreateFunctionForTesting(
+      std::optional<CreateFunction> create_function);
 
   // Singletons should not be cloneable.
   FastPairHandshakeLookup(const FastPairHandshakeLookup&) = delete;
   // Singletons should not be assignable.
   FastPairHandshakeLookup& operator=(const FastPairHandshakeLookup&) = delete;
 
-  // Get an existing instance for |FastPairdevice|.
+  // Get an existing instance for |FastPairdevice|. If there is none, a
+  // handshake retained for a device with the same address and protocol is
+  // handed over to |FastPairdevice|.
   FastPairHandshake* Get(FastPairDevice* device);
 
   // Get an existing instance for |address|.
@@ -64,6 +71,15 @@ class FastPairHandshakeLookup {
   // Erases the FastPairHandshake instance for |FastPairdevice| if it exists.
   bool Erase(absl::string_view address);
 
+  // Keeps the handshake of |FastPairdevice| for |timeout| once its pairing
+  // flow is done, if the handshake completed successfully, so that the next
+  // pairing attempt with the same device reuses its GATT connection and keys.
+  // Otherwise erases it. Returns true if the handshake is kept.
+  bool Retain(FastPairDevice* device, absl::Duration timeout);
+
+  // Erases the retained FastPairHandshake instances whose timeout passed.
+  void EraseExpired();
+
   // Deletes all existing FastPairHandshake instances.
   void Clear();
 
@@ -82,11 +98,24 @@ class FastPairHandshakeLookup {
   ~FastPairHandshakeLookup() = default;
 
  private:
+  // A completed handshake no longer tied to a |FastPairDevice|. The device
+  // may be gone by now, so it is matched by address.
+  struct RetainedHandshake {
+    std::string ble_address;
+    std::optional<std::string> public_address;
+    Protocol protocol;
+    absl::Time expiry;
+    std::unique_ptr<FastPairHandshake> handshake;
+  };
+
+  void EraseExpiredLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   static absl::Mutex mutex_;
   static FastPairHandshakeLookup* instance_ ABSL_GUARDED_BY(mutex_);
 
   absl::flat_hash_map<FastPairDevice*, std::unique_ptr<FastPairHandshake>>
       fast_pair_handshakes_ ABSL_GUARDED_BY(mutex_);
+  std::vector<RetainedHandshake> retained_handshakes_ ABSL_GUARDED_BY(mutex_);
 };
 }  // namespace fastpair
 }  // namespace nearby
@@ -17,12 +17,15 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "fastpair/common/fast_pair_device.h"
 #include "fastpair/common/pair_failure.h"
 #include "fastpair/common/protocol.h"
+#include "fastpair/handshake/fast_pair_handshake.h"
 #include "fastpair/internal/mediums/mediums.h"
 #include "internal/platform/count_down_latch.h"
 #include "internal/platform/medium_environment.h"
@@ -33,6 +36,15 @@ namespace {
 constexpr absl::string_view kValidModelId("718c17");
 constexpr absl::string_view kPubliceAddress("public_address");
 
+class FakeFastPairHandshake : public FastPairHandshake {
+ public:
+  explicit FakeFastPairHandshake(
+      FastPairHandshakeLookup::OnCompleteCallback callback)
+      : FastPairHandshake(std::move(callback), nullptr, nullptr) {
+    completed_successfully_ = true;
+  }
+};
+
 class MediumEnvironmentStarter {
  public:
   MediumEnvironmentStarter() { MediumEnvironment::Instance().Start(); }
@@ -145,6 +157,70 @@ TEST_F(FastPairHandshakeLookupTest, ClearAllFastPairHandshakeInstances) {
   EXPECT_FALSE(FastPairHandshakeLookup::GetInstance()->Get(device_));
 }
 
+TEST_F(FastPairHandshakeLookupTest, ReusesRetainedHandshakeForSameAddress) {
+  FastPairHandshakeLookup::SetCreateFunctionForTesting(
+      [](FastPairDevice& device, Mediums& mediums,
+         FastPairHandshakeLookup::OnCompleteCallback callback) {
+        return std::make_unique<FakeFastPairHandshake>(std::move(callback));
+      });
+  Mediums mediums;
+  FastPairHandshake* handshake = FastPairHandshakeLookup::GetInstance()->Create(
+      *device_, mediums, [](FastPairDevice&, std::optional<PairFailure>) {},
+      &executor_);
+
+  EXPECT_TRUE(FastPairHandshakeLookup::GetInstance()->Retain(
+      device_, absl::Minutes(1)));
+  EXPECT_FALSE(FastPairHandshakeLookup::GetInstance()->Get(device_));
+
+  FastPairDevice retroactive_device(kValidModelId, provider_address_,
+                                    Protocol::kFastPairRetroactivePairing);
+  EXPECT_FALSE(
+      FastPairHandshakeLookup::GetInstance()->Get(&retroactive_device));
+  FastPairDevice same_device(kValidModelId, provider_address_,
+                             Protocol::kFastPairInitialPairing);
+  EXPECT_EQ(FastPairHandshakeLookup::GetInstance()->Get(&same_device),
+            handshake);
+  // The handshake now belongs to |same_device|.
+  EXPECT_EQ(FastPairHandshakeLookup::GetInstance()->Get(&same_device),
+            handshake);
+
+  FastPairHandshakeLookup::GetInstance()->Clear();
+  FastPairHandshakeLookup::SetCreateFunctionForTesting(std::nullopt);
+}
+
+TEST_F(FastPairHandshakeLookupTest, DropsRetainedHandshakeAfterTimeout) {
+  FastPairHandshakeLookup::SetCreateFunctionForTesting(
+      [](FastPairDevice& device, Mediums& mediums,
+         FastPairHandshakeLookup::OnCompleteCallback callback) {
+        return std::make_unique<FakeFastPairHandshake>(std::move(callback));
+      });
+  Mediums mediums;
+  FastPairHandshakeLookup::GetInstance()->Create(
+      *device_, mediums, [](FastPairDevice&, std::optional<PairFailure>) {},
+      &executor_);
+
+  EXPECT_TRUE(FastPairHandshakeLookup::GetInstance()->Retain(
+      device_, absl::ZeroDuration()));
+  FastPairHandshakeLookup::GetInstance()->EraseExpired();
+
+  FastPairDevice same_device(kValidModelId, provider_address_,
+                             Protocol::kFastPairInitialPairing);
+  EXPECT_FALSE(FastPairHandshakeLookup::GetInstance()->Get(&same_device));
+  FastPairHandshakeLookup::SetCreateFunctionForTesting(std::nullopt);
+}
+
+TEST_F(FastPairHandshakeLookupTest, DoesNotRetainFailedHandshake) {
+  CreateFastPairHandshkeInstanceForDevice(*device_);
+
+  EXPECT_FALSE(FastPairHandshakeLookup::GetInstance()->Retain(
+      device_, absl::Minutes(1)));
+
+  FastPairDevice same_device(kValidModelId, provider_address_,
+                             Protocol::kFastPairInitialPairing);
+  EXPECT_FALSE(FastPairHandshakeLookup::GetInstance()->Get(device_));
+  EXPECT_FALSE(FastPairHandshakeLookup::GetInstance()->Get(&same_device));
+}
+
 }  // namespace
 }  // namespace fastpair
 }  // namespace nearby
@@ -29,6 +29,7 @@
 #include "internal/platform/ble_v2.h"
 #include "internal/platform/implementation/ble_v2.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_impl.h"
 namespace nearby {
 namespace fastpair {
 
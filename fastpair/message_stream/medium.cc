@@ -121,9 +121,11 @@ void Medium::RunLoop(BluetoothSocket socket) {
     if (!payload.ok() || payload.result().size() != length) {
       break;
     }
-    observer_.OnReceived(Message{.message_group = group,
-                                 .message_code = code,
-                                 .payload = std::string(payload.result())});
+    // Moves the payload out of the read buffer instead of copying it.
+    observer_.OnReceived(
+        Message{.message_group = group,
+                .message_code = code,
+                .payload = std::string(std::move(payload).result())});
   }
   socket.Close();
   if (!cancellation_flag_.Cancelled()) {
@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/time/time.h"
 #include "fastpair/message_stream/message.h"
 #include "internal/platform/bluetooth_utils.h"
@@ -215,11 +216,12 @@ bool MessageStream::HandleDeviceInformationEvent(const Message& message) {
             << " but is " << message.payload.size();
         break;
       }
-      std::vector<BatteryInfo> battery_levels(message.payload.size());
-      for (size_t i = 0; i < message.payload.size(); i++) {
-        battery_levels[i] = ConvertBatteryInfo(message.payload[i]);
+      // Battery updates are frequent, keep them off the heap.
+      absl::InlinedVector<BatteryInfo, kMaxBatteryLevels> battery_levels;
+      for (char battery_value : message.payload) {
+        battery_levels.push_back(ConvertBatteryInfo(battery_value));
       }
-      observer_.OnBatteryUpdated(std::move(battery_levels));
+      observer_.OnBatteryUpdated(battery_levels);
       return true;
     }
     case MessageCode::kRemainingBatteryTime: {
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/types/span.h"
 #include "fastpair/message_stream/medium.h"
 #include "fastpair/message_stream/message.h"
 #include "internal/platform/implementation/device_info.h"
@@ -52,7 +53,9 @@ class MessageStream : public Medium::Observer {
     // `address` is in canonical, human-readable format.
     virtual void OnBleAddressUpdated(absl::string_view address) = 0;
 
-    virtual void OnBatteryUpdated(std::vector<BatteryInfo> battery_levels) = 0;
+    // `battery_levels` is only valid during the call.
+    virtual void OnBatteryUpdated(
+        absl::Span<const BatteryInfo> battery_levels) = 0;
 
     virtual void OnRemainingBatteryTime(absl::Duration duration) = 0;
 
@@ -0,0 +1,81 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
+#include "fastpair/common/fast_pair_device.h"
+#include "fastpair/common/protocol.h"
+#include "fastpair/message_stream/message.h"
+#include "fastpair/message_stream/message_stream.h"
+
+namespace nearby {
+namespace fastpair {
+namespace {
+
+// Counts the battery levels it is told about, and ignores everything else.
+class CountingObserver : public MessageStream::Observer {
+ public:
+  void OnConnectionResult(absl::Status result) override {}
+  void OnDisconnected(absl::Status status) override {}
+  void OnEnableSilenceMode(bool enable) override {}
+  void OnLogBufferFull() override {}
+  void OnModelId(absl::string_view model_id) override {}
+  void OnBleAddressUpdated(absl::string_view address) override {}
+  void OnBatteryUpdated(
+      absl::Span<const MessageStream::BatteryInfo> battery_levels) override {
+    battery_levels_ += battery_levels.size();
+  }
+  void OnRemainingBatteryTime(absl::Duration duration) override {}
+  bool OnRing(uint8_t components, absl::Duration duration) override {
+    return true;
+  }
+
+  int64_t battery_levels() const { return battery_levels_; }
+
+ private:
+  int64_t battery_levels_ = 0;
+};
+
+// Headsets send battery updates continuously, with one byte per battery.
+void BM_BatteryUpdated(benchmark::State& state) {
+  FastPairDevice device("model id", "ble address",
+                        Protocol::kFastPairRetroactivePairing);
+  CountingObserver observer;
+  MessageStream message_stream(device, std::nullopt, observer);
+  // Charging, at 100%.
+  const std::string payload(state.range(0), '\xE4');
+
+  for (auto _ : state) {
+    message_stream.OnReceived(
+        Message{.message_group = MessageGroup::kDeviceInformationEvent,
+                .message_code = MessageCode::kBatteryUpdated,
+                .payload = payload});
+  }
+  benchmark::DoNotOptimize(observer.battery_levels());
+  state.SetItemsProcessed(state.iterations());
+}
+// Left bud, right bud and case.
+BENCHMARK(BM_BatteryUpdated)->DenseRange(1, 3);
+
+}  // namespace
+}  // namespace fastpair
+}  // namespace nearby
@@ -28,6 +28,7 @@
 #include "absl/strings/escaping.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "fastpair/common/constant.h"
 #include "fastpair/common/fast_pair_device.h"
 #include "fastpair/message_stream/fake_medium_observer.h"
@@ -78,8 +79,9 @@ class FakeObserver : public MessageStream::Observer {
   }
 
   void OnBatteryUpdated(
-      std::vector<MessageStream::BatteryInfo> battery_levels) override {
-    battery_levels_.Set(battery_levels);
+      absl::Span<const MessageStream::BatteryInfo> battery_levels) override {
+    battery_levels_.Set(std::vector<MessageStream::BatteryInfo>(
+        battery_levels.begin(), battery_levels.end()));
   }
 
   void OnRemainingBatteryTime(absl::Duration duration) override {
@@ -449,6 +451,39 @@ FUZZ_TEST(MessageStreamFuzzTest, HandlesAnyMessage)
     .WithDomains(AnyMessageGroup(), AnyMessageCode(),
                  fuzztest::Arbitrary<std::string>());
 
+void ReportsEveryBatteryLevel(absl::string_view payload) {
+  FastPairDevice fp_device("model id", "ble address",
+                           Protocol::kFastPairRetroactivePairing);
+  FakeObserver observer;
+  MessageStream message_stream(fp_device, std::nullopt, observer);
+  message_stream.OnReceived(
+      Message{.message_group = MessageGroup::kDeviceInformationEvent,
+              .message_code = MessageCode::kBatteryUpdated,
+              .payload = std::string(payload)});
+
+  // Updates with more than three batteries are dropped.
+  if (payload.size() > 3) {
+    EXPECT_FALSE(observer.battery_levels_.IsSet());
+    return;
+  }
+  ASSERT_TRUE(observer.battery_levels_.IsSet());
+  std::vector<MessageStream::BatteryInfo> battery_levels =
+      observer.battery_levels_.Get().result();
+  ASSERT_EQ(battery_levels.size(), payload.size());
+  for (size_t i = 0; i < payload.size(); i++) {
+    uint8_t value = payload[i];
+    EXPECT_EQ(battery_levels[i].is_charging, (value & 0x80) != 0);
+    if ((value & 0x7F) == 0x7F) {
+      EXPECT_FALSE(battery_levels[i].level.has_value());
+    } else {
+      EXPECT_EQ(battery_levels[i].level, value & 0x7F);
+    }
+  }
+}
+
+FUZZ_TEST(MessageStreamFuzzTest, ReportsEveryBatteryLevel)
+    .WithDomains(fuzztest::Arbitrary<std::string>().WithMaxSize(4));
+
 }  // namespace
 }  // namespace fastpair
 }  // namespace nearby
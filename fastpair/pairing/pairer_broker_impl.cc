@@ -33,6 +33,10 @@ constexpr int kMaxFailureRetryCount = 3;
 constexpr int kMaxNumHandshakeAttempts = 3;
 constexpr absl::Duration kCancelPairingRetryDelay = absl::Seconds(1);
 constexpr absl::Duration kRetryHandshakeDelay = absl::Seconds(1);
+// How long a completed handshake is kept for another pairing attempt. The
+// provider only accepts pairing for a short time after the Key-Based Pairing
+// request.
+constexpr absl::Duration kRetainedHandshakeTimeout = absl::Seconds(10);
 }  // namespace
 
 PairerBrokerImpl::PairerBrokerImpl(Mediums& medium,
@@ -291,7 +295,8 @@ void PairerBrokerImpl::OnFastPairProcedureComplete(FastPairDevice& device) {
   NEARBY_LOGS(INFO) << __func__ << ": Device=" << device;
   executor_->Execute("EraseHandshakeAndPairers",
                      [&]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_) {
-                       EraseHandshakeAndPairers(device);
+                       EraseHandshakeAndPairers(device,
+                                                /*retain_handshake=*/true);
                      });
   for (auto& observer : observers_.GetObservers()) {
     observer->OnPairingComplete(device);
@@ -310,14 +315,23 @@ void PairerBrokerImpl::OnFastPairProcedureComplete(FastPairDevice& device) {
   }
 }
 
-void PairerBrokerImpl::EraseHandshakeAndPairers(FastPairDevice& device) {
+void PairerBrokerImpl::EraseHandshakeAndPairers(FastPairDevice& device,
+                                                bool retain_handshake) {
   MutexLock lock(&mutex_);
   NEARBY_LOGS(WARNING) << __func__;
   // |fast_pair_pairers_| and its children objects depend on the handshake
   // instance. Shut them down before destroying the handshake.
   pair_failure_counts_.erase(device.GetModelId());
   fast_pair_pairers_.erase(device.GetModelId());
-  FastPairHandshakeLookup::GetInstance()->Erase(&device);
+  if (retain_handshake && FastPairHandshakeLookup::GetInstance()->Retain(
+                              &device, kRetainedHandshakeTimeout)) {
+    retained_handshake_timer_ = std::make_unique<TimerImpl>();
+    retained_handshake_timer_->Start(
+        kRetainedHandshakeTimeout / absl::Milliseconds(1), 0,
+        []() { FastPairHandshakeLookup::GetInstance()->EraseExpired(); });
+  } else {
+    FastPairHandshakeLookup::GetInstance()->Erase(&device);
+  }
   did_handshake_previously_complete_successfully_map_.insert_or_assign(
       std::string(device.GetModelId()), false);
 }
@@ -71,7 +71,10 @@ class PairerBrokerImpl : public PairerBroker {
   void OnAccountKeyFailure(FastPairDevice& device, PairFailure failure)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_);
 
-  void EraseHandshakeAndPairers(FastPairDevice& device)
+  // If |retain_handshake| is true, a successful handshake is kept for a
+  // while so that pairing with the device again can reuse it.
+  void EraseHandshakeAndPairers(FastPairDevice& device,
+                                bool retain_handshake = false)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_);
 
   Mediums& medium_;
@@ -94,6 +97,7 @@ class PairerBrokerImpl : public PairerBroker {
   // Timer
   std::unique_ptr<TimerImpl> cancel_pairing_timer_;
   std::unique_ptr<TimerImpl> retry_handshake_timer_;
+  std::unique_ptr<TimerImpl> retained_handshake_timer_;
 
   ObserverList<Observer> observers_;
 };
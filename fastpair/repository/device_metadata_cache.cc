@@ -0,0 +1,135 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "fastpair/repository/device_metadata_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "fastpair/common/device_metadata.h"
+#include "fastpair/common/fast_pair_prefs.h"
+#include "fastpair/proto/fastpair_rpcs.proto.h"
+#include "internal/platform/clock.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/preferences/preferences_manager.h"
+
+namespace nearby {
+namespace fastpair {
+namespace {
+using json = ::nlohmann::json;
+
+constexpr char kMetadataKey[] = "metadata";
+constexpr char kFetchTimeKey[] = "fetch_time";
+}  // namespace
+
+DeviceMetadataCache::DeviceMetadataCache(
+    preferences::PreferencesManager* preferences_manager, const Clock* clock,
+    size_t max_size, absl::Duration ttl)
+    : preferences_manager_(preferences_manager),
+      clock_(clock),
+      max_size_(std::max<size_t>(max_size, 1)),
+      ttl_(ttl) {
+  Load();
+}
+
+std::optional<DeviceMetadataCache::Entry> DeviceMetadataCache::Get(
+    absl::string_view hex_model_id) const {
+  MutexLock lock(&mutex_);
+  auto it = entries_.find(hex_model_id);
+  if (it == entries_.end()) return std::nullopt;
+  return Entry{.metadata = it->second.metadata,
+               .is_stale = clock_->Now() - it->second.fetch_time >= ttl_};
+}
+
+void DeviceMetadataCache::Put(absl::string_view hex_model_id,
+                              const DeviceMetadata& metadata) {
+  MutexLock lock(&mutex_);
+  auto it = entries_.find(hex_model_id);
+  if (it == entries_.end() && entries_.size() >= max_size_) {
+    EvictOldest();
+  }
+  entries_.insert_or_assign(
+      std::string(hex_model_id),
+      CachedMetadata{.metadata = metadata, .fetch_time = clock_->Now()});
+  Persist();
+}
+
+void DeviceMetadataCache::Load() {
+  if (preferences_manager_ == nullptr) return;
+  json cache = preferences_manager_->Get(
+      prefs::kNearbyFastPairDeviceMetadataName, json::object());
+  if (!cache.is_object()) return;
+
+  MutexLock lock(&mutex_);
+  for (const auto& [hex_model_id, value] : cache.items()) {
+    if (!value.is_object() || !value.contains(kMetadataKey) ||
+        !value[kMetadataKey].is_string() || !value.contains(kFetchTimeKey) ||
+        !value[kFetchTimeKey].is_number_integer()) {
+      continue;
+    }
+    std::string serialized;
+    proto::GetObservedDeviceResponse response;
+    if (!absl::WebSafeBase64Unescape(value[kMetadataKey].get<std::string>(),
+                                     &serialized) ||
+        !response.ParseFromString(serialized)) {
+      NEARBY_LOGS(WARNING) << __func__
+                           << ": Dropping unreadable cached metadata for model "
+                           << hex_model_id;
+      continue;
+    }
+    entries_.insert_or_assign(
+        hex_model_id,
+        CachedMetadata{.metadata = DeviceMetadata(std::move(response)),
+                       .fetch_time = absl::FromUnixMillis(
+                           value[kFetchTimeKey].get<int64_t>())});
+  }
+  // The size bound may have shrunk since the cache was persisted.
+  while (entries_.size() > max_size_) {
+    EvictOldest();
+  }
+  NEARBY_LOGS(INFO) << __func__ << ": Loaded " << entries_.size()
+                    << " cached device metadata.";
+}
+
+void DeviceMetadataCache::EvictOldest() {
+  auto oldest = std::min_element(
+      entries_.begin(), entries_.end(), [](const auto& a, const auto& b) {
+        return a.second.fetch_time < b.second.fetch_time;
+      });
+  entries_.erase(oldest);
+}
+
+void DeviceMetadataCache::Persist() const {
+  if (preferences_manager_ == nullptr) return;
+  json cache = json::object();
+  for (const auto& [hex_model_id, cached] : entries_) {
+    cache[hex_model_id] = {
+        {kMetadataKey, absl::WebSafeBase64Escape(
+                           cached.metadata.GetResponse().SerializeAsString())},
+        {kFetchTimeKey, absl::ToUnixMillis(cached.fetch_time)}};
+  }
+  preferences_manager_->Set(prefs::kNearbyFastPairDeviceMetadataName, cache);
+}
+
+}  // namespace fastpair
+}  // namespace nearby
@@ -0,0 +1,89 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_NEARBY_FASTPAIR_REPOSITORY_DEVICE_METADATA_CACHE_H_
+#define THIRD_PARTY_NEARBY_FASTPAIR_REPOSITORY_DEVICE_METADATA_CACHE_H_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "fastpair/common/device_metadata.h"
+#include "internal/platform/clock.h"
+#include "internal/platform/mutex.h"
+#include "internal/preferences/preferences_manager.h"
+
+namespace nearby {
+namespace fastpair {
+
+// Caches the device metadata downloaded for a model id, so that discovering a
+// known model doesn't wait on a server round trip.
+//
+// The cache holds at most `max_size` entries and evicts the least recently
+// fetched one. Entries older than `ttl` are still returned, but marked
+// stale so that the caller refreshes them. If a preferences manager is
+// given, the cache is persisted across restarts.
+class DeviceMetadataCache {
+ public:
+  static constexpr size_t kDefaultMaxSize = 32;
+  static constexpr absl::Duration kDefaultTtl = absl::Hours(24 * 7);
+
+  struct Entry {
+    DeviceMetadata metadata;
+    bool is_stale;
+  };
+
+  // `preferences_manager` may be null for an in-memory only cache.
+  DeviceMetadataCache(preferences::PreferencesManager* preferences_manager,
+                      const Clock* clock, size_t max_size = kDefaultMaxSize,
+                      absl::Duration ttl = kDefaultTtl);
+  DeviceMetadataCache(const DeviceMetadataCache&) = delete;
+  DeviceMetadataCache& operator=(const DeviceMetadataCache&) = delete;
+
+  std::optional<Entry> Get(absl::string_view hex_model_id) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Stores `metadata` as freshly fetched, and persists the cache.
+  void Put(absl::string_view hex_model_id, const DeviceMetadata& metadata)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct CachedMetadata {
+    DeviceMetadata metadata;
+    absl::Time fetch_time;
+  };
+
+  void Load() ABSL_LOCKS_EXCLUDED(mutex_);
+  void EvictOldest() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void Persist() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  preferences::PreferencesManager* const preferences_manager_;
+  const Clock* const clock_;
+  const size_t max_size_;
+  const absl::Duration ttl_;
+
+  mutable Mutex mutex_;
+  absl::flat_hash_map<std::string, CachedMetadata> entries_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace fastpair
+}  // namespace nearby
+
+#endif  // THIRD_PARTY_NEARBY_FASTPAIR_REPOSITORY_DEVICE_METADATA_CACHE_H_
@@ -0,0 +1,127 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "fastpair/repository/device_metadata_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "fastpair/common/device_metadata.h"
+#include "fastpair/common/fast_pair_prefs.h"
+#include "fastpair/proto/fastpair_rpcs.proto.h"
+#include "internal/preferences/preferences_manager.h"
+#include "internal/test/fake_clock.h"
+
+namespace nearby {
+namespace fastpair {
+namespace {
+
+constexpr char kPreferencesFilePath[] = "Google/Nearby/FastPair";
+constexpr int64_t kModelId1 = 0x718C17;
+constexpr int64_t kModelId2 = 0x9ADB11;
+constexpr int64_t kModelId3 = 0x2A3B4C;
+constexpr absl::Duration kTtl = absl::Hours(1);
+
+DeviceMetadata CreateMetadata(int64_t model_id) {
+  proto::GetObservedDeviceResponse response;
+  response.mutable_device()->set_id(model_id);
+  return DeviceMetadata(response);
+}
+
+class DeviceMetadataCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    preferences_manager_ =
+        std::make_unique<preferences::PreferencesManager>(kPreferencesFilePath);
+    prefs::RegisterNearbyFastPairPrefs(preferences_manager_.get());
+  }
+
+  std::unique_ptr<DeviceMetadataCache> CreateCache(size_t max_size = 2) {
+    return std::make_unique<DeviceMetadataCache>(preferences_manager_.get(),
+                                                 &clock_, max_size, kTtl);
+  }
+
+  FakeClock clock_;
+  std::unique_ptr<preferences::PreferencesManager> preferences_manager_;
+};
+
+TEST_F(DeviceMetadataCacheTest, ReturnsCachedMetadata) {
+  auto cache = CreateCache();
+  EXPECT_FALSE(cache->Get("718C17").has_value());
+
+  cache->Put("718C17", CreateMetadata(kModelId1));
+
+  std::optional<DeviceMetadataCache::Entry> entry = cache->Get("718C17");
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->metadata.GetDetails().id(), kModelId1);
+  EXPECT_FALSE(entry->is_stale);
+}
+
+TEST_F(DeviceMetadataCacheTest, MarksOldMetadataStale) {
+  auto cache = CreateCache();
+  cache->Put("718C17", CreateMetadata(kModelId1));
+
+  clock_.FastForward(kTtl);
+
+  std::optional<DeviceMetadataCache::Entry> entry = cache->Get("718C17");
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_TRUE(entry->is_stale);
+
+  cache->Put("718C17", CreateMetadata(kModelId1));
+  EXPECT_FALSE(cache->Get("718C17")->is_stale);
+}
+
+TEST_F(DeviceMetadataCacheTest, EvictsTheOldestMetadata) {
+  auto cache = CreateCache(/*max_size=*/2);
+  cache->Put("718C17", CreateMetadata(kModelId1));
+  clock_.FastForward(absl::Seconds(1));
+  cache->Put("9ADB11", CreateMetadata(kModelId2));
+  clock_.FastForward(absl::Seconds(1));
+  cache->Put("2A3B4C", CreateMetadata(kModelId3));
+
+  EXPECT_FALSE(cache->Get("718C17").has_value());
+  EXPECT_TRUE(cache->Get("9ADB11").has_value());
+  EXPECT_TRUE(cache->Get("2A3B4C").has_value());
+}
+
+TEST_F(DeviceMetadataCacheTest, RestoresPersistedMetadata) {
+  CreateCache()->Put("718C17", CreateMetadata(kModelId1));
+  clock_.FastForward(kTtl);
+
+  auto cache = CreateCache();
+  std::optional<DeviceMetadataCache::Entry> entry = cache->Get("718C17");
+
+  ASSERT_TRUE(entry.has_value());
+  EXPECT_EQ(entry->metadata.GetDetails().id(), kModelId1);
+  // The fetch time is persisted too.
+  EXPECT_TRUE(entry->is_stale);
+}
+
+TEST(DeviceMetadataCacheWithoutPreferencesTest, KeepsMetadataInMemory) {
+  FakeClock clock;
+  DeviceMetadataCache cache(/*preferences_manager=*/nullptr, &clock);
+
+  cache.Put("718C17", CreateMetadata(kModelId1));
+
+  EXPECT_TRUE(cache.Get("718C17").has_value());
+}
+
+}  // namespace
+}  // namespace fastpair
+}  // namespace nearby
@@ -14,6 +14,7 @@
 
 #include "fastpair/repository/fast_pair_repository_impl.h"
 
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -22,12 +23,18 @@
 
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "fastpair/common/account_key.h"
 #include "fastpair/common/device_metadata.h"
 #include "fastpair/proto/data.proto.h"
+#include "fastpair/repository/device_metadata_cache.h"
 #include "fastpair/proto/enum.proto.h"
 #include "fastpair/proto/proto_builder.h"
+#include "internal/platform/clock.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/preferences/preferences_manager.h"
 
 namespace nearby {
 namespace fastpair {
@@ -72,8 +79,12 @@ bool IsDeviceSha256Matched(const proto::FastPairDevice& device,
 }
 }  // namespace
 
-FastPairRepositoryImpl::FastPairRepositoryImpl(FastPairClient* fast_pair_client)
-    : fast_pair_client_(fast_pair_client) {}
+FastPairRepositoryImpl::FastPairRepositoryImpl(
+    FastPairClient* fast_pair_client,
+    preferences::PreferencesManager* preferences_manager, Clock* clock)
+    : metadata_cache_(preferences_manager,
+                      clock != nullptr ? clock : &system_clock_),
+      fast_pair_client_(fast_pair_client) {}
 
 void FastPairRepositoryImpl::AddObserver(Observer* observer) {
   observers_.AddObserver(observer);
@@ -86,6 +97,31 @@ void FastPairRepositoryImpl::RemoveObserver(Observer* observer) {
 void FastPairRepositoryImpl::GetDeviceMetadata(
     absl::string_view hex_model_id, DeviceMetadataCallback callback) {
   NEARBY_LOGS(INFO) << __func__ << " with model id= " << hex_model_id;
+  cache_executor_.Execute(
+      "Get Cached Device Metadata",
+      [this, hex_model_id = std::string(hex_model_id),
+       callback = std::move(callback)]() mutable {
+        std::optional<DeviceMetadataCache::Entry> entry =
+            metadata_cache_.Get(hex_model_id);
+        if (!entry.has_value()) {
+          FetchDeviceMetadata(hex_model_id, std::move(callback));
+          return;
+        }
+        NEARBY_LOGS(INFO) << __func__ << ": Found cached device metadata.";
+        callback(std::move(entry->metadata));
+        if (!entry->is_stale) return;
+
+        // Stale metadata is still served, and refreshed in the background.
+        {
+          MutexLock lock(&mutex_);
+          if (!refreshing_model_ids_.insert(hex_model_id).second) return;
+        }
+        FetchDeviceMetadata(hex_model_id, /*callback=*/nullptr);
+      });
+}
+
+void FastPairRepositoryImpl::FetchDeviceMetadata(
+    absl::string_view hex_model_id, DeviceMetadataCallback callback) {
   executor_.Execute(
       "Get Device Metadata", [this, hex_model_id = std::string(hex_model_id),
                               callback = std::move(callback)]() mutable {
@@ -97,17 +133,20 @@ void FastPairRepositoryImpl::GetDeviceMetadata(
         request.set_mode(proto::GetObservedDeviceRequest::MODE_RELEASE);
         absl::StatusOr<proto::GetObservedDeviceResponse> response =
             fast_pair_client_->GetObservedDevice(request);
+        std::optional<DeviceMetadata> metadata;
         if (response.ok()) {
           NEARBY_LOGS(WARNING) << "Got GetObservedDeviceResponse from backend.";
-          metadata_cache_[hex_model_id] =
-              std::make_unique<DeviceMetadata>(response.value());
-          // TODO(b/289139378) : save device's metadata in local cache.
-          callback(*metadata_cache_[hex_model_id]);
+          metadata.emplace(*std::move(response));
+          metadata_cache_.Put(hex_model_id, *metadata);
         } else {
           NEARBY_LOGS(WARNING)
               << "Failed to get GetObservedDeviceResponse from backend.";
-          callback(std::nullopt);
         }
+        {
+          MutexLock lock(&mutex_);
+          refreshing_model_ids_.erase(hex_model_id);
+        }
+        if (callback) callback(std::move(metadata));
       });
 }
 
@@ -222,21 +261,29 @@ void FastPairRepositoryImpl::CheckIfAssociatedWithCurrentAccount(
     absl::StatusOr<proto::UserReadDevicesResponse> response =
         fast_pair_client_->UserReadDevices(request);
     if (response.ok()) {
+      std::vector<AccountKey> account_keys;
+      std::vector<const proto::FastPairDevice*> devices;
       for (const auto& info : response->fast_pair_info()) {
         if (!info.has_device()) {
           continue;
         }
-        AccountKey account_key(info.device().account_key());
-        if (!account_key_filter.IsPossiblyInSet(account_key)) {
-          continue;
-        }
+        account_keys.emplace_back(info.device().account_key());
+        devices.push_back(&info.device());
+      }
+      // Check all saved account keys against the filter in one pass.
+      size_t offset = 0;
+      while (std::optional<size_t> match =
+                 account_key_filter.FindPossiblyInSet(
+                     absl::MakeConstSpan(account_keys).subspan(offset))) {
+        size_t index = offset + *match;
         proto::StoredDiscoveryItem device;
-        if (device.ParseFromString(info.device().discovery_item_bytes())) {
+        if (device.ParseFromString(devices[index]->discovery_item_bytes())) {
           NEARBY_LOGS(INFO)
               << "Account key matched with a paired device: " << device.title();
-          std::move(callback)(account_key, device.id());
+          std::move(callback)(account_keys[index], device.id());
           return;
         }
+        offset = index + 1;
       }
     }
     NEARBY_LOGS(INFO) << "Account key does not match any paired devices.";
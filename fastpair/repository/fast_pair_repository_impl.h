@@ -18,19 +18,31 @@
 #include <memory>
 #include <string>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 #include "fastpair/common/device_metadata.h"
+#include "fastpair/repository/device_metadata_cache.h"
 #include "fastpair/repository/fast_pair_repository.h"
 #include "fastpair/server_access/fast_pair_client.h"
 #include "internal/base/observer_list.h"
+#include "internal/platform/clock.h"
+#include "internal/platform/clock_impl.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/single_thread_executor.h"
+#include "internal/preferences/preferences_manager.h"
 
 namespace nearby {
 namespace fastpair {
 
 class FastPairRepositoryImpl : public FastPairRepository {
  public:
-  explicit FastPairRepositoryImpl(FastPairClient* fast_pair_client);
+  // Device metadata is persisted in `preferences_manager` if given. `clock`
+  // defaults to the system clock.
+  explicit FastPairRepositoryImpl(
+      FastPairClient* fast_pair_client,
+      preferences::PreferencesManager* preferences_manager = nullptr,
+      Clock* clock = nullptr);
 
   FastPairRepositoryImpl(const FastPairRepositoryImpl&) = delete;
   FastPairRepositoryImpl& operator=(const FastPairRepositoryImpl&) = delete;
@@ -58,11 +70,23 @@ class FastPairRepositoryImpl : public FastPairRepository {
                               OperationCallback callback) override;
 
  private:
+  // Downloads the metadata of `hex_model_id` into the cache, and hands it to
+  // `callback` if given.
+  void FetchDeviceMetadata(absl::string_view hex_model_id,
+                           DeviceMetadataCallback callback);
+
+  ClockImpl system_clock_;
+  DeviceMetadataCache metadata_cache_;
+  Mutex mutex_;
+  // Model ids whose stale cached metadata is being refreshed.
+  absl::flat_hash_set<std::string> refreshing_model_ids_
+      ABSL_GUARDED_BY(mutex_);
   // A thread for running blocking tasks.
   SingleThreadExecutor executor_;
+  // Serves cached metadata without waiting behind server requests. Declared
+  // after `executor_`, which its tasks post to, so that it is destroyed first.
+  SingleThreadExecutor cache_executor_;
   FastPairClient* fast_pair_client_;
-  absl::flat_hash_map<std::string, std::unique_ptr<DeviceMetadata>>
-      metadata_cache_;
   ObserverList<FastPairRepository::Observer> observers_;
 };
 }  // namespace fastpair
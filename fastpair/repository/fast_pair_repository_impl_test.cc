@@ -27,8 +27,10 @@
 #include "fastpair/proto/data.proto.h"
 #include "fastpair/proto/fast_pair_string.proto.h"
 #include "fastpair/proto/proto_builder.h"
+#include "fastpair/repository/device_metadata_cache.h"
 #include "fastpair/server_access/fake_fast_pair_client.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/test/fake_clock.h"
 
 namespace nearby {
 namespace fastpair {
@@ -133,6 +135,89 @@ TEST(FastPairRepositoryImplTest, FailedToDownloadMetadata) {
   latch.Await();
 }
 
+TEST(FastPairRepositoryImplTest, ServesCachedMetadataWithoutServerRequest) {
+  FakeFastPairClient fake_fast_pair_client;
+  FakeClock clock;
+  auto fast_pair_repository = std::make_unique<FastPairRepositoryImpl>(
+      &fake_fast_pair_client, /*preferences_manager=*/nullptr, &clock);
+  proto::GetObservedDeviceResponse response_proto;
+  response_proto.mutable_strings()->set_initial_pairing_description(
+      kInitialPairingdescription);
+  fake_fast_pair_client.SetGetObservedDeviceResponse(response_proto);
+  CountDownLatch download_latch(1);
+  fast_pair_repository->GetDeviceMetadata(
+      kHexModelId, [&](std::optional<DeviceMetadata> device_metadata) {
+        EXPECT_TRUE(device_metadata.has_value());
+        download_latch.CountDown();
+      });
+  download_latch.Await();
+
+  // The server is no longer reachable, but the metadata is cached.
+  fake_fast_pair_client.SetGetObservedDeviceResponse(
+      absl::InternalError("No response"));
+  CountDownLatch cached_latch(1);
+  fast_pair_repository->GetDeviceMetadata(
+      kHexModelId, [&](std::optional<DeviceMetadata> device_metadata) {
+        ASSERT_TRUE(device_metadata.has_value());
+        EXPECT_THAT(device_metadata->GetResponse(),
+                    MatchesProto(response_proto));
+        cached_latch.CountDown();
+      });
+  cached_latch.Await();
+}
+
+TEST(FastPairRepositoryImplTest, RefreshesStaleMetadataInTheBackground) {
+  FakeFastPairClient fake_fast_pair_client;
+  FakeClock clock;
+  auto fast_pair_repository = std::make_unique<FastPairRepositoryImpl>(
+      &fake_fast_pair_client, /*preferences_manager=*/nullptr, &clock);
+  proto::GetObservedDeviceResponse old_response;
+  old_response.mutable_strings()->set_initial_pairing_description("old");
+  fake_fast_pair_client.SetGetObservedDeviceResponse(old_response);
+  CountDownLatch download_latch(1);
+  fast_pair_repository->GetDeviceMetadata(
+      kHexModelId, [&](std::optional<DeviceMetadata> device_metadata) {
+        download_latch.CountDown();
+      });
+  download_latch.Await();
+
+  clock.FastForward(DeviceMetadataCache::kDefaultTtl);
+  proto::GetObservedDeviceResponse new_response;
+  new_response.mutable_strings()->set_initial_pairing_description("new");
+  fake_fast_pair_client.SetGetObservedDeviceResponse(new_response);
+
+  // The stale metadata is served right away.
+  CountDownLatch stale_latch(1);
+  fast_pair_repository->GetDeviceMetadata(
+      kHexModelId, [&](std::optional<DeviceMetadata> device_metadata) {
+        ASSERT_TRUE(device_metadata.has_value());
+        EXPECT_THAT(device_metadata->GetResponse(), MatchesProto(old_response));
+        stale_latch.CountDown();
+      });
+  stale_latch.Await();
+
+  // Wait for the refresh, which runs before any later server request.
+  fake_fast_pair_client.SetUserReadDevicesResponse(
+      absl::InternalError("No response"));
+  CountDownLatch refresh_latch(1);
+  fast_pair_repository->GetDeviceMetadata(
+      kHexModelId, [&](std::optional<DeviceMetadata> device_metadata) {
+        fast_pair_repository->IsDeviceSavedToAccount(
+            kPublicAddress,
+            [&](absl::Status status) { refresh_latch.CountDown(); });
+      });
+  refresh_latch.Await();
+
+  CountDownLatch fresh_latch(1);
+  fast_pair_repository->GetDeviceMetadata(
+      kHexModelId, [&](std::optional<DeviceMetadata> device_metadata) {
+        ASSERT_TRUE(device_metadata.has_value());
+        EXPECT_THAT(device_metadata->GetResponse(), MatchesProto(new_response));
+        fresh_latch.CountDown();
+      });
+  fresh_latch.Await();
+}
+
 TEST(FastPairRepositoryImplTest, GetUserSavedDevicesSuccess) {
   FakeFastPairClient fake_fast_pair_client;
   auto fast_pair_repository =
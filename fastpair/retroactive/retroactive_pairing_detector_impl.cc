@@ -19,10 +19,17 @@
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "fastpair/internal/mediums/mediums.h"
 #include "fastpair/repository/fast_pair_repository.h"
 #include "internal/platform/implementation/account_manager.h"
+#include "internal/platform/system_clock.h"
 
 namespace nearby {
 namespace fastpair {
@@ -87,17 +94,61 @@ void RetroactivePairingDetectorImpl::DevicePairedChanged(
     return;
   }
 
-  FastPairRepository::Get()->IsDeviceSavedToAccount(
-      device.GetMacAddress(),
-      [this, mac_address = device.GetMacAddress()](absl::Status status) {
-        if (status.ok()) {
-          NEARBY_LOGS(VERBOSE) << __func__
-                               << ": Ignoring because device is already saved "
-                                  "to the current account.";
-          return;
-        }
-        NotifyRetroactiveDeviceFound(mac_address);
-      });
+  if (!AddCandidate(device.GetMacAddress())) {
+    NEARBY_LOGS(INFO) << __func__ << ": Ignoring known candidate.";
+    return;
+  }
+  StartAccountLookups();
+}
+
+bool RetroactivePairingDetectorImpl::AddCandidate(
+    absl::string_view mac_address) {
+  absl::Time now = SystemClock::ElapsedRealtime();
+  absl::MutexLock lock(&mutex_);
+  absl::erase_if(candidates_, [now](const auto& candidate) {
+    return now - candidate.second >= kCandidateTtl;
+  });
+  if (!candidates_.emplace(absl::AsciiStrToUpper(mac_address), now).second) {
+    return false;
+  }
+  pending_lookups_.push_back(std::string(mac_address));
+  return true;
+}
+
+void RetroactivePairingDetectorImpl::StartAccountLookups() {
+  std::vector<std::string> addresses;
+  {
+    absl::MutexLock lock(&mutex_);
+    while (lookups_in_flight_ < kMaxConcurrentAccountLookups &&
+           !pending_lookups_.empty()) {
+      addresses.push_back(std::move(pending_lookups_.front()));
+      pending_lookups_.pop_front();
+      ++lookups_in_flight_;
+    }
+  }
+  // Outside of the lock, in case the repository calls back right away.
+  for (const std::string& address : addresses) {
+    FastPairRepository::Get()->IsDeviceSavedToAccount(
+        address, [this, address](absl::Status status) {
+          OnAccountLookupDone(address, status);
+        });
+  }
+}
+
+void RetroactivePairingDetectorImpl::OnAccountLookupDone(
+    absl::string_view mac_address, absl::Status status) {
+  if (status.ok()) {
+    NEARBY_LOGS(VERBOSE) << __func__
+                         << ": Ignoring because device is already saved "
+                            "to the current account.";
+  } else {
+    NotifyRetroactiveDeviceFound(mac_address);
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    --lookups_in_flight_;
+  }
+  StartAccountLookups();
 }
 
 void RetroactivePairingDetectorImpl::NotifyRetroactiveDeviceFound(
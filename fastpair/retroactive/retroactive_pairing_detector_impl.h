@@ -15,7 +15,15 @@
 #ifndef THIRD_PARTY_NEARBY_FASTPAIR_RETROACTIVE_RETROACTIVE_PAIRING_DETECTOR_IMPL_H_
 #define THIRD_PARTY_NEARBY_FASTPAIR_RETROACTIVE_RETROACTIVE_PAIRING_DETECTOR_IMPL_H_
 
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "fastpair/internal/mediums/mediums.h"
 #include "fastpair/repository/fast_pair_device_repository.h"
 #include "fastpair/retroactive/retroactive_pairing_detector.h"
@@ -50,12 +58,38 @@ class RetroactivePairingDetectorImpl
                            bool new_paired_status) override;
 
  private:
+  // A device paired again within this long of its first pairing event is the
+  // same candidate, and isn't looked up again.
+  static constexpr absl::Duration kCandidateTtl = absl::Minutes(1);
+  // Caps the account lookups running at a time, so that a storm of pairing
+  // events doesn't turn into a storm of requests and retroactive pairings.
+  static constexpr int kMaxConcurrentAccountLookups = 2;
+
+  // Queues the lookup of |mac_address| in the user's account, unless it is a
+  // known candidate. Returns false if it is.
+  bool AddCandidate(absl::string_view mac_address)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Starts the queued lookups there is room for.
+  void StartAccountLookups() ABSL_LOCKS_EXCLUDED(mutex_);
+  void OnAccountLookupDone(absl::string_view mac_address, absl::Status status)
+      ABSL_LOCKS_EXCLUDED(mutex_);
   void NotifyRetroactiveDeviceFound(absl::string_view mac_address);
+
   Mediums& mediums_;
   ObserverList<RetroactivePairingDetector::Observer> observers_;
   FastPairDeviceRepository* repository_;
   AccountManager* account_manager_;
   SingleThreadExecutor* executor_;
+
+  absl::Mutex mutex_;
+  // When each candidate was first seen, by upper-case MAC address. Entries
+  // older than |kCandidateTtl| are dropped on the next pairing event.
+  absl::flat_hash_map<std::string, absl::Time> candidates_
+      ABSL_GUARDED_BY(mutex_);
+  // The MAC addresses of the candidates waiting for room to be looked up in the
+  // user's account.
+  std::deque<std::string> pending_lookups_ ABSL_GUARDED_BY(mutex_);
+  int lookups_in_flight_ ABSL_GUARDED_BY(mutex_) = 0;
 };
 
 }  // namespace fastpair
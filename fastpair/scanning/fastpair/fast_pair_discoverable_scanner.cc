@@ -28,6 +28,7 @@
 #include "fastpair/common/constant.h"
 #include "fastpair/common/fast_pair_device.h"
 #include "fastpair/common/protocol.h"
+#include "fastpair/crypto/fast_pair_encryption.h"
 #include "fastpair/dataparser/fast_pair_data_parser.h"
 #include "fastpair/proto/fastpair_rpcs.pb.h"
 #include "fastpair/repository/fast_pair_repository.h"
@@ -197,6 +198,10 @@ void FastPairDiscoverableScanner::OnDeviceMetadataRetrieved(
                 device_repository_->AddDevice(std::move(fast_pair_device));
             NotifyDeviceFound(*device);
           });
+  // Pairing with the device starts with a key exchange, get its key ready
+  // before the user taps the notification.
+  executor_->Execute("prepare-ephemeral-key",
+                     []() { FastPairEncryption::PrepareEphemeralKey(); });
 }
 
 void FastPairDiscoverableScanner::NotifyDeviceFound(FastPairDevice& device) {
@@ -22,6 +22,8 @@
 #include "fastpair/common/constant.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
 
 namespace nearby {
 namespace fastpair {
@@ -30,6 +32,10 @@ namespace {
 constexpr absl::Duration kFastPairLowPowerActiveSeconds = absl::Seconds(2);
 constexpr absl::Duration kFastPairLowPowerInactiveSeconds = absl::Seconds(3);
 constexpr char kFastPairServiceUuid[] = "0000FE2C-0000-1000-8000-00805F9B34FB";
+// A device keeps repeating the same advertisement, and the observers only need
+// to parse it once. It is still passed on again after this long, so that an
+// observer whose lookup failed gets another chance.
+constexpr absl::Duration kRepeatedAdvertisementInterval = absl::Seconds(10);
 
 class ScanningSessionImpl : public FastPairScanner::ScanningSession {
  public:
@@ -137,25 +143,40 @@ void FastPairScannerImpl::StartTimer(absl::Duration delay,
 }
 
 void FastPairScannerImpl::OnDeviceFound(const BlePeripheral& peripheral) {
-  NEARBY_LOGS(INFO) << __func__ << "Found device with ble Address = "
-                    << peripheral.GetName();
   std::string service_data =
       peripheral.GetAdvertisementBytes(kServiceId).string_data();
   if (service_data.empty()) {
     NEARBY_LOGS(WARNING) << "No Fast Pair service data found on device";
     return;
   }
+  if (!IsNewAdvertisement(peripheral.GetName(), std::move(service_data))) {
+    return;
+  }
 
-  device_address_advertisement_data_map_[peripheral.GetName()].insert(
-      service_data);
-
+  NEARBY_LOGS(INFO) << __func__ << "Found device with ble Address = "
+                    << peripheral.GetName();
   NotifyDeviceFound(peripheral);
 }
 
+bool FastPairScannerImpl::IsNewAdvertisement(const std::string& address,
+                                             std::string service_data) {
+  absl::Time now = SystemClock::ElapsedRealtime();
+  MutexLock lock(&mutex_);
+  auto [it, inserted] = device_address_advertisement_data_map_[address]
+                            .try_emplace(std::move(service_data), now);
+  if (inserted) return true;
+  if (now - it->second < kRepeatedAdvertisementInterval) return false;
+  it->second = now;
+  return true;
+}
+
 void FastPairScannerImpl::OnDeviceLost(const BlePeripheral& peripheral) {
   NEARBY_LOGS(INFO) << __func__ << "Lost device with ble Address = "
                     << peripheral.GetName();
-  device_address_advertisement_data_map_.erase(peripheral.GetName());
+  {
+    MutexLock lock(&mutex_);
+    device_address_advertisement_data_map_.erase(peripheral.GetName());
+  }
 
   for (auto& observer : observer_.GetObservers()) {
     observer->OnDeviceLost(peripheral);
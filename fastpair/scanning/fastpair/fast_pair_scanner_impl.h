@@ -16,13 +16,16 @@
 #define THIRD_PARTY_NEARBY_FASTPAIR_SCANNING_FASTPAIR_FAST_PAIR_SCANNER_IMPL_H_
 
 #include <memory>
-#include <set>
 #include <string>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
 #include "fastpair/internal/mediums/mediums.h"
 #include "fastpair/scanning/fastpair/fast_pair_scanner.h"
 #include "internal/base/observer_list.h"
 #include "internal/platform/bluetooth_adapter.h"
+#include "internal/platform/mutex.h"
 #include "internal/platform/single_thread_executor.h"
 #include "internal/platform/timer_impl.h"
 
@@ -58,15 +61,20 @@ class FastPairScannerImpl : public FastPairScanner {
   void PauseScanning() ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_);
   void StartTimer(absl::Duration delay, absl::AnyInvocable<void()> callback)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_);
+  // Returns false if the same advertisement of the device was already passed
+  // on to the observers recently.
+  bool IsNewAdvertisement(const std::string& address, std::string service_data)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   Mediums& mediums_;
   SingleThreadExecutor* executor_;
   std::unique_ptr<TimerImpl> timer_ ABSL_GUARDED_BY(*executor_);
 
-  // Map of a Bluetooth device address to a set of advertisement data we have
-  // seen.
-  absl::flat_hash_map<std::string, std::set<std::string>>
-      device_address_advertisement_data_map_;
+  Mutex mutex_;
+  // Map of a Bluetooth device address to the advertisement data we have seen,
+  // with the time each was last passed on to the observers.
+  absl::flat_hash_map<std::string, absl::flat_hash_map<std::string, absl::Time>>
+      device_address_advertisement_data_map_ ABSL_GUARDED_BY(mutex_);
   ObserverList<FastPairScanner::Observer> observer_;
 };
 
@@ -26,6 +26,7 @@
 #include "internal/platform/bluetooth_adapter.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/count_down_latch.h"
+#include "internal/platform/implementation/ble.h"
 #include "internal/platform/medium_environment.h"
 #include "internal/platform/single_thread_executor.h"
 
@@ -62,6 +63,39 @@ class FastPairScannerObserver : public FastPairScanner::Observer {
   CountDownLatch* lost_latch_ = nullptr;
 };
 
+class FakeBlePeripheral : public api::BlePeripheral {
+ public:
+  FakeBlePeripheral(absl::string_view name, absl::string_view service_data)
+      : name_(name), service_data_(service_data) {}
+
+  std::string GetName() const override { return name_; }
+  ByteArray GetAdvertisementBytes(
+      const std::string& service_id) const override {
+    return ByteArray(service_data_);
+  }
+
+  void SetServiceData(absl::string_view service_data) {
+    service_data_ = std::string(service_data);
+  }
+
+ private:
+  std::string name_;
+  std::string service_data_;
+};
+
+class CountingScannerObserver : public FastPairScanner::Observer {
+ public:
+  void OnDeviceFound(const BlePeripheral& peripheral) override {
+    found_count_++;
+  }
+  void OnDeviceLost(const BlePeripheral& peripheral) override {}
+
+  int found_count() const { return found_count_; }
+
+ private:
+  int found_count_ = 0;
+};
+
 class FastPairScannerImplTest : public testing::Test {
  public:
   void SetUp() override { MediumEnvironment::Instance().Start(); }
@@ -123,6 +157,34 @@ TEST_F(FastPairScannerImplTest, StopScanning) {
   DestroyOnExecutor(std::move(scanner), &executor);
 }
 
+TEST_F(FastPairScannerImplTest, SkipsRepeatedAdvertisements) {
+  Mediums mediums;
+  SingleThreadExecutor executor;
+  auto scanner = std::make_unique<FastPairScannerImpl>(mediums, &executor);
+  CountingScannerObserver observer;
+  scanner->AddObserver(&observer);
+  FakeBlePeripheral fake_peripheral("11:22:33:44:55:66",
+                                    absl::HexStringToBytes(kModelId));
+  BlePeripheral peripheral(&fake_peripheral);
+
+  scanner->OnDeviceFound(peripheral);
+  scanner->OnDeviceFound(peripheral);
+  EXPECT_EQ(observer.found_count(), 1);
+
+  // A changed advertisement is passed on right away.
+  fake_peripheral.SetServiceData(absl::HexStringToBytes("0a0b0c"));
+  scanner->OnDeviceFound(peripheral);
+  EXPECT_EQ(observer.found_count(), 2);
+
+  // So is the first advertisement after the device was lost.
+  scanner->OnDeviceLost(peripheral);
+  scanner->OnDeviceFound(peripheral);
+  EXPECT_EQ(observer.found_count(), 3);
+
+  scanner->RemoveObserver(&observer);
+  DestroyOnExecutor(std::move(scanner), &executor);
+}
+
 }  // namespace
 }  // namespace fastpair
 }  // namespace nearby
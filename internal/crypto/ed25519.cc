@@ -14,15 +14,20 @@
 
 #include "internal/crypto/ed25519.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
+#include "internal/platform/count_down_latch.h"
 #include "internal/platform/crypto.h"
+#include "internal/platform/multi_thread_executor.h"
 #include <openssl/base.h>
 #include <openssl/evp.h>
 
@@ -32,6 +37,9 @@ constexpr size_t kEd25519SignatureSize = 64;
 constexpr size_t kEd25519PrivateKeySize = 32;
 constexpr size_t kEd25519PublicKeySize = 32;
 constexpr size_t kEd25519KeySeedSize = 32;
+// Each thread of a batch verification gets at least this many signatures,
+// so that starting it pays off.
+constexpr size_t kMinBatchSizePerThread = 16;
 
 // Keypair
 Ed25519KeyPair::~Ed25519KeyPair() {
@@ -181,4 +189,42 @@ absl::Status Ed25519Verifier::Verify(absl::string_view data,
              : absl::InternalError("Signature is invalid.");
 }
 
+std::vector<absl::Status> Ed25519Verifier::VerifyBatch(
+    absl::Span<const Ed25519SignedData> batch, int max_threads) {
+  std::vector<absl::Status> results(batch.size());
+  auto verify_range = [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      absl::StatusOr<Ed25519Verifier> verifier =
+          Create(std::string(batch[i].public_key));
+      results[i] = verifier.ok()
+                       ? verifier->Verify(batch[i].data, batch[i].signature)
+                       : verifier.status();
+    }
+  };
+
+  size_t threads = std::clamp<size_t>(batch.size() / kMinBatchSizePerThread,
+                                      1, std::max(max_threads, 1));
+  if (threads == 1) {
+    verify_range(0, batch.size());
+    return results;
+  }
+  size_t range_size = (batch.size() + threads - 1) / threads;
+  size_t ranges = (batch.size() + range_size - 1) / range_size;
+  // The calling thread verifies the first range.
+  CountDownLatch latch(ranges - 1);
+  {
+    MultiThreadExecutor executor(ranges - 1);
+    for (size_t begin = range_size; begin < batch.size();
+         begin += range_size) {
+      executor.Execute([&, begin]() {
+        verify_range(begin, std::min(begin + range_size, batch.size()));
+        latch.CountDown();
+      });
+    }
+    verify_range(0, range_size);
+    latch.Await();
+  }
+  return results;
+}
+
 }  // namespace nearby::crypto
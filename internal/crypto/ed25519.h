@@ -18,8 +18,12 @@
 #include <cstring>
 #include <optional>
 #include <string>
+#include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "internal/crypto_cros/crypto_export.h"
 #include <openssl/base.h>
 #include <openssl/digest.h>
@@ -62,11 +66,24 @@ class CRYPTO_EXPORT Ed25519Signer {
   CryptoKeyUniquePtr private_key_;
 };
 
+// A signature of |data| to verify with |public_key|.
+struct Ed25519SignedData {
+  absl::string_view public_key;
+  absl::string_view data;
+  absl::string_view signature;
+};
+
 class CRYPTO_EXPORT Ed25519Verifier {
  public:
   static absl::StatusOr<Ed25519Verifier> Create(std::string public_key);
   absl::Status Verify(absl::string_view data, absl::string_view signature);
 
+  // Verifies each of |batch|, and returns the statuses Create() or Verify()
+  // would, in order. Large batches are split across up to |max_threads|
+  // threads, the calling thread included.
+  static std::vector<absl::Status> VerifyBatch(
+      absl::Span<const Ed25519SignedData> batch, int max_threads);
+
  private:
   explicit Ed25519Verifier(CryptoKeyUniquePtr public_key);
 
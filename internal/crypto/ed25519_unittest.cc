@@ -15,6 +15,7 @@
 #include "internal/crypto/ed25519.h"
 
 #include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -209,5 +210,43 @@ TEST(Ed25519SignerVerifierTest, NewKeypairFromRandomSeedRoundtrip) {
   EXPECT_OK(verifier->Verify("hello world", *signature));
 }
 
+TEST(Ed25519SignerVerifierTest, VerifiesBatchInOrder) {
+  constexpr int kBatchSize = 100;
+  std::vector<std::string> public_keys;
+  std::vector<std::string> signatures;
+  for (int i = 0; i < kBatchSize; i++) {
+    auto key_pair = Ed25519Signer::CreateNewKeyPair();
+    ASSERT_OK(key_pair);
+    auto signer = Ed25519Signer::Create(
+        absl::StrCat(key_pair->private_key, key_pair->public_key));
+    ASSERT_OK(signer);
+    public_keys.push_back(key_pair->public_key);
+    signatures.push_back(*signer->Sign("hello world"));
+  }
+  std::vector<Ed25519SignedData> batch;
+  for (int i = 0; i < kBatchSize; i++) {
+    // Every third signature is checked with the key of another one.
+    batch.push_back({
+        .public_key = public_keys[i % 3 == 0 ? (i + 1) % kBatchSize : i],
+        .data = "hello world",
+        .signature = signatures[i],
+    });
+  }
+  batch.push_back({.public_key = "bad key",
+                   .data = "hello world",
+                   .signature = signatures[0]});
+
+  for (int max_threads : {1, 4}) {
+    std::vector<absl::Status> results =
+        Ed25519Verifier::VerifyBatch(batch, max_threads);
+
+    ASSERT_EQ(results.size(), batch.size());
+    for (int i = 0; i < kBatchSize; i++) {
+      EXPECT_EQ(results[i].ok(), i % 3 != 0) << i;
+    }
+    EXPECT_THAT(results.back(), StatusIs(StatusCode::kInvalidArgument));
+  }
+}
+
 }  // namespace
 }  // namespace nearby::crypto
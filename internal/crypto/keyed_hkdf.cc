@@ -0,0 +1,73 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/crypto/keyed_hkdf.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "internal/crypto_cros/hmac.h"
+#include "internal/crypto_cros/sha2.h"
+#include <openssl/mem.h>
+
+namespace nearby::crypto {
+namespace {
+
+constexpr size_t kMaxBlocks = 255;
+
+}  // namespace
+
+KeyedHkdfSha256::KeyedHkdfSha256(absl::Span<const uint8_t> salt)
+    : extract_(HMAC::SHA256) {
+  // An empty salt stands for a string of zeros, which keys HMAC the same way.
+  initialized_ = extract_.Init(salt);
+}
+
+std::vector<uint8_t> KeyedHkdfSha256::Derive(absl::Span<const uint8_t> secret,
+                                             absl::Span<const uint8_t> info,
+                                             size_t derived_key_size) const {
+  if (!initialized_ || derived_key_size > kMaxBlocks * kSHA256Length) {
+    return {};
+  }
+
+  uint8_t prk[kSHA256Length];
+  if (!extract_.Sign(secret, absl::MakeSpan(prk))) return {};
+  HMAC expand(HMAC::SHA256);
+  bool keyed = expand.Init(absl::MakeConstSpan(prk));
+  OPENSSL_cleanse(prk, sizeof(prk));
+  if (!keyed) return {};
+
+  // T(i) = HMAC(PRK, T(i - 1) | info | i), with an empty T(0).
+  std::vector<uint8_t> key;
+  key.reserve(derived_key_size);
+  std::vector<uint8_t> input;
+  input.reserve(kSHA256Length + info.size() + 1);
+  uint8_t block[kSHA256Length];
+  for (size_t i = 1; key.size() < derived_key_size; ++i) {
+    input.insert(input.end(), info.begin(), info.end());
+    input.push_back(static_cast<uint8_t>(i));
+    if (!expand.Sign(input, absl::MakeSpan(block))) return {};
+    size_t take = std::min(sizeof(block), derived_key_size - key.size());
+    key.insert(key.end(), block, block + take);
+    input.assign(block, block + sizeof(block));
+  }
+  OPENSSL_cleanse(block, sizeof(block));
+  return key;
+}
+
+}  // namespace nearby::crypto
@@ -0,0 +1,55 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_NEARBY_INTERNAL_CRYPTO_KEYED_HKDF_H_
+#define THIRD_PARTY_NEARBY_INTERNAL_CRYPTO_KEYED_HKDF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "absl/types/span.h"
+#include "internal/crypto_cros/crypto_export.h"
+#include "internal/crypto_cros/hmac.h"
+
+namespace nearby::crypto {
+
+// HKDF-SHA256 (RFC 5869) under a fixed salt. The extract step of every
+// derivation is an HMAC keyed with the salt; that HMAC is keyed once here,
+// so deriving many keys under the same salt, e.g. hashing every
+// authentication token of a certificate with its secret key, only hashes the
+// secrets. A const instance may be used from several threads.
+class CRYPTO_EXPORT KeyedHkdfSha256 {
+ public:
+  explicit KeyedHkdfSha256(absl::Span<const uint8_t> salt);
+
+  KeyedHkdfSha256(const KeyedHkdfSha256&) = delete;
+  KeyedHkdfSha256& operator=(const KeyedHkdfSha256&) = delete;
+
+  // Returns the same bytes as HkdfSha256(|secret|, salt, |info|,
+  // |derived_key_size|), or an empty vector if |derived_key_size| is over the
+  // HKDF limit of 255 blocks.
+  std::vector<uint8_t> Derive(absl::Span<const uint8_t> secret,
+                              absl::Span<const uint8_t> info,
+                              size_t derived_key_size) const;
+
+ private:
+  HMAC extract_;
+  bool initialized_ = false;
+};
+
+}  // namespace nearby::crypto
+
+#endif  // THIRD_PARTY_NEARBY_INTERNAL_CRYPTO_KEYED_HKDF_H_
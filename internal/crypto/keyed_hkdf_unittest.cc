@@ -0,0 +1,68 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/crypto/keyed_hkdf.h"
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/escaping.h"
+#include "absl/types/span.h"
+#include "internal/crypto_cros/hkdf.h"
+
+namespace nearby::crypto {
+namespace {
+
+std::vector<uint8_t> FromHex(absl::string_view hex) {
+  std::string bytes = absl::HexStringToBytes(hex);
+  return std::vector<uint8_t>(bytes.begin(), bytes.end());
+}
+
+TEST(KeyedHkdfSha256Test, Rfc5869TestCase1) {
+  KeyedHkdfSha256 hkdf(FromHex("000102030405060708090a0b0c"));
+
+  EXPECT_EQ(hkdf.Derive(FromHex("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b"),
+                        FromHex("f0f1f2f3f4f5f6f7f8f9"), 42),
+            FromHex("3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ec"
+                    "c4c5bf34007208d5b887185865"));
+}
+
+TEST(KeyedHkdfSha256Test, MatchesHkdfSha256) {
+  std::vector<uint8_t> salt = FromHex("5a17");
+  KeyedHkdfSha256 hkdf(salt);
+  KeyedHkdfSha256 unsalted(/*salt=*/{});
+
+  for (size_t size : {1, 16, 32, 33, 80}) {
+    std::vector<uint8_t> secret(size, 0x42);
+    std::vector<uint8_t> info(size / 2, 0x17);
+    EXPECT_EQ(hkdf.Derive(secret, info, size),
+              HkdfSha256(secret, salt, info, size));
+    EXPECT_EQ(unsalted.Derive(secret, /*info=*/{}, size),
+              HkdfSha256(secret, /*salt=*/{}, /*info=*/{}, size));
+  }
+}
+
+TEST(KeyedHkdfSha256Test, RejectsOversizedKeys) {
+  KeyedHkdfSha256 hkdf(/*salt=*/{});
+
+  EXPECT_THAT(hkdf.Derive(FromHex("01"), /*info=*/{}, 255 * 32 + 1),
+              testing::IsEmpty());
+}
+
+}  // namespace
+}  // namespace nearby::crypto
@@ -17,6 +17,7 @@
 #include <stddef.h>
 
 #include <algorithm>
+#include <memory>
 #include <string>
 
 #ifdef NEARBY_CHROMIUM
@@ -40,10 +41,11 @@ HMAC::HMAC(HashAlgorithm hash_alg) : hash_alg_(hash_alg), initialized_(false) {
   DCHECK(hash_alg_ == SHA1 || hash_alg_ == SHA256);
 }
 
-HMAC::~HMAC() {
-  // Zero out key copy.
-  key_.assign(key_.size(), 0);
-  nearbybase::STLClearObject(&key_);
+HMAC::~HMAC() = default;
+
+void HMAC::ContextDeleter::operator()(HMAC_CTX* ctx) const {
+  // Also clears the key material held by the context.
+  HMAC_CTX_free(ctx);
 }
 
 size_t HMAC::DigestLength() const {
@@ -62,7 +64,15 @@ bool HMAC::Init(const unsigned char* key, size_t key_length) {
   // Init must not be called more than once on the same HMAC object.
   DCHECK(!initialized_);
   initialized_ = true;
-  key_.assign(key, key + key_length);
+  keyed_context_.reset(HMAC_CTX_new());
+  if (!keyed_context_) return false;
+  // HMAC_Init_ex() treats a null key as "keep the current key".
+  static const unsigned char kEmptyKey = 0;
+  if (!HMAC_Init_ex(keyed_context_.get(), key ? key : &kEmptyKey, key_length,
+                    hash_alg_ == SHA1 ? EVP_sha1() : EVP_sha256(), nullptr)) {
+    keyed_context_.reset();
+    return false;
+  }
   return true;
 }
 
@@ -80,11 +90,17 @@ bool HMAC::Sign(absl::Span<const uint8_t> data,
 
   if (digest.size() > DigestLength()) return false;
 
+  std::unique_ptr<HMAC_CTX, ContextDeleter> context(HMAC_CTX_new());
+  if (!context || !keyed_context_) return false;
+#ifdef OPENSSL_IS_BORINGSSL
+  if (!HMAC_CTX_copy_ex(context.get(), keyed_context_.get())) return false;
+#else
+  if (!HMAC_CTX_copy(context.get(), keyed_context_.get())) return false;
+#endif
   ScopedOpenSSLSafeSizeBuffer<EVP_MAX_MD_SIZE> result(digest.data(),
                                                       digest.size());
-  return !!::HMAC(hash_alg_ == SHA1 ? EVP_sha1() : EVP_sha256(), key_.data(),
-                  key_.size(), data.data(), data.size(), result.safe_buffer(),
-                  nullptr);
+  return HMAC_Update(context.get(), data.data(), data.size()) &&
+         HMAC_Final(context.get(), result.safe_buffer(), nullptr);
 }
 
 bool HMAC::Verify(absl::string_view data, absl::string_view digest) const {
@@ -23,7 +23,6 @@
 #include <stddef.h>
 
 #include <memory>
-#include <vector>
 
 #include "absl/base/attributes.h"
 #include "absl/strings/string_view.h"
@@ -31,6 +30,8 @@
 #include "internal/crypto_cros/crypto_export.h"
 #include "internal/crypto_cros/nearby_base.h"
 
+struct hmac_ctx_st;
+
 namespace nearby::crypto {
 
 // Simplify the interface and reduce includes by abstracting out the internals.
@@ -57,7 +58,9 @@ class CRYPTO_EXPORT HMAC {
   // TODO(abarth): Add a PreferredKeyLength() member function.
 
   // Initializes this instance using |key| of the length |key_length|. Call Init
-  // only once. It returns false on the second or later calls.
+  // only once. It returns false on the second or later calls. The inner and
+  // outer pads of the key are computed here once, so signing many messages
+  // with the same instance only hashes the messages.
   //
   // NOTE: the US Federal crypto standard FIPS 198, Section 3 says:
   //   The size of the key, K, shall be equal to or greater than L/2, where L
@@ -115,9 +118,15 @@ class CRYPTO_EXPORT HMAC {
       absl::Span<const uint8_t> digest) const ABSL_MUST_USE_RESULT;
 
  private:
+  struct ContextDeleter {
+    void operator()(hmac_ctx_st* ctx) const;
+  };
+
   HashAlgorithm hash_alg_;
   bool initialized_;
-  std::vector<unsigned char> key_;
+  // Keyed by Init(); each Sign() works on a copy, so that a const instance
+  // can be shared between threads.
+  std::unique_ptr<hmac_ctx_st, ContextDeleter> keyed_context_;
 };
 
 }  // namespace nearby::crypto
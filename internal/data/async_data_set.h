@@ -0,0 +1,101 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_NEARBY_INTERNAL_DATA_ASYNC_DATA_SET_H_
+#define THIRD_PARTY_NEARBY_INTERNAL_DATA_ASYNC_DATA_SET_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/strings/string_view.h"
+#include "internal/data/data_set.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby::data {
+
+// DataSet that runs the operations of another DataSet, such as a
+// LeveldbDataSet, on its own thread, so that callers don't block on disk I/O.
+// Operations run one at a time in the order they were called. Callbacks are
+// invoked on that thread.
+//
+// Operations still pending when the AsyncDataSet is destroyed are run before
+// the wrapped DataSet is destroyed.
+template <typename T>
+class AsyncDataSet : public DataSet<T> {
+ public:
+  using KeyEntryVector = typename DataSet<T>::KeyEntryVector;
+
+  explicit AsyncDataSet(std::unique_ptr<DataSet<T>> data_set)
+      : data_set_(std::move(data_set)) {}
+  ~AsyncDataSet() override { executor_.Shutdown(); }
+
+  void Initialize(absl::AnyInvocable<void(InitStatus) &&> callback) override {
+    executor_.Execute("data-set-initialize",
+                      [this, callback = std::move(callback)]() mutable {
+                        data_set_->Initialize(std::move(callback));
+                      });
+  }
+
+  void LoadEntries(
+      absl::AnyInvocable<void(bool, std::unique_ptr<std::vector<T>>) &&>
+          callback) override {
+    executor_.Execute("data-set-load-entries",
+                      [this, callback = std::move(callback)]() mutable {
+                        data_set_->LoadEntries(std::move(callback));
+                      });
+  }
+
+  void LoadEntry(
+      absl::string_view key,
+      absl::AnyInvocable<void(bool, std::unique_ptr<T>) &&> callback) override {
+    executor_.Execute("data-set-load-entry",
+                      [this, key = std::string(key),
+                       callback = std::move(callback)]() mutable {
+                        data_set_->LoadEntry(key, std::move(callback));
+                      });
+  }
+
+  void UpdateEntries(std::unique_ptr<KeyEntryVector> entries_to_save,
+                     std::unique_ptr<std::vector<std::string>> keys_to_remove,
+                     absl::AnyInvocable<void(bool) &&> callback) override {
+    executor_.Execute(
+        "data-set-update-entries",
+        [this, entries_to_save = std::move(entries_to_save),
+         keys_to_remove = std::move(keys_to_remove),
+         callback = std::move(callback)]() mutable {
+          data_set_->UpdateEntries(std::move(entries_to_save),
+                                   std::move(keys_to_remove),
+                                   std::move(callback));
+        });
+  }
+
+  void Destroy(absl::AnyInvocable<void(bool) &&> callback) override {
+    executor_.Execute("data-set-destroy",
+                      [this, callback = std::move(callback)]() mutable {
+                        data_set_->Destroy(std::move(callback));
+                      });
+  }
+
+ private:
+  std::unique_ptr<DataSet<T>> data_set_;
+  SingleThreadExecutor executor_;
+};
+
+}  // namespace nearby::data
+
+#endif  // THIRD_PARTY_NEARBY_INTERNAL_DATA_ASYNC_DATA_SET_H_
@@ -0,0 +1,93 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "internal/data/async_data_set.h"
+
+#include <stdint.h>
+
+#include <filesystem>  // NOLINT(build/c++17)
+#include <ios>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+#include "internal/data/data_set.h"
+#include "internal/data/leveldb_data_set.h"
+#include "internal/data/leveldb_data_set_test.proto.h"
+
+namespace nearby::data {
+namespace {
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+std::filesystem::path GenerateLeveldbPath() {
+  auto temp_directory_path = std::filesystem::temp_directory_path();
+  std::random_device dev;
+  std::mt19937 prng(dev());
+  std::uniform_int_distribution<uint64_t> rand(0);
+  std::filesystem::path path;
+  do {
+    std::stringstream leveldb_directory;
+    leveldb_directory << std::hex << "nearby_async_db_" << rand(prng);
+    path = temp_directory_path / leveldb_directory.str();
+  } while (std::filesystem::exists(path));
+  return path;
+}
+
+TEST(AsyncDataSet, RunsOperationsInOrder) {
+  std::filesystem::path path = GenerateLeveldbPath();
+  auto dataset = std::make_unique<AsyncDataSet<DiceRoll>>(
+      std::make_unique<LeveldbDataSet<DiceRoll>>(path.string()));
+
+  // Nothing waits between the calls; each one runs after the previous one.
+  InitStatus status = InitStatus::kNotInitialized;
+  dataset->Initialize([&status](InitStatus s) { status = s; });
+  DiceRoll diceroll;
+  diceroll.set_value(12);
+  auto entries = std::make_unique<AsyncDataSet<DiceRoll>::KeyEntryVector>(
+      AsyncDataSet<DiceRoll>::KeyEntryVector({{"id1", diceroll}}));
+  bool updated = false;
+  dataset->UpdateEntries(std::move(entries),
+                         std::make_unique<std::vector<std::string>>(),
+                         [&updated](bool success) { updated = success; });
+  absl::Notification loaded;
+  std::unique_ptr<DiceRoll> result;
+  dataset->LoadEntry("id1",
+                     [&result, &loaded](bool, std::unique_ptr<DiceRoll> res) {
+                       result = std::move(res);
+                       loaded.Notify();
+                     });
+  ASSERT_TRUE(loaded.WaitForNotificationWithTimeout(kTimeout));
+
+  EXPECT_EQ(status, InitStatus::kOK);
+  EXPECT_TRUE(updated);
+  ASSERT_NE(result, nullptr);
+  EXPECT_EQ(result->value(), 12);
+
+  absl::Notification destroyed;
+  dataset->Destroy([&destroyed](bool) { destroyed.Notify(); });
+  ASSERT_TRUE(destroyed.WaitForNotificationWithTimeout(kTimeout));
+  dataset.reset();
+  std::filesystem::remove_all(path);
+}
+
+}  // namespace
+}  // namespace nearby::data
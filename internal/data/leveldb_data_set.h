@@ -22,12 +22,14 @@
 #include <vector>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/strings/string_view.h"
 #include "third_party/leveldb/include/db.h"
 #include "third_party/leveldb/include/iterator.h"
 #include "third_party/leveldb/include/options.h"
 #include "third_party/leveldb/include/slice.h"
 #include "third_party/leveldb/include/status.h"
+#include "third_party/leveldb/include/write_batch.h"
 #include "internal/data/data_set.h"
 #include "internal/platform/logging.h"
 #include "google/protobuf/message_lite.h"
@@ -58,14 +60,39 @@ class LeveldbDataSet : public DataSet<T> {
           void(bool,
                std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
           callback);
+  // Loads the entries whose keys start with `prefix`, in key order.
+  void LoadEntriesWithKeyPrefix(
+      absl::string_view prefix,
+      absl::AnyInvocable<
+          void(bool,
+               std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
+          callback);
+  // Loads the entries with keys in [`start`, `limit`), in key order. An empty
+  // `limit` loads up to the last key.
+  void LoadEntriesInKeyRange(
+      absl::string_view start, absl::string_view limit,
+      absl::AnyInvocable<
+          void(bool,
+               std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
+          callback);
+  // Saves and removes the entries in a single atomic write.
   void UpdateEntries(std::unique_ptr<KeyEntryVector> entries_to_save,
                      std::unique_ptr<std::vector<std::string>> keys_to_remove,
                      absl::AnyInvocable<void(bool) &&> callback) override;
   void Destroy(absl::AnyInvocable<void(bool) &&> callback) override;
 
  private:
+  // Loads the entries from the first key at or after `start` for as long as
+  // `in_range` accepts their keys.
+  void LoadKeyRange(
+      absl::string_view start,
+      absl::FunctionRef<bool(const leveldb::Slice&)> in_range,
+      absl::AnyInvocable<
+          void(bool,
+               std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
+          callback);
   void Serialize(T const& value, std::string& str);
-  void Deserialize(absl::string_view str, T& value);
+  void Deserialize(const leveldb::Slice& slice, T& value);
 
  private:
   std::string path_;
@@ -116,8 +143,8 @@ void LeveldbDataSet<T, isMessageLite>::LoadEntries(
 
   for (it->SeekToFirst(); it->Valid(); it->Next()) {
     T value;
-    Deserialize(it->value().ToString(), value);
-    result->push_back(value);
+    Deserialize(it->value(), value);
+    result->push_back(std::move(value));
   }
 
   if (it->status().ok()) {
@@ -148,7 +175,7 @@ void LeveldbDataSet<T, isMessageLite>::LoadEntry(
     std::move(callback)(false, std::move(result));
     return;
   }
-  Deserialize(value, *result);
+  Deserialize(leveldb::Slice(value), *result);
   std::move(callback)(true, std::move(result));
 }
 
@@ -159,6 +186,53 @@ void LeveldbDataSet<T, isMessageLite>::LoadEntriesWithKeys(
     absl::AnyInvocable<
         void(bool, std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
         callback) {
+  LoadKeyRange(
+      "", [](const leveldb::Slice&) { return true; }, std::move(callback));
+}
+
+template <typename T,
+          std::enable_if_t<std::is_base_of<proto2::MessageLite, T>::value, bool>
+              isMessageLite>
+void LeveldbDataSet<T, isMessageLite>::LoadEntriesWithKeyPrefix(
+    absl::string_view prefix,
+    absl::AnyInvocable<
+        void(bool, std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
+        callback) {
+  leveldb::Slice prefix_slice(prefix.data(), prefix.size());
+  LoadKeyRange(
+      prefix,
+      [&prefix_slice](const leveldb::Slice& key) {
+        return key.starts_with(prefix_slice);
+      },
+      std::move(callback));
+}
+
+template <typename T,
+          std::enable_if_t<std::is_base_of<proto2::MessageLite, T>::value, bool>
+              isMessageLite>
+void LeveldbDataSet<T, isMessageLite>::LoadEntriesInKeyRange(
+    absl::string_view start, absl::string_view limit,
+    absl::AnyInvocable<
+        void(bool, std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
+        callback) {
+  leveldb::Slice limit_slice(limit.data(), limit.size());
+  LoadKeyRange(
+      start,
+      [&limit_slice](const leveldb::Slice& key) {
+        return limit_slice.empty() || key.compare(limit_slice) < 0;
+      },
+      std::move(callback));
+}
+
+template <typename T,
+          std::enable_if_t<std::is_base_of<proto2::MessageLite, T>::value, bool>
+              isMessageLite>
+void LeveldbDataSet<T, isMessageLite>::LoadKeyRange(
+    absl::string_view start,
+    absl::FunctionRef<bool(const leveldb::Slice&)> in_range,
+    absl::AnyInvocable<
+        void(bool, std::unique_ptr<std::vector<std::pair<std::string, T>>>) &&>
+        callback) {
   auto result = std::make_unique<std::vector<std::pair<std::string, T>>>();
   if (status_ != InitStatus::kOK) {
     std::move(callback)(false, std::move(result));
@@ -168,10 +242,11 @@ void LeveldbDataSet<T, isMessageLite>::LoadEntriesWithKeys(
   std::unique_ptr<leveldb::Iterator> it(
       db_->NewIterator(leveldb::ReadOptions()));
 
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+  for (it->Seek(leveldb::Slice(start.data(), start.size()));
+       it->Valid() && in_range(it->key()); it->Next()) {
     T value;
-    Deserialize(it->value().ToString(), value);
-    result->push_back({it->key().ToString(), value});
+    Deserialize(it->value(), value);
+    result->emplace_back(it->key().ToString(), std::move(value));
   }
 
   if (it->status().ok()) {
@@ -197,21 +272,27 @@ void LeveldbDataSet<T, isMessageLite>::UpdateEntries(
     return;
   }
 
+  // The batch copies keys and values, so one buffer serves all entries.
+  leveldb::WriteBatch batch;
+  std::string str;
   if (entries_to_save != nullptr) {
     for (const auto& [key, value] : *entries_to_save) {
-      std::string str;
       Serialize(value, str);
-      db_->Put(leveldb::WriteOptions(), key, leveldb::Slice(str));
+      batch.Put(key, leveldb::Slice(str));
     }
   }
 
   if (keys_to_remove != nullptr) {
     for (const auto& it : *keys_to_remove) {
-      db_->Delete(leveldb::WriteOptions(), it);
+      batch.Delete(it);
     }
   }
 
-  std::move(callback)(true);
+  leveldb::Status status = db_->Write(leveldb::WriteOptions(), &batch);
+  if (!status.ok()) {
+    LOG(INFO) << "Failed to update entries in database.";
+  }
+  std::move(callback)(status.ok());
 }
 
 template <typename T,
@@ -240,9 +321,10 @@ void LeveldbDataSet<T, isMessageLite>::Serialize(T const& value,
 template <typename T,
           std::enable_if_t<std::is_base_of<proto2::MessageLite, T>::value, bool>
               isMessageLite>
-void LeveldbDataSet<T, isMessageLite>::Deserialize(absl::string_view str,
+void LeveldbDataSet<T, isMessageLite>::Deserialize(const leveldb::Slice& slice,
                                                    T& value) {
-  value.ParseFromString(str);
+  // Parses in place, without copying the value out of leveldb first.
+  value.ParseFromArray(slice.data(), static_cast<int>(slice.size()));
 }
 
 }  // namespace data
@@ -29,6 +29,7 @@
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
 #include "internal/data/data_set.h"
@@ -37,6 +38,8 @@
 namespace nearby::data {
 namespace {
 
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
 using ::testing::SizeIs;
 
 // Generate a unique directory under temp directory for leveldb storage
@@ -283,5 +286,94 @@ TEST(LeveldbDataSet, RemoveEntriesDiceRoll) {
   EXPECT_EQ(result["id4"].nickname(), diceroll4.nickname());
 }
 
+template <typename T>
+std::vector<std::string> LoadKeysWithPrefixAndWait(
+    std::unique_ptr<LeveldbDataSet<T>>& dataset, absl::string_view prefix) {
+  std::vector<std::string> keys;
+  absl::Notification notification;
+  dataset->LoadEntriesWithKeyPrefix(
+      prefix,
+      [&keys, &notification](
+          bool, std::unique_ptr<std::vector<std::pair<std::string, T>>> res) {
+        for (const auto& it : *res) {
+          keys.push_back(it.first);
+        }
+        notification.Notify();
+      });
+  notification.WaitForNotificationWithTimeout(absl::Seconds(5));
+  return keys;
+}
+
+template <typename T>
+std::vector<std::string> LoadKeysInRangeAndWait(
+    std::unique_ptr<LeveldbDataSet<T>>& dataset, absl::string_view start,
+    absl::string_view limit) {
+  std::vector<std::string> keys;
+  absl::Notification notification;
+  dataset->LoadEntriesInKeyRange(
+      start, limit,
+      [&keys, &notification](
+          bool, std::unique_ptr<std::vector<std::pair<std::string, T>>> res) {
+        for (const auto& it : *res) {
+          keys.push_back(it.first);
+        }
+        notification.Notify();
+      });
+  notification.WaitForNotificationWithTimeout(absl::Seconds(5));
+  return keys;
+}
+
+TEST(LeveldbDataSet, LoadEntriesWithKeyPrefixDiceRoll) {
+  std::filesystem::path path = GenerateLeveldbPath();
+  std::unique_ptr<LeveldbDataSet<DiceRoll>> diceroll_set =
+      CreateDataSet<DiceRoll>(path);
+
+  InitializeAndWait(diceroll_set);
+
+  auto entries = LeveldbDataSet<DiceRoll>::KeyEntryVector(
+      {{"a/id1", GenerateDiceRoll(2)},
+       {"b/id1", GenerateDiceRoll(5)},
+       {"b/id2", GenerateDiceRoll(7)},
+       {"c/id1", GenerateDiceRoll(12)}});
+  auto data =
+      std::make_unique<LeveldbDataSet<DiceRoll>::KeyEntryVector>(entries);
+  UpdateEntriesAndWait(diceroll_set, std::move(data), nullptr);
+
+  std::vector<std::string> b_keys =
+      LoadKeysWithPrefixAndWait(diceroll_set, "b/");
+  std::vector<std::string> d_keys =
+      LoadKeysWithPrefixAndWait(diceroll_set, "d/");
+  WipeCleanAndWait(diceroll_set, path);
+
+  EXPECT_THAT(b_keys, ElementsAre("b/id1", "b/id2"));
+  EXPECT_THAT(d_keys, IsEmpty());
+}
+
+TEST(LeveldbDataSet, LoadEntriesInKeyRangeDiceRoll) {
+  std::filesystem::path path = GenerateLeveldbPath();
+  std::unique_ptr<LeveldbDataSet<DiceRoll>> diceroll_set =
+      CreateDataSet<DiceRoll>(path);
+
+  InitializeAndWait(diceroll_set);
+
+  auto entries = LeveldbDataSet<DiceRoll>::KeyEntryVector(
+      {{"id1", GenerateDiceRoll(2)},
+       {"id2", GenerateDiceRoll(5)},
+       {"id3", GenerateDiceRoll(7)},
+       {"id4", GenerateDiceRoll(12)}});
+  auto data =
+      std::make_unique<LeveldbDataSet<DiceRoll>::KeyEntryVector>(entries);
+  UpdateEntriesAndWait(diceroll_set, std::move(data), nullptr);
+
+  std::vector<std::string> bounded =
+      LoadKeysInRangeAndWait(diceroll_set, "id2", "id4");
+  std::vector<std::string> unbounded =
+      LoadKeysInRangeAndWait(diceroll_set, "id3", "");
+  WipeCleanAndWait(diceroll_set, path);
+
+  EXPECT_THAT(bounded, ElementsAre("id2", "id3"));
+  EXPECT_THAT(unbounded, ElementsAre("id3", "id4"));
+}
+
 }  // namespace
 }  // namespace nearby::data
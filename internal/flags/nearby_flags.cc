@@ -31,7 +31,10 @@ NearbyFlags& NearbyFlags::GetInstance() {
 
 bool NearbyFlags::GetBoolFlag(const flags::Flag<bool>& flag) {
   absl::MutexLock lock(&mutex_);
+  return ReadLocked(flag);
+}
 
+bool NearbyFlags::ReadLocked(const flags::Flag<bool>& flag) {
   const auto& it = overrided_bool_flag_values_.find(flag.name());
   if (it != overrided_bool_flag_values_.end()) {
     return it->second;
@@ -45,7 +48,10 @@ bool NearbyFlags::GetBoolFlag(const flags::Flag<bool>& flag) {
 
 int64_t NearbyFlags::GetInt64Flag(const flags::Flag<int64_t>& flag) {
   absl::MutexLock lock(&mutex_);
+  return ReadLocked(flag);
+}
 
+int64_t NearbyFlags::ReadLocked(const flags::Flag<int64_t>& flag) {
   const auto& it = overrided_int64_flag_values_.find(flag.name());
   if (it != overrided_int64_flag_values_.end()) {
     return it->second;
@@ -59,7 +65,10 @@ int64_t NearbyFlags::GetInt64Flag(const flags::Flag<int64_t>& flag) {
 
 double NearbyFlags::GetDoubleFlag(const flags::Flag<double>& flag) {
   absl::MutexLock lock(&mutex_);
+  return ReadLocked(flag);
+}
 
+double NearbyFlags::ReadLocked(const flags::Flag<double>& flag) {
   const auto& it = overrided_double_flag_values_.find(flag.name());
   if (it != overrided_double_flag_values_.end()) {
     return it->second;
@@ -89,24 +98,28 @@ std::string NearbyFlags::GetStringFlag(
 void NearbyFlags::SetFlagReader(flags::FlagReader& flag_reader) {
   absl::MutexLock lock(&mutex_);
   flag_reader_ = &flag_reader;
+  BumpGenerationLocked();
 }
 
 void NearbyFlags::OverrideBoolFlagValue(const flags::Flag<bool>& flag,
                                         bool new_value) {
   absl::MutexLock lock(&mutex_);
   overrided_bool_flag_values_[flag.name()] = new_value;
+  BumpGenerationLocked();
 }
 
 void NearbyFlags::OverrideInt64FlagValue(const flags::Flag<int64_t>& flag,
                                          int64_t new_value) {
   absl::MutexLock lock(&mutex_);
   overrided_int64_flag_values_[flag.name()] = new_value;
+  BumpGenerationLocked();
 }
 
 void NearbyFlags::OverrideDoubleFlagValue(const flags::Flag<double>& flag,
                                           double new_value) {
   absl::MutexLock lock(&mutex_);
   overrided_double_flag_values_[flag.name()] = new_value;
+  BumpGenerationLocked();
 }
 
 void NearbyFlags::OverrideStringFlagValue(
@@ -121,6 +134,12 @@ void NearbyFlags::ResetOverridedValues() {
   overrided_int64_flag_values_.clear();
   overrided_double_flag_values_.clear();
   overrided_string_flag_values_.clear();
+  BumpGenerationLocked();
+}
+
+void NearbyFlags::ReloadFlags() {
+  absl::MutexLock lock(&mutex_);
+  BumpGenerationLocked();
 }
 
 }  // namespace nearby
@@ -15,8 +15,10 @@
 #ifndef THIRD_PARTY_NEARBY_INTERNAL_FLAGS_NEARBY_FLAGS_H_
 #define THIRD_PARTY_NEARBY_INTERNAL_FLAGS_NEARBY_FLAGS_H_
 
+#include <atomic>
 #include <cstdint>
 #include <string>
+#include <type_traits>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
@@ -34,6 +36,28 @@ class NearbyFlags final : public nearby::flags::FlagReader {
 
   static NearbyFlags& GetInstance();
 
+  // Reads `kFlag` on hot paths. Each flag keeps its value in a cache of its
+  // own, so that a read is a couple of atomic loads as long as no flag value
+  // changed. Overrides, resets, SetFlagReader() and ReloadFlags() invalidate
+  // all cached values. Only bool, int64_t and double flags can be cached.
+  //
+  //   if (NearbyFlags::Get<config_package_nearby::kEnableFeature>()) {...}
+  template <const auto& kFlag>
+  static auto Get() {
+    using ValueType = decltype(kFlag.default_value());
+    static_assert(std::is_same_v<ValueType, bool> ||
+                      std::is_same_v<ValueType, int64_t> ||
+                      std::is_same_v<ValueType, double>,
+                  "Only bool, int64_t and double flags can be cached");
+    static CachedValue<ValueType> cache;
+    NearbyFlags& flags = GetInstance();
+    uint64_t generation = flags.generation_.load(std::memory_order_acquire);
+    if (cache.generation.load(std::memory_order_acquire) == generation) {
+      return cache.value.load(std::memory_order_relaxed);
+    }
+    return flags.Fill(kFlag, cache);
+  }
+
   // Reads flag with boolean value.
   bool GetBoolFlag(const flags::Flag<bool>& flag) override
       ABSL_LOCKS_EXCLUDED(mutex_);
@@ -71,13 +95,53 @@ class NearbyFlags final : public nearby::flags::FlagReader {
   // Reset all overridden values.
   void ResetOverridedValues() ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Drops the values cached by Get(). Call it when the flag reader's values
+  // change.
+  void ReloadFlags() ABSL_LOCKS_EXCLUDED(mutex_);
+
  private:
+  template <typename T>
+  struct CachedValue {
+    // The generation the value was read in; 0 if it was never read.
+    std::atomic<uint64_t> generation{0};
+    std::atomic<T> value{};
+  };
+
   NearbyFlags() = default;
 
+  bool ReadLocked(const flags::Flag<bool>& flag)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  int64_t ReadLocked(const flags::Flag<int64_t>& flag)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  double ReadLocked(const flags::Flag<double>& flag)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Reads `flag` and publishes its value in `cache`. Values are only
+  // published under `mutex_`, which every change of `generation_` holds too,
+  // so a cache never ends up tagged with a generation its value isn't from.
+  template <typename T>
+  T Fill(const flags::Flag<T>& flag, CachedValue<T>& cache)
+      ABSL_LOCKS_EXCLUDED(mutex_) {
+    absl::MutexLock lock(&mutex_);
+    T value = ReadLocked(flag);
+    cache.value.store(value, std::memory_order_relaxed);
+    cache.generation.store(generation_.load(std::memory_order_relaxed),
+                           std::memory_order_release);
+    return value;
+  }
+
+  // Invalidates the values cached by Get().
+  void BumpGenerationLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    generation_.fetch_add(1, std::memory_order_release);
+  }
+
   flags::FlagReader* flag_reader_ = nullptr;
   flags::DefaultFlagReader default_flag_reader_;
 
   mutable absl::Mutex mutex_;
+  // Only changed under `mutex_`. Starts at 1, so that no cache matches it
+  // before its first read.
+  std::atomic<uint64_t> generation_{1};
   absl::flat_hash_map<std::string, bool> overrided_bool_flag_values_
       ABSL_GUARDED_BY(mutex_);
 
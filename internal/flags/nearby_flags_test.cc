@@ -85,6 +85,44 @@ TEST(NearbyFlags, OverrideDefaultValues) {
   NearbyFlags::GetInstance().ResetOverridedValues();
 }
 
+TEST(NearbyFlags, GetCachedValues) {
+  EXPECT_EQ(NearbyFlags::Get<kTestBoolFlag>(), kTestBoolFlag.default_value());
+  EXPECT_EQ(NearbyFlags::Get<kTestInt64Flag>(),
+            kTestInt64Flag.default_value());
+  EXPECT_EQ(NearbyFlags::Get<kTestDoubleFlag>(),
+            kTestDoubleFlag.default_value());
+}
+
+TEST(NearbyFlags, OverridesInvalidateCachedValues) {
+  EXPECT_EQ(NearbyFlags::Get<kTestBoolFlag>(), kTestBoolFlag.default_value());
+
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(kTestBoolFlag,
+                                                   kTestBoolFlagTestValue);
+  EXPECT_EQ(NearbyFlags::Get<kTestBoolFlag>(), kTestBoolFlagTestValue);
+  NearbyFlags::GetInstance().OverrideDoubleFlagValue(kTestDoubleFlag,
+                                                     kTestDoubleFlagTestValue);
+  EXPECT_EQ(NearbyFlags::Get<kTestDoubleFlag>(), kTestDoubleFlagTestValue);
+
+  NearbyFlags::GetInstance().ResetOverridedValues();
+  EXPECT_EQ(NearbyFlags::Get<kTestBoolFlag>(), kTestBoolFlag.default_value());
+  EXPECT_EQ(NearbyFlags::Get<kTestDoubleFlag>(),
+            kTestDoubleFlag.default_value());
+}
+
+TEST(NearbyFlags, ReloadFlagsRereadsTheFlagReader) {
+  ::testing::NiceMock<MockFlagReader> flag_reader;
+  NearbyFlags::GetInstance().SetFlagReader(flag_reader);
+  EXPECT_CALL(flag_reader, GetInt64Flag(::testing::_))
+      .WillOnce(::testing::Return(1))
+      .WillOnce(::testing::Return(2));
+
+  // The second read is served from the cache.
+  EXPECT_EQ(NearbyFlags::Get<kTestInt64Flag>(), 1);
+  EXPECT_EQ(NearbyFlags::Get<kTestInt64Flag>(), 1);
+  NearbyFlags::GetInstance().ReloadFlags();
+  EXPECT_EQ(NearbyFlags::Get<kTestInt64Flag>(), 2);
+}
+
 TEST(NearbyFlags, SetFlagReader) {
   auto flag_reader = std::make_unique<::testing::NiceMock<MockFlagReader>>();
   NearbyFlags::GetInstance().SetFlagReader(*flag_reader.get());
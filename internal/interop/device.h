@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_CONNECTIONS_IMPLEMENTATION_DEVICE_H_
 #define THIRD_PARTY_NEARBY_CONNECTIONS_IMPLEMENTATION_DEVICE_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -47,6 +48,9 @@ class NearbyDevice {
   virtual std::vector<ConnectionInfoVariant> GetConnectionInfos() const = 0;
   virtual Type GetType() const { return Type::kUnknownDevice; }
   virtual std::string ToProtoBytes() const = 0;
+  // Returns a copy of the device, for work that outlives the reference it was
+  // handed. Returns nullptr if the device can't be copied.
+  virtual std::unique_ptr<NearbyDevice> Clone() const { return nullptr; }
 };
 
 }  // namespace nearby
@@ -15,6 +15,8 @@
 #ifndef THIRD_PARTY_NEARBY_CONNECTIONS_DEVICE_PROVIDER_H_
 #define THIRD_PARTY_NEARBY_CONNECTIONS_DEVICE_PROVIDER_H_
 
+#include <cstdint>
+
 #include "internal/interop/authentication_status.h"
 #include "internal/interop/authentication_transport.h"
 #include "internal/interop/device.h"
@@ -29,6 +31,10 @@ class NearbyDeviceProvider {
   virtual ~NearbyDeviceProvider() = default;
 
   const virtual NearbyDevice* GetLocalDevice() = 0;
+  // Returns a version of the local device, which providers that change the
+  // device bump on every change, so callers can keep what they derive from
+  // the device, e.g. its serialized bytes, until the version changes.
+  virtual std::uint64_t GetLocalDeviceVersion() const { return 0; }
   virtual AuthenticationStatus AuthenticateAsInitiator(
       const NearbyDevice& remote_device, absl::string_view shared_secret,
       const AuthenticationTransport& authentication_transport) const {
@@ -14,19 +14,31 @@
 
 #include "internal/network/http_client_impl.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
 #include "internal/network/debug.h"
 #include "internal/network/http_request.h"
 #include "internal/network/http_response.h"
+#include "internal/network/http_response_cache.h"
 #include "internal/network/http_status_code.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/implementation/http_loader.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
@@ -34,16 +46,54 @@
 
 namespace nearby {
 namespace network {
+namespace {
+
+// Returns the response cache of the process, sized by the feature flag when
+// the first client is created, or null if it is disabled.
+HttpResponseCache* GetSharedResponseCache() {
+  static HttpResponseCache* cache = []() -> HttpResponseCache* {
+    std::int64_t max_bytes =
+        FeatureFlags::GetInstance().GetFlags().http_response_cache_max_bytes;
+    if (max_bytes <= 0) return nullptr;
+    return new HttpResponseCache(max_bytes);
+  }();
+  return cache;
+}
+
+}  // namespace
+
+NearbyHttpClient::NearbyHttpClient()
+    : NearbyHttpClient(
+          GetSharedResponseCache(),
+          FeatureFlags::GetInstance().GetFlags().coalesce_http_requests) {}
+
+NearbyHttpClient::NearbyHttpClient(HttpResponseCache* cache,
+                                   bool coalesce_requests)
+    : cache_(cache), coalesce_requests_(coalesce_requests) {}
 
 void NearbyHttpClient::StartRequest(
     const HttpRequest& request,
     absl::AnyInvocable<void(const absl::StatusOr<HttpResponse>&)> callback) {
   MutexLock lock(&mutex_);
+  std::string key = GetCoalescingKey(request);
+  if (!key.empty()) {
+    auto it = pending_requests_.find(key);
+    if (it != pending_requests_.end()) {
+      NEARBY_LOGS(INFO) << __func__ << ": Coalesced async request to url="
+                        << request.GetUrl().GetUrlPath();
+      it->second.push_back(std::move(callback));
+      return;
+    }
+    // The callback is called with the other ones waiting on |key|.
+    pending_requests_[key].push_back(std::move(callback));
+    callback = nullptr;
+  }
   executor_.Execute(
-      [request = std::move(request), callback = std::move(callback)]() mutable {
+      [this, key = std::move(key), request = std::move(request),
+       callback = std::move(callback)]() mutable {
         NEARBY_LOGS(INFO) << __func__ << ": Start async request to url="
                           << request.GetUrl().GetUrlPath();
-        absl::StatusOr<HttpResponse> response = InternalGetResponse(request);
+        absl::StatusOr<HttpResponse> response = CachedGetResponse(request);
         if (response.ok()) {
           NEARBY_LOGS(INFO)
               << __func__
@@ -54,7 +104,9 @@ void NearbyHttpClient::StartRequest(
                              << response.status();
         }
 
-        if (callback) {
+        if (!key.empty()) {
+          CompleteCoalescedRequests(key, response);
+        } else if (callback) {
           callback(response);
         }
         NEARBY_LOGS(INFO) << __func__ << ": Completed request to url="
@@ -73,7 +125,7 @@ void NearbyHttpClient::StartCancellableRequest(
   }
   executor_
       .Execute(
-          [cancellable_request = std::move(cancellable_request),
+          [this, cancellable_request = std::move(cancellable_request),
            callback = std::move(callback)]() mutable {
             NEARBY_LOGS(INFO)
                 << __func__ << ": Start async request to url="
@@ -86,7 +138,7 @@ void NearbyHttpClient::StartCancellableRequest(
               return;
             }
             absl::StatusOr<HttpResponse> response =
-                InternalGetResponse(cancellable_request->http_request());
+                CachedGetResponse(cancellable_request->http_request());
             if (response.ok()) {
               NEARBY_LOGS(INFO)
                   << __func__ << ": Got response from url="
@@ -117,10 +169,40 @@ void NearbyHttpClient::StartCancellableRequest(
 
 absl::StatusOr<HttpResponse> NearbyHttpClient::GetResponse(
     const HttpRequest& request) {
+  std::string key = GetCoalescingKey(request);
+  if (!key.empty()) {
+    absl::StatusOr<HttpResponse> coalesced_response;
+    CountDownLatch latch(1);
+    bool coalesced = false;
+    {
+      MutexLock lock(&mutex_);
+      auto it = pending_requests_.find(key);
+      if (it != pending_requests_.end()) {
+        it->second.push_back(
+            [&](const absl::StatusOr<HttpResponse>& response) {
+              coalesced_response = response;
+              latch.CountDown();
+            });
+        coalesced = true;
+      } else {
+        pending_requests_[key];
+      }
+    }
+    if (coalesced) {
+      NEARBY_LOGS(INFO) << __func__ << ": Coalesced request to url="
+                        << request.GetUrl().GetUrlPath();
+      latch.Await();
+      return coalesced_response;
+    }
+  }
+
   NEARBY_LOGS(INFO) << __func__ << ": Start request to url="
                     << request.GetUrl().GetUrlPath();
 
-  absl::StatusOr<HttpResponse> response = InternalGetResponse(request);
+  absl::StatusOr<HttpResponse> response = CachedGetResponse(request);
+  if (!key.empty()) {
+    CompleteCoalescedRequests(key, response);
+  }
   if (response.ok()) {
     NEARBY_LOGS(INFO) << __func__ << ": Got response from url="
                       << request.GetUrl().GetUrlPath();
@@ -133,6 +215,66 @@ absl::StatusOr<HttpResponse> NearbyHttpClient::GetResponse(
   return response;
 }
 
+absl::StatusOr<HttpResponse> NearbyHttpClient::CachedGetResponse(
+    const HttpRequest& request) {
+  if (cache_ == nullptr) {
+    return InternalGetResponse(request);
+  }
+  std::optional<HttpResponse> cached_response =
+      cache_->GetFreshResponse(request);
+  if (cached_response.has_value()) {
+    NEARBY_VLOG(1) << __func__ << ": Got cached response to url="
+                   << request.GetUrl().GetUrlPath();
+    return *std::move(cached_response);
+  }
+  HttpRequest conditional_request = request;
+  cache_->AddValidators(&conditional_request);
+  absl::StatusOr<HttpResponse> response =
+      InternalGetResponse(conditional_request);
+  if (!response.ok()) {
+    return response;
+  }
+  return cache_->OnResponse(request, *std::move(response));
+}
+
+std::string NearbyHttpClient::GetCoalescingKey(
+    const HttpRequest& request) const {
+  if (!coalesce_requests_) return "";
+  if (request.GetMethod() != HttpRequestMethod::kGet &&
+      request.GetMethod() != HttpRequestMethod::kHead) {
+    return "";
+  }
+  std::vector<std::string> headers;
+  for (const auto& header : request.GetAllHeaders()) {
+    for (const auto& value : header.second) {
+      headers.push_back(
+          absl::StrCat(absl::AsciiStrToLower(header.first), ":", value));
+    }
+  }
+  std::sort(headers.begin(), headers.end());
+  return absl::StrCat(
+      request.GetMethodString(), " ", request.GetUrl().GetUrlPath(), "\n",
+      absl::StrJoin(headers, "\n"), "\n",
+      absl::Hash<absl::string_view>{}(request.GetBody().GetRawData()));
+}
+
+void NearbyHttpClient::CompleteCoalescedRequests(
+    const std::string& key, const absl::StatusOr<HttpResponse>& response) {
+  std::vector<ResponseCallback> callbacks;
+  {
+    MutexLock lock(&mutex_);
+    auto it = pending_requests_.find(key);
+    if (it == pending_requests_.end()) return;
+    callbacks = std::move(it->second);
+    pending_requests_.erase(it);
+  }
+  for (auto& callback : callbacks) {
+    if (callback) {
+      callback(response);
+    }
+  }
+}
+
 absl::StatusOr<HttpResponse> NearbyHttpClient::InternalGetResponse(
     const HttpRequest& request) {
   api::WebRequest web_request;
@@ -17,10 +17,17 @@
 
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/statusor.h"
 #include "internal/network/http_client.h"
 #include "internal/network/http_request.h"
+#include "internal/network/http_response.h"
+#include "internal/network/http_response_cache.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/single_thread_executor.h"
 
@@ -29,7 +36,13 @@ namespace network {
 
 class NearbyHttpClient : public HttpClient {
  public:
-  NearbyHttpClient() = default;
+  // Keeps responses in the cache shared by the process, and coalesces
+  // identical requests, as set by the feature flags.
+  NearbyHttpClient();
+  // Keeps responses in |cache|, unless null, which must outlive the client.
+  // If |coalesce_requests|, a GET or HEAD request identical to one still in
+  // flight isn't sent again; it gets the response to the one in flight.
+  NearbyHttpClient(HttpResponseCache* cache, bool coalesce_requests);
   ~NearbyHttpClient() override = default;
 
   NearbyHttpClient(const NearbyHttpClient&) = default;
@@ -51,10 +64,29 @@ class NearbyHttpClient : public HttpClient {
   absl::StatusOr<HttpResponse> GetResponse(const HttpRequest& request) override;
 
  private:
+  using ResponseCallback =
+      absl::AnyInvocable<void(const absl::StatusOr<HttpResponse>&)>;
+
+  // Answers |request| from |cache_| if it can, or sends it.
+  absl::StatusOr<HttpResponse> CachedGetResponse(const HttpRequest& request);
+  // Returns the key identical requests share, or an empty string if
+  // |request| mustn't be coalesced.
+  std::string GetCoalescingKey(const HttpRequest& request) const;
+  // Hands |response| to the requests waiting on |key|, and stops coalescing
+  // requests with it.
+  void CompleteCoalescedRequests(const std::string& key,
+                                 const absl::StatusOr<HttpResponse>& response)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   static absl::StatusOr<HttpResponse> InternalGetResponse(
       const HttpRequest& request);
 
+  HttpResponseCache* cache_ = nullptr;
+  bool coalesce_requests_ = false;
   Mutex mutex_;
+  // The callbacks waiting on the requests in flight, by coalescing key.
+  absl::flat_hash_map<std::string, std::vector<ResponseCallback>>
+      pending_requests_ ABSL_GUARDED_BY(mutex_);
   SingleThreadExecutor executor_;
 };
 
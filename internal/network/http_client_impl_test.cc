@@ -30,6 +30,7 @@
 #include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
 #include "internal/network/http_client.h"
+#include "internal/network/http_response_cache.h"
 #include "internal/network/http_status_code.h"
 #include "internal/platform/implementation/http_loader.h"
 #include "internal/platform/implementation/platform.h"
@@ -43,6 +44,7 @@ struct HttpTestContext {
   WebResponse web_response;
   absl::Status status;
   absl::Duration api_time;
+  int request_count = 0;
 };
 
 HttpTestContext* GetContext() {
@@ -56,6 +58,7 @@ HttpTestContext* GetContext() {
 absl::StatusOr<WebResponse> ImplementationPlatform::SendRequest(
     const WebRequest& request) {
   GetContext()->web_request = request;
+  GetContext()->request_count++;
   if (GetContext()->api_time != absl::ZeroDuration()) {
     absl::SleepFor(GetContext()->api_time);
   }
@@ -78,6 +81,7 @@ class NearbyHttpClientTest : public ::testing::Test {
     api::GetContext()->web_response = api::WebResponse();
     api::GetContext()->status = absl::Status();
     api::GetContext()->api_time = absl::ZeroDuration();
+    api::GetContext()->request_count = 0;
   }
 
   void MockFailedResponse(absl::Status status) {
@@ -397,6 +401,89 @@ TEST_F(NearbyHttpClientTest,
   EXPECT_FALSE(notification.WaitForNotificationWithTimeout(absl::Seconds(1)));
 }
 
+TEST_F(NearbyHttpClientTest, CoalescesIdenticalGetRequestsAsync) {
+  absl::StatusOr<HttpRequest> request =
+      MakeHttpRequest("http://www.google.com", HttpRequestMethod::kGet, {}, "");
+  MockResponse(HttpStatusCode::kHttpOk, "OK", {}, "web content");
+  api::GetContext()->api_time = absl::Milliseconds(100);
+  NearbyHttpClient client(/*cache=*/nullptr, /*coalesce_requests=*/true);
+  absl::StatusOr<HttpResponse> results[2];
+  absl::Notification notifications[2];
+
+  for (int i = 0; i < 2; ++i) {
+    client.StartRequest(*request,
+                        [&, i](const absl::StatusOr<HttpResponse>& response) {
+                          results[i] = response;
+                          notifications[i].Notify();
+                        });
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    notifications[i].WaitForNotification();
+    ASSERT_TRUE(results[i].ok());
+    EXPECT_EQ(results[i]->GetBody().GetRawData(), "web content");
+  }
+  EXPECT_EQ(api::GetContext()->request_count, 1);
+}
+
+TEST_F(NearbyHttpClientTest, DoesNotCoalescePostRequestsAsync) {
+  absl::StatusOr<HttpRequest> request = MakeHttpRequest(
+      "http://www.google.com", HttpRequestMethod::kPost, {}, "body");
+  MockResponse(HttpStatusCode::kHttpOk, "OK", {}, "web content");
+  NearbyHttpClient client(/*cache=*/nullptr, /*coalesce_requests=*/true);
+  absl::Notification notifications[2];
+
+  for (int i = 0; i < 2; ++i) {
+    client.StartRequest(
+        *request, [&, i](const absl::StatusOr<HttpResponse>& response) {
+          notifications[i].Notify();
+        });
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    notifications[i].WaitForNotification();
+  }
+  EXPECT_EQ(api::GetContext()->request_count, 2);
+}
+
+TEST_F(NearbyHttpClientTest, AnswersFreshRequestFromCache) {
+  absl::StatusOr<HttpRequest> request =
+      MakeHttpRequest("http://www.google.com", HttpRequestMethod::kGet, {}, "");
+  MockResponse(HttpStatusCode::kHttpOk, "OK",
+               {{"Cache-Control", "max-age=3600"}}, "web content");
+  HttpResponseCache cache(/*max_bytes=*/1024);
+  NearbyHttpClient client(&cache, /*coalesce_requests=*/false);
+
+  ASSERT_TRUE(client.GetResponse(*request).ok());
+  absl::StatusOr<HttpResponse> result = client.GetResponse(*request);
+
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(result->GetBody().GetRawData(), "web content");
+  EXPECT_EQ(api::GetContext()->request_count, 1);
+  EXPECT_EQ(cache.GetStats().hits, 1);
+}
+
+TEST_F(NearbyHttpClientTest, RevalidatesStaleResponse) {
+  absl::StatusOr<HttpRequest> request =
+      MakeHttpRequest("http://www.google.com", HttpRequestMethod::kGet, {}, "");
+  MockResponse(HttpStatusCode::kHttpOk, "OK",
+               {{"Cache-Control", "no-cache"}, {"ETag", "\"v1\""}},
+               "web content");
+  HttpResponseCache cache(/*max_bytes=*/1024);
+  NearbyHttpClient client(&cache, /*coalesce_requests=*/false);
+  ASSERT_TRUE(client.GetResponse(*request).ok());
+
+  MockResponse(HttpStatusCode::kHttpNotModified, "Not Modified", {}, "");
+  absl::StatusOr<HttpResponse> result = client.GetResponse(*request);
+
+  CheckHeader(GetWebRequest().headers, "If-None-Match", "\"v1\"");
+  ASSERT_TRUE(result.ok());
+  EXPECT_EQ(result->GetStatusCode(), HttpStatusCode::kHttpOk);
+  EXPECT_EQ(result->GetBody().GetRawData(), "web content");
+  EXPECT_EQ(api::GetContext()->request_count, 2);
+  EXPECT_EQ(cache.GetStats().revalidated, 1);
+}
+
 }  // namespace
 }  // namespace network
 }  // namespace nearby
@@ -0,0 +1,226 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/network/http_response_cache.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "internal/network/http_request.h"
+#include "internal/network/http_response.h"
+#include "internal/network/http_status_code.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+namespace network {
+namespace {
+
+constexpr absl::string_view kCacheControl = "Cache-Control";
+constexpr absl::string_view kETag = "ETag";
+constexpr absl::string_view kLastModified = "Last-Modified";
+constexpr absl::string_view kIfNoneMatch = "If-None-Match";
+constexpr absl::string_view kIfModifiedSince = "If-Modified-Since";
+
+// Returns the first value of |name|, compared regardless of case, in
+// |headers|.
+std::optional<std::string> FindHeader(
+    const absl::flat_hash_map<std::string, std::vector<std::string>>& headers,
+    absl::string_view name) {
+  for (const auto& header : headers) {
+    if (absl::EqualsIgnoreCase(header.first, name) && !header.second.empty()) {
+      return header.second.front();
+    }
+  }
+  return std::nullopt;
+}
+
+struct CacheControl {
+  bool no_store = false;
+  std::optional<absl::Duration> max_age;
+};
+
+CacheControl ParseCacheControl(
+    const absl::flat_hash_map<std::string, std::vector<std::string>>&
+        headers) {
+  CacheControl cache_control;
+  std::optional<std::string> value = FindHeader(headers, kCacheControl);
+  if (!value.has_value()) return cache_control;
+  for (absl::string_view directive :
+       absl::StrSplit(*value, ',', absl::SkipWhitespace())) {
+    std::string lower =
+        absl::AsciiStrToLower(absl::StripAsciiWhitespace(directive));
+    std::int64_t seconds;
+    if (lower == "no-store") {
+      cache_control.no_store = true;
+    } else if (lower == "no-cache") {
+      cache_control.max_age = absl::ZeroDuration();
+    } else if (absl::StartsWith(lower, "max-age=") &&
+               absl::SimpleAtoi(absl::string_view(lower).substr(8), &seconds)) {
+      // no-cache wins over max-age.
+      if (!cache_control.max_age.has_value()) {
+        cache_control.max_age =
+            absl::Seconds(std::max<std::int64_t>(seconds, 0));
+      }
+    }
+  }
+  return cache_control;
+}
+
+std::size_t GetSize(const std::string& key, const HttpResponse& response) {
+  std::size_t size = key.size() + response.GetBody().GetRawData().size();
+  for (const auto& header : response.GetAllHeaders()) {
+    for (const auto& value : header.second) {
+      size += header.first.size() + value.size();
+    }
+  }
+  return size;
+}
+
+}  // namespace
+
+HttpResponseCache::HttpResponseCache(std::size_t max_bytes)
+    : max_bytes_(max_bytes) {}
+
+std::optional<HttpResponse> HttpResponseCache::GetFreshResponse(
+    const HttpRequest& request) {
+  std::string key = GetKey(request);
+  if (key.empty()) return std::nullopt;
+  MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() ||
+      it->second.expires <= SystemClock::ElapsedRealtime()) {
+    return std::nullopt;
+  }
+  lru_keys_.splice(lru_keys_.begin(), lru_keys_, it->second.lru_position);
+  stats_.hits++;
+  return it->second.response;
+}
+
+void HttpResponseCache::AddValidators(HttpRequest* request) {
+  std::string key = GetKey(*request);
+  if (key.empty()) return;
+  MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return;
+  const auto& headers = it->second.response.GetAllHeaders();
+  std::optional<std::string> etag = FindHeader(headers, kETag);
+  if (etag.has_value()) {
+    request->AddHeader(kIfNoneMatch, *etag);
+  }
+  std::optional<std::string> last_modified = FindHeader(headers, kLastModified);
+  if (last_modified.has_value()) {
+    request->AddHeader(kIfModifiedSince, *last_modified);
+  }
+}
+
+HttpResponse HttpResponseCache::OnResponse(const HttpRequest& request,
+                                           HttpResponse response) {
+  std::string key = GetKey(request);
+  if (key.empty()) return response;
+  CacheControl cache_control = ParseCacheControl(response.GetAllHeaders());
+  absl::Time now = SystemClock::ElapsedRealtime();
+
+  MutexLock lock(&mutex_);
+  if (response.GetStatusCode() == HttpStatusCode::kHttpNotModified) {
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return response;
+    stats_.revalidated++;
+    Entry& entry = it->second;
+    entry.expires = now + cache_control.max_age.value_or(absl::ZeroDuration());
+    lru_keys_.splice(lru_keys_.begin(), lru_keys_, entry.lru_position);
+    return entry.response;
+  }
+
+  stats_.misses++;
+  Remove(key);
+  if (response.GetStatusCode() != HttpStatusCode::kHttpOk ||
+      cache_control.no_store) {
+    return response;
+  }
+  bool has_validator =
+      FindHeader(response.GetAllHeaders(), kETag).has_value() ||
+      FindHeader(response.GetAllHeaders(), kLastModified).has_value();
+  if (!has_validator && cache_control.max_age.value_or(absl::ZeroDuration()) <=
+                            absl::ZeroDuration()) {
+    return response;
+  }
+  std::size_t size = GetSize(key, response);
+  if (size > max_bytes_) return response;
+
+  while (total_bytes_ + size > max_bytes_) {
+    std::string oldest = lru_keys_.back();
+    Remove(oldest);
+    stats_.evicted++;
+  }
+  lru_keys_.push_front(key);
+  total_bytes_ += size;
+  entries_[key] = Entry{
+      .response = response,
+      .expires = now + cache_control.max_age.value_or(absl::ZeroDuration()),
+      .size = size,
+      .lru_position = lru_keys_.begin(),
+  };
+  return response;
+}
+
+HttpResponseCache::Stats HttpResponseCache::GetStats() const {
+  MutexLock lock(&mutex_);
+  return stats_;
+}
+
+std::string HttpResponseCache::GetKey(const HttpRequest& request) {
+  if (request.GetMethod() != HttpRequestMethod::kGet) return "";
+  const auto& headers = request.GetAllHeaders();
+  if (FindHeader(headers, kIfNoneMatch).has_value() ||
+      FindHeader(headers, kIfModifiedSince).has_value() ||
+      FindHeader(headers, kCacheControl).has_value()) {
+    return "";
+  }
+  std::vector<std::string> sorted_headers;
+  for (const auto& header : headers) {
+    for (const auto& value : header.second) {
+      sorted_headers.push_back(
+          absl::StrCat(absl::AsciiStrToLower(header.first), ":", value));
+    }
+  }
+  std::sort(sorted_headers.begin(), sorted_headers.end());
+  return absl::StrCat(request.GetUrl().GetUrlPath(), "\n",
+                      absl::StrJoin(sorted_headers, "\n"));
+}
+
+void HttpResponseCache::Remove(const std::string& key) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) return;
+  total_bytes_ -= it->second.size;
+  lru_keys_.erase(it->second.lru_position);
+  entries_.erase(it);
+}
+
+}  // namespace network
+}  // namespace nearby
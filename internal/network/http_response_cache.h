@@ -0,0 +1,105 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_NEARBY_INTERNAL_NETWORK_HTTP_RESPONSE_CACHE_H_
+#define THIRD_PARTY_NEARBY_INTERNAL_NETWORK_HTTP_RESPONSE_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
+#include "internal/network/http_request.h"
+#include "internal/network/http_response.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+namespace network {
+
+// Keeps the responses to GET requests in memory, as allowed by their
+// Cache-Control, ETag and Last-Modified headers, up to |max_bytes|; the least
+// recently used responses are evicted first.
+//
+// A response is served from the cache while it is fresh, i.e. younger than
+// its max-age. Once stale, the request is sent with the validators of the
+// cached response, and a 304 Not Modified answer is replaced by the cached
+// response. Responses with no max-age and no validator, or with no-store,
+// aren't kept. Requests that carry validators of their own bypass the cache.
+//
+// The cache is keyed by the URL and the headers of the request, so requests
+// made with different credentials never share a response.
+class HttpResponseCache {
+ public:
+  struct Stats {
+    // Responses served from the cache without a request.
+    std::int64_t hits = 0;
+    // Stale responses confirmed by a 304 Not Modified answer.
+    std::int64_t revalidated = 0;
+    // Requests that went to the server for a full response.
+    std::int64_t misses = 0;
+    std::int64_t evicted = 0;
+  };
+
+  explicit HttpResponseCache(std::size_t max_bytes);
+
+  HttpResponseCache(const HttpResponseCache&) = delete;
+  HttpResponseCache& operator=(const HttpResponseCache&) = delete;
+
+  // Returns the cached response to |request| if it is still fresh.
+  std::optional<HttpResponse> GetFreshResponse(const HttpRequest& request)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Adds the validators of the stale response cached for |request|, if any,
+  // to |request|, which must have been given to GetFreshResponse() first.
+  void AddValidators(HttpRequest* request) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Stores |response| to |request| if it may be cached. Returns the response
+  // to hand to the caller: the cached one, refreshed, for a 304 Not Modified
+  // answer to the validators added by AddValidators(), or |response|.
+  HttpResponse OnResponse(const HttpRequest& request, HttpResponse response)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  Stats GetStats() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Entry {
+    HttpResponse response;
+    absl::Time expires;
+    std::size_t size = 0;
+    std::list<std::string>::iterator lru_position;
+  };
+
+  // Returns the key of |request|, or an empty string if it bypasses the
+  // cache.
+  static std::string GetKey(const HttpRequest& request);
+
+  void Remove(const std::string& key) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::size_t max_bytes_;
+  mutable Mutex mutex_;
+  std::size_t total_bytes_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<std::string, Entry> entries_ ABSL_GUARDED_BY(mutex_);
+  // The keys of |entries_|, the most recently used first.
+  std::list<std::string> lru_keys_ ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace network
+}  // namespace nearby
+
+#endif  // THIRD_PARTY_NEARBY_INTERNAL_NETWORK_HTTP_RESPONSE_CACHE_H_
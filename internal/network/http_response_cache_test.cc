@@ -0,0 +1,137 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/network/http_response_cache.h"
+
+#include <optional>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+#include "internal/network/http_request.h"
+#include "internal/network/http_response.h"
+#include "internal/network/http_status_code.h"
+#include "internal/network/url.h"
+
+namespace nearby {
+namespace network {
+namespace {
+
+HttpRequest MakeRequest(absl::string_view url) {
+  return HttpRequest(*Url::Create(url));
+}
+
+HttpResponse MakeResponse(absl::string_view cache_control,
+                          absl::string_view body) {
+  HttpResponse response;
+  response.SetStatusCode(HttpStatusCode::kHttpOk);
+  response.AddHeader("cache-control", cache_control);
+  response.SetBody(body);
+  return response;
+}
+
+TEST(HttpResponseCache, ServesFreshResponse) {
+  HttpResponseCache cache(/*max_bytes=*/1024);
+  HttpRequest request = MakeRequest("https://example.com/a");
+
+  cache.OnResponse(request, MakeResponse("public, max-age=60", "a"));
+  std::optional<HttpResponse> response = cache.GetFreshResponse(request);
+
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ(response->GetBody().GetRawData(), "a");
+  EXPECT_EQ(cache.GetStats().hits, 1);
+}
+
+TEST(HttpResponseCache, DoesNotKeepNoStoreResponse) {
+  HttpResponseCache cache(/*max_bytes=*/1024);
+  HttpRequest request = MakeRequest("https://example.com/a");
+
+  cache.OnResponse(request, MakeResponse("no-store, max-age=60", "a"));
+
+  EXPECT_FALSE(cache.GetFreshResponse(request).has_value());
+}
+
+TEST(HttpResponseCache, DoesNotKeepPostResponse) {
+  HttpResponseCache cache(/*max_bytes=*/1024);
+  HttpRequest request = MakeRequest("https://example.com/a");
+  request.SetMethod(HttpRequestMethod::kPost);
+
+  cache.OnResponse(request, MakeResponse("max-age=60", "a"));
+
+  EXPECT_FALSE(cache.GetFreshResponse(request).has_value());
+}
+
+TEST(HttpResponseCache, KeysByHeaders) {
+  HttpResponseCache cache(/*max_bytes=*/1024);
+  HttpRequest request = MakeRequest("https://example.com/a");
+  request.AddHeader("Authorization", "Bearer 1");
+  HttpRequest other_request = MakeRequest("https://example.com/a");
+  other_request.AddHeader("Authorization", "Bearer 2");
+
+  cache.OnResponse(request, MakeResponse("max-age=60", "a"));
+
+  EXPECT_TRUE(cache.GetFreshResponse(request).has_value());
+  EXPECT_FALSE(cache.GetFreshResponse(other_request).has_value());
+}
+
+TEST(HttpResponseCache, AddsValidatorsOfStaleResponse) {
+  HttpResponseCache cache(/*max_bytes=*/1024);
+  HttpRequest request = MakeRequest("https://example.com/a");
+  HttpResponse response = MakeResponse("max-age=0", "a");
+  response.AddHeader("ETag", "\"1\"");
+  response.AddHeader("Last-Modified", "Wed, 21 Oct 2015 07:28:00 GMT");
+  cache.OnResponse(request, response);
+
+  ASSERT_FALSE(cache.GetFreshResponse(request).has_value());
+  HttpRequest conditional_request = request;
+  cache.AddValidators(&conditional_request);
+
+  EXPECT_THAT(conditional_request.GetAllHeaders().at("If-None-Match"),
+              ::testing::ElementsAre("\"1\""));
+  EXPECT_THAT(conditional_request.GetAllHeaders().at("If-Modified-Since"),
+              ::testing::ElementsAre("Wed, 21 Oct 2015 07:28:00 GMT"));
+
+  HttpResponse not_modified;
+  not_modified.SetStatusCode(HttpStatusCode::kHttpNotModified);
+  not_modified.AddHeader("Cache-Control", "max-age=60");
+  HttpResponse revalidated = cache.OnResponse(request, not_modified);
+
+  EXPECT_EQ(revalidated.GetStatusCode(), HttpStatusCode::kHttpOk);
+  EXPECT_EQ(revalidated.GetBody().GetRawData(), "a");
+  EXPECT_TRUE(cache.GetFreshResponse(request).has_value());
+}
+
+TEST(HttpResponseCache, EvictsLeastRecentlyUsedResponse) {
+  HttpRequest request_a = MakeRequest("https://example.com/a");
+  HttpRequest request_b = MakeRequest("https://example.com/b");
+  HttpRequest request_c = MakeRequest("https://example.com/c");
+  HttpResponse response = MakeResponse("max-age=60", std::string(100, 'x'));
+  // Room for two responses.
+  HttpResponseCache cache(/*max_bytes=*/400);
+
+  cache.OnResponse(request_a, response);
+  cache.OnResponse(request_b, response);
+  ASSERT_TRUE(cache.GetFreshResponse(request_a).has_value());
+  cache.OnResponse(request_c, response);
+
+  EXPECT_TRUE(cache.GetFreshResponse(request_a).has_value());
+  EXPECT_FALSE(cache.GetFreshResponse(request_b).has_value());
+  EXPECT_TRUE(cache.GetFreshResponse(request_c).has_value());
+  EXPECT_EQ(cache.GetStats().evicted, 1);
+}
+
+}  // namespace
+}  // namespace network
+}  // namespace nearby
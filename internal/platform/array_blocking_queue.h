@@ -15,12 +15,15 @@
 #ifndef PLATFORM_PUBLIC_ARRAY_BLOCKING_QUEUE_H_
 #define PLATFORM_PUBLIC_ARRAY_BLOCKING_QUEUE_H_
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
-#include <queue>
+#include <utility>
 
 #include "internal/platform/condition_variable.h"
-#include "internal/platform/logging.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
 
@@ -31,72 +34,162 @@ namespace nearby {
  * ArrayBlockingQueue before sending to ensure each client has equal chance to
  * send its data. Since C++ doesn't provide ArrayBlockingQueue as Java, we
  * implement one here.
+ *
+ * The queue is a bounded lock-free ring that any number of threads may put
+ * into and take from. Each slot carries a sequence number telling whether it
+ * is ready to be written or read (D. Vyukov's bounded MPMC queue). Blocked
+ * callers sleep on a ConditionVariable, which is only signaled when a waiter
+ * is registered, so the non-blocking path is a couple of atomic operations.
  */
 template <typename T>
 class ArrayBlockingQueue {
  public:
-  explicit ArrayBlockingQueue(size_t capacity) : capacity_(capacity) {}
-
-  void Put(const T& value) {
-    MutexLock lock(&queue_mutex_);
-    if (queue_.size() >= capacity_) {
-      has_space_.Wait();
+  explicit ArrayBlockingQueue(size_t capacity)
+      : capacity_(std::max<size_t>(capacity, 1)),
+        slots_(std::make_unique<Slot[]>(capacity_)) {
+    for (size_t i = 0; i < capacity_; i++) {
+      slots_[i].sequence.store(EmptySequence(i), std::memory_order_relaxed);
     }
-    queue_.push(value);
-    NEARBY_LOGS(INFO) << "ArrayBlockingQueue::Put()";
-    has_data_.Notify();
   }
+  ArrayBlockingQueue(const ArrayBlockingQueue&) = delete;
+  ArrayBlockingQueue& operator=(const ArrayBlockingQueue&) = delete;
 
-  T Take() {
-    MutexLock lock(&queue_mutex_);
-    if (queue_.empty()) {
-      has_data_.Wait();
+  void Put(const T& value) { Put(T(value)); }
+  void Put(T&& value) {
+    while (true) {
+      uint32_t epoch = takes_.epoch.load();
+      if (TryPut(std::move(value))) return;
+      takes_.WaitFor(epoch);
     }
-    T front = queue_.front();
-    queue_.pop();
-    NEARBY_LOGS(INFO) << "ArrayBlockingQueue::Take()";
-    has_space_.Notify();
-    return front;
   }
 
-  bool TryPut(const T& value) {
-    MutexLock lock(&queue_mutex_);
-    if (queue_.size() < capacity_) {
-      queue_.push(value);
-      has_data_.Notify();
-      return true;
+  T Take() {
+    while (true) {
+      uint32_t epoch = puts_.epoch.load();
+      if (std::optional<T> value = TryTake()) return *std::move(value);
+      puts_.WaitFor(epoch);
     }
-    return false;
   }
 
+  // Leaves |value| untouched if the queue is full.
+  bool TryPut(const T& value) { return TryPutImpl(value); }
+  bool TryPut(T&& value) { return TryPutImpl(std::move(value)); }
+
   // Returns std::nullopt if the queue is empty.
   std::optional<T> TryTake() {
-    MutexLock lock(&queue_mutex_);
-    if (!queue_.empty()) {
-      T front = queue_.front();
-      queue_.pop();
-      has_space_.Notify();
-      return front;
+    size_t position = take_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position % capacity_];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::intptr_t>(sequence) -
+                  static_cast<std::intptr_t>(FullSequence(position));
+      if (diff == 0) {
+        if (take_position_.compare_exchange_weak(position, position + 1,
+                                                 std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return std::nullopt;
+      } else {
+        position = take_position_.load(std::memory_order_relaxed);
+      }
     }
-    return std::nullopt;
+    std::optional<T> value = std::move(slot->value);
+    slot->value.reset();
+    slot->sequence.store(EmptySequence(position + capacity_),
+                         std::memory_order_release);
+    takes_.Wake();
+    return value;
   }
 
+  // Approximate while other threads use the queue.
   size_t Size() const {
-    MutexLock lock(&queue_mutex_);
-    return queue_.size();
+    size_t take_position = take_position_.load(std::memory_order_acquire);
+    size_t put_position = put_position_.load(std::memory_order_acquire);
+    return put_position > take_position ? put_position - take_position : 0;
   }
 
-  bool Empty() const {
-    MutexLock lock(&queue_mutex_);
-    return queue_.empty();
-  }
+  bool Empty() const { return Size() == 0; }
 
  private:
-  std::queue<T> queue_;
-  mutable Mutex queue_mutex_;
-  ConditionVariable has_data_{&queue_mutex_};
-  ConditionVariable has_space_{&queue_mutex_};
+  struct Slot {
+    std::atomic<size_t> sequence{0};
+    std::optional<T> value;
+  };
+
+  // The sequence of a slot waiting for the put at |position|, and of one
+  // holding the value put there. Doubled so that the two can't collide when
+  // the capacity is 1.
+  static size_t EmptySequence(size_t position) { return position * 2; }
+  static size_t FullSequence(size_t position) { return position * 2 + 1; }
+
+  template <typename U>
+  bool TryPutImpl(U&& value) {
+    size_t position = put_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position % capacity_];
+      size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::intptr_t>(sequence) -
+                  static_cast<std::intptr_t>(EmptySequence(position));
+      if (diff == 0) {
+        if (put_position_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        position = put_position_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->value.emplace(std::forward<U>(value));
+    slot->sequence.store(FullSequence(position), std::memory_order_release);
+    puts_.Wake();
+    return true;
+  }
+
+  // The puts or the takes, and the callers blocked until there is one more.
+  struct Progress {
+    // Sleeps until |epoch| moves past |seen|. Callers read |seen| before
+    // failing to put or take, so a change in between isn't missed.
+    void WaitFor(uint32_t seen) {
+      MutexLock lock(&mutex);
+      blocked.fetch_add(1);
+      while (epoch.load() == seen) {
+        changed.Wait();
+      }
+      blocked.fetch_sub(1);
+    }
+
+    // The waiter registers itself before checking |epoch|, and the check and
+    // the wait happen under |mutex|, so a waiter is either seen here or sees
+    // the new epoch.
+    void Wake() {
+      epoch.fetch_add(1);
+      if (blocked.load() > 0) {
+        MutexLock lock(&mutex);
+        changed.Notify();
+      }
+    }
+
+    // Bumped after each put, or each take.
+    std::atomic<uint32_t> epoch{0};
+    std::atomic<int> blocked{0};
+    Mutex mutex;
+    ConditionVariable changed{&mutex};
+  };
+
   const size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  // Kept on separate cache lines, since producers and consumers usually run
+  // on different threads.
+  alignas(64) std::atomic<size_t> put_position_{0};
+  alignas(64) std::atomic<size_t> take_position_{0};
+  // Blocked takers wait for puts, and blocked putters for takes.
+  alignas(64) Progress puts_;
+  alignas(64) Progress takes_;
 };
 
 }  // namespace nearby
@@ -0,0 +1,134 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "internal/platform/array_blocking_queue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace {
+
+constexpr absl::Duration kShortTimeout = absl::Milliseconds(100);
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+TEST(ArrayBlockingQueueTest, TakesInPutOrder) {
+  ArrayBlockingQueue<int> queue(3);
+
+  queue.Put(1);
+  queue.Put(2);
+  queue.Put(3);
+
+  EXPECT_EQ(queue.Size(), 3);
+  EXPECT_EQ(queue.Take(), 1);
+  EXPECT_EQ(queue.Take(), 2);
+  EXPECT_EQ(queue.Take(), 3);
+  EXPECT_TRUE(queue.Empty());
+}
+
+TEST(ArrayBlockingQueueTest, TryPutFailsWhenFull) {
+  ArrayBlockingQueue<int> queue(2);
+
+  EXPECT_TRUE(queue.TryPut(1));
+  EXPECT_TRUE(queue.TryPut(2));
+  EXPECT_FALSE(queue.TryPut(3));
+  EXPECT_EQ(queue.TryTake(), 1);
+  EXPECT_TRUE(queue.TryPut(3));
+  EXPECT_EQ(queue.TryTake(), 2);
+  EXPECT_EQ(queue.TryTake(), 3);
+  EXPECT_EQ(queue.TryTake(), std::nullopt);
+}
+
+TEST(ArrayBlockingQueueTest, HoldsMoveOnlyValues) {
+  ArrayBlockingQueue<std::unique_ptr<int>> queue(1);
+
+  queue.Put(std::make_unique<int>(5));
+  std::unique_ptr<int> value = queue.Take();
+
+  ASSERT_NE(value, nullptr);
+  EXPECT_EQ(*value, 5);
+}
+
+TEST(ArrayBlockingQueueTest, TakeWaitsForPut) {
+  ArrayBlockingQueue<int> queue(1);
+  CountDownLatch taken(1);
+  SingleThreadExecutor executor;
+
+  executor.Execute([&queue, &taken]() {
+    EXPECT_EQ(queue.Take(), 7);
+    taken.CountDown();
+  });
+  EXPECT_FALSE(taken.Await(kShortTimeout).result());
+  queue.Put(7);
+
+  EXPECT_TRUE(taken.Await(kTimeout).result());
+}
+
+TEST(ArrayBlockingQueueTest, PutWaitsForSpace) {
+  ArrayBlockingQueue<int> queue(1);
+  CountDownLatch put(1);
+  SingleThreadExecutor executor;
+  queue.Put(1);
+
+  executor.Execute([&queue, &put]() {
+    queue.Put(2);
+    put.CountDown();
+  });
+  EXPECT_FALSE(put.Await(kShortTimeout).result());
+  EXPECT_EQ(queue.Take(), 1);
+
+  EXPECT_TRUE(put.Await(kTimeout).result());
+  EXPECT_EQ(queue.Take(), 2);
+}
+
+TEST(ArrayBlockingQueueTest, ManyProducersAndConsumers) {
+  constexpr int kThreads = 4;
+  constexpr int kValuesPerThread = 10000;
+  ArrayBlockingQueue<int> queue(16);
+  std::atomic<int64_t> sum = 0;
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < kThreads; i++) {
+    threads.emplace_back([&queue]() {
+      for (int value = 1; value <= kValuesPerThread; value++) {
+        queue.Put(value);
+      }
+    });
+    threads.emplace_back([&queue, &sum]() {
+      for (int j = 0; j < kValuesPerThread; j++) {
+        sum += queue.Take();
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(sum, int64_t{kThreads} * kValuesPerThread * (kValuesPerThread + 1) /
+                     2);
+  EXPECT_TRUE(queue.Empty());
+}
+
+}  // namespace
+}  // namespace nearby
@@ -0,0 +1,160 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/async_log_sink.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/base/log_severity.h"
+#include "absl/hash/hash.h"
+#include "absl/log/log_entry.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+
+namespace {
+
+// Longest part of a suppressed message quoted in its summary.
+constexpr size_t kMaxQuotedLength = 200;
+
+void WriteToStderr(absl::string_view batch) {
+  std::fwrite(batch.data(), 1, batch.size(), stderr);
+  std::fflush(stderr);
+}
+
+}  // namespace
+
+AsyncLogSink::AsyncLogSink(Options options)
+    : AsyncLogSink(options, &WriteToStderr) {}
+
+AsyncLogSink::AsyncLogSink(Options options, Writer writer)
+    : options_(options),
+      queue_(options.max_pending_messages),
+      writer_(std::move(writer)) {
+  flusher_ = std::thread([this]() { RunFlusher(); });
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  {
+    absl::MutexLock lock(&flusher_mutex_);
+    stopping_ = true;
+  }
+  flusher_.join();
+  WriteQueued(/*final=*/true);
+}
+
+void AsyncLogSink::Send(const absl::LogEntry& entry) {
+  Write(entry.log_severity(), entry.source_filename(), entry.source_line(),
+        entry.timestamp(), entry.text_message_with_prefix_and_newline());
+}
+
+void AsyncLogSink::Write(absl::LogSeverity severity, absl::string_view file,
+                         int line, absl::Time timestamp,
+                         absl::string_view text) {
+  Message message{std::string(text), absl::HashOf(file, line), timestamp};
+  if (!queue_.TryPut(std::move(message))) {
+    overflowed_.fetch_add(1, std::memory_order_relaxed);
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+  }
+  // The process is about to die; don't leave the reason in the queue.
+  if (severity == absl::LogSeverity::kFatal) {
+    Flush();
+  }
+}
+
+void AsyncLogSink::Flush() { WriteQueued(/*final=*/false); }
+
+int64_t AsyncLogSink::GetDroppedCount() const {
+  return dropped_.load(std::memory_order_relaxed);
+}
+
+void AsyncLogSink::RunFlusher() {
+  while (true) {
+    {
+      absl::MutexLock lock(&flusher_mutex_);
+      flusher_mutex_.AwaitWithTimeout(absl::Condition(&stopping_),
+                                      options_.flush_interval);
+      if (stopping_) return;
+    }
+    WriteQueued(/*final=*/false);
+  }
+}
+
+void AsyncLogSink::WriteQueued(bool final) {
+  absl::MutexLock lock(&write_mutex_);
+  std::string batch;
+  // Only what's queued now; messages logged meanwhile wait for the next
+  // round, so that a busy logger can't keep the writer here.
+  for (size_t pending = queue_.Size(); pending > 0; --pending) {
+    std::optional<Message> message = queue_.TryTake();
+    if (!message.has_value()) break;
+    AppendRateLimited(*std::move(message), batch);
+  }
+  int64_t overflowed = overflowed_.exchange(0, std::memory_order_relaxed);
+  if (overflowed > 0) {
+    absl::StrAppend(&batch, "Dropped ", overflowed,
+                    " log messages because the log queue was full.\n");
+  }
+  absl::Time now = absl::Now();
+  for (auto& [site, state] : sites_) {
+    if (state.suppressed > 0 &&
+        (final || now - state.window_start >= options_.rate_limit_window)) {
+      AppendSummary(state, batch);
+    }
+  }
+  if (final) sites_.clear();
+  if (!batch.empty()) writer_(batch);
+}
+
+void AsyncLogSink::AppendRateLimited(Message message, std::string& batch) {
+  if (options_.max_messages_per_site <= 0) {
+    batch.append(message.text);
+    return;
+  }
+  SiteState& state = sites_[message.site];
+  if (state.count == 0 ||
+      message.timestamp - state.window_start >= options_.rate_limit_window) {
+    AppendSummary(state, batch);
+    state.window_start = message.timestamp;
+    state.count = 0;
+  }
+  if (++state.count <= options_.max_messages_per_site) {
+    batch.append(message.text);
+    return;
+  }
+  state.suppressed++;
+  state.last_suppressed = std::move(message.text);
+  dropped_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AsyncLogSink::AppendSummary(SiteState& state, std::string& batch) {
+  if (state.suppressed == 0) return;
+  absl::string_view quoted = state.last_suppressed;
+  if (!quoted.empty() && quoted.back() == '\n') quoted.remove_suffix(1);
+  absl::StrAppend(&batch, "Suppressed ", state.suppressed,
+                  " log messages from the line that logged: ",
+                  quoted.substr(0, kMaxQuotedLength), "\n");
+  state.suppressed = 0;
+  state.last_suppressed.clear();
+}
+
+}  // namespace nearby
@@ -0,0 +1,134 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_PUBLIC_ASYNC_LOG_SINK_H_
+#define PLATFORM_PUBLIC_ASYNC_LOG_SINK_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "absl/base/log_severity.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/log/log_entry.h"
+#include "absl/log/log_sink.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/array_blocking_queue.h"
+
+namespace nearby {
+
+// A log sink that takes writing log messages off the logging thread.
+//
+// Send() copies the formatted message into a lock-free queue, and a
+// background thread writes the queued messages in batches. Messages from a
+// source line that logs more than `max_messages_per_site` times per
+// `rate_limit_window` are dropped, and counted in a summary line instead.
+// When the queue is full, messages are dropped and counted too. FATAL
+// messages are written before Send() returns.
+//
+// To move all logging off the logging threads:
+//   ```
+//   static AsyncLogSink* sink = new AsyncLogSink(AsyncLogSink::Options());
+//   absl::AddLogSink(sink);
+//   absl::SetStderrThreshold(absl::LogSeverityAtLeast::kInfinity);
+//   ```
+class AsyncLogSink : public absl::LogSink {
+ public:
+  struct Options {
+    // Number of messages that can wait to be written.
+    size_t max_pending_messages = 4096;
+    // How often queued messages are written.
+    absl::Duration flush_interval = absl::Milliseconds(100);
+    // Messages one source line may log per `rate_limit_window`. 0 disables
+    // rate limiting.
+    int max_messages_per_site = 100;
+    absl::Duration rate_limit_window = absl::Seconds(1);
+  };
+
+  // Receives a batch of newline-terminated messages.
+  using Writer = absl::AnyInvocable<void(absl::string_view batch)>;
+
+  // Writes the messages to stderr.
+  explicit AsyncLogSink(Options options);
+  AsyncLogSink(Options options, Writer writer);
+  AsyncLogSink(const AsyncLogSink&) = delete;
+  AsyncLogSink& operator=(const AsyncLogSink&) = delete;
+  // Writes the messages still queued. The sink must be removed from absl
+  // logging before it's destroyed.
+  ~AsyncLogSink() override;
+
+  void Send(const absl::LogEntry& entry) override;
+  // Writes the queued messages before returning.
+  void Flush() override ABSL_LOCKS_EXCLUDED(write_mutex_);
+
+  // Queues `text`, a formatted and newline-terminated message logged from
+  // `file`:`line` at `timestamp`.
+  void Write(absl::LogSeverity severity, absl::string_view file, int line,
+             absl::Time timestamp, absl::string_view text);
+
+  // Number of messages dropped, either because the queue was full or by rate
+  // limiting.
+  int64_t GetDroppedCount() const;
+
+ private:
+  struct Message {
+    std::string text;
+    // Hash of the source file and line.
+    uint64_t site = 0;
+    absl::Time timestamp;
+  };
+
+  struct SiteState {
+    absl::Time window_start;
+    int count = 0;
+    int64_t suppressed = 0;
+    // The last message dropped by rate limiting, quoted in the summary.
+    std::string last_suppressed;
+  };
+
+  void RunFlusher() ABSL_LOCKS_EXCLUDED(flusher_mutex_);
+  // Writes the queued messages. With `final` set, also writes the summaries
+  // of sites still being rate limited.
+  void WriteQueued(bool final) ABSL_LOCKS_EXCLUDED(write_mutex_);
+  // Appends `message` to `batch` unless its site is over the limit.
+  void AppendRateLimited(Message message, std::string& batch)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(write_mutex_);
+  static void AppendSummary(SiteState& state, std::string& batch);
+
+  const Options options_;
+  ArrayBlockingQueue<Message> queue_;
+  std::atomic<int64_t> overflowed_{0};
+  std::atomic<int64_t> dropped_{0};
+
+  // Serializes writers of queued messages: the flusher thread, Flush() and
+  // FATAL messages.
+  absl::Mutex write_mutex_;
+  Writer writer_ ABSL_GUARDED_BY(write_mutex_);
+  absl::flat_hash_map<uint64_t, SiteState> sites_ ABSL_GUARDED_BY(write_mutex_);
+
+  absl::Mutex flusher_mutex_;
+  bool stopping_ ABSL_GUARDED_BY(flusher_mutex_) = false;
+  // Not an executor, since the executors' own logging would come back here.
+  std::thread flusher_;
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_PUBLIC_ASYNC_LOG_SINK_H_
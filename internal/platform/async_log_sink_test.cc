@@ -0,0 +1,203 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/async_log_sink.h"
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/base/log_severity.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace {
+
+using ::testing::HasSubstr;
+
+// Collects the batches written by a sink.
+class FakeWriter {
+ public:
+  AsyncLogSink::Writer GetWriter() {
+    return [this](absl::string_view batch) {
+      absl::MutexLock lock(&mutex_);
+      absl::StrAppend(&output_, batch);
+      batches_++;
+    };
+  }
+
+  std::string GetOutput() {
+    absl::MutexLock lock(&mutex_);
+    return output_;
+  }
+
+  int GetBatchCount() {
+    absl::MutexLock lock(&mutex_);
+    return batches_;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  std::string output_ ABSL_GUARDED_BY(mutex_);
+  int batches_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+AsyncLogSink::Options SlowFlushOptions() {
+  AsyncLogSink::Options options;
+  // Long enough that only Flush() writes during a test.
+  options.flush_interval = absl::Hours(1);
+  return options;
+}
+
+TEST(AsyncLogSinkTest, FlushWritesQueuedMessagesInOneBatch) {
+  FakeWriter writer;
+  AsyncLogSink sink(SlowFlushOptions(), writer.GetWriter());
+  absl::Time now = absl::Now();
+
+  sink.Write(absl::LogSeverity::kInfo, "a.cc", 1, now, "first\n");
+  sink.Write(absl::LogSeverity::kInfo, "a.cc", 2, now, "second\n");
+  EXPECT_EQ(writer.GetOutput(), "");
+  sink.Flush();
+
+  EXPECT_EQ(writer.GetOutput(), "first\nsecond\n");
+  EXPECT_EQ(writer.GetBatchCount(), 1);
+}
+
+TEST(AsyncLogSinkTest, FlusherWritesInTheBackground) {
+  FakeWriter writer;
+  AsyncLogSink::Options options;
+  options.flush_interval = absl::Milliseconds(10);
+  AsyncLogSink sink(options, writer.GetWriter());
+
+  sink.Write(absl::LogSeverity::kInfo, "a.cc", 1, absl::Now(), "message\n");
+
+  absl::Time deadline = absl::Now() + absl::Seconds(5);
+  while (writer.GetOutput().empty() && absl::Now() < deadline) {
+    absl::SleepFor(absl::Milliseconds(1));
+  }
+  EXPECT_EQ(writer.GetOutput(), "message\n");
+}
+
+TEST(AsyncLogSinkTest, FatalMessagesAreWrittenImmediately) {
+  FakeWriter writer;
+  AsyncLogSink sink(SlowFlushOptions(), writer.GetWriter());
+
+  sink.Write(absl::LogSeverity::kFatal, "a.cc", 1, absl::Now(), "fatal\n");
+
+  EXPECT_EQ(writer.GetOutput(), "fatal\n");
+}
+
+TEST(AsyncLogSinkTest, DestructorWritesQueuedMessages) {
+  FakeWriter writer;
+  {
+    AsyncLogSink sink(SlowFlushOptions(), writer.GetWriter());
+    sink.Write(absl::LogSeverity::kInfo, "a.cc", 1, absl::Now(), "message\n");
+  }
+
+  EXPECT_EQ(writer.GetOutput(), "message\n");
+}
+
+TEST(AsyncLogSinkTest, CountsMessagesDroppedWhenTheQueueIsFull) {
+  FakeWriter writer;
+  AsyncLogSink::Options options = SlowFlushOptions();
+  options.max_pending_messages = 2;
+  AsyncLogSink sink(options, writer.GetWriter());
+  absl::Time now = absl::Now();
+
+  for (int i = 0; i < 5; i++) {
+    sink.Write(absl::LogSeverity::kInfo, "a.cc", i, now,
+               absl::StrCat(i, "\n"));
+  }
+  sink.Flush();
+
+  EXPECT_EQ(sink.GetDroppedCount(), 3);
+  EXPECT_THAT(writer.GetOutput(), HasSubstr("0\n1\nDropped 3 log messages"));
+}
+
+TEST(AsyncLogSinkTest, RateLimitsRepeatedMessagesOfOneSite) {
+  FakeWriter writer;
+  AsyncLogSink::Options options = SlowFlushOptions();
+  options.max_messages_per_site = 2;
+  options.rate_limit_window = absl::Seconds(10);
+  AsyncLogSink sink(options, writer.GetWriter());
+  absl::Time start = absl::Now();
+
+  for (int i = 0; i < 5; i++) {
+    sink.Write(absl::LogSeverity::kInfo, "a.cc", 1, start,
+               absl::StrCat("repeated ", i, "\n"));
+  }
+  sink.Write(absl::LogSeverity::kInfo, "a.cc", 2, start, "other\n");
+  // A new window lets the site log again, after summing up the last one.
+  sink.Write(absl::LogSeverity::kInfo, "a.cc", 1, start + absl::Seconds(10),
+             "later\n");
+  sink.Flush();
+
+  EXPECT_EQ(sink.GetDroppedCount(), 3);
+  EXPECT_EQ(writer.GetOutput(),
+            "repeated 0\nrepeated 1\nother\n"
+            "Suppressed 3 log messages from the line that logged: "
+            "repeated 4\nlater\n");
+}
+
+TEST(AsyncLogSinkTest, DestructorWritesPendingSummaries) {
+  FakeWriter writer;
+  {
+    AsyncLogSink::Options options = SlowFlushOptions();
+    options.max_messages_per_site = 1;
+    options.rate_limit_window = absl::Hours(1);
+    AsyncLogSink sink(options, writer.GetWriter());
+    absl::Time now = absl::Now();
+    sink.Write(absl::LogSeverity::kInfo, "a.cc", 1, now, "kept\n");
+    sink.Write(absl::LogSeverity::kInfo, "a.cc", 1, now, "dropped\n");
+  }
+
+  EXPECT_EQ(writer.GetOutput(),
+            "kept\nSuppressed 1 log messages from the line that logged: "
+            "dropped\n");
+}
+
+TEST(AsyncLogSinkTest, ConcurrentWritersLoseNoMessages) {
+  FakeWriter writer;
+  AsyncLogSink::Options options;
+  options.flush_interval = absl::Milliseconds(1);
+  options.max_pending_messages = 1 << 16;
+  options.max_messages_per_site = 0;
+  constexpr int kThreads = 4;
+  constexpr int kMessagesPerThread = 1000;
+  {
+    AsyncLogSink sink(options, writer.GetWriter());
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+      threads.emplace_back([&sink, t]() {
+        for (int i = 0; i < kMessagesPerThread; i++) {
+          sink.Write(absl::LogSeverity::kInfo, "a.cc", t, absl::Now(), "m\n");
+        }
+      });
+    }
+    for (auto& thread : threads) thread.join();
+    EXPECT_EQ(sink.GetDroppedCount(), 0);
+  }
+
+  EXPECT_EQ(writer.GetOutput().size(), kThreads * kMessagesPerThread * 2);
+}
+
+}  // namespace
+}  // namespace nearby
@@ -28,11 +28,8 @@
 namespace nearby {
 
 std::string Base64Utils::Encode(const ByteArray& bytes) {
-  std::string base64_string;
-
-  absl::WebSafeBase64Escape(std::string(bytes), &base64_string);
-
-  return base64_string;
+  // Encodes in place, without copying |bytes| to a string first.
+  return absl::WebSafeBase64Escape(bytes.AsStringView());
 }
 
 ByteArray Base64Utils::Decode(absl::string_view base64_string) {
@@ -41,7 +38,7 @@ ByteArray Base64Utils::Decode(absl::string_view base64_string) {
     return ByteArray();
   }
 
-  return ByteArray(decoded_string.data(), decoded_string.size());
+  return ByteArray(std::move(decoded_string));
 }
 
 std::int32_t Base64Utils::BytesToInt(const ByteArray& bytes) {
@@ -0,0 +1,78 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "internal/platform/base64_utils.h"
+#include "internal/platform/bluetooth_utils.h"
+#include "internal/platform/byte_array.h"
+
+namespace nearby {
+namespace {
+
+// The data is fixed, so that runs are comparable.
+ByteArray MakeData(int64_t size) {
+  std::string data(size, 0);
+  for (int64_t i = 0; i < size; i++) data[i] = static_cast<char>(i * 31);
+  return ByteArray(std::move(data));
+}
+
+void BM_Base64Encode(benchmark::State& state) {
+  ByteArray data = MakeData(state.range(0));
+
+  for (auto _ : state) {
+    std::string encoded = Base64Utils::Encode(data);
+    benchmark::DoNotOptimize(encoded.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64Encode)->RangeMultiplier(8)->Range(16, 1 << 12);
+
+void BM_Base64Decode(benchmark::State& state) {
+  std::string encoded = Base64Utils::Encode(MakeData(state.range(0)));
+
+  for (auto _ : state) {
+    ByteArray decoded = Base64Utils::Decode(encoded);
+    benchmark::DoNotOptimize(decoded.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Base64Decode)->RangeMultiplier(8)->Range(16, 1 << 12);
+
+void BM_BluetoothMacAddressToString(benchmark::State& state) {
+  ByteArray address = MakeData(BluetoothUtils::kBluetoothMacAddressLength);
+
+  for (auto _ : state) {
+    std::string text = BluetoothUtils::ToString(address);
+    benchmark::DoNotOptimize(text.data());
+  }
+}
+BENCHMARK(BM_BluetoothMacAddressToString);
+
+void BM_BluetoothMacAddressFromString(benchmark::State& state) {
+  std::string text = BluetoothUtils::ToString(
+      MakeData(BluetoothUtils::kBluetoothMacAddressLength));
+
+  for (auto _ : state) {
+    ByteArray address = BluetoothUtils::FromString(text);
+    benchmark::DoNotOptimize(address.data());
+  }
+}
+BENCHMARK(BM_BluetoothMacAddressFromString);
+
+}  // namespace
+}  // namespace nearby
@@ -0,0 +1,48 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/base64_utils.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+#include "absl/strings/escaping.h"
+#include "internal/platform/byte_array.h"
+
+namespace nearby {
+namespace {
+
+TEST(Base64UtilsTest, EncodesUrlSafe) {
+  ByteArray bytes(std::string("\xfb\xff\xbf", 3));
+
+  EXPECT_EQ(Base64Utils::Encode(bytes), "-_-_");
+}
+
+TEST(Base64UtilsTest, RoundTripsAllLengths) {
+  std::string data;
+  for (int i = 0; i < 64; i++) {
+    EXPECT_EQ(Base64Utils::Encode(ByteArray(data)),
+              absl::WebSafeBase64Escape(data));
+    EXPECT_EQ(Base64Utils::Decode(Base64Utils::Encode(ByteArray(data))),
+              ByteArray(data));
+    data.push_back(static_cast<char>(i * 37));
+  }
+}
+
+TEST(Base64UtilsTest, DecodeRejectsInvalidInput) {
+  EXPECT_TRUE(Base64Utils::Decode("a*b").Empty());
+}
+
+}  // namespace
+}  // namespace nearby
@@ -0,0 +1,195 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/ble_advertising_scheduler.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "internal/platform/feature_flags.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+
+BleAdvertisingScheduler& BleAdvertisingScheduler::GetInstance() {
+  static BleAdvertisingScheduler* instance = new BleAdvertisingScheduler(
+      FeatureFlags::GetInstance().GetFlags().ble_advertising_max_sets,
+      FeatureFlags::GetInstance().GetFlags().ble_advertising_time_slice);
+  return *instance;
+}
+
+BleAdvertisingScheduler::BleAdvertisingScheduler(int max_advertising_sets,
+                                                 absl::Duration time_slice)
+    : max_advertising_sets_(std::max(max_advertising_sets, 1)),
+      time_slice_(time_slice) {}
+
+BleAdvertisingScheduler::~BleAdvertisingScheduler() {
+  executor_.Shutdown();
+  MutexLock lock(&mutex_);
+  for (auto& [id, advertisement] : advertisements_) {
+    TakeOffAir(*advertisement);
+  }
+}
+
+std::unique_ptr<BleAdvertisingScheduler::AdvertisingSession>
+BleAdvertisingScheduler::StartAdvertising(
+    absl::string_view name, int priority,
+    StartAdvertisingFunction start_advertising) {
+  MutexLock lock(&mutex_);
+  std::uint64_t id = ++next_id_;
+  auto advertisement = std::make_unique<Advertisement>();
+  advertisement->stats.name = std::string(name);
+  advertisement->stats.priority = priority;
+  advertisement->start_advertising = std::move(start_advertising);
+  advertisement->turn_time = SystemClock::ElapsedRealtime();
+  advertisements_.emplace(id, std::move(advertisement));
+  Schedule(/*rotate=*/false);
+  return std::make_unique<AdvertisingSession>(AdvertisingSession{
+      .stop_advertising = [this, id]() { return StopAdvertising(id); },
+  });
+}
+
+void BleAdvertisingScheduler::Rotate() {
+  MutexLock lock(&mutex_);
+  rotation_scheduled_ = false;
+  for (auto& [id, advertisement] : advertisements_) {
+    advertisement->start_failed = false;
+  }
+  Schedule(/*rotate=*/true);
+}
+
+std::vector<BleAdvertisingScheduler::AdvertisementStats>
+BleAdvertisingScheduler::GetStats() const {
+  MutexLock lock(&mutex_);
+  absl::Time now = SystemClock::ElapsedRealtime();
+  std::vector<AdvertisementStats> stats;
+  stats.reserve(advertisements_.size());
+  for (const auto& [id, advertisement] : advertisements_) {
+    stats.push_back(advertisement->stats);
+    if (advertisement->stats.on_air) {
+      stats.back().airtime += now - advertisement->on_air_since;
+    }
+  }
+  return stats;
+}
+
+absl::Status BleAdvertisingScheduler::StopAdvertising(std::uint64_t id) {
+  MutexLock lock(&mutex_);
+  auto it = advertisements_.find(id);
+  if (it == advertisements_.end()) {
+    return absl::NotFoundError("Can't find the provided advertising session");
+  }
+  std::unique_ptr<Advertisement> advertisement = std::move(it->second);
+  advertisements_.erase(it);
+  TakeOffAir(*advertisement);
+  const AdvertisementStats& stats = advertisement->stats;
+  NEARBY_LOGS(INFO) << "BleAdvertisingScheduler: removed " << stats.name
+                    << "; airtime=" << stats.airtime
+                    << "; started=" << stats.started_count
+                    << "; failed=" << stats.failed_count;
+  // Gives its set to a waiting advertisement.
+  Schedule(/*rotate=*/false);
+  return absl::OkStatus();
+}
+
+void BleAdvertisingScheduler::Schedule(bool rotate) {
+  std::vector<Advertisement*> candidates;
+  candidates.reserve(advertisements_.size());
+  for (auto& [id, advertisement] : advertisements_) {
+    candidates.push_back(advertisement.get());
+  }
+  // Within a priority, the advertisements on air longest and the ones waiting
+  // longest are the first to give up and take a set, respectively.
+  std::sort(candidates.begin(), candidates.end(),
+            [rotate](const Advertisement* a, const Advertisement* b) {
+              if (a->stats.priority != b->stats.priority) {
+                return a->stats.priority > b->stats.priority;
+              }
+              if (a->stats.on_air != b->stats.on_air) {
+                return rotate ? b->stats.on_air : a->stats.on_air;
+              }
+              if (a->stats.on_air) return a->turn_time > b->turn_time;
+              return a->turn_time < b->turn_time;
+            });
+  std::vector<Advertisement*> selected;
+  for (Advertisement* advertisement : candidates) {
+    if (selected.size() >= static_cast<std::size_t>(max_advertising_sets_)) {
+      break;
+    }
+    if (!advertisement->stats.on_air && advertisement->start_failed) continue;
+    selected.push_back(advertisement);
+  }
+
+  // Frees the sets before starting other advertisements on them.
+  for (Advertisement* advertisement : candidates) {
+    if (std::find(selected.begin(), selected.end(), advertisement) ==
+        selected.end()) {
+      TakeOffAir(*advertisement);
+    }
+  }
+  absl::Time now = SystemClock::ElapsedRealtime();
+  for (Advertisement* advertisement : selected) {
+    if (advertisement->stats.on_air) continue;
+    advertisement->turn_time = now;
+    advertisement->session = advertisement->start_advertising();
+    if (advertisement->session == nullptr) {
+      advertisement->stats.failed_count++;
+      advertisement->start_failed = true;
+      NEARBY_LOGS(WARNING) << "BleAdvertisingScheduler: failed to start "
+                           << advertisement->stats.name
+                           << "; retrying on its next turn.";
+      continue;
+    }
+    advertisement->stats.on_air = true;
+    advertisement->stats.started_count++;
+    advertisement->on_air_since = now;
+  }
+
+  bool has_waiting =
+      std::any_of(candidates.begin(), candidates.end(),
+                  [](const Advertisement* advertisement) {
+                    return !advertisement->stats.on_air;
+                  });
+  if (has_waiting && !rotation_scheduled_ &&
+      time_slice_ != absl::InfiniteDuration()) {
+    rotation_scheduled_ = true;
+    executor_.Schedule([this]() { Rotate(); }, time_slice_);
+  }
+}
+
+void BleAdvertisingScheduler::TakeOffAir(Advertisement& advertisement) {
+  if (!advertisement.stats.on_air) return;
+  absl::Status status = advertisement.session->stop_advertising();
+  if (!status.ok()) {
+    NEARBY_LOGS(WARNING) << "BleAdvertisingScheduler: failed to stop "
+                         << advertisement.stats.name << ": " << status;
+  }
+  advertisement.session.reset();
+  advertisement.stats.on_air = false;
+  advertisement.stats.airtime +=
+      SystemClock::ElapsedRealtime() - advertisement.on_air_since;
+}
+
+}  // namespace nearby
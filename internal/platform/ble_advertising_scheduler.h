@@ -0,0 +1,119 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_PUBLIC_BLE_ADVERTISING_SCHEDULER_H_
+#define PLATFORM_PUBLIC_BLE_ADVERTISING_SCHEDULER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "internal/platform/implementation/ble_v2.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/scheduled_executor.h"
+
+namespace nearby {
+
+// Multiplexes the BLE advertisements of all the clients in the process onto
+// the advertising sets the controller has, so that a client starting an
+// advertisement never fails, or evicts the advertisement of another one,
+// for lack of a free set.
+//
+// The advertisements with the highest priority are on air first. When more
+// advertisements of the same priority wait than there are sets left, they
+// take turns every time slice. An advertisement failing to start waits for
+// its next turn, instead of being retried at once.
+class BleAdvertisingScheduler final {
+ public:
+  using AdvertisingSession = api::ble_v2::BleMedium::AdvertisingSession;
+  // Starts an advertisement on the platform. Returns nullptr on failure.
+  using StartAdvertisingFunction =
+      absl::AnyInvocable<std::unique_ptr<AdvertisingSession>()>;
+
+  struct AdvertisementStats {
+    std::string name;
+    int priority = 0;
+    bool on_air = false;
+    // Number of times the advertisement was put on air, and failed to start.
+    int started_count = 0;
+    int failed_count = 0;
+    absl::Duration airtime = absl::ZeroDuration();
+  };
+
+  // Returns the scheduler of the process, configured by the feature flags.
+  static BleAdvertisingScheduler& GetInstance();
+
+  // Rotates the advertisements every |time_slice|, never if it is infinite.
+  BleAdvertisingScheduler(int max_advertising_sets, absl::Duration time_slice);
+  ~BleAdvertisingScheduler();
+
+  BleAdvertisingScheduler(const BleAdvertisingScheduler&) = delete;
+  BleAdvertisingScheduler& operator=(const BleAdvertisingScheduler&) = delete;
+
+  // Adds an advertisement, put on air with |start_advertising| whenever it
+  // gets a set. Stopping the returned session removes it.
+  std::unique_ptr<AdvertisingSession> StartAdvertising(
+      absl::string_view name, int priority,
+      StartAdvertisingFunction start_advertising) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Puts the advertisements that waited the longest on air, in place of the
+  // ones of the same priority that have been on air the longest.
+  void Rotate() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  std::vector<AdvertisementStats> GetStats() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Advertisement {
+    AdvertisementStats stats;
+    StartAdvertisingFunction start_advertising;
+    // Set while the advertisement is on air.
+    std::unique_ptr<AdvertisingSession> session;
+    absl::Time on_air_since = absl::InfinitePast();
+    // When the advertisement last got a turn, was added, or failed to start.
+    // The oldest one goes on air first.
+    absl::Time turn_time = absl::InfinitePast();
+    // Set when the advertisement failed to start, until the next rotation.
+    bool start_failed = false;
+  };
+
+  absl::Status StopAdvertising(std::uint64_t id) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Matches the advertisements on air to their priority and turns. When
+  // |rotate| is false, keeps the ones on air unless an advertisement of a
+  // higher priority waits, and skips the ones that failed to start.
+  void Schedule(bool rotate) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void TakeOffAir(Advertisement& advertisement)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const int max_advertising_sets_;
+  const absl::Duration time_slice_;
+  // Held while starting and stopping platform advertisements too, so that
+  // they happen in the order they are scheduled.
+  mutable Mutex mutex_;
+  std::uint64_t next_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<std::uint64_t, std::unique_ptr<Advertisement>>
+      advertisements_ ABSL_GUARDED_BY(mutex_);
+  bool rotation_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+  ScheduledExecutor executor_;
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_PUBLIC_BLE_ADVERTISING_SCHEDULER_H_
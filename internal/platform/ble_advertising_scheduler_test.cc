@@ -0,0 +1,189 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/ble_advertising_scheduler.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace {
+
+using AdvertisingSession = BleAdvertisingScheduler::AdvertisingSession;
+using ::testing::UnorderedElementsAre;
+
+// Puts advertisements on air, as a platform medium would.
+class FakeAdvertiser {
+ public:
+  BleAdvertisingScheduler::StartAdvertisingFunction Advertise(
+      const std::string& name) {
+    return [this, name]() -> std::unique_ptr<AdvertisingSession> {
+      if (failing_.contains(name)) return nullptr;
+      on_air_.insert(name);
+      return std::make_unique<AdvertisingSession>(AdvertisingSession{
+          .stop_advertising =
+              [this, name]() {
+                on_air_.erase(name);
+                return absl::OkStatus();
+              },
+      });
+    };
+  }
+
+  void SetFailing(const std::string& name, bool failing) {
+    if (failing) {
+      failing_.insert(name);
+    } else {
+      failing_.erase(name);
+    }
+  }
+
+  const absl::flat_hash_set<std::string>& on_air() const { return on_air_; }
+
+ private:
+  absl::flat_hash_set<std::string> on_air_;
+  absl::flat_hash_set<std::string> failing_;
+};
+
+TEST(BleAdvertisingSchedulerTest, AdvertisesWhileSetsAreFree) {
+  FakeAdvertiser advertiser;
+  BleAdvertisingScheduler scheduler(/*max_advertising_sets=*/2,
+                                    absl::InfiniteDuration());
+
+  auto a = scheduler.StartAdvertising("a", 1, advertiser.Advertise("a"));
+  auto b = scheduler.StartAdvertising("b", 1, advertiser.Advertise("b"));
+
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("a", "b"));
+  EXPECT_TRUE(a->stop_advertising().ok());
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("b"));
+  EXPECT_TRUE(b->stop_advertising().ok());
+  EXPECT_TRUE(advertiser.on_air().empty());
+  EXPECT_TRUE(scheduler.GetStats().empty());
+}
+
+TEST(BleAdvertisingSchedulerTest, HigherPriorityPreemptsLowerPriority) {
+  FakeAdvertiser advertiser;
+  BleAdvertisingScheduler scheduler(/*max_advertising_sets=*/1,
+                                    absl::InfiniteDuration());
+
+  auto low = scheduler.StartAdvertising("low", 1, advertiser.Advertise("low"));
+  auto high =
+      scheduler.StartAdvertising("high", 2, advertiser.Advertise("high"));
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("high"));
+
+  // Rotating never takes turns across priorities.
+  scheduler.Rotate();
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("high"));
+
+  // The waiting advertisement gets the set back.
+  EXPECT_TRUE(high->stop_advertising().ok());
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("low"));
+  EXPECT_TRUE(low->stop_advertising().ok());
+}
+
+TEST(BleAdvertisingSchedulerTest, RotatesAdvertisementsOfSamePriority) {
+  FakeAdvertiser advertiser;
+  BleAdvertisingScheduler scheduler(/*max_advertising_sets=*/2,
+                                    absl::InfiniteDuration());
+
+  auto a = scheduler.StartAdvertising("a", 1, advertiser.Advertise("a"));
+  auto b = scheduler.StartAdvertising("b", 1, advertiser.Advertise("b"));
+  auto c = scheduler.StartAdvertising("c", 1, advertiser.Advertise("c"));
+  // Adding an advertisement does not evict one of the same priority.
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("a", "b"));
+
+  // The advertisement on air the longest makes way for the waiting one.
+  scheduler.Rotate();
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("b", "c"));
+  scheduler.Rotate();
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("c", "a"));
+  scheduler.Rotate();
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("a", "b"));
+
+  EXPECT_TRUE(a->stop_advertising().ok());
+  EXPECT_TRUE(b->stop_advertising().ok());
+  EXPECT_TRUE(c->stop_advertising().ok());
+}
+
+TEST(BleAdvertisingSchedulerTest, FailedAdvertisementWaitsForNextTurn) {
+  FakeAdvertiser advertiser;
+  BleAdvertisingScheduler scheduler(/*max_advertising_sets=*/1,
+                                    absl::InfiniteDuration());
+  advertiser.SetFailing("a", true);
+
+  auto a = scheduler.StartAdvertising("a", 1, advertiser.Advertise("a"));
+  EXPECT_TRUE(advertiser.on_air().empty());
+  auto b = scheduler.StartAdvertising("b", 1, advertiser.Advertise("b"));
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("b"));
+
+  advertiser.SetFailing("a", false);
+  scheduler.Rotate();
+  EXPECT_THAT(advertiser.on_air(), UnorderedElementsAre("a"));
+
+  std::vector<BleAdvertisingScheduler::AdvertisementStats> stats =
+      scheduler.GetStats();
+  ASSERT_EQ(stats.size(), 2);
+  for (const auto& advertisement : stats) {
+    if (advertisement.name == "a") {
+      EXPECT_TRUE(advertisement.on_air);
+      EXPECT_EQ(advertisement.started_count, 1);
+      EXPECT_EQ(advertisement.failed_count, 1);
+    } else {
+      EXPECT_FALSE(advertisement.on_air);
+      EXPECT_EQ(advertisement.started_count, 1);
+      EXPECT_EQ(advertisement.failed_count, 0);
+    }
+  }
+
+  EXPECT_TRUE(a->stop_advertising().ok());
+  EXPECT_TRUE(b->stop_advertising().ok());
+}
+
+TEST(BleAdvertisingSchedulerTest, StoppingTwiceFails) {
+  FakeAdvertiser advertiser;
+  BleAdvertisingScheduler scheduler(/*max_advertising_sets=*/1,
+                                    absl::InfiniteDuration());
+
+  auto a = scheduler.StartAdvertising("a", 1, advertiser.Advertise("a"));
+
+  EXPECT_TRUE(a->stop_advertising().ok());
+  EXPECT_TRUE(absl::IsNotFound(a->stop_advertising()));
+}
+
+TEST(BleAdvertisingSchedulerTest, RotatesEveryTimeSlice) {
+  FakeAdvertiser advertiser;
+  BleAdvertisingScheduler scheduler(/*max_advertising_sets=*/1,
+                                    absl::Milliseconds(10));
+
+  auto a = scheduler.StartAdvertising("a", 1, advertiser.Advertise("a"));
+  auto b = scheduler.StartAdvertising("b", 1, advertiser.Advertise("b"));
+  absl::SleepFor(absl::Milliseconds(200));
+
+  for (const auto& advertisement : scheduler.GetStats()) {
+    EXPECT_GT(advertisement.started_count, 1);
+  }
+  EXPECT_TRUE(a->stop_advertising().ok());
+  EXPECT_TRUE(b->stop_advertising().ok());
+}
+
+}  // namespace
+}  // namespace nearby
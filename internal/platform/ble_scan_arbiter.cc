@@ -0,0 +1,321 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/ble_scan_arbiter.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "internal/platform/bluetooth_adapter.h"
+#include "internal/platform/implementation/ble_v2.h"
+#include "internal/platform/implementation/platform.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/uuid.h"
+
+namespace nearby {
+
+namespace {
+using ::nearby::api::ble_v2::BleAdvertisementData;
+using ::nearby::api::ble_v2::TxPowerLevel;
+
+// Set while the platform calls back, so StopScanning() can tell it is called
+// from a scan callback and must not call the platform from there.
+thread_local const BleScanArbiter* dispatching_arbiter = nullptr;
+
+// Marks the calling thread as dispatching the scan results of an arbiter.
+class ScopedDispatch {
+ public:
+  explicit ScopedDispatch(const BleScanArbiter* arbiter)
+      : previous_(dispatching_arbiter) {
+    dispatching_arbiter = arbiter;
+  }
+  ~ScopedDispatch() { dispatching_arbiter = previous_; }
+
+ private:
+  const BleScanArbiter* const previous_;
+};
+}  // namespace
+
+std::shared_ptr<BleScanArbiter> BleScanArbiter::GetInstance() {
+  static Mutex* mutex = new Mutex();
+  static std::weak_ptr<BleScanArbiter>* instance =
+      new std::weak_ptr<BleScanArbiter>();
+  MutexLock lock(mutex);
+  std::shared_ptr<BleScanArbiter> arbiter = instance->lock();
+  if (arbiter == nullptr) {
+    auto adapter = std::make_unique<BluetoothAdapter>();
+    std::unique_ptr<BleMedium> medium =
+        api::ImplementationPlatform::CreateBleV2Medium(adapter->GetImpl());
+    arbiter = std::shared_ptr<BleScanArbiter>(
+        new BleScanArbiter(std::move(adapter), std::move(medium)));
+    *instance = arbiter;
+  }
+  return arbiter;
+}
+
+BleScanArbiter::BleScanArbiter(std::unique_ptr<BleMedium> medium)
+    : BleScanArbiter(/*adapter=*/nullptr, std::move(medium)) {}
+
+BleScanArbiter::BleScanArbiter(std::unique_ptr<BluetoothAdapter> adapter,
+                               std::unique_ptr<BleMedium> medium)
+    : adapter_(std::move(adapter)), medium_(std::move(medium)) {}
+
+BleScanArbiter::~BleScanArbiter() {
+  // Runs the platform scan updates still pending before stopping the scans.
+  platform_executor_.Shutdown();
+  // Stops the scans of the clients that dropped their session without
+  // stopping it.
+  absl::flat_hash_map<Uuid, ServiceScan> scans;
+  {
+    MutexLock lock(&mutex_);
+    scans = std::move(scans_);
+  }
+  for (auto& [service_uuid, scan] : scans) {
+    if (scan.session == nullptr) continue;
+    absl::Status status = scan.session->stop_scanning();
+    if (!status.ok()) {
+      NEARBY_LOGS(WARNING) << "BleScanArbiter: failed to stop the scan for "
+                           << "service UUID " << std::string(service_uuid)
+                           << ": " << status;
+    }
+  }
+}
+
+std::unique_ptr<BleScanArbiter::BleMedium::ScanningSession>
+BleScanArbiter::StartScanning(const Uuid& service_uuid,
+                              TxPowerLevel tx_power_level,
+                              BleMedium::ScanningCallback callback) {
+  if (medium_ == nullptr) {
+    NEARBY_LOGS(WARNING) << "BleScanArbiter: no BLE medium to scan with.";
+    return nullptr;
+  }
+  auto client = std::make_shared<Client>(tx_power_level, std::move(callback));
+  std::uint64_t client_id;
+  {
+    MutexLock lock(&mutex_);
+    client_id = ++next_client_id_;
+    scans_[service_uuid].clients.emplace(client_id, client);
+  }
+
+  absl::Status status;
+  {
+    MutexLock platform_lock(&platform_mutex_);
+    status = UpdatePlatformScan(service_uuid);
+  }
+  if (!status.ok()) {
+    NEARBY_LOGS(WARNING) << "BleScanArbiter: failed to scan for service UUID "
+                         << std::string(service_uuid) << ": " << status;
+    StopScanning(service_uuid, client_id).IgnoreError();
+    return nullptr;
+  }
+
+  // Clients joining a running scan get the result of starting it.
+  std::optional<absl::Status> start_status;
+  {
+    MutexLock lock(&mutex_);
+    auto it = scans_.find(service_uuid);
+    if (it != scans_.end()) start_status = it->second.start_status;
+  }
+  if (start_status.has_value()) ReportStartResult(*client, *start_status);
+
+  return std::make_unique<BleMedium::ScanningSession>(
+      BleMedium::ScanningSession{
+          .stop_scanning =
+              [arbiter = shared_from_this(), service_uuid, client_id]() {
+                return arbiter->StopScanning(service_uuid, client_id);
+              },
+      });
+}
+
+std::optional<TxPowerLevel> BleScanArbiter::GetTxPowerLevel(
+    const Uuid& service_uuid) const {
+  MutexLock lock(&mutex_);
+  auto it = scans_.find(service_uuid);
+  if (it == scans_.end() || it->second.session == nullptr) {
+    return std::nullopt;
+  }
+  return it->second.tx_power_level;
+}
+
+absl::Status BleScanArbiter::StopScanning(const Uuid& service_uuid,
+                                          std::uint64_t client_id) {
+  std::shared_ptr<Client> client;
+  {
+    MutexLock lock(&mutex_);
+    auto it = scans_.find(service_uuid);
+    if (it == scans_.end()) {
+      return absl::NotFoundError("Can't find the provided scanning session");
+    }
+    auto client_it = it->second.clients.find(client_id);
+    if (client_it == it->second.clients.end()) {
+      return absl::NotFoundError("Can't find the provided scanning session");
+    }
+    client = std::move(client_it->second);
+    it->second.clients.erase(client_it);
+  }
+  {
+    // Waits for a callback running on another thread. The callback itself is
+    // released with the last reference to |client|, after any dispatch still
+    // running it returns.
+    MutexLock lock(&client->mutex);
+    client->active = false;
+  }
+  if (dispatching_arbiter == this) {
+    // The client stops from a scan callback: update the platform scan once
+    // the platform is no longer calling back on this thread.
+    platform_executor_.Execute([this, service_uuid]() {
+      MutexLock platform_lock(&platform_mutex_);
+      absl::Status status = UpdatePlatformScan(service_uuid);
+      if (!status.ok()) {
+        NEARBY_LOGS(WARNING)
+            << "BleScanArbiter: failed to update the scan for service UUID "
+            << std::string(service_uuid) << ": " << status;
+      }
+    });
+    return absl::OkStatus();
+  }
+  MutexLock platform_lock(&platform_mutex_);
+  return UpdatePlatformScan(service_uuid);
+}
+
+absl::Status BleScanArbiter::UpdatePlatformScan(const Uuid& service_uuid) {
+  std::unique_ptr<BleMedium::ScanningSession> stale_session;
+  TxPowerLevel tx_power_level = TxPowerLevel::kUnknown;
+  bool has_clients = false;
+  {
+    MutexLock lock(&mutex_);
+    auto it = scans_.find(service_uuid);
+    if (it == scans_.end()) return absl::OkStatus();
+    ServiceScan& scan = it->second;
+    for (const auto& [client_id, client] : scan.clients) {
+      if (static_cast<int>(client->tx_power_level) >
+          static_cast<int>(tx_power_level)) {
+        tx_power_level = client->tx_power_level;
+      }
+    }
+    has_clients = !scan.clients.empty();
+    if (has_clients && scan.session != nullptr &&
+        scan.tx_power_level == tx_power_level) {
+      return absl::OkStatus();
+    }
+    stale_session = std::move(scan.session);
+    if (has_clients) {
+      scan.tx_power_level = tx_power_level;
+      scan.start_status.reset();
+    } else {
+      scans_.erase(it);
+    }
+  }
+
+  absl::Status status = absl::OkStatus();
+  if (stale_session != nullptr) {
+    NEARBY_LOGS(INFO) << "BleScanArbiter: stopping the scan for service UUID "
+                      << std::string(service_uuid);
+    status = stale_session->stop_scanning();
+  }
+  if (!has_clients) return status;
+
+  NEARBY_LOGS(INFO) << "BleScanArbiter: starting the scan for service UUID "
+                    << std::string(service_uuid) << " at TX power level "
+                    << static_cast<int>(tx_power_level);
+  std::unique_ptr<BleMedium::ScanningSession> session = medium_->StartScanning(
+      service_uuid, tx_power_level,
+      BleMedium::ScanningCallback{
+          .start_scanning_result =
+              [this, service_uuid](absl::Status status) {
+                OnStartScanningResult(service_uuid, status);
+              },
+          .advertisement_found_cb =
+              [this, service_uuid](api::ble_v2::BlePeripheral& peripheral,
+                                   BleAdvertisementData advertisement_data) {
+                OnAdvertisementFound(service_uuid, peripheral,
+                                     advertisement_data);
+              },
+          .advertisement_lost_cb =
+              [this, service_uuid](api::ble_v2::BlePeripheral& peripheral) {
+                OnAdvertisementLost(service_uuid, peripheral);
+              },
+      });
+  if (session == nullptr) {
+    return absl::InternalError("Failed to start the platform scan");
+  }
+  MutexLock lock(&mutex_);
+  scans_[service_uuid].session = std::move(session);
+  return absl::OkStatus();
+}
+
+void BleScanArbiter::OnStartScanningResult(const Uuid& service_uuid,
+                                           absl::Status status) {
+  ScopedDispatch dispatch(this);
+  {
+    MutexLock lock(&mutex_);
+    auto it = scans_.find(service_uuid);
+    if (it == scans_.end()) return;
+    it->second.start_status = status;
+  }
+  for (const std::shared_ptr<Client>& client : GetClients(service_uuid)) {
+    ReportStartResult(*client, status);
+  }
+}
+
+void BleScanArbiter::OnAdvertisementFound(
+    const Uuid& service_uuid, api::ble_v2::BlePeripheral& peripheral,
+    const BleAdvertisementData& data) {
+  ScopedDispatch dispatch(this);
+  for (const std::shared_ptr<Client>& client : GetClients(service_uuid)) {
+    MutexLock lock(&client->mutex);
+    if (client->active) {
+      client->callback.advertisement_found_cb(peripheral, data);
+    }
+  }
+}
+
+void BleScanArbiter::OnAdvertisementLost(
+    const Uuid& service_uuid, api::ble_v2::BlePeripheral& peripheral) {
+  ScopedDispatch dispatch(this);
+  for (const std::shared_ptr<Client>& client : GetClients(service_uuid)) {
+    MutexLock lock(&client->mutex);
+    if (client->active) client->callback.advertisement_lost_cb(peripheral);
+  }
+}
+
+std::vector<std::shared_ptr<BleScanArbiter::Client>> BleScanArbiter::GetClients(
+    const Uuid& service_uuid) const {
+  std::vector<std::shared_ptr<Client>> clients;
+  MutexLock lock(&mutex_);
+  auto it = scans_.find(service_uuid);
+  if (it == scans_.end()) return clients;
+  clients.reserve(it->second.clients.size());
+  for (const auto& [client_id, client] : it->second.clients) {
+    clients.push_back(client);
+  }
+  return clients;
+}
+
+void BleScanArbiter::ReportStartResult(Client& client, absl::Status status) {
+  MutexLock lock(&client.mutex);
+  if (!client.active || client.start_result_reported) return;
+  client.start_result_reported = true;
+  client.callback.start_scanning_result(status);
+}
+
+}  // namespace nearby
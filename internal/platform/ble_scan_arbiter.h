@@ -0,0 +1,136 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_PUBLIC_BLE_SCAN_ARBITER_H_
+#define PLATFORM_PUBLIC_BLE_SCAN_ARBITER_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "internal/platform/bluetooth_adapter.h"
+#include "internal/platform/implementation/ble_v2.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/uuid.h"
+
+namespace nearby {
+
+// Shares the BLE scans of all the clients in the process: connections,
+// presence and the other users of BleV2Medium scan through one platform
+// medium, so the platform runs one scan with the merged set of service UUIDs
+// instead of a scan per client.
+//
+// There is one platform scanning session per service UUID, whatever the
+// number of clients scanning for it, run at the highest TX power level (the
+// most demanding duty cycle) any of them asks for. Every scan result is
+// dispatched once to the clients of its service UUID.
+class BleScanArbiter final
+    : public std::enable_shared_from_this<BleScanArbiter> {
+ public:
+  using BleMedium = api::ble_v2::BleMedium;
+  using TxPowerLevel = api::ble_v2::TxPowerLevel;
+
+  // Returns the arbiter of the process, creating it if no client holds it.
+  static std::shared_ptr<BleScanArbiter> GetInstance();
+
+  // Scans through |medium|. Used in tests.
+  explicit BleScanArbiter(std::unique_ptr<BleMedium> medium);
+  ~BleScanArbiter();
+
+  BleScanArbiter(const BleScanArbiter&) = delete;
+  BleScanArbiter& operator=(const BleScanArbiter&) = delete;
+
+  // Same as BleMedium::StartScanning(). Returns nullptr if the platform fails
+  // to start the scan. The returned session keeps the arbiter alive.
+  std::unique_ptr<BleMedium::ScanningSession> StartScanning(
+      const Uuid& service_uuid, TxPowerLevel tx_power_level,
+      BleMedium::ScanningCallback callback)
+      ABSL_LOCKS_EXCLUDED(platform_mutex_, mutex_);
+
+  // Returns the TX power level of the platform scan for |service_uuid|, if
+  // any is running.
+  std::optional<TxPowerLevel> GetTxPowerLevel(const Uuid& service_uuid) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Client {
+    explicit Client(TxPowerLevel tx_power_level,
+                    BleMedium::ScanningCallback callback)
+        : tx_power_level(tx_power_level), callback(std::move(callback)) {}
+
+    const TxPowerLevel tx_power_level;
+    // Held while calling back, so no callback runs once the client stopped
+    // scanning. Recursive, so a client may stop scanning from its callbacks.
+    RecursiveMutex mutex;
+    bool active ABSL_GUARDED_BY(mutex) = true;
+    bool start_result_reported ABSL_GUARDED_BY(mutex) = false;
+    BleMedium::ScanningCallback callback ABSL_GUARDED_BY(mutex);
+  };
+
+  struct ServiceScan {
+    TxPowerLevel tx_power_level = TxPowerLevel::kUnknown;
+    std::unique_ptr<BleMedium::ScanningSession> session;
+    // Set once the platform reports the result of starting |session|.
+    std::optional<absl::Status> start_status;
+    absl::flat_hash_map<std::uint64_t, std::shared_ptr<Client>> clients;
+  };
+
+  BleScanArbiter(std::unique_ptr<BluetoothAdapter> adapter,
+                 std::unique_ptr<BleMedium> medium);
+
+  absl::Status StopScanning(const Uuid& service_uuid, std::uint64_t client_id)
+      ABSL_LOCKS_EXCLUDED(platform_mutex_, mutex_);
+  // Starts, restarts at another TX power level or stops the platform scan for
+  // |service_uuid|, to match its clients.
+  absl::Status UpdatePlatformScan(const Uuid& service_uuid)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(platform_mutex_)
+          ABSL_LOCKS_EXCLUDED(mutex_);
+
+  void OnStartScanningResult(const Uuid& service_uuid, absl::Status status)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void OnAdvertisementFound(const Uuid& service_uuid,
+                            api::ble_v2::BlePeripheral& peripheral,
+                            const api::ble_v2::BleAdvertisementData& data)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void OnAdvertisementLost(const Uuid& service_uuid,
+                           api::ble_v2::BlePeripheral& peripheral)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  std::vector<std::shared_ptr<Client>> GetClients(const Uuid& service_uuid)
+      const ABSL_LOCKS_EXCLUDED(mutex_);
+  static void ReportStartResult(Client& client, absl::Status status);
+
+  // Null in tests, where the medium is injected.
+  std::unique_ptr<BluetoothAdapter> adapter_;
+  std::unique_ptr<BleMedium> medium_;
+  // Serializes the calls starting and stopping platform scans, which aren't
+  // made under |mutex_| as the platform may call back synchronously.
+  Mutex platform_mutex_ ABSL_ACQUIRED_BEFORE(mutex_);
+  mutable Mutex mutex_;
+  std::uint64_t next_client_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  absl::flat_hash_map<Uuid, ServiceScan> scans_ ABSL_GUARDED_BY(mutex_);
+  // Updates the platform scans of the clients stopping from a scan callback,
+  // as the platform must not be called from its own callbacks.
+  SingleThreadExecutor platform_executor_;
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_PUBLIC_BLE_SCAN_ARBITER_H_
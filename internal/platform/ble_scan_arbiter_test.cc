@@ -0,0 +1,300 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/ble_scan_arbiter.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "protobuf-matchers/protocol-buffer-matchers.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/implementation/ble_v2.h"
+#include "internal/platform/uuid.h"
+
+namespace nearby {
+namespace {
+
+using ::nearby::api::ble_v2::BleAdvertisementData;
+using ::nearby::api::ble_v2::BleMedium;
+using ::nearby::api::ble_v2::BlePeripheral;
+using ::nearby::api::ble_v2::TxPowerLevel;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using ::testing::Optional;
+using ::testing::status::StatusIs;
+
+const Uuid kServiceUuidA(1234, 5678);
+const Uuid kServiceUuidB(8765, 4321);
+constexpr absl::Duration kTimeout = absl::Seconds(1);
+
+class FakeBlePeripheral : public BlePeripheral {
+ public:
+  std::string GetAddress() const override { return "4C:8B:1D:CE:BA:D1"; }
+  UniqueId GetUniqueId() const override { return 1; }
+};
+
+// Runs the platform scans in memory, and reports them started synchronously.
+class FakeBleMedium : public BleMedium {
+ public:
+  struct Scan {
+    Uuid service_uuid;
+    TxPowerLevel tx_power_level;
+    ScanningCallback callback;
+    bool stopped = false;
+  };
+
+  bool StartAdvertising(const BleAdvertisementData& advertising_data,
+                        api::ble_v2::AdvertiseParameters) override {
+    return false;
+  }
+  std::unique_ptr<AdvertisingSession> StartAdvertising(
+      const BleAdvertisementData& advertising_data,
+      api::ble_v2::AdvertiseParameters, AdvertisingCallback) override {
+    return nullptr;
+  }
+  bool StopAdvertising() override { return false; }
+  bool StartScanning(const Uuid& service_uuid, TxPowerLevel tx_power_level,
+                     ScanCallback callback) override {
+    return false;
+  }
+  bool StopScanning() override { return false; }
+  std::unique_ptr<ScanningSession> StartScanning(
+      const Uuid& service_uuid, TxPowerLevel tx_power_level,
+      ScanningCallback callback) override {
+    if (fail_to_scan_) return nullptr;
+    scans_.push_back(std::make_unique<Scan>(
+        Scan{service_uuid, tx_power_level, std::move(callback)}));
+    Scan* scan = scans_.back().get();
+    scan->callback.start_scanning_result(absl::OkStatus());
+    return std::make_unique<ScanningSession>(ScanningSession{
+        .stop_scanning =
+            [this, scan]() {
+              scan->stopped = true;
+              scan_stopped_.CountDown();
+              return absl::OkStatus();
+            },
+    });
+  }
+  std::unique_ptr<api::ble_v2::GattServer> StartGattServer(
+      api::ble_v2::ServerGattConnectionCallback) override {
+    return nullptr;
+  }
+  std::unique_ptr<api::ble_v2::GattClient> ConnectToGattServer(
+      BlePeripheral&, TxPowerLevel,
+      api::ble_v2::ClientGattConnectionCallback) override {
+    return nullptr;
+  }
+  std::unique_ptr<api::ble_v2::BleServerSocket> OpenServerSocket(
+      const std::string&) override {
+    return nullptr;
+  }
+  std::unique_ptr<api::ble_v2::BleSocket> Connect(const std::string&,
+                                                  TxPowerLevel, BlePeripheral&,
+                                                  CancellationFlag*) override {
+    return nullptr;
+  }
+  bool IsExtendedAdvertisementsAvailable() override { return false; }
+  bool GetRemotePeripheral(const std::string&,
+                           GetRemotePeripheralCallback) override {
+    return false;
+  }
+  bool GetRemotePeripheral(BlePeripheral::UniqueId,
+                           GetRemotePeripheralCallback) override {
+    return false;
+  }
+
+  // Returns the scans that are not stopped.
+  std::vector<Scan*> GetRunningScans() {
+    std::vector<Scan*> running_scans;
+    for (auto& scan : scans_) {
+      if (!scan->stopped) running_scans.push_back(scan.get());
+    }
+    return running_scans;
+  }
+
+  // Reports an advertisement for |service_uuid| found by the running scans.
+  void FindAdvertisement(const Uuid& service_uuid, const std::string& data) {
+    BleAdvertisementData advertisement_data;
+    advertisement_data.service_data[service_uuid] = ByteArray(data);
+    for (Scan* scan : GetRunningScans()) {
+      if (scan->service_uuid == service_uuid) {
+        scan->callback.advertisement_found_cb(peripheral_, advertisement_data);
+      }
+    }
+  }
+
+  void SetFailToScan(bool fail_to_scan) { fail_to_scan_ = fail_to_scan; }
+
+  // Returns true once a scan is stopped, possibly on another thread.
+  bool WaitForScanStopped() { return scan_stopped_.Await(kTimeout).result(); }
+
+ private:
+  FakeBlePeripheral peripheral_;
+  std::vector<std::unique_ptr<Scan>> scans_;
+  bool fail_to_scan_ = false;
+  CountDownLatch scan_stopped_{1};
+};
+
+class BleScanArbiterTest : public ::testing::Test {
+ protected:
+  // Returns a callback recording the advertisements it finds in |found|.
+  static BleMedium::ScanningCallback RecordFound(
+      const Uuid& service_uuid, std::vector<std::string>& found,
+      int* started = nullptr) {
+    return {
+        .start_scanning_result =
+            [started](absl::Status status) {
+              if (started != nullptr && status.ok()) ++*started;
+            },
+        .advertisement_found_cb =
+            [service_uuid, &found](BlePeripheral& peripheral,
+                                   BleAdvertisementData advertisement_data) {
+              found.push_back(std::string(
+                  advertisement_data.service_data[service_uuid]));
+            },
+    };
+  }
+
+  FakeBleMedium* medium_ = new FakeBleMedium();
+  std::shared_ptr<BleScanArbiter> arbiter_ = std::make_shared<BleScanArbiter>(
+      std::unique_ptr<FakeBleMedium>(medium_));
+};
+
+TEST_F(BleScanArbiterTest, SharesOnePlatformScanPerServiceUuid) {
+  std::vector<std::string> found_1;
+  std::vector<std::string> found_2;
+  int started = 0;
+  auto session_1 = arbiter_->StartScanning(
+      kServiceUuidA, TxPowerLevel::kLow,
+      RecordFound(kServiceUuidA, found_1, &started));
+  auto session_2 = arbiter_->StartScanning(
+      kServiceUuidA, TxPowerLevel::kLow,
+      RecordFound(kServiceUuidA, found_2, &started));
+  ASSERT_NE(session_1, nullptr);
+  ASSERT_NE(session_2, nullptr);
+
+  EXPECT_EQ(medium_->GetRunningScans().size(), 1);
+  EXPECT_EQ(started, 2);
+  medium_->FindAdvertisement(kServiceUuidA, "advertisement");
+  EXPECT_THAT(found_1, ElementsAre("advertisement"));
+  EXPECT_THAT(found_2, ElementsAre("advertisement"));
+
+  EXPECT_OK(session_1->stop_scanning());
+  EXPECT_EQ(medium_->GetRunningScans().size(), 1);
+  EXPECT_OK(session_2->stop_scanning());
+  EXPECT_THAT(medium_->GetRunningScans(), IsEmpty());
+  EXPECT_THAT(session_2->stop_scanning(),
+              StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST_F(BleScanArbiterTest, DispatchesByServiceUuid) {
+  std::vector<std::string> found_a;
+  std::vector<std::string> found_b;
+  auto session_a = arbiter_->StartScanning(kServiceUuidA, TxPowerLevel::kLow,
+                                           RecordFound(kServiceUuidA, found_a));
+  auto session_b = arbiter_->StartScanning(kServiceUuidB, TxPowerLevel::kLow,
+                                           RecordFound(kServiceUuidB, found_b));
+
+  medium_->FindAdvertisement(kServiceUuidA, "a");
+  medium_->FindAdvertisement(kServiceUuidB, "b");
+
+  EXPECT_THAT(found_a, ElementsAre("a"));
+  EXPECT_THAT(found_b, ElementsAre("b"));
+  EXPECT_OK(session_a->stop_scanning());
+  EXPECT_OK(session_b->stop_scanning());
+}
+
+TEST_F(BleScanArbiterTest, ScansAtTheMostDemandingPowerLevel) {
+  std::vector<std::string> found;
+  auto low_power_session = arbiter_->StartScanning(
+      kServiceUuidA, TxPowerLevel::kLow, RecordFound(kServiceUuidA, found));
+  EXPECT_THAT(arbiter_->GetTxPowerLevel(kServiceUuidA),
+              Optional(TxPowerLevel::kLow));
+
+  auto high_power_session = arbiter_->StartScanning(
+      kServiceUuidA, TxPowerLevel::kHigh, RecordFound(kServiceUuidA, found));
+  EXPECT_THAT(arbiter_->GetTxPowerLevel(kServiceUuidA),
+              Optional(TxPowerLevel::kHigh));
+  ASSERT_EQ(medium_->GetRunningScans().size(), 1);
+  EXPECT_EQ(medium_->GetRunningScans()[0]->tx_power_level, TxPowerLevel::kHigh);
+
+  EXPECT_OK(high_power_session->stop_scanning());
+  EXPECT_THAT(arbiter_->GetTxPowerLevel(kServiceUuidA),
+              Optional(TxPowerLevel::kLow));
+  EXPECT_OK(low_power_session->stop_scanning());
+  EXPECT_EQ(arbiter_->GetTxPowerLevel(kServiceUuidA), std::nullopt);
+}
+
+TEST_F(BleScanArbiterTest, StoppedClientIsNotCalledBack) {
+  std::vector<std::string> found;
+  std::vector<std::string> other_found;
+  auto session = arbiter_->StartScanning(kServiceUuidA, TxPowerLevel::kLow,
+                                         RecordFound(kServiceUuidA, found));
+  auto other_session =
+      arbiter_->StartScanning(kServiceUuidA, TxPowerLevel::kLow,
+                              RecordFound(kServiceUuidA, other_found));
+
+  EXPECT_OK(session->stop_scanning());
+  medium_->FindAdvertisement(kServiceUuidA, "advertisement");
+
+  EXPECT_THAT(found, IsEmpty());
+  EXPECT_THAT(other_found, ElementsAre("advertisement"));
+  EXPECT_OK(other_session->stop_scanning());
+}
+
+TEST_F(BleScanArbiterTest, ClientCanStopScanningFromItsCallback) {
+  std::vector<std::string> found;
+  std::unique_ptr<BleMedium::ScanningSession> session;
+  auto record = RecordFound(kServiceUuidA, found).advertisement_found_cb;
+  session = arbiter_->StartScanning(
+      kServiceUuidA, TxPowerLevel::kLow,
+      {
+          .advertisement_found_cb =
+              [&session, record = std::move(record)](
+                  BlePeripheral& peripheral,
+                  BleAdvertisementData advertisement_data) mutable {
+                EXPECT_OK(session->stop_scanning());
+                // The callback outlives the session it stopped.
+                record(peripheral, std::move(advertisement_data));
+              },
+      });
+  ASSERT_NE(session, nullptr);
+
+  medium_->FindAdvertisement(kServiceUuidA, "advertisement");
+
+  EXPECT_THAT(found, ElementsAre("advertisement"));
+  EXPECT_TRUE(medium_->WaitForScanStopped());
+  EXPECT_THAT(medium_->GetRunningScans(), IsEmpty());
+}
+
+TEST_F(BleScanArbiterTest, FailsIfPlatformFailsToScan) {
+  std::vector<std::string> found;
+  medium_->SetFailToScan(true);
+
+  EXPECT_EQ(arbiter_->StartScanning(kServiceUuidA, TxPowerLevel::kLow,
+                                    RecordFound(kServiceUuidA, found)),
+            nullptr);
+  EXPECT_EQ(arbiter_->GetTxPowerLevel(kServiceUuidA), std::nullopt);
+}
+
+}  // namespace
+}  // namespace nearby
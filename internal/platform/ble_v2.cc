@@ -19,6 +19,10 @@
 #include <utility>
 
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "internal/platform/ble_advertising_scheduler.h"
+#include "internal/platform/ble_scan_arbiter.h"
+#include "internal/platform/feature_flags.h"
 #include "internal/platform/implementation/ble_v2.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
@@ -49,8 +53,30 @@ BleV2Medium::StartAdvertising(
     const api::ble_v2::BleAdvertisementData& advertising_data,
     api::ble_v2::AdvertiseParameters advertise_set_parameters,
     api::ble_v2::BleMedium::AdvertisingCallback callback) {
-  return impl_->StartAdvertising(advertising_data, advertise_set_parameters,
-                                 std::move(callback));
+  if (!FeatureFlags::GetInstance()
+           .GetFlags()
+           .enable_ble_advertising_scheduler) {
+    return impl_->StartAdvertising(advertising_data, advertise_set_parameters,
+                                   std::move(callback));
+  }
+  std::string name = "ble advertisement";
+  if (!advertising_data.service_data.empty()) {
+    absl::StrAppend(&name, " ",
+                    std::string(advertising_data.service_data.begin()->first));
+  }
+  // The scheduler retries the advertisements failing to start on their next
+  // turn, so the client is only told that its advertisement was accepted.
+  std::unique_ptr<api::ble_v2::BleMedium::AdvertisingSession> session =
+      BleAdvertisingScheduler::GetInstance().StartAdvertising(
+          name, static_cast<int>(advertise_set_parameters.tx_power_level),
+          [this, advertising_data, advertise_set_parameters]() {
+            return impl_->StartAdvertising(advertising_data,
+                                           advertise_set_parameters, {});
+          });
+  if (callback.start_advertising_result) {
+    callback.start_advertising_result(absl::OkStatus());
+  }
+  return session;
 }
 
 bool BleV2Medium::StartScanning(const Uuid& service_uuid,
@@ -116,24 +142,68 @@ BleV2Medium::StartScanning(const Uuid& service_uuid,
                            api::ble_v2::TxPowerLevel tx_power_level,
                            api::ble_v2::BleMedium::ScanningCallback callback) {
   NEARBY_LOGS(INFO) << "platform mutex: " << &mutex_;
-  return impl_->StartScanning(
+  auto start_scanning_result =
+      [this, start_scanning_result = std::move(callback.start_scanning_result)](
+          absl::Status status) mutable {
+        {
+          MutexLock lock(&mutex_);
+          if (status.ok()) {
+            scanning_enabled_ = true;
+          }
+        }
+        start_scanning_result(status);
+      };
+  if (!FeatureFlags::GetInstance().GetFlags().enable_shared_ble_scan) {
+    return impl_->StartScanning(
+        service_uuid, tx_power_level,
+        api::ble_v2::BleMedium::ScanningCallback{
+            .start_scanning_result = std::move(start_scanning_result),
+            .advertisement_found_cb =
+                std::move(callback.advertisement_found_cb),
+            .advertisement_lost_cb = std::move(callback.advertisement_lost_cb),
+        });
+  }
+
+  std::shared_ptr<BleScanArbiter> scan_arbiter;
+  {
+    MutexLock lock(&mutex_);
+    if (scan_arbiter_ == nullptr) {
+      scan_arbiter_ = BleScanArbiter::GetInstance();
+    }
+    scan_arbiter = scan_arbiter_;
+  }
+  return scan_arbiter->StartScanning(
       service_uuid, tx_power_level,
       api::ble_v2::BleMedium::ScanningCallback{
-          .start_scanning_result =
-              [this, start_scanning_result =
-                         std::move(callback.start_scanning_result)](
-                  absl::Status status) mutable {
-                {
-                  MutexLock lock(&mutex_);
-                  if (status.ok()) {
-                    scanning_enabled_ = true;
-                  }
-                }
-                start_scanning_result(status);
+          .start_scanning_result = std::move(start_scanning_result),
+          .advertisement_found_cb =
+              [this, advertisement_found_cb =
+                         std::move(callback.advertisement_found_cb)](
+                  api::ble_v2::BlePeripheral& peripheral,
+                  BleAdvertisementData advertisement_data) mutable {
+                advertisement_found_cb(GetLocalPeripheral(peripheral),
+                                       std::move(advertisement_data));
               },
-          .advertisement_found_cb = std::move(callback.advertisement_found_cb),
-          .advertisement_lost_cb = std::move(callback.advertisement_lost_cb),
+          .advertisement_lost_cb =
+              [this, advertisement_lost_cb =
+                         std::move(callback.advertisement_lost_cb)](
+                  api::ble_v2::BlePeripheral& peripheral) mutable {
+                advertisement_lost_cb(GetLocalPeripheral(peripheral));
+              },
+      });
+}
+
+api::ble_v2::BlePeripheral& BleV2Medium::GetLocalPeripheral(
+    api::ble_v2::BlePeripheral& peripheral) {
+  // The peripherals found by the shared scan belong to the medium of the
+  // arbiter; connecting to one goes through this medium.
+  api::ble_v2::BlePeripheral* local_peripheral = &peripheral;
+  impl_->GetRemotePeripheral(
+      peripheral.GetUniqueId(),
+      [&local_peripheral](api::ble_v2::BlePeripheral& remote_peripheral) {
+        local_peripheral = &remote_peripheral;
       });
+  return *local_peripheral;
 }
 
 std::unique_ptr<GattServer> BleV2Medium::StartGattServer(
@@ -225,6 +295,27 @@ BleV2Socket BleV2Medium::Connect(const std::string& service_id,
   return socket;
 }
 
+BleV2ServerSocket BleV2Medium::OpenL2capServerSocket(
+    const std::string& service_id) {
+  return BleV2ServerSocket(*this, impl_->OpenL2capServerSocket(service_id));
+}
+
+BleV2Socket BleV2Medium::ConnectOverL2cap(int psm,
+                                          const std::string& service_id,
+                                          TxPowerLevel tx_power_level,
+                                          const BleV2Peripheral& peripheral,
+                                          CancellationFlag* cancellation_flag) {
+  BleV2Socket socket;
+  peripheral.GetImpl([&](api::ble_v2::BlePeripheral& device) {
+    socket = BleV2Socket(
+        peripheral,
+        impl_->ConnectOverL2cap(psm, service_id, tx_power_level,
+                                api::ble_v2::L2capSocketOptions(), device,
+                                cancellation_flag));
+  });
+  return socket;
+}
+
 bool BleV2Medium::IsExtendedAdvertisementsAvailable() {
   return IsValid() && impl_->IsExtendedAdvertisementsAvailable();
 }
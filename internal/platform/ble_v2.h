@@ -24,6 +24,7 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "internal/platform/ble_scan_arbiter.h"
 #include "internal/platform/bluetooth_adapter.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/implementation/ble_v2.h"
@@ -56,6 +57,12 @@ class BleV2Peripheral final {
   ByteArray GetId() const { return id_; }
   void SetId(const ByteArray& id) { id_ = id; }
 
+  // Returns the identifier of the platform peripheral, which doesn't change
+  // when its BLE address rotates. Empty for a default-constructed peripheral.
+  std::optional<api::ble_v2::BlePeripheral::UniqueId> GetUniqueId() const {
+    return unique_id_;
+  }
+
   int GetPsm() const { return psm_; }
   void SetPsm(int psm) { psm_ = psm; }
 
@@ -123,6 +130,13 @@ class BleV2Socket final {
   // Returns BlePeripheral object which wraps a valid BlePeripheral pointer.
   BleV2Peripheral& GetRemotePeripheral() { return peripheral_; }
 
+  // Requests high throughput, or power-balanced, connection parameters.
+  // Returns the parameters granted, or absl::nullopt if unsupported.
+  absl::optional<api::ble_v2::BleConnectionParameters>
+  RequestConnectionParameters(bool high_throughput) {
+    return state_->socket->RequestConnectionParameters(high_throughput);
+  }
+
   // Returns true if a socket is usable. If this method returns false,
   // it is not safe to call any other method.
   // NOTE(socket validity):
@@ -158,6 +172,11 @@ class BleV2ServerSocket final {
   BleV2ServerSocket(BleV2Medium& medium,
                     std::unique_ptr<api::ble_v2::BleServerSocket> socket)
       : medium_(&medium), impl_(std::move(socket)) {}
+  BleV2ServerSocket(BleV2Medium& medium,
+                    std::unique_ptr<api::ble_v2::BleL2capServerSocket> socket)
+      : medium_(&medium),
+        psm_(socket != nullptr ? socket->GetPsm() : 0),
+        impl_(std::move(socket)) {}
   BleV2ServerSocket(const BleV2ServerSocket&) = default;
   BleV2ServerSocket& operator=(const BleV2ServerSocket&) = default;
 
@@ -191,10 +210,13 @@ class BleV2ServerSocket final {
   }
 
   bool IsValid() const { return impl_ != nullptr; }
+  // Returns the PSM of an L2CAP server socket, 0 otherwise.
+  int GetPsm() const { return psm_; }
   api::ble_v2::BleServerSocket& GetImpl() { return *impl_; }
 
  private:
   BleV2Medium* medium_;
+  int psm_ = 0;
   std::shared_ptr<api::ble_v2::BleServerSocket> impl_;
 };
 
@@ -383,6 +405,9 @@ class BleV2Medium final {
   // TODO(b/271305977) remove this function.
   bool StopAdvertising();
 
+  // With |enable_ble_advertising_scheduler|, the advertisement takes turns
+  // with the ones of the other clients; see BleAdvertisingScheduler. The
+  // returned session must be stopped before this medium is destroyed.
   std::unique_ptr<api::ble_v2::BleMedium::AdvertisingSession> StartAdvertising(
       const api::ble_v2::BleAdvertisementData& advertising_data,
       api::ble_v2::AdvertiseParameters advertise_set_parameters,
@@ -397,6 +422,8 @@ class BleV2Medium final {
   // TODO(b/271305977) remove this function.
   bool StopScanning();
 
+  // Scans through the process-wide BleScanArbiter when the
+  // enable_shared_ble_scan feature flag is on.
   std::unique_ptr<api::ble_v2::BleMedium::ScanningSession> StartScanning(
       const Uuid& service_uuid, api::ble_v2::TxPowerLevel tx_power_level,
       api::ble_v2::BleMedium::ScanningCallback callback);
@@ -422,6 +449,18 @@ class BleV2Medium final {
                       const BleV2Peripheral& peripheral,
                       CancellationFlag* cancellation_flag);
 
+  // Returns a new BleServerSocket on an L2CAP channel.
+  // On Success, BleServerSocket::IsValid() returns true, and GetPsm() returns
+  // the PSM of the channel.
+  BleV2ServerSocket OpenL2capServerSocket(const std::string& service_id);
+
+  // Returns a new BleSocket connected to the L2CAP channel |psm|.
+  // On Success, BleSocket::IsValid() returns true.
+  BleV2Socket ConnectOverL2cap(int psm, const std::string& service_id,
+                               api::ble_v2::TxPowerLevel tx_power_level,
+                               const BleV2Peripheral& peripheral,
+                               CancellationFlag* cancellation_flag);
+
   bool IsExtendedAdvertisementsAvailable();
 
   bool IsValid() const { return impl_ != nullptr; }
@@ -434,6 +473,11 @@ class BleV2Medium final {
   BluetoothAdapter& GetAdapter() { return adapter_; }
 
  private:
+  // Returns the peripheral of this medium matching |peripheral| of another
+  // one, or |peripheral| if there is none.
+  api::ble_v2::BlePeripheral& GetLocalPeripheral(
+      api::ble_v2::BlePeripheral& peripheral);
+
   Mutex mutex_;
   std::unique_ptr<api::ble_v2::BleMedium> impl_;
   BluetoothAdapter& adapter_;
@@ -443,6 +487,7 @@ class BleV2Medium final {
       ABSL_GUARDED_BY(mutex_);
   ScanCallback scan_callback_ ABSL_GUARDED_BY(mutex_);
   bool scanning_enabled_ ABSL_GUARDED_BY(mutex_) = false;
+  std::shared_ptr<BleScanArbiter> scan_arbiter_ ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace nearby
@@ -15,6 +15,7 @@
 #include "internal/platform/blocking_queue_stream.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <utility>
 
@@ -44,24 +45,32 @@ ExceptionOr<ByteArray> BlockingQueueStream::Read(std::int64_t size) {
     return ExceptionOr<ByteArray>(Exception::kInterrupted);
   }
 
-  ByteArray bytes = queue_head_.Empty() ? blocking_queue_.Take() : queue_head_;
-  if (bytes == queue_end_) {
-    LOG(INFO) << "BlockingQueueStream is Interrupted.";
-    return ExceptionOr<ByteArray>(Exception::kInterrupted);
+  if (queue_head_.Empty()) {
+    queue_head_ = blocking_queue_.Take();
+    queue_head_offset_ = 0;
+    if (queue_head_ == queue_end_) {
+      LOG(INFO) << "BlockingQueueStream is Interrupted.";
+      return ExceptionOr<ByteArray>(Exception::kInterrupted);
+    }
   }
 
-  int copy_len = std::min<int>(size, bytes.size());
-  ByteArray buffer;
-  buffer.SetData(bytes.data(), copy_len);
-  if (copy_len < bytes.size()) {
-    queue_head_ = ByteArray(bytes.data() + copy_len, bytes.size() - copy_len);
-  } else {
+  size_t remaining = queue_head_.size() - queue_head_offset_;
+  if (queue_head_offset_ == 0 && static_cast<size_t>(size) >= remaining) {
+    ByteArray chunk = std::move(queue_head_);
+    queue_head_ = ByteArray();
+    return ExceptionOr<ByteArray>(std::move(chunk));
+  }
+  size_t copy_len = std::min<size_t>(size, remaining);
+  ByteArray buffer(queue_head_.data() + queue_head_offset_, copy_len);
+  queue_head_offset_ += copy_len;
+  if (queue_head_offset_ == queue_head_.size()) {
     queue_head_ = ByteArray();
+    queue_head_offset_ = 0;
   }
   return ExceptionOr<ByteArray>(std::move(buffer));
 }
 
-void BlockingQueueStream::Write(const ByteArray& bytes) {
+void BlockingQueueStream::Write(ByteArray&& bytes) {
   if (!is_multiplex_enabled_) {
     LOG(INFO) << "Multiplex is not enabled, drop the write.";
     return;
@@ -71,10 +80,12 @@ void BlockingQueueStream::Write(const ByteArray& bytes) {
         << "Failed to write BlockingQueueStream because it was closed.";
     return;
   }
+  if (bytes.Empty()) return;
+  size_t size = bytes.size();
   is_writing_ = true;
-  blocking_queue_.Put(bytes);
+  blocking_queue_.Put(std::move(bytes));
   is_writing_ = false;
-  NEARBY_VLOG(1) << "BlockingQueueStream wrote " << bytes.size() << " bytes";
+  NEARBY_VLOG(1) << "BlockingQueueStream wrote " << size << " bytes";
 }
 
 Exception BlockingQueueStream::Close() {
@@ -15,6 +15,8 @@
 #ifndef PLATFORM_PUBLIC_BLOCKING_QUEUE_STREAM_H_
 #define PLATFORM_PUBLIC_BLOCKING_QUEUE_STREAM_H_
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 
 #include "connections/implementation/flags/nearby_connections_feature_flags.h"
@@ -24,7 +26,6 @@
 #include "internal/platform/exception.h"
 #include "internal/platform/feature_flags.h"
 #include "internal/platform/input_stream.h"
-#include "internal/platform/mutex.h"
 
 namespace nearby {
 class BlockingQueueStream : public InputStream {
@@ -32,15 +33,15 @@ class BlockingQueueStream : public InputStream {
   BlockingQueueStream();
   ~BlockingQueueStream() override = default;
 
+  // Returns the next written chunk as is if it fits in |size|, without
+  // copying it.
   ExceptionOr<ByteArray> Read(std::int64_t size) override;
-  void Write(const ByteArray& bytes);
+  void Write(const ByteArray& bytes) { Write(ByteArray(bytes)); }
+  void Write(ByteArray&& bytes);
   Exception Close() override;
-  bool IsWriting() const {
-    return is_writing_;
-  }
+  bool IsWriting() const { return is_writing_; }
 
  private:
-  mutable Mutex mutex_;
   bool is_multiplex_enabled_ = NearbyFlags::GetInstance().GetBoolFlag(
       connections::config_package_nearby::nearby_connections_feature::
           kEnableMultiplex);
@@ -48,10 +49,14 @@ class BlockingQueueStream : public InputStream {
       FeatureFlags::GetInstance()
           .GetFlags()
           .blocking_queue_stream_queue_capacity};
+  // The chunk being read and how much of it was read already. Only used by
+  // the reader.
   ByteArray queue_head_;
-  ByteArray queue_end_ = ByteArray();
-  bool is_writing_ = false;
-  bool is_closed_ = false;
+  size_t queue_head_offset_ = 0;
+  // Written by Close() to wake the reader.
+  const ByteArray queue_end_ = ByteArray();
+  std::atomic<bool> is_writing_ = false;
+  std::atomic<bool> is_closed_ = false;
 };
 }  // namespace nearby
 
@@ -47,6 +47,32 @@ TEST(BlockingQueueStreamTest, ReadSuccess) {
           kEnableMultiplex, is_multiplex_enabled);
 }
 
+TEST(BlockingQueueStreamTest, ReadReturnsOneChunkAtATime) {
+  bool is_multiplex_enabled = NearbyFlags::GetInstance().GetBoolFlag(
+      connections::config_package_nearby::nearby_connections_feature::
+          kEnableMultiplex);
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      connections::config_package_nearby::nearby_connections_feature::
+          kEnableMultiplex, true);
+
+  BlockingQueueStream stream;
+  stream.Write(ByteArray("chunk1"));
+  stream.Write(ByteArray("chunk2"));
+  ExceptionOr<ByteArray> result = stream.Read(100);
+  EXPECT_EQ(result.result(), ByteArray("chunk1"));
+  result = stream.Read(3);
+  EXPECT_EQ(result.result(), ByteArray("chu"));
+  result = stream.Read(100);
+  EXPECT_EQ(result.result(), ByteArray("nk2"));
+  stream.Close();
+  result = stream.Read(100);
+  EXPECT_EQ(result, ExceptionOr<ByteArray>(Exception::kInterrupted));
+
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      connections::config_package_nearby::nearby_connections_feature::
+          kEnableMultiplex, is_multiplex_enabled);
+}
+
 TEST(BlockingQueueStreamTest, MultiplexDisabled) {
   bool is_multiplex_enabled = NearbyFlags::GetInstance().GetBoolFlag(
       connections::config_package_nearby::nearby_connections_feature::
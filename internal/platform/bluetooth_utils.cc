@@ -20,12 +20,16 @@
 
 #include "absl/strings/ascii.h"
 #include "absl/strings/escaping.h"
-#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "internal/platform/byte_array.h"
 
 namespace nearby {
+namespace {
+
+constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+}  // namespace
 
 std::string BluetoothUtils::ToString(const ByteArray& bluetooth_mac_address) {
   std::string colon_delimited_string;
@@ -36,10 +40,12 @@ std::string BluetoothUtils::ToString(const ByteArray& bluetooth_mac_address) {
   if (IsBluetoothMacAddressUnset(bluetooth_mac_address))
     return colon_delimited_string;
 
-  for (auto byte : std::string(bluetooth_mac_address)) {
-    if (!colon_delimited_string.empty())
-      absl::StrAppend(&colon_delimited_string, ":");
-    absl::StrAppend(&colon_delimited_string, absl::StrFormat("%02X", byte));
+  // "XX:" per byte, less the last colon.
+  colon_delimited_string.resize(kBluetoothMacAddressLength * 3 - 1, ':');
+  for (int i = 0; i < kBluetoothMacAddressLength; i++) {
+    auto byte = static_cast<std::uint8_t>(bluetooth_mac_address.data()[i]);
+    colon_delimited_string[i * 3] = kHexDigits[byte >> 4];
+    colon_delimited_string[i * 3 + 1] = kHexDigits[byte & 0x0F];
   }
   return colon_delimited_string;
 }
@@ -0,0 +1,137 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/buffered_frame_reader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/input_stream.h"
+
+namespace nearby {
+
+BufferedFrameReader::BufferedFrameReader(InputStream* stream,
+                                         std::size_t buffer_size)
+    : stream_(stream),
+      buffer_size_(std::max(buffer_size, sizeof(std::int32_t))) {
+  buffer_.reserve(buffer_size_);
+}
+
+ExceptionOr<ByteArray> BufferedFrameReader::Read(std::int64_t size) {
+  if (size <= 0) {
+    return ExceptionOr<ByteArray>(ByteArray());
+  }
+  if (buffered_size() == 0) {
+    // Large reads don't need the buffer.
+    if (static_cast<std::size_t>(size) >= buffer_size_) {
+      return stream_->Read(size);
+    }
+    ExceptionOr<ByteArray> read_bytes = stream_->Read(buffer_size_);
+    if (!read_bytes.ok() ||
+        read_bytes.result().size() <= static_cast<std::size_t>(size)) {
+      return read_bytes;
+    }
+    buffer_.assign(read_bytes.result().data(), read_bytes.result().size());
+  }
+  std::size_t read_size =
+      std::min(static_cast<std::size_t>(size), buffered_size());
+  ByteArray bytes(buffered_data(), read_size);
+  Consume(read_size);
+  return ExceptionOr<ByteArray>(std::move(bytes));
+}
+
+ExceptionOr<ByteArray> BufferedFrameReader::ReadLengthPrefixedFrame(
+    std::int32_t max_size) {
+  Exception exception = Fill(sizeof(std::int32_t));
+  if (exception.Raised()) {
+    return ExceptionOr<ByteArray>(exception);
+  }
+  const char* header = buffered_data();
+  std::int32_t size = 0;
+  for (std::size_t i = 0; i < sizeof(std::int32_t); i++) {
+    size = (size << 8) | (static_cast<std::int32_t>(header[i]) & 0x0FF);
+  }
+  if (size < 0 || size > max_size) {
+    return ExceptionOr<ByteArray>(Exception::kIo);
+  }
+  std::size_t frame_size = sizeof(std::int32_t) + size;
+  if (frame_size <= buffer_size_) {
+    exception = Fill(frame_size);
+    if (exception.Raised()) {
+      return ExceptionOr<ByteArray>(exception);
+    }
+    ByteArray bytes(buffered_data() + sizeof(std::int32_t), size);
+    Consume(frame_size);
+    return ExceptionOr<ByteArray>(std::move(bytes));
+  }
+
+  // The frame doesn't fit in the buffer: take what is buffered, and read the
+  // rest into the frame.
+  Consume(sizeof(std::int32_t));
+  ByteArray bytes;
+  bytes.SetData(size);
+  std::size_t position = std::min<std::size_t>(buffered_size(), size);
+  bytes.CopyAt(0, ByteArray(buffered_data(), position));
+  Consume(position);
+  while (position < static_cast<std::size_t>(size)) {
+    ExceptionOr<ByteArray> read_bytes = stream_->Read(size - position);
+    if (!read_bytes.ok()) {
+      return read_bytes;
+    }
+    if (read_bytes.result().Empty()) {
+      return ExceptionOr<ByteArray>(Exception::kIo);
+    }
+    bytes.CopyAt(position, read_bytes.result());
+    position += read_bytes.result().size();
+  }
+  return ExceptionOr<ByteArray>(std::move(bytes));
+}
+
+Exception BufferedFrameReader::Close() { return stream_->Close(); }
+
+void BufferedFrameReader::Consume(std::size_t size) {
+  begin_ += size;
+  if (begin_ == buffer_.size()) {
+    buffer_.clear();
+    begin_ = 0;
+  }
+}
+
+Exception BufferedFrameReader::Fill(std::size_t size) {
+  if (buffered_size() >= size) {
+    return {Exception::kSuccess};
+  }
+  if (begin_ + size > buffer_size_) {
+    buffer_.erase(0, begin_);
+    begin_ = 0;
+  }
+  while (buffered_size() < size) {
+    ExceptionOr<ByteArray> read_bytes =
+        stream_->Read(buffer_size_ - buffer_.size());
+    if (!read_bytes.ok()) {
+      return read_bytes.GetException();
+    }
+    if (read_bytes.result().Empty()) {
+      return {Exception::kIo};
+    }
+    buffer_.append(read_bytes.result().data(), read_bytes.result().size());
+  }
+  return {Exception::kSuccess};
+}
+
+}  // namespace nearby
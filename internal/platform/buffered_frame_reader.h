@@ -0,0 +1,67 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_BASE_BUFFERED_FRAME_READER_H_
+#define PLATFORM_BASE_BUFFERED_FRAME_READER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/input_stream.h"
+
+namespace nearby {
+
+// An InputStream that reads its underlying stream in blocks of up to
+// `buffer_size` bytes, and hands out the bytes from its buffer.
+//
+// Length-prefixed frames are parsed in the buffer, so that reading a frame
+// takes one read of the underlying stream for as many frames as fit in a
+// block, instead of one read for the length and one or more for the bytes.
+// Frames larger than the buffer are read into the returned bytes directly.
+//
+// Bytes read ahead from the underlying stream are only available from this
+// reader. Not thread-safe.
+class BufferedFrameReader : public InputStream {
+ public:
+  // `stream` must outlive this reader.
+  BufferedFrameReader(InputStream* stream, std::size_t buffer_size);
+
+  ExceptionOr<ByteArray> Read(std::int64_t size) override;
+  ExceptionOr<ByteArray> ReadLengthPrefixedFrame(
+      std::int32_t max_size) override;
+  // Closes the underlying stream.
+  Exception Close() override;
+
+ private:
+  std::size_t buffered_size() const { return buffer_.size() - begin_; }
+  const char* buffered_data() const { return buffer_.data() + begin_; }
+  void Consume(std::size_t size);
+  // Reads from the underlying stream until at least `size` bytes are
+  // buffered. `size` must not exceed the buffer size.
+  Exception Fill(std::size_t size);
+
+  InputStream* const stream_;
+  const std::size_t buffer_size_;
+  // The bytes from `begin_` on are buffered. The storage is kept across
+  // reads, and its unread bytes moved to the front when more room is needed.
+  std::string buffer_;
+  std::size_t begin_ = 0;
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_BASE_BUFFERED_FRAME_READER_H_
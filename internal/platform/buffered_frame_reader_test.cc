@@ -0,0 +1,124 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/buffered_frame_reader.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/input_stream.h"
+
+namespace nearby {
+namespace {
+
+// Hands out `data` in reads of at most `max_read_size` bytes.
+class FakeInputStream : public InputStream {
+ public:
+  FakeInputStream(std::string data, std::size_t max_read_size)
+      : data_(std::move(data)), max_read_size_(max_read_size) {}
+
+  ExceptionOr<ByteArray> Read(std::int64_t size) override {
+    read_count_++;
+    std::size_t read_size = std::min(
+        {static_cast<std::size_t>(size), max_read_size_, data_.size() - pos_});
+    ByteArray bytes(data_.data() + pos_, read_size);
+    pos_ += read_size;
+    return ExceptionOr<ByteArray>(bytes);
+  }
+  Exception Close() override { return {Exception::kSuccess}; }
+
+  int read_count() const { return read_count_; }
+
+ private:
+  const std::string data_;
+  const std::size_t max_read_size_;
+  std::size_t pos_ = 0;
+  int read_count_ = 0;
+};
+
+std::string Frame(const std::string& bytes) {
+  std::string frame(4, 0);
+  frame[0] = static_cast<char>((bytes.size() >> 24) & 0xFF);
+  frame[1] = static_cast<char>((bytes.size() >> 16) & 0xFF);
+  frame[2] = static_cast<char>((bytes.size() >> 8) & 0xFF);
+  frame[3] = static_cast<char>(bytes.size() & 0xFF);
+  return frame + bytes;
+}
+
+TEST(BufferedFrameReaderTest, ReadsSeveralFramesInOneRead) {
+  FakeInputStream stream(Frame("first") + Frame("") + Frame("third"),
+                         /*max_read_size=*/1024);
+  BufferedFrameReader reader(&stream, /*buffer_size=*/1024);
+
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(100).result()),
+            "first");
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(100).result()), "");
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(100).result()),
+            "third");
+  EXPECT_EQ(stream.read_count(), 1);
+  EXPECT_EQ(reader.ReadLengthPrefixedFrame(100).exception(), Exception::kIo);
+}
+
+TEST(BufferedFrameReaderTest, ReadsFramesSplitOverReads) {
+  std::string data(300, 'a');
+  FakeInputStream stream(Frame(data) + Frame("last"), /*max_read_size=*/7);
+  BufferedFrameReader reader(&stream, /*buffer_size=*/512);
+
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(1000).result()), data);
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(1000).result()),
+            "last");
+}
+
+TEST(BufferedFrameReaderTest, ReadsFramesLargerThanTheBuffer) {
+  std::string data;
+  for (int i = 0; i < 100; i++) data.push_back(static_cast<char>(i));
+  FakeInputStream stream(Frame("small") + Frame(data) + Frame("small"),
+                         /*max_read_size=*/1024);
+  BufferedFrameReader reader(&stream, /*buffer_size=*/16);
+
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(1000).result()),
+            "small");
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(1000).result()), data);
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(1000).result()),
+            "small");
+}
+
+TEST(BufferedFrameReaderTest, FailsOnFrameTooLarge) {
+  FakeInputStream stream(Frame("too large"), /*max_read_size=*/1024);
+  BufferedFrameReader reader(&stream, /*buffer_size=*/1024);
+
+  EXPECT_EQ(reader.ReadLengthPrefixedFrame(4).exception(), Exception::kIo);
+}
+
+TEST(BufferedFrameReaderTest, ReadsBufferedBytes) {
+  FakeInputStream stream(Frame("frame") + "tail", /*max_read_size=*/1024);
+  BufferedFrameReader reader(&stream, /*buffer_size=*/1024);
+
+  EXPECT_EQ(std::string(reader.ReadLengthPrefixedFrame(100).result()),
+            "frame");
+  EXPECT_EQ(std::string(reader.Read(2).result()), "ta");
+  EXPECT_EQ(std::string(reader.ReadExactly(2).result()), "il");
+  // End of file.
+  EXPECT_TRUE(reader.Read(2).result().Empty());
+  EXPECT_EQ(stream.read_count(), 2);
+}
+
+}  // namespace
+}  // namespace nearby
@@ -106,6 +106,10 @@ class ByteArray {
   // operation.
   explicit operator std::string() && { return std::move(data_); }
 
+  // Returns a reference to the internal representation, for APIs that take a
+  // const std::string& and would otherwise force a copy of the data.
+  const std::string& AsStringRef() const { return data_; }
+
   // Returns the representation of the underlying data as a string view.
   absl::string_view AsStringView() const {
     return absl::string_view(data(), size());
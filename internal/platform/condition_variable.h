@@ -30,15 +30,28 @@ class ConditionVariable final {
  public:
   using Platform = api::ImplementationPlatform;
   explicit ConditionVariable(Mutex* mutex)
-      : impl_(Platform::CreateConditionVariable(mutex->impl_.get())) {}
+      : tracker_(mutex->tracker_.get()),
+        impl_(Platform::CreateConditionVariable(mutex->impl_.get())) {}
   ConditionVariable(ConditionVariable&&) = default;
   ConditionVariable& operator=(ConditionVariable&&) = default;
 
   void Notify() { impl_->Notify(); }
-  Exception Wait() { return impl_->Wait(); }
-  Exception Wait(absl::Duration timeout) { return impl_->Wait(timeout); }
+  Exception Wait() {
+    if (tracker_ != nullptr) tracker_->OnWaitStart();
+    Exception result = impl_->Wait();
+    if (tracker_ != nullptr) tracker_->OnWaitEnd();
+    return result;
+  }
+  Exception Wait(absl::Duration timeout) {
+    if (tracker_ != nullptr) tracker_->OnWaitStart();
+    Exception result = impl_->Wait(timeout);
+    if (tracker_ != nullptr) tracker_->OnWaitEnd();
+    return result;
+  }
 
  private:
+  // The profiling state of a named mutex, nullptr otherwise.
+  LockProfiler::Tracker* tracker_;
   std::unique_ptr<api::ConditionVariable> impl_;
 };
 
@@ -13,18 +13,28 @@
 // limitations under the License.
 #include "internal/platform/credential_storage_impl.h"
 
+#include <cstddef>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
 #include "internal/platform/implementation/credential_callbacks.h"
+#include "internal/platform/logging.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/proto/credential.pb.h"
 
 namespace nearby {
 
+using ::nearby::internal::IdentityType;
 using ::nearby::internal::LocalCredential;
 using ::nearby::internal::SharedCredential;
 using ::nearby::presence::CredentialSelector;
 using ::nearby::presence::GetPublicCredentialsResultCallback;
 using ::nearby::presence::PublicCredentialType;
+using ::nearby::presence::SaveCredentialsResultCallback;
 
 void CredentialStorageImpl::SaveCredentials(
     absl::string_view manager_app_id, absl::string_view account_name,
@@ -32,9 +42,45 @@ void CredentialStorageImpl::SaveCredentials(
     const std::vector<SharedCredential>& public_credentials,
     PublicCredentialType public_credential_type,
     SaveCredentialsResultCallback callback) {
-  return impl_->SaveCredentials(manager_app_id, account_name,
-                                private_credentials, public_credentials,
-                                public_credential_type, std::move(callback));
+  if (public_credentials.empty()) {
+    return impl_->SaveCredentials(manager_app_id, account_name,
+                                  private_credentials, public_credentials,
+                                  public_credential_type, std::move(callback));
+  }
+  PublicCredentialKey key{std::string(manager_app_id),
+                          std::string(account_name), public_credential_type};
+  if (private_credentials.empty()) {
+    MutexLock lock(&public_credentials_->mutex);
+    auto it = public_credentials_->entries.find(key);
+    if (it != public_credentials_->entries.end() &&
+        SamePublicCredentials(it->second, public_credentials)) {
+      NEARBY_LOGS(INFO) << "Public credentials for account: [" << account_name
+                        << "], manager app ID:[" << manager_app_id
+                        << "] are unchanged; skip saving them";
+      std::move(callback.credentials_saved_cb)(absl::OkStatus());
+      return;
+    }
+  }
+  impl_->SaveCredentials(
+      manager_app_id, account_name, private_credentials, public_credentials,
+      public_credential_type,
+      SaveCredentialsResultCallback{
+          .credentials_saved_cb =
+              [index = public_credentials_.get(), key = std::move(key),
+               indexed = IndexPublicCredentials(public_credentials),
+               callback = std::move(callback.credentials_saved_cb)](
+                  absl::Status status) mutable {
+                {
+                  MutexLock lock(&index->mutex);
+                  if (status.ok()) {
+                    index->entries[key] = std::move(indexed);
+                  } else {
+                    // What's stored is unknown now; reload it on next read.
+                    index->entries.erase(key);
+                  }
+                }
+                std::move(callback)(status);
+              }});
 }
 
 void CredentialStorageImpl::UpdateLocalCredential(
@@ -55,8 +101,97 @@ void CredentialStorageImpl::GetPublicCredentials(
     const CredentialSelector& credential_selector,
     PublicCredentialType public_credential_type,
     GetPublicCredentialsResultCallback callback) {
-  return impl_->GetPublicCredentials(
-      credential_selector, public_credential_type, std::move(callback));
+  PublicCredentialKey key{credential_selector.manager_app_id,
+                          credential_selector.account_name,
+                          public_credential_type};
+  {
+    MutexLock lock(&public_credentials_->mutex);
+    auto it = public_credentials_->entries.find(key);
+    if (it != public_credentials_->entries.end()) {
+      std::move(callback.credentials_fetched_cb)(
+          SelectPublicCredentials(it->second, credential_selector));
+      return;
+    }
+  }
+  // Loads all the identity types of the key at once, so the following queries
+  // are served from the index.
+  CredentialSelector load_selector = credential_selector;
+  load_selector.identity_type = IdentityType::IDENTITY_TYPE_UNSPECIFIED;
+  impl_->GetPublicCredentials(
+      load_selector, public_credential_type,
+      GetPublicCredentialsResultCallback{
+          .credentials_fetched_cb =
+              [index = public_credentials_.get(), key = std::move(key),
+               credential_selector,
+               callback = std::move(callback.credentials_fetched_cb)](
+                  absl::StatusOr<std::vector<SharedCredential>>
+                      credentials) mutable {
+                if (!credentials.ok()) {
+                  std::move(callback)(credentials.status());
+                  return;
+                }
+                PublicCredentialsByType indexed =
+                    IndexPublicCredentials(*credentials);
+                absl::StatusOr<std::vector<SharedCredential>> selected =
+                    SelectPublicCredentials(indexed, credential_selector);
+                {
+                  MutexLock lock(&index->mutex);
+                  // A save completed meanwhile is more recent.
+                  index->entries.try_emplace(key, std::move(indexed));
+                }
+                std::move(callback)(std::move(selected));
+              }});
+}
+
+CredentialStorageImpl::PublicCredentialsByType
+CredentialStorageImpl::IndexPublicCredentials(
+    const std::vector<SharedCredential>& public_credentials) {
+  PublicCredentialsByType indexed;
+  for (const SharedCredential& credential : public_credentials) {
+    indexed[credential.identity_type()].push_back(credential);
+  }
+  return indexed;
+}
+
+bool CredentialStorageImpl::SamePublicCredentials(
+    const PublicCredentialsByType& indexed,
+    const std::vector<SharedCredential>& public_credentials) {
+  PublicCredentialsByType other = IndexPublicCredentials(public_credentials);
+  if (other.size() != indexed.size()) return false;
+  for (const auto& [identity_type, credentials] : other) {
+    auto it = indexed.find(identity_type);
+    if (it == indexed.end() || it->second.size() != credentials.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < credentials.size(); ++i) {
+      if (it->second[i].SerializeAsString() !=
+          credentials[i].SerializeAsString()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+absl::StatusOr<std::vector<SharedCredential>>
+CredentialStorageImpl::SelectPublicCredentials(
+    const PublicCredentialsByType& indexed,
+    const CredentialSelector& credential_selector) {
+  std::vector<SharedCredential> selected;
+  if (credential_selector.identity_type ==
+      IdentityType::IDENTITY_TYPE_UNSPECIFIED) {
+    for (const auto& [identity_type, credentials] : indexed) {
+      selected.insert(selected.end(), credentials.begin(), credentials.end());
+    }
+  } else {
+    auto it = indexed.find(credential_selector.identity_type);
+    if (it != indexed.end()) selected = it->second;
+  }
+  if (selected.empty()) {
+    return absl::NotFoundError(
+        absl::StrFormat("No public credentials for %v", credential_selector));
+  }
+  return selected;
 }
 
 }  // namespace nearby
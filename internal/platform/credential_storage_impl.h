@@ -16,13 +16,20 @@
 #define THIRD_PARTY_NEARBY_INTERNAL_PLATFORM_CREDENTIAL_STORAGE_IMPL_H_
 
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "internal/platform/implementation/credential_callbacks.h"
 #include "internal/platform/implementation/credential_storage.h"
 #include "internal/platform/implementation/platform.h"
+#include "internal/platform/mutex.h"
+#include "internal/proto/credential.pb.h"
 
 namespace nearby {
 
@@ -30,11 +37,18 @@ namespace nearby {
  * The instance of CredentialStorageImpl is owned by {@code CredentialManager}.
  * It's a wrapper on top of implementation/credential_storage.h to providing
  * credential storage operations for Nearby logic layer to invoke.
+ *
+ * Public credentials are indexed in memory by identity type, per
+ * manager app/account/credential type, the first time they are read or saved,
+ * so scanning queries don't go through the platform storage; saving the same
+ * public credentials again, as remote credentials are after every server sync,
+ * is not written through.
  */
 class CredentialStorageImpl : public api::CredentialStorage {
  public:
   explicit CredentialStorageImpl()
-      : impl_(api::ImplementationPlatform::CreateCredentialStorage()) {}
+      : impl_(api::ImplementationPlatform::CreateCredentialStorage()),
+        public_credentials_(std::make_unique<PublicCredentialIndex>()) {}
 
   // CredentialStorageImpl class is movable but not copyable.
   CredentialStorageImpl(CredentialStorageImpl&& other) = default;
@@ -64,7 +78,31 @@ class CredentialStorageImpl : public api::CredentialStorage {
       GetPublicCredentialsResultCallback callback) override;
 
  private:
+  using PublicCredentialKey =
+      std::tuple<std::string, std::string, PublicCredentialType>;
+  // The public credentials of a key, by identity type.
+  using PublicCredentialsByType =
+      absl::flat_hash_map<nearby::internal::IdentityType,
+                          std::vector<SharedCredential>>;
+
+  struct PublicCredentialIndex {
+    Mutex mutex;
+    absl::flat_hash_map<PublicCredentialKey, PublicCredentialsByType> entries
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  static PublicCredentialsByType IndexPublicCredentials(
+      const std::vector<SharedCredential>& public_credentials);
+  static bool SamePublicCredentials(
+      const PublicCredentialsByType& indexed,
+      const std::vector<SharedCredential>& public_credentials);
+  static absl::StatusOr<std::vector<SharedCredential>> SelectPublicCredentials(
+      const PublicCredentialsByType& indexed,
+      const CredentialSelector& credential_selector);
+
   std::unique_ptr<api::CredentialStorage> impl_;
+  // Held by pointer to keep the class movable.
+  std::unique_ptr<PublicCredentialIndex> public_credentials_;
 };
 
 }  // namespace nearby
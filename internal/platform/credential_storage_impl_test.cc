@@ -506,5 +506,50 @@ INSTANTIATE_TEST_SUITE_P(
     testing::Values(IdentityType::IDENTITY_TYPE_PRIVATE_GROUP,
                     IdentityType::IDENTITY_TYPE_CONTACTS_GROUP));
 
+TEST(CredentialStorageImplTest, GetPublicCredentialsByIdentityType) {
+  CredentialStorageImpl credential_storage;
+  EXPECT_OK(SavePublicCredentials(credential_storage,
+                                  PublicCredentialType::kRemotePublicCredential,
+                                  kSecretId));
+
+  auto fetched_public_credentials = GetPublicCredentials(
+      credential_storage, IdentityType::IDENTITY_TYPE_CONTACTS_GROUP,
+      PublicCredentialType::kRemotePublicCredential);
+  ASSERT_OK(fetched_public_credentials);
+  EXPECT_THAT(*fetched_public_credentials,
+              UnorderedPointwise(
+                  EqualsProto(),
+                  {CreatePublicCredential(
+                      kSecretId, IdentityType::IDENTITY_TYPE_CONTACTS_GROUP)}));
+  EXPECT_THAT(
+      GetPublicCredentials(credential_storage,
+                           IdentityType::IDENTITY_TYPE_PUBLIC,
+                           PublicCredentialType::kRemotePublicCredential),
+      StatusIs(absl::StatusCode::kNotFound));
+}
+
+TEST(CredentialStorageImplTest, SaveUnchangedRemotePublicCredentials) {
+  constexpr absl::string_view kAnotherSecretId = "another secret id";
+  CredentialStorageImpl credential_storage;
+
+  EXPECT_OK(SavePublicCredentials(credential_storage,
+                                  PublicCredentialType::kRemotePublicCredential,
+                                  kSecretId));
+  EXPECT_OK(SavePublicCredentials(credential_storage,
+                                  PublicCredentialType::kRemotePublicCredential,
+                                  kSecretId));
+  EXPECT_OK(SavePublicCredentials(credential_storage,
+                                  PublicCredentialType::kRemotePublicCredential,
+                                  kAnotherSecretId));
+
+  auto fetched_public_credentials = GetPublicCredentials(
+      credential_storage, IdentityType::IDENTITY_TYPE_UNSPECIFIED,
+      PublicCredentialType::kRemotePublicCredential);
+  ASSERT_OK(fetched_public_credentials);
+  EXPECT_THAT(
+      *fetched_public_credentials,
+      UnorderedPointwise(EqualsProto(), BuildPublicCreds(kAnotherSecretId)));
+}
+
 }  // namespace
 }  // namespace nearby
@@ -0,0 +1,172 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "internal/platform/executor_stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/time/time.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+namespace {
+
+int BucketOf(int64_t micros) {
+  int bucket = 0;
+  // Bucket 0 holds everything below 1ms.
+  for (int64_t limit = 1000;
+       micros >= limit && bucket + 1 < ExecutorStats::kNumBuckets;
+       limit *= 2) {
+    bucket++;
+  }
+  return bucket;
+}
+
+void UpdateMax(std::atomic<int64_t>& max, int64_t value) {
+  int64_t current = max.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max.compare_exchange_weak(current, value,
+                                    std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+absl::Duration ExecutorStats::Histogram::ApproximatePercentile(
+    double percentile) const {
+  if (count == 0) return absl::ZeroDuration();
+  int64_t rank = static_cast<int64_t>(count * percentile / 100);
+  int64_t seen = 0;
+  for (int i = 0; i < kNumBuckets - 1; i++) {
+    seen += buckets[i];
+    if (seen > rank) return absl::Milliseconds(int64_t{1} << i);
+  }
+  return absl::InfiniteDuration();
+}
+
+void ExecutorStats::AtomicHistogram::Record(absl::Duration duration) {
+  int64_t micros = std::max<int64_t>(absl::ToInt64Microseconds(duration), 0);
+  buckets_[BucketOf(micros)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_micros_.fetch_add(micros, std::memory_order_relaxed);
+  UpdateMax(max_micros_, micros);
+}
+
+ExecutorStats::Histogram ExecutorStats::AtomicHistogram::Get() const {
+  Histogram histogram;
+  for (int i = 0; i < kNumBuckets; i++) {
+    histogram.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  histogram.count = count_.load(std::memory_order_relaxed);
+  histogram.total =
+      absl::Microseconds(total_micros_.load(std::memory_order_relaxed));
+  histogram.max =
+      absl::Microseconds(max_micros_.load(std::memory_order_relaxed));
+  return histogram;
+}
+
+void ExecutorStats::OnSubmitted() {
+  int64_t submitted =
+      submitted_count_.fetch_add(1, std::memory_order_relaxed) + 1;
+  UpdateMax(max_queue_depth_,
+            submitted - started_count_.load(std::memory_order_relaxed));
+}
+
+void ExecutorStats::OnStarted(absl::Duration queue_latency) {
+  started_count_.fetch_add(1, std::memory_order_relaxed);
+  queue_latency_.Record(queue_latency);
+}
+
+void ExecutorStats::OnCompleted(absl::Duration run_time) {
+  completed_count_.fetch_add(1, std::memory_order_relaxed);
+  run_time_.Record(run_time);
+}
+
+ExecutorStats::Snapshot ExecutorStats::GetSnapshot() const {
+  Snapshot snapshot;
+  snapshot.name = name_;
+  // Read the started count first, so that the depth can't go negative.
+  int64_t started = started_count_.load(std::memory_order_relaxed);
+  snapshot.submitted_count = submitted_count_.load(std::memory_order_relaxed);
+  snapshot.completed_count = completed_count_.load(std::memory_order_relaxed);
+  snapshot.queue_depth =
+      std::max<int64_t>(snapshot.submitted_count - started, 0);
+  snapshot.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+  snapshot.queue_latency = queue_latency_.Get();
+  snapshot.run_time = run_time_.Get();
+  return snapshot;
+}
+
+ExecutorStatsRegistry& ExecutorStatsRegistry::GetInstance() {
+  static ExecutorStatsRegistry* instance = new ExecutorStatsRegistry();
+  return *instance;
+}
+
+std::shared_ptr<ExecutorStats> ExecutorStatsRegistry::Register(
+    std::string name) {
+  auto stats = std::make_shared<ExecutorStats>(std::move(name));
+  MutexLock lock(&mutex_);
+  stats_.erase(std::remove_if(stats_.begin(), stats_.end(),
+                              [](const std::weak_ptr<ExecutorStats>& stats) {
+                                return stats.expired();
+                              }),
+               stats_.end());
+  stats_.push_back(stats);
+  return stats;
+}
+
+std::vector<ExecutorStats::Snapshot> ExecutorStatsRegistry::GetSnapshots() {
+  std::vector<ExecutorStats::Snapshot> snapshots;
+  MutexLock lock(&mutex_);
+  for (const std::weak_ptr<ExecutorStats>& weak_stats : stats_) {
+    if (std::shared_ptr<ExecutorStats> stats = weak_stats.lock()) {
+      snapshots.push_back(stats->GetSnapshot());
+    }
+  }
+  return snapshots;
+}
+
+void ExecutorStatsRegistry::SetTaskTraceListener(absl::Duration threshold,
+                                                 TaskTraceListener listener) {
+  MutexLock lock(&mutex_);
+  trace_threshold_ = threshold;
+  listener_ = std::move(listener);
+  has_listener_.store(listener_ != nullptr, std::memory_order_release);
+}
+
+void ExecutorStatsRegistry::ClearTaskTraceListener() {
+  MutexLock lock(&mutex_);
+  listener_ = nullptr;
+  has_listener_.store(false, std::memory_order_release);
+}
+
+void ExecutorStatsRegistry::MaybeTrace(const TaskTrace& trace) {
+  if (!has_listener_.load(std::memory_order_acquire)) return;
+  MutexLock lock(&mutex_);
+  if (listener_ == nullptr) return;
+  if (trace.start_time - trace.submit_time < trace_threshold_ &&
+      trace.end_time - trace.start_time < trace_threshold_) {
+    return;
+  }
+  listener_(trace);
+}
+
+}  // namespace nearby
@@ -0,0 +1,154 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PLATFORM_PUBLIC_EXECUTOR_STATS_H_
+#define PLATFORM_PUBLIC_EXECUTOR_STATS_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/mutex.h"
+
+namespace nearby {
+
+// Counters and latency histograms of one named executor.
+//
+// Updated by `SubmittableExecutor` for every task it runs, with atomics only,
+// so executors on hot paths can keep stats without contending for a lock.
+class ExecutorStats {
+ public:
+  // Bucket `i` counts durations below 2^i milliseconds; the last bucket also
+  // counts everything longer.
+  static constexpr int kNumBuckets = 16;
+
+  struct Histogram {
+    std::array<int64_t, kNumBuckets> buckets{};
+    int64_t count = 0;
+    absl::Duration total = absl::ZeroDuration();
+    absl::Duration max = absl::ZeroDuration();
+
+    // Returns the upper bound of the bucket holding the `percentile` (0-100)
+    // of the recorded durations. `absl::InfiniteDuration()` if it falls in
+    // the last bucket, zero if nothing was recorded.
+    absl::Duration ApproximatePercentile(double percentile) const;
+  };
+
+  struct Snapshot {
+    std::string name;
+    int64_t submitted_count = 0;
+    int64_t completed_count = 0;
+    // Tasks submitted but not started yet.
+    int64_t queue_depth = 0;
+    int64_t max_queue_depth = 0;
+    // From submission to the start of the task.
+    Histogram queue_latency;
+    Histogram run_time;
+  };
+
+  explicit ExecutorStats(std::string name) : name_(std::move(name)) {}
+  ExecutorStats(const ExecutorStats&) = delete;
+  ExecutorStats& operator=(const ExecutorStats&) = delete;
+
+  const std::string& name() const { return name_; }
+
+  void OnSubmitted();
+  void OnStarted(absl::Duration queue_latency);
+  void OnCompleted(absl::Duration run_time);
+
+  Snapshot GetSnapshot() const;
+
+ private:
+  class AtomicHistogram {
+   public:
+    void Record(absl::Duration duration);
+    Histogram Get() const;
+
+   private:
+    std::array<std::atomic<int64_t>, kNumBuckets> buckets_{};
+    std::atomic<int64_t> count_{0};
+    std::atomic<int64_t> total_micros_{0};
+    std::atomic<int64_t> max_micros_{0};
+  };
+
+  const std::string name_;
+  std::atomic<int64_t> submitted_count_{0};
+  std::atomic<int64_t> started_count_{0};
+  std::atomic<int64_t> completed_count_{0};
+  std::atomic<int64_t> max_queue_depth_{0};
+  AtomicHistogram queue_latency_;
+  AtomicHistogram run_time_;
+};
+
+// A task that waited or ran for at least the threshold given to
+// `ExecutorStatsRegistry::SetTaskTraceListener()`, in the shape of a trace
+// event.
+struct TaskTrace {
+  std::string executor_name;
+  std::string task_name;
+  absl::Time submit_time;
+  absl::Time start_time;
+  absl::Time end_time;
+};
+
+// Keeps track of the stats of all named executors.
+class ExecutorStatsRegistry {
+ public:
+  using TaskTraceListener = absl::AnyInvocable<void(const TaskTrace&)>;
+
+  static ExecutorStatsRegistry& GetInstance();
+
+  // Creates the stats of an executor. The registry only keeps a weak
+  // reference, so the stats go away with the executor and its tasks.
+  std::shared_ptr<ExecutorStats> Register(std::string name)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the stats of all live named executors.
+  std::vector<ExecutorStats::Snapshot> GetSnapshots()
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Calls `listener` on the executor thread after every task of a named
+  // executor that waited or ran for at least `threshold`. The listener must
+  // be cheap and must not block. Replaces the previous listener.
+  void SetTaskTraceListener(absl::Duration threshold,
+                            TaskTraceListener listener)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  void ClearTaskTraceListener() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Passes `trace` to the listener if there is one and the task reached the
+  // threshold.
+  void MaybeTrace(const TaskTrace& trace) ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  ExecutorStatsRegistry() = default;
+
+  // Lets tasks skip the mutex while nobody listens.
+  std::atomic<bool> has_listener_{false};
+  Mutex mutex_;
+  std::vector<std::weak_ptr<ExecutorStats>> stats_ ABSL_GUARDED_BY(mutex_);
+  absl::Duration trace_threshold_ ABSL_GUARDED_BY(mutex_);
+  TaskTraceListener listener_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_PUBLIC_EXECUTOR_STATS_H_
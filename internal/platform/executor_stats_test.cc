@@ -0,0 +1,145 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "internal/platform/executor_stats.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace {
+
+using ::testing::Contains;
+using ::testing::Field;
+using ::testing::Not;
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+TEST(ExecutorStatsTest, RecordsDurationsInPowerOfTwoBuckets) {
+  ExecutorStats stats("test");
+
+  stats.OnStarted(absl::Microseconds(500));
+  stats.OnStarted(absl::Milliseconds(3));
+  stats.OnStarted(absl::Milliseconds(3));
+  stats.OnStarted(absl::Seconds(1000));
+
+  ExecutorStats::Histogram latency = stats.GetSnapshot().queue_latency;
+  EXPECT_EQ(latency.count, 4);
+  EXPECT_EQ(latency.buckets[0], 1);
+  EXPECT_EQ(latency.buckets[2], 2);
+  EXPECT_EQ(latency.buckets[ExecutorStats::kNumBuckets - 1], 1);
+  EXPECT_EQ(latency.max, absl::Seconds(1000));
+  EXPECT_EQ(latency.ApproximatePercentile(50), absl::Milliseconds(4));
+  EXPECT_EQ(latency.ApproximatePercentile(100), absl::InfiniteDuration());
+  EXPECT_EQ(stats.GetSnapshot().run_time.ApproximatePercentile(50),
+            absl::ZeroDuration());
+}
+
+TEST(ExecutorStatsTest, TracksQueueDepth) {
+  ExecutorStats stats("test");
+
+  stats.OnSubmitted();
+  stats.OnSubmitted();
+  stats.OnSubmitted();
+  stats.OnStarted(absl::ZeroDuration());
+  stats.OnCompleted(absl::ZeroDuration());
+
+  ExecutorStats::Snapshot snapshot = stats.GetSnapshot();
+  EXPECT_EQ(snapshot.submitted_count, 3);
+  EXPECT_EQ(snapshot.completed_count, 1);
+  EXPECT_EQ(snapshot.queue_depth, 2);
+  EXPECT_EQ(snapshot.max_queue_depth, 3);
+}
+
+TEST(ExecutorStatsTest, NamedExecutorReportsItsTasks) {
+  CountDownLatch release(1);
+  CountDownLatch done(4);
+  SingleThreadExecutor executor("NamedExecutorReportsItsTasks");
+  std::shared_ptr<ExecutorStats> stats = executor.GetStats();
+  ASSERT_NE(stats, nullptr);
+
+  executor.Execute("blocker", [&release, &done]() {
+    EXPECT_TRUE(release.Await(kTimeout).result());
+    done.CountDown();
+  });
+  for (int i = 0; i < 3; i++) {
+    executor.Execute([&done]() { done.CountDown(); });
+  }
+  EXPECT_GE(stats->GetSnapshot().queue_depth, 3);
+  release.CountDown();
+  EXPECT_TRUE(done.Await(kTimeout).result());
+  executor.Shutdown();
+
+  ExecutorStats::Snapshot snapshot = stats->GetSnapshot();
+  EXPECT_EQ(snapshot.submitted_count, 4);
+  EXPECT_EQ(snapshot.completed_count, 4);
+  EXPECT_EQ(snapshot.queue_depth, 0);
+  EXPECT_GE(snapshot.max_queue_depth, 3);
+  EXPECT_EQ(snapshot.queue_latency.count, 4);
+  EXPECT_EQ(snapshot.run_time.count, 4);
+  EXPECT_THAT(ExecutorStatsRegistry::GetInstance().GetSnapshots(),
+              Contains(Field(&ExecutorStats::Snapshot::name,
+                             "NamedExecutorReportsItsTasks")));
+}
+
+TEST(ExecutorStatsTest, UnnamedExecutorHasNoStats) {
+  SingleThreadExecutor executor;
+
+  EXPECT_EQ(executor.GetStats(), nullptr);
+}
+
+TEST(ExecutorStatsTest, RegistryForgetsDestroyedExecutors) {
+  {
+    SingleThreadExecutor executor("RegistryForgetsDestroyedExecutors");
+  }
+
+  EXPECT_THAT(ExecutorStatsRegistry::GetInstance().GetSnapshots(),
+              Not(Contains(Field(&ExecutorStats::Snapshot::name,
+                                 "RegistryForgetsDestroyedExecutors"))));
+}
+
+TEST(ExecutorStatsTest, TracesTasksAboveTheThreshold) {
+  Mutex mutex;
+  std::vector<std::string> traced;
+  ExecutorStatsRegistry::GetInstance().SetTaskTraceListener(
+      absl::Milliseconds(50), [&mutex, &traced](const TaskTrace& trace) {
+        MutexLock lock(&mutex);
+        traced.push_back(trace.task_name);
+      });
+  {
+    SingleThreadExecutor executor("TracesTasksAboveTheThreshold");
+    executor.Execute("fast", []() {});
+    executor.Execute("slow", []() { absl::SleepFor(absl::Milliseconds(100)); });
+    executor.Shutdown();
+  }
+  ExecutorStatsRegistry::GetInstance().ClearTaskTraceListener();
+
+  MutexLock lock(&mutex);
+  EXPECT_THAT(traced, Contains("slow"));
+  EXPECT_THAT(traced, Not(Contains("fast")));
+}
+
+}  // namespace
+}  // namespace nearby
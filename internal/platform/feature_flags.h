@@ -38,6 +38,12 @@ class FeatureFlags {
     std::int32_t keep_alive_interval_millis = 5000;
     std::int32_t keep_alive_timeout_millis = 30000;
     bool use_exp_backoff_in_bwu_retry = true;
+    // Keep writing on the prior channel while a bandwidth upgrade completes,
+    // instead of pausing writes until the prior channel is shut down. Writes
+    // move to the upgraded channel, at a frame boundary, once the
+    // SAFE_TO_CLOSE_PRIOR_CHANNEL frame is written. Compatible with remote
+    // devices that don't enable it. Read when an upgrade protocol starts.
+    bool enable_bwu_make_before_break = false;
     // without the exp backoff, retry intervals in seconds: 5, 10, 10, 10...
     // with the exp backoff, retry intervals in seconds: 3, 6, 12, 24...
     absl::Duration bwu_retry_exp_backoff_initial_delay = absl::Seconds(3);
@@ -67,6 +73,17 @@ class FeatureFlags {
     // and StopScanning for BLE V2.
     // TODO(b/333408829): Add flag to control async advertising.
     bool enable_ble_v2_async_scanning = false;
+    // Run the async BLE V2 scans of all the clients in the process through
+    // one platform medium, with one platform scan per service UUID. See
+    // BleScanArbiter.
+    bool enable_shared_ble_scan = false;
+    // Put the async BLE V2 advertisements of all the clients in the process
+    // on air through one scheduler, which rotates them over
+    // |ble_advertising_max_sets| advertising sets every
+    // |ble_advertising_time_slice|. See BleAdvertisingScheduler.
+    bool enable_ble_advertising_scheduler = false;
+    std::uint32_t ble_advertising_max_sets = 2;
+    absl::Duration ble_advertising_time_slice = absl::Seconds(2);
     // Enable legacy device discovered callback being used inside ble v2
     // DiscoverPeripheralTracker flow.
     bool enable_invoking_legacy_device_discovered_cb = false;
@@ -80,6 +97,16 @@ class FeatureFlags {
     absl::Duration safe_to_disconnect_reconnect_timeout_millis =
         absl::Milliseconds(15000);
     std::int32_t safe_to_disconnect_reconnect_retry_attempts = 3;
+    // Growth of the wait between reconnect attempts, up to the max retry
+    // delay, and the fraction of every wait cut at random. The defaults keep
+    // the wait constant.
+    double safe_to_disconnect_reconnect_backoff_multiplier = 1.0;
+    absl::Duration safe_to_disconnect_reconnect_max_retry_delay =
+        absl::Seconds(30);
+    double safe_to_disconnect_reconnect_retry_jitter = 0.0;
+    // Maximum number of mediums a reconnect attempt races: the medium that
+    // dropped, and the ones ranked below it. 1 only retries the lost medium.
+    std::uint32_t safe_to_disconnect_reconnect_max_racing_mediums = 1;
     absl::Duration
         safe_to_disconnect_reconnect_skip_duplicated_endpoint_duration =
             absl::Milliseconds(2000);
@@ -113,11 +140,254 @@ class FeatureFlags {
     // The new outgoing frame with the middle priority will wait for space to
     // become available if the queue is full.'
     std::uint32_t multiplex_socket_middle_priority_queue_capacity = 50;
+    // Every virtual socket of a MultiplexSocket queues its outgoing frames
+    // separately, and may keep at most this many bytes queued before its
+    // writes wait. The queues are served in turn, each sending up to the
+    // quantum bytes per turn, so small frames of one virtual socket don't wait
+    // behind large chunks of another.
+    std::uint32_t multiplex_socket_virtual_socket_max_queued_bytes =
+        1024 * 1024;
+    std::uint32_t multiplex_socket_scheduler_quantum_bytes = 16 * 1024;
     // The maximum size of frame we'll attempt to read, to avoid a remote device
     // from triggering an OutOfMemory error.
     std::uint32_t connection_max_frame_length = 1048576;
     std::uint32_t blocking_queue_stream_queue_capacity = 10;
     bool support_web_rtc_non_cellular_medium = false;
+    // Maximum number of outgoing file chunks that may be read ahead of the
+    // endpoint channel writer. WiFi and WebRTC mediums use the high bandwidth
+    // window, Bluetooth and BLE use the low bandwidth one. A window of 1 keeps
+    // reading and writing strictly sequential.
+    std::uint32_t payload_send_window_high_bandwidth_max_chunks = 4;
+    std::uint32_t payload_send_window_low_bandwidth_max_chunks = 1;
+    // Upper bound of bytes buffered in the send window, regardless of medium.
+    std::uint32_t payload_send_window_max_bytes = 4 * 1024 * 1024;
+    // Number of threads sending bytes and file payloads. Payloads to different
+    // endpoints are sent concurrently; file payloads leave one thread free for
+    // bytes payloads. Read once, when the PayloadManager is created.
+    std::uint32_t max_concurrent_outgoing_payloads = 4;
+    // Run the keep-alive checks of all endpoints on one shared scheduled
+    // executor, instead of one dedicated thread per endpoint. Read once, when
+    // the EndpointManager is created.
+    bool enable_shared_endpoint_keep_alive = false;
+    // Maximum number of endpoint channels a payload frame sent to several
+    // endpoints is written to in parallel. The frame is serialized once and
+    // shared by all writes. A value of 1 writes to the endpoints one after
+    // the other. Read once, when the EndpointManager is created.
+    std::uint32_t payload_fan_out_max_parallel_writes = 1;
+    // Adapt the outgoing chunk size of every endpoint to the time it takes to
+    // send a chunk, within the bounds of its medium. A chunk slower than the
+    // target halves the chunk size; as many fast chunks in a row as
+    // adaptive_chunk_size_grow_after_frames double it. Read once, when the
+    // EndpointManager is created.
+    bool enable_adaptive_chunk_size = false;
+    absl::Duration adaptive_chunk_size_target_frame_duration =
+        absl::Milliseconds(100);
+    std::int32_t adaptive_chunk_size_grow_after_frames = 4;
+    // Input files of at least this size are memory-mapped and read from the
+    // mapping, so outgoing file chunks are read ahead by the kernel and copied
+    // once. Only used by the POSIX file implementation. A file truncated while
+    // it is mapped makes reads past its new end crash, so this is opt-in;
+    // 0 disables it.
+    std::int64_t input_file_mmap_min_size = 0;
+    // Mapped input files are mapped this many bytes at a time, the next window
+    // replacing the previous one as chunks are read, so a large file doesn't
+    // take its whole size of address space. 0 maps the whole file.
+    std::int64_t input_file_mmap_window_size = 64 * 1024 * 1024;
+    // Write incoming file chunks to disk on a background thread, so a slow
+    // disk does not stall reading from the channel. Chunks are coalesced into
+    // writes of at least the coalesce size, and at most the max buffered bytes
+    // wait to be written. The file is flushed before the payload is reported
+    // as complete.
+    bool enable_incoming_file_write_behind = false;
+    std::uint32_t incoming_file_write_behind_max_buffered_bytes =
+        4 * 1024 * 1024;
+    std::uint32_t incoming_file_write_behind_coalesce_bytes = 512 * 1024;
+    // Reserve the announced size of an incoming file on disk before its first
+    // chunk is written, so that the file system allocates it in one go.
+    bool enable_incoming_file_preallocation = true;
+    // Hash file payloads with SHA-256 as their chunks are read or written,
+    // and report the digest in their final progress update. Senders send it
+    // with the last chunk, and receivers fail a file whose digest differs.
+    // Read when a file payload is created.
+    bool enable_file_payload_digest = false;
+    // Advertise the AES-GCM record layer in connection responses, and seal
+    // frames with it instead of the UKEY2 D2D encoding when the remote device
+    // advertised it too. Peers that don't advertise it keep the D2D encoding.
+    bool enable_aead_record_layer = false;
+    // Resume the encryption of the previous session with a one round trip
+    // ticket exchange when auto-reconnecting, instead of a new UKEY2
+    // handshake. Either side falls back to UKEY2 when the other doesn't
+    // resume.
+    bool enable_session_resumption = false;
+    // Number of incoming frames an endpoint channel may read from its socket
+    // ahead of the reader, on a dedicated thread, so reading overlaps with
+    // decrypting the frames read before. 0 reads and decrypts on the reader
+    // thread, one frame at a time. Read when the channel is created.
+    std::uint32_t endpoint_channel_read_ahead_max_frames = 0;
+    // Size of the buffer an endpoint channel reads its socket into, so that
+    // several small frames, or a frame and its length, are read from the
+    // socket at once. 0 reads the length and the bytes of each frame from the
+    // socket. Read when the channel is created.
+    std::uint32_t endpoint_channel_read_buffer_size = 0;
+    // Connect to a discovered endpoint over several of its mediums at once,
+    // instead of one after the other. The most preferred medium is tried
+    // first, and every next one the stagger delay later, or as soon as an
+    // attempt fails, with at most the max racing mediums tried at a time. The
+    // first channel that connects is kept, and the other attempts are
+    // cancelled. Read once, when the PCP handler is created.
+    bool enable_medium_connection_racing = false;
+    std::uint32_t medium_connection_racing_max_mediums = 2;
+    absl::Duration medium_connection_racing_stagger_delay =
+        absl::Milliseconds(300);
+    // Start WifiLan advertising and discovery concurrently with the mediums
+    // sharing the Bluetooth radio, which still start one after the other.
+    // Read once, when the PCP handler is created.
+    bool enable_parallel_medium_startup = false;
+    // Restart only the advertising mediums whose encoded advertisement, power
+    // level or fast advertisement service UUID changes on an advertising
+    // options update, rather than all of them on a power level change and
+    // none otherwise.
+    bool enable_incremental_advertising_update = false;
+    // Accept BLE v2 connections on an L2CAP connection-oriented channel too,
+    // and advertise its PSM. Connect to the L2CAP channel of peripherals that
+    // advertise a PSM, asking for the largest MTU and the LE 2M PHY, and fall
+    // back to the GATT socket when that fails. Platforms without L2CAP
+    // channels keep using the GATT socket.
+    bool enable_ble_l2cap_sockets = false;
+    // Coalesce the found, lost and distance changed events of discovered
+    // endpoints over this window, and deliver only the resulting changes, at
+    // most once per window. Zero delivers every event right away. Read when
+    // discovery starts.
+    absl::Duration discovery_event_coalescing_window = absl::ZeroDuration();
+    // Maximum number of GATT advertisement reads the BLE v2 discovered
+    // peripheral tracker runs at once, when they run in a thread. Every
+    // peripheral has at most one read at a time, and reads of new or changed
+    // advertisement headers run before retries of failed ones. Read once,
+    // when the tracker is created.
+    std::uint32_t ble_v2_gatt_fetch_max_concurrency = 1;
+    // Bounds of the cache of decoded BLE v2 advertisements, which spares
+    // parsing and hashing the advertisements re-broadcast with the same
+    // bytes. 0 entries disables it. Read once, when the discovered
+    // peripheral tracker is created.
+    std::uint32_t ble_v2_advertisement_cache_max_entries = 256;
+    std::uint32_t ble_v2_advertisement_cache_max_bytes = 64 * 1024;
+    // WifiLan keeps the NSD services it finds for the TTL after they were last
+    // found, and a restarted discovery reports them right away. The ones not
+    // found again within the revalidation timeout are then reported lost, so
+    // a peer that went away shows up as found until then. The platforms don't
+    // report the mDNS record TTLs; 120s is the usual TTL of SRV and TXT
+    // records. Zero disables the cache. Read once, when the WifiLan medium is
+    // created.
+    absl::Duration wifi_lan_nsd_cache_ttl = absl::ZeroDuration();
+    absl::Duration wifi_lan_nsd_cache_revalidation_timeout = absl::Seconds(5);
+    // Once the instant on lost advertisement is restarted for a lost
+    // advertisement, further changes to its hashes over this window are
+    // batched into a single restart at the end of the window. Zero restarts it
+    // on every change. Read once, when the instant on lost manager is created.
+    absl::Duration instant_on_lost_batching_window = absl::Milliseconds(100);
+    // Connections the client disconnects from stay parked for this long, their
+    // channels encrypted and kept alive, if the remote endpoint parks them as
+    // well. The next connection request to the same endpoint resumes them,
+    // without connecting a medium or running UKEY2 again. Zero disables it.
+    // Read once, when the ClientProxy is created.
+    absl::Duration connection_pool_idle_timeout = absl::ZeroDuration();
+    // When an auto-upgraded connection is initiated, let the handler of the
+    // medium it would be upgraded to prepare the upgrade while the client
+    // decides whether to accept it. For WebRTC, both devices create their
+    // peer connection, and the device initiating the upgrade registers with
+    // the signaling server, so the upgrade starts at the offer and answer.
+    bool enable_bwu_prewarm = false;
+    // Advertise payload chunk compression in connection responses, and
+    // compress the chunks of BYTES and STREAM payloads sent to endpoints that
+    // advertised it too, unless the payload opts out. Chunks that look
+    // incompressible or don't shrink enough are sent as they are.
+    bool enable_payload_compression = false;
+    // Advertise payload batching in connection responses, and send BYTES
+    // payloads of at most the max payload size to endpoints that advertised
+    // it together, in one frame of at most the max batch size. A batch waits
+    // at most the max delay for more payloads, and then also takes the ones
+    // sent while the previous payloads to the same endpoints were written.
+    // Read when the PayloadManager is created.
+    bool enable_payload_batching = false;
+    std::uint32_t payload_batching_max_payload_size = 1024;
+    std::uint32_t payload_batching_max_batch_size = 32 * 1024;
+    absl::Duration payload_batching_max_delay = absl::Milliseconds(5);
+    // Deliver the payload, payload progress, discovery and disconnection
+    // callbacks of every client on a thread of its own, so a slow client
+    // doesn't stall the threads reporting them. Progress of a payload still waiting to be
+    // delivered is replaced by the latest one. Once the max pending callbacks
+    // wait, reporting another one waits up to the max wait for the client to
+    // catch up. Read once, when the ClientProxy is created.
+    bool enable_client_callback_queue = false;
+    std::uint32_t client_callback_queue_max_pending = 256;
+    absl::Duration client_callback_queue_max_wait = absl::Milliseconds(20);
+    // Once the last upgrade over a WifiDirect group or WifiHotspot is reverted,
+    // keep the group up, and the devices that joined it connected, for this
+    // long. An upgrade started in the meantime reuses them with the same
+    // credentials, and skips the scan and join. Groups are never reused after
+    // being up for 10 minutes. Zero stops them right away.
+    absl::Duration wifi_bwu_group_reuse_timeout = absl::ZeroDuration();
+    // Order the bandwidth upgrade mediums by their estimated throughput with
+    // the endpoint, as measured on earlier connections to it, rather than by
+    // the static order of preference. Unmeasured mediums are estimated from
+    // their type and the state of the WiFi radio.
+    bool enable_bwu_medium_scoring = false;
+    // Remember, across sessions and in the preferences, how each medium fared
+    // with the remote devices connected before, and try the mediums that
+    // worked with a device first when connecting to it again. With
+    // enable_bwu_medium_scoring, bandwidth upgrades use the throughput
+    // recorded as well, and avoid the mediums that failed last time.
+    bool enable_peer_medium_cache = false;
+    // Read the ConnectionRequestFrame of incoming connections on a pool of
+    // reader threads, and only then go on with them on the PCP handler
+    // thread, so that a peer slow to send its request doesn't hold up the
+    // other connections, discovery and advertising. At most the max readers
+    // read at a time. Read once, when the PCP handler is created.
+    bool enable_async_connection_request_read = false;
+    std::uint32_t connection_request_max_readers = 4;
+    // Runs the device authentication of v3 connections, which follows UKEY2
+    // and takes message round trips of its own, off the PCP handler thread.
+    // At most the max authentications run at a time. Read once, when the PCP
+    // handler is created.
+    bool enable_async_device_authentication = false;
+    std::uint32_t device_authentication_max_concurrent = 4;
+    // Maximum number of UKEY2 handshakes of incoming connections run at a
+    // time. A value of 1 runs them one after the other, so a peer that stalls
+    // its handshake holds up every other incoming connection until it times
+    // out. Read once, when the EncryptionRunner is created.
+    std::uint32_t max_concurrent_server_handshakes = 1;
+    // Disconnects the endpoints of a client that stops all endpoints all at
+    // once: the safe-to-disconnect handshakes run in parallel on up to this
+    // many threads, all channels are closed before waiting for any of them,
+    // and the frame processors are waited for up to a single deadline. A
+    // value of 1 disconnects the endpoints one after the other. Read once,
+    // when the EndpointManager is created.
+    std::uint32_t endpoint_teardown_max_parallel_disconnects = 1;
+    // Count frames read from an endpoint as a sign of life as well as the
+    // frames written to it: while data arrives, a keep-alive is only written
+    // once the endpoint hasn't heard from us for half the keep-alive timeout,
+    // which both ends of a connection share. Read once, when the
+    // EndpointManager is created.
+    bool enable_keep_alive_suppression = false;
+    // The most bytes that incoming BYTES payloads of a client may hold
+    // between being read and being handed to the client. Once reached, the
+    // endpoints aren't read until payloads are delivered, for up to a few
+    // seconds. 0 doesn't bound them. Read when the PayloadManager is created.
+    std::int64_t incoming_bytes_memory_budget = 0;
+    // The most of those bytes a single endpoint may hold. Once reached, only
+    // that endpoint isn't read, so one peer can't take the whole budget of
+    // the client. 0 doesn't bound them. Read when the PayloadManager is
+    // created.
+    std::int64_t incoming_bytes_endpoint_memory_budget = 0;
+    // The most bytes of HTTP responses that NearbyHttpClient keeps in memory,
+    // shared by all clients, to answer GET requests again while the responses
+    // are fresh, or after a 304 Not Modified. 0 disables the cache. Read when
+    // the first NearbyHttpClient is created.
+    std::int64_t http_response_cache_max_bytes = 0;
+    // Have NearbyHttpClient send a GET or HEAD request only once while an
+    // identical request is in flight, and hand the response to both. Read
+    // when a NearbyHttpClient is created.
+    bool coalesce_http_requests = false;
   };
 
   static const FeatureFlags& GetInstance() {
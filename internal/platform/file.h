@@ -85,6 +85,10 @@ class OutputFile final {
   // down to the applicable transport layer.
   Exception Flush();
 
+  // Reserves disk space for |size| bytes on platforms that support it.
+  // Returns Exception::kIo on error, Exception::kSuccess otherwise.
+  Exception Preallocate(std::int64_t size);
+
   // Disallows further writes to the file and frees system resources,
   // associated with it.
   Exception Close();
@@ -85,6 +85,14 @@ constexpr auto kEnableWifiHotspotNative =
 constexpr auto kEnableWifiHotspotNativeScan =
     flags::Flag<bool>(kConfigPackage, "45670001", false);
 
+// Enable/Disable the work stealing executor for MultiThreadExecutor
+constexpr auto kEnableWorkStealingExecutor =
+    flags::Flag<bool>(kConfigPackage, "45673120", false);
+
+// Enable/Disable wait and hold time profiling of named mutexes
+constexpr auto kEnableLockProfiling =
+    flags::Flag<bool>(kConfigPackage, "45673121", false);
+
 }  // namespace nearby_platform_feature
 }  // namespace config_package_nearby
 }  // namespace platform
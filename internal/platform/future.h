@@ -15,16 +15,65 @@
 #ifndef PLATFORM_PUBLIC_FUTURE_H_
 #define PLATFORM_PUBLIC_FUTURE_H_
 
+#include <cstddef>
 #include <memory>
+#include <optional>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>  // NOLINT
+#define NEARBY_FUTURE_COROUTINES 1
+#endif
+
+#include "absl/base/thread_annotations.h"
 #include "absl/time/time.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/implementation/executor.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/runnable.h"
 #include "internal/platform/settable_future.h"
 
 namespace nearby {
 
+template <typename T>
+class Future;
+
+namespace future_internal {
+
+// Runs continuations on the thread that completes the future.
+class InlineExecutor final : public api::Executor {
+ public:
+  static InlineExecutor& GetInstance() {
+    static InlineExecutor* const executor = new InlineExecutor();
+    return *executor;
+  }
+
+  void Execute(Runnable&& runnable) override { runnable(); }
+  void Shutdown() override {}
+};
+
+template <typename T>
+struct ExceptionOrValue;
+
+template <typename T>
+struct ExceptionOrValue<ExceptionOr<T>> {
+  using type = T;
+};
+
+template <typename T>
+void Complete(Future<T>& future, ExceptionOr<T> result) {
+  if (result.ok()) {
+    future.Set(std::move(result).result());
+  } else {
+    future.SetException(result.GetException());
+  }
+}
+
+}  // namespace future_internal
+
 template <typename T>
 class Future final {
  public:
@@ -49,6 +98,61 @@ class Future final {
   }
   bool IsSet() const { return impl_->IsSet(); }
 
+  // Returns a future of the result of |continuation|, which is called with
+  // the result of this future once it is done, successful or not.
+  // |continuation| takes an ExceptionOr<T> and returns an ExceptionOr<U>.
+  //
+  // |continuation| runs on |executor|, or, if null, on the thread that
+  // completes this future; inline continuations must be short. Chaining
+  // continuations lets a multi-step exchange wait for each step without
+  // parking a thread in Get().
+  template <typename F, typename U = typename future_internal::ExceptionOrValue<
+                            std::invoke_result_t<F&, ExceptionOr<T>>>::type>
+  Future<U> Then(F continuation, api::Executor* executor = nullptr) {
+    Future<U> next;
+    AddListener(
+        [next, continuation = std::move(continuation)](
+            ExceptionOr<T> result) mutable {
+          future_internal::Complete(next, continuation(std::move(result)));
+        },
+        executor != nullptr ? executor
+                            : &future_internal::InlineExecutor::GetInstance());
+    return next;
+  }
+
+#ifdef NEARBY_FUTURE_COROUTINES
+  // Makes a coroutine returning Future<T> complete it with co_return, which
+  // takes a T, an Exception or an ExceptionOr<T>.
+  struct promise_type;
+
+  // Lets a coroutine co_await the result of the future. The coroutine resumes
+  // on the thread that completes the future.
+  auto operator co_await() {
+    class Awaiter {
+     public:
+      explicit Awaiter(Future future) : future_(std::move(future)) {}
+
+      bool await_ready() const { return future_.IsSet(); }
+      void await_suspend(std::coroutine_handle<> handle) {
+        future_.AddListener(
+            [this, handle](ExceptionOr<T> result) {
+              result_ = std::move(result);
+              handle.resume();
+            },
+            &future_internal::InlineExecutor::GetInstance());
+      }
+      ExceptionOr<T> await_resume() {
+        return result_.has_value() ? std::move(*result_) : future_.Get();
+      }
+
+     private:
+      Future future_;
+      std::optional<ExceptionOr<T>> result_;
+    };
+    return Awaiter(*this);
+  }
+#endif  // NEARBY_FUTURE_COROUTINES
+
  private:
   // Instance of future implementation is wrapped in shared_ptr<> to make
   // it possible to pass Future by value and share the implementation.
@@ -63,6 +167,88 @@ class Future final {
   std::shared_ptr<SettableFuture<T>> impl_;
 };
 
+#ifdef NEARBY_FUTURE_COROUTINES
+template <typename T>
+struct Future<T>::promise_type {
+  // Not an aggregate, so that a coroutine taking a Future<T> doesn't
+  // initialize |future| with it.
+  promise_type() = default;
+
+  Future<T> get_return_object() { return future; }
+  std::suspend_never initial_suspend() noexcept { return {}; }
+  std::suspend_never final_suspend() noexcept { return {}; }
+  void return_value(T value) { future.Set(std::move(value)); }
+  void return_value(Exception exception) { future.SetException(exception); }
+  void return_value(ExceptionOr<T> result) {
+    future_internal::Complete(future, std::move(result));
+  }
+  void unhandled_exception() { future.SetException({Exception::kFailed}); }
+
+  Future<T> future;
+};
+#endif  // NEARBY_FUTURE_COROUTINES
+
+// Returns a future of the values of |futures|, in order, once they all
+// succeed, or the exception of the first one that fails.
+template <typename T>
+Future<std::vector<T>> WhenAll(std::vector<Future<T>> futures) {
+  struct State {
+    Mutex mutex;
+    std::vector<T> values ABSL_GUARDED_BY(mutex);
+    std::size_t pending ABSL_GUARDED_BY(mutex);
+  };
+
+  Future<std::vector<T>> all;
+  if (futures.empty()) {
+    all.Set({});
+    return all;
+  }
+  auto state = std::make_shared<State>();
+  {
+    MutexLock lock(&state->mutex);
+    state->values.resize(futures.size());
+    state->pending = futures.size();
+  }
+  for (std::size_t i = 0; i < futures.size(); ++i) {
+    futures[i].AddListener(
+        [all, state, i](ExceptionOr<T> result) mutable {
+          if (!result.ok()) {
+            all.SetException(result.GetException());
+            return;
+          }
+          std::vector<T> values;
+          {
+            MutexLock lock(&state->mutex);
+            state->values[i] = std::move(result).result();
+            if (--state->pending > 0) return;
+            values = std::move(state->values);
+          }
+          all.Set(std::move(values));
+        },
+        &future_internal::InlineExecutor::GetInstance());
+  }
+  return all;
+}
+
+// Returns a future of the result of the first of |futures| to be done,
+// successful or not. Fails right away if |futures| is empty.
+template <typename T>
+Future<T> WhenAny(std::vector<Future<T>> futures) {
+  Future<T> any;
+  if (futures.empty()) {
+    any.SetException({Exception::kFailed});
+    return any;
+  }
+  for (Future<T>& future : futures) {
+    future.AddListener(
+        [any](ExceptionOr<T> result) mutable {
+          future_internal::Complete(any, std::move(result));
+        },
+        &future_internal::InlineExecutor::GetInstance());
+  }
+  return any;
+}
+
 }  // namespace nearby
 
 #endif  // PLATFORM_PUBLIC_FUTURE_H_
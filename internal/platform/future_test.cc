@@ -14,6 +14,9 @@
 
 #include "internal/platform/future.h"
 
+#include <vector>
+
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -266,4 +269,99 @@ TEST(FutureTest, SetExceptionBeforeTimeout) {
   EXPECT_EQ(future.Get().exception(), Exception::kExecution);
 }
 
+TEST(FutureTest, DestroyingFutureCancelsTimeout) {
+  for (int i = 0; i < 100; ++i) {
+    Future<int> future(absl::Milliseconds(i % 5));
+    if (i % 2) future.Set(i);
+  }
+
+  // The timeouts of the destroyed futures must not reach them.
+  absl::SleepFor(absl::Milliseconds(50));
+}
+
+TEST(FutureTest, ThenRunsContinuationInline) {
+  Future<int> future;
+  Future<int> doubled =
+      future.Then([](ExceptionOr<int> result) -> ExceptionOr<int> {
+        if (!result.ok()) return result;
+        return ExceptionOr<int>(result.result() * 2);
+      });
+  EXPECT_FALSE(doubled.IsSet());
+
+  future.Set(21);
+
+  EXPECT_TRUE(doubled.IsSet());
+  EXPECT_EQ(doubled.Get().result(), 42);
+}
+
+TEST(FutureTest, ThenPropagatesException) {
+  Future<int> future;
+  SingleThreadExecutor executor;
+  Future<int> next = future.Then(
+      [](ExceptionOr<int> result) -> ExceptionOr<int> { return result; },
+      &executor);
+
+  future.SetException({Exception::kIo});
+
+  EXPECT_EQ(next.Get(absl::Seconds(1)).exception(), Exception::kIo);
+}
+
+TEST(FutureTest, WhenAllCollectsValuesInOrder) {
+  Future<int> first;
+  Future<int> second;
+  Future<std::vector<int>> all = WhenAll<int>({first, second});
+
+  second.Set(2);
+  EXPECT_FALSE(all.IsSet());
+  first.Set(1);
+
+  EXPECT_THAT(all.Get().result(), ::testing::ElementsAre(1, 2));
+}
+
+TEST(FutureTest, WhenAllFailsOnFirstException) {
+  Future<int> first;
+  Future<int> second;
+  Future<std::vector<int>> all = WhenAll<int>({first, second});
+
+  second.SetException({Exception::kTimeout});
+
+  EXPECT_EQ(all.Get().exception(), Exception::kTimeout);
+}
+
+TEST(FutureTest, WhenAnyTakesFirstResult) {
+  Future<int> first;
+  Future<int> second;
+  Future<int> any = WhenAny<int>({first, second});
+
+  second.Set(2);
+  first.Set(1);
+
+  EXPECT_EQ(any.Get().result(), 2);
+}
+
+#ifdef NEARBY_FUTURE_COROUTINES
+Future<int> AddOneWhenSet(Future<int> input) {
+  ExceptionOr<int> value = co_await input;
+  if (!value.ok()) co_return value;
+  co_return value.result() + 1;
+}
+
+TEST(FutureTest, CoroutineAwaitsFuture) {
+  Future<int> input;
+  Future<int> output = AddOneWhenSet(input);
+  EXPECT_FALSE(output.IsSet());
+
+  input.Set(41);
+
+  EXPECT_EQ(output.Get().result(), 42);
+}
+
+TEST(FutureTest, CoroutinePropagatesException) {
+  Future<int> input;
+  input.SetException({Exception::kIo});
+
+  EXPECT_EQ(AddOneWhenSet(input).Get().exception(), Exception::kIo);
+}
+#endif  // NEARBY_FUTURE_COROUTINES
+
 }  // namespace nearby
@@ -0,0 +1,53 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/future_timeouts.h"
+
+#include <utility>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/single_thread_executor.h"
+#include "internal/platform/timer_wheel.h"
+
+namespace nearby {
+
+namespace {
+
+// Never destroyed, futures may time out during process exit.
+TimerWheel& GetTimerWheel() {
+  static TimerWheel* const timer_wheel = new TimerWheel();
+  return *timer_wheel;
+}
+
+SingleThreadExecutor& GetExecutor() {
+  static SingleThreadExecutor* const executor = new SingleThreadExecutor();
+  return *executor;
+}
+
+}  // namespace
+
+FutureTimeouts::TimeoutId FutureTimeouts::Schedule(
+    absl::Duration timeout, absl::AnyInvocable<void()> on_timeout) {
+  return GetTimerWheel().Schedule(
+      timeout, [on_timeout = std::move(on_timeout)]() mutable {
+        GetExecutor().Execute("future-timeout", std::move(on_timeout));
+      });
+}
+
+bool FutureTimeouts::Cancel(TimeoutId id) {
+  return GetTimerWheel().Cancel(id);
+}
+
+}  // namespace nearby
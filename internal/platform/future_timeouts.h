@@ -0,0 +1,46 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_PUBLIC_FUTURE_TIMEOUTS_H_
+#define PLATFORM_PUBLIC_FUTURE_TIMEOUTS_H_
+
+#include <cstdint>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+
+// Expires the timeouts of all the futures of the process on one timer thread,
+// and runs their callbacks on one executor thread, so that a future with a
+// timeout needs neither a timer nor a thread of its own.
+//
+// Callbacks run one at a time and must be short.
+class FutureTimeouts {
+ public:
+  using TimeoutId = std::uint64_t;
+  static constexpr TimeoutId kInvalidTimeoutId = 0;
+
+  // Runs |on_timeout| on the shared executor once |timeout| has passed.
+  static TimeoutId Schedule(absl::Duration timeout,
+                            absl::AnyInvocable<void()> on_timeout);
+
+  // Cancels the timeout of |id|. Returns false if it already expired, in
+  // which case its callback may still be about to run.
+  static bool Cancel(TimeoutId id);
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_PUBLIC_FUTURE_TIMEOUTS_H_
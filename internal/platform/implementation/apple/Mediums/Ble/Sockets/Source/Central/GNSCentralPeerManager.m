@@ -109,6 +109,11 @@ static NSString *PeripheralStateString(CBPeripheralState state) {
 
 // The completion of a write-with-response to peripheral; nil if none is in progress.
 @property(nonatomic) GNSErrorHandler dataWriteCompletion;
+
+// The data of a write-without-response waiting for the peripheral to be ready to send it, and its
+// completion; nil if none is waiting.
+@property(nonatomic) NSData *pendingWriteWithoutResponseData;
+@property(nonatomic) GNSErrorHandler pendingWriteWithoutResponseCompletion;
 @end
 
 @implementation GNSCentralPeerManager
@@ -312,6 +317,8 @@ static NSString *PeripheralStateString(CBPeripheralState state) {
 
   // If there is a pending characteristic write, call the completion.
   [self callDataWriteCompletionWithError:GNSErrorWithCode(GNSErrorLostConnection)];
+  [self callPendingWriteWithoutResponseCompletionWithError:GNSErrorWithCode(
+                                                               GNSErrorLostConnection)];
 
   [self cleanRSSICompletionAfterDisconnectionWithError:error];
   _state = GNSCentralPeerManagerStateBleDisconnecting;
@@ -457,6 +464,15 @@ static NSString *PeripheralStateString(CBPeripheralState state) {
   }
 }
 
+- (void)callPendingWriteWithoutResponseCompletionWithError:(NSError *)error {
+  if (_pendingWriteWithoutResponseCompletion) {
+    GNSErrorHandler completion = _pendingWriteWithoutResponseCompletion;
+    _pendingWriteWithoutResponseCompletion = nil;
+    _pendingWriteWithoutResponseData = nil;
+    dispatch_async(_queue, ^{ completion(error); });
+  }
+}
+
 #pragma mark - CBPeripheralDelegate
 
 - (void)peripheral:(CBPeripheral *)peripheral didDiscoverServices:(NSError *)error {
@@ -583,6 +599,15 @@ static NSString *PeripheralStateString(CBPeripheralState state) {
   [self callDataWriteCompletionWithError:error];
 }
 
+- (void)peripheralIsReadyToSendWriteWithoutResponse:(CBPeripheral *)peripheral {
+  if (!_pendingWriteWithoutResponseData) return;
+  NSData *data = _pendingWriteWithoutResponseData;
+  GNSErrorHandler completion = _pendingWriteWithoutResponseCompletion;
+  _pendingWriteWithoutResponseData = nil;
+  _pendingWriteWithoutResponseCompletion = nil;
+  [self writeValueWithoutResponse:data completion:completion];
+}
+
 // This method sends |packet| fitting a single characteristic write to |socket|. All packets sent by
 // this class (not the socket) must use this method.
 - (void)sendPacket:(GNSWeavePacket *)packet {
@@ -655,6 +680,13 @@ static NSString *PeripheralStateString(CBPeripheralState state) {
 }
 
 - (void)sendData:(NSData *)data socket:(GNSSocket *)socket completion:(GNSErrorHandler)completion {
+  // When the peripheral accepts writes without response, the next packet is written as soon as
+  // CoreBluetooth has room for it, instead of after a round trip for the response of this one.
+  if (_outgoingChar.properties & CBCharacteristicPropertyWriteWithoutResponse) {
+    [self writeValueWithoutResponse:data completion:completion];
+    return;
+  }
+
   GTMLoggerInfo(@"Writing value to characteristic");
   if (_dataWriteCompletion != nil) {
     // This shouldn't happen because writes should be serialized by the socket code. But log it
@@ -686,6 +718,28 @@ static NSString *PeripheralStateString(CBPeripheralState state) {
                        type:CBCharacteristicWriteWithResponse];
 }
 
+// Writes |data| without response if CoreBluetooth has room for it, and otherwise keeps it until
+// -peripheralIsReadyToSendWriteWithoutResponse:. The socket only sends the next packet once
+// |completion| is called, so at most one write waits at a time.
+- (void)writeValueWithoutResponse:(NSData *)data completion:(GNSErrorHandler)completion {
+  if (_pendingWriteWithoutResponseCompletion != nil) {
+    // This shouldn't happen because writes should be serialized by the socket code. But log it
+    // in case there's a bug that causes it to happen.
+    GTMLoggerInfo(@"Previous characteristic data write without response didn't complete");
+  }
+  if (!_cbPeripheral.canSendWriteWithoutResponse) {
+    GTMLoggerInfo(@"Waiting to write value to characteristic without response");
+    _pendingWriteWithoutResponseData = data;
+    _pendingWriteWithoutResponseCompletion = completion;
+    return;
+  }
+  GTMLoggerInfo(@"Writing value to characteristic without response");
+  [_cbPeripheral writeValue:data
+          forCharacteristic:_outgoingChar
+                       type:CBCharacteristicWriteWithoutResponse];
+  dispatch_async(_queue, ^{ completion(nil); });
+}
+
 - (NSUUID *)socketServiceIdentifier:(GNSSocket *)socket {
   return _cbPeripheral.identifier;
 }
@@ -247,6 +247,34 @@ static void FireTimer(void) {
   OCMExpect([_peripheralMock setDelegate:nil]);
 }
 
+- (void)testSendDataWithoutResponseWaitsUntilReady {
+  [self simulateConnectedSocketWithPairingChar:NO];
+  OCMStub([_toPeripheralCharacteristic properties])
+      .andReturn(CBCharacteristicPropertyWrite | CBCharacteristicPropertyWriteWithoutResponse);
+  __block BOOL canSendWriteWithoutResponse = NO;
+  OCMStub([_peripheralMock canSendWriteWithoutResponse]).andDo(^(NSInvocation *invocation) {
+    [invocation setReturnValue:&canSendWriteWithoutResponse];
+  });
+  NSData *data = [@"data" dataUsingEncoding:NSUTF8StringEncoding];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Data sent"];
+  [_centralPeerManager sendData:data
+                         socket:_socket
+                     completion:^(NSError *error) {
+                       XCTAssertNil(error);
+                       [expectation fulfill];
+                     }];
+
+  // The write goes out once CoreBluetooth has room for it.
+  OCMExpect([_peripheralMock writeValue:data
+                      forCharacteristic:_toPeripheralCharacteristic
+                                   type:CBCharacteristicWriteWithoutResponse]);
+  canSendWriteWithoutResponse = YES;
+  [_centralPeerManager peripheralIsReadyToSendWriteWithoutResponse:_peripheralMock];
+  [self waitForExpectationsWithTimeout:1 handler:nil];
+  // The dealloc should set the delegate to nil.
+  OCMExpect([_peripheralMock setDelegate:nil]);
+}
+
 - (void)testBLEDisconnectBeforeConnect {
   OCMExpect([_centralManagerMock connectPeripheralForPeer:_centralPeerManager
                                                   options:[self peripheralConnectionOptions]]);
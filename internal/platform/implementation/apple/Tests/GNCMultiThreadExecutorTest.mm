@@ -30,6 +30,8 @@ using MultiThreadExecutor = ::nearby::api::SubmittableExecutor;
 @interface GNCMultiThreadExecutorTest : XCTestCase
 @property(atomic) int counter;
 @property(atomic) int otherCounter;
+@property(atomic) int running;
+@property(atomic) int maxRunning;
 @end
 
 @implementation GNCMultiThreadExecutorTest
@@ -72,6 +74,32 @@ using MultiThreadExecutor = ::nearby::api::SubmittableExecutor;
   XCTAssertLessThanOrEqual(abs(self.counter - kIncrements), 0);
 }
 
+// Tests that no more runnables than the max concurrency run at once.
+- (void)testLimitsConcurrency {
+  std::unique_ptr<MultiThreadExecutor> executor([self executor]);
+
+  const int kRunnableCount = 16;
+  for (int i = 0; i < kRunnableCount; i++) {
+    executor->Execute([self]() {
+      @synchronized(self) {
+        self.running++;
+        self.maxRunning = MAX(self.maxRunning, self.running);
+      }
+      [NSThread sleepForTimeInterval:0.01];
+      @synchronized(self) {
+        self.running--;
+        self.counter++;
+      }
+    });
+  }
+
+  // Check that all the runnables ran after giving them time to run, at most 4 at once.
+  [NSThread sleepForTimeInterval:0.2];
+  XCTAssertEqual(self.counter, kRunnableCount);
+  XCTAssertLessThanOrEqual(self.maxRunning, 4);
+  XCTAssertGreaterThan(self.maxRunning, 1);
+}
+
 // Tests that fails to submit when the executor is shut down.
 - (void)testFailtoSubmitAfterShutdown {
   std::unique_ptr<MultiThreadExecutor> executor([self executor]);
@@ -115,14 +115,16 @@ BleOutputStream::~BleOutputStream() {
 
 Exception BleOutputStream::Write(const ByteArray &data) {
   [condition_ lock];
-  NSLog(@"[NEARBY] Sending data of size: %lu", NSDataFromByteArray(data).length);
+  NSLog(@"[NEARBY] Sending data of size: %lu", (unsigned long)data.size());
 
   if (!connection_) {
     [condition_ unlock];
     return {Exception::kIo};
   }
 
-  NSMutableData *packet = [NSMutableData dataWithData:NSDataFromByteArray(data)];
+  // A single copy; the connection may still hold on to the packet after a Close() returns this
+  // call early, so it can't borrow the bytes of |data|.
+  NSData *packet = NSDataFromByteArray(data);
 
   // Send the data, blocking until the completion handler is called.
   __block bool isComplete = NO;
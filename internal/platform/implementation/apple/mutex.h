@@ -34,6 +34,11 @@ class ABSL_LOCKABLE Mutex : public api::Mutex {
     mutex_.Lock();
     mutex_.ForgetDeadlockInfo();
   }
+  bool TryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) override {
+    if (!mutex_.TryLock()) return false;
+    mutex_.ForgetDeadlockInfo();
+    return true;
+  }
   void Unlock() ABSL_UNLOCK_FUNCTION() override { mutex_.Unlock(); }
 
  private:
@@ -57,6 +62,15 @@ class ABSL_LOCKABLE RecursiveMutex : public api::Mutex {
     }
     ++count_;
   }
+  bool TryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) override {
+    intptr_t thread_id = ThreadId();
+    if (thread_id_.load(std::memory_order_acquire) != thread_id) {
+      if (!mutex_.TryLock()) return false;
+      thread_id_.store(thread_id, std::memory_order_release);
+    }
+    ++count_;
+    return true;
+  }
 
   void Unlock() ABSL_UNLOCK_FUNCTION() override {
     if (--count_ == 0) {
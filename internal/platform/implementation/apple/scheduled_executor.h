@@ -26,10 +26,23 @@
  * The impl class is an Obj-C class so that
  *  (a) the dispatch block can strongly retain it, and
  *  (b) for ease of declaring an atomic property.
+ *
+ * Every executor queue targets one concurrent queue shared by all
+ * executors, so the executors share the GCD thread pool instead of each
+ * holding on to threads of its own.
  */
-@interface GNCOperationQueueImpl : NSObject
-@property(nonatomic) NSOperationQueue* queue;
+@interface GNCDispatchQueueImpl : NSObject
+/** Runs the blocks; serial for an executor with a max concurrency of 1. */
+@property(nonatomic, readonly) dispatch_queue_t queue;
+/** Tracks the submitted blocks that have not finished yet. */
+@property(nonatomic, readonly) dispatch_group_t group;
 @property(atomic) BOOL shuttingDown;
+
+/**
+ * Runs |block| on |queue| once fewer than the max concurrency blocks are
+ * running.
+ */
+- (void)submit:(dispatch_block_t)block;
 @end
 
 namespace nearby {
@@ -56,7 +69,7 @@ class ScheduledExecutor : public api::ScheduledExecutor {
  private:
   void Shutdown(std::int64_t timeout_millis);
 
-  GNCOperationQueueImpl* impl_;
+  GNCDispatchQueueImpl* impl_;
 };
 
 }  // namespace apple
@@ -43,15 +43,65 @@
 
 @end
 
-@implementation GNCOperationQueueImpl
+@interface GNCDispatchQueueImpl ()
+/** Bounds the blocks running at once on a concurrent |queue|; nil for a serial one. */
+@property(nonatomic) dispatch_semaphore_t slots;
+/** Starts the blocks of a concurrent |queue| in order, as slots free up. */
+@property(nonatomic) dispatch_queue_t admissionQueue;
+@end
+
+@implementation GNCDispatchQueueImpl
+
+/** The root of the executor queues. Its QoS class applies to all of them. */
++ (dispatch_queue_t)targetQueue {
+  static dispatch_queue_t targetQueue;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    targetQueue = dispatch_queue_create(
+        "com.google.nearby.executor",
+        dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_CONCURRENT,
+                                                QOS_CLASS_USER_INITIATED, 0));
+  });
+  return targetQueue;
+}
 
 + (instancetype)implWithMaxConcurrency:(int)maxConcurrency {
-  GNCOperationQueueImpl *impl = [[GNCOperationQueueImpl alloc] init];
-  impl.queue = [[NSOperationQueue alloc] init];
-  impl.queue.maxConcurrentOperationCount = maxConcurrency;
+  GNCDispatchQueueImpl *impl = [[GNCDispatchQueueImpl alloc] init];
+  dispatch_queue_t targetQueue = [GNCDispatchQueueImpl targetQueue];
+  impl->_group = dispatch_group_create();
+  if (maxConcurrency <= 1) {
+    impl->_queue = dispatch_queue_create_with_target("com.google.nearby.executor.serial",
+                                                     DISPATCH_QUEUE_SERIAL, targetQueue);
+  } else {
+    impl->_queue = dispatch_queue_create_with_target("com.google.nearby.executor.concurrent",
+                                                     DISPATCH_QUEUE_CONCURRENT, targetQueue);
+    impl->_slots = dispatch_semaphore_create(maxConcurrency);
+    impl->_admissionQueue = dispatch_queue_create_with_target(
+        "com.google.nearby.executor.admission", DISPATCH_QUEUE_SERIAL, targetQueue);
+  }
   return impl;
 }
 
+- (void)submit:(dispatch_block_t)block {
+  dispatch_group_t group = _group;
+  dispatch_semaphore_t slots = _slots;
+  if (slots == nil) {
+    dispatch_group_async(group, _queue, block);
+    return;
+  }
+
+  dispatch_queue_t queue = _queue;
+  dispatch_group_enter(group);
+  dispatch_async(_admissionQueue, ^{
+    dispatch_semaphore_wait(slots, DISPATCH_TIME_FOREVER);
+    dispatch_async(queue, ^{
+      block();
+      dispatch_semaphore_signal(slots);
+      dispatch_group_leave(group);
+    });
+  });
+}
+
 @end
 
 namespace nearby {
@@ -62,7 +112,8 @@ static const std::int64_t kExecutorShutdownDefaultTimeout = 500;  // 0.5 seconds
 // This Cancelable references a Runnable and a cancel method that sets its canceled boolean to true.
 class CancelableForRunnable : public api::Cancelable {
  public:
-  explicit CancelableForRunnable(GNCRunnableWrapper *runnable) : runnable_(runnable) {}
+  CancelableForRunnable(GNCRunnableWrapper *runnable, dispatch_source_t timer)
+      : runnable_(runnable), timer_(timer) {}
   CancelableForRunnable() = default;
   ~CancelableForRunnable() override = default;
   CancelableForRunnable(const CancelableForRunnable &) = delete;
@@ -71,17 +122,20 @@ class CancelableForRunnable : public api::Cancelable {
   // api::Cancelable:
   bool Cancel() override {
     runnable_->_canceled->Set(true);
+    // Releases the timer, and the runnable with it, unless it already fired.
+    dispatch_source_cancel(timer_);
     return true;
   }
 
  private:
   GNCRunnableWrapper *runnable_;
+  dispatch_source_t timer_;
 };
 
-ScheduledExecutor::ScheduledExecutor() { impl_ = [GNCOperationQueueImpl implWithMaxConcurrency:1]; }
+ScheduledExecutor::ScheduledExecutor() { impl_ = [GNCDispatchQueueImpl implWithMaxConcurrency:1]; }
 
 ScheduledExecutor::ScheduledExecutor(int max_concurrency) {
-  impl_ = [GNCOperationQueueImpl implWithMaxConcurrency:max_concurrency];
+  impl_ = [GNCDispatchQueueImpl implWithMaxConcurrency:max_concurrency];
 }
 
 ScheduledExecutor::~ScheduledExecutor() { impl_ = nil; }
@@ -92,24 +146,30 @@ std::shared_ptr<api::Cancelable> ScheduledExecutor::Schedule(Runnable &&runnable
                                                              absl::Duration duration) {
   if (impl_.shuttingDown) return std::shared_ptr<api::Cancelable>(nullptr);
 
-  // Wrap the runnable in an Obj-C object so it can be referenced by the delayed block.
+  // Wrap the runnable in an Obj-C object so it can be referenced by the timer's block.
   GNCRunnableWrapper *wrapper = [GNCRunnableWrapper wrapperWithRunnable:std::move(runnable)];
-  CancelableForRunnable *cancelable = new CancelableForRunnable(wrapper);
-  GNCOperationQueueImpl *impl = impl_;  // don't capture |this|
-  dispatch_after(
-      dispatch_time(DISPATCH_TIME_NOW, absl::ToInt64Milliseconds(duration) * NSEC_PER_MSEC),
-      dispatch_get_global_queue(DISPATCH_TARGET_QUEUE_DEFAULT, 0), ^{
-        [impl.queue addOperationWithBlock:^{
-          // Execute the runnable only if the executor is not shutting down, and the runnable isn't
-          // canceled.
-          // Warning: This block should reference only Obj-C objects, and never C++ objects.
-          if (!impl.shuttingDown && !wrapper->_canceled->Get()) {
-            wrapper->_runnable();
-          }
-        }];
-      });
-
-  return std::shared_ptr<api::Cancelable>(cancelable);
+  GNCDispatchQueueImpl *impl = impl_;  // don't capture |this|
+  dispatch_source_t timer =
+      dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, /*handle=*/0, /*mask=*/0,
+                             [GNCDispatchQueueImpl targetQueue]);
+  dispatch_source_set_event_handler(timer, ^{
+    // One shot; canceling the timer also releases this block.
+    dispatch_source_cancel(timer);
+    [impl submit:^{
+      // Execute the runnable only if the executor is not shutting down, and the runnable isn't
+      // canceled.
+      // Warning: This block should reference only Obj-C objects, and never C++ objects.
+      if (!impl.shuttingDown && !wrapper->_canceled->Get()) {
+        wrapper->_runnable();
+      }
+    }];
+  });
+  dispatch_source_set_timer(
+      timer, dispatch_time(DISPATCH_TIME_NOW, absl::ToInt64Nanoseconds(duration)),
+      DISPATCH_TIME_FOREVER, /*leeway=*/0);
+  dispatch_resume(timer);
+
+  return std::make_shared<CancelableForRunnable>(wrapper, timer);
 }
 
 void ScheduledExecutor::Execute(Runnable &&runnable) { DoSubmit(std::move(runnable)); }
@@ -121,7 +181,7 @@ bool ScheduledExecutor::DoSubmit(Runnable &&runnable) {
 
   // Submit the runnable to the queue.
   __block Runnable local_runnable = std::move(runnable);
-  [impl_.queue addOperationWithBlock:^{
+  [impl_ submit:^{
     local_runnable();
   }];
   return true;
@@ -131,12 +191,9 @@ void ScheduledExecutor::Shutdown(std::int64_t timeout_millis) {
   // Prevent new/delayed operations from being queued/executed.
   impl_.shuttingDown = YES;
 
-  // Block until either (a) all currently executing operations finish, or (b) the timeout expires.
-  dispatch_group_t group = dispatch_group_create();
-  dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_TARGET_QUEUE_DEFAULT, 0), ^{
-    [impl_.queue waitUntilAllOperationsAreFinished];
-  });
-  dispatch_group_wait(group, dispatch_time(DISPATCH_TIME_NOW, timeout_millis * NSEC_PER_MSEC));
+  // Block until either (a) all submitted blocks finish, or (b) the timeout expires.
+  dispatch_group_wait(impl_.group,
+                      dispatch_time(DISPATCH_TIME_NOW, timeout_millis * NSEC_PER_MSEC));
 }
 
 }  // namespace apple
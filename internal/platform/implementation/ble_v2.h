@@ -30,6 +30,8 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/exception.h"
@@ -333,6 +335,13 @@ struct ServerGattConnectionCallback {
 };
 
 // A BLE GATT client socket for requesting GATT socket.
+// Parameters of a BLE connection, as granted by the platform.
+struct BleConnectionParameters {
+  absl::Duration connection_interval = absl::ZeroDuration();
+  int att_mtu = 0;
+  bool le_2m_phy = false;
+};
+
 class BleSocket {
  public:
   virtual ~BleSocket() = default;
@@ -357,6 +366,18 @@ class BleSocket {
   // Returns valid BlePeripheral pointer if there is a connection, and
   // nullptr otherwise.
   virtual BlePeripheral* GetRemotePeripheral() = 0;
+
+  // Requests connection parameters suited to bulk transfer if
+  // |high_throughput| is true: the shortest connection interval, the largest
+  // ATT MTU and the LE 2M PHY. Otherwise returns the connection to the
+  // power-balanced parameters of the platform.
+  //
+  // Returns the parameters in effect once the request is applied, or
+  // absl::nullopt if the platform does not support the request.
+  virtual absl::optional<BleConnectionParameters> RequestConnectionParameters(
+      bool high_throughput) {
+    return absl::nullopt;
+  }
 };
 
 // A BLE GATT server socket for listening incoming GATT socket.
@@ -376,6 +397,26 @@ class BleServerSocket {
   virtual Exception Close() = 0;
 };
 
+// A BLE server socket listening on an L2CAP connection-oriented channel.
+class BleL2capServerSocket : public BleServerSocket {
+ public:
+  ~BleL2capServerSocket() override = default;
+
+  // Returns the PSM (protocol service multiplexer) of the channel, which
+  // clients connect to.
+  virtual int GetPsm() const = 0;
+};
+
+// Link settings requested for an L2CAP connection-oriented channel. A platform
+// applies the ones its stack and the remote device support, and ignores the
+// others.
+struct L2capSocketOptions {
+  // Request the largest MTU the stack supports for the channel.
+  bool request_max_mtu = true;
+  // Request the LE 2M PHY for the connection.
+  bool prefer_le_2m_phy = true;
+};
+
 // The main BLE medium used inside of Nearby. This serves as the entry point
 // for all BLE and GATT related operations.
 class BleMedium {
@@ -509,6 +550,31 @@ class BleMedium {
       const std::string& service_id, TxPowerLevel tx_power_level,
       BlePeripheral& peripheral, CancellationFlag* cancellation_flag) = 0;
 
+  // Opens a server socket on an L2CAP connection-oriented channel, for
+  // service ID. Its PSM is advertised, so that clients connect to it with
+  // ConnectOverL2cap() rather than over GATT.
+  //
+  // On success, returns a new BleL2capServerSocket.
+  // On error, or if the platform doesn't support L2CAP channels, returns
+  // nullptr.
+  virtual std::unique_ptr<BleL2capServerSocket> OpenL2capServerSocket(
+      const std::string& service_id) {
+    return nullptr;
+  }
+
+  // Connects to the L2CAP connection-oriented channel |psm| of a BLE
+  // peripheral.
+  //
+  // On success, returns a new BleSocket.
+  // On error, or if the platform doesn't support L2CAP channels, returns
+  // nullptr.
+  virtual std::unique_ptr<BleSocket> ConnectOverL2cap(
+      int psm, const std::string& service_id, TxPowerLevel tx_power_level,
+      const L2capSocketOptions& options, BlePeripheral& peripheral,
+      CancellationFlag* cancellation_flag) {
+    return nullptr;
+  }
+
   // Requests if support extended advertisement.
   virtual bool IsExtendedAdvertisementsAvailable() = 0;
 
@@ -788,6 +788,59 @@ std::unique_ptr<api::ble_v2::BleSocket> BleV2Medium::Connect(
     }
   }
 
+  return ConnectToServerSocket(*remote_server_socket, service_id,
+                               cancellation_flag);
+}
+
+std::unique_ptr<api::ble_v2::BleL2capServerSocket>
+BleV2Medium::OpenL2capServerSocket(const std::string& service_id) {
+  absl::MutexLock lock(&mutex_);
+  int psm = next_psm_++;
+  auto server_socket =
+      std::make_unique<BleV2L2capServerSocket>(&GetAdapter(), psm);
+  server_socket->GetServerSocket().SetCloseNotifier([this, psm]() {
+    absl::MutexLock lock(&mutex_);
+    l2cap_server_sockets_.erase(psm);
+  });
+  NEARBY_LOGS(INFO) << "G3 Ble Adding L2CAP server socket: medium=" << this
+                    << ", service_id=" << service_id << ", psm=" << psm;
+  l2cap_server_sockets_.insert({psm, &server_socket->GetServerSocket()});
+  return server_socket;
+}
+
+std::unique_ptr<api::ble_v2::BleSocket> BleV2Medium::ConnectOverL2cap(
+    int psm, const std::string& service_id, TxPowerLevel tx_power_level,
+    const api::ble_v2::L2capSocketOptions& options,
+    api::ble_v2::BlePeripheral& remote_peripheral,
+    CancellationFlag* cancellation_flag) {
+  NEARBY_LOGS(INFO) << "G3 Ble ConnectOverL2cap [self]: medium=" << this
+                    << ", service_id=" << service_id << ", psm=" << psm;
+  auto& remote_adapter =
+      static_cast<BleV2Peripheral&>(remote_peripheral).GetAdapter();
+  auto* remote_medium =
+      static_cast<BleV2Medium*>(remote_adapter.GetBleV2Medium());
+  if (!remote_medium) {
+    return nullptr;
+  }
+
+  BleV2ServerSocket* remote_server_socket = nullptr;
+  {
+    absl::MutexLock medium_lock(&remote_medium->mutex_);
+    auto item = remote_medium->l2cap_server_sockets_.find(psm);
+    if (item == remote_medium->l2cap_server_sockets_.end()) {
+      NEARBY_LOGS(ERROR) << "G3 Ble Failed to find L2CAP server socket: psm="
+                         << psm;
+      return nullptr;
+    }
+    remote_server_socket = item->second;
+  }
+  return ConnectToServerSocket(*remote_server_socket, service_id,
+                               cancellation_flag);
+}
+
+std::unique_ptr<api::ble_v2::BleSocket> BleV2Medium::ConnectToServerSocket(
+    BleV2ServerSocket& remote_server_socket, const std::string& service_id,
+    CancellationFlag* cancellation_flag) {
   if (cancellation_flag->Cancelled()) {
     NEARBY_LOGS(ERROR) << "G3 BLE Connect: Has been cancelled: "
                           "service_id="
@@ -798,14 +851,12 @@ std::unique_ptr<api::ble_v2::BleSocket> BleV2Medium::Connect(
   CancellationFlagListener listener(
       cancellation_flag, [&remote_server_socket]() {
         NEARBY_LOGS(INFO) << "G3 Ble Cancel Connect.";
-        if (remote_server_socket != nullptr) {
-          remote_server_socket->Close();
-        }
+        remote_server_socket.Close();
       });
 
   auto socket = std::make_unique<BleV2Socket>(&GetAdapter());
   // Finally, Request to connect to this socket.
-  if (!remote_server_socket->Connect(*socket)) {
+  if (!remote_server_socket.Connect(*socket)) {
     NEARBY_LOGS(ERROR) << "G3 Ble Failed to connect to existing Ble "
                           "Server socket: service_id="
                        << service_id;
@@ -31,6 +31,8 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "absl/types/optional.h"
 #include "internal/platform/borrowable.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancellation_flag.h"
@@ -61,7 +63,9 @@ class BleV2Peripheral : public api::ble_v2::BlePeripheral {
 
 class BleV2Socket : public api::ble_v2::BleSocket, public SocketBase {
  public:
-  explicit BleV2Socket(BluetoothAdapter* adapter) : adapter_(adapter) {}
+  explicit BleV2Socket(BluetoothAdapter* adapter)
+      : SocketBase(location::nearby::proto::connections::BLE),
+        adapter_(adapter) {}
 
   // Returns the InputStream of this connected BleSocket.
   InputStream& GetInputStream() override {
@@ -86,6 +90,18 @@ class BleV2Socket : public api::ble_v2::BleSocket, public SocketBase {
   // nullptr otherwise.
   BleV2Peripheral* GetRemotePeripheral() override ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Grants the parameters of a typical phone link; there is no radio to
+  // reconfigure.
+  absl::optional<api::ble_v2::BleConnectionParameters>
+  RequestConnectionParameters(bool high_throughput) override {
+    return api::ble_v2::BleConnectionParameters{
+        .connection_interval = high_throughput ? absl::Microseconds(7500)
+                                               : absl::Milliseconds(30),
+        .att_mtu = 517,
+        .le_2m_phy = high_throughput,
+    };
+  }
+
  private:
   BluetoothAdapter* adapter_ = nullptr;  // Our Adapter. Read only.
 };
@@ -142,6 +158,26 @@ class BleV2ServerSocket : public api::ble_v2::BleServerSocket {
   bool closed_ ABSL_GUARDED_BY(mutex_) = false;
 };
 
+// A BleV2ServerSocket on an L2CAP channel, which clients find by its PSM.
+class BleV2L2capServerSocket : public api::ble_v2::BleL2capServerSocket {
+ public:
+  BleV2L2capServerSocket(BluetoothAdapter* adapter, int psm)
+      : server_socket_(adapter), psm_(psm) {}
+  ~BleV2L2capServerSocket() override = default;
+
+  std::unique_ptr<api::ble_v2::BleSocket> Accept() override {
+    return server_socket_.Accept();
+  }
+  Exception Close() override { return server_socket_.Close(); }
+  int GetPsm() const override { return psm_; }
+
+  BleV2ServerSocket& GetServerSocket() { return server_socket_; }
+
+ private:
+  BleV2ServerSocket server_socket_;
+  const int psm_;
+};
+
 // Container of operations that can be performed over the BLE medium.
 class BleV2Medium : public api::ble_v2::BleMedium {
  public:
@@ -193,6 +229,18 @@ class BleV2Medium : public api::ble_v2::BleMedium {
       api::ble_v2::BlePeripheral& remote_peripheral,
       CancellationFlag* cancellation_flag) override ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Opens a server socket on an L2CAP channel with a new PSM.
+  std::unique_ptr<api::ble_v2::BleL2capServerSocket> OpenL2capServerSocket(
+      const std::string& service_id) override ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Connects to the L2CAP server socket |psm| of the remote medium.
+  std::unique_ptr<api::ble_v2::BleSocket> ConnectOverL2cap(
+      int psm, const std::string& service_id,
+      api::ble_v2::TxPowerLevel tx_power_level,
+      const api::ble_v2::L2capSocketOptions& options,
+      api::ble_v2::BlePeripheral& remote_peripheral,
+      CancellationFlag* cancellation_flag) override ABSL_LOCKS_EXCLUDED(mutex_);
+
   bool IsExtendedAdvertisementsAvailable() override;
 
   BluetoothAdapter& GetAdapter() { return *adapter_; }
@@ -322,6 +370,10 @@ class BleV2Medium : public api::ble_v2::BleMedium {
   };
 
   bool IsStopped(Borrowable<api::ble_v2::GattServer*> server);
+  // Connects a new socket to the server socket of a remote medium.
+  std::unique_ptr<api::ble_v2::BleSocket> ConnectToServerSocket(
+      BleV2ServerSocket& remote_server_socket, const std::string& service_id,
+      CancellationFlag* cancellation_flag);
   absl::Mutex mutex_;
   BluetoothAdapter* adapter_;  // Our device adapter; read-only.
   BleV2Peripheral peripheral_{adapter_};
@@ -330,6 +382,10 @@ class BleV2Medium : public api::ble_v2::BleMedium {
       remote_peripherals_ ABSL_GUARDED_BY(mutex_);
   absl::flat_hash_map<std::string, BleV2ServerSocket*> server_sockets_
       ABSL_GUARDED_BY(mutex_);
+  // L2CAP server sockets by PSM, allocated from the LE dynamic range.
+  absl::flat_hash_map<int, BleV2ServerSocket*> l2cap_server_sockets_
+      ABSL_GUARDED_BY(mutex_);
+  int next_psm_ ABSL_GUARDED_BY(mutex_) = 0x80;
   absl::flat_hash_set<std::pair<Uuid, std::uint32_t>>
       scanning_internal_session_ids_ ABSL_GUARDED_BY(mutex_);
   bool is_extended_advertisements_available_ = false;
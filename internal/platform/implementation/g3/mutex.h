@@ -35,6 +35,11 @@ class ABSL_LOCKABLE Mutex : public api::Mutex {
     mutex_.Lock();
     if (!check_) mutex_.ForgetDeadlockInfo();
   }
+  bool TryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) override {
+    if (!mutex_.TryLock()) return false;
+    if (!check_) mutex_.ForgetDeadlockInfo();
+    return true;
+  }
   void Unlock() ABSL_UNLOCK_FUNCTION() override { mutex_.Unlock(); }
 
  private:
@@ -19,10 +19,12 @@
 #include <optional>
 #include <utility>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/str_format.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "internal/platform/implementation/cancelable.h"
+#include "internal/platform/implementation/shared/timer_service.h"
 #include "internal/platform/medium_environment.h"
 #include "internal/platform/runnable.h"
 #include "internal/test/fake_clock.h"
@@ -80,6 +82,12 @@ ScheduledExecutor::~ScheduledExecutor() {
   if (fake_clock.has_value()) {
     (*fake_clock)->RemoveObserver(name_);
   }
+  CancelTimers();
+  executor_.Shutdown();
+}
+
+void ScheduledExecutor::Shutdown() {
+  CancelTimers();
   executor_.Shutdown();
 }
 
@@ -104,11 +112,37 @@ std::shared_ptr<api::Cancelable> ScheduledExecutor::Schedule(
     tasks_.insert(std::pair<absl::Time, std::unique_ptr<Runnable>>(
         trigger_time, std::make_unique<Runnable>(std::move(task))));
   } else {
-    executor_.ScheduleAfter(delay, std::move(task));
+    // Set before `mutex_` is released; the callback only reads it under
+    // `mutex_`.
+    auto timer_id = std::make_shared<shared::TimerService::TimerId>(0);
+    absl::MutexLock lock(&mutex_);
+    *timer_id = shared::TimerService::GetInstance().Schedule(
+        delay, [this, timer_id, task = std::move(task)]() mutable {
+          // The id stays registered until the task is handed off, so that
+          // CancelTimers() waits for this callback instead of letting the
+          // executor be destroyed under it.
+          executor_.Execute(std::move(task));
+          absl::MutexLock lock(&mutex_);
+          timer_ids_.erase(*timer_id);
+        });
+    timer_ids_.insert(*timer_id);
   }
   return scheduled_cancelable;
 }
 
+void ScheduledExecutor::CancelTimers() {
+  absl::flat_hash_set<shared::TimerService::TimerId> timer_ids;
+  {
+    absl::MutexLock lock(&mutex_);
+    timer_ids.swap(timer_ids_);
+  }
+  // Not holding `mutex_`, which a running callback waits for. Cancel() waits
+  // for a callback that is already running.
+  for (shared::TimerService::TimerId timer_id : timer_ids) {
+    shared::TimerService::GetInstance().Cancel(timer_id);
+  }
+}
+
 void ScheduledExecutor::RunReadyTasks() {
   std::optional<FakeClock*> fake_clock =
       MediumEnvironment::Instance().GetSimulatedClock();
@@ -21,10 +21,12 @@
 #include <utility>
 
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/time/time.h"
 #include "internal/platform/implementation/cancelable.h"
 #include "internal/platform/implementation/g3/single_thread_executor.h"
 #include "internal/platform/implementation/scheduled_executor.h"
+#include "internal/platform/implementation/shared/timer_service.h"
 #include "internal/platform/runnable.h"
 
 namespace nearby {
@@ -42,15 +44,21 @@ class ScheduledExecutor final : public api::ScheduledExecutor {
   }
   std::shared_ptr<api::Cancelable> Schedule(Runnable&& runnable,
                                             absl::Duration delay) override;
-  void Shutdown() override { executor_.Shutdown(); }
+  void Shutdown() override;
 
  private:
   void RunReadyTasks();
+  // Cancels the tasks waiting in the timer service.
+  void CancelTimers() ABSL_LOCKS_EXCLUDED(mutex_);
   SingleThreadExecutor executor_;
   std::string name_;
   absl::Mutex mutex_;
   absl::btree_multimap<absl::Time, std::unique_ptr<Runnable>> tasks_
       ABSL_GUARDED_BY(mutex_);
+  // The tasks scheduled on the shared timer service when the clock isn't
+  // simulated.
+  absl::flat_hash_set<shared::TimerService::TimerId> timer_ids_
+      ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace g3
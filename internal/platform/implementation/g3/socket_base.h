@@ -26,16 +26,28 @@
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/input_stream.h"
+#include "internal/platform/medium_environment.h"
 #include "internal/platform/output_stream.h"
 #include "internal/platform/pipe.h"
+#include "proto/connections_enums.pb.h"
 
 namespace nearby {
 namespace g3 {
 
 // Common base for BT, BLE and Wifi socket implementations.
+//
+// The data written to a socket is shaped with the `LinkShaping` the
+// MediumEnvironment has for the socket's medium when the socket is created.
 class SocketBase {
  public:
-  SocketBase() { std::tie(input_for_remote_, output_) = CreatePipe(); }
+  explicit SocketBase(location::nearby::proto::connections::Medium medium) {
+    LinkShaping shaping = MediumEnvironment::Instance().GetLinkShaping(medium);
+    if (shaping.IsEnabled()) {
+      std::tie(input_for_remote_, output_) = CreatePipe(shaping);
+    } else {
+      std::tie(input_for_remote_, output_) = CreatePipe();
+    }
+  }
   virtual ~SocketBase() {
     absl::MutexLock lock(&mutex_);
     DoClose();
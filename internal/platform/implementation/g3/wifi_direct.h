@@ -34,6 +34,9 @@ class WifiDirectMedium;
 
 class WifiDirectSocket : public api::WifiDirectSocket, public SocketBase {
  public:
+  WifiDirectSocket()
+      : SocketBase(location::nearby::proto::connections::WIFI_DIRECT) {}
+
   // Returns the InputStream of the WifiDirectSocket.
   // On error, returned stream will report Exception::kIo on any operation.
   //
@@ -35,6 +35,9 @@ class WifiHotspotMedium;
 
 class WifiHotspotSocket : public api::WifiHotspotSocket, public SocketBase {
  public:
+  WifiHotspotSocket()
+      : SocketBase(location::nearby::proto::connections::WIFI_HOTSPOT) {}
+
   // Returns the InputStream of the WifiHotspotSocket.
   // On error, returned stream will report Exception::kIo on any operation.
   //
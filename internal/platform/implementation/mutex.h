@@ -44,6 +44,9 @@ class ABSL_LOCKABLE Mutex {
   virtual ~Mutex() {}
 
   virtual void Lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() = 0;
+  // Acquires the lock if it can do so without blocking. Returns true if it
+  // did.
+  virtual bool TryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) = 0;
   virtual void Unlock() ABSL_UNLOCK_FUNCTION() = 0;
 };
 
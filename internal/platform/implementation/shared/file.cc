@@ -14,14 +14,27 @@
 
 #include "internal/platform/implementation/shared/file.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <ios>
 #include <memory>
 #include <string>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
+#include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/feature_flags.h"
 
 namespace nearby {
 namespace shared {
@@ -29,17 +42,108 @@ namespace shared {
 // InputFile
 std::unique_ptr<IOFile> IOFile::CreateInputFile(
     const absl::string_view file_path, size_t size) {
-  return absl::WrapUnique(new IOFile(file_path, size));
+  auto file = absl::WrapUnique(new IOFile(file_path, size));
+  if (file->OpenInputFile()) {
+    file->MapInputFile();
+  } else {
+    file->file_.open(file->path_, std::ios::binary | std::ios::in);
+  }
+  return file;
 }
 
-IOFile::IOFile(const absl::string_view file_path, size_t size)
-    : file_(std::string(file_path.data(), file_path.size()),
-            std::ios::binary | std::ios::in | std::ios::ate),
-      path_(file_path),
-      total_size_(size) {
-  file_.seekg(0);
+IOFile::~IOFile() {
+  UnmapInputFile();
+  CloseInputFile();
+}
+
+bool IOFile::OpenInputFile() {
+#if defined(_WIN32)
+  return false;
+#else
+  // A file that fails to open is not read through |file_| either; reads fail.
+  fd_ = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) return true;
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0) {
+    CloseInputFile();
+    return true;
+  }
+  input_size_ = static_cast<size_t>(file_stat.st_size);
+#if defined(__linux__)
+  // Chunks are read front to back; let the kernel read ahead aggressively.
+  posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+  return true;
+#endif
 }
 
+void IOFile::CloseInputFile() {
+#if !defined(_WIN32)
+  if (fd_ >= 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+#endif
+}
+
+bool IOFile::MapInputFile() {
+#if defined(_WIN32)
+  return false;
+#else
+  const FeatureFlags::Flags& flags = FeatureFlags::GetInstance().GetFlags();
+  std::int64_t min_size = flags.input_file_mmap_min_size;
+  if (min_size <= 0 || total_size_ < min_size || fd_ < 0 ||
+      input_size_ < static_cast<size_t>(min_size)) {
+    return false;
+  }
+  size_t window_size = static_cast<size_t>(
+      std::max<std::int64_t>(flags.input_file_mmap_window_size, 0));
+  if (window_size == 0 || window_size >= input_size_) {
+    map_window_size_ = input_size_;
+  } else {
+    // Windows start at multiples of their size, which must be page aligned.
+    size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    map_window_size_ = (window_size + page_size - 1) / page_size * page_size;
+  }
+  if (!MapInputWindow(0)) {
+    map_window_size_ = 0;
+    return false;
+  }
+  return true;
+#endif
+}
+
+bool IOFile::MapInputWindow(size_t offset) {
+#if defined(_WIN32)
+  return false;
+#else
+  UnmapInputFile();
+  if (fd_ < 0 || offset >= input_size_) return false;
+  size_t length = std::min(map_window_size_, input_size_ - offset);
+  void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd_,
+                    static_cast<off_t>(offset));
+  if (data == MAP_FAILED) return false;
+  // Chunks are read front to back; let the kernel read ahead aggressively.
+  madvise(data, length, MADV_SEQUENTIAL);
+  mapped_data_ = static_cast<const char*>(data);
+  mapped_offset_ = offset;
+  mapped_size_ = length;
+  return true;
+#endif
+}
+
+void IOFile::UnmapInputFile() {
+#if !defined(_WIN32)
+  if (mapped_data_ != nullptr) {
+    munmap(const_cast<char*>(mapped_data_), mapped_size_);
+    mapped_data_ = nullptr;
+  }
+#endif
+}
+
+IOFile::IOFile(const absl::string_view file_path, size_t size)
+    : file_(), path_(file_path), total_size_(size) {}
+
 std::unique_ptr<IOFile> IOFile::CreateOutputFile(const absl::string_view path) {
   return std::unique_ptr<IOFile>(new IOFile(path));
 }
@@ -50,6 +154,28 @@ IOFile::IOFile(const absl::string_view file_path)
 }
 
 ExceptionOr<ByteArray> IOFile::Read(std::int64_t size) {
+  if (map_window_size_ > 0) {
+    return ReadMapped(size);
+  }
+
+#if !defined(_WIN32)
+  if (fd_ >= 0) {
+    // Read straight into the buffer handed out, at the tracked offset.
+    std::string read_bytes(std::max<std::int64_t>(size, 0), '\0');
+    ssize_t num_bytes_read;
+    do {
+      num_bytes_read =
+          pread(fd_, read_bytes.data(), read_bytes.size(), input_offset_);
+    } while (num_bytes_read < 0 && errno == EINTR);
+    if (num_bytes_read < 0) {
+      return ExceptionOr<ByteArray>{Exception::kIo};
+    }
+    input_offset_ += num_bytes_read;
+    read_bytes.resize(num_bytes_read);
+    return ExceptionOr<ByteArray>(ByteArray(std::move(read_bytes)));
+  }
+#endif
+
   if (!file_.is_open()) {
     return ExceptionOr<ByteArray>{Exception::kIo};
   }
@@ -62,18 +188,58 @@ ExceptionOr<ByteArray> IOFile::Read(std::int64_t size) {
     return ExceptionOr<ByteArray>{Exception::kIo};
   }
 
-  ByteArray bytes(size);
-  std::unique_ptr<char[]> read_bytes{new char[size]};
-  file_.read(read_bytes.get(), static_cast<ptrdiff_t>(size));
+  // Read straight into the buffer handed out, instead of through a temporary.
+  std::string read_bytes(size, '\0');
+  file_.read(read_bytes.data(), static_cast<ptrdiff_t>(size));
   auto num_bytes_read = file_.gcount();
   if (num_bytes_read == 0) {
     return ExceptionOr<ByteArray>{Exception::kIo};
   }
+  read_bytes.resize(num_bytes_read);
+
+  return ExceptionOr<ByteArray>(ByteArray(std::move(read_bytes)));
+}
+
+ExceptionOr<ByteArray> IOFile::ReadMapped(std::int64_t size) {
+  size_t length =
+      std::min(static_cast<size_t>(std::max<std::int64_t>(size, 0)),
+               GetRemainingInputSize());
+  std::string read_bytes;
+  read_bytes.reserve(length);
+  // A read crossing the end of the mapped window continues in the next one.
+  while (read_bytes.size() < length) {
+    if (mapped_data_ == nullptr || input_offset_ < mapped_offset_ ||
+        input_offset_ >= mapped_offset_ + mapped_size_) {
+      if (!MapInputWindow(input_offset_ / map_window_size_ *
+                          map_window_size_)) {
+        return ExceptionOr<ByteArray>{Exception::kIo};
+      }
+    }
+    size_t count = std::min(length - read_bytes.size(),
+                            mapped_offset_ + mapped_size_ - input_offset_);
+    read_bytes.append(mapped_data_ + (input_offset_ - mapped_offset_), count);
+    input_offset_ += count;
+  }
+  return ExceptionOr<ByteArray>(ByteArray(std::move(read_bytes)));
+}
+
+ExceptionOr<size_t> IOFile::Skip(size_t offset) {
+  if (map_window_size_ == 0 && fd_ < 0) {
+    return InputStream::Skip(offset);
+  }
+  size_t skipped = std::min(offset, GetRemainingInputSize());
+  input_offset_ += skipped;
+  return ExceptionOr<size_t>(skipped);
+}
 
-  return ExceptionOr<ByteArray>(ByteArray(read_bytes.get(), num_bytes_read));
+size_t IOFile::GetRemainingInputSize() const {
+  return input_offset_ < input_size_ ? input_size_ - input_offset_ : 0;
 }
 
 Exception IOFile::Close() {
+  UnmapInputFile();
+  map_window_size_ = 0;
+  CloseInputFile();
   if (file_.is_open()) {
     file_.close();
   }
@@ -99,5 +265,27 @@ Exception IOFile::Flush() {
   return {file_.good() ? Exception::kSuccess : Exception::kIo};
 }
 
+Exception IOFile::Preallocate(std::int64_t size) {
+  if (!file_.is_open()) {
+    return {Exception::kIo};
+  }
+#if defined(__linux__)
+  if (size <= 0) return {Exception::kSuccess};
+  // |file_| doesn't expose its descriptor; the reservation belongs to the
+  // file, so a second descriptor works as well.
+  int fd = open(path_.c_str(), O_WRONLY);
+  if (fd < 0) return {Exception::kIo};
+  // Keeps the file size unchanged, so that a partially received file doesn't
+  // look complete.
+  int result = fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, size);
+  close(fd);
+  // Not every file system supports preallocation; the writes still work.
+  if (result != 0 && errno != EOPNOTSUPP) {
+    return {Exception::kIo};
+  }
+#endif
+  return {Exception::kSuccess};
+}
+
 }  // namespace shared
 }  // namespace nearby
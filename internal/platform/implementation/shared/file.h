@@ -15,8 +15,10 @@
 #ifndef PLATFORM_IMPL_SHARED_FILE_H_
 #define PLATFORM_IMPL_SHARED_FILE_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <string>
 
 #include "absl/strings/string_view.h"
@@ -34,7 +36,10 @@ class IOFile final : public api::InputFile, public api::OutputFile {
 
   static std::unique_ptr<IOFile> CreateOutputFile(const absl::string_view path);
 
+  ~IOFile() override;
+
   ExceptionOr<ByteArray> Read(std::int64_t size) override;
+  ExceptionOr<size_t> Skip(size_t offset) override;
 
   std::string GetFilePath() const override { return path_; }
 
@@ -43,14 +48,46 @@ class IOFile final : public api::InputFile, public api::OutputFile {
 
   Exception Write(const ByteArray& data) override;
   Exception Flush() override;
+  Exception Preallocate(std::int64_t size) override;
 
  private:
   explicit IOFile(const absl::string_view file_path, size_t size);
   explicit IOFile(const absl::string_view file_path);
 
+  // Opens |fd_| for reading the input file, and tells the kernel that it is
+  // read front to back. Returns false if the file is read through |file_|.
+  bool OpenInputFile();
+  void CloseInputFile();
+  // Maps the input file into memory, if it is large enough according to
+  // FeatureFlags::input_file_mmap_min_size. Reads are then served from the
+  // mapping, with the kernel reading ahead of them, instead of going through
+  // |fd_|. Returns false if the file is read through |fd_|.
+  bool MapInputFile();
+  // Replaces the mapped window with the one starting at |offset|, a multiple
+  // of |map_window_size_|.
+  bool MapInputWindow(size_t offset);
+  void UnmapInputFile();
+  ExceptionOr<ByteArray> ReadMapped(std::int64_t size);
+  size_t GetRemainingInputSize() const;
+
+  // Output files, and input files where |fd_| isn't available.
   std::fstream file_;
   std::string path_;
   std::int64_t total_size_;
+
+  // Input file read with pread() or mapped, or -1.
+  int fd_ = -1;
+  // Size of the input file when opened, and offset of the next read from
+  // |fd_| or the mapping.
+  size_t input_size_ = 0;
+  size_t input_offset_ = 0;
+  // Size of the windows the input file is mapped in, or 0 if it isn't mapped.
+  size_t map_window_size_ = 0;
+  // Mapped window of the input file, or nullptr, and where it starts in the
+  // file.
+  const char* mapped_data_ = nullptr;
+  size_t mapped_offset_ = 0;
+  size_t mapped_size_ = 0;
 };
 
 }  // namespace shared
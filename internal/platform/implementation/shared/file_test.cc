@@ -24,6 +24,7 @@
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
 #include "internal/platform/byte_array.h"
+#include "internal/platform/feature_flags.h"
 
 namespace nearby {
 namespace shared {
@@ -112,6 +113,20 @@ TEST_F(FileTest, IOFile_GetTotalSize) {
   EXPECT_EQ(io_file->GetTotalSize(), 3);
 }
 
+TEST_F(FileTest, IOFile_Skip) {
+  WriteToFile("abcdef");
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+  AssertEquals(io_file->Read(1), "a");
+  ExceptionOr<size_t> skipped = io_file->Skip(3);
+  ASSERT_TRUE(skipped.ok());
+  EXPECT_EQ(skipped.result(), 3);
+  AssertEquals(io_file->Read(kMaxSize), "ef");
+  skipped = io_file->Skip(4);
+  ASSERT_TRUE(skipped.ok());
+  EXPECT_EQ(skipped.result(), 0);
+  AssertEmpty(io_file->Read(kMaxSize));
+}
+
 TEST_F(FileTest, IOFile_CloseInput) {
   WriteToFile("abc");
   auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
@@ -145,5 +160,110 @@ TEST_F(FileTest, IOFile_CloseOutput) {
   EXPECT_EQ(io_file->Write(bytes), Exception{Exception::kIo});
 }
 
+TEST_F(FileTest, IOFile_PreallocateKeepsFileSize) {
+  auto io_file_output = shared::IOFile::CreateOutputFile(path_);
+  EXPECT_EQ(io_file_output->Preallocate(1024), Exception{Exception::kSuccess});
+  EXPECT_EQ(io_file_output->Write(ByteArray("abc")),
+            Exception{Exception::kSuccess});
+  io_file_output->Close();
+
+  auto io_file_input = shared::IOFile::CreateInputFile(path_, 3);
+  AssertEquals(io_file_input->Read(1024), "abc");
+  EXPECT_TRUE(io_file_input->Read(1024).result().Empty());
+}
+
+TEST_F(FileTest, IOFile_PreallocateClosedOutput) {
+  auto io_file = shared::IOFile::CreateOutputFile(path_);
+  io_file->Close();
+  EXPECT_EQ(io_file->Preallocate(1024), Exception{Exception::kIo});
+}
+
+class MappedFileTest : public FileTest {
+ protected:
+  void SetUp() override {
+    FileTest::SetUp();
+    FeatureFlags::GetMutableFlagsForTesting().input_file_mmap_min_size = 1;
+  }
+  void TearDown() override {
+    FeatureFlags::GetMutableFlagsForTesting().input_file_mmap_min_size = 0;
+    FeatureFlags::GetMutableFlagsForTesting().input_file_mmap_window_size =
+        window_size_;
+  }
+
+  const std::int64_t window_size_ =
+      FeatureFlags::GetInstance().GetFlags().input_file_mmap_window_size;
+};
+
+TEST_F(MappedFileTest, IOFile_ReadWithSize) {
+  WriteToFile("abcdef");
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+  AssertEquals(io_file->Read(2), "ab");
+  AssertEquals(io_file->Read(kMaxSize), "cde");
+  AssertEquals(io_file->Read(kMaxSize), "f");
+  AssertEmpty(io_file->Read(kMaxSize));
+}
+
+TEST_F(MappedFileTest, IOFile_Skip) {
+  WriteToFile("abcdef");
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+  ExceptionOr<size_t> skipped = io_file->Skip(4);
+  ASSERT_TRUE(skipped.ok());
+  EXPECT_EQ(skipped.result(), 4);
+  AssertEquals(io_file->Read(kMaxSize), "ef");
+  skipped = io_file->Skip(4);
+  ASSERT_TRUE(skipped.ok());
+  EXPECT_EQ(skipped.result(), 0);
+}
+
+TEST_F(MappedFileTest, IOFile_ReadAcrossWindows) {
+  // Windows are rounded up to whole pages.
+  FeatureFlags::GetMutableFlagsForTesting().input_file_mmap_window_size = 1;
+  std::string text;
+  for (int i = 0; i < 3 * 64 * 1024; ++i) {
+    text.push_back(static_cast<char>('a' + i % 26));
+  }
+  WriteToFile(text);
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+
+  std::string read;
+  while (true) {
+    ExceptionOr<ByteArray> bytes = io_file->Read(10000);
+    ASSERT_TRUE(bytes.ok());
+    if (bytes.result().Empty()) break;
+    read += std::string(bytes.result());
+  }
+  EXPECT_EQ(read, text);
+}
+
+TEST_F(MappedFileTest, IOFile_SkipAcrossWindows) {
+  FeatureFlags::GetMutableFlagsForTesting().input_file_mmap_window_size = 1;
+  std::string text;
+  for (int i = 0; i < 3 * 64 * 1024; ++i) {
+    text.push_back(static_cast<char>('a' + i % 26));
+  }
+  WriteToFile(text);
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+
+  AssertEquals(io_file->Read(3), text.substr(0, 3));
+  ExceptionOr<size_t> skipped = io_file->Skip(2 * 64 * 1024);
+  ASSERT_TRUE(skipped.ok());
+  EXPECT_EQ(skipped.result(), 2 * 64 * 1024);
+  AssertEquals(io_file->Read(5), text.substr(3 + 2 * 64 * 1024, 5));
+}
+
+TEST_F(MappedFileTest, IOFile_CloseInput) {
+  WriteToFile("abc");
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+  io_file->Close();
+  ExceptionOr<ByteArray> read_result = io_file->Read(kMaxSize);
+  EXPECT_FALSE(read_result.ok());
+  EXPECT_TRUE(read_result.GetException().Raised(Exception::kIo));
+}
+
+TEST_F(MappedFileTest, IOFile_EmptyFileIsNotMapped) {
+  auto io_file = shared::IOFile::CreateInputFile(path_, GetSize());
+  AssertEmpty(io_file->Read(kMaxSize));
+}
+
 }  // namespace shared
 }  // namespace nearby
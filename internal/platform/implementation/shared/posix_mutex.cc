@@ -32,6 +32,8 @@ Mutex::~Mutex() {
 
 void Mutex::Lock() { pthread_mutex_lock(&mutex_); }
 
+bool Mutex::TryLock() { return pthread_mutex_trylock(&mutex_) == 0; }
+
 void Mutex::Unlock() { pthread_mutex_unlock(&mutex_); }
 
 }  // namespace posix
@@ -28,6 +28,7 @@ class ABSL_LOCKABLE Mutex : public api::Mutex {
   ~Mutex() override;
 
   void Lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() override;
+  bool TryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) override;
   void Unlock() ABSL_UNLOCK_FUNCTION() override;
 
  private:
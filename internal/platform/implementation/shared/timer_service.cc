@@ -0,0 +1,129 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/implementation/shared/timer_service.h"
+
+#include <functional>
+#include <queue>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/runnable.h"
+
+namespace nearby {
+namespace shared {
+namespace {
+
+// The fewest deadlines CompactDeadlines() bothers to clean up.
+constexpr size_t kMinDeadlinesToCompact = 64;
+
+}  // namespace
+
+TimerService& TimerService::GetInstance() {
+  // Never destroyed, callbacks may be scheduled during process exit.
+  static TimerService* const instance = new TimerService();
+  return *instance;
+}
+
+TimerService::TimerService() : thread_([this]() { RunTimerThread(); }) {}
+
+TimerService::~TimerService() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+    deadlines_changed_.Signal();
+  }
+  thread_.join();
+}
+
+TimerService::TimerId TimerService::Schedule(absl::Duration delay,
+                                             Runnable&& callback) {
+  absl::MutexLock lock(&mutex_);
+  TimerId id = next_id_++;
+  Deadline deadline = {absl::Now() + delay, id};
+  bool is_earliest = deadlines_.empty() || deadlines_.top() > deadline;
+  deadlines_.push(deadline);
+  callbacks_.emplace(id, std::move(callback));
+  if (is_earliest) {
+    deadlines_changed_.Signal();
+  }
+  return id;
+}
+
+bool TimerService::Cancel(TimerId id) {
+  absl::MutexLock lock(&mutex_);
+  if (callbacks_.erase(id) > 0) {
+    CompactDeadlines();
+    return true;
+  }
+  if (std::this_thread::get_id() != thread_.get_id()) {
+    while (running_id_ == id) {
+      callback_done_.Wait(&mutex_);
+    }
+  }
+  return false;
+}
+
+void TimerService::RunTimerThread() {
+  mutex_.Lock();
+  while (!shutdown_) {
+    if (deadlines_.empty()) {
+      deadlines_changed_.Wait(&mutex_);
+      continue;
+    }
+    Deadline deadline = deadlines_.top();
+    if (deadline.time > absl::Now()) {
+      deadlines_changed_.WaitWithDeadline(&mutex_, deadline.time);
+      continue;
+    }
+    deadlines_.pop();
+    auto it = callbacks_.find(deadline.id);
+    if (it == callbacks_.end()) {
+      // Cancelled.
+      continue;
+    }
+    Runnable callback = std::move(it->second);
+    callbacks_.erase(it);
+    running_id_ = deadline.id;
+    mutex_.Unlock();
+    callback();
+    mutex_.Lock();
+    running_id_ = 0;
+    callback_done_.SignalAll();
+  }
+  mutex_.Unlock();
+}
+
+void TimerService::CompactDeadlines() {
+  if (deadlines_.size() < kMinDeadlinesToCompact ||
+      deadlines_.size() < 2 * callbacks_.size()) {
+    return;
+  }
+  std::vector<Deadline> live;
+  live.reserve(callbacks_.size());
+  while (!deadlines_.empty()) {
+    if (callbacks_.contains(deadlines_.top().id)) {
+      live.push_back(deadlines_.top());
+    }
+    deadlines_.pop();
+  }
+  deadlines_ = decltype(deadlines_)(std::greater<Deadline>(), std::move(live));
+}
+
+}  // namespace shared
+}  // namespace nearby
@@ -0,0 +1,93 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_IMPL_SHARED_TIMER_SERVICE_H_
+#define PLATFORM_IMPL_SHARED_TIMER_SERVICE_H_
+
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/runnable.h"
+
+namespace nearby {
+namespace shared {
+
+// Runs callbacks after a delay on a single timer thread, so that scheduled
+// executors and timers don't need a thread of their own to wait on.
+//
+// Callbacks run on the timer thread one at a time and must be short; they
+// are meant to hand the actual work to an executor.
+class TimerService {
+ public:
+  using TimerId = std::uint64_t;
+
+  // Returns the timer service of the process.
+  static TimerService& GetInstance();
+
+  TimerService();
+  TimerService(const TimerService&) = delete;
+  TimerService& operator=(const TimerService&) = delete;
+  // Drops the callbacks which haven't run yet.
+  ~TimerService();
+
+  // Runs `callback` on the timer thread once `delay` has passed.
+  TimerId Schedule(absl::Duration delay, Runnable&& callback)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops the callback of `id`. Returns false if it already ran. If the
+  // callback is running on another thread, waits for it to return, so that
+  // the state it uses can be released afterwards.
+  bool Cancel(TimerId id) ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct Deadline {
+    absl::Time time;
+    TimerId id;
+
+    bool operator>(const Deadline& other) const {
+      return time != other.time ? time > other.time : id > other.id;
+    }
+  };
+
+  void RunTimerThread() ABSL_LOCKS_EXCLUDED(mutex_);
+  // Drops the deadlines of cancelled callbacks once they make up most of the
+  // heap, so that timers cancelled long before they expire don't pile up.
+  void CompactDeadlines() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  absl::Mutex mutex_;
+  absl::CondVar deadlines_changed_;
+  absl::CondVar callback_done_;
+  // A min-heap of the deadlines. A cancelled callback is only removed from
+  // `callbacks_`, which makes Cancel() O(1).
+  std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>
+      deadlines_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<TimerId, Runnable> callbacks_ ABSL_GUARDED_BY(mutex_);
+  TimerId next_id_ ABSL_GUARDED_BY(mutex_) = 1;
+  // The callback running on the timer thread, 0 if none.
+  TimerId running_id_ ABSL_GUARDED_BY(mutex_) = 0;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  std::thread thread_;
+};
+
+}  // namespace shared
+}  // namespace nearby
+
+#endif  // PLATFORM_IMPL_SHARED_TIMER_SERVICE_H_
@@ -0,0 +1,130 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/implementation/shared/timer_service.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace shared {
+namespace {
+
+using ::testing::ElementsAre;
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+TEST(TimerServiceTest, RunsCallbackAfterDelay) {
+  TimerService timer_service;
+  absl::Notification done;
+  absl::Time start = absl::Now();
+
+  timer_service.Schedule(absl::Milliseconds(50), [&done]() { done.Notify(); });
+
+  ASSERT_TRUE(done.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(50));
+}
+
+TEST(TimerServiceTest, RunsCallbacksInDeadlineOrder) {
+  TimerService timer_service;
+  absl::Mutex mutex;
+  std::vector<int> order;
+  absl::Notification done;
+
+  timer_service.Schedule(absl::Milliseconds(60), [&]() {
+    absl::MutexLock lock(&mutex);
+    order.push_back(3);
+    done.Notify();
+  });
+  timer_service.Schedule(absl::Milliseconds(20), [&]() {
+    absl::MutexLock lock(&mutex);
+    order.push_back(1);
+  });
+  timer_service.Schedule(absl::Milliseconds(40), [&]() {
+    absl::MutexLock lock(&mutex);
+    order.push_back(2);
+  });
+
+  ASSERT_TRUE(done.WaitForNotificationWithTimeout(kTimeout));
+  absl::MutexLock lock(&mutex);
+  EXPECT_THAT(order, ElementsAre(1, 2, 3));
+}
+
+TEST(TimerServiceTest, CancelDropsTheCallback) {
+  TimerService timer_service;
+  std::atomic_bool ran = false;
+  absl::Notification later_done;
+
+  TimerService::TimerId id =
+      timer_service.Schedule(absl::Milliseconds(10), [&ran]() { ran = true; });
+  EXPECT_TRUE(timer_service.Cancel(id));
+  timer_service.Schedule(absl::Milliseconds(50),
+                         [&later_done]() { later_done.Notify(); });
+
+  ASSERT_TRUE(later_done.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_FALSE(ran);
+  EXPECT_FALSE(timer_service.Cancel(id));
+}
+
+TEST(TimerServiceTest, CancelReturnsFalseOnceTheCallbackRan) {
+  TimerService timer_service;
+  absl::Notification done;
+
+  TimerService::TimerId id = timer_service.Schedule(
+      absl::ZeroDuration(), [&done]() { done.Notify(); });
+
+  ASSERT_TRUE(done.WaitForNotificationWithTimeout(kTimeout));
+  EXPECT_FALSE(timer_service.Cancel(id));
+}
+
+TEST(TimerServiceTest, CancelWaitsForTheRunningCallback) {
+  TimerService timer_service;
+  absl::Notification started;
+  std::atomic_bool finished = false;
+
+  TimerService::TimerId id =
+      timer_service.Schedule(absl::ZeroDuration(), [&]() {
+        started.Notify();
+        absl::SleepFor(absl::Milliseconds(100));
+        finished = true;
+      });
+  ASSERT_TRUE(started.WaitForNotificationWithTimeout(kTimeout));
+
+  EXPECT_FALSE(timer_service.Cancel(id));
+  EXPECT_TRUE(finished);
+}
+
+TEST(TimerServiceTest, CancelledTimersDontDelayOthers) {
+  TimerService timer_service;
+  for (int i = 0; i < 10000; i++) {
+    timer_service.Cancel(
+        timer_service.Schedule(absl::Hours(1), []() { FAIL(); }));
+  }
+  absl::Notification done;
+
+  timer_service.Schedule(absl::Milliseconds(10), [&done]() { done.Notify(); });
+
+  EXPECT_TRUE(done.WaitForNotificationWithTimeout(kTimeout));
+}
+
+}  // namespace
+}  // namespace shared
+}  // namespace nearby
@@ -0,0 +1,153 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/implementation/shared/work_stealing_executor.h"
+
+#include <cstddef>
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "internal/platform/runnable.h"
+
+namespace nearby {
+namespace shared {
+namespace {
+
+// The executor and the index of the worker running on this thread, if any.
+thread_local const WorkStealingExecutor* current_executor = nullptr;
+thread_local size_t current_worker = 0;
+
+}  // namespace
+
+WorkStealingExecutor::WorkStealingExecutor(int max_parallelism) {
+  size_t worker_count = max_parallelism > 0 ? max_parallelism : 1;
+  workers_.reserve(worker_count);
+  for (size_t i = 0; i < worker_count; i++) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  for (size_t i = 0; i < worker_count; i++) {
+    workers_[i]->thread = std::thread([this, i]() { RunWorker(i); });
+  }
+}
+
+WorkStealingExecutor::~WorkStealingExecutor() { Shutdown(); }
+
+void WorkStealingExecutor::Execute(Runnable&& runnable) {
+  DoSubmit(std::move(runnable));
+}
+
+bool WorkStealingExecutor::DoSubmit(Runnable&& runnable) {
+  pending_tasks_.fetch_add(1);
+  if (shutdown_) {
+    pending_tasks_.fetch_sub(1);
+    return false;
+  }
+  if (current_executor == this) {
+    Worker& worker = *workers_[current_worker];
+    absl::MutexLock lock(&worker.mutex);
+    worker.tasks.push_back(std::move(runnable));
+  } else {
+    absl::MutexLock lock(&injection_mutex_);
+    injection_queue_.push_back(std::move(runnable));
+  }
+  if (sleeping_workers_ > 0) {
+    WakeWorker(/*all=*/false);
+  }
+  return true;
+}
+
+void WorkStealingExecutor::Shutdown() {
+  shutdown_ = true;
+  WakeWorker(/*all=*/true);
+
+  if (current_executor == this) {
+    // A worker can't wait for itself; the destructor joins the workers.
+    return;
+  }
+  absl::MutexLock lock(&join_mutex_);
+  if (joined_) {
+    return;
+  }
+  for (std::unique_ptr<Worker>& worker : workers_) {
+    worker->thread.join();
+  }
+  joined_ = true;
+}
+
+void WorkStealingExecutor::RunWorker(size_t index) {
+  current_executor = this;
+  current_worker = index;
+  while (true) {
+    Runnable task;
+    if (TakeTask(index, task)) {
+      pending_tasks_.fetch_sub(1);
+      task();
+      continue;
+    }
+
+    absl::MutexLock lock(&idle_mutex_);
+    sleeping_workers_.fetch_add(1);
+    while (pending_tasks_ == 0 && !shutdown_) {
+      idle_cond_.Wait(&idle_mutex_);
+    }
+    sleeping_workers_.fetch_sub(1);
+    if (pending_tasks_ == 0 && shutdown_) {
+      return;
+    }
+  }
+}
+
+bool WorkStealingExecutor::TakeTask(size_t index, Runnable& task) {
+  {
+    Worker& worker = *workers_[index];
+    absl::MutexLock lock(&worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = std::move(worker.tasks.front());
+      worker.tasks.pop_front();
+      return true;
+    }
+  }
+  {
+    absl::MutexLock lock(&injection_mutex_);
+    if (!injection_queue_.empty()) {
+      task = std::move(injection_queue_.front());
+      injection_queue_.pop_front();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < workers_.size(); i++) {
+    Worker& victim = *workers_[(index + i) % workers_.size()];
+    absl::MutexLock lock(&victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingExecutor::WakeWorker(bool all) {
+  absl::MutexLock lock(&idle_mutex_);
+  if (all) {
+    idle_cond_.SignalAll();
+  } else {
+    idle_cond_.Signal();
+  }
+}
+
+}  // namespace shared
+}  // namespace nearby
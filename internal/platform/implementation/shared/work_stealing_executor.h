@@ -0,0 +1,91 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_IMPL_SHARED_WORK_STEALING_EXECUTOR_H_
+#define PLATFORM_IMPL_SHARED_WORK_STEALING_EXECUTOR_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "internal/platform/implementation/submittable_executor.h"
+#include "internal/platform/runnable.h"
+
+namespace nearby {
+namespace shared {
+
+// A multi thread executor where every worker has its own task queue.
+//
+// Tasks submitted from a worker go to the queue of that worker, others go to
+// a shared injection queue. An idle worker takes tasks from its own queue
+// first, then from the injection queue, and then steals from the other
+// workers, so that submitting a task rarely contends on a lock shared by all
+// workers.
+//
+// The tasks of one queue start in submission order, but there is no order
+// across queues, as with any multi thread executor.
+class WorkStealingExecutor final : public api::SubmittableExecutor {
+ public:
+  explicit WorkStealingExecutor(int max_parallelism);
+  WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+  WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+  // Waits for all submitted tasks to run. Must not run from one of the tasks.
+  ~WorkStealingExecutor() override;
+
+  void Execute(Runnable&& runnable) override;
+  bool DoSubmit(Runnable&& runnable) override;
+  // Rejects new tasks and waits for the submitted ones to run. When called
+  // from a task, returns without waiting.
+  void Shutdown() override;
+
+ private:
+  struct Worker {
+    absl::Mutex mutex;
+    std::deque<Runnable> tasks ABSL_GUARDED_BY(mutex);
+    std::thread thread;
+  };
+
+  void RunWorker(size_t index);
+  // Takes the next task for the worker at `index`, if any.
+  bool TakeTask(size_t index, Runnable& task);
+  void WakeWorker(bool all);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  absl::Mutex injection_mutex_;
+  std::deque<Runnable> injection_queue_ ABSL_GUARDED_BY(injection_mutex_);
+
+  // Counted before a task is queued and after it is taken, so that a worker
+  // doesn't exit while a task it should run is being queued.
+  std::atomic<int64_t> pending_tasks_ = 0;
+  std::atomic<int> sleeping_workers_ = 0;
+  std::atomic_bool shutdown_ = false;
+
+  absl::Mutex idle_mutex_;
+  absl::CondVar idle_cond_;
+
+  absl::Mutex join_mutex_;
+  bool joined_ ABSL_GUARDED_BY(join_mutex_) = false;
+};
+
+}  // namespace shared
+}  // namespace nearby
+
+#endif  // PLATFORM_IMPL_SHARED_WORK_STEALING_EXECUTOR_H_
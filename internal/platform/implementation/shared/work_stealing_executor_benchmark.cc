@@ -0,0 +1,82 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "internal/platform/implementation/shared/work_stealing_executor.h"
+
+namespace nearby {
+namespace shared {
+namespace {
+
+constexpr int kWorkers = 4;
+constexpr int kTasks = 1 << 12;
+
+// Tasks submitted from outside the executor, which all go through the
+// injection queue.
+void BM_ExecuteFromOneThread(benchmark::State& state) {
+  WorkStealingExecutor executor(kWorkers);
+
+  for (auto _ : state) {
+    absl::BlockingCounter done(kTasks);
+    for (int i = 0; i < kTasks; i++) {
+      executor.Execute([&done]() { done.DecrementCount(); });
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * kTasks);
+}
+BENCHMARK(BM_ExecuteFromOneThread)->UseRealTime();
+
+// Tasks submitted from |state.range(0)| threads, where every task submits
+// one more from its worker. The nested tasks go to the local queues, and
+// idle workers steal them.
+void BM_ExecuteFromManyThreads(benchmark::State& state) {
+  const int threads = state.range(0);
+  const int tasks_per_thread = kTasks / threads;
+  WorkStealingExecutor executor(kWorkers);
+
+  for (auto _ : state) {
+    absl::BlockingCounter done(2 * threads * tasks_per_thread);
+    std::vector<std::thread> submitters;
+    for (int i = 0; i < threads; i++) {
+      submitters.emplace_back([&executor, &done, tasks_per_thread]() {
+        for (int j = 0; j < tasks_per_thread; j++) {
+          executor.Execute([&executor, &done]() {
+            executor.Execute([&done]() { done.DecrementCount(); });
+            done.DecrementCount();
+          });
+        }
+      });
+    }
+    for (std::thread& submitter : submitters) {
+      submitter.join();
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * 2 * threads * tasks_per_thread);
+}
+BENCHMARK(BM_ExecuteFromManyThreads)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace shared
+}  // namespace nearby
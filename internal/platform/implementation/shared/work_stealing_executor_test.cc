@@ -0,0 +1,97 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/implementation/shared/work_stealing_executor.h"
+
+#include <atomic>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace shared {
+namespace {
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+TEST(WorkStealingExecutorTest, RunsAllTasksBeforeDestruction) {
+  std::atomic<int> count = 0;
+  {
+    WorkStealingExecutor executor(4);
+    for (int i = 0; i < 1000; i++) {
+      executor.Execute([&count]() { count++; });
+    }
+  }
+
+  EXPECT_EQ(count, 1000);
+}
+
+TEST(WorkStealingExecutorTest, RunsTasksConcurrently) {
+  WorkStealingExecutor executor(2);
+  absl::Notification first_started;
+  absl::Notification second_done;
+
+  executor.Execute([&]() {
+    first_started.Notify();
+    EXPECT_TRUE(second_done.WaitForNotificationWithTimeout(kTimeout));
+  });
+  executor.Execute([&]() {
+    EXPECT_TRUE(first_started.WaitForNotificationWithTimeout(kTimeout));
+    second_done.Notify();
+  });
+
+  EXPECT_TRUE(second_done.WaitForNotificationWithTimeout(kTimeout));
+}
+
+TEST(WorkStealingExecutorTest, StealsTasksOfABusyWorker) {
+  WorkStealingExecutor executor(2);
+  absl::Notification nested_done;
+
+  // The nested task is queued on the worker running the outer task, which is
+  // blocked until another worker steals and runs it.
+  executor.Execute([&]() {
+    executor.Execute([&nested_done]() { nested_done.Notify(); });
+    EXPECT_TRUE(nested_done.WaitForNotificationWithTimeout(kTimeout));
+  });
+
+  EXPECT_TRUE(nested_done.WaitForNotificationWithTimeout(kTimeout));
+}
+
+TEST(WorkStealingExecutorTest, ShutdownWaitsForQueuedTasks) {
+  WorkStealingExecutor executor(1);
+  std::atomic<int> count = 0;
+  for (int i = 0; i < 100; i++) {
+    executor.Execute([&count]() { count++; });
+  }
+
+  executor.Shutdown();
+
+  EXPECT_EQ(count, 100);
+}
+
+TEST(WorkStealingExecutorTest, RejectsTasksAfterShutdown) {
+  WorkStealingExecutor executor(2);
+  executor.Shutdown();
+
+  bool ran = false;
+  EXPECT_FALSE(executor.DoSubmit([&ran]() { ran = true; }));
+  executor.Shutdown();
+
+  EXPECT_FALSE(ran);
+}
+
+}  // namespace
+}  // namespace shared
+}  // namespace nearby
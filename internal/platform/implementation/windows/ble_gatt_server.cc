@@ -17,6 +17,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <exception>
 #include <memory>
 #include <optional>
@@ -42,6 +43,7 @@
 #include "internal/platform/logging.h"
 #include "internal/platform/uuid.h"
 #include "winrt/Windows.Foundation.Collections.h"
+#include "winrt/Windows.Foundation.h"
 #include "winrt/Windows.Storage.Streams.h"
 #include "winrt/base.h"
 
@@ -82,9 +84,10 @@ using ::winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::
     GattSubscribedClient;
 using ::winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::
     GattWriteRequestedEventArgs;
+using ::winrt::Windows::Foundation::AsyncStatus;
+using ::winrt::Windows::Foundation::IAsyncOperation;
 using ::winrt::Windows::Foundation::Collections::IVectorView;
 using ::winrt::Windows::Storage::Streams::Buffer;
-using ::winrt::Windows::Storage::Streams::DataWriter;
 using Permission = api::ble_v2::GattCharacteristic::Permission;
 using Property = api::ble_v2::GattCharacteristic::Property;
 
@@ -110,6 +113,28 @@ std::string ConvertGattStatusToString(
   }
 }
 
+Buffer ToBuffer(const ByteArray& data) {
+  Buffer buffer = Buffer(data.size());
+  std::memcpy(buffer.data(), data.data(), data.size());
+  buffer.Length(data.size());
+  return buffer;
+}
+
+void LogNotificationResult(const GattClientNotificationResult& result) {
+  if (result.Status() != GattCommunicationStatus::Success) {
+    LOG(ERROR) << "Failed to notify value change. remote device id="
+               << ::winrt::to_string(
+                      result.SubscribedClient().Session().DeviceId().Id());
+  }
+}
+
+void LogNotificationResults(
+    const IVectorView<GattClientNotificationResult>& results) {
+  for (const auto& result : results) {
+    LogNotificationResult(result);
+  }
+}
+
 }  // namespace
 
 BleGattServer::BleGattServer(api::BluetoothAdapter* adapter,
@@ -145,6 +170,7 @@ BleGattServer::CreateCharacteristic(
 
   GattCharacteristicData gatt_characteristic_data;
   gatt_characteristic_data.gatt_characteristic = gatt_characteristic;
+  gatt_characteristic_data.buffer = ToBuffer(gatt_characteristic_data.data);
 
   gatt_characteristic_datas_.push_back(gatt_characteristic_data);
 
@@ -167,6 +193,7 @@ bool BleGattServer::UpdateCharacteristic(
     if (it.gatt_characteristic.uuid == characteristic.uuid) {
       VLOG(1) << __func__ << ": Found the characteristic to update.";
       it.data = value;
+      it.buffer = ToBuffer(value);
 
       // If it is in running, notify the value changed.
       if (is_advertising_) {
@@ -430,12 +457,7 @@ bool BleGattServer::StartAdvertisement(const ByteArray& service_data,
     advertisement_parameters.IsConnectable(is_connectable);
     advertisement_parameters.IsDiscoverable(true);
 
-    DataWriter data_writer;
-    for (int i = 0; i < service_data.size(); ++i) {
-      data_writer.WriteByte(static_cast<uint8_t>(*(service_data.data() + i)));
-    }
-
-    advertisement_parameters.ServiceData(data_writer.DetachBuffer());
+    advertisement_parameters.ServiceData(ToBuffer(service_data));
 
     gatt_service_provider_.StartAdvertising(advertisement_parameters);
 
@@ -550,12 +572,7 @@ void BleGattServer::SetCloseNotifier(absl::AnyInvocable<void()> notifier) {
       return {};
     }
 
-    const ByteArray& data = characteristic_data->data;
-
-    Buffer buffer = Buffer(data.size());
-    std::memcpy(buffer.data(), data.data(), data.size());
-    buffer.Length(data.size());
-    request.RespondWithValue(buffer);
+    request.RespondWithValue(characteristic_data->buffer);
     deferral.Complete();
 
     VLOG(1) << __func__ << ": Sent data to remote device.";
@@ -595,6 +612,7 @@ void BleGattServer::Characteristic_SubscribedClientsChanged(
   try {
     std::vector<api::ble_v2::GattCharacteristic>
         added_subscribed_characteristics;
+    std::vector<GattSubscribedClient> added_subscribed_clients;
     std::vector<api::ble_v2::GattCharacteristic>
         removed_subscribed_characteristics;
 
@@ -625,6 +643,7 @@ void BleGattServer::Characteristic_SubscribedClientsChanged(
         // This is a new subscribed client.
         added_subscribed_characteristics.push_back(
             characteristic_data->gatt_characteristic);
+        added_subscribed_clients.push_back(current_subscribed_client);
       }
     }
 
@@ -650,8 +669,10 @@ void BleGattServer::Characteristic_SubscribedClientsChanged(
          added_subscribed_characteristics) {
       gatt_connection_callback_.characteristic_subscription_cb(
           subscribed_characteristic);
-
-      NotifyValueChanged(subscribed_characteristic);
+    }
+    // Only the new clients need the current value.
+    if (!added_subscribed_clients.empty()) {
+      NotifyValue(*characteristic_data, added_subscribed_clients);
     }
 
     for (const auto& subscribed_characteristic :
@@ -695,23 +716,59 @@ void BleGattServer::NotifyValueChanged(
       return;
     }
 
-    const ByteArray& data = characteristic_data->data;
+    // Pipelines the notifications instead of waiting for each one: the
+    // clients get back-to-back value changes in as few connection events as
+    // the stack allows, and only a full pipeline waits for the oldest.
+    auto& pending = characteristic_data->pending_notifications;
+    while (!pending.empty() &&
+           pending.front().Status() != AsyncStatus::Started) {
+      if (pending.front().Status() == AsyncStatus::Completed) {
+        LogNotificationResults(pending.front().GetResults());
+      } else {
+        LOG(ERROR) << __func__ << ": Failed to notify value change. error="
+                   << pending.front().ErrorCode();
+      }
+      pending.pop_front();
+    }
+    if (pending.size() >= kMaxPendingNotifications) {
+      IAsyncOperation<IVectorView<GattClientNotificationResult>> oldest =
+          std::move(pending.front());
+      pending.pop_front();
+      LogNotificationResults(oldest.get());
+    }
 
-    Buffer buffer = Buffer(data.size());
-    std::memcpy(buffer.data(), data.data(), data.size());
-    buffer.Length(data.size());
+    pending.push_back(
+        characteristic_data->local_characteristic.NotifyValueAsync(
+            characteristic_data->buffer));
+  } catch (std::exception exception) {
+    LOG(ERROR) << __func__ << ": Exception: " << exception.what();
+  } catch (const winrt::hresult_error& error) {
+    LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
+               << winrt::to_string(error.message());
+  } catch (...) {
+    LOG(ERROR) << __func__ << ": Unknown exception.";
+  }
+}
 
-    IVectorView<GattClientNotificationResult> results =
-        characteristic_data->local_characteristic.NotifyValueAsync(buffer)
-            .get();
+void BleGattServer::NotifyValue(
+    const GattCharacteristicData& characteristic_data,
+    const std::vector<GattSubscribedClient>& clients) {
+  if (characteristic_data.local_characteristic == nullptr) {
+    return;
+  }
 
-    for (const auto& result : results) {
-      if (result.Status() != GattCommunicationStatus::Success) {
-        LOG(ERROR) << __func__
-                   << ": Failed to notify value change. remote device id="
-                   << ::winrt::to_string(
-                          result.SubscribedClient().Session().DeviceId().Id());
-      }
+  try {
+    // Starts the notification to every client before waiting for any, so
+    // that the clients are notified concurrently.
+    std::vector<IAsyncOperation<GattClientNotificationResult>> operations;
+    operations.reserve(clients.size());
+    for (const auto& client : clients) {
+      operations.push_back(
+          characteristic_data.local_characteristic.NotifyValueAsync(
+              characteristic_data.buffer, client));
+    }
+    for (auto& operation : operations) {
+      LogNotificationResult(operation.get());
     }
   } catch (std::exception exception) {
     LOG(ERROR) << __func__ << ": Exception: " << exception.what();
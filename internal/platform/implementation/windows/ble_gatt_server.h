@@ -17,6 +17,8 @@
 
 #include <windows.h>
 
+#include <cstddef>
+#include <deque>
 #include <memory>
 #include <vector>
 
@@ -37,6 +39,8 @@
 #include "winrt/Windows.Devices.Bluetooth.GenericAttributeProfile.h"
 #include "winrt/Windows.Devices.Bluetooth.h"
 #include "winrt/Windows.Foundation.Collections.h"
+#include "winrt/Windows.Foundation.h"
+#include "winrt/Windows.Storage.Streams.h"
 #include "winrt/base.h"
 
 namespace nearby {
@@ -76,10 +80,23 @@ class BleGattServer : public api::ble_v2::GattServer {
   }
 
  private:
+  // The notifications of value changes in flight per characteristic. Once
+  // this many wait for their clients, the next one waits for the oldest.
+  static constexpr std::size_t kMaxPendingNotifications = 4;
+
   // Used to save native data related to the GATT characteristic.
   struct GattCharacteristicData {
     api::ble_v2::GattCharacteristic gatt_characteristic;
     ByteArray data;
+    // |data| as sent to remote devices. Replaced, never modified, when |data|
+    // changes, so reads and notifications of a value share one buffer.
+    ::winrt::Windows::Storage::Streams::IBuffer buffer = nullptr;
+    // Notifications to all subscribed clients still in flight, oldest first.
+    std::deque<::winrt::Windows::Foundation::IAsyncOperation<
+        ::winrt::Windows::Foundation::Collections::IVectorView<
+            ::winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::
+                GattClientNotificationResult>>>
+        pending_notifications;
     ::winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::
         GattLocalCharacteristic local_characteristic = nullptr;
     ::winrt::Windows::Foundation::Collections::IVectorView<
@@ -95,6 +112,13 @@ class BleGattServer : public api::ble_v2::GattServer {
   void NotifyValueChanged(
       const api::ble_v2::GattCharacteristic& gatt_characteristic)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Notifies the value of |characteristic_data| to |clients| only, all at
+  // once, and waits for them.
+  void NotifyValue(
+      const GattCharacteristicData& characteristic_data,
+      const std::vector<::winrt::Windows::Devices::Bluetooth::
+                            GenericAttributeProfile::GattSubscribedClient>&
+          clients) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   GattCharacteristicData* FindGattCharacteristicData(
       const ::winrt::Windows::Devices::Bluetooth::GenericAttributeProfile::
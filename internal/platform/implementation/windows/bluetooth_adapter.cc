@@ -40,6 +40,7 @@
 
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "third_party/json/src/json.hpp"
 #include "internal/platform/feature_flags.h"
 #include "internal/platform/implementation/platform.h"
@@ -96,6 +97,16 @@ BluetoothAdapter::BluetoothAdapter() : windows_bluetooth_adapter_(nullptr) {
       // https://docs.microsoft.com/en-us/uwp/api/windows.devices.bluetooth.bluetoothadapter.getradioasync?view=winrt-20348
       windows_bluetooth_radio_ =
           windows_bluetooth_adapter_.GetRadioAsync().get();
+      if (windows_bluetooth_radio_ != nullptr) {
+        is_radio_on_ = windows_bluetooth_radio_.State() == RadioState::On;
+        // Occurs when the state of the radio changes.
+        // https://learn.microsoft.com/en-us/uwp/api/windows.devices.radios.radio.statechanged?view=winrt-22621
+        radio_state_changed_token_ = windows_bluetooth_radio_.StateChanged(
+            [this](const Radio &radio,
+                   const winrt::Windows::Foundation::IInspectable &) {
+              OnRadioStateChanged();
+            });
+      }
     }
   } catch (const winrt::hresult_error &error) {
     LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
@@ -105,6 +116,38 @@ BluetoothAdapter::BluetoothAdapter() : windows_bluetooth_adapter_(nullptr) {
   }
 }
 
+BluetoothAdapter::~BluetoothAdapter() {
+  if (windows_bluetooth_radio_ == nullptr) {
+    return;
+  }
+  try {
+    windows_bluetooth_radio_.StateChanged(radio_state_changed_token_);
+  } catch (const winrt::hresult_error &error) {
+    LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
+               << winrt::to_string(error.message());
+  } catch (...) {
+    LOG(ERROR) << __func__ << ": unknown error.";
+  }
+}
+
+void BluetoothAdapter::OnRadioStateChanged() {
+  try {
+    is_radio_on_ = windows_bluetooth_radio_.State() == RadioState::On;
+  } catch (const winrt::hresult_error &error) {
+    LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
+               << winrt::to_string(error.message());
+    is_radio_on_ = false;
+  } catch (...) {
+    LOG(ERROR) << __func__ << ": unknown error.";
+    is_radio_on_ = false;
+  }
+  LOG(INFO) << __func__ << ": Bluetooth radio is "
+            << (is_radio_on_ ? "on." : "off.");
+  // The radio is restarted to apply a new name.
+  absl::MutexLock lock(&cache_mutex_);
+  cached_name_.reset();
+}
+
 // Synchronously sets the status of the BluetoothAdapter to 'status', and
 // returns true if the operation was a success.
 bool BluetoothAdapter::SetStatus(Status status) {
@@ -161,6 +204,7 @@ bool BluetoothAdapter::SetStatus(Status status) {
     return false;
   }
 
+  is_radio_on_ = status == Status::kEnabled;
   LOG(INFO) << __func__ << ": Successfully set the radio state to "
             << (status == Status::kDisabled ? "kDisabled." : "kEnabled.");
   return true;
@@ -173,21 +217,7 @@ bool BluetoothAdapter::IsEnabled() const {
     LOG(ERROR) << __func__ << ": No Bluetooth radio on this device.";
     return false;
   }
-  try {
-    // Gets the current state of the radio represented by this object.
-    // https://docs.microsoft.com/en-us/uwp/api/windows.devices.radios.radio.state?view=winrt-20348
-    return windows_bluetooth_radio_.State() == RadioState::On;
-  } catch (std::exception exception) {
-    LOG(ERROR) << __func__ << ": exception:" << exception.what();
-    return false;
-  } catch (const winrt::hresult_error &ex) {
-    LOG(ERROR) << __func__ << ": exception:" << ex.code() << ": "
-               << winrt::to_string(ex.message());
-    return false;
-  } catch (...) {
-    LOG(ERROR) << __func__ << ": unknown error.";
-    return false;
-  }
+  return is_radio_on_;
 }
 
 // Returns true if the Bluetooth hardware supports Bluetooth 5.0 Extended
@@ -408,6 +438,14 @@ std::string BluetoothAdapter::GetName() const {
     return *device_name_;
   }
 
+  absl::MutexLock lock(&cache_mutex_);
+  if (!cached_name_.has_value()) {
+    cached_name_ = GetNameUncached();
+  }
+  return *cached_name_;
+}
+
+std::string BluetoothAdapter::GetNameUncached() const {
   std::optional<std::string> adapter_instance_id =
       GetGenericBluetoothAdapterInstanceID();
   if (!adapter_instance_id.has_value()) {
@@ -477,6 +515,10 @@ bool BluetoothAdapter::SetName(absl::string_view name, bool persist) {
   if (!persist) {
     StoreRadioNames(GetName(), name);
   }
+  {
+    absl::MutexLock lock(&cache_mutex_);
+    cached_name_.reset();
+  }
   if (name.size() > 248 * sizeof(char)) {
     LOG(ERROR) << __func__
                << ": Failed to set name for bluetooth adapter because "
@@ -826,9 +868,14 @@ std::string BluetoothAdapter::GetMacAddress() const {
     LOG(ERROR) << __func__ << ": No Bluetooth adapter on this device.";
     return "";
   }
+  absl::MutexLock lock(&cache_mutex_);
+  if (cached_mac_address_.has_value()) {
+    return *cached_mac_address_;
+  }
   try {
-    return uint64_to_mac_address_string(
+    cached_mac_address_ = uint64_to_mac_address_string(
         windows_bluetooth_adapter_.BluetoothAddress());
+    return *cached_mac_address_;
   } catch (std::exception exception) {
     LOG(ERROR) << __func__ << ": exception:" << exception.what();
     return "";
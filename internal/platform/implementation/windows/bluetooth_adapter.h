@@ -20,11 +20,14 @@
 #include <guiddef.h>
 // clang-format on
 
+#include <atomic>
 #include <optional>
 #include <string>
 #include <utility>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/synchronization/mutex.h"
 #include "internal/platform/implementation/bluetooth_adapter.h"
 #include "internal/platform/implementation/windows/generated/winrt/Windows.Devices.Bluetooth.h"
 #include "internal/platform/implementation/windows/generated/winrt/Windows.Devices.Radios.h"
@@ -51,7 +54,7 @@ class BluetoothAdapter : public api::BluetoothAdapter {
  public:
   BluetoothAdapter();
 
-  ~BluetoothAdapter() override = default;
+  ~BluetoothAdapter() override;
 
   typedef absl::AnyInvocable<void(api::BluetoothAdapter::ScanMode)>
       ScanModeCallback;
@@ -112,6 +115,8 @@ class BluetoothAdapter : public api::BluetoothAdapter {
 
  private:
   void process_error();
+  void OnRadioStateChanged();
+  std::string GetNameUncached() const;
   void StoreRadioNames(absl::string_view original_radio_name,
                        absl::string_view nearby_radio_name);
 
@@ -119,6 +124,19 @@ class BluetoothAdapter : public api::BluetoothAdapter {
   std::string registry_bluetooth_adapter_name_;
 
   Radio windows_bluetooth_radio_ = nullptr;
+  // The radio state, kept up to date from the radio's StateChanged events so
+  // that IsEnabled() does not query the radio.
+  std::atomic<bool> is_radio_on_ = false;
+  winrt::event_token radio_state_changed_token_;
+
+  // The adapter name is read from the registry after enumerating the
+  // Bluetooth devices, so it is kept until it is set or the radio changes
+  // state. The MAC address does not change.
+  mutable absl::Mutex cache_mutex_;
+  mutable std::optional<std::string> cached_name_
+      ABSL_GUARDED_BY(cache_mutex_);
+  mutable std::optional<std::string> cached_mac_address_
+      ABSL_GUARDED_BY(cache_mutex_);
   std::optional<std::string> GetGenericBluetoothAdapterInstanceID() const;
   void find_and_replace(char *source, const char *strFind,
                         const char *strReplace) const;
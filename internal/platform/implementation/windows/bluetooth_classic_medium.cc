@@ -16,14 +16,18 @@
 
 #include <windows.h>
 
+#include <algorithm>
 #include <functional>
 #include <ios>
 #include <memory>
 #include <regex>  // NOLINT
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/cancellation_flag_listener.h"
 #include "internal/platform/feature_flags.h"
@@ -113,7 +117,9 @@ BluetoothClassicMedium::BluetoothClassicMedium(
       &BluetoothClassicMedium::OnScanModeChanged, this, std::placeholders::_1));
 }
 
-BluetoothClassicMedium::~BluetoothClassicMedium() {}
+BluetoothClassicMedium::~BluetoothClassicMedium() {
+  resolve_executor_.Shutdown();
+}
 
 bool BluetoothClassicMedium::StartDiscovery(
     BluetoothClassicMedium::DiscoveryCallback discovery_callback) {
@@ -164,8 +170,6 @@ std::unique_ptr<api::BluetoothSocket> BluetoothClassicMedium::ConnectToService(
       return nullptr;
     }
 
-    winrt::guid service(service_uuid);
-
     if (cancellation_flag == nullptr) {
       LOG(ERROR) << __func__ << ": cancellation_flag not specified.";
       return nullptr;
@@ -190,13 +194,9 @@ std::unique_ptr<api::BluetoothSocket> BluetoothClassicMedium::ConnectToService(
       return nullptr;
     }
 
-    RfcommDeviceService requested_service(
-        GetRequestedService(remote_device_to_connect_, service));
-
-    if (!FeatureFlags::GetInstance()
-             .GetFlags()
-             .skip_service_discovery_before_connecting_to_rfcomm &&
-        !CheckSdp(requested_service)) {
+    RfcommDeviceService requested_service =
+        ResolveService(remote_device_to_connect_, service_uuid);
+    if (requested_service == nullptr) {
       LOG(ERROR) << __func__ << ": Invalid SDP.";
       return nullptr;
     }
@@ -217,8 +217,11 @@ std::unique_ptr<api::BluetoothSocket> BluetoothClassicMedium::ConnectToService(
         rfcomm_socket->Connect(requested_service.ConnectionHostName(),
                                requested_service.ConnectionServiceName());
     if (!success) {
+      // The device may have moved the service to another channel.
+      InvalidateResolvedService(remote_device.GetMacAddress(), service_uuid);
       return nullptr;
     }
+    AddConnectedServiceUuid(service_uuid);
 
     return std::move(rfcomm_socket);
   } catch (std::exception exception) {
@@ -226,12 +229,14 @@ std::unique_ptr<api::BluetoothSocket> BluetoothClassicMedium::ConnectToService(
     // expects nullptr if it fails
     LOG(ERROR) << __func__ << ": Exception connecting bluetooth async: "
                << exception.what();
+    InvalidateResolvedService(remote_device.GetMacAddress(), service_uuid);
     return nullptr;
   } catch (const winrt::hresult_error& ex) {
     LOG(ERROR) << __func__
                << ": Exception connecting bluetooth async, error code: "
                << ex.code()
                << ", error message: " << winrt::to_string(ex.message());
+    InvalidateResolvedService(remote_device.GetMacAddress(), service_uuid);
     return nullptr;
   } catch (...) {
     LOG(ERROR) << __func__ << ": Unknown exception.";
@@ -483,6 +488,91 @@ bool BluetoothClassicMedium::CheckSdp(RfcommDeviceService requested_service) {
   }
 }
 
+RfcommDeviceService BluetoothClassicMedium::ResolveService(
+    BluetoothDevice* device, const std::string& service_uuid) {
+  std::pair<std::string, std::string> key(device->GetMacAddress(),
+                                          service_uuid);
+  {
+    absl::MutexLock lock(&resolved_services_mutex_);
+    auto it = resolved_services_.find(key);
+    if (it != resolved_services_.end()) {
+      if (absl::Now() - it->second.resolved_time < kResolvedServiceTtl) {
+        VLOG(1) << __func__ << ": Reusing resolved service " << service_uuid
+                << " of device " << key.first;
+        return it->second.service;
+      }
+      resolved_services_.erase(it);
+    }
+  }
+
+  RfcommDeviceService service =
+      GetRequestedService(device, winrt::guid(service_uuid));
+  if (service == nullptr) {
+    return nullptr;
+  }
+  if (!FeatureFlags::GetInstance()
+           .GetFlags()
+           .skip_service_discovery_before_connecting_to_rfcomm &&
+      !CheckSdp(service)) {
+    return nullptr;
+  }
+
+  absl::MutexLock lock(&resolved_services_mutex_);
+  resolved_services_.insert_or_assign(
+      std::move(key), ResolvedService{.service = service,
+                                      .resolved_time = absl::Now()});
+  return service;
+}
+
+void BluetoothClassicMedium::InvalidateResolvedService(
+    const std::string& mac_address, const std::string& service_uuid) {
+  absl::MutexLock lock(&resolved_services_mutex_);
+  resolved_services_.erase(std::make_pair(mac_address, service_uuid));
+}
+
+void BluetoothClassicMedium::AddConnectedServiceUuid(
+    const std::string& service_uuid) {
+  absl::MutexLock lock(&resolved_services_mutex_);
+  auto it = std::find(connected_service_uuids_.begin(),
+                      connected_service_uuids_.end(), service_uuid);
+  if (it != connected_service_uuids_.end()) {
+    connected_service_uuids_.erase(it);
+  } else if (connected_service_uuids_.size() >= kMaxConnectedServiceUuids) {
+    connected_service_uuids_.erase(connected_service_uuids_.begin());
+  }
+  connected_service_uuids_.push_back(service_uuid);
+}
+
+void BluetoothClassicMedium::PreResolveServices(
+    const std::string& mac_address) {
+  {
+    absl::MutexLock lock(&resolved_services_mutex_);
+    if (connected_service_uuids_.empty()) {
+      return;
+    }
+  }
+  resolve_executor_.Execute([this, mac_address]() {
+    std::vector<std::string> service_uuids;
+    {
+      absl::MutexLock lock(&resolved_services_mutex_);
+      service_uuids = connected_service_uuids_;
+    }
+    BluetoothDevice* device = GetRemoteDeviceInternal(mac_address);
+    if (device == nullptr) {
+      return;
+    }
+    for (const std::string& service_uuid : service_uuids) {
+      try {
+        ResolveService(device, service_uuid);
+      } catch (...) {
+        // Resolved again when connecting.
+        VLOG(1) << "PreResolveServices: Failed to resolve service "
+                << service_uuid << " of device " << mac_address;
+      }
+    }
+  });
+}
+
 bool BluetoothClassicMedium::HasRemoteDevice(const std::string& mac_address) {
   absl::MutexLock lock(&devices_map_mutex_);
   if (IsWatcherStarted()) {
@@ -677,6 +767,7 @@ winrt::fire_and_forget BluetoothClassicMedium::DeviceWatcher_Added(
   for (auto& observer : observers_.GetObservers()) {
     observer->DeviceAdded(*device);
   }
+  PreResolveServices(mac_address);
   return winrt::fire_and_forget();
 }
 
@@ -17,10 +17,13 @@
 
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "internal/base/observer_list.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/implementation/bluetooth_adapter.h"
@@ -29,6 +32,7 @@
 #include "internal/platform/implementation/windows/bluetooth_classic_device.h"
 #include "internal/platform/implementation/windows/bluetooth_classic_server_socket.h"
 #include "internal/platform/implementation/windows/bluetooth_classic_socket.h"
+#include "internal/platform/implementation/windows/submittable_executor.h"
 #include "internal/platform/implementation/windows/generated/winrt/Windows.Devices.Enumeration.h"
 #include "internal/platform/implementation/windows/generated/winrt/Windows.Networking.Sockets.h"
 #include "internal/platform/implementation/windows/generated/winrt/base.h"
@@ -141,6 +145,23 @@ class BluetoothClassicMedium : public api::BluetoothClassicMedium {
   // Check to see that the device actually handles the requested service
   bool CheckSdp(RfcommDeviceService requested_service);
 
+  // Returns the service |service_uuid| of |device|, checked against its SDP
+  // record, from the cache if it was resolved recently. Resolves and caches it
+  // otherwise. Returns nullptr if the device doesn't provide the service.
+  RfcommDeviceService ResolveService(BluetoothDevice* device,
+                                     const std::string& service_uuid)
+      ABSL_LOCKS_EXCLUDED(resolved_services_mutex_);
+  void InvalidateResolvedService(const std::string& mac_address,
+                                 const std::string& service_uuid)
+      ABSL_LOCKS_EXCLUDED(resolved_services_mutex_);
+  // Remembers |service_uuid| as one to pre-resolve on discovered devices.
+  void AddConnectedServiceUuid(const std::string& service_uuid)
+      ABSL_LOCKS_EXCLUDED(resolved_services_mutex_);
+  // Resolves the services connected to before on the device at
+  // |mac_address|, in the background.
+  void PreResolveServices(const std::string& mac_address)
+      ABSL_LOCKS_EXCLUDED(resolved_services_mutex_);
+
   // Methods to handle bluetooth devices
   bool HasRemoteDevice(const std::string& mac_address)
       ABSL_LOCKS_EXCLUDED(devices_map_mutex_);
@@ -189,6 +210,24 @@ class BluetoothClassicMedium : public api::BluetoothClassicMedium {
   BluetoothServerSocket* raw_server_socket_ = nullptr;
   bool is_radio_discoverable_ = false;
   ObserverList<Observer> observers_;
+
+  // A resolved service, kept to connect to it again without another SDP
+  // query, which can take about a second.
+  struct ResolvedService {
+    RfcommDeviceService service = nullptr;
+    absl::Time resolved_time;
+  };
+  static constexpr absl::Duration kResolvedServiceTtl = absl::Minutes(10);
+  static constexpr int kMaxConnectedServiceUuids = 4;
+
+  absl::Mutex resolved_services_mutex_;
+  // Keyed by MAC address and service UUID. Dropped when connecting fails.
+  absl::flat_hash_map<std::pair<std::string, std::string>, ResolvedService>
+      resolved_services_ ABSL_GUARDED_BY(resolved_services_mutex_);
+  // The service UUIDs connected to, the most recent last.
+  std::vector<std::string> connected_service_uuids_
+      ABSL_GUARDED_BY(resolved_services_mutex_);
+  SubmittableExecutor resolve_executor_;
 };
 
 }  // namespace windows
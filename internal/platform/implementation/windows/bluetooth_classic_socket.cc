@@ -14,6 +14,7 @@
 
 #include "internal/platform/implementation/windows/bluetooth_classic_socket.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <exception>
@@ -22,6 +23,7 @@
 
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
@@ -273,6 +275,46 @@ Exception BluetoothSocket::BluetoothOutputStream::Write(const ByteArray& data) {
   }
 }
 
+Exception BluetoothSocket::BluetoothOutputStream::Writev(
+    absl::Span<const ByteArray* const> buffers) {
+  try {
+    size_t total_size = 0;
+    for (const ByteArray* data : buffers) {
+      total_size += data->size();
+    }
+    if (total_size > write_buffer_.Capacity()) {
+      LOG(WARNING) << __func__
+                   << ": resize write buffer to packet size: " << total_size;
+      write_buffer_ = Buffer(total_size);
+    }
+
+    size_t offset = 0;
+    for (const ByteArray* data : buffers) {
+      std::memcpy(write_buffer_.data() + offset, data->data(), data->size());
+      offset += data->size();
+    }
+    write_buffer_.Length(total_size);
+
+    uint32_t wrote_bytes = winrt_output_stream_.WriteAsync(write_buffer_).get();
+    if (wrote_bytes != total_size) {
+      LOG(ERROR) << __func__ << ": Only wrote partial of data:[" << wrote_bytes
+                 << "/" << total_size << "].";
+      return {Exception::kIo};
+    }
+    return {Exception::kSuccess};
+  } catch (std::exception exception) {
+    LOG(ERROR) << __func__ << ": Exception: " << exception.what();
+    return {Exception::kIo};
+  } catch (const winrt::hresult_error& error) {
+    LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
+               << winrt::to_string(error.message());
+    return {Exception::kIo};
+  } catch (...) {
+    LOG(ERROR) << __func__ << ": Unknown exeption.";
+    return {Exception::kIo};
+  }
+}
+
 Exception BluetoothSocket::BluetoothOutputStream::Flush() {
   try {
     if (winrt_output_stream_ == nullptr) {
@@ -20,6 +20,7 @@
 #include <cstdint>
 #include <memory>
 
+#include "absl/types/span.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/implementation/bluetooth_classic.h"
@@ -93,6 +94,9 @@ class BluetoothSocket : public api::BluetoothSocket {
     ~BluetoothOutputStream() override = default;
 
     Exception Write(const ByteArray& data) override;
+    // Gathers all buffers into |write_buffer_| and sends them with a single
+    // WriteAsync().
+    Exception Writev(absl::Span<const ByteArray* const> buffers) override;
     Exception Flush() override;
 
     Exception Close() override;
@@ -14,11 +14,14 @@
 
 #include "internal/platform/implementation/windows/file.h"
 
+#include <windows.h>
+
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
-#include <ios>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
@@ -29,101 +32,139 @@
 
 namespace nearby {
 namespace windows {
+namespace {
+
+// ReadFile() and WriteFile() take 32-bit lengths.
+constexpr std::int64_t kMaxIoSize = MAXDWORD;
+
+HANDLE OpenFile(absl::string_view path, DWORD access, DWORD creation,
+                DWORD flags) {
+  // Always open file path as wide string on Windows platform.
+  std::wstring wide_path = string_utils::StringToWideString(std::string(path));
+  return CreateFileW(wide_path.c_str(), access,
+                     FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, creation,
+                     flags, nullptr);
+}
+
+}  // namespace
 
 // InputFile
 std::unique_ptr<IOFile> IOFile::CreateInputFile(absl::string_view file_path,
                                                 size_t size) {
-  return absl::WrapUnique(new IOFile(file_path, size));
-}
-
-IOFile::IOFile(absl::string_view file_path, size_t size) : path_(file_path) {
-  // Always open input file path as wide string on Windows platform.
-  std::wstring wide_path = string_utils::StringToWideString(
-      std::string(file_path));
-  file_.open(wide_path, std::ios::binary | std::ios::in | std::ios::ate);
-
-  total_size_ = file_.tellg();
-  if (total_size_ == -1) {
-    // Unsure why it consistently returns -1 when the file size exceeds 2GB. If
-    // obtaining the file size through tellg fails, use the size provided
-    // in the parameters.
-    total_size_ = size;
+  // Chunks are read front to back; the cache manager reads ahead of them.
+  auto file = absl::WrapUnique(new IOFile(
+      file_path, OpenFile(file_path, GENERIC_READ, OPEN_EXISTING,
+                          FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN)));
+  LARGE_INTEGER file_size;
+  if (file->handle_ != INVALID_HANDLE_VALUE &&
+      GetFileSizeEx(file->handle_, &file_size)) {
+    file->total_size_ = file_size.QuadPart;
+  } else {
+    file->total_size_ = size;
   }
-
-  file_.seekg(0);
+  return file;
 }
 
 std::unique_ptr<IOFile> IOFile::CreateOutputFile(absl::string_view path) {
-  return std::unique_ptr<IOFile>(new IOFile(path));
+  return absl::WrapUnique(
+      new IOFile(path, OpenFile(path, GENERIC_WRITE, CREATE_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL)));
 }
 
-IOFile::IOFile(absl::string_view file_path)
-    : file_(), path_(file_path), total_size_(0) {
-  // Always open input file path as wide string on Windows platform.
-  std::wstring wide_path =
-      string_utils::StringToWideString(path_);
-  file_.open(wide_path, std::ios::binary | std::ios::out);
-}
+IOFile::IOFile(absl::string_view file_path, HANDLE handle)
+    : handle_(handle), path_(file_path) {}
 
-ExceptionOr<ByteArray> IOFile::Read(std::int64_t size) {
-  try {
-    if (!file_.is_open()) {
-      return ExceptionOr<ByteArray>{Exception::kIo};
-    }
+IOFile::~IOFile() { Close(); }
 
-    if (!file_.good()) {
-      return ExceptionOr<ByteArray>{Exception::kIo};
-    }
+ExceptionOr<ByteArray> IOFile::Read(std::int64_t size) {
+  if (handle_ == INVALID_HANDLE_VALUE) {
+    return ExceptionOr<ByteArray>{Exception::kIo};
+  }
 
-    if (file_.eof()) {
-      return ExceptionOr<ByteArray>{ByteArray{}};
-    }
+  // Read straight into the buffer handed out, instead of through a temporary.
+  std::string read_bytes(std::clamp<std::int64_t>(size, 0, kMaxIoSize), '\0');
+  DWORD num_bytes_read = 0;
+  if (!ReadFile(handle_, read_bytes.data(),
+                static_cast<DWORD>(read_bytes.size()), &num_bytes_read,
+                nullptr)) {
+    LOG(ERROR) << "Failed to read " << path_ << ", error " << GetLastError();
+    return ExceptionOr<ByteArray>{Exception::kIo};
+  }
+  // Nothing read means end of file.
+  position_ += num_bytes_read;
+  read_bytes.resize(num_bytes_read);
+  return ExceptionOr<ByteArray>(ByteArray(std::move(read_bytes)));
+}
 
-    if (buffer_.size() < size) {
-      buffer_.resize(size);
-    }
+ExceptionOr<size_t> IOFile::Skip(size_t offset) {
+  if (handle_ == INVALID_HANDLE_VALUE) {
+    return ExceptionOr<size_t>{Exception::kIo};
+  }
 
-    file_.read(buffer_.data(), static_cast<ptrdiff_t>(size));
-    auto num_bytes_read = file_.gcount();
-    if (num_bytes_read == 0) {
-      return ExceptionOr<ByteArray>{Exception::kIo};
-    }
-    return ExceptionOr<ByteArray>(ByteArray(buffer_.data(), num_bytes_read));
-  } catch (...) {
-    LOG(ERROR) << "Fail to read";
-    return ExceptionOr<ByteArray>{Exception::kIo};
+  std::int64_t skipped = std::min(static_cast<std::int64_t>(offset),
+                                  std::max<std::int64_t>(
+                                      total_size_ - position_, 0));
+  LARGE_INTEGER distance;
+  distance.QuadPart = skipped;
+  if (!SetFilePointerEx(handle_, distance, nullptr, FILE_CURRENT)) {
+    return ExceptionOr<size_t>{Exception::kIo};
   }
+  position_ += skipped;
+  return ExceptionOr<size_t>(static_cast<size_t>(skipped));
 }
 
 Exception IOFile::Close() {
-  if (file_.is_open()) {
-    file_.close();
+  if (handle_ != INVALID_HANDLE_VALUE) {
+    CloseHandle(handle_);
+    handle_ = INVALID_HANDLE_VALUE;
   }
   return {Exception::kSuccess};
 }
 
 Exception IOFile::Write(const ByteArray& data) {
-  try {
-    if (!file_.is_open()) {
-      return {Exception::kIo};
-    }
+  if (handle_ == INVALID_HANDLE_VALUE) {
+    return {Exception::kIo};
+  }
 
-    if (!file_.good()) {
+  const char* bytes = data.data();
+  std::int64_t remaining = data.size();
+  while (remaining > 0) {
+    DWORD num_bytes_written = 0;
+    if (!WriteFile(handle_, bytes,
+                   static_cast<DWORD>(std::min(remaining, kMaxIoSize)),
+                   &num_bytes_written, nullptr)) {
+      LOG(ERROR) << "Failed to write " << path_ << ", error "
+                 << GetLastError();
       return {Exception::kIo};
     }
-
-    file_.write(data.data(), data.size());
-    file_.flush();
-    return {file_.good() ? Exception::kSuccess : Exception::kIo};
-  } catch (...) {
-    LOG(ERROR) << "Fail to write";
-    return {Exception::kIo};
+    bytes += num_bytes_written;
+    remaining -= num_bytes_written;
   }
+  return {Exception::kSuccess};
 }
 
 Exception IOFile::Flush() {
-  file_.flush();
-  return {file_.good() ? Exception::kSuccess : Exception::kIo};
+  // Writes go straight to the file system cache; there is nothing buffered
+  // here to flush.
+  return {handle_ != INVALID_HANDLE_VALUE ? Exception::kSuccess
+                                          : Exception::kIo};
+}
+
+Exception IOFile::Preallocate(std::int64_t size) {
+  if (handle_ == INVALID_HANDLE_VALUE) {
+    return {Exception::kIo};
+  }
+  if (size <= 0) return {Exception::kSuccess};
+  // Setting the allocation size reserves the clusters without moving the end
+  // of file.
+  FILE_ALLOCATION_INFO allocation_info;
+  allocation_info.AllocationSize.QuadPart = size;
+  if (!SetFileInformationByHandle(handle_, FileAllocationInfo,
+                                  &allocation_info, sizeof(allocation_info))) {
+    LOG(WARNING) << "Failed to preallocate " << size << " bytes for " << path_;
+    return {Exception::kIo};
+  }
+  return {Exception::kSuccess};
 }
 
 }  // namespace windows
@@ -15,9 +15,10 @@
 #ifndef PLATFORM_IMPL_WINDOWS_FILE_H_
 #define PLATFORM_IMPL_WINDOWS_FILE_H_
 
+#include <windows.h>
+
 #include <cstddef>
 #include <cstdint>
-#include <fstream>
 #include <memory>
 #include <string>
 
@@ -37,7 +38,11 @@ class IOFile final : public api::InputFile, public api::OutputFile {
 
   static std::unique_ptr<IOFile> CreateOutputFile(absl::string_view path);
 
+  ~IOFile() override;
+
   ExceptionOr<ByteArray> Read(std::int64_t size) override;
+  // Seeks instead of reading the skipped bytes.
+  ExceptionOr<size_t> Skip(size_t offset) override;
 
   std::string GetFilePath() const override { return path_; }
 
@@ -46,15 +51,19 @@ class IOFile final : public api::InputFile, public api::OutputFile {
 
   Exception Write(const ByteArray& data) override;
   Exception Flush() override;
+  Exception Preallocate(std::int64_t size) override;
 
  private:
-  explicit IOFile(absl::string_view file_path, size_t size);
-  explicit IOFile(absl::string_view file_path);
+  // Takes ownership of |handle|, which may be INVALID_HANDLE_VALUE.
+  IOFile(absl::string_view file_path, HANDLE handle);
 
-  std::fstream file_;
+  // Reads and writes go straight to the handle: no stream buffer in between,
+  // and reads land in the ByteArray handed out.
+  HANDLE handle_;
   std::string path_;
-  std::string buffer_;
-  std::int64_t total_size_;
+  std::int64_t total_size_ = 0;
+  // The read position.
+  std::int64_t position_ = 0;
 };
 
 }  // namespace windows
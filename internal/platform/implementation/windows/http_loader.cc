@@ -15,7 +15,10 @@
 #include "internal/platform/implementation/windows/http_loader.h"
 
 #include <iostream>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -23,6 +26,7 @@
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "internal/platform/implementation/http_loader.h"
 #include "internal/platform/logging.h"
 
@@ -37,6 +41,63 @@ using ::nearby::api::WebResponse;
 
 }  // namespace
 
+InternetSession& InternetSession::GetInstance() {
+  static std::aligned_storage_t<sizeof(InternetSession),
+                                alignof(InternetSession)>
+      storage;
+  static InternetSession* instance = new (&storage) InternetSession();
+  return *instance;
+}
+
+absl::StatusOr<HINTERNET> InternetSession::GetConnection(
+    const std::string& host, int port) {
+  absl::MutexLock lock(&mutex_);
+  if (internet_handle_ == nullptr) {
+    internet_handle_ =
+        InternetOpenA("Mozilla/5.0",                /*Agent*/
+                      INTERNET_OPEN_TYPE_PRECONFIG, /*Access Type*/
+                      nullptr,                      /*Proxy*/
+                      nullptr,                      /*Proxy bypass*/
+                      0);                           /*Flags*/
+    if (internet_handle_ == nullptr) {
+      LOG(ERROR) << "Failed to open internet with error " << GetLastError()
+                 << ".";
+      return absl::FailedPreconditionError(absl::StrCat(GetLastError()));
+    }
+#ifdef INTERNET_OPTION_ENABLE_HTTP_PROTOCOL
+    // Falls back to HTTP/1.1 on servers, and OS versions, without HTTP/2.
+    DWORD protocols = HTTP_PROTOCOL_FLAG_HTTP2;
+    if (!InternetSetOptionA(internet_handle_,
+                            INTERNET_OPTION_ENABLE_HTTP_PROTOCOL, &protocols,
+                            sizeof(protocols))) {
+      LOG(INFO) << "HTTP/2 is not available, error " << GetLastError() << ".";
+    }
+#endif
+  }
+
+  auto it = connections_.find(std::make_pair(host, port));
+  if (it != connections_.end()) {
+    return it->second;
+  }
+
+  HINTERNET connect_handle =
+      InternetConnectA(internet_handle_,      /*Internet*/
+                       host.c_str(),          /*Server name*/
+                       port,                  /*Port*/
+                       nullptr,               /*User name*/
+                       nullptr,               /*Password*/
+                       INTERNET_SERVICE_HTTP, /*Service*/
+                       0,                     /*Flags*/
+                       0);                    /*Context*/
+  if (connect_handle == nullptr) {
+    LOG(ERROR) << "Failed to connect remote web server with error "
+               << GetLastError() << ".";
+    return absl::FailedPreconditionError(absl::StrCat(GetLastError()));
+  }
+  connections_.emplace(std::make_pair(host, port), connect_handle);
+  return connect_handle;
+}
+
 absl::StatusOr<WebResponse> HttpLoader::GetResponse() {
   absl::Status status;
 
@@ -56,12 +117,9 @@ absl::StatusOr<WebResponse> HttpLoader::GetResponse() {
     return status;
   }
 
-  // Processes response from web server
+  // Processes response from web server. The whole response is read, which
+  // hands the connection back to the pool.
   absl::StatusOr<WebResponse> result = ProcessResponse();
-  if (!result.ok()) {
-    return result;
-  }
-
   DisconnectWebServer();
   return result;
 }
@@ -197,34 +255,12 @@ absl::Status HttpLoader::ParseUrl() {
 }
 
 absl::Status HttpLoader::ConnectWebServer() {
-  internet_handle_ = InternetOpenA("Mozilla/5.0",                /*Agent*/
-                                   INTERNET_OPEN_TYPE_PRECONFIG, /*Access Type*/
-                                   nullptr,                      /*Proxy*/
-                                   nullptr, /*Proxy bypass*/
-                                   0);      /*Flags*/
-
-  if (internet_handle_ == nullptr) {
-    LOG(ERROR) << "Failed to open internet with error " << GetLastError()
-               << ".";
-    return absl::FailedPreconditionError(absl::StrCat(GetLastError()));
-  }
-
-  connect_handle_ = InternetConnectA(internet_handle_,      /*Internet*/
-                                     host_.c_str(),         /*Server name*/
-                                     port_,                 /*Port*/
-                                     nullptr,               /*User name*/
-                                     nullptr,               /*Password*/
-                                     INTERNET_SERVICE_HTTP, /*Service*/
-                                     0,                     /*Flags*/
-                                     0);                    /*Context*/
-
-  if (connect_handle_ == nullptr) {
-    LOG(ERROR) << "Failed to connect remote web server with error "
-               << GetLastError() << ".";
-    InternetCloseHandle(internet_handle_);
-    return absl::FailedPreconditionError(absl::StrCat(GetLastError()));
+  absl::StatusOr<HINTERNET> connect_handle =
+      InternetSession::GetInstance().GetConnection(host_, port_);
+  if (!connect_handle.ok()) {
+    return connect_handle.status();
   }
-
+  connect_handle_ = *connect_handle;
   return absl::OkStatus();
 }
 
@@ -246,9 +282,6 @@ absl::Status HttpLoader::SendRequest() {
   if (request_handle_ == nullptr) {
     LOG(ERROR) << "Failed to open request to remote web server with error "
                << GetLastError() << ".";
-    InternetCloseHandle(internet_handle_);
-    InternetCloseHandle(connect_handle_);
-
     return absl::FailedPreconditionError(absl::StrCat(GetLastError()));
   }
 
@@ -287,10 +320,6 @@ absl::Status HttpLoader::SendRequest() {
   if (result == FALSE) {
     LOG(ERROR) << "Failed to send request to remote web server with error "
                << GetLastError() << ".";
-    InternetCloseHandle(request_handle_);
-    InternetCloseHandle(connect_handle_);
-    InternetCloseHandle(internet_handle_);
-
     return absl::FailedPreconditionError(absl::StrCat(GetLastError()));
   }
 
@@ -336,9 +365,6 @@ absl::StatusOr<WebResponse> HttpLoader::ProcessResponse() {
     } else {
       LOG(ERROR) << "Failed to read response from remote web server with error "
                  << GetLastError() << ".";
-      InternetCloseHandle(request_handle_);
-      InternetCloseHandle(connect_handle_);
-      InternetCloseHandle(internet_handle_);
       return absl::FailedPreconditionError(absl::StrCat(GetLastError()));
     }
   }
@@ -356,16 +382,8 @@ void HttpLoader::DisconnectWebServer() {
     InternetCloseHandle(request_handle_);
     request_handle_ = nullptr;
   }
-
-  if (connect_handle_ != nullptr) {
-    InternetCloseHandle(connect_handle_);
-    connect_handle_ = nullptr;
-  }
-
-  if (internet_handle_ != nullptr) {
-    InternetCloseHandle(internet_handle_);
-    internet_handle_ = nullptr;
-  }
+  // The connection handle stays open in InternetSession for later requests.
+  connect_handle_ = nullptr;
 }
 
 absl::Status HttpLoader::HTTPCodeToStatus(int status_code,
@@ -396,7 +414,9 @@ absl::Status HttpLoader::HTTPCodeToStatus(int status_code,
     default:
       break;
   }
-  if (status_code >= 200 && status_code < 300) {
+  // 304 Not Modified answers a conditional request, and has the caller use
+  // the response it already has.
+  if ((status_code >= 200 && status_code < 300) || status_code == 304) {
     return absl::OkStatus();
   } else if (status_code >= 400 && status_code < 500) {
     return absl::FailedPreconditionError(status_message);
@@ -19,24 +19,58 @@
 #include <wininet.h>
 
 #include <string>
+#include <utility>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "internal/platform/implementation/http_loader.h"
 
 namespace nearby {
 namespace windows {
 
+// Holds the WinInet session of the process, and a connection handle per web
+// server, so that requests to a server reuse the keep-alive connections
+// WinInet pools for it instead of each paying a new TCP and TLS handshake.
+// HTTP/2 is used where the OS supports it. WinInet handles are thread safe,
+// so any number of requests may go through them at once.
+class InternetSession {
+ public:
+  InternetSession(const InternetSession&) = delete;
+  InternetSession& operator=(const InternetSession&) = delete;
+
+  static InternetSession& GetInstance();
+
+  // Returns the connection handle of |host|:|port|, opening the session and
+  // the connection on first use. The handle stays open for the life of the
+  // process.
+  absl::StatusOr<HINTERNET> GetConnection(const std::string& host, int port)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // This is a singleton object, for which destructor will never be called.
+  InternetSession() = default;
+  ~InternetSession() = default;
+
+  absl::Mutex mutex_;
+  HINTERNET internet_handle_ ABSL_GUARDED_BY(mutex_) = nullptr;
+  absl::flat_hash_map<std::pair<std::string, int>, HINTERNET> connections_
+      ABSL_GUARDED_BY(mutex_);
+};
+
 // HttpLoader is used to get HTTP response from remote server.
 //
 // HttpLoader gets HTTP request information from caller, and calling Windows
-// WinInet APIs to get HTTP response. The platform handles HTTP/HTTPS sessions.
+// WinInet APIs to get HTTP response. The connection to the server comes from
+// InternetSession, and only the request handle belongs to the loader.
 class HttpLoader {
  public:
   explicit HttpLoader(const nearby::api::WebRequest& request)
       : request_(request) {}
-  ~HttpLoader() = default;
+  ~HttpLoader() { DisconnectWebServer(); }
 
   absl::StatusOr<nearby::api::WebResponse> GetResponse();
 
@@ -74,7 +108,7 @@ class HttpLoader {
   bool is_secure_ = false;
   int port_ = 80;
 
-  HINTERNET internet_handle_ = nullptr;
+  // Owned by InternetSession.
   HINTERNET connect_handle_ = nullptr;
   HINTERNET request_handle_ = nullptr;
 };
@@ -146,3 +146,35 @@ TEST_F(InputFileTests, FailedRead) {
 
   EXPECT_STREQ(data.c_str(), "");
 }
+
+TEST_F(InputFileTests, SuccessfulSkip) {
+  nearby::PayloadId payloadId(TEST_PAYLOAD_ID);
+  std::unique_ptr<nearby::api::InputFile> inputFile = nullptr;
+
+  inputFile = nearby::api::ImplementationPlatform::CreateInputFile(
+      payloadId, strlen(TEST_STRING));
+
+  auto skipped = inputFile->Skip(2);
+  EXPECT_TRUE(skipped.ok());
+  EXPECT_EQ(skipped.result(), 2);
+
+  auto dataRead = inputFile->Read(inputFile->GetTotalSize());
+  EXPECT_TRUE(dataRead.ok());
+  EXPECT_EQ(inputFile->Close(), nearby::Exception{nearby::Exception::kSuccess});
+
+  EXPECT_STREQ(std::string(dataRead.result()).c_str(), TEST_STRING + 2);
+}
+
+TEST_F(InputFileTests, SkipStopsAtEndOfFile) {
+  nearby::PayloadId payloadId(TEST_PAYLOAD_ID);
+  std::unique_ptr<nearby::api::InputFile> inputFile = nullptr;
+
+  inputFile = nearby::api::ImplementationPlatform::CreateInputFile(
+      payloadId, strlen(TEST_STRING));
+
+  auto skipped = inputFile->Skip(strlen(TEST_STRING) + 100);
+  EXPECT_TRUE(skipped.ok());
+  EXPECT_EQ(skipped.result(), strlen(TEST_STRING));
+
+  EXPECT_EQ(inputFile->Close(), nearby::Exception{nearby::Exception::kSuccess});
+}
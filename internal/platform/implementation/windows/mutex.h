@@ -43,6 +43,13 @@ class ABSL_LOCKABLE Mutex : public api::Mutex {
       recursive_mutex_.lock();
     }
   }
+  bool TryLock() ABSL_EXCLUSIVE_TRYLOCK_FUNCTION(true) override {
+    if (mode_ == Mode::kRegularNoCheck) mutex_.ForgetDeadlockInfo();
+    if (mode_ == Mode::kRegular || mode_ == Mode::kRegularNoCheck) {
+      return mutex_.TryLock();
+    }
+    return recursive_mutex_.try_lock();
+  }
 
   void Unlock() ABSL_UNLOCK_FUNCTION() override {
     if (mode_ == Mode::kRegular || mode_ == Mode::kRegularNoCheck) {
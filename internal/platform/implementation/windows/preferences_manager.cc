@@ -20,6 +20,7 @@
 #include <optional>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/strings/str_cat.h"
@@ -41,8 +42,9 @@ namespace {
 using json = ::nlohmann::json;
 }  // namespace
 
-PreferencesManager::PreferencesManager(absl::string_view file_path)
-    : api::PreferencesManager(file_path) {
+PreferencesManager::PreferencesManager(absl::string_view file_path,
+                                       absl::Duration flush_delay)
+    : api::PreferencesManager(file_path), flush_delay_(flush_delay) {
   std::optional<std::filesystem::path> path =
       nearby::api::ImplementationPlatform::CreateDeviceInfo()
           ->GetLocalAppDataPath();
@@ -57,6 +59,11 @@ PreferencesManager::PreferencesManager(absl::string_view file_path)
   value_ = preferences_repository_->LoadPreferences();
 }
 
+PreferencesManager::~PreferencesManager() {
+  executor_.Shutdown();
+  Flush();
+}
+
 bool PreferencesManager::Set(absl::string_view key, const json& value) {
   absl::MutexLock lock(&mutex_);
   return SetValue(key, value);
@@ -116,7 +123,8 @@ bool PreferencesManager::SetTime(absl::string_view key, absl::Time value) {
   }
 
   value_[absl::StrCat(key)] = tt;
-  return Commit();
+  Commit();
+  return true;
 }
 
 // Get JSON value.
@@ -188,20 +196,53 @@ absl::Time PreferencesManager::GetTime(absl::string_view key,
 // Removes preferences
 void PreferencesManager::Remove(absl::string_view key) {
   absl::MutexLock lock(&mutex_);
-  value_.erase(absl::StrCat(key));
+  if (value_.erase(absl::StrCat(key)) > 0) {
+    Commit();
+  }
 }
 
-// Private methods
+bool PreferencesManager::Flush() {
+  absl::MutexLock flush_lock(&flush_mutex_);
+  json preferences;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!dirty_) {
+      return true;
+    }
+    dirty_ = false;
+    preferences = value_;
+  }
 
-// Writes data to storage.
-bool PreferencesManager::Commit() {
-  if (!preferences_repository_->SavePreferences(value_)) {
+  if (!preferences_repository_->SavePreferences(std::move(preferences))) {
     LOG(ERROR) << "Failed to save preference." << std::endl;
+    absl::MutexLock lock(&mutex_);
+    dirty_ = true;
     return false;
   }
   return true;
 }
 
+// Private methods
+
+// Schedules the pending changes to be written to storage.
+void PreferencesManager::Commit() {
+  dirty_ = true;
+  if (flush_scheduled_) {
+    return;
+  }
+
+  flush_scheduled_ = true;
+  executor_.Schedule(
+      [this]() {
+        {
+          absl::MutexLock lock(&mutex_);
+          flush_scheduled_ = false;
+        }
+        Flush();
+      },
+      flush_delay_);
+}
+
 bool PreferencesManager::SetValue(absl::string_view key, const json& value) {
   if (!value_.is_object()) {
     LOG(ERROR) << "Preferences is no longer an object! value_="
@@ -214,7 +255,8 @@ bool PreferencesManager::SetValue(absl::string_view key, const json& value) {
   }
 
   value_[absl::StrCat(key)] = value;
-  return Commit();
+  Commit();
+  return true;
 }
 
 template <typename T>
@@ -252,7 +294,8 @@ bool PreferencesManager::SetArrayValue(absl::string_view key,
   }
 
   value_[absl::StrCat(key)] = array_value;
-  return Commit();
+  Commit();
+  return true;
 }
 
 template <typename T>
@@ -30,6 +30,7 @@
 #include "nlohmann/json_fwd.hpp"
 #include "internal/platform/implementation/preferences_manager.h"
 #include "internal/platform/implementation/windows/preferences_repository.h"
+#include "internal/platform/implementation/windows/scheduled_executor.h"
 
 namespace nearby {
 namespace windows {
@@ -38,9 +39,17 @@ namespace windows {
 // Preferences are persistent storage for application settings, it is key/value
 // based settings. Application components can observe the interested preference
 // change by the observer.
+//
+// Changes are written to storage in the background, |flush_delay| after the
+// first one, so that the keys set in a row are written together. Pending
+// changes are written when the manager is destroyed.
 class PreferencesManager : public api::PreferencesManager {
  public:
-  explicit PreferencesManager(absl::string_view path);
+  static constexpr absl::Duration kDefaultFlushDelay = absl::Milliseconds(500);
+
+  explicit PreferencesManager(absl::string_view path,
+                              absl::Duration flush_delay = kDefaultFlushDelay);
+  ~PreferencesManager() override;
 
   // Sets values
 
@@ -108,9 +117,13 @@ class PreferencesManager : public api::PreferencesManager {
   // Removes preferences
   void Remove(absl::string_view key) override ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Writes the pending changes to storage now. Returns false if they couldn't
+  // be written, in which case they are written with the next change.
+  bool Flush() ABSL_LOCKS_EXCLUDED(mutex_, flush_mutex_);
+
  private:
-  // Writes data to storage.
-  bool Commit() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Schedules the pending changes to be written to storage.
+  void Commit() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   bool SetValue(absl::string_view key, const nlohmann::json& value)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -129,10 +142,17 @@ class PreferencesManager : public api::PreferencesManager {
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   nlohmann::json value_ ABSL_GUARDED_BY(mutex_);
-  std::unique_ptr<PreferencesRepository> preferences_repository_
-      ABSL_GUARDED_BY(mutex_);
-
+  bool dirty_ ABSL_GUARDED_BY(mutex_) = false;
+  bool flush_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+  // Set in the constructor; it has a lock of its own.
+  std::unique_ptr<PreferencesRepository> preferences_repository_;
+  const absl::Duration flush_delay_;
+
+  // Held while writing to storage, so that the writes are ordered, without
+  // holding |mutex_| and blocking the callers during the disk I/O.
+  absl::Mutex flush_mutex_ ABSL_ACQUIRED_BEFORE(mutex_);
   mutable absl::Mutex mutex_;
+  ScheduledExecutor executor_;
 };
 
 }  // namespace windows
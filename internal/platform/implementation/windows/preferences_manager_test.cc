@@ -182,5 +182,33 @@ TEST(PreferencesManager, RemoveKey) {
   EXPECT_EQ(result, "default key");
 }
 
+TEST(PreferencesManager, WritesChangesTogether) {
+  std::string int_key = "batched_int_key";
+  std::string string_key = "batched_string_key";
+  {
+    PreferencesManager pm(kPreferencesFilePath, absl::Hours(1));
+    pm.SetInteger(int_key, 1);
+    pm.SetInteger(int_key, 2);
+    pm.SetString(string_key, "batched");
+    EXPECT_TRUE(pm.Flush());
+    EXPECT_EQ(PreferencesManager(kPreferencesFilePath).GetInteger(int_key, 0),
+              2);
+  }
+  PreferencesManager pm(kPreferencesFilePath);
+  EXPECT_EQ(pm.GetString(string_key, ""), "batched");
+}
+
+TEST(PreferencesManager, WritesPendingChangesOnDestruction) {
+  std::string int_key = "pending_int_key";
+  {
+    PreferencesManager pm(kPreferencesFilePath, absl::Hours(1));
+    pm.SetInteger(int_key, 1234);
+    pm.Remove("batched_int_key");
+  }
+  PreferencesManager pm(kPreferencesFilePath);
+  EXPECT_EQ(pm.GetInteger(int_key, 0), 1234);
+  EXPECT_EQ(pm.GetInteger("batched_int_key", 0), 0);
+}
+
 }  // namespace windows
 }  // namespace nearby
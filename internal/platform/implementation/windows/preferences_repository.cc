@@ -32,6 +32,24 @@ using json = ::nlohmann::json;
 
 constexpr char kPreferencesFileName[] = "preferences.json";
 constexpr char kPreferencesBackupFileName[] = "preferences_bak.json";
+constexpr char kPreferencesTempFileName[] = "preferences_tmp.json";
+
+std::optional<json> LoadFile(const std::filesystem::path& full_name) {
+  std::ifstream preferences_file(full_name);
+  if (!preferences_file.good()) {
+    return std::nullopt;
+  }
+
+  json preferences = json::parse(preferences_file, nullptr, false);
+  preferences_file.close();
+
+  if (preferences.is_discarded()) {
+    LOG(ERROR) << "Preferences file corrupted.";
+    return std::nullopt;
+  }
+
+  return preferences;
+}
 
 }  // namespace
 
@@ -78,6 +96,20 @@ bool PreferencesRepository::SavePreferences(json preferences) {
 
     std::filesystem::path full_name = path / kPreferencesFileName;
     std::filesystem::path full_name_backup = path / kPreferencesBackupFileName;
+    std::filesystem::path full_name_temp = path / kPreferencesTempFileName;
+
+    // Write to a temporary file first, so that the preferences file is only
+    // ever replaced by a complete one.
+    std::ofstream preferences_file(full_name_temp);
+    preferences_file << preferences;
+    preferences_file.close();
+
+    // Make sure the file wasn't saved in a corrupted state
+    if (preferences_file.fail() || !LoadFile(full_name_temp).has_value()) {
+      LOG(ERROR) << "Preferences saved to disk in corrupted state.";
+      nearby::sharing::RemoveFile(full_name_temp);
+      return false;
+    }
 
     // Create a backup without moving the bytes on disk
     if (nearby::sharing::FileExists(full_name)) {
@@ -87,19 +119,13 @@ bool PreferencesRepository::SavePreferences(json preferences) {
       }
     }
 
-    std::ofstream preferences_file(full_name);
-    preferences_file << preferences;
-    preferences_file.close();
-
-    // Make sure the file wasn't saved in a corrupted state
-    if (!AttemptLoad().has_value()) {
-      LOG(ERROR) << "Preferences saved to disk in corrupted state. "
+    if (!nearby::sharing::Rename(full_name_temp, full_name)) {
+      LOG(ERROR) << "Failed to rename preferences file. "
                     "Restoring from backup.";
-
       if (!RestoreFromBackup().has_value()) {
         LOG(ERROR) << "Failed to restore preferences file.";
-        return false;
       }
+      return false;
     }
   } catch (const std::exception& e) {
     LOG(ERROR) << "Failed to save preferences file: " << e.what();
@@ -121,20 +147,7 @@ std::optional<json> PreferencesRepository::AttemptLoad() {
   }
 
   try {
-    std::ifstream preferences_file(full_name);
-    if (!preferences_file.good()) {
-      return std::nullopt;
-    }
-
-    json preferences = json::parse(preferences_file, nullptr, false);
-    preferences_file.close();
-
-    if (preferences.is_discarded()) {
-      LOG(ERROR) << "Preferences file corrupted.";
-      return std::nullopt;
-    }
-
-    return preferences;
+    return LoadFile(full_name);
   } catch (const std::exception& e) {
     LOG(ERROR) << "Exception while loading preferences: " << e.what();
     return std::nullopt;
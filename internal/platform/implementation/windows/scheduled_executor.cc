@@ -23,6 +23,7 @@
 #include "internal/flags/nearby_flags.h"
 #include "internal/platform/flags/nearby_platform_feature_flags.h"
 #include "internal/platform/implementation/cancelable.h"
+#include "internal/platform/implementation/shared/timer_service.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/runnable.h"
 
@@ -36,6 +37,12 @@ ScheduledExecutor::ScheduledExecutor()
           platform::config_package_nearby::nearby_platform_feature::
               kEnableTaskScheduler)) {}
 
+ScheduledExecutor::~ScheduledExecutor() {
+  if (!shut_down_) {
+    Shutdown();
+  }
+}
+
 // Cancelable is kept both in the executor context, and in the caller context.
 // We want Cancelable to live until both caller and executor are done with it.
 // Exclusive ownership model does not work for this case;
@@ -69,10 +76,14 @@ std::shared_ptr<api::Cancelable> ScheduledExecutor::Schedule(
     }
 
     std::shared_ptr<ScheduledTask> task =
-        std::make_shared<ScheduledTask>(std::move(runnable), duration);
+        std::make_shared<ScheduledTask>(std::move(runnable));
 
     scheduled_tasks_.push_back(task);
-    executor_->Execute([task]() { task->Start(); });
+    // The timer service only hands the task to the executor, so that no
+    // executor thread waits for the delay.
+    task->set_timer_id(shared::TimerService::GetInstance().Schedule(
+        duration,
+        [this, task]() { executor_->Execute([task]() { task->Run(); }); }));
     return task;
   }
 }
@@ -99,6 +110,9 @@ void ScheduledExecutor::Shutdown() {
       shut_down_ = true;
       for (auto& task : scheduled_tasks_) {
         task->Cancel();
+        // A timer that fired but is still handing over the task uses the
+        // executor.
+        task->StopTimer();
       }
 
       scheduled_tasks_.clear();
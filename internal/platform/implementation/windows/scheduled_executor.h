@@ -21,10 +21,10 @@
 #include <memory>
 #include <vector>
 
-#include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
 #include "internal/platform/implementation/cancelable.h"
 #include "internal/platform/implementation/scheduled_executor.h"
+#include "internal/platform/implementation/shared/timer_service.h"
 #include "internal/platform/implementation/windows/executor.h"
 #include "internal/platform/implementation/windows/task_scheduler.h"
 #include "internal/platform/runnable.h"
@@ -42,7 +42,7 @@ class ScheduledExecutor : public api::ScheduledExecutor {
  public:
   ScheduledExecutor();
 
-  ~ScheduledExecutor() override = default;
+  ~ScheduledExecutor() override;
 
   // Cancelable is kept both in the executor context, and in the caller context.
   // We want Cancelable to live until both caller and executor are done with it.
@@ -58,39 +58,49 @@ class ScheduledExecutor : public api::ScheduledExecutor {
   void Shutdown() override;
 
  private:
+  // A task waiting in the shared timer service, which hands it to the
+  // executor once it is due.
   class ScheduledTask : public api::Cancelable {
    public:
-    explicit ScheduledTask(Runnable&& task, absl::Duration duration)
-        : task_(std::move(task)), duration_(duration) {}
+    explicit ScheduledTask(Runnable&& task) : task_(std::move(task)) {}
 
     bool Cancel() override {
-      if (is_executed_ || is_cancelled_) {
+      Status expected = kNotRun;
+      if (!status_.compare_exchange_strong(expected, kCancelled)) {
         return false;
       }
-
-      is_cancelled_ = true;
-      notification_.Notify();
+      StopTimer();
       return true;
     };
 
-    void Start() {
-      if (is_executed_ ||
-          notification_.WaitForNotificationWithTimeout(duration_)) {
-        return;
+    void Run() {
+      Status expected = kNotRun;
+      if (status_.compare_exchange_strong(expected, kExecuted)) {
+        task_();
       }
+    }
+
+    // Drops the timer, waiting for it if it is handing the task over.
+    void StopTimer() {
+      shared::TimerService::GetInstance().Cancel(timer_id_);
+    }
 
-      is_executed_ = true;
-      task_();
+    void set_timer_id(shared::TimerService::TimerId timer_id) {
+      timer_id_ = timer_id;
     }
 
-    bool IsDone() const { return is_cancelled_ || is_executed_; }
+    bool IsDone() const { return status_ != kNotRun; }
 
    private:
+    enum Status {
+      kNotRun,
+      kExecuted,
+      kCancelled,
+    };
+
     Runnable task_;
-    absl::Duration duration_;
-    absl::Notification notification_;
-    bool is_cancelled_ = false;
-    bool is_executed_ = false;
+    std::atomic<Status> status_ = kNotRun;
+    std::atomic<shared::TimerService::TimerId> timer_id_ = 0;
   };
 
   std::unique_ptr<nearby::windows::Executor> executor_ = nullptr;
@@ -0,0 +1,148 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/implementation/windows/stream_writer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <utility>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+#include "internal/platform/logging.h"
+
+// WinRT headers
+#include "internal/platform/implementation/windows/generated/winrt/Windows.Foundation.h"
+#include "internal/platform/implementation/windows/generated/winrt/Windows.Storage.Streams.h"
+#include "internal/platform/implementation/windows/generated/winrt/base.h"
+
+namespace nearby {
+namespace windows {
+
+using ::winrt::Windows::Foundation::AsyncStatus;
+using ::winrt::Windows::Foundation::TimeSpan;
+using ::winrt::Windows::Storage::Streams::Buffer;
+using ::winrt::Windows::Storage::Streams::IOutputStream;
+
+StreamWriter::StreamWriter(IOutputStream output_stream, int max_pending_writes)
+    : output_stream_(output_stream),
+      max_pending_writes_(max_pending_writes > 0 ? max_pending_writes : 1) {}
+
+StreamWriter::~StreamWriter() { CancelPendingWrites(TimeSpan::zero()); }
+
+Exception StreamWriter::Write(absl::Span<const ByteArray* const> buffers) {
+  absl::MutexLock lock(&mutex_);
+  while (pending_writes_.size() >= max_pending_writes_) {
+    if (Exception error = CompleteOldestWrite(); error.Raised()) {
+      return error;
+    }
+  }
+
+  try {
+    size_t total_size = 0;
+    for (const ByteArray* data : buffers) {
+      total_size += data->size();
+    }
+    Buffer buffer = TakeBuffer(total_size);
+    size_t offset = 0;
+    for (const ByteArray* data : buffers) {
+      std::memcpy(buffer.data() + offset, data->data(), data->size());
+      offset += data->size();
+    }
+    buffer.Length(total_size);
+    pending_writes_.push_back({output_stream_.WriteAsync(buffer), buffer});
+    return {Exception::kSuccess};
+  } catch (std::exception exception) {
+    LOG(ERROR) << __func__ << ": Exception: " << exception.what();
+    return {Exception::kIo};
+  } catch (const winrt::hresult_error& error) {
+    LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
+               << winrt::to_string(error.message());
+    return {Exception::kIo};
+  } catch (...) {
+    LOG(ERROR) << __func__ << ": Unknown exeption.";
+    return {Exception::kIo};
+  }
+}
+
+Exception StreamWriter::WaitForPendingWrites() {
+  absl::MutexLock lock(&mutex_);
+  Exception result = {Exception::kSuccess};
+  while (!pending_writes_.empty()) {
+    if (Exception error = CompleteOldestWrite(); error.Raised()) {
+      result = error;
+    }
+  }
+  return result;
+}
+
+void StreamWriter::CancelPendingWrites(TimeSpan timeout) {
+  absl::MutexLock lock(&mutex_);
+  for (PendingWrite& pending_write : pending_writes_) {
+    try {
+      if (pending_write.operation.wait_for(timeout) != AsyncStatus::Completed) {
+        pending_write.operation.Cancel();
+      }
+    } catch (...) {
+      LOG(WARNING) << __func__ << ": Failed to cancel a pending write.";
+    }
+  }
+  pending_writes_.clear();
+}
+
+Buffer StreamWriter::TakeBuffer(uint32_t size) {
+  for (auto it = free_buffers_.begin(); it != free_buffers_.end(); ++it) {
+    if (it->Capacity() >= size) {
+      Buffer buffer = *it;
+      free_buffers_.erase(it);
+      return buffer;
+    }
+  }
+  return Buffer(size);
+}
+
+Exception StreamWriter::CompleteOldestWrite() {
+  PendingWrite pending_write = std::move(pending_writes_.front());
+  pending_writes_.pop_front();
+  try {
+    uint32_t size = pending_write.buffer.Length();
+    uint32_t wrote_bytes = pending_write.operation.get();
+    if (wrote_bytes != size) {
+      LOG(ERROR) << __func__ << ": Only wrote partial of data:[" << wrote_bytes
+                 << "/" << size << "].";
+      return {Exception::kIo};
+    }
+    if (free_buffers_.size() < max_pending_writes_) {
+      free_buffers_.push_back(pending_write.buffer);
+    }
+    return {Exception::kSuccess};
+  } catch (std::exception exception) {
+    LOG(ERROR) << __func__ << ": Exception: " << exception.what();
+    return {Exception::kIo};
+  } catch (const winrt::hresult_error& error) {
+    LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
+               << winrt::to_string(error.message());
+    return {Exception::kIo};
+  } catch (...) {
+    LOG(ERROR) << __func__ << ": Unknown exeption.";
+    return {Exception::kIo};
+  }
+}
+
+}  // namespace windows
+}  // namespace nearby
@@ -0,0 +1,88 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_IMPL_WINDOWS_STREAM_WRITER_H_
+#define PLATFORM_IMPL_WINDOWS_STREAM_WRITER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "internal/platform/byte_array.h"
+#include "internal/platform/exception.h"
+
+// WinRT headers
+#include "internal/platform/implementation/windows/generated/winrt/Windows.Foundation.h"
+#include "internal/platform/implementation/windows/generated/winrt/Windows.Storage.Streams.h"
+#include "internal/platform/implementation/windows/generated/winrt/base.h"
+
+namespace nearby {
+namespace windows {
+
+// Writes to a WinRT output stream with several WriteAsync() operations in
+// flight, so that a socket isn't limited to one round trip per write.
+//
+// The data of each write is copied into a buffer taken from a pool, which is
+// handed back once the write completes. Write() returns as soon as the write
+// is started, and only waits when `max_pending_writes` writes are in flight,
+// so an error of a write is returned by a later call. A write that only wrote
+// part of its data is an error too.
+class StreamWriter {
+ public:
+  static constexpr int kDefaultMaxPendingWrites = 4;
+
+  explicit StreamWriter(
+      winrt::Windows::Storage::Streams::IOutputStream output_stream,
+      int max_pending_writes = kDefaultMaxPendingWrites);
+  ~StreamWriter();
+
+  // Starts writing the concatenation of `buffers`.
+  Exception Write(absl::Span<const ByteArray* const> buffers)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Waits for all writes in flight to complete.
+  Exception WaitForPendingWrites() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Gives the writes in flight `timeout` to complete and cancels the others.
+  void CancelPendingWrites(winrt::Windows::Foundation::TimeSpan timeout)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  struct PendingWrite {
+    winrt::Windows::Foundation::IAsyncOperationWithProgress<uint32_t, uint32_t>
+        operation{nullptr};
+    winrt::Windows::Storage::Streams::Buffer buffer{nullptr};
+  };
+
+  winrt::Windows::Storage::Streams::Buffer TakeBuffer(uint32_t size)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Waits for the oldest write in flight and recycles its buffer.
+  Exception CompleteOldestWrite() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  winrt::Windows::Storage::Streams::IOutputStream output_stream_{nullptr};
+  const size_t max_pending_writes_;
+  absl::Mutex mutex_;
+  std::deque<PendingWrite> pending_writes_ ABSL_GUARDED_BY(mutex_);
+  std::vector<winrt::Windows::Storage::Streams::Buffer> free_buffers_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace windows
+}  // namespace nearby
+
+#endif  // PLATFORM_IMPL_WINDOWS_STREAM_WRITER_H_
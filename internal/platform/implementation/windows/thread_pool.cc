@@ -16,33 +16,51 @@
 
 #include <windows.h>
 
+#include <algorithm>
 #include <memory>
 #include <queue>
 #include <utility>
 
 #include "absl/memory/memory.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "internal/platform/implementation/shared/count_down_latch.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/runnable.h"
 
 namespace nearby {
 namespace windows {
+namespace {
+
+// Indexed by ThreadPool::Priority.
+constexpr TP_CALLBACK_PRIORITY
+    kCallbackPriorities[ThreadPool::kPriorityCount] = {
+        TP_CALLBACK_PRIORITY_HIGH,
+        TP_CALLBACK_PRIORITY_NORMAL,
+        TP_CALLBACK_PRIORITY_LOW,
+};
+
+}  // namespace
 
 VOID CALLBACK WorkCallback(PTP_CALLBACK_INSTANCE instance, PVOID parameter,
                            PTP_WORK work) {
   // Instance is not used in thread pools.
   UNREFERENCED_PARAMETER(instance);
+  // The work is reused for the next tasks, and closed with the pool.
+  UNREFERENCED_PARAMETER(work);
 
   ThreadPool* thread_pool = reinterpret_cast<ThreadPool*>(parameter);
   thread_pool->RunNextTask();
-  CloseThreadpoolWork(work);
 }
 
 std::unique_ptr<ThreadPool> ThreadPool::Create(int max_pool_size) {
+  return Create(/*min_pool_size=*/1, max_pool_size);
+}
+
+std::unique_ptr<ThreadPool> ThreadPool::Create(int min_pool_size,
+                                               int max_pool_size) {
   PTP_POOL thread_pool = nullptr;
-  TP_CALLBACK_ENVIRON thread_pool_environ;
-  InitializeThreadpoolEnvironment(&thread_pool_environ);
 
   if (max_pool_size <= 0) {
     LOG(ERROR) << __func__
@@ -58,9 +76,11 @@ std::unique_ptr<ThreadPool> ThreadPool::Create(int max_pool_size) {
   }
 
   // Sets thread pool maximum value. In order to release all threads,
-  // it will keep at least one thread.
+  // it will keep at least one thread. Win32 adds threads up to the maximum
+  // while work is queued, and retires idle ones down to the minimum.
+  min_pool_size = std::clamp(min_pool_size, 1, max_pool_size);
   SetThreadpoolThreadMaximum(thread_pool, max_pool_size);
-  if (!SetThreadpoolThreadMinimum(thread_pool, 1)) {
+  if (!SetThreadpoolThreadMinimum(thread_pool, min_pool_size)) {
     LOG(ERROR) << __func__
                << ": failed to set minimum thread pool size. LastError: "
                << GetLastError();
@@ -68,21 +88,32 @@ std::unique_ptr<ThreadPool> ThreadPool::Create(int max_pool_size) {
     return nullptr;
   }
 
-  //
-  // Associate the callback environment with our thread pool.
-  //
-  SetThreadpoolCallbackPool(&thread_pool_environ, thread_pool);
-
-  return absl::WrapUnique(
-      new ThreadPool(thread_pool, thread_pool_environ, max_pool_size));
+  auto pool = absl::WrapUnique(new ThreadPool(thread_pool, max_pool_size));
+  for (int i = 0; i < kPriorityCount; ++i) {
+    PTP_WORK work = CreateThreadpoolWork(WorkCallback, pool.get(),
+                                         &pool->thread_pool_environs_[i]);
+    if (work == nullptr) {
+      LOG(ERROR) << __func__
+                 << ": failed to create thread pool work. LastError: "
+                 << GetLastError();
+      return nullptr;
+    }
+    pool->works_[i] = work;
+  }
+  return pool;
 }
 
-ThreadPool::ThreadPool(PTP_POOL thread_pool,
-                       TP_CALLBACK_ENVIRON thread_pool_environ,
-                       int max_pool_size)
-    : thread_pool_(thread_pool),
-      thread_pool_environ_(thread_pool_environ),
-      max_pool_size_(max_pool_size) {
+ThreadPool::ThreadPool(PTP_POOL thread_pool, int max_pool_size)
+    : thread_pool_(thread_pool), max_pool_size_(max_pool_size) {
+  //
+  // Associate the callback environments with our thread pool.
+  //
+  for (int i = 0; i < kPriorityCount; ++i) {
+    InitializeThreadpoolEnvironment(&thread_pool_environs_[i]);
+    SetThreadpoolCallbackPool(&thread_pool_environs_[i], thread_pool);
+    SetThreadpoolCallbackPriority(&thread_pool_environs_[i],
+                                  kCallbackPriorities[i]);
+  }
   VLOG(1) << __func__ << ": Thread pool(" << this
           << ") is created with size:" << max_pool_size_;
 }
@@ -98,35 +129,37 @@ ThreadPool::~ThreadPool() {
 }
 
 bool ThreadPool::Run(Runnable task) {
-  absl::MutexLock lock(&mutex_);
+  return Run(std::move(task), Priority::kNormal);
+}
 
-  if (thread_pool_ == nullptr) {
-    return false;
-  }
+bool ThreadPool::Run(Runnable task, Priority priority) {
+  int index = static_cast<int>(priority);
+  {
+    absl::MutexLock lock(&mutex_);
 
-  if (shutdown_latch_ != nullptr) {
-    LOG(WARNING) << __func__ << ": Thread pool is in shutting down.";
-    return false;
-  }
+    if (thread_pool_ == nullptr) {
+      return false;
+    }
 
-  PTP_WORK work;
-  tasks_.push(std::move(task));
-  VLOG(1) << __func__ << ": Scheduled to run task(" << &tasks_.back() << ").";
+    if (shutdown_latch_ != nullptr) {
+      LOG(WARNING) << __func__ << ": Thread pool is in shutting down.";
+      return false;
+    }
 
-  work = CreateThreadpoolWork(WorkCallback, this, &thread_pool_environ_);
-  if (work == nullptr) {
-    LOG(ERROR) << __func__ << ": failed to create thread pool work. LastError: "
-               << GetLastError();
-    return false;
-  }
+    tasks_[index].push(
+        QueuedTask{.task = std::move(task), .queued_time = absl::Now()});
+    VLOG(1) << __func__ << ": Scheduled to run task("
+            << &tasks_[index].back() << ") with priority " << index << ".";
 
-  ++running_tasks_count_;
+    ++running_tasks_count_;
+  }
 
   //
-  // Submit the work to the pool. Because this was a pre-allocated
+  // Submit the work to the pool outside of the lock; the pool can't be closed
+  // while the task is counted as running. Because this is a pre-allocated
   // work item (using CreateThreadpoolWork), it is guaranteed to execute.
   //
-  SubmitThreadpoolWork(work);
+  SubmitThreadpoolWork(works_[index]);
   return true;
 }
 
@@ -141,9 +174,7 @@ void ThreadPool::ShutDown() {
     }
 
     if (running_tasks_count_ == 0) {
-      CloseThreadpool(thread_pool_);
-      thread_pool_ = nullptr;
-      VLOG(1) << __func__ << ": Thread pool(" << this << ") is shut down.";
+      ClosePool();
       return;
     }
 
@@ -163,12 +194,39 @@ void ThreadPool::ShutDown() {
 
   {
     absl::MutexLock lock(&mutex_);
-    CloseThreadpool(thread_pool_);
-    thread_pool_ = nullptr;
-    VLOG(1) << __func__ << ": Thread pool(" << this << ") is shut down.";
+    ClosePool();
   }
 }
 
+ThreadPool::QueueStats ThreadPool::GetQueueStats(Priority priority) const {
+  absl::MutexLock lock(&mutex_);
+  return queue_stats_[static_cast<int>(priority)];
+}
+
+void ThreadPool::ClosePool() {
+  // The callbacks still returning keep the works alive until they are done.
+  for (PTP_WORK& work : works_) {
+    if (work != nullptr) {
+      CloseThreadpoolWork(work);
+      work = nullptr;
+    }
+  }
+  CloseThreadpool(thread_pool_);
+  thread_pool_ = nullptr;
+  for (TP_CALLBACK_ENVIRON& environment : thread_pool_environs_) {
+    DestroyThreadpoolEnvironment(&environment);
+  }
+  for (int i = 0; i < kPriorityCount; ++i) {
+    const QueueStats& stats = queue_stats_[i];
+    if (stats.run_count == 0) continue;
+    VLOG(1) << __func__ << ": Thread pool(" << this << ") priority " << i
+            << ": tasks=" << stats.run_count
+            << "; mean_wait=" << stats.total_wait / stats.run_count
+            << "; max_wait=" << stats.max_wait;
+  }
+  VLOG(1) << __func__ << ": Thread pool(" << this << ") is shut down.";
+}
+
 void ThreadPool::RunNextTask() {
   Runnable task = nullptr;
 
@@ -178,21 +236,30 @@ void ThreadPool::RunNextTask() {
     if (thread_pool_ == nullptr) {
       return;
     }
-    if (!tasks_.empty()) {
-      VLOG(1) << __func__ << ": Run task(" << &tasks_.front() << ").";
-
-      task = std::move(tasks_.front());
-      tasks_.pop();
-
-      if (task == nullptr) {
-        LOG(WARNING) << __func__
-                     << ": Tried to run task in an empty thread pool.";
-        --running_tasks_count_;
-        if (running_tasks_count_ == 0 && shutdown_latch_ != nullptr) {
-          shutdown_latch_->CountDown();
-        }
-        return;
+    for (int i = 0; i < kPriorityCount; ++i) {
+      if (tasks_[i].empty()) continue;
+      VLOG(1) << __func__ << ": Run task(" << &tasks_[i].front() << ").";
+
+      QueuedTask queued_task = std::move(tasks_[i].front());
+      tasks_[i].pop();
+      task = std::move(queued_task.task);
+
+      absl::Duration wait = absl::Now() - queued_task.queued_time;
+      QueueStats& stats = queue_stats_[i];
+      ++stats.run_count;
+      stats.total_wait += wait;
+      stats.max_wait = std::max(stats.max_wait, wait);
+      break;
+    }
+
+    if (task == nullptr) {
+      LOG(WARNING) << __func__
+                   << ": Tried to run task in an empty thread pool.";
+      --running_tasks_count_;
+      if (running_tasks_count_ == 0 && shutdown_latch_ != nullptr) {
+        shutdown_latch_->CountDown();
       }
+      return;
     }
   }
 
@@ -17,12 +17,15 @@
 
 #include <windows.h>
 
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <queue>
 #include <utility>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "internal/platform/implementation/shared/count_down_latch.h"
 #include "internal/platform/runnable.h"
 
@@ -31,35 +34,73 @@ namespace windows {
 
 class ThreadPool {
  public:
+  // Tasks of a higher priority run before the queued tasks of a lower one,
+  // e.g. channel reads and keep-alives before bulk file I/O. Tasks of the same
+  // priority run in the order they were queued.
+  enum class Priority {
+    kHigh = 0,
+    kNormal = 1,
+    kLow = 2,
+  };
+  static constexpr int kPriorityCount = 3;
+
+  // How long the tasks of a priority waited in the queue before running.
+  struct QueueStats {
+    std::int64_t run_count = 0;
+    absl::Duration total_wait = absl::ZeroDuration();
+    absl::Duration max_wait = absl::ZeroDuration();
+  };
+
   virtual ~ThreadPool();
   static std::unique_ptr<ThreadPool> Create(int max_pool_size);
+  // The pool keeps |min_pool_size| threads, and grows up to |max_pool_size|
+  // threads while tasks are queued.
+  static std::unique_ptr<ThreadPool> Create(int min_pool_size,
+                                            int max_pool_size);
 
   // Runs a task on thread pool. The result indicates whether the task is put
   // into the thread pool.
   bool Run(Runnable task) ABSL_LOCKS_EXCLUDED(mutex_);
+  bool Run(Runnable task, Priority priority) ABSL_LOCKS_EXCLUDED(mutex_);
 
   // In Nearby platform, thread pool should make sure all queued tasks completed
   // in shut down.
   void ShutDown();
 
+  QueueStats GetQueueStats(Priority priority) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
  private:
-  ThreadPool(PTP_POOL thread_pool, TP_CALLBACK_ENVIRON thread_pool_environ,
-             int max_pool_size);
+  struct QueuedTask {
+    Runnable task;
+    absl::Time queued_time;
+  };
+
+  ThreadPool(PTP_POOL thread_pool, int max_pool_size);
   void RunNextTask();
+  void ClosePool() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   // Protects the access to tasks of the thread pool.
   mutable absl::Mutex mutex_;
 
-  // The task queue of the thread pool. Thread pool will pick up task to run
-  // when it is idle.
-  std::queue<Runnable> tasks_ ABSL_GUARDED_BY(mutex_);
+  // The task queues of the thread pool, by priority. Thread pool will pick up
+  // the first task of the highest priority to run when it is idle.
+  std::array<std::queue<QueuedTask>, kPriorityCount> tasks_
+      ABSL_GUARDED_BY(mutex_);
+
+  std::array<QueueStats, kPriorityCount> queue_stats_ ABSL_GUARDED_BY(mutex_);
 
   // Keeps the pointer of the thread pool. It is created when constructing the
   // thread pool.
   PTP_POOL thread_pool_ ABSL_GUARDED_BY(mutex_) = nullptr;
 
-  // Keeps the environment of the thread pool.
-  TP_CALLBACK_ENVIRON thread_pool_environ_ ABSL_GUARDED_BY(mutex_);
+  // Keeps the environments of the thread pool, one per priority, each with
+  // the matching Win32 callback priority.
+  std::array<TP_CALLBACK_ENVIRON, kPriorityCount> thread_pool_environs_;
+
+  // The work objects submitted once per queued task, one per priority. They
+  // are created with the pool and reused for every task.
+  std::array<PTP_WORK, kPriorityCount> works_ = {};
 
   // The maximum thread count in the thread pool
   int max_pool_size_ ABSL_GUARDED_BY(mutex_) = 0;
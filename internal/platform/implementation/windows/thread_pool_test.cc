@@ -15,10 +15,12 @@
 #include "internal/platform/implementation/windows/thread_pool.h"
 
 #include <atomic>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/synchronization/blocking_counter.h"
+#include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 
@@ -79,6 +81,60 @@ TEST(ThreadPool, ShutdownWaitsForRunningTasks) {
   EXPECT_EQ(value, 1);
 }
 
+TEST(ThreadPool, HigherPriorityTasksRunFirst) {
+  auto pool = ThreadPool::Create(1);
+  absl::Notification started;
+  absl::Notification released;
+  absl::BlockingCounter blocking_counter(3);
+  std::vector<std::string> completed_tasks;
+
+  pool->Run([&]() {
+    started.Notify();
+    released.WaitForNotification();
+  });
+  started.WaitForNotification();
+  pool->Run(
+      [&]() {
+        completed_tasks.push_back("low");
+        blocking_counter.DecrementCount();
+      },
+      ThreadPool::Priority::kLow);
+  pool->Run([&]() {
+    completed_tasks.push_back("normal");
+    blocking_counter.DecrementCount();
+  });
+  pool->Run(
+      [&]() {
+        completed_tasks.push_back("high");
+        blocking_counter.DecrementCount();
+      },
+      ThreadPool::Priority::kHigh);
+  released.Notify();
+
+  blocking_counter.Wait();
+  EXPECT_EQ(completed_tasks,
+            std::vector<std::string>({"high", "normal", "low"}));
+  pool->ShutDown();
+}
+
+TEST(ThreadPool, RecordsQueueWaitPerPriority) {
+  auto pool = ThreadPool::Create(/*min_pool_size=*/1, /*max_pool_size=*/1);
+  absl::Notification released;
+
+  pool->Run([&]() { released.WaitForNotification(); });
+  pool->Run([]() {}, ThreadPool::Priority::kLow);
+  absl::SleepFor(absl::Milliseconds(100));
+  released.Notify();
+  pool->ShutDown();
+
+  ThreadPool::QueueStats low_stats =
+      pool->GetQueueStats(ThreadPool::Priority::kLow);
+  EXPECT_EQ(low_stats.run_count, 1);
+  EXPECT_GE(low_stats.max_wait, absl::Milliseconds(100));
+  EXPECT_EQ(pool->GetQueueStats(ThreadPool::Priority::kNormal).run_count, 1);
+  EXPECT_EQ(pool->GetQueueStats(ThreadPool::Priority::kHigh).run_count, 0);
+}
+
 }  // namespace
 }  // namespace windows
 }  // namespace nearby
@@ -31,6 +31,7 @@
 // Nearby connections headers
 #include "internal/platform/implementation/wifi_direct.h"
 #include "internal/platform/implementation/windows/scheduled_executor.h"
+#include "internal/platform/implementation/windows/stream_writer.h"
 
 // ABSL header
 #include "absl/types/optional.h"
@@ -137,6 +138,8 @@ class WifiDirectSocket : public api::WifiDirectSocket {
 
    private:
     IInputStream input_stream_{nullptr};
+    // Reused by the reads instead of allocating one per read.
+    Buffer read_buffer_{nullptr};
   };
 
   // A simple wrapper to handle output stream of socket
@@ -151,6 +154,9 @@ class WifiDirectSocket : public api::WifiDirectSocket {
 
    private:
     IOutputStream output_stream_{nullptr};
+    // Keeps several writes in flight; shared so that the stream stays
+    // copyable.
+    std::shared_ptr<StreamWriter> writer_;
   };
 
   // Internal properties
@@ -39,6 +39,7 @@
 #include "internal/platform/implementation/cancelable.h"
 #include "internal/platform/implementation/wifi_hotspot.h"
 #include "internal/platform/implementation/windows/scheduled_executor.h"
+#include "internal/platform/implementation/windows/stream_writer.h"
 #include "internal/platform/implementation/windows/submittable_executor.h"
 #include "internal/platform/implementation/windows/wifi_hotspot_native.h"
 
@@ -152,6 +153,8 @@ class WifiHotspotSocket : public api::WifiHotspotSocket {
     SOCKET socket_ = INVALID_SOCKET;
     SocketType socket_type_ = SocketType::kWinRTSocket;
     ByteArray read_buffer_;
+    // Reused by the reads of a WinRT socket.
+    Buffer winrt_read_buffer_{nullptr};
   };
 
   // A simple wrapper to handle output stream of socket
@@ -169,6 +172,9 @@ class WifiHotspotSocket : public api::WifiHotspotSocket {
     IOutputStream output_stream_{nullptr};
     SOCKET socket_ = INVALID_SOCKET;
     SocketType socket_type_ = SocketType::kWinRTSocket;
+    // Keeps several writes of a WinRT socket in flight; shared so that the
+    // stream stays copyable.
+    std::shared_ptr<StreamWriter> writer_;
   };
 
   // Internal properties
@@ -12,12 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
-#include <cstring>
 #include <exception>
+#include <memory>
 
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/implementation/windows/stream_writer.h"
 #include "internal/platform/implementation/windows/wifi_hotspot.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/logging.h"
@@ -27,6 +31,15 @@ namespace nearby {
 namespace windows {
 namespace {
 
+using ::winrt::Windows::Foundation::TimeSpan;
+
+// How long closing a socket waits for the writes still in flight.
+constexpr TimeSpan kPendingWritesTimeout = std::chrono::seconds(5);
+
+// The most Skip() reads at a time, so that skipping a large offset doesn't
+// allocate a buffer as large.
+constexpr size_t kSkipChunkSize = 64 * 1024;
+
 int recv_sync(SOCKET s, char* buf, int len, int flags) {
   int result;
   struct fd_set read_fds;
@@ -148,10 +161,16 @@ ExceptionOr<ByteArray> WifiHotspotSocket::SocketInputStream::Read(
     std::int64_t size) {
   try {
     if (socket_type_ == SocketType::kWinRTSocket) {
-      Buffer buffer = Buffer(size);
+      if (winrt_read_buffer_ == nullptr ||
+          winrt_read_buffer_.Capacity() < size) {
+        winrt_read_buffer_ = Buffer(size);
+      }
+      winrt_read_buffer_.Length(0);
 
-      auto ibuffer =
-          input_stream_.ReadAsync(buffer, size, InputStreamOptions::None).get();
+      auto ibuffer = input_stream_
+                         .ReadAsync(winrt_read_buffer_, size,
+                                    InputStreamOptions::None)
+                         .get();
 
       if (ibuffer.Length() != size) {
         LOG(WARNING) << "Only got part of data of needed.";
@@ -200,25 +219,38 @@ ExceptionOr<ByteArray> WifiHotspotSocket::SocketInputStream::Read(
 ExceptionOr<size_t> WifiHotspotSocket::SocketInputStream::Skip(size_t offset) {
   try {
     if (socket_type_ == SocketType::kWinRTSocket) {
-      Buffer buffer = Buffer(offset);
-
-      auto ibuffer =
-          input_stream_.ReadAsync(buffer, offset, InputStreamOptions::None)
-              .get();
-      return ExceptionOr<size_t>((size_t)ibuffer.Length());
+      size_t skipped = 0;
+      while (skipped < offset) {
+        uint32_t chunk_size = std::min(offset - skipped, kSkipChunkSize);
+        if (winrt_read_buffer_ == nullptr ||
+            winrt_read_buffer_.Capacity() < chunk_size) {
+          winrt_read_buffer_ = Buffer(chunk_size);
+        }
+        winrt_read_buffer_.Length(0);
+        auto ibuffer = input_stream_
+                           .ReadAsync(winrt_read_buffer_, chunk_size,
+                                      InputStreamOptions::None)
+                           .get();
+        if (ibuffer.Length() == 0) {
+          break;
+        }
+        skipped += ibuffer.Length();
+      }
+      return ExceptionOr<size_t>(skipped);
     }
     // When socket_type_ == SocketType::kWin32Socket
     int result;
-    int count = 0;
+    size_t count = 0;
 
-    // When socket_type_ == SocketType::kWin32Socket
-    if (offset > read_buffer_.size()) {
-      read_buffer_.resize(offset);
+    if (read_buffer_.size() < kSkipChunkSize) {
+      read_buffer_.resize(kSkipChunkSize);
     }
 
     while (count < offset) {
-      result =
-          recv_sync(socket_, read_buffer_.data() + count, offset - count, 0);
+      // Reads into the start of the buffer, the bytes are dropped anyway.
+      int chunk_size =
+          static_cast<int>(std::min(offset - count, kSkipChunkSize));
+      result = recv_sync(socket_, read_buffer_.data(), chunk_size, 0);
       if (result == 0) {
         LOG(WARNING) << "Connection closed.";
         return {Exception::kIo};
@@ -271,6 +303,7 @@ WifiHotspotSocket::SocketOutputStream::SocketOutputStream(
     IOutputStream output_stream) {
   output_stream_ = output_stream;
   socket_type_ = SocketType::kWinRTSocket;
+  writer_ = std::make_shared<StreamWriter>(output_stream);
 }
 
 WifiHotspotSocket::SocketOutputStream::SocketOutputStream(SOCKET socket) {
@@ -281,12 +314,8 @@ WifiHotspotSocket::SocketOutputStream::SocketOutputStream(SOCKET socket) {
 Exception WifiHotspotSocket::SocketOutputStream::Write(const ByteArray& data) {
   try {
     if (socket_type_ == SocketType::kWinRTSocket) {
-      Buffer buffer = Buffer(data.size());
-      std::memcpy(buffer.data(), data.data(), data.size());
-      buffer.Length(data.size());
-
-      output_stream_.WriteAsync(buffer).get();
-      return {Exception::kSuccess};
+      const ByteArray* buffers[] = {&data};
+      return writer_->Write(buffers);
     }
 
     int result;
@@ -324,6 +353,9 @@ Exception WifiHotspotSocket::SocketOutputStream::Write(const ByteArray& data) {
 Exception WifiHotspotSocket::SocketOutputStream::Flush() {
   try {
     if (socket_type_ == SocketType::kWinRTSocket) {
+      if (Exception error = writer_->WaitForPendingWrites(); error.Raised()) {
+        return error;
+      }
       output_stream_.FlushAsync().get();
     }
     return {Exception::kSuccess};
@@ -343,6 +375,7 @@ Exception WifiHotspotSocket::SocketOutputStream::Flush() {
 Exception WifiHotspotSocket::SocketOutputStream::Close() {
   try {
     if (socket_type_ == SocketType::kWinRTSocket) {
+      writer_->CancelPendingWrites(kPendingWritesTimeout);
       output_stream_.Close();
     } else {
       // When socket_type_ == SocketType::kWin32Socket
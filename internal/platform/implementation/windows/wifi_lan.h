@@ -38,6 +38,7 @@
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/cancellation_flag.h"
 #include "internal/platform/count_down_latch.h"
@@ -45,6 +46,7 @@
 #include "internal/platform/implementation/cancelable.h"
 #include "internal/platform/implementation/wifi_lan.h"
 #include "internal/platform/implementation/windows/scheduled_executor.h"
+#include "internal/platform/implementation/windows/stream_writer.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/nsd_service_info.h"
@@ -145,11 +147,18 @@ class WifiLanSocket : public api::WifiLanSocket {
     ~SocketOutputStream() = default;
 
     Exception Write(const ByteArray& data) override;
+    // Copies all buffers into one WinRT buffer and issues a single
+    // WriteAsync(), instead of one per buffer.
+    Exception Writev(absl::Span<const ByteArray* const> buffers) override;
+    // Waits for the pending writes before flushing the stream.
     Exception Flush() override;
     Exception Close() override;
 
    private:
     IOutputStream output_stream_{nullptr};
+    // Keeps several writes in flight; shared so that the stream stays
+    // copyable.
+    std::shared_ptr<StreamWriter> writer_;
   };
 
   // Internal properties
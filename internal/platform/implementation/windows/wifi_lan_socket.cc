@@ -12,13 +12,18 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstddef>
 #include <cstdint>
-#include <cstring>
 #include <exception>
+#include <memory>
 #include <utility>
 
+#include "absl/types/span.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
+#include "internal/platform/implementation/windows/stream_writer.h"
 #include "internal/platform/implementation/windows/wifi_lan.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/logging.h"
@@ -26,6 +31,18 @@
 
 namespace nearby {
 namespace windows {
+namespace {
+
+using ::winrt::Windows::Foundation::TimeSpan;
+
+// How long closing a socket waits for the writes still in flight.
+constexpr TimeSpan kPendingWritesTimeout = std::chrono::seconds(5);
+
+// The most Skip() reads at a time, so that skipping a large offset doesn't
+// allocate a buffer as large.
+constexpr size_t kSkipChunkSize = 64 * 1024;
+
+}  // namespace
 
 WifiLanSocket::WifiLanSocket(StreamSocket socket) {
   stream_soket_ = socket;
@@ -117,11 +134,23 @@ ExceptionOr<ByteArray> WifiLanSocket::SocketInputStream::Read(
 
 ExceptionOr<size_t> WifiLanSocket::SocketInputStream::Skip(size_t offset) {
   try {
-    Buffer buffer = Buffer(offset);
-
-    auto ibuffer =
-        input_stream_.ReadAsync(buffer, offset, InputStreamOptions::None).get();
-    return ExceptionOr((size_t)ibuffer.Length());
+    size_t skipped = 0;
+    while (skipped < offset) {
+      uint32_t chunk_size = std::min(offset - skipped, kSkipChunkSize);
+      if (read_buffer_ == nullptr || read_buffer_.Capacity() < chunk_size) {
+        read_buffer_ = Buffer(chunk_size);
+      }
+      read_buffer_.Length(0);
+      auto ibuffer =
+          input_stream_
+              .ReadAsync(read_buffer_, chunk_size, InputStreamOptions::None)
+              .get();
+      if (ibuffer.Length() == 0) {
+        break;
+      }
+      skipped += ibuffer.Length();
+    }
+    return ExceptionOr(skipped);
   } catch (std::exception exception) {
     LOG(ERROR) << __func__ << ": Exception: " << exception.what();
     return {Exception::kIo};
@@ -156,34 +185,23 @@ Exception WifiLanSocket::SocketInputStream::Close() {
 WifiLanSocket::SocketOutputStream::SocketOutputStream(
     IOutputStream output_stream) {
   output_stream_ = output_stream;
+  writer_ = std::make_shared<StreamWriter>(output_stream);
 }
 
 Exception WifiLanSocket::SocketOutputStream::Write(const ByteArray& data) {
-  try {
-    Buffer buffer = Buffer(data.size());
-    std::memcpy(buffer.data(), data.data(), data.size());
-    buffer.Length(data.size());
-    uint32_t wrote_bytes = output_stream_.WriteAsync(buffer).get();
-    if (wrote_bytes != data.size()) {
-      LOG(WARNING) << "Only wrote partial of data:[" << wrote_bytes << "/"
-                   << data.size() << "].";
-    }
+  const ByteArray* buffers[] = {&data};
+  return writer_->Write(buffers);
+}
 
-    return {Exception::kSuccess};
-  } catch (std::exception exception) {
-    LOG(ERROR) << __func__ << ": Exception: " << exception.what();
-    return {Exception::kIo};
-  } catch (const winrt::hresult_error& error) {
-    LOG(ERROR) << __func__ << ": WinRT exception: " << error.code() << ": "
-               << winrt::to_string(error.message());
-    return {Exception::kIo};
-  } catch (...) {
-    LOG(ERROR) << __func__ << ": Unknown exeption.";
-    return {Exception::kIo};
-  }
+Exception WifiLanSocket::SocketOutputStream::Writev(
+    absl::Span<const ByteArray* const> buffers) {
+  return writer_->Write(buffers);
 }
 
 Exception WifiLanSocket::SocketOutputStream::Flush() {
+  if (Exception error = writer_->WaitForPendingWrites(); error.Raised()) {
+    return error;
+  }
   try {
     output_stream_.FlushAsync().get();
     return {Exception::kSuccess};
@@ -201,6 +219,7 @@ Exception WifiLanSocket::SocketOutputStream::Flush() {
 }
 
 Exception WifiLanSocket::SocketOutputStream::Close() {
+  writer_->CancelPendingWrites(kPendingWritesTimeout);
   try {
     output_stream_.Close();
     return {Exception::kSuccess};
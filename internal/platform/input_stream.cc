@@ -74,4 +74,21 @@ ExceptionOr<ByteArray> InputStream::ReadExactly(std::size_t size) {
 
   return ExceptionOr<ByteArray>(std::move(buffer));
 }
+
+ExceptionOr<ByteArray> InputStream::ReadLengthPrefixedFrame(
+    std::int32_t max_size) {
+  ExceptionOr<ByteArray> header = ReadExactly(sizeof(std::int32_t));
+  if (!header.ok()) {
+    return header;
+  }
+  const char* bytes = header.result().data();
+  std::int32_t size = 0;
+  for (size_t i = 0; i < sizeof(std::int32_t); i++) {
+    size = (size << 8) | (static_cast<std::int32_t>(bytes[i]) & 0x0FF);
+  }
+  if (size < 0 || size > max_size) {
+    return ExceptionOr<ByteArray>(Exception::kIo);
+  }
+  return ReadExactly(size);
+}
 }  // namespace nearby
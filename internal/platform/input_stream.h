@@ -44,6 +44,15 @@ class InputStream {
   // `size` bytes.
   ExceptionOr<ByteArray> ReadExactly(std::size_t size);
 
+  // Reads a frame made of a 4-byte big-endian length, of at most `max_size`,
+  // and that many bytes, and returns the bytes after the length.
+  // Implementations backed by a message-oriented transport, where a frame
+  // usually arrives as one message, should override this to hand out the
+  // message without reparsing it; the default reads the length and then the
+  // bytes with ReadExactly().
+  // Returns Exception::kIo on error, or if the length is out of range.
+  virtual ExceptionOr<ByteArray> ReadLengthPrefixedFrame(std::int32_t max_size);
+
   // throws Exception::kIo
   virtual Exception Close() = 0;
 };
@@ -115,5 +115,27 @@ TEST(InputStreamTest, ReadExactlyFailsOnError) {
   EXPECT_EQ(result.exception(), Exception::kIo);
 }
 
+TEST(InputStreamTest, ReadLengthPrefixedFrame) {
+  NiceMock<TestInputStream> stream;
+  InSequence seq;
+  EXPECT_CALL(stream, Read(4))
+      .WillOnce(Return(ExceptionOr<ByteArray>(ByteArray("\0\0\0\x0a", 4))));
+  EXPECT_CALL(stream, Read(10)).WillOnce(Return(Range(0, 10)));
+
+  ExceptionOr<ByteArray> result = stream.ReadLengthPrefixedFrame(10);
+
+  EXPECT_EQ(result, Range(0, 10));
+}
+
+TEST(InputStreamTest, ReadLengthPrefixedFrameFailsOnTooLongFrame) {
+  NiceMock<TestInputStream> stream;
+  EXPECT_CALL(stream, Read(4))
+      .WillOnce(Return(ExceptionOr<ByteArray>(ByteArray("\0\0\0\x0b", 4))));
+
+  ExceptionOr<ByteArray> result = stream.ReadLengthPrefixedFrame(10);
+
+  EXPECT_EQ(result.exception(), Exception::kIo);
+}
+
 }  // namespace
 }  // namespace nearby
@@ -0,0 +1,176 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "internal/platform/lock_profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/flags/nearby_flags.h"
+#include "internal/platform/flags/nearby_platform_feature_flags.h"
+#include "internal/platform/implementation/mutex.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+namespace {
+
+void UpdateMax(std::atomic<int64_t>& max, int64_t value) {
+  int64_t current = max.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max.compare_exchange_weak(current, value,
+                                    std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace
+
+std::atomic<bool> LockProfiler::enabled_{false};
+
+void LockProfiler::Site::RecordAcquisition(bool contended,
+                                           absl::Duration wait) {
+  acquisitions_.fetch_add(1, std::memory_order_relaxed);
+  if (!contended) return;
+  int64_t wait_nanos = absl::ToInt64Nanoseconds(wait);
+  contentions_.fetch_add(1, std::memory_order_relaxed);
+  total_wait_nanos_.fetch_add(wait_nanos, std::memory_order_relaxed);
+  UpdateMax(max_wait_nanos_, wait_nanos);
+}
+
+void LockProfiler::Site::RecordHold(absl::Duration hold) {
+  int64_t hold_nanos = absl::ToInt64Nanoseconds(hold);
+  total_hold_nanos_.fetch_add(hold_nanos, std::memory_order_relaxed);
+  UpdateMax(max_hold_nanos_, hold_nanos);
+}
+
+LockProfiler::LockReport LockProfiler::Site::GetReport() const {
+  LockReport report;
+  report.name = name_;
+  report.acquisitions = acquisitions_.load(std::memory_order_relaxed);
+  report.contentions = contentions_.load(std::memory_order_relaxed);
+  report.total_wait =
+      absl::Nanoseconds(total_wait_nanos_.load(std::memory_order_relaxed));
+  report.max_wait =
+      absl::Nanoseconds(max_wait_nanos_.load(std::memory_order_relaxed));
+  report.total_hold =
+      absl::Nanoseconds(total_hold_nanos_.load(std::memory_order_relaxed));
+  report.max_hold =
+      absl::Nanoseconds(max_hold_nanos_.load(std::memory_order_relaxed));
+  return report;
+}
+
+void LockProfiler::Site::Reset() {
+  acquisitions_.store(0, std::memory_order_relaxed);
+  contentions_.store(0, std::memory_order_relaxed);
+  total_wait_nanos_.store(0, std::memory_order_relaxed);
+  max_wait_nanos_.store(0, std::memory_order_relaxed);
+  total_hold_nanos_.store(0, std::memory_order_relaxed);
+  max_hold_nanos_.store(0, std::memory_order_relaxed);
+}
+
+LockProfiler& LockProfiler::GetInstance() {
+  static LockProfiler* instance = new LockProfiler();
+  return *instance;
+}
+
+LockProfiler::LockProfiler() {
+  if (NearbyFlags::GetInstance().GetBoolFlag(
+          platform::config_package_nearby::nearby_platform_feature::
+              kEnableLockProfiling)) {
+    SetEnabled(true);
+  }
+}
+
+void LockProfiler::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void LockProfiler::Tracker::Lock(api::Mutex& mutex) {
+  absl::Time lock_time = absl::InfinitePast();
+  if (!IsEnabled()) {
+    mutex.Lock();
+  } else if (mutex.TryLock()) {
+    site_->RecordAcquisition(/*contended=*/false, absl::ZeroDuration());
+    lock_time = SystemClock::ElapsedRealtime();
+  } else {
+    absl::Time start = SystemClock::ElapsedRealtime();
+    mutex.Lock();
+    lock_time = SystemClock::ElapsedRealtime();
+    site_->RecordAcquisition(/*contended=*/true, lock_time - start);
+  }
+  if (depth_++ == 0) lock_time_ = lock_time;
+}
+
+void LockProfiler::Tracker::Unlock(api::Mutex& mutex) {
+  if (--depth_ == 0) EndHold();
+  mutex.Unlock();
+}
+
+void LockProfiler::Tracker::OnWaitStart() { EndHold(); }
+
+void LockProfiler::Tracker::OnWaitEnd() {
+  if (IsEnabled()) lock_time_ = SystemClock::ElapsedRealtime();
+}
+
+void LockProfiler::Tracker::EndHold() {
+  if (lock_time_ == absl::InfinitePast()) return;
+  site_->RecordHold(SystemClock::ElapsedRealtime() - lock_time_);
+  lock_time_ = absl::InfinitePast();
+}
+
+std::unique_ptr<LockProfiler::Tracker> LockProfiler::CreateTracker(
+    absl::string_view name) {
+  return std::make_unique<Tracker>(GetSite(name));
+}
+
+LockProfiler::Site* LockProfiler::GetSite(absl::string_view name) {
+  absl::MutexLock lock(&mutex_);
+  std::unique_ptr<Site>& site = sites_[name];
+  if (site == nullptr) {
+    site = std::make_unique<Site>(std::string(name));
+  }
+  return site.get();
+}
+
+std::vector<LockProfiler::LockReport> LockProfiler::GetReport() const {
+  std::vector<LockReport> reports;
+  {
+    absl::MutexLock lock(&mutex_);
+    reports.reserve(sites_.size());
+    for (const auto& [name, site] : sites_) {
+      reports.push_back(site->GetReport());
+    }
+  }
+  std::sort(reports.begin(), reports.end(),
+            [](const LockReport& a, const LockReport& b) {
+              return a.total_wait > b.total_wait;
+            });
+  return reports;
+}
+
+void LockProfiler::Reset() {
+  absl::MutexLock lock(&mutex_);
+  for (auto& [name, site] : sites_) {
+    site->Reset();
+  }
+}
+
+}  // namespace nearby
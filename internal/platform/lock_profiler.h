@@ -0,0 +1,135 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef PLATFORM_PUBLIC_LOCK_PROFILER_H_
+#define PLATFORM_PUBLIC_LOCK_PROFILER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/implementation/mutex.h"
+
+namespace nearby {
+
+// Collects wait and hold times of named `Mutex` and `RecursiveMutex`
+// instances. All locks created with the same name share one entry.
+//
+// Profiling is off unless the kEnableLockProfiling platform flag is set or
+// SetEnabled(true) is called. Unnamed locks are never profiled; named locks
+// check one atomic per acquisition while profiling is off.
+class LockProfiler {
+ public:
+  struct LockReport {
+    std::string name;
+    int64_t acquisitions = 0;
+    // Acquisitions that found the lock held by another thread.
+    int64_t contentions = 0;
+    absl::Duration total_wait = absl::ZeroDuration();
+    absl::Duration max_wait = absl::ZeroDuration();
+    absl::Duration total_hold = absl::ZeroDuration();
+    absl::Duration max_hold = absl::ZeroDuration();
+  };
+
+  // The counters of one lock name.
+  class Site {
+   public:
+    explicit Site(std::string name) : name_(std::move(name)) {}
+    Site(const Site&) = delete;
+    Site& operator=(const Site&) = delete;
+
+    void RecordAcquisition(bool contended, absl::Duration wait);
+    void RecordHold(absl::Duration hold);
+
+    LockReport GetReport() const;
+    void Reset();
+
+   private:
+    const std::string name_;
+    std::atomic<int64_t> acquisitions_{0};
+    std::atomic<int64_t> contentions_{0};
+    std::atomic<int64_t> total_wait_nanos_{0};
+    std::atomic<int64_t> max_wait_nanos_{0};
+    std::atomic<int64_t> total_hold_nanos_{0};
+    std::atomic<int64_t> max_hold_nanos_{0};
+  };
+
+  static LockProfiler& GetInstance();
+
+  // The profiling state of one named lock. It lives on the heap, so that it
+  // stays put when the lock is moved.
+  class Tracker {
+   public:
+    explicit Tracker(Site* site) : site_(site) {}
+    Tracker(const Tracker&) = delete;
+    Tracker& operator=(const Tracker&) = delete;
+
+    void Lock(api::Mutex& mutex) ABSL_EXCLUSIVE_LOCK_FUNCTION(mutex);
+    void Unlock(api::Mutex& mutex) ABSL_UNLOCK_FUNCTION(mutex);
+
+    // A condition variable wait releases the lock, so it doesn't count as
+    // hold time.
+    void OnWaitStart();
+    void OnWaitEnd();
+
+   private:
+    void EndHold();
+
+    Site* const site_;
+    // Only touched by the thread holding the lock. Above 1 for a recursive
+    // lock acquired again by its holder.
+    int depth_ = 0;
+    // When the outermost Lock() returned, if it was profiled.
+    absl::Time lock_time_ = absl::InfinitePast();
+  };
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void SetEnabled(bool enabled);
+
+  // Creates the tracker of a new lock named `name`.
+  std::unique_ptr<Tracker> CreateTracker(absl::string_view name)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the counters of every lock name, the longest total wait first.
+  std::vector<LockReport> GetReport() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Zeroes the counters of every lock name.
+  void Reset() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  LockProfiler();
+
+  // Returns the site of `name`. Sites live as long as the process.
+  Site* GetSite(absl::string_view name) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  static std::atomic<bool> enabled_;
+
+  // Not a nearby::Mutex, which may report here.
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, std::unique_ptr<Site>> sites_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_PUBLIC_LOCK_PROFILER_H_
@@ -0,0 +1,162 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "internal/platform/lock_profiler.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+namespace {
+
+constexpr absl::Duration kTimeout = absl::Seconds(5);
+
+std::optional<LockProfiler::LockReport> FindReport(const std::string& name) {
+  for (const LockProfiler::LockReport& report :
+       LockProfiler::GetInstance().GetReport()) {
+    if (report.name == name) return report;
+  }
+  return std::nullopt;
+}
+
+class LockProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    LockProfiler::GetInstance().Reset();
+    LockProfiler::SetEnabled(true);
+  }
+  void TearDown() override { LockProfiler::SetEnabled(false); }
+};
+
+TEST_F(LockProfilerTest, RecordsNothingWhileDisabled) {
+  LockProfiler::SetEnabled(false);
+  Mutex mutex("RecordsNothingWhileDisabled");
+
+  { MutexLock lock(&mutex); }
+
+  std::optional<LockProfiler::LockReport> report =
+      FindReport("RecordsNothingWhileDisabled");
+  ASSERT_TRUE(report.has_value());
+  EXPECT_EQ(report->acquisitions, 0);
+}
+
+TEST_F(LockProfilerTest, RecordsAcquisitionsAndHoldTime) {
+  Mutex mutex("RecordsAcquisitionsAndHoldTime");
+
+  {
+    MutexLock lock(&mutex);
+    absl::SleepFor(absl::Milliseconds(20));
+  }
+  { MutexLock lock(&mutex); }
+
+  std::optional<LockProfiler::LockReport> report =
+      FindReport("RecordsAcquisitionsAndHoldTime");
+  ASSERT_TRUE(report.has_value());
+  EXPECT_EQ(report->acquisitions, 2);
+  EXPECT_EQ(report->contentions, 0);
+  EXPECT_GE(report->total_hold, absl::Milliseconds(20));
+  EXPECT_GE(report->max_hold, absl::Milliseconds(20));
+}
+
+TEST_F(LockProfilerTest, RecordsContention) {
+  Mutex mutex("RecordsContention");
+  CountDownLatch locked(1);
+  SingleThreadExecutor executor;
+
+  executor.Execute([&mutex, &locked]() {
+    MutexLock lock(&mutex);
+    locked.CountDown();
+    absl::SleepFor(absl::Milliseconds(50));
+  });
+  ASSERT_TRUE(locked.Await(kTimeout).result());
+  { MutexLock lock(&mutex); }
+  executor.Shutdown();
+
+  std::optional<LockProfiler::LockReport> report =
+      FindReport("RecordsContention");
+  ASSERT_TRUE(report.has_value());
+  EXPECT_EQ(report->acquisitions, 2);
+  EXPECT_EQ(report->contentions, 1);
+  EXPECT_GT(report->total_wait, absl::ZeroDuration());
+  EXPECT_EQ(report->total_wait, report->max_wait);
+}
+
+TEST_F(LockProfilerTest, RecursiveMutexHoldEndsWithOutermostUnlock) {
+  RecursiveMutex mutex("RecursiveMutexHoldEndsWithOutermostUnlock");
+
+  {
+    MutexLock outer(&mutex);
+    { MutexLock inner(&mutex); }
+    absl::SleepFor(absl::Milliseconds(20));
+  }
+
+  std::optional<LockProfiler::LockReport> report =
+      FindReport("RecursiveMutexHoldEndsWithOutermostUnlock");
+  ASSERT_TRUE(report.has_value());
+  EXPECT_EQ(report->acquisitions, 2);
+  EXPECT_EQ(report->contentions, 0);
+  EXPECT_GE(report->max_hold, absl::Milliseconds(20));
+}
+
+TEST_F(LockProfilerTest, ConditionVariableWaitIsNotHoldTime) {
+  Mutex mutex("ConditionVariableWaitIsNotHoldTime");
+  ConditionVariable condition(&mutex);
+
+  {
+    MutexLock lock(&mutex);
+    condition.Wait(absl::Milliseconds(50));
+  }
+
+  std::optional<LockProfiler::LockReport> report =
+      FindReport("ConditionVariableWaitIsNotHoldTime");
+  ASSERT_TRUE(report.has_value());
+  EXPECT_LT(report->total_hold, absl::Milliseconds(50));
+}
+
+TEST_F(LockProfilerTest, LocksWithTheSameNameShareAReport) {
+  Mutex first("LocksWithTheSameNameShareAReport");
+  Mutex second("LocksWithTheSameNameShareAReport");
+
+  { MutexLock lock(&first); }
+  { MutexLock lock(&second); }
+
+  std::optional<LockProfiler::LockReport> report =
+      FindReport("LocksWithTheSameNameShareAReport");
+  ASSERT_TRUE(report.has_value());
+  EXPECT_EQ(report->acquisitions, 2);
+}
+
+TEST_F(LockProfilerTest, UnnamedMutexIsNotReported) {
+  std::vector<LockProfiler::LockReport> before =
+      LockProfiler::GetInstance().GetReport();
+  Mutex mutex;
+
+  { MutexLock lock(&mutex); }
+
+  EXPECT_EQ(LockProfiler::GetInstance().GetReport().size(), before.size());
+}
+
+}  // namespace
+}  // namespace nearby
@@ -31,7 +31,26 @@
 // Public APIs
 // The stream statement must come last, or it won't compile.
 #define NEARBY_VLOG(level) VLOG(level)
+#if defined(NEARBY_CHROMIUM)
 #define NEARBY_LOGS(severity) LOG(severity)
+#else  // defined(NEARBY_CHROMIUM)
+// absl evaluates the stream of a LOG(severity) statement below the minimum
+// log level, and only drops the message afterwards. NEARBY_LOGS skips the
+// statement instead, so that arguments aren't formatted for nothing.
+#define NEARBY_LOGS(severity) NEARBY_LOGS_INTERNAL_##severity
+// The severity must reach LOG_IF unexpanded, since Windows headers define
+// ERROR as a macro.
+#define NEARBY_LOGS_INTERNAL_INFO \
+  LOG_IF(INFO, ::absl::LogSeverity::kInfo >= ::absl::MinLogLevel())
+#define NEARBY_LOGS_INTERNAL_WARNING \
+  LOG_IF(WARNING, ::absl::LogSeverity::kWarning >= ::absl::MinLogLevel())
+#define NEARBY_LOGS_INTERNAL_ERROR \
+  LOG_IF(ERROR, ::absl::LogSeverity::kError >= ::absl::MinLogLevel())
+// Must stay a plain LOG(FATAL), which the compiler knows doesn't return.
+#define NEARBY_LOGS_INTERNAL_FATAL LOG(FATAL)
+// Chromium's LOG(VERBOSE) is VLOG(1); absl has no VERBOSE severity.
+#define NEARBY_LOGS_INTERNAL_VERBOSE VLOG(1)
+#endif  // defined(NEARBY_CHROMIUM)
 
 #define NEARBY_DLOG(severity) DLOG(severity)
 #define NEARBY_DVLOG(severity) DVLOG(severity)
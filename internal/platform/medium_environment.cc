@@ -23,6 +23,7 @@
 #include <utility>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/random/random.h"
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_format.h"
@@ -43,11 +44,13 @@
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/nsd_service_info.h"
+#include "internal/platform/pipe.h"
 #include "internal/platform/prng.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/uuid.h"
 #include "internal/platform/wifi_credential.h"
 #include "internal/test/fake_clock.h"
+#include "proto/connections_enums.pb.h"
 
 namespace nearby {
 
@@ -99,6 +102,7 @@ void MediumEnvironment::Reset() {
       MutexLock lock(&mutex_);
       wifi_direct_mediums_.clear();
       wifi_hotspot_mediums_.clear();
+      link_shaping_.clear();
     }
     use_valid_peer_connection_ = true;
     peer_connection_latency_ = absl::ZeroDuration();
@@ -805,17 +809,44 @@ void MediumEnvironment::UnregisterWebRtcSignalingMessenger(
 void MediumEnvironment::SendWebRtcSignalingMessage(absl::string_view peer_id,
                                                    const ByteArray& message) {
   if (!enabled_) return;
-  RunOnMediumEnvironmentThread(
-      [this, peer_id{std::string(peer_id)}, message]() {
-        auto item = webrtc_signaling_message_callback_.find(peer_id);
-        if (item == webrtc_signaling_message_callback_.end()) {
-          NEARBY_LOGS(WARNING)
-              << "No callback registered for peer id = " << peer_id;
-          return;
-        }
+  // Signaling messages are datagrams, so they may be lost and reordered as
+  // well as delayed.
+  absl::Duration delay;
+  {
+    MutexLock lock(&mutex_);
+    LinkShaping shaping;
+    auto it = link_shaping_.find(location::nearby::proto::connections::WEB_RTC);
+    if (it != link_shaping_.end()) shaping = it->second;
+    if (absl::Bernoulli(bit_gen_, shaping.drop_probability)) {
+      NEARBY_LOGS(INFO) << "Dropped WebRTC signaling message for peer id = "
+                        << peer_id;
+      return;
+    }
+    delay =
+        shaping.latency + shaping.jitter * absl::Uniform(bit_gen_, 0.0, 1.0);
+    if (absl::Bernoulli(bit_gen_, shaping.reorder_probability)) {
+      delay += shaping.reorder_delay;
+    }
+  }
+  Runnable deliver = [this, peer_id{std::string(peer_id)}, message]() {
+    auto item = webrtc_signaling_message_callback_.find(peer_id);
+    if (item == webrtc_signaling_message_callback_.end()) {
+      NEARBY_LOGS(WARNING) << "No callback registered for peer id = "
+                           << peer_id;
+      return;
+    }
 
-        item->second(message);
-      });
+    item->second(message);
+  };
+  if (delay <= absl::ZeroDuration()) {
+    RunOnMediumEnvironmentThread(std::move(deliver));
+    return;
+  }
+  link_delay_executor_.Schedule(
+      [this, deliver = std::move(deliver)]() mutable {
+        if (enabled_) RunOnMediumEnvironmentThread(std::move(deliver));
+      },
+      delay);
 }
 
 void MediumEnvironment::SendWebRtcSignalingComplete(absl::string_view peer_id,
@@ -852,6 +883,20 @@ absl::Duration MediumEnvironment::GetPeerConnectionLatency() {
   return peer_connection_latency_;
 }
 
+void MediumEnvironment::SetLinkShaping(
+    location::nearby::proto::connections::Medium medium, LinkShaping shaping) {
+  MutexLock lock(&mutex_);
+  link_shaping_[medium] = shaping;
+}
+
+LinkShaping MediumEnvironment::GetLinkShaping(
+    location::nearby::proto::connections::Medium medium) {
+  MutexLock lock(&mutex_);
+  auto it = link_shaping_.find(medium);
+  if (it == link_shaping_.end()) return {};
+  return it->second;
+}
+
 std::string MediumEnvironment::GetFakeIPAddress() const {
   std::string ip_address;
   ip_address.resize(4);
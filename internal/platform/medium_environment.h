@@ -24,6 +24,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/random/random.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "absl/types/optional.h"
@@ -46,8 +47,11 @@
 #include "internal/platform/implementation/wifi_lan.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/nsd_service_info.h"
+#include "internal/platform/pipe.h"
+#include "internal/platform/scheduled_executor.h"
 #include "internal/platform/single_thread_executor.h"
 #include "internal/platform/wifi_credential.h"
+#include "proto/connections_enums.pb.h"
 
 namespace nearby {
 
@@ -193,6 +197,16 @@ class MediumEnvironment {
 
   absl::Duration GetPeerConnectionLatency();
 
+  // Sets the link profile of `medium`. It shapes the sockets of `medium`
+  // created from now on, and, for WEB_RTC, delays, drops and reorders the
+  // signaling messages sent from now on. Cleared by Reset().
+  void SetLinkShaping(location::nearby::proto::connections::Medium medium,
+                      LinkShaping shaping);
+
+  // Returns the shaping of the sockets of `medium`, none if it wasn't set.
+  LinkShaping GetLinkShaping(
+      location::nearby::proto::connections::Medium medium);
+
   // Adds medium-related info to allow for scanning/advertising to work.
   // This provides access to this medium from other mediums, when protocol
   // expects they should communicate.
@@ -490,6 +504,8 @@ class MediumEnvironment {
   std::atomic_int job_count_ = 0;
   std::atomic_bool enable_notifications_ = false;
   SingleThreadExecutor executor_;
+  // Holds back datagrams for the latency of their link.
+  ScheduledExecutor link_delay_executor_;
   EnvironmentConfig config_;
 
   // The following data members are accessed in the context of a private
@@ -526,6 +542,10 @@ class MediumEnvironment {
 
   bool use_valid_peer_connection_ = true;
   absl::Duration peer_connection_latency_ = absl::ZeroDuration();
+  absl::flat_hash_map<location::nearby::proto::connections::Medium,
+                      LinkShaping>
+      link_shaping_ ABSL_GUARDED_BY(mutex_);
+  absl::BitGen bit_gen_ ABSL_GUARDED_BY(mutex_);
   std::unique_ptr<FakeClock> simulated_clock_ ABSL_GUARDED_BY(mutex_);
   ObserverList<api::BluetoothClassicMedium::Observer> observers_;
   bool ble_extended_advertisements_available_ = false;
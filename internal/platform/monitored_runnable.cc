@@ -16,9 +16,12 @@
 
 #include <utility>
 
+#include "absl/strings/string_view.h"
+
 // TODO: Support thread status
 #include "internal/platform/logging.h"
 #include "internal/platform/pending_job_registry.h"
+#include "internal/platform/trace_event.h"
 
 #define SET_THREAD_STATUS(NAME)
 
@@ -34,26 +37,40 @@ MonitoredRunnable::MonitoredRunnable(Runnable&& runnable)
 MonitoredRunnable::MonitoredRunnable(const std::string& name,
                                      Runnable&& runnable)
     : name_{name}, runnable_{std::move(runnable)} {
-  PendingJobRegistry::GetInstance().AddPendingJob(name_, post_time_);
+  job_id_ = PendingJobRegistry::GetInstance().AddPendingJob(name_, post_time_);
+}
+
+MonitoredRunnable::MonitoredRunnable(MonitoredRunnable&& other)
+    : name_{other.name_},
+      runnable_{std::move(other.runnable_)},
+      post_time_{other.post_time_},
+      job_id_{other.job_id_} {
+  other.job_id_ = PendingJobRegistry::kUntrackedJob;
+}
+
+MonitoredRunnable::~MonitoredRunnable() {
+  PendingJobRegistry::GetInstance().RemoveJob(job_id_);
 }
 
 void MonitoredRunnable::operator()() {
   SET_THREAD_STATUS(name_.c_str());
+  NEARBY_TRACE_EVENT("executor",
+                     name_.empty() ? absl::string_view("Task") : name_);
   auto start_time = SystemClock::ElapsedRealtime();
   auto start_delay = start_time - post_time_;
   if (start_delay >= kMinReportedStartDelay) {
     NEARBY_LOGS(INFO) << "Task: \"" << name_ << "\" started after "
                       << absl::ToInt64Seconds(start_delay) << " seconds";
   }
-  PendingJobRegistry::GetInstance().RemovePendingJob(name_, post_time_);
-  PendingJobRegistry::GetInstance().AddRunningJob(name_, post_time_);
+  PendingJobRegistry::GetInstance().SetJobRunning(job_id_);
   runnable_();
   auto task_duration = SystemClock::ElapsedRealtime() - start_time;
   if (task_duration >= kMinReportedTaskDuration) {
     NEARBY_LOGS(INFO) << "Task: \"" << name_ << "\" finished after "
                       << absl::ToInt64Seconds(task_duration) << " seconds";
   }
-  PendingJobRegistry::GetInstance().RemoveRunningJob(name_, post_time_);
+  PendingJobRegistry::GetInstance().RemoveJob(job_id_);
+  job_id_ = PendingJobRegistry::kUntrackedJob;
   PendingJobRegistry::GetInstance().ListJobs();
 }
 
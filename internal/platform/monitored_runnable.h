@@ -18,6 +18,7 @@
 #include <string>
 
 #include "absl/time/time.h"
+#include "internal/platform/pending_job_registry.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/system_clock.h"
 
@@ -31,6 +32,10 @@ class MonitoredRunnable {
  public:
   explicit MonitoredRunnable(Runnable&& runnable);
   MonitoredRunnable(const std::string& name, Runnable&& runnable);
+  MonitoredRunnable(MonitoredRunnable&& other);
+  MonitoredRunnable& operator=(MonitoredRunnable&&) = delete;
+  // Unregisters the task if it is dropped without running.
+  ~MonitoredRunnable();
 
   void operator()();
 
@@ -38,6 +43,7 @@ class MonitoredRunnable {
   const std::string name_;
   Runnable runnable_;
   absl::Time post_time_ = SystemClock::ElapsedRealtime();
+  PendingJobRegistry::JobId job_id_ = PendingJobRegistry::kUntrackedJob;
 };
 
 }  // namespace nearby
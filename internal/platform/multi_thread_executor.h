@@ -15,6 +15,9 @@
 #ifndef PLATFORM_PUBLIC_MULTI_THREAD_EXECUTOR_H_
 #define PLATFORM_PUBLIC_MULTI_THREAD_EXECUTOR_H_
 
+#include <string>
+#include <utility>
+
 #include "absl/base/thread_annotations.h"
 #include "internal/platform/implementation/platform.h"
 #include "internal/platform/submittable_executor.h"
@@ -31,6 +34,12 @@ class ABSL_LOCKABLE MultiThreadExecutor final : public SubmittableExecutor {
   explicit MultiThreadExecutor(int max_parallelism)
       : SubmittableExecutor(
             Platform::CreateMultiThreadExecutor(max_parallelism)) {}
+  // Creates an executor that reports its stats under `name`, see
+  // `ExecutorStatsRegistry`.
+  MultiThreadExecutor(int max_parallelism, std::string name)
+      : SubmittableExecutor(
+            Platform::CreateMultiThreadExecutor(max_parallelism),
+            std::move(name)) {}
   MultiThreadExecutor(MultiThreadExecutor&&) = default;
   MultiThreadExecutor& operator=(MultiThreadExecutor&&) = default;
   ~MultiThreadExecutor() override = default;
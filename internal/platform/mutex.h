@@ -20,6 +20,7 @@
 #include "absl/base/thread_annotations.h"
 #include "internal/platform/implementation/mutex.h"
 #include "internal/platform/implementation/platform.h"
+#include "internal/platform/lock_profiler.h"
 
 namespace nearby {
 
@@ -35,17 +36,35 @@ class ABSL_LOCKABLE Mutex final {
       : impl_(api::ImplementationPlatform::CreateMutex(
             check ? api::Mutex::Mode::kRegular
                   : api::Mutex::Mode::kRegularNoCheck)) {}
+  // Creates a mutex whose wait and hold times are reported to `LockProfiler`
+  // under `name`.
+  explicit Mutex(const char* name, bool check = true) : Mutex(check) {
+    tracker_ = LockProfiler::GetInstance().CreateTracker(name);
+  }
   Mutex(Mutex&&) = default;
   Mutex& operator=(Mutex&&) = default;
   ~Mutex() = default;
 
-  void Lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() { impl_->Lock(); }
-  void Unlock() ABSL_UNLOCK_FUNCTION() { impl_->Unlock(); }
+  void Lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() {
+    if (tracker_) {
+      tracker_->Lock(*impl_);
+    } else {
+      impl_->Lock();
+    }
+  }
+  void Unlock() ABSL_UNLOCK_FUNCTION() {
+    if (tracker_) {
+      tracker_->Unlock(*impl_);
+    } else {
+      impl_->Unlock();
+    }
+  }
 
  private:
   friend class ConditionVariable;
-  friend class MutexLock;
   std::unique_ptr<api::Mutex> impl_;
+  // Only set for named mutexes.
+  std::unique_ptr<LockProfiler::Tracker> tracker_;
 };
 
 // This mutex is compatible with Java definition:
@@ -59,16 +78,35 @@ class ABSL_LOCKABLE RecursiveMutex final {
   RecursiveMutex()
       : impl_(api::ImplementationPlatform::CreateMutex(
             api::Mutex::Mode::kRecursive)) {}
+  // Creates a mutex whose wait and hold times are reported to `LockProfiler`
+  // under `name`. The hold time runs from the outermost Lock() to the
+  // matching Unlock().
+  explicit RecursiveMutex(const char* name) : RecursiveMutex() {
+    tracker_ = LockProfiler::GetInstance().CreateTracker(name);
+  }
   RecursiveMutex(RecursiveMutex&&) = default;
   RecursiveMutex& operator=(RecursiveMutex&&) = default;
   ~RecursiveMutex() = default;
 
-  void Lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() { impl_->Lock(); }
-  void Unlock() ABSL_UNLOCK_FUNCTION() { impl_->Unlock(); }
+  void Lock() ABSL_EXCLUSIVE_LOCK_FUNCTION() {
+    if (tracker_) {
+      tracker_->Lock(*impl_);
+    } else {
+      impl_->Lock();
+    }
+  }
+  void Unlock() ABSL_UNLOCK_FUNCTION() {
+    if (tracker_) {
+      tracker_->Unlock(*impl_);
+    } else {
+      impl_->Unlock();
+    }
+  }
 
  private:
-  friend class MutexLock;
   std::unique_ptr<api::Mutex> impl_;
+  // Only set for named mutexes.
+  std::unique_ptr<LockProfiler::Tracker> tracker_;
 };
 
 #pragma pop_macro("CreateMutex")
@@ -16,7 +16,6 @@
 #define PLATFORM_PUBLIC_MUTEX_LOCK_H_
 
 #include "absl/base/thread_annotations.h"
-#include "internal/platform/implementation/mutex.h"
 #include "internal/platform/mutex.h"
 
 namespace nearby {
@@ -25,17 +24,24 @@ namespace nearby {
 class ABSL_SCOPED_LOCKABLE MutexLock final {
  public:
   explicit MutexLock(Mutex* mutex) ABSL_EXCLUSIVE_LOCK_FUNCTION(mutex)
-      : mutex_(mutex->impl_.get()) {
+      : mutex_(mutex) {
     mutex_->Lock();
   }
   explicit MutexLock(RecursiveMutex* mutex) ABSL_EXCLUSIVE_LOCK_FUNCTION(mutex)
-      : mutex_(mutex->impl_.get()) {
-    mutex_->Lock();
+      : recursive_mutex_(mutex) {
+    recursive_mutex_->Lock();
+  }
+  ~MutexLock() ABSL_UNLOCK_FUNCTION() {
+    if (mutex_ != nullptr) {
+      mutex_->Unlock();
+    } else {
+      recursive_mutex_->Unlock();
+    }
   }
-  ~MutexLock() ABSL_UNLOCK_FUNCTION() { mutex_->Unlock(); }
 
  private:
-  api::Mutex* mutex_;
+  Mutex* mutex_ = nullptr;
+  RecursiveMutex* recursive_mutex_ = nullptr;
 };
 
 }  // namespace nearby
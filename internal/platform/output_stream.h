@@ -15,6 +15,7 @@
 #ifndef PLATFORM_BASE_OUTPUT_STREAM_H_
 #define PLATFORM_BASE_OUTPUT_STREAM_H_
 
+#include "absl/types/span.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 
@@ -28,7 +29,21 @@ class OutputStream {
   virtual ~OutputStream() = default;
 
   virtual Exception Write(const ByteArray& data) = 0;  // throws Exception::kIo
-  virtual Exception Flush() = 0;                       // throws Exception::kIo
+
+  // Writes |buffers| back to back, as if they were one contiguous ByteArray.
+  // Implementations backed by a transport that can send scattered buffers in
+  // one operation should override this; the default issues one Write() per
+  // buffer and stops at the first failure.
+  virtual Exception Writev(  // throws Exception::kIo
+      absl::Span<const ByteArray* const> buffers) {
+    for (const ByteArray* buffer : buffers) {
+      Exception exception = Write(*buffer);
+      if (exception.Raised()) return exception;
+    }
+    return {Exception::kSuccess};
+  }
+
+  virtual Exception Flush() = 0;  // throws Exception::kIo
   virtual Exception Close() = 0;                       // throws Exception::kIo
 };
 
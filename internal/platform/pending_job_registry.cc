@@ -14,6 +14,12 @@
 
 #include "internal/platform/pending_job_registry.h"
 
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/time/time.h"
 #include "internal/platform/logging.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/system_clock.h"
@@ -35,71 +41,133 @@ PendingJobRegistry::PendingJobRegistry() = default;
 
 PendingJobRegistry::~PendingJobRegistry() = default;
 
-void PendingJobRegistry::AddPendingJob(const std::string& name,
-                                       absl::Time post_time) {
-  MutexLock lock(&mutex_);
-  pending_jobs_.emplace(CreateKey(name, post_time), post_time);
-}
-
-void PendingJobRegistry::RemovePendingJob(const std::string& name,
-                                          absl::Time post_time) {
-  MutexLock lock(&mutex_);
-  pending_jobs_.erase(CreateKey(name, post_time));
+PendingJobRegistry::JobId PendingJobRegistry::AddPendingJob(
+    const std::string& name, absl::Time post_time) {
+  const std::string* interned_name = InternName(name);
+  std::uint32_t start = next_slot_.fetch_add(1, std::memory_order_relaxed);
+  for (std::size_t i = 0; i < kMaxTrackedJobs; ++i) {
+    JobId id = (start + i) % kMaxTrackedJobs;
+    Slot& slot = slots_[id];
+    SlotState expected = SlotState::kFree;
+    if (slot.state.load(std::memory_order_relaxed) != SlotState::kFree ||
+        !slot.state.compare_exchange_strong(expected, SlotState::kClaimed,
+                                            std::memory_order_acquire)) {
+      continue;
+    }
+    slot.name.store(interned_name, std::memory_order_relaxed);
+    slot.post_time_nanos.store(absl::ToUnixNanos(post_time),
+                               std::memory_order_relaxed);
+    slot.start_time_nanos.store(0, std::memory_order_relaxed);
+    slot.state.store(SlotState::kPending, std::memory_order_release);
+    pending_job_count_.fetch_add(1, std::memory_order_relaxed);
+    return id;
+  }
+  untracked_job_count_.fetch_add(1, std::memory_order_relaxed);
+  return kOverflowJob;
 }
 
-void PendingJobRegistry::AddRunningJob(const std::string& name,
-                                       absl::Time post_time) {
-  MutexLock lock(&mutex_);
-  running_jobs_.emplace(CreateKey(name, post_time),
-                        SystemClock::ElapsedRealtime());
+void PendingJobRegistry::SetJobRunning(JobId id) {
+  if (id < 0) return;
+  Slot& slot = slots_[id];
+  slot.start_time_nanos.store(
+      absl::ToUnixNanos(SystemClock::ElapsedRealtime()),
+      std::memory_order_relaxed);
+  slot.state.store(SlotState::kRunning, std::memory_order_release);
+  pending_job_count_.fetch_sub(1, std::memory_order_relaxed);
+  running_job_count_.fetch_add(1, std::memory_order_relaxed);
 }
 
-void PendingJobRegistry::RemoveRunningJob(const std::string& name,
-                                          absl::Time post_time) {
-  MutexLock lock(&mutex_);
-  running_jobs_.erase(CreateKey(name, post_time));
+void PendingJobRegistry::RemoveJob(JobId id) {
+  if (id == kOverflowJob) {
+    untracked_job_count_.fetch_sub(1, std::memory_order_relaxed);
+    return;
+  }
+  if (id < 0) return;
+  Slot& slot = slots_[id];
+  if (slot.state.load(std::memory_order_relaxed) == SlotState::kPending) {
+    pending_job_count_.fetch_sub(1, std::memory_order_relaxed);
+  } else {
+    running_job_count_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  slot.state.store(SlotState::kFree, std::memory_order_release);
 }
 
 void PendingJobRegistry::ListJobs() {
   auto current_time = SystemClock::ElapsedRealtime();
-  MutexLock lock(&mutex_);
-  if (current_time - list_jobs_time_ < kMinReportInterval) return;
-  for (auto& job : pending_jobs_) {
-    auto age = current_time - job.second;
-    if (age >= kReportPendingJobsOlderThan) {
-      NEARBY_LOGS(INFO) << "Task \"" << job.first << "\" is waiting for "
-                        << absl::ToInt64Seconds(age) << " s";
-    }
-  }
-  for (auto& job : running_jobs_) {
-    auto age = current_time - job.second;
-    if (age >= kReportRunningJobsOlderThan) {
-      NEARBY_LOGS(INFO) << "Task \"" << job.first << "\" is running for "
-                        << absl::ToInt64Seconds(age) << " s";
-    }
+  std::int64_t last = list_jobs_time_nanos_.load(std::memory_order_relaxed);
+  if (current_time - absl::FromUnixNanos(last) < kMinReportInterval) return;
+  // Only the thread that moves the report time forward reports.
+  if (!list_jobs_time_nanos_.compare_exchange_strong(
+          last, absl::ToUnixNanos(current_time), std::memory_order_relaxed)) {
+    return;
   }
-  list_jobs_time_ = current_time;
+  ReportJobs(current_time, /*all=*/false);
 }
 
 void PendingJobRegistry::ListAllJobs() {
-  MutexLock lock(&mutex_);
   auto current_time = SystemClock::ElapsedRealtime();
-  for (auto& job : pending_jobs_) {
-    auto age = current_time - job.second;
-    NEARBY_LOGS(INFO) << "Task \"" << job.first << "\" is waiting for "
-                      << absl::ToInt64Seconds(age) << " s";
-  }
-  for (auto& job : running_jobs_) {
-    auto age = current_time - job.second;
-    NEARBY_LOGS(INFO) << "Task \"" << job.first << "\" is running for "
-                      << absl::ToInt64Seconds(age) << " s";
+  list_jobs_time_nanos_.store(absl::ToUnixNanos(current_time),
+                              std::memory_order_relaxed);
+  ReportJobs(current_time, /*all=*/true);
+}
+
+std::int64_t PendingJobRegistry::GetPendingJobCount() const {
+  return pending_job_count_.load(std::memory_order_relaxed);
+}
+
+std::int64_t PendingJobRegistry::GetRunningJobCount() const {
+  return running_job_count_.load(std::memory_order_relaxed);
+}
+
+std::int64_t PendingJobRegistry::GetUntrackedJobCount() const {
+  return untracked_job_count_.load(std::memory_order_relaxed);
+}
+
+const std::string* PendingJobRegistry::InternName(const std::string& name) {
+  // Executors post the same few names over and over, so each thread keeps
+  // the names it has seen and only takes the lock for a new one.
+  thread_local absl::flat_hash_map<std::string, const std::string*> names;
+  auto it = names.find(name);
+  if (it != names.end()) return it->second;
+  const std::string* interned_name;
+  {
+    MutexLock lock(&mutex_);
+    interned_name = &*names_.insert(name).first;
   }
-  list_jobs_time_ = current_time;
+  names.emplace(name, interned_name);
+  return interned_name;
 }
 
-std::string PendingJobRegistry::CreateKey(const std::string& name,
-                                          absl::Time post_time) {
-  return name + "." + std::to_string(absl::ToUnixNanos(post_time));
+void PendingJobRegistry::ReportJobs(absl::Time current_time, bool all) {
+  for (Slot& slot : slots_) {
+    SlotState state = slot.state.load(std::memory_order_acquire);
+    if (state != SlotState::kPending && state != SlotState::kRunning) {
+      continue;
+    }
+    const std::string* name = slot.name.load(std::memory_order_relaxed);
+    std::int64_t start_time_nanos =
+        slot.start_time_nanos.load(std::memory_order_relaxed);
+    if (state == SlotState::kPending) {
+      auto age = current_time - absl::FromUnixNanos(slot.post_time_nanos.load(
+                                    std::memory_order_relaxed));
+      if (all || age >= kReportPendingJobsOlderThan) {
+        NEARBY_LOGS(INFO) << "Task \"" << *name << "\" is waiting for "
+                          << absl::ToInt64Seconds(age) << " s";
+      }
+    } else {
+      auto age = current_time - absl::FromUnixNanos(start_time_nanos);
+      if (all || age >= kReportRunningJobsOlderThan) {
+        NEARBY_LOGS(INFO) << "Task \"" << *name << "\" is running for "
+                          << absl::ToInt64Seconds(age) << " s";
+      }
+    }
+  }
+  std::int64_t untracked = GetUntrackedJobCount();
+  if (all || untracked > 0) {
+    NEARBY_LOGS(INFO) << "Tasks pending: " << GetPendingJobCount()
+                      << "; running: " << GetRunningJobCount()
+                      << "; untracked: " << untracked;
+  }
 }
 
 }  // namespace nearby
@@ -15,7 +15,14 @@
 #ifndef PLATFORM_PUBLIC_PENDING_JOB_REGISTRY_H_
 #define PLATFORM_PUBLIC_PENDING_JOB_REGISTRY_H_
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
 #include "absl/base/thread_annotations.h"
+#include "absl/container/node_hash_set.h"
 #include "absl/time/time.h"
 #include "internal/platform/mutex.h"
 
@@ -23,30 +30,74 @@ namespace nearby {
 
 // A global registry of running tasks. The goal is to help us monitor
 // tasks that are either waiting too long for their turn or they never finish
+//
+// Jobs live in a fixed table of slots updated with atomics, so registering a
+// job neither allocates nor takes a lock. Job names are interned once per
+// thread. When every slot is taken, further jobs are only counted.
 class PendingJobRegistry {
  public:
+  using JobId = int;
+  // A job that isn't in the registry; the calls below ignore it.
+  static constexpr JobId kUntrackedJob = -1;
+  // A job posted while the table was full, which is only counted.
+  static constexpr JobId kOverflowJob = -2;
+  static constexpr std::size_t kMaxTrackedJobs = 512;
+
   static PendingJobRegistry& GetInstance();
 
   ~PendingJobRegistry();
 
-  void AddPendingJob(const std::string& name, absl::Time post_time);
-  void RemovePendingJob(const std::string& name, absl::Time post_time);
-  void AddRunningJob(const std::string& name, absl::Time post_time);
-  void RemoveRunningJob(const std::string& name, absl::Time post_time);
+  // Returns the id to pass to the calls below, or kOverflowJob if the table
+  // is full.
+  JobId AddPendingJob(const std::string& name, absl::Time post_time);
+  void SetJobRunning(JobId id);
+  // Called when the job finishes, or is dropped without running.
+  void RemoveJob(JobId id);
   void ListJobs();
   void ListAllJobs();
 
+  // Number of jobs posted but not yet running, and running.
+  std::int64_t GetPendingJobCount() const;
+  std::int64_t GetRunningJobCount() const;
+  // Number of jobs posted while the table was full, and not removed yet.
+  std::int64_t GetUntrackedJobCount() const;
+
  private:
+  enum class SlotState {
+    kFree,
+    // Taken by AddPendingJob(), which is still filling it in.
+    kClaimed,
+    kPending,
+    kRunning,
+  };
+
+  struct Slot {
+    // The fields below are only read once the state is kPending or kRunning.
+    std::atomic<SlotState> state{SlotState::kFree};
+    // The interned name of the job.
+    std::atomic<const std::string*> name{nullptr};
+    std::atomic<std::int64_t> post_time_nanos{0};
+    // Set once the job is running.
+    std::atomic<std::int64_t> start_time_nanos{0};
+  };
+
   PendingJobRegistry();
 
-  std::string CreateKey(const std::string& name, absl::Time post_time);
+  const std::string* InternName(const std::string& name);
+  void ReportJobs(absl::Time current_time, bool all);
+
+  std::array<Slot, kMaxTrackedJobs> slots_;
+  // Where the search for a free slot starts.
+  std::atomic<std::uint32_t> next_slot_{0};
+  std::atomic<std::int64_t> pending_job_count_{0};
+  std::atomic<std::int64_t> running_job_count_{0};
+  std::atomic<std::int64_t> untracked_job_count_{0};
+  std::atomic<std::int64_t> list_jobs_time_nanos_{0};
 
   Mutex mutex_;
-  absl::flat_hash_map<std::string, absl::Time> pending_jobs_
-      ABSL_GUARDED_BY(mutex_);
-  absl::flat_hash_map<std::string, absl::Time> running_jobs_
-      ABSL_GUARDED_BY(mutex_);
-  absl::Time list_jobs_time_ ABSL_GUARDED_BY(mutex_) = absl::UnixEpoch();
+  // Interned names are never freed; there are only as many as there are
+  // distinct task names in the code.
+  absl::node_hash_set<std::string> names_ ABSL_GUARDED_BY(mutex_);
 };
 
 }  // namespace nearby
@@ -0,0 +1,92 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/pending_job_registry.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace {
+
+// The registry is shared by the whole process; the tests only look at how
+// their own calls change the counts.
+class PendingJobRegistryTest : public ::testing::Test {
+ protected:
+  PendingJobRegistry& registry_ = PendingJobRegistry::GetInstance();
+  const std::int64_t pending_ = registry_.GetPendingJobCount();
+  const std::int64_t running_ = registry_.GetRunningJobCount();
+  const std::int64_t untracked_ = registry_.GetUntrackedJobCount();
+};
+
+TEST_F(PendingJobRegistryTest, CountsPendingAndRunningJobs) {
+  PendingJobRegistry::JobId id =
+      registry_.AddPendingJob("job", absl::UnixEpoch());
+  ASSERT_GE(id, 0);
+  EXPECT_EQ(registry_.GetPendingJobCount(), pending_ + 1);
+  EXPECT_EQ(registry_.GetRunningJobCount(), running_);
+
+  registry_.SetJobRunning(id);
+  EXPECT_EQ(registry_.GetPendingJobCount(), pending_);
+  EXPECT_EQ(registry_.GetRunningJobCount(), running_ + 1);
+
+  registry_.RemoveJob(id);
+  EXPECT_EQ(registry_.GetPendingJobCount(), pending_);
+  EXPECT_EQ(registry_.GetRunningJobCount(), running_);
+}
+
+TEST_F(PendingJobRegistryTest, RemovesJobThatNeverRan) {
+  PendingJobRegistry::JobId id =
+      registry_.AddPendingJob("job", absl::UnixEpoch());
+  ASSERT_GE(id, 0);
+
+  registry_.RemoveJob(id);
+  EXPECT_EQ(registry_.GetPendingJobCount(), pending_);
+  EXPECT_EQ(registry_.GetRunningJobCount(), running_);
+}
+
+TEST_F(PendingJobRegistryTest, CountsJobsPastTheTableUntilRemoved) {
+  std::vector<PendingJobRegistry::JobId> ids;
+  for (std::size_t i = 0; i < PendingJobRegistry::kMaxTrackedJobs; ++i) {
+    ids.push_back(registry_.AddPendingJob("job", absl::UnixEpoch()));
+  }
+  PendingJobRegistry::JobId overflow =
+      registry_.AddPendingJob("job", absl::UnixEpoch());
+  EXPECT_EQ(overflow, PendingJobRegistry::kOverflowJob);
+  EXPECT_EQ(registry_.GetUntrackedJobCount(), untracked_ + 1);
+
+  registry_.SetJobRunning(overflow);
+  registry_.RemoveJob(overflow);
+  EXPECT_EQ(registry_.GetUntrackedJobCount(), untracked_);
+  for (PendingJobRegistry::JobId id : ids) {
+    registry_.RemoveJob(id);
+  }
+  EXPECT_EQ(registry_.GetPendingJobCount(), pending_);
+  EXPECT_EQ(registry_.GetUntrackedJobCount(), untracked_);
+}
+
+TEST_F(PendingJobRegistryTest, IgnoresUntrackedJob) {
+  registry_.SetJobRunning(PendingJobRegistry::kUntrackedJob);
+  registry_.RemoveJob(PendingJobRegistry::kUntrackedJob);
+  EXPECT_EQ(registry_.GetPendingJobCount(), pending_);
+  EXPECT_EQ(registry_.GetRunningJobCount(), running_);
+  EXPECT_EQ(registry_.GetUntrackedJobCount(), untracked_);
+}
+
+}  // namespace
+}  // namespace nearby
@@ -14,13 +14,20 @@
 
 #include "internal/platform/pipe.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <deque>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/random/random.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/condition_variable.h"
 #include "internal/platform/exception.h"
@@ -32,9 +39,23 @@
 namespace nearby {
 
 namespace {
+
+// The first ring allocation of an unbounded pipe.
+constexpr size_t kInitialUnboundedCapacity = 64 * 1024;
+
+// Bytes written to the pipe are copied into a ring buffer, which a read
+// copies out of. An unbounded pipe grows its ring when a write doesn't fit,
+// a bounded one makes the writer wait for the reader. Either way, the ring is
+// reused once the pipe has reached its working size.
+//
+// A shaped pipe additionally remembers when the data of each write becomes
+// readable, and holds the writer back for the time the data takes to go
+// onto the link.
 class Pipe {
  public:
-  Pipe() = default;
+  // `capacity` of 0 makes the pipe unbounded.
+  explicit Pipe(size_t capacity, LinkShaping shaping = {})
+      : max_capacity_(capacity), shaping_(shaping), ring_(capacity) {}
 
   class PipeInputStream : public InputStream {
    public:
@@ -60,7 +81,11 @@ class Pipe {
     ~PipeOutputStream() override { DoClose(); }
 
     Exception Write(const ByteArray& data) override {
-      return pipe_->Write(data);
+      const ByteArray* buffers[] = {&data};
+      return pipe_->Writev(buffers);
+    }
+    Exception Writev(absl::Span<const ByteArray* const> buffers) override {
+      return pipe_->Writev(buffers);
     }
     Exception Flush() override { return {Exception::kSuccess}; }
     Exception Close() override { return DoClose(); }
@@ -74,111 +99,253 @@ class Pipe {
   };
 
  private:
-  ExceptionOr<ByteArray> Read(size_t size) ABSL_LOCKS_EXCLUDED(mutex_);
-  Exception Write(const ByteArray& data) ABSL_LOCKS_EXCLUDED(mutex_);
+  ExceptionOr<ByteArray> Read(std::int64_t size) ABSL_LOCKS_EXCLUDED(mutex_);
+  Exception Writev(absl::Span<const ByteArray* const> buffers)
+      ABSL_LOCKS_EXCLUDED(mutex_);
 
   void MarkInputStreamClosed() ABSL_LOCKS_EXCLUDED(mutex_);
   void MarkOutputStreamClosed() ABSL_LOCKS_EXCLUDED(mutex_);
 
-  Exception WriteLocked(const ByteArray& data)
+  // Copies as much of `data` into the ring as fits, growing an unbounded
+  // ring first. Returns the number of bytes copied.
+  size_t Append(const char* data, size_t size)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void Grow(size_t min_capacity) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Waits for the link to carry `size` bytes, then records when they become
+  // readable.
+  void Transmit(size_t size) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Returns how many of the unread bytes are readable now, waiting until at
+  // least one is. Returns 0 if the pipe was closed while waiting.
+  size_t WaitUntilReadable() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const size_t max_capacity_;
+  const LinkShaping shaping_;
 
   bool input_stream_closed_ ABSL_GUARDED_BY(mutex_) = false;
   bool output_stream_closed_ ABSL_GUARDED_BY(mutex_) = false;
-  bool read_all_chunks_ ABSL_GUARDED_BY(mutex_) = false;
 
-  std::deque<ByteArray> ABSL_GUARDED_BY(mutex_) buffer_;
+  std::vector<char> ring_ ABSL_GUARDED_BY(mutex_);
+  // Offset of the first unread byte in `ring_`, and the number of unread
+  // bytes.
+  size_t read_offset_ ABSL_GUARDED_BY(mutex_) = 0;
+  size_t size_ ABSL_GUARDED_BY(mutex_) = 0;
+
+  // Shaping state. Every write appends the total number of bytes written
+  // once it is in the ring, and the time they become readable.
+  struct Delivery {
+    std::int64_t end;
+    absl::Time readable_at;
+  };
+  std::deque<Delivery> deliveries_ ABSL_GUARDED_BY(mutex_);
+  std::int64_t total_written_ ABSL_GUARDED_BY(mutex_) = 0;
+  std::int64_t total_read_ ABSL_GUARDED_BY(mutex_) = 0;
+  // Token bucket, in bytes; negative while writers wait for it to refill.
+  double tokens_ ABSL_GUARDED_BY(mutex_) = shaping_.burst_bytes;
+  absl::Time tokens_at_ ABSL_GUARDED_BY(mutex_) = absl::Now();
+  absl::Time last_readable_at_ ABSL_GUARDED_BY(mutex_) = absl::InfinitePast();
+  absl::BitGen bit_gen_ ABSL_GUARDED_BY(mutex_);
   // Order of declaration matters:
-  // - mutex must be defined before condvar;
+  // - mutex must be defined before condvars;
   Mutex mutex_;
-  ConditionVariable cond_{&mutex_};
+  ConditionVariable has_data_{&mutex_};
+  ConditionVariable has_space_{&mutex_};
 };
 
-ExceptionOr<ByteArray> Pipe::Read(size_t size) {
+ExceptionOr<ByteArray> Pipe::Read(std::int64_t size) {
   MutexLock lock(&mutex_);
 
-  // We're done reading all the chunks that were written before the OutputStream
-  // was closed, so there's nothing to do here other than return an empty chunk
-  // to serve as an EOF indication to callers.
-  if (read_all_chunks_) {
-    return ExceptionOr<ByteArray>{ByteArray{}};
-  }
-
-  while (buffer_.empty() && !input_stream_closed_) {
-    Exception wait_exception = cond_.Wait();
+  while (size_ == 0 && !input_stream_closed_ && !output_stream_closed_) {
+    Exception wait_exception = has_data_.Wait();
 
     if (wait_exception.Raised()) {
       return ExceptionOr<ByteArray>{wait_exception};
     }
   }
 
-  // If we received our sentinel chunk, mark the fact that there cannot
-  // possibly be any more chunks to read here on in, and return an empty chunk
-  // to serve as an EOF indication to callers.
-  if (buffer_.empty() || buffer_.front().Empty()) {
-    read_all_chunks_ = true;
+  // Once the reader is closed, or everything written before the writer was
+  // closed has been read, return an empty chunk to serve as an EOF
+  // indication to callers.
+  if (input_stream_closed_ || size_ == 0 || size <= 0) {
     return ExceptionOr<ByteArray>{ByteArray{}};
   }
+  size_t readable = size_;
+  if (shaping_.IsEnabled()) {
+    readable = WaitUntilReadable();
+    if (readable == 0) return ExceptionOr<ByteArray>{ByteArray{}};
+  }
 
-  ByteArray first_chunk{buffer_.front()};
-  buffer_.pop_front();
-
-  // If first_chunk is small enough to not overshoot the requested 'size', just
-  // return that.
-  if (first_chunk.size() <= size) {
-    return ExceptionOr<ByteArray>{first_chunk};
-  } else {
-    // Break first_chunk into 2 parts -- the first one of which (next_chunk)
-    // will be 'size' bytes long, and will be returned, and the second one of
-    // which (overflow_chunk) will be re-inserted into buffer_, at the head of
-    // the queue, to be served up in the next call to read().
-    ByteArray next_chunk(first_chunk.data(), size);
-    buffer_.push_front(
-        ByteArray(first_chunk.data() + size, first_chunk.size() - size));
-    return ExceptionOr<ByteArray>{next_chunk};
+  // Only the requested bytes are copied out, in at most two pieces if they
+  // wrap around the end of the ring.
+  size_t read_size = std::min(static_cast<size_t>(size), readable);
+  ByteArray result(read_size);
+  size_t first = std::min(read_size, ring_.size() - read_offset_);
+  std::memcpy(result.data(), ring_.data() + read_offset_, first);
+  std::memcpy(result.data() + first, ring_.data(), read_size - first);
+  read_offset_ = (read_offset_ + read_size) % ring_.size();
+  size_ -= read_size;
+  if (size_ == 0) read_offset_ = 0;
+  total_read_ += read_size;
+  while (!deliveries_.empty() && deliveries_.front().end <= total_read_) {
+    deliveries_.pop_front();
   }
+  has_space_.Notify();
+  return ExceptionOr<ByteArray>{std::move(result)};
 }
 
-Exception Pipe::Write(const ByteArray& data) {
+Exception Pipe::Writev(absl::Span<const ByteArray* const> buffers) {
+  if (shaping_.IsEnabled()) {
+    size_t size = 0;
+    for (const ByteArray* buffer : buffers) size += buffer->size();
+    if (size > 0) Transmit(size);
+  }
   MutexLock lock(&mutex_);
 
-  return WriteLocked(data);
+  for (const ByteArray* buffer : buffers) {
+    const char* data = buffer->data();
+    size_t remaining = buffer->size();
+    while (remaining > 0) {
+      if (input_stream_closed_ || output_stream_closed_) {
+        return {Exception::kIo};
+      }
+      size_t appended = Append(data, remaining);
+      if (appended > 0) {
+        data += appended;
+        remaining -= appended;
+        // Trigger has_data_ to unblock a potentially-blocked call to read(),
+        // now that there's more data for it to consume.
+        has_data_.Notify();
+        continue;
+      }
+      // A bounded pipe is full; wait for the reader to make room. Other
+      // writers may interleave their data from here on.
+      Exception wait_exception = has_space_.Wait();
+      if (wait_exception.Raised()) return wait_exception;
+    }
+  }
+  if (input_stream_closed_ || output_stream_closed_) {
+    return {Exception::kIo};
+  }
+  return {Exception::kSuccess};
+}
+
+size_t Pipe::Append(const char* data, size_t size) {
+  if (max_capacity_ == 0 && ring_.size() - size_ < size) {
+    Grow(size_ + size);
+  }
+  size_t appended = std::min(size, ring_.size() - size_);
+  if (appended == 0) return 0;
+  size_t write_offset = (read_offset_ + size_) % ring_.size();
+  size_t first = std::min(appended, ring_.size() - write_offset);
+  std::memcpy(ring_.data() + write_offset, data, first);
+  std::memcpy(ring_.data(), data + first, appended - first);
+  size_ += appended;
+  return appended;
+}
+
+void Pipe::Grow(size_t min_capacity) {
+  size_t capacity = std::max(ring_.size() * 2, kInitialUnboundedCapacity);
+  while (capacity < min_capacity) capacity *= 2;
+  std::vector<char> ring(capacity);
+  size_t first = std::min(size_, ring_.size() - read_offset_);
+  if (first > 0) {
+    std::memcpy(ring.data(), ring_.data() + read_offset_, first);
+    std::memcpy(ring.data() + first, ring_.data(), size_ - first);
+  }
+  ring_ = std::move(ring);
+  read_offset_ = 0;
+}
+
+void Pipe::Transmit(size_t size) {
+  absl::Time sent_at;
+  {
+    MutexLock lock(&mutex_);
+    absl::Time now = absl::Now();
+    sent_at = now;
+    if (shaping_.bytes_per_second > 0) {
+      double rate = shaping_.bytes_per_second;
+      tokens_ = std::min<double>(
+          shaping_.burst_bytes,
+          tokens_ + absl::ToDoubleSeconds(now - tokens_at_) * rate);
+      tokens_at_ = now;
+      // Writers that find the bucket empty queue up behind each other, each
+      // adding to the debt the next one has to wait out.
+      tokens_ -= size;
+      if (tokens_ < 0) sent_at += absl::Seconds(-tokens_ / rate);
+    }
+    absl::Time readable_at = sent_at + shaping_.latency;
+    if (shaping_.jitter > absl::ZeroDuration()) {
+      readable_at += shaping_.jitter * absl::Uniform(bit_gen_, 0.0, 1.0);
+    }
+    // The data is appended right after this, so the delivery covers exactly
+    // the bytes of this write unless writers race, in which case they share
+    // the later of their delivery times.
+    last_readable_at_ = std::max(last_readable_at_, readable_at);
+    deliveries_.push_back(
+        {total_written_ + static_cast<std::int64_t>(size), last_readable_at_});
+    total_written_ += size;
+  }
+  absl::SleepFor(sent_at - absl::Now());
+}
+
+size_t Pipe::WaitUntilReadable() {
+  while (true) {
+    if (input_stream_closed_) return 0;
+    absl::Time now = absl::Now();
+    std::int64_t readable_end = total_read_;
+    for (const Delivery& delivery : deliveries_) {
+      if (delivery.readable_at > now) break;
+      readable_end = delivery.end;
+    }
+    // Only what is already in the ring can be read.
+    readable_end =
+        std::min(readable_end, total_read_ + static_cast<std::int64_t>(size_));
+    if (readable_end > total_read_) {
+      return static_cast<size_t>(readable_end - total_read_);
+    }
+    if (deliveries_.empty()) return size_;
+    Exception wait_exception =
+        has_data_.Wait(deliveries_.front().readable_at - now);
+    if (wait_exception.Raised()) return 0;
+  }
 }
 
 void Pipe::MarkInputStreamClosed() {
   MutexLock lock(&mutex_);
   if (input_stream_closed_) return;
   input_stream_closed_ = true;
-  // Trigger cond_ to unblock a potentially-blocked call to read(), and to let
-  // it know to return Exception::IO.
-  cond_.Notify();
+  // Unblock a potentially-blocked call to read(), and writers waiting for
+  // space, to let them know the pipe is closed.
+  has_data_.Notify();
+  has_space_.Notify();
 }
 
 void Pipe::MarkOutputStreamClosed() {
   MutexLock lock(&mutex_);
   if (output_stream_closed_) return;
-  // Write a sentinel null chunk before marking output_stream_closed as true.
-  WriteLocked(ByteArray{});
   output_stream_closed_ = true;
+  // The reader drains what was written, then gets EOF.
+  has_data_.Notify();
+  has_space_.Notify();
 }
 
-Exception Pipe::WriteLocked(const ByteArray& data) {
-  if (input_stream_closed_ || output_stream_closed_) {
-    return {Exception::kIo};
-  }
+}  // namespace
 
-  buffer_.push_back(data);
-  // Trigger cond_ to unblock a potentially-blocked call to read(), now that
-  // there's more data for it to consume.
-  cond_.Notify();
-  return {Exception::kSuccess};
+std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
+CreatePipe() {
+  return CreatePipe(/*capacity=*/0);
 }
 
-}  // namespace
+std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
+CreatePipe(size_t capacity) {
+  auto pipe = std::make_shared<Pipe>(capacity);
+  return std::make_pair(std::make_unique<Pipe::PipeInputStream>(pipe),
+                        std::make_unique<Pipe::PipeOutputStream>(pipe));
+}
 
 std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
-CreatePipe() {
-  auto pipe = std::make_shared<Pipe>();
+CreatePipe(const LinkShaping& shaping) {
+  auto pipe = std::make_shared<Pipe>(/*capacity=*/0, shaping);
   return std::make_pair(std::make_unique<Pipe::PipeInputStream>(pipe),
                         std::make_unique<Pipe::PipeOutputStream>(pipe));
 }
@@ -15,9 +15,12 @@
 #ifndef PLATFORM_PUBLIC_PIPE_H_
 #define PLATFORM_PUBLIC_PIPE_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
 
+#include "absl/time/time.h"
 #include "internal/platform/input_stream.h"
 #include "internal/platform/output_stream.h"
 
@@ -30,9 +33,50 @@ namespace nearby {
 //  WriterThread(std::move(output));
 //  ```
 //  Pipe stays valid as long as either `input` or `output` exist.
+//
+// A read returns up to the requested number of bytes, possibly spanning
+// several writes. The pipe buffers any amount of unread data.
 std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
 CreatePipe();
 
+// Creates a pipe buffering at most `capacity` unread bytes. Writes block
+// while the pipe is full, so a writer can't run ahead of its reader.
+std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
+CreatePipe(size_t capacity);
+
+// Properties of a simulated link, applied to the data written to a pipe.
+struct LinkShaping {
+  // Time between a write and the moment its data can be read.
+  absl::Duration latency = absl::ZeroDuration();
+  // Random extra latency of each write, uniform in [0, jitter]. A stream
+  // keeps its order, so data never overtakes data written before it.
+  absl::Duration jitter = absl::ZeroDuration();
+  // Token bucket the written data is paced with: it refills at
+  // `bytes_per_second` up to `burst_bytes`. 0 bytes per second means
+  // unlimited. A writer is held back until its data fits in the bucket.
+  std::int64_t bytes_per_second = 0;
+  std::int64_t burst_bytes = 0;
+
+  // Only for datagram transports, streams are never lossy: the probability
+  // that a datagram is lost, and that it is held back by `reorder_delay` so
+  // datagrams sent after it overtake it.
+  double drop_probability = 0;
+  double reorder_probability = 0;
+  absl::Duration reorder_delay = absl::Milliseconds(10);
+
+  // Returns true if streams over the link are shaped at all.
+  bool IsEnabled() const {
+    return latency > absl::ZeroDuration() || jitter > absl::ZeroDuration() ||
+           bytes_per_second > 0;
+  }
+};
+
+// Creates an unbounded pipe whose data is delayed and rate limited as if it
+// travelled over a link with the given `shaping`. Shaping runs on the real
+// clock, even when a simulated clock is installed.
+std::pair<std::unique_ptr<InputStream>, std::unique_ptr<OutputStream>>
+CreatePipe(const LinkShaping& shaping);
+
 }  // namespace nearby
 
 #endif  // PLATFORM_PUBLIC_PIPE_H_
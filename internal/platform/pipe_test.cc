@@ -26,6 +26,8 @@
 
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/exception.h"
 #include "internal/platform/input_stream.h"
@@ -54,6 +56,34 @@ TEST(PipeTest, SimpleWriteRead) {
   EXPECT_EQ(data, std::string(read_data.result()));
 }
 
+TEST(PipeTest, WritevReadsBackInOrder) {
+  auto [input_stream, output_stream] = CreatePipe();
+  ByteArray header(std::string("AB"));
+  ByteArray empty;
+  ByteArray body(std::string("CDEF"));
+  const ByteArray* buffers[] = {&header, &empty, &body};
+
+  EXPECT_TRUE(output_stream->Writev(buffers).Ok());
+
+  // The empty segment must not be mistaken for the EOF sentinel.
+  ExceptionOr<ByteArray> read_data = input_stream->Read(2);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "AB");
+  read_data = input_stream->Read(kChunkSize);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "CDEF");
+}
+
+TEST(PipeTest, WritevAfterOutputStreamClosed) {
+  auto [input_stream, output_stream] = CreatePipe();
+  ByteArray data(std::string("ABCD"));
+  const ByteArray* buffers[] = {&data};
+
+  output_stream->Close();
+
+  EXPECT_TRUE(output_stream->Writev(buffers).Raised(Exception::kIo));
+}
+
 TEST(PipeTest, WriteEndClosedBeforeRead) {
   auto [input_stream, output_stream] = CreatePipe();
 
@@ -150,6 +180,67 @@ TEST(PipeTest, RepeatedClose) {
   EXPECT_TRUE(input_stream->Close().Ok());
 }
 
+TEST(PipeTest, ReadSpansWrites) {
+  auto [input_stream, output_stream] = CreatePipe();
+  EXPECT_TRUE(output_stream->Write(ByteArray(std::string("AB"))).Ok());
+  EXPECT_TRUE(output_stream->Write(ByteArray(std::string("CDE"))).Ok());
+
+  ExceptionOr<ByteArray> read_data = input_stream->Read(4);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "ABCD");
+  read_data = input_stream->Read(kChunkSize);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "E");
+}
+
+TEST(PipeTest, UnboundedPipeGrowsPastInitialCapacity) {
+  auto [input_stream, output_stream] = CreatePipe();
+  std::string data(3 * kChunkSize, 'x');
+  for (size_t i = 0; i < data.size(); ++i) data[i] = 'a' + i % 26;
+
+  EXPECT_TRUE(output_stream->Write(ByteArray(data)).Ok());
+  EXPECT_TRUE(output_stream->Close().Ok());
+
+  std::string actual_data;
+  while (true) {
+    ExceptionOr<ByteArray> read_data = input_stream->Read(kChunkSize);
+    ASSERT_TRUE(read_data.ok());
+    if (read_data.result().Empty()) break;
+    actual_data += std::string(read_data.result());
+  }
+  EXPECT_EQ(data, actual_data);
+}
+
+TEST(PipeTest, BoundedPipeWrapsAround) {
+  auto [input_stream, output_stream] = CreatePipe(/*capacity=*/7);
+
+  // Writes and reads of different sizes move the data across the end of the
+  // ring many times.
+  std::string expected_data;
+  std::string actual_data;
+  for (int i = 0; i < 100; ++i) {
+    std::string data(1 + i % 5, 'a' + i % 26);
+    EXPECT_TRUE(output_stream->Write(ByteArray(data)).Ok());
+    expected_data += data;
+    ExceptionOr<ByteArray> read_data = input_stream->Read(1 + i % 3);
+    ASSERT_TRUE(read_data.ok());
+    actual_data += std::string(read_data.result());
+    if (expected_data.size() - actual_data.size() > 2) {
+      read_data = input_stream->Read(kChunkSize);
+      ASSERT_TRUE(read_data.ok());
+      actual_data += std::string(read_data.result());
+    }
+  }
+  EXPECT_TRUE(output_stream->Close().Ok());
+  while (true) {
+    ExceptionOr<ByteArray> read_data = input_stream->Read(kChunkSize);
+    ASSERT_TRUE(read_data.ok());
+    if (read_data.result().Empty()) break;
+    actual_data += std::string(read_data.result());
+  }
+  EXPECT_EQ(expected_data, actual_data);
+}
+
 class Thread {
  public:
   Thread() : thread_(), attr_(), runnable_() {
@@ -337,4 +428,147 @@ TEST(PipeTest, ConcurrentWriteAndRead) {
   reader_thread.Join();
 }
 
+TEST(PipeTest, BoundedPipeWriteBlockedUntilRead) {
+  auto [input_stream, output_stream] = CreatePipe(/*capacity=*/4);
+  std::atomic_bool write_done = false;
+
+  Thread writer_thread;
+  writer_thread.Start([&output_stream = output_stream, &write_done]() {
+    // Only half of the data fits until the reader catches up.
+    EXPECT_TRUE(output_stream->Write(ByteArray(std::string("ABCDEFGH"))).Ok());
+    write_done = true;
+  });
+
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_FALSE(write_done);
+  ExceptionOr<ByteArray> read_data = input_stream->Read(kChunkSize);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "ABCD");
+  read_data = input_stream->Read(kChunkSize);
+  EXPECT_TRUE(read_data.ok());
+  EXPECT_EQ(std::string(read_data.result()), "EFGH");
+  writer_thread.Join();
+
+  EXPECT_TRUE(write_done);
+}
+
+TEST(PipeTest, BoundedPipeWriteFailsWhenReadEndClosedWhileFull) {
+  auto [input_stream, output_stream] = CreatePipe(/*capacity=*/4);
+  std::atomic_bool write_failed = false;
+
+  Thread writer_thread;
+  writer_thread.Start([&output_stream = output_stream, &write_failed]() {
+    write_failed =
+        output_stream->Write(ByteArray(std::string("ABCDEFGH")))
+            .Raised(Exception::kIo);
+  });
+  absl::SleepFor(absl::Milliseconds(100));
+  EXPECT_TRUE(input_stream->Close().Ok());
+  writer_thread.Join();
+
+  EXPECT_TRUE(write_failed);
+}
+
+TEST(PipeTest, ShapedPipeDelaysDataByLatency) {
+  auto [input_stream, output_stream] =
+      CreatePipe(LinkShaping{.latency = absl::Milliseconds(200)});
+
+  absl::Time start = absl::Now();
+  EXPECT_TRUE(output_stream->Write(ByteArray(std::string("ABCD"))).Ok());
+  // Latency doesn't hold back the writer.
+  EXPECT_LT(absl::Now() - start, absl::Milliseconds(100));
+  ExceptionOr<ByteArray> read = input_stream->Read(4);
+
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(190));
+  ASSERT_TRUE(read.ok());
+  EXPECT_EQ(std::string(read.result()), "ABCD");
+}
+
+TEST(PipeTest, ShapedPipeKeepsWritesInFlight) {
+  auto [input_stream, output_stream] =
+      CreatePipe(LinkShaping{.latency = absl::Milliseconds(200)});
+
+  absl::Time start = absl::Now();
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(output_stream->Write(ByteArray(std::string("AB"))).Ok());
+    absl::SleepFor(absl::Milliseconds(20));
+  }
+  std::string received;
+  while (received.size() < 10) {
+    ExceptionOr<ByteArray> read = input_stream->Read(10);
+    ASSERT_TRUE(read.ok());
+    received += std::string(read.result());
+  }
+
+  // The writes overlap on the link rather than adding up their latency.
+  EXPECT_LT(absl::Now() - start, absl::Milliseconds(600));
+  EXPECT_EQ(received, "ABABABABAB");
+}
+
+TEST(PipeTest, ShapedPipeLimitsBandwidth) {
+  auto [input_stream, output_stream] =
+      CreatePipe(LinkShaping{.bytes_per_second = 100 * 1024});
+
+  absl::Time start = absl::Now();
+  EXPECT_TRUE(output_stream->Write(ByteArray(20 * 1024)).Ok());
+  EXPECT_TRUE(output_stream->Write(ByteArray(10 * 1024)).Ok());
+
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(290));
+  ExceptionOr<ByteArray> read = input_stream->Read(64 * 1024);
+  ASSERT_TRUE(read.ok());
+  EXPECT_EQ(read.result().size(), 30 * 1024);
+}
+
+TEST(PipeTest, ShapedPipeLetsBurstThroughBucket) {
+  auto [input_stream, output_stream] = CreatePipe(
+      LinkShaping{.bytes_per_second = 100 * 1024, .burst_bytes = 50 * 1024});
+
+  absl::Time start = absl::Now();
+  EXPECT_TRUE(output_stream->Write(ByteArray(40 * 1024)).Ok());
+  // The first write fits in the bucket.
+  EXPECT_LT(absl::Now() - start, absl::Milliseconds(100));
+  EXPECT_TRUE(output_stream->Write(ByteArray(30 * 1024)).Ok());
+
+  // The second one waits for the 20 KiB the bucket lacks.
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(190));
+  ExceptionOr<ByteArray> read = input_stream->Read(128 * 1024);
+  ASSERT_TRUE(read.ok());
+  EXPECT_EQ(read.result().size(), 70 * 1024);
+}
+
+TEST(PipeTest, ShapedPipeKeepsOrderUnderJitter) {
+  auto [input_stream, output_stream] =
+      CreatePipe(LinkShaping{.jitter = absl::Milliseconds(50)});
+
+  std::string sent;
+  for (int i = 0; i < 20; ++i) {
+    std::string data(1, static_cast<char>('a' + i));
+    sent += data;
+    EXPECT_TRUE(output_stream->Write(ByteArray(data)).Ok());
+  }
+  std::string received;
+  while (received.size() < sent.size()) {
+    ExceptionOr<ByteArray> read = input_stream->Read(sent.size());
+    ASSERT_TRUE(read.ok());
+    received += std::string(read.result());
+  }
+
+  EXPECT_EQ(received, sent);
+}
+
+TEST(PipeTest, ShapedPipeDeliversInFlightDataAfterWriterCloses) {
+  auto [input_stream, output_stream] =
+      CreatePipe(LinkShaping{.latency = absl::Milliseconds(100)});
+
+  EXPECT_TRUE(output_stream->Write(ByteArray(std::string("ABCD"))).Ok());
+  EXPECT_TRUE(output_stream->Close().Ok());
+
+  ExceptionOr<ByteArray> read = input_stream->Read(4);
+  ASSERT_TRUE(read.ok());
+  EXPECT_EQ(std::string(read.result()), "ABCD");
+  read = input_stream->Read(4);
+  ASSERT_TRUE(read.ok());
+  EXPECT_TRUE(read.result().Empty());
+}
+
 }  // namespace nearby
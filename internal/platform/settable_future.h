@@ -19,11 +19,11 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/time/time.h"
-#include "internal/flags/nearby_flags.h"
 #include "internal/platform/condition_variable.h"
 #include "internal/platform/exception.h"
-#include "internal/platform/flags/nearby_platform_feature_flags.h"
+#include "internal/platform/future_timeouts.h"
 #include "internal/platform/implementation/executor.h"
 #include "internal/platform/implementation/listenable_future.h"
 #include "internal/platform/implementation/platform.h"
@@ -32,7 +32,6 @@
 #include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/system_clock.h"
-#include "internal/platform/timer_impl.h"
 
 namespace nearby {
 
@@ -43,47 +42,59 @@ class SettableFuture : public api::SettableFuture<T> {
   SettableFuture() = default;
 
   // Creates a SettableFuture that fails with a kTimeout when `timeout` expires.
+  // The timeout is kept by FutureTimeouts, shared by all futures.
   explicit SettableFuture(absl::Duration timeout)
-      : timer_(std::make_unique<TimerImpl>()) {
-    timer_->Start(absl::ToInt64Milliseconds(timeout), 0, [this] {
-      // Offload the timeout to a single thread executor.
-      if (NearbyFlags::GetInstance().GetBoolFlag(
-              platform::config_package_nearby::nearby_platform_feature::
-                  kEnableTaskScheduler)) {
-        executor_ = api::ImplementationPlatform::CreateSingleThreadExecutor();
-        executor_->Execute([this]() { SetException({Exception::kTimeout}); });
-      } else {
-        SetException({Exception::kTimeout});
-      }
-    });
+      : timeout_target_(std::make_shared<TimeoutTarget>(this)) {
+    MutexLock lock(&mutex_);
+    timeout_id_ = FutureTimeouts::Schedule(
+        timeout, [target = timeout_target_]() {
+          MutexLock lock(&target->mutex);
+          if (target->future != nullptr) {
+            target->future->SetException({Exception::kTimeout});
+          }
+        });
   }
 
-  ~SettableFuture() override = default;
+  ~SettableFuture() override {
+    if (timeout_target_ != nullptr) {
+      // Waits for the timeout if it is running.
+      MutexLock lock(&timeout_target_->mutex);
+      timeout_target_->future = nullptr;
+    }
+    MutexLock lock(&mutex_);
+    CancelTimeoutLocked();
+  }
 
   bool Set(T value) override {
-    MutexLock lock(&mutex_);
-    timer_.reset();
-    if (!done_) {
+    Completion completion;
+    {
+      MutexLock lock(&mutex_);
+      CancelTimeoutLocked();
+      if (done_) return false;
       value_ = std::move(value);
-      done_ = true;
       exception_ = {Exception::kSuccess};
-      completed_.Notify();
-      InvokeAllLocked();
-      return true;
+      completion = CompleteLocked();
     }
-    return false;
+    InvokeAll(std::move(completion));
+    return true;
   }
 
+  // Listeners are invoked once the future is done, after it releases its
+  // lock, so a listener running on the completing thread may use the future.
   void AddListener(FutureCallback callback, api::Executor* executor) override {
-    MutexLock lock(&mutex_);
-    if (done_) {
-      executor->Execute(
-          [value = GetLocked(), callback = std::move(callback)]() mutable {
-            callback(std::move(value));
-          });
-    } else {
-      listeners_.emplace_back(std::make_pair(executor, std::move(callback)));
+    ExceptionOr<T> value;
+    {
+      MutexLock lock(&mutex_);
+      if (!done_) {
+        listeners_.emplace_back(std::make_pair(executor, std::move(callback)));
+        return;
+      }
+      value = GetLocked();
     }
+    executor->Execute([value = std::move(value),
+                       callback = std::move(callback)]() mutable {
+      callback(std::move(value));
+    });
   }
 
   bool IsSet() const {
@@ -92,15 +103,14 @@ class SettableFuture : public api::SettableFuture<T> {
   }
 
   bool SetException(Exception exception) override {
-    MutexLock lock(&mutex_);
-    if (timer_) {
-      timer_->Stop();
-      // We can't destroy the timer from the timer.
-      if (!exception.Raised(Exception::kTimeout)) {
-        timer_.reset();
-      }
+    Completion completion;
+    {
+      MutexLock lock(&mutex_);
+      CancelTimeoutLocked();
+      completion = SetExceptionLocked(exception);
     }
-    return SetExceptionLocked(exception);
+    InvokeAll(std::move(completion));
+    return true;
   }
 
   ExceptionOr<T> Get() override {
@@ -112,35 +122,70 @@ class SettableFuture : public api::SettableFuture<T> {
   }
 
   ExceptionOr<T> Get(absl::Duration timeout) override {
-    MutexLock lock(&mutex_);
-    while (!done_) {
-      absl::Time start_time = SystemClock::ElapsedRealtime();
-      if (completed_.Wait(timeout).Raised(Exception::kInterrupted)) {
-        SetExceptionLocked({Exception::kInterrupted});
-        break;
-      }
-      absl::Duration spent = SystemClock::ElapsedRealtime() - start_time;
-      if (spent < timeout) {
-        timeout -= spent;
-      } else if (!done_) {
-        SetExceptionLocked({Exception::kTimeout});
-        break;
+    Completion completion;
+    ExceptionOr<T> result;
+    {
+      MutexLock lock(&mutex_);
+      while (!done_) {
+        absl::Time start_time = SystemClock::ElapsedRealtime();
+        if (completed_.Wait(timeout).Raised(Exception::kInterrupted)) {
+          completion = SetExceptionLocked({Exception::kInterrupted});
+          break;
+        }
+        absl::Duration spent = SystemClock::ElapsedRealtime() - start_time;
+        if (spent < timeout) {
+          timeout -= spent;
+        } else if (!done_) {
+          completion = SetExceptionLocked({Exception::kTimeout});
+          break;
+        }
       }
+      result = GetLocked();
     }
-    return GetLocked();
+    InvokeAll(std::move(completion));
+    return result;
   }
 
  private:
-  bool SetExceptionLocked(Exception exception) {
-    if (!done_) {
-      exception_ = exception.value != Exception::kSuccess
-                       ? exception
-                       : Exception{Exception::kFailed};
-      done_ = true;
-      completed_.Notify();
-      InvokeAllLocked();
+  // Lets the timeout reach the future only while the future is alive.
+  struct TimeoutTarget {
+    explicit TimeoutTarget(SettableFuture* future) : future(future) {}
+
+    Mutex mutex;
+    SettableFuture* future ABSL_GUARDED_BY(mutex);
+  };
+
+  void CancelTimeoutLocked() {
+    if (timeout_id_ != FutureTimeouts::kInvalidTimeoutId) {
+      FutureTimeouts::Cancel(timeout_id_);
+      timeout_id_ = FutureTimeouts::kInvalidTimeoutId;
     }
-    return true;
+  }
+
+  // The listeners of a future that is done, and the result to pass them.
+  struct Completion {
+    std::vector<std::pair<api::Executor*, FutureCallback>> listeners;
+    ExceptionOr<T> result;
+  };
+
+  Completion SetExceptionLocked(Exception exception) {
+    if (done_) return Completion();
+    exception_ = exception.value != Exception::kSuccess
+                     ? exception
+                     : Exception{Exception::kFailed};
+    return CompleteLocked();
+  }
+
+  Completion CompleteLocked() {
+    done_ = true;
+    completed_.Notify();
+    Completion completion;
+    if (!listeners_.empty()) {
+      completion.listeners = std::move(listeners_);
+      listeners_.clear();
+      completion.result = GetLocked();
+    }
+    return completion;
   }
 
   ExceptionOr<T> GetLocked() {
@@ -149,14 +194,14 @@ class SettableFuture : public api::SettableFuture<T> {
                : ExceptionOr<T>{value_};
   }
 
-  void InvokeAllLocked() {
-    for (auto& item : listeners_) {
-      item.first->Execute(
-          [value = GetLocked(), callback = std::move(item.second)]() mutable {
-            callback(std::move(value));
-          });
+  // Must be called without the lock; the future may be gone by then.
+  static void InvokeAll(Completion completion) {
+    for (auto& item : completion.listeners) {
+      item.first->Execute([value = completion.result,
+                           callback = std::move(item.second)]() mutable {
+        callback(std::move(value));
+      });
     }
-    listeners_.clear();
   }
 
   mutable Mutex mutex_;
@@ -165,8 +210,8 @@ class SettableFuture : public api::SettableFuture<T> {
   bool done_{false};
   T value_;
   Exception exception_{Exception::kFailed};
-  std::unique_ptr<TimerImpl> timer_;
-  std::unique_ptr<api::SubmittableExecutor> executor_;
+  std::shared_ptr<TimeoutTarget> timeout_target_;
+  FutureTimeouts::TimeoutId timeout_id_ = FutureTimeouts::kInvalidTimeoutId;
 };
 
 }  // namespace nearby
@@ -15,6 +15,9 @@
 #ifndef PLATFORM_PUBLIC_SINGLE_THREAD_EXECUTOR_H_
 #define PLATFORM_PUBLIC_SINGLE_THREAD_EXECUTOR_H_
 
+#include <string>
+#include <utility>
+
 #include "absl/base/thread_annotations.h"
 #include "internal/platform/submittable_executor.h"
 
@@ -29,6 +32,11 @@ class ABSL_LOCKABLE SingleThreadExecutor : public SubmittableExecutor {
   using Platform = api::ImplementationPlatform;
   SingleThreadExecutor()
       : SubmittableExecutor(Platform::CreateSingleThreadExecutor()) {}
+  // Creates an executor that reports its stats under `name`, see
+  // `ExecutorStatsRegistry`.
+  explicit SingleThreadExecutor(std::string name)
+      : SubmittableExecutor(Platform::CreateSingleThreadExecutor(),
+                            std::move(name)) {}
   ~SingleThreadExecutor() override = default;
   SingleThreadExecutor(SingleThreadExecutor&&) = default;
   SingleThreadExecutor& operator=(SingleThreadExecutor&&) = default;
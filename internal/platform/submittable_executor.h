@@ -21,7 +21,9 @@
 #include <utility>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/time/time.h"
 #include "internal/platform/callable.h"
+#include "internal/platform/executor_stats.h"
 #include "internal/platform/future.h"
 #include "internal/platform/implementation/executor.h"
 #include "internal/platform/implementation/submittable_executor.h"
@@ -30,6 +32,7 @@
 #include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/runnable.h"
+#include "internal/platform/system_clock.h"
 #include "internal/platform/thread_check_callable.h"
 #include "internal/platform/thread_check_runnable.h"
 
@@ -51,22 +54,26 @@ class ABSL_LOCKABLE SubmittableExecutor : public api::SubmittableExecutor,
     {
       MutexLock other_lock(&other.mutex_);
       impl_ = std::move(other.impl_);
+      stats_ = std::move(other.stats_);
     }
     return *this;
   }
   virtual void Execute(const std::string& name, Runnable&& runnable)
       ABSL_LOCKS_EXCLUDED(mutex_) {
     MutexLock lock(&mutex_);
-    if (impl_)
-      impl_->Execute(MonitoredRunnable(
-          name, ThreadCheckRunnable(this, std::move(runnable))));
+    if (!impl_) return;
+    impl_->Execute(Instrument(
+        name, MonitoredRunnable(
+                  name, ThreadCheckRunnable(this, std::move(runnable)))));
+    if (stats_) stats_->OnSubmitted();
   }
 
   void Execute(Runnable&& runnable) ABSL_LOCKS_EXCLUDED(mutex_) override {
     MutexLock lock(&mutex_);
-    if (impl_)
-      impl_->Execute(
-          MonitoredRunnable(ThreadCheckRunnable(this, std::move(runnable))));
+    if (!impl_) return;
+    impl_->Execute(Instrument(
+        {}, MonitoredRunnable(ThreadCheckRunnable(this, std::move(runnable)))));
+    if (stats_) stats_->OnSubmitted();
   }
 
   void Shutdown() ABSL_LOCKS_EXCLUDED(mutex_) override { DoShutdown(); }
@@ -78,16 +85,17 @@ class ABSL_LOCKABLE SubmittableExecutor : public api::SubmittableExecutor,
   bool Submit(Callable<T>&& callable, Future<T>* future)
       ABSL_LOCKS_EXCLUDED(mutex_) {
     MutexLock lock(&mutex_);
-    bool submitted =
-        DoSubmit([callable = ThreadCheckCallable<T>(this, std::move(callable)),
-                  future]() mutable {
+    bool submitted = DoSubmit(Instrument(
+        {}, [callable = ThreadCheckCallable<T>(this, std::move(callable)),
+             future]() mutable {
           ExceptionOr<T> result = callable();
           if (result.ok()) {
             future->Set(result.result());
           } else {
             future->SetException({result.exception()});
           }
-        });
+        }));
+    if (submitted && stats_) stats_->OnSubmitted();
     if (!submitted) {
       // complete immediately with kExecution exception value.
       future->SetException({Exception::kExecution});
@@ -95,9 +103,22 @@ class ABSL_LOCKABLE SubmittableExecutor : public api::SubmittableExecutor,
     return submitted;
   }
 
+  // Returns the stats of a named executor, nullptr for an unnamed one.
+  std::shared_ptr<ExecutorStats> GetStats() const ABSL_LOCKS_EXCLUDED(mutex_) {
+    MutexLock lock(&mutex_);
+    return stats_;
+  }
+
  protected:
   explicit SubmittableExecutor(std::unique_ptr<api::SubmittableExecutor> impl)
       : impl_(std::move(impl)) {}
+  // A named executor reports the queue latency and run time of its tasks to
+  // `ExecutorStatsRegistry`.
+  SubmittableExecutor(std::unique_ptr<api::SubmittableExecutor> impl,
+                      std::string name)
+      : impl_(std::move(impl)),
+        stats_(ExecutorStatsRegistry::GetInstance().Register(std::move(name))) {
+  }
 
  private:
   void DoShutdown() ABSL_LOCKS_EXCLUDED(mutex_) {
@@ -120,8 +141,27 @@ class ABSL_LOCKABLE SubmittableExecutor : public api::SubmittableExecutor,
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) override {
     return impl_ ? impl_->DoSubmit(std::move(wrapped_callable)) : false;
   }
+  // Wraps `runnable` to update the stats of a named executor. Unnamed
+  // executors run it as is.
+  template <typename R>
+  Runnable Instrument(const std::string& task_name, R&& runnable)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (!stats_) return std::forward<R>(runnable);
+    return [stats = stats_, task_name, runnable = std::forward<R>(runnable),
+            submit_time = SystemClock::ElapsedRealtime()]() mutable {
+      absl::Time start_time = SystemClock::ElapsedRealtime();
+      stats->OnStarted(start_time - submit_time);
+      runnable();
+      absl::Time end_time = SystemClock::ElapsedRealtime();
+      stats->OnCompleted(end_time - start_time);
+      ExecutorStatsRegistry::GetInstance().MaybeTrace(
+          {stats->name(), task_name, submit_time, start_time, end_time});
+    };
+  }
+
   mutable Mutex mutex_;
   std::unique_ptr<api::SubmittableExecutor> ABSL_GUARDED_BY(mutex_) impl_;
+  std::shared_ptr<ExecutorStats> ABSL_GUARDED_BY(mutex_) stats_;
 };
 
 }  // namespace nearby
@@ -0,0 +1,215 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/timer_wheel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/implementation/system_clock.h"
+#include "internal/platform/mutex_lock.h"
+
+namespace nearby {
+
+namespace {
+// Set on the wheel thread, so Cancel() can tell it is called from a callback
+// and must not wait for that callback to return.
+thread_local const TimerWheel* current_wheel = nullptr;
+}  // namespace
+
+TimerWheel::TimerWheel(absl::Duration tick)
+    : tick_(std::max(tick, absl::Milliseconds(1))),
+      start_time_(SystemClock::ElapsedRealtime()) {
+  executor_.Execute("timer-wheel", [this]() { Loop(); });
+}
+
+TimerWheel::~TimerWheel() { Shutdown(); }
+
+TimerWheel::TimerId TimerWheel::Schedule(absl::Duration delay,
+                                         absl::AnyInvocable<void()> callback) {
+  return Add(delay, absl::ZeroDuration(), std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::ScheduleRepeating(
+    absl::Duration period, absl::AnyInvocable<void()> callback) {
+  return Add(period, std::max(period, tick_), std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::Add(absl::Duration delay, absl::Duration period,
+                                    absl::AnyInvocable<void()> callback) {
+  MutexLock lock(&mutex_);
+  if (shutdown_) return kInvalidTimerId;
+  // Nothing is pending, so no tick needs to be processed; skip the wheel
+  // forward instead of replaying the ticks it slept through.
+  if (timers_.empty()) {
+    current_tick_ = std::max(current_tick_, GetElapsedTicks());
+  }
+  TimerId id = next_id_++;
+  std::uint64_t expiry_tick = current_tick_ + std::max<std::uint64_t>(
+                                                  ToTicks(delay), 1);
+  timers_.emplace(
+      id, Timer{.expiry_tick = expiry_tick,
+                .period_ticks = ToTicks(period),
+                .callback = std::make_shared<absl::AnyInvocable<void()>>(
+                    std::move(callback))});
+  PlaceLocked(id, expiry_tick);
+  cond_.Notify();
+  return id;
+}
+
+bool TimerWheel::Cancel(TimerId id) {
+  MutexLock lock(&mutex_);
+  bool was_pending = timers_.erase(id) > 0;
+  if (current_wheel != this) {
+    while (running_id_ == id && id != kInvalidTimerId) {
+      cond_.Wait();
+    }
+  }
+  return was_pending;
+}
+
+void TimerWheel::Shutdown() {
+  {
+    MutexLock lock(&mutex_);
+    if (shutdown_) return;
+    shutdown_ = true;
+    timers_.clear();
+    cond_.Notify();
+  }
+  executor_.Shutdown();
+}
+
+size_t TimerWheel::GetPendingTimerCount() const {
+  MutexLock lock(&mutex_);
+  return timers_.size();
+}
+
+std::uint64_t TimerWheel::ToTicks(absl::Duration duration) const {
+  if (duration <= absl::ZeroDuration()) return 0;
+  // Round up, so a timer never fires early.
+  std::uint64_t ticks = absl::ToInt64Microseconds(duration + tick_ -
+                                                  absl::Microseconds(1)) /
+                        absl::ToInt64Microseconds(tick_);
+  return std::min(ticks, kMaxDelayTicks);
+}
+
+std::uint64_t TimerWheel::GetElapsedTicks() const {
+  return absl::ToInt64Microseconds(SystemClock::ElapsedRealtime() -
+                                   start_time_) /
+         absl::ToInt64Microseconds(tick_);
+}
+
+void TimerWheel::PlaceLocked(TimerId id, std::uint64_t expiry_tick) {
+  std::uint64_t delta =
+      expiry_tick > current_tick_ ? expiry_tick - current_tick_ : 0;
+  int level = 0;
+  while (level < kLevels - 1 && (delta >> (kSlotBits * (level + 1))) != 0) {
+    level++;
+  }
+  std::uint64_t slot = (expiry_tick >> (kSlotBits * level)) & kSlotMask;
+  wheel_[level][slot].push_back(id);
+}
+
+void TimerWheel::AdvanceLocked(std::vector<ExpiredTimer>& expired) {
+  current_tick_++;
+
+  // Whenever a level wraps around, re-distribute the next slot of the level
+  // above it into the lower levels.
+  for (int level = 1; level < kLevels; level++) {
+    if ((current_tick_ & ((std::uint64_t{1} << (kSlotBits * level)) - 1)) !=
+        0) {
+      break;
+    }
+    std::uint64_t slot = (current_tick_ >> (kSlotBits * level)) & kSlotMask;
+    std::vector<TimerId> ids = std::move(wheel_[level][slot]);
+    wheel_[level][slot].clear();
+    for (TimerId id : ids) {
+      auto it = timers_.find(id);
+      if (it != timers_.end()) PlaceLocked(id, it->second.expiry_tick);
+    }
+  }
+
+  std::vector<TimerId> ids = std::move(wheel_[0][current_tick_ & kSlotMask]);
+  wheel_[0][current_tick_ & kSlotMask].clear();
+  for (TimerId id : ids) {
+    auto it = timers_.find(id);
+    if (it == timers_.end()) continue;
+    Timer& timer = it->second;
+    if (timer.expiry_tick > current_tick_) {
+      PlaceLocked(id, timer.expiry_tick);
+      continue;
+    }
+    expired.push_back({.id = id, .callback = timer.callback});
+    // One-shot timers stay in |timers_| until they run, so a Cancel() that
+    // comes in between still takes effect.
+    if (timer.period_ticks > 0) {
+      timer.expiry_tick = current_tick_ + timer.period_ticks;
+      PlaceLocked(id, timer.expiry_tick);
+    }
+  }
+}
+
+void TimerWheel::Loop() {
+  current_wheel = this;
+  while (true) {
+    std::vector<ExpiredTimer> expired;
+    {
+      MutexLock lock(&mutex_);
+      if (shutdown_) break;
+      if (timers_.empty()) {
+        // Idle: sleep until a timer is added.
+        cond_.Wait();
+        continue;
+      }
+      std::uint64_t target_tick = GetElapsedTicks();
+      if (target_tick <= current_tick_) {
+        absl::Duration until_next_tick =
+            start_time_ + tick_ * static_cast<int64_t>(current_tick_ + 1) -
+            SystemClock::ElapsedRealtime();
+        cond_.Wait(std::max(until_next_tick, absl::Milliseconds(1)));
+        continue;
+      }
+      while (current_tick_ < target_tick) {
+        AdvanceLocked(expired);
+      }
+    }
+
+    for (ExpiredTimer& timer : expired) {
+      {
+        MutexLock lock(&mutex_);
+        if (shutdown_) break;
+        // A timer cancelled after it was collected must not run.
+        auto it = timers_.find(timer.id);
+        if (it == timers_.end()) continue;
+        if (it->second.period_ticks == 0) timers_.erase(it);
+        running_id_ = timer.id;
+      }
+      (*timer.callback)();
+      {
+        MutexLock lock(&mutex_);
+        running_id_ = kInvalidTimerId;
+        cond_.Notify();
+      }
+    }
+  }
+  current_wheel = nullptr;
+}
+
+}  // namespace nearby
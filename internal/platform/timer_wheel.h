@@ -0,0 +1,128 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_PUBLIC_TIMER_WHEEL_H_
+#define PLATFORM_PUBLIC_TIMER_WHEEL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/time/time.h"
+#include "internal/platform/condition_variable.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
+
+namespace nearby {
+
+// A hierarchical timer wheel that drives many one-shot and periodic timers
+// from a single thread.
+//
+// Scheduling and cancelling a timer are O(1). The thread only wakes up once
+// per tick while timers are pending, and sleeps while there are none, so the
+// thread count and the wakeup rate do not grow with the number of timers.
+// Deadlines are rounded up to the next tick.
+//
+// Callbacks run on the wheel thread, one at a time, and must not block for
+// long; hand longer work off to an executor.
+class TimerWheel {
+ public:
+  using TimerId = std::uint64_t;
+  static constexpr TimerId kInvalidTimerId = 0;
+
+  explicit TimerWheel(absl::Duration tick = absl::Milliseconds(10));
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  // Runs |callback| once, after |delay|.
+  // Returns kInvalidTimerId if the wheel has been shut down.
+  TimerId Schedule(absl::Duration delay, absl::AnyInvocable<void()> callback)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Runs |callback| every |period|, until cancelled.
+  // Returns kInvalidTimerId if the wheel has been shut down.
+  TimerId ScheduleRepeating(absl::Duration period,
+                            absl::AnyInvocable<void()> callback)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Cancels a pending timer. If its callback is running on another thread,
+  // blocks until it returns. Returns true if the timer was pending.
+  bool Cancel(TimerId id) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops all pending timers and stops the wheel thread.
+  void Shutdown() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Number of timers currently scheduled.
+  size_t GetPendingTimerCount() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  static constexpr int kLevels = 4;
+  static constexpr int kSlotBits = 8;
+  static constexpr std::uint64_t kSlots = 1 << kSlotBits;
+  static constexpr std::uint64_t kSlotMask = kSlots - 1;
+  // Longest delay the wheel can represent, in ticks. Longer ones are clamped.
+  static constexpr std::uint64_t kMaxDelayTicks =
+      (std::uint64_t{1} << (kSlotBits * kLevels)) - 1;
+
+  struct Timer {
+    std::uint64_t expiry_tick;
+    // Zero for one-shot timers.
+    std::uint64_t period_ticks;
+    std::shared_ptr<absl::AnyInvocable<void()>> callback;
+  };
+
+  struct ExpiredTimer {
+    TimerId id;
+    std::shared_ptr<absl::AnyInvocable<void()>> callback;
+  };
+
+  TimerId Add(absl::Duration delay, absl::Duration period,
+              absl::AnyInvocable<void()> callback) ABSL_LOCKS_EXCLUDED(mutex_);
+  std::uint64_t ToTicks(absl::Duration duration) const;
+  std::uint64_t GetElapsedTicks() const;
+  void PlaceLocked(TimerId id, std::uint64_t expiry_tick)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Moves the wheel forward by one tick, collecting the timers that expire.
+  void AdvanceLocked(std::vector<ExpiredTimer>& expired)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void Loop() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const absl::Duration tick_;
+  const absl::Time start_time_;
+
+  mutable Mutex mutex_;
+  ConditionVariable cond_{&mutex_};
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  std::uint64_t current_tick_ ABSL_GUARDED_BY(mutex_) = 0;
+  TimerId next_id_ ABSL_GUARDED_BY(mutex_) = 1;
+  TimerId running_id_ ABSL_GUARDED_BY(mutex_) = kInvalidTimerId;
+  absl::flat_hash_map<TimerId, Timer> timers_ ABSL_GUARDED_BY(mutex_);
+  // Slots hold timer ids; a cancelled timer is simply absent from |timers_|
+  // and is skipped when its slot comes up.
+  std::array<std::array<std::vector<TimerId>, kSlots>, kLevels> wheel_
+      ABSL_GUARDED_BY(mutex_);
+
+  SingleThreadExecutor executor_;
+};
+
+}  // namespace nearby
+
+#endif  // PLATFORM_PUBLIC_TIMER_WHEEL_H_
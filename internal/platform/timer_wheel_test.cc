@@ -0,0 +1,176 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/timer_wheel.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+
+namespace nearby {
+namespace {
+
+constexpr absl::Duration kTick = absl::Milliseconds(1);
+constexpr absl::Duration kDefaultTimeout = absl::Seconds(2);
+
+TEST(TimerWheelTest, FiresOneShotTimer) {
+  TimerWheel wheel(kTick);
+  CountDownLatch fired(1);
+  absl::Time start = absl::Now();
+
+  EXPECT_NE(wheel.Schedule(absl::Milliseconds(20), [&fired]() {
+    fired.CountDown();
+  }),
+            TimerWheel::kInvalidTimerId);
+
+  EXPECT_TRUE(fired.Await(kDefaultTimeout).result());
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(20));
+  EXPECT_EQ(wheel.GetPendingTimerCount(), 0);
+}
+
+TEST(TimerWheelTest, FiresTimersInDeadlineOrder) {
+  TimerWheel wheel(kTick);
+  absl::Mutex mutex;
+  std::vector<int> order;
+  CountDownLatch fired(3);
+  auto record = [&](int value) {
+    return [&, value]() {
+      absl::MutexLock lock(&mutex);
+      order.push_back(value);
+      fired.CountDown();
+    };
+  };
+
+  wheel.Schedule(absl::Milliseconds(30), record(3));
+  wheel.Schedule(absl::Milliseconds(10), record(1));
+  wheel.Schedule(absl::Milliseconds(20), record(2));
+
+  EXPECT_TRUE(fired.Await(kDefaultTimeout).result());
+  absl::MutexLock lock(&mutex);
+  EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+}
+
+TEST(TimerWheelTest, FiresTimerBeyondFirstLevel) {
+  // 300 ticks does not fit in the 256 slots of the first level, so the timer
+  // must be cascaded down before it fires.
+  TimerWheel wheel(kTick);
+  CountDownLatch fired(1);
+  absl::Time start = absl::Now();
+
+  wheel.Schedule(absl::Milliseconds(300), [&fired]() { fired.CountDown(); });
+
+  EXPECT_TRUE(fired.Await(kDefaultTimeout).result());
+  EXPECT_GE(absl::Now() - start, absl::Milliseconds(300));
+}
+
+TEST(TimerWheelTest, CancelledTimerDoesNotFire) {
+  TimerWheel wheel(kTick);
+  std::atomic<bool> fired = false;
+
+  TimerWheel::TimerId id =
+      wheel.Schedule(absl::Milliseconds(20), [&fired]() { fired = true; });
+
+  EXPECT_TRUE(wheel.Cancel(id));
+  absl::SleepFor(absl::Milliseconds(50));
+  EXPECT_FALSE(fired);
+  EXPECT_FALSE(wheel.Cancel(id));
+}
+
+TEST(TimerWheelTest, RepeatingTimerFiresUntilCancelled) {
+  TimerWheel wheel(kTick);
+  std::atomic<int> count = 0;
+  CountDownLatch fired(3);
+
+  TimerWheel::TimerId id =
+      wheel.ScheduleRepeating(absl::Milliseconds(5), [&count, &fired]() {
+        count++;
+        fired.CountDown();
+      });
+
+  EXPECT_TRUE(fired.Await(kDefaultTimeout).result());
+  EXPECT_TRUE(wheel.Cancel(id));
+  int count_after_cancel = count;
+  absl::SleepFor(absl::Milliseconds(30));
+  EXPECT_EQ(count, count_after_cancel);
+}
+
+TEST(TimerWheelTest, CancelWaitsForRunningCallback) {
+  TimerWheel wheel(kTick);
+  CountDownLatch started(1);
+  std::atomic<bool> finished = false;
+
+  TimerWheel::TimerId id =
+      wheel.Schedule(absl::Milliseconds(1), [&started, &finished]() {
+        started.CountDown();
+        absl::SleepFor(absl::Milliseconds(50));
+        finished = true;
+      });
+  EXPECT_TRUE(started.Await(kDefaultTimeout).result());
+
+  wheel.Cancel(id);
+
+  EXPECT_TRUE(finished);
+}
+
+TEST(TimerWheelTest, CallbackCanCancelItself) {
+  TimerWheel wheel(kTick);
+  CountDownLatch fired(1);
+  TimerWheel::TimerId id = TimerWheel::kInvalidTimerId;
+  absl::Mutex mutex;
+
+  {
+    absl::MutexLock lock(&mutex);
+    id = wheel.ScheduleRepeating(absl::Milliseconds(5), [&]() {
+      absl::MutexLock lock(&mutex);
+      wheel.Cancel(id);
+      fired.CountDown();
+    });
+  }
+
+  EXPECT_TRUE(fired.Await(kDefaultTimeout).result());
+  absl::SleepFor(absl::Milliseconds(20));
+  EXPECT_EQ(wheel.GetPendingTimerCount(), 0);
+}
+
+TEST(TimerWheelTest, ManyTimersShareOneThread) {
+  TimerWheel wheel(kTick);
+  constexpr int kTimers = 1000;
+  CountDownLatch fired(kTimers);
+
+  for (int i = 0; i < kTimers; i++) {
+    wheel.Schedule(absl::Milliseconds(i % 50),
+                   [&fired]() { fired.CountDown(); });
+  }
+
+  EXPECT_TRUE(fired.Await(kDefaultTimeout).result());
+}
+
+TEST(TimerWheelTest, ScheduleAfterShutdownFails) {
+  TimerWheel wheel(kTick);
+  wheel.Schedule(absl::Seconds(10), []() {});
+
+  wheel.Shutdown();
+
+  EXPECT_EQ(wheel.GetPendingTimerCount(), 0);
+  EXPECT_EQ(wheel.Schedule(absl::Milliseconds(1), []() {}),
+            TimerWheel::kInvalidTimerId);
+}
+
+}  // namespace
+}  // namespace nearby
@@ -0,0 +1,224 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/trace_event.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/system_clock.h"
+
+namespace nearby {
+namespace {
+
+// The viewers need a process id; all events come from this one.
+constexpr int kProcessId = 1;
+
+int GetTraceThreadId() {
+  static std::atomic<int> next_thread_id{1};
+  thread_local int thread_id =
+      next_thread_id.fetch_add(1, std::memory_order_relaxed);
+  return thread_id;
+}
+
+uint64_t NonZero(uint64_t id) { return id == 0 ? 1 : id; }
+
+void AppendJsonString(std::string& out, absl::string_view value) {
+  out.push_back('"');
+  for (char c : value) {
+    switch (c) {
+      case '"':
+        out.append("\\\"");
+        break;
+      case '\\':
+        out.append("\\\\");
+        break;
+      case '\n':
+        out.append("\\n");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          absl::StrAppendFormat(&out, "\\u%04x", c);
+        } else {
+          out.push_back(c);
+        }
+    }
+  }
+  out.push_back('"');
+}
+
+// Appends the fields every event has, without the closing brace.
+void AppendEventHeader(std::string& out, char phase,
+                       absl::string_view category, absl::string_view name,
+                       absl::Time timestamp, int thread_id) {
+  absl::StrAppend(&out, "{\"ph\":\"", absl::string_view(&phase, 1),
+                  "\",\"cat\":");
+  AppendJsonString(out, category);
+  out.append(",\"name\":");
+  AppendJsonString(out, name);
+  absl::StrAppend(&out, ",\"ts\":", absl::ToUnixMicros(timestamp),
+                  ",\"pid\":", kProcessId, ",\"tid\":", thread_id);
+}
+
+}  // namespace
+
+std::atomic<bool> TraceRecorder::enabled_{false};
+
+TraceRecorder& TraceRecorder::GetInstance() {
+  static TraceRecorder* instance = new TraceRecorder();
+  return *instance;
+}
+
+void TraceRecorder::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void TraceRecorder::SetMaxEvents(size_t max_events) {
+  absl::MutexLock lock(&mutex_);
+  max_events_ = max_events;
+}
+
+void TraceRecorder::AddCompleteEvent(absl::string_view category,
+                                     absl::string_view name, absl::Time start,
+                                     absl::Duration duration,
+                                     uint64_t flow_id) {
+  AddEvent({.phase = 'X',
+            .category = std::string(category),
+            .name = std::string(name),
+            .start = start,
+            .duration = duration,
+            .flow_id = flow_id,
+            .thread_id = GetTraceThreadId()});
+}
+
+void TraceRecorder::AddInstantEvent(absl::string_view category,
+                                    absl::string_view name, uint64_t flow_id) {
+  AddEvent({.phase = 'i',
+            .category = std::string(category),
+            .name = std::string(name),
+            .start = SystemClock::ElapsedRealtime(),
+            .flow_id = flow_id,
+            .thread_id = GetTraceThreadId()});
+}
+
+void TraceRecorder::AddEvent(Event event) {
+  absl::MutexLock lock(&mutex_);
+  if (events_.size() >= max_events_) {
+    ++dropped_events_;
+    return;
+  }
+  events_.push_back(std::move(event));
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::GetEvents() const {
+  absl::MutexLock lock(&mutex_);
+  return events_;
+}
+
+int64_t TraceRecorder::GetDroppedEventCount() const {
+  absl::MutexLock lock(&mutex_);
+  return dropped_events_;
+}
+
+std::string TraceRecorder::ToChromeTraceJson() const {
+  std::vector<Event> events = GetEvents();
+  // Complete events are recorded when they end; the flow starts at the one
+  // that began first.
+  std::stable_sort(events.begin(), events.end(),
+                   [](const Event& a, const Event& b) {
+                     return a.start < b.start;
+                   });
+
+  std::string out = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  absl::flat_hash_set<uint64_t> started_flows;
+  bool first = true;
+  for (const Event& event : events) {
+    if (!first) out.push_back(',');
+    first = false;
+    AppendEventHeader(out, event.phase, event.category, event.name,
+                      event.start, event.thread_id);
+    if (event.phase == 'X') {
+      absl::StrAppend(&out, ",\"dur\":",
+                      absl::ToInt64Microseconds(event.duration));
+    } else {
+      out.append(",\"s\":\"t\"");
+    }
+    out.push_back('}');
+    if (event.flow_id == 0) continue;
+
+    // Binds to the event above, as its enclosing slice.
+    char flow_phase = started_flows.insert(event.flow_id).second ? 's' : 't';
+    out.push_back(',');
+    AppendEventHeader(out, flow_phase, event.category, "flow", event.start,
+                      event.thread_id);
+    absl::StrAppend(&out, ",\"id\":\"", absl::Hex(event.flow_id),
+                    "\",\"bp\":\"e\"}");
+  }
+  out.append("]}");
+  return out;
+}
+
+bool TraceRecorder::WriteChromeTrace(const std::filesystem::path& path) const {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) return false;
+  file << ToChromeTraceJson();
+  file.close();
+  return !file.fail();
+}
+
+void TraceRecorder::Clear() {
+  absl::MutexLock lock(&mutex_);
+  events_.clear();
+  dropped_events_ = 0;
+}
+
+uint64_t TraceFlowIdForEndpoint(absl::string_view endpoint_id) {
+  return NonZero(absl::HashOf(absl::string_view("endpoint"), endpoint_id));
+}
+
+uint64_t TraceFlowIdForPayload(int64_t payload_id) {
+  return NonZero(absl::HashOf(absl::string_view("payload"), payload_id));
+}
+
+ScopedTraceEvent::ScopedTraceEvent(absl::string_view category,
+                                   absl::string_view name, uint64_t flow_id) {
+  if (!TraceRecorder::IsEnabled()) return;
+  category_ = std::string(category);
+  name_ = std::string(name);
+  flow_id_ = flow_id;
+  start_ = SystemClock::ElapsedRealtime();
+}
+
+ScopedTraceEvent::~ScopedTraceEvent() {
+  if (start_ == absl::InfinitePast()) return;
+  TraceRecorder::GetInstance().AddCompleteEvent(
+      category_, name_, start_, SystemClock::ElapsedRealtime() - start_,
+      flow_id_);
+}
+
+}  // namespace nearby
@@ -0,0 +1,156 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PLATFORM_PUBLIC_TRACE_EVENT_H_
+#define PLATFORM_PUBLIC_TRACE_EVENT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+
+// Collects trace events and writes them in the Chrome trace event format,
+// which both chrome://tracing and ui.perfetto.dev open.
+//
+// Events are recorded with the NEARBY_TRACE_* macros below. Recording is off
+// unless SetEnabled(true) is called, and then each macro checks one atomic.
+// Building with -DNEARBY_NO_TRACING compiles the macros out entirely.
+//
+// Events may carry a flow id, see TraceFlowIdForEndpoint() and
+// TraceFlowIdForPayload(). The viewers draw arrows between the events of one
+// flow, so that e.g. a payload can be followed from the thread that sends its
+// chunks to the executor that reports its progress.
+class TraceRecorder {
+ public:
+  static constexpr size_t kDefaultMaxEvents = 1 << 18;
+
+  struct Event {
+    // 'X' for a complete event with a duration, 'i' for an instant event.
+    char phase = 'X';
+    std::string category;
+    std::string name;
+    absl::Time start = absl::InfinitePast();
+    absl::Duration duration = absl::ZeroDuration();
+    // 0 if the event is not part of a flow.
+    uint64_t flow_id = 0;
+    // Small per-process id of the recording thread.
+    int thread_id = 0;
+  };
+
+  static TraceRecorder& GetInstance();
+
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+  static void SetEnabled(bool enabled);
+
+  // Caps the number of buffered events; events past the cap are dropped and
+  // counted.
+  void SetMaxEvents(size_t max_events) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  void AddCompleteEvent(absl::string_view category, absl::string_view name,
+                        absl::Time start, absl::Duration duration,
+                        uint64_t flow_id = 0) ABSL_LOCKS_EXCLUDED(mutex_);
+  void AddInstantEvent(absl::string_view category, absl::string_view name,
+                       uint64_t flow_id = 0) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the buffered events in the order they were recorded.
+  std::vector<Event> GetEvents() const ABSL_LOCKS_EXCLUDED(mutex_);
+  int64_t GetDroppedEventCount() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns the buffered events as a Chrome trace JSON object.
+  std::string ToChromeTraceJson() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Writes ToChromeTraceJson() to `path`. Returns false on I/O errors.
+  bool WriteChromeTrace(const std::filesystem::path& path) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops all buffered events.
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  TraceRecorder() = default;
+
+  void AddEvent(Event event) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  static std::atomic<bool> enabled_;
+
+  // Not a nearby::Mutex, which may itself be traced or profiled.
+  mutable absl::Mutex mutex_;
+  size_t max_events_ ABSL_GUARDED_BY(mutex_) = kDefaultMaxEvents;
+  std::vector<Event> events_ ABSL_GUARDED_BY(mutex_);
+  int64_t dropped_events_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+// Flow ids of an endpoint and of a payload. Never 0.
+uint64_t TraceFlowIdForEndpoint(absl::string_view endpoint_id);
+uint64_t TraceFlowIdForPayload(int64_t payload_id);
+
+// Records a complete event covering its own lifetime. Use NEARBY_TRACE_EVENT
+// instead of naming this directly, so that the event compiles out with
+// tracing.
+class ScopedTraceEvent {
+ public:
+  ScopedTraceEvent(absl::string_view category, absl::string_view name,
+                   uint64_t flow_id = 0);
+  ~ScopedTraceEvent();
+  ScopedTraceEvent(const ScopedTraceEvent&) = delete;
+  ScopedTraceEvent& operator=(const ScopedTraceEvent&) = delete;
+
+ private:
+  // Empty while tracing is off, so a disabled event copies no strings.
+  std::string category_;
+  std::string name_;
+  uint64_t flow_id_ = 0;
+  absl::Time start_ = absl::InfinitePast();
+};
+
+}  // namespace nearby
+
+#define NEARBY_TRACE_CONCAT_INNER(a, b) a##b
+#define NEARBY_TRACE_CONCAT(a, b) NEARBY_TRACE_CONCAT_INNER(a, b)
+
+#if defined(NEARBY_NO_TRACING)
+#define NEARBY_TRACE_EVENT(category, name) static_cast<void>(0)
+#define NEARBY_TRACE_EVENT_WITH_FLOW(category, name, flow_id) \
+  static_cast<void>(0)
+#define NEARBY_TRACE_INSTANT(category, name, flow_id) static_cast<void>(0)
+#else
+// Traces the rest of the enclosing scope.
+#define NEARBY_TRACE_EVENT(category, name)                            \
+  ::nearby::ScopedTraceEvent NEARBY_TRACE_CONCAT(nearby_trace_event_, \
+                                                 __LINE__)(category, name)
+// Traces the rest of the enclosing scope as a step of flow `flow_id`.
+#define NEARBY_TRACE_EVENT_WITH_FLOW(category, name, flow_id)         \
+  ::nearby::ScopedTraceEvent NEARBY_TRACE_CONCAT(nearby_trace_event_, \
+                                                 __LINE__)(           \
+      category, name, ::nearby::TraceRecorder::IsEnabled() ? (flow_id) : 0)
+// Records a point in time as a step of flow `flow_id`, or of no flow if 0.
+#define NEARBY_TRACE_INSTANT(category, name, flow_id)                 \
+  do {                                                                \
+    if (::nearby::TraceRecorder::IsEnabled()) {                       \
+      ::nearby::TraceRecorder::GetInstance().AddInstantEvent(         \
+          category, name, (flow_id));                                 \
+    }                                                                 \
+  } while (0)
+#endif
+
+#endif  // PLATFORM_PUBLIC_TRACE_EVENT_H_
@@ -0,0 +1,133 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "internal/platform/trace_event.h"
+
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+
+namespace nearby {
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+class TraceEventTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TraceRecorder::GetInstance().Clear();
+    TraceRecorder::GetInstance().SetMaxEvents(
+        TraceRecorder::kDefaultMaxEvents);
+    TraceRecorder::SetEnabled(true);
+  }
+  void TearDown() override { TraceRecorder::SetEnabled(false); }
+};
+
+TEST_F(TraceEventTest, RecordsNothingWhileDisabled) {
+  TraceRecorder::SetEnabled(false);
+
+  {
+    NEARBY_TRACE_EVENT("test", "Scope");
+    NEARBY_TRACE_INSTANT("test", "Instant", 0);
+  }
+
+  EXPECT_TRUE(TraceRecorder::GetInstance().GetEvents().empty());
+}
+
+TEST_F(TraceEventTest, ScopeRecordsCompleteEvent) {
+  {
+    std::string name = "Scope";
+    NEARBY_TRACE_EVENT("test", name);
+    // The event keeps its own copy of the name.
+    name = "Changed";
+  }
+
+  std::vector<TraceRecorder::Event> events =
+      TraceRecorder::GetInstance().GetEvents();
+  ASSERT_EQ(events.size(), 1);
+  EXPECT_EQ(events[0].phase, 'X');
+  EXPECT_EQ(events[0].category, "test");
+  EXPECT_EQ(events[0].name, "Scope");
+  EXPECT_GE(events[0].duration, absl::ZeroDuration());
+  EXPECT_EQ(events[0].flow_id, 0);
+}
+
+TEST_F(TraceEventTest, FlowIdsTellEndpointsAndPayloadsApart) {
+  EXPECT_NE(TraceFlowIdForEndpoint("ABCD"), 0);
+  EXPECT_EQ(TraceFlowIdForEndpoint("ABCD"), TraceFlowIdForEndpoint("ABCD"));
+  EXPECT_NE(TraceFlowIdForEndpoint("ABCD"), TraceFlowIdForEndpoint("EFGH"));
+  EXPECT_EQ(TraceFlowIdForPayload(42), TraceFlowIdForPayload(42));
+  EXPECT_NE(TraceFlowIdForPayload(42), TraceFlowIdForPayload(43));
+}
+
+TEST_F(TraceEventTest, JsonLinksEventsOfOneFlow) {
+  uint64_t flow_id = TraceFlowIdForPayload(42);
+  { NEARBY_TRACE_EVENT_WITH_FLOW("test", "SendChunk", flow_id); }
+  NEARBY_TRACE_INSTANT("test", "ChunkReceived", flow_id);
+
+  std::string json = TraceRecorder::GetInstance().ToChromeTraceJson();
+
+  EXPECT_THAT(json, HasSubstr("\"traceEvents\":["));
+  EXPECT_THAT(json, HasSubstr("\"ph\":\"X\",\"cat\":\"test\","
+                              "\"name\":\"SendChunk\""));
+  EXPECT_THAT(json, HasSubstr("\"ph\":\"i\",\"cat\":\"test\","
+                              "\"name\":\"ChunkReceived\""));
+  // The flow starts at the first event and steps through the second.
+  EXPECT_THAT(json, HasSubstr("\"ph\":\"s\""));
+  EXPECT_THAT(json, HasSubstr("\"ph\":\"t\""));
+}
+
+TEST_F(TraceEventTest, JsonEscapesNames) {
+  NEARBY_TRACE_INSTANT("test", "say \"hi\"\\", 0);
+
+  std::string json = TraceRecorder::GetInstance().ToChromeTraceJson();
+
+  EXPECT_THAT(json, HasSubstr("\"name\":\"say \\\"hi\\\"\\\\\""));
+}
+
+TEST_F(TraceEventTest, DropsEventsPastTheCap) {
+  TraceRecorder::GetInstance().SetMaxEvents(2);
+
+  for (int i = 0; i < 5; ++i) {
+    NEARBY_TRACE_INSTANT("test", "Instant", 0);
+  }
+
+  EXPECT_EQ(TraceRecorder::GetInstance().GetEvents().size(), 2);
+  EXPECT_EQ(TraceRecorder::GetInstance().GetDroppedEventCount(), 3);
+}
+
+TEST_F(TraceEventTest, WritesTraceFile) {
+  NEARBY_TRACE_INSTANT("test", "Written", 0);
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() / "trace_event_test.json";
+
+  ASSERT_TRUE(TraceRecorder::GetInstance().WriteChromeTrace(path));
+
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  EXPECT_EQ(contents.str(), TraceRecorder::GetInstance().ToChromeTraceJson());
+  EXPECT_THAT(contents.str(), Not(HasSubstr("\"dur\"")));
+  std::filesystem::remove(path);
+}
+
+}  // namespace
+}  // namespace nearby
@@ -174,10 +174,12 @@ class WifiDirectMedium {
   }
   bool StopWifiDirect() { return impl_->StopWifiDirect(); }
 
-  bool ConnectWifiDirect(absl::string_view ssid, absl::string_view password) {
+  bool ConnectWifiDirect(absl::string_view ssid, absl::string_view password,
+                         int frequency = -1) {
     MutexLock lock(&mutex_);
     wifi_direct_credentials_.SetSSID(std::string(ssid));
     wifi_direct_credentials_.SetPassword(std::string(password));
+    wifi_direct_credentials_.SetFrequency(frequency);
     return impl_->ConnectWifiDirect(&wifi_direct_credentials_);
   }
   bool DisconnectWifiDirect() { return impl_->DisconnectWifiDirect(); }
@@ -14,6 +14,7 @@
 
 #include "internal/weave/base_socket.h"
 
+#include <algorithm>
 #include <deque>
 #include <string>
 #include <utility>
@@ -77,6 +78,7 @@ BaseSocket::BaseSocket(const Connection& connection, SocketCallback&& callback)
            },
        .on_disconnected_cb = [this]() { DisconnectQuietly(); }});
   max_packet_size_ = connection_.GetMaxPacketSize();
+  max_packets_in_flight_ = std::max(connection_.GetMaxPacketsInFlight(), 1);
 }
 
 BaseSocket::~BaseSocket() {
@@ -100,13 +102,26 @@ void BaseSocket::TryWriteNextControl() {
   if (current_control_ == nullptr) {
     return;
   }
+  // Only one control packet is transmitted at a time. Control packets are not
+  // held back by the message packets in flight though, so that an error
+  // packet goes out right away.
+  for (InFlightPacket kind : in_flight_packets_) {
+    if (kind == InFlightPacket::kControl) return;
+  }
   // We need to do this because if a control packet is being sent, it is
   // one of three packets. ConnectionRequest, ConnectionConfirm, or Error.
   // In any case, we should not have any messages in the queue from the previous
   // connection.
   current_message_ = nullptr;
   message_request_queue_.clear();
-  WritePacket(current_control_->NextPacket(max_packet_size_));
+  // The message packets still in flight no longer complete a message.
+  for (InFlightPacket& kind : in_flight_packets_) {
+    if (kind == InFlightPacket::kMessageEnd) {
+      kind = InFlightPacket::kMessagePart;
+    }
+  }
+  WritePacket(current_control_->NextPacket(max_packet_size_),
+              InFlightPacket::kControl);
 }
 
 void BaseSocket::TryWriteNextMessage() {
@@ -122,26 +137,83 @@ void BaseSocket::TryWriteNextMessage() {
   }
   bool connected = IsConnected();
   MutexLock lock(&mutex_);
-  if (current_message_ == nullptr) {
-    if (!message_request_queue_.empty()) {
-      current_message_ = &message_request_queue_.front();
+  CompleteEmptyMessages();
+  // Keeps up to `max_packets_in_flight_` packets in flight, moving on to the
+  // next message while the last packets of the previous one are transmitted.
+  while (connected && in_flight_packets_.size() <
+                          static_cast<size_t>(max_packets_in_flight_)) {
+    if (current_message_ == nullptr || current_message_->IsFinished()) {
+      current_message_ = nullptr;
+      for (MessageWriteRequest& request : message_request_queue_) {
+        if (!request.IsFinished()) {
+          current_message_ = &request;
+          break;
+        }
+      }
+    }
+    if (current_message_ == nullptr) {
+      return;
+    }
+    absl::StatusOr<Packet> packet =
+        current_message_->NextPacket(max_packet_size_);
+    if (!WritePacket(std::move(packet), current_message_->IsFinished()
+                                            ? InFlightPacket::kMessageEnd
+                                            : InFlightPacket::kMessagePart)) {
+      return;
     }
   }
-  if (current_message_ == nullptr || current_message_->IsFinished() ||
-      !connected) {
-    return;
+}
+
+void BaseSocket::CompleteEmptyMessages() {
+  while (!message_request_queue_.empty() &&
+         !message_request_queue_.front().IsStarted() &&
+         message_request_queue_.front().IsFinished()) {
+    message_request_queue_.front().SetWriteStatus(absl::OkStatus());
+    if (current_message_ == &message_request_queue_.front()) {
+      current_message_ = nullptr;
+    }
+    message_request_queue_.pop_front();
   }
-  WritePacket(current_message_->NextPacket(max_packet_size_));
 }
 
-void BaseSocket::WritePacket(absl::StatusOr<Packet> packet) {
+std::string BaseSocket::TakeInitialMessage(size_t max_size) {
+  MutexLock lock(&mutex_);
+  if (state_ == SocketConnectionState::kConnected ||
+      message_request_queue_.empty()) {
+    return "";
+  }
+  MessageWriteRequest& request = message_request_queue_.front();
+  if (request.IsStarted() || request.IsFinished() ||
+      request.message().size() > max_size) {
+    return "";
+  }
+  std::string message = request.message();
+  request.SetWriteStatus(absl::OkStatus());
+  if (current_message_ == &request) {
+    current_message_ = nullptr;
+  }
+  message_request_queue_.pop_front();
+  return message;
+}
+
+bool BaseSocket::WritePacket(absl::StatusOr<Packet> packet,
+                             InFlightPacket kind) {
   if (!packet.ok()) {
     NEARBY_LOGS(WARNING) << "Packet status:" << packet.status();
-    return;
+    return false;
   }
   CHECK_OK(packet->SetPacketCounter(packet_counter_generator_.Next()));
+  if (!in_flight_packets_.empty()) {
+    write_stats_.pipelined_packets_written++;
+  }
+  in_flight_packets_.push_back(kind);
+  write_stats_.packets_written++;
+  write_stats_.peak_packets_in_flight =
+      std::max(write_stats_.peak_packets_in_flight,
+               static_cast<int>(in_flight_packets_.size()));
   NEARBY_LOGS(INFO) << "transmitting packet";
   connection_.Transmit(packet->GetBytes());
+  return true;
 }
 
 void BaseSocket::OnWriteRequestWriteComplete(absl::Status status) {
@@ -151,19 +223,25 @@ void BaseSocket::OnWriteRequestWriteComplete(absl::Status status) {
           ABSL_LOCKS_EXCLUDED(mutex_) mutable {
             {
               MutexLock lock(&mutex_);
-              if (current_control_ != nullptr) {
-                current_control_ = nullptr;
-                control_request_queue_.pop_front();
-              } else if (current_message_ != nullptr) {
-                NEARBY_LOGS(INFO) << "OnWriteResult current is not null";
-                if (current_message_->IsFinished()) {
-                  NEARBY_LOGS(INFO) << "OnWriteResult current finished";
-                  current_message_->SetWriteStatus(status);
-                  if (!message_request_queue_.empty() &&
-                      current_message_ == &message_request_queue_.front()) {
+              // Packets are completed in the order they were transmitted.
+              // There is nothing in flight if the socket has been reset in
+              // the meantime.
+              if (!in_flight_packets_.empty()) {
+                InFlightPacket kind = in_flight_packets_.front();
+                in_flight_packets_.pop_front();
+                if (kind == InFlightPacket::kControl &&
+                    current_control_ != nullptr) {
+                  current_control_ = nullptr;
+                  control_request_queue_.pop_front();
+                } else if (kind == InFlightPacket::kMessageEnd) {
+                  CompleteEmptyMessages();
+                  if (!message_request_queue_.empty()) {
                     NEARBY_LOGS(INFO) << "remove message";
+                    message_request_queue_.front().SetWriteStatus(status);
+                    if (current_message_ == &message_request_queue_.front()) {
+                      current_message_ = nullptr;
+                    }
                     message_request_queue_.pop_front();
-                    current_message_ = nullptr;
                   }
                 }
               }
@@ -229,7 +307,15 @@ void BaseSocket::DisconnectQuietly() {
                             control_request_queue_.clear();
                             current_control_ = nullptr;
                             current_message_ = nullptr;
+                            in_flight_packets_.clear();
                             state_ = SocketConnectionState::kDisconnected;
+                            NEARBY_LOGS(INFO)
+                                << "Packets written: "
+                                << write_stats_.packets_written
+                                << ", pipelined: "
+                                << write_stats_.pipelined_packets_written
+                                << ", peak in flight: "
+                                << write_stats_.peak_packets_in_flight;
                           }
                           NEARBY_LOGS(INFO) << "Socket now disconnected.";
                         });
@@ -293,6 +379,11 @@ bool BaseSocket::IsConnected() {
   return state_ == SocketConnectionState::kConnected;
 }
 
+BaseSocket::WriteStats BaseSocket::GetWriteStats() {
+  MutexLock lock(&mutex_);
+  return write_stats_;
+}
+
 void BaseSocket::OnConnected(int new_max_packet_size) {
   RunOnSocketThread("TryWriteOnConnected",
                     [this, new_max_packet_size]()
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_INTERNAL_WEAVE_BASE_SOCKET_H_
 #define THIRD_PARTY_NEARBY_INTERNAL_WEAVE_BASE_SOCKET_H_
 
+#include <cstddef>
 #include <deque>
 #include <string>
 #include <utility>
@@ -42,10 +43,19 @@ namespace weave {
 // messages.
 class BaseSocket {
  public:
+  // Counters of the packets written on the socket since it was created.
+  struct WriteStats {
+    int packets_written = 0;
+    // Packets written while earlier packets were still being transmitted.
+    int pipelined_packets_written = 0;
+    int peak_packets_in_flight = 0;
+  };
+
   BaseSocket(const Connection& connection, SocketCallback&& callback);
   virtual ~BaseSocket();
 
   bool IsConnected() ABSL_LOCKS_EXCLUDED(mutex_);
+  WriteStats GetWriteStats() ABSL_LOCKS_EXCLUDED(mutex_);
   void Disconnect();
   nearby::Future<absl::Status> Write(ByteArray message);
   virtual void Connect() = 0;
@@ -65,6 +75,12 @@ class BaseSocket {
     executor_.Execute(name, std::move(runnable));
   }
   void ShutDown();
+  // Takes the first message written before the socket connected, if it is no
+  // longer than |max_size|, so that it rides along in a handshake packet
+  // instead of waiting for the handshake to complete. The message is
+  // completed successfully. Returns an empty string if there is none. Must be
+  // called on the socket thread.
+  std::string TakeInitialMessage(size_t max_size) ABSL_LOCKS_EXCLUDED(mutex_);
 
   // Test only functions.
   void AddControlPacket(Packet packet) ABSL_LOCKS_EXCLUDED(mutex_) {
@@ -83,6 +99,13 @@ class BaseSocket {
     kConnected
   };
 
+  // What a transmitted packet completes once its write completes.
+  enum class InFlightPacket {
+    kControl,
+    kMessagePart,
+    kMessageEnd,
+  };
+
   bool IsRemotePacketCounterExpected(int counter);
   void TryWriteNextControl() ABSL_EXCLUSIVE_LOCKS_REQUIRED(executor_)
       ABSL_LOCKS_EXCLUDED(mutex_);
@@ -90,7 +113,10 @@ class BaseSocket {
       ABSL_LOCKS_EXCLUDED(mutex_);
   void OnWriteRequestWriteComplete(absl::Status status)
       ABSL_LOCKS_EXCLUDED(executor_);
-  void WritePacket(absl::StatusOr<Packet> packet);
+  // Completes the messages at the front of the queue that have no packets.
+  void CompleteEmptyMessages() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  bool WritePacket(absl::StatusOr<Packet> packet, InFlightPacket kind)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   Mutex mutex_;
   // Messages and controls are in two separate queues to separate their control
@@ -101,9 +127,13 @@ class BaseSocket {
       ABSL_GUARDED_BY(mutex_);
   ControlPacketWriteRequest* current_control_ = nullptr;
   MessageWriteRequest* current_message_ = nullptr;
+  // The packets transmitted and not completed yet, in transmit order.
+  std::deque<InFlightPacket> in_flight_packets_ ABSL_GUARDED_BY(mutex_);
+  WriteStats write_stats_ ABSL_GUARDED_BY(mutex_);
   SocketConnectionState state_ ABSL_GUARDED_BY(mutex_) =
       SocketConnectionState::kDisconnected;
   int max_packet_size_;
+  int max_packets_in_flight_;
   Packetizer packetizer_;
   PacketSequenceNumberGenerator packet_counter_generator_;
   PacketSequenceNumberGenerator remote_packet_counter_generator_;
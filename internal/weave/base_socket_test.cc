@@ -47,6 +47,7 @@ class FakeConnection : public Connection {
   }
 
   int GetMaxPacketSize() const override { return max_packet_size_; }
+  int GetMaxPacketsInFlight() const override { return max_packets_in_flight_; }
   void Transmit(std::string packet) override {
     absl::MutexLock lock(&mutex_);
     packets_written_.push_back(packet);
@@ -73,6 +74,9 @@ class FakeConnection : public Connection {
   void SetInstantTransmit(bool instant_transmit) {
     instant_transmit_ = instant_transmit;
   }
+  void SetMaxPacketsInFlight(int max_packets_in_flight) {
+    max_packets_in_flight_ = max_packets_in_flight;
+  }
   void OnTransmitProxy(absl::Status status) {
     callback_.on_transmit_cb(status);
   }
@@ -82,6 +86,7 @@ class FakeConnection : public Connection {
 
  protected:
   int max_packet_size_;
+  int max_packets_in_flight_ = 1;
   ConnectionCallback callback_;
   absl::Mutex mutex_;
   std::vector<std::string> packets_written_ ABSL_GUARDED_BY(mutex_);
@@ -489,6 +494,78 @@ TEST_F(BaseSocketTest, TestDisconnectOnBadDataPacketCounter) {
   EXPECT_FALSE(connected_);
 }
 
+SocketCallback CreateIgnoringSocketCallback() {
+  return SocketCallback{
+      .on_connected_cb = []() {},
+      .on_disconnected_cb = []() {},
+      .on_receive_cb = [](std::string) {},
+      .on_error_cb = [](absl::Status) {},
+  };
+}
+
+TEST(BaseSocketPipeliningTest, WritesPacketsUpToTheInFlightLimit) {
+  FakeConnection connection(kMaxPacketSize);
+  connection.SetInstantTransmit(false);
+  connection.SetMaxPacketsInFlight(3);
+  FakeSocket socket(connection, CreateIgnoringSocketCallback());
+  socket.OnConnectedProxy(kMaxPacketSize);
+
+  // Four packets of two bytes each.
+  nearby::Future<absl::Status> result =
+      socket.Write(ByteArray("\x01\x02\x03\x04\x05\x06\x07\x08"));
+  absl::SleepFor(absl::Milliseconds(10));
+  EXPECT_EQ(connection.PollWrittenPacket(),
+            CreateDataPacket(0, true, false, ByteArray("\x01\x02")).GetBytes());
+  EXPECT_EQ(
+      connection.PollWrittenPacket(),
+      CreateDataPacket(1, false, false, ByteArray("\x03\x04")).GetBytes());
+  EXPECT_EQ(
+      connection.PollWrittenPacket(),
+      CreateDataPacket(2, false, false, ByteArray("\x05\x06")).GetBytes());
+  EXPECT_TRUE(connection.NoMorePackets());
+
+  connection.OnTransmitProxy(absl::OkStatus());
+  absl::SleepFor(absl::Milliseconds(10));
+  EXPECT_EQ(connection.PollWrittenPacket(),
+            CreateDataPacket(3, false, true, ByteArray("\x07\x08")).GetBytes());
+  for (int i = 0; i < 2; i++) {
+    connection.OnTransmitProxy(absl::OkStatus());
+  }
+  absl::SleepFor(absl::Milliseconds(10));
+  EXPECT_FALSE(result.IsSet());
+
+  connection.OnTransmitProxy(absl::OkStatus());
+  EXPECT_OK(result.Get().GetResult());
+  BaseSocket::WriteStats stats = socket.GetWriteStats();
+  EXPECT_EQ(stats.packets_written, 4);
+  EXPECT_EQ(stats.pipelined_packets_written, 3);
+  EXPECT_EQ(stats.peak_packets_in_flight, 3);
+}
+
+TEST(BaseSocketPipeliningTest, CompletesPipelinedMessagesInOrder) {
+  FakeConnection connection(kMaxPacketSize);
+  connection.SetInstantTransmit(false);
+  connection.SetMaxPacketsInFlight(2);
+  FakeSocket socket(connection, CreateIgnoringSocketCallback());
+  socket.OnConnectedProxy(kMaxPacketSize);
+
+  nearby::Future<absl::Status> first = socket.Write(ByteArray("\x01"));
+  nearby::Future<absl::Status> second = socket.Write(ByteArray("\x02"));
+  absl::SleepFor(absl::Milliseconds(10));
+  EXPECT_EQ(connection.PollWrittenPacket(),
+            CreateDataPacket(0, true, true, ByteArray("\x01")).GetBytes());
+  EXPECT_EQ(connection.PollWrittenPacket(),
+            CreateDataPacket(1, true, true, ByteArray("\x02")).GetBytes());
+
+  connection.OnTransmitProxy(absl::OkStatus());
+  EXPECT_OK(first.Get().GetResult());
+  absl::SleepFor(absl::Milliseconds(10));
+  EXPECT_FALSE(second.IsSet());
+
+  connection.OnTransmitProxy(absl::OkStatus());
+  EXPECT_OK(second.Get().GetResult());
+}
+
 }  // namespace
 }  // namespace weave
 }  // namespace nearby
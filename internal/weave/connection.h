@@ -36,6 +36,10 @@ class Connection {
   virtual ~Connection() = default;
   virtual void Initialize(ConnectionCallback callback) = 0;
   virtual int GetMaxPacketSize() const = 0;
+  // Returns how many packets the socket may transmit before the first of them
+  // completes. Connections writing without response can accept several packets
+  // per connection interval.
+  virtual int GetMaxPacketsInFlight() const { return 1; }
   virtual void Transmit(std::string packet) = 0;
   virtual void Close() = 0;
 };
@@ -36,6 +36,7 @@ class MessageWriteRequest {
 
   bool IsStarted() const;
   bool IsFinished() const;
+  const std::string& message() const { return message_; }
 
   absl::StatusOr<Packet> NextPacket(int max_packet_size);
 
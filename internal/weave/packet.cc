@@ -35,8 +35,6 @@ constexpr char kControlType = 0b10000000;
 constexpr char kDataType = 0b00000000;
 constexpr char kMaskPacketCounter = 0b01110000;
 constexpr char kMaskControlCommandNumber = 0b00001111;
-constexpr int kConnectionRequestExtraDataSize = 13;
-constexpr int kConnectionConfirmExtraDataSize = 15;
 constexpr int kConnectionConfirmPacketHeaderLength = 4;
 constexpr int kConnectionRequestPacketHeaderLength = 6;
 }  // namespace
@@ -63,7 +61,7 @@ Packet Packet::CreateControlPacket(ControlPacketType command_number,
 absl::StatusOr<Packet> Packet::CreateConnectionRequestPacket(
     int16_t min_protocol_version, int16_t max_protocol_version,
     int16_t max_packet_size, absl::string_view extra_data) {
-  if (extra_data.size() > kConnectionRequestExtraDataSize) {
+  if (extra_data.size() > kConnectionRequestMaxExtraDataSize) {
     return absl::InvalidArgumentError(
         "Connection request packet may contain at most 13 bytes of extra "
         "data.");
@@ -102,7 +100,7 @@ absl::StatusOr<Packet> Packet::CreateConnectionRequestPacket(
 absl::StatusOr<Packet> Packet::CreateConnectionConfirmPacket(
     int16_t selected_protocol_version, int16_t selected_packet_size,
     absl::string_view extra_data) {
-  if (extra_data.size() > kConnectionConfirmExtraDataSize) {
+  if (extra_data.size() > kConnectionConfirmMaxExtraDataSize) {
     return absl::InvalidArgumentError(
         "Connection confirm packet may contain at most 15 bytes of extra "
         "data.");
@@ -85,6 +85,9 @@ class Packet {
  public:
   static constexpr int kMaxPacketCounter = 0b111;
   static constexpr int kPacketHeaderLength = 1;
+  // The most extra data a connection request or confirm packet carries.
+  static constexpr int kConnectionRequestMaxExtraDataSize = 13;
+  static constexpr int kConnectionConfirmMaxExtraDataSize = 15;
   enum class ControlPacketType {
     kControlConnectionRequest = 0,
     kControlConnectionConfirm = 1,
@@ -131,6 +134,10 @@ class Packet {
   int GetPacketCounter() const;
   ControlPacketType GetControlCommandNumber() const;
   std::string GetPayload() const { return bytes_.substr(kPacketHeaderLength); }
+  // Same as GetPayload(), without copying. Only valid while the packet is.
+  absl::string_view GetPayloadView() const {
+    return absl::string_view(bytes_).substr(kPacketHeaderLength);
+  }
   std::string GetBytes() const { return bytes_; }
   absl::Status SetPacketCounter(int packetCounter);
   std::string ToString();
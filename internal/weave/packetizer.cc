@@ -18,7 +18,7 @@
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
-#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "internal/platform/byte_array.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/weave/packet.h"
@@ -42,7 +42,11 @@ absl::Status Packetizer::AddPacket(Packet packet) {
         "Packet marked as first packet cannot be added if there are existing "
         "packets.");
   }
-  absl::StrAppend(&pending_payloads_, packet.GetPayload());
+  if (packet.IsFirstPacket()) {
+    pending_payloads_.reserve(last_message_size_);
+  }
+  absl::string_view payload = packet.GetPayloadView();
+  pending_payloads_.append(payload.data(), payload.size());
   if (packet.IsLastPacket()) {
     is_message_complete_ = true;
   }
@@ -55,6 +59,7 @@ absl::StatusOr<ByteArray> Packetizer::TakeMessage() {
     return absl::UnavailableError(
         "Full message is not available, no last packet added yet.");
   }
+  last_message_size_ = pending_payloads_.size();
   ByteArray message = ByteArray(std::move(pending_payloads_));
   pending_payloads_.clear();
   is_message_complete_ = false;
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_INTERNAL_WEAVE_PACKETIZER_H_
 #define THIRD_PARTY_NEARBY_INTERNAL_WEAVE_PACKETIZER_H_
 
+#include <cstddef>
 #include <string>
 
 #include "absl/status/statusor.h"
@@ -48,6 +49,9 @@ class Packetizer {
  private:
   Mutex mutex_;
   std::string pending_payloads_ ABSL_GUARDED_BY(mutex_);
+  // Size of the last message taken, used to reserve the buffer of the next one
+  // since Weave packets don't carry the message length.
+  size_t last_message_size_ ABSL_GUARDED_BY(mutex_) = 0;
   bool is_message_complete_ ABSL_GUARDED_BY(mutex_) = false;
 };
 }  // namespace weave
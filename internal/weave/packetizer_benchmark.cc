@@ -0,0 +1,75 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/status/statusor.h"
+#include "internal/platform/byte_array.h"
+#include "internal/weave/packet.h"
+#include "internal/weave/packetizer.h"
+
+namespace nearby {
+namespace weave {
+namespace {
+
+// The payload of a data packet at the default 20 byte BLE packet size.
+constexpr int kPayloadSize = 19;
+
+// Returns the received bytes of a message split into |packet_count| packets.
+std::vector<ByteArray> MakePackets(int64_t packet_count) {
+  std::vector<ByteArray> packets;
+  packets.reserve(packet_count);
+  for (int64_t i = 0; i < packet_count; i++) {
+    Packet packet = Packet::CreateDataPacket(
+        /*is_first_packet=*/i == 0, /*is_last_packet=*/i == packet_count - 1,
+        ByteArray(std::string(kPayloadSize, static_cast<char>(i * 31))));
+    packets.push_back(ByteArray(packet.GetBytes()));
+  }
+  return packets;
+}
+
+// Reassembles a message the way BaseSocket does on receive: each packet is
+// parsed from the received bytes and added, and the message is taken once
+// complete.
+void BM_JoinMessage(benchmark::State& state) {
+  const std::vector<ByteArray> packets = MakePackets(state.range(0));
+  Packetizer packetizer;
+
+  for (auto _ : state) {
+    for (const ByteArray& bytes : packets) {
+      absl::StatusOr<Packet> packet = Packet::FromBytes(bytes);
+      if (!packet.ok() || !packetizer.AddPacket(*std::move(packet)).ok()) {
+        state.SkipWithError("add packet failed");
+        return;
+      }
+    }
+    absl::StatusOr<ByteArray> message = packetizer.TakeMessage();
+    if (!message.ok()) {
+      state.SkipWithError("take message failed");
+      return;
+    }
+    benchmark::DoNotOptimize(message->data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * kPayloadSize);
+}
+BENCHMARK(BM_JoinMessage)->RangeMultiplier(8)->Range(1, 1 << 12);
+
+}  // namespace
+}  // namespace weave
+}  // namespace nearby
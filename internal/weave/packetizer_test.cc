@@ -14,6 +14,7 @@
 
 #include "internal/weave/packetizer.h"
 
+#include <string>
 #include <utility>
 
 #include "gmock/gmock.h"
@@ -116,6 +117,25 @@ TEST(PacketizerTest, TestAddTwoFirstPacketsFails) {
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST(PacketizerTest, TestJoinsMessagesOfManyPackets) {
+  Packetizer packetizer;
+  // A long message followed by a shorter one, which must not contain any of
+  // the bytes of the first.
+  for (int packet_count : {300, 100}) {
+    std::string expected;
+    for (int i = 0; i < packet_count; i++) {
+      std::string payload(19, static_cast<char>('a' + i % 26));
+      expected.append(payload);
+      EXPECT_OK(packetizer.AddPacket(Packet::CreateDataPacket(
+          /*is_first_packet=*/i == 0,
+          /*is_last_packet=*/i == packet_count - 1, ByteArray(payload))));
+    }
+    absl::StatusOr<ByteArray> message = packetizer.TakeMessage();
+    ASSERT_OK(message);
+    EXPECT_EQ(message->string_data(), expected);
+  }
+}
+
 }  // namespace
 }  // namespace weave
 }  // namespace nearby
@@ -141,17 +141,24 @@ void ServerSocket::OnReceiveControlPacket(Packet packet) {
 
 void ServerSocket::WriteConnectionConfirm() {
   state_ = State::kServerConfirm;
-  absl::StatusOr<Packet> packet = Packet::CreateConnectionConfirmPacket(
-      kProtocolVersion, max_packet_size_, "");
-  if (!packet.ok()) {
-    NEARBY_LOGS(ERROR) << "Failed to create connection confirm packet: "
-                       << packet.status();
-    DisconnectInternal(packet.status());
-    return;
-  }
-  WriteControlPacket(std::move(*packet));
-  state_ = State::kHandshakeCompleted;
-  OnConnected(max_packet_size_);
+  // The confirm is built on the socket thread, behind any message the
+  // receive callback above wrote in reply to the request's data, so that a
+  // short reply rides along in the confirm instead of costing another round
+  // trip once connected.
+  RunOnSocketThread("WriteConnectionConfirm", [this]() {
+    absl::StatusOr<Packet> packet = Packet::CreateConnectionConfirmPacket(
+        kProtocolVersion, max_packet_size_,
+        TakeInitialMessage(Packet::kConnectionConfirmMaxExtraDataSize));
+    if (!packet.ok()) {
+      NEARBY_LOGS(ERROR) << "Failed to create connection confirm packet: "
+                         << packet.status();
+      DisconnectInternal(packet.status());
+      return;
+    }
+    WriteControlPacket(std::move(*packet));
+    state_ = State::kHandshakeCompleted;
+    OnConnected(max_packet_size_);
+  });
 }
 
 }  // namespace weave
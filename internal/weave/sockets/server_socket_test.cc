@@ -110,8 +110,13 @@ class ServerSocketTest : public ::testing::Test {
                                          },
                                      .on_receive_cb =
                                          [this](std::string message) {
-                                           MutexLock lock(&mutex_);
-                                           messages_read_.push_back(message);
+                                           {
+                                             MutexLock lock(&mutex_);
+                                             messages_read_.push_back(message);
+                                           }
+                                           if (!reply_.empty()) {
+                                             socket_.Write(ByteArray(reply_));
+                                           }
                                          },
                                      .on_error_cb =
                                          [this](absl::Status status) {
@@ -152,6 +157,8 @@ class ServerSocketTest : public ::testing::Test {
                        packet->GetPayload().data()[3]) &
                       (int16_t)0xFFFF;
     EXPECT_EQ(packet_size, expected_size);
+    // A reply to the initial data is carried by the confirm packet.
+    EXPECT_EQ(packet->GetPayload().substr(4), reply_);
     // Now write a data packet of the expected payload size.
     int expected_payload_size = expected_size - 1;
     auto status = socket_.Write(ByteArray(expected_payload_size));
@@ -175,6 +182,8 @@ class ServerSocketTest : public ::testing::Test {
   std::vector<std::string> messages_read_;
   absl::Status last_error_;
   bool expect_connected_ = true;
+  // Written back when a message is received.
+  std::string reply_;
   TestServerSocket socket_;
 };
 
@@ -206,6 +215,13 @@ TEST_F(ServerSocketTest, TestConnectInitialData) {
   EXPECT_EQ(messages_read_[0], initial_data);
 }
 
+TEST_F(ServerSocketTest, TestReplyInConnectionConfirm) {
+  reply_ = "34";
+  RunConnect(/*client_max_packet_size=*/2, /*server_max_packet_size=*/2,
+             /*expected_size=*/2, "12");
+  EXPECT_EQ(messages_read_.size(), 1);
+}
+
 TEST_F(ServerSocketTest, TestDisconnect) {
   RunConnect(/*client_max_packet_size=*/2, /*server_max_packet_size=*/2,
              /*expected_size=*/2, "");
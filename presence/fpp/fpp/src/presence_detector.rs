@@ -12,10 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-use std::collections::{HashMap, VecDeque};
-use std::time::{Instant, SystemTime};
-
-use itertools::Itertools;
+use std::collections::HashMap;
+use std::time::Instant;
 
 use crate::fspl_converter::compute_distance_meters_at_high_tx_power;
 use crate::fused_presence_utils::{
@@ -27,6 +25,11 @@ use crate::fused_presence_utils::{
 
 const MAX_RSSI_FILTER_VALUE: i32 = 10;
 const DEFAULT_ESTIMATED_DISTANCE_DATA_TTL_MILLIS: u128 = 4000;
+/// Weight of a new RSSI sample in the exponentially weighted moving average.
+const RSSI_SMOOTHING_FACTOR: f64 = 0.5;
+/// A device stays in its current zone while its distance is within this
+/// ratio of the zone, so a distance hovering at a threshold doesn't flap.
+const ZONE_HYSTERESIS_RATIO: f64 = 0.1;
 
 /// Static function for getting proximity state from threshold
 fn get_proximity_state_from_threshold(distance_meters: f64) -> ProximityState {
@@ -45,38 +48,54 @@ fn get_proximity_state_from_threshold(distance_meters: f64) -> ProximityState {
     ProximityState::Far
 }
 
-/// Tracks and computes proximity/presence state events.
-pub struct PresenceDetector {
-    start_time: Instant,
-    last_range_update_time: RangingUpdateTime,
-    best_proximity_estimate_per_device: HashMap<u64, ProximityEstimate>,
-    transition_history: VecDeque<ProximityState>,
+/// Returns the proximity state of a distance, keeping |current_state| while
+/// the distance is within the hysteresis ratio of it.
+pub(crate) fn get_proximity_state_with_hysteresis(
+    distance_meters: f64,
+    current_state: Option<ProximityState>,
+) -> ProximityState {
+    let new_state = get_proximity_state_from_threshold(distance_meters);
+    match current_state {
+        Some(current_state)
+            if new_state != current_state
+                && (get_proximity_state_from_threshold(
+                    distance_meters / (1.0 + ZONE_HYSTERESIS_RATIO),
+                ) == current_state
+                    || get_proximity_state_from_threshold(
+                        distance_meters * (1.0 + ZONE_HYSTERESIS_RATIO),
+                    ) == current_state) =>
+        {
+            current_state
+        }
+        _ => new_state,
+    }
 }
 
-struct RangingUpdateTime(u128);
-
-impl RangingUpdateTime {
-    pub fn is_expired(&self) -> bool {
-        let elapsed_real_time_millis = Instant::now().elapsed().as_millis();
-        elapsed_real_time_millis - self.0 > DEFAULT_ESTIMATED_DISTANCE_DATA_TTL_MILLIS
-    }
+/// The running estimate of a single device, updated in constant time per scan
+/// result.
+struct DeviceState {
+    /// Exponentially weighted moving average of the RSSI.
+    smoothed_rssi: f64,
+    /// The zone of the latest scan results, and how many scan results in a row
+    /// it has been seen for.
+    candidate_state: ProximityState,
+    candidate_count: u8,
+    /// The last reported estimate, if the device ever settled in a zone.
+    best_proximity_estimate: Option<ProximityEstimate>,
+    /// Milliseconds since the detector start time of the last scan result.
+    last_update_millis: u128,
+}
 
-    pub fn update(&mut self, start_time: Instant) {
-        self.0 = Instant::now().duration_since(start_time).as_millis();
-    }
+/// Tracks and computes proximity/presence state events.
+pub struct PresenceDetector {
+    start_time: Instant,
+    device_states: HashMap<u64, DeviceState>,
 }
 
 impl PresenceDetector {
     /// Creates a new instance of presence detector
     pub fn new() -> Self {
-        PresenceDetector {
-            start_time: Instant::now(),
-            last_range_update_time: RangingUpdateTime(0),
-            best_proximity_estimate_per_device: HashMap::new(),
-            transition_history: VecDeque::with_capacity(
-                (DEFAULT_CONSECUTIVE_SCANS_REQUIRED + 1).into(),
-            ),
-        }
+        PresenceDetector { start_time: Instant::now(), device_states: HashMap::new() }
     }
 
     /// Updates the presence detector with a new scan result and returns the
@@ -87,40 +106,58 @@ impl PresenceDetector {
     ) -> Option<ProximityEstimate> {
         let device_id = ble_scan_result.device_id;
         if ble_scan_result.rssi > MAX_RSSI_FILTER_VALUE {
-            return self.best_proximity_estimate_per_device.get(&device_id).copied();
-        }
-        if self.last_range_update_time.is_expired() {
-            self.transition_history.clear();
+            return self.get_proximity_estimate(device_id);
         }
         let mut tx_power: i32 = 0;
         if let MaybeTxPower::Valid(some_tx_power) = ble_scan_result.tx_power {
             tx_power = some_tx_power;
         }
-        let rssi = ble_scan_result.rssi + tx_power;
-        let distance_meters = compute_distance_meters_at_high_tx_power(rssi);
-        let new_proximity_estimate = ProximityEstimate {
-            device_id,
-            distance_confidence: MeasurementConfidence::Low,
+        let rssi = f64::from(ble_scan_result.rssi + tx_power);
+        let now_millis = Instant::now().duration_since(self.start_time).as_millis();
+        let state = self.device_states.entry(device_id).or_insert(DeviceState {
+            smoothed_rssi: rssi,
+            candidate_state: ProximityState::Unknown,
+            candidate_count: 0,
+            best_proximity_estimate: None,
+            last_update_millis: now_millis,
+        });
+        if now_millis - state.last_update_millis > DEFAULT_ESTIMATED_DISTANCE_DATA_TTL_MILLIS {
+            // The device has been out of sight for a while, start over instead
+            // of averaging with stale samples.
+            state.smoothed_rssi = rssi;
+            state.candidate_count = 0;
+        }
+        state.last_update_millis = now_millis;
+        state.smoothed_rssi += RSSI_SMOOTHING_FACTOR * (rssi - state.smoothed_rssi);
+
+        let distance_meters =
+            compute_distance_meters_at_high_tx_power(state.smoothed_rssi.round() as i32);
+        let proximity_state = get_proximity_state_with_hysteresis(
             distance_meters,
-            proximity_state: get_proximity_state_from_threshold(distance_meters),
-            elapsed_real_time_millis: Instant::now().duration_since(self.start_time).as_millis()
-                as u64,
-            source: PresenceDataSource::Ble,
-        };
-        self.transition_history.push_front(new_proximity_estimate.proximity_state);
-        self.transition_history.truncate(DEFAULT_CONSECUTIVE_SCANS_REQUIRED.into());
-        if self.transition_history.iter().unique().count() == 1
-            && self.transition_history.len() == DEFAULT_CONSECUTIVE_SCANS_REQUIRED.into()
-        {
-            self.best_proximity_estimate_per_device.insert(device_id, new_proximity_estimate);
-            self.last_range_update_time.update(self.start_time);
+            state.best_proximity_estimate.map(|estimate| estimate.proximity_state),
+        );
+        if proximity_state == state.candidate_state {
+            state.candidate_count = state.candidate_count.saturating_add(1);
+        } else {
+            state.candidate_state = proximity_state;
+            state.candidate_count = 1;
+        }
+        if state.candidate_count >= DEFAULT_CONSECUTIVE_SCANS_REQUIRED {
+            state.best_proximity_estimate = Some(ProximityEstimate {
+                device_id,
+                distance_confidence: MeasurementConfidence::Low,
+                distance_meters,
+                proximity_state,
+                elapsed_real_time_millis: now_millis as u64,
+                source: PresenceDataSource::Ble,
+            });
         }
-        self.best_proximity_estimate_per_device.get(&device_id).copied()
+        state.best_proximity_estimate
     }
 
     /// Returns the current proximity estimate for a given device
     pub fn get_proximity_estimate(&self, device_id: u64) -> Option<ProximityEstimate> {
-        self.best_proximity_estimate_per_device.get(&device_id).copied()
+        self.device_states.get(&device_id).and_then(|state| state.best_proximity_estimate)
     }
 }
 
@@ -32,6 +32,16 @@ const BLE_SCAN_RESULT_SHORT_RANGE_ZONE: BleScanResult = BleScanResult {
     ..BLE_SCAN_RESULT_REACH_ZONE
 };
 
+const BLE_SCAN_RESULT_CLOSE_REACH_ZONE: BleScanResult = BleScanResult {
+    rssi: -30,
+    ..BLE_SCAN_RESULT_REACH_ZONE
+};
+
+const BLE_SCAN_RESULT_OTHER_DEVICE_SHORT_RANGE_ZONE: BleScanResult = BleScanResult {
+    device_id: 5678,
+    ..BLE_SCAN_RESULT_SHORT_RANGE_ZONE
+};
+
 const REACH_PROXIMITY_ESTIMATE: ProximityEstimate = ProximityEstimate {
     device_id: 1234,
     distance_meters: 0.1,
@@ -103,3 +113,61 @@ fn test_on_ble_scan_result_transition_to_new_zone() {
         Some(SHORT_RANGE_PROXIMITY_ESTIMATE)
     );
 }
+
+#[test]
+fn test_on_ble_scan_result_tracks_devices_independently() {
+    // Interleaved scan results of two devices each count towards their own zone
+    let mut presence_detector = PresenceDetector::new();
+    for _ in 0..2 {
+        presence_detector.on_ble_scan_result(BLE_SCAN_RESULT_REACH_ZONE);
+        presence_detector.on_ble_scan_result(BLE_SCAN_RESULT_OTHER_DEVICE_SHORT_RANGE_ZONE);
+    }
+    assert_eq!(
+        presence_detector
+            .get_proximity_estimate(1234)
+            .map(|estimate| estimate.proximity_state),
+        Some(ProximityState::Reach)
+    );
+    assert_eq!(
+        presence_detector
+            .get_proximity_estimate(5678)
+            .map(|estimate| estimate.proximity_state),
+        Some(ProximityState::ShortRange)
+    );
+}
+
+#[test]
+fn test_on_ble_scan_result_ignores_single_outlier() {
+    let mut presence_detector = PresenceDetector::new();
+    presence_detector.on_ble_scan_result(BLE_SCAN_RESULT_CLOSE_REACH_ZONE);
+    presence_detector.on_ble_scan_result(BLE_SCAN_RESULT_CLOSE_REACH_ZONE);
+    presence_detector.on_ble_scan_result(BLE_SCAN_RESULT_SHORT_RANGE_ZONE);
+    assert_eq!(
+        presence_detector
+            .on_ble_scan_result(BLE_SCAN_RESULT_CLOSE_REACH_ZONE)
+            .map(|estimate| estimate.proximity_state),
+        Some(ProximityState::Reach)
+    );
+}
+
+#[test]
+fn test_get_proximity_state_with_hysteresis() {
+    // Just past the reach threshold
+    assert_eq!(
+        get_proximity_state_with_hysteresis(0.6, None),
+        ProximityState::ShortRange
+    );
+    assert_eq!(
+        get_proximity_state_with_hysteresis(0.6, Some(ProximityState::Reach)),
+        ProximityState::Reach
+    );
+    assert_eq!(
+        get_proximity_state_with_hysteresis(0.7, Some(ProximityState::Reach)),
+        ProximityState::ShortRange
+    );
+    // Just within the reach threshold
+    assert_eq!(
+        get_proximity_state_with_hysteresis(0.55, Some(ProximityState::ShortRange)),
+        ProximityState::ShortRange
+    );
+}
@@ -81,10 +81,10 @@ absl::Status FppManager::UpdateBleScanResult(uint64_t device_id,
                         /*elapsedRealtime=*/0,
                         ProximityState::Unknown,
                         PresenceDataSource::Ble};
+  auto it = current_proximity_estimates_.find(device_id);
   ProximityEstimate old_proximity_estimate =
-      current_proximity_estimates_.contains(device_id)
-          ? current_proximity_estimates_[device_id]
-          : default_proximity_estimate;
+      it != current_proximity_estimates_.end() ? it->second
+                                               : default_proximity_estimate;
   ProximityEstimate new_proximity_estimate = default_proximity_estimate;
   int status_code = update_ble_scan_result(
       presence_detector_handle_, ble_scan_result, &new_proximity_estimate);
@@ -119,8 +119,11 @@ void FppManager::ResetProximityStateData() {
 }
 
 std::optional<RangingData> FppManager::GetRangingData(uint64_t device_id) {
-  return ConvertProximityEstimateToRangingData(
-      current_proximity_estimates_[device_id]);
+  auto it = current_proximity_estimates_.find(device_id);
+  if (it == current_proximity_estimates_.end()) {
+    return std::nullopt;
+  }
+  return ConvertProximityEstimateToRangingData(it->second);
 }
 
 // Converts FPP ProximityEstimate struct to NP RangingData struct
@@ -142,7 +145,7 @@ void FppManager::CheckPresenceZoneChanged(uint64_t device_id,
                                           ProximityEstimate old_estimate,
                                           ProximityEstimate new_estimate) {
   if (old_estimate.proximity_state != new_estimate.proximity_state) {
-    NEARBY_LOGS(WARNING)
+    NEARBY_LOGS(INFO)
         << "Updating zone transition callbacks with new zone. Zone="
         << static_cast<int>(new_estimate.proximity_state);
     for (auto& pair : zone_transition_callbacks_) {
@@ -0,0 +1,121 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "presence/implementation/advertisement_cache.h"
+
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/functional/function_ref.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "absl/types/variant.h"
+#include "internal/platform/logging.h"
+#include "internal/proto/local_credential.pb.h"
+#include "presence/implementation/advertisement_factory.h"
+#include "presence/implementation/base_broadcast_request.h"
+#include "presence/implementation/mediums/advertisement_data.h"
+
+namespace nearby {
+namespace presence {
+
+namespace {
+
+bool IsExpired(const internal::LocalCredential& credential, absl::Time now) {
+  return credential.end_time_millis() < absl::ToUnixMillis(now);
+}
+
+}  // namespace
+
+std::optional<AdvertisementData> AdvertisementCache::Take(
+    const BaseBroadcastRequest& request, const LocalCredential& credential,
+    absl::Time now) {
+  std::optional<Key> key = GetKey(request);
+  if (!key) {
+    return std::nullopt;
+  }
+  auto it = entries_.find(*key);
+  if (it == entries_.end()) {
+    return std::nullopt;
+  }
+  Entry& entry = it->second;
+  if (entry.credential.id() != credential.id() ||
+      IsExpired(entry.credential, now)) {
+    entries_.erase(it);
+    return std::nullopt;
+  }
+  if (entry.advertisements.empty()) {
+    return std::nullopt;
+  }
+  AdvertisementData advertisement = std::move(entry.advertisements.front());
+  entry.advertisements.pop_front();
+  return advertisement;
+}
+
+std::optional<internal::LocalCredential> AdvertisementCache::Fill(
+    const BaseBroadcastRequest& request, const LocalCredential& credential,
+    absl::Time now,
+    absl::FunctionRef<std::string(LocalCredential&)> select_salt) {
+  std::optional<Key> key = GetKey(request);
+  if (!key || IsExpired(credential, now)) {
+    return std::nullopt;
+  }
+  Entry& entry = entries_[*key];
+  if (entry.credential.id() != credential.id()) {
+    entry = Entry{.credential = credential};
+  } else {
+    // `credential` may have consumed salts since the entry was filled.
+    for (const auto& [salt, consumed] : credential.consumed_salts()) {
+      entry.credential.mutable_consumed_salts()->insert({salt, consumed});
+    }
+  }
+
+  bool added = false;
+  while (entry.advertisements.size() < kMaxAdvertisementsPerRequest) {
+    BaseBroadcastRequest salted_request = request;
+    salted_request.salt = select_salt(entry.credential);
+    absl::StatusOr<AdvertisementData> advertisement =
+        AdvertisementFactory().CreateAdvertisement(salted_request,
+                                                   entry.credential);
+    if (!advertisement.ok()) {
+      NEARBY_LOGS(WARNING) << "Can't precompute advertisement, reason: "
+                           << advertisement.status();
+      break;
+    }
+    entry.advertisements.push_back(*std::move(advertisement));
+    added = true;
+  }
+  if (!added) {
+    return std::nullopt;
+  }
+  return entry.credential;
+}
+
+std::optional<AdvertisementCache::Key> AdvertisementCache::GetKey(
+    const BaseBroadcastRequest& request) {
+  if (!absl::holds_alternative<BaseBroadcastRequest::BasePresence>(
+          request.variant)) {
+    return std::nullopt;
+  }
+  const auto& presence =
+      absl::get<BaseBroadcastRequest::BasePresence>(request.variant);
+  return Key{presence.credential_selector.identity_type,
+             presence.credential_selector.manager_app_id,
+             presence.credential_selector.account_name, presence.action.action,
+             request.tx_power};
+}
+
+}  // namespace presence
+}  // namespace nearby
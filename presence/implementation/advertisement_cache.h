@@ -0,0 +1,92 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_ADVERTISEMENT_CACHE_H_
+#define THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_ADVERTISEMENT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <tuple>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/function_ref.h"
+#include "absl/time/time.h"
+#include "internal/proto/local_credential.pb.h"
+#include "presence/implementation/base_broadcast_request.h"
+#include "presence/implementation/mediums/advertisement_data.h"
+
+namespace nearby {
+namespace presence {
+
+// Keeps the next few advertisements of each broadcast request, built ahead of
+// time with the credential the request is advertised with. Starting a
+// broadcast again can then skip the LDT encryption and the serialization of
+// the advertisement.
+//
+// The advertisements are only valid while their credential is: they are
+// dropped when the credential expires or another credential is selected.
+//
+// Owned by `BroadcastManager`. Not thread-safe.
+class AdvertisementCache {
+ public:
+  using LocalCredential = internal::LocalCredential;
+
+  // The number of advertisements built ahead of time for a request.
+  static constexpr size_t kMaxAdvertisementsPerRequest = 3;
+
+  AdvertisementCache() = default;
+  AdvertisementCache(const AdvertisementCache&) = delete;
+  AdvertisementCache& operator=(const AdvertisementCache&) = delete;
+
+  // Removes and returns the next advertisement of `request` built with
+  // `credential`, if any.
+  std::optional<AdvertisementData> Take(const BaseBroadcastRequest& request,
+                                        const LocalCredential& credential,
+                                        absl::Time now);
+
+  // Builds advertisements of `request` with `credential` until
+  // `kMaxAdvertisementsPerRequest` are ready. Each one gets a salt from
+  // `select_salt`, which records it in the credential's consumed salts.
+  //
+  // Returns the credential with the salts of the new advertisements, which
+  // the caller must save in the storage, or nothing if none was built.
+  std::optional<LocalCredential> Fill(
+      const BaseBroadcastRequest& request, const LocalCredential& credential,
+      absl::Time now,
+      absl::FunctionRef<std::string(LocalCredential&)> select_salt);
+
+ private:
+  // Identity type, manager app id, account name, action and TX power: what an
+  // advertisement is built from, besides the salt and the credential.
+  using Key = std::tuple<int, std::string, std::string, uint32_t, int8_t>;
+
+  struct Entry {
+    // The credential the advertisements are built with, including the salts
+    // they consumed.
+    LocalCredential credential;
+    std::deque<AdvertisementData> advertisements;
+  };
+
+  static std::optional<Key> GetKey(const BaseBroadcastRequest& request);
+
+  absl::flat_hash_map<Key, Entry> entries_;
+};
+
+}  // namespace presence
+}  // namespace nearby
+
+#endif  // THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_ADVERTISEMENT_CACHE_H_
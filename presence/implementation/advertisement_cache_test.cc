@@ -0,0 +1,149 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "presence/implementation/advertisement_cache.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/time/time.h"
+#include "internal/platform/byte_array.h"
+#include "internal/proto/credential.pb.h"
+#include "internal/proto/local_credential.pb.h"
+#include "presence/implementation/base_broadcast_request.h"
+#include "presence/implementation/mediums/advertisement_data.h"
+
+namespace nearby {
+namespace presence {
+namespace {
+
+using ::nearby::internal::IdentityType;
+using ::nearby::internal::LocalCredential;
+
+constexpr IdentityType kIdentity = IdentityType::IDENTITY_TYPE_PRIVATE_GROUP;
+constexpr absl::Time kNow = absl::FromUnixSeconds(1000);
+
+LocalCredential CreateLocalCredential(int64_t id) {
+  // Values copied from LDT tests
+  ByteArray seed({204, 219, 36, 137, 233, 252, 172, 66, 179, 147, 72,
+                  184, 148, 30, 209, 154, 29,  54,  14, 117, 224, 152,
+                  200, 193, 94, 107, 28,  194, 182, 32, 205, 57});
+  ByteArray metadata_key(
+      {205, 104, 63, 225, 161, 209, 248, 70, 84, 61, 10, 19, 212, 174});
+
+  LocalCredential private_credential;
+  private_credential.set_id(id);
+  private_credential.set_identity_type(kIdentity);
+  private_credential.set_key_seed(seed.AsStringView());
+  private_credential.set_metadata_encryption_key_v0(
+      metadata_key.AsStringView());
+  private_credential.set_end_time_millis(
+      absl::ToUnixMillis(kNow + absl::Hours(1)));
+  return private_credential;
+}
+
+BaseBroadcastRequest CreateRequest() {
+  return BaseBroadcastRequest(BasePresenceRequestBuilder(kIdentity)
+                                  .SetAccountName("Test account")
+                                  .SetTxPower(5)
+                                  .SetAction({.action = 8}));
+}
+
+// Hands out consecutive salts and records them, like `SelectSalt()`.
+std::string SelectNextSalt(LocalCredential& credential) {
+  uint16_t salt = credential.consumed_salts().size() + 1;
+  credential.mutable_consumed_salts()->insert({salt, true});
+  return std::string(
+      {static_cast<char>(salt >> 8), static_cast<char>(salt & 0xFF)});
+}
+
+TEST(AdvertisementCache, TakesPrecomputedAdvertisements) {
+  AdvertisementCache cache;
+
+  std::optional<LocalCredential> updated = cache.Fill(
+      CreateRequest(), CreateLocalCredential(1), kNow, SelectNextSalt);
+
+  ASSERT_TRUE(updated.has_value());
+  EXPECT_EQ(updated->consumed_salts().size(),
+            AdvertisementCache::kMaxAdvertisementsPerRequest);
+  std::optional<AdvertisementData> first =
+      cache.Take(CreateRequest(), CreateLocalCredential(1), kNow);
+  std::optional<AdvertisementData> second =
+      cache.Take(CreateRequest(), CreateLocalCredential(1), kNow);
+  ASSERT_TRUE(first.has_value());
+  ASSERT_TRUE(second.has_value());
+  EXPECT_NE(first->content, second->content);
+}
+
+TEST(AdvertisementCache, RunsOutOfAdvertisementsUntilFilledAgain) {
+  AdvertisementCache cache;
+  cache.Fill(CreateRequest(), CreateLocalCredential(1), kNow, SelectNextSalt);
+
+  for (size_t i = 0; i < AdvertisementCache::kMaxAdvertisementsPerRequest;
+       i++) {
+    EXPECT_TRUE(cache.Take(CreateRequest(), CreateLocalCredential(1), kNow)
+                    .has_value());
+  }
+  EXPECT_FALSE(
+      cache.Take(CreateRequest(), CreateLocalCredential(1), kNow).has_value());
+
+  std::optional<LocalCredential> updated = cache.Fill(
+      CreateRequest(), CreateLocalCredential(1), kNow, SelectNextSalt);
+  // The credential keeps the salts of the advertisements built before.
+  ASSERT_TRUE(updated.has_value());
+  EXPECT_EQ(updated->consumed_salts().size(),
+            2 * AdvertisementCache::kMaxAdvertisementsPerRequest);
+  EXPECT_TRUE(
+      cache.Take(CreateRequest(), CreateLocalCredential(1), kNow).has_value());
+}
+
+TEST(AdvertisementCache, DropsAdvertisementsOfAnotherCredential) {
+  AdvertisementCache cache;
+  cache.Fill(CreateRequest(), CreateLocalCredential(1), kNow, SelectNextSalt);
+
+  EXPECT_FALSE(
+      cache.Take(CreateRequest(), CreateLocalCredential(2), kNow).has_value());
+  EXPECT_FALSE(
+      cache.Take(CreateRequest(), CreateLocalCredential(1), kNow).has_value());
+}
+
+TEST(AdvertisementCache, DropsAdvertisementsOfExpiredCredential) {
+  AdvertisementCache cache;
+  cache.Fill(CreateRequest(), CreateLocalCredential(1), kNow, SelectNextSalt);
+
+  EXPECT_FALSE(cache
+                   .Take(CreateRequest(), CreateLocalCredential(1),
+                         kNow + absl::Hours(2))
+                   .has_value());
+  EXPECT_FALSE(cache.Fill(CreateRequest(), CreateLocalCredential(1),
+                          kNow + absl::Hours(2), SelectNextSalt)
+                   .has_value());
+}
+
+TEST(AdvertisementCache, DoesNotShareAdvertisementsBetweenRequests) {
+  AdvertisementCache cache;
+  cache.Fill(CreateRequest(), CreateLocalCredential(1), kNow, SelectNextSalt);
+  BaseBroadcastRequest other_request = CreateRequest();
+  other_request.tx_power = 7;
+
+  EXPECT_FALSE(
+      cache.Take(other_request, CreateLocalCredential(1), kNow).has_value());
+}
+
+}  // namespace
+}  // namespace presence
+}  // namespace nearby
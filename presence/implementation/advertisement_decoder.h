@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_ADVERTISEMENT_DECODER_H_
 #define THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_ADVERTISEMENT_DECODER_H_
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -22,6 +23,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "internal/proto/credential.pb.h"
 #include "presence/data_element.h"
 
@@ -51,6 +53,18 @@ class AdvertisementDecoder {
   // misformatted or if it couldn't be decrypted.
   virtual absl::StatusOr<Advertisement> DecodeAdvertisement(
       absl::string_view advertisement) = 0;
+
+  // Decodes each of |advertisements| into the result at the same index of
+  // |results|, which must be as long, as DecodeAdvertisement() would. Lets a
+  // decoder share its per-call setup across a batch of advertisements, and
+  // callers reuse the result storage.
+  virtual void DecodeAdvertisements(
+      absl::Span<const absl::string_view> advertisements,
+      absl::Span<absl::StatusOr<Advertisement>> results) {
+    for (size_t i = 0; i < advertisements.size() && i < results.size(); ++i) {
+      results[i] = DecodeAdvertisement(advertisements[i]);
+    }
+  }
 };
 
 }  // namespace presence
@@ -16,11 +16,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
@@ -32,6 +35,7 @@
 #include "presence/implementation/advertisement_decoder.h"
 #include "presence/implementation/base_broadcast_request.h"
 #include "presence/implementation/ldt.h"
+#include "presence/implementation/ldt_decryptor_cache.h"
 
 namespace nearby {
 namespace presence {
@@ -172,32 +176,87 @@ void DecodeBaseAction(absl::string_view serialized_action,
   ActionFactory::DecodeAction(action, decoded_advertisement.data_elements);
 }
 
-absl::StatusOr<std::string> DecryptLdt(
+std::optional<std::string> AdvertisementDecoderImpl::TryDecrypt(
+    const internal::SharedCredential& credential, absl::string_view salt,
+    absl::string_view encrypted_contents) {
+  absl::StatusOr<std::shared_ptr<LdtEncryptor>> encryptor;
+  if (ldt_decryptor_cache_ != nullptr) {
+    encryptor = ldt_decryptor_cache_->GetDecryptor(credential);
+  } else {
+    absl::StatusOr<LdtEncryptor> created = LdtEncryptor::Create(
+        credential.key_seed(), credential.metadata_encryption_key_tag_v0());
+    if (created.ok()) {
+      encryptor = std::make_shared<LdtEncryptor>(*std::move(created));
+    } else {
+      encryptor = created.status();
+    }
+  }
+  if (!encryptor.ok()) {
+    return std::nullopt;
+  }
+  absl::StatusOr<std::string> result =
+      (*encryptor)->DecryptAndVerify(encrypted_contents, salt);
+  if (!result.ok() || result->size() <= kBaseMetadataSize) {
+    return std::nullopt;
+  }
+  return *std::move(result);
+}
+
+absl::StatusOr<std::string> AdvertisementDecoderImpl::DecryptLdt(
     const std::vector<internal::SharedCredential>& credentials,
     absl::string_view salt, absl::string_view encrypted_contents,
     Advertisement& decoded_advertisement) {
   if (credentials.empty()) {
     return absl::UnavailableError("No credentials");
   }
-  for (const auto& credential : credentials) {
-    absl::StatusOr<LdtEncryptor> encryptor = LdtEncryptor::Create(
-        credential.key_seed(), credential.metadata_encryption_key_tag_v0());
-    if (encryptor.ok()) {
-      absl::StatusOr<std::string> result =
-          encryptor->DecryptAndVerify(encrypted_contents, salt);
-      if (result.ok() && result->size() > kBaseMetadataSize) {
-        decoded_advertisement.public_credential = credential;
-        decoded_advertisement.metadata_key =
-            result->substr(0, kBaseMetadataSize);
-        return result->substr(kBaseMetadataSize);
+  ++decryption_stats_.advertisements;
+  // A sender repeats the same advertisement until it rotates the salt, so
+  // the credential that decrypted the previous copy is tried first.
+  uint64_t tag = absl::HashOf(decoded_advertisement.identity_type, salt,
+                              encrypted_contents);
+  std::optional<size_t> indexed;
+  auto it = credential_index_.find(tag);
+  if (it != credential_index_.end() && it->second < credentials.size()) {
+    indexed = it->second;
+  }
+
+  size_t candidates = 0;
+  size_t match = 0;
+  std::optional<std::string> result;
+  if (indexed.has_value()) {
+    ++candidates;
+    result = TryDecrypt(credentials[*indexed], salt, encrypted_contents);
+    if (result.has_value()) {
+      match = *indexed;
+      ++decryption_stats_.index_hits;
+    }
+  }
+  for (size_t i = 0; !result.has_value() && i < credentials.size(); ++i) {
+    if (indexed == i) continue;
+    ++candidates;
+    result = TryDecrypt(credentials[i], salt, encrypted_contents);
+    if (result.has_value()) {
+      match = i;
+      if (credential_index_.size() >= kMaxCredentialIndexSize) {
+        credential_index_.clear();
       }
+      credential_index_[tag] = i;
     }
   }
-  return absl::UnavailableError(
-      "Couldn't decrypt the message with any credentials");
+  decryption_stats_.candidates += candidates;
+  NEARBY_VLOG(1) << "Tried " << candidates
+                 << " credentials to decrypt the advertisement";
+
+  if (!result.has_value()) {
+    return absl::UnavailableError(
+        "Couldn't decrypt the message with any credentials");
+  }
+  decoded_advertisement.public_credential = credentials[match];
+  decoded_advertisement.metadata_key = result->substr(0, kBaseMetadataSize);
+  return result->substr(kBaseMetadataSize);
 }
 
-absl::Status DecryptDataElements(
+absl::Status AdvertisementDecoderImpl::DecryptDataElements(
     const std::vector<internal::SharedCredential>& credentials,
     const DataElement& elem, Advertisement& decoded_advertisement) {
   if (elem.GetValue().size() <= kEncryptedIdentityAdditionalLength) {
@@ -266,7 +325,7 @@ absl::StatusOr<Advertisement> AdvertisementDecoderImpl::DecodeAdvertisement(
       if (credentials_map_ == nullptr) {
         return absl::FailedPreconditionError("Missing credentials");
       }
-      auto identity_type_specific_creds =
+      const auto& identity_type_specific_creds =
           (*credentials_map_)[decoded_advertisement.identity_type];
       absl::Status status = DecryptDataElements(identity_type_specific_creds,
                                                 *elem, decoded_advertisement);
@@ -15,13 +15,20 @@
 #ifndef THIRD_PARTY_NEARBY_PRESENCE_ADVERTISEMENT_DECODER_IMPL_H_
 #define THIRD_PARTY_NEARBY_PRESENCE_ADVERTISEMENT_DECODER_IMPL_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/status/status.h"
 #include "internal/proto/credential.pb.h"
+#include "presence/data_element.h"
 #include "presence/implementation/advertisement_decoder.h"
+#include "presence/implementation/ldt_decryptor_cache.h"
 
 namespace nearby {
 namespace presence {
@@ -35,14 +42,56 @@ class AdvertisementDecoderImpl : public AdvertisementDecoder {
                           std::vector<internal::SharedCredential>>*
           credentials_map)
       : credentials_map_(credentials_map) {}
+  // Decrypts with the decryptors in `ldt_decryptor_cache`, if not null,
+  // instead of creating them for every advertisement.
+  AdvertisementDecoderImpl(
+      absl::flat_hash_map<nearby::internal::IdentityType,
+                          std::vector<internal::SharedCredential>>*
+          credentials_map,
+      LdtDecryptorCache* ldt_decryptor_cache)
+      : credentials_map_(credentials_map),
+        ldt_decryptor_cache_(ldt_decryptor_cache) {}
 
   absl::StatusOr<Advertisement> DecodeAdvertisement(
       absl::string_view advertisement) override;
 
+  // Counts the credentials tried to decrypt advertisements.
+  struct DecryptionStats {
+    // Encrypted advertisements decoded.
+    std::uint64_t advertisements = 0;
+    // Credentials tried on them, including the indexed ones.
+    std::uint64_t candidates = 0;
+    // Advertisements decrypted with the credential found in the index.
+    std::uint64_t index_hits = 0;
+  };
+  const DecryptionStats& GetDecryptionStats() const {
+    return decryption_stats_;
+  }
+
  private:
+  // Entries in `credential_index_` before it starts over.
+  static constexpr size_t kMaxCredentialIndexSize = 256;
+
+  absl::Status DecryptDataElements(
+      const std::vector<internal::SharedCredential>& credentials,
+      const DataElement& elem, Advertisement& decoded_advertisement);
+  absl::StatusOr<std::string> DecryptLdt(
+      const std::vector<internal::SharedCredential>& credentials,
+      absl::string_view salt, absl::string_view encrypted_contents,
+      Advertisement& decoded_advertisement);
+  // Returns the decrypted contents if they were encrypted with `credential`.
+  std::optional<std::string> TryDecrypt(
+      const internal::SharedCredential& credential, absl::string_view salt,
+      absl::string_view encrypted_contents);
+
   absl::flat_hash_map<internal::IdentityType,
                       std::vector<internal::SharedCredential>>*
       credentials_map_ = nullptr;
+  LdtDecryptorCache* ldt_decryptor_cache_ = nullptr;
+  // Index of the credential that decrypted an advertisement, by a hash of
+  // its identity type, salt and encrypted contents.
+  absl::flat_hash_map<std::uint64_t, size_t> credential_index_;
+  DecryptionStats decryption_stats_;
 };
 
 }  // namespace presence
@@ -93,7 +93,8 @@ internal::IdentityType GetIdentityType(
 }
 
 absl::StatusOr<::nearby::internal::SharedCredential> FindById(
-    std::vector<::nearby::internal::SharedCredential> private_credentials,
+    const std::vector<::nearby::internal::SharedCredential>&
+        private_credentials,
     uint64_t id) {
   auto cred =
       std::find_if(private_credentials.begin(), private_credentials.end(),
@@ -107,7 +108,8 @@ absl::StatusOr<::nearby::internal::SharedCredential> FindById(
 
 absl::Status ProcessLegibleV0Adv(
     nearby_protocol::LegibleDeserializedV0Advertisement legible_adv,
-    std::vector<::nearby::internal::SharedCredential> private_credentials,
+    const std::vector<::nearby::internal::SharedCredential>&
+        private_credentials,
     Advertisement& advertisement) {
   advertisement.identity_type = GetIdentityType(legible_adv.GetIdentityKind());
 
@@ -147,7 +149,8 @@ absl::Status ProcessLegibleV0Adv(
 
 absl::Status ProcessV0Advertisement(
     nearby_protocol::DeserializedV0Advertisement result,
-    std::vector<::nearby::internal::SharedCredential> private_credentials,
+    const std::vector<::nearby::internal::SharedCredential>&
+        private_credentials,
     Advertisement& adv) {
   switch (result.GetKind()) {
     case nearby_protocol::DeserializedV0AdvertisementKind::Legible:
@@ -25,10 +25,12 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "internal/platform/byte_array.h"
 #include "internal/proto/credential.pb.h"
 #include "presence/data_element.h"
 #include "presence/implementation/advertisement_decoder_impl.h"
+#include "presence/implementation/ldt_decryptor_cache.h"
 #include "presence/scan_request.h"
 #include "presence/scan_request_builder.h"
 
@@ -162,6 +164,31 @@ TEST(AdvertisementDecoderImpl, DecodeBaseNpPrivateAdvertisement) {
                                       absl::HexStringToBytes("08"))));
 }
 
+TEST(AdvertisementDecoderImpl, RepeatedAdvertisementTriesIndexedCredential) {
+  absl::flat_hash_map<IdentityType, std::vector<internal::SharedCredential>>
+      credentials;
+  SharedCredential other_credential = GetPublicCredential();
+  other_credential.set_key_seed(std::string(32, 'x'));
+  credentials[IdentityType::IDENTITY_TYPE_PRIVATE_GROUP] = {
+      other_credential, other_credential, GetPublicCredential()};
+  LdtDecryptorCache ldt_decryptor_cache;
+  AdvertisementDecoderImpl decoder(&credentials, &ldt_decryptor_cache);
+  std::string advertisement =
+      absl::HexStringToBytes("00514142b8412efb0bc657ba514baf4d1b50ddc842cd1c");
+
+  ASSERT_OK(decoder.DecodeAdvertisement(advertisement));
+  EXPECT_EQ(decoder.GetDecryptionStats().candidates, 3);
+  EXPECT_EQ(decoder.GetDecryptionStats().index_hits, 0);
+
+  absl::StatusOr<Advertisement> result =
+      decoder.DecodeAdvertisement(advertisement);
+  ASSERT_OK(result);
+  EXPECT_EQ(result->identity_type, IdentityType::IDENTITY_TYPE_PRIVATE_GROUP);
+  EXPECT_EQ(decoder.GetDecryptionStats().advertisements, 2);
+  EXPECT_EQ(decoder.GetDecryptionStats().candidates, 4);
+  EXPECT_EQ(decoder.GetDecryptionStats().index_hits, 1);
+}
+
 TEST(AdvertisementDecoderImpl, InvalidEncryptedContent) {
   std::string salt = "AB";
   ByteArray metadata_key(
@@ -213,6 +240,26 @@ TEST(AdvertisementDecoderImpl, EmptyAdvertisement) {
               StatusIs(absl::StatusCode::kOutOfRange));
 }
 
+TEST(AdvertisementDecoderImpl, DecodesBatchInOrder) {
+  AdvertisementDecoderImpl decoder;
+  const std::string advertisements[] = {
+      absl::HexStringToBytes("002041420337C1C2C31BEE"),
+      "",
+      absl::HexStringToBytes("000A"),
+  };
+  const absl::string_view views[] = {advertisements[0], advertisements[1],
+                                     advertisements[2]};
+  absl::StatusOr<Advertisement> results[3];
+
+  decoder.DecodeAdvertisements(views, absl::MakeSpan(results));
+
+  ASSERT_OK(results[0]);
+  EXPECT_EQ(results[0]->identity_type, IdentityType::IDENTITY_TYPE_PUBLIC);
+  EXPECT_THAT(results[1], StatusIs(absl::StatusCode::kOutOfRange));
+  ASSERT_OK(results[2]);
+  EXPECT_THAT(results[2]->data_elements, ElementsAre(DataElement(0xA, "")));
+}
+
 TEST(AdvertisementDecoderImpl, UnsupportedAdvertisementVersion) {
   AdvertisementDecoderImpl decoder;
 
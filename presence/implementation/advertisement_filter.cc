@@ -14,7 +14,10 @@
 
 #include "presence/implementation/advertisement_filter.h"
 
-#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/types/variant.h"
@@ -26,45 +29,62 @@
 namespace nearby {
 namespace presence {
 
-bool Contains(const std::vector<DataElement>& data_elements,
-              const DataElement& data_element) {
-  return std::find(data_elements.begin(), data_elements.end(), data_element) !=
-         data_elements.end();
-}
+namespace {
 
-bool ContainsAll(const std::vector<DataElement>& data_elements,
-                 const std::vector<DataElement>& extended_properties) {
-  for (const auto& filter_element : extended_properties) {
-    if (!Contains(data_elements, filter_element)) {
-      return false;
-    }
-  }
-  return true;
+uint32_t IdentityTypeBit(internal::IdentityType identity_type) {
+  return identity_type >= 0 && identity_type < 32 ? 1u << identity_type : 0;
 }
 
-bool ContainsAny(const std::vector<DataElement>& data_elements,
-                 const std::vector<int>& actions) {
-  if (actions.empty()) {
-    return true;
+}  // namespace
+
+AdvertisementFilter::AdvertisementFilter(const ScanRequest& scan_request) {
+  for (internal::IdentityType identity_type : scan_request.identity_types) {
+    identity_types_ |= IdentityTypeBit(identity_type);
   }
-  for (int action : actions) {
-    if (Contains(data_elements, DataElement(ActionBit(action)))) {
-      return true;
+
+  // NOLINT is used to suppress google3-legacy-absl-backport lints because the
+  // the suggestion is not compatible with Chrome
+  for (const auto& filter : scan_request.scan_filters) {
+    CompiledFilter compiled;
+    const std::vector<DataElement>* extended_properties = nullptr;
+    if (absl::holds_alternative<PresenceScanFilter>(filter)) {  // NOLINT
+      extended_properties =
+          &absl::get<PresenceScanFilter>(filter).extended_properties;  // NOLINT
+    } else if (absl::holds_alternative<LegacyPresenceScanFilter>(  // NOLINT
+                   filter)) {
+      const auto& legacy_filter =
+          absl::get<LegacyPresenceScanFilter>(filter);  // NOLINT
+      for (int action : legacy_filter.actions) {
+        compiled.any_actions.set(static_cast<uint8_t>(action));
+      }
+      extended_properties = &legacy_filter.extended_properties;
+    } else {
+      continue;
     }
+    for (const DataElement& data_element : *extended_properties) {
+      compiled.required_conditions.push_back(AddCondition(data_element));
+    }
+    filters_.push_back(std::move(compiled));
   }
-  return false;
+}
+
+size_t AdvertisementFilter::AddCondition(const DataElement& data_element) {
+  condition_types_.insert(data_element.GetType());
+  return conditions_
+      .try_emplace(
+          std::make_pair(data_element.GetType(),
+                         std::string(data_element.GetValue())),
+          conditions_.size())
+      .first->second;
 }
 
 bool AdvertisementFilter::MatchesScanFilter(
-    const Advertisement& advertisement) {
+    const Advertisement& advertisement) const {
   // Verify the identity is one requested in the scan_request.
   // Per the Public API of scan_request, if identity_types provided in the
   // scan_request is empty then decode advertisements of every identity type
-  auto requested_identity_types = scan_request_.identity_types;
-  if (!requested_identity_types.empty() &&
-      !(std::find(
-            requested_identity_types.begin(), requested_identity_types.end(),
-            advertisement.identity_type) != requested_identity_types.end())) {
+  if (identity_types_ != 0 &&
+      (identity_types_ & IdentityTypeBit(advertisement.identity_type)) == 0) {
     NEARBY_LOGS(INFO)
         << "Skipping advertisement with identity type: "
         << advertisement.identity_type
@@ -75,46 +95,48 @@ bool AdvertisementFilter::MatchesScanFilter(
 
   // The advertisement matches the scan request when it matches at least
   // one of the filters in the request.
-  if (scan_request_.scan_filters.empty()) {
+  if (filters_.empty()) {
     return true;
   }
 
-  // NOLINT is used to suppress google3-legacy-absl-backport lints because the
-  // the suggestion is not compatible with Chrome
-  for (const auto& filter : scan_request_.scan_filters) {
-    if (absl::holds_alternative<PresenceScanFilter>(filter)) {  // NOLINT
-      if (MatchesScanFilter(advertisement.data_elements,
-                            absl::get<PresenceScanFilter>(filter))) {  // NOLINT
-        return true;
-      }
-    } else if (absl::holds_alternative<LegacyPresenceScanFilter>(  // NOLINT
-                   filter)) {
-      if (MatchesScanFilter(
-              advertisement.data_elements,
-              absl::get<LegacyPresenceScanFilter>(filter))) {  // NOLINT
-        return true;
+  // Evaluates every condition once for all the filters.
+  ActionMask actions;
+  std::vector<bool> satisfied(conditions_.size());
+  for (const DataElement& data_element : advertisement.data_elements) {
+    if (data_element.GetType() == DataElement::kActionFieldType &&
+        data_element.GetValue().size() == 1) {
+      actions.set(static_cast<uint8_t>(data_element.GetValue()[0]));
+    }
+    if (!condition_types_.contains(data_element.GetType())) {
+      continue;
+    }
+    auto it = conditions_.find(std::make_pair(
+        data_element.GetType(), std::string(data_element.GetValue())));
+    if (it != conditions_.end()) {
+      satisfied[it->second] = true;
+    }
+  }
+
+  for (const CompiledFilter& filter : filters_) {
+    // The advertisement must:
+    // * contain any Action from the filter,
+    // * contain all Data Elements in the filter.
+    if (filter.any_actions.any() && (filter.any_actions & actions).none()) {
+      continue;
+    }
+    bool contains_all = true;
+    for (size_t condition : filter.required_conditions) {
+      if (!satisfied[condition]) {
+        contains_all = false;
+        break;
       }
     }
+    if (contains_all) {
+      return true;
+    }
   }
   return false;
 }
 
-bool AdvertisementFilter::MatchesScanFilter(
-    const std::vector<DataElement>& data_elements,
-    const PresenceScanFilter& filter) {
-  // The advertisement must contain all Data Elements in scan request.
-  return ContainsAll(data_elements, filter.extended_properties);
-}
-
-bool AdvertisementFilter::MatchesScanFilter(
-    const std::vector<DataElement>& data_elements,
-    const LegacyPresenceScanFilter& filter) {
-  // The advertisement must:
-  // * contain any Action from scan request,
-  // * contain all Data Elements in scan request.
-  return ContainsAny(data_elements, filter.actions) &&
-         ContainsAll(data_elements, filter.extended_properties);
-}
-
 }  // namespace presence
 }  // namespace nearby
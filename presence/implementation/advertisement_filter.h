@@ -15,29 +15,60 @@
 #ifndef THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_ADVERTISEMENT_FILTER_H_
 #define THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_ADVERTISEMENT_FILTER_H_
 
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "presence/data_element.h"
 #include "presence/implementation/advertisement_decoder.h"
 #include "presence/scan_request.h"
 
 namespace nearby {
 namespace presence {
+
+// Matches decoded advertisements against the filters of a scan request.
+//
+// The scan request is compiled once when the filter is created. Actions are
+// kept as bitmasks, and the data elements required by the scan filters are
+// deduplicated so that each of them is looked up once per advertisement, no
+// matter how many filters require it.
 class AdvertisementFilter {
  public:
-  explicit AdvertisementFilter(ScanRequest scan_request)
-      : scan_request_(scan_request) {}
+  explicit AdvertisementFilter(const ScanRequest& scan_request);
 
   // Returns true if the decoded advertisement in `data_elements` matches the
   // filters in `scan_request`.
-  bool MatchesScanFilter(const Advertisement& adv);
+  bool MatchesScanFilter(const Advertisement& adv) const;
 
  private:
-  bool MatchesScanFilter(const std::vector<DataElement>& data_elements,
-                         const PresenceScanFilter& filter);
-  bool MatchesScanFilter(const std::vector<DataElement>& data_elements,
-                         const LegacyPresenceScanFilter& filter);
-  ScanRequest scan_request_;
+  // One bit per action value, which is a single byte.
+  using ActionMask = std::bitset<256>;
+
+  struct CompiledFilter {
+    // Indices in `conditions_` of the data elements the advertisement must
+    // contain.
+    std::vector<size_t> required_conditions;
+    // The advertisement must contain one of these actions, unless empty.
+    ActionMask any_actions;
+  };
+
+  // Returns the index of the condition on `data_element`, adding it if new.
+  size_t AddCondition(const DataElement& data_element);
+
+  // Bit `n` is set when identity type `n` was requested. Zero if the scan
+  // request accepts all identity types.
+  uint32_t identity_types_ = 0;
+  // Types of the data elements in `conditions_`. Data elements of other types
+  // can't satisfy any condition.
+  absl::flat_hash_set<uint16_t> condition_types_;
+  // Maps the type and value of a required data element to its index.
+  absl::flat_hash_map<std::pair<uint16_t, std::string>, size_t> conditions_;
+  std::vector<CompiledFilter> filters_;
 };
 
 }  // namespace presence
@@ -169,6 +169,33 @@ TEST(AdvertisementFilter, MatchesMultipleFilters) {
   EXPECT_FALSE(adv_filter.MatchesScanFilter({.data_elements = {ttt_action}}));
 }
 
+TEST(AdvertisementFilter, MatchesFiltersSharingDataElements) {
+  DataElement model_id =
+      DataElement(DataElement::kModelIdFieldType, "model id");
+  DataElement salt = DataElement(DataElement::kSaltFieldType, "salt");
+  DataElement salt2 = DataElement(DataElement::kSaltFieldType, "salt 2");
+  DataElement ttt_action = DataElement(ActionBit::kTapToTransferAction);
+  PresenceScanFilter presence_filter = {
+      .extended_properties = {model_id, salt2}};
+  LegacyPresenceScanFilter legacy_filter = {
+      .actions = {static_cast<int>(ActionBit::kTapToTransferAction)},
+      .extended_properties = {model_id, salt}};
+
+  AdvertisementFilter adv_filter(ScanRequestBuilder()
+                                     .AddScanFilter(presence_filter)
+                                     .AddScanFilter(legacy_filter)
+                                     .Build());
+
+  EXPECT_TRUE(
+      adv_filter.MatchesScanFilter({.data_elements = {salt2, model_id}}));
+  EXPECT_TRUE(adv_filter.MatchesScanFilter(
+      {.data_elements = {model_id, ttt_action, salt}}));
+  EXPECT_FALSE(
+      adv_filter.MatchesScanFilter({.data_elements = {model_id, salt}}));
+  EXPECT_FALSE(
+      adv_filter.MatchesScanFilter({.data_elements = {salt, ttt_action}}));
+}
+
 }  // namespace
 }  // namespace presence
 }  // namespace nearby
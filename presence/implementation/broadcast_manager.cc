@@ -17,6 +17,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -29,6 +30,7 @@
 #include "internal/platform/implementation/ble_v2.h"
 #include "internal/platform/implementation/credential_callbacks.h"
 #include "internal/platform/implementation/crypto.h"
+#include "internal/platform/implementation/system_clock.h"
 #include "internal/platform/logging.h"
 #include "presence/broadcast_request.h"
 #include "presence/data_types.h"
@@ -187,8 +189,15 @@ absl::optional<LocalCredential> BroadcastManager::Advertise(  // NOLINT
   }
   absl::optional<LocalCredential> credential =  // NOLINT
       SelectCredential(broadcast_request, std::move(credentials));
+  std::optional<AdvertisementData> precomputed;
+  if (credential) {
+    precomputed = advertisement_cache_.Take(broadcast_request, *credential,
+                                            SystemClock::ElapsedRealtime());
+  }
   absl::StatusOr<AdvertisementData> advertisement =
-      AdvertisementFactory().CreateAdvertisement(broadcast_request, credential);
+      precomputed ? *std::move(precomputed)
+                  : AdvertisementFactory().CreateAdvertisement(
+                        broadcast_request, credential);
   if (!advertisement.ok()) {
     NEARBY_LOGS(WARNING) << "Can't create advertisement, reason: "
                          << advertisement.status();
@@ -208,9 +217,46 @@ absl::optional<LocalCredential> BroadcastManager::Advertise(  // NOLINT
     return absl::optional<LocalCredential>();  // NOLINT
   }
   it->second.SetAdvertisingSession(std::move(session));
+  if (!credential) {
+    return credential;
+  }
+  PrecomputeAdvertisements(broadcast_request, *credential);
+  if (precomputed) {
+    // The salt of a precomputed advertisement was saved when it was built.
+    return absl::optional<LocalCredential>();  // NOLINT
+  }
   return credential;
 }
 
+void BroadcastManager::PrecomputeAdvertisements(
+    BaseBroadcastRequest broadcast_request, LocalCredential credential) {
+  RunOnServiceControllerThread(
+      "precompute-advertisements",
+      [this, broadcast_request = std::move(broadcast_request),
+       credential = std::move(credential)]()
+          ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_) {
+            std::optional<LocalCredential> updated = advertisement_cache_.Fill(
+                broadcast_request, credential, SystemClock::ElapsedRealtime(),
+                [](LocalCredential& credential) {
+                  return SelectSalt(
+                      credential, SaltFromInt(nearby::RandData<uint16_t>()));
+                });
+            absl::StatusOr<CredentialSelector> selector =
+                AdvertisementFactory::GetCredentialSelector(broadcast_request);
+            if (!updated || !selector.ok()) {
+              return;
+            }
+            credential_manager_->UpdateLocalCredential(
+                *selector, *std::move(updated), {[](absl::Status status) {
+                  if (!status.ok()) {
+                    NEARBY_LOGS(WARNING)
+                        << "Failed to save precomputed salts, status: "
+                        << status;
+                  }
+                }});
+          });
+}
+
 void BroadcastManager::NotifyStartCallbackStatus(BroadcastSessionId id,
                                                  absl::Status status) {
   RunOnServiceControllerThread("started-broadcast-cb",
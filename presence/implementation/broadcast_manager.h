@@ -31,6 +31,7 @@
 #include "internal/platform/single_thread_executor.h"
 #include "presence/broadcast_request.h"
 #include "presence/data_types.h"
+#include "presence/implementation/advertisement_cache.h"
 #include "presence/implementation/base_broadcast_request.h"
 #include "presence/implementation/credential_manager.h"
 #include "presence/implementation/mediums/mediums.h"
@@ -100,8 +101,14 @@ class BroadcastManager {
       BroadcastSessionId id, BaseBroadcastRequest broadcast_request,
       std::vector<LocalCredential> credentials)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_);
+
+  // Builds the next advertisements of `broadcast_request` in a separate task
+  // and saves the salts they consume in `credential`.
+  void PrecomputeAdvertisements(BaseBroadcastRequest broadcast_request,
+                                LocalCredential credential);
   absl::flat_hash_map<BroadcastSessionId, BroadcastSessionState> sessions_
       ABSL_GUARDED_BY(*executor_);
+  AdvertisementCache advertisement_cache_ ABSL_GUARDED_BY(*executor_);
 };
 
 }  // namespace presence
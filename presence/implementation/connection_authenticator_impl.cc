@@ -44,6 +44,27 @@ constexpr char kBroadcasterHkdfInfo[] =
     "Nearby Presence Broadcaster Credential Hash";
 constexpr char kDiscovererHkdfInfo[] =
     "Nearby Presence Discoverer Credential Hash";
+// Signatures are checked against every shared credential, on up to this many
+// threads when there are many.
+constexpr int kMaxSignatureVerificationThreads = 4;
+
+// Verifies |signature| of |message| with the key of each of
+// |shared_credentials|.
+std::vector<absl::Status> VerifyWithEachCredential(
+    absl::string_view message, absl::string_view signature,
+    const std::vector<internal::SharedCredential>& shared_credentials) {
+  std::vector<crypto::Ed25519SignedData> batch;
+  batch.reserve(shared_credentials.size());
+  for (const auto& shared_credential : shared_credentials) {
+    batch.push_back({
+        .public_key = shared_credential.connection_signature_verification_key(),
+        .data = message,
+        .signature = signature,
+    });
+  }
+  return crypto::Ed25519Verifier::VerifyBatch(batch,
+                                              kMaxSignatureVerificationThreads);
+}
 }  // namespace
 
 absl::StatusOr<ConnectionAuthenticator::InitiatorData>
@@ -101,17 +122,11 @@ absl::Status ConnectionAuthenticatorImpl::VerifyMessageAsInitiator(
   if (authentication_data.private_key_signature.empty()) {
     return absl::InvalidArgumentError("Empty private key signature.");
   }
-  for (const auto& shared_credential : shared_credentials) {
-    auto verifier = crypto::Ed25519Verifier::Create(
-        shared_credential.connection_signature_verification_key());
-    if (!verifier.ok()) {
-      continue;
-    }
-    // Verify ED25519 signature, returning true if verification succeeded.
-    if (verifier
-            ->Verify(absl::StrCat(kBroadcasterMessageHeader, ukey2_secret),
-                     authentication_data.private_key_signature)
-            .ok()) {
+  // Verify ED25519 signature, returning true if verification succeeded.
+  for (const absl::Status& status : VerifyWithEachCredential(
+           absl::StrCat(kBroadcasterMessageHeader, ukey2_secret),
+           authentication_data.private_key_signature, shared_credentials)) {
+    if (status.ok()) {
       return absl::OkStatus();
     }
   }
@@ -171,15 +186,15 @@ ConnectionAuthenticatorImpl::VerifyMessageAsResponder(
     }
     // Now, match our shared credential.
     std::optional<internal::SharedCredential> matched_shared_credential;
-    for (const auto& shared_credential : shared_credentials) {
-      auto verifier = crypto::Ed25519Verifier::Create(
-          shared_credential.connection_signature_verification_key());
-      if (!verifier.ok() ||
-          verifier
-              ->Verify(absl::StrCat(kDiscovererMessageHeader, ukey2_secret),
-                       auth_data.private_key_signature)
-              .ok()) {
-        matched_shared_credential = shared_credential;
+    std::vector<absl::Status> results = VerifyWithEachCredential(
+        absl::StrCat(kDiscovererMessageHeader, ukey2_secret),
+        auth_data.private_key_signature, shared_credentials);
+    for (size_t i = 0; i < shared_credentials.size(); ++i) {
+      if (results[i].ok() ||
+          !crypto::Ed25519Verifier::Create(
+               shared_credentials[i].connection_signature_verification_key())
+               .ok()) {
+        matched_shared_credential = shared_credentials[i];
         break;
       }
     }
@@ -29,6 +29,8 @@ namespace presence {
 
 using SubscriberId = uint64_t;
 
+class LdtDecryptorCache;
+
 /*
  * The instance of CredentialManager is owned by {@code ServiceControllerImpl}.
  * Helping service controller to manage local credentials and coordinate with
@@ -107,6 +109,10 @@ class CredentialManager {
 
   virtual ::nearby::internal::DeviceIdentityMetaData
   GetDeviceIdentityMetaData() = 0;
+
+  // Returns the LDT decryptors of the public credentials, kept until the
+  // credentials change. Returns null if no decryptors are kept.
+  virtual LdtDecryptorCache* GetLdtDecryptorCache() { return nullptr; }
 };
 
 }  // namespace presence
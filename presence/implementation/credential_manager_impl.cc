@@ -117,53 +117,76 @@ void CredentialManagerImpl::GenerateCredentials(
     const std::vector<IdentityType>& identity_types,
     int credential_life_cycle_days, int contiguous_copy_of_credentials,
     GenerateCredentialsResultCallback credentials_generated_cb) {
-  std::vector<SharedCredential> public_credentials;
-  std::vector<LocalCredential> private_credentials;
-
+  auto pending = std::make_unique<PendingCredentials>();
+  pending->device_identity_metadata = device_identity_metadata;
   for (auto identity_type : identity_types) {
     absl::Time start_time = SystemClock::ElapsedRealtime();
     absl::Duration gap = credential_life_cycle_days * absl::Hours(24);
     for (int index = 0; index < contiguous_copy_of_credentials; index++) {
-      auto public_private_credentials =
-          CreateLocalCredential(device_identity_metadata, identity_type,
-                                start_time, start_time + gap);
-      if (public_private_credentials.second.identity_type() !=
-          IdentityType::IDENTITY_TYPE_UNSPECIFIED) {
-        private_credentials.push_back(public_private_credentials.first);
-        public_credentials.push_back(public_private_credentials.second);
-      }
+      pending->slots.push_back({identity_type, start_time, start_time + gap});
       start_time += gap;
     }
   }
 
-  // Create credential_storage object and invoke SaveCredentials.
-  credential_storage_ptr_->SaveCredentials(
-      manager_app_id, kEmptyAccountName, private_credentials,
-      public_credentials, PublicCredentialType::kLocalPublicCredential,
-      SaveCredentialsResultCallback{
-          .credentials_saved_cb =
-              [this, manager_app_id = std::string(manager_app_id),
-               account_name = kEmptyAccountName,
-               callback = std::move(credentials_generated_cb),
-               public_credentials](absl::Status status) mutable {
-                if (!status.ok()) {
-                  NEARBY_LOGS(WARNING)
-                      << "Save credentials failed with: " << status;
-                  std::move(callback.credentials_generated_cb)(status);
-                  return;
-                }
-                std::move(callback.credentials_generated_cb)(
-                    std::move(public_credentials));
-                RunOnServiceControllerThread(
-                    "local-creds-changed",
-                    [this, manager_app_id = std::string(manager_app_id),
-                     account_name = std::string(account_name)]()
-                        ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_) {
-                          OnCredentialsChanged(
-                              manager_app_id, account_name,
-                              PublicCredentialType::kLocalPublicCredential);
-                        });
-              }});
+  pending->on_created = [this, manager_app_id = std::string(manager_app_id),
+                         callback = std::move(credentials_generated_cb)](
+                            std::vector<LocalCredential> private_credentials,
+                            std::vector<SharedCredential>
+                                public_credentials) mutable {
+    // Create credential_storage object and invoke SaveCredentials.
+    credential_storage_ptr_->SaveCredentials(
+        manager_app_id, kEmptyAccountName, private_credentials,
+        public_credentials, PublicCredentialType::kLocalPublicCredential,
+        SaveCredentialsResultCallback{
+            .credentials_saved_cb =
+                [this, manager_app_id, account_name = kEmptyAccountName,
+                 callback = std::move(callback),
+                 public_credentials](absl::Status status) mutable {
+                  if (!status.ok()) {
+                    NEARBY_LOGS(WARNING)
+                        << "Save credentials failed with: " << status;
+                    std::move(callback.credentials_generated_cb)(status);
+                    return;
+                  }
+                  std::move(callback.credentials_generated_cb)(
+                      std::move(public_credentials));
+                  RunOnServiceControllerThread(
+                      "local-creds-changed",
+                      [this, manager_app_id,
+                       account_name = std::string(account_name)]()
+                          ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_) {
+                            OnCredentialsChanged(
+                                manager_app_id, account_name,
+                                PublicCredentialType::kLocalPublicCredential);
+                          });
+                }});
+  };
+  CreateCredentialsInSlices(std::move(pending));
+}
+
+void CredentialManagerImpl::CreateCredentialsInSlices(
+    std::unique_ptr<PendingCredentials> pending) {
+  if (pending->next_slot == pending->slots.size()) {
+    std::move(pending->on_created)(std::move(pending->local_credentials),
+                                   std::move(pending->shared_credentials));
+    return;
+  }
+  RunOnServiceControllerThread(
+      "create-credential", [this, pending = std::move(pending)]() mutable {
+        const CredentialSlot& slot = pending->slots[pending->next_slot++];
+        auto public_private_credentials =
+            CreateLocalCredential(pending->device_identity_metadata,
+                                  slot.identity_type, slot.start_time,
+                                  slot.end_time);
+        if (public_private_credentials.second.identity_type() !=
+            IdentityType::IDENTITY_TYPE_UNSPECIFIED) {
+          pending->local_credentials.push_back(
+              std::move(public_private_credentials.first));
+          pending->shared_credentials.push_back(
+              std::move(public_private_credentials.second));
+        }
+        CreateCredentialsInSlices(std::move(pending));
+      });
 }
 
 void CredentialManagerImpl::UpdateRemotePublicCredentials(
@@ -516,6 +539,8 @@ void CredentialManagerImpl::OnCredentialsChanged(
     PublicCredentialType credential_type) {
   NEARBY_LOGS(INFO) << "OnCredentialsChanged for app " << manager_app_id
                     << ", account " << account_name;
+  // Decryptors of the replaced credentials must not outlive them.
+  ldt_decryptor_cache_.Clear();
   for (IdentityType identity_type :
        GetSubscribedIdentities(manager_app_id, account_name, credential_type)) {
     CredentialSelector credential_selector = {
@@ -747,51 +772,64 @@ void CredentialManagerImpl::RefillRemainingValidCredentialsWithNewCredentials(
   int valid_credentials_count = valid_local_credentials.size();
   CHECK_EQ(valid_credentials_count, valid_shared_credentials.size());
 
-  std::vector<LocalCredential> newly_generated_local_credentials;
-  std::vector<SharedCredential> newly_generated_shared_credentials;
-
   // Generate more credential pairs to refill the expired ones.
+  auto pending = std::make_unique<PendingCredentials>();
+  pending->device_identity_metadata = device_identity_metadata_;
   auto start_time =
       absl::FromUnixMillis(start_time_to_generate_new_credentials_millis);
   auto gap = kCredentialLifeCycleDays * absl::Hours(24);
   for (int i = 0; i < kExpectedValidLocalCredtialSize - valid_credentials_count;
        i++) {
-    auto pair = CreateLocalCredential(device_identity_metadata_,
-                                      credential_selector.identity_type,
-                                      start_time, start_time + gap);
-    newly_generated_local_credentials.push_back(std::move(pair.first));
-    newly_generated_shared_credentials.push_back(std::move(pair.second));
+    pending->slots.push_back(
+        {credential_selector.identity_type, start_time, start_time + gap});
     start_time += gap;
   }
 
-  // Now merge newly generated credentials to already existing valid ones.
-  valid_local_credentials.insert(valid_local_credentials.end(),
-                                 newly_generated_local_credentials.begin(),
-                                 newly_generated_local_credentials.end());
-  valid_shared_credentials.insert(valid_shared_credentials.end(),
-                                  newly_generated_shared_credentials.begin(),
-                                  newly_generated_shared_credentials.end());
-
-  // Save merged local and shared credential lists to storage
-  credential_storage_ptr_->SaveCredentials(
-      credential_selector.manager_app_id, credential_selector.account_name,
-      valid_local_credentials, valid_shared_credentials,
-      PublicCredentialType::kLocalPublicCredential,
-      SaveCredentialsResultCallback{
-          .credentials_saved_cb =
-              [this, valid_local_credentials, valid_shared_credentials,
-               callback_for_local_credentials =
-                   std::move(callback_for_local_credentials),
-               callback_for_shared_credentials =
-                   std::move(callback_for_shared_credentials)](
-                  absl::Status status) mutable {
-                OnCredentialRefillComplete(
-                    std::move(status), valid_local_credentials,
-                    valid_shared_credentials,
-                    std::move(callback_for_local_credentials),
-                    std::move(callback_for_shared_credentials));
-              },
-      });
+  pending->on_created =
+      [this, credential_selector,
+       valid_local_credentials = std::move(valid_local_credentials),
+       valid_shared_credentials = std::move(valid_shared_credentials),
+       callback_for_local_credentials =
+           std::move(callback_for_local_credentials),
+       callback_for_shared_credentials =
+           std::move(callback_for_shared_credentials)](
+          std::vector<LocalCredential> newly_generated_local_credentials,
+          std::vector<SharedCredential>
+              newly_generated_shared_credentials) mutable {
+        // Now merge newly generated credentials to already existing valid
+        // ones.
+        valid_local_credentials.insert(
+            valid_local_credentials.end(),
+            newly_generated_local_credentials.begin(),
+            newly_generated_local_credentials.end());
+        valid_shared_credentials.insert(
+            valid_shared_credentials.end(),
+            newly_generated_shared_credentials.begin(),
+            newly_generated_shared_credentials.end());
+
+        // Save merged local and shared credential lists to storage
+        credential_storage_ptr_->SaveCredentials(
+            credential_selector.manager_app_id,
+            credential_selector.account_name, valid_local_credentials,
+            valid_shared_credentials,
+            PublicCredentialType::kLocalPublicCredential,
+            SaveCredentialsResultCallback{
+                .credentials_saved_cb =
+                    [this, valid_local_credentials, valid_shared_credentials,
+                     callback_for_local_credentials =
+                         std::move(callback_for_local_credentials),
+                     callback_for_shared_credentials =
+                         std::move(callback_for_shared_credentials)](
+                        absl::Status status) mutable {
+                      OnCredentialRefillComplete(
+                          std::move(status), valid_local_credentials,
+                          valid_shared_credentials,
+                          std::move(callback_for_local_credentials),
+                          std::move(callback_for_shared_credentials));
+                    },
+            });
+      };
+  CreateCredentialsInSlices(std::move(pending));
 }
 
 void CredentialManagerImpl::OnCredentialRefillComplete(
@@ -16,6 +16,7 @@
 #define THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_CREDENTIAL_MANAGER_IMPL_H_
 
 #include <atomic>
+#include <cstddef>
 #include <memory>
 #include <optional>
 #include <string>
@@ -24,6 +25,7 @@
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
 #include "absl/log/die_if_null.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
@@ -34,8 +36,10 @@
 #include "internal/platform/runnable.h"
 #include "internal/platform/single_thread_executor.h"
 #include "internal/proto/credential.pb.h"
+#include "internal/proto/local_credential.pb.h"
 #include "internal/proto/metadata.pb.h"
 #include "presence/implementation/credential_manager.h"
+#include "presence/implementation/ldt_decryptor_cache.h"
 
 namespace nearby {
 namespace presence {
@@ -155,6 +159,10 @@ class CredentialManagerImpl : public CredentialManager {
     return device_identity_metadata_;
   }
 
+  LdtDecryptorCache* GetLdtDecryptorCache() override {
+    return &ldt_decryptor_cache_;
+  }
+
  private:
   struct SubscriberKey {
     CredentialSelector credential_selector;
@@ -185,6 +193,29 @@ class CredentialManagerImpl : public CredentialManager {
     SubscriberId id_;
   };
 
+  // The validity period of a credential to create.
+  struct CredentialSlot {
+    IdentityType identity_type;
+    absl::Time start_time;
+    absl::Time end_time;
+  };
+  struct PendingCredentials {
+    DeviceIdentityMetaData device_identity_metadata;
+    std::vector<CredentialSlot> slots;
+    size_t next_slot = 0;
+    std::vector<nearby::internal::LocalCredential> local_credentials;
+    std::vector<nearby::internal::SharedCredential> shared_credentials;
+    absl::AnyInvocable<void(std::vector<nearby::internal::LocalCredential>,
+                            std::vector<nearby::internal::SharedCredential>)>
+        on_created;
+  };
+
+  // Creates the credentials of `pending->slots` one per task on `executor_`,
+  // so that the broadcasts and scans sharing the thread aren't stalled while
+  // the keys are generated. Then hands the credentials to
+  // `pending->on_created`. Credentials failing to be created are skipped.
+  void CreateCredentialsInSlices(std::unique_ptr<PendingCredentials> pending);
+
   void RunOnServiceControllerThread(absl::string_view name,
                                     Runnable&& runnable) {
     executor_->Execute(std::string(name), std::move(runnable));
@@ -254,6 +285,7 @@ class CredentialManagerImpl : public CredentialManager {
   SingleThreadExecutor* executor_;
   std::unique_ptr<nearby::CredentialStorageImpl> credential_storage_ptr_;
   DeviceIdentityMetaData device_identity_metadata_;
+  LdtDecryptorCache ldt_decryptor_cache_;
 };
 
 }  // namespace presence
@@ -14,6 +14,7 @@
 
 #include "presence/implementation/credential_manager_impl.h"
 
+#include <atomic>
 #include <memory>
 #include <optional>
 #include <string>
@@ -309,6 +310,29 @@ TEST_F(CredentialManagerImplTest, GenerateCredentialsSuccessfully) {
   }
 }
 
+TEST_F(CredentialManagerImplTest, GenerateCredentialsLetsOtherTasksRun) {
+  std::atomic_bool generated = false;
+  std::atomic_bool task_ran_before_generated = false;
+  CountDownLatch latch(1);
+
+  credential_manager_.GenerateCredentials(
+      CreateTestDeviceIdentityMetaData(), kManagerAppId,
+      {IDENTITY_TYPE_PRIVATE_GROUP}, kExpectedPresenceCredentialValidDays,
+      kExpectedPresenceCredentialListSize,
+      {.credentials_generated_cb =
+           [&](absl::StatusOr<std::vector<SharedCredential>> credentials) {
+             EXPECT_OK(credentials);
+             generated = true;
+             latch.CountDown();
+           }});
+  // Credentials are created one task at a time, so this task doesn't wait
+  // for the whole batch.
+  executor_.Execute([&]() { task_ran_before_generated = !generated; });
+
+  EXPECT_TRUE(latch.Await().Ok());
+  EXPECT_TRUE(task_ran_before_generated);
+}
+
 TEST_F(CredentialManagerImplTest,
        SubscribeCallsCallbackWithExistingCredentials) {
   absl::StatusOr<std::vector<SharedCredential>> public_credentials1;
@@ -0,0 +1,52 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "presence/implementation/ldt_decryptor_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/status/statusor.h"
+#include "internal/platform/mutex_lock.h"
+#include "internal/proto/credential.pb.h"
+#include "presence/implementation/ldt.h"
+
+namespace nearby {
+namespace presence {
+
+absl::StatusOr<std::shared_ptr<LdtEncryptor>> LdtDecryptorCache::GetDecryptor(
+    const ::nearby::internal::SharedCredential& credential) {
+  MutexLock lock(&mutex_);
+  Key key{credential.key_seed(), credential.metadata_encryption_key_tag_v0()};
+  auto it = decryptors_.find(key);
+  if (it != decryptors_.end()) {
+    return it->second;
+  }
+  absl::StatusOr<LdtEncryptor> decryptor =
+      LdtEncryptor::Create(key.first, key.second);
+  if (!decryptor.ok()) {
+    return decryptor.status();
+  }
+  auto shared = std::make_shared<LdtEncryptor>(*std::move(decryptor));
+  decryptors_.emplace(std::move(key), shared);
+  return shared;
+}
+
+void LdtDecryptorCache::Clear() {
+  MutexLock lock(&mutex_);
+  decryptors_.clear();
+}
+
+}  // namespace presence
+}  // namespace nearby
@@ -0,0 +1,64 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_LDT_DECRYPTOR_CACHE_H_
+#define THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_LDT_DECRYPTOR_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+#include "internal/platform/mutex.h"
+#include "internal/proto/credential.pb.h"
+#include "presence/implementation/ldt.h"
+
+namespace nearby {
+namespace presence {
+
+// Keeps the `LdtEncryptor` of every shared credential an advertisement was
+// decrypted with, so that decoding an advertisement doesn't derive the LDT
+// keys of all credentials again.
+//
+// Owned by `CredentialManagerImpl`, which clears it whenever the credentials
+// change.
+class LdtDecryptorCache {
+ public:
+  LdtDecryptorCache() = default;
+  LdtDecryptorCache(const LdtDecryptorCache&) = delete;
+  LdtDecryptorCache& operator=(const LdtDecryptorCache&) = delete;
+
+  // Returns the decryptor for `credential`, creating it on first use.
+  absl::StatusOr<std::shared_ptr<LdtEncryptor>> GetDecryptor(
+      const ::nearby::internal::SharedCredential& credential)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Drops all decryptors. The ones handed out before remain usable.
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  // The key seed and the known HMAC the decryptor was created with.
+  using Key = std::pair<std::string, std::string>;
+
+  Mutex mutex_;
+  absl::flat_hash_map<Key, std::shared_ptr<LdtEncryptor>> decryptors_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace presence
+}  // namespace nearby
+
+#endif  // THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_LDT_DECRYPTOR_CACHE_H_
@@ -0,0 +1,101 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "presence/implementation/ldt_decryptor_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "protobuf-matchers/protocol-buffer-matchers.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/string_view.h"
+#include "internal/proto/credential.pb.h"
+#include "presence/implementation/ldt.h"
+
+namespace nearby {
+namespace presence {
+namespace {
+
+using ::nearby::internal::SharedCredential;
+
+// Test data from Android tests.
+constexpr absl::string_view kKeySeedBase16 =
+    "CCDB2489E9FCAC42B39348B8941ED19A1D360E75E098C8C15E6B1CC2B620CD39";
+constexpr absl::string_view kKnownMacBase16 =
+    "B4C59FA599241B81758D976B5A621C05232FE1BF89AE5987CA254C3554DCE50E";
+constexpr absl::string_view kPlainTextBase16 =
+    "CD683FE1A1D1F846543D0A13D4AEA40040C8D67B";
+constexpr absl::string_view kCipherTextBase16 =
+    "61E481C12F4DE24F2D4AB22D8908F80D3A3F9B40";
+constexpr absl::string_view kSaltBase16 = "0C0F";
+
+SharedCredential MakeCredential() {
+  SharedCredential credential;
+  credential.set_key_seed(absl::HexStringToBytes(kKeySeedBase16));
+  credential.set_metadata_encryption_key_tag_v0(
+      absl::HexStringToBytes(kKnownMacBase16));
+  return credential;
+}
+
+TEST(LdtDecryptorCache, DecryptsWithTheCachedDecryptor) {
+  LdtDecryptorCache cache;
+
+  absl::StatusOr<std::shared_ptr<LdtEncryptor>> decryptor =
+      cache.GetDecryptor(MakeCredential());
+  ASSERT_OK(decryptor);
+  absl::StatusOr<std::string> decrypted = (*decryptor)->DecryptAndVerify(
+      absl::HexStringToBytes(kCipherTextBase16),
+      absl::HexStringToBytes(kSaltBase16));
+
+  ASSERT_OK(decrypted);
+  EXPECT_EQ(*decrypted, absl::HexStringToBytes(kPlainTextBase16));
+}
+
+TEST(LdtDecryptorCache, ReusesTheDecryptorOfACredential) {
+  LdtDecryptorCache cache;
+
+  absl::StatusOr<std::shared_ptr<LdtEncryptor>> first =
+      cache.GetDecryptor(MakeCredential());
+  absl::StatusOr<std::shared_ptr<LdtEncryptor>> second =
+      cache.GetDecryptor(MakeCredential());
+
+  ASSERT_OK(first);
+  ASSERT_OK(second);
+  EXPECT_EQ(*first, *second);
+}
+
+TEST(LdtDecryptorCache, ClearDropsTheDecryptors) {
+  LdtDecryptorCache cache;
+  absl::StatusOr<std::shared_ptr<LdtEncryptor>> before =
+      cache.GetDecryptor(MakeCredential());
+  ASSERT_OK(before);
+
+  cache.Clear();
+  absl::StatusOr<std::shared_ptr<LdtEncryptor>> after =
+      cache.GetDecryptor(MakeCredential());
+
+  ASSERT_OK(after);
+  EXPECT_NE(*before, *after);
+  // A decryptor handed out before the cache was cleared is still usable.
+  EXPECT_OK(
+      (*before)->DecryptAndVerify(absl::HexStringToBytes(kCipherTextBase16),
+                                  absl::HexStringToBytes(kSaltBase16)));
+}
+
+}  // namespace
+}  // namespace presence
+}  // namespace nearby
@@ -16,6 +16,7 @@
 
 #include <assert.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -23,13 +24,18 @@
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "internal/platform/count_down_latch.h"
 #include "internal/platform/future.h"
 #include "internal/platform/implementation/ble_v2.h"
 #include "internal/platform/implementation/credential_callbacks.h"
 #include "internal/platform/implementation/crypto.h"
 #include "internal/platform/logging.h"
+#include "internal/platform/trace_event.h"
 #include "presence//implementation/advertisement_filter.h"
 #include "presence/data_element.h"
 #include "presence/data_types.h"
@@ -67,22 +73,14 @@ ScanSessionId ScanManager::StartScan(ScanRequest scan_request,
             .advertisement_found_cb =
                 [this, id](BlePeripheral& peripheral,
                            BleAdvertisementData data) {
-                  RunOnServiceControllerThread(
-                      "notify-found-ble",
-                      [this, id, data = std::move(data),
-                       address = peripheral.GetAddress()]()
-                          ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_) {
-                            NotifyFoundBle(id, data, address);
-                          });
+                  QueueBleEvent({.id = id,
+                                 .remote_address = peripheral.GetAddress(),
+                                 .data = std::move(data)});
                 },
             .advertisement_lost_cb =
                 [this, id](BlePeripheral& peripheral) {
-                  RunOnServiceControllerThread(
-                      "notify-lost-ble",
-                      [this, id, address = peripheral.GetAddress()]()
-                          ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_) {
-                            NotifyLostBle(id, address);
-                          });
+                  QueueBleEvent({.id = id,
+                                 .remote_address = peripheral.GetAddress()});
                 }};
         FetchCredentials(id, scan_request);
         scan_sessions_.insert(
@@ -114,36 +112,113 @@ void ScanManager::StopScan(ScanSessionId id) {
       });
 }
 
-void ScanManager::NotifyFoundBle(ScanSessionId id, BleAdvertisementData data,
-                                 absl::string_view remote_address) {
-  auto it = scan_sessions_.find(id);
-  if (it == scan_sessions_.end()) {
+void ScanManager::QueueBleEvent(PendingBleEvent event) {
+  MutexLock lock(&pending_mutex_);
+  pending_ble_events_.push_back(std::move(event));
+  if (decode_batch_scheduled_) {
     return;
   }
+  decode_batch_scheduled_ = true;
+  RunOnServiceControllerThread(
+      "decode-ble-batch",
+      [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_) { DecodeBleBatch(); });
+}
 
-  auto advertisement_data =
-      data.service_data[kPresenceServiceUuid].AsStringView();
+void ScanManager::DecodeBleBatch() {
+  NEARBY_TRACE_EVENT("presence", "Decode BLE advertisements");
+  std::vector<PendingBleEvent> batch;
+  {
+    MutexLock lock(&pending_mutex_);
+    while (!pending_ble_events_.empty() &&
+           batch.size() < kMaxDecodeBatchSize) {
+      batch.push_back(std::move(pending_ble_events_.front()));
+      pending_ble_events_.pop_front();
+    }
+    if (pending_ble_events_.empty()) {
+      decode_batch_scheduled_ = false;
+    } else {
+      // Tasks queued in the meantime, like stopping a scan, run before the
+      // next batch.
+      RunOnServiceControllerThread(
+          "decode-ble-batch", [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(
+                                  *executor_) { DecodeBleBatch(); });
+    }
+  }
 
-  auto advert = it->second.decoder.DecodeAdvertisement(advertisement_data);
-  if (!advert.ok()) {
-    // This advertisement is not relevant to the current element, skip.
+  // A session's decoder is not thread-safe, so the advertisements of one
+  // session are decoded by the same task.
+  absl::flat_hash_map<ScanSessionId, std::vector<size_t>> found_by_session;
+  for (size_t i = 0; i < batch.size(); ++i) {
+    if (batch[i].data.has_value() && scan_sessions_.contains(batch[i].id)) {
+      found_by_session[batch[i].id].push_back(i);
+    }
+  }
+  std::vector<absl::StatusOr<Advertisement>> adverts(batch.size());
+  auto decode = [&batch, &adverts](AdvertisementDecoderImpl& decoder,
+                                   const std::vector<size_t>& indices) {
+    std::vector<absl::string_view> advertisements;
+    advertisements.reserve(indices.size());
+    for (size_t i : indices) {
+      advertisements.push_back(
+          batch[i].data->service_data[kPresenceServiceUuid].AsStringView());
+    }
+    std::vector<absl::StatusOr<Advertisement>> results(indices.size());
+    decoder.DecodeAdvertisements(advertisements, absl::MakeSpan(results));
+    for (size_t j = 0; j < indices.size(); ++j) {
+      adverts[indices[j]] = std::move(results[j]);
+    }
+  };
+  if (found_by_session.size() == 1) {
+    const auto& [id, indices] = *found_by_session.begin();
+    decode(scan_sessions_.find(id)->second.decoder, indices);
+  } else if (found_by_session.size() > 1) {
+    CountDownLatch latch(found_by_session.size());
+    for (const auto& [id, indices] : found_by_session) {
+      AdvertisementDecoderImpl* decoder =
+          &scan_sessions_.find(id)->second.decoder;
+      decode_executor_.Execute(
+          "decode-ble", [&decode, &latch, decoder, &indices = indices]() {
+            decode(*decoder, indices);
+            latch.CountDown();
+          });
+    }
+    // `executor_` is blocked until the batch is decoded, so the sessions and
+    // their credentials can't change in the meantime.
+    latch.Await();
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    const PendingBleEvent& event = batch[i];
+    if (!event.data.has_value()) {
+      NotifyLostBle(event.id, event.remote_address);
+    } else if (adverts[i].ok()) {
+      NotifyFoundBle(event.id, *adverts[i], event.remote_address);
+    }
+    // Otherwise the advertisement is not relevant to the session, skip.
+  }
+}
+
+void ScanManager::NotifyFoundBle(ScanSessionId id, const Advertisement& advert,
+                                 absl::string_view remote_address) {
+  auto it = scan_sessions_.find(id);
+  if (it == scan_sessions_.end()) {
     return;
   }
 
-  if (it->second.advertisement_filter.MatchesScanFilter(*advert)) {
+  if (it->second.advertisement_filter.MatchesScanFilter(advert)) {
     internal::DeviceIdentityMetaData device_identity_metadata;
     device_identity_metadata.set_bluetooth_mac_address(
         std::string(remote_address));
 
     if (!device_address_to_endpoint_id_map_.contains(remote_address)) {
       PresenceDevice device(DeviceMotion(), device_identity_metadata,
-                            advert->identity_type);
+                            advert.identity_type);
       // Ok if the advertisement is for trusted/private identity.
-      if (advert->public_credential.ok()) {
-        device.SetDecryptSharedCredential(*(advert->public_credential));
+      if (advert.public_credential.ok()) {
+        device.SetDecryptSharedCredential(*(advert.public_credential));
       }
-      device.AddExtendedProperties(advert->data_elements);
-      for (const auto& data_element : advert->data_elements) {
+      device.AddExtendedProperties(advert.data_elements);
+      for (const auto& data_element : advert.data_elements) {
         if (data_element.GetType() == DataElement::kActionFieldType) {
           device.AddAction(PresenceAction(static_cast<int>(
               static_cast<uint8_t>(data_element.GetValue()[0]))));
@@ -159,11 +234,11 @@ void ScanManager::NotifyFoundBle(ScanSessionId id, BleAdvertisementData data,
           device_address_to_endpoint_id_map_.at(remote_address));
       device.SetDeviceIdentityMetaData(device_identity_metadata);
       // Ok if the advertisement is for trusted/private identity.
-      if (advert->public_credential.ok()) {
-        device.SetDecryptSharedCredential(*(advert->public_credential));
+      if (advert.public_credential.ok()) {
+        device.SetDecryptSharedCredential(*(advert.public_credential));
       }
-      device.AddExtendedProperties(advert->data_elements);
-      for (const auto& data_element : advert->data_elements) {
+      device.AddExtendedProperties(advert.data_elements);
+      for (const auto& data_element : advert.data_elements) {
         if (data_element.GetType() == DataElement::kActionFieldType) {
           device.AddAction(PresenceAction(static_cast<int>(
               static_cast<uint8_t>(data_element.GetValue()[0]))));
@@ -266,7 +341,12 @@ void ScanManager::UpdateCredentials(ScanSessionId id,
 
   ScanSessionState& session = it->second;
   session.credentials[identity_type] = std::move(credentials);
+#ifdef USE_RUST_DECODER
   session.decoder = AdvertisementDecoderImpl(&session.credentials);
+#else
+  session.decoder = AdvertisementDecoderImpl(
+      &session.credentials, credential_manager_->GetLdtDecryptorCache());
+#endif
 }
 
 int ScanManager::ScanningCallbacksLengthForTest() {
@@ -15,21 +15,27 @@
 #ifndef THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_SCAN_MANAGER_H_
 #define THIRD_PARTY_NEARBY_PRESENCE_IMPLEMENTATION_SCAN_MANAGER_H_
 
+#include <cstddef>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "internal/platform/implementation/ble_v2.h"
+#include "internal/platform/multi_thread_executor.h"
 #include "internal/platform/mutex.h"
 #include "internal/platform/mutex_lock.h"
 #include "internal/platform/runnable.h"
 #include "internal/platform/single_thread_executor.h"
 #include "internal/proto/credential.pb.h"
 #include "presence/data_types.h"
+#include "presence/implementation/advertisement_decoder.h"
 #include "presence/implementation/advertisement_filter.h"
 #include "presence/implementation/credential_manager.h"
 #include "presence/implementation/mediums/mediums.h"
@@ -71,6 +77,11 @@ class ScanManager {
   // Reference: go/totw/135#augmenting-the-public-api-for-tests
   int ScanningCallbacksLengthForTest();
 
+  // The most BLE scan results handled by one decode batch.
+  static constexpr size_t kMaxDecodeBatchSize = 32;
+  // The number of threads decoding the advertisements of a batch.
+  static constexpr int kMaxDecodeThreads = 4;
+
  private:
   struct ScanSessionState {
     ScanRequest request;
@@ -81,7 +92,22 @@ class ScanManager {
     AdvertisementFilter advertisement_filter;
     std::unique_ptr<ScanningSession> scanning_session;
   };
-  void NotifyFoundBle(ScanSessionId id, BleAdvertisementData data,
+  // A BLE scan result waiting for the next decode batch. `data` is empty for
+  // a lost advertisement.
+  struct PendingBleEvent {
+    ScanSessionId id;
+    std::string remote_address;
+    std::optional<BleAdvertisementData> data;
+  };
+  // Called from the BLE scanning callbacks. Queues `event` and schedules a
+  // decode batch if none is pending.
+  void QueueBleEvent(PendingBleEvent event) ABSL_LOCKS_EXCLUDED(pending_mutex_);
+  // Takes up to `kMaxDecodeBatchSize` queued scan results, decodes the found
+  // advertisements on `decode_executor_` and then notifies the sessions in the
+  // order the results arrived.
+  void DecodeBleBatch() ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_)
+      ABSL_LOCKS_EXCLUDED(pending_mutex_);
+  void NotifyFoundBle(ScanSessionId id, const Advertisement& advert,
                       absl::string_view remote_address)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(*executor_);
   void NotifyLostBle(ScanSessionId id, absl::string_view remote_address)
@@ -102,6 +128,12 @@ class ScanManager {
       device_address_to_endpoint_id_map_
       ABSL_GUARDED_BY(*executor_);
   SingleThreadExecutor* executor_;
+  Mutex pending_mutex_;
+  std::deque<PendingBleEvent> pending_ble_events_
+      ABSL_GUARDED_BY(pending_mutex_);
+  bool decode_batch_scheduled_ ABSL_GUARDED_BY(pending_mutex_) = false;
+  // Only runs tasks while `executor_` waits for them in `DecodeBleBatch()`.
+  MultiThreadExecutor decode_executor_{kMaxDecodeThreads};
 };
 
 }  // namespace presence
@@ -279,6 +279,38 @@ TEST_F(ScanManagerTest, DiscoverThenLoseAdvertisement) {
   EXPECT_EQ(manager.ScanningCallbacksLengthForTest(), 0);
 }
 
+TEST_F(ScanManagerTest, EverySessionIsNotifiedOfAnAdvertisement) {
+  Mediums mediums;
+  ScanManager manager(mediums, credential_manager_, executor_);
+  CountDownLatch notified_latch1{1};
+  CountDownLatch notified_latch2{1};
+  // The device is already known to the session seeing it last, which is
+  // notified of an update instead.
+  auto make_callback = [](CountDownLatch& latch) {
+    return ScanCallback{
+        .start_scan_cb = [](absl::Status status) {},
+        .on_discovered_cb = [&latch](PresenceDevice pd) { latch.CountDown(); },
+        .on_updated_cb = [&latch](PresenceDevice pd) { latch.CountDown(); }};
+  };
+  ScanSessionId scan_session1 = manager.StartScan(
+      MakeDefaultScanRequest(), make_callback(notified_latch1));
+  ScanSessionId scan_session2 = manager.StartScan(
+      MakeDefaultScanRequest(), make_callback(notified_latch2));
+  ASSERT_EQ(manager.ScanningCallbacksLengthForTest(), 2);
+
+  // Set up advertiser
+  nearby::BluetoothAdapter server_adapter;
+  Ble ble2(server_adapter);
+  std::unique_ptr<AdvertisingSession> advertising_session =
+      StartAdvertisingOn(ble2);
+
+  EXPECT_TRUE(notified_latch1.Await().Ok());
+  EXPECT_TRUE(notified_latch2.Await().Ok());
+  manager.StopScan(scan_session1);
+  manager.StopScan(scan_session2);
+  EXPECT_EQ(manager.ScanningCallbacksLengthForTest(), 0);
+}
+
 TEST_F(ScanManagerTest, StopOneSessionFromAnotherDeadlock) {
   Mediums mediums;
   ScanManager manager(mediums, credential_manager_, executor_);
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_PRESENCE_PRESENCE_DEVICE_H_
 #define THIRD_PARTY_NEARBY_PRESENCE_PRESENCE_DEVICE_H_
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -67,6 +68,9 @@ class PresenceDevice : public nearby::NearbyDevice {
   NearbyDevice::Type GetType() const override {
     return NearbyDevice::Type::kPresenceDevice;
   }
+  std::unique_ptr<nearby::NearbyDevice> Clone() const override {
+    return std::make_unique<PresenceDevice>(*this);
+  }
   DeviceMotion GetDeviceMotion() const { return device_motion_; }
   DeviceIdentityMetaData GetDeviceIdentityMetadata() const {
     return device_identity_metadata_;
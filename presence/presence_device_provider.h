@@ -15,6 +15,8 @@
 #ifndef THIRD_PARTY_NEARBY_PRESENCE_PRESENCE_DEVICE_PROVIDER_H_
 #define THIRD_PARTY_NEARBY_PRESENCE_PRESENCE_DEVICE_PROVIDER_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -41,6 +43,9 @@ class PresenceDeviceProvider : public NearbyDeviceProvider {
       const ConnectionAuthenticator* connection_authenticator);
 
   const NearbyDevice* GetLocalDevice() override { return &device_; }
+  std::uint64_t GetLocalDeviceVersion() const override {
+    return local_device_version_;
+  }
 
   // To authenticate as an initiator (when the device is in the scanning role),
   // the PresenceDeviceProvider will block and:
@@ -64,6 +69,7 @@ class PresenceDeviceProvider : public NearbyDeviceProvider {
       const ::nearby::internal::DeviceIdentityMetaData&
           device_identity_metadata) {
     device_.SetDeviceIdentityMetaData(device_identity_metadata);
+    local_device_version_++;
   }
 
   void SetManagerAppId(absl::string_view manager_app_id) {
@@ -84,6 +90,8 @@ class PresenceDeviceProvider : public NearbyDeviceProvider {
 
   ServiceController& service_controller_;
   PresenceDevice device_;
+  // Bumped on every change to |device_|.
+  std::atomic<std::uint64_t> local_device_version_ = 0;
   std::string manager_app_id_;
   const ConnectionAuthenticator& connection_authenticator_;
 };
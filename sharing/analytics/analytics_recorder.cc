@@ -18,11 +18,15 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "google/protobuf/duration.pb.h"
 #include "absl/random/random.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "internal/platform/count_down_latch.h"
+#include "internal/platform/mutex_lock.h"
 #include "proto/sharing_enums.pb.h"
 #include "sharing/analytics/analytics_device_settings.h"
 #include "sharing/analytics/analytics_information.h"
@@ -854,12 +858,46 @@ std::unique_ptr<SharingLog> AnalyticsRecorder::CreateSharingLog(
   return sharing_log;
 }
 
+AnalyticsRecorder::~AnalyticsRecorder() {
+  serial_executor_.Shutdown();
+  // Logs the events whose task did not get to run.
+  if (event_logger_ != nullptr) {
+    LogPendingEvents();
+  }
+}
+
 void AnalyticsRecorder::LogEvent(const SharingLog& message) {
   if (event_logger_ == nullptr) {
     return;
   }
 
-  event_logger_->Log(message);
+  MutexLock lock(&mutex_);
+  pending_events_.push_back(message);
+  if (logging_scheduled_) {
+    return;
+  }
+  logging_scheduled_ = true;
+  serial_executor_.Execute("analytics-recorder",
+                           [this]() { LogPendingEvents(); });
+}
+
+void AnalyticsRecorder::LogPendingEvents() {
+  std::vector<SharingLog> events;
+  {
+    MutexLock lock(&mutex_);
+    events = std::move(pending_events_);
+    pending_events_.clear();
+    logging_scheduled_ = false;
+  }
+  for (const SharingLog& event : events) {
+    event_logger_->Log(event);
+  }
+}
+
+void AnalyticsRecorder::Sync() {
+  CountDownLatch latch(1);
+  serial_executor_.Execute([&]() { latch.CountDown(); });
+  latch.Await();
 }
 
 int64_t AnalyticsRecorder::GenerateNextId() {
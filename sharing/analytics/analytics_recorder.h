@@ -19,10 +19,14 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "internal/analytics/event_logger.h"
+#include "internal/platform/mutex.h"
+#include "internal/platform/single_thread_executor.h"
 #include "proto/sharing_enums.pb.h"
 #include "sharing/analytics/analytics_device_settings.h"
 #include "sharing/analytics/analytics_information.h"
@@ -36,12 +40,17 @@ namespace nearby {
 namespace sharing {
 namespace analytics {
 
+// Events are handed to the EventLogger on a thread of the recorder's own, in
+// the order they were recorded, so that a slow logger never holds up a
+// transfer. The events recorded while the logger is busy are handed over
+// together once it is done.
 class AnalyticsRecorder {
  public:
   explicit AnalyticsRecorder(int32_t vendor_id,
                              nearby::analytics::EventLogger* event_logger)
       : vendor_id_(vendor_id), event_logger_(event_logger) {}
-  ~AnalyticsRecorder() = default;
+  // Logs the events still pending before returning.
+  ~AnalyticsRecorder();
 
   void NewEstablishConnection(
       int64_t session_id,
@@ -205,15 +214,29 @@ class AnalyticsRecorder {
   // Generates a random number for session ID or flow ID.
   int64_t GenerateNextId();
 
+  // Waits until the events recorded so far are logged.
+  // For testing only.
+  void Sync();
+
  private:
   std::unique_ptr<nearby::sharing::analytics::proto::SharingLog>
   CreateSharingLog(
       location::nearby::proto::sharing::EventCategory event_category,
       location::nearby::proto::sharing::EventType event_type);
-  void LogEvent(const nearby::sharing::analytics::proto::SharingLog& message);
+  void LogEvent(const nearby::sharing::analytics::proto::SharingLog& message)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+  // Logs the pending events, on |serial_executor_|.
+  void LogPendingEvents() ABSL_LOCKS_EXCLUDED(mutex_);
 
   const int32_t vendor_id_;
   nearby::analytics::EventLogger* event_logger_ = nullptr;
+  Mutex mutex_;
+  std::vector<nearby::sharing::analytics::proto::SharingLog> pending_events_
+      ABSL_GUARDED_BY(mutex_);
+  // Set while a LogPendingEvents() task is scheduled and has not started
+  // yet.
+  bool logging_scheduled_ ABSL_GUARDED_BY(mutex_) = false;
+  SingleThreadExecutor serial_executor_;
 };
 
 }  // namespace analytics
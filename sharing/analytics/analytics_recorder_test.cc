@@ -26,6 +26,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "internal/analytics/mock_event_logger.h"
+#include "internal/platform/count_down_latch.h"
 #include "proto/sharing_enums.pb.h"
 #include "sharing/analytics/analytics_device_settings.h"
 #include "sharing/analytics/analytics_information.h"
@@ -66,7 +67,7 @@ class AnalyticsRecorderTest : public ::testing::Test {
 
   MockEventLogger& event_logger() { return event_logger_; }
 
-  AnalyticsRecorder analytics_recoder() { return analytics_recorder_; }
+  AnalyticsRecorder& analytics_recoder() { return analytics_recorder_; }
 
  private:
   MockEventLogger event_logger_;
@@ -905,6 +906,34 @@ TEST_F(AnalyticsRecorderTest, NewRpcCallStatus) {
       absl::Milliseconds(456));
 }
 
+TEST_F(AnalyticsRecorderTest, LogsOffTheCallingThread) {
+  CountDownLatch logging(1);
+  CountDownLatch released(1);
+  ::testing::InSequence sequence;
+  EXPECT_CALL(event_logger(), Log(An<const SharingLog&>()))
+      .WillOnce([&](const SharingLog& log) {
+        EXPECT_EQ(log.event_type(), EventType::ADD_CONTACT);
+        logging.CountDown();
+        released.Await();
+      });
+  EXPECT_CALL(event_logger(), Log(An<const SharingLog&>()))
+      .WillOnce([](const SharingLog& log) {
+        EXPECT_EQ(log.event_type(), EventType::REMOVE_CONTACT);
+      });
+  EXPECT_CALL(event_logger(), Log(An<const SharingLog&>()))
+      .WillOnce([](const SharingLog& log) {
+        EXPECT_EQ(log.event_type(), EventType::TAP_HELP);
+      });
+
+  analytics_recoder().NewAddContact();
+  ASSERT_TRUE(logging.Await(absl::Seconds(1)).result());
+  // Recording does not wait for the busy logger.
+  analytics_recoder().NewRemoveContact();
+  analytics_recoder().NewTapHelp();
+  released.CountDown();
+  analytics_recoder().Sync();
+}
+
 TEST_F(AnalyticsRecorderTest, GenerateID) {
   int64_t id = analytics_recoder().GenerateNextId();
   EXPECT_GT(id, 0);
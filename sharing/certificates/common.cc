@@ -25,8 +25,10 @@
 
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "internal/crypto/keyed_hkdf.h"
 #include "internal/crypto_cros/encryptor.h"
 #include "internal/crypto_cros/hkdf.h"
+#include "internal/crypto_cros/hmac.h"
 #include "internal/crypto_cros/symmetric_key.h"
 #include "internal/platform/crypto.h"
 #include "sharing/certificates/constants.h"
@@ -61,10 +63,10 @@ bool IsNearbyShareCertificateWithinValidityPeriod(
 
 std::vector<uint8_t> DeriveNearbyShareKey(absl::Span<const uint8_t> key,
                                           size_t new_num_bytes) {
-  return crypto::HkdfSha256(key,
-                            /*salt=*/absl::Span<const uint8_t>(),
-                            /*info=*/absl::Span<const uint8_t>(),
-                            new_num_bytes);
+  static const crypto::KeyedHkdfSha256* unsalted_hkdf =
+      new crypto::KeyedHkdfSha256(/*salt=*/absl::Span<const uint8_t>());
+  return unsalted_hkdf->Derive(key, /*info=*/absl::Span<const uint8_t>(),
+                               new_num_bytes);
 }
 
 std::vector<uint8_t> ComputeAuthenticationTokenHash(
@@ -75,6 +77,35 @@ std::vector<uint8_t> ComputeAuthenticationTokenHash(
                             kNearbyShareNumBytesAuthenticationTokenHash);
 }
 
+std::vector<uint8_t> ComputeAuthenticationTokenHash(
+    absl::Span<const uint8_t> authentication_token,
+    const crypto::KeyedHkdfSha256& secret_key_hkdf) {
+  return secret_key_hkdf.Derive(authentication_token,
+                                /*info=*/absl::Span<const uint8_t>(),
+                                kNearbyShareNumBytesAuthenticationTokenHash);
+}
+
+std::shared_ptr<const crypto::KeyedHkdfSha256> CreateAuthenticationTokenHkdf(
+    const crypto::SymmetricKey* secret_key) {
+  if (!secret_key) return nullptr;
+  return std::make_shared<const crypto::KeyedHkdfSha256>(
+      as_bytes(absl::MakeSpan(secret_key->key())));
+}
+
+const crypto::HMAC& GetMetadataEncryptionKeyTagHmac() {
+  static const crypto::HMAC* hmac = [] {
+    auto* hmac = new crypto::HMAC(crypto::HMAC::HashAlgorithm::SHA256);
+    // This array of 0x00 is used to conform with the GmsCore implementation.
+    std::vector<uint8_t> key(kNearbyShareNumBytesMetadataEncryptionKeyTag,
+                             0x00);
+    if (!hmac->Init(key)) {
+      NL_LOG(ERROR) << "Failed to key the metadata encryption key tag HMAC.";
+    }
+    return hmac;
+  }();
+  return *hmac;
+}
+
 std::vector<uint8_t> GenerateRandomBytes(size_t num_bytes) {
   std::vector<uint8_t> bytes(num_bytes);
   RandBytes(absl::Span<uint8_t>(bytes));
@@ -23,7 +23,9 @@
 
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "internal/crypto/keyed_hkdf.h"
 #include "internal/crypto_cros/encryptor.h"
+#include "internal/crypto_cros/hmac.h"
 #include "internal/crypto_cros/symmetric_key.h"
 
 namespace nearby {
@@ -50,6 +52,22 @@ std::vector<uint8_t> ComputeAuthenticationTokenHash(
     absl::Span<const uint8_t> authentication_token,
     absl::Span<const uint8_t> secret_key);
 
+// Same as above, with the HKDF keyed with the |secret_key| as salt once, for
+// certificates hashing every authentication token with the same key.
+std::vector<uint8_t> ComputeAuthenticationTokenHash(
+    absl::Span<const uint8_t> authentication_token,
+    const crypto::KeyedHkdfSha256& secret_key_hkdf);
+
+// Creates the HKDF for ComputeAuthenticationTokenHash() with |secret_key|, or
+// returns null if there is no key.
+std::shared_ptr<const crypto::KeyedHkdfSha256> CreateAuthenticationTokenHkdf(
+    const crypto::SymmetricKey* secret_key);
+
+// Returns the HMAC, keyed once and shared by all certificates, that computes
+// the tag committing to a metadata encryption key. Its all-zero key conforms
+// with the GmsCore implementation.
+const crypto::HMAC& GetMetadataEncryptionKeyTagHmac();
+
 // Uses HKDF to generate a new key of length |new_num_bytes| from |key|. To
 // conform with the GmsCore implementation, trivial salt and info are used.
 std::vector<uint8_t> DeriveNearbyShareKey(absl::Span<const uint8_t> key,
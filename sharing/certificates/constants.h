@@ -107,6 +107,10 @@ constexpr char kNearbyShareReceiverVerificationPrefix = 0x02;
 // The maximum number of attempts to initialize LevelDB in Certificate Storage.
 constexpr size_t kNearbyShareCertificateStorageMaxNumInitializeAttempts = 3;
 
+// The maximum total serialized size of the public certificates Certificate
+// Storage keeps parsed in memory. Above it, every read goes to LevelDB.
+constexpr size_t kNearbyShareMaxPublicCertificateCacheSizeBytes = 1024 * 1024;
+
 // The frequency with which to download public certificates.
 constexpr absl::Duration kNearbySharePublicCertificateDownloadPeriod =
     absl::Hours(12);
@@ -106,6 +106,7 @@ void FakeNearbyShareCertificateStorage::GetPublicCertificate(
     std::function<
         void(bool, std::unique_ptr<nearby::sharing::proto::PublicCertificate>)>
         callback) {
+  get_public_certificate_id_ = std::string(id);
   get_public_certificate_callback_ = std::move(callback);
 }
 
@@ -130,6 +130,16 @@ class FakeNearbyShareCertificateStorage : public NearbyShareCertificateStorage {
     return get_public_certificates_callbacks_;
   }
 
+  const std::string& get_public_certificate_id() const {
+    return get_public_certificate_id_;
+  }
+
+  std::function<void(
+      bool, std::unique_ptr<nearby::sharing::proto::PublicCertificate>)>&
+  get_public_certificate_callback() {
+    return get_public_certificate_callback_;
+  }
+
   std::vector<AddPublicCertificatesCall>& add_public_certificates_calls() {
     return add_public_certificates_calls_;
   }
@@ -159,6 +169,7 @@ class FakeNearbyShareCertificateStorage : public NearbyShareCertificateStorage {
   std::optional<std::vector<NearbySharePrivateCertificate>>
       private_certificates_;
   std::vector<PublicCertificateCallback> get_public_certificates_callbacks_;
+  std::string get_public_certificate_id_;
   std::function<void(
       bool, std::unique_ptr<nearby::sharing::proto::PublicCertificate>)>
       get_public_certificate_callback_;
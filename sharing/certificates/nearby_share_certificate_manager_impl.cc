@@ -51,6 +51,7 @@
 #include "sharing/certificates/nearby_share_decrypted_public_certificate.h"
 #include "sharing/certificates/nearby_share_encrypted_metadata_key.h"
 #include "sharing/certificates/nearby_share_private_certificate.h"
+#include "sharing/certificates/nearby_share_public_certificate_index.h"
 #include "sharing/common/nearby_share_prefs.h"
 #include "sharing/contacts/nearby_share_contact_manager.h"
 #include "sharing/flags/generated/nearby_sharing_feature_flags.h"
@@ -76,6 +77,7 @@ namespace {
 
 using ::google::nearby::identity::v1::QuerySharedCredentialsRequest;
 using ::google::nearby::identity::v1::QuerySharedCredentialsResponse;
+using ::google::nearby::identity::v1::SharedCredential;
 using ::nearby::sharing::api::PreferenceManager;
 using ::nearby::sharing::api::PublicCertificateDatabase;
 using ::nearby::sharing::api::SharingPlatform;
@@ -142,6 +144,7 @@ std::optional<EncryptedMetadata> BuildMetadata(
 
 void TryDecryptPublicCertificates(
     const NearbyShareEncryptedMetadataKey& encrypted_metadata_key,
+    NearbySharePublicCertificateIndex& index,
     NearbyShareCertificateManager::CertDecryptedCallback callback, bool success,
     std::unique_ptr<std::vector<PublicCertificate>> public_certificates) {
   if (!success || !public_certificates) {
@@ -157,6 +160,7 @@ void TryDecryptPublicCertificates(
     if (decrypted) {
       VLOG(1) << "Successfully decrypted public certificate with ID "
               << nearby::utils::HexEncode(decrypted->id());
+      index.Add(encrypted_metadata_key, cert.secret_id());
       std::move(callback)(std::move(decrypted));
       return;
     }
@@ -165,6 +169,25 @@ void TryDecryptPublicCertificates(
   std::move(callback)(std::nullopt);
 }
 
+// Tries every public certificate in |storage| on |encrypted_metadata_key| and
+// records the one that decrypts it in |index|.
+void GetDecryptedPublicCertificateFromAll(
+    NearbyShareCertificateStorage& storage,
+    std::shared_ptr<NearbySharePublicCertificateIndex> index,
+    NearbyShareEncryptedMetadataKey encrypted_metadata_key,
+    NearbyShareCertificateManager::CertDecryptedCallback callback) {
+  storage.GetPublicCertificates(
+      [index = std::move(index),
+       encrypted_metadata_key = std::move(encrypted_metadata_key),
+       callback = std::move(callback)](
+          bool success,
+          std::unique_ptr<std::vector<PublicCertificate>> result) {
+        TryDecryptPublicCertificates(encrypted_metadata_key, *index,
+                                     std::move(callback), success,
+                                     std::move(result));
+      });
+}
+
 void DumpCertificateId(std::stringstream& sstream, absl::string_view cert_id,
                        bool is_public_cert) {
   if (is_public_cert) {
@@ -278,6 +301,7 @@ NearbyShareCertificateManagerImpl::NearbyShareCertificateManagerImpl(
                     << ": Download public certificates scheduler is called.";
                 DownloadPublicCertificates();
               })),
+      page_processor_(context->CreateConcurrentTaskRunner(1)),
       executor_(context->CreateSequencedTaskRunner()) {
   local_device_data_manager_->AddObserver(this);
   contact_manager_->AddObserver(this);
@@ -296,6 +320,9 @@ void NearbyShareCertificateManagerImpl::CertificateDownloadContext::
   if (next_page_token_.has_value()) {
     request.set_page_token(*next_page_token_);
   }
+  for (const std::string& secret_id : known_secret_ids_) {
+    request.add_secret_ids(secret_id);
+  }
   nearby_share_client_->ListPublicCertificates(
       request, [this](const absl::StatusOr<ListPublicCertificatesResponse>&
                           response) mutable {
@@ -340,35 +367,43 @@ void NearbyShareCertificateManagerImpl::CertificateDownloadContext::
               << __func__
               << ": [Call Identity API] Failed to download certificates: "
               << response.status();
+          WaitForProcessedPages();
           std::move(download_failure_callback_)();
           return;
         }
-        for (const auto& credential : response->shared_credentials()) {
-          if (credential.data_type() !=
-              google::nearby::identity::v1::SharedCredential::
-                  DATA_TYPE_PUBLIC_CERTIFICATE) {
-            LOG(WARNING) << __func__
-                         << ": [Call Identity API] skipping non "
-                            "DATA_TYPE_PUBLIC_CERTIFICATE, credential.id: "
-                         << credential.id();
-            continue;
+        // Parses the page while the next one downloads.
+        std::vector<SharedCredential> credentials(
+            response->shared_credentials().begin(),
+            response->shared_credentials().end());
+        page_processor_->PostTask([this,
+                                   credentials = std::move(credentials)]() {
+          for (const auto& credential : credentials) {
+            if (credential.data_type() !=
+                SharedCredential::DATA_TYPE_PUBLIC_CERTIFICATE) {
+              LOG(WARNING) << __func__
+                           << ": [Call Identity API] skipping non "
+                              "DATA_TYPE_PUBLIC_CERTIFICATE, credential.id: "
+                           << credential.id();
+              continue;
+            }
+            PublicCertificate certificate;
+            if (!certificate.ParseFromString(credential.data())) {
+              LOG(ERROR) << __func__
+                         << ": [Call Identity API] Failed parsing to "
+                            "PublicCertificate, credential.id: "
+                         << credential.id() << " data: "
+                         << absl::BytesToHexString(credential.data());
+              continue;
+            }
+            VLOG(1) << __func__
+                    << ": [Call Identity API] Successfully parsed credential: "
+                    << credential.id();
+            certificates_.push_back(std::move(certificate));
           }
-          PublicCertificate certificate;
-          if (!certificate.ParseFromString(credential.data())) {
-            LOG(ERROR) << __func__
-                       << ": [Call Identity API] Failed parsing to "
-                          "PublicCertificate, credential.id: "
-                       << credential.id() << " data: "
-                       << absl::BytesToHexString(credential.data());
-            continue;
-          }
-          VLOG(1) << __func__
-                  << ": [Call Identity API] Successfully parsed credential: "
-                  << credential.id();
-          certificates_.push_back(certificate);
-        }
+        });
 
         if (response->next_page_token().empty()) {
+          WaitForProcessedPages();
           LOG(INFO) << __func__
                     << ": [Call Identity API] Completed to download "
                     << certificates_.size() << " certificates";
@@ -380,18 +415,30 @@ void NearbyShareCertificateManagerImpl::CertificateDownloadContext::
       });
 }
 
-void NearbyShareCertificateManagerImpl::OnPublicCertificatesDownloadSuccess(
-    const std::vector<PublicCertificate>& certificates) {
-  // Save certificates to store.
+void NearbyShareCertificateManagerImpl::CertificateDownloadContext::
+    WaitForProcessedPages() {
   absl::Notification notification;
-  bool is_added_to_store = false;
-  certificate_storage_->AddPublicCertificates(
-      absl::MakeSpan(certificates.data(), certificates.size()),
-      [&](bool success) {
-        is_added_to_store = success;
-        notification.Notify();
-      });
+  if (!page_processor_->PostTask([&]() { notification.Notify(); })) {
+    return;
+  }
   notification.WaitForNotification();
+}
+
+void NearbyShareCertificateManagerImpl::OnPublicCertificatesDownloadSuccess(
+    const std::vector<PublicCertificate>& certificates) {
+  // Save certificates to store. These are only the ones missing from storage,
+  // so the stored certificates stay untouched.
+  bool is_added_to_store = true;
+  if (!certificates.empty()) {
+    absl::Notification notification;
+    certificate_storage_->AddPublicCertificates(
+        absl::MakeSpan(certificates.data(), certificates.size()),
+        [&](bool success) {
+          is_added_to_store = success;
+          notification.Notify();
+        });
+    notification.WaitForNotification();
+  }
   if (!is_added_to_store) {
     LOG(ERROR) << "Failed to add certificates to store.";
     OnPublicCertificatesDownloadFailure();
@@ -428,7 +475,9 @@ void NearbyShareCertificateManagerImpl::DownloadPublicCertificates() {
     // FetchNextPage() returns.
     auto context = std::make_unique<CertificateDownloadContext>(
         nearby_client_.get(), nearby_identity_client_.get(),
+        page_processor_.get(),
         kDeviceIdPrefix + local_device_data_manager_->GetId(),
+        certificate_storage_->GetPublicCertificateIds(),
         absl::bind_front(&NearbyShareCertificateManagerImpl::
                              OnPublicCertificatesDownloadFailure,
                          this),
@@ -529,19 +578,42 @@ NearbyShareCertificateManagerImpl::GetPrivateCertificatesAsPublicCertificates(
 void NearbyShareCertificateManagerImpl::GetDecryptedPublicCertificate(
     NearbyShareEncryptedMetadataKey encrypted_metadata_key,
     CertDecryptedCallback callback) {
-  certificate_storage_->GetPublicCertificates(
-      [encrypted_metadata_key = std::move(encrypted_metadata_key),
+  std::optional<std::string> secret_id =
+      public_certificate_index_->Find(encrypted_metadata_key);
+  if (!secret_id) {
+    GetDecryptedPublicCertificateFromAll(
+        *certificate_storage_, public_certificate_index_,
+        std::move(encrypted_metadata_key), std::move(callback));
+    return;
+  }
+
+  // The key was decrypted before; only the certificate that did it is loaded.
+  // If it is gone or was replaced, fall back to trying all of them.
+  certificate_storage_->GetPublicCertificate(
+      *secret_id,
+      [storage = certificate_storage_, index = public_certificate_index_,
+       encrypted_metadata_key = std::move(encrypted_metadata_key),
        callback = std::move(callback)](
-          bool success,
-          std::unique_ptr<std::vector<PublicCertificate>> result) {
-        TryDecryptPublicCertificates(encrypted_metadata_key,
-                                     std::move(callback), success,
-                                     std::move(result));
+          bool success, std::unique_ptr<PublicCertificate> result) mutable {
+        if (success && result) {
+          std::optional<NearbyShareDecryptedPublicCertificate> decrypted =
+              NearbyShareDecryptedPublicCertificate::DecryptPublicCertificate(
+                  *result, encrypted_metadata_key);
+          if (decrypted) {
+            std::move(callback)(std::move(decrypted));
+            return;
+          }
+        }
+        index->Remove(encrypted_metadata_key);
+        GetDecryptedPublicCertificateFromAll(
+            *storage, index, std::move(encrypted_metadata_key),
+            std::move(callback));
       });
 }
 
 void NearbyShareCertificateManagerImpl::ClearPublicCertificates(
     std::function<void(bool)> callback) {
+  public_certificate_index_->Clear();
   certificate_storage_->ClearPublicCertificates(std::move(callback));
 }
 
@@ -842,6 +914,7 @@ void NearbyShareCertificateManagerImpl::OnPublicCertificateExpiration() {
     if (!result) {
       LOG(ERROR) << "Failed to remove expired public certificates.";
     }
+    public_certificate_index_->Clear();
     public_certificate_expiration_scheduler_->HandleResult(result);
   });
 }
@@ -33,6 +33,7 @@
 #include "sharing/certificates/nearby_share_certificate_storage.h"
 #include "sharing/certificates/nearby_share_encrypted_metadata_key.h"
 #include "sharing/certificates/nearby_share_private_certificate.h"
+#include "sharing/certificates/nearby_share_public_certificate_index.h"
 #include "sharing/contacts/nearby_share_contact_manager.h"
 #include "sharing/internal/api/preference_manager.h"
 #include "sharing/internal/api/public_certificate_database.h"
@@ -100,7 +101,8 @@ class NearbyShareCertificateManagerImpl
     CertificateDownloadContext(
         nearby::sharing::api::SharingRpcClient* nearby_share_client,
         nearby::sharing::api::IdentityRpcClient* nearby_identity_client,
-        std::string device_id,
+        TaskRunner* page_processor, std::string device_id,
+        std::vector<std::string> known_secret_ids,
         absl::AnyInvocable<void() &&> download_failure_callback,
         absl::AnyInvocable<
             void(const std::vector<nearby::sharing::proto::PublicCertificate>&
@@ -108,12 +110,15 @@ class NearbyShareCertificateManagerImpl
             download_success_callback)
         : nearby_share_client_(nearby_share_client),
           nearby_identity_client_(nearby_identity_client),
+          page_processor_(page_processor),
           device_id_(std::move(device_id)),
+          known_secret_ids_(std::move(known_secret_ids)),
           download_failure_callback_(std::move(download_failure_callback)),
           download_success_callback_(std::move(download_success_callback)) {}
 
     // Fetches the next page of certificates.
-    // If |next_page_token_| is empty, it fetches the first page.
+    // If |next_page_token_| is empty, it fetches the first page. Only
+    // certificates missing from |known_secret_ids_| are downloaded.
     // On successful download, if  page token in the response is empty, the
     // |download_success_callback_| is invoked with all downloaded certificates.
     void FetchNextPage();
@@ -123,11 +128,20 @@ class NearbyShareCertificateManagerImpl
     void QuerySharedCredentialsFetchNextPage();
 
    private:
+    // Waits until the pages posted to |page_processor_| are processed.
+    void WaitForProcessedPages();
+
     nearby::sharing::api::SharingRpcClient* const nearby_share_client_;
     nearby::sharing::api::IdentityRpcClient* const nearby_identity_client_;
+    // Parses the credentials of a page while the next page downloads.
+    TaskRunner* const page_processor_;
     std::string device_id_;
+    // The secret IDs of the public certificates already in storage.
+    std::vector<std::string> known_secret_ids_;
     std::optional<std::string> next_page_token_;
     int page_number_ = 1;
+    // Only accessed on |page_processor_| until WaitForProcessedPages()
+    // returns.
     std::vector<nearby::sharing::proto::PublicCertificate> certificates_;
     absl::AnyInvocable<void() &&> download_failure_callback_;
     absl::AnyInvocable<
@@ -214,6 +228,9 @@ class NearbyShareCertificateManagerImpl
       nearby_identity_client_;
 
   std::shared_ptr<NearbyShareCertificateStorage> certificate_storage_;
+  // Shared with the storage callbacks, which may outlive the manager.
+  std::shared_ptr<NearbySharePublicCertificateIndex> public_certificate_index_ =
+      std::make_shared<NearbySharePublicCertificateIndex>();
   std::unique_ptr<NearbyShareScheduler>
       private_certificate_expiration_scheduler_;
   std::unique_ptr<NearbyShareScheduler>
@@ -222,6 +239,8 @@ class NearbyShareCertificateManagerImpl
       upload_local_device_certificates_scheduler_;
   std::unique_ptr<NearbyShareScheduler> download_public_certificates_scheduler_;
 
+  // Processes downloaded pages for the downloads running on |executor_|.
+  std::unique_ptr<TaskRunner> page_processor_;
   std::unique_ptr<TaskRunner> executor_;
   // Whether we need to regenerate the certificates and make another
   // PublishDevice call. At every PublishDevice call, we check
@@ -452,6 +452,11 @@ class NearbyShareCertificateManagerImplTest
     std::vector<proto::ListPublicCertificatesRequest> requests =
         client_factory_.instances().back()->list_public_certificates_requests();
     EXPECT_EQ(requests.size(), num_pages);
+    // Every page skips the certificates already in storage.
+    for (const proto::ListPublicCertificatesRequest& request : requests) {
+      EXPECT_THAT(request.secret_ids(),
+                  ::testing::ElementsAreArray(kPublicCertificateIds));
+    }
   }
 
   nearby::sharing::proto::ListPublicCertificatesResponse BuildRpcResponse(
@@ -728,6 +733,59 @@ TEST_F(NearbyShareCertificateManagerImplTest,
             GetNearbyShareTestMetadata().SerializeAsString());
 }
 
+TEST_F(NearbyShareCertificateManagerImplTest,
+       GetDecryptedPublicCertificateLoadsOnlyTheIndexedCertificate) {
+  std::optional<NearbyShareDecryptedPublicCertificate> decrypted_pub_cert;
+  cert_manager_->GetDecryptedPublicCertificate(
+      metadata_encryption_keys_[0],
+      [&](std::optional<NearbyShareDecryptedPublicCertificate> cert) {
+        CaptureDecryptedPublicCertificateCallback(&decrypted_pub_cert, cert);
+      });
+  GetPublicCertificatesCallback(true, public_certificates_);
+  ASSERT_TRUE(decrypted_pub_cert);
+
+  // The second advertisement with the same key only loads its certificate.
+  decrypted_pub_cert.reset();
+  cert_manager_->GetDecryptedPublicCertificate(
+      metadata_encryption_keys_[0],
+      [&](std::optional<NearbyShareDecryptedPublicCertificate> cert) {
+        CaptureDecryptedPublicCertificateCallback(&decrypted_pub_cert, cert);
+      });
+  EXPECT_TRUE(cert_store_->get_public_certificates_callbacks().empty());
+  EXPECT_EQ(cert_store_->get_public_certificate_id(),
+            public_certificates_[0].secret_id());
+  cert_store_->get_public_certificate_callback()(
+      true, std::make_unique<PublicCertificate>(public_certificates_[0]));
+
+  ASSERT_TRUE(decrypted_pub_cert);
+  std::vector<uint8_t> id(public_certificates_[0].secret_id().begin(),
+                          public_certificates_[0].secret_id().end());
+  EXPECT_EQ(decrypted_pub_cert->id(), id);
+}
+
+TEST_F(NearbyShareCertificateManagerImplTest,
+       GetDecryptedPublicCertificateFallsBackWhenIndexedCertificateIsGone) {
+  std::optional<NearbyShareDecryptedPublicCertificate> decrypted_pub_cert;
+  cert_manager_->GetDecryptedPublicCertificate(
+      metadata_encryption_keys_[0],
+      [&](std::optional<NearbyShareDecryptedPublicCertificate> cert) {
+        CaptureDecryptedPublicCertificateCallback(&decrypted_pub_cert, cert);
+      });
+  GetPublicCertificatesCallback(true, public_certificates_);
+  ASSERT_TRUE(decrypted_pub_cert);
+
+  decrypted_pub_cert.reset();
+  cert_manager_->GetDecryptedPublicCertificate(
+      metadata_encryption_keys_[0],
+      [&](std::optional<NearbyShareDecryptedPublicCertificate> cert) {
+        CaptureDecryptedPublicCertificateCallback(&decrypted_pub_cert, cert);
+      });
+  cert_store_->get_public_certificate_callback()(false, nullptr);
+  GetPublicCertificatesCallback(true, public_certificates_);
+
+  EXPECT_TRUE(decrypted_pub_cert);
+}
+
 TEST_F(NearbyShareCertificateManagerImplTest,
        GetDecryptedPublicCertificateCertNotFound) {
   auto private_cert = NearbySharePrivateCertificate(
@@ -774,6 +832,23 @@ TEST_F(NearbyShareCertificateManagerImplTest,
       /*num_pages=*/2, DownloadPublicCertificatesResult::kHttpError));
 }
 
+TEST_F(NearbyShareCertificateManagerImplTest,
+       DownloadPublicCertificatesNothingNewSkipsStorage) {
+  cert_store_->SetPublicCertificateIds(kPublicCertificateIds);
+  size_t initial_num_notifications = num_public_certs_downloaded_notifications_;
+  client_factory_.instances().back()->SetListPublicCertificatesResponses(
+      {proto::ListPublicCertificatesResponse()});
+  download_scheduler_->InvokeRequestCallback();
+  Sync();
+
+  CheckRpcRequest(/*num_pages=*/1);
+  EXPECT_TRUE(cert_store_->add_public_certificates_calls().empty());
+  ASSERT_FALSE(download_scheduler_->handled_results().empty());
+  EXPECT_TRUE(download_scheduler_->handled_results().back());
+  EXPECT_EQ(num_public_certs_downloaded_notifications_,
+            initial_num_notifications + 1);
+}
+
 TEST_F(NearbyShareCertificateManagerImplTest, QuerySharedCredentialsSuccess) {
   NearbyFlags::GetInstance().OverrideBoolFlagValue(
       config_package_nearby::nearby_sharing_feature::kCallNearbyIdentityApi,
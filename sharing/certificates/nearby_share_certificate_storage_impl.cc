@@ -26,9 +26,11 @@
 #include <vector>
 
 #include "absl/container/btree_map.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
@@ -49,6 +51,7 @@ namespace {
 using ::nearby::sharing::api::PreferenceManager;
 using ::nearby::sharing::api::PrivateCertificateData;
 using ::nearby::sharing::api::PublicCertificateDatabase;
+using ::nearby::sharing::proto::PublicCertificate;
 
 // Compare to leveldb_proto::Enums::InitStatus. Using a separate enum so that
 // the values don't change.
@@ -238,6 +241,7 @@ void NearbyShareCertificateStorageImpl::OnDatabaseDestroyedReinitialize(
   if (!success) {
     LOG(ERROR) << __func__
                << ": Failed to destroy public certificate database.";
+    ResetPublicCertificateCache(/*database_empty=*/false);
     FinishInitialization(false);
     callback(false);
     return;
@@ -245,6 +249,7 @@ void NearbyShareCertificateStorageImpl::OnDatabaseDestroyedReinitialize(
 
   public_certificate_expirations_.clear();
   SavePublicCertificateExpirations();
+  ResetPublicCertificateCache(/*database_empty=*/true);
 
   Initialize();
   callback(true);
@@ -255,25 +260,31 @@ void NearbyShareCertificateStorageImpl::OnDatabaseDestroyed(
   if (!success) {
     LOG(ERROR) << __func__
                << ": Failed to destroy public certificate database.";
+    ResetPublicCertificateCache(/*database_empty=*/false);
     std::move(callback)(false);
     return;
   }
 
   public_certificate_expirations_.clear();
   SavePublicCertificateExpirations();
+  ResetPublicCertificateCache(/*database_empty=*/true);
 
   std::move(callback)(true);
 }
 
 void NearbyShareCertificateStorageImpl::AddPublicCertificatesCallback(
-    std::unique_ptr<ExpirationList> new_expirations, ResultCallback callback,
-    bool proceed) {
+    std::unique_ptr<ExpirationList> new_expirations,
+    std::unique_ptr<std::vector<PublicCertificate>> public_certificates,
+    ResultCallback callback, bool proceed) {
   if (!proceed) {
     LOG(ERROR) << __func__ << ": Failed to add public certificates.";
+    // Some of the certificates may have been written.
+    ResetPublicCertificateCache(/*database_empty=*/false);
     std::move(callback)(false);
     return;
   }
   VLOG(1) << __func__ << ": Successfully added public certificates.";
+  AddToPublicCertificateCache(*public_certificates);
 
   public_certificate_expirations_ =
       MergeExpirations(public_certificate_expirations_, *new_expirations);
@@ -286,10 +297,12 @@ void NearbyShareCertificateStorageImpl::RemoveExpiredPublicCertificatesCallback(
     ResultCallback callback, bool proceed) {
   if (!proceed) {
     LOG(ERROR) << __func__ << ": Failed to remove expired public certificates.";
+    ResetPublicCertificateCache(/*database_empty=*/false);
     std::move(callback)(false);
     return;
   }
   VLOG(1) << __func__ << ": Expired public certificates successfully removed.";
+  RemoveFromPublicCertificateCache(ids_to_remove);
 
   auto should_remove =
       [&](const std::pair<std::string, absl::Time>& pair) -> bool {
@@ -327,8 +340,31 @@ void NearbyShareCertificateStorageImpl::GetPublicCertificates(
     return;
   }
 
+  std::unique_ptr<std::vector<PublicCertificate>> cached =
+      GetCachedPublicCertificates();
+  if (cached) {
+    std::move(callback)(true, std::move(cached));
+    return;
+  }
+
+  uint64_t generation;
+  {
+    absl::MutexLock lock(&cache_mutex_);
+    generation = public_certificate_cache_generation_;
+  }
   VLOG(1) << __func__ << ": Calling LoadEntries on database.";
-  public_certificate_database_->LoadEntries(std::move(callback));
+  public_certificate_database_->LoadEntries(
+      [weak_this = weak_from_this(), generation,
+       callback = std::move(callback)](
+          bool success,
+          std::unique_ptr<std::vector<PublicCertificate>> result) {
+        if (success && result) {
+          if (auto storage = weak_this.lock()) {
+            storage->FillPublicCertificateCache(generation, *result);
+          }
+        }
+        std::move(callback)(success, std::move(result));
+      });
 }
 
 void NearbyShareCertificateStorageImpl::GetPublicCertificate(
@@ -348,6 +384,17 @@ void NearbyShareCertificateStorageImpl::GetPublicCertificate(
         });
     return;
   }
+  {
+    absl::MutexLock lock(&cache_mutex_);
+    if (public_certificate_cache_.has_value()) {
+      auto it = public_certificate_cache_->find(id);
+      if (it != public_certificate_cache_->end()) {
+        std::move(callback)(true,
+                            std::make_unique<PublicCertificate>(it->second));
+        return;
+      }
+    }
+  }
   VLOG(1) << __func__ << ": Calling LoadCertificate on database, key: " << id;
   public_certificate_database_->LoadCertificate(id, std::move(callback));
 }
@@ -417,11 +464,16 @@ void NearbyShareCertificateStorageImpl::AddPublicCertificates(
           << ": Calling UpdateEntries on public certificate database with "
           << public_certificates.size() << " certificates.";
   public_certificate_database_->AddCertificates(
-      public_certificates, [weak_this = weak_from_this(), new_expirations,
-                            callback = std::move(callback)](bool success) {
+      public_certificates,
+      [weak_this = weak_from_this(), new_expirations,
+       certificates = std::vector<PublicCertificate>(
+           public_certificates.begin(), public_certificates.end()),
+       callback = std::move(callback)](bool success) mutable {
         if (auto storage = weak_this.lock()) {
           storage->AddPublicCertificatesCallback(
               std::make_unique<ExpirationList>(new_expirations),
+              std::make_unique<std::vector<PublicCertificate>>(
+                  std::move(certificates)),
               std::move(callback), success);
         }
       });
@@ -532,4 +584,84 @@ void NearbyShareCertificateStorageImpl::SavePublicCertificateExpirations() {
       prefs::kNearbySharingPublicCertificateExpirationDictName, expirations);
 }
 
+std::unique_ptr<std::vector<PublicCertificate>>
+NearbyShareCertificateStorageImpl::GetCachedPublicCertificates() const {
+  absl::MutexLock lock(&cache_mutex_);
+  if (!public_certificate_cache_.has_value()) return nullptr;
+  auto certificates = std::make_unique<std::vector<PublicCertificate>>();
+  certificates->reserve(public_certificate_cache_->size());
+  for (const auto& [id, certificate] : *public_certificate_cache_) {
+    certificates->push_back(certificate);
+  }
+  return certificates;
+}
+
+void NearbyShareCertificateStorageImpl::FillPublicCertificateCache(
+    uint64_t generation, const std::vector<PublicCertificate>& certificates) {
+  absl::MutexLock lock(&cache_mutex_);
+  if (generation != public_certificate_cache_generation_) return;
+
+  absl::flat_hash_map<std::string, PublicCertificate> cache;
+  size_t size_bytes = 0;
+  for (const PublicCertificate& certificate : certificates) {
+    size_bytes += certificate.ByteSizeLong();
+    if (size_bytes > kNearbyShareMaxPublicCertificateCacheSizeBytes) {
+      VLOG(1) << __func__ << ": Public certificates don't fit in memory.";
+      return;
+    }
+    cache.insert_or_assign(certificate.secret_id(), certificate);
+  }
+  public_certificate_cache_ = std::move(cache);
+  public_certificate_cache_size_bytes_ = size_bytes;
+}
+
+void NearbyShareCertificateStorageImpl::AddToPublicCertificateCache(
+    absl::Span<const PublicCertificate> certificates) {
+  absl::MutexLock lock(&cache_mutex_);
+  public_certificate_cache_generation_++;
+  if (!public_certificate_cache_.has_value()) return;
+
+  for (const PublicCertificate& certificate : certificates) {
+    auto [it, inserted] =
+        public_certificate_cache_->try_emplace(certificate.secret_id());
+    if (!inserted) {
+      public_certificate_cache_size_bytes_ -= it->second.ByteSizeLong();
+    }
+    it->second = certificate;
+    public_certificate_cache_size_bytes_ += certificate.ByteSizeLong();
+  }
+  if (public_certificate_cache_size_bytes_ >
+      kNearbyShareMaxPublicCertificateCacheSizeBytes) {
+    VLOG(1) << __func__ << ": Public certificates don't fit in memory.";
+    public_certificate_cache_.reset();
+    public_certificate_cache_size_bytes_ = 0;
+  }
+}
+
+void NearbyShareCertificateStorageImpl::RemoveFromPublicCertificateCache(
+    const absl::flat_hash_set<std::string>& ids) {
+  absl::MutexLock lock(&cache_mutex_);
+  public_certificate_cache_generation_++;
+  if (!public_certificate_cache_.has_value()) return;
+
+  for (const std::string& id : ids) {
+    auto it = public_certificate_cache_->find(id);
+    if (it == public_certificate_cache_->end()) continue;
+    public_certificate_cache_size_bytes_ -= it->second.ByteSizeLong();
+    public_certificate_cache_->erase(it);
+  }
+}
+
+void NearbyShareCertificateStorageImpl::ResetPublicCertificateCache(
+    bool database_empty) {
+  absl::MutexLock lock(&cache_mutex_);
+  public_certificate_cache_generation_++;
+  public_certificate_cache_size_bytes_ = 0;
+  if (database_empty) {
+    public_certificate_cache_.emplace();
+  } else {
+    public_certificate_cache_.reset();
+  }
+}
+
 }  // namespace nearby::sharing
@@ -16,6 +16,7 @@
 #define THIRD_PARTY_NEARBY_SHARING_CERTIFICATES_NEARBY_SHARE_CERTIFICATE_STORAGE_IMPL_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <functional>
 #include <memory>
@@ -25,7 +26,10 @@
 #include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "sharing/certificates/nearby_share_certificate_storage.h"
@@ -41,6 +45,12 @@ namespace nearby::sharing {
 // initialized by calling Initialize before retrieving or storing certificates.
 // Callbacks are guaranteed to not be invoked after
 // NearbyShareCertificateStorageImpl is destroyed.
+//
+// Once all public certificates have been loaded from LevelDB, they are kept
+// parsed in memory, as long as they fit in
+// kNearbyShareMaxPublicCertificateCacheSizeBytes, and public certificate reads
+// are answered from memory. Writes go to LevelDB first and are applied to the
+// in-memory copy when they succeed.
 class NearbyShareCertificateStorageImpl : public NearbyShareCertificateStorage,
       public std::enable_shared_from_this<NearbyShareCertificateStorageImpl> {
  public:
@@ -113,8 +123,10 @@ class NearbyShareCertificateStorageImpl : public NearbyShareCertificateStorage,
   void DestroyAndReinitialize();
 
   void AddPublicCertificatesCallback(
-      std::unique_ptr<ExpirationList> new_expirations, ResultCallback callback,
-      bool proceed);
+      std::unique_ptr<ExpirationList> new_expirations,
+      std::unique_ptr<std::vector<nearby::sharing::proto::PublicCertificate>>
+          public_certificates,
+      ResultCallback callback, bool proceed);
   void RemoveExpiredPublicCertificatesCallback(
       const absl::flat_hash_set<std::string>& ids_to_remove,
       ResultCallback callback, bool proceed);
@@ -122,6 +134,28 @@ class NearbyShareCertificateStorageImpl : public NearbyShareCertificateStorage,
   bool FetchPublicCertificateExpirations();
   void SavePublicCertificateExpirations();
 
+  // Returns a copy of all public certificates if they are cached, or nullptr.
+  std::unique_ptr<std::vector<nearby::sharing::proto::PublicCertificate>>
+  GetCachedPublicCertificates() const ABSL_LOCKS_EXCLUDED(cache_mutex_);
+  // Caches |certificates| loaded from the database, unless the database
+  // changed since |generation| or they don't fit in memory.
+  void FillPublicCertificateCache(
+      uint64_t generation,
+      const std::vector<nearby::sharing::proto::PublicCertificate>&
+          certificates) ABSL_LOCKS_EXCLUDED(cache_mutex_);
+  // Applies certificates successfully added to the database.
+  void AddToPublicCertificateCache(
+      absl::Span<const nearby::sharing::proto::PublicCertificate> certificates)
+      ABSL_LOCKS_EXCLUDED(cache_mutex_);
+  // Applies certificates successfully removed from the database.
+  void RemoveFromPublicCertificateCache(
+      const absl::flat_hash_set<std::string>& ids)
+      ABSL_LOCKS_EXCLUDED(cache_mutex_);
+  // Drops the cache. If |database_empty| the database is known to hold no
+  // certificates, which is cached instead.
+  void ResetPublicCertificateCache(bool database_empty)
+      ABSL_LOCKS_EXCLUDED(cache_mutex_);
+
   nearby::sharing::api::PreferenceManager& preference_manager_;
   InitStatus init_status_ = InitStatus::kUninitialized;
   size_t num_initialize_attempts_ = 0;
@@ -129,6 +163,18 @@ class NearbyShareCertificateStorageImpl : public NearbyShareCertificateStorage,
       public_certificate_database_;
   ExpirationList public_certificate_expirations_;
 
+  // Database callbacks can run on an executor thread.
+  mutable absl::Mutex cache_mutex_;
+  // All public certificates in the database keyed by secret ID, if known.
+  std::optional<absl::flat_hash_map<std::string,
+                                    nearby::sharing::proto::PublicCertificate>>
+      public_certificate_cache_ ABSL_GUARDED_BY(cache_mutex_);
+  size_t public_certificate_cache_size_bytes_ ABSL_GUARDED_BY(cache_mutex_) = 0;
+  // Incremented whenever the database changes, so that a load started before
+  // doesn't overwrite the cache with stale certificates.
+  uint64_t public_certificate_cache_generation_ ABSL_GUARDED_BY(cache_mutex_) =
+      0;
+
   std::queue<std::function<void()>> deferred_callbacks_;
 };
 
@@ -453,6 +453,82 @@ TEST_F(NearbyShareCertificateStorageImplTest, GetPublicCertificate) {
   EXPECT_THAT(cert_store.use_count(), Eq(1));
 }
 
+TEST_F(NearbyShareCertificateStorageImplTest,
+       GetPublicCertificatesFromMemoryAfterFirstLoad) {
+  auto db = std::make_unique<nearby::FakePublicCertificateDb>(
+      PrepopulatePublicCertificates());
+  nearby::FakePublicCertificateDb* fake_db = db.get();
+
+  auto cert_store = NearbyShareCertificateStorageImpl::Factory::Create(
+      preference_manager_, std::move(db));
+  fake_db->InvokeInitStatusCallback(FakePublicCertificateDb::InitStatus::kOk);
+
+  std::vector<PublicCertificate> public_certificates;
+  int num_callbacks = 0;
+  auto get_public_certificates = [&]() {
+    cert_store->GetPublicCertificates(
+        [this, &public_certificates, complete = [&num_callbacks] {
+          ++num_callbacks;
+        }](bool success,
+           std::unique_ptr<std::vector<PublicCertificate>> result) {
+          PublicCertificateCallback(&public_certificates, std::move(complete),
+                                    success, std::move(result));
+        });
+  };
+  get_public_certificates();
+  fake_db->InvokeLoadCallback(true);
+  ASSERT_EQ(num_callbacks, 1);
+
+  // Later reads don't go to the database.
+  get_public_certificates();
+  ASSERT_EQ(num_callbacks, 2);
+  EXPECT_EQ(public_certificates.size(), 3u);
+  std::unique_ptr<PublicCertificate> public_certificate;
+  cert_store->GetPublicCertificate(
+      kSecretId3, [&public_certificate](
+                      bool success, std::unique_ptr<PublicCertificate> result) {
+        public_certificate = std::move(result);
+      });
+  ASSERT_TRUE(public_certificate);
+  EXPECT_EQ(public_certificate->secret_key(), kSecretKey3);
+
+  // Writes are applied to the certificates in memory.
+  bool succeeded = false;
+  cert_store->AddPublicCertificates(
+      {CreatePublicCertificate(
+          kSecretId4, kSecretKey4, kPublicKey4, kStartSeconds4, kStartNanos4,
+          kEndSeconds4, kEndNanos4, kForSelectedContacts4,
+          kMetadataEncryptionKey4, kEncryptedMetadataBytes4,
+          kMetadataEncryptionKeyTag4)},
+      [this, &succeeded](bool success) {
+        CaptureBoolCallback(&succeeded, success);
+      });
+  fake_db->InvokeAddCallback(true);
+  ASSERT_TRUE(succeeded);
+  get_public_certificates();
+  ASSERT_EQ(num_callbacks, 3);
+  EXPECT_EQ(public_certificates.size(), 4u);
+
+  // Certificates 1 and 4 expire first.
+  succeeded = false;
+  cert_store->RemoveExpiredPublicCertificates(
+      absl::FromUnixSeconds(kEndSeconds1 + 1) +
+          kNearbySharePublicCertificateValidityBoundOffsetTolerance,
+      [this, &succeeded](bool success) {
+        CaptureBoolCallback(&succeeded, success);
+      });
+  fake_db->InvokeRemoveCallback(true);
+  ASSERT_TRUE(succeeded);
+  get_public_certificates();
+  ASSERT_EQ(num_callbacks, 4);
+  ASSERT_EQ(public_certificates.size(), 2u);
+  ASSERT_EQ(public_certificates.size(), fake_db->GetCertificatesMap().size());
+  for (const PublicCertificate& cert : public_certificates) {
+    EXPECT_EQ(fake_db->GetCertificatesMap().count(cert.secret_id()), 1u);
+  }
+  EXPECT_THAT(cert_store.use_count(), Eq(1));
+}
+
 TEST_F(NearbyShareCertificateStorageImplTest, AddPublicCertificates) {
   auto db = std::make_unique<nearby::FakePublicCertificateDb>(
       PrepopulatePublicCertificates());
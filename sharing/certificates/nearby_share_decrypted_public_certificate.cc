@@ -110,13 +110,8 @@ std::optional<std::vector<uint8_t>> DecryptMetadataPayload(
 bool VerifyMetadataEncryptionKeyTag(
     absl::Span<const uint8_t> decrypted_metadata_key,
     absl::Span<const uint8_t> metadata_encryption_key_tag) {
-  // This array of 0x00 is used to conform with the GmsCore implementation.
-  std::vector<uint8_t> key(kNearbyShareNumBytesMetadataEncryptionKeyTag, 0x00);
-
-  std::vector<uint8_t> result(kNearbyShareNumBytesMetadataEncryptionKeyTag);
-  crypto::HMAC hmac(crypto::HMAC::HashAlgorithm::SHA256);
-  return hmac.Init(key) &&
-         hmac.Verify(decrypted_metadata_key, metadata_encryption_key_tag);
+  return GetMetadataEncryptionKeyTagHmac().Verify(decrypted_metadata_key,
+                                                  metadata_encryption_key_tag);
 }
 
 }  // namespace
@@ -200,6 +195,8 @@ NearbyShareDecryptedPublicCertificate::NearbyShareDecryptedPublicCertificate(
     : not_before_(not_before),
       not_after_(not_after),
       secret_key_(std::move(secret_key)),
+      authentication_token_hkdf_(
+          CreateAuthenticationTokenHkdf(secret_key_.get())),
       public_key_(std::move(public_key)),
       id_(std::move(id)),
       unencrypted_metadata_(std::move(unencrypted_metadata)),
@@ -219,6 +216,7 @@ NearbyShareDecryptedPublicCertificate::operator=(
   not_after_ = other.not_after_;
   secret_key_ = crypto::SymmetricKey::Import(
       crypto::SymmetricKey::Algorithm::AES, other.secret_key_->key());
+  authentication_token_hkdf_ = other.authentication_token_hkdf_;
   public_key_ = other.public_key_;
   id_ = other.id_;
   unencrypted_metadata_ = other.unencrypted_metadata_;
@@ -253,8 +251,8 @@ bool NearbyShareDecryptedPublicCertificate::VerifySignature(
 std::vector<uint8_t>
 NearbyShareDecryptedPublicCertificate::HashAuthenticationToken(
     absl::Span<const uint8_t> authentication_token) const {
-  return ComputeAuthenticationTokenHash(
-      authentication_token, as_bytes(absl::MakeSpan(secret_key_->key())));
+  return ComputeAuthenticationTokenHash(authentication_token,
+                                        *authentication_token_hkdf_);
 }
 
 }  // namespace sharing
@@ -23,6 +23,7 @@
 
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "internal/crypto/keyed_hkdf.h"
 #include "internal/crypto_cros/symmetric_key.h"
 #include "sharing/certificates/nearby_share_encrypted_metadata_key.h"
 #include "sharing/proto/encrypted_metadata.pb.h"
@@ -97,6 +98,10 @@ class NearbyShareDecryptedPublicCertificate {
   // Also, used to generate an authentication token hash.
   std::unique_ptr<crypto::SymmetricKey> secret_key_;
 
+  // Hashes authentication tokens with |secret_key_|. Immutable, so copies of
+  // the certificate share it.
+  std::shared_ptr<const crypto::KeyedHkdfSha256> authentication_token_hkdf_;
+
   // A P-256 public key used for verification. The bytes comprise a DER-encoded
   // ASN.1 SubjectPublicKeyInfo from the X.509 specification (RFC 5280).
   std::vector<uint8_t> public_key_;
@@ -79,14 +79,10 @@ std::vector<uint8_t> CreateCertificateIdFromSecretKey(
 // in certificates.
 std::optional<std::vector<uint8_t>> CreateMetadataEncryptionKeyTag(
     absl::Span<const uint8_t> metadata_encryption_key) {
-  // This array of 0x00 is used to conform with the GmsCore implementation.
-  std::vector<uint8_t> key(kNearbyShareNumBytesMetadataEncryptionKeyTag, 0x00);
-
   std::vector<uint8_t> result(kNearbyShareNumBytesMetadataEncryptionKeyTag);
-  crypto::HMAC hmac(crypto::HMAC::HashAlgorithm::SHA256);
-  if (!hmac.Init(key) ||
-      !hmac.Sign(metadata_encryption_key,
-                 absl::MakeSpan(result.data(), result.size())))
+  if (!GetMetadataEncryptionKeyTagHmac().Sign(
+          metadata_encryption_key,
+          absl::MakeSpan(result.data(), result.size())))
     return std::nullopt;
 
   return result;
@@ -155,6 +151,8 @@ NearbySharePrivateCertificate::NearbySharePrivateCertificate(
       secret_key_(crypto::SymmetricKey::GenerateRandomKey(
           crypto::SymmetricKey::Algorithm::AES,
           /*key_size_in_bits=*/8 * kNearbyShareNumBytesSecretKey)),
+      authentication_token_hkdf_(
+          CreateAuthenticationTokenHkdf(secret_key_.get())),
       metadata_encryption_key_(
           GenerateRandomBytes(kNearbyShareNumBytesMetadataEncryptionKey)),
       id_(CreateCertificateIdFromSecretKey(*secret_key_)),
@@ -176,6 +174,8 @@ NearbySharePrivateCertificate::NearbySharePrivateCertificate(
       not_after_(not_after),
       key_pair_(std::move(key_pair)),
       secret_key_(std::move(secret_key)),
+      authentication_token_hkdf_(
+          CreateAuthenticationTokenHkdf(secret_key_.get())),
       metadata_encryption_key_(std::move(metadata_encryption_key)),
       id_(std::move(id)),
       unencrypted_metadata_(std::move(unencrypted_metadata)),
@@ -200,6 +200,7 @@ NearbySharePrivateCertificate& NearbySharePrivateCertificate::operator=(
   key_pair_ = other.key_pair_->Copy();
   secret_key_ = crypto::SymmetricKey::Import(
       crypto::SymmetricKey::Algorithm::AES, other.secret_key_->key());
+  authentication_token_hkdf_ = other.authentication_token_hkdf_;
   metadata_encryption_key_ = other.metadata_encryption_key_;
   id_ = other.id_;
   unencrypted_metadata_ = other.unencrypted_metadata_;
@@ -259,8 +260,8 @@ std::optional<std::vector<uint8_t>> NearbySharePrivateCertificate::Sign(
 
 std::vector<uint8_t> NearbySharePrivateCertificate::HashAuthenticationToken(
     absl::Span<const uint8_t> authentication_token) const {
-  return ComputeAuthenticationTokenHash(
-      authentication_token, as_bytes(absl::MakeSpan(secret_key_->key())));
+  return ComputeAuthenticationTokenHash(authentication_token,
+                                        *authentication_token_hkdf_);
 }
 
 std::optional<nearby::sharing::proto::PublicCertificate>
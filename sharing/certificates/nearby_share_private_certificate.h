@@ -25,6 +25,7 @@
 
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "internal/crypto/keyed_hkdf.h"
 #include "internal/crypto_cros/ec_private_key.h"
 #include "internal/crypto_cros/symmetric_key.h"
 #include "sharing/certificates/nearby_share_encrypted_metadata_key.h"
@@ -162,6 +163,10 @@ class NearbySharePrivateCertificate {
   // certificate.
   std::unique_ptr<crypto::SymmetricKey> secret_key_;
 
+  // Hashes authentication tokens with |secret_key_|. Immutable, so copies of
+  // the certificate share it.
+  std::shared_ptr<const crypto::KeyedHkdfSha256> authentication_token_hkdf_;
+
   // A 14-byte symmetric key used to encrypt |unencrypted_metadata_|. Not
   // included in the public certificate.
   std::vector<uint8_t> metadata_encryption_key_;
@@ -0,0 +1,77 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sharing/certificates/nearby_share_public_certificate_index.h"
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "sharing/certificates/nearby_share_encrypted_metadata_key.h"
+
+namespace nearby {
+namespace sharing {
+
+std::optional<std::string> NearbySharePublicCertificateIndex::Find(
+    const NearbyShareEncryptedMetadataKey& encrypted_metadata_key) const {
+  absl::MutexLock lock(&mutex_);
+  auto it = secret_ids_.find(MakeKey(encrypted_metadata_key));
+  if (it == secret_ids_.end()) return std::nullopt;
+  return it->second;
+}
+
+void NearbySharePublicCertificateIndex::Add(
+    const NearbyShareEncryptedMetadataKey& encrypted_metadata_key,
+    absl::string_view secret_id) {
+  absl::MutexLock lock(&mutex_);
+  // Advertisements rotate their metadata keys, so old entries are not worth
+  // evicting one by one.
+  if (secret_ids_.size() >= kMaxSize) {
+    secret_ids_.clear();
+  }
+  secret_ids_.insert_or_assign(MakeKey(encrypted_metadata_key),
+                               std::string(secret_id));
+}
+
+void NearbySharePublicCertificateIndex::Remove(
+    const NearbyShareEncryptedMetadataKey& encrypted_metadata_key) {
+  absl::MutexLock lock(&mutex_);
+  secret_ids_.erase(MakeKey(encrypted_metadata_key));
+}
+
+void NearbySharePublicCertificateIndex::Clear() {
+  absl::MutexLock lock(&mutex_);
+  secret_ids_.clear();
+}
+
+size_t NearbySharePublicCertificateIndex::size() const {
+  absl::MutexLock lock(&mutex_);
+  return secret_ids_.size();
+}
+
+// static
+std::string NearbySharePublicCertificateIndex::MakeKey(
+    const NearbyShareEncryptedMetadataKey& encrypted_metadata_key) {
+  std::string key(encrypted_metadata_key.salt().begin(),
+                  encrypted_metadata_key.salt().end());
+  key.append(encrypted_metadata_key.encrypted_key().begin(),
+             encrypted_metadata_key.encrypted_key().end());
+  return key;
+}
+
+}  // namespace sharing
+}  // namespace nearby
@@ -0,0 +1,84 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef NEARBY_SHARING_CERTIFICATES_NEARBY_SHARE_PUBLIC_CERTIFICATE_INDEX_H_
+#define NEARBY_SHARING_CERTIFICATES_NEARBY_SHARE_PUBLIC_CERTIFICATE_INDEX_H_
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "sharing/certificates/nearby_share_encrypted_metadata_key.h"
+
+namespace nearby {
+namespace sharing {
+
+// Maps the encrypted metadata keys of incoming advertisements to the secret ID
+// of the public certificate that decrypted them, so that identifying a device
+// that was seen before is a single certificate lookup and decryption instead
+// of trying every certificate in storage.
+//
+// The metadata key can only be decrypted with the certificate's secret key, so
+// the index is learned from successful decryptions. A hit is only a hint: a
+// certificate that was removed or replaced in storage fails to decrypt the key
+// and the caller falls back to trying all certificates.
+class NearbySharePublicCertificateIndex {
+ public:
+  // The number of metadata keys kept before the index starts over.
+  static constexpr size_t kMaxSize = 1024;
+
+  NearbySharePublicCertificateIndex() = default;
+  NearbySharePublicCertificateIndex(const NearbySharePublicCertificateIndex&) =
+      delete;
+  NearbySharePublicCertificateIndex& operator=(
+      const NearbySharePublicCertificateIndex&) = delete;
+
+  // Returns the secret ID of the certificate that last decrypted
+  // |encrypted_metadata_key|, if any.
+  std::optional<std::string> Find(
+      const NearbyShareEncryptedMetadataKey& encrypted_metadata_key) const
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Records that the certificate with |secret_id| decrypted
+  // |encrypted_metadata_key|.
+  void Add(const NearbyShareEncryptedMetadataKey& encrypted_metadata_key,
+           absl::string_view secret_id) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Forgets |encrypted_metadata_key|.
+  void Remove(const NearbyShareEncryptedMetadataKey& encrypted_metadata_key)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Forgets all metadata keys.
+  void Clear() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  size_t size() const ABSL_LOCKS_EXCLUDED(mutex_);
+
+ private:
+  static std::string MakeKey(
+      const NearbyShareEncryptedMetadataKey& encrypted_metadata_key);
+
+  mutable absl::Mutex mutex_;
+  // Salt followed by the encrypted key, to certificate secret ID.
+  absl::flat_hash_map<std::string, std::string> secret_ids_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace sharing
+}  // namespace nearby
+
+#endif  // NEARBY_SHARING_CERTIFICATES_NEARBY_SHARE_PUBLIC_CERTIFICATE_INDEX_H_
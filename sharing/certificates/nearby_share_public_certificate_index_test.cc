@@ -0,0 +1,79 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sharing/certificates/nearby_share_public_certificate_index.h"
+
+#include <stdint.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "sharing/certificates/nearby_share_encrypted_metadata_key.h"
+
+namespace nearby {
+namespace sharing {
+namespace {
+
+NearbyShareEncryptedMetadataKey MakeKey(uint8_t salt, uint8_t key) {
+  return NearbyShareEncryptedMetadataKey(std::vector<uint8_t>(2, salt),
+                                         std::vector<uint8_t>(14, key));
+}
+
+TEST(NearbySharePublicCertificateIndexTest, FindsAddedKeys) {
+  NearbySharePublicCertificateIndex index;
+  index.Add(MakeKey(1, 1), "secret_id_1");
+  index.Add(MakeKey(1, 2), "secret_id_2");
+
+  EXPECT_EQ(index.Find(MakeKey(1, 1)),
+            std::optional<std::string>("secret_id_1"));
+  EXPECT_EQ(index.Find(MakeKey(1, 2)),
+            std::optional<std::string>("secret_id_2"));
+  // Same encrypted key, different salt.
+  EXPECT_EQ(index.Find(MakeKey(2, 1)), std::nullopt);
+}
+
+TEST(NearbySharePublicCertificateIndexTest, RemoveAndClear) {
+  NearbySharePublicCertificateIndex index;
+  index.Add(MakeKey(1, 1), "secret_id_1");
+  index.Add(MakeKey(1, 2), "secret_id_2");
+
+  index.Remove(MakeKey(1, 1));
+  EXPECT_EQ(index.Find(MakeKey(1, 1)), std::nullopt);
+  EXPECT_EQ(index.size(), 1);
+
+  index.Clear();
+  EXPECT_EQ(index.Find(MakeKey(1, 2)), std::nullopt);
+  EXPECT_EQ(index.size(), 0);
+}
+
+TEST(NearbySharePublicCertificateIndexTest, StartsOverWhenFull) {
+  NearbySharePublicCertificateIndex index;
+  for (size_t i = 0; i < NearbySharePublicCertificateIndex::kMaxSize; ++i) {
+    index.Add(MakeKey(i & 0xff, i >> 8), "secret_id");
+  }
+  EXPECT_EQ(index.size(), NearbySharePublicCertificateIndex::kMaxSize);
+
+  index.Add(MakeKey(0xff, 0xff), "secret_id");
+
+  EXPECT_EQ(index.size(), 1);
+  EXPECT_EQ(index.Find(MakeKey(0xff, 0xff)),
+            std::optional<std::string>("secret_id"));
+}
+
+}  // namespace
+}  // namespace sharing
+}  // namespace nearby
@@ -54,6 +54,15 @@ constexpr absl::Duration kInvalidateDelay = absl::Milliseconds(500);
 // value is 1MB to match the default setting on Android.
 constexpr int64_t kAttachmentsSizeThresholdOverHighQualityMedium = 1000000;
 
+// The most file payloads of an outgoing share handed to Nearby Connections at
+// once. Keeping several queued avoids waiting for the completion of every
+// file before the next one starts, which dominates shares of many small files.
+constexpr size_t kMaxInFlightFilePayloads = 4;
+
+// If true, small files are offered to be sent in file bundles, and incoming
+// file bundles are accepted when the session knows where to save them.
+constexpr bool kSupportFileBundles = true;
+
 // If true, the user will be able to accept incoming Wi-Fi Credential
 // attachments and join the network when the attachment is opened.
 constexpr bool kSupportReceivingWifiCredentials = true;
@@ -64,6 +73,11 @@ constexpr double kTransferSpeedUpdateInterval = 1.0;
 // Time between successive transfer completion ETA in seconds.
 constexpr double kEstimatedTimeRemainingUpdateInterval = 3.0;
 
+// Minimum time between successive in-progress transfer updates of a share.
+// Updates completing a payload are always reported.
+constexpr absl::Duration kMinTransferProgressUpdateInterval =
+    absl::Milliseconds(100);
+
 }  // namespace sharing
 }  // namespace nearby
 
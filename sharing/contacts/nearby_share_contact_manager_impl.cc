@@ -17,6 +17,7 @@
 #include <stdint.h>
 
 #include <algorithm>
+#include <iterator>
 #include <memory>
 #include <optional>
 #include <set>
@@ -174,6 +175,7 @@ NearbyShareContactManagerImpl::NearbyShareContactManagerImpl(
               /*require_connectivity=*/true,
               prefs::kNearbySharingSchedulerContactDownloadAndUploadName,
               [&] { DownloadContacts(); })),
+      page_processor_(context->CreateConcurrentTaskRunner(1)),
       executor_(context->CreateSequencedTaskRunner()),
       use_identity_api_(NearbyFlags::GetInstance().GetBoolFlag(
           config_package_nearby::nearby_sharing_feature::
@@ -207,23 +209,32 @@ void NearbyShareContactManagerImpl::ContactDownloadContext::FetchNextPage() {
           const absl::StatusOr<ListContactPeopleResponse>& response) mutable {
         if (!response.ok()) {
           LOG(WARNING) << "Failed to download contacts: " << response.status();
+          WaitForProcessedPages();
           std::move(download_callback_)(
               response.status(), /*num_unreachable_contacts_filtered_out=*/0);
           return;
         }
 
-        contacts_.insert(contacts_.end(), response->contact_records().begin(),
-                         response->contact_records().end());
+        // Filters the page while the next one downloads. We only care about
+        // contacts that we can share with.
+        std::vector<ContactRecord> contacts(
+            response->contact_records().begin(),
+            response->contact_records().end());
+        page_processor_->PostTask(
+            [this, contacts = std::move(contacts)]() mutable {
+              uint32_t contacts_size = contacts.size();
+              FilterOutUnreachableContacts(contacts);
+              num_unreachable_contacts_filtered_out_ +=
+                  contacts_size - contacts.size();
+              contacts_.insert(contacts_.end(),
+                               std::make_move_iterator(contacts.begin()),
+                               std::make_move_iterator(contacts.end()));
+            });
 
         if (response->next_page_token().empty()) {
-          // We should filter here because we only care about contacts that we
-          // can share with.
-          uint32_t contacts_size = contacts_.size();
-          FilterOutUnreachableContacts(contacts_);
-          uint32_t num_unreachable_contacts_filtered_out =
-              contacts_size - contacts_.size();
+          WaitForProcessedPages();
           std::move(download_callback_)(std::move(contacts_),
-                                        num_unreachable_contacts_filtered_out);
+                                        num_unreachable_contacts_filtered_out_);
           return;
         }
         // Continue with next page.
@@ -232,6 +243,15 @@ void NearbyShareContactManagerImpl::ContactDownloadContext::FetchNextPage() {
       });
 }
 
+void NearbyShareContactManagerImpl::ContactDownloadContext::
+    WaitForProcessedPages() {
+  absl::Notification notification;
+  if (!page_processor_->PostTask([&]() { notification.Notify(); })) {
+    return;
+  }
+  notification.WaitForNotification();
+}
+
 void NearbyShareContactManagerImpl::DownloadContacts() {
   if (use_identity_api_) {
     LOG(INFO) << __func__ << ": [Call Identity API] Skipping DownloadContacts";
@@ -253,7 +273,7 @@ void NearbyShareContactManagerImpl::DownloadContacts() {
     // Currently Contacts download is synchronous.  It completes after
     // FetchNextPage() returns.
     auto context = std::make_unique<ContactDownloadContext>(
-        nearby_share_client_.get(),
+        nearby_share_client_.get(), page_processor_.get(),
         absl::bind_front(
             &NearbyShareContactManagerImpl::OnContactsDownloadCompleted, this));
     context->FetchNextPage();
@@ -279,7 +299,8 @@ void NearbyShareContactManagerImpl::GetContacts(ContactsCallback callback) {
     // Currently Contacts download is synchronous.  It completes after
     // FetchNextPage() returns.
     auto context = std::make_unique<ContactDownloadContext>(
-        nearby_share_client_.get(), std::move(callback));
+        nearby_share_client_.get(), page_processor_.get(),
+        std::move(callback));
     context->FetchNextPage();
   });
 }
@@ -399,9 +420,11 @@ void NearbyShareContactManagerImpl::OnContactsUploadFinished(
 void NearbyShareContactManagerImpl::NotifyAllObserversContactsDownloaded(
     const std::vector<ContactRecord>& contacts,
     uint32_t num_unreachable_contacts_filtered_out) {
-  // Sort the contacts before sending the list to observers.
+  // Sort the contacts before sending the list to observers. The contact list
+  // rarely changes between downloads, so reuse the order of the last one.
   std::vector<ContactRecord> sorted_contacts = contacts;
-  SortNearbyShareContactRecords(&sorted_contacts);
+  SortNearbyShareContactRecords(last_sorted_contacts_, &sorted_contacts);
+  last_sorted_contacts_ = sorted_contacts;
 
   // First, notify NearbyShareContactManager::Observers.
   // Note: These are direct observers of the NearbyShareContactManager base
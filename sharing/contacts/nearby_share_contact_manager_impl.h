@@ -91,8 +91,9 @@ class NearbyShareContactManagerImpl : public NearbyShareContactManager {
    public:
     ContactDownloadContext(
         nearby::sharing::api::SharingRpcClient* nearby_share_client,
-        ContactsCallback download_callback)
+        TaskRunner* page_processor, ContactsCallback download_callback)
         : nearby_share_client_(nearby_share_client),
+          page_processor_(page_processor),
           download_callback_(std::move(download_callback)) {}
 
     // Fetches the next page of contacts.
@@ -102,10 +103,18 @@ class NearbyShareContactManagerImpl : public NearbyShareContactManager {
     void FetchNextPage();
 
    private:
+    // Waits until the pages posted to |page_processor_| are processed.
+    void WaitForProcessedPages();
+
     nearby::sharing::api::SharingRpcClient* const nearby_share_client_;
+    // Filters the contacts of a page while the next page downloads.
+    TaskRunner* const page_processor_;
     std::optional<std::string> next_page_token_;
     int page_number_ = 1;
+    // Only accessed on |page_processor_| until WaitForProcessedPages()
+    // returns.
     std::vector<nearby::sharing::proto::ContactRecord> contacts_;
+    uint32_t num_unreachable_contacts_filtered_out_ = 0;
     ContactsCallback download_callback_;
   };
 
@@ -148,6 +157,12 @@ class NearbyShareContactManagerImpl : public NearbyShareContactManager {
   NearbyShareLocalDeviceDataManager* local_device_data_manager_ = nullptr;
   std::unique_ptr<NearbyShareScheduler> contact_download_and_upload_scheduler_;
 
+  // The contacts of the last download, in sorted order. Only accessed on
+  // |executor_|.
+  std::vector<nearby::sharing::proto::ContactRecord> last_sorted_contacts_;
+
+  // Processes downloaded pages for the downloads running on |executor_|.
+  std::unique_ptr<TaskRunner> page_processor_ = nullptr;
   std::unique_ptr<TaskRunner> executor_ = nullptr;
   // Identity API does not support contacts upload/download. So essentially
   // contact manager is inactive.
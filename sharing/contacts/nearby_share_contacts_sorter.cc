@@ -16,10 +16,14 @@
 
 #include <algorithm>
 #include <locale>
+#include <cstddef>
+#include <iterator>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
 #include "sharing/proto/rpc_resources.pb.h"
 
@@ -80,9 +84,11 @@ class ContactRecordComparator {
 
   bool operator()(const nearby::sharing::proto::ContactRecord& c1,
                   const nearby::sharing::proto::ContactRecord& c2) const {
-    ContactSortingFields f1 = GetContactSortingFields(c1);
-    ContactSortingFields f2 = GetContactSortingFields(c2);
+    return (*this)(GetContactSortingFields(c1), GetContactSortingFields(c2));
+  }
 
+  bool operator()(const ContactSortingFields& f1,
+                  const ContactSortingFields& f2) const {
     switch (CollatorCompare(f1.person_name_or_email, f2.person_name_or_email)) {
       case 0:
         // Do nothing. Compare with the next field.
@@ -141,20 +147,94 @@ class ContactRecordComparator {
   std::locale locale_;
 };
 
+std::locale GetLocale(absl::string_view locale_string) {
+  // initialized to default program environment locale.
+  std::locale loc = std::locale("");
+
+  if (!locale_string.empty()) {
+    loc = std::locale(std::string(locale_string).c_str());
+  }
+  return loc;
+}
+
+// Sorts |contacts| with the sorting fields of every contact extracted once,
+// rather than on every comparison.
+void SortContacts(std::vector<nearby::sharing::proto::ContactRecord>& contacts,
+                  const ContactRecordComparator& comparator) {
+  std::vector<std::pair<ContactSortingFields, size_t>> keys;
+  keys.reserve(contacts.size());
+  for (size_t i = 0; i < contacts.size(); ++i) {
+    keys.emplace_back(GetContactSortingFields(contacts[i]), i);
+  }
+  std::sort(keys.begin(), keys.end(),
+            [&comparator](const auto& k1, const auto& k2) {
+              return comparator(k1.first, k2.first);
+            });
+
+  std::vector<nearby::sharing::proto::ContactRecord> sorted;
+  sorted.reserve(contacts.size());
+  for (const auto& key : keys) {
+    sorted.push_back(std::move(contacts[key.second]));
+  }
+  contacts = std::move(sorted);
+}
+
 }  // namespace
 
 void SortNearbyShareContactRecords(
     std::vector<nearby::sharing::proto::ContactRecord>* contacts,
     absl::string_view locale_string) {
-  // initialized to default program environment locale.
-  std::locale loc = std::locale("");
+  SortContacts(*contacts, ContactRecordComparator(GetLocale(locale_string)));
+}
 
-  if (!locale_string.empty()) {
-    loc = std::locale(locale_string.data());
+void SortNearbyShareContactRecords(
+    const std::vector<nearby::sharing::proto::ContactRecord>&
+        previously_sorted_contacts,
+    std::vector<nearby::sharing::proto::ContactRecord>* contacts,
+    absl::string_view locale_string) {
+  ContactRecordComparator comparator(GetLocale(locale_string));
+
+  // Count the contacts that are unchanged since the previous sort.
+  std::vector<std::string> previous_serialized;
+  previous_serialized.reserve(previously_sorted_contacts.size());
+  absl::flat_hash_map<std::string, int> previous_counts;
+  for (const auto& contact : previously_sorted_contacts) {
+    previous_serialized.push_back(contact.SerializeAsString());
+    ++previous_counts[previous_serialized.back()];
+  }
+  absl::flat_hash_map<std::string, int> unchanged_counts;
+  std::vector<nearby::sharing::proto::ContactRecord> changed;
+  for (auto& contact : *contacts) {
+    std::string serialized = contact.SerializeAsString();
+    auto it = previous_counts.find(serialized);
+    if (it != previous_counts.end() && it->second > 0) {
+      --it->second;
+      ++unchanged_counts[std::move(serialized)];
+    } else {
+      changed.push_back(std::move(contact));
+    }
   }
 
-  ContactRecordComparator comparator(loc);
-  std::sort(contacts->begin(), contacts->end(), comparator);
+  // The unchanged contacts keep their previous relative order, so only the
+  // changed ones need sorting before both are merged.
+  std::vector<nearby::sharing::proto::ContactRecord> unchanged;
+  unchanged.reserve(contacts->size() - changed.size());
+  for (size_t i = 0; i < previously_sorted_contacts.size(); ++i) {
+    auto it = unchanged_counts.find(previous_serialized[i]);
+    if (it != unchanged_counts.end() && it->second > 0) {
+      --it->second;
+      unchanged.push_back(previously_sorted_contacts[i]);
+    }
+  }
+  SortContacts(changed, comparator);
+
+  contacts->clear();
+  contacts->reserve(unchanged.size() + changed.size());
+  std::merge(std::make_move_iterator(unchanged.begin()),
+             std::make_move_iterator(unchanged.end()),
+             std::make_move_iterator(changed.begin()),
+             std::make_move_iterator(changed.end()),
+             std::back_inserter(*contacts), comparator);
 }
 
 }  // namespace sharing
@@ -39,6 +39,17 @@ void SortNearbyShareContactRecords(
     std::vector<nearby::sharing::proto::ContactRecord>* contacts,
     absl::string_view locale_string = "");
 
+// Same as above, but reuses the order of |previously_sorted_contacts|, the
+// result of an earlier sort with the same |locale_string|. Only the contacts
+// of |contacts| that are new or changed since then are sorted, and merged with
+// the unchanged ones, which makes sorting a mostly unchanged contact list
+// linear.
+void SortNearbyShareContactRecords(
+    const std::vector<nearby::sharing::proto::ContactRecord>&
+        previously_sorted_contacts,
+    std::vector<nearby::sharing::proto::ContactRecord>* contacts,
+    absl::string_view locale_string = "");
+
 }  // namespace sharing
 }  // namespace nearby
 
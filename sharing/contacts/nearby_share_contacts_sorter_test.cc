@@ -184,6 +184,30 @@ TEST(NearbyShareContactsSorter, US) {
       VerifySort(expected_contacts, contacts(), "en_US.UTF-8"));
 }
 
+TEST(NearbyShareContactsSorter, ReusesThePreviousOrder) {
+  std::vector<ContactRecord> previously_sorted_contacts = contacts();
+  SortNearbyShareContactRecords(&previously_sorted_contacts, "en_US.UTF-8");
+
+  // Drop a contact, rename one and add a new one.
+  std::vector<ContactRecord> updated_contacts = contacts();
+  updated_contacts.erase(updated_contacts.begin() + 3);
+  updated_contacts[5].set_person_name("Bob");
+  ContactRecord new_contact;
+  new_contact.set_person_name("Eve");
+  new_contact.set_is_reachable(true);
+  updated_contacts.push_back(new_contact);
+
+  std::default_random_engine rng;
+  std::shuffle(updated_contacts.begin(), updated_contacts.end(), rng);
+  std::vector<ContactRecord> expected_contacts = updated_contacts;
+  SortNearbyShareContactRecords(&expected_contacts, "en_US.UTF-8");
+
+  SortNearbyShareContactRecords(previously_sorted_contacts, &updated_contacts,
+                                "en_US.UTF-8");
+
+  EXPECT_THAT(updated_contacts, Pointwise(EqualsProto(), expected_contacts));
+}
+
 TEST(NearbyShareContactsSorter, DISABLED_Sweden) {
   // Expected ordering:
   //  Á        |               |              |
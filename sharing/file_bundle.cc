@@ -0,0 +1,120 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sharing/file_bundle.h"
+
+#include <stddef.h>
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <ios>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
+#include "internal/base/files.h"
+#include "sharing/common/compatible_u8_string.h"
+#include "sharing/file_attachment.h"
+#include "sharing/internal/public/logging.h"
+
+namespace nearby::sharing {
+
+std::vector<std::vector<size_t>> PlanFileBundles(
+    absl::Span<const FileAttachment> files) {
+  std::vector<std::vector<size_t>> bundles;
+  std::vector<size_t> bundle;
+  int64_t bundle_size = 0;
+  for (size_t i = 0; i < files.size(); ++i) {
+    int64_t size = files[i].size();
+    if (size <= 0 || size > kMaxBundledFileSizeBytes) continue;
+    if (bundle_size + size > kMaxFileBundleSizeBytes) {
+      if (bundle.size() > 1) bundles.push_back(std::move(bundle));
+      bundle.clear();
+      bundle_size = 0;
+    }
+    bundle.push_back(i);
+    bundle_size += size;
+  }
+  if (bundle.size() > 1) bundles.push_back(std::move(bundle));
+  return bundles;
+}
+
+std::optional<std::vector<uint8_t>> ReadFileBundle(
+    absl::Span<const std::filesystem::path> paths,
+    absl::Span<const int64_t> sizes) {
+  if (paths.size() != sizes.size()) return std::nullopt;
+  int64_t total_size = 0;
+  for (int64_t size : sizes) total_size += size;
+
+  std::vector<uint8_t> bundle(total_size);
+  size_t offset = 0;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    std::ifstream file(paths[i], std::ios::binary);
+    file.read(reinterpret_cast<char*>(bundle.data() + offset), sizes[i]);
+    // The file must be exactly the size announced in the introduction.
+    if (!file || file.gcount() != sizes[i] || file.peek() != EOF) {
+      LOG(WARNING) << __func__ << ": Failed to read bundled file "
+                   << paths[i].string();
+      return std::nullopt;
+    }
+    offset += sizes[i];
+  }
+  return bundle;
+}
+
+bool WriteFileBundle(absl::Span<const uint8_t> bundle,
+                     absl::Span<const std::filesystem::path> paths,
+                     absl::Span<const int64_t> sizes) {
+  if (paths.size() != sizes.size()) return false;
+  int64_t total_size = 0;
+  for (int64_t size : sizes) total_size += size;
+  if (total_size != static_cast<int64_t>(bundle.size())) {
+    LOG(WARNING) << __func__ << ": Bundle of " << bundle.size()
+                 << " bytes doesn't match the file sizes.";
+    return false;
+  }
+
+  size_t offset = 0;
+  for (size_t i = 0; i < paths.size(); ++i) {
+    std::ofstream file(paths[i], std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(bundle.data() + offset),
+               sizes[i]);
+    if (!file) {
+      LOG(WARNING) << __func__ << ": Failed to write bundled file "
+                   << paths[i].string();
+      return false;
+    }
+    offset += sizes[i];
+  }
+  return true;
+}
+
+std::filesystem::path GetUniqueFilePath(const std::filesystem::path& path) {
+  if (!FileExists(path)) return path;
+  std::filesystem::path stem = path.stem();
+  std::filesystem::path extension = path.extension();
+  for (int i = 1;; ++i) {
+    std::filesystem::path unique_path = path;
+    unique_path.replace_filename(
+        absl::StrCat(GetCompatibleU8String(stem.u8string()), " (", i, ")",
+                     GetCompatibleU8String(extension.u8string())));
+    if (!FileExists(unique_path)) return unique_path;
+  }
+}
+
+}  // namespace nearby::sharing
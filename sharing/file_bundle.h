@@ -0,0 +1,66 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef THIRD_PARTY_NEARBY_SHARING_FILE_BUNDLE_H_
+#define THIRD_PARTY_NEARBY_SHARING_FILE_BUNDLE_H_
+
+#include <stddef.h>
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <optional>
+#include <vector>
+
+#include "absl/types/span.h"
+#include "sharing/file_attachment.h"
+
+namespace nearby::sharing {
+
+// Helpers for file bundles, which carry several small files in one BYTES
+// payload so that a share of many small files doesn't pay the per-payload
+// overhead for each of them. The bytes of the files follow each other without
+// any framing; the sizes come from the introduction frame.
+
+// Files larger than this are always sent in their own FILE payload.
+inline constexpr int64_t kMaxBundledFileSizeBytes = 256 * 1024;
+
+// The most bytes in one bundle, which is held in memory on both sides.
+inline constexpr int64_t kMaxFileBundleSizeBytes = 1024 * 1024;
+
+// Groups the small attachments of `files` into bundles. Returns the indices of
+// the attachments of each bundle. A bundle has at least two files.
+std::vector<std::vector<size_t>> PlanFileBundles(
+    absl::Span<const FileAttachment> files);
+
+// Reads the files at `paths` into one bundle. Returns std::nullopt if a file
+// can't be read or its size doesn't match the one in `sizes`.
+std::optional<std::vector<uint8_t>> ReadFileBundle(
+    absl::Span<const std::filesystem::path> paths,
+    absl::Span<const int64_t> sizes);
+
+// Splits `bundle` into the files at `paths`, with the sizes in `sizes`.
+// Returns false if the sizes don't add up to the bundle or a file can't be
+// written.
+bool WriteFileBundle(absl::Span<const uint8_t> bundle,
+                     absl::Span<const std::filesystem::path> paths,
+                     absl::Span<const int64_t> sizes);
+
+// Returns `path`, or a path next to it with a " (n)" suffix added to the file
+// name if a file already exists at `path`.
+std::filesystem::path GetUniqueFilePath(const std::filesystem::path& path);
+
+}  // namespace nearby::sharing
+
+#endif  // THIRD_PARTY_NEARBY_SHARING_FILE_BUNDLE_H_
@@ -0,0 +1,126 @@
+// Copyright 2024 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sharing/file_bundle.h"
+
+#include <stddef.h>
+
+#include <cstdint>
+#include <filesystem>  // NOLINT
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "sharing/file_attachment.h"
+#include "sharing/proto/wire_format.pb.h"
+
+namespace nearby::sharing {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+FileAttachment MakeFile(int64_t id, int64_t size) {
+  return FileAttachment(id, size, "file.jpg", "image/jpeg",
+                        service::proto::FileMetadata::IMAGE);
+}
+
+void WriteFile(const std::filesystem::path& path, const std::string& content) {
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+std::string ReadFile(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+TEST(FileBundleTest, PlanBundlesSmallFiles) {
+  std::vector<FileAttachment> files = {
+      MakeFile(1, 100), MakeFile(2, kMaxBundledFileSizeBytes + 1),
+      MakeFile(3, 200), MakeFile(4, 300)};
+
+  EXPECT_THAT(PlanFileBundles(files), ElementsAre(ElementsAre(0, 2, 3)));
+}
+
+TEST(FileBundleTest, PlanSplitsBundlesAtMaxSize) {
+  std::vector<FileAttachment> files;
+  for (int i = 0; i < 5; ++i) {
+    files.push_back(MakeFile(i, kMaxBundledFileSizeBytes));
+  }
+
+  EXPECT_THAT(PlanFileBundles(files), ElementsAre(ElementsAre(0, 1, 2, 3)));
+}
+
+TEST(FileBundleTest, PlanDoesNotBundleASingleFile) {
+  std::vector<FileAttachment> files = {MakeFile(1, 100)};
+
+  EXPECT_THAT(PlanFileBundles(files), IsEmpty());
+}
+
+TEST(FileBundleTest, ReadAndWriteBundle) {
+  std::filesystem::path directory = testing::TempDir();
+  std::vector<std::filesystem::path> paths = {directory / "bundle_in_1",
+                                              directory / "bundle_in_2"};
+  WriteFile(paths[0], "hello");
+  WriteFile(paths[1], "world!");
+  std::vector<int64_t> sizes = {5, 6};
+
+  std::optional<std::vector<uint8_t>> bundle = ReadFileBundle(paths, sizes);
+  ASSERT_TRUE(bundle.has_value());
+  EXPECT_EQ(std::string(bundle->begin(), bundle->end()), "helloworld!");
+
+  std::vector<std::filesystem::path> out_paths = {directory / "bundle_out_1",
+                                                  directory / "bundle_out_2"};
+  EXPECT_TRUE(WriteFileBundle(*bundle, out_paths, sizes));
+  EXPECT_EQ(ReadFile(out_paths[0]), "hello");
+  EXPECT_EQ(ReadFile(out_paths[1]), "world!");
+}
+
+TEST(FileBundleTest, ReadFailsOnSizeMismatch) {
+  std::filesystem::path path =
+      std::filesystem::path(testing::TempDir()) / "bundle_mismatch";
+  WriteFile(path, "hello");
+
+  EXPECT_FALSE(ReadFileBundle({path}, {4}).has_value());
+  EXPECT_FALSE(ReadFileBundle({path}, {6}).has_value());
+}
+
+TEST(FileBundleTest, WriteFailsOnSizeMismatch) {
+  std::vector<uint8_t> bundle = {1, 2, 3};
+  std::filesystem::path path =
+      std::filesystem::path(testing::TempDir()) / "bundle_short";
+
+  EXPECT_FALSE(WriteFileBundle(bundle, {path}, {4}));
+}
+
+TEST(FileBundleTest, GetUniqueFilePath) {
+  std::filesystem::path directory = testing::TempDir();
+  std::filesystem::path path = directory / "unique.txt";
+  std::filesystem::remove(path);
+  std::filesystem::remove(directory / "unique (1).txt");
+  EXPECT_EQ(GetUniqueFilePath(path), path);
+
+  WriteFile(path, "taken");
+
+  EXPECT_EQ(GetUniqueFilePath(path), directory / "unique (1).txt");
+}
+
+}  // namespace
+}  // namespace nearby::sharing
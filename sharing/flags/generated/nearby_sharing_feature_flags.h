@@ -107,6 +107,42 @@ constexpr auto kEnableConflictBanner =
 // Enable a persistent BETA label.
 constexpr auto kEnableMacosBetaLabel =
     flags::Flag<bool>(kConfigPackage, "45662570", true);
+// When true, a discovered device advertising its name is reported as an
+// unknown share target right away, and updated once its public certificate is
+// decrypted.
+constexpr auto kEnableProvisionalShareTargets =
+    flags::Flag<bool>(kConfigPackage, "45671315", false);
+// When true, the periodic and expiration schedulers fire recurring requests
+// that are due close together on a shared wake-up grid.
+constexpr auto kEnableSchedulerWakeUpCoalescing =
+    flags::Flag<bool>(kConfigPackage, "45671316", false);
+// When true, files that the current medium transfers within a couple of
+// seconds are sent right away instead of waiting for a bandwidth upgrade.
+constexpr auto kEnableAdaptiveMediumUpgradeWait =
+    flags::Flag<bool>(kConfigPackage, "45671317", false);
+// When true, files are sent over the current medium right away and move to
+// the upgraded medium mid-transfer. Only for Nearby Connections builds with
+// make-before-break bandwidth upgrades.
+constexpr auto kStartTransferBeforeMediumUpgrade =
+    flags::Flag<bool>(kConfigPackage, "45671318", false);
+// When true, the sender writes the introduction frame right after its own
+// paired key result, without waiting for the receiver's result.
+constexpr auto kEnableEarlyIntroduction =
+    flags::Flag<bool>(kConfigPackage, "45671319", false);
+// When true, fast initiation scanning runs in windows separated by pauses that
+// grow while no device is detected.
+constexpr auto kEnableFastInitiationDutyCycle =
+    flags::Flag<bool>(kConfigPackage, "45671320", false);
+// When true, certificates decrypted for discovered advertisements are kept for
+// a while, so that the same advertisement found again, on another medium or
+// after a scan restart, is not decrypted again.
+constexpr auto kEnableDecryptedCertificateCache =
+    flags::Flag<bool>(kConfigPackage, "45671321", false);
+// When true, the contact and certificate managers, whose schedulers load from
+// storage and call the server as soon as they start, are started on first use
+// of the service or after a delay, instead of in its constructor.
+constexpr auto kEnableDeferredManagerStartup =
+    flags::Flag<bool>(kConfigPackage, "45671322", false);
 
 inline absl::btree_map<int, const flags::Flag<bool>&> GetBoolFlags() {
   return {
@@ -129,6 +165,14 @@ inline absl::btree_map<int, const flags::Flag<bool>&> GetBoolFlags() {
       {45410558, kShowAdminModeWarning},
       {45661130, kEnableConflictBanner},
       {45662570, kEnableMacosBetaLabel},
+      {45671315, kEnableProvisionalShareTargets},
+      {45671316, kEnableSchedulerWakeUpCoalescing},
+      {45671317, kEnableAdaptiveMediumUpgradeWait},
+      {45671318, kStartTransferBeforeMediumUpgrade},
+      {45671319, kEnableEarlyIntroduction},
+      {45671320, kEnableFastInitiationDutyCycle},
+      {45671321, kEnableDecryptedCertificateCache},
+      {45671322, kEnableDeferredManagerStartup},
   };
 }
 
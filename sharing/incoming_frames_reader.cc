@@ -14,6 +14,7 @@
 
 #include "sharing/incoming_frames_reader.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <algorithm>
@@ -41,12 +42,18 @@ using FrameType = ::nearby::sharing::service::proto::V1Frame_FrameType;
 using V1Frame = ::nearby::sharing::service::proto::V1Frame;
 using Frame = ::nearby::sharing::service::proto::Frame;
 
+// The most frames of one type kept for later reads. A peer repeating a frame
+// nobody reads would otherwise grow the cache without bound.
+constexpr size_t kMaxCachedFramesPerType = 4;
+
 std::unique_ptr<V1Frame> DecodeV1Frame(const std::vector<uint8_t>& data) {
-  auto frame = std::make_unique<Frame>();
+  Frame frame;
 
-  if (frame->ParseFromArray(data.data(), data.size()) &&
-      frame->version() == Frame::V1) {
-    return absl::WrapUnique(frame->release_v1());
+  if (frame.ParseFromArray(data.data(), data.size()) &&
+      frame.version() == Frame::V1) {
+    // Only the wrapper lives on the stack. The parser allocated the V1Frame
+    // on the heap, and releasing it hands it over without a copy.
+    return absl::WrapUnique(frame.release_v1());
   } else {
     return nullptr;
   }
@@ -95,7 +102,7 @@ void IncomingFramesReader::ProcessReadRequest(
     cached_frame = PopCachedFrame(frame_type);
   }
   if (cached_frame) {
-    callback(*cached_frame);
+    callback(std::move(*cached_frame));
     return;
   }
   {
@@ -166,7 +173,7 @@ void IncomingFramesReader::OnDataReadFromConnection(
       NL_LOG(WARNING) << __func__ << ": Failed to read frame of type "
                       << *frame_info.frame_type << ", but got frame of type "
                       << frame_type << ". Cached for later.";
-      cached_frames_.push_back(std::move(frame));
+      CacheFrame(std::move(frame));
       cached_frame = true;
     }
   }
@@ -198,7 +205,7 @@ void IncomingFramesReader::Done(std::unique_ptr<V1Frame> frame) {
     read_frame_info = std::move(read_frame_info_queue_.front());
     read_frame_info_queue_.pop();
   }
-  read_frame_info.callback(*frame);
+  read_frame_info.callback(std::move(*frame));
 
   {
     absl::MutexLock lock(&mutex_);
@@ -217,6 +224,22 @@ void IncomingFramesReader::Done(std::unique_ptr<V1Frame> frame) {
   }
 }
 
+void IncomingFramesReader::CacheFrame(std::unique_ptr<V1Frame> frame) {
+  FrameType frame_type = frame->type();
+  auto is_same_type = [frame_type](const std::unique_ptr<V1Frame>& cached) {
+    return cached->type() == frame_type;
+  };
+  if (static_cast<size_t>(std::count_if(cached_frames_.begin(),
+                                       cached_frames_.end(), is_same_type)) >=
+      kMaxCachedFramesPerType) {
+    NL_LOG(WARNING) << __func__ << ": Too many cached frames of type "
+                    << frame_type << ". Dropped the oldest one.";
+    cached_frames_.erase(std::find_if(cached_frames_.begin(),
+                                      cached_frames_.end(), is_same_type));
+  }
+  cached_frames_.push_back(std::move(frame));
+}
+
 std::unique_ptr<V1Frame> IncomingFramesReader::PopCachedFrame(
     std::optional<V1Frame::FrameType> frame_type) {
   NL_VLOG(1) << __func__ << ": Fetching cached frame";
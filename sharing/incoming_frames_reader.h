@@ -96,6 +96,11 @@ class IncomingFramesReader
   void OnTimeout();
   void Done(std::unique_ptr<nearby::sharing::service::proto::V1Frame> frame)
       ABSL_LOCKS_EXCLUDED(mutex_);
+  // Caches |frame|, dropping the oldest cached frame of its type if there
+  // are too many.
+  void CacheFrame(
+      std::unique_ptr<nearby::sharing::service::proto::V1Frame> frame)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
   std::unique_ptr<nearby::sharing::service::proto::V1Frame> PopCachedFrame(
       std::optional<nearby::sharing::service::proto::V1Frame::FrameType>
           frame_type) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -106,7 +111,8 @@ class IncomingFramesReader
   absl::Mutex mutex_;
   std::queue<ReadFrameInfo> read_frame_info_queue_ ABSL_GUARDED_BY(mutex_);
 
-  // Caches frames read from NearbyConnection which are not used immediately.
+  // Caches frames read from NearbyConnection which are not used immediately,
+  // at most kMaxCachedFramesPerType of each type.
   std::list<std::unique_ptr<nearby::sharing::service::proto::V1Frame>>
       cached_frames_ ABSL_GUARDED_BY(mutex_);
 
@@ -71,14 +71,14 @@ std::optional<std::vector<uint8_t>> GetCancelFrame() {
   return std::nullopt;
 }
 
-std::optional<std::vector<uint8_t>> GetResponseFrame() {
+std::optional<std::vector<uint8_t>> GetResponseFrame(
+    ConnectionResponseFrame::Status status = ConnectionResponseFrame::ACCEPT) {
   nearby::sharing::service::proto::Frame frame =
       nearby::sharing::service::proto::Frame();
   frame.set_version(nearby::sharing::service::proto::Frame::V1);
   V1Frame* v1frame = frame.mutable_v1();
   v1frame->set_type(service::proto::V1Frame::RESPONSE);
-  v1frame->mutable_connection_response()->set_status(
-      ConnectionResponseFrame::ACCEPT);
+  v1frame->mutable_connection_response()->set_status(status);
 
   std::vector<uint8_t> data;
   data.resize(frame.ByteSizeLong());
@@ -267,6 +267,46 @@ TEST_F(IncomingFramesReaderTest, JumbledFramesOrdering_ReadFromCache) {
   EXPECT_TRUE(response_notification.WaitForNotificationWithTimeout(kTimeout));
 }
 
+TEST_F(IncomingFramesReaderTest, CacheDropsOldestFramesOfAType) {
+  // The accepting response is pushed out of the cache by the later ones.
+  std::optional<std::vector<uint8_t>> accept_frame =
+      GetResponseFrame(ConnectionResponseFrame::ACCEPT);
+  ASSERT_TRUE(accept_frame.has_value());
+  connection().WriteMessage(*accept_frame);
+  for (int i = 0; i < 4; ++i) {
+    std::optional<std::vector<uint8_t>> reject_frame =
+        GetResponseFrame(ConnectionResponseFrame::REJECT);
+    ASSERT_TRUE(reject_frame.has_value());
+    connection().WriteMessage(*reject_frame);
+  }
+  std::optional<std::vector<uint8_t>> introduction_frame =
+      GetIntroductionFrame();
+  ASSERT_TRUE(introduction_frame.has_value());
+  connection().WriteMessage(*introduction_frame);
+
+  absl::Notification notification;
+  frames_reader()->ReadFrame(
+      service::proto::V1Frame::INTRODUCTION,
+      [&](std::optional<V1Frame> frame) {
+        EXPECT_EQ(frame->type(), service::proto::V1Frame::INTRODUCTION);
+        notification.Notify();
+      },
+      kTimeout);
+  EXPECT_TRUE(notification.WaitForNotificationWithTimeout(kTimeout));
+
+  absl::Notification response_notification;
+  frames_reader()->ReadFrame(
+      service::proto::V1Frame::RESPONSE,
+      [&](std::optional<V1Frame> frame) {
+        ASSERT_NE(frame, std::nullopt);
+        EXPECT_EQ(frame->connection_response().status(),
+                  ConnectionResponseFrame::REJECT);
+        response_notification.Notify();
+      },
+      kTimeout);
+  EXPECT_TRUE(response_notification.WaitForNotificationWithTimeout(kTimeout));
+}
+
 TEST_F(IncomingFramesReaderTest, ReadAfterConnectionClosed) {
   absl::Notification notification;
   frames_reader()->ReadFrame(
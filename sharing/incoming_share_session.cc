@@ -26,7 +26,9 @@
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/functional/any_invocable.h"
+#include "internal/base/files.h"
 #include "internal/platform/clock.h"
 #include "internal/platform/task_runner.h"
 #include "sharing/analytics/analytics_recorder.h"
@@ -34,6 +36,7 @@
 #include "sharing/common/compatible_u8_string.h"
 #include "sharing/constants.h"
 #include "sharing/file_attachment.h"
+#include "sharing/file_bundle.h"
 #include "sharing/internal/public/logging.h"
 #include "sharing/nearby_connection.h"
 #include "sharing/nearby_connections_manager.h"
@@ -55,10 +58,29 @@ namespace {
 using ::location::nearby::proto::sharing::OSType;
 using ::location::nearby::proto::sharing::ResponseToIntroduction;
 using ::nearby::sharing::service::proto::ConnectionResponseFrame;
+using ::nearby::sharing::service::proto::FileBundleMetadata;
+using ::nearby::sharing::service::proto::FileMetadata;
 using ::nearby::sharing::service::proto::IntroductionFrame;
 using ::nearby::sharing::service::proto::V1Frame;
 using ::nearby::sharing::service::proto::WifiCredentials;
 
+// Returns the path under `directory` a bundled file is saved to, or
+// std::nullopt if its name or parent folder would leave `directory`.
+std::optional<std::filesystem::path> GetBundledFilePath(
+    const std::filesystem::path& directory, const FileMetadata& file) {
+  std::filesystem::path name(file.name());
+  if (name.empty() || name != name.filename() || name == "." || name == "..") {
+    return std::nullopt;
+  }
+  std::filesystem::path parent_folder =
+      std::filesystem::path(file.parent_folder()).lexically_normal();
+  if (parent_folder.has_root_path() ||
+      (!parent_folder.empty() && *parent_folder.begin() == "..")) {
+    return std::nullopt;
+  }
+  return directory / parent_folder / name;
+}
+
 }  // namespace
 
 IncomingShareSession::IncomingShareSession(
@@ -111,6 +133,8 @@ IncomingShareSession::ProcessIntroduction(
     file_size_sum += file.size();
   }
 
+  ProcessFileBundles(introduction_frame);
+
   for (const auto& text : introduction_frame.text_metadata()) {
     if (text.size() <= 0) {
       LOG(WARNING) << "Ignore introduction, due to invalid attachment size";
@@ -148,6 +172,110 @@ IncomingShareSession::ProcessIntroduction(
   return std::nullopt;
 }
 
+void IncomingShareSession::EnableFileBundles(std::filesystem::path directory) {
+  file_bundle_directory_ = std::move(directory);
+}
+
+void IncomingShareSession::ProcessFileBundles(
+    const IntroductionFrame& introduction_frame) {
+  if (!kSupportFileBundles || !file_bundle_directory_.has_value() ||
+      introduction_frame.file_bundle_metadata().empty()) {
+    return;
+  }
+  absl::flat_hash_map<int64_t, const FileMetadata*> files;
+  for (const FileMetadata& file : introduction_frame.file_metadata()) {
+    files.emplace(file.id(), &file);
+  }
+
+  // The sender sends either all bundles or none, so one invalid bundle means
+  // none of them are accepted.
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> bundles;
+  absl::flat_hash_set<int64_t> bundled_file_ids;
+  for (const FileBundleMetadata& bundle :
+       introduction_frame.file_bundle_metadata()) {
+    int64_t bundle_size = 0;
+    for (int64_t file_id : bundle.file_ids()) {
+      auto it = files.find(file_id);
+      if (it == files.end() || !bundled_file_ids.insert(file_id).second ||
+          !GetBundledFilePath(*file_bundle_directory_, *it->second)) {
+        LOG(WARNING) << "Ignoring file bundles, due to invalid file "
+                     << file_id;
+        return;
+      }
+      bundle_size += it->second->size();
+    }
+    if (bundle.file_ids().empty() || bundle_size > kMaxFileBundleSizeBytes ||
+        !bundles
+             .emplace(bundle.payload_id(),
+                      std::vector<int64_t>(bundle.file_ids().begin(),
+                                           bundle.file_ids().end()))
+             .second) {
+      LOG(WARNING) << "Ignoring file bundles, due to invalid bundle "
+                   << bundle.payload_id();
+      return;
+    }
+  }
+
+  for (const auto& [payload_id, file_ids] : bundles) {
+    for (int64_t file_id : file_ids) {
+      SetAttachmentPayloadId(file_id, payload_id);
+    }
+  }
+  VLOG(1) << "Accepting " << bundled_file_ids.size() << " files in "
+          << bundles.size() << " file bundles.";
+  file_bundles_ = std::move(bundles);
+}
+
+bool IncomingShareSession::SaveFileBundle(int64_t payload_id) {
+  auto bundle_it = file_bundles_.find(payload_id);
+  if (bundle_it == file_bundles_.end()) return false;
+  const Payload* incoming_payload =
+      connections_manager().GetIncomingPayload(payload_id);
+  if (!incoming_payload || !incoming_payload->content.is_bytes()) {
+    LOG(WARNING) << "No payload found for file bundle: " << payload_id;
+    return false;
+  }
+
+  AttachmentContainer& container = mutable_attachment_container();
+  absl::flat_hash_set<int64_t> file_ids(bundle_it->second.begin(),
+                                        bundle_it->second.end());
+  absl::flat_hash_map<int64_t, int> file_indices;
+  for (int i = 0; i < container.GetFileAttachments().size(); ++i) {
+    if (file_ids.contains(container.GetFileAttachments()[i].id())) {
+      file_indices.emplace(container.GetFileAttachments()[i].id(), i);
+    }
+  }
+
+  std::vector<std::filesystem::path> paths;
+  std::vector<int64_t> sizes;
+  for (int64_t file_id : bundle_it->second) {
+    auto it = file_indices.find(file_id);
+    if (it == file_indices.end()) return false;
+    const FileAttachment& file = container.GetFileAttachments()[it->second];
+    FileMetadata metadata;
+    metadata.set_name(std::string(file.file_name()));
+    metadata.set_parent_folder(std::string(file.parent_folder()));
+    std::optional<std::filesystem::path> path =
+        GetBundledFilePath(*file_bundle_directory_, metadata);
+    if (!path.has_value() || !CreateDirectories(path->parent_path())) {
+      return false;
+    }
+    paths.push_back(GetUniqueFilePath(*path));
+    sizes.push_back(file.size());
+  }
+  if (!WriteFileBundle(incoming_payload->content.bytes_payload.bytes, paths,
+                       sizes)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < paths.size(); ++i) {
+    container.GetMutableFileAttachment(file_indices.at(bundle_it->second[i]))
+        .set_file_path(paths[i]);
+  }
+  file_bundles_.erase(bundle_it);
+  return true;
+}
+
 bool IncomingShareSession::ProcessKeyVerificationResult(
     PairedKeyVerificationRunner::PairedKeyVerificationResult result,
     OSType share_target_os_type,
@@ -220,7 +348,8 @@ bool IncomingShareSession::AcceptTransfer(
     VLOG(1) << __func__ << ": Accepted incoming files from share target - "
             << share_target().id;
   }
-  WriteResponseFrame(ConnectionResponseFrame::ACCEPT);
+  WriteResponseFrame(ConnectionResponseFrame::ACCEPT,
+                     /*accept_file_bundles=*/!file_bundles_.empty());
   VLOG(1) << __func__ << ": Successfully wrote response frame";
   // Log analytics event of responding to introduction.
   analytics_recorder().NewRespondToIntroduction(
@@ -261,6 +390,16 @@ bool IncomingShareSession::UpdateFilePayloadPaths() {
       continue;
     }
 
+    if (file_bundles_.contains(it->second)) {
+      // Sets the paths of all files of the bundle.
+      if (!SaveFileBundle(it->second)) {
+        LOG(WARNING) << "No file bundle saved for file attachment: "
+                     << file.id();
+        result = false;
+      }
+      continue;
+    }
+
     const Payload* incoming_payload =
         connections_manager().GetIncomingPayload(it->second);
     if (!incoming_payload || !incoming_payload->content.is_file()) {
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_SHARING_INCOMING_SHARE_SESSION_H_
 #define THIRD_PARTY_NEARBY_SHARING_INCOMING_SHARE_SESSION_H_
 
+#include <cstdint>
 #include <filesystem>  // NOLINT
 #include <functional>
 #include <memory>
@@ -22,6 +23,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/functional/any_invocable.h"
 #include "internal/platform/clock.h"
 #include "internal/platform/task_runner.h"
@@ -54,6 +56,10 @@ class IncomingShareSession : public ShareSession {
 
   bool IsIncoming() const override { return true; }
 
+  // Accepts the file bundles offered by the sender, which are split into files
+  // saved under `directory`. Must be called before ProcessIntroduction.
+  void EnableFileBundles(std::filesystem::path directory);
+
   // Returns nullopt on success.
   // On failure, returns the status that should be used to terminate the
   // connection.
@@ -118,6 +124,15 @@ class IncomingShareSession : public ShareSession {
   void InvokeTransferUpdateCallback(const TransferMetadata& metadata) override;
 
  private:
+  // Accepts the file bundles of the introduction if all of them are valid.
+  void ProcessFileBundles(
+      const nearby::sharing::service::proto::IntroductionFrame&
+          introduction_frame);
+
+  // Splits the file bundle received in payload `payload_id` into its files.
+  // Returns true if the files were saved, and their paths set.
+  bool SaveFileBundle(int64_t payload_id);
+
   // Update file attachment paths with payload paths.
   bool UpdateFilePayloadPaths();
 
@@ -132,6 +147,11 @@ class IncomingShareSession : public ShareSession {
   std::function<void(const IncomingShareSession&, const TransferMetadata&)>
       transfer_update_callback_;
 
+  std::optional<std::filesystem::path> file_bundle_directory_;
+  // Map of the payload id of an accepted file bundle to the ids of its files,
+  // until the files are saved.
+  absl::flat_hash_map<int64_t, std::vector<int64_t>> file_bundles_;
+
   bool bandwidth_upgrade_requested_ = false;
   bool ready_for_accept_ = false;
   // This alarm is used to disconnect the sharing connection if both sides do
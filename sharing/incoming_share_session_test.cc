@@ -297,6 +297,57 @@ TEST_F(IncomingShareSessionTest, ProcessIntroductionSuccess) {
               Eq(wifimeta2.payload_id()));
 }
 
+TEST_F(IncomingShareSessionTest, ProcessIntroductionWithFileBundles) {
+  session_.OnConnected(&connection_);
+  session_.EnableFileBundles(testing::TempDir());
+  IntroductionFrame frame = introduction_frame_;
+  auto* bundle = frame.add_file_bundle_metadata();
+  bundle->set_payload_id(5555);
+  bundle->add_file_ids(frame.file_metadata(0).id());
+  bundle->add_file_ids(frame.file_metadata(1).id());
+
+  EXPECT_THAT(session_.ProcessIntroduction(frame), Eq(std::nullopt));
+
+  EXPECT_THAT(session_.attachment_payload_map().at(frame.file_metadata(0).id()),
+              Eq(5555));
+  EXPECT_THAT(session_.attachment_payload_map().at(frame.file_metadata(1).id()),
+              Eq(5555));
+}
+
+TEST_F(IncomingShareSessionTest,
+       ProcessIntroductionIgnoresFileBundlesIfNotEnabled) {
+  session_.OnConnected(&connection_);
+  IntroductionFrame frame = introduction_frame_;
+  auto* bundle = frame.add_file_bundle_metadata();
+  bundle->set_payload_id(5555);
+  bundle->add_file_ids(frame.file_metadata(0).id());
+  bundle->add_file_ids(frame.file_metadata(1).id());
+
+  EXPECT_THAT(session_.ProcessIntroduction(frame), Eq(std::nullopt));
+
+  EXPECT_THAT(session_.attachment_payload_map().at(frame.file_metadata(0).id()),
+              Eq(frame.file_metadata(0).payload_id()));
+}
+
+TEST_F(IncomingShareSessionTest,
+       ProcessIntroductionIgnoresFileBundlesWithUnsafeNames) {
+  session_.OnConnected(&connection_);
+  session_.EnableFileBundles(testing::TempDir());
+  IntroductionFrame frame = introduction_frame_;
+  frame.mutable_file_metadata(1)->set_parent_folder("../outside");
+  auto* bundle = frame.add_file_bundle_metadata();
+  bundle->set_payload_id(5555);
+  bundle->add_file_ids(frame.file_metadata(0).id());
+  bundle->add_file_ids(frame.file_metadata(1).id());
+
+  EXPECT_THAT(session_.ProcessIntroduction(frame), Eq(std::nullopt));
+
+  EXPECT_THAT(session_.attachment_payload_map().at(frame.file_metadata(0).id()),
+              Eq(frame.file_metadata(0).payload_id()));
+  EXPECT_THAT(session_.attachment_payload_map().at(frame.file_metadata(1).id()),
+              Eq(frame.file_metadata(1).payload_id()));
+}
+
 TEST_F(IncomingShareSessionTest,
        PayloadTransferUpdateCompleteWithWrongPayloadType) {
   connections_manager_.AcceptConnection(
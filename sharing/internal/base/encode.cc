@@ -16,26 +16,27 @@
 
 #include <stdint.h>
 
-#include <iomanip>
-#include <ios>
-#include <sstream>
 #include <string>
 
 #include "absl/types/span.h"
 
 namespace nearby {
 namespace utils {
+namespace {
+
+constexpr char kHexDigits[] = "0123456789ABCDEF";
+
+}  // namespace
 
 // Returns uppercase string.
 std::string HexEncode(absl::Span<const uint8_t> data) {
-  std::ostringstream stream;
-  stream << std::hex << std::setfill('0') << std::uppercase;
-
+  std::string hex(data.size() * 2, '\0');
+  char* out = hex.data();
   for (uint8_t val : data) {
-    stream << std::setw(2) << static_cast<int>(val);
+    *out++ = kHexDigits[val >> 4];
+    *out++ = kHexDigits[val & 0x0F];
   }
-
-  return stream.str();
+  return hex;
 }
 
 }  // namespace utils
@@ -21,6 +21,7 @@
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "sharing/internal/api/network_monitor.h"
 #include "sharing/internal/api/sharing_platform.h"
 #include "sharing/internal/public/connectivity_manager.h"
@@ -63,6 +64,14 @@ ConnectivityManagerImpl::ConnectivityManagerImpl(SharingPlatform& platform) {
             static_cast<ConnectionType>(connection_type);
         NL_VLOG(1) << ": New connection type:"
                    << GetConnectionTypeString(new_connection_type);
+        {
+          absl::MutexLock lock(&state_mutex_);
+          state_.store({
+              .connection_type = new_connection_type,
+              .is_lan_connected = is_lan_connected,
+              .is_known = true,
+          });
+        }
         for (auto& listener : listeners_) {
           listener.second(new_connection_type, is_lan_connected);
         }
@@ -70,11 +79,30 @@ ConnectivityManagerImpl::ConnectivityManagerImpl(SharingPlatform& platform) {
 }
 
 bool ConnectivityManagerImpl::IsLanConnected() {
-  return network_monitor_->IsLanConnected();
+  return GetState().is_lan_connected;
 }
 
 ConnectionType ConnectivityManagerImpl::GetConnectionType() {
-  return static_cast<ConnectionType>(network_monitor_->GetCurrentConnection());
+  return GetState().connection_type;
+}
+
+ConnectivityManagerImpl::State ConnectivityManagerImpl::GetState() {
+  State state = state_.load();
+  if (state.is_known || network_monitor_ == nullptr) {
+    return state;
+  }
+  absl::MutexLock lock(&state_mutex_);
+  state = state_.load();
+  if (!state.is_known) {
+    state = {
+        .connection_type = static_cast<ConnectionType>(
+            network_monitor_->GetCurrentConnection()),
+        .is_lan_connected = network_monitor_->IsLanConnected(),
+        .is_known = true,
+    };
+    state_.store(state);
+  }
+  return state;
 }
 
 void ConnectivityManagerImpl::RegisterConnectionListener(
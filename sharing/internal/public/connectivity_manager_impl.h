@@ -15,12 +15,15 @@
 #ifndef THIRD_PARTY_NEARBY_SHARING_INTERNAL_PUBLIC_CONNECTIVITY_MANAGER_IMPL_H_
 #define THIRD_PARTY_NEARBY_SHARING_INTERNAL_PUBLIC_CONNECTIVITY_MANAGER_IMPL_H_
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "sharing/internal/api/network_monitor.h"
 #include "sharing/internal/api/sharing_platform.h"
 #include "sharing/internal/public/connectivity_manager.h"
@@ -45,6 +48,23 @@ class ConnectivityManagerImpl : public ConnectivityManager {
   int GetListenerCount() const;
 
  private:
+  // The network state last reported by the network monitor.
+  struct State {
+    ConnectionType connection_type = ConnectionType::kUnknown;
+    bool is_lan_connected = false;
+    // False until the state is read from the network monitor or reported by
+    // it.
+    bool is_known = false;
+  };
+
+  // Returns the cached state, reading it from the network monitor the first
+  // time only; the network monitor keeps it up to date afterwards.
+  State GetState() ABSL_LOCKS_EXCLUDED(state_mutex_);
+
+  // Read without locking; written under `state_mutex_`, so a state read from
+  // the network monitor never replaces a newer one it reported.
+  std::atomic<State> state_;
+  absl::Mutex state_mutex_;
   absl::flat_hash_map<std::string, std::function<void(ConnectionType, bool)>>
       listeners_;
   std::unique_ptr<api::NetworkMonitor> network_monitor_;
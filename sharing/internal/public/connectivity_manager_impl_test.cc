@@ -31,7 +31,9 @@ using ::nearby::sharing::api::MockNetworkMonitor;
 using ::nearby::sharing::api::MockSharingPlatform;
 using ::testing::_;
 using ::testing::ByMove;
+using ::testing::DoAll;
 using ::testing::Return;
+using ::testing::SaveArg;
 
 TEST(ConnectivityManagerImpl, IsLanConnected) {
   MockSharingPlatform sharing_platform;
@@ -59,6 +61,57 @@ TEST(ConnectivityManagerImpl, GetConnectionType) {
             ConnectivityManager::ConnectionType::kWifi);
 }
 
+TEST(ConnectivityManagerImpl, ReadsNetworkMonitorOnce) {
+  MockSharingPlatform sharing_platform;
+  auto network_monitor = std::make_unique<MockNetworkMonitor>();
+  MockNetworkMonitor* mock_network_monitor = network_monitor.get();
+  EXPECT_CALL(sharing_platform, CreateNetworkMonitor(_))
+      .WillOnce(Return(ByMove(std::move(network_monitor))));
+  EXPECT_CALL(*mock_network_monitor, GetCurrentConnection())
+      .WillOnce(Return(MockNetworkMonitor::ConnectionType::kEthernet));
+  EXPECT_CALL(*mock_network_monitor, IsLanConnected()).WillOnce(Return(true));
+
+  ConnectivityManagerImpl connectivity_manager_impl(sharing_platform);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(connectivity_manager_impl.GetConnectionType(),
+              ConnectivityManager::ConnectionType::kEthernet);
+    EXPECT_TRUE(connectivity_manager_impl.IsLanConnected());
+  }
+}
+
+TEST(ConnectivityManagerImpl, UsesStateReportedByNetworkMonitor) {
+  MockSharingPlatform sharing_platform;
+  auto network_monitor = std::make_unique<MockNetworkMonitor>();
+  MockNetworkMonitor* mock_network_monitor = network_monitor.get();
+  std::function<void(MockNetworkMonitor::ConnectionType, bool)> callback;
+  EXPECT_CALL(sharing_platform, CreateNetworkMonitor(_))
+      .WillOnce(DoAll(SaveArg<0>(&callback),
+                      Return(ByMove(std::move(network_monitor)))));
+  EXPECT_CALL(*mock_network_monitor, GetCurrentConnection()).Times(0);
+  EXPECT_CALL(*mock_network_monitor, IsLanConnected()).Times(0);
+  ConnectivityManagerImpl connectivity_manager_impl(sharing_platform);
+  int notified = 0;
+  connectivity_manager_impl.RegisterConnectionListener(
+      "listener",
+      [&](ConnectivityManager::ConnectionType connection_type,
+          bool is_lan_connected) {
+        // Listeners see the new state through the connectivity manager too.
+        EXPECT_EQ(connectivity_manager_impl.GetConnectionType(),
+                  connection_type);
+        EXPECT_EQ(connectivity_manager_impl.IsLanConnected(),
+                  is_lan_connected);
+        notified++;
+      });
+
+  callback(MockNetworkMonitor::ConnectionType::kWifi, true);
+  callback(MockNetworkMonitor::ConnectionType::kNone, false);
+
+  EXPECT_EQ(notified, 2);
+  EXPECT_EQ(connectivity_manager_impl.GetConnectionType(),
+            ConnectivityManager::ConnectionType::kNone);
+  EXPECT_FALSE(connectivity_manager_impl.IsLanConnected());
+}
+
 TEST(ConnectivityManagerImpl, RegisterConnectionListener) {
   std::function<void(ConnectivityManager::ConnectionType, bool)> listener_1 =
       [](ConnectivityManager::ConnectionType connection_type,
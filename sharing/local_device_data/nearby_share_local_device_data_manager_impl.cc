@@ -32,6 +32,8 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "internal/platform/device_info.h"
 #include "internal/platform/implementation/account_manager.h"
 #include "internal/platform/implementation/device_info.h"
@@ -59,6 +61,7 @@ using ::google::nearby::identity::v1::PublishDeviceResponse;
 using ::nearby::api::DeviceInfo;
 using ::nearby::sharing::api::PreferenceManager;
 using ::nearby::sharing::api::SharingRpcClientFactory;
+using ::nearby::sharing::proto::PublicCertificate;
 using ::nearby::sharing::proto::UpdateDeviceRequest;
 using ::nearby::sharing::proto::UpdateDeviceResponse;
 
@@ -81,6 +84,14 @@ constexpr absl::string_view kCertificatesFieldMaskPath = "public_certificates";
 
 constexpr absl::string_view kDefaultDeviceName = "$0\'s $1";
 
+// Device name changes within this delay of the first one are merged into one
+// notification.
+constexpr absl::Duration kDeviceNameChangeDelay = absl::Milliseconds(500);
+
+// Unchanged certificates are uploaded again after this interval, in case the
+// server lost them.
+constexpr absl::Duration kMaxCertificateUploadInterval = absl::Hours(24);
+
 // Returns a truncated version of |name| that is |max_length| characters long.
 // For example, name="Reallylongname" with max_length=9 will return "Really...".
 // name="Reallylongname" with max_length=20 will return "Reallylongname".
@@ -98,6 +109,18 @@ std::string GetTruncatedName(std::string name, size_t max_length) {
   return truncated;
 }
 
+// Returns a fingerprint of the certificates uploaded for |account_id|.
+uint64_t ComputeCertificatesFingerprint(
+    absl::string_view account_id,
+    const std::vector<PublicCertificate>& certificates) {
+  std::string data(account_id);
+  for (const PublicCertificate& certificate : certificates) {
+    std::string serialized = certificate.SerializeAsString();
+    absl::StrAppend(&data, serialized.size(), ":", serialized);
+  }
+  return util_hash::HighwayFingerprint64(data);
+}
+
 }  // namespace
 
 // static
@@ -137,6 +160,7 @@ NearbyShareLocalDeviceDataManagerImpl::NearbyShareLocalDeviceDataManagerImpl(
       nearby_share_client_(rpc_client_factory->CreateInstance()),
       nearby_identity_client_(rpc_client_factory->CreateIdentityInstance()),
       device_id_(GetId()),
+      clock_(context->GetClock()),
       executor_(context->CreateSequencedTaskRunner()) {}
 
 NearbyShareLocalDeviceDataManagerImpl::
@@ -179,18 +203,44 @@ NearbyShareLocalDeviceDataManagerImpl::ValidateDeviceName(
 
 DeviceNameValidationResult NearbyShareLocalDeviceDataManagerImpl::SetDeviceName(
     absl::string_view name) {
-  if (name == GetDeviceName()) return DeviceNameValidationResult::kValid;
+  std::string previous_device_name = GetDeviceName();
+  if (name == previous_device_name) return DeviceNameValidationResult::kValid;
 
   auto error = ValidateDeviceName(name);
   if (error != DeviceNameValidationResult::kValid) return error;
 
   preference_manager_.SetString(prefs::kNearbySharingDeviceNameName, name);
 
+  {
+    absl::MutexLock lock(&mutex_);
+    if (device_name_change_pending_) {
+      return DeviceNameValidationResult::kValid;
+    }
+    device_name_change_pending_ = true;
+  }
+  executor_->PostDelayedTask(
+      kDeviceNameChangeDelay,
+      [this, previous_device_name = std::move(previous_device_name)]() {
+        NotifyDeviceNameChanged(previous_device_name);
+      });
+
+  return DeviceNameValidationResult::kValid;
+}
+
+void NearbyShareLocalDeviceDataManagerImpl::NotifyDeviceNameChanged(
+    const std::string& previous_device_name) {
+  {
+    absl::MutexLock lock(&mutex_);
+    device_name_change_pending_ = false;
+  }
+  if (GetDeviceName() == previous_device_name) {
+    LOG(INFO) << __func__ << ": device name changed back, skip to notify.";
+    return;
+  }
+
   NotifyLocalDeviceDataChanged(/*did_device_name_change=*/true,
                                /*did_full_name_change=*/false,
                                /*did_icon_change=*/false);
-
-  return DeviceNameValidationResult::kValid;
 }
 
 void NearbyShareLocalDeviceDataManagerImpl::UploadContacts(
@@ -353,13 +403,26 @@ void NearbyShareLocalDeviceDataManagerImpl::UploadCertificates(
       return;
     }
 
-    if (!account_manager_.GetCurrentAccount().has_value()) {
+    std::optional<AccountManager::Account> account =
+        account_manager_.GetCurrentAccount();
+    if (!account.has_value()) {
       LOG(WARNING) << __func__
                    << ": skip to upload certificates due "
                       "to no login account.";
       callback(/*success=*/true);
       return;
     }
+
+    uint64_t fingerprint =
+        ComputeCertificatesFingerprint(account->id, certificates);
+    if (WasCertificateUploadRecent(fingerprint)) {
+      LOG(INFO) << __func__
+                << ": skip to upload certificates unchanged since the last "
+                   "upload.";
+      callback(/*success=*/true);
+      return;
+    }
+
     UpdateDeviceRequest request;
     request.mutable_device()->set_name(
         absl::StrCat(kDeviceIdPrefix, device_id_));
@@ -368,7 +431,7 @@ void NearbyShareLocalDeviceDataManagerImpl::UploadCertificates(
     request.mutable_update_mask()->add_paths(
         std::string(kCertificatesFieldMaskPath));
     nearby_share_client_->UpdateDevice(
-        request, [this, callback = std::move(callback)](
+        request, [this, fingerprint, callback = std::move(callback)](
                      const absl::StatusOr<UpdateDeviceResponse>& response) {
           // check whether the manager is running again
           if (!is_running()) {
@@ -382,12 +445,24 @@ void NearbyShareLocalDeviceDataManagerImpl::UploadCertificates(
             LOG(WARNING)
                 << "UploadCertificates: Failed to get response from backend: "
                 << response.status();
+          } else {
+            absl::MutexLock lock(&mutex_);
+            last_certificate_upload_fingerprint_ = fingerprint;
+            last_certificate_upload_time_ = clock_->Now();
           }
           callback(/*success=*/response.ok());
         });
   });
 }
 
+bool NearbyShareLocalDeviceDataManagerImpl::WasCertificateUploadRecent(
+    uint64_t fingerprint) {
+  absl::MutexLock lock(&mutex_);
+  return last_certificate_upload_fingerprint_ == fingerprint &&
+         clock_->Now() - last_certificate_upload_time_ <
+             kMaxCertificateUploadInterval;
+}
+
 std::string NearbyShareLocalDeviceDataManagerImpl::GetDefaultDeviceName()
     const {
   std::optional<AccountManager::Account> account =
@@ -15,12 +15,17 @@
 #ifndef THIRD_PARTY_NEARBY_SHARING_LOCAL_DEVICE_DATA_NEARBY_SHARE_LOCAL_DEVICE_DATA_MANAGER_IMPL_H_
 #define THIRD_PARTY_NEARBY_SHARING_LOCAL_DEVICE_DATA_NEARBY_SHARE_LOCAL_DEVICE_DATA_MANAGER_IMPL_H_
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/clock.h"
 #include "internal/platform/device_info.h"
 #include "internal/platform/implementation/account_manager.h"
 #include "internal/platform/task_runner.h"
@@ -43,6 +48,11 @@ class NearbyShareScheduler;
 // guaranteed to be invoked. In addition to supporting on-demand device-data
 // downloads, this implementation schedules periodic downloads of device
 // data--full name and icon URL--from the server.
+//
+// Device name changes made in quick succession, as a settings UI typing a name
+// does, are merged into one observer notification, so certificates are
+// regenerated and uploaded once. Certificate uploads with the same content as
+// the last successful one are skipped for up to a day.
 class NearbyShareLocalDeviceDataManagerImpl
     : public NearbyShareLocalDeviceDataManager {
  public:
@@ -96,6 +106,16 @@ class NearbyShareLocalDeviceDataManagerImpl
   // will be truncated, for example "Mi...'s Chromebook."
   std::string GetDefaultDeviceName() const;
 
+  // Notifies observers of the device name change, unless the name was changed
+  // back to |previous_device_name| in the meantime.
+  void NotifyDeviceNameChanged(const std::string& previous_device_name)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+  // Returns whether |fingerprint| matches the last successful certificate
+  // upload, made less than the max upload interval ago.
+  bool WasCertificateUploadRecent(uint64_t fingerprint)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   nearby::sharing::api::PreferenceManager& preference_manager_;
   AccountManager& account_manager_;
   nearby::DeviceInfo& device_info_;
@@ -103,6 +123,16 @@ class NearbyShareLocalDeviceDataManagerImpl
   std::unique_ptr<nearby::sharing::api::IdentityRpcClient>
       nearby_identity_client_;
   const std::string device_id_;
+  Clock* const clock_;
+  mutable absl::Mutex mutex_;
+  // Whether a device name change notification is waiting to be sent.
+  bool device_name_change_pending_ ABSL_GUARDED_BY(mutex_) = false;
+  // Fingerprint of the account and certificates of the last successful
+  // certificate upload, and when it was made.
+  std::optional<uint64_t> last_certificate_upload_fingerprint_
+      ABSL_GUARDED_BY(mutex_);
+  absl::Time last_certificate_upload_time_ ABSL_GUARDED_BY(mutex_) =
+      absl::InfinitePast();
   std::unique_ptr<TaskRunner> executor_;
 };
 
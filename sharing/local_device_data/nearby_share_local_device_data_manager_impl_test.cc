@@ -247,6 +247,11 @@ class NearbyShareLocalDeviceDataManagerImplTest
         absl::Milliseconds(1000)));
   }
 
+  void FastForward(absl::Duration duration) {
+    context_.fake_clock()->FastForward(duration);
+    Sync();
+  }
+
  private:
   nearby::FakePreferenceManager preference_manager_;
   nearby::FakeAccountManager fake_account_manager_;
@@ -337,6 +342,7 @@ TEST_F(NearbyShareLocalDeviceDataManagerImplTest, SetDeviceName) {
   error = manager()->SetDeviceName(kFakeDeviceName);
   EXPECT_EQ(error, DeviceNameValidationResult::kValid);
   EXPECT_EQ(manager()->GetDeviceName(), kFakeDeviceName);
+  FastForward(absl::Milliseconds(500));
   EXPECT_EQ(notifications().size(), 1u);
   EXPECT_EQ(ObserverNotification(/*did_device_name_change=*/true,
                                  /*did_full_name_change=*/false,
@@ -349,6 +355,41 @@ TEST_F(NearbyShareLocalDeviceDataManagerImplTest, SetDeviceName) {
   EXPECT_EQ(manager()->GetDeviceName(), kFakeDeviceName);
 }
 
+TEST_F(NearbyShareLocalDeviceDataManagerImplTest,
+       SetDeviceName_MergesQuickChanges) {
+  CreateManager();
+
+  EXPECT_EQ(manager()->SetDeviceName("My"), DeviceNameValidationResult::kValid);
+  EXPECT_EQ(manager()->SetDeviceName("My Cool"),
+            DeviceNameValidationResult::kValid);
+  EXPECT_EQ(manager()->SetDeviceName(kFakeDeviceName),
+            DeviceNameValidationResult::kValid);
+  EXPECT_EQ(manager()->GetDeviceName(), kFakeDeviceName);
+  Sync();
+  EXPECT_TRUE(notifications().empty());
+
+  FastForward(absl::Milliseconds(500));
+  ASSERT_EQ(notifications().size(), 1u);
+  EXPECT_EQ(ObserverNotification(/*did_device_name_change=*/true,
+                                 /*did_full_name_change=*/false,
+                                 /*did_icon_change=*/false),
+            notifications().back());
+}
+
+TEST_F(NearbyShareLocalDeviceDataManagerImplTest,
+       SetDeviceName_ChangedBackIsNotNotified) {
+  CreateManager();
+  std::string device_name = manager()->GetDeviceName();
+
+  EXPECT_EQ(manager()->SetDeviceName(kFakeDeviceName),
+            DeviceNameValidationResult::kValid);
+  EXPECT_EQ(manager()->SetDeviceName(device_name),
+            DeviceNameValidationResult::kValid);
+  FastForward(absl::Milliseconds(500));
+
+  EXPECT_TRUE(notifications().empty());
+}
+
 TEST_F(NearbyShareLocalDeviceDataManagerImplTest, UploadContacts_Success) {
   CreateManager();
   UploadContacts(CreateResponse(kFakeFullName, kFakeIconUrl, kFakeIconToken));
@@ -370,6 +411,45 @@ TEST_F(NearbyShareLocalDeviceDataManagerImplTest, UploadCertificates_Failure) {
   UploadCertificates(/*response=*/absl::InternalError(""));
 }
 
+TEST_F(NearbyShareLocalDeviceDataManagerImplTest,
+       UploadCertificates_SkipsUnchangedCertificates) {
+  CreateManager();
+  UploadCertificates(
+      CreateResponse(kFakeFullName, kFakeIconUrl, kFakeIconToken));
+  ASSERT_EQ(client()->update_device_requests().size(), 1u);
+
+  std::optional<bool> returned_success;
+  manager()->UploadCertificates(
+      GetFakeCertificates(),
+      [&returned_success](bool success) { returned_success = success; });
+  Sync();
+  EXPECT_EQ(returned_success, true);
+  EXPECT_EQ(client()->update_device_requests().size(), 1u);
+
+  // Unchanged certificates are uploaded again after a day.
+  FastForward(absl::Hours(24));
+  UploadCertificates(
+      CreateResponse(kFakeFullName, kFakeIconUrl, kFakeIconToken));
+  EXPECT_EQ(client()->update_device_requests().size(), 2u);
+
+  // Changed certificates are uploaded.
+  std::vector<nearby::sharing::proto::PublicCertificate> certificates =
+      GetFakeCertificates();
+  certificates.pop_back();
+  manager()->UploadCertificates(std::move(certificates), [](bool success) {});
+  Sync();
+  EXPECT_EQ(client()->update_device_requests().size(), 3u);
+}
+
+TEST_F(NearbyShareLocalDeviceDataManagerImplTest,
+       UploadCertificates_RetriesAfterFailure) {
+  CreateManager();
+  UploadCertificates(/*response=*/absl::InternalError(""));
+  UploadCertificates(
+      CreateResponse(kFakeFullName, kFakeIconUrl, kFakeIconToken));
+  EXPECT_EQ(client()->update_device_requests().size(), 2u);
+}
+
 std::vector<nearby::sharing::proto::PublicCertificate> GetTestCertificates() {
   nearby::sharing::proto::PublicCertificate cert1;
   cert1.set_secret_id("id1");
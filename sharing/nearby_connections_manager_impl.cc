@@ -493,14 +493,17 @@ void NearbyConnectionsManagerImpl::Send(
               << endpoint_id << " to transfer manager. payload is file: "
               << payload->content.is_file() << ", is bytes "
               << payload->content.is_bytes();
+    int64_t size = payload->content.file_payload.size;
     transfer_managers_.at(endpoint_id)
-        ->Send([&, endpoint_id = std::string(endpoint_id),
-                payload_copy = *payload]() {
-          LOG(INFO) << __func__ << ": Send payload " << payload_copy.id
-                    << " to " << endpoint_id;
-          auto sent_payload = std::make_unique<Payload>(payload_copy);
-          SendWithoutDelay(endpoint_id, std::move(sent_payload));
-        });
+        ->Send(
+            [&, endpoint_id = std::string(endpoint_id),
+             payload_copy = *payload]() {
+              LOG(INFO) << __func__ << ": Send payload " << payload_copy.id
+                        << " to " << endpoint_id;
+              auto sent_payload = std::make_unique<Payload>(payload_copy);
+              SendWithoutDelay(endpoint_id, std::move(sent_payload));
+            },
+            size);
     transfer_managers_.at(endpoint_id)->StartTransfer();
     return;
   }
@@ -821,14 +824,25 @@ void NearbyConnectionsManagerImpl::ProcessUnknownFilePathsToDelete(
 
 std::optional<
     std::weak_ptr<NearbyConnectionsManagerImpl::PayloadStatusListener>>
-NearbyConnectionsManagerImpl::GetStatusListenerForId(int64_t payload_id) const {
+NearbyConnectionsManagerImpl::GetStatusListenerForUpdate(
+    const PayloadTransferUpdate& update) {
   MutexLock lock(&mutex_);
-  auto listener_it = payload_status_listeners_.find(payload_id);
+  auto listener_it = payload_status_listeners_.find(update.payload_id);
   if (listener_it == payload_status_listeners_.end()) {
     return std::nullopt;
   }
 
-  return listener_it->second;
+  std::weak_ptr<PayloadStatusListener> listener = listener_it->second;
+  switch (update.status) {
+    case PayloadStatus::kInProgress:
+      break;
+    case PayloadStatus::kSuccess:
+    case PayloadStatus::kCanceled:
+    case PayloadStatus::kFailure:
+      payload_status_listeners_.erase(listener_it);
+      break;
+  }
+  return listener;
 }
 
 NearbyConnectionImpl* NearbyConnectionsManagerImpl::GetConnectionForId(
@@ -839,35 +853,27 @@ NearbyConnectionImpl* NearbyConnectionsManagerImpl::GetConnectionForId(
   return connection_it->second.get();
 }
 
-void NearbyConnectionsManagerImpl::RemoveStatusListenerForPayloadId(
-    int64_t payload_id) {
-  MutexLock lock(&mutex_);
-  payload_status_listeners_.erase(payload_id);
-}
-
 void NearbyConnectionsManagerImpl::OnPayloadTransferUpdate(
     absl::string_view endpoint_id, const PayloadTransferUpdate& update) {
-  LOG(INFO) << "Received payload transfer update id=" << update.payload_id
+  // Updates in progress arrive for every chunk of a payload.
+  if (update.status == PayloadStatus::kInProgress) {
+    VLOG(1) << "Received payload transfer update id=" << update.payload_id
             << ",status=" << PayloadStatusToString(update.status)
             << ",total=" << update.total_bytes
             << ",bytes_transferred=" << update.bytes_transferred;
+  } else {
+    LOG(INFO) << "Received payload transfer update id=" << update.payload_id
+              << ",status=" << PayloadStatusToString(update.status)
+              << ",total=" << update.total_bytes
+              << ",bytes_transferred=" << update.bytes_transferred;
+  }
 
   // If this is a payload we've registered for, then forward its status to
   // the PayloadStatusListener if it still exists. We don't need to do
   // anything more with the payload.
   std::optional<std::weak_ptr<PayloadStatusListener>> listener =
-      GetStatusListenerForId(update.payload_id);
+      GetStatusListenerForUpdate(update);
   if (listener.has_value()) {
-    switch (update.status) {
-      case PayloadStatus::kInProgress:
-        break;
-      case PayloadStatus::kSuccess:
-      case PayloadStatus::kCanceled:
-      case PayloadStatus::kFailure:
-        RemoveStatusListenerForPayloadId(update.payload_id);
-        break;
-    }
-
     // Note: The listener might be invalidated, for example, if it is shared
     // with another payload in the same transfer.
     if (auto status_listener = listener->lock()) {
@@ -132,13 +132,13 @@ class NearbyConnectionsManagerImpl : public NearbyConnectionsManager {
   void DeleteUnknownFilePayloadAndCancel(Payload& payload);
   absl::flat_hash_set<std::filesystem::path> GetUnknownFilePathsToDelete();
 
-  std::optional<std::weak_ptr<PayloadStatusListener>> GetStatusListenerForId(
-      int64_t payload_id) const ABSL_LOCKS_EXCLUDED(mutex_);
-
-  NearbyConnectionImpl* GetConnectionForId(absl::string_view endpoint_id) const
+  // Returns the listener registered for the payload of `update`, if any, and
+  // unregisters it if `update` is final.
+  std::optional<std::weak_ptr<PayloadStatusListener>>
+  GetStatusListenerForUpdate(const PayloadTransferUpdate& update)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
-  void RemoveStatusListenerForPayloadId(int64_t payload_id)
+  NearbyConnectionImpl* GetConnectionForId(absl::string_view endpoint_id) const
       ABSL_LOCKS_EXCLUDED(mutex_);
 
   void Reset();
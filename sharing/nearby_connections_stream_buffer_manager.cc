@@ -16,7 +16,9 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
 #include <utility>
@@ -39,12 +41,17 @@ NearbyConnectionsStreamBufferManager::~NearbyConnectionsStreamBufferManager() =
     default;
 
 void NearbyConnectionsStreamBufferManager::StartTrackingPayload(
-    NcPayload payload) {
+    NcPayload payload, std::optional<int64_t> total_size) {
   int64_t payload_id = payload.GetId();
   NL_LOG(INFO) << "Starting to track stream payload with ID " << payload_id;
 
-  id_to_payload_with_buffer_map_[payload_id] =
+  auto payload_with_buffer =
       std::make_unique<PayloadWithBuffer>(std::move(payload));
+  if (total_size.has_value() && *total_size > 0) {
+    payload_with_buffer->buffer.reserve(
+        std::min(*total_size, kMaxReservedSizeBytes));
+  }
+  id_to_payload_with_buffer_map_[payload_id] = std::move(payload_with_buffer);
 }
 
 bool NearbyConnectionsStreamBufferManager::IsTrackingPayload(
@@ -72,6 +79,10 @@ void NearbyConnectionsStreamBufferManager::HandleBytesTransferred(
 
   // We only need to read the new bytes which have not already been inserted
   // into the buffer.
+  if (cumulative_bytes_transferred_so_far <=
+      static_cast<int64_t>(payload_with_buffer->buffer.size())) {
+    return;
+  }
   size_t bytes_to_read =
       cumulative_bytes_transferred_so_far - payload_with_buffer->buffer.size();
 
@@ -83,19 +94,27 @@ void NearbyConnectionsStreamBufferManager::HandleBytesTransferred(
     return;
   }
 
-  NcExceptionOr<NcByteArray> bytes = stream->Read(bytes_to_read);
-  if (!bytes.ok()) {
-    NL_LOG(ERROR) << "Payload with ID " << payload_id << " encountered "
-                  << "exception while reading; transfer has failed.";
-    StopTrackingFailedPayload(payload_id);
-    return;
+  // Read in bounded chunks which are appended to the buffer right away, so
+  // that at most one chunk exists outside of the buffer.
+  while (bytes_to_read > 0) {
+    NcExceptionOr<NcByteArray> bytes =
+        stream->Read(std::min(bytes_to_read, kMaxReadSizeBytes));
+    if (!bytes.ok()) {
+      NL_LOG(ERROR) << "Payload with ID " << payload_id << " encountered "
+                    << "exception while reading; transfer has failed.";
+      StopTrackingFailedPayload(payload_id);
+      return;
+    }
+    // Empty `bytes` means the End Of File. There should be at `bytes_to_read`
+    // bytes available in the input stream, so we should never face the EOF
+    // condition.
+    NL_DCHECK(!bytes.result().Empty());
+    if (bytes.result().Empty()) return;
+
+    payload_with_buffer->buffer.append(bytes.result().data(),
+                                       bytes.result().size());
+    bytes_to_read -= std::min(bytes_to_read, bytes.result().size());
   }
-  // Empty `bytes` means the End Of File. There should be at `bytes_to_read`
-  // bytes available in the input stream, so we should never face the EOF
-  // condition.
-  NL_DCHECK(!bytes.result().Empty());
-
-  payload_with_buffer->buffer += static_cast<std::string>(bytes.result());
 }
 
 NcByteArray
@@ -108,7 +127,7 @@ NearbyConnectionsStreamBufferManager::GetCompletePayloadAndStopTracking(
     return NcByteArray();
   }
 
-  NcByteArray complete_payload(it->second->buffer);
+  NcByteArray complete_payload(std::move(it->second->buffer));
 
   // Close stream and erase internal state before returning payload.
   it->second->buffer_payload.AsStream()->Close();
@@ -15,9 +15,11 @@
 #ifndef THIRD_PARTY_NEARBY_SHARING_NEARBY_CONNECTIONS_STREAM_BUFFER_MANAGER_H_
 #define THIRD_PARTY_NEARBY_SHARING_NEARBY_CONNECTIONS_STREAM_BUFFER_MANAGER_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
@@ -52,11 +54,21 @@ using NcPayload = ::nearby::connections::Payload;
 // buffer.
 class NearbyConnectionsStreamBufferManager {
  public:
+  // The most bytes read from a stream at once, so that a large transfer update
+  // doesn't allocate a second copy of the bytes next to the buffer.
+  static constexpr size_t kMaxReadSizeBytes = 1024 * 1024;
+
+  // The most bytes reserved up front for a payload's buffer. A larger payload
+  // grows its buffer as bytes arrive.
+  static constexpr int64_t kMaxReservedSizeBytes = 64 * 1024 * 1024;
+
   NearbyConnectionsStreamBufferManager();
   ~NearbyConnectionsStreamBufferManager();
 
-  // Starts tracking the given payload.
-  void StartTrackingPayload(NcPayload payload);
+  // Starts tracking the given payload. If |total_size| is known, the buffer
+  // is allocated for it once instead of growing with every transfer update.
+  void StartTrackingPayload(NcPayload payload,
+                            std::optional<int64_t> total_size = std::nullopt);
 
   // Returns whether a payload with the provided ID is being tracked.
   bool IsTrackingPayload(int64_t payload_id) const;
@@ -79,7 +91,7 @@ class NearbyConnectionsStreamBufferManager {
     NcPayload buffer_payload;
 
     // Partially-complete buffer which contains the bytes which have been read
-    // up to this point.
+    // up to this point. Moved into the complete payload.
     std::string buffer;
   };
 
@@ -16,6 +16,7 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -39,6 +40,7 @@ class FakeStream : public NcInputStream {
     if (should_throw_exception_) {
       return NcException::kIo;
     }
+    max_read_size_ = std::max(max_read_size_, size);
     return NcExceptionOr<NcByteArray>(NcByteArray(std::string(size, '\0')));
   }
 
@@ -57,6 +59,7 @@ class FakeStream : public NcInputStream {
   }
 
   bool should_throw_exception_ = false;
+  std::int64_t max_read_size_ = 0;
 };
 
 }  // namespace
@@ -172,5 +175,64 @@ TEST_F(NearbyConnectionsStreamBufferManagerTest, SingleStreamCheckException) {
   EXPECT_FALSE(buffer_manager_.IsTrackingPayload(/*payload_id=*/1));
 }
 
+TEST_F(NearbyConnectionsStreamBufferManagerTest,
+       LargeTransferIsReadInBoundedChunks) {
+  CreatePayloadStreamResult payload_and_stream =
+      CreatePayload(/*payload_id=*/1);
+  constexpr size_t kPayloadSize =
+      NearbyConnectionsStreamBufferManager::kMaxReadSizeBytes * 3 + 10;
+
+  buffer_manager_.StartTrackingPayload(std::move(payload_and_stream.payload));
+  buffer_manager_.HandleBytesTransferred(
+      /*payload_id=*/1,
+      /*cumulative_bytes_transferred_so_far=*/kPayloadSize);
+
+  EXPECT_EQ(static_cast<size_t>(payload_and_stream.stream->max_read_size_),
+            NearbyConnectionsStreamBufferManager::kMaxReadSizeBytes);
+  NcByteArray array =
+      buffer_manager_.GetCompletePayloadAndStopTracking(/*payload_id=*/1);
+  EXPECT_EQ(array.size(), kPayloadSize);
+}
+
+TEST_F(NearbyConnectionsStreamBufferManagerTest,
+       SingleStreamTrackingWithTotalSize) {
+  CreatePayloadStreamResult payload_and_stream =
+      CreatePayload(/*payload_id=*/1);
+
+  buffer_manager_.StartTrackingPayload(std::move(payload_and_stream.payload),
+                                       /*total_size=*/2500);
+  EXPECT_TRUE(buffer_manager_.IsTrackingPayload(/*payload_id=*/1));
+
+  buffer_manager_.HandleBytesTransferred(
+      /*payload_id=*/1,
+      /*cumulative_bytes_transferred_so_far=*/1980);
+  buffer_manager_.HandleBytesTransferred(
+      /*payload_id=*/1,
+      /*cumulative_bytes_transferred_so_far=*/2500);
+
+  NcByteArray array =
+      buffer_manager_.GetCompletePayloadAndStopTracking(/*payload_id=*/1);
+  EXPECT_EQ(array.size(), 2500u);
+}
+
+TEST_F(NearbyConnectionsStreamBufferManagerTest,
+       RepeatedTransferUpdateReadsNothing) {
+  CreatePayloadStreamResult payload_and_stream =
+      CreatePayload(/*payload_id=*/1);
+
+  buffer_manager_.StartTrackingPayload(std::move(payload_and_stream.payload));
+  buffer_manager_.HandleBytesTransferred(
+      /*payload_id=*/1,
+      /*cumulative_bytes_transferred_so_far=*/1980);
+  buffer_manager_.HandleBytesTransferred(
+      /*payload_id=*/1,
+      /*cumulative_bytes_transferred_so_far=*/1980);
+
+  EXPECT_TRUE(buffer_manager_.IsTrackingPayload(/*payload_id=*/1));
+  NcByteArray array =
+      buffer_manager_.GetCompletePayloadAndStopTracking(/*payload_id=*/1);
+  EXPECT_EQ(array.size(), 1980u);
+}
+
 }  // namespace sharing
 }  // namespace nearby
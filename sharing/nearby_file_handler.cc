@@ -14,7 +14,9 @@
 
 #include "sharing/nearby_file_handler.h"
 
+#include <stddef.h>
 #include <stdint.h>
+
 #include <filesystem>  // NOLINT(build/c++17)
 #include <functional>
 #include <memory>
@@ -23,10 +25,12 @@
 #include <vector>
 
 #include "absl/functional/any_invocable.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "internal/base/files.h"
+#include "internal/platform/task_runner.h"
 #include "internal/platform/task_runner_impl.h"
 #include "sharing/common/compatible_u8_string.h"
 #include "sharing/internal/api/sharing_platform.h"
@@ -38,18 +42,38 @@ namespace {
 
 using ::nearby::sharing::api::SharingPlatform;
 
-// Called on the FileTaskRunner to actually open the files passed.
+// Number of files opened at the same time. Opening a file on a network or
+// removable drive mostly waits on the device, so a share of many files is
+// opened in batches instead of one file after the other.
+constexpr uint32_t kMaxConcurrentFileOpens = 4;
+
+// Called on the FileTaskRunner to actually open the files passed. The files
+// are opened on |open_task_runner| and returned in the order of |file_paths|.
 std::vector<NearbyFileHandler::FileInfo> DoOpenFiles(
+    TaskRunner& open_task_runner,
     absl::Span<const std::filesystem::path> file_paths) {
+  std::vector<std::optional<uintmax_t>> sizes(file_paths.size());
+  absl::BlockingCounter pending_opens(file_paths.size());
+  for (size_t i = 0; i < file_paths.size(); ++i) {
+    auto open_file = [&sizes, &pending_opens, &file_paths, i]() {
+      sizes[i] = GetFileSize(file_paths[i]);
+      pending_opens.DecrementCount();
+    };
+    if (!open_task_runner.PostTask(open_file)) {
+      open_file();
+    }
+  }
+  pending_opens.Wait();
+
   std::vector<NearbyFileHandler::FileInfo> files;
-  for (const auto& file_path : file_paths) {
-    std::optional<uintmax_t> size = GetFileSize(file_path);
-    if (!size.has_value()) {
+  files.reserve(file_paths.size());
+  for (size_t i = 0; i < file_paths.size(); ++i) {
+    if (!sizes[i].has_value()) {
       NL_LOG(ERROR) << __func__ << ": Failed to open file. File="
-                    << GetCompatibleU8String(file_path.u8string());
+                    << GetCompatibleU8String(file_paths[i].u8string());
       return {};
     }
-    files.push_back({*size, file_path});
+    files.push_back({*sizes[i], file_paths[i]});
   }
   return files;
 }
@@ -58,6 +82,7 @@ std::vector<NearbyFileHandler::FileInfo> DoOpenFiles(
 
 NearbyFileHandler::NearbyFileHandler(SharingPlatform& platform)
     : platform_(platform) {
+  open_task_runner_ = std::make_unique<TaskRunnerImpl>(kMaxConcurrentFileOpens);
   sequenced_task_runner_ = std::make_unique<TaskRunnerImpl>(1);
 }
 
@@ -66,8 +91,9 @@ NearbyFileHandler::~NearbyFileHandler() = default;
 void NearbyFileHandler::OpenFiles(std::vector<std::filesystem::path> file_paths,
                                   OpenFilesCallback callback) {
   sequenced_task_runner_->PostTask(
-      [callback = std::move(callback), file_paths = std::move(file_paths)]() {
-        auto opened_files = DoOpenFiles(file_paths);
+      [this, callback = std::move(callback),
+       file_paths = std::move(file_paths)]() {
+        auto opened_files = DoOpenFiles(*open_task_runner_, file_paths);
         callback(opened_files);
       });
 }
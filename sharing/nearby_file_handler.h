@@ -45,7 +45,8 @@ class NearbyFileHandler {
   ~NearbyFileHandler();
 
   // Open the files given in |file_paths| and return the opened files sizes via
-  // |callback|. If any file fails to open, return an empty list.
+  // |callback|, in the order of |file_paths|. The files are opened in parallel.
+  // If any file fails to open, return an empty list.
   void OpenFiles(std::vector<std::filesystem::path> file_paths,
                  OpenFilesCallback callback);
 
@@ -60,6 +61,9 @@ class NearbyFileHandler {
 
  private:
   nearby::sharing::api::SharingPlatform& platform_;
+  // Opens the files of OpenFiles() in parallel. Declared before
+  // |sequenced_task_runner_|, which waits on it, so that it outlives it.
+  std::unique_ptr<TaskRunner> open_task_runner_;
   std::unique_ptr<TaskRunner> sequenced_task_runner_;
 };
 
@@ -17,9 +17,11 @@
 #include <atomic>
 #include <cstdio>
 #include <filesystem>  // NOLINT(build/c++17)
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -31,11 +33,13 @@ namespace sharing {
 namespace {
 using ::nearby::sharing::api::MockSharingPlatform;
 
-bool CreateFile(std::filesystem::path file_path) {
+bool CreateFile(std::filesystem::path file_path,
+                absl::string_view content = "") {
   std::FILE* file = std::fopen(file_path.string().c_str(), "w+");
   if (file == nullptr) {
     return false;
   }
+  std::fwrite(content.data(), 1, content.size(), file);
   std::fclose(file);
   return true;
 }
@@ -61,6 +65,60 @@ TEST(NearbyFileHandler, OpenFiles) {
   ASSERT_TRUE(RemoveFile(test_file));
 }
 
+TEST(NearbyFileHandler, OpenFilesKeepsTheOrderOfThePaths) {
+  MockSharingPlatform mock_platform;
+  NearbyFileHandler nearby_file_handler(mock_platform);
+  absl::Notification notification;
+  std::vector<NearbyFileHandler::FileInfo> result;
+  std::vector<std::filesystem::path> file_paths;
+  for (int i = 0; i < 10; ++i) {
+    std::filesystem::path test_file =
+        std::filesystem::temp_directory_path() /
+        ("nearby_nfh_test_" + std::to_string(i) + ".txt");
+    ASSERT_TRUE(CreateFile(test_file, std::string(i, 'a')));
+    file_paths.push_back(test_file);
+  }
+
+  nearby_file_handler.OpenFiles(
+      file_paths, [&result, &notification](
+                      std::vector<NearbyFileHandler::FileInfo> file_infos) {
+        result = file_infos;
+        notification.Notify();
+      });
+
+  ASSERT_TRUE(notification.WaitForNotificationWithTimeout(absl::Seconds(1)));
+  ASSERT_EQ(result.size(), file_paths.size());
+  for (size_t i = 0; i < file_paths.size(); ++i) {
+    EXPECT_EQ(result[i].file_path, file_paths[i]);
+    EXPECT_EQ(result[i].size, i);
+    ASSERT_TRUE(RemoveFile(file_paths[i]));
+  }
+}
+
+TEST(NearbyFileHandler, OpenFilesFailsIfAFileIsMissing) {
+  MockSharingPlatform mock_platform;
+  NearbyFileHandler nearby_file_handler(mock_platform);
+  absl::Notification notification;
+  std::vector<NearbyFileHandler::FileInfo> result;
+  std::filesystem::path test_file =
+      std::filesystem::temp_directory_path() / "nearby_nfh_test_abc.jpg";
+  std::filesystem::path missing_file =
+      std::filesystem::temp_directory_path() / "nearby_nfh_test_missing.jpg";
+  ASSERT_TRUE(CreateFile(test_file));
+
+  nearby_file_handler.OpenFiles(
+      {test_file, missing_file},
+      [&result, &notification](
+          std::vector<NearbyFileHandler::FileInfo> file_infos) {
+        result = file_infos;
+        notification.Notify();
+      });
+
+  ASSERT_TRUE(notification.WaitForNotificationWithTimeout(absl::Seconds(1)));
+  EXPECT_TRUE(result.empty());
+  ASSERT_TRUE(RemoveFile(test_file));
+}
+
 TEST(NearbyFileHandler, DeleteAFileFromDisk) {
   MockSharingPlatform mock_platform;
   NearbyFileHandler nearby_file_handler(mock_platform);
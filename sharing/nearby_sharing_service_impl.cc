@@ -52,6 +52,7 @@
 #include "internal/platform/implementation/account_manager.h"
 #include "internal/platform/implementation/device_info.h"
 #include "internal/platform/task_runner.h"
+#include "internal/platform/trace_event.h"
 #include "proto/sharing_enums.pb.h"
 #include "sharing/advertisement.h"
 #include "sharing/analytics/analytics_information.h"
@@ -135,6 +136,13 @@ constexpr absl::Duration kProcessNetworkChangeTimerDelay = absl::Seconds(1);
 // nearby is sharing" notification to appear again.
 constexpr absl::Duration kFastInitiationScannerCooldown = absl::Seconds(8);
 
+// When duty cycling fast initiation scanning, the length of a scan window, and
+// the bounds of the pause after it. The pause doubles after every window
+// without a detection, and goes back to the minimum on a detection.
+constexpr absl::Duration kFastInitiationScanWindow = absl::Seconds(10);
+constexpr absl::Duration kFastInitiationScanPauseMin = absl::Seconds(10);
+constexpr absl::Duration kFastInitiationScanPauseMax = absl::Minutes(2);
+
 // The maximum number of certificate downloads that can be performed during a
 // discovery session.
 // Assuming a 2min discovery session and 10s download interval.
@@ -146,6 +154,16 @@ constexpr size_t kMaxCertificateDownloadsDuringDiscovery = 12u;
 constexpr absl::Duration kCertificateDownloadDuringDiscoveryPeriod =
     absl::Seconds(10);
 
+// How long a certificate decrypted for a discovered advertisement is reused,
+// and how many are kept.
+constexpr absl::Duration kDecryptedCertificateCacheExpiry = absl::Minutes(15);
+constexpr size_t kMaxDecryptedCertificateCacheSize = 64u;
+
+// How long after the service is created the contact and certificate managers
+// are started, when their startup is deferred and the service is not used
+// before.
+constexpr absl::Duration kDeferredManagerStartupDelay = absl::Seconds(10);
+
 constexpr absl::string_view kConnectionListenerName = "nearby-share-service";
 constexpr absl::string_view kScreenStateListenerName = "nearby-share-service";
 constexpr absl::string_view kProfileRelativePath = "Google/Nearby/Sharing";
@@ -171,6 +189,15 @@ NearbySharingService::Observer::AdapterState MapAdapterState(bool is_present,
   return state;
 }
 
+// An advertisement's salt and encrypted metadata key identify the
+// certificate that decrypts it.
+std::string DecryptedCertificateCacheKey(const Advertisement& advertisement) {
+  std::string key(advertisement.salt().begin(), advertisement.salt().end());
+  key.append(advertisement.encrypted_metadata_key().begin(),
+             advertisement.encrypted_metadata_key().end());
+  return key;
+}
+
 OSType ToProtoOsType(::nearby::api::DeviceInfo::OsType os_type) {
   switch (os_type) {
     case ::nearby::api::DeviceInfo::OsType::kAndroid:
@@ -225,6 +252,7 @@ NearbySharingServiceImpl::NearbySharingServiceImpl(
   CHECK(analytics_recorder);
 
   is_shutting_down_ = std::make_unique<bool>(false);
+  service_creation_time_ = context_->GetClock()->Now();
   std::filesystem::path path = device_info_.GetAppDataPath();
 
   std::filesystem::path full_database_path =
@@ -261,8 +289,18 @@ NearbySharingServiceImpl::NearbySharingServiceImpl(
   nearby_connections_manager_->SetCustomSavePath(custom_save_path);
 
   local_device_data_manager_->Start();
-  contact_manager_->Start();
-  certificate_manager_->Start();
+  if (NearbyFlags::GetInstance().GetBoolFlag(
+          config_package_nearby::nearby_sharing_feature::
+              kEnableDeferredManagerStartup)) {
+    deferred_manager_startup_timer_ = std::make_unique<ThreadTimer>(
+        *service_thread_, "deferred_manager_startup_timer",
+        kDeferredManagerStartupDelay,
+        [this]() { StartDeferredManagers("startup delay"); });
+  } else {
+    contact_manager_->Start();
+    certificate_manager_->Start();
+    are_deferred_managers_started_ = true;
+  }
   update_file_paths_in_progress_ = false;
 
   SetupBluetoothAdapter();
@@ -284,6 +322,7 @@ void NearbySharingServiceImpl::Shutdown(
 
         StopAdvertising();
         StopFastInitiationScanning();
+        ResetFastInitiationDutyCycle();
         StopFastInitiationAdvertising();
         StopScanning();
         nearby_connections_manager_->Shutdown();
@@ -298,6 +337,7 @@ void NearbySharingServiceImpl::Shutdown(
         nearby_fast_initiation_->RemoveObserver(this);
 
         on_network_changed_delay_timer_.reset();
+        deferred_manager_startup_timer_.reset();
 
         foreground_receive_callbacks_map_.clear();
         background_receive_callbacks_map_.clear();
@@ -315,6 +355,28 @@ void NearbySharingServiceImpl::Shutdown(
       });
 }
 
+void NearbySharingServiceImpl::StartDeferredManagers(
+    absl::string_view reason) {
+  if (are_deferred_managers_started_ || IsShuttingDown()) {
+    return;
+  }
+  are_deferred_managers_started_ = true;
+  deferred_manager_startup_timer_.reset();
+
+  Clock* clock = context_->GetClock();
+  absl::Time start_time = clock->Now();
+  contact_manager_->Start();
+  absl::Time contact_manager_started_time = clock->Now();
+  certificate_manager_->Start();
+  absl::Time certificate_manager_started_time = clock->Now();
+  LOG(INFO) << __func__ << ": Started on " << reason << ", "
+            << start_time - service_creation_time_
+            << " after service creation; contact manager took "
+            << contact_manager_started_time - start_time
+            << ", certificate manager took "
+            << certificate_manager_started_time - contact_manager_started_time;
+}
+
 bool NearbySharingServiceImpl::IsShuttingDown() {
   return (is_shutting_down_ == nullptr || *is_shutting_down_);
 }
@@ -326,6 +388,7 @@ void NearbySharingServiceImpl::Cleanup() {
 
   DisableAllOutgoingShareTargets();
   discovery_cache_.clear();
+  decrypted_certificate_cache_.clear();
   for (auto& it : incoming_share_session_map_) {
     it.second.OnDisconnect();
   }
@@ -338,6 +401,7 @@ void NearbySharingServiceImpl::Cleanup() {
 
   discovered_advertisements_to_retry_map_.clear();
   discovered_advertisements_retried_set_.clear();
+  pending_share_target_upgrades_.clear();
 
   foreground_send_surface_map_.clear();
   background_send_surface_map_.clear();
@@ -414,6 +478,7 @@ void NearbySharingServiceImpl::RegisterSendSurface(
         }
         DCHECK(transfer_callback);
         DCHECK(discovery_callback);
+        StartDeferredManagers("send surface registered");
         LOG(INFO) << __func__ << ": RegisterSendSurface is called with state: "
                   << (state == SendSurfaceState::kForeground ? "Foreground"
                                                              : "Background")
@@ -573,6 +638,7 @@ void NearbySharingServiceImpl::RegisterReceiveSurface(
           return;
         }
         DCHECK(transfer_callback);
+        StartDeferredManagers("receive surface registered");
 
         LOG(INFO) << __func__
                   << ": RegisterReceiveSurface is called with state: "
@@ -1038,6 +1104,8 @@ AccountManager* NearbySharingServiceImpl::GetAccountManager() {
 void NearbySharingServiceImpl::OnIncomingConnection(
     absl::string_view endpoint_id, absl::Span<const uint8_t> endpoint_info,
     NearbyConnection* connection) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("sharing", "Incoming connection",
+                               TraceFlowIdForEndpoint(endpoint_id));
   DCHECK(connection);
 
   app_info_->SetActiveFlag();
@@ -1322,6 +1390,8 @@ void NearbySharingServiceImpl::OnVisibilityChanged(
 
 // NearbyShareCertificateManager::Observer:
 void NearbySharingServiceImpl::OnPublicCertificatesDownloaded() {
+  // The downloaded certificates may no longer include the cached ones.
+  decrypted_certificate_cache_.clear();
   if (!is_scanning_ || discovered_advertisements_to_retry_map_.empty()) {
     return;
   }
@@ -1657,6 +1727,8 @@ void NearbySharingServiceImpl::AddEndpointDiscoveryEvent(
 void NearbySharingServiceImpl::HandleEndpointDiscovered(
     absl::Time start_time, absl::string_view endpoint_id,
     absl::Span<const uint8_t> endpoint_info) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("sharing", "Endpoint discovered",
+                               TraceFlowIdForEndpoint(endpoint_id));
   VLOG(1) << __func__ << ": endpoint_id=" << endpoint_id
           << ", endpoint_info=" << nearby::utils::HexEncode(endpoint_info)
           << " time: " << start_time;
@@ -1685,9 +1757,64 @@ void NearbySharingServiceImpl::HandleEndpointDiscovered(
   NearbyShareEncryptedMetadataKey encrypted_metadata_key(
       advertisement->salt(), advertisement->encrypted_metadata_key());
 
+  std::optional<NearbyShareDecryptedPublicCertificate> cached_certificate =
+      GetCachedDecryptedCertificate(*advertisement);
+  if (cached_certificate.has_value()) {
+    VLOG(1) << __func__
+            << ": Reusing the certificate decrypted earlier for endpoint_id="
+            << endpoint_id;
+    OnOutgoingDecryptedCertificate(endpoint_id, endpoint_info, *advertisement,
+                                   std::move(cached_certificate));
+    return;
+  }
+
   std::string endpoint_id_copy = std::string(endpoint_id);
   std::vector<uint8_t> endpoint_info_copy{endpoint_info.begin(),
                                           endpoint_info.end()};
+
+  // A device advertising its name can be shown before its certificate is
+  // decrypted. Endpoints already reported take the regular path, which
+  // updates their share target.
+  if (NearbyFlags::GetInstance().GetBoolFlag(
+          config_package_nearby::nearby_sharing_feature::
+              kEnableProvisionalShareTargets) &&
+      advertisement->device_name().has_value() &&
+      !outgoing_share_target_map_.contains(endpoint_id)) {
+    std::optional<ShareTarget> share_target =
+        CreateShareTarget(endpoint_id, *advertisement,
+                          /*certificate=*/std::nullopt, /*is_incoming=*/false);
+    if (share_target.has_value()) {
+      ReportOutgoingShareTarget(endpoint_id, *std::move(share_target),
+                                /*certificate=*/std::nullopt);
+      uint64_t upgrade_id = ++next_share_target_upgrade_id_;
+      pending_share_target_upgrades_[endpoint_id] = upgrade_id;
+      // The decryption doesn't hold up the next discovery events.
+      GetCertificateManager()->GetDecryptedPublicCertificate(
+          std::move(encrypted_metadata_key),
+          [this, start_time, endpoint_id_copy, endpoint_info_copy, upgrade_id,
+           advertisement_copy = *advertisement](
+              std::optional<NearbyShareDecryptedPublicCertificate>
+                  decrypted_public_certificate) {
+            RunOnNearbySharingServiceThread(
+                "provisional_share_target_certificate",
+                [this, start_time, endpoint_id_copy, endpoint_info_copy,
+                 upgrade_id, advertisement_copy,
+                 decrypted_public_certificate]() {
+                  LOG(INFO) << "Decrypted public certificate of provisional "
+                               "share target, success: "
+                            << decrypted_public_certificate.has_value()
+                            << ", latency: "
+                            << context_->GetClock()->Now() - start_time;
+                  OnProvisionalShareTargetCertificate(
+                      endpoint_id_copy, endpoint_info_copy, advertisement_copy,
+                      upgrade_id, decrypted_public_certificate);
+                });
+          });
+      FinishEndpointDiscoveryEvent();
+      return;
+    }
+  }
+
   GetCertificateManager()->GetDecryptedPublicCertificate(
       std::move(encrypted_metadata_key),
       [this, start_time, endpoint_id_copy, endpoint_info_copy,
@@ -1723,6 +1850,7 @@ void NearbySharingServiceImpl::HandleEndpointLost(
 
   discovered_advertisements_to_retry_map_.erase(endpoint_id);
   discovered_advertisements_retried_set_.erase(endpoint_id);
+  pending_share_target_upgrades_.erase(endpoint_id);
   MoveToDiscoveryCache(std::string(endpoint_id),
                        NearbyFlags::GetInstance().GetInt64Flag(
                            config_package_nearby::nearby_sharing_feature::
@@ -1774,35 +1902,120 @@ void NearbySharingServiceImpl::OnOutgoingDecryptedCertificate(
     FinishEndpointDiscoveryEvent();
     return;
   }
-  if (FindDuplicateInOutgoingShareTargets(endpoint_id, *share_target)) {
-    DeduplicateInOutgoingShareTarget(*share_target, endpoint_id,
+  if (certificate.has_value()) {
+    CacheDecryptedCertificate(advertisement, *certificate);
+  }
+  // A certificate decrypted by the regular path supersedes a pending upgrade.
+  pending_share_target_upgrades_.erase(endpoint_id);
+  ReportOutgoingShareTarget(endpoint_id, *std::move(share_target),
+                            std::move(certificate));
+  FinishEndpointDiscoveryEvent();
+}
+
+void NearbySharingServiceImpl::OnProvisionalShareTargetCertificate(
+    absl::string_view endpoint_id, absl::Span<const uint8_t> endpoint_info,
+    const Advertisement& advertisement, uint64_t upgrade_id,
+    std::optional<NearbyShareDecryptedPublicCertificate> certificate) {
+  auto it = pending_share_target_upgrades_.find(endpoint_id);
+  if (it == pending_share_target_upgrades_.end() || it->second != upgrade_id) {
+    VLOG(1) << __func__ << ": Ignoring stale certificate decryption for "
+            << "endpoint_id=" << endpoint_id;
+    return;
+  }
+  pending_share_target_upgrades_.erase(it);
+
+  if (!certificate.has_value()) {
+    // The target stays an unknown device, unless a later certificate download
+    // decrypts the advertisement.
+    if (!discovered_advertisements_retried_set_.contains(endpoint_id)) {
+      discovered_advertisements_to_retry_map_[endpoint_id] =
+          std::vector<uint8_t>(endpoint_info.begin(), endpoint_info.end());
+    }
+    return;
+  }
+  CacheDecryptedCertificate(advertisement, *certificate);
+  std::optional<ShareTarget> share_target =
+      CreateShareTarget(endpoint_id, advertisement, certificate,
+                        /*is_incoming=*/false);
+  if (!share_target.has_value() ||
+      !outgoing_share_target_map_.contains(endpoint_id)) {
+    return;
+  }
+  ReportOutgoingShareTarget(endpoint_id, *std::move(share_target),
+                            std::move(certificate));
+}
+
+std::optional<NearbyShareDecryptedPublicCertificate>
+NearbySharingServiceImpl::GetCachedDecryptedCertificate(
+    const Advertisement& advertisement) {
+  auto it = decrypted_certificate_cache_.find(
+      DecryptedCertificateCacheKey(advertisement));
+  if (it == decrypted_certificate_cache_.end()) {
+    return std::nullopt;
+  }
+  absl::Time now = context_->GetClock()->Now();
+  if (now >= it->second.expiry || now >= it->second.certificate.not_after()) {
+    decrypted_certificate_cache_.erase(it);
+    return std::nullopt;
+  }
+  return it->second.certificate;
+}
+
+void NearbySharingServiceImpl::CacheDecryptedCertificate(
+    const Advertisement& advertisement,
+    const NearbyShareDecryptedPublicCertificate& certificate) {
+  if (!NearbyFlags::GetInstance().GetBoolFlag(
+          config_package_nearby::nearby_sharing_feature::
+              kEnableDecryptedCertificateCache)) {
+    return;
+  }
+  absl::Time now = context_->GetClock()->Now();
+  if (decrypted_certificate_cache_.size() >=
+      kMaxDecryptedCertificateCacheSize) {
+    absl::erase_if(decrypted_certificate_cache_, [now](const auto& entry) {
+      return now >= entry.second.expiry;
+    });
+    if (decrypted_certificate_cache_.size() >=
+        kMaxDecryptedCertificateCacheSize) {
+      decrypted_certificate_cache_.clear();
+    }
+  }
+  decrypted_certificate_cache_.insert_or_assign(
+      DecryptedCertificateCacheKey(advertisement),
+      CachedCertificate{.certificate = certificate,
+                        .expiry = now + kDecryptedCertificateCacheExpiry});
+}
+
+void NearbySharingServiceImpl::ReportOutgoingShareTarget(
+    absl::string_view endpoint_id, ShareTarget share_target,
+    std::optional<NearbyShareDecryptedPublicCertificate> certificate) {
+  if (FindDuplicateInOutgoingShareTargets(endpoint_id, share_target)) {
+    DeduplicateInOutgoingShareTarget(share_target, endpoint_id,
                                       std::move(certificate));
-    FinishEndpointDiscoveryEvent();
     return;
   }
-  if (FindDuplicateInDiscoveryCache(endpoint_id, *share_target)) {
-    DeDuplicateInDiscoveryCache(*share_target, endpoint_id,
+  if (FindDuplicateInDiscoveryCache(endpoint_id, share_target)) {
+    DeDuplicateInDiscoveryCache(share_target, endpoint_id,
                                 std::move(certificate));
-    FinishEndpointDiscoveryEvent();
     return;
   }
 
   VLOG(1) << __func__ << ": Adding (endpoint_id=" << endpoint_id
-          << ", share_target_id=" << share_target->id
+          << ", share_target_id=" << share_target.id
           << ") to outgoing share target map";
-  outgoing_share_target_map_.insert_or_assign(endpoint_id, *share_target);
-  CreateOutgoingShareSession(*share_target, endpoint_id,
+  outgoing_share_target_map_.insert_or_assign(endpoint_id, share_target);
+  CreateOutgoingShareSession(share_target, endpoint_id,
                              std::move(certificate));
 
   // Update the endpoint id for the share target.
   LOG(INFO) << __func__ << ": An endpoint: " << endpoint_id
             << " has been discovered, with an advertisement "
                "containing a valid share target with id: "
-            << share_target->id;
+            << share_target.id;
 
   // Log analytics event of discovering share target.
   analytics_recorder_.NewDiscoverShareTarget(
-      *share_target, scanning_session_id_,
+      share_target, scanning_session_id_,
       absl::ToInt64Milliseconds(context_->GetClock()->Now() -
                                 scanning_start_timestamp_),
       /*flow_id=*/1, /*referrer_package=*/std::nullopt,
@@ -1819,17 +2032,15 @@ void NearbySharingServiceImpl::OnOutgoingDecryptedCertificate(
           << " discovery callbacks be called.";
 
   for (auto& entry : foreground_send_surface_map_) {
-    entry.second.OnShareTargetDiscovered(*share_target);
+    entry.second.OnShareTargetDiscovered(share_target);
   }
   for (auto& entry : background_send_surface_map_) {
-    entry.second.OnShareTargetDiscovered(*share_target);
+    entry.second.OnShareTargetDiscovered(share_target);
   }
 
   VLOG(1) << __func__ << ": Reported OnShareTargetDiscovered: share_target: "
-          << share_target->ToString() << " endpoint_id=" << endpoint_id
+          << share_target.ToString() << " endpoint_id=" << endpoint_id
           << " to all send surfaces.";
-
-  FinishEndpointDiscoveryEvent();
 }
 
 void NearbySharingServiceImpl::ScheduleCertificateDownloadDuringDiscovery(
@@ -2160,6 +2371,7 @@ void NearbySharingServiceImpl::StartScanning() {
   DisableAllOutgoingShareTargets();
   discovered_advertisements_to_retry_map_.clear();
   discovered_advertisements_retried_set_.clear();
+  pending_share_target_upgrades_.clear();
 
   scanning_session_id_ = analytics_recorder_.GenerateNextId();
 
@@ -2199,6 +2411,7 @@ NearbySharingService::StatusCodes NearbySharingServiceImpl::StopScanning() {
   certificate_download_during_discovery_timer_.reset();
   discovered_advertisements_to_retry_map_.clear();
   discovered_advertisements_retried_set_.clear();
+  pending_share_target_upgrades_.clear();
 
   // Note: We don't know if we stopped scanning in preparation to send a file,
   // or we stopped because the user left the page. We'll invalidate after a
@@ -2234,6 +2447,7 @@ void NearbySharingServiceImpl::InvalidateFastInitiationScanning() {
             << ": Stopping background scanning due to post-transfer "
                "cooldown period";
     StopFastInitiationScanning();
+    ResetFastInitiationDutyCycle();
     return;
   }
 
@@ -2242,6 +2456,7 @@ void NearbySharingServiceImpl::InvalidateFastInitiationScanning() {
     VLOG(1) << __func__
             << ": Stopping background scanning because the screen is locked.";
     StopFastInitiationScanning();
+    ResetFastInitiationDutyCycle();
     return;
   }
 
@@ -2250,6 +2465,7 @@ void NearbySharingServiceImpl::InvalidateFastInitiationScanning() {
         << __func__
         << ": Stopping background scanning because bluetooth is powered down.";
     StopFastInitiationScanning();
+    ResetFastInitiationDutyCycle();
     return;
   }
 
@@ -2259,6 +2475,7 @@ void NearbySharingServiceImpl::InvalidateFastInitiationScanning() {
             << ": Stopping background scanning because we're scanning "
                "for other devices.";
     StopFastInitiationScanning();
+    ResetFastInitiationDutyCycle();
     return;
   }
 
@@ -2267,6 +2484,7 @@ void NearbySharingServiceImpl::InvalidateFastInitiationScanning() {
             << ": Stopping background scanning because we're currently "
                "in the midst of a transfer.";
     StopFastInitiationScanning();
+    ResetFastInitiationDutyCycle();
     return;
   }
 
@@ -2275,6 +2493,7 @@ void NearbySharingServiceImpl::InvalidateFastInitiationScanning() {
             << ": Stopping background scanning because we're already "
                "in high visibility mode.";
     StopFastInitiationScanning();
+    ResetFastInitiationDutyCycle();
     return;
   }
 
@@ -2283,10 +2502,59 @@ void NearbySharingServiceImpl::InvalidateFastInitiationScanning() {
             << ": Stopping background scanning because hardware "
                "support is not available or not ready.";
     StopFastInitiationScanning();
+    ResetFastInitiationDutyCycle();
+    return;
+  }
+
+  if (is_fast_initiation_scan_paused_) {
+    VLOG(1) << __func__
+            << ": Background scanning stays paused until the next scan window.";
     return;
   }
 
   StartFastInitiationScanning();
+  if (!fast_initiation_duty_cycle_timer_ &&
+      NearbyFlags::GetInstance().GetBoolFlag(
+          config_package_nearby::nearby_sharing_feature::
+              kEnableFastInitiationDutyCycle)) {
+    StartFastInitiationScanWindow();
+  }
+}
+
+void NearbySharingServiceImpl::StartFastInitiationScanWindow() {
+  fast_initiation_duty_cycle_timer_ = std::make_unique<ThreadTimer>(
+      *service_thread_, "fast_initiation_scan_window_timer",
+      kFastInitiationScanWindow, [this]() { PauseFastInitiationScanning(); });
+}
+
+void NearbySharingServiceImpl::PauseFastInitiationScanning() {
+  absl::Duration pause = fast_initiation_scan_pause_;
+  VLOG(1) << __func__ << ": Pausing background scanning for " << pause;
+  StopFastInitiationScanning();
+  is_fast_initiation_scan_paused_ = true;
+  fast_initiation_scan_pause_start_ = context_->GetClock()->Now();
+  fast_initiation_scan_pause_ =
+      std::min(fast_initiation_scan_pause_ * 2, kFastInitiationScanPauseMax);
+  fast_initiation_duty_cycle_timer_ = std::make_unique<ThreadTimer>(
+      *service_thread_, "fast_initiation_scan_pause_timer", pause, [this]() {
+        ResetFastInitiationDutyCycle(/*reset_pause=*/false);
+        InvalidateFastInitiationScanning();
+      });
+}
+
+void NearbySharingServiceImpl::ResetFastInitiationDutyCycle(bool reset_pause) {
+  fast_initiation_duty_cycle_timer_.reset();
+  if (reset_pause) {
+    fast_initiation_scan_pause_ = kFastInitiationScanPauseMin;
+  }
+  if (!is_fast_initiation_scan_paused_) {
+    return;
+  }
+  is_fast_initiation_scan_paused_ = false;
+  fast_initiation_scan_time_saved_ +=
+      context_->GetClock()->Now() - fast_initiation_scan_pause_start_;
+  LOG(INFO) << __func__ << ": Background scanning paused for "
+            << fast_initiation_scan_time_saved_ << " in total.";
 }
 
 void NearbySharingServiceImpl::StartFastInitiationScanning() {
@@ -2304,6 +2572,13 @@ void NearbySharingServiceImpl::StartFastInitiationScanning() {
 
 void NearbySharingServiceImpl::OnFastInitiationDevicesDetected() {
   VLOG(1) << __func__;
+  // Keeps scanning for a whole window after every detection.
+  RunOnNearbySharingServiceThread("fast_initiation_devices_detected", [this]() {
+    if (fast_initiation_duty_cycle_timer_ && !is_fast_initiation_scan_paused_) {
+      fast_initiation_scan_pause_ = kFastInitiationScanPauseMin;
+      StartFastInitiationScanWindow();
+    }
+  });
 
   for (auto& observer : observers_.GetObservers()) {
     observer->OnFastInitiationDevicesDetected();
@@ -2404,6 +2679,8 @@ void NearbySharingServiceImpl::OnTransferStarted(bool is_incoming) {
 void NearbySharingServiceImpl::OnOutgoingConnection(
     int64_t share_target_id, absl::string_view endpoint_id,
     NearbyConnection* connection, Status status) {
+  NEARBY_TRACE_EVENT_WITH_FLOW("sharing", "Outgoing connection",
+                               TraceFlowIdForEndpoint(endpoint_id));
   OutgoingShareSession* session = GetOutgoingShareSession(share_target_id);
   if (session == nullptr) {
     LOG(WARNING) << "Nearby connection connected, but share target "
@@ -2481,6 +2758,12 @@ void NearbySharingServiceImpl::OnCreatePayloads(
   }
   // Log analytics event of describing attachments.
   analytics_recorder_.NewDescribeAttachments(session.attachment_container());
+  if (NearbyFlags::GetInstance().GetBoolFlag(
+          config_package_nearby::nearby_sharing_feature::
+              kEnableEarlyIntroduction)) {
+    // Built while connecting, so it can go out with the paired key result.
+    session.PrepareIntroduction();
+  }
 
   std::optional<std::vector<uint8_t>> bluetooth_mac_address =
       GetBluetoothMacAddressForShareTarget(session);
@@ -3162,6 +3445,13 @@ IncomingShareSession& NearbySharingServiceImpl::CreateIncomingShareSession(
   if (certificate.has_value()) {
     it->second.set_certificate(std::move(*certificate));
   }
+  if (kSupportFileBundles) {
+    // Bundled files are saved where Nearby Connections saves incoming files.
+    std::string custom_save_path = settings_->GetCustomSavePath();
+    it->second.EnableFileBundles(
+        custom_save_path.empty() ? device_info_.GetDownloadPath()
+                                 : std::filesystem::path(custom_save_path));
+  }
   return it->second;
 }
 
@@ -186,6 +186,10 @@ class NearbySharingServiceImpl
     std::unique_ptr<ThreadTimer> expiry_timer;
     ShareTarget share_target;
   };
+  struct CachedCertificate {
+    NearbyShareDecryptedPublicCertificate certificate;
+    absl::Time expiry;
+  };
   // Internal implementation of methods to avoid using recursive mutex.
   StatusCodes InternalUnregisterSendSurface(
       TransferUpdateCallback* transfer_callback);
@@ -278,6 +282,24 @@ class NearbySharingServiceImpl
       absl::string_view endpoint_id, absl::Span<const uint8_t> endpoint_info,
       const Advertisement& advertisement,
       std::optional<NearbyShareDecryptedPublicCertificate> certificate);
+  // Reports |share_target| of a discovered endpoint to the send surfaces, as
+  // a new or an updated share target.
+  void ReportOutgoingShareTarget(
+      absl::string_view endpoint_id, ShareTarget share_target,
+      std::optional<NearbyShareDecryptedPublicCertificate> certificate);
+  // Returns the certificate decrypted earlier for |advertisement|, if it has
+  // not expired.
+  std::optional<NearbyShareDecryptedPublicCertificate>
+  GetCachedDecryptedCertificate(const Advertisement& advertisement);
+  void CacheDecryptedCertificate(
+      const Advertisement& advertisement,
+      const NearbyShareDecryptedPublicCertificate& certificate);
+  // Upgrades the provisional share target of |endpoint_id| with the result of
+  // the certificate decryption identified by |upgrade_id|.
+  void OnProvisionalShareTargetCertificate(
+      absl::string_view endpoint_id, absl::Span<const uint8_t> endpoint_info,
+      const Advertisement& advertisement, uint64_t upgrade_id,
+      std::optional<NearbyShareDecryptedPublicCertificate> certificate);
   void ScheduleCertificateDownloadDuringDiscovery(size_t attempt_count);
   void OnCertificateDownloadDuringDiscoveryTimerFired(size_t attempt_count);
 
@@ -298,6 +320,14 @@ class NearbySharingServiceImpl
   void OnFastInitiationDevicesDetected();
   void OnFastInitiationDevicesNotDetected();
   void StopFastInitiationScanning();
+  // Duty cycling of fast initiation scanning, when enabled: scanning runs for
+  // a window, then pauses before InvalidateFastInitiationScanning() starts
+  // the next window.
+  void StartFastInitiationScanWindow();
+  void PauseFastInitiationScanning();
+  // Stops the duty cycle, resuming scanning if it is paused. The next pause
+  // is the shortest unless |reset_pause| is false.
+  void ResetFastInitiationDutyCycle(bool reset_pause = true);
 
   void ScheduleRotateBackgroundAdvertisementTimer();
   void OnRotateBackgroundAdvertisementTimerFired();
@@ -450,6 +480,9 @@ class NearbySharingServiceImpl
   void UpdateFilePath(AttachmentContainer& container);
   // Returns true if Shutdown() has been called.
   bool IsShuttingDown();
+  // Starts the contact and certificate managers if they have not been started
+  // yet, and logs how long their startup took.
+  void StartDeferredManagers(absl::string_view reason);
 
   // Send initial adapter state to observer for each supported adapter.
   void SendInitialAdapterState(NearbySharingService::Observer* observer);
@@ -542,6 +575,15 @@ class NearbySharingServiceImpl
   // cause new download of public certificates. The purpose is to reduce the
   // unnecessary backend API call.
   absl::flat_hash_set<std::string> discovered_advertisements_retried_set_;
+  // A map from endpoint ID to the certificate decryption still pending for
+  // its provisional share target. A decryption finishing for an endpoint that
+  // was lost, or discovered again, meanwhile is ignored.
+  absl::flat_hash_map<std::string, uint64_t> pending_share_target_upgrades_;
+  // Certificates decrypted for discovered advertisements, keyed by the salt
+  // and encrypted metadata key of the advertisement.
+  absl::flat_hash_map<std::string, CachedCertificate>
+      decrypted_certificate_cache_;
+  uint64_t next_share_target_upgrade_id_ = 0;
 
   // A map of ShareTarget id to disconnection timeout callback. Used to only
   // disconnect after a timeout to keep sending any pending payloads.
@@ -569,10 +611,27 @@ class NearbySharingServiceImpl
   // Used to debounce OnNetworkChanged processing.
   std::unique_ptr<ThreadTimer> on_network_changed_delay_timer_;
 
+  // The time the service was created, to log how long after it the deferred
+  // managers start.
+  absl::Time service_creation_time_;
+  // Starts the contact and certificate managers, when their startup is
+  // deferred and the service is not used before.
+  std::unique_ptr<ThreadTimer> deferred_manager_startup_timer_;
+  bool are_deferred_managers_started_ = false;
+
   // Used to prevent the "Device nearby is sharing" notification from appearing
   // immediately after a completed share.
   std::unique_ptr<ThreadTimer> fast_initiation_scanner_cooldown_timer_;
 
+  // Ends the current scan window or pause while fast initiation scanning is
+  // duty cycled.
+  std::unique_ptr<ThreadTimer> fast_initiation_duty_cycle_timer_;
+  bool is_fast_initiation_scan_paused_ = false;
+  absl::Duration fast_initiation_scan_pause_ = absl::Seconds(10);
+  absl::Time fast_initiation_scan_pause_start_;
+  // The time fast initiation scanning has been paused by the duty cycle.
+  absl::Duration fast_initiation_scan_time_saved_ = absl::ZeroDuration();
+
   // A queue of endpoint-discovered and endpoint-lost events that ensures the
   // events are processed sequentially, in the order received from Nearby
   // Connections. An event is processed either immediately, if there are no
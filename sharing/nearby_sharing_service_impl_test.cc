@@ -116,6 +116,7 @@ using ::nearby::sharing::service::proto::TextMetadata;
 using ::nearby::sharing::service::proto::V1Frame;
 using ::testing::_;
 using ::testing::InSequence;
+using ::testing::Mock;
 using ::testing::NiceMock;
 using ::testing::Return;
 using ::testing::ReturnRef;
@@ -1403,6 +1404,55 @@ class TestObserver : public NearbySharingService::Observer {
   AdapterState lan_state_ = AdapterState::INVALID;
 };
 
+class NearbySharingServiceImplDeferredStartupTest
+    : public NearbySharingServiceImplTest {
+ protected:
+  void SetUp() override {
+    NearbyFlags::GetInstance().OverrideBoolFlagValue(
+        config_package_nearby::nearby_sharing_feature::
+            kEnableDeferredManagerStartup,
+        true);
+    NearbySharingServiceImplTest::SetUp();
+  }
+
+  bool AreDeferredManagersRunning() {
+    EXPECT_EQ(contact_manager_factory_.instances().size(), 1u);
+    return contact_manager_factory_.instances().back()->is_running() &&
+           certificate_manager()->is_running();
+  }
+};
+
+TEST_F(NearbySharingServiceImplTest, ManagersStartWithService) {
+  FlushTesting();
+  EXPECT_TRUE(contact_manager_factory_.instances().back()->is_running());
+  EXPECT_TRUE(certificate_manager()->is_running());
+}
+
+TEST_F(NearbySharingServiceImplDeferredStartupTest,
+       ManagersStartOnSurfaceRegistration) {
+  FlushTesting();
+  EXPECT_FALSE(contact_manager_factory_.instances().back()->is_running());
+  EXPECT_FALSE(certificate_manager()->is_running());
+
+  MockTransferUpdateCallback transfer_callback;
+  MockShareTargetDiscoveredCallback discovery_callback;
+  EXPECT_EQ(RegisterSendSurface(&transfer_callback, &discovery_callback,
+                                SendSurfaceState::kForeground),
+            NearbySharingService::StatusCodes::kOk);
+  ScopedSendSurface s(service_.get(), &transfer_callback);
+  EXPECT_TRUE(AreDeferredManagersRunning());
+}
+
+TEST_F(NearbySharingServiceImplDeferredStartupTest,
+       ManagersStartAfterStartupDelay) {
+  FastForward(absl::Seconds(9));
+  EXPECT_FALSE(contact_manager_factory_.instances().back()->is_running());
+  EXPECT_FALSE(certificate_manager()->is_running());
+
+  FastForward(absl::Seconds(1));
+  EXPECT_TRUE(AreDeferredManagersRunning());
+}
+
 TEST_F(NearbySharingServiceImplTest, StartFastInitiationAdvertising) {
   FakeNearbyFastInitiation* fast_initiation =
       nearby_fast_initiation_factory_->GetNearbyFastInitiation();
@@ -1583,6 +1633,56 @@ TEST_F(NearbySharingServiceImplTest,
   EXPECT_EQ(fast_initiation->StopScanningCount(), 1);
 }
 
+TEST_F(NearbySharingServiceImplTest, FastInitiationScanning_DutyCycle) {
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      config_package_nearby::nearby_sharing_feature::
+          kEnableFastInitiationDutyCycle,
+      true);
+  FakeNearbyFastInitiation* fast_initiation =
+      nearby_fast_initiation_factory_->GetNearbyFastInitiation();
+  SetConnectionType(ConnectionType::kBluetooth);
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 1);
+
+  // Restart scanning so that it runs in windows.
+  SetBluetoothIsPowered(false);
+  SetBluetoothIsPowered(true);
+  EXPECT_TRUE(sharing_service_task_runner_->SyncWithTimeout(kTaskWaitTimeout));
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 2);
+  EXPECT_EQ(fast_initiation->StopScanningCount(), 1);
+
+  // The first window is followed by a 10s pause.
+  FastForward(absl::Seconds(10));
+  EXPECT_EQ(fast_initiation->StopScanningCount(), 2);
+  FastForward(absl::Seconds(10));
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 3);
+
+  // Without a detection, the next pause is twice as long.
+  FastForward(absl::Seconds(10));
+  EXPECT_EQ(fast_initiation->StopScanningCount(), 3);
+  FastForward(absl::Seconds(10));
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 3);
+  FastForward(absl::Seconds(10));
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 4);
+
+  // A detection extends the window, and brings the pause back to 10s.
+  FastForward(absl::Seconds(5));
+  fast_initiation->FireDevicesDetected();
+  FastForward(absl::Seconds(5));
+  EXPECT_EQ(fast_initiation->StopScanningCount(), 3);
+  FastForward(absl::Seconds(5));
+  EXPECT_EQ(fast_initiation->StopScanningCount(), 4);
+  FastForward(absl::Seconds(10));
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 5);
+
+  // Locking the screen stops the duty cycle along with scanning.
+  SetScreenLocked(true);
+  EXPECT_EQ(fast_initiation->StopScanningCount(), 5);
+  FastForward(absl::Seconds(30));
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 5);
+  SetScreenLocked(false);
+  EXPECT_EQ(fast_initiation->StartScanningCount(), 6);
+}
+
 TEST_F(NearbySharingServiceImplTest,
        ForegroundRegisterSendSurfaceStartsDiscovering) {
   SetConnectionType(ConnectionType::kWifi);
@@ -1710,6 +1810,99 @@ TEST_F(NearbySharingServiceImplTest,
   Shutdown();
 }
 
+TEST_F(NearbySharingServiceImplTest,
+       ProvisionalShareTargetIsUpdatedWithTheCertificate) {
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      config_package_nearby::nearby_sharing_feature::
+          kEnableProvisionalShareTargets,
+      true);
+  SetConnectionType(ConnectionType::kWifi);
+
+  MockTransferUpdateCallback transfer_callback;
+  NiceMock<MockShareTargetDiscoveredCallback> discovery_callback;
+  EXPECT_EQ(RegisterSendSurface(&transfer_callback, &discovery_callback,
+                                SendSurfaceState::kForeground),
+            NearbySharingService::StatusCodes::kOk);
+  ScopedSendSurface s(service_.get(), &transfer_callback);
+  EXPECT_TRUE(fake_nearby_connections_manager_->IsDiscovering());
+
+  // The device is reported before its certificate is decrypted.
+  int64_t discovered_target_id = 0;
+  EXPECT_CALL(discovery_callback, OnShareTargetDiscovered)
+      .WillOnce([&](ShareTarget share_target) {
+        EXPECT_FALSE(share_target.is_known);
+        EXPECT_EQ(share_target.device_name, kDeviceName);
+        EXPECT_EQ(share_target.device_id, kEndpointId);
+        discovered_target_id = share_target.id;
+      });
+  fake_nearby_connections_manager_->OnEndpointFound(
+      kEndpointId, std::make_unique<DiscoveredEndpointInfo>(
+                       CreateTestEndpointInfo(), kServiceId));
+  FlushTesting();
+  Mock::VerifyAndClearExpectations(&discovery_callback);
+
+  EXPECT_CALL(discovery_callback, OnShareTargetUpdated)
+      .WillOnce([&](ShareTarget share_target) {
+        EXPECT_TRUE(share_target.is_known);
+        EXPECT_EQ(share_target.id, discovered_target_id);
+        EXPECT_EQ(share_target.full_name, kTestMetadataFullName);
+      });
+  ProcessLatestPublicCertificateDecryption(/*expected_num_calls=*/1,
+                                           /*success=*/true);
+
+  Shutdown();
+}
+
+TEST_F(NearbySharingServiceImplTest,
+       RediscoveredAdvertisementReusesDecryptedCertificate) {
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      config_package_nearby::nearby_sharing_feature::
+          kEnableDecryptedCertificateCache,
+      true);
+  SetConnectionType(ConnectionType::kWifi);
+
+  MockTransferUpdateCallback transfer_callback;
+  NiceMock<MockShareTargetDiscoveredCallback> discovery_callback;
+  EXPECT_EQ(RegisterSendSurface(&transfer_callback, &discovery_callback,
+                                SendSurfaceState::kForeground),
+            NearbySharingService::StatusCodes::kOk);
+  ScopedSendSurface s(service_.get(), &transfer_callback);
+  EXPECT_TRUE(fake_nearby_connections_manager_->IsDiscovering());
+
+  std::optional<ShareTarget> reported_target;
+  ON_CALL(discovery_callback, OnShareTargetDiscovered)
+      .WillByDefault(
+          [&](ShareTarget share_target) { reported_target = share_target; });
+  ON_CALL(discovery_callback, OnShareTargetUpdated)
+      .WillByDefault(
+          [&](ShareTarget share_target) { reported_target = share_target; });
+  fake_nearby_connections_manager_->OnEndpointFound(
+      kEndpointId, std::make_unique<DiscoveredEndpointInfo>(
+                       CreateTestEndpointInfo(), kServiceId));
+  FlushTesting();
+  ProcessLatestPublicCertificateDecryption(/*expected_num_calls=*/1,
+                                           /*success=*/true);
+  ASSERT_TRUE(reported_target.has_value());
+  EXPECT_TRUE(reported_target->is_known);
+
+  // The same advertisement found again is not decrypted again.
+  reported_target.reset();
+  fake_nearby_connections_manager_->OnEndpointLost(kEndpointId);
+  FlushTesting();
+  fake_nearby_connections_manager_->OnEndpointFound(
+      kEndpointId, std::make_unique<DiscoveredEndpointInfo>(
+                       CreateTestEndpointInfo(), kServiceId));
+  FlushTesting();
+  EXPECT_EQ(
+      certificate_manager()->get_decrypted_public_certificate_calls().size(),
+      1);
+  ASSERT_TRUE(reported_target.has_value());
+  EXPECT_TRUE(reported_target->is_known);
+  EXPECT_EQ(reported_target->full_name, kTestMetadataFullName);
+
+  Shutdown();
+}
+
 TEST_F(NearbySharingServiceImplTest, RegisterSendSurfaceEmptyCertificate) {
   SetConnectionType(ConnectionType::kWifi);
 
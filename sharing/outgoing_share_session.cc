@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <filesystem>  // NOLINT
 #include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <queue>
@@ -25,6 +26,8 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/random/random.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "internal/platform/clock.h"
@@ -34,6 +37,7 @@
 #include "sharing/certificates/nearby_share_decrypted_public_certificate.h"
 #include "sharing/constants.h"
 #include "sharing/file_attachment.h"
+#include "sharing/file_bundle.h"
 #include "sharing/internal/public/logging.h"
 #include "sharing/nearby_connection.h"
 #include "sharing/nearby_connections_manager.h"
@@ -219,6 +223,7 @@ bool OutgoingShareSession::CreateFilePayloads(
   }
   file_payloads_.clear();
   file_payloads_.reserve(files.size());
+  in_flight_file_payload_ids_.clear();
 
   for (size_t i = 0; i < files.size(); ++i) {
     const NearbyFileHandler::FileInfo& file_info = files[i];
@@ -231,6 +236,26 @@ bool OutgoingShareSession::CreateFilePayloads(
     file_payloads_.push_back(std::move(payload));
     SetAttachmentPayloadId(attachment.id(), file_payloads_.back().id);
   }
+
+  // The bundles are only offered; the files keep their own payloads until the
+  // receiver accepts them.
+  file_bundles_.clear();
+  if (!kSupportFileBundles) return true;
+  absl::BitGen bitgen;
+  for (const std::vector<size_t>& indices :
+       PlanFileBundles(container.GetFileAttachments())) {
+    FileBundle& bundle = file_bundles_.emplace_back();
+    bundle.payload_id = absl::Uniform<int64_t>(
+        absl::IntervalOpenClosed, bitgen, 0,
+        std::numeric_limits<int64_t>::max());
+    for (size_t index : indices) {
+      const FileAttachment& attachment = container.GetFileAttachments()[index];
+      bundle.file_ids.push_back(attachment.id());
+      bundle.paths.push_back(
+          file_payloads_[index].content.file_payload.file.path);
+      bundle.sizes.push_back(attachment.size());
+    }
+  }
   return true;
 }
 
@@ -260,6 +285,13 @@ bool OutgoingShareSession::FillIntroductionFrame(
     file_metadata->set_size(file.size());
     file_metadata->set_parent_folder(std::string(file.parent_folder()));
   }
+  for (const FileBundle& bundle : file_bundles_) {
+    auto* file_bundle_metadata = introduction->add_file_bundle_metadata();
+    file_bundle_metadata->set_payload_id(bundle.payload_id);
+    for (int64_t file_id : bundle.file_ids) {
+      file_bundle_metadata->add_file_ids(file_id);
+    }
+  }
 
   // Write introduction of text payloads.
   const std::vector<TextAttachment>& text_attachments =
@@ -345,6 +377,11 @@ void OutgoingShareSession::SendPayloads(
 }
 
 void OutgoingShareSession::SendNextPayload() {
+  if (text_payloads_.empty() &&
+      (!file_payloads_.empty() || !accepted_file_bundles_.empty())) {
+    SendFilePayloads();
+    return;
+  }
   std::optional<Payload> payload = ExtractNextPayload();
   if (payload.has_value()) {
     LOG(INFO) << "Send  payload " << payload->id;
@@ -355,6 +392,54 @@ void OutgoingShareSession::SendNextPayload() {
   }
 }
 
+void OutgoingShareSession::UseFileBundles() {
+  absl::flat_hash_set<int64_t> bundled_payload_ids;
+  for (const FileBundle& bundle : file_bundles_) {
+    for (int64_t file_id : bundle.file_ids) {
+      bundled_payload_ids.insert(attachment_payload_map().at(file_id));
+      SetAttachmentPayloadId(file_id, bundle.payload_id);
+    }
+  }
+  std::erase_if(file_payloads_, [&bundled_payload_ids](const Payload& payload) {
+    return bundled_payload_ids.contains(payload.id);
+  });
+  VLOG(1) << "Sending " << bundled_payload_ids.size() << " files in "
+          << file_bundles_.size() << " bundles.";
+  accepted_file_bundles_ = std::move(file_bundles_);
+  file_bundles_.clear();
+}
+
+void OutgoingShareSession::SendFilePayloads() {
+  while (in_flight_file_payload_ids_.size() < kMaxInFlightFilePayloads) {
+    Payload payload;
+    if (!accepted_file_bundles_.empty()) {
+      // Bundles are only read when sent, so that at most the bundles in flight
+      // are held in memory.
+      const FileBundle& bundle = accepted_file_bundles_.back();
+      std::optional<std::vector<uint8_t>> bytes =
+          ReadFileBundle(bundle.paths, bundle.sizes);
+      if (!bytes.has_value()) {
+        LOG(WARNING) << "Failed to read file bundle " << bundle.payload_id;
+        accepted_file_bundles_.clear();
+        Abort(TransferMetadata::Status::kFailed);
+        return;
+      }
+      payload = Payload(bundle.payload_id, *std::move(bytes));
+      accepted_file_bundles_.pop_back();
+    } else if (!file_payloads_.empty()) {
+      payload = std::move(file_payloads_.back());
+      file_payloads_.pop_back();
+    } else {
+      return;
+    }
+    LOG(INFO) << "Send file payload " << payload.id;
+    in_flight_file_payload_ids_.insert(payload.id);
+    connections_manager().Send(endpoint_id(),
+                               std::make_unique<Payload>(std::move(payload)),
+                               payload_tracker());
+  }
+}
+
 void OutgoingShareSession::SendAttachmentsCompleted(
     const TransferMetadata& metadata) {
   if (!metadata.is_final_status()) {
@@ -374,8 +459,7 @@ void OutgoingShareSession::SendAttachmentsCompleted(
       ConvertToConnectionLayerStatus(connection_layer_status_), os_type());
 }
 
-bool OutgoingShareSession::SendIntroduction(
-    std::function<void()> timeout_callback) {
+bool OutgoingShareSession::PrepareIntroduction() {
   Frame frame;
   frame.set_version(Frame::V1);
   V1Frame* v1_frame = frame.mutable_v1();
@@ -385,7 +469,34 @@ bool OutgoingShareSession::SendIntroduction(
   if (!FillIntroductionFrame(introduction_frame)) {
     return false;
   }
-  WriteFrame(frame);
+  prepared_introduction_ = std::move(frame);
+  return true;
+}
+
+void OutgoingShareSession::OnLocalKeyVerificationResult(
+    PairedKeyVerificationRunner::PairedKeyVerificationResult result) {
+  if (!prepared_introduction_.has_value() ||
+      result ==
+          PairedKeyVerificationRunner::PairedKeyVerificationResult::kFail) {
+    return;
+  }
+  VLOG(1) << "Writing the introduction frame before the remote paired key "
+             "result";
+  WriteFrame(*prepared_introduction_);
+  prepared_introduction_.reset();
+  introduction_written_ = true;
+}
+
+bool OutgoingShareSession::SendIntroduction(
+    std::function<void()> timeout_callback) {
+  if (!introduction_written_) {
+    if (!prepared_introduction_.has_value() && !PrepareIntroduction()) {
+      return false;
+    }
+    WriteFrame(*prepared_introduction_);
+    prepared_introduction_.reset();
+    introduction_written_ = true;
+  }
   // Log analytics event of sending introduction.
   analytics_recorder().NewSendIntroduction(session_id(), share_target(),
                                            /*transfer_position=*/1,
@@ -415,6 +526,9 @@ OutgoingShareSession::HandleConnectionResponse(
 
   switch (response->status()) {
     case ConnectionResponseFrame::ACCEPT: {
+      if (response->accept_file_bundles()) {
+        UseFileBundles();
+      }
       UpdateTransferMetadata(
           TransferMetadataBuilder()
               .set_status(TransferMetadata::Status::kInProgress)
@@ -580,10 +694,21 @@ OutgoingShareSession::ProcessPayloadTransferUpdates() {
   }
 
   std::optional<TransferMetadata> metadata;
+  bool file_payload_completed = false;
   for (; !updates.empty(); updates.pop()) {
+    if (updates.front()->status == PayloadStatus::kSuccess &&
+        in_flight_file_payload_ids_.erase(updates.front()->payload_id) > 0) {
+      file_payload_completed = true;
+    }
     metadata =
         get_payload_tracker()->ProcessPayloadUpdate(std::move(updates.front()));
   }
+  // Only the last update is reported, so the next file payloads are sent from
+  // here rather than relying on the caller to see every completion.
+  if (file_payload_completed && text_payloads_.empty() &&
+      !(metadata.has_value() && metadata->is_final_status())) {
+    SendFilePayloads();
+  }
   return metadata;
 }
 
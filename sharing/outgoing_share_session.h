@@ -24,6 +24,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "internal/platform/clock.h"
@@ -37,6 +38,7 @@
 #include "sharing/nearby_file_handler.h"
 #include "sharing/paired_key_verification_runner.h"
 #include "sharing/proto/enums.pb.h"
+#include "sharing/proto/wire_format.pb.h"
 #include "sharing/share_session.h"
 #include "sharing/share_target.h"
 #include "sharing/thread_timer.h"
@@ -94,7 +96,18 @@ class OutgoingShareSession : public ShareSession {
   bool CreateFilePayloads(
       const std::vector<NearbyFileHandler::FileInfo>& files);
 
+  // Builds the introduction frame ahead of paired key verification, and has it
+  // written as soon as the local verification result doesn't fail, instead of
+  // after the remote result is read. The receiver keeps the frame until it
+  // reads it. Must be called after the payloads are created.
+  // Returns false if there is no introduction to send.
+  bool PrepareIntroduction();
+  // Writes the prepared introduction frame, if any, unless `result` is kFail.
+  void OnLocalKeyVerificationResult(
+      PairedKeyVerificationRunner::PairedKeyVerificationResult result) override;
+
   // Returns true if the introduction frame is written successfully.
+  // If it was written early, only starts waiting for the acceptance.
   // `timeout_callback` is called if accept is not received from both sender and
   // receiver within the timeout.
   bool SendIntroduction(std::function<void()> timeout_callback);
@@ -124,6 +137,8 @@ class OutgoingShareSession : public ShareSession {
           frame_read_callback,
       std::function<void()> payload_transder_update_callback);
   // Send the next payload to NearbyConnectionManager.
+  // File payloads are sent up to `kMaxInFlightFilePayloads` at a time, the
+  // others one per call.
   // Used only if enable_transfer_cancellation_optimization is true.
   void SendNextPayload();
 
@@ -166,6 +181,11 @@ class OutgoingShareSession : public ShareSession {
   TransportType GetTransportType(bool disable_wifi_hotspot) const;
 
   std::optional<Payload> ExtractNextPayload();
+  // Sends the bundled files in the offered bundles instead of their own
+  // payloads.
+  void UseFileBundles();
+  // Sends file payloads until `kMaxInFlightFilePayloads` are in flight.
+  void SendFilePayloads();
   bool FillIntroductionFrame(
       nearby::sharing::service::proto::IntroductionFrame* introduction) const;
 
@@ -174,9 +194,24 @@ class OutgoingShareSession : public ShareSession {
   std::vector<Payload> text_payloads_;
   std::vector<Payload> file_payloads_;
   std::vector<Payload> wifi_credentials_payloads_;
+  // Small files offered to the receiver in one payload each bundle.
+  struct FileBundle {
+    int64_t payload_id = 0;
+    std::vector<int64_t> file_ids;
+    std::vector<std::filesystem::path> paths;
+    std::vector<int64_t> sizes;
+  };
+  std::vector<FileBundle> file_bundles_;
+  // The bundles accepted by the receiver which haven't been sent yet.
+  std::vector<FileBundle> accepted_file_bundles_;
+  // IDs of the file payloads sent which haven't completed yet.
+  absl::flat_hash_set<int64_t> in_flight_file_payload_ids_;
   Status connection_layer_status_ = Status::kUnknown;
   std::function<void(OutgoingShareSession&, const TransferMetadata&)>
       transfer_update_callback_;
+  // Set by PrepareIntroduction() until the frame is written.
+  std::optional<nearby::sharing::service::proto::Frame> prepared_introduction_;
+  bool introduction_written_ = false;
   bool ready_for_accept_ = false;
   // This alarm is used to disconnect the sharing connection if both sides do
   // not press accept within the timeout.
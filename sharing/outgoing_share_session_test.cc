@@ -14,6 +14,7 @@
 
 #include "sharing/outgoing_share_session.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -24,6 +25,7 @@
 #include "gmock/gmock.h"
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "internal/analytics/mock_event_logger.h"
@@ -36,6 +38,7 @@
 #include "sharing/attachment_container.h"
 #include "sharing/certificates/test_util.h"
 #include "sharing/common/nearby_share_enums.h"
+#include "sharing/constants.h"
 #include "sharing/fake_nearby_connections_manager.h"
 #include "sharing/file_attachment.h"
 #include "sharing/nearby_connection.h"
@@ -489,6 +492,73 @@ TEST_F(OutgoingShareSessionTest, SendIntroductionSuccess) {
               Eq(wifi_payloads[0].id));
 }
 
+TEST_F(OutgoingShareSessionTest, PrepareIntroductionWithoutPayloads) {
+  InitSendAttachments(CreateDefaultAttachmentContainer());
+  EXPECT_THAT(session_.PrepareIntroduction(), IsFalse());
+}
+
+TEST_F(OutgoingShareSessionTest, PreparedIntroductionWrittenOnLocalResult) {
+  InitSendAttachments(CreateDefaultAttachmentContainer());
+  session_.set_session_id(1234);
+  NearbyConnectionImpl connection(device_info_);
+  ConnectionSuccess(&connection);
+  session_.CreateTextPayloads();
+  session_.CreateWifiCredentialsPayloads();
+  session_.CreateFilePayloads({{
+      .size = 12355L,
+      .file_path = file1_.file_path().value(),
+  }});
+  std::vector<Frame> frames;
+  connections_manager_.set_send_payload_callback(
+      [&](std::unique_ptr<Payload> payload,
+          std::weak_ptr<NearbyConnectionsManager::PayloadStatusListener>
+              listener) {
+        const std::vector<uint8_t>& data = payload->content.bytes_payload.bytes;
+        frames.emplace_back().ParseFromArray(data.data(), data.size());
+      });
+  ASSERT_THAT(session_.PrepareIntroduction(), IsTrue());
+
+  session_.OnLocalKeyVerificationResult(
+      PairedKeyVerificationRunner::PairedKeyVerificationResult::kUnable);
+
+  ASSERT_THAT(frames, SizeIs(1));
+  EXPECT_THAT(frames[0].v1().type(), Eq(V1Frame::INTRODUCTION));
+  EXPECT_THAT(frames[0].v1().introduction().text_metadata_size(), Eq(2));
+
+  // Only the acceptance wait is left once verification completes.
+  EXPECT_CALL(
+      mock_event_logger_,
+      Log(Matcher<const SharingLog&>(AllOf(
+          (HasCategory(EventCategory::SENDING_EVENT),
+           HasEventType(EventType::SEND_INTRODUCTION),
+           Property(&SharingLog::send_introduction, HasSessionId(1234)))))));
+  EXPECT_THAT(session_.SendIntroduction([]() {}), IsTrue());
+  EXPECT_THAT(frames, SizeIs(1));
+}
+
+TEST_F(OutgoingShareSessionTest, PreparedIntroductionNotWrittenOnLocalFail) {
+  InitSendAttachments(CreateDefaultAttachmentContainer());
+  NearbyConnectionImpl connection(device_info_);
+  ConnectionSuccess(&connection);
+  session_.CreateTextPayloads();
+  session_.CreateWifiCredentialsPayloads();
+  session_.CreateFilePayloads({{
+      .size = 12355L,
+      .file_path = file1_.file_path().value(),
+  }});
+  int frames_written = 0;
+  connections_manager_.set_send_payload_callback(
+      [&](std::unique_ptr<Payload> payload,
+          std::weak_ptr<NearbyConnectionsManager::PayloadStatusListener>
+              listener) { frames_written++; });
+  ASSERT_THAT(session_.PrepareIntroduction(), IsTrue());
+
+  session_.OnLocalKeyVerificationResult(
+      PairedKeyVerificationRunner::PairedKeyVerificationResult::kFail);
+
+  EXPECT_THAT(frames_written, Eq(0));
+}
+
 TEST_F(OutgoingShareSessionTest, SendIntroductionTimeout) {
   auto container = std::make_unique<AttachmentContainer>(
       std::vector<TextAttachment>{text1_}, std::vector<FileAttachment>{},
@@ -783,6 +853,59 @@ TEST_F(OutgoingShareSessionTest, SendNextPayload) {
   session_.SendNextPayload();
 }
 
+TEST_F(OutgoingShareSessionTest, SendFilePayloadsPipelined) {
+  std::vector<FileAttachment> files;
+  std::vector<NearbyFileHandler::FileInfo> file_infos;
+  for (size_t i = 0; i <= kMaxInFlightFilePayloads; ++i) {
+    files.push_back(FileAttachment(
+        absl::StrCat("/usr/local/tmp/someFileName", i, ".jpg"),
+        "/usr/local/parent"));
+    file_infos.push_back({
+        .size = 100,
+        .file_path = *files.back().file_path(),
+    });
+  }
+  InitSendAttachments(std::make_unique<AttachmentContainer>(
+      std::vector<TextAttachment>{}, std::move(files),
+      std::vector<WifiCredentialsAttachment>{}));
+  session_.CreateFilePayloads(file_infos);
+  std::vector<int64_t> sent_payload_ids;
+  connections_manager_.set_send_payload_callback(
+      [&sent_payload_ids](
+          std::unique_ptr<Payload> payload,
+          std::weak_ptr<NearbyConnectionsManager::PayloadStatusListener>) {
+        sent_payload_ids.push_back(payload->id);
+      });
+  EXPECT_CALL(mock_event_logger_,
+              Log(Matcher<const SharingLog&>(
+                  AllOf((HasCategory(EventCategory::SENDING_EVENT),
+                         HasEventType(EventType::SEND_ATTACHMENTS_START))))));
+  NearbyConnectionImpl connection(device_info_);
+  ConnectionSuccess(&connection);
+  MockFunction<void()> payload_transder_update_callback;
+
+  session_.SendPayloads([](std::optional<V1Frame> frame) {},
+                        payload_transder_update_callback.AsStdFunction());
+
+  EXPECT_THAT(sent_payload_ids, SizeIs(kMaxInFlightFilePayloads));
+  // Waiting for a file still in flight doesn't send another one.
+  session_.SendNextPayload();
+  EXPECT_THAT(sent_payload_ids, SizeIs(kMaxInFlightFilePayloads));
+
+  session_.payload_tracker().lock()->OnStatusUpdate(
+      std::make_unique<PayloadTransferUpdate>(
+          sent_payload_ids[0], PayloadStatus::kSuccess, /*total_bytes=*/100,
+          /*bytes_transferred=*/100));
+  std::optional<TransferMetadata> metadata =
+      session_.ProcessPayloadTransferUpdates();
+
+  ASSERT_THAT(metadata.has_value(), IsTrue());
+  EXPECT_THAT(metadata->status(), Eq(TransferMetadata::Status::kInProgress));
+  EXPECT_THAT(metadata->in_progress_attachment_transferred_bytes(),
+              Eq(std::optional<uint64_t>(100)));
+  EXPECT_THAT(sent_payload_ids, SizeIs(kMaxInFlightFilePayloads + 1));
+}
+
 TEST_F(OutgoingShareSessionTest, ProcessKeyVerificationResultFail) {
   NearbyConnectionImpl connection(device_info_);
   session_.set_session_id(1234);
@@ -129,9 +129,11 @@ PairedKeyVerificationRunner::PairedKeyVerificationRunner(
 PairedKeyVerificationRunner::~PairedKeyVerificationRunner() = default;
 
 void PairedKeyVerificationRunner::Run(
-    std::function<void(PairedKeyVerificationResult, OSType)> callback) {
+    std::function<void(PairedKeyVerificationResult, OSType)> callback,
+    std::function<void(PairedKeyVerificationResult)> local_result_callback) {
   DCHECK(!callback_);
   callback_ = std::move(callback);
+  local_result_callback_ = std::move(local_result_callback);
   verification_result_ = PairedKeyVerificationResult::kSuccess;
 
   SendPairedKeyEncryptionFrame();
@@ -179,6 +181,9 @@ void PairedKeyVerificationRunner::OnReadPairedKeyEncryptionFrame(
           << local_result;
 
   SendPairedKeyResultFrame(local_result);
+  if (local_result_callback_) {
+    std::move(local_result_callback_)(verification_result_);
+  }
 
   frames_reader_->ReadFrame(
       V1Frame::PAIRED_KEY_RESULT,
@@ -68,10 +68,15 @@ class PairedKeyVerificationRunner
 
   ~PairedKeyVerificationRunner();
 
+  // `local_result_callback`, if set, is called with the result verified so
+  // far once the local paired key result frame is written, before the remote
+  // one is read. Frames written from it go out after the result frame.
   void Run(std::function<
-           void(PairedKeyVerificationResult verification_result,
-                ::location::nearby::proto::sharing::OSType remote_os_type)>
-               callback);
+               void(PairedKeyVerificationResult verification_result,
+                    ::location::nearby::proto::sharing::OSType remote_os_type)>
+               callback,
+           std::function<void(PairedKeyVerificationResult local_result)>
+               local_result_callback = nullptr);
 
   std::weak_ptr<PairedKeyVerificationRunner> GetWeakPtr() {
     return this->weak_from_this();
@@ -108,6 +113,7 @@ class PairedKeyVerificationRunner
   std::function<void(PairedKeyVerificationResult,
                      ::location::nearby::proto::sharing::OSType)>
       callback_;
+  std::function<void(PairedKeyVerificationResult)> local_result_callback_;
   PairedKeyVerificationResult verification_result_;
   char local_prefix_;
   char remote_prefix_;
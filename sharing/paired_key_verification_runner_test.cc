@@ -209,7 +209,10 @@ class PairedKeyVerificationRunnerTest : public testing::Test {
       bool is_incoming, bool use_valid_public_certificate,
       const PairedKeyVerificationRunner::VisibilityHistory& visibility_history,
       PairedKeyVerificationRunner::PairedKeyVerificationResult expected_result,
-      OSType expected_os_type = OSType::UNKNOWN_OS_TYPE) {
+      OSType expected_os_type = OSType::UNKNOWN_OS_TYPE,
+      std::function<
+          void(PairedKeyVerificationRunner::PairedKeyVerificationResult)>
+          local_result_callback = nullptr) {
     std::optional<NearbyShareDecryptedPublicCertificate> public_certificate =
         use_valid_public_certificate
             ? std::make_optional<NearbyShareDecryptedPublicCertificate>(
@@ -230,7 +233,8 @@ class PairedKeyVerificationRunnerTest : public testing::Test {
             OSType remote_os_type) {
           EXPECT_EQ(expected_result, result);
           EXPECT_EQ(expected_os_type, remote_os_type);
-        });
+        },
+        std::move(local_result_callback));
   }
 
   void SetUpPairedKeyEncryptionFrame(ReturnFrameType frame_type) {
@@ -386,6 +390,29 @@ TEST_F(PairedKeyVerificationRunnerTest,
   ExpectPairedKeyResultFrameSent(PairedKeyResultFrame::SUCCESS);
 }
 
+TEST_F(PairedKeyVerificationRunnerTest,
+       LocalResultReportedBeforeRemoteResultIsRead) {
+  SetUpPairedKeyEncryptionFrame(ReturnFrameType::kValid);
+  SetUpPairedKeyResultFrame(ReturnFrameType::kValid,
+                            PairedKeyResultFrame::FAIL);
+  std::optional<PairedKeyVerificationResult> local_result;
+
+  RunVerification(
+      true,
+      /*use_valid_public_certificate=*/true,
+      {.visibility = DeviceVisibility::DEVICE_VISIBILITY_ALL_CONTACTS,
+       .last_visibility = DeviceVisibility::DEVICE_VISIBILITY_ALL_CONTACTS,
+       .last_visibility_time = GetFakeClock()->Now()},
+      /*expected_result=*/
+      PairedKeyVerificationResult::kFail, OSType::UNKNOWN_OS_TYPE,
+      [&](PairedKeyVerificationResult result) { local_result = result; });
+
+  // The remote result does not change the local one.
+  EXPECT_EQ(local_result, PairedKeyVerificationResult::kSuccess);
+  ExpectPairedKeyEncryptionFrameSent();
+  ExpectPairedKeyResultFrameSent(PairedKeyResultFrame::SUCCESS);
+}
+
 struct TestParameters {
   bool is_incoming;
   bool has_valid_certificate;
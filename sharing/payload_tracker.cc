@@ -14,6 +14,7 @@
 
 #include "sharing/payload_tracker.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <limits>
@@ -42,9 +43,11 @@ PayloadTracker::PayloadTracker(
     Clock* clock, int64_t share_target_id, const AttachmentContainer& container,
     const absl::flat_hash_map<int64_t, int64_t>& attachment_payload_map,
     std::unique_ptr<WorkerQueue<std::unique_ptr<PayloadTransferUpdate>>>
-        payload_queue)
+        payload_queue,
+    absl::Duration min_progress_update_interval)
     : clock_(clock),
       share_target_id_(share_target_id),
+      min_progress_update_interval_(min_progress_update_interval),
       payload_update_queue_(std::move(payload_queue)) {
   total_transfer_size_ = 0;
   confirmed_transfer_size_ = 0;
@@ -58,7 +61,7 @@ PayloadTracker::PayloadTracker(
       continue;
     }
 
-    payload_state_.emplace(it->second, State(file.id(), file.size()));
+    AddAttachment(it->second, file.id(), file.size());
     ++num_file_attachments_;
     total_transfer_size_ += file.size();
   }
@@ -72,7 +75,7 @@ PayloadTracker::PayloadTracker(
       continue;
     }
 
-    payload_state_.emplace(it->second, State(text.id(), text.size()));
+    AddAttachment(it->second, text.id(), text.size());
     ++num_text_attachments_;
     total_transfer_size_ += text.size();
   }
@@ -88,8 +91,7 @@ PayloadTracker::PayloadTracker(
       continue;
     }
 
-    payload_state_.emplace(
-        it->second, State(wifi_credentials.id(), wifi_credentials.size()));
+    AddAttachment(it->second, wifi_credentials.id(), wifi_credentials.size());
     ++num_wifi_credentials_attachments_;
     total_transfer_size_ += wifi_credentials.size();
   }
@@ -97,6 +99,23 @@ PayloadTracker::PayloadTracker(
 
 PayloadTracker::~PayloadTracker() = default;
 
+void PayloadTracker::AddAttachment(int64_t payload_id, int64_t attachment_id,
+                                   int64_t size) {
+  ++total_attachments_count_;
+  auto [it, inserted] =
+      payload_state_.emplace(payload_id, State(attachment_id, size));
+  if (inserted) return;
+
+  // A file bundle carries several attachments in one payload.
+  State& state = it->second;
+  if (state.bundled_attachments.empty()) {
+    state.bundled_attachments.push_back(
+        {state.attachment_id, state.total_size});
+  }
+  state.bundled_attachments.push_back({attachment_id, size});
+  state.total_size += size;
+}
+
 void PayloadTracker::OnStatusUpdate(
     std::unique_ptr<PayloadTransferUpdate> update) {
   if (payload_state_.find(update->payload_id) == payload_state_.end()) {
@@ -104,7 +123,19 @@ void PayloadTracker::OnStatusUpdate(
                << update->payload_id;
     return;
   }
-  payload_update_queue_->Queue(std::move(update));
+  if (update->status != PayloadStatus::kInProgress) {
+    payload_update_queue_->Queue(std::move(update));
+    return;
+  }
+  // An update in progress supersedes the previous one of the same payload, if
+  // that one is still waiting to be processed.
+  int64_t payload_id = update->payload_id;
+  payload_update_queue_->QueueOrReplaceLast(
+      std::move(update),
+      [payload_id](const std::unique_ptr<PayloadTransferUpdate>& last) {
+        return last->payload_id == payload_id &&
+               last->status == PayloadStatus::kInProgress;
+      });
 }
 
 std::optional<TransferMetadata> PayloadTracker::ProcessPayloadUpdate(
@@ -125,8 +156,13 @@ std::optional<TransferMetadata> PayloadTracker::ProcessPayloadUpdate(
     LOG(INFO) << __func__ << ": Completed transfer of payload "
               << update->payload_id << " with attachment id "
               << state.attachment_id;
-    transferred_attachments_count_++;
+    transferred_attachments_count_ +=
+        std::max(static_cast<int>(state.bundled_attachments.size()), 1);
     confirmed_transfer_size_ += update->bytes_transferred;
+    in_progress_transfer_size_ -= state.amount_transferred;
+  } else if (update->bytes_transferred > state.amount_transferred) {
+    in_progress_transfer_size_ +=
+        update->bytes_transferred - state.amount_transferred;
   }
 
   // The number of bytes transferred should never go down. That said, some
@@ -146,7 +182,7 @@ std::optional<TransferMetadata> PayloadTracker::OnTransferUpdate(
     return TransferMetadataBuilder()
         .set_status(TransferMetadata::Status::kComplete)
         .set_progress(100)
-        .set_total_attachments_count(payload_state_.size())
+        .set_total_attachments_count(total_attachments_count_)
         .set_transferred_attachments_count(transferred_attachments_count_)
         .build();
   }
@@ -155,7 +191,7 @@ std::optional<TransferMetadata> PayloadTracker::OnTransferUpdate(
     VLOG(1) << __func__ << ": Payloads cancelled.";
     return TransferMetadataBuilder()
         .set_status(TransferMetadata::Status::kCancelled)
-        .set_total_attachments_count(payload_state_.size())
+        .set_total_attachments_count(total_attachments_count_)
         .set_transferred_attachments_count(transferred_attachments_count_)
         .build();
   }
@@ -164,20 +200,22 @@ std::optional<TransferMetadata> PayloadTracker::OnTransferUpdate(
     VLOG(1) << __func__ << ": Payloads failed.";
     return TransferMetadataBuilder()
         .set_status(TransferMetadata::Status::kFailed)
-        .set_total_attachments_count(payload_state_.size())
+        .set_total_attachments_count(total_attachments_count_)
         .set_transferred_attachments_count(transferred_attachments_count_)
         .build();
   }
 
-  double percent = CalculateProgressPercent(state);
+  double percent = CalculateProgressPercent();
   int current_progress = static_cast<int>(percent);
   absl::Time current_time = clock_->Now();
-  uint64_t current_transferred_size = GetTotalTransferred(state);
 
-  if (current_progress == last_update_progress_ &&
-      state.status != PayloadStatus::kSuccess) {
+  if (state.status != PayloadStatus::kSuccess &&
+      (current_progress == last_update_progress_ ||
+       current_time - last_progress_update_timestamp_ <
+           min_progress_update_interval_)) {
     return std::nullopt;
   }
+  uint64_t current_transferred_size = GetTotalTransferred();
 
   // Update transfer speed approximately every `kTransferSpeedUpdateInterval`
   // second.
@@ -219,6 +257,22 @@ std::optional<TransferMetadata> PayloadTracker::OnTransferUpdate(
   }
 
   last_update_progress_ = current_progress;
+  last_progress_update_timestamp_ = current_time;
+
+  // The attachment of a bundle currently transferred is found from the offsets
+  // of the attachments in the payload.
+  int64_t in_progress_attachment_id = state.attachment_id;
+  uint64_t in_progress_attachment_total_bytes = state.total_size;
+  uint64_t in_progress_attachment_transferred_bytes = state.amount_transferred;
+  uint64_t offset = 0;
+  for (const auto& [attachment_id, size] : state.bundled_attachments) {
+    in_progress_attachment_id = attachment_id;
+    in_progress_attachment_total_bytes = size;
+    in_progress_attachment_transferred_bytes =
+        std::min(state.amount_transferred - offset, size);
+    if (state.amount_transferred < offset + size) break;
+    offset += size;
+  }
 
   return TransferMetadataBuilder()
       .set_status(TransferMetadata::Status::kInProgress)
@@ -226,16 +280,18 @@ std::optional<TransferMetadata> PayloadTracker::OnTransferUpdate(
       .set_transferred_bytes(current_transferred_size)
       .set_transfer_speed(static_cast<uint64_t>(current_speed_))
       .set_estimated_time_remaining(std::llround(estimated_time_remaining_))
-      .set_total_attachments_count(payload_state_.size())
+      .set_total_attachments_count(total_attachments_count_)
       .set_transferred_attachments_count(transferred_attachments_count_)
-      .set_in_progress_attachment_id(state.attachment_id)
-      .set_in_progress_attachment_total_bytes(state.total_size)
-      .set_in_progress_attachment_transferred_bytes(state.amount_transferred)
+      .set_in_progress_attachment_id(in_progress_attachment_id)
+      .set_in_progress_attachment_total_bytes(
+          in_progress_attachment_total_bytes)
+      .set_in_progress_attachment_transferred_bytes(
+          in_progress_attachment_transferred_bytes)
       .build();
 }
 
 bool PayloadTracker::IsComplete() const {
-  return transferred_attachments_count_ == payload_state_.size();
+  return transferred_attachments_count_ == total_attachments_count_;
 }
 
 bool PayloadTracker::IsCancelled(const State& state) const {
@@ -246,20 +302,17 @@ bool PayloadTracker::HasFailed(const State& state) const {
   return state.status == PayloadStatus::kFailure;
 }
 
-uint64_t PayloadTracker::GetTotalTransferred(const State& state) const {
-  if (state.status == PayloadStatus::kSuccess) {
-    return confirmed_transfer_size_;
-  }
-  return confirmed_transfer_size_ + state.amount_transferred;
+uint64_t PayloadTracker::GetTotalTransferred() const {
+  return confirmed_transfer_size_ + in_progress_transfer_size_;
 }
 
-double PayloadTracker::CalculateProgressPercent(const State& state) const {
+double PayloadTracker::CalculateProgressPercent() const {
   if (!total_transfer_size_) {
     LOG(WARNING) << __func__ << ": Total attachment size is 0";
     return 100.0;
   }
 
-  return (100.0 * GetTotalTransferred(state)) / total_transfer_size_;
+  return (100.0 * GetTotalTransferred()) / total_transfer_size_;
 }
 
 }  // namespace sharing
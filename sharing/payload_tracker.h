@@ -20,6 +20,8 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <utility>
+#include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/time/time.h"
@@ -43,7 +45,8 @@ class PayloadTracker : public NearbyConnectionsManager::PayloadStatusListener {
       Clock* clock, int64_t share_target_id,
       const AttachmentContainer& container,
       const absl::flat_hash_map<int64_t, int64_t>& attachment_payload_map,
-      std::unique_ptr<PayloadUpdateQueue> payload_queue);
+      std::unique_ptr<PayloadUpdateQueue> payload_queue,
+      absl::Duration min_progress_update_interval = absl::ZeroDuration());
   ~PayloadTracker() override;
 
   std::optional<TransferMetadata> ProcessPayloadUpdate(
@@ -60,21 +63,30 @@ class PayloadTracker : public NearbyConnectionsManager::PayloadStatusListener {
 
     int64_t attachment_id = 0;
     uint64_t amount_transferred = 0;
-    const uint64_t total_size;
+    uint64_t total_size;
     PayloadStatus status = PayloadStatus::kInProgress;
+    // The IDs and sizes of the attachments of a file bundle, in the order of
+    // their bytes in the payload. Empty for a payload of one attachment.
+    std::vector<std::pair<int64_t, uint64_t>> bundled_attachments;
   };
 
+  void AddAttachment(int64_t payload_id, int64_t attachment_id, int64_t size);
+
   std::optional<TransferMetadata> OnTransferUpdate(const State& state);
 
   bool IsComplete() const;
   bool IsCancelled(const State& state) const;
   bool HasFailed(const State& state) const;
 
-  uint64_t GetTotalTransferred(const State& state) const;
-  double CalculateProgressPercent(const State& state) const;
+  // Counts the bytes of every payload, including the ones transferred in
+  // parallel with the payload of the current update.
+  uint64_t GetTotalTransferred() const;
+  double CalculateProgressPercent() const;
 
   Clock* const clock_;
   const int64_t share_target_id_;
+  // In-progress updates closer together than this are not reported.
+  const absl::Duration min_progress_update_interval_;
   std::unique_ptr<PayloadUpdateQueue> payload_update_queue_;
 
   // Map of payload id to state of payload.
@@ -82,8 +94,11 @@ class PayloadTracker : public NearbyConnectionsManager::PayloadStatusListener {
 
   uint64_t total_transfer_size_;
   uint64_t confirmed_transfer_size_;
+  // Bytes transferred so far of the payloads which haven't completed yet.
+  uint64_t in_progress_transfer_size_ = 0;
 
   int last_update_progress_ = 0;  // progress percentage
+  absl::Time last_progress_update_timestamp_ = absl::InfinitePast();
   absl::Time last_transfer_speed_update_timestamp_;
   absl::Time last_eta_update_timestamp_;
   uint64_t last_transferred_size_ = 0;
@@ -95,6 +110,7 @@ class PayloadTracker : public NearbyConnectionsManager::PayloadStatusListener {
 
   // Tracks transferred attachments count.
   int transferred_attachments_count_ = 0;
+  int total_attachments_count_ = 0;
 
   // For metrics.
   size_t num_text_attachments_ = 0;
@@ -17,6 +17,7 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <queue>
 #include <string>
 #include <utility>
 #include <vector>
@@ -101,6 +102,160 @@ TEST_F(PayloadTrackerTest, StatusUpdateWithTimeUpdate) {
   EXPECT_EQ(metadata->progress(), 3.0);
 }
 
+TEST(PayloadTrackerParallelTest, ProgressCountsAllPayloadsInFlight) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner{&fake_clock, 1};
+  AttachmentContainer container;
+  absl::flat_hash_map<int64_t, int64_t> attachment_payload_map;
+  for (int64_t id : {kFileId, kFileId + 1}) {
+    container.AddFileAttachment(FileAttachment(
+        id, kFileSize, std::string(kFileName), std::string(kMimeType),
+        service::proto::FileMetadata::IMAGE));
+    attachment_payload_map.emplace(id, id);
+  }
+  PayloadTracker payload_tracker(
+      &fake_clock, kShareTargetId, container, attachment_payload_map,
+      std::make_unique<PayloadTracker::PayloadUpdateQueue>(&task_runner));
+
+  std::optional<TransferMetadata> metadata =
+      payload_tracker.ProcessPayloadUpdate(
+          std::make_unique<PayloadTransferUpdate>(
+              kFileId, PayloadStatus::kInProgress, kFileSize,
+              /*bytes_transferred=*/kFileSize / 2));
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->progress(), 25.0);
+
+  metadata = payload_tracker.ProcessPayloadUpdate(
+      std::make_unique<PayloadTransferUpdate>(
+          kFileId + 1, PayloadStatus::kInProgress, kFileSize,
+          /*bytes_transferred=*/kFileSize / 2));
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->progress(), 50.0);
+  EXPECT_EQ(metadata->in_progress_attachment_id(), kFileId + 1);
+  EXPECT_EQ(metadata->in_progress_attachment_transferred_bytes(),
+            kFileSize / 2);
+
+  metadata = payload_tracker.ProcessPayloadUpdate(
+      std::make_unique<PayloadTransferUpdate>(
+          kFileId, PayloadStatus::kSuccess, kFileSize,
+          /*bytes_transferred=*/kFileSize));
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->progress(), 75.0);
+  EXPECT_EQ(metadata->transferred_attachments_count(), 1);
+}
+
+TEST(PayloadTrackerParallelTest, FileBundleReportsTheFileInProgress) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner{&fake_clock, 1};
+  AttachmentContainer container;
+  absl::flat_hash_map<int64_t, int64_t> attachment_payload_map;
+  // Both files are sent in payload `kFileId`.
+  for (int64_t id : {kFileId, kFileId + 1}) {
+    container.AddFileAttachment(FileAttachment(
+        id, kFileSize, std::string(kFileName), std::string(kMimeType),
+        service::proto::FileMetadata::IMAGE));
+    attachment_payload_map.emplace(id, kFileId);
+  }
+  PayloadTracker payload_tracker(
+      &fake_clock, kShareTargetId, container, attachment_payload_map,
+      std::make_unique<PayloadTracker::PayloadUpdateQueue>(&task_runner));
+
+  std::optional<TransferMetadata> metadata =
+      payload_tracker.ProcessPayloadUpdate(
+          std::make_unique<PayloadTransferUpdate>(
+              kFileId, PayloadStatus::kInProgress, 2 * kFileSize,
+              /*bytes_transferred=*/kFileSize + kFileSize / 2));
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->progress(), 75.0);
+  EXPECT_EQ(metadata->total_attachments_count(), 2);
+  EXPECT_EQ(metadata->in_progress_attachment_id(), kFileId + 1);
+  EXPECT_EQ(metadata->in_progress_attachment_total_bytes(), kFileSize);
+  EXPECT_EQ(metadata->in_progress_attachment_transferred_bytes(),
+            kFileSize / 2);
+
+  metadata = payload_tracker.ProcessPayloadUpdate(
+      std::make_unique<PayloadTransferUpdate>(
+          kFileId, PayloadStatus::kSuccess, 2 * kFileSize,
+          /*bytes_transferred=*/2 * kFileSize));
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->status(), TransferMetadata::Status::kComplete);
+  EXPECT_EQ(metadata->transferred_attachments_count(), 2);
+}
+
+TEST(PayloadTrackerRateLimitTest, LimitsInProgressUpdates) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner{&fake_clock, 1};
+  AttachmentContainer container;
+  container.AddFileAttachment(FileAttachment(
+      kFileId, kFileSize, std::string(kFileName), std::string(kMimeType),
+      service::proto::FileMetadata::IMAGE));
+  PayloadTracker payload_tracker(
+      &fake_clock, kShareTargetId, container, {{kFileId, kFileId}},
+      std::make_unique<PayloadTracker::PayloadUpdateQueue>(&task_runner),
+      /*min_progress_update_interval=*/absl::Milliseconds(100));
+  auto update = [&payload_tracker](PayloadStatus status,
+                                   int64_t bytes_transferred) {
+    return payload_tracker.ProcessPayloadUpdate(
+        std::make_unique<PayloadTransferUpdate>(kFileId, status, kFileSize,
+                                                bytes_transferred));
+  };
+
+  std::optional<TransferMetadata> metadata =
+      update(PayloadStatus::kInProgress, 1024);
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->progress(), 1.0);
+
+  // Too soon after the last update.
+  fake_clock.FastForward(absl::Milliseconds(50));
+  EXPECT_FALSE(update(PayloadStatus::kInProgress, 2048).has_value());
+
+  fake_clock.FastForward(absl::Milliseconds(50));
+  metadata = update(PayloadStatus::kInProgress, 3072);
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->progress(), 3.0);
+
+  // The completion of a payload is always reported.
+  metadata = update(PayloadStatus::kSuccess, kFileSize);
+  ASSERT_TRUE(metadata.has_value());
+  EXPECT_EQ(metadata->status(), TransferMetadata::Status::kComplete);
+}
+
+TEST(PayloadTrackerQueueTest, CoalescesQueuedInProgressUpdates) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner{&fake_clock, 1};
+  AttachmentContainer container;
+  absl::flat_hash_map<int64_t, int64_t> attachment_payload_map;
+  for (int64_t id : {kFileId, kFileId + 1}) {
+    container.AddFileAttachment(FileAttachment(
+        id, kFileSize, std::string(kFileName), std::string(kMimeType),
+        service::proto::FileMetadata::IMAGE));
+    attachment_payload_map.emplace(id, id);
+  }
+  auto payload_updates_queue =
+      std::make_unique<PayloadTracker::PayloadUpdateQueue>(&task_runner);
+  PayloadTracker::PayloadUpdateQueue* queue = payload_updates_queue.get();
+  PayloadTracker payload_tracker(&fake_clock, kShareTargetId, container,
+                                 attachment_payload_map,
+                                 std::move(payload_updates_queue));
+  auto update = [&payload_tracker](int64_t payload_id, PayloadStatus status,
+                                   int64_t bytes_transferred) {
+    payload_tracker.OnStatusUpdate(std::make_unique<PayloadTransferUpdate>(
+        payload_id, status, kFileSize, bytes_transferred));
+  };
+
+  update(kFileId, PayloadStatus::kInProgress, 1024);
+  update(kFileId, PayloadStatus::kInProgress, 2048);
+  update(kFileId + 1, PayloadStatus::kInProgress, 1024);
+  update(kFileId + 1, PayloadStatus::kSuccess, kFileSize);
+  update(kFileId + 1, PayloadStatus::kInProgress, kFileSize);
+
+  std::queue<std::unique_ptr<PayloadTransferUpdate>> updates = queue->ReadAll();
+  ASSERT_EQ(updates.size(), 4);
+  EXPECT_EQ(updates.front()->payload_id, kFileId);
+  EXPECT_EQ(updates.front()->bytes_transferred, 2048);
+  EXPECT_EQ(queue->GetStats().replaced_count, 1);
+}
+
 }  // namespace
 }  // namespace sharing
 }  // namespace nearby
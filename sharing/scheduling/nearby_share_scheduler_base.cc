@@ -24,9 +24,12 @@
 #include <string>
 #include <utility>
 
+#include "absl/random/random.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 #include "absl/time/time.h"
+#include "internal/flags/nearby_flags.h"
+#include "sharing/flags/generated/nearby_sharing_feature_flags.h"
 #include "sharing/internal/api/preference_manager.h"
 #include "sharing/internal/public/connectivity_manager.h"
 #include "sharing/internal/public/context.h"
@@ -34,6 +37,7 @@
 #include "sharing/scheduling/format.h"
 #include "sharing/scheduling/nearby_share_scheduler.h"
 #include "sharing/scheduling/nearby_share_scheduler_fields.h"
+#include "sharing/scheduling/nearby_share_scheduler_utils.h"
 
 namespace nearby {
 namespace sharing {
@@ -44,6 +48,17 @@ using ::nearby::sharing::api::PreferenceManager;
 constexpr absl::Duration kZeroTimeDelta = absl::ZeroDuration();
 constexpr absl::Duration kBaseRetryDelay = absl::Seconds(5);
 constexpr absl::Duration kMaxRetryDelay = absl::Hours(1);
+constexpr absl::Duration kWakeUpCoalescingWindow = absl::Minutes(15);
+
+// The offset of the wake-up grid, chosen once per process.
+absl::Duration GetWakeUpGridPhase() {
+  static const absl::Duration phase = [] {
+    absl::BitGen bitgen;
+    return absl::Milliseconds(absl::Uniform<int64_t>(
+        bitgen, 0, absl::ToInt64Milliseconds(kWakeUpCoalescingWindow)));
+  }();
+  return phase;
+}
 
 }  // namespace
 
@@ -57,6 +72,9 @@ NearbyShareSchedulerBase::NearbyShareSchedulerBase(
       clock_(context->GetClock()),
       retry_failures_(retry_failures),
       require_connectivity_(require_connectivity),
+      coalesce_wake_ups_(NearbyFlags::GetInstance().GetBoolFlag(
+          config_package_nearby::nearby_sharing_feature::
+              kEnableSchedulerWakeUpCoalescing)),
       pref_name_(pref_name) {
   timer_ = context->CreateTimer();
   connection_listener_name_ = absl::Substitute(
@@ -115,6 +133,11 @@ void NearbyShareSchedulerBase::Reschedule() {
   std::optional<absl::Duration> delay = GetTimeUntilNextRequest();
   if (!delay.has_value()) return;
 
+  if (coalesce_wake_ups_) {
+    delay = CoalesceRequestDelay(clock_->Now(), *delay,
+                                 kWakeUpCoalescingWindow, GetWakeUpGridPhase());
+  }
+
   int64_t delay_milliseconds = (*delay) / absl::Milliseconds(1);
 
   timer_->Start(delay_milliseconds, delay_milliseconds,
@@ -44,6 +44,11 @@ namespace sharing {
 // The scheduler waits until the device is online before notifying the owner if
 // network connectivity is required.
 //
+// With wake-up coalescing enabled, recurring requests are pulled forward onto a
+// wake-up grid shared by all schedulers of the process, so that requests that
+// are due close together wake the device and the radio once. The grid has a
+// random per-process offset so that devices don't all hit the server at once.
+//
 // Derived classes must override TimeUntilRecurringRequest() to establish the
 // desired recurring request behavior of the scheduler.
 class NearbyShareSchedulerBase : public NearbyShareScheduler {
@@ -117,6 +122,7 @@ class NearbyShareSchedulerBase : public NearbyShareScheduler {
 
   const bool retry_failures_;
   const bool require_connectivity_;
+  const bool coalesce_wake_ups_;
   const std::string pref_name_;
   bool is_initialized_ = false;
   std::string connection_listener_name_;
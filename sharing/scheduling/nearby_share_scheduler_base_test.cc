@@ -19,12 +19,17 @@
 #include <algorithm>
 #include <memory>
 #include <optional>
+#include <set>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
+#include "internal/flags/nearby_flags.h"
 #include "internal/test/fake_clock.h"
+#include "sharing/flags/generated/nearby_sharing_feature_flags.h"
 #include "sharing/internal/test/fake_context.h"
 #include "sharing/internal/test/fake_preference_manager.h"
 #include "sharing/scheduling/nearby_share_scheduler.h"
@@ -404,6 +409,42 @@ TEST_F(NearbyShareSchedulerBaseTest, RestoreSchedulingData) {
   EXPECT_EQ(scheduler()->GetNumConsecutiveFailures(), 1u);
 }
 
+TEST(NearbyShareSchedulerBaseCoalescingTest, CoalescesRequestsDueTogether) {
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      config_package_nearby::nearby_sharing_feature::
+          kEnableSchedulerWakeUpCoalescing,
+      true);
+  nearby::FakePreferenceManager preference_manager;
+  nearby::FakeContext fake_context;
+  absl::Time start = fake_context.GetClock()->Now();
+  std::vector<absl::Time> request_times;
+  std::vector<std::unique_ptr<NearbyShareSchedulerBaseForTest>> schedulers;
+  for (int i = 0; i < 3; ++i) {
+    schedulers.push_back(std::make_unique<NearbyShareSchedulerBaseForTest>(
+        &fake_context, preference_manager,
+        kTestTimeUntilRecurringRequest + absl::Minutes(5 * i),
+        /*retry_failures=*/true, /*require_connectivity=*/false,
+        absl::StrCat(kTestPrefName, i), [&]() {
+          request_times.push_back(fake_context.GetClock()->Now());
+        }));
+    schedulers.back()->Start();
+  }
+
+  while (fake_context.GetClock()->Now() <
+         start + kTestTimeUntilRecurringRequest + absl::Minutes(10)) {
+    fake_context.fake_clock()->FastForward(absl::Seconds(1));
+  }
+
+  // The requests are due within 10 minutes of each other, so at most one grid
+  // point falls between them, and none fires late.
+  ASSERT_EQ(request_times.size(), 3u);
+  EXPECT_LE(std::set<absl::Time>(request_times.begin(), request_times.end())
+                .size(),
+            2u);
+  EXPECT_LE(request_times[0], start + kTestTimeUntilRecurringRequest);
+  NearbyFlags::GetInstance().ResetOverridedValues();
+}
+
 }  // namespace
 }  // namespace sharing
 }  // namespace nearby
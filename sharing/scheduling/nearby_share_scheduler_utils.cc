@@ -82,4 +82,16 @@ std::string ConvertToReadableSchedule(PreferenceManager& preference_manager,
   return result;
 }
 
+absl::Duration CoalesceRequestDelay(absl::Time now, absl::Duration delay,
+                                    absl::Duration window,
+                                    absl::Duration phase) {
+  if (window <= absl::ZeroDuration() || delay < window) return delay;
+
+  absl::Time grid_origin = absl::UnixEpoch() + phase;
+  absl::Duration since_origin = now + delay - grid_origin;
+  absl::Time grid_point = grid_origin + absl::Floor(since_origin, window);
+  // |delay| >= |window| keeps the grid point after |now|.
+  return grid_point - now;
+}
+
 }  // namespace nearby::sharing
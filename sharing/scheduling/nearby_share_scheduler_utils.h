@@ -18,6 +18,7 @@
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "sharing/internal/api/preference_manager.h"
 
 namespace nearby::sharing {
@@ -27,6 +28,15 @@ std::string ConvertToReadableSchedule(
     nearby::sharing::api::PreferenceManager& preference_manager,
     absl::string_view schedule_preference);
 
+// Returns the delay until the wake-up grid point that a request due in |delay|
+// from |now| is coalesced to. Grid points are |window| apart, offset from the
+// Unix epoch by |phase|, so that all requests due within the same window fire
+// together. A request is never delayed, only pulled forward by less than
+// |window|; requests due sooner than |window| are not coalesced.
+absl::Duration CoalesceRequestDelay(absl::Time now, absl::Duration delay,
+                                    absl::Duration window,
+                                    absl::Duration phase);
+
 }  // namespace nearby::sharing
 
 #endif  // THIRD_PARTY_NEARBY_SHARING_SCHEDULING_NEARBY_SHARE_SCHEDULER_UTILS_H_
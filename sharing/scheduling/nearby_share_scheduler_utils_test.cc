@@ -22,6 +22,7 @@
 #include "protobuf-matchers/protocol-buffer-matchers.h"
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "sharing/internal/api/preference_manager.h"
 #include "sharing/internal/test/fake_preference_manager.h"
 #include "sharing/scheduling/nearby_share_scheduler_fields.h"
@@ -115,4 +116,30 @@ TEST_F(NearbyShareSchedulerUtilsTest, ConvertToReadableScheduleMissingFields) {
   EXPECT_THAT(debug_str, Eq("{failed_count:345, is_waiting_for_result:true}"));
 }
 
+TEST(NearbyShareSchedulerUtilsCoalesceTest, PullsRequestToGridPoint) {
+  absl::Time now = absl::UnixEpoch() + absl::Hours(100);
+
+  // Grid points are at now + 5min + k * 15min.
+  EXPECT_EQ(CoalesceRequestDelay(now, absl::Minutes(30), absl::Minutes(15),
+                                 absl::Minutes(5)),
+            absl::Minutes(20));
+  EXPECT_EQ(CoalesceRequestDelay(now, absl::Minutes(34), absl::Minutes(15),
+                                 absl::Minutes(5)),
+            absl::Minutes(20));
+  EXPECT_EQ(CoalesceRequestDelay(now, absl::Minutes(35), absl::Minutes(15),
+                                 absl::Minutes(5)),
+            absl::Minutes(35));
+}
+
+TEST(NearbyShareSchedulerUtilsCoalesceTest, KeepsRequestsDueSoon) {
+  absl::Time now = absl::UnixEpoch() + absl::Hours(100);
+
+  EXPECT_EQ(CoalesceRequestDelay(now, absl::Minutes(14), absl::Minutes(15),
+                                 absl::Minutes(5)),
+            absl::Minutes(14));
+  EXPECT_EQ(CoalesceRequestDelay(now, absl::ZeroDuration(), absl::Minutes(15),
+                                 absl::Minutes(5)),
+            absl::ZeroDuration());
+}
+
 }  // namespace nearby::sharing
@@ -132,6 +132,14 @@ void ShareSession::UpdateTransferMetadata(
     return;
   }
   got_final_status_ = transfer_metadata.is_final_status();
+  if (got_final_status_ && payload_updates_queue_ != nullptr) {
+    PayloadTracker::PayloadUpdateQueue::Stats stats =
+        payload_updates_queue_->GetStats();
+    VLOG(1) << __func__ << ": Queued " << stats.queued_count
+            << " payload updates for " << share_target_.id
+            << ", max depth: " << stats.max_depth
+            << ", max latency: " << stats.max_latency;
+  }
   InvokeTransferUpdateCallback(transfer_metadata);
 }
 
@@ -194,7 +202,9 @@ void ShareSession::RunPairedKeyVerification(
       absl::bind_front(&ShareSession::WriteFrame, this),
       certificate_, certificate_manager, frames_reader_.get(),
       kReadFramesTimeout);
-  key_verification_runner_->Run(std::move(callback));
+  key_verification_runner_->Run(
+      std::move(callback),
+      absl::bind_front(&ShareSession::OnLocalKeyVerificationResult, this));
 }
 
 void ShareSession::OnDisconnect() {
@@ -234,12 +244,15 @@ void ShareSession::WriteFrame(const Frame& frame) {
 }
 
 void ShareSession::WriteResponseFrame(
-    ConnectionResponseFrame::Status response_status) {
+    ConnectionResponseFrame::Status response_status, bool accept_file_bundles) {
   Frame frame;
   frame.set_version(Frame::V1);
   V1Frame* v1_frame = frame.mutable_v1();
   v1_frame->set_type(V1Frame::RESPONSE);
   v1_frame->mutable_connection_response()->set_status(response_status);
+  if (accept_file_bundles) {
+    v1_frame->mutable_connection_response()->set_accept_file_bundles(true);
+  }
 
   WriteFrame(frame);
 }
@@ -297,11 +310,13 @@ bool ShareSession::HandleKeyVerificationResult(
 void ShareSession::InitializePayloadTracker(
     absl::AnyInvocable<void()> payload_transfer_updates_callback) {
   auto payload_updates_queue =
-      std::make_unique<PayloadTracker::PayloadUpdateQueue>(&service_thread());
+      std::make_unique<PayloadTracker::PayloadUpdateQueue>(
+          &service_thread(),
+          PayloadTracker::PayloadUpdateQueue::Options{.clock = &clock_});
   payload_updates_queue_ = payload_updates_queue.get();
   payload_tracker_ = std::make_shared<PayloadTracker>(
       &clock_, share_target_.id, attachment_container_, attachment_payload_map_,
-      std::move(payload_updates_queue));
+      std::move(payload_updates_queue), kMinTransferProgressUpdateInterval);
   payload_updates_queue_->Start(std::move(payload_transfer_updates_callback));
 }
 
@@ -125,9 +125,11 @@ class ShareSession {
     return attachment_payload_map_;
   }
 
+  // `accept_file_bundles` asks the sender to send the file bundles it offered.
   void WriteResponseFrame(
       nearby::sharing::service::proto::ConnectionResponseFrame::Status
-          response_status);
+          response_status,
+      bool accept_file_bundles = false);
   void WriteCancelFrame();
 
   void SetTokenForTests(std::string token) { token_ = std::move(token); }
@@ -138,6 +140,10 @@ class ShareSession {
   virtual void InvokeTransferUpdateCallback(
       const TransferMetadata& metadata) = 0;
   virtual void OnConnectionDisconnected() {}
+  // Called during paired key verification with the local result, once the
+  // local result frame is written and before the remote one is read.
+  virtual void OnLocalKeyVerificationResult(
+      PairedKeyVerificationRunner::PairedKeyVerificationResult result) {}
   void SetConnection(NearbyConnection* connection);
   void SetAttachmentContainer(AttachmentContainer container) {
     attachment_container_ = std::move(container);
@@ -14,6 +14,7 @@
 
 #include "sharing/transfer_manager.h"
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -22,6 +23,8 @@
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
 #include "absl/time/time.h"
+#include "internal/flags/nearby_flags.h"
+#include "sharing/flags/generated/nearby_sharing_feature_flags.h"
 #include "sharing/internal/public/context.h"
 #include "sharing/internal/public/logging.h"
 #include "sharing/nearby_connections_types.h"
@@ -41,6 +44,22 @@ bool IsHighQualityMedium(Medium medium) {
   return false;
 }
 
+// A conservative estimate of the throughput of a low quality medium, in bytes
+// per second.
+int64_t GetExpectedBytesPerSecond(Medium medium) {
+  switch (medium) {
+    case Medium::kBle:
+    case Medium::kNfc:
+      return 10 * 1024;
+    case Medium::kBleL2Cap:
+      return 50 * 1024;
+    case Medium::kBluetooth:
+    default:
+      // Connections start over Bluetooth until told otherwise.
+      return 150 * 1024;
+  }
+}
+
 }  // namespace
 
 TransferManager::TransferManager(Context* context,
@@ -53,9 +72,28 @@ TransferManager::~TransferManager() {
   pending_tasks_.clear();
 }
 
-void TransferManager::Send(std::function<void()> task) {
+void TransferManager::Send(std::function<void()> task, int64_t size) {
   absl::MutexLock lock(&mutex_);
 
+  if (is_waiting_for_high_quality_medium_ &&
+      NearbyFlags::GetInstance().GetBoolFlag(
+          config_package_nearby::nearby_sharing_feature::
+              kStartTransferBeforeMediumUpgrade)) {
+    NL_LOG(INFO) << "Connection to endpoint " << endpoint_id_
+                 << " starts payload transfer before the medium upgrade.";
+    StopWaitingForHighQualityMedium();
+  }
+
+  // Never overtakes a file that waits.
+  if (is_waiting_for_high_quality_medium_ && pending_tasks_.empty() &&
+      IsQuickOnCurrentMedium(size)) {
+    NL_LOG(INFO) << "Connection to endpoint " << endpoint_id_
+                 << " sends a payload of " << size
+                 << " bytes without waiting for a high quality medium.";
+    task();
+    return;
+  }
+
   if (is_waiting_for_high_quality_medium_) {
     NL_LOG(INFO)
         << "Connection to endpoint " << endpoint_id_
@@ -69,6 +107,7 @@ void TransferManager::Send(std::function<void()> task) {
 
 void TransferManager::OnMediumQualityChanged(Medium current_medium) {
   absl::MutexLock lock(&mutex_);
+  current_medium_ = current_medium;
 
   if (!is_waiting_for_high_quality_medium_) {
     NL_LOG(WARNING) << "It is not waiting for high quality medium.";
@@ -131,6 +170,16 @@ bool TransferManager::CancelTransfer() {
   return true;
 }
 
+bool TransferManager::IsQuickOnCurrentMedium(int64_t size) const {
+  if (size <= 0 || !NearbyFlags::GetInstance().GetBoolFlag(
+                       config_package_nearby::nearby_sharing_feature::
+                           kEnableAdaptiveMediumUpgradeWait)) {
+    return false;
+  }
+  return size <= GetExpectedBytesPerSecond(current_medium_) *
+                     absl::ToInt64Seconds(kMaxTransferDurationWithoutUpgrade);
+}
+
 void TransferManager::StopWaitingForHighQualityMedium() {
   is_waiting_for_high_quality_medium_ = false;
 
@@ -15,6 +15,7 @@
 #ifndef THIRD_PARTY_NEARBY_SHARING_TRANSFER_MANAGER_H_
 #define THIRD_PARTY_NEARBY_SHARING_TRANSFER_MANAGER_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -34,16 +35,28 @@ namespace sharing {
 // TransferManager is used to delay the payload transfer until the medium
 // quality is in high quality. If the quality doesn't change in a duration, it
 // will give up to wait for the medium change.
+//
+// With kEnableAdaptiveMediumUpgradeWait, a file that the current medium is
+// expected to transfer within kMaxTransferDurationWithoutUpgrade is sent right
+// away, as long as no earlier file is waiting. With
+// kStartTransferBeforeMediumUpgrade, nothing waits: files start on the current
+// medium, and a make-before-break upgrade takes them over mid-transfer.
 class TransferManager {
  public:
   // Used to wait for the medium upgrade.
   static constexpr absl::Duration kMediumUpgradeTimeout = absl::Seconds(10);
+  // Files the current medium transfers within this long don't wait for the
+  // upgrade, which would take longer than the transfer itself.
+  static constexpr absl::Duration kMaxTransferDurationWithoutUpgrade =
+      absl::Seconds(2);
 
   TransferManager(Context* context, absl::string_view endpoint_id);
 
   ~TransferManager();
 
-  void Send(std::function<void()> task) ABSL_LOCKS_EXCLUDED(mutex_);
+  // |size| is the size of the file sent by |task|, or 0 if unknown.
+  void Send(std::function<void()> task, int64_t size = 0)
+      ABSL_LOCKS_EXCLUDED(mutex_);
   void OnMediumQualityChanged(Medium current_medium)
       ABSL_LOCKS_EXCLUDED(mutex_);
   bool StartTransfer() ABSL_LOCKS_EXCLUDED(mutex_);
@@ -51,11 +64,17 @@ class TransferManager {
 
  private:
   void StopWaitingForHighQualityMedium() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Whether a file of |size| bytes is sent over the current medium quickly
+  // enough not to wait for the upgrade.
+  bool IsQuickOnCurrentMedium(int64_t size) const
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
   Context* context_;
   std::string endpoint_id_;
   absl::Mutex mutex_;
   bool is_waiting_for_high_quality_medium_ ABSL_GUARDED_BY(mutex_) = true;
+  // Unknown until the first bandwidth change is reported.
+  Medium current_medium_ ABSL_GUARDED_BY(mutex_) = Medium::kUnknown;
   std::vector<std::function<void()>> pending_tasks_ ABSL_GUARDED_BY(mutex_);
   std::unique_ptr<ThreadTimer> timeout_timer_ ABSL_GUARDED_BY(mutex_) = nullptr;
 };
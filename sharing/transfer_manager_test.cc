@@ -14,13 +14,17 @@
 
 #include "sharing/transfer_manager.h"
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/notification.h"
 #include "absl/time/time.h"
+#include "internal/flags/nearby_flags.h"
 #include "internal/test/fake_clock.h"
+#include "sharing/flags/generated/nearby_sharing_feature_flags.h"
 #include "sharing/internal/test/fake_context.h"
 #include "sharing/nearby_connections_types.h"
 
@@ -176,6 +180,66 @@ TEST(TransferManager, MediumUpgradeBeforeStartTransfer) {
   ASSERT_TRUE(is_called);
 }
 
+TEST(TransferManager, AdaptiveWaitSendsSmallFileRightAway) {
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      config_package_nearby::nearby_sharing_feature::
+          kEnableAdaptiveMediumUpgradeWait,
+      true);
+  FakeContext context;
+  std::vector<std::string> sent;
+
+  TransferManager transfer_manager{&context, kEndpointId};
+  transfer_manager.OnMediumQualityChanged(Medium::kBluetooth);
+  transfer_manager.Send([&]() { sent.push_back("small"); }, /*size=*/1024);
+  ASSERT_TRUE(transfer_manager.StartTransfer());
+  EXPECT_EQ(sent, std::vector<std::string>{"small"});
+
+  // A large file waits for the upgrade, and so does a small one behind it.
+  transfer_manager.Send([&]() { sent.push_back("large"); },
+                        /*size=*/int64_t{1} << 30);
+  transfer_manager.Send([&]() { sent.push_back("small 2"); }, /*size=*/1024);
+  EXPECT_EQ(sent.size(), 1u);
+
+  transfer_manager.OnMediumQualityChanged(Medium::kWifiLan);
+  EXPECT_EQ(sent, (std::vector<std::string>{"small", "large", "small 2"}));
+  NearbyFlags::GetInstance().ResetOverridedValues();
+}
+
+TEST(TransferManager, AdaptiveWaitHoldsFilesOnSlowMedium) {
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      config_package_nearby::nearby_sharing_feature::
+          kEnableAdaptiveMediumUpgradeWait,
+      true);
+  FakeContext context;
+  bool is_called = false;
+
+  TransferManager transfer_manager{&context, kEndpointId};
+  transfer_manager.OnMediumQualityChanged(Medium::kBle);
+  // Takes longer than kMaxTransferDurationWithoutUpgrade over BLE.
+  transfer_manager.Send([&]() { is_called = true; }, /*size=*/1024 * 1024);
+  ASSERT_TRUE(transfer_manager.StartTransfer());
+
+  EXPECT_FALSE(is_called);
+  NearbyFlags::GetInstance().ResetOverridedValues();
+}
+
+TEST(TransferManager, StartsTransferBeforeMediumUpgrade) {
+  NearbyFlags::GetInstance().OverrideBoolFlagValue(
+      config_package_nearby::nearby_sharing_feature::
+          kStartTransferBeforeMediumUpgrade,
+      true);
+  FakeContext context;
+  bool is_called = false;
+
+  TransferManager transfer_manager{&context, kEndpointId};
+  transfer_manager.Send([&]() { is_called = true; },
+                        /*size=*/int64_t{1} << 30);
+
+  EXPECT_TRUE(is_called);
+  EXPECT_FALSE(transfer_manager.StartTransfer());
+  NearbyFlags::GetInstance().ResetOverridedValues();
+}
+
 }  // namespace
 }  // namespace sharing
 }  // namespace nearby
@@ -15,13 +15,19 @@
 #ifndef THIRD_PARTY_NEARBY_SHARING_WORKER_QUEUE_H_
 #define THIRD_PARTY_NEARBY_SHARING_WORKER_QUEUE_H_
 
+#include <stddef.h>
+
 #include <atomic>
+#include <cstdint>
 #include <queue>
 #include <utility>
 
 #include "absl/base/thread_annotations.h"
 #include "absl/functional/any_invocable.h"
+#include "absl/functional/function_ref.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "internal/platform/clock.h"
 #include "internal/platform/task_runner.h"
 #include "sharing/internal/public/logging.h"
 
@@ -32,13 +38,53 @@ namespace nearby::sharing {
 // The callback is edge triggered, i.e. it will only be scheduled when the queue
 // changes from empty to non-empty.  This object guarantees that only 1 callback
 // is scheduled at a time until the `ReadAll` method is called which resets the
-// scheduling state.
+// scheduling state.  Items queued by several producers meanwhile are handed to
+// the callback in one batch.
+//
+// The queue may be bounded, see `Options`.
 //
 // This class is thread-safe.
 template <typename T>
 class WorkerQueue {
  public:
-  explicit WorkerQueue(TaskRunner* task_runner) : task_runner_(task_runner) {}
+  // What `Queue` does with an item when the queue is full.
+  enum class OverflowPolicy {
+    // Waits until the worker reads the queue, or the queue is stopped.
+    kBlock,
+    // Drops the new item.
+    kDropNewest,
+    // Drops the oldest queued item to make room for the new one.
+    kDropOldest,
+  };
+
+  struct Options {
+    // Maximum number of queued items. 0 means unbounded.
+    size_t max_size = 0;
+    OverflowPolicy overflow_policy = OverflowPolicy::kBlock;
+    // Used to measure how long items wait to be read. Latency is not measured
+    // if null.
+    const Clock* clock = nullptr;
+  };
+
+  struct Stats {
+    // Number of items queued, including the dropped ones.
+    uint64_t queued_count = 0;
+    // Number of items dropped because the queue was full or stopped.
+    uint64_t dropped_count = 0;
+    // Number of items that replaced the last queued item, see
+    // `QueueOrReplaceLast`. They are not counted in `queued_count`.
+    uint64_t replaced_count = 0;
+    // Largest number of items waiting to be read at once.
+    size_t max_depth = 0;
+    // Longest time between queuing the first item of a batch and reading the
+    // batch with `ReadAll`.
+    absl::Duration max_latency = absl::ZeroDuration();
+  };
+
+  explicit WorkerQueue(TaskRunner* task_runner)
+      : WorkerQueue(task_runner, Options()) {}
+  WorkerQueue(TaskRunner* task_runner, Options options)
+      : task_runner_(task_runner), options_(options) {}
 
   ~WorkerQueue() { Stop(); }
 
@@ -66,9 +112,14 @@ class WorkerQueue {
     return true;
   }
 
-  // Stops the queue.  No new callback will be scheduled.
+  // Stops the queue.  No new callback will be scheduled, and producers
+  // blocked on a full queue return.
   void Stop() {
     bool already_stopped = is_stopped_.exchange(true);
+    {
+      absl::MutexLock lock(&mutex_);
+      not_full_.SignalAll();
+    }
     if (already_stopped || !is_started_) {
       return;
     }
@@ -77,10 +128,55 @@ class WorkerQueue {
 
   // Queues an item to be processed by the callback.
   // Callback are edge triggered.
-  void Queue(T item) {
+  // Returns false if the item was dropped.
+  bool Queue(T item) {
     absl::MutexLock lock(&mutex_);
+    stats_.queued_count++;
+    if (IsFull()) {
+      switch (options_.overflow_policy) {
+        case OverflowPolicy::kBlock:
+          while (IsFull() && !is_stopped_) {
+            not_full_.Wait(&mutex_);
+          }
+          if (is_stopped_) {
+            stats_.dropped_count++;
+            return false;
+          }
+          break;
+        case OverflowPolicy::kDropNewest:
+          stats_.dropped_count++;
+          return false;
+        case OverflowPolicy::kDropOldest:
+          queue_.pop();
+          stats_.dropped_count++;
+          break;
+      }
+    }
+    if (queue_.empty() && options_.clock != nullptr) {
+      oldest_item_time_ = options_.clock->Now();
+    }
     queue_.push(std::move(item));
+    if (queue_.size() > stats_.max_depth) {
+      stats_.max_depth = queue_.size();
+    }
     ScheduleCallback();
+    return true;
+  }
+
+  // Replaces the last queued item, if it is still waiting to be read and
+  // `replaces` returns true for it, with `item`.  Queues `item` otherwise.
+  // Replacing an item never blocks nor drops an item.
+  // Returns false if the item was dropped.
+  bool QueueOrReplaceLast(T item, absl::FunctionRef<bool(const T&)> replaces) {
+    {
+      absl::MutexLock lock(&mutex_);
+      if (!queue_.empty() && replaces(queue_.back())) {
+        queue_.back() = std::move(item);
+        stats_.replaced_count++;
+        return true;
+      }
+    }
+    return Queue(std::move(item));
   }
 
   // Returns all the items in the queue and clears the queue.
@@ -91,21 +187,35 @@ class WorkerQueue {
     absl::MutexLock lock(&mutex_);
     std::queue<T> queue;
     queue.swap(queue_);
+    if (!queue.empty() && options_.clock != nullptr) {
+      absl::Duration latency = options_.clock->Now() - oldest_item_time_;
+      if (latency > stats_.max_latency) {
+        stats_.max_latency = latency;
+      }
+    }
+    not_full_.SignalAll();
     return queue;
   }
 
+  Stats GetStats() const {
+    absl::MutexLock lock(&mutex_);
+    return stats_;
+  }
+
  private:
+  bool IsFull() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return options_.max_size > 0 && queue_.size() >= options_.max_size;
+  }
+
   void ScheduleCallback() {
     // Skip if not started or stopped
     if (!is_started_ || is_stopped_) {
       return;
     }
     if (is_scheduled_.exchange(true)) {
-      LOG(ERROR) << "Already scheduled";
       // Already scheduled.
       return;
     }
-    LOG(ERROR) << "Scheduling callback";
     task_runner_->PostTask([this]() {
       if (is_stopped_) {
         return;
@@ -115,13 +225,18 @@ class WorkerQueue {
   }
 
   TaskRunner* const task_runner_ = nullptr;
+  const Options options_;
   absl::AnyInvocable<void()> callback_;
   // Tracks whether Start() has been called.
   std::atomic<bool> is_started_ = false;
   // Tracks whether Stop() has been called.
   std::atomic<bool> is_stopped_ = false;
-  absl::Mutex mutex_;
+  mutable absl::Mutex mutex_;
+  absl::CondVar not_full_;
   std::queue<T> queue_ ABSL_GUARDED_BY(mutex_);
+  // When the oldest item of `queue_` was queued.
+  absl::Time oldest_item_time_ ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
   // This is used track whether the callback is already scheduled so as to avoid
   // scheduling multiple callbacks.
   // `is_scheduled_` must be false if is_started_ is false.
@@ -18,6 +18,7 @@
 
 #include "gtest/gtest.h"
 #include "absl/synchronization/notification.h"
+#include "absl/time/time.h"
 #include "internal/test/fake_clock.h"
 #include "internal/test/fake_task_runner.h"
 
@@ -110,5 +111,122 @@ TEST(WorkerQueueTest, StopStopsCallback) {
   // No more callbacks.
 }
 
+TEST(WorkerQueueTest, DropNewestWhenFull) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner(&fake_clock, 1);
+  WorkerQueue<int> queue(
+      &task_runner,
+      {.max_size = 2,
+       .overflow_policy = WorkerQueue<int>::OverflowPolicy::kDropNewest});
+  EXPECT_TRUE(queue.Queue(1));
+  EXPECT_TRUE(queue.Queue(2));
+  EXPECT_FALSE(queue.Queue(3));
+
+  std::queue<int> items = queue.ReadAll();
+  EXPECT_EQ(items.size(), 2);
+  EXPECT_EQ(items.front(), 1);
+  EXPECT_EQ(items.back(), 2);
+  EXPECT_EQ(queue.GetStats().dropped_count, 1);
+}
+
+TEST(WorkerQueueTest, DropOldestWhenFull) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner(&fake_clock, 1);
+  WorkerQueue<int> queue(
+      &task_runner,
+      {.max_size = 2,
+       .overflow_policy = WorkerQueue<int>::OverflowPolicy::kDropOldest});
+  EXPECT_TRUE(queue.Queue(1));
+  EXPECT_TRUE(queue.Queue(2));
+  EXPECT_TRUE(queue.Queue(3));
+
+  std::queue<int> items = queue.ReadAll();
+  EXPECT_EQ(items.size(), 2);
+  EXPECT_EQ(items.front(), 2);
+  EXPECT_EQ(items.back(), 3);
+  EXPECT_EQ(queue.GetStats().dropped_count, 1);
+}
+
+TEST(WorkerQueueTest, BlockWhenFullUntilRead) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner(&fake_clock, 1);
+  WorkerQueue<int> queue(&task_runner, {.max_size = 1});
+  absl::Notification queued;
+  EXPECT_TRUE(queue.Queue(1));
+  task_runner.PostTask([&queue, &queued]() {
+    EXPECT_TRUE(queue.Queue(2));
+    queued.Notify();
+  });
+  EXPECT_FALSE(queued.WaitForNotificationWithTimeout(absl::Milliseconds(50)));
+
+  std::queue<int> items = queue.ReadAll();
+  EXPECT_EQ(items.front(), 1);
+  queued.WaitForNotification();
+  items = queue.ReadAll();
+  EXPECT_EQ(items.front(), 2);
+}
+
+TEST(WorkerQueueTest, StopReleasesBlockedProducer) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner(&fake_clock, 1);
+  WorkerQueue<int> queue(&task_runner, {.max_size = 1});
+  absl::Notification dropped;
+  EXPECT_TRUE(queue.Queue(1));
+  task_runner.PostTask([&queue, &dropped]() {
+    EXPECT_FALSE(queue.Queue(2));
+    dropped.Notify();
+  });
+
+  queue.Stop();
+  dropped.WaitForNotification();
+  EXPECT_EQ(queue.GetStats().dropped_count, 1);
+}
+
+TEST(WorkerQueueTest, StatsTrackDepthAndLatency) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner(&fake_clock, 1);
+  WorkerQueue<int> queue(&task_runner, {.clock = &fake_clock});
+  queue.Queue(1);
+  fake_clock.FastForward(absl::Milliseconds(30));
+  queue.Queue(2);
+  fake_clock.FastForward(absl::Milliseconds(20));
+  queue.ReadAll();
+  queue.Queue(3);
+  fake_clock.FastForward(absl::Milliseconds(10));
+  queue.ReadAll();
+
+  WorkerQueue<int>::Stats stats = queue.GetStats();
+  EXPECT_EQ(stats.queued_count, 3);
+  EXPECT_EQ(stats.dropped_count, 0);
+  EXPECT_EQ(stats.max_depth, 2);
+  EXPECT_EQ(stats.max_latency, absl::Milliseconds(50));
+}
+
+TEST(WorkerQueueTest, QueueOrReplaceLast) {
+  FakeClock fake_clock;
+  FakeTaskRunner task_runner(&fake_clock, 1);
+  WorkerQueue<int> queue(&task_runner);
+  auto is_odd = [](const int& last) { return last % 2 == 1; };
+  EXPECT_TRUE(queue.QueueOrReplaceLast(1, is_odd));
+  EXPECT_TRUE(queue.QueueOrReplaceLast(3, is_odd));
+  EXPECT_TRUE(queue.Queue(4));
+  EXPECT_TRUE(queue.QueueOrReplaceLast(5, is_odd));
+
+  std::queue<int> items = queue.ReadAll();
+  EXPECT_EQ(items.size(), 3);
+  EXPECT_EQ(items.front(), 3);
+  EXPECT_EQ(items.back(), 5);
+
+  // Items already read are not replaced.
+  EXPECT_TRUE(queue.QueueOrReplaceLast(7, is_odd));
+  items = queue.ReadAll();
+  EXPECT_EQ(items.size(), 1);
+  EXPECT_EQ(items.front(), 7);
+
+  WorkerQueue<int>::Stats stats = queue.GetStats();
+  EXPECT_EQ(stats.queued_count, 4);
+  EXPECT_EQ(stats.replaced_count, 1);
+}
+
 }  // namespace
 }  // namespace nearby::sharing